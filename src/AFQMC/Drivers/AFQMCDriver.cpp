@@ -95,6 +95,8 @@ bool AFQMCDriver::run(WalkerSet& wset)
   if (nCheckpoint > 0)
     checkpoint(wset, iBlock, step_tot);
 
+  report_memory_managers();
+
   return true;
 }
 
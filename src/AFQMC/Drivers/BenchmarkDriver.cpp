@@ -1,171 +1,210 @@
-#include <tuple>
-#include <map>
-#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
 
-#include "OhmmsData/AttributeSet.h"
 #include "OhmmsData/ParameterSet.h"
-#include "Message/MPIObjectBase.h"
-#include "Concurrency/OpenMP.h"
-#include "Message/Communicate.h"
-#include "Message/CommOperators.h"
 #include "OhmmsData/libxmldefs.h"
 #include "Configuration.h"
-#include "Utilities/qmc_common.h"
+#include "Utilities/Timer.h"
+#include "Utilities/FairDivide.h"
 
 #include "AFQMC/config.h"
 #include "BenchmarkDriver.h"
+#include "AFQMC/Memory/buffer_managers.h"
 
 namespace qmcplusplus
 {
-bool BenchmarkDriver::run()
+namespace afqmc
+{
+// waits for the device kernels writing to p by copying one element to the host
+template<class Ptr>
+static void wait_for_device(Ptr p)
+{
+#if defined(ENABLE_CUDA) || defined(ENABLE_HIP)
+  std::decay_t<decltype(*to_address(p))> v;
+  copy_n(p, 1, &v);
+#endif
+}
+
+template<class Kernel>
+void BenchmarkDriver::time_kernel(const std::string& kernel, int nwalk, Kernel&& f)
+{
+  if (kernel_list != "all" && kernel_list.find(kernel) == std::string::npos)
+    return;
+  f();
+  globalComm.barrier();
+  double tmin = std::numeric_limits<double>::max();
+  double tsum = 0.0;
+  Timer timer;
+  for (int i = 0; i < nrepeat; i++)
+  {
+    timer.restart();
+    f();
+    globalComm.barrier();
+    double t = timer.elapsed();
+    tmin     = std::min(tmin, t);
+    tsum += t;
+  }
+  results.push_back({kernel, nwalk, tmin, tsum / std::max(nrepeat, 1)});
+  app_log() << "  " << std::left << std::setw(12) << kernel << std::right << std::setw(8) << nwalk << std::scientific
+            << std::setprecision(4) << std::setw(14) << tmin << std::setw(14) << tsum / std::max(nrepeat, 1)
+            << std::defaultfloat << std::endl;
+}
+
+bool BenchmarkDriver::run(WalkerSet& wset)
 {
+  using stack_alloc_type   = LocalTGBufferManager::template allocator_t<ComplexType>;
+  using stack_alloc_SPtype = LocalTGBufferManager::template allocator_t<SPComplexType>;
+  using StaticMatrix       = boost::multi::static_array<ComplexType, 2, stack_alloc_type>;
+  using StaticSPMatrix     = boost::multi::static_array<SPComplexType, 2, stack_alloc_SPtype>;
+
   app_log() << "***********************************************************\n"
             << "************ Starting Benchmark/Tests/Timings *************\n"
             << "***********************************************************\n";
 
-  prop0->benchmark(benchmark_list, maxnW, delnW, nrepeat, wlkBucket);
+  LocalTGBufferManager buffer_manager;
+  long Gsize      = wfn0.size_of_G_for_vbias();
+  long localnCV   = wfn0.local_number_of_cholesky_vectors();
+  RealType Eshift = prop0.hybrid_propagation() ? RealType(0.0) : RealType(real(wset[0].energy()));
 
-  wlkBucket->benchmark(benchmark_list, maxnW, delnW, nrepeat);
+  app_log() << "  " << std::left << std::setw(12) << "kernel" << std::right << std::setw(8) << "nwalk"
+            << std::setw(14) << "min (s)" << std::setw(14) << "avg (s)" << std::endl;
+  for (int nw : walkers)
+  {
+    wset.resize(nw);
+    wfn0.Energy(wset);
+    auto G_ext   = wfn0.transposed_G_for_vbias() ? iextensions<2u>{nw, Gsize} : iextensions<2u>{Gsize, nw};
+    auto vhs_ext = wfn0.transposed_vHS() ? iextensions<2u>{nw, NMO * NMO} : iextensions<2u>{NMO * NMO, nw};
+
+    time_kernel("overlap", nw, [&]() { wfn0.Overlap(wset); });
+    time_kernel("energy", nw, [&]() { wfn0.Energy(wset); });
+
+    { // the buffers must be released before Propagate updates the memory managers
+      StaticMatrix G(G_ext, buffer_manager.get_generator().template get_allocator<ComplexType>());
+      time_kernel("density", nw, [&]() {
+        wfn0.MixedDensityMatrix_for_vbias(wset, G);
+        wait_for_device(G.origin());
+      });
+#if defined(MIXED_PRECISION)
+      StaticSPMatrix Gsp(G_ext, buffer_manager.get_generator().template get_allocator<SPComplexType>());
+      {
+        int Gak0, GakN;
+        std::tie(Gak0, GakN) =
+            FairDivideBoundary(TG.getLocalTGRank(), int(Gsp.num_elements()), TG.getNCoresPerTG());
+        copy_n_cast(make_device_ptr(G.origin()) + Gak0, GakN - Gak0, make_device_ptr(Gsp.origin()) + Gak0);
+        TG.local_barrier();
+      }
+#else
+      StaticSPMatrix& Gsp = G;
+#endif
+      // vbias is used as the auxiliary field X of vHS
+      StaticSPMatrix vbias({localnCV, long(nw)},
+                           buffer_manager.get_generator().template get_allocator<SPComplexType>());
+      time_kernel("vbias", nw, [&]() {
+        wfn0.vbias(Gsp, vbias, std::sqrt(dt));
+        wait_for_device(vbias.origin());
+      });
+      StaticSPMatrix vHS(vhs_ext, buffer_manager.get_generator().template get_allocator<SPComplexType>());
+      time_kernel("vhs", nw, [&]() {
+        wfn0.vHS(vbias, vHS, std::sqrt(dt));
+        wait_for_device(vHS.origin());
+      });
+    }
+
+    time_kernel("propagate", nw, [&]() { prop0.Propagate(1, wset, Eshift, dt, 1); });
+  }
 
+  if (globalComm.rank() == 0)
+  {
+    std::string file = (json_file == "") ? project_title + std::string(".benchmark.json") : json_file;
+    if (!writeJSON(file))
+    {
+      app_error() << " Error writing benchmark file " << file << std::endl;
+      return false;
+    }
+    app_log() << " Benchmark results written to " << file << std::endl;
+  }
   return true;
 }
 
-bool BenchmarkDriver::parse(xmlNodePtr cur)
+double BenchmarkDriver::propagation_time(WalkerSet& wset)
 {
-  if (cur == NULL)
-    return false;
-
-  std::string str, str1;
-
-  ncores_per_TG = 1;
-  ParameterSet m_param;
-  m_param.add(benchmark_list, "list");
-  m_param.add(maxnW, "maxnw");
-  m_param.add(delnW, "delnw");
-  m_param.add(nrepeat, "repeat");
-  m_param.add(ncores_per_TG, "ncores_per_TG");
-  m_param.add(ncores_per_TG, "ncores");
-  m_param.add(ncores_per_TG, "cores");
-  m_param.add(dt, "timestep");
-  m_param.put(cur);
-
-  return true;
+  RealType Eshift = prop0.hybrid_propagation() ? RealType(0.0) : RealType(real(wset[0].energy()));
+  kernel_list     = "propagate";
+  time_kernel("propagate", wset.size(), [&]() { prop0.Propagate(1, wset, Eshift, dt, 1); });
+  return results.back().tmin;
 }
 
-
-bool BenchmarkDriver::setup(HamPtr h0, WSetPtr w0, PropPtr p0, WfnPtr wf0)
+bool BenchmarkDriver::writeJSON(const std::string& file)
 {
-  ham0      = h0;
-  wlkBucket = w0;
-  prop0     = p0;
-  wfn0      = wf0;
-  restarted = false;
-
-  app_log() << "\n****************************************************\n"
-            << "****************************************************\n"
-            << "****************************************************\n"
-            << "          Beginning Driver initialization.\n"
-            << "****************************************************\n"
-            << "****************************************************\n"
-            << "****************************************************\n"
-            << std::endl;
-
-  app_log() << " Using " << ncores_per_TG << " cores per node in a TaskGroup. \n";
-  // right now this TG is not used. It is needed for setup purposes and to
-  // get a unique TG number for every group of cores on a node (used in the WalkerSet)
-  TG.setup(ncores_per_TG, 1, false);
-  std::vector<int> TGdata(5);
-  TG.getSetupInfo(TGdata);
-
-  // setup local-to-node MPI Comm
-  // TGdata[0]: node_number
-  myComm->split_comm(TGdata[0], MPI_COMM_NODE_LOCAL);
-  TG.setNodeCommLocal(MPI_COMM_NODE_LOCAL);
-  int key = TG.getTGNumber(); // This works because the TG used has nnodes_per_TG=1
-  myComm->split_comm(key, MPI_COMM_TG_LOCAL);
-  TG.setTGCommLocal(MPI_COMM_TG_LOCAL);
-  key = TG.getCoreRank();
-  myComm->split_comm(key, MPI_COMM_TG_LOCAL_HEADS);
-
-  key = TG.getCoreID();
-  myComm->split_comm(key, MPI_COMM_HEAD_OF_NODES);
-  TG.setHeadOfNodesComm(MPI_COMM_HEAD_OF_NODES);
-
-  CommBuffer.setup(TG.getCoreRank() == 0, std::string("COMMBuffer_") + std::to_string(TG.getTGNumber()),
-                   MPI_COMM_TG_LOCAL);
-  TG.setBuffer(&CommBuffer);
-
-  app_log() << "\n****************************************************\n"
-            << "               Initializing Hamiltonian \n"
-            << "****************************************************\n"
-            << std::endl;
-
-  // hamiltonian
-  if (!ham0->init(TGdata, &CommBuffer, MPI_COMM_TG_LOCAL, MPI_COMM_NODE_LOCAL, MPI_COMM_HEAD_OF_NODES))
-  {
-    app_error() << "Error initializing Hamiltonian in BenchmarkDriver::setup" << std::endl;
+  std::ofstream out(file);
+  if (!out)
     return false;
-  }
-
-  app_log() << "\n****************************************************\n"
-            << "               Initializing Wavefunction \n"
-            << "****************************************************\n"
-            << std::endl;
-
-  hdf_archive read(myComm);
-  if (!wfn0->init(TGdata, &CommBuffer, read, std::string(""), MPI_COMM_TG_LOCAL, MPI_COMM_NODE_LOCAL,
-                  MPI_COMM_HEAD_OF_NODES))
-  {
-    app_error() << "Error initializing Wavefunction in BenchmarkDriver::setup" << std::endl;
-    return false;
-  }
-  if (!wfn0->setup(ham0))
+#if defined(MIXED_PRECISION)
+  std::string precision("mixed");
+#else
+  std::string precision("double");
+#endif
+#if defined(ENABLE_CUDA) || defined(ENABLE_HIP)
+  std::string device("gpu");
+#else
+  std::string device("cpu");
+#endif
+  out << "{\n  \"title\": \"" << project_title << "\",\n  \"wavefunction\": \"" << wfn_title
+      << "\",\n  \"precision\": \"" << precision << "\",\n  \"device\": \"" << device
+      << "\",\n  \"ranks\": " << globalComm.size() << ",\n  \"NMO\": " << NMO << ",\n  \"NAEA\": " << NAEA
+      << ",\n  \"NAEB\": " << NAEB << ",\n  \"nchol\": " << wfn0.global_number_of_cholesky_vectors()
+      << ",\n  \"kernels\": [";
+  char buf[128];
+  for (int i = 0; i < results.size(); i++)
   {
-    app_error() << "Error in WavefunctionHandler::setup in BenchmarkDriver::setup" << std::endl;
-    return false;
+    const auto& r = results[i];
+    snprintf(buf, sizeof(buf), "\"nwalk\": %d, \"min\": %.6e, \"avg\": %.6e", r.nwalk, r.tmin, r.tavg);
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.kernel << "\", " << buf << "}";
   }
+  out << "\n  ]\n}\n";
+  return static_cast<bool>(out);
+}
 
-  app_log() << "\n****************************************************\n"
-            << "              Initializing Propagator \n"
-            << "****************************************************\n"
-            << std::endl;
-
-  // propagator
-  if (!prop0->setup(TGdata, &CommBuffer, ham0, wfn0, dt, read, std::string(""), MPI_COMM_TG_LOCAL, MPI_COMM_NODE_LOCAL,
-                    MPI_COMM_HEAD_OF_NODES))
-  {
-    app_error() << "Error in PropagatorBase::setup in BenchmarkDriver::setup" << std::endl;
+bool BenchmarkDriver::parse(xmlNodePtr cur)
+{
+  if (cur == NULL)
     return false;
-  }
 
-  // you will also need the Propagator's TG to handle the distibuted case
-  wfn0->setupFactorizedHamiltonian(prop0->is_vn_sparse(), prop0->getSpvn(), prop0->getDvn(), dt, prop0->getTG());
+  std::string walker_list("1 8 32");
+  kernel_list = "all";
+  nrepeat     = 5;
+  dt          = 0.01;
+  json_file   = "";
 
-  app_log() << "\n****************************************************\n"
-            << "             Initializing Walker Handler \n"
-            << "****************************************************\n"
-            << std::endl;
-
-  // walker set
-  wlkBucket->setup(TG.getCoreRank(), ncores_per_TG, TG.getTGNumber(), prop0->getNBackProp(), MPI_COMM_TG_LOCAL_HEADS,
-                   MPI_COMM_TG_LOCAL, MPI_COMM_NODE_LOCAL, &LocalTimer);
-  wlkBucket->setHF(wfn0->getHF());
-  wlkBucket->initWalkers(maxnW);
-  wfn0->evaluateLocalEnergy(wlkBucket);
-
-  app_log() << "\n****************************************************\n"
-            << "****************************************************\n"
-            << "****************************************************\n"
-            << "          Finished Driver initialization.\n"
-            << "****************************************************\n"
-            << "****************************************************\n"
-            << "****************************************************\n"
-            << std::endl;
+  ParameterSet m_param;
+  m_param.add(walker_list, "walkers");
+  m_param.add(kernel_list, "kernels");
+  m_param.add(nrepeat, "repeat");
+  m_param.add(dt, "dt");
+  m_param.add(dt, "timestep");
+  m_param.add(json_file, "output");
+  m_param.put(cur);
 
-  myComm->barrier();
+  std::transform(kernel_list.begin(), kernel_list.end(), kernel_list.begin(), (int (*)(int))tolower);
+  walkers.clear();
+  std::istringstream is(walker_list);
+  int nw;
+  while (is >> nw)
+    if (nw > 0)
+      walkers.push_back(nw);
+  if (walkers.size() == 0)
+    APP_ABORT(" Error: Empty list of walkers in BenchmarkDriver. \n");
 
   return true;
 }
 
+} // namespace afqmc
 } // namespace qmcplusplus
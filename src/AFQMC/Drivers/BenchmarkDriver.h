@@ -1,55 +1,102 @@
 #ifndef QMCPLUSPLUS_AFQMC_BENCHMARKDRIVER_H
 #define QMCPLUSPLUS_AFQMC_BENCHMARKDRIVER_H
 
-#include "Message/MPIObjectBase.h"
-#include "hdf/hdf_multi.h"
-#include "hdf/hdf_archive.h"
+#include <string>
+#include <vector>
+
+#include "mpi3/communicator.hpp"
 
 #include "AFQMC/config.h"
-#include "AFQMC/Wavefunctions/WavefunctionHandler.h"
-#include "AFQMC/Propagators/PropagatorBase.h"
-#include "AFQMC/Walkers/WalkerHandlerBase.hpp"
-#include "AFQMC/Walkers/LocalWalkerHandler.h"
-#include "AFQMC/Hamiltonians/HamiltonianBase.hpp"
+#include "AFQMC/Utilities/taskgroup.h"
+#include "AFQMC/Propagators/Propagator.hpp"
+#include "AFQMC/Wavefunctions/Wavefunction.hpp"
+#include "AFQMC/Walkers/WalkerSet.hpp"
 
 namespace qmcplusplus
 {
-class BenchmarkDriver
+namespace afqmc
+{
+/*
+ * Times the kernels of a Wavefunction/Propagator pair (and therefore of its HamiltonianOperations)
+ * for a list of walker counts: overlaps, density matrices for vbias, vbias, vHS, local energy and
+ * a full propagation step. The results are printed and written as JSON by the first rank.
+ * The batch size and the precision are those of the Propagator input and of the build.
+ */
+class BenchmarkDriver : public AFQMCInfo
 {
-  using HamPtr  = std::shared_ptr<HamiltonianBase>;
-  using WSetPtr = std::shared_ptr<WalkerHandlerBase>;
-  using WfnPtr  = WavefunctionHandler*;
-  using PropPtr = PropagatorBase*;
-  using InfoPtr = AFQMCInfo*;
-
 public:
-  BenchmarkDriver() : benchmark_list(""), maxnW(128), delnW(-1), nrepeat(5), dt(0.01)
+  BenchmarkDriver(boost::mpi3::communicator& comm,
+                  AFQMCInfo& info,
+                  std::string& title,
+                  xmlNodePtr cur,
+                  TaskGroup_& tg_,
+                  std::string& wfn_name,
+                  Wavefunction& wfn_,
+                  Propagator& prpg_)
+      : AFQMCInfo(info),
+        globalComm(comm),
+        project_title(title),
+        wfn_title(wfn_name),
+        TG(tg_),
+        wfn0(wfn_),
+        prop0(prpg_)
   {
-    name          = "Benchmark";
-    project_title = "benchmark";
+    name = "BenchmarkDriver";
+
+    // read options from xml block
+    parse(cur);
   }
 
   ~BenchmarkDriver() {}
 
-  bool run();
+  bool run(WalkerSet&);
 
   bool parse(xmlNodePtr);
 
-  bool setup(HamPtr, WSetPtr, PropPtr, WfnPtr);
+  // times propagation steps of the walkers in wset like the propagate kernel, returns the fastest step in seconds
+  double propagation_time(WalkerSet& wset);
 
-  bool checkpoint(int a, int b) { return true; }
-
-  bool restart(hdf_archive& d) { return true; }
+protected:
+  struct KernelTime
+  {
+    std::string kernel;
+    int nwalk;
+    double tmin;
+    double tavg;
+  };
 
-  bool clear() { return true; }
+  boost::mpi3::communicator& globalComm;
 
-protected:
-  int maxnW, delnW, nrepeat;
+  std::string name;
+  std::string project_title;
+  std::string wfn_title;
 
+  // walker counts per task group
+  std::vector<int> walkers;
+  // kernels to time
+  std::string kernel_list;
+  // timed calls of each kernel, after one untimed call
+  int nrepeat;
   RealType dt;
+  std::string json_file;
+
+  // task group of the propagator
+  TaskGroup_& TG;
+
+  Wavefunction& wfn0;
+
+  Propagator& prop0;
 
-  std::string benchmark_list;
+  std::vector<KernelTime> results;
+
+  // times kernel nrepeat times after one warm up call
+  template<class Kernel>
+  void time_kernel(const std::string& kernel, int nwalk, Kernel&& f);
+
+  bool writeJSON(const std::string& file);
 };
+
+} // namespace afqmc
 } // namespace qmcplusplus
 
 #endif
@@ -1,4 +1,6 @@
 #include <iomanip>
+#include <sstream>
+#include <vector>
 
 #include "Configuration.h"
 #include "OhmmsData/libxmldefs.h"
@@ -9,8 +11,11 @@
 #include "AFQMC/Utilities/taskgroup.h"
 #include "DriverFactory.h"
 #include "AFQMC/Drivers/AFQMCDriver.h"
+#include "AFQMC/Drivers/BenchmarkDriver.h"
 #include "AFQMC/Walkers/WalkerIO.hpp"
 #include "AFQMC/Memory/buffer_managers.h"
+#include "AFQMC/Memory/utilities.hpp"
+#include "AFQMC/Utilities/Utils.hpp"
 
 #include "AFQMC/Walkers/WalkerSetFactory.hpp"
 #include "AFQMC/Hamiltonians/HamiltonianFactory.h"
@@ -40,9 +45,12 @@ bool DriverFactory::executeDriver(std::string title, int m_series, xmlNodePtr cu
   }
   else if (type == "benchmark")
   {
-    APP_ABORT(" FINISH \n ");
     return executeBenchmarkDriver(title, m_series, cur);
   }
+  else if (type == "autotune")
+  {
+    return executeAutoTuneDriver(title, m_series, cur);
+  }
   else
   {
     app_error() << "Unknown execute driver: " << type << std::endl;
@@ -51,7 +59,7 @@ bool DriverFactory::executeDriver(std::string title, int m_series, xmlNodePtr cu
   }
 }
 
-bool DriverFactory::executeAFQMCDriver(std::string title, int m_series, xmlNodePtr cur)
+bool DriverFactory::executeAFQMCDriver(std::string title, int m_series, xmlNodePtr cur, const TaskGroupLayout* layout)
 {
   if (cur == NULL)
     APP_ABORT(" Error: Null xml node in DriverFactory::executeAFQMCDriver(). \n ");
@@ -95,6 +103,8 @@ bool DriverFactory::executeAFQMCDriver(std::string title, int m_series, xmlNodeP
   m_param.add(str1, "set_nwalker_to_target");
   m_param.add(hdf_read_restart, "hdf_read_file");
   m_param.put(cur);
+  if (layout)
+    ncores_per_TG = layout->ncores;
 
   // hard restriction for now
   bool first(false);
@@ -201,6 +211,8 @@ bool DriverFactory::executeAFQMCDriver(std::string title, int m_series, xmlNodeP
   int nnodes_propg = std::max(1, get_parameter<int>(PropFac, prop_name, "nnodes", 1));
   int nnodes_wfn   = std::max(1, get_parameter<int>(WfnFac, wfn_name, "nnodes", 1));
   RealType cutvn   = get_parameter<RealType>(PropFac, prop_name, "cutoff", 1e-6);
+  if (layout)
+    nnodes_propg = nnodes_wfn = layout->nnodes;
 
   // setup task groups
   auto& TGprop = TGHandler.getTG(nnodes_propg);
@@ -210,7 +222,7 @@ bool DriverFactory::executeAFQMCDriver(std::string title, int m_series, xmlNodeP
   // defaults to 20MB. Read from input!!!
   std::size_t buffer_size(20);
   if (first)
-    LocalTGBufferManager local_buffer(TGwfn.TG_local(), buffer_size * 1024uL * 1024uL);
+    setup_localTG_buffer_manager(TGwfn.TG_local(), buffer_size * 1024uL * 1024uL);
 
   // walker set and type
   WalkerSet& wset          = WSetFac.getWalkerSet(TGHandler.getTG(1), wset_name, rng.get());
@@ -231,6 +243,8 @@ bool DriverFactory::executeAFQMCDriver(std::string title, int m_series, xmlNodeP
   // propagator
   Propagator& prop0 = PropFac.getPropagator(TGprop, prop_name, wfn0, rng.get());
   bool hybrid       = prop0.hybrid_propagation();
+  if (layout && layout->nbatch)
+    prop0.set_batch_size(*layout->nbatch);
 
   // resize walker set
   if (restarted)
@@ -294,7 +308,287 @@ bool DriverFactory::executeAFQMCDriver(std::string title, int m_series, xmlNodeP
   return true;
 }
 
-bool DriverFactory::executeBenchmarkDriver(std::string title, int m_series, xmlNodePtr cur) { return false; }
+bool DriverFactory::executeBenchmarkDriver(std::string title, int m_series, xmlNodePtr cur)
+{
+  if (cur == NULL)
+    APP_ABORT(" Error: Null xml node in DriverFactory::executeBenchmarkDriver(). \n ");
+
+  std::string ham_name("ham0");
+  std::string wfn_name("wfn0");
+  std::string wset_name("wset0");
+  std::string prop_name("prop0");
+  std::string info("info0");
+  OhmmsAttributeSet oAttrib;
+  oAttrib.add(prop_name, "prop");
+  oAttrib.add(wset_name, "wset");
+  oAttrib.add(wfn_name, "wfn");
+  oAttrib.add(ham_name, "ham");
+  oAttrib.add(info, "info");
+  oAttrib.put(cur);
+
+  if (InfoMap.find(info) == InfoMap.end())
+  {
+    app_error() << "ERROR: Undefined info in execute block. \n";
+    return false;
+  }
+  auto& AFinfo = InfoMap[info];
+  int NMO      = AFinfo.NMO;
+  int NAEB     = AFinfo.NAEB;
+
+  int ncores_per_TG = 1;
+  int nWalkers      = 10;
+  ParameterSet m_param;
+  m_param.add(nWalkers, "nWalkers");
+  m_param.add(ncores_per_TG, "ncores_per_TG");
+  m_param.add(ncores_per_TG, "ncores");
+  m_param.add(ncores_per_TG, "cores");
+  m_param.put(cur);
+
+  // hard restriction for now
+  bool first(false);
+  if (ncores < 0)
+  {
+    first  = true;
+    ncores = ncores_per_TG;
+  }
+  else if (ncores != ncores_per_TG)
+    APP_ABORT(" Error: Current implementation requires the same ncores in all execution blocks. \n");
+
+  TGHandler.setNCores(ncores);
+
+  std::unique_ptr<RandomGenerator>& rng = RandomNumberControl::Children.front();
+
+  app_log() << "\n****************************************************\n"
+            << "          Beginning Benchmark initialization.\n"
+            << "****************************************************\n"
+            << std::endl;
+
+  if (WfnFac.getXML(wfn_name) == nullptr)
+    APP_ABORT(" Error: Missing Wavefunction xml block. \n");
+  if (PropFac.getXML(prop_name) == nullptr)
+    APP_ABORT(" Error: Missing Propagator xml block. \n");
+  if (WSetFac.getXML(wset_name) == nullptr)
+    APP_ABORT(" Error: Missing Walker Set xml block. \n");
+
+  int nnodes_propg = std::max(1, get_parameter<int>(PropFac, prop_name, "nnodes", 1));
+  int nnodes_wfn   = std::max(1, get_parameter<int>(WfnFac, wfn_name, "nnodes", 1));
+  RealType cutvn   = get_parameter<RealType>(PropFac, prop_name, "cutoff", 1e-6);
+
+  auto& TGprop = TGHandler.getTG(nnodes_propg);
+  auto& TGwfn  = TGHandler.getTG(nnodes_wfn);
+
+  std::size_t buffer_size(20);
+  if (first)
+    setup_localTG_buffer_manager(TGwfn.TG_local(), buffer_size * 1024uL * 1024uL);
+
+  WalkerSet& wset          = WSetFac.getWalkerSet(TGHandler.getTG(1), wset_name, rng.get());
+  WALKER_TYPES walker_type = wset.getWalkerType();
+
+  if (not WfnFac.is_constructed(wfn_name))
+  {
+    Hamiltonian& ham0  = HamFac.getHamiltonian(gTG, ham_name);
+    Wavefunction& wfn0 = WfnFac.getWavefunction(TGprop, TGwfn, wfn_name, walker_type, &ham0, cutvn, nWalkers);
+  }
+  Wavefunction& wfn0 = WfnFac.getWavefunction(TGprop, TGwfn, wfn_name, walker_type, nullptr, cutvn, nWalkers);
+  Propagator& prop0  = PropFac.getPropagator(TGprop, prop_name, wfn0, rng.get());
+
+  auto initial_guess = WfnFac.getInitialGuess(wfn_name);
+  wset.resize(1, initial_guess[0], initial_guess[1]({0, NMO}, {0, NAEB}));
+  wfn0.Energy(wset);
+
+  gTG.global_barrier();
+
+  BenchmarkDriver driver(gTG.Global(), AFinfo, title, cur, TGprop, wfn_name, wfn0, prop0);
+
+  if (!driver.run(wset))
+  {
+    app_error() << " Problems with BenchmarkDriver::run()." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool DriverFactory::executeAutoTuneDriver(std::string title, int m_series, xmlNodePtr cur)
+{
+  if (cur == NULL)
+    APP_ABORT(" Error: Null xml node in DriverFactory::executeAutoTuneDriver(). \n ");
+
+  std::string ham_name("ham0");
+  std::string wfn_name("wfn0");
+  std::string wset_name("wset0");
+  std::string prop_name("prop0");
+  std::string info("info0");
+  OhmmsAttributeSet oAttrib;
+  oAttrib.add(prop_name, "prop");
+  oAttrib.add(wset_name, "wset");
+  oAttrib.add(wfn_name, "wfn");
+  oAttrib.add(ham_name, "ham");
+  oAttrib.add(info, "info");
+  oAttrib.put(cur);
+
+  if (InfoMap.find(info) == InfoMap.end())
+  {
+    app_error() << "ERROR: Undefined info in execute block. \n";
+    return false;
+  }
+  auto& AFinfo = InfoMap[info];
+  int NMO      = AFinfo.NMO;
+  int NAEB     = AFinfo.NAEB;
+
+  int ncores_per_TG      = 1;
+  int nWalkers           = 10;
+  double min_free_memory = 0.0;
+  std::string ncores_list, nnodes_list, nbatch_list;
+  ParameterSet m_param;
+  m_param.add(nWalkers, "nWalkers");
+  m_param.add(ncores_per_TG, "ncores_per_TG");
+  m_param.add(ncores_per_TG, "ncores");
+  m_param.add(ncores_per_TG, "cores");
+  m_param.add(ncores_list, "tune_ncores");
+  m_param.add(nnodes_list, "tune_nnodes");
+  m_param.add(nbatch_list, "tune_nbatch");
+  m_param.add(min_free_memory, "tune_min_free_memory");
+  m_param.put(cur);
+
+  if (WfnFac.getXML(wfn_name) == nullptr)
+    APP_ABORT(" Error: Missing Wavefunction xml block. \n");
+  if (PropFac.getXML(prop_name) == nullptr)
+    APP_ABORT(" Error: Missing Propagator xml block. \n");
+  if (WSetFac.getXML(wset_name) == nullptr)
+    APP_ABORT(" Error: Missing Walker Set xml block. \n");
+
+  // objects of a previous execution block fix the layout
+  if (WfnFac.is_constructed(wfn_name) || PropFac.is_constructed(prop_name) || WSetFac.is_constructed(wset_name))
+  {
+    app_log() << " Warning: Task group layout fixed by a previous execution block, running the afqmc driver "
+              << "without tuning. \n";
+    return executeAFQMCDriver(title, m_series, cur);
+  }
+
+  auto read_list = [](const std::string& list, int value) {
+    std::vector<int> values;
+    std::istringstream is(list);
+    int v;
+    while (is >> v)
+      values.push_back(v);
+    if (values.empty())
+      values.push_back(value);
+    return values;
+  };
+  // the current implementation requires the same ncores in all execution blocks
+  std::vector<int> ncores_tune = (ncores < 0) ? read_list(ncores_list, ncores_per_TG) : std::vector<int>{ncores};
+  int nnodes_propg             = std::max(1, get_parameter<int>(PropFac, prop_name, "nnodes", 1));
+  std::vector<int> nnodes_tune = read_list(nnodes_list, nnodes_propg);
+  // nbatch of the propagator input unless a list is given
+  std::vector<std::optional<int>> nbatch_tune;
+  for (int nb : read_list(nbatch_list, 0))
+    nbatch_tune.push_back((nbatch_list.empty()) ? std::nullopt : std::optional<int>(nb));
+
+  // ncores and nnodes of a TaskGroup_ must divide the cores of a node and the nodes, devices take one core per TG
+  const bool on_devices = number_of_devices() > 0;
+  auto valid_layout     = [&](int nc, int nn) {
+    if (nc < 1 || nn < 1)
+      return false;
+    if (on_devices)
+      return nc == 1 && gTG.getGlobalSize() % nn == 0;
+    return gTG.getTotalCores() % nc == 0 && gTG.getTotalNodes() % nn == 0;
+  };
+
+  std::unique_ptr<RandomGenerator>& rng = RandomNumberControl::Children.front();
+  RealType cutvn                        = get_parameter<RealType>(PropFac, prop_name, "cutoff", 1e-6);
+  std::size_t buffer_size(20);
+
+  app_log() << "\n****************************************************\n"
+            << "          Beginning task group tuning.\n"
+            << "****************************************************\n"
+            << std::endl;
+
+  struct Trial
+  {
+    TaskGroupLayout layout;
+    double walkers_per_second;
+    size_t free_memory;
+  };
+  std::vector<Trial> trials;
+  for (int nc : ncores_tune)
+    for (int nn : nnodes_tune)
+    {
+      if (!valid_layout(nc, nn))
+      {
+        app_log() << " Skipping ncores: " << nc << " nnodes: " << nn << ", incompatible with the job. \n";
+        continue;
+      }
+      TaskGroupHandler tg_handler(gTG, nc);
+      TaskGroup_& TG     = tg_handler.getTG(nn);
+      TaskGroup_& TGwalk = tg_handler.getTG(1);
+      setup_localTG_buffer_manager(TG.TG_local(), buffer_size * 1024uL * 1024uL);
+      {
+        WalkerSet wset    = WSetFac.buildDetachedWalkerSet(TGwalk, wset_name, rng.get());
+        Hamiltonian& ham0 = HamFac.getHamiltonian(gTG, ham_name);
+        Wavefunction wfn =
+            WfnFac.buildDetachedWavefunction(TG, TG, wfn_name, wset.getWalkerType(), &ham0, cutvn, nWalkers);
+        Propagator prop           = PropFac.buildDetachedPropagator(TG, prop_name, wfn, rng.get());
+        auto const& initial_guess = WfnFac.getInitialGuess(wfn_name);
+        wset.resize(nWalkers, initial_guess[0], initial_guess[1]({0, NMO}, {0, NAEB}));
+        wfn.Energy(wset);
+
+        BenchmarkDriver bench(gTG.Global(), AFinfo, title, cur, TG, wfn_name, wfn, prop);
+        // nWalkers per task group, as in the afqmc driver
+        const double total_walkers = double(nWalkers) * TGwalk.getNumberOfTGs();
+        // the batch size only applies with one core per local TG
+        std::vector<std::optional<int>> nbatches(nbatch_tune);
+        if (TG.getNCoresPerTG() > 1)
+          nbatches = {std::nullopt};
+        for (auto const& nbatch : nbatches)
+        {
+          if (nbatch)
+            prop.set_batch_size(*nbatch);
+          const double t    = bench.propagation_time(wset);
+          size_t free_local = available_memory();
+          size_t free_memory(0);
+          gTG.Global().all_reduce_n(&free_local, 1, &free_memory, boost::mpi3::min<>());
+          trials.push_back({{nc, nn, nbatch}, total_walkers / t, free_memory});
+        }
+      }
+      // the host buffer lives on the communicator of this local TG
+      release_localTG_buffer_manager();
+    }
+
+  if (trials.empty())
+    APP_ABORT(" Error: No valid task group layout in DriverFactory::executeAutoTuneDriver(). \n");
+
+  // ranks time slightly differently, rank 0 chooses for all
+  int best = -1;
+  app_log() << "\n   ncores   nnodes   nbatch    walkers/s   free memory (MB) \n";
+  for (int i = 0; i < trials.size(); i++)
+  {
+    auto const& trial = trials[i];
+    app_log() << std::setw(9) << trial.layout.ncores << std::setw(9) << trial.layout.nnodes << std::setw(9)
+              << (trial.layout.nbatch ? std::to_string(*trial.layout.nbatch) : std::string("input"))
+              << std::setw(13) << std::setprecision(6) << trial.walkers_per_second << std::setw(19)
+              << trial.free_memory << "\n";
+    if (trial.free_memory >= min_free_memory &&
+        (best < 0 || trial.walkers_per_second > trials[best].walkers_per_second))
+      best = i;
+  }
+  if (best < 0)
+  {
+    app_log() << " Warning: No layout leaves " << min_free_memory
+              << " MB free, using the one leaving the most memory. \n";
+    best = std::max_element(trials.begin(), trials.end(),
+                            [](auto const& a, auto const& b) { return a.free_memory < b.free_memory; }) -
+        trials.begin();
+  }
+  gTG.Global().broadcast_value(best);
+
+  TaskGroupLayout layout = trials[best].layout;
+  app_log() << " Running with ncores: " << layout.ncores << " nnodes: " << layout.nnodes << " nbatch: "
+            << (layout.nbatch ? std::to_string(*layout.nbatch) : std::string("input")) << "\n"
+            << std::endl;
+
+  return executeAFQMCDriver(title, m_series, cur, &layout);
+}
 
 } // namespace afqmc
 } // namespace qmcplusplus
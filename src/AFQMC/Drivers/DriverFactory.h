@@ -2,6 +2,8 @@
 #ifndef QMCPLUSPLUS_DRIVERFACTORY_H
 #define QMCPLUSPLUS_DRIVERFACTORY_H
 
+#include <optional>
+
 #include "OhmmsData/libxmldefs.h"
 #include "Message/MPIObjectBase.h"
 
@@ -46,8 +48,18 @@ public:
   bool executeDriver(std::string title, int m_series, xmlNodePtr cur);
 
 private:
-  bool executeAFQMCDriver(std::string title, int m_series, xmlNodePtr cur);
+  // task group layout and walker batch size replacing those of the input
+  struct TaskGroupLayout
+  {
+    int ncores;
+    int nnodes;
+    std::optional<int> nbatch;
+  };
+
+  bool executeAFQMCDriver(std::string title, int m_series, xmlNodePtr cur, const TaskGroupLayout* layout = nullptr);
   bool executeBenchmarkDriver(std::string title, int m_series, xmlNodePtr cur);
+  // times short propagations on candidate layouts and runs the afqmc driver on the fastest one
+  bool executeAutoTuneDriver(std::string title, int m_series, xmlNodePtr cur);
 
   int ncores;
 
@@ -124,6 +124,11 @@ public:
     nrefs = wfn0.number_of_references_for_back_propagation();
     wset.resize_bp(max_nback_prop, ncv, nrefs);
     wset.setBPPos(0);
+    // the fields of the path are the only storage growing with nsteps
+    app_log() << "  BackPropagatedEstimator: storing " << max_nback_prop << " steps of " << ncv
+              << " auxiliary fields for " << wset.capacity() << " walkers: "
+              << double(max_nback_prop) * ncv * wset.capacity() * sizeof(SPComplexType) / 1024.0 / 1024.0
+              << " MB per task group" << std::endl;
     // set SMN in case BP begins right away
     if (nblocks_skip == 0)
       for (auto it = wset.begin(); it < wset.end(); ++it)
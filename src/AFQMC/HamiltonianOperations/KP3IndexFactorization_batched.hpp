@@ -127,6 +127,7 @@ public:
                                 mpi3C3Tensor&& hij_,
                                 shmCMatrix_&& h1,
                                 std::vector<shmSpMatrix_>&& vik,
+                                boost::multi::array<int, 2>&& vik_rows,
                                 std::vector<shmSpMatrix_>&& vak,
                                 std::vector<shmSpMatrix_>&& vakn,
                                 std::vector<shmSpMatrix_>&& vbl,
@@ -158,6 +159,7 @@ public:
         nelpk(std::move(nelpk_)),
         QKToK2(std::move(QKToK2_)),
         LQKikn(std::move(move_vector<shmSpMatrix>(std::move(vik)))),
+        LQKikn_rows(std::move(vik_rows)),
         //LQKank(std::move(move_vector<LQKankMatrix>(std::move(vak),TG.Node()))),
         LQKank(std::move(move_vector<LQKankMatrix>(std::move(vak)))),
         //needs_copy(true),
@@ -1272,15 +1274,19 @@ public:
         for (int K = 0; K < nkpts; ++K)
         { // K is the index of the kpoint pair of (i,k)
           int QK = QKToK2[Q][K];
-          Aarray.push_back(sp_pointer(LQKikn[Q][K].origin()));
+          // vKK is zero for the dropped blocks
+          if (LQKikn_rows[Q][K] < 0)
+            continue;
+          Aarray.push_back(sp_pointer(LQKikn[Q][LQKikn_rows[Q][K]].origin()));
           Barray.push_back(XQnw[Q][0].origin());
           Carray.push_back(vKK[K][QK].origin());
         }
       }
     }
     // C: v = T(X) * T(Lik) --> F: T(Lik) * T(X) = v
-    gemmBatched('T', 'T', nmo_max2, nwalk, nchol_max, SPComplexType(1.0), Aarray.data(), nchol_max, Barray.data(),
-                nwalk, SPComplexType(0.0), Carray.data(), nmo_max2, Aarray.size());
+    if (Aarray.size() > 0)
+      gemmBatched('T', 'T', nmo_max2, nwalk, nchol_max, SPComplexType(1.0), Aarray.data(), nchol_max, Barray.data(),
+                  nwalk, SPComplexType(0.0), Carray.data(), nmo_max2, Aarray.size());
 
 
     Aarray.clear();
@@ -1296,7 +1302,9 @@ public:
         for (int K = 0; K < nkpts; ++K)
         { // K is the index of the kpoint pair of (i,k)
           int QK = QKToK2[Q][K];
-          Aarray.push_back(sp_pointer(LQKikn[kminus[Q]][QK].origin()));
+          if (LQKikn_rows[kminus[Q]][QK] < 0)
+            continue;
+          Aarray.push_back(sp_pointer(LQKikn[kminus[Q]][LQKikn_rows[kminus[Q]][QK]].origin()));
           Barray.push_back(XQnw[Q][0].origin());
           Carray.push_back(vKK[K][QK].origin());
         }
@@ -1306,15 +1314,18 @@ public:
         for (int K = 0; K < nkpts; ++K)
         { // K is the index of the kpoint pair of (i,k)
           int QK = QKToK2[Q][K];
-          Aarray.push_back(sp_pointer(LQKikn[Q][K].origin()));
+          if (LQKikn_rows[Q][K] < 0)
+            continue;
+          Aarray.push_back(sp_pointer(LQKikn[Q][LQKikn_rows[Q][K]].origin()));
           Barray.push_back(XQnw[Q][1].origin());
           Carray.push_back(vKK[nkpts + Qmap[Q] - 1][QK].origin());
         }
       }
     }
     // C: v = T(X) * T(Lik) --> F: T(Lik) * T(X) = v
-    gemmBatched('C', 'T', nmo_max2, nwalk, nchol_max, SPComplexType(1.0), Aarray.data(), nchol_max, Barray.data(),
-                nwalk, SPComplexType(0.0), Carray.data(), nmo_max2, Aarray.size());
+    if (Aarray.size() > 0)
+      gemmBatched('C', 'T', nmo_max2, nwalk, nchol_max, SPComplexType(1.0), Aarray.data(), nchol_max, Barray.data(),
+                  nwalk, SPComplexType(0.0), Carray.data(), nmo_max2, Aarray.size());
 
 
     using vType = typename std::decay<MatB>::type::element;
@@ -1526,6 +1537,9 @@ private:
   //Cholesky Tensor Lik[Q][nk][i][k][n]
   std::vector<shmSpMatrix> LQKikn;
 
+  // row of block [Q][K] in LQKikn[Q], -1 if the block was dropped as negligible
+  boost::multi::array<int, 2> LQKikn_rows;
+
   // half-transformed Cholesky tensor
   std::vector<LQKankMatrix> LQKank;
   const bool needs_copy;
@@ -358,21 +358,27 @@ public:
         Array_ref<SPComplexType, 3> Rwub3D(Rwub.origin(), {nw, nu, nelec[ispin]});
         Array_ref<SPComplexType, 3> Twbk(make_device_ptr(Guv.origin()), {nw, nelec[ispin], nmo_});
         Array_ref<SPComplexType, 2> Twbk2D(Twbk.origin(), {nw, nelec[ispin] * nmo_});
+#if defined(QMC_COMPLEX)
+        // Twbk[w] = T(Rwub[w]) * T(rotPiu), with the same rotPiu for all walkers (zero stride)
+        // column major: Twbk[w]^T = rotPiu * Rwub[w]
+        if (kN > k0)
+        {
+          using ma::gemmStridedBatched;
+          gemmStridedBatched('T', 'T', (kN - k0), nelec[ispin], nu, SPComplexType(1.0),
+                             ma::pointer_dispatch(rotPiu[k0].origin()) + nu0, rotPiu.stride(0), 0,
+                             ma::pointer_dispatch(Rwub3D.origin()), nelec[ispin], nu * nelec[ispin], SPComplexType(0.0),
+                             ma::pointer_dispatch(Twbk.origin()) + k0, nmo_, nelec[ispin] * nmo_, nw);
+        }
+#else
         std::vector<decltype(&(Rwub3D[0]))> vRwub;
         std::vector<decltype(&(rotPiu({0, 1}, {0, 1})))> vPku;
-        std::vector<decltype(&(Twbk[0]({0, 1}, {0, 1})))> vTwbk;
         vRwub.reserve(nw);
         vPku.reserve(nw);
-        vTwbk.reserve(nw);
         for (int w = 0; w < nw; ++w)
         {
           vRwub.emplace_back(&(Rwub3D[w]));
           vPku.emplace_back(&(rotPiu({k0, kN}, {nu0, nu0 + nu})));
-          vTwbk.emplace_back(&(Twbk[w]({0, nelec[ispin]}, {k0, kN})));
         }
-#if defined(QMC_COMPLEX)
-        ma::BatchedProduct('T', 'T', vRwub, vPku, vTwbk);
-#else
         // need to keep vPku on the left hand side in real build
         if (Guv.num_elements() >= 2 * Twbk.num_elements())
         {
@@ -1077,30 +1083,29 @@ protected:
     using array_ptr       = boost::multi::array_ptr<SPComplexType, 2, sp_pointer>;
     auto Pua_ptr(&(rotcPua[k]({nu0, nu0 + nu}, {ispin * nup, nup + ispin * ndown})));
 
+    using ma::gemmStridedBatched;
+    // T[w][a][v] = sum_j G[w][a][j] * rotPiu[j][v]
+#if defined(QMC_COMPLEX)
+    // the same rotPiu for all walkers (zero stride), column major: T[w]^T = rotPiu^T * G[w]^T
+    if (vN > v0)
+      gemmStridedBatched('N', 'N', (vN - v0), nelec[ispin], nmo_, SPComplexType(1.0),
+                         ma::pointer_dispatch(rotPiu.origin()) + v0, rotPiu.stride(0), 0,
+                         ma::pointer_dispatch(G.origin()) + ispin * nup * nmo_, nmo_, G.stride(0),
+                         SPComplexType(0.0), ma::pointer_dispatch(Tav.origin()) + v0, Tav.stride(1), Tav.stride(0),
+                         nw);
+#else
     std::vector<const_array_ptr> Gwaj;
     std::vector<decltype(&(rotPiu({0, 1}, {0, 1})))> Pjv;
     std::vector<decltype(&(Tav[0]({0, 1}, {0, 1})))> Twav;
-    std::vector<decltype(Pua_ptr)> Pua;
-    std::vector<decltype(&(Guv[0]({0, 1}, {0, 1})))> Gwuv;
-
     Gwaj.reserve(nw);
     Pjv.reserve(nw);
     Twav.reserve(nw);
-    Pua.reserve(nw);
-    Gwuv.reserve(nw);
-
     for (int iw = 0; iw < nw; ++iw)
     {
       Gwaj.emplace_back(make_device_ptr(G[iw].origin()) + ispin * nup * nmo_, iextensions<2u>{nelec[ispin], nmo_});
       Pjv.emplace_back(&(rotPiu({0, nmo_}, {v0, vN})));
       Twav.emplace_back(&(Tav[iw]({0, nelec[ispin]}, {v0, vN})));
-      Pua.emplace_back(Pua_ptr);
-      Gwuv.emplace_back(&(Guv[iw]({0, nu}, {v0, vN})));
     }
-    // T[w][a][v] = sum_v G[w][a][j] * rotcPua[j][v]
-#if defined(QMC_COMPLEX)
-    ma::BatchedProduct('N', 'N', Gwaj, Pjv, Twav);
-#else
     ShmArray<SPComplexType, 3> Gja({nw, nmo_, nelec[ispin]},
                                    shm_buffer_manager.get_generator().template get_allocator<SPComplexType>());
     Array_ref<SPComplexType, 3> Tva(make_device_ptr(Guv.origin()), {nw, nv, nelec[ispin]});
@@ -1121,7 +1126,12 @@ protected:
 #endif
     comm->barrier();
     // G[w][u][v] = sum_a rotcPua[u][a] * T[w][a][v]
-    ma::BatchedProduct('N', 'N', Pua, Twav, Gwuv);
+    // the same rotcPua for all walkers (zero stride), column major: G[w]^T = T[w]^T * rotcPua^T
+    if (vN > v0)
+      gemmStridedBatched('N', 'N', (vN - v0), nu, nelec[ispin], SPComplexType(1.0),
+                         ma::pointer_dispatch(Tav.origin()) + v0, Tav.stride(1), Tav.stride(0),
+                         ma::pointer_dispatch(Pua_ptr->origin()), rotcPua[k].stride(0), 0, SPComplexType(0.0),
+                         ma::pointer_dispatch(Guv.origin()) + v0, Guv.stride(1), Guv.stride(0), nw);
     comm->barrier();
 
     // Gwv = Gwvv, in range v={nu0,nu0+nu}
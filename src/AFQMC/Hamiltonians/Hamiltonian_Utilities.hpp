@@ -17,6 +17,7 @@
 #define QMCPLUSPLUS_AFQMC_HAMILTONIAN_UTILITIES_H
 
 #include <cstdlib>
+#include <algorithm>
 #include <complex>
 #include <iostream>
 #include <vector>
@@ -202,6 +203,21 @@ inline bool find_smallest_permutation(s4D<ValueType>& val)
 #endif
 }
 
+/** accumulate the rounding error of storing x in SPComplexType
+ * @param x values computed in ComplexType
+ * @param n number of values
+ * @param max_abs largest absolute value of x, updated
+ * @param max_err largest absolute rounding error, updated
+ */
+inline void add_sp_storage_error(ComplexType const* x, size_t n, RealType& max_abs, RealType& max_err)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    max_abs = std::max(max_abs, RealType(std::abs(x[i])));
+    max_err = std::max(max_err, RealType(std::abs(x[i] - static_cast<ComplexType>(static_cast<SPComplexType>(x[i])))));
+  }
+}
+
 } // namespace afqmc
 } // namespace qmcplusplus
 
@@ -1551,14 +1551,61 @@ HamiltonianOperations KPFactorizedHamiltonian::getHamiltonianOperations_batched(
   //                            nmo_per_kp,nchol_per_kp,kminus,QKtok2,H1,LQKikn,
   //                            vn0,nsampleQ,gQ,E0,global_ncvecs);
 
+  // keep only the blocks L[Q][K] with a norm above cutoff_block, vHS skips the dropped ones
+  boost::multi::array<int, 2> LQKikn_rows({nkpts, nkpts});
+  {
+    size_t nblocks(0), nkept(0);
+    for (int Q = 0; Q < nkpts; Q++)
+    {
+      const int nrows = LQKikn[Q].size(0);
+      const int ncols = LQKikn[Q].size(1);
+      std::vector<int> kept;
+      if (distNode.root())
+        for (int K = 0; K < nrows; K++)
+        {
+          auto blk = to_address(LQKikn[Q][K].origin());
+          RealType nrm2(0.0);
+          for (int i = 0; i < ncols; i++)
+            nrm2 += std::norm(blk[i]);
+          if (cutoff_block <= 0.0 || std::sqrt(nrm2) >= cutoff_block)
+            kept.push_back(K);
+        }
+      int nk = kept.size();
+      distNode.broadcast_n(&nk, 1, 0);
+      kept.resize(nk);
+      distNode.broadcast_n(kept.data(), nk, 0);
+      std::fill_n(LQKikn_rows[Q].origin(), nkpts, -1);
+      for (int r = 0; r < nk; r++)
+        LQKikn_rows[Q][kept[r]] = r;
+      if (nrows == nkpts)
+      {
+        nblocks += nrows;
+        nkept += nk;
+      }
+      if (nk < nrows)
+      {
+        shmSpMatrix L({std::max(nk, 1), ncols}, shared_allocator<SPComplexType>{distNode});
+        if (distNode.root())
+          for (int r = 0; r < nk; r++)
+            std::copy_n(to_address(LQKikn[Q][kept[r]].origin()), ncols, to_address(L[r].origin()));
+        distNode.barrier();
+        LQKikn[Q] = std::move(L);
+      }
+    }
+    if (cutoff_block > 0.0)
+      app_log() << " Keeping " << nkept << " of " << nblocks << " blocks of L[Q][K][ikn] with a norm above "
+                << cutoff_block << std::endl;
+  }
+
   if (ooc == "yes" || ooc == "true")
   {
     return HamiltonianOperations(
         KP3IndexFactorization_batched<shmSpMatrix>(type, TG, std::move(nmo_per_kp), std::move(nchol_per_kp),
                                                    std::move(kminus), std::move(nocc_per_kp), std::move(QKtok2),
-                                                   std::move(H1), std::move(haj), std::move(LQKikn), std::move(LQKank),
-                                                   std::move(LQKakn), std::move(LQKbnl), std::move(LQKbln),
-                                                   std::move(Qmap), std::move(vn0), std::move(gQ), nsampleQ, E0,
+                                                   std::move(H1), std::move(haj), std::move(LQKikn),
+                                                   std::move(LQKikn_rows), std::move(LQKank), std::move(LQKakn),
+                                                   std::move(LQKbnl), std::move(LQKbln), std::move(Qmap),
+                                                   std::move(vn0), std::move(gQ), nsampleQ, E0,
                                                    device_allocator<ComplexType>{}, global_origin, global_ncvecs,
                                                    memory));
   }
@@ -1568,9 +1615,10 @@ HamiltonianOperations KPFactorizedHamiltonian::getHamiltonianOperations_batched(
     return HamiltonianOperations(
         KP3IndexFactorization_batched<devSpMatrix>(type, TG, std::move(nmo_per_kp), std::move(nchol_per_kp),
                                                    std::move(kminus), std::move(nocc_per_kp), std::move(QKtok2),
-                                                   std::move(H1), std::move(haj), std::move(LQKikn), std::move(LQKank),
-                                                   std::move(LQKakn), std::move(LQKbnl), std::move(LQKbln),
-                                                   std::move(Qmap), std::move(vn0), std::move(gQ), nsampleQ, E0,
+                                                   std::move(H1), std::move(haj), std::move(LQKikn),
+                                                   std::move(LQKikn_rows), std::move(LQKank), std::move(LQKakn),
+                                                   std::move(LQKbnl), std::move(LQKbln), std::move(Qmap),
+                                                   std::move(vn0), std::move(gQ), nsampleQ, E0,
                                                    device_allocator<ComplexType>{}, global_origin, global_ncvecs,
                                                    memory));
   }
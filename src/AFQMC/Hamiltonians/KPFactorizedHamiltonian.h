@@ -46,6 +46,7 @@ public:
     std::string str("yes");
     ParameterSet m_param;
     m_param.add(cutoff_cholesky, "cutoff_cholesky");
+    m_param.add(cutoff_block, "cutoff_block");
     m_param.add(fileName, "filename");
     m_param.add(memory, "memory");
     if (TG.TG_local().size() == 1)
@@ -106,6 +107,9 @@ protected:
 
   double cutoff_cholesky;
 
+  // blocks L[Q][K] with a smaller norm are dropped by the batched implementation
+  double cutoff_block = 0.0;
+
   int nsampleQ = -1;
 
   HamiltonianOperations getHamiltonianOperations_shared(bool pureSD,
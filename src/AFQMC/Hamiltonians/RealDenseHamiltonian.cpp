@@ -22,6 +22,7 @@
 #include "AFQMC/Utilities/Utils.hpp"
 #include "AFQMC/Utilities/kp_utilities.hpp"
 #include "AFQMC/Utilities/hdf5_consistency_helper.hpp"
+#include "AFQMC/Hamiltonians/Hamiltonian_Utilities.hpp"
 #include "RealDenseHamiltonian.h"
 #include "AFQMC/SlaterDeterminantOperations/rotate.hpp"
 
@@ -233,6 +234,9 @@ HamiltonianOperations RealDenseHamiltonian::getHamiltonianOperations(bool pureSD
       ma::product(ComplexType(2.0), PsiT[nd], H1C, ComplexType(0.0), haj_r);
     }
   }
+  // rounding error of the single precision storage of mixed precision builds
+  constexpr bool sp_storage = !std::is_same<SPComplexType, ComplexType>::value;
+  RealType max_abs(0), max_err(0);
   {
     CMatrix lik({NMO, NMO});
     CMatrix lak({nup, NMO});
@@ -247,6 +251,8 @@ HamiltonianOperations RealDenseHamiltonian::getHamiltonianOperations(bool pureSD
           for (int k = 0; k < NMO; k++, ik++)
             lik[i][k] = ComplexType(static_cast<RealType>(Likn[ik][nc]), 0.0);
         ma::product(PsiT[nspins * nd], lik, lak);
+        if (sp_storage)
+          add_sp_storage_error(lak.origin(), nup * NMO, max_abs, max_err);
         for (int a = 0; a < nup; a++)
           copy_n_cast(lak[a].origin(), NMO, to_address(Lank[nspins * nd][a][nc].origin()));
         if (ndet == 1)
@@ -256,6 +262,8 @@ HamiltonianOperations RealDenseHamiltonian::getHamiltonianOperations(bool pureSD
         if (type == COLLINEAR)
         {
           ma::product(PsiT[2 * nd + 1], lik, lak.sliced(0, ndown));
+          if (sp_storage)
+            add_sp_storage_error(lak.origin(), ndown * NMO, max_abs, max_err);
           for (int a = 0; a < ndown; a++)
             copy_n_cast(lak[a].origin(), NMO, to_address(Lank[2 * nd + 1][a][nc].origin()));
           if (ndet == 1)
@@ -266,6 +274,14 @@ HamiltonianOperations RealDenseHamiltonian::getHamiltonianOperations(bool pureSD
       }
     }
   }
+  if (sp_storage)
+  {
+    RealType errs[2] = {max_abs, max_err}, gerrs[2];
+    TG.Global().all_reduce_n(errs, 2, gerrs, boost::mpi3::max<>());
+    app_log() << " Half-rotated Cholesky tensors stored in single precision. Largest rounding error relative to the "
+                 "largest element: "
+              << (gerrs[0] > 0 ? gerrs[1] / gerrs[0] : 0) << std::endl;
+  }
   TG.Global().barrier();
   if (distNode.root())
   {
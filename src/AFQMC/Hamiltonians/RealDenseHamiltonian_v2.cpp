@@ -21,6 +21,7 @@
 #include "AFQMC/config.h"
 #include "AFQMC/Utilities/Utils.hpp"
 #include "AFQMC/Utilities/kp_utilities.hpp"
+#include "AFQMC/Hamiltonians/Hamiltonian_Utilities.hpp"
 #include "RealDenseHamiltonian_v2.h"
 #include "AFQMC/SlaterDeterminantOperations/rotate.hpp"
 
@@ -229,6 +230,9 @@ HamiltonianOperations RealDenseHamiltonian_v2::getHamiltonianOperations(bool pur
     }
   }
   // Generate Lnak
+  // rounding error of the single precision storage of mixed precision builds
+  constexpr bool sp_storage = !std::is_same<SPComplexType, ComplexType>::value;
+  RealType max_abs(0), max_err(0);
   {
     CMatrix lik({NMO, NMO});
     CMatrix lak({nup, NMO});
@@ -243,15 +247,27 @@ HamiltonianOperations RealDenseHamiltonian_v2::getHamiltonianOperations(bool pur
           for (int k = 0; k < NMO; k++, ik++)
             lik[i][k] = ComplexType(static_cast<RealType>(Likn[ik][nc]), 0.0);
         ma::product(PsiT[nspins * nd], lik, lak);
+        if (sp_storage)
+          add_sp_storage_error(lak.origin(), nup * NMO, max_abs, max_err);
         copy_n_cast(lak.origin(), nup * NMO, to_address(Lnak[nspins * nd][nc].origin()));
         if (type == COLLINEAR)
         {
           ma::product(PsiT[2 * nd + 1], lik, lak.sliced(0, ndown));
+          if (sp_storage)
+            add_sp_storage_error(lak.origin(), ndown * NMO, max_abs, max_err);
           copy_n_cast(lak.origin(), ndown * NMO, to_address(Lnak[2 * nd + 1][nc].origin()));
         }
       }
     }
   }
+  if (sp_storage)
+  {
+    RealType errs[2] = {max_abs, max_err}, gerrs[2];
+    TG.Global().all_reduce_n(errs, 2, gerrs, boost::mpi3::max<>());
+    app_log() << " Half-rotated Cholesky tensors stored in single precision. Largest rounding error relative to the "
+                 "largest element: "
+              << (gerrs[0] > 0 ? gerrs[1] / gerrs[0] : 0) << std::endl;
+  }
   TG.Global().barrier();
   if (distNode.root())
   {
@@ -15,10 +15,13 @@
 #ifndef AFQMC_BUFFER_HANDLER_HPP
 #define AFQMC_BUFFER_HANDLER_HPP
 
+#include <algorithm>
 #include <cstddef>
+#include <type_traits>
 
 #include "AFQMC/config.h"
 #include "mpi3/shared_communicator.hpp"
+#include "MemoryAccounting.h"
 
 // new allocators
 #include "multi/memory/fallback.hpp"
@@ -48,6 +51,16 @@ private:
   fallback mr_;
   Constructor constr_;
 
+  // statistics of the stack resources replaced by resize
+  long peak_      = 0;
+  long hits_      = 0;
+  long fallbacks_ = 0;
+  int resizes_    = 0;
+
+  // the buffers are charged to their own tag in the memory accounting
+  static constexpr MemorySpace space = std::is_pointer<raw_pointer>::value ? MemorySpace::HOST : MemorySpace::DEVICE;
+  static int memory_tag() { return MemoryAccounting::getTagID("AFQMC buffers"); }
+
 public:
   template<class T>
   using allocator = boost::multi::memory::allocator<T, fallback, typename Constructor::template rebind<T>::other>;
@@ -58,12 +71,15 @@ public:
         _start(static_cast<pointer>(base_mr.allocate(_size, Align))),
         mr_({_start, _size}, std::addressof(base_mr)),
         constr_(c)
-  {}
+  {
+    getMemoryAccounting().add(memory_tag(), space, _size);
+  }
 
   ~BufferAllocatorGenerator()
   {
     if (_start != nullptr)
       base_mr.deallocate(static_cast<raw_pointer>(_start), _size);
+    getMemoryAccounting().remove(memory_tag(), space, _size);
   }
 
   // sets _size to mr_.max_needed() and creates a new mr_ with capacity _size.
@@ -82,15 +98,32 @@ public:
       //          mr_.reset();
       if (_size > 0)
         base_mr.deallocate(static_cast<raw_pointer>(_start), _size);
+      getMemoryAccounting().remove(memory_tag(), space, _size);
       _size  = new_size + 1024;
+      getMemoryAccounting().add(memory_tag(), space, _size);
       _start = static_cast<pointer>(base_mr.allocate(_size, Align));
       // useful to set to zero in GPUs
       using std::fill_n;
       fill_n(_start, _size, base_element(0));
+      peak_ = high_water_mark();
+      hits_ += mr_.hits();
+      fallbacks_ += mr_.fallbacks();
+      ++resizes_;
       mr_ = fallback{{_start, _size}, std::addressof(base_mr)};
     }
   }
 
+  // current capacity of the buffer in bytes
+  long size() const { return _size; }
+  // largest number of bytes simultaneously in use since construction, including fallback allocations
+  long high_water_mark() const { return std::max(peak_, long(mr_.max_needed())); }
+  // number of allocations since construction, served by the buffer or by the fallback resource
+  long allocations() const { return hits_ + mr_.hits() + fallbacks(); }
+  // number of allocations that did not fit in the buffer
+  long fallbacks() const { return fallbacks_ + mr_.fallbacks(); }
+  // number of times the buffer was reallocated
+  int resizes() const { return resizes_; }
+
   template<class T>
   allocator<T> get_allocator()
   {
@@ -12,7 +12,9 @@
 //    Lawrence Livermore National Laboratory
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <iomanip>
 #include <memory>
+#include <string>
 #include "buffer_managers.h"
 
 namespace qmcplusplus
@@ -49,6 +51,21 @@ void setup_memory_managers(mpi3::shared_communicator& node, size_t size, int nc)
 #endif
 }
 
+void setup_localTG_buffer_manager(mpi3::shared_communicator& local, size_t size)
+{
+  if (!LocalTGBufferManager::is_initialized())
+    LocalTGBufferManager local_buffer(local, size);
+}
+
+void release_localTG_buffer_manager()
+{
+#if !defined(ENABLE_CUDA) && !defined(ENABLE_HIP)
+  // the shared memory buffer lives on the communicator of the local TG, the device buffer on no communicator
+  if (LocalTGBufferManager::is_initialized())
+    LocalTGBufferManager().release();
+#endif
+}
+
 void update_memory_managers()
 {
   HostBufferManager host_buffer;
@@ -62,6 +79,46 @@ void update_memory_managers()
 #endif
 }
 
+long memory_managers_high_water_mark()
+{
+  HostBufferManager host_buffer;
+#if defined(ENABLE_CUDA) || defined(ENABLE_HIP)
+  DeviceBufferManager dev_buffer;
+  return host_buffer.get_generator().high_water_mark() + dev_buffer.get_generator().high_water_mark();
+#else
+  LocalTGBufferManager local_buffer;
+  return host_buffer.get_generator().high_water_mark() + local_buffer.get_generator().high_water_mark();
+#endif
+}
+
+template<class Generator>
+static void report_generator(std::string const& name, Generator const& gen)
+{
+  app_log() << "  " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(12) << gen.size() / 1024.0 / 1024.0 << std::setw(12) << gen.high_water_mark() / 1024.0 / 1024.0
+            << std::setw(14) << gen.allocations() << std::setw(12) << gen.fallbacks() << std::setw(9) << gen.resizes()
+            << "\n";
+}
+
+void report_memory_managers()
+{
+  app_log() << "\n  Work buffers:\n"
+            << "  " << std::left << std::setw(10) << "buffer" << std::right << std::setw(12) << "size (MB)"
+            << std::setw(12) << "peak (MB)" << std::setw(14) << "allocations" << std::setw(12) << "fallbacks"
+            << std::setw(9) << "resizes"
+            << "\n";
+  HostBufferManager host_buffer;
+  report_generator("host", host_buffer.get_generator());
+#if defined(ENABLE_CUDA) || defined(ENABLE_HIP)
+  DeviceBufferManager dev_buffer;
+  report_generator("device", dev_buffer.get_generator());
+#else
+  LocalTGBufferManager local_buffer;
+  report_generator("localTG", local_buffer.get_generator());
+#endif
+  app_log() << std::defaultfloat << std::endl;
+}
+
 void release_memory_managers()
 {
   HostBufferManager host_buffer;
@@ -25,7 +25,15 @@ namespace afqmc
 {
 void setup_memory_managers(mpi3::shared_communicator& local, size_t size);
 void setup_memory_managers(mpi3::shared_communicator& node, size_t size, int nc);
+// sets up the buffer of the local TG unless it is already set up
+void setup_localTG_buffer_manager(mpi3::shared_communicator& local, size_t size);
+// releases the buffer of the local TG before its communicator is destroyed, a no-op with devices
+void release_localTG_buffer_manager();
 void update_memory_managers();
+// largest memory in use by the work buffers since setup, in bytes, summed over the buffers
+long memory_managers_high_water_mark();
+// prints the size, high-water mark and allocation counts of the work buffers to app_log
+void report_memory_managers();
 void release_memory_managers();
 
 } // namespace afqmc
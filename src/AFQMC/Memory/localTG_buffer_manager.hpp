@@ -43,6 +43,8 @@ public:
 
   void release() { DeviceBufferManager::release(); }
 
+  static bool is_initialized() { return initialized_by_derived_class; }
+
   generator_t& get_generator()
   {
     if (not initialized_by_derived_class)
@@ -88,6 +90,8 @@ public:
     return *generator;
   }
 
+  static bool is_initialized() { return bool(generator); }
+
 protected:
   // static pointers to global objects
   //static generator_t* generator;
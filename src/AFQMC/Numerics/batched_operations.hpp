@@ -52,14 +52,15 @@ void batched_dot_wabn_wban(int nbatch,
   {
     for (int w = 0; w < nwalk; ++w)
     {
-      std::complex<Q> E_(0.0);
+      std::complex<T> E_(0.0);
       auto A_(Tab + (2 * batch * nwalk + w) * nocc2nc);
       auto B_(Tab + ((2 * batch + 1) * nwalk + w) * nocc2nc);
       using ma::dot;
       for (int a = 0; a < nocc; ++a)
         for (int b = 0; b < nocc; ++b)
-          E_ += ma::dot(nchol, A_ + (a * nocc + b) * nchol, 1, B_ + (b * nocc + a) * nchol, 1);
-      y[w * incy] += static_cast<std::complex<T>>(alpha[batch] * E_);
+          E_ += static_cast<std::complex<T>>(
+              ma::dot(nchol, A_ + (a * nocc + b) * nchol, 1, B_ + (b * nocc + a) * nchol, 1));
+      y[w * incy] += static_cast<std::complex<T>>(alpha[batch]) * E_;
     }
   }
 }
@@ -79,14 +80,15 @@ void batched_dot_wanb_wbna(int nbatch,
   {
     for (int w = 0; w < nwalk; ++w)
     {
-      std::complex<Q> E_(0.0);
+      std::complex<T> E_(0.0);
       auto A_(Tab + (2 * batch * nwalk + w) * nocc2nc);
       auto B_(Tab + ((2 * batch + 1) * nwalk + w) * nocc2nc);
       using ma::dot;
       for (int a = 0; a < nocc; ++a)
         for (int b = 0; b < nocc; ++b)
-          E_ += ma::dot(nchol, A_ + a * nocc * nchol + b, nocc, B_ + b * nocc * nchol + a, nocc);
-      y[w * incy] += static_cast<std::complex<T>>(alpha[batch] * E_);
+          E_ += static_cast<std::complex<T>>(
+              ma::dot(nchol, A_ + a * nocc * nchol + b, nocc, B_ + b * nocc * nchol + a, nocc));
+      y[w * incy] += static_cast<std::complex<T>>(alpha[batch]) * E_;
     }
   }
 }
@@ -103,13 +105,14 @@ void dot_wabn(int nwalk,
   int nocc2nc = nocc * nocc * nchol;
   for (int w = 0; w < nwalk; ++w)
   {
-    std::complex<Q> E_(0.0);
+    std::complex<T> E_(0.0);
     auto A_(Tab + w * nocc2nc);
     using ma::dot;
     for (int a = 0; a < nocc; ++a)
       for (int b = 0; b < nocc; ++b)
-        E_ += ma::dot(nchol, A_ + (a * nocc + b) * nchol, 1, A_ + (b * nocc + a) * nchol, 1);
-    y[w * incy] += static_cast<std::complex<T>>(alpha * E_);
+        E_ += static_cast<std::complex<T>>(
+            ma::dot(nchol, A_ + (a * nocc + b) * nchol, 1, A_ + (b * nocc + a) * nchol, 1));
+    y[w * incy] += static_cast<std::complex<T>>(alpha) * E_;
   }
 }
 
@@ -157,13 +160,14 @@ void dot_wanb(int nwalk,
   int nocc2nc = nocc * nchol * nocc;
   for (int w = 0; w < nwalk; ++w)
   {
-    std::complex<Q> E_(0.0);
+    std::complex<T> E_(0.0);
     auto A_(Tab + w * nocc2nc);
     using ma::dot;
     for (int a = 0; a < nocc; ++a)
       for (int b = 0; b < nocc; ++b)
-        E_ += ma::dot(nchol, A_ + a * nocc * nchol + b, nocc, A_ + b * nocc * nchol + a, nocc);
-    y[w * incy] += static_cast<std::complex<T>>(alpha * E_);
+        E_ += static_cast<std::complex<T>>(
+            ma::dot(nchol, A_ + a * nocc * nchol + b, nocc, A_ + b * nocc * nchol + a, nocc));
+    y[w * incy] += static_cast<std::complex<T>>(alpha) * E_;
   }
 }
 
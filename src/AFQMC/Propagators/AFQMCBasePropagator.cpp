@@ -1,4 +1,6 @@
 
+#include <algorithm>
+#include <cmath>
 #include "Configuration.h"
 #include "Utilities/FairDivide.h"
 #include "AFQMC/Memory/utilities.hpp"
@@ -32,6 +34,7 @@ void AFQMCBasePropagator::parse(xmlNodePtr cur)
   // this is wrong!!! must get batched capability from SDet, not from input
   nbatched_propagation = 0;
   nbatched_qr          = 0;
+  nbatch_memory        = 0.0;
   if (number_of_devices() > 0)
     nbatched_propagation = -1;
   if (number_of_devices() > 0)
@@ -63,6 +66,8 @@ void AFQMCBasePropagator::parse(xmlNodePtr cur)
     m_param.add(nbatched_propagation, "nbatch");
   if (TG.TG_local().size() == 1)
     m_param.add(nbatched_qr, "nbatch_qr");
+  if (TG.TG_local().size() == 1)
+    m_param.add(nbatch_memory, "nbatch_memory");
   m_param.add(freep, "free_projection");
 
   //m_param.add(sz_pin_field_file,"sz_pinning_field_file");
@@ -92,6 +97,9 @@ void AFQMCBasePropagator::parse(xmlNodePtr cur)
     app_log() << " Using batched propagation with a batch size: " << nbatched_propagation << "\n";
   else
     app_log() << " Using sequential propagation. \n";
+  if (nbatched_propagation != 0 && nbatch_memory > 0.0)
+    app_log() << " Sizing the propagation batches to " << nbatch_memory
+              << " MB of work buffers after the first step.\n";
   if (nbatched_qr != 0)
     app_log() << " Using batched orthogonalization in back propagation with a batch size: " << nbatched_qr << "\n";
   else
@@ -171,6 +179,20 @@ void AFQMCBasePropagator::parse(xmlNodePtr cur)
   app_log() << std::endl;
 }
 
+void AFQMCBasePropagator::size_batches_to_memory(int max_batch)
+{
+  using qmcplusplus::app_log;
+  double per_walker = std::max(1.0, double(memory_managers_high_water_mark()));
+  double nb         = std::floor(nbatch_memory * 1024.0 * 1024.0 / per_walker);
+  nbatched_propagation = int(std::max(1.0, std::min(nb, double(std::max(max_batch, 1)))));
+  app_log() << " Work buffer high-water mark with one walker per batch: " << per_walker / 1024.0 / 1024.0
+            << " MB. \n"
+            << " Using batched propagation with a batch size: " << nbatched_propagation << "\n";
+  if (nb < 1.0)
+    app_log() << " WARNING: nbatch_memory is smaller than the memory needed by a single walker. \n";
+  nbatch_memory = 0.0;
+}
+
 void AFQMCBasePropagator::reset_nextra(int nextra)
 {
   if (nextra <= 0)
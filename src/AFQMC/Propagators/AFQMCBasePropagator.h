@@ -109,6 +109,7 @@ public:
         order(6),
         nbatched_propagation(0),
         nbatched_qr(0),
+        nbatch_memory(0.0),
         spin_dependent_P1(false)
   {
     P1.reserve(2);
@@ -128,6 +129,16 @@ public:
   template<class WlkSet>
   void Propagate(int steps, WlkSet& wset, RealType E1, RealType dt, int fix_bias = 1)
   {
+    if (nbatch_memory > 0.0 && nbatched_propagation != 0 && steps > 0)
+    {
+      // the first step propagates one walker per batch, the high-water mark of the work buffers
+      // after it is an upper bound of the memory needed by each walker in a batch
+      nbatched_propagation = 1;
+      step(1, wset, E1, dt);
+      size_batches_to_memory(wset.capacity());
+      update_memory_managers();
+      steps--;
+    }
     int nblk   = steps / fix_bias;
     int nextra = steps % fix_bias;
     for (int i = 0; i < nblk; i++)
@@ -149,6 +160,16 @@ public:
 
   bool free_propagation() { return free_projection; }
 
+  // replaces the nbatch and nbatch_memory input, like nbatch it applies only with one core per local TG
+  void set_batch_size(int nbatch)
+  {
+    if (TG.TG_local().size() == 1)
+    {
+      nbatched_propagation = nbatch;
+      nbatch_memory        = 0.0;
+    }
+  }
+
   int global_number_of_cholesky_vectors() const { return wfn.global_number_of_cholesky_vectors(); }
 
   // in case P1 needs to exist before call to Propagate is executed
@@ -202,6 +223,8 @@ protected:
   int order;
   int nbatched_propagation;
   int nbatched_qr;
+  // memory in MB of the work buffers used to size the propagation batches, 0 to keep nbatch
+  double nbatch_memory;
   bool spin_dependent_P1;
   bool printP1eV = false;
 
@@ -244,6 +267,9 @@ protected:
 
   void reset_nextra(int nextra);
 
+  // sets nbatched_propagation from nbatch_memory and the high-water mark of the work buffers
+  void size_batches_to_memory(int max_batch);
+
   void parse(xmlNodePtr cur);
 
   template<class WSet>
@@ -71,6 +71,8 @@ public:
   }
 
   void generateP1(int, WALKER_TYPES) { throw std::runtime_error("calling visitor on dummy_Propagator object"); }
+
+  void set_batch_size(int) { throw std::runtime_error("calling visitor on dummy_Propagator object"); }
 };
 } // namespace dummy
 
@@ -114,6 +116,11 @@ public:
     boost::apply_visitor([&](auto&& a) { a.generateP1(std::forward<Args>(args)...); }, *this);
   }
 
+  void set_batch_size(int nbatch)
+  {
+    boost::apply_visitor([&](auto&& a) { a.set_batch_size(nbatch); }, *this);
+  }
+
   bool hybrid_propagation()
   {
     return boost::apply_visitor([&](auto&& a) { return a.hybrid_propagation(); }, *this);
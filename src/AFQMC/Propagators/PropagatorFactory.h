@@ -71,6 +71,15 @@ public:
       return p0->second;
   }
 
+  // builds a Propagator from the xml block ID without registering it, e.g. on a trial task group layout
+  Propagator buildDetachedPropagator(TaskGroup_& TG, const std::string& ID, Wavefunction& wfn, RandomGenerator* rng)
+  {
+    auto xml = xmlBlocks.find(ID);
+    if (xml == xmlBlocks.end())
+      APP_ABORT(" Error in PropagatorFactory::buildDetachedPropagator(string&): Missing xml block. \n");
+    return buildPropagator(TG, xml->second, wfn, rng);
+  }
+
   xmlNodePtr getXML(const std::string& ID)
   {
     auto xml = xmlBlocks.find(ID);
@@ -72,6 +72,12 @@ public:
     boost::apply_visitor([&](auto&& a) { a.BatchedOverlap(std::forward<Args>(args)...); }, *this);
   }
 
+  template<class... Args>
+  void StackedOverlap(Args&&... args)
+  {
+    boost::apply_visitor([&](auto&& a) { a.StackedOverlap(std::forward<Args>(args)...); }, *this);
+  }
+
   template<class... Args>
   void BatchedPropagate(Args&&... args)
   {
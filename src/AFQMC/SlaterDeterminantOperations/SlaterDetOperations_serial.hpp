@@ -311,6 +311,28 @@ public:
                                                   herm);
   }
 
+  // overlaps of nw equally strided walkers with the references stacked in hermA, see batched::StackedOverlap
+  template<class MatA, class PtrB, class TVec>
+  void StackedOverlap(MatA const& hermA,
+                      int nref,
+                      PtrB B,
+                      int ldb,
+                      int strideB,
+                      int nw,
+                      T LogOverlapFactor,
+                      TVec&& ovlp)
+  {
+    if (nw == 0)
+      return;
+    int NEL    = hermA.size(0) / nref;
+    int nbatch = nw * nref;
+    assert(ovlp.size() == nbatch);
+    TTensor TNN3D({nbatch, NEL, NEL}, buffer_manager.get_generator().template get_allocator<T>());
+    IVector IWORK(iextensions<1u>{nbatch * (NEL + 1)}, buffer_manager.get_generator().template get_allocator<int>());
+    SlaterDeterminantOperations::batched::StackedOverlap(hermA, B, ldb, strideB, nw, LogOverlapFactor,
+                                                         std::forward<TVec>(ovlp), TNN3D, IWORK);
+  }
+
   template<class MatA, class PTR>
   void BatchedOrthogonalize(std::vector<MatA>& Ai, T LogOverlapFactor, PTR detR)
   {
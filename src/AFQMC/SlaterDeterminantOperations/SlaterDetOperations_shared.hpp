@@ -239,6 +239,19 @@ public:
     APP_ABORT(" Error: Batched routines not compatible with SlaterDetOperations_shared::BatchedOverlap \n");
   }
 
+  template<class MatA, class PtrB, class TVec>
+  void StackedOverlap(MatA const& hermA,
+                      int nref,
+                      PtrB B,
+                      int ldb,
+                      int strideB,
+                      int nw,
+                      T LogOverlapFactor,
+                      TVec&& ovlp)
+  {
+    APP_ABORT(" Error: Batched routines not compatible with SlaterDetOperations_shared::StackedOverlap \n");
+  }
+
   template<class MatA, class MatP1, class MatV>
   void BatchedPropagate(std::vector<MatA>& Ai,
                         const MatP1& P1,
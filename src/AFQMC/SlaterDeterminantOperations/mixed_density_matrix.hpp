@@ -1321,6 +1321,66 @@ void Overlap(std::vector<MatA>& hermA,
                                  to_address(ovlp.origin()), nbatch);
 }
 
+/*
+ * Overlaps of nw walkers with nref references stacked in a dense matrix.
+ * hermA: [nref*NEL][NMO], the hermitian conjugate of the references one after the other
+ * B: origin of the first walker, the walkers are [NMO][NEL] matrices with leading dimension ldb,
+ *    separated by strideB elements
+ * ovlp[iw*nref+iref] = det( hermA[iref] * B[iw] )
+ * All the products are done in a single strided batched gemm, since the references of a walker
+ * form a single matrix.
+ */
+template<class MatA, class PtrB, class Mat, class TVec, class IBuffer, class Tp>
+void StackedOverlap(MatA const& hermA,
+                    PtrB B,
+                    int ldb,
+                    int strideB,
+                    int nw,
+                    Tp LogOverlapFactor,
+                    TVec&& ovlp,
+                    Mat&& TNN3D,
+                    IBuffer& IWORK)
+{
+  static_assert(std::decay<MatA>::type::dimensionality == 2, " MatA::dimensionality == 2");
+  static_assert(std::decay<TVec>::type::dimensionality == 1, " TVec::dimensionality == 1");
+  static_assert(std::decay<Mat>::type::dimensionality == 3, "std::decay<Mat>::type::dimensionality == 3");
+
+  using ma::gemmStridedBatched;
+  using ma::getrfBatched;
+
+  int NMO    = hermA.size(1);
+  int NEL    = TNN3D.size(1);
+  int nref   = hermA.size(0) / NEL;
+  int nbatch = nref * nw;
+
+  assert(hermA.size(0) == nref * NEL);
+  assert(hermA.stride(1) == 1);
+  assert(TNN3D.size(0) == nbatch);
+  assert(TNN3D.size(2) == NEL);
+  assert(TNN3D.stride(1) == NEL);
+  assert(TNN3D.stride(0) == NEL * NEL);
+  assert(ovlp.size() == nbatch);
+  assert(IWORK.num_elements() >= nbatch * (NEL + 1));
+
+  using element = typename std::decay<Mat>::type::element;
+  using pointer = typename std::decay<Mat>::type::element_ptr;
+
+  // TNN3D[iw*nref+iref] = hermA[iref] * B[iw], the same hermA for all walkers
+  gemmStridedBatched('N', 'N', NEL, nref * NEL, NMO, element(1.0), ma::pointer_dispatch(B), ldb, strideB,
+                     ma::pointer_dispatch(hermA.origin()), hermA.stride(0), 0, element(0.0),
+                     ma::pointer_dispatch(TNN3D.origin()), NEL, nref * NEL * NEL, nw);
+
+  std::vector<pointer> NNarray;
+  NNarray.reserve(nbatch);
+  for (int i = 0; i < nbatch; i++)
+    NNarray.emplace_back(TNN3D[i].origin());
+
+  getrfBatched(NEL, NNarray.data(), NEL, IWORK.origin(), IWORK.origin() + nbatch * NEL, nbatch);
+
+  using ma::strided_determinant_from_getrf;
+  strided_determinant_from_getrf(NEL, NNarray[0], NEL, TNN3D.stride(0), IWORK.origin(), NEL, LogOverlapFactor,
+                                 to_address(ovlp.origin()), nbatch);
+}
 
 } // namespace batched
 
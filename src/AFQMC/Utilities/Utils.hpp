@@ -360,6 +360,22 @@ inline void memory_report()
 #endif
 }
 
+// free memory in MB, of the device in GPU builds
+inline size_t available_memory()
+{
+#ifdef ENABLE_CUDA
+  size_t free_, tot_;
+  cudaMemGetInfo(&free_, &tot_);
+  return free_ >> 20;
+#elif ENABLE_HIP
+  size_t free_, tot_;
+  hipMemGetInfo(&free_, &tot_);
+  return free_ >> 20;
+#else
+  return freemem() >> 20;
+#endif
+}
+
 // TODO: FDM : why not use standard naming convention like arch::afqmc_rand_generator?
 #if defined(ENABLE_CUDA)
 template<class T, class Dummy>
@@ -13,6 +13,8 @@
 #define QMCPLUSPLUS_AFQMC_WALKERCONTROL_HPP
 
 
+#include <algorithm>
+#include <cmath>
 #include <tuple>
 #include <cassert>
 #include <memory>
@@ -359,7 +361,13 @@ inline void SerialBranching(WalkerSet& wset,
 }
 
 /**
- * Implements the distributed comb branching algorithm.
+ * Implements the distributed comb branching algorithm (systematic resampling).
+ * The walkers of all ranks are laid in rank order on a line, each covering a segment of length abs(weight).
+ * A comb of N=global target population teeth with spacing W/N and a random offset is placed on the line and
+ * each walker is replicated once per tooth in its segment with weight W/N. The position of the segments of
+ * this rank follows from an exclusive prefix sum of the weights, so only the first tooth of each rank is
+ * gathered to obtain the new walker counts. The walkers are then exchanged point-to-point by loadBalance.
+ * This implementation requires contiguous walkers and fixed population walker sets.
  */
 template<class WalkerSet,
          class Mat,
@@ -373,7 +381,68 @@ inline void CombBranching(WalkerSet& wset,
                           Random& rng,
                           communicator& comm)
 {
-  APP_ABORT("Error: comb not implemented yet. \n");
+  int nW     = wset.size();
+  int target = wset.get_TG_target_population();
+  int ntot   = wset.get_global_target_population();
+  int nproc  = comm.size();
+
+  std::vector<std::pair<double, int>> buffer(nW);
+  boost::multi::array<ComplexType, 1> w_data(iextensions<1u>{nW});
+  wset.getProperty(WEIGHT, w_data);
+  double wloc = 0.0;
+  for (int i = 0; i < nW; ++i)
+  {
+    buffer[i] = {std::abs(w_data[i]), 0};
+    wloc += buffer[i].first;
+  }
+
+  // start of the segments of this rank and total weight
+  double wprev = 0.0, wtot = 0.0;
+  MPI_Exscan(&wloc, &wprev, 1, MPI_DOUBLE, MPI_SUM, comm.get());
+  if (comm.rank() == 0)
+    wprev = 0.0;
+  MPI_Allreduce(&wloc, &wtot, 1, MPI_DOUBLE, MPI_SUM, comm.get());
+  if (wtot <= 0.0)
+    APP_ABORT(" Error in CombBranching: All walkers have zero weight.\n");
+
+  double dw = wtot / double(ntot);
+  double u  = rng();
+  comm.broadcast_n(&u, 1, 0);
+  // tooth k sits at (k+u)*dw, index of the first tooth at or beyond x
+  auto first_tooth = [&](double x) { return std::min(ntot, std::max(0, int(std::ceil(x / dw - u)))); };
+
+  // the first tooth of every rank fixes the new walker counts, the end of the last rank is forced to ntot
+  // to keep the population exact in spite of rounding in the prefix sum
+  std::vector<int> first(nproc + 1);
+  int k0 = first_tooth(wprev);
+  MPI_Allgather(&k0, 1, MPI_INT, first.data(), 1, MPI_INT, comm.get());
+  first[0]     = 0;
+  first[nproc] = ntot;
+  for (int i = 1; i <= nproc; i++)
+    first[i] = std::max(first[i], first[i - 1]);
+  wlk_counts.resize(nproc);
+  for (int i = 0; i < nproc; i++)
+    wlk_counts[i] = first[i + 1] - first[i];
+
+  int k    = first[comm.rank()];
+  int kend = first[comm.rank() + 1];
+  double wcum = wprev;
+  for (int i = 0; i < nW; ++i)
+  {
+    wcum += buffer[i].first;
+    int kn    = (i == nW - 1) ? kend : std::min(kend, std::max(k, first_tooth(wcum)));
+    buffer[i] = {dw, kn - k};
+    k         = kn;
+  }
+
+  // reserve space for extra walkers
+  if (wlk_counts[comm.rank()] > target)
+    Wexcess.reextent(
+        {std::max(0, wlk_counts[comm.rank()] - target), wset.single_walker_size() + wset.single_walker_bp_size()});
+
+  // perform local branching
+  // walkers beyond target go in Wexcess
+  wset.branch(buffer.begin(), buffer.end(), Wexcess);
 }
 
 } // namespace afqmc
@@ -63,6 +63,15 @@ public:
       return wlk->second;
   }
 
+  // builds a WalkerSet from the xml block ID without registering it, e.g. on a trial task group layout
+  WalkerSet buildDetachedWalkerSet(TaskGroup_& TG, const std::string& ID, RandomGenerator* rng)
+  {
+    auto xml = xmlBlocks.find(ID);
+    if (xml == xmlBlocks.end())
+      APP_ABORT("Error: Missing xml Block in WalkerSetFactory::buildDetachedWalkerSet(string&). \n");
+    return buildHandler(TG, xml->second, rng);
+  }
+
   xmlNodePtr getXML(const std::string& ID)
   {
     auto xml = xmlBlocks.find(ID);
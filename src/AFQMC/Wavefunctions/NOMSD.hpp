@@ -569,6 +569,8 @@ protected:
   // eventually switched from CMatrix to SMHSparseMatrix(node)
   std::vector<devPsiT> OrbMats;
   mpi3CMatrix RefOrbMats;
+  // dense references of each spin stacked in a [ndet*NEL][NMO] matrix, built on first use by Overlap_stacked
+  std::vector<CMatrix> StackedOrbMats;
 
   std::unique_ptr<shared_mutex> mutex;
 
@@ -678,6 +680,9 @@ protected:
   template<class WlkSet, class TVec>
   void Overlap_batched(const WlkSet& wset, TVec&& Ov);
 
+  template<class WlkSet, class TVec>
+  bool Overlap_stacked(const WlkSet& wset, TVec&& Ov);
+
   template<class WlkSet>
   void Orthogonalize_batched(WlkSet& wset, bool impSamp);
 
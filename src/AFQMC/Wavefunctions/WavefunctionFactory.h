@@ -76,6 +76,21 @@ public:
       return w0->second;
   }
 
+  // builds a Wavefunction from the xml block ID without registering it, e.g. on a trial task group layout
+  Wavefunction buildDetachedWavefunction(TaskGroup_& TGprop,
+                                         TaskGroup_& TGwfn,
+                                         const std::string& ID,
+                                         WALKER_TYPES walker_type,
+                                         Hamiltonian* h,
+                                         RealType cutvn = 1e-6,
+                                         int targetNW   = 1)
+  {
+    auto xml = xmlBlocks.find(ID);
+    if (xml == xmlBlocks.end())
+      APP_ABORT(" Error in WavefunctionFactory::buildDetachedWavefunction(string&): Missing xml block. \n");
+    return buildWavefunction(TGprop, TGwfn, xml->second, walker_type, h, cutvn, targetNW);
+  }
+
   // Use this routine to check if there is a wfn associated with a given ID
   // since getWavefunction aborts if the xml block is missing
   // returns the xmlNodePtr associated with ID
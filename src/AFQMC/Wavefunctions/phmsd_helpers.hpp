@@ -108,6 +108,11 @@ inline void calculate_overlaps(int rank, int ngrp, int spin, PH_EXCT const& abij
 
 // using simple round-robin scheme for parallelization within TG_local
 // assumes that reference determinant is already on [0]
+//
+// The configuration of an excitation is the reference with the holes e[0:nex] replaced by the
+// particles e[nex:2*nex]. The terms of every excitation are accumulated as if its configuration was
+// the reference, the contraction with T is then done once for all excitations with a single product,
+// and only the O(nex^3) terms involving the holes are corrected excitation by excitation.
 template<class Array1D, class MatA, class MatB, class MatC, class PH_EXCT, class index_aos>
 inline void calculate_R(int rank,
                         int ngrp,
@@ -128,8 +133,11 @@ inline void calculate_R(int rank,
   auto refc   = abij.reference_configuration(spin);
   for (int i = 0; i < R.size(0); i++)
     std::fill_n(R[i].origin(), R.size(1), ComplexType(0));
-  int NEL = T.size(1);
-  std::vector<int> orbs(NEL);
+  int NEL  = T.size(1);
+  int Nact = T.size(0);
+  // sum of the weights of the excitations and C[p][a] = sum w * Q[p][q] with e[q+nex] = a
+  ComplexType wsum(0.0);
+  boost::multi::array<ComplexType, 2> C({NEL, Nact}, ComplexType(0.0));
   ComplexType ov_a;
   // add reference contribution!!!
   if (rank == 0)
@@ -156,7 +164,6 @@ inline void calculate_R(int rank,
       if (nd % ngrp == rank)
       {
         auto e = *it;
-        abij.get_configuration(spin, nd, orbs);
         if (nex == 1)
         {
           ov_a    = T[*((*it) + 1)][*(*it)];
@@ -190,26 +197,47 @@ inline void calculate_R(int rank,
         w *= ov_a * ov0;
         if (std::abs(w) > 1e-10)
         {
-          // add term coming from identity
-          for (int i = 0; i < NEL; ++i)
-            R[i][orbs[i]] += w;
+          // term coming from identity, the holes are occupied by the particles
+          wsum += w;
+          for (int r = 0; r < nex; ++r)
+          {
+            R[e[r]][e[r + nex]] += w;
+            R[e[r]][refc[e[r]]] -= w;
+          }
           for (int p = 0; p < nex; ++p)
           {
             auto Rp = R[e[p]];
+            auto Cp = C[e[p]];
             auto Ip = Q[p];
             for (int q = 0; q < nex; ++q)
             {
-              auto Ipq = Ip[q];
-              auto Tq  = T[e[q + nex]];
-              for (int i = 0; i < NEL; ++i)
-                Rp[orbs[i]] -= w * Ipq * Tq[i];
-              Rp[orbs[e[q]]] += w * Ipq;
+              auto wIpq = w * Ip[q];
+              auto Tq   = T[e[q + nex]];
+              Cp[e[q + nex]] += wIpq;
+              Rp[e[q + nex]] += wIpq;
+              // the columns of the holes are those of the particles, not of the reference
+              for (int r = 0; r < nex; ++r)
+              {
+                Rp[e[r + nex]] -= wIpq * Tq[e[r]];
+                Rp[refc[e[r]]] += wIpq * Tq[e[r]];
+              }
             }
           }
         }
       }
     }
   }
+  // R[p][refc[i]] += wsum * delta(p,i) - sum_a C[p][a] * T[a][i]
+  boost::multi::array<ComplexType, 2> CT({NEL, NEL});
+  ma::product(C, T, CT);
+  for (int p = 0; p < NEL; ++p)
+  {
+    auto Rp  = R[p];
+    auto CTp = CT[p];
+    for (int i = 0; i < NEL; ++i)
+      Rp[refc[i]] -= CTp[i];
+    Rp[refc[p]] += wsum;
+  }
 }
 
 template<class MatE, class MatO, class MatQ, class MatB, class MatT, class MatP, class index_aos>
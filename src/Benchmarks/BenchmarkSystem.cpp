@@ -0,0 +1,355 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BenchmarkSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <getopt.h>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "OhmmsData/Libxml2Doc.h"
+#include "Concurrency/OpenMP.h"
+#include "DeviceManager.h"
+
+namespace qmcplusplus
+{
+bool BenchmarkOptions::parse(int argc, char** argv, std::ostream& os)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "he:i:w:s:u:r:d:gnz:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'e':
+      num_electrons = std::atoi(optarg);
+      break;
+    case 'i':
+      num_ions = std::atoi(optarg);
+      break;
+    case 'w':
+      walkers_per_crowd = std::atoi(optarg);
+      break;
+    case 's':
+      steps = std::atoi(optarg);
+      break;
+    case 'u':
+      warmup_steps = std::atoi(optarg);
+      break;
+    case 'r':
+      rs = std::atof(optarg);
+      break;
+    case 'd':
+      delay_rank = std::atoi(optarg);
+      break;
+    case 'g':
+      use_gpu = true;
+      break;
+    case 'n':
+      use_j3 = false;
+      break;
+    case 'z':
+      seed = std::atoi(optarg);
+      break;
+    default:
+      printUsage(argv[0], os);
+      return false;
+    }
+  }
+  if (num_electrons < 2 || num_ions < 1 || walkers_per_crowd < 1 || steps < 1 || warmup_steps < 0 || rs <= 0.0 ||
+      delay_rank < 0)
+  {
+    os << "Invalid benchmark options." << std::endl;
+    printUsage(argv[0], os);
+    return false;
+  }
+  return true;
+}
+
+void BenchmarkOptions::printUsage(const char* app, std::ostream& os) const
+{
+  os << "usage: " << app << " [options]" << std::endl
+     << "  -e int     number of electrons, rounded up to closed shells of both spins [" << num_electrons << "]"
+     << std::endl
+     << "  -i int     number of ions [" << num_ions << "]" << std::endl
+     << "  -w int     walkers per crowd, one crowd per thread [" << walkers_per_crowd << "]" << std::endl
+     << "  -s int     timed steps [" << steps << "]" << std::endl
+     << "  -u int     warmup steps [" << warmup_steps << "]" << std::endl
+     << "  -r float   electron density rs [" << rs << "]" << std::endl
+     << "  -d int     delay rank of the determinant updates, 0 for the default [" << delay_rank << "]" << std::endl
+     << "  -g         use the offload implementations" << std::endl
+     << "  -n         no three-body Jastrow" << std::endl
+     << "  -z int     random seed [" << seed << "]" << std::endl;
+}
+
+int BenchmarkSystem::roundUpToClosedShell(int num_states)
+{
+  // the plane waves of a cubic cell with |n|^2 <= shell fill the closed shells
+  for (int nmax = 1;; nmax++)
+  {
+    std::vector<int> n2_list;
+    for (int i = -nmax; i <= nmax; i++)
+      for (int j = -nmax; j <= nmax; j++)
+        for (int k = -nmax; k <= nmax; k++)
+          n2_list.push_back(i * i + j * j + k * k);
+    std::sort(n2_list.begin(), n2_list.end());
+    // shells up to nmax^2 are complete in the enumerated cube
+    for (int shell = 0; shell <= nmax * nmax; shell++)
+    {
+      const int count = std::upper_bound(n2_list.begin(), n2_list.end(), shell) - n2_list.begin();
+      if (count >= num_states)
+        return count;
+    }
+  }
+}
+
+BenchmarkSystem::BenchmarkSystem(Communicate* comm, const BenchmarkOptions& options)
+    : electrons_per_spin_(roundUpToClosedShell((options.num_electrons + 1) / 2)),
+      cell_length_(std::cbrt(4.0 * M_PI / 3.0 * 2 * electrons_per_spin_) * options.rs),
+      ptcl_pool_(comm),
+      wf_pool_(ptcl_pool_, comm),
+      ham_pool_(ptcl_pool_, wf_pool_, comm)
+{
+  Libxml2Document particle_doc;
+  if (!particle_doc.parseFromString(makeParticleXML(options)))
+    throw std::runtime_error("BenchmarkSystem failed to parse the particle set input!");
+  xmlNodePtr sim_cell = xmlFirstElementChild(particle_doc.getRoot());
+  ptcl_pool_.readSimulationCellXML(sim_cell);
+  for (xmlNodePtr pset = xmlNextElementSibling(sim_cell); pset != nullptr; pset = xmlNextElementSibling(pset))
+    ptcl_pool_.put(pset);
+  ptcl_pool_.randomize();
+  getElectrons().update();
+
+  Libxml2Document wf_doc;
+  if (!wf_doc.parseFromString(makeWaveFunctionXML(options)))
+    throw std::runtime_error("BenchmarkSystem failed to parse the wavefunction input!");
+  wf_pool_.put(wf_doc.getRoot());
+
+  Libxml2Document ham_doc;
+  if (!ham_doc.parseFromString(makeHamiltonianXML()))
+    throw std::runtime_error("BenchmarkSystem failed to parse the hamiltonian input!");
+  ham_pool_.put(ham_doc.getRoot());
+}
+
+std::string BenchmarkSystem::makeParticleXML(const BenchmarkOptions& options) const
+{
+  // the ions carry the electron charge to keep the cell neutral
+  const double ion_charge = 2.0 * electrons_per_spin_ / options.num_ions;
+  RandomGenerator rng(options.seed);
+  std::ostringstream xml;
+  xml.precision(10);
+  xml << "<tmp>" << std::endl
+      << "<simulationcell>" << std::endl
+      << "  <parameter name=\"lattice\" units=\"bohr\">" << std::endl
+      << "    " << cell_length_ << " 0 0" << std::endl
+      << "    0 " << cell_length_ << " 0" << std::endl
+      << "    0 0 " << cell_length_ << std::endl
+      << "  </parameter>" << std::endl
+      << "  <parameter name=\"bconds\">p p p</parameter>" << std::endl
+      << "  <parameter name=\"LR_dim_cutoff\">15</parameter>" << std::endl
+      << "</simulationcell>" << std::endl
+      << "<particleset name=\"ion\" size=\"" << options.num_ions << "\">" << std::endl
+      << "  <group name=\"I\">" << std::endl
+      << "    <parameter name=\"charge\">" << ion_charge << "</parameter>" << std::endl
+      << "  </group>" << std::endl
+      << "  <attrib name=\"position\" datatype=\"posArray\" condition=\"0\">" << std::endl;
+  for (int iat = 0; iat < options.num_ions; iat++)
+  {
+    const double x = cell_length_ * rng();
+    const double y = cell_length_ * rng();
+    const double z = cell_length_ * rng();
+    xml << "    " << x << " " << y << " " << z << std::endl;
+  }
+  xml << "  </attrib>" << std::endl
+      << "</particleset>" << std::endl
+      << "<particleset name=\"e\" random=\"yes\" gpu=\"" << (options.use_gpu ? "yes" : "no") << "\">" << std::endl
+      << "  <group name=\"u\" size=\"" << electrons_per_spin_ << "\">" << std::endl
+      << "    <parameter name=\"charge\">-1</parameter>" << std::endl
+      << "  </group>" << std::endl
+      << "  <group name=\"d\" size=\"" << electrons_per_spin_ << "\">" << std::endl
+      << "    <parameter name=\"charge\">-1</parameter>" << std::endl
+      << "  </group>" << std::endl
+      << "</particleset>" << std::endl
+      << "</tmp>" << std::endl;
+  return xml.str();
+}
+
+std::string BenchmarkSystem::makeWaveFunctionXML(const BenchmarkOptions& options) const
+{
+  // smooth decaying B-spline coefficients, the values only need to keep the walkers well behaved
+  auto coefficients = [](double amplitude, int size) {
+    std::ostringstream coefs;
+    for (int i = 0; i < size; i++)
+    {
+      const double x = 1.0 - static_cast<double>(i) / size;
+      coefs << " " << amplitude * x * x;
+    }
+    return coefs.str();
+  };
+
+  std::ostringstream xml;
+  xml << "<wavefunction name=\"psi0\" target=\"e\">" << std::endl
+      << "  <sposet_builder type=\"heg\">" << std::endl
+      << "    <sposet type=\"heg\" name=\"spo_ud\" size=\"" << electrons_per_spin_ << "\"/>" << std::endl
+      << "  </sposet_builder>" << std::endl
+      << "  <determinantset>" << std::endl
+      << "    <slaterdeterminant batch=\"yes\"";
+  if (options.delay_rank > 0)
+    xml << " delay_rank=\"" << options.delay_rank << "\"";
+  if (options.use_gpu)
+    xml << " gpu=\"yes\"";
+  xml << ">" << std::endl
+      << "      <determinant id=\"updet\" group=\"u\" sposet=\"spo_ud\" size=\"" << electrons_per_spin_ << "\"/>"
+      << std::endl
+      << "      <determinant id=\"downdet\" group=\"d\" sposet=\"spo_ud\" size=\"" << electrons_per_spin_ << "\"/>"
+      << std::endl
+      << "    </slaterdeterminant>" << std::endl
+      << "  </determinantset>" << std::endl
+      << "  <jastrow name=\"J1\" type=\"One-Body\" function=\"Bspline\" source=\"ion\">" << std::endl
+      << "    <correlation elementType=\"I\" size=\"8\" cusp=\"0\">" << std::endl
+      << "      <coefficients id=\"eI\" type=\"Array\">" << coefficients(-0.5, 8) << "</coefficients>" << std::endl
+      << "    </correlation>" << std::endl
+      << "  </jastrow>" << std::endl
+      << "  <jastrow name=\"J2\" type=\"Two-Body\" function=\"Bspline\">" << std::endl
+      << "    <correlation speciesA=\"u\" speciesB=\"u\" size=\"8\">" << std::endl
+      << "      <coefficients id=\"uu\" type=\"Array\">" << coefficients(0.5, 8) << "</coefficients>" << std::endl
+      << "    </correlation>" << std::endl
+      << "    <correlation speciesA=\"u\" speciesB=\"d\" size=\"8\">" << std::endl
+      << "      <coefficients id=\"ud\" type=\"Array\">" << coefficients(1.0, 8) << "</coefficients>" << std::endl
+      << "    </correlation>" << std::endl
+      << "  </jastrow>" << std::endl;
+  if (options.use_j3)
+  {
+    // a short range three-body term as in production inputs, half the Wigner-Seitz radius
+    const double rcut = 0.25 * cell_length_;
+    xml << "  <jastrow name=\"J3\" type=\"eeI\" function=\"polynomial\" source=\"ion\">" << std::endl
+        << "    <correlation ispecies=\"I\" especies=\"u\" isize=\"3\" esize=\"3\" rcut=\"" << rcut << "\"/>"
+        << std::endl
+        << "    <correlation ispecies=\"I\" especies1=\"u\" especies2=\"d\" isize=\"3\" esize=\"3\" rcut=\"" << rcut
+        << "\"/>" << std::endl
+        << "  </jastrow>" << std::endl;
+  }
+  xml << "</wavefunction>" << std::endl;
+  return xml.str();
+}
+
+std::string BenchmarkSystem::makeHamiltonianXML() const
+{
+  return R"(
+<hamiltonian name="h0" type="generic" target="e">
+  <pairpot type="coulomb" name="ElecElec" source="e" target="e"/>
+  <pairpot type="coulomb" name="IonIon" source="ion" target="ion"/>
+  <pairpot type="coulomb" name="ElecIon" source="ion" target="e"/>
+</hamiltonian>
+)";
+}
+
+void BenchmarkSystem::printSummary(std::ostream& os, const BenchmarkOptions& options, int num_crowds) const
+{
+  os << "  electrons       " << 2 * electrons_per_spin_ << " (" << electrons_per_spin_ << " per spin)" << std::endl
+     << "  ions            " << options.num_ions << std::endl
+     << "  cell length     " << cell_length_ << " bohr, rs " << options.rs << std::endl
+     << "  Jastrow         J1 J2" << (options.use_j3 ? " J3" : "") << std::endl
+     << "  crowds          " << num_crowds << " x " << options.walkers_per_crowd << " walkers" << std::endl
+     << "  steps           " << options.steps << " timed, " << options.warmup_steps << " warmup" << std::endl
+     << "  offload         " << (options.use_gpu ? "yes" : "no") << std::endl;
+}
+
+BenchmarkCrowd::BenchmarkCrowd(BenchmarkSystem& system, int num_walkers, int seed)
+    : pset_res("ParticleSet"), twf_res("TrialWaveFunction"), ham_res("Hamiltonian"), random_gen_(seed)
+{
+  ParticleSet& golden_elecs = system.getElectrons();
+  const auto& lattice       = golden_elecs.getLattice();
+  for (int iw = 0; iw < num_walkers; iw++)
+  {
+    elecs_.push_back(std::make_unique<ParticleSet>(golden_elecs));
+    // each walker starts from its own uniform random configuration
+    ParticleSet& elecs = *elecs_.back();
+    for (int iat = 0; iat < elecs.getTotalNum(); iat++)
+      elecs.R[iat] = lattice.toCart(ParticleSet::SingleParticlePos(random_gen_(), random_gen_(), random_gen_()));
+    elecs.update();
+    twfs_.push_back(system.getTWF().makeClone(elecs));
+    hams_.push_back(system.getHamiltonian().makeClone(elecs, *twfs_.back()));
+  }
+  golden_elecs.createResource(pset_res);
+  system.getTWF().createResource(twf_res);
+  system.getHamiltonian().createResource(ham_res);
+}
+
+RefVectorWithLeader<ParticleSet> BenchmarkCrowd::getElectrons() const
+{
+  RefVectorWithLeader<ParticleSet> p_list(*elecs_[0]);
+  for (auto& elecs : elecs_)
+    p_list.push_back(*elecs);
+  return p_list;
+}
+
+RefVectorWithLeader<TrialWaveFunction> BenchmarkCrowd::getTWFs() const
+{
+  RefVectorWithLeader<TrialWaveFunction> wf_list(*twfs_[0]);
+  for (auto& twf : twfs_)
+    wf_list.push_back(*twf);
+  return wf_list;
+}
+
+RefVectorWithLeader<QMCHamiltonian> BenchmarkCrowd::getHamiltonians() const
+{
+  RefVectorWithLeader<QMCHamiltonian> ham_list(*hams_[0]);
+  for (auto& ham : hams_)
+    ham_list.push_back(*ham);
+  return ham_list;
+}
+
+void initializeBenchmarkDevices()
+{
+  Communicate node_comm;
+  node_comm.initializeAsNodeComm(*OHMMS::Controller);
+  DeviceManager::initializeGlobalDeviceManager(node_comm.rank(), node_comm.size());
+}
+
+std::vector<std::unique_ptr<BenchmarkCrowd>> makeBenchmarkCrowds(BenchmarkSystem& system,
+                                                                 const BenchmarkOptions& options)
+{
+  const int num_crowds = omp_get_max_threads();
+  std::vector<std::unique_ptr<BenchmarkCrowd>> crowds;
+  for (int ic = 0; ic < num_crowds; ic++)
+    crowds.push_back(std::make_unique<BenchmarkCrowd>(system, options.walkers_per_crowd, options.seed + 1 + ic));
+  return crowds;
+}
+
+void printKernelTimings(std::ostream& os, const TimerList_t& timers, long walker_steps)
+{
+  os << std::left << std::setw(40) << "Kernel" << std::right << std::setw(12) << "Calls" << std::setw(14) << "Total(s)"
+     << std::setw(14) << "Per call(s)" << std::setw(16) << "Per walker(s)" << std::endl;
+  const auto flags = os.flags();
+  os << std::scientific << std::setprecision(4);
+  for (NewTimer& timer : timers)
+  {
+    const long calls = timer.get_num_calls();
+    os << std::left << std::setw(40) << timer.get_name() << std::right << std::setw(12) << calls << std::setw(14)
+       << timer.get_total() << std::setw(14) << (calls > 0 ? timer.get_total() / calls : 0.0) << std::setw(16)
+       << timer.get_total() / walker_steps << std::endl;
+  }
+  os.flags(flags);
+}
+
+void writeTimingInfo(Communicate* comm)
+{
+  Libxml2Document timing_doc;
+  timing_doc.newDoc("resources");
+  timer_manager.output_timing(comm, timing_doc, timing_doc.getRoot());
+  if (comm->rank() == 0)
+    timing_doc.dump(comm->getName() + ".info.xml");
+}
+
+} // namespace qmcplusplus
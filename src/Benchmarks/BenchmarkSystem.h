@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file BenchmarkSystem.h
+ * @brief synthetic systems of production ParticleSet, TrialWaveFunction and QMCHamiltonian objects
+ *
+ * Shared by the qmc-bench-* applications. The objects are built from generated XML through the same pools
+ * and factories as qmcpack, so the benchmarks run the production kernels rather than stripped down copies.
+ */
+#ifndef QMCPLUSPLUS_BENCHMARK_SYSTEM_H
+#define QMCPLUSPLUS_BENCHMARK_SYSTEM_H
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Configuration.h"
+#include "Particle/ParticleSetPool.h"
+#include "QMCWaveFunctions/WaveFunctionPool.h"
+#include "QMCHamiltonians/HamiltonianPool.h"
+#include "Utilities/RandomGenerator.h"
+#include "Utilities/ResourceCollection.h"
+#include "Utilities/TimerManager.h"
+#include "type_traits/RefVectorWithLeader.h"
+
+namespace qmcplusplus
+{
+/** command line options of the qmc-bench-* applications
+ */
+struct BenchmarkOptions
+{
+  /// requested number of electrons, rounded up to closed shells of both spins
+  int num_electrons = 64;
+  /// number of ions placed at random in the cell
+  int num_ions = 8;
+  /// number of walkers in each crowd, one crowd per thread
+  int walkers_per_crowd = 8;
+  /// number of timed steps
+  int steps = 10;
+  /// number of untimed steps before the timed ones
+  int warmup_steps = 2;
+  /// Wigner-Seitz radius of the electrons, sets the cell size
+  double rs = 2.0;
+  /// delay rank of the determinant updates, 0 for the default
+  int delay_rank = 0;
+  /// use the offload implementations of the particle sets and determinants
+  bool use_gpu = false;
+  /// include the three-body electron-electron-ion Jastrow
+  bool use_j3 = true;
+  /// seed of the positions and the moves
+  int seed = 11;
+
+  /** parse the command line
+   * @return false if the run should stop, after -h or a bad option
+   */
+  bool parse(int argc, char** argv, std::ostream& os);
+  void printUsage(const char* app, std::ostream& os) const;
+};
+
+/** the golden objects of a synthetic system
+ *
+ * A cubic periodic cell at density rs holds num_ions ions at random positions and the electrons of
+ * two closed shell spin groups. The trial wavefunction is a Slater determinant of plane waves with
+ * B-spline one and two body Jastrows and, optionally, a polynomial electron-electron-ion Jastrow.
+ * The Hamiltonian has the kinetic energy and the electron-electron, electron-ion and ion-ion Coulomb terms.
+ */
+class BenchmarkSystem
+{
+public:
+  BenchmarkSystem(Communicate* comm, const BenchmarkOptions& options);
+
+  ParticleSet& getElectrons() { return *ptcl_pool_.getParticleSet("e"); }
+  ParticleSet& getIons() { return *ptcl_pool_.getParticleSet("ion"); }
+  TrialWaveFunction& getTWF() { return *wf_pool_.getPrimary(); }
+  QMCHamiltonian& getHamiltonian() { return *ham_pool_.getPrimary(); }
+
+  /// number of electrons of each spin after rounding up to a closed shell
+  int getElectronsPerSpin() const { return electrons_per_spin_; }
+  /// length of the cubic cell
+  double getCellLength() const { return cell_length_; }
+
+  /// smallest number of plane waves in closed shells of a cubic cell, not less than num_states
+  static int roundUpToClosedShell(int num_states);
+
+  /// print the size of the system and the run
+  void printSummary(std::ostream& os, const BenchmarkOptions& options, int num_crowds) const;
+
+private:
+  const int electrons_per_spin_;
+  const double cell_length_;
+  ParticleSetPool ptcl_pool_;
+  WaveFunctionPool wf_pool_;
+  HamiltonianPool ham_pool_;
+
+  std::string makeParticleXML(const BenchmarkOptions& options) const;
+  std::string makeWaveFunctionXML(const BenchmarkOptions& options) const;
+  std::string makeHamiltonianXML() const;
+};
+
+/** walkers of one crowd cloned from the golden objects and their shared resources
+ */
+class BenchmarkCrowd
+{
+public:
+  BenchmarkCrowd(BenchmarkSystem& system, int num_walkers, int seed);
+
+  int size() const { return elecs_.size(); }
+
+  RefVectorWithLeader<ParticleSet> getElectrons() const;
+  RefVectorWithLeader<TrialWaveFunction> getTWFs() const;
+  RefVectorWithLeader<QMCHamiltonian> getHamiltonians() const;
+
+  RandomGenerator& getRandomGen() { return random_gen_; }
+
+  ResourceCollection pset_res;
+  ResourceCollection twf_res;
+  ResourceCollection ham_res;
+
+private:
+  std::vector<std::unique_ptr<ParticleSet>> elecs_;
+  std::vector<std::unique_ptr<TrialWaveFunction>> twfs_;
+  std::vector<std::unique_ptr<QMCHamiltonian>> hams_;
+  RandomGenerator random_gen_;
+};
+
+/// assign the accelerators of the node to the ranks as qmcpack does
+void initializeBenchmarkDevices();
+
+/// one crowd of options.walkers_per_crowd walkers per OpenMP thread
+std::vector<std::unique_ptr<BenchmarkCrowd>> makeBenchmarkCrowds(BenchmarkSystem& system,
+                                                                 const BenchmarkOptions& options);
+
+/** print the time of the kernel timers of the master thread
+ * @param walker_steps number of walkers times steps of the master crowd, per walker step times are reported
+ */
+void printKernelTimings(std::ostream& os, const TimerList_t& timers, long walker_steps);
+
+/// write the timers in the format of qmcpack to <name of comm>.info.xml, read by tests/performance/process_perf.py
+void writeTimingInfo(Communicate* comm);
+
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file qmc-bench-hamiltonian.cpp
+ * @brief benchmark of the batched local energy evaluation of the production QMCHamiltonian
+ *
+ * Each step displaces all the electrons of the walkers of each crowd, updates the particle sets,
+ * evaluates the trial wavefunction from scratch for the kinetic energy and then the local energy.
+ * The time of each Hamiltonian term is in the timer report of the Hamiltonian.
+ */
+
+#include <iostream>
+#include "Configuration.h"
+#include "Message/Communicate.h"
+#include "Concurrency/ParallelExecutor.hpp"
+#include "ParticleBase/RandomSeqGenerator.h"
+#include "Platforms/Host/OutputManager.h"
+#include "Utilities/Timer.h"
+#include "BenchmarkSystem.h"
+
+using namespace qmcplusplus;
+
+enum HamiltonianBenchTimers
+{
+  HB_UPDATE,
+  HB_EVALUATE_LOG,
+  HB_EVALUATE
+};
+
+TimerNameList_t<HamiltonianBenchTimers> HamiltonianBenchTimerNames =
+    {{HB_UPDATE, "Bench::ParticleSet::mw_update"},
+     {HB_EVALUATE_LOG, "Bench::TWF::mw_evaluateLog"},
+     {HB_EVALUATE, "Bench::QMCHamiltonian::mw_evaluate"}};
+
+/// run steps local energy evaluations of the walkers of a crowd
+void runSteps(int crowd_id, std::vector<std::unique_ptr<BenchmarkCrowd>>& crowds, TimerList_t& timers, int steps)
+{
+  using PosType = QMCTraits::PosType;
+  BenchmarkCrowd& crowd = *crowds[crowd_id];
+  const auto p_list     = crowd.getElectrons();
+  const auto wf_list    = crowd.getTWFs();
+  const auto ham_list   = crowd.getHamiltonians();
+  ResourceCollectionTeamLock<ParticleSet> pset_lock(crowd.pset_res, p_list);
+  ResourceCollectionTeamLock<TrialWaveFunction> twf_lock(crowd.twf_res, wf_list);
+  ResourceCollectionTeamLock<QMCHamiltonian> ham_lock(crowd.ham_res, ham_list);
+
+  const QMCTraits::RealType sqrttau = std::sqrt(0.3);
+  std::vector<PosType> deltas(p_list.getLeader().getTotalNum());
+
+  for (int step = 0; step < steps; step++)
+  {
+    for (ParticleSet& pset : p_list)
+    {
+      makeGaussRandomWithEngine(deltas, crowd.getRandomGen());
+      for (int iat = 0; iat < deltas.size(); iat++)
+        pset.R[iat] += sqrttau * deltas[iat];
+    }
+    {
+      ScopedTimer local_timer(timers[HB_UPDATE]);
+      ParticleSet::mw_update(p_list);
+    }
+    {
+      ScopedTimer local_timer(timers[HB_EVALUATE_LOG]);
+      TrialWaveFunction::mw_evaluateLog(wf_list, p_list);
+    }
+    {
+      ScopedTimer local_timer(timers[HB_EVALUATE]);
+      QMCHamiltonian::mw_evaluate(ham_list, wf_list, p_list);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef HAVE_MPI
+  mpi3::environment env(argc, argv);
+  OHMMS::Controller->initialize(env);
+#endif
+  Communicate* comm = OHMMS::Controller;
+  comm->setName("qmc-bench-hamiltonian");
+  if (comm->rank() != 0)
+    outputManager.shutOff();
+
+  BenchmarkOptions options;
+  if (!options.parse(argc, argv, std::cerr))
+  {
+    OHMMS::Controller->finalize();
+    return 1;
+  }
+
+  initializeBenchmarkDevices();
+  timer_manager.set_timer_threshold(timer_level_fine);
+  TimerList_t timers;
+  setup_timers(timers, HamiltonianBenchTimerNames, timer_level_coarse);
+
+  BenchmarkSystem system(comm, options);
+  auto crowds = makeBenchmarkCrowds(system, options);
+
+  // pinned, the master crowd runs on the master thread which owns the reported timer values
+  ParallelExecutor<> crowd_task(true);
+  crowd_task(crowds.size(), runSteps, std::ref(crowds), std::ref(timers), options.warmup_steps);
+  timer_manager.reset();
+
+  Timer wall_clock;
+  crowd_task(crowds.size(), runSteps, std::ref(crowds), std::ref(timers), options.steps);
+  const double wall_time = wall_clock.elapsed();
+
+  if (comm->rank() == 0)
+  {
+    const long walker_steps = static_cast<long>(options.walkers_per_crowd) * options.steps;
+    std::cout << std::endl << "qmc-bench-hamiltonian" << std::endl;
+    system.printSummary(std::cout, options, crowds.size());
+    std::cout << "  wall time       " << wall_time << " s, " << crowds.size() * walker_steps / wall_time
+              << " local energies/s per rank" << std::endl
+              << std::endl
+              << "Kernels of the master crowd" << std::endl;
+    printKernelTimings(std::cout, timers, walker_steps);
+  }
+  writeTimingInfo(comm);
+  timer_manager.print(comm);
+
+  OHMMS::Controller->finalize();
+  return 0;
+}
@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file qmc-bench-particleset.cpp
+ * @brief benchmark of the batched moves of the production ParticleSet and its distance tables
+ *
+ * Each step proposes a move of every electron of the walkers of each crowd, accepts half of them,
+ * then finishes the particle-by-particle region and updates the tables from scratch.
+ */
+
+#include <iostream>
+#include "Configuration.h"
+#include "Message/Communicate.h"
+#include "Concurrency/ParallelExecutor.hpp"
+#include "ParticleBase/RandomSeqGenerator.h"
+#include "Platforms/Host/OutputManager.h"
+#include "Utilities/Timer.h"
+#include "BenchmarkSystem.h"
+
+using namespace qmcplusplus;
+
+enum ParticleSetBenchTimers
+{
+  PSB_MAKE_MOVE,
+  PSB_ACCEPT_REJECT,
+  PSB_DONE_PBYP,
+  PSB_UPDATE
+};
+
+TimerNameList_t<ParticleSetBenchTimers> ParticleSetBenchTimerNames =
+    {{PSB_MAKE_MOVE, "Bench::ParticleSet::mw_makeMove"},
+     {PSB_ACCEPT_REJECT, "Bench::ParticleSet::mw_accept_rejectMove"},
+     {PSB_DONE_PBYP, "Bench::ParticleSet::mw_donePbyP"},
+     {PSB_UPDATE, "Bench::ParticleSet::mw_update"}};
+
+/// run steps sweeps over the walkers of a crowd
+void runSweeps(int crowd_id, std::vector<std::unique_ptr<BenchmarkCrowd>>& crowds, TimerList_t& timers, int steps)
+{
+  using PosType = QMCTraits::PosType;
+  BenchmarkCrowd& crowd = *crowds[crowd_id];
+  const auto p_list     = crowd.getElectrons();
+  ResourceCollectionTeamLock<ParticleSet> pset_lock(crowd.pset_res, p_list);
+
+  const int num_walkers = crowd.size();
+  const int num_ptcls   = p_list.getLeader().getTotalNum();
+  const QMCTraits::RealType sqrttau = std::sqrt(0.3);
+
+  std::vector<PosType> deltas(num_walkers * num_ptcls);
+  std::vector<PosType> displs(num_walkers);
+  std::vector<bool> is_accepted(num_walkers);
+
+  for (int step = 0; step < steps; step++)
+  {
+    makeGaussRandomWithEngine(deltas, crowd.getRandomGen());
+    for (int iat = 0; iat < num_ptcls; iat++)
+    {
+      for (int iw = 0; iw < num_walkers; iw++)
+        displs[iw] = sqrttau * deltas[iat * num_walkers + iw];
+      {
+        ScopedTimer local_timer(timers[PSB_MAKE_MOVE]);
+        ParticleSet::mw_makeMove(p_list, iat, displs);
+      }
+      for (int iw = 0; iw < num_walkers; iw++)
+        is_accepted[iw] = crowd.getRandomGen()() < 0.5;
+      {
+        ScopedTimer local_timer(timers[PSB_ACCEPT_REJECT]);
+        ParticleSet::mw_accept_rejectMove(p_list, iat, is_accepted);
+      }
+    }
+    {
+      ScopedTimer local_timer(timers[PSB_DONE_PBYP]);
+      ParticleSet::mw_donePbyP(p_list);
+    }
+    {
+      ScopedTimer local_timer(timers[PSB_UPDATE]);
+      ParticleSet::mw_update(p_list);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef HAVE_MPI
+  mpi3::environment env(argc, argv);
+  OHMMS::Controller->initialize(env);
+#endif
+  Communicate* comm = OHMMS::Controller;
+  comm->setName("qmc-bench-particleset");
+  if (comm->rank() != 0)
+    outputManager.shutOff();
+
+  BenchmarkOptions options;
+  if (!options.parse(argc, argv, std::cerr))
+  {
+    OHMMS::Controller->finalize();
+    return 1;
+  }
+
+  initializeBenchmarkDevices();
+  timer_manager.set_timer_threshold(timer_level_fine);
+  TimerList_t timers;
+  setup_timers(timers, ParticleSetBenchTimerNames, timer_level_coarse);
+
+  BenchmarkSystem system(comm, options);
+  auto crowds = makeBenchmarkCrowds(system, options);
+
+  // pinned, the master crowd runs on the master thread which owns the reported timer values
+  ParallelExecutor<> crowd_task(true);
+  crowd_task(crowds.size(), runSweeps, std::ref(crowds), std::ref(timers), options.warmup_steps);
+  timer_manager.reset();
+
+  Timer wall_clock;
+  crowd_task(crowds.size(), runSweeps, std::ref(crowds), std::ref(timers), options.steps);
+  const double wall_time = wall_clock.elapsed();
+
+  if (comm->rank() == 0)
+  {
+    const long walker_steps = static_cast<long>(options.walkers_per_crowd) * options.steps;
+    std::cout << std::endl << "qmc-bench-particleset" << std::endl;
+    system.printSummary(std::cout, options, crowds.size());
+    std::cout << "  wall time       " << wall_time << " s, "
+              << crowds.size() * walker_steps * 2 * system.getElectronsPerSpin() / wall_time
+              << " electron moves/s per rank" << std::endl
+              << std::endl
+              << "Kernels of the master crowd" << std::endl;
+    printKernelTimings(std::cout, timers, walker_steps);
+  }
+  writeTimingInfo(comm);
+  timer_manager.print(comm);
+
+  OHMMS::Controller->finalize();
+  return 0;
+}
@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file qmc-bench-wavefunction.cpp
+ * @brief benchmark of the batched particle-by-particle moves of the production TrialWaveFunction
+ *
+ * Each step sweeps all the electrons of the walkers of each crowd through the mw_ calls of VMCBatched
+ * with drift, prepareGroup, evalGrad, makeMove, calcRatioGrad and accept_rejectMove,
+ * then completes the updates and evaluates the gradients and laplacians.
+ */
+
+#include <iostream>
+#include "Configuration.h"
+#include "Message/Communicate.h"
+#include "Concurrency/ParallelExecutor.hpp"
+#include "ParticleBase/RandomSeqGenerator.h"
+#include "Platforms/Host/OutputManager.h"
+#include "Utilities/Timer.h"
+#include "type_traits/ConvertToReal.h"
+#include "BenchmarkSystem.h"
+
+using namespace qmcplusplus;
+
+enum WaveFunctionBenchTimers
+{
+  WFB_EVALUATE_LOG,
+  WFB_PREPARE_GROUP,
+  WFB_EVAL_GRAD,
+  WFB_MAKE_MOVE,
+  WFB_RATIO_GRAD,
+  WFB_ACCEPT_REJECT,
+  WFB_COMPLETE_UPDATES,
+  WFB_DONE_PBYP,
+  WFB_EVALUATE_GL
+};
+
+TimerNameList_t<WaveFunctionBenchTimers> WaveFunctionBenchTimerNames =
+    {{WFB_EVALUATE_LOG, "Bench::TWF::mw_evaluateLog"},
+     {WFB_PREPARE_GROUP, "Bench::TWF::mw_prepareGroup"},
+     {WFB_EVAL_GRAD, "Bench::TWF::mw_evalGrad"},
+     {WFB_MAKE_MOVE, "Bench::ParticleSet::mw_makeMove"},
+     {WFB_RATIO_GRAD, "Bench::TWF::mw_calcRatioGrad"},
+     {WFB_ACCEPT_REJECT, "Bench::mw_accept_rejectMove"},
+     {WFB_COMPLETE_UPDATES, "Bench::TWF::mw_completeUpdates"},
+     {WFB_DONE_PBYP, "Bench::ParticleSet::mw_donePbyP"},
+     {WFB_EVALUATE_GL, "Bench::TWF::mw_evaluateGL"}};
+
+/// run steps sweeps over the walkers of a crowd
+void runSweeps(int crowd_id, std::vector<std::unique_ptr<BenchmarkCrowd>>& crowds, TimerList_t& timers, int steps)
+{
+  using PosType = QMCTraits::PosType;
+  BenchmarkCrowd& crowd = *crowds[crowd_id];
+  const auto p_list     = crowd.getElectrons();
+  const auto wf_list    = crowd.getTWFs();
+  ResourceCollectionTeamLock<ParticleSet> pset_lock(crowd.pset_res, p_list);
+  ResourceCollectionTeamLock<TrialWaveFunction> twf_lock(crowd.twf_res, wf_list);
+
+  const int num_walkers = crowd.size();
+  const int num_ptcls   = p_list.getLeader().getTotalNum();
+  // the time step of a typical VMC run, drift included
+  const QMCTraits::RealType tau     = 0.3;
+  const QMCTraits::RealType sqrttau = std::sqrt(tau);
+
+  std::vector<PosType> deltas(num_walkers * num_ptcls);
+  std::vector<PosType> displs(num_walkers);
+  std::vector<TrialWaveFunction::GradType> grads_now(num_walkers);
+  std::vector<TrialWaveFunction::GradType> grads_new(num_walkers);
+  std::vector<TrialWaveFunction::PsiValueType> ratios(num_walkers);
+  std::vector<bool> is_accepted(num_walkers);
+
+  ParticleSet::mw_update(p_list);
+  {
+    ScopedTimer local_timer(timers[WFB_EVALUATE_LOG]);
+    TrialWaveFunction::mw_evaluateLog(wf_list, p_list);
+  }
+
+  for (int step = 0; step < steps; step++)
+  {
+    makeGaussRandomWithEngine(deltas, crowd.getRandomGen());
+    for (int ig = 0; ig < p_list.getLeader().groups(); ig++)
+    {
+      {
+        ScopedTimer local_timer(timers[WFB_PREPARE_GROUP]);
+        TrialWaveFunction::mw_prepareGroup(wf_list, p_list, ig);
+      }
+      for (int iat = p_list.getLeader().first(ig); iat < p_list.getLeader().last(ig); iat++)
+      {
+        {
+          ScopedTimer local_timer(timers[WFB_EVAL_GRAD]);
+          TrialWaveFunction::mw_evalGrad(wf_list, p_list, iat, grads_now);
+        }
+        for (int iw = 0; iw < num_walkers; iw++)
+        {
+          PosType drift;
+          convertToReal(grads_now[iw], drift);
+          displs[iw] = tau * drift + sqrttau * deltas[iat * num_walkers + iw];
+        }
+        {
+          ScopedTimer local_timer(timers[WFB_MAKE_MOVE]);
+          ParticleSet::mw_makeMove(p_list, iat, displs);
+        }
+        {
+          ScopedTimer local_timer(timers[WFB_RATIO_GRAD]);
+          TrialWaveFunction::mw_calcRatioGrad(wf_list, p_list, iat, ratios, grads_new);
+        }
+        for (int iw = 0; iw < num_walkers; iw++)
+          is_accepted[iw] = crowd.getRandomGen()() < std::norm(ratios[iw]);
+        {
+          ScopedTimer local_timer(timers[WFB_ACCEPT_REJECT]);
+          TrialWaveFunction::mw_accept_rejectMove(wf_list, p_list, iat, is_accepted, true);
+          ParticleSet::mw_accept_rejectMove(p_list, iat, is_accepted);
+        }
+      }
+    }
+    {
+      ScopedTimer local_timer(timers[WFB_COMPLETE_UPDATES]);
+      TrialWaveFunction::mw_completeUpdates(wf_list);
+    }
+    {
+      ScopedTimer local_timer(timers[WFB_DONE_PBYP]);
+      ParticleSet::mw_donePbyP(p_list);
+    }
+    {
+      ScopedTimer local_timer(timers[WFB_EVALUATE_GL]);
+      TrialWaveFunction::mw_evaluateGL(wf_list, p_list, false);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef HAVE_MPI
+  mpi3::environment env(argc, argv);
+  OHMMS::Controller->initialize(env);
+#endif
+  Communicate* comm = OHMMS::Controller;
+  comm->setName("qmc-bench-wavefunction");
+  if (comm->rank() != 0)
+    outputManager.shutOff();
+
+  BenchmarkOptions options;
+  if (!options.parse(argc, argv, std::cerr))
+  {
+    OHMMS::Controller->finalize();
+    return 1;
+  }
+
+  initializeBenchmarkDevices();
+  timer_manager.set_timer_threshold(timer_level_fine);
+  TimerList_t timers;
+  setup_timers(timers, WaveFunctionBenchTimerNames, timer_level_coarse);
+
+  BenchmarkSystem system(comm, options);
+  auto crowds = makeBenchmarkCrowds(system, options);
+
+  // pinned, the master crowd runs on the master thread which owns the reported timer values
+  ParallelExecutor<> crowd_task(true);
+  crowd_task(crowds.size(), runSweeps, std::ref(crowds), std::ref(timers), options.warmup_steps);
+  timer_manager.reset();
+
+  Timer wall_clock;
+  crowd_task(crowds.size(), runSweeps, std::ref(crowds), std::ref(timers), options.steps);
+  const double wall_time = wall_clock.elapsed();
+
+  if (comm->rank() == 0)
+  {
+    const long walker_steps = static_cast<long>(options.walkers_per_crowd) * options.steps;
+    std::cout << std::endl << "qmc-bench-wavefunction" << std::endl;
+    system.printSummary(std::cout, options, crowds.size());
+    std::cout << "  wall time       " << wall_time << " s, "
+              << crowds.size() * walker_steps * 2 * system.getElectronsPerSpin() / wall_time
+              << " electron moves/s per rank" << std::endl
+              << std::endl
+              << "Kernels of the master crowd" << std::endl;
+    printKernelTimings(std::cout, timers, walker_steps);
+  }
+  writeTimingInfo(comm);
+  timer_manager.print(comm);
+
+  OHMMS::Controller->finalize();
+  return 0;
+}
@@ -35,12 +35,26 @@ template<Executor TT = Executor::OPENMP>
 class ParallelExecutor
 {
 public:
+  /** @param pinned_tasks if true, task i always runs on worker i % number of workers,
+   *  so that the memory first touched by a task stays local to it on NUMA systems.
+   *  Otherwise the tasks are picked up by the idle workers.
+   *  @param threads_per_task threads of the parallel regions nested in each task, BLAS calls included.
+   *  The workers are reduced so that workers * threads_per_task does not exceed the available threads.
+   */
+  explicit ParallelExecutor(bool pinned_tasks = false, int threads_per_task = 1)
+      : pinned_tasks_(pinned_tasks), threads_per_task_(threads_per_task < 1 ? 1 : threads_per_task)
+  {}
+
   /** Concurrently execute an arbitrary function/kernel with task id and arbitrary args
    *
    *  ie each task will run f(int task_id, Args... args)
    */
   template<typename F, typename... Args>
   void operator()(int num_tasks, F&& f, Args&&... args);
+
+private:
+  const bool pinned_tasks_;
+  const int threads_per_task_;
 };
 
 } // namespace qmcplusplus
@@ -17,6 +17,7 @@
 #ifndef QMCPLUSPLUS_PARALLELEXECUTOR_OPENMP_HPP
 #define QMCPLUSPLUS_PARALLELEXECUTOR_OPENMP_HPP
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 
@@ -26,6 +27,42 @@
 
 namespace qmcplusplus
 {
+enum class ParallelTaskStatus
+{
+  DONE,
+  NESTED_THROW,
+  THROW
+};
+
+/// run one task, an exception is reported by the status since it cannot leave the OpenMP parallel region
+template<typename F, typename... Args>
+ParallelTaskStatus runParallelTask(const std::string& nesting_error,
+                                   int threads_per_task,
+                                   int task_id,
+                                   F&& f,
+                                   Args&&... args)
+{
+  try
+  {
+    // sizes the parallel regions opened by the task, getNextLevelNumThreads and the BLAS calls follow it
+    if (threads_per_task > 1)
+      omp_set_num_threads(threads_per_task);
+    f(task_id, std::forward<Args>(args)...);
+  }
+  catch (const std::runtime_error& re)
+  {
+    if (nesting_error == re.what())
+      return ParallelTaskStatus::NESTED_THROW;
+    app_error() << re.what() << std::flush;
+    return ParallelTaskStatus::THROW;
+  }
+  catch (...)
+  {
+    return ParallelTaskStatus::THROW;
+  }
+  return ParallelTaskStatus::DONE;
+}
+
 /** implements parallel tasks executed by threads in an OpenMP thread pool.
  *
  *  This specialization throws below the top openmp theading level
@@ -41,28 +78,44 @@ void ParallelExecutor<Executor::OPENMP>::operator()(int num_tasks, F&& f, Args&&
     throw std::runtime_error(nesting_error);
   int nested_throw_count = 0;
   int throw_count        = 0;
-#pragma omp parallel for reduction(+ : nested_throw_count, throw_count)
-  for (int task_id = 0; task_id < num_tasks; ++task_id)
+  int num_workers        = omp_get_max_threads();
+  const int max_levels   = omp_get_max_active_levels();
+  // never more threads per task than available
+  const int threads_per_task = std::min(threads_per_task_, num_workers);
+  if (threads_per_task > 1)
   {
-    try
-    {
-      f(task_id, std::forward<Args>(args)...);
-    }
-    catch (const std::runtime_error& re)
+    num_workers = std::max(1, std::min(num_tasks, num_workers / threads_per_task));
+    if (max_levels < 2)
+      omp_set_max_active_levels(2);
+  }
+  if (pinned_tasks_)
+  {
+#pragma omp parallel for num_threads(num_workers) schedule(static, 1) \
+    reduction(+ : nested_throw_count, throw_count)
+    for (int task_id = 0; task_id < num_tasks; ++task_id)
     {
-      if (nesting_error == re.what())
-        ++nested_throw_count;
-      else
-      {
-        app_error() << re.what() << std::flush;
-        ++throw_count;
-      }
+      const ParallelTaskStatus status =
+          runParallelTask(nesting_error, threads_per_task, task_id, f, std::forward<Args>(args)...);
+      nested_throw_count += status == ParallelTaskStatus::NESTED_THROW;
+      throw_count += status == ParallelTaskStatus::THROW;
     }
-    catch (...)
+  }
+  else
+  {
+    // tasks of uneven cost, e.g. crowds recomputing more walkers or more crowds than threads,
+    // are picked up by the threads that become idle.
+#pragma omp parallel for num_threads(num_workers) schedule(dynamic, 1) \
+    reduction(+ : nested_throw_count, throw_count)
+    for (int task_id = 0; task_id < num_tasks; ++task_id)
     {
-      ++throw_count;
+      const ParallelTaskStatus status =
+          runParallelTask(nesting_error, threads_per_task, task_id, f, std::forward<Args>(args)...);
+      nested_throw_count += status == ParallelTaskStatus::NESTED_THROW;
+      throw_count += status == ParallelTaskStatus::THROW;
     }
   }
+  if (threads_per_task > 1 && max_levels < 2)
+    omp_set_max_active_levels(max_levels);
   if (throw_count > 0)
     throw std::runtime_error("Unexpected exception thrown in threaded section");
   else if (nested_throw_count > 0)
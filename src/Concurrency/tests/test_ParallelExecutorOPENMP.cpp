@@ -11,6 +11,7 @@
 
 #include "catch.hpp"
 
+#include <vector>
 #include "Concurrency/ParallelExecutor.hpp"
 
 namespace qmcplusplus
@@ -48,6 +49,45 @@ TEST_CASE("ParallelExecutor<OPENMP> lambda case", "[concurrency]")
   REQUIRE(count == num_threads);
 }
 
+TEST_CASE("ParallelExecutor<OPENMP> pinned tasks", "[concurrency]")
+{
+  const int num_threads = omp_get_max_threads();
+  ParallelExecutor<Executor::OPENMP> test_block(true);
+  std::vector<int> task_threads(3 * num_threads, -1);
+  for (int repeat = 0; repeat < 2; repeat++)
+    test_block(
+        task_threads.size(),
+        [](int id, std::vector<int>& threads) {
+          // a task moved to another thread is marked as such
+          threads[id] = (threads[id] == -1 || threads[id] == omp_get_thread_num()) ? omp_get_thread_num() : -2;
+        },
+        std::ref(task_threads));
+  for (int id = 0; id < task_threads.size(); id++)
+    CHECK(task_threads[id] == id % num_threads);
+}
+
+TEST_CASE("ParallelExecutor<OPENMP> threads per task", "[concurrency]")
+{
+  const int num_threads      = omp_get_max_threads();
+  const int threads_per_task = 2;
+  const int num_tasks        = std::max(1, num_threads / threads_per_task);
+  ParallelExecutor<Executor::OPENMP> test_block(true, threads_per_task);
+  std::vector<int> nested_threads(num_tasks, 0);
+  test_block(
+      num_tasks,
+      [](int id, std::vector<int>& nested) {
+        // the BLAS calls see the same count through getNextLevelNumThreads
+        nested[id] = getNextLevelNumThreads();
+      },
+      std::ref(nested_threads));
+#ifdef _OPENMP
+  for (int id = 0; id < num_tasks; id++)
+    CHECK(nested_threads[id] == std::min(threads_per_task, num_threads));
+#endif
+  // the nesting is limited to the tasks
+  CHECK(getNextLevelNumThreads() == num_threads);
+}
+
 TEST_CASE("ParallelExecutor<OPENMP> nested case", "[concurrency]")
 {
   int num_threads = 1;
@@ -375,6 +375,16 @@ public:
   {
     X.updateFrom();
   }
+  template<class Queue, typename Allocator = Alloc, typename = IsDualSpace<Allocator>>
+  void updateToAsync(Queue& queue)
+  {
+    X.updateToAsync(queue);
+  }
+  template<class Queue, typename Allocator = Alloc, typename = IsDualSpace<Allocator>>
+  void updateFromAsync(Queue& queue)
+  {
+    X.updateFromAsync(queue);
+  }
 
 protected:
   size_type D1, D2;
@@ -274,11 +274,30 @@ public:
   {
     qmc_allocator_traits<Alloc>::updateTo(mAllocator, X, nLocal);
   }
+  /// transfer only the elements [offset, offset + size)
+  template<typename Allocator = Alloc, typename = IsDualSpace<Allocator>>
+  void updateTo(size_t size, size_t offset)
+  {
+    if (offset + size > nLocal)
+      throw std::out_of_range("Vector::updateTo the range exceeds the size of the vector");
+    qmc_allocator_traits<Alloc>::updateTo(mAllocator, X + offset, size);
+  }
   template<typename Allocator = Alloc, typename = IsDualSpace<Allocator>>
   void updateFrom()
   {
     qmc_allocator_traits<Alloc>::updateFrom(mAllocator, X, nLocal);
   }
+  /// transfers ordered on queue, the host side may not be touched until the queue is synchronized
+  template<class Queue, typename Allocator = Alloc, typename = IsDualSpace<Allocator>>
+  void updateToAsync(Queue& queue)
+  {
+    qmc_allocator_traits<Alloc>::updateToAsync(mAllocator, X, nLocal, queue);
+  }
+  template<class Queue, typename Allocator = Alloc, typename = IsDualSpace<Allocator>>
+  void updateFromAsync(Queue& queue)
+  {
+    qmc_allocator_traits<Alloc>::updateFromAsync(mAllocator, X, nLocal, queue);
+  }
 
 private:
   ///size
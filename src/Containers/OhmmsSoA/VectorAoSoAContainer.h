@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file VectorAoSoAContainer.h
+ * AoSoA Container for D-dim vectors
+ *
+ * Alternative to VectorSoaContainer keeping the D components of TILE consecutive elements together
+ */
+#ifndef QMCPLUSPLUS_VECTOR_AOSOA_H
+#define QMCPLUSPLUS_VECTOR_AOSOA_H
+
+#include <vector>
+#include "OhmmsSoA/VectorSoaContainer.h"
+
+namespace qmcplusplus
+{
+/** AoSoA adaptor class for Vector<TinyVector<T,D> >
+ * @tparam T data type, float, double
+ * @tparam TILE number of elements of a tile, the default fills one SIMD register
+ * @tparam Alloc memory allocator
+ *
+ * The elements are stored in tiles of TILE elements, each tile is a TILE x D SoA block, i.e.
+ * the d-th component of the i-th element is at (i / TILE) * TILE * D + d * TILE + i % TILE.
+ * A tile is contiguous in memory so the gathers and the short loops of a kernel touching a few elements
+ * stay in a few cache lines while each tile is still a VectorSoaContainer for the SIMD kernels.
+ * The size is padded to a multiple of TILE, the padding is set by TILE instead of Alloc::alignment.
+ */
+template<typename T, unsigned D, unsigned TILE = QMC_SIMD_ALIGNMENT / sizeof(T), typename Alloc = aligned_allocator<T>>
+struct VectorAoSoAContainer
+{
+  static_assert(TILE * sizeof(T) % QMC_SIMD_ALIGNMENT == 0, "AoSoA tiles must keep the SIMD alignment");
+
+  using AoSElement_t = TinyVector<T, D>;
+  using Element_t    = T;
+  using SoATile_t    = VectorSoaContainer<T, D, Alloc>;
+  using Accessor     = typename SoATile_t::Accessor;
+
+  static constexpr unsigned tile_size = TILE;
+
+  VectorAoSoAContainer() : nLocal(0) {}
+
+  /// constructor with size n without initialization
+  explicit VectorAoSoAContainer(size_t n) : nLocal(0) { resize(n); }
+
+  /** constructor with Vector<T1,D> */
+  template<typename T1>
+  VectorAoSoAContainer(const Vector<TinyVector<T1, D>>& in) : nLocal(0)
+  {
+    resize(in.size());
+    copyIn(in);
+  }
+
+  /** resize the storage
+   * @param n the number of elements
+   */
+  inline void resize(size_t n)
+  {
+    nLocal = n;
+    myData.resize(num_tiles() * TILE * D);
+  }
+
+  ///return the physical size
+  inline size_t size() const { return nLocal; }
+  ///return the size padded to full tiles
+  inline size_t capacity() const { return num_tiles() * TILE; }
+  ///return the number of tiles
+  inline size_t num_tiles() const { return (nLocal + TILE - 1) / TILE; }
+
+  /** AoS to AoSoA : copy from Vector<TinyVector<>>
+   *
+   * The same sizes are assumed.
+   */
+  template<typename T1>
+  void copyIn(const Vector<TinyVector<T1, D>>& in)
+  {
+    for (size_t i = 0; i < nLocal; ++i)
+      (*this)(i) = in[i];
+  }
+
+  /** SoA to AoSoA : copy from VectorSoaContainer
+   *
+   * The same sizes are assumed.
+   */
+  template<typename A1>
+  void copyIn(const VectorSoaContainer<T, D, A1>& in)
+  {
+    for (size_t t = 0; t < num_tiles(); ++t)
+      for (size_t d = 0; d < D; ++d)
+      {
+        const size_t first = t * TILE;
+        std::copy_n(in.data(d) + first, std::min(size_t(TILE), nLocal - first), tile(t) + d * TILE);
+      }
+  }
+
+  /** AoSoA to AoS : copy to Vector<TinyVector<>>
+   *
+   * The same sizes are assumed.
+   */
+  template<typename T1>
+  void copyOut(Vector<TinyVector<T1, D>>& out) const
+  {
+    for (size_t i = 0; i < nLocal; ++i)
+      out[i] = (*this)[i];
+  }
+
+  /** return TinyVector<T,D>
+   */
+  inline const AoSElement_t operator[](size_t i) const { return AoSElement_t(myData.data() + offset(i), TILE); }
+
+  /** access operator for assignment of the i-th value
+   *
+   * Use for (*this)(i)=TinyVector<T,D>;
+   */
+  inline Accessor operator()(size_t i) { return Accessor(myData.data() + offset(i), TILE); }
+
+  ///return the base
+  inline T* data() { return myData.data(); }
+  ///return the base
+  inline const T* data() const { return myData.data(); }
+  ///return the base of the t-th tile
+  inline T* tile(size_t t) { return myData.data() + t * TILE * D; }
+  ///return the base of the t-th tile
+  inline const T* tile(size_t t) const { return myData.data() + t * TILE * D; }
+
+  /** return the t-th tile as a SoA view of TILE elements
+   *
+   * The view is read only in spirit, VectorSoaContainer has no const view.
+   */
+  inline const SoATile_t getTileSoA(size_t t) const { return SoATile_t(const_cast<T*>(tile(t)), TILE, TILE); }
+
+private:
+  /// the position of the first component of the i-th element
+  static inline size_t offset(size_t i) { return (i / TILE) * TILE * D + i % TILE; }
+
+  /// number of elements
+  size_t nLocal;
+  /// data, num_tiles() tiles of TILE * D values
+  std::vector<T, Alloc> myData;
+};
+
+} // namespace qmcplusplus
+
+#endif
@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "OhmmsSoA/VectorAoSoAContainer.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("VectorAoSoAContainer layout", "[OhmmsSoA]")
+{
+  using vec_aosoa_t     = VectorAoSoAContainer<double, 3>;
+  constexpr size_t tile = vec_aosoa_t::tile_size;
+  const size_t n        = 2 * tile + 1;
+
+  Vector<TinyVector<double, 3>> R(n), R_out(n);
+  for (size_t i = 0; i < n; i++)
+    R[i] = TinyVector<double, 3>(i, 0.5 * i, -1.0 * i);
+
+  vec_aosoa_t RAoSoA(R);
+  CHECK(RAoSoA.size() == n);
+  CHECK(RAoSoA.num_tiles() == 3);
+  CHECK(RAoSoA.capacity() == 3 * tile);
+
+  // the components of a tile are contiguous
+  const size_t i = tile + 1;
+  CHECK(RAoSoA.data()[tile * 3 + 1] == Approx(R[i][0]));
+  CHECK(RAoSoA.data()[tile * 3 + tile + 1] == Approx(R[i][1]));
+  CHECK(RAoSoA.data()[tile * 3 + 2 * tile + 1] == Approx(R[i][2]));
+  CHECK(RAoSoA[i][2] == Approx(R[i][2]));
+
+  RAoSoA(i) = TinyVector<double, 3>(1.0, 2.0, 3.0);
+  CHECK(RAoSoA[i][1] == Approx(2.0));
+  RAoSoA(i) = R[i];
+
+  // each tile is a SoA view
+  const auto tile_soa = RAoSoA.getTileSoA(1);
+  CHECK(tile_soa.size() == tile);
+  CHECK(tile_soa[1][0] == Approx(R[i][0]));
+  CHECK(tile_soa.data(2)[1] == Approx(R[i][2]));
+
+  RAoSoA.copyOut(R_out);
+  for (size_t j = 0; j < n; j++)
+    for (size_t d = 0; d < 3; d++)
+      CHECK(R_out[j][d] == Approx(R[j][d]));
+
+  // from the SoA layout
+  VectorSoaContainer<double, 3> RSoA(R);
+  vec_aosoa_t RAoSoA_from_soa(n);
+  RAoSoA_from_soa.copyIn(RSoA);
+  for (size_t j = 0; j < n; j++)
+    for (size_t d = 0; d < 3; d++)
+      CHECK(RAoSoA_from_soa[j][d] == Approx(R[j][d]));
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,298 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "EnergyDensityNew.h"
+#include "OhmmsData/AttributeSet.h"
+#include "Particle/DistanceTable.h"
+#include "QMCHamiltonians/QMCHamiltonian.h"
+
+namespace qmcplusplus
+{
+EnergyDensityNew::EnergyDensityNew(xmlNodePtr cur, const ParticleSet& pset_dynamic, DataLocality dl)
+    : OperatorEstBase(dl)
+{
+  my_name_                 = "EnergyDensity";
+  std::string dynamic_name = pset_dynamic.getName();
+  OhmmsAttributeSet attrib;
+  attrib.add(my_name_, "name");
+  attrib.add(dynamic_name, "dynamic");
+  attrib.add(static_name_, "static");
+  attrib.add(ion_points_, "ion_points");
+  attrib.put(cur);
+  if (dynamic_name != pset_dynamic.getName())
+    throw std::runtime_error("EnergyDensityNew: the dynamic particle set " + dynamic_name +
+                             " must be the target particle set " + pset_dynamic.getName());
+
+  // the static particles are found through the distance tables of the target
+  const ParticleSet* pset_static = nullptr;
+  if (!static_name_.empty())
+  {
+    for (int i = 0; i < pset_dynamic.getNumDistTables(); ++i)
+    {
+      const ParticleSet& origin = pset_dynamic.getDistTable(i).get_origin();
+      if (&origin != &pset_dynamic && origin.getName() == static_name_)
+      {
+        dtable_index_ = i;
+        pset_static   = &origin;
+        break;
+      }
+    }
+    if (pset_static == nullptr)
+      throw std::runtime_error("EnergyDensityNew: the static particle set " + static_name_ +
+                               " is not a source of " + pset_dynamic.getName() +
+                               ", it must be used by a term of the hamiltonian");
+  }
+  else if (ion_points_)
+    throw std::runtime_error("EnergyDensityNew: ion_points needs a static particle set");
+
+  num_dynamic_   = pset_dynamic.getTotalNum();
+  num_static_    = pset_static ? pset_static->getTotalNum() : 0;
+  num_particles_ = ion_points_ ? num_dynamic_ : num_dynamic_ + num_static_;
+  if (ion_points_)
+  {
+    ion_positions_.resize(num_static_, OHMMS_DIM);
+    for (int i = 0; i < num_static_; i++)
+      for (int d = 0; d < OHMMS_DIM; d++)
+        ion_positions_(i, d) = pset_static->R[i][d];
+  }
+
+  std::vector<const ParticleSet*> pref;
+  if (pset_static)
+    pref.push_back(pset_static);
+  bool stop    = false;
+  bool has_ref = false;
+  for (xmlNodePtr element = cur->children; element != NULL; element = element->next)
+    if (std::string((const char*)element->name) == "reference_points")
+    {
+      if (has_ref)
+        throw std::runtime_error("EnergyDensityNew: only one reference_points element is allowed");
+      stop    = !ref_.put(element, pset_dynamic, pref) || stop;
+      has_ref = true;
+    }
+  if (!has_ref)
+    stop = !ref_.put(pset_dynamic, pref) || stop;
+
+  // voronoi grids are centered on the minimum image static particles
+  const auto& lattice = pset_dynamic.getLattice();
+  const bool periodic = lattice.SuperCellEnum != SUPERCELL_OPEN;
+  ParticlePos r_static;
+  std::vector<Real> z_static;
+  if (pset_static)
+  {
+    const SpeciesSet& species(pset_static->getSpeciesSet());
+    const int charge_index = species.findAttribute("charge");
+    r_static.resize(num_static_);
+    z_static.resize(num_static_);
+    for (int i = 0; i < num_static_; i++)
+    {
+      r_static[i] = pset_static->R[i];
+      if (periodic)
+        lattice.applyMinimumImage(r_static[i]);
+      z_static[i] = charge_index < 0 ? 0 : species(charge_index, pset_static->GroupID[i]);
+    }
+  }
+  int nvalues = N_ED_VALUES;
+  for (xmlNodePtr element = cur->children; element != NULL; element = element->next)
+    if (std::string((const char*)element->name) == "spacegrid")
+    {
+      auto sg = std::make_unique<SpaceGrid>(nvalues);
+      if (pset_static)
+        stop = !sg->put(element, ref_.points, r_static, z_static, num_dynamic_, periodic, false) || stop;
+      else
+      {
+        stop = !sg->put(element, ref_.points, periodic, false) || stop;
+        if (sg->coordinate == SpaceGrid::voronoi)
+          throw std::runtime_error("EnergyDensityNew: voronoi space grids need a static particle set");
+      }
+      spacegrids_.push_back(std::move(sg));
+    }
+  if (stop)
+    throw std::runtime_error("EnergyDensityNew: invalid reference_points or spacegrid input");
+
+  SpaceGrid::BufferType layout;
+  for (auto& sg : spacegrids_)
+    sg->allocate_buffer_space(layout);
+  outside_offset_ = layout.size();
+  ion_offset_     = outside_offset_ + N_ED_VALUES;
+  data_.resize(ion_offset_ + (ion_points_ ? num_static_ * N_ED_VALUES : 0), 0.0);
+
+  r_.resize(num_particles_);
+  ed_values_.resize(num_particles_, N_ED_VALUES);
+  if (ion_points_)
+    ed_ion_values_.resize(num_static_, N_ED_VALUES);
+  particles_outside_.resize(num_particles_, true);
+}
+
+EnergyDensityNew::EnergyDensityNew(const EnergyDensityNew& other)
+    : OperatorEstBase(other),
+      static_name_(other.static_name_),
+      dtable_index_(other.dtable_index_),
+      num_dynamic_(other.num_dynamic_),
+      num_static_(other.num_static_),
+      num_particles_(other.num_particles_),
+      ion_points_(other.ion_points_),
+      ion_positions_(other.ion_positions_),
+      ref_(other.ref_),
+      outside_offset_(other.outside_offset_),
+      ion_offset_(other.ion_offset_),
+      r_(other.r_),
+      ed_values_(other.ed_values_),
+      ed_ion_values_(other.ed_ion_values_),
+      particles_outside_(other.particles_outside_)
+{
+  // the grids keep scratch of their own
+  for (auto& sg : other.spacegrids_)
+    spacegrids_.push_back(std::make_unique<SpaceGrid>(*sg));
+  data_.resize(other.data_.size(), 0.0);
+}
+
+std::unique_ptr<OperatorEstBase> EnergyDensityNew::spawnCrowdClone() const
+{
+  return std::make_unique<EnergyDensityNew>(*this);
+}
+
+void EnergyDensityNew::accumulate(const RefVector<MCPWalker>& walkers,
+                                  const RefVector<ParticleSet>& psets,
+                                  const RefVector<TrialWaveFunction>& wfns,
+                                  RandomGenerator& rng)
+{
+  throw std::runtime_error("EnergyDensityNew::accumulate needs the walker hamiltonians");
+}
+
+void EnergyDensityNew::accumulate(const RefVector<MCPWalker>& walkers,
+                                  const RefVector<ParticleSet>& psets,
+                                  const RefVector<TrialWaveFunction>& wfns,
+                                  const RefVector<QMCHamiltonian>& hams,
+                                  RandomGenerator& rng)
+{
+  const int nw = walkers.size();
+  if (nw == 0)
+    return;
+  kinetic_.resize(nw);
+  potential_.resize(nw);
+  potential_static_.resize(nw);
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    kinetic_[iw].resize(num_dynamic_);
+    potential_[iw].resize(num_dynamic_);
+    potential_static_[iw].resize(num_static_);
+  }
+  const RefVectorWithLeader<QMCHamiltonian> ham_list(hams[0], hams);
+  const RefVectorWithLeader<ParticleSet> p_list(psets[0], psets);
+  const RefVector<Vector<FullPrecRealType>> kinetic_refs(kinetic_.begin(), kinetic_.end());
+  const RefVector<Vector<FullPrecRealType>> potential_refs(potential_.begin(), potential_.end());
+  const RefVector<Vector<FullPrecRealType>> potential_static_refs(potential_static_.begin(), potential_static_.end());
+  const auto missing = QMCHamiltonian::mw_evaluatePerParticle(ham_list, p_list, static_name_, kinetic_refs,
+                                                              potential_refs, potential_static_refs);
+  if (!missing.empty() && !missing_reported_)
+  {
+    std::string names;
+    for (const auto& name : missing)
+      names += " " + name;
+    app_warning() << "EnergyDensityNew " << my_name_ << " leaves out the hamiltonian components without"
+                  << " per particle energies:" << names << std::endl;
+    missing_reported_ = true;
+  }
+
+  for (int iw = 0; iw < nw; ++iw)
+    accumulateWalker(psets[iw], walkers[iw].get().Weight, kinetic_[iw], potential_[iw], potential_static_[iw]);
+}
+
+void EnergyDensityNew::accumulateWalker(ParticleSet& pset,
+                                        FullPrecRealType weight,
+                                        const Vector<FullPrecRealType>& kinetic,
+                                        const Vector<FullPrecRealType>& potential,
+                                        const Vector<FullPrecRealType>& potential_static)
+{
+  walkers_weight_ += weight;
+  int p = 0;
+  for (int i = 0; i < num_dynamic_; i++, p++)
+  {
+    r_[p]             = pset.R[i];
+    ed_values_(p, W) = weight;
+    ed_values_(p, T) = weight * kinetic[i];
+    ed_values_(p, V) = weight * potential[i];
+  }
+  if (dtable_index_ >= 0)
+  {
+    const ParticleSet& pset_static = pset.getDistTable(dtable_index_).get_origin();
+    for (int i = 0; i < num_static_; i++)
+      if (ion_points_)
+      {
+        ed_ion_values_(i, W) = weight;
+        ed_ion_values_(i, T) = 0.0;
+        ed_ion_values_(i, V) = weight * potential_static[i];
+      }
+      else
+      {
+        r_[p]             = pset_static.R[i];
+        ed_values_(p, W) = weight;
+        ed_values_(p, T) = 0.0;
+        ed_values_(p, V) = weight * potential_static[i];
+        p++;
+      }
+  }
+  pset.applyMinimumImage(r_);
+
+  const DistanceTableAB* dtab = dtable_index_ >= 0 ? &pset.getDistTableAB(dtable_index_) : nullptr;
+  std::fill(particles_outside_.begin(), particles_outside_.end(), true);
+  for (auto& sg : spacegrids_)
+    sg->evaluate(r_, ed_values_, data_, particles_outside_, dtab);
+  for (int p = 0; p < num_particles_; p++)
+    if (particles_outside_[p])
+      for (int v = 0; v < N_ED_VALUES; v++)
+        data_[outside_offset_ + v] += ed_values_(p, v);
+  if (ion_points_)
+    for (int i = 0; i < num_static_; i++)
+      for (int v = 0; v < N_ED_VALUES; v++)
+        data_[ion_offset_ + i * N_ED_VALUES + v] += ed_ion_values_(i, v);
+}
+
+void EnergyDensityNew::registerOperatorEstimator(hid_t gid)
+{
+  // same layout as EnergyDensityEstimator::registerCollectables
+  std::vector<ObservableHelper> h5desc;
+  hid_t g = H5Gcreate2(gid, my_name_.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  h5desc.emplace_back("variables");
+  auto& oh = h5desc.back();
+  oh.open(g);
+  oh.addProperty(num_particles_, "nparticles");
+  int nspacegrids = spacegrids_.size();
+  oh.addProperty(nspacegrids, "nspacegrids");
+  if (ion_points_)
+  {
+    oh.addProperty(num_static_, "nions");
+    oh.addProperty(ion_positions_, "ion_positions");
+  }
+
+  ref_.save(h5desc, g);
+
+  h5desc.emplace_back("outside");
+  auto& oh_outside = h5desc.back();
+  std::vector<int> ng(1, N_ED_VALUES);
+  oh_outside.set_dimensions(ng, outside_offset_);
+  oh_outside.open(g);
+  for (int i = 0; i < spacegrids_.size(); i++)
+    spacegrids_[i]->registerCollectables(h5desc, g, i);
+  if (ion_points_)
+  {
+    std::vector<int> ng2{num_static_, N_ED_VALUES};
+    h5desc.emplace_back("ions");
+    auto& oh_ions = h5desc.back();
+    oh_ions.set_dimensions(ng2, ion_offset_);
+    oh_ions.open(g);
+  }
+  for (auto& h5d : h5desc)
+    h5desc_.emplace_back(std::make_unique<ObservableHelper>(std::move(h5d)));
+  H5Gclose(g);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_ENERGYDENSITYNEW_H
+#define QMCPLUSPLUS_ENERGYDENSITYNEW_H
+
+#include "OperatorEstBase.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "OhmmsPETE/OhmmsVector.h"
+#include "QMCHamiltonians/ReferencePoints.h"
+#include "QMCHamiltonians/SpaceGrid.h"
+
+namespace qmcplusplus
+{
+/** @ingroup Estimators
+ * @brief Energy density on space grids for the batched drivers, ported from EnergyDensityEstimator
+ *
+ *  The weight, kinetic and potential energy of every particle are binned into the space grids of the input.
+ *  The per particle energies come from QMCHamiltonian::mw_evaluatePerParticle for the whole crowd
+ *  instead of the per particle traces, so the estimator needs the walker hamiltonians and
+ *  overrides the accumulate taking them. Each crowd clone bins into its own copy of data_.
+ *
+ *  data_ is laid out as the collectables of the legacy estimator: the space grids one after another,
+ *  then the values of the particles outside every grid and the values of the ions if ion_points.
+ */
+class EnergyDensityNew : public OperatorEstBase
+{
+public:
+  using Real             = QMCT::RealType;
+  using FullPrecRealType = QMCT::FullPrecRealType;
+  using ParticlePos      = PtclOnLatticeTraits::ParticlePos;
+
+  /// values binned for every particle
+  enum
+  {
+    W = 0,
+    T,
+    V,
+    N_ED_VALUES
+  };
+
+  /** read the estimator element
+   * @param cur          estimator element with reference_points and spacegrid children
+   * @param pset_dynamic golden target particle set, the static set must be a source of its distance tables
+   */
+  EnergyDensityNew(xmlNodePtr cur, const ParticleSet& pset_dynamic, DataLocality dl = DataLocality::crowd);
+
+  /// deep copy of the grids, the data is not copied, see OperatorEstBase
+  EnergyDensityNew(const EnergyDensityNew& other);
+
+  void startBlock(int steps) override {}
+
+  /** the per particle energies need the hamiltonians, this one throws
+   */
+  void accumulate(const RefVector<MCPWalker>& walkers,
+                  const RefVector<ParticleSet>& psets,
+                  const RefVector<TrialWaveFunction>& wfns,
+                  RandomGenerator& rng) override;
+
+  /** bin the per particle energies of a crowd
+   */
+  void accumulate(const RefVector<MCPWalker>& walkers,
+                  const RefVector<ParticleSet>& psets,
+                  const RefVector<TrialWaveFunction>& wfns,
+                  const RefVector<QMCHamiltonian>& hams,
+                  RandomGenerator& rng) override;
+
+  /** bin the per particle values of one walker
+   * @param pset       walker target particle set
+   * @param weight     walker weight
+   * @param kinetic    kinetic energy of the particles of pset
+   * @param potential  potential energy of the particles of pset
+   * @param potential_static potential energy of the static particles
+   */
+  void accumulateWalker(ParticleSet& pset,
+                        FullPrecRealType weight,
+                        const Vector<FullPrecRealType>& kinetic,
+                        const Vector<FullPrecRealType>& potential,
+                        const Vector<FullPrecRealType>& potential_static);
+
+  std::unique_ptr<OperatorEstBase> spawnCrowdClone() const override;
+
+  void registerOperatorEstimator(hid_t gid) override;
+
+  int getNumSpaceGrids() const { return spacegrids_.size(); }
+  int getOutsideOffset() const { return outside_offset_; }
+  int getIonOffset() const { return ion_offset_; }
+
+private:
+  /// name of the static particle set, empty if there is none
+  std::string static_name_;
+  /// index of the distance table from the static particles in the target particle sets
+  int dtable_index_ = -1;
+  int num_dynamic_  = 0;
+  int num_static_   = 0;
+  /// number of particles binned into the space grids
+  int num_particles_ = 0;
+  /// bin the static particle values at the ions instead of the grids
+  bool ion_points_ = false;
+  /// positions of the ions, written to the h5 file with ion_points
+  Matrix<Real> ion_positions_;
+  ReferencePoints ref_;
+  std::vector<std::unique_ptr<SpaceGrid>> spacegrids_;
+  int outside_offset_ = 0;
+  int ion_offset_     = 0;
+
+  /// crowd scratch, positions of the binned particles
+  ParticlePos r_;
+  /// crowd scratch, [particle][W,T,V]
+  Matrix<Real> ed_values_;
+  Matrix<Real> ed_ion_values_;
+  std::vector<bool> particles_outside_;
+  /// crowd scratch, per particle energies of every walker
+  std::vector<Vector<FullPrecRealType>> kinetic_;
+  std::vector<Vector<FullPrecRealType>> potential_;
+  std::vector<Vector<FullPrecRealType>> potential_static_;
+  /// hamiltonian components without per particle energies were reported
+  bool missing_reported_ = false;
+};
+
+} // namespace qmcplusplus
+
+#endif
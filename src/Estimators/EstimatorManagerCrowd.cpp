@@ -11,11 +11,13 @@
 
 #include "EstimatorManagerCrowd.h"
 #include "Estimators/CollectablesEstimator.h"
+#include "MemoryAccounting.h"
 
 namespace qmcplusplus
 {
 EstimatorManagerCrowd::EstimatorManagerCrowd(EstimatorManagerNew& em)
 {
+  ScopedMemoryTag memory_tag("estimators");
   // For now I'm going to try to refactor away the clone pattern only at the manager level.
   // i.e. not continue into the scalar_estimators and collectables
   for (const auto& est : em.Estimators)
@@ -27,6 +29,7 @@ EstimatorManagerCrowd::EstimatorManagerCrowd(EstimatorManagerNew& em)
 void EstimatorManagerCrowd::accumulate(const RefVector<MCPWalker>& walkers,
                                        const RefVector<ParticleSet>& psets,
                                        const RefVector<TrialWaveFunction>& wfns,
+                                       const RefVector<QMCHamiltonian>& hams,
                                        RandomGenerator& rng)
 {
   block_num_samples_ += walkers.size();
@@ -36,7 +39,7 @@ void EstimatorManagerCrowd::accumulate(const RefVector<MCPWalker>& walkers,
   for (int i = 0; i < num_scalar_estimators; ++i)
     scalar_estimators_[i]->accumulate(walkers);
   for (int i = 0; i < operator_ests_.size(); ++i)
-    operator_ests_[i]->accumulate(walkers, psets, wfns, rng);
+    operator_ests_[i]->accumulate(walkers, psets, wfns, hams, rng);
 }
 
 
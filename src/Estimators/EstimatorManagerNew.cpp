@@ -16,11 +16,15 @@
 #include "EstimatorManagerNew.h"
 #include "SpinDensityNew.h"
 #include "MomentumDistribution.h"
+#include "EnergyDensityNew.h"
+#include "StructureFactorNew.h"
+#include "PairCorrelationNew.h"
 #include "OneBodyDensityMatrices.h"
 #include "QMCHamiltonians/QMCHamiltonian.h"
 #include "Message/Communicate.h"
 #include "Message/CommOperators.h"
 #include "Message/CommUtilities.h"
+#include "Message/CommProfile.h"
 #include "Estimators/LocalEnergyEstimator.h"
 #include "Estimators/LocalEnergyOnlyEstimator.h"
 #include "Estimators/RMCLocalEnergyEstimator.h"
@@ -32,6 +36,7 @@
 #include "hdf/hdf_archive.h"
 #include "OhmmsData/AttributeSet.h"
 #include "Estimators/CSEnergyEstimator.h"
+#include "MemoryAccounting.h"
 
 //leave it for serialization debug
 //#define DEBUG_ESTIMATOR_ARCHIVE
@@ -45,6 +50,8 @@ EstimatorManagerNew::EstimatorManagerNew(Communicate* c)
 
 EstimatorManagerNew::~EstimatorManagerNew()
 {
+  if (pending_write_.valid())
+    pending_write_.wait();
   if (Collectables)
     delete Collectables;
 }
@@ -91,12 +98,14 @@ void EstimatorManagerNew::addHeader(std::ostream& o)
 }
 
 /// \todo clean up this method its a mess
-void EstimatorManagerNew::startDriverRun()
+void EstimatorManagerNew::startDriverRun(const std::string& stream_tag)
 {
   reset();
-  RecordCount = 0;
+  RecordCount              = 0;
+  operator_blocks_pending_ = 0;
   energyAccumulator.clear();
   varAccumulator.clear();
+  energy_reblocking_.clear();
   int nc = (Collectables) ? Collectables->size() : 0;
   BlockAverages.setValues(0.0);
   // \todo Collectables should just have its own data structures not change the EMBS layout.
@@ -113,15 +122,27 @@ void EstimatorManagerNew::startDriverRun()
 #endif
   if (my_comm_->rank() == 0)
   {
-    std::string fname(my_comm_->getName());
-    fname.append(".scalar.dat");
-    Archive = std::make_unique<std::ofstream>(fname.c_str());
-    addHeader(*Archive);
+    std::string fname(my_comm_->getName() + stream_tag);
+    Archive.reset();
+    if (write_scalar_text_)
+    {
+      Archive = std::make_unique<std::ofstream>((fname + ".scalar.dat").c_str());
+      addHeader(*Archive);
+    }
+    binary_archive_.reset();
+    if (write_scalar_binary_)
+    {
+      std::vector<std::string> names{"index"};
+      names.insert(names.end(), BlockAverages.Names.begin(), BlockAverages.Names.end());
+      names.insert(names.end(), BlockProperties.Names.begin(), BlockProperties.Names.end());
+      binary_archive_ = std::make_unique<ScalarTableWriter>(fname + ".scalar.bin", names);
+      binary_row_.resize(names.size());
+    }
     if (h5desc.size())
     {
       h5desc.clear();
     }
-    fname  = my_comm_->getName() + ".stat.h5";
+    fname  = my_comm_->getName() + stream_tag + ".stat.h5";
     h_file = std::make_unique<hdf_archive>();
     h_file->create(fname);
     for (int i = 0; i < Estimators.size(); i++)
@@ -131,7 +152,23 @@ void EstimatorManagerNew::startDriverRun()
   }
 }
 
-void EstimatorManagerNew::stopDriverRun() { h_file.reset(); }
+void EstimatorManagerNew::stopDriverRun()
+{
+  waitForWrites();
+  if (my_comm_->rank() == 0 && energy_reblocking_.count() >= min_reblocking_blocks_)
+    app_log() << "  Reblocked energy " << energy_reblocking_.mean() << " +/- " << getEnergyError() << " from "
+              << energy_reblocking_.count() << " blocks" << std::endl;
+  // partial sums of a reduction period cut short by the end of the run
+  if (operator_blocks_pending_ > 0)
+  {
+    reduceWriteAndZeroOperatorEstimators();
+    dispatchWrites();
+    waitForWrites();
+  }
+  h_file.reset();
+  if (binary_archive_)
+    binary_archive_->flush();
+}
 
 void EstimatorManagerNew::startBlock(int steps) { block_timer_.restart(); }
 
@@ -141,15 +178,17 @@ void EstimatorManagerNew::stopBlock(unsigned long accept, unsigned long reject,
    * DMC needs to add non-local move counters.
    * also need to add num_samples which differs from block_weight
    */
+  // the write buffers are free once the previous block is written
+  waitForWrites();
   //take block averages and update properties per block
   PropertyCache[weightInd] = block_weight;
   makeBlockAverages(accept, reject);
-  reduceOperatorEstimators();
-  writeOperatorEstimators();
-  zeroOperatorEstimators();
+  if (++operator_blocks_pending_ == operator_reduction_period_)
+    reduceWriteAndZeroOperatorEstimators();
   // intentionally put after all the estimator I/O
   PropertyCache[cpuInd] = block_timer_.elapsed();
   writeScalarH5();
+  dispatchWrites();
   RecordCount++;
 }
 
@@ -181,7 +220,11 @@ void EstimatorManagerNew::makeBlockAverages(unsigned long accepts, unsigned long
   std::vector<unsigned long> accepts_and_rejects(my_comm_->size() * 2, 0);
   accepts_and_rejects[my_comm_->rank()]                    = accepts;
   accepts_and_rejects[my_comm_->size() + my_comm_->rank()] = rejects;
-  my_comm_->allreduce(accepts_and_rejects);
+  {
+    ScopedCommProfile profile("EstimatorManagerNew::allreduce_accepts",
+                              accepts_and_rejects.size() * sizeof(unsigned long));
+    my_comm_->allreduce(accepts_and_rejects);
+  }
   unsigned long total_block_accept =
       std::accumulate(accepts_and_rejects.begin(), accepts_and_rejects.begin() + my_comm_->size(), 0);
   unsigned long total_block_reject = std::accumulate(accepts_and_rejects.begin() + my_comm_->size(),
@@ -202,7 +245,10 @@ void EstimatorManagerNew::makeBlockAverages(unsigned long accepts, unsigned long
 
   // This is necessary to use mpi3's C++ style reduce
 #ifdef HAVE_MPI
-  my_comm_->comm.reduce_in_place_n(reduce_buffer.begin(), reduce_buffer.size(), std::plus<>{});
+  {
+    ScopedCommProfile profile("EstimatorManagerNew::reduce_scalars", reduce_buffer.size() * sizeof(double));
+    my_comm_->comm.reduce_in_place_n(reduce_buffer.begin(), reduce_buffer.size(), std::plus<>{});
+  }
 #endif
   if (my_comm_->rank() == 0)
   {
@@ -223,6 +269,13 @@ void EstimatorManagerNew::makeBlockAverages(unsigned long accepts, unsigned long
   //add the block average to summarize
   energyAccumulator(AverageCache[0]);
   varAccumulator(AverageCache[1]);
+  if (my_comm_->rank() == 0)
+    energy_reblocking_(AverageCache[0]);
+}
+
+bool EstimatorManagerNew::isTargetEnergyErrorReached() const
+{
+  return target_energy_error_ > 0 && getEnergyError() < target_energy_error_;
 }
 
 void EstimatorManagerNew::writeScalarH5()
@@ -230,10 +283,12 @@ void EstimatorManagerNew::writeScalarH5()
   //Do not assume h_file is valid
   if (h_file)
   {
-    for (int o = 0; o < h5desc.size(); ++o)
-      // cheating here, remove SquaredAverageCache from API
-      h5desc[o].write(AverageCache.data(), AverageCache.data());
-    H5Fflush(h_file->getFileID(), H5F_SCOPE_LOCAL);
+    average_write_buffer_ = AverageCache;
+    staged_writes_.push_back([this]() {
+      for (int o = 0; o < h5desc.size(); ++o)
+        // cheating here, remove SquaredAverageCache from API
+        h5desc[o].write(average_write_buffer_.data(), average_write_buffer_.data());
+    });
   }
 
   if (Archive)
@@ -246,48 +301,48 @@ void EstimatorManagerNew::writeScalarH5()
       *Archive << std::setw(FieldWidth) << PropertyCache[j];
     *Archive << std::endl;
   }
+
+  if (binary_archive_)
+  {
+    auto row = binary_row_.begin();
+    *row++   = RecordCount;
+    row      = std::copy_n(AverageCache.begin(), BlockAverages.size(), row);
+    std::copy(PropertyCache.begin(), PropertyCache.end(), row);
+    binary_archive_->append(binary_row_.data());
+  }
 }
 
 void EstimatorManagerNew::reduceOperatorEstimators()
 {
   if (operator_ests_.size() > 0)
   {
-    std::vector<size_t> operator_data_sizes(operator_ests_.size());
-    RefVector<OperatorEstBase> ref_op_ests = convertUPtrToRefVector(operator_ests_);
-    for (int iop = 0; iop < operator_data_sizes.size(); ++iop)
-    {
-      operator_data_sizes[iop] = operator_ests_[iop]->get_data().size();
-    }
-    // 1 larger because we put the weight in to avoid dependence of the Scalar estimators being reduced firt.
-    size_t nops = *(std::max_element(operator_data_sizes.begin(), operator_data_sizes.end())) + 1;
-    std::vector<RealType> operator_send_buffer;
-    std::vector<RealType> operator_recv_buffer;
-    operator_send_buffer.reserve(nops);
-    operator_recv_buffer.reserve(nops);
+    // the weights go separately so the data can be reduced straight from the estimators.
+    std::vector<FullPrecRealType> walkers_weights(operator_ests_.size());
     for (int iop = 0; iop < operator_ests_.size(); ++iop)
     {
-      auto& estimator      = *operator_ests_[iop];
-      auto& data           = estimator.get_data();
-      size_t adjusted_size = data.size() + 1;
-      operator_send_buffer.resize(adjusted_size, 0.0);
-      operator_recv_buffer.resize(adjusted_size, 0.0);
-      std::copy_n(data.begin(), data.size(), operator_send_buffer.begin());
-      operator_send_buffer[data.size()] = estimator.get_walkers_weight();
-      // This is necessary to use mpi3's C++ style reduce
+      operator_ests_[iop]->alignDataForReduction(*my_comm_);
+      walkers_weights[iop] = operator_ests_[iop]->get_walkers_weight();
+    }
+    // This is necessary to use mpi3's C++ style reduce
 #ifdef HAVE_MPI
-      my_comm_->comm.reduce_n(operator_send_buffer.begin(), adjusted_size, operator_recv_buffer.begin(), std::plus<>{},
-                              0);
-#else
-      operator_recv_buffer = operator_send_buffer;
+    {
+      ScopedCommProfile profile("EstimatorManagerNew::reduce_operators",
+                                walkers_weights.size() * sizeof(FullPrecRealType));
+      my_comm_->comm.reduce_in_place_n(walkers_weights.begin(), walkers_weights.size(), std::plus<>{});
+    }
+    for (auto& op_est : operator_ests_)
+    {
+      auto& data = op_est->get_data();
+      ScopedCommProfile profile("EstimatorManagerNew::reduce_operators", data.size() * sizeof(data[0]));
+      my_comm_->comm.reduce_in_place_n(data.begin(), data.size(), std::plus<>{});
+    }
 #endif
-      if (my_comm_->rank() == 0)
+    if (my_comm_->rank() == 0)
+      for (int iop = 0; iop < operator_ests_.size(); ++iop)
       {
-        std::copy_n(operator_recv_buffer.begin(), data.size(), data.begin());
-        size_t reduced_walker_weights = operator_recv_buffer[data.size()];
-        RealType invTotWgt            = 1.0 / static_cast<QMCT::RealType>(reduced_walker_weights);
+        RealType invTotWgt = 1.0 / walkers_weights[iop];
         operator_ests_[iop]->normalize(invTotWgt);
       }
-    }
   }
 }
 
@@ -297,9 +352,13 @@ void EstimatorManagerNew::writeOperatorEstimators()
   {
     if (h_file)
     {
-      for (auto& op_est : operator_ests_)
-        op_est->write();
-      H5Fflush(h_file->getFileID(), H5F_SCOPE_LOCAL);
+      operator_write_buffers_.resize(operator_ests_.size());
+      for (int iop = 0; iop < operator_ests_.size(); ++iop)
+        operator_write_buffers_[iop] = operator_ests_[iop]->get_data();
+      staged_writes_.push_back([this]() {
+        for (int iop = 0; iop < operator_ests_.size(); ++iop)
+          operator_ests_[iop]->write(operator_write_buffers_[iop]);
+      });
     }
   }
 }
@@ -310,6 +369,37 @@ void EstimatorManagerNew::zeroOperatorEstimators()
     op_est->zero();
 }
 
+void EstimatorManagerNew::dispatchWrites()
+{
+  if (staged_writes_.empty())
+    return;
+  auto write_block = [this]() {
+    for (auto& write : staged_writes_)
+      write();
+    staged_writes_.clear();
+    H5Fflush(h_file->getFileID(), H5F_SCOPE_LOCAL);
+  };
+  if (async_io_)
+    pending_write_ = std::async(std::launch::async, write_block);
+  else
+    write_block();
+}
+
+void EstimatorManagerNew::waitForWrites()
+{
+  // rethrows the failures of the background write
+  if (pending_write_.valid())
+    pending_write_.get();
+}
+
+void EstimatorManagerNew::reduceWriteAndZeroOperatorEstimators()
+{
+  reduceOperatorEstimators();
+  writeOperatorEstimators();
+  zeroOperatorEstimators();
+  operator_blocks_pending_ = 0;
+}
+
 void EstimatorManagerNew::getApproximateEnergyVariance(RealType& e, RealType& var)
 {
   RealType tmp[3];
@@ -336,6 +426,7 @@ bool EstimatorManagerNew::put(QMCHamiltonian& H,
                               const WaveFunctionFactory& wf_factory,
                               xmlNodePtr cur)
 {
+  ScopedMemoryTag memory_tag("estimators");
   std::vector<std::string> extra_types;
   std::vector<std::string> extra_names;
   cur = cur->children;
@@ -405,6 +496,12 @@ bool EstimatorManagerNew::put(QMCHamiltonian& H,
                                                                              pset.getSpeciesSet(), wf_factory,
                                                                              pset_target));
       }
+      else if (est_type == "EnergyDensity")
+        operator_ests_.emplace_back(std::make_unique<EnergyDensityNew>(cur, pset));
+      else if (est_type == "StructureFactor")
+        operator_ests_.emplace_back(std::make_unique<StructureFactorNew>(cur, pset));
+      else if (est_type == "PairCorrelation")
+        operator_ests_.emplace_back(std::make_unique<PairCorrelationNew>(cur, pset));
       else
       {
         extra_types.push_back(est_type);
@@ -13,9 +13,12 @@
 #define QMCPLUSPLUS_ESTIMATORMANAGERNEW_H
 
 #include <memory>
+#include <functional>
+#include <future>
 
 #include "Configuration.h"
 #include "Utilities/Timer.h"
+#include "Utilities/ScalarTable.h"
 #include "Pools/PooledData.h"
 #include "Message/Communicate.h"
 #include "Estimators/ScalarEstimatorBase.h"
@@ -86,10 +89,11 @@ public:
    * Open files. Setting zeros.
    * @param blocks number of blocks
    * @param record if true, will write to a file
+   * @param stream_tag inserted after the project name of the scalar.dat and stat.h5 files
    *
    * Replace reportHeader and reset functon.
    */
-  void startDriverRun();
+  void startDriverRun(const std::string& stream_tag = "");
 
   /** Stop the manager at the end of a driver run().
    * Flush/close files.
@@ -109,6 +113,50 @@ public:
    */
   void stopBlock(unsigned long accept, unsigned long reject, RealType block_weight);
 
+  /** set the number of blocks the operator estimators accumulate between two reductions over the ranks
+   *
+   *  The partial sums of the skipped blocks are carried forward, the written record is their weighted average.
+   */
+  void setOperatorReductionPeriod(int period) { operator_reduction_period_ = period; }
+
+  /** select the files of the scalar block records, effective from the next startDriverRun
+   * @param write_text write the formatted scalar.dat
+   * @param write_binary write the binary scalar.bin, a ScalarTable of all the scalar estimators
+   */
+  void setScalarOutput(bool write_text, bool write_binary)
+  {
+    write_scalar_text_   = write_text;
+    write_scalar_binary_ = write_binary;
+  }
+
+  /** write the block records of the stat.h5 on a background thread
+   *
+   *  The block data is copied into write buffers and the driver continues while the previous
+   *  block is written. Only one block is in flight, the next stopBlock waits for it.
+   */
+  void setAsyncIO(bool async_io) { async_io_ = async_io; }
+
+  /** stop the driver run once the reblocked error of the block energies is below target_error
+   *
+   *  A target_error <= 0 disables the check.
+   */
+  void setTargetEnergyError(RealType target_error) { target_energy_error_ = target_error; }
+
+  /** true if a target error is set and the reblocked error of the block energies is below it
+   *
+   *  Only meaningful on rank 0 where the block averages are reduced, the caller broadcasts the decision.
+   */
+  bool isTargetEnergyErrorReached() const;
+
+  /// reblocked standard error of the mean of the block energies, only meaningful on rank 0
+  RealType getEnergyError() const { return energy_reblocking_.error(min_reblocking_blocks_); }
+
+  /** wait until all the block records handed to the background writer are in the stat.h5
+   *
+   *  Call before any other HDF5 I/O, e.g. a checkpoint, the HDF5 library may not be thread safe.
+   */
+  void waitForWrites();
+
   /** At end of block collect the scalar estimators for the entire rank
    *   
    *  \todo remove assumption of one ScalarEstimator per crowd.
@@ -169,6 +217,7 @@ private:
    *
    *  Implementation makes the assumption that sending each OperatorEstimator
    *  separately is the correct memory use vs. mpi message balance.
+   *  Each estimator's data is reduced in place, the walker weights of all of them go in one message.
    */
   void reduceOperatorEstimators();
   /** Write OperatorEstimator data to *.stat.h5
@@ -179,6 +228,10 @@ private:
   /** OperatorEstimators need to be zeroed out after the block is finished.
    */
   void zeroOperatorEstimators();
+  /// end a reduction period of the OperatorEstimators
+  void reduceWriteAndZeroOperatorEstimators();
+  /// run the writes staged by this block, in the background with async_io_
+  void dispatchWrites();
 
   ///name of the primary estimator name
   std::string MainEstimatorName;
@@ -194,6 +247,14 @@ private:
   std::unique_ptr<hdf_archive> h_file;
   ///file handler to write data
   std::unique_ptr<std::ofstream> Archive;
+  ///binary table of the same records, not limited to max4ascii columns
+  std::unique_ptr<ScalarTableWriter> binary_archive_;
+  ///row of binary_archive_
+  std::vector<double> binary_row_;
+  ///if true, write scalar.dat
+  bool write_scalar_text_ = true;
+  ///if true, write scalar.bin
+  bool write_scalar_binary_ = false;
   ///file handler to write data for debugging
   std::unique_ptr<std::ofstream> DebugArchive;
   ///communicator to handle communication
@@ -210,6 +271,12 @@ private:
   ScalarEstimatorBase::accumulator_type energyAccumulator;
   /** accumulator for the variance **/
   ScalarEstimatorBase::accumulator_type varAccumulator;
+  /// online reblocking of the block energies, updated on rank 0
+  ScalarEstimatorBase::reblocking_type energy_reblocking_;
+  /// a reblocking level needs this many blocks to estimate the error
+  static constexpr int min_reblocking_blocks_ = 32;
+  /// target reblocked error of the energy, disabled if <= 0
+  RealType target_energy_error_ = 0;
   ///cached block averages of the values
   Vector<RealType> AverageCache;
   ///cached block averages of properties, e.g. BlockCPU
@@ -233,6 +300,22 @@ private:
    */
   std::vector<std::unique_ptr<OperatorEstBase>> operator_ests_;
 
+  ///number of blocks between the reductions of the operator estimators
+  int operator_reduction_period_ = 1;
+  ///number of blocks the operator estimators have accumulated since their last reduction
+  int operator_blocks_pending_ = 0;
+
+  ///if true, the stat.h5 block records are written on a background thread
+  bool async_io_ = false;
+  ///hdf5 writes of the current block, staged on rank 0
+  std::vector<std::function<void()>> staged_writes_;
+  ///copies of the OperatorEstimator data being written in the background
+  std::vector<OperatorEstBase::Data> operator_write_buffers_;
+  ///copy of AverageCache being written in the background
+  Vector<RealType> average_write_buffer_;
+  ///background write of the previous block
+  std::future<void> pending_write_;
+
   ///block timer
   Timer block_timer_;
 
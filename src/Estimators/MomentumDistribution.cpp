@@ -12,6 +12,8 @@
 #include "MomentumDistribution.h"
 #include "CPU/e2iphi.h"
 #include "TrialWaveFunction.h"
+#include "Numerics/MatrixOperators.h"
+#include "QMCHamiltonians/NLPPJob.h"
 
 #include <iostream>
 #include <numeric>
@@ -241,6 +243,12 @@ void MomentumDistribution::accumulate(const RefVector<MCPWalker>& walkers,
                                       const RefVector<TrialWaveFunction>& wfns,
                                       RandomGenerator& rng)
 {
+  if (input_.get<bool>("batched"))
+  {
+    accumulateBatched(walkers, psets, wfns, rng);
+    return;
+  }
+
   for (int iw = 0; iw < walkers.size(); ++iw)
   {
     MCPWalker& walker      = walkers[iw];
@@ -304,6 +312,121 @@ void MomentumDistribution::accumulate(const RefVector<MCPWalker>& walkers,
   }
 }
 
+void MomentumDistribution::accumulateBatched(const RefVector<MCPWalker>& walkers,
+                                             const RefVector<ParticleSet>& psets,
+                                             const RefVector<TrialWaveFunction>& wfns,
+                                             RandomGenerator& rng)
+{
+  const int nw = walkers.size();
+  if (nw == 0)
+    return;
+  const int np = psets[0].get().getTotalNum();
+  const int nk = kPoints.size();
+
+  // samples and their phases, shared by the walkers of the crowd
+  phase_table_.resize(M, nk);
+  for (int s = 0; s < M; ++s)
+  {
+    PosType newpos;
+    for (int i = 0; i < OHMMS_DIM; ++i)
+      newpos[i] = rng();
+    vPos[s] = Lattice.toCart(newpos);
+    for (int ik = 0; ik < nk; ++ik)
+      kdotp[ik] = -dot(kPoints[ik], vPos[s]);
+    eval_e2iphi(nk, kdotp.data(), phases.data(0), phases.data(1));
+    for (int ik = 0; ik < nk; ++ik)
+      phase_table_(s, ik) = ComplexType(phases.data(0)[ik], phases.data(1)[ik]);
+  }
+
+  // walkers move between crowds, a virtual particle set follows the ParticleSet it was made for
+  auto& vps = crowd_vps_.vps;
+  if (vps.size() < nw)
+  {
+    vps.resize(nw);
+    crowd_vps_.deltas.resize(nw, std::vector<PosType>(M));
+    crowd_vps_.ratios.resize(nw, std::vector<ValueType>(M));
+  }
+  for (int iw = 0; iw < nw; ++iw)
+    if (!vps[iw] || &vps[iw]->refPS != &psets[iw].get())
+      vps[iw] = std::make_unique<VirtualParticleSet>(psets[iw], M);
+  if (!crowd_vps_.vp_res)
+  {
+    crowd_vps_.vp_res = std::make_unique<ResourceCollection>("MomentumDistributionVP");
+    vps[0]->createResource(*crowd_vps_.vp_res);
+  }
+
+  RefVectorWithLeader<VirtualParticleSet> vp_list(*vps[0]);
+  RefVectorWithLeader<const VirtualParticleSet> const_vp_list(*vps[0]);
+  RefVectorWithLeader<TrialWaveFunction> wf_list(wfns[0]);
+  RefVector<const std::vector<PosType>> deltaV_list;
+  RefVector<std::vector<ValueType>> ratios_list;
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    vp_list.push_back(*vps[iw]);
+    const_vp_list.push_back(*vps[iw]);
+    wf_list.push_back(wfns[iw]);
+    deltaV_list.push_back(crowd_vps_.deltas[iw]);
+    ratios_list.push_back(crowd_vps_.ratios[iw]);
+  }
+
+  // ratios of particle i of every walker moved to the samples
+  ratio_table_.resize(nw * np, M);
+  {
+    ResourceCollectionTeamLock<VirtualParticleSet> vp_res_lock(*crowd_vps_.vp_res, vp_list);
+    std::vector<NLPPJob<RealType>> jobs;
+    jobs.reserve(nw);
+    for (int i = 0; i < np; ++i)
+    {
+      jobs.clear();
+      for (int iw = 0; iw < nw; ++iw)
+      {
+        const PosType& r = psets[iw].get().R[i];
+        jobs.emplace_back(-1, i, r, 0.0, PosType());
+        std::vector<PosType>& deltas = crowd_vps_.deltas[iw];
+        for (int s = 0; s < M; ++s)
+          deltas[s] = vPos[s] - r;
+      }
+      RefVector<const NLPPJob<RealType>> joblist(jobs.begin(), jobs.end());
+      VirtualParticleSet::mw_makeMoves(vp_list, deltaV_list, joblist, false);
+      TrialWaveFunction::mw_evaluateRatios(wf_list, const_vp_list, ratios_list);
+      for (int iw = 0; iw < nw; ++iw)
+      {
+        const std::vector<ValueType>& ratios = crowd_vps_.ratios[iw];
+        ComplexType* row                     = ratio_table_[iw * np + i];
+        for (int s = 0; s < M; ++s)
+          row[s] = ComplexType(ratios[s]);
+      }
+    }
+  }
+
+  // sum_s ratio_s e^{-ik.v_s} for every particle of every walker
+  ratio_phase_table_.resize(nw * np, nk);
+  MatrixOperators::product(ratio_table_, phase_table_, ratio_phase_table_);
+
+  // n(k) = Re sum_i e^{ik.r_i} sum_s ratio_s e^{-ik.v_s}
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    ParticleSet& pset = psets[iw];
+    RealType weight   = walkers[iw].get().Weight;
+    walkers_weight_ += weight;
+
+    std::fill_n(nofK.begin(), nk, RealType(0));
+    for (int i = 0; i < np; ++i)
+    {
+      for (int ik = 0; ik < nk; ++ik)
+        kdotp[ik] = dot(kPoints[ik], pset.R[i]);
+      eval_e2iphi(nk, kdotp.data(), phases.data(0), phases.data(1));
+      const ComplexType* restrict rp    = ratio_phase_table_[iw * np + i];
+      const RealType* restrict phases_c = phases.data(0);
+      const RealType* restrict phases_s = phases.data(1);
+      for (int ik = 0; ik < nk; ++ik)
+        nofK[ik] += phases_c[ik] * rp[ik].real() - phases_s[ik] * rp[ik].imag();
+    }
+
+    for (int ik = 0; ik < nk; ++ik)
+      data_[ik] += weight * nofK[ik] * norm_nofK;
+  }
+}
 
 void MomentumDistribution::collect(const RefVector<OperatorEstBase>& type_erased_operator_estimators)
 {
@@ -17,6 +17,8 @@
 #include "Configuration.h"
 #include "OperatorEstBase.h"
 #include "Containers/OhmmsPETE/TinyVector.h"
+#include "Particle/VirtualParticleSet.h"
+#include "ResourceCollection.h"
 
 #include "MomentumDistributionInput.h"
 
@@ -72,6 +74,30 @@ public:
   ///nofK
   aligned_vector<RealType> nofK;
 
+  /** @ingroup MomentumDistribution crowd batched evaluation
+   *  @{
+   */
+  ///e^{-ik.v_s} of the samples shared by the crowd, M x nk
+  Matrix<ComplexType> phase_table_;
+  ///ratios of every particle of every walker moved to the samples, (nw*np) x M
+  Matrix<ComplexType> ratio_table_;
+  ///ratio_table_ * phase_table_, (nw*np) x nk
+  Matrix<ComplexType> ratio_phase_table_;
+  /** per walker virtual particle sets and their multi walker resource
+   *  they refer to the walkers' ParticleSets so a crowd clone starts without them.
+   */
+  struct CrowdVirtualParticles
+  {
+    UPtrVector<VirtualParticleSet> vps;
+    std::unique_ptr<ResourceCollection> vp_res;
+    std::vector<std::vector<PosType>> deltas;
+    std::vector<std::vector<ValueType>> ratios;
+    CrowdVirtualParticles() = default;
+    CrowdVirtualParticles(const CrowdVirtualParticles&) {}
+  };
+  CrowdVirtualParticles crowd_vps_;
+  /** @} */
+
 public:
   /** Constructor for MomentumDistributionInput 
    */
@@ -128,6 +154,16 @@ public:
 private:
   MomentumDistribution(const MomentumDistribution& md) = default;
 
+  /** accumulate the walkers of a crowd together
+   *
+   *  The walkers share one set of samples. Each particle is moved to the samples in all the walkers with
+   *  one mw_evaluateRatios and the Fourier transform of the ratios is a single GEMM with the phase table.
+   */
+  void accumulateBatched(const RefVector<MCPWalker>& walkers,
+                         const RefVector<ParticleSet>& psets,
+                         const RefVector<TrialWaveFunction>& wfns,
+                         RandomGenerator& rng);
+
   friend class testing::MomentumDistributionTests;
 };
 
@@ -26,12 +26,14 @@ public:
   MomentumDistributionInput()
   {
     section_name   = "MomentumDistribution";
-    attributes     = {"type", "name", "samples", "kmax", "kmax0", "kmax1", "kmax2"};
+    attributes     = {"type", "name", "samples", "kmax", "kmax0", "kmax1", "kmax2", "batched"};
     strings        = {"type", "name"};
     integers       = {"samples"};
     reals          = {"kmax", "kmax0", "kmax1", "kmax2"};
+    bools          = {"batched"};
     default_values = {{"name", std::string("nofk")}, {"samples", int(40)}, {"kmax", Real(0.0)},
-                      {"kmax0", Real(0.0)},          {"kmax1", Real(0.0)}, {"kmax2", Real(0.0)}};
+                      {"kmax0", Real(0.0)},          {"kmax1", Real(0.0)}, {"kmax2", Real(0.0)},
+                      {"batched", bool(false)}};
   }
 };
 // clang-format: on
@@ -20,6 +20,7 @@
 #include "Utilities/string_utils.h"
 #include "QMCWaveFunctions/WaveFunctionFactory.h"
 #include "type_traits/complex_help.hpp"
+#include "QMCHamiltonians/NLPPJob.h"
 
 namespace qmcplusplus
 {
@@ -126,7 +127,7 @@ OneBodyDensityMatrices::OneBodyDensityMatrices(OneBodyDensityMatricesInput&& obd
   samples_weights_.resize(samples_);
   psi_ratios_.resize(nparticles);
 
-  if (input_.get_evaluator() == Evaluator::MATRIX)
+  if (input_.get_evaluator() == Evaluator::MATRIX || input_.get_evaluator() == Evaluator::BATCHED)
   {
     Phi_MB_.resize(samples_, basis_size_);
     Phi_NB_.reserve(nspecies);
@@ -142,6 +143,14 @@ OneBodyDensityMatrices::OneBodyDensityMatrices(OneBodyDensityMatricesInput&& obd
       N_BB_.emplace_back(basis_size_, basis_size_);
     }
   }
+  // the crowd sized matrices are sized by the first accumulate
+  sample_batch_ = std::min(static_cast<int>(samples_), max_sample_batch_);
+  if (input_.get_evaluator() == Evaluator::BATCHED)
+  {
+    Phi_WNB_.resize(nspecies);
+    Psi_WNM_.resize(nspecies);
+    Phi_Psi_WNB_.resize(nspecies);
+  }
 
   if (sampling_ == Sampling::METROPOLIS)
   {
@@ -405,6 +414,11 @@ void OneBodyDensityMatrices::implAccumulate(const RefVector<MCPWalker>& walkers,
                                             const RefVector<TrialWaveFunction>& wfns,
                                             RNG_GEN& rng)
 {
+  if (input_.get_evaluator() == Evaluator::BATCHED)
+  {
+    implAccumulateBatched(walkers, psets, wfns, rng);
+    return;
+  }
   for (int iw = 0; iw < walkers.size(); ++iw)
   {
     walkers_weight_ += walkers[iw].get().Weight;
@@ -445,24 +459,81 @@ void OneBodyDensityMatrices::evaluateMatrix(ParticleSet& pset_target,
     }
   }
   // accumulate data for this walker
+  accumulateNumberMatrices();
+}
+
+template<class RNG_GEN>
+void OneBodyDensityMatrices::implAccumulateBatched(const RefVector<MCPWalker>& walkers,
+                                                   const RefVector<ParticleSet>& psets,
+                                                   const RefVector<TrialWaveFunction>& wfns,
+                                                   RNG_GEN& rng)
+{
+  const int num_walkers = walkers.size();
+  if (num_walkers == 0)
+    return;
+  ParticleSet& pset_leader = psets[0];
+
+  std::vector<Real> walker_weights(num_walkers);
+  for (int iw = 0; iw < num_walkers; ++iw)
   {
-    ScopedTimer local_timer(timers_.accumulate_timer);
-    const int basis_size_sq = basis_size_ * basis_size_;
-    int ij                  = 0;
+    walker_weights[iw] = walkers[iw].get().Weight;
+    walkers_weight_ += walker_weights[iw];
+  }
+
+  // samples and their basis values are shared by the crowd, the walker weights enter with the ratios
+  warmupSampling(pset_leader, rng);
+  generateSamples(metric_, pset_leader, rng);
+  generateSampleBasis(Phi_MB_, pset_leader, wfns[0]); // basis : samples x basis_size
+  generateCrowdParticleBasis(psets, Phi_WNB_);        // conj(basis) : walkers*particles x basis_size
+
+  for (Matrix<Value>& N_bb : N_BB_)
+    N_bb = 0.0;
+
+  const Value one(1.0);
+  const Value zero(0.0);
+  for (int first_sample = 0; first_sample < samples_; first_sample += sample_batch_)
+  {
+    const int num_samples = std::min(sample_batch_, static_cast<int>(samples_) - first_sample);
+    // conj(Psi ratio) : walkers*particles x samples of the batch
+    generateCrowdSampleRatios(psets, wfns, walker_weights, first_sample, num_samples, Psi_WNM_);
+
+    ScopedTimer local_timer(timers_.matrix_products_timer);
+    const Value* phi_mb = Phi_MB_.data() + first_sample * basis_size_;
     for (int s = 0; s < species_.size(); ++s)
     {
-      //int ij=nindex; // for testing
-      const Matrix<Value>& NDM = N_BB_[s];
-      for (int n = 0; n < basis_size_sq; ++n)
-      {
-        Value val = NDM(n);
-        data_[ij] += real(val);
-        ij++;
+      Matrix<Value>& Psi_wnm     = Psi_WNM_[s];
+      Matrix<Value>& Phi_Psi_wnb = Phi_Psi_WNB_[s];
+      Matrix<Value>& Phi_wnb     = Phi_WNB_[s];
+      const int num_rows         = Psi_wnm.rows();
+      // ratio*basis : walkers*particles x basis_size
+      BLAS::gemm('N', 'N', basis_size_, num_rows, num_samples, one, phi_mb, basis_size_, Psi_wnm.data(),
+                 Psi_wnm.cols(), zero, Phi_Psi_wnb.data(), basis_size_);
+      // conj(basis)^T*ratio*basis summed over the crowd : basis_size^2
+      BLAS::gemm('N', 'T', basis_size_, basis_size_, num_rows, one, Phi_Psi_wnb.data(), basis_size_, Phi_wnb.data(),
+                 basis_size_, one, N_BB_[s].data(), basis_size_);
+    }
+  }
+  accumulateNumberMatrices();
+}
+
+void OneBodyDensityMatrices::accumulateNumberMatrices()
+{
+  ScopedTimer local_timer(timers_.accumulate_timer);
+  const int basis_size_sq = basis_size_ * basis_size_;
+  int ij                  = 0;
+  for (int s = 0; s < species_.size(); ++s)
+  {
+    //int ij=nindex; // for testing
+    const Matrix<Value>& NDM = N_BB_[s];
+    for (int n = 0; n < basis_size_sq; ++n)
+    {
+      Value val = NDM(n);
+      data_[ij] += real(val);
+      ij++;
 #if defined(QMC_COMPLEX)
-        data_[ij] += imag(val);
-        ij++;
+      data_[ij] += imag(val);
+      ij++;
 #endif
-      }
     }
   }
 }
@@ -484,6 +555,110 @@ void OneBodyDensityMatrices::generateParticleBasis(ParticleSet& pset_target, std
   }
 }
 
+void OneBodyDensityMatrices::generateCrowdParticleBasis(const RefVector<ParticleSet>& psets,
+                                                        std::vector<Matrix<Value>>& phi_wnb)
+{
+  ScopedTimer local_timer(timers_.gen_particle_basis_timer);
+  const int num_walkers = psets.size();
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    ParticleSet& pset = psets[iw];
+    int p             = 0;
+    for (int s = 0; s < species_.size(); ++s)
+    {
+      Matrix<Value>& P_wnb = phi_wnb[s];
+      if (iw == 0)
+      {
+        P_wnb.resize(num_walkers * species_sizes_[s], basis_size_);
+        Phi_Psi_WNB_[s].resize(num_walkers * species_sizes_[s], basis_size_);
+      }
+      for (int n = 0; n < species_sizes_[s]; ++n, ++p)
+      {
+        updateBasis(pset.R[p], pset);
+        Value* row = P_wnb[iw * species_sizes_[s] + n];
+        for (int b = 0; b < basis_size_; ++b)
+          row[b] = qmcplusplus::conj(basis_values_[b]);
+      }
+    }
+  }
+}
+
+void OneBodyDensityMatrices::generateCrowdSampleRatios(const RefVector<ParticleSet>& psets,
+                                                       const RefVector<TrialWaveFunction>& wfns,
+                                                       const std::vector<Real>& walker_weights,
+                                                       int first_sample,
+                                                       int num_samples,
+                                                       std::vector<Matrix<Value>>& psi_wnm)
+{
+  ScopedTimer local_timer(timers_.gen_sample_ratios_timer);
+  const int num_walkers = psets.size();
+  auto& vps             = crowd_vps_.vps;
+
+  // walkers move between crowds, a virtual particle set follows the ParticleSet it was made for
+  if (vps.size() < num_walkers)
+  {
+    vps.resize(num_walkers);
+    crowd_vps_.deltas.resize(num_walkers, std::vector<Position>(sample_batch_));
+    crowd_vps_.ratios.resize(num_walkers, std::vector<Value>(sample_batch_));
+  }
+  for (int iw = 0; iw < num_walkers; ++iw)
+    if (!vps[iw] || &vps[iw]->refPS != &psets[iw].get())
+      vps[iw] = std::make_unique<VirtualParticleSet>(psets[iw], sample_batch_);
+  if (!crowd_vps_.vp_res)
+  {
+    crowd_vps_.vp_res = std::make_unique<ResourceCollection>("OneBodyDensityMatricesVP");
+    vps[0]->createResource(*crowd_vps_.vp_res);
+  }
+
+  RefVectorWithLeader<VirtualParticleSet> vp_list(*vps[0]);
+  RefVectorWithLeader<const VirtualParticleSet> const_vp_list(*vps[0]);
+  RefVectorWithLeader<TrialWaveFunction> wf_list(wfns[0]);
+  RefVector<const std::vector<Position>> deltaV_list;
+  RefVector<std::vector<Value>> ratios_list;
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    vp_list.push_back(*vps[iw]);
+    const_vp_list.push_back(*vps[iw]);
+    wf_list.push_back(wfns[iw]);
+    deltaV_list.push_back(crowd_vps_.deltas[iw]);
+    ratios_list.push_back(crowd_vps_.ratios[iw]);
+  }
+  ResourceCollectionTeamLock<VirtualParticleSet> vp_res_lock(*crowd_vps_.vp_res, vp_list);
+
+  std::vector<NLPPJob<Real>> jobs;
+  jobs.reserve(num_walkers);
+  int p = 0;
+  for (int s = 0; s < species_.size(); ++s)
+  {
+    Matrix<Value>& P_wnm = psi_wnm[s];
+    P_wnm.resize(num_walkers * species_sizes_[s], sample_batch_);
+    for (int n = 0; n < species_sizes_[s]; ++n, ++p)
+    {
+      // move particle p of every walker to the samples, a short last batch repeats its last sample
+      jobs.clear();
+      for (int iw = 0; iw < num_walkers; ++iw)
+      {
+        const Position& r = psets[iw].get().R[p];
+        jobs.emplace_back(-1, p, r, 0.0, Position());
+        std::vector<Position>& deltas = crowd_vps_.deltas[iw];
+        for (int k = 0; k < sample_batch_; ++k)
+          deltas[k] = rsamples_[first_sample + std::min(k, num_samples - 1)] - r;
+      }
+      RefVector<const NLPPJob<Real>> joblist(jobs.begin(), jobs.end());
+      VirtualParticleSet::mw_makeMoves(vp_list, deltaV_list, joblist, false);
+      TrialWaveFunction::mw_evaluateRatios(wf_list, const_vp_list, ratios_list);
+
+      for (int iw = 0; iw < num_walkers; ++iw)
+      {
+        const std::vector<Value>& ratios = crowd_vps_.ratios[iw];
+        Value* row                       = P_wnm[iw * species_sizes_[s] + n];
+        for (int k = 0; k < num_samples; ++k)
+          row[k] = qmcplusplus::conj(ratios[k]) * samples_weights_[first_sample + k] * walker_weights[iw];
+      }
+    }
+  }
+}
+
 void OneBodyDensityMatrices::generateSampleBasis(Matrix<Value>& Phi_mb,
                                                  ParticleSet& pset_target,
                                                  TrialWaveFunction& psi_target)
@@ -630,7 +805,11 @@ template void OneBodyDensityMatrices::implAccumulate<RandomGenerator>(const RefV
                                                                       const RefVector<ParticleSet>& psets,
                                                                       const RefVector<TrialWaveFunction>& wfns,
                                                                       RandomGenerator& rng);
-#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST)
+template void OneBodyDensityMatrices::implAccumulateBatched<RandomGenerator>(const RefVector<MCPWalker>& walkers,
+                                                                             const RefVector<ParticleSet>& psets,
+                                                                             const RefVector<TrialWaveFunction>& wfns,
+                                                                             RandomGenerator& rng);
+#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST) || defined(QMC_RNG_PHILOX)
 template void OneBodyDensityMatrices::generateSamples<StdRandom<double>>(Real weight,
                                                                          ParticleSet& pset_target,
                                                                          StdRandom<double>& rng,
@@ -643,6 +822,11 @@ template void OneBodyDensityMatrices::implAccumulate<StdRandom<double>>(const Re
                                                                         const RefVector<ParticleSet>& psets,
                                                                         const RefVector<TrialWaveFunction>& wfns,
                                                                         StdRandom<double>& rng);
+template void OneBodyDensityMatrices::implAccumulateBatched<StdRandom<double>>(
+    const RefVector<MCPWalker>& walkers,
+    const RefVector<ParticleSet>& psets,
+    const RefVector<TrialWaveFunction>& wfns,
+    StdRandom<double>& rng);
 #endif
 
 } // namespace qmcplusplus
@@ -18,6 +18,8 @@
 #include "Estimators/OperatorEstBase.h"
 #include "type_traits/complex_help.hpp"
 #include "QMCWaveFunctions/CompositeSPOSet.h"
+#include "Particle/VirtualParticleSet.h"
+#include "ResourceCollection.h"
 #include "ParticleBase/RandomSeqGenerator.h"
 #include "QMCWaveFunctions/WaveFunctionFactory.h"
 #include "OneBodyDensityMatricesInput.h"
@@ -121,6 +123,33 @@ private:
   Matrix<Value> Phi_MB_;
   /** @} */
 
+  /** @ingroup Crowd workspace of Evaluator::BATCHED
+   *  rows of the per species matrices run over the walkers of the crowd, then their particles
+   *  @{ */
+  /// conj(basis_values) of every particle of every walker
+  std::vector<Matrix<Value>> Phi_WNB_;
+  /// conj(ratio) times the sample and walker weights for one batch of samples
+  std::vector<Matrix<Value>> Psi_WNM_;
+  std::vector<Matrix<Value>> Phi_Psi_WNB_;
+  /// upper bound of the samples moved together as the virtual particles of one walker
+  static constexpr int max_sample_batch_ = 128;
+  int sample_batch_;
+
+  /** per walker virtual particle sets and their multi walker resource
+   *  they refer to the walkers' ParticleSets so a crowd clone starts without them.
+   */
+  struct CrowdVirtualParticles
+  {
+    UPtrVector<VirtualParticleSet> vps;
+    std::unique_ptr<ResourceCollection> vp_res;
+    std::vector<std::vector<Position>> deltas;
+    std::vector<std::vector<Value>> ratios;
+    CrowdVirtualParticles() = default;
+    CrowdVirtualParticles(const CrowdVirtualParticles&) {}
+  };
+  CrowdVirtualParticles crowd_vps_;
+  /** @} */
+
   /** @ingroup DensityIntegration only used for density integration
    *  @{
    */
@@ -194,6 +223,18 @@ private:
                       const RefVector<TrialWaveFunction>& wfns,
                       RNG_GEN& rng);
 
+  /** batched accumulation, one set of samples is shared by all the walkers of the crowd
+   *
+   *  The sample basis is evaluated once per crowd, the ratios of a batch of samples
+   *  for all the walkers come from one mw_evaluateRatios per particle and the number
+   *  matrices of the whole crowd are summed by two GEMMs per batch.
+   */
+  template<class RNG_GEN>
+  void implAccumulateBatched(const RefVector<MCPWalker>& walkers,
+                             const RefVector<ParticleSet>& psets,
+                             const RefVector<TrialWaveFunction>& wfns,
+                             RNG_GEN& rng);
+
   size_t calcFullDataSize(size_t basis_size, int num_species);
   //local functions
   void normalizeBasis(ParticleSet& pset_target);
@@ -274,6 +315,22 @@ private:
    *    * updates basis_values_ to last rsample
    */
   void generateParticleBasis(ParticleSet& pset_target, std::vector<Matrix<Value>>& phi_nb);
+  /** set phi_wnb to basis values per particle of every walker
+   *  sideeffects:
+   *    * updates basis_values_ to the last particle
+   */
+  void generateCrowdParticleBasis(const RefVector<ParticleSet>& psets, std::vector<Matrix<Value>>& phi_wnb);
+  /** set psi_wnm to the weighted conj(ratios) of every particle of every walker for the samples
+   *  [first_sample, first_sample + num_samples)
+   */
+  void generateCrowdSampleRatios(const RefVector<ParticleSet>& psets,
+                                 const RefVector<TrialWaveFunction>& wfns,
+                                 const std::vector<Real>& walker_weights,
+                                 int first_sample,
+                                 int num_samples,
+                                 std::vector<Matrix<Value>>& psi_wnm);
+  /// add N_BB_ to data_
+  void accumulateNumberMatrices();
 
   //  basis set updates
   void updateBasis(const Position& r, ParticleSet& pset_target);
@@ -331,7 +388,12 @@ extern template void OneBodyDensityMatrices::implAccumulate<RandomGenerator>(con
                                                                              const RefVector<ParticleSet>& psets,
                                                                              const RefVector<TrialWaveFunction>& wfns,
                                                                              RandomGenerator& rng);
-#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST)
+extern template void OneBodyDensityMatrices::implAccumulateBatched<RandomGenerator>(
+    const RefVector<MCPWalker>& walkers,
+    const RefVector<ParticleSet>& psets,
+    const RefVector<TrialWaveFunction>& wfns,
+    RandomGenerator& rng);
+#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST) || defined(QMC_RNG_PHILOX)
 extern template void OneBodyDensityMatrices::generateSamples<StdRandom<double>>(Real weight,
                                                                                 ParticleSet& pset_target,
                                                                                 StdRandom<double>& rng,
@@ -344,6 +406,11 @@ extern template void OneBodyDensityMatrices::implAccumulate<StdRandom<double>>(c
                                                                                const RefVector<ParticleSet>& psets,
                                                                                const RefVector<TrialWaveFunction>& wfns,
                                                                                StdRandom<double>& rng);
+extern template void OneBodyDensityMatrices::implAccumulateBatched<StdRandom<double>>(
+    const RefVector<MCPWalker>& walkers,
+    const RefVector<ParticleSet>& psets,
+    const RefVector<TrialWaveFunction>& wfns,
+    StdRandom<double>& rng);
 #endif
 
 } // namespace qmcplusplus
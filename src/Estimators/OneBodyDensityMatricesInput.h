@@ -37,7 +37,8 @@ public:
   enum class Evaluator
   {
     LOOP,
-    MATRIX
+    MATRIX,
+    BATCHED
   };
 
   /** mapping for enumerated options of OneBodyDensityMatrices
@@ -56,7 +57,8 @@ public:
                               {"integrator-uniform", Integrator::UNIFORM},
                               {"integrator-density", Integrator::DENSITY},
                               {"evaluator-loop", Evaluator::LOOP},
-                              {"evaluator-matrix", Evaluator::MATRIX}};
+                              {"evaluator-matrix", Evaluator::MATRIX},
+                              {"evaluator-batched", Evaluator::BATCHED}};
 
   class OneBodyDensityMatrixInputSection : public InputSection
   {
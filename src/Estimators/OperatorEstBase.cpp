@@ -39,7 +39,9 @@ void OperatorEstBase::normalize(QMCT::RealType invTotWgt)
     elem *= invTotWgt;
 }
 
-void OperatorEstBase::write()
+void OperatorEstBase::write() { write(data_); }
+
+void OperatorEstBase::write(const Data& data)
 {
   if (h5desc_.size() == 0)
     return;
@@ -47,16 +49,14 @@ void OperatorEstBase::write()
     // collectables in mixed precision were accumulated in float but always written
     // to hdf5 in double.
 #ifdef MIXED_PRECISION
-  std::vector<QMCT::FullPrecRealType> expanded_data(data_.size(), 0.0);
-  std::copy_n(data_.begin(), data_.size(), expanded_data.begin());
-  assert(data_.size() > 0);
-  // auto total = std::accumulate(data_->begin(), data_->end(), 0.0);
-  // std::cout << "data size: " << data_->size() << " : " << total << '\n';
+  std::vector<QMCT::FullPrecRealType> expanded_data(data.size(), 0.0);
+  std::copy_n(data.begin(), data.size(), expanded_data.begin());
+  assert(data.size() > 0);
   for (auto& h5d : h5desc_)
     h5d->write(expanded_data.data(), nullptr);
 #else
   for (auto& h5d : h5desc_)
-    h5d->write(data_.data(), nullptr);
+    h5d->write(data.data(), nullptr);
 #endif
 }
 
@@ -23,9 +23,12 @@
 #include "type_traits/DataLocality.h"
 #include <bitset>
 
+class Communicate;
+
 namespace qmcplusplus
 {
 class TrialWaveFunction;
+class QMCHamiltonian;
 namespace testing
 {
 class OEBAccessor;
@@ -90,6 +93,21 @@ public:
                           const RefVector<TrialWaveFunction>& wfns,
                           RandomGenerator& rng) = 0;
 
+  /** Accumulate with the walker hamiltonians at hand
+   *
+   *  Called by the crowd for every estimator. Estimators of per particle energies override it,
+   *  the default ignores the hamiltonians.
+   *  \param[in]      hams          per walker QMCHamiltonian, evaluated at the current configurations
+   */
+  virtual void accumulate(const RefVector<MCPWalker>& walkers,
+                          const RefVector<ParticleSet>& psets,
+                          const RefVector<TrialWaveFunction>& wfns,
+                          const RefVector<QMCHamiltonian>& hams,
+                          RandomGenerator& rng)
+  {
+    accumulate(walkers, psets, wfns, rng);
+  }
+
   /** Reduce estimator result data from crowds to rank
    *
    *  This is assumed to be called from only from one thread per crowds->rank
@@ -102,6 +120,13 @@ public:
 
   virtual void normalize(QMCT::RealType invToWgt);
 
+  /** make the layout of data_ identical on all the ranks of comm before it is reduced
+   *
+   *  The default does nothing, a dense estimator has the same layout everywhere.
+   *  Estimators storing only the occupied part of their grid agree on the union here.
+   */
+  virtual void alignDataForReduction(Communicate& comm) {}
+
   virtual void startBlock(int steps) = 0;
 
   std::vector<QMCT::RealType>& get_data() { return data_; }
@@ -123,6 +148,12 @@ public:
    */
   void write();
 
+  /** Write data laid out as this estimator's data to the registered observable_helpers
+   *
+   *  used to write a copy of the block data while the estimator accumulates the next block.
+   */
+  virtual void write(const Data& data);
+
   /** zero data appropriately for the DataLocality
    */
   void zero();
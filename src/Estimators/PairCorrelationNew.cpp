@@ -0,0 +1,189 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "PairCorrelationNew.h"
+#include "OhmmsData/AttributeSet.h"
+#include "Particle/DistanceTable.h"
+#include "QMCHamiltonians/PairCorrEstimator.h"
+#include "Utilities/SimpleParser.h"
+
+namespace qmcplusplus
+{
+PairCorrelationNew::PairCorrelationNew(xmlNodePtr cur, const ParticleSet& pset, DataLocality dl)
+    : OperatorEstBase(dl)
+{
+  my_name_ = "gofr";
+  // use the simulation cell radius if any direction is periodic
+  if (pset.getLattice().SuperCellEnum)
+  {
+    rmax_   = pset.getLattice().WignerSeitzRadius;
+    volume_ = pset.getLattice().Volume;
+  }
+  std::string sources;
+  int nbins = 0;
+  OhmmsAttributeSet attrib;
+  attrib.add(my_name_, "name");
+  attrib.add(nbins, "num_bin");
+  attrib.add(rmax_, "rmax");
+  attrib.add(delta_, "dr");
+  attrib.add(sources, "source");
+  attrib.add(sources, "sources");
+  attrib.put(cur);
+  if (rmax_ <= 0 || delta_ <= 0)
+    throw std::runtime_error("PairCorrelationNew: rmax and dr must be positive");
+  num_bins_  = nbins > 0 ? nbins : static_cast<int>(std::ceil(rmax_ / delta_));
+  delta_     = rmax_ / static_cast<Real>(num_bins_);
+  delta_inv_ = 1.0 / delta_;
+
+  num_species_ = pset.groups();
+  num_ptcls_   = pset.getTotalNum();
+  for (int i = 0; i < num_species_; i++)
+    species_counts_.push_back(pset.last(i) - pset.first(i));
+  for (int i = 0; i < num_species_; ++i)
+    for (int j = i; j < num_species_; ++j)
+      gofr_names_.push_back("gofr_" + pset.getName() + "_" + std::to_string(i) + "_" + std::to_string(j));
+
+  for (int i = 0; i < pset.getNumDistTables(); ++i)
+    if (&pset.getDistTable(i).get_origin() == &pset)
+      aa_table_index_ = i;
+  if (aa_table_index_ < 0)
+    throw std::runtime_error("PairCorrelationNew: the particle set " + pset.getName() +
+                             " has no distance table with itself");
+
+  std::vector<std::string> source_names;
+  parsewords(sources.c_str(), source_names);
+  int offset = gofr_names_.size();
+  for (const auto& source_name : source_names)
+  {
+    int index = -1;
+    for (int i = 0; i < pset.getNumDistTables(); ++i)
+      if (&pset.getDistTable(i).get_origin() != &pset && pset.getDistTable(i).get_origin().getName() == source_name)
+        index = i;
+    if (index < 0)
+      throw std::runtime_error("PairCorrelationNew: the source " + source_name + " is not a source of " +
+                               pset.getName() + ", it must be used by the hamiltonian or the wavefunction");
+    const DistanceTable& table = pset.getDistTable(index);
+    const SpeciesSet& species  = table.get_origin().getSpeciesSet();
+    source_table_indices_.push_back(index);
+    source_offsets_.push_back(offset);
+    for (int s = 0; s < species.size(); ++s)
+      gofr_names_.push_back("gofr_" + table.getName() + "_" + species.speciesName[s]);
+    offset += species.size();
+  }
+
+  data_.resize(gofr_names_.size() * num_bins_, 0.0);
+  setNormFactor();
+}
+
+int PairCorrelationNew::getPairOffset(int ig, int jg) const
+{
+  return PairCorrEstimator::gen_pair_id(ig, jg, num_species_) * num_bins_;
+}
+
+void PairCorrelationNew::setNormFactor()
+{
+  // same normalization as PairCorrEstimator::set_norm_factor, 1 / the number of pairs of an ideal gas in a shell
+  norm_factor_.resize(num_species_ * (num_species_ + 1) / 2 + 1, num_bins_);
+  const Real ftpi        = 4. / 3 * M_PI;
+  const Real n_tot_pairs = num_ptcls_ * (num_ptcls_ - 1) / 2;
+  for (int i = 0; i < num_bins_; i++)
+  {
+    const Real r          = static_cast<Real>(i) * delta_;
+    const Real bin_volume = ftpi * (std::pow(r + delta_, 3) - std::pow(r, 3));
+    norm_factor_(0, i)    = volume_ / (n_tot_pairs * bin_volume);
+    int indx              = 1;
+    for (int m = 0; m < num_species_; m++)
+      for (int n = m; n < num_species_; n++, indx++)
+      {
+        const Real nm          = species_counts_[m];
+        const Real nn          = species_counts_[n];
+        const Real npairs      = m == n ? nn * (nn - 1) / 2. : nn * nm;
+        norm_factor_(indx, i) = volume_ / (npairs * bin_volume);
+      }
+  }
+}
+
+std::unique_ptr<OperatorEstBase> PairCorrelationNew::spawnCrowdClone() const
+{
+  auto spawn = std::make_unique<PairCorrelationNew>(*this);
+  spawn->get_data().resize(data_.size(), 0.0);
+  return spawn;
+}
+
+void PairCorrelationNew::accumulate(const RefVector<MCPWalker>& walkers,
+                                    const RefVector<ParticleSet>& psets,
+                                    const RefVector<TrialWaveFunction>& wfns,
+                                    RandomGenerator& rng)
+{
+  const int nbins = num_bins_;
+  const Real rmax = rmax_;
+  const Real dinv = delta_inv_;
+  for (int iw = 0; iw < walkers.size(); ++iw)
+  {
+    const ParticleSet& pset = psets[iw];
+    const Real w            = walkers[iw].get().Weight;
+    walkers_weight_ += walkers[iw].get().Weight;
+
+    // the bins of a row are found in one pass over the contiguous distances, then added to the histograms
+    const auto& dii = pset.getDistTableAA(aa_table_index_);
+    row_bins_.resize(dii.centers());
+    row_hists_.resize(dii.centers());
+    for (int iat = 1; iat < dii.centers(); ++iat)
+    {
+      const Real* restrict dist = dii.getDistRow(iat).data();
+      int* restrict bins        = row_bins_.data();
+      for (int j = 0; j < iat; ++j)
+        bins[j] = dist[j] < rmax ? std::min(static_cast<int>(dinv * dist[j]), nbins - 1) : -1;
+      const int ig = pset.GroupID[iat];
+      for (int j = 0; j < iat; ++j)
+        row_hists_[j] = PairCorrEstimator::gen_pair_id(ig, pset.GroupID[j], num_species_);
+      for (int j = 0; j < iat; ++j)
+        if (bins[j] >= 0)
+          data_[row_hists_[j] * nbins + bins[j]] += w * norm_factor_(row_hists_[j] + 1, bins[j]);
+    }
+
+    for (int k = 0; k < source_table_indices_.size(); ++k)
+    {
+      const auto& dab  = pset.getDistTableAB(source_table_indices_[k]);
+      const auto& gid  = dab.get_origin().GroupID;
+      const Real w_src = w / dab.centers();
+      row_bins_.resize(dab.centers());
+      for (int iat = 0; iat < dab.targets(); ++iat)
+      {
+        const Real* restrict dist = dab.getDistRow(iat).data();
+        int* restrict bins        = row_bins_.data();
+        for (int j = 0; j < dab.centers(); ++j)
+          bins[j] = dist[j] < rmax ? std::min(static_cast<int>(dinv * dist[j]), nbins - 1) : -1;
+        for (int j = 0; j < dab.centers(); ++j)
+          if (bins[j] >= 0)
+            data_[(source_offsets_[k] + gid[j]) * nbins + bins[j]] += w_src * norm_factor_(0, bins[j]);
+      }
+    }
+  }
+}
+
+void PairCorrelationNew::registerOperatorEstimator(hid_t gid)
+{
+  hid_t sgid = H5Gcreate2(gid, my_name_.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  std::vector<int> onedim(1, num_bins_);
+  for (int i = 0; i < gofr_names_.size(); ++i)
+  {
+    h5desc_.emplace_back(std::make_unique<ObservableHelper>(gofr_names_[i]));
+    auto& h5o = h5desc_.back();
+    h5o->set_dimensions(onedim, i * num_bins_);
+    h5o->open(sgid);
+    h5o->addProperty(delta_, "delta");
+    h5o->addProperty(rmax_, "cutoff");
+  }
+  H5Gclose(sgid);
+}
+
+} // namespace qmcplusplus
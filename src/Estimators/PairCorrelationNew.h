@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_PAIRCORRELATIONNEW_H
+#define QMCPLUSPLUS_PAIRCORRELATIONNEW_H
+
+#include "OperatorEstBase.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+
+namespace qmcplusplus
+{
+/** @ingroup Estimators
+ * @brief Pair correlation functions for the batched drivers, ported from PairCorrEstimator
+ *
+ *  Histograms the rows of the distance tables the hamiltonian and the wavefunction already keep
+ *  for every walker, the target-target table and the tables from the sources of the input.
+ *  A crowd clone histograms its walkers into its own copy of data_.
+ *
+ *  data_ is laid out as the collectables of the legacy estimator: num_bins values for every pair of species
+ *  of the target, then for every species of every source.
+ *
+ *  <estimator type="PairCorrelation" name="gofr" num_bin="100" rmax="5.0" sources="ion0"/>
+ */
+class PairCorrelationNew : public OperatorEstBase
+{
+public:
+  using Real = QMCT::RealType;
+
+  /** read the estimator element
+   * @param cur  estimator element
+   * @param pset golden target particle set, the sources must be sources of its distance tables
+   */
+  PairCorrelationNew(xmlNodePtr cur, const ParticleSet& pset, DataLocality dl = DataLocality::crowd);
+
+  void startBlock(int steps) override {}
+
+  /** histogram the pair distances of a crowd
+   */
+  void accumulate(const RefVector<MCPWalker>& walkers,
+                  const RefVector<ParticleSet>& psets,
+                  const RefVector<TrialWaveFunction>& wfns,
+                  RandomGenerator& rng) override;
+
+  std::unique_ptr<OperatorEstBase> spawnCrowdClone() const override;
+
+  void registerOperatorEstimator(hid_t gid) override;
+
+  int getNumBins() const { return num_bins_; }
+  Real getRmax() const { return rmax_; }
+  /// offset of the histogram of the target species pair (i,j) in data_, same ordering as PairCorrEstimator
+  int getPairOffset(int ig, int jg) const;
+  /// offset of the histogram of species s of the k-th source in data_
+  int getSourceOffset(int k, int s) const { return (source_offsets_[k] + s) * num_bins_; }
+
+private:
+  void setNormFactor();
+
+  int num_bins_    = 0;
+  Real rmax_       = 10.0;
+  Real delta_      = 0.5;
+  Real delta_inv_  = 2.0;
+  Real volume_     = 1.0;
+  int num_species_ = 0;
+  int num_ptcls_   = 0;
+  std::vector<Real> species_counts_;
+  /// index of the target-target table
+  int aa_table_index_ = -1;
+  /// indices of the tables from the sources
+  std::vector<int> source_table_indices_;
+  /// first histogram of each source
+  std::vector<int> source_offsets_;
+  /// names of the histograms
+  std::vector<std::string> gofr_names_;
+  /// [0 for the sources, 1 + pair id][bin], see PairCorrEstimator::set_norm_factor
+  Matrix<Real> norm_factor_;
+
+  /// crowd scratch, bins and histograms of the pairs of one row
+  std::vector<int> row_bins_;
+  std::vector<int> row_hists_;
+};
+
+} // namespace qmcplusplus
+
+#endif
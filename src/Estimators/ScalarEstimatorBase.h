@@ -42,6 +42,7 @@ struct ScalarEstimatorBase
 {
   using RealType         = QMCTraits::FullPrecRealType;
   using accumulator_type = accumulator_set<RealType>;
+  using reblocking_type  = reblocking_accumulator<RealType>;
   using Walker_t         = MCWalkerConfiguration::Walker_t;
   using MCPWalker        = Walker<QMCTraits, PtclOnLatticeTraits>;
   using WalkerIterator   = MCWalkerConfiguration::const_iterator;
@@ -22,10 +22,13 @@ void SpinDensityInput::readXML(xmlNodePtr cur)
 {
   std::string write_report;
   std::string save_memory;
+  std::string sparse;
   OhmmsAttributeSet attrib;
   attrib.add(myName_, "name");
   attrib.add(write_report, "report");
   attrib.add(save_memory, "save_memory");
+  attrib.add(sparse, "sparse");
+  attrib.add(brick_, "brick");
   attrib.put(cur);
 
   Tensor<Real, DIM> axes;
@@ -95,6 +98,12 @@ void SpinDensityInput::readXML(xmlNodePtr cur)
   else
     save_memory_ = false;
 
+  sparse_ = sparse == "yes";
+  if (sparse_ && save_memory_)
+    throw UniformCommunicateError("SpinDensity input sparse and save_memory cannot be used together");
+  if (brick_ < 1)
+    throw UniformCommunicateError("SpinDensity input brick must be positive");
+
   // weird legacy stuff
   // if (write_report == "yes")
   //   report("  ");
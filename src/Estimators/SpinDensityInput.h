@@ -44,6 +44,8 @@ public:
   int get_npoints() const { return npoints_; }
   bool get_write_report() const { return write_report_; }
   bool get_save_memory() const { return save_memory_; }
+  bool get_sparse() const { return sparse_; }
+  int get_brick() const { return brick_; }
 
   struct DerivedParameters
   {
@@ -74,6 +76,10 @@ private:
   int npoints_;
   bool write_report_;
   bool save_memory_;
+  /// if true, only the bricks of the grid visited by particles are stored
+  bool sparse_ = false;
+  /// number of grid points along each edge of a sparse brick
+  int brick_ = 8;
   /** these are necessary for calculateDerivedParameters
    *  
    *  If we are going to later write out a canonical input for
@@ -15,11 +15,19 @@
 #include <iostream>
 #include <numeric>
 #include <SpeciesSet.h>
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "Numerics/HDFNumericAttrib.h"
+#include "Numerics/HDFSTLAttrib.h"
 
 namespace qmcplusplus
 {
 SpinDensityNew::SpinDensityNew(SpinDensityInput&& input, const SpeciesSet& species, DataLocality dl)
-    : OperatorEstBase(dl), input_(std::move(input)), species_(species), species_size_(getSpeciesSize(species))
+    : OperatorEstBase(dl),
+      input_(std::move(input)),
+      species_(species),
+      species_size_(getSpeciesSize(species)),
+      sparse_(input_.get_sparse())
 {
   my_name_ = "SpinDensity";
 
@@ -31,7 +39,10 @@ SpinDensityNew::SpinDensityNew(SpinDensityInput&& input, const SpeciesSet& speci
 
   derived_parameters_ = input_.calculateDerivedParameters(lattice_);
 
-  data_.resize(getFullDataSize(), 0.0);
+  if (sparse_)
+    initBricks();
+  else
+    data_.resize(getFullDataSize(), 0.0);
 
   if (input_.get_write_report())
     report("  ");
@@ -45,7 +56,8 @@ SpinDensityNew::SpinDensityNew(SpinDensityInput&& input,
       input_(std::move(input)),
       species_(species),
       species_size_(getSpeciesSize(species)),
-      lattice_(lattice)
+      lattice_(lattice),
+      sparse_(input_.get_sparse())
 {
   my_name_ = "SpinDensity";
   std::cout << "SpinDensity constructor called\n";
@@ -57,7 +69,10 @@ SpinDensityNew::SpinDensityNew(SpinDensityInput&& input,
     throw std::runtime_error("SpinDensityNew cannot be constructed from a lattice that is not explicitly defined");
 
   derived_parameters_ = input_.calculateDerivedParameters(lattice_);
-  data_.resize(getFullDataSize());
+  if (sparse_)
+    initBricks();
+  else
+    data_.resize(getFullDataSize());
   if (input_.get_write_report())
     report("  ");
 }
@@ -80,6 +95,36 @@ std::vector<int> SpinDensityNew::getSpeciesSize(const SpeciesSet& species)
 
 size_t SpinDensityNew::getFullDataSize() { return species_.size() * derived_parameters_.npoints; }
 
+void SpinDensityNew::initBricks()
+{
+  auto& dp_   = derived_parameters_;
+  brick_edge_ = input_.get_brick();
+  int num_bricks = 1;
+  size_t brick_points = 1;
+  for (int d = 0; d < QMCT::DIM; ++d)
+  {
+    brick_grid_[d] = (dp_.grid[d] + brick_edge_ - 1) / brick_edge_;
+    num_bricks *= brick_grid_[d];
+    brick_points *= brick_edge_;
+  }
+  brick_size_ = species_.size() * brick_points;
+  brick_slots_.assign(num_bricks, -1);
+  bricks_.clear();
+  data_.clear();
+}
+
+size_t SpinDensityNew::getBrickOffset(int brick)
+{
+  int& slot = brick_slots_[brick];
+  if (slot < 0)
+  {
+    slot = bricks_.size();
+    bricks_.push_back(brick);
+    data_.resize(data_.size() + brick_size_, 0.0);
+  }
+  return slot * brick_size_;
+}
+
 std::unique_ptr<OperatorEstBase> SpinDensityNew::spawnCrowdClone() const {
   std::size_t data_size = data_.size();
   auto spawn_data_locality = data_locality_;
@@ -132,7 +177,21 @@ void SpinDensityNew::accumulate(const RefVector<MCPWalker>& walkers,
       for (int ps = 0; ps < species_size_[s]; ++ps, ++p)
       {
         QMCT::PosType u = lattice_.toUnit(pset.R[p] - dp_.corner);
-        size_t point    = offset;
+        if (sparse_)
+        {
+          // brick id and the point inside the brick
+          int brick    = 0;
+          size_t local = s;
+          for (int d = 0; d < QMCT::DIM; ++d)
+          {
+            const int ig = (int)(dp_.grid[d] * (u[d] - std::floor(u[d]))); //periodic only
+            brick        = brick * brick_grid_[d] + ig / brick_edge_;
+            local        = local * brick_edge_ + ig % brick_edge_;
+          }
+          data_[getBrickOffset(brick) + local] += weight;
+          continue;
+        }
+        size_t point = offset;
         for (int d = 0; d < QMCT::DIM; ++d)
           point += dp_.gdims[d] * ((int)(dp_.grid[d] * (u[d] - std::floor(u[d])))); //periodic only
         accumulateToData(point, weight);
@@ -183,6 +242,22 @@ void SpinDensityNew::collect(const RefVector<OperatorEstBase>& type_erased_opera
       oeb.zero();
     }
   }
+  else if (data_locality_ == DataLocality::crowd && sparse_)
+  {
+    for (OperatorEstBase& crowd_oeb : type_erased_operator_estimators)
+    {
+      auto& oeb        = static_cast<SpinDensityNew&>(crowd_oeb);
+      const auto& data = oeb.get_data();
+      for (int slot = 0; slot < oeb.bricks_.size(); ++slot)
+      {
+        const size_t offset = getBrickOffset(oeb.bricks_[slot]);
+        std::transform(data.begin() + slot * brick_size_, data.begin() + (slot + 1) * brick_size_,
+                       data_.begin() + offset, data_.begin() + offset, std::plus<>{});
+      }
+      walkers_weight_ += oeb.walkers_weight_;
+      oeb.zero();
+    }
+  }
   else if (data_locality_ == DataLocality::crowd)
   {
     OperatorEstBase::collect(type_erased_operator_estimators);
@@ -207,6 +282,9 @@ void SpinDensityNew::report(const std::string& pad)
   for (int d = 0; d < QMCT::DIM; ++d)
     app_log() << pad << "    " << d << " " << lattice_.Rv[d] << std::endl;
   app_log() << pad << "  end cell " << std::endl;
+  if (sparse_)
+    app_log() << pad << "  sparse bricks of " << brick_edge_ << "^" << QMCT::DIM << " points, " << brick_grid_
+              << " bricks" << std::endl;
   app_log() << pad << "  nspecies = " << species_.size() << std::endl;
   for (int s = 0; s < species_.size(); ++s)
     app_log() << pad << "    species[" << s << "]"
@@ -216,6 +294,35 @@ void SpinDensityNew::report(const std::string& pad)
 
 void SpinDensityNew::registerOperatorEstimator(hid_t gid)
 {
+  if (sparse_)
+  {
+    sparse_h5_.close();
+    sparse_h5_.group = H5Gcreate2(gid, my_name_.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    std::vector<int> grid(derived_parameters_.grid.begin(), derived_parameters_.grid.end());
+    HDFAttribIO<std::vector<int>> grid_out(grid);
+    grid_out.write(sparse_h5_.group, "grid");
+    HDFAttribIO<int> brick_out(brick_edge_);
+    brick_out.write(sparse_h5_.group, "brick");
+    std::vector<int> species_size(species_size_);
+    HDFAttribIO<std::vector<int>> species_out(species_size);
+    species_out.write(sparse_h5_.group, "species_sizes");
+    // one record per block: the number of bricks, their ids and their values
+    auto createAppendable = [this](const char* name, hid_t type) {
+      hsize_t dims = 0, maxdims = H5S_UNLIMITED, chunk = 4096;
+      hid_t space = H5Screate_simple(1, &dims, &maxdims);
+      hid_t prop  = H5Pcreate(H5P_DATASET_CREATE);
+      H5Pset_chunk(prop, 1, &chunk);
+      hid_t dset = H5Dcreate2(sparse_h5_.group, name, type, space, H5P_DEFAULT, prop, H5P_DEFAULT);
+      H5Pclose(prop);
+      H5Sclose(space);
+      return dset;
+    };
+    sparse_h5_.counts = createAppendable("brick_counts", H5T_NATIVE_INT);
+    sparse_h5_.bricks = createAppendable("bricks", H5T_NATIVE_INT);
+    sparse_h5_.values = createAppendable("value", H5T_NATIVE_DOUBLE);
+    return;
+  }
+
   std::vector<size_t> my_indexes;
   hid_t sgid = H5Gcreate2(gid, my_name_.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
@@ -237,4 +344,78 @@ void SpinDensityNew::registerOperatorEstimator(hid_t gid)
 }
 
 
+void SpinDensityNew::alignDataForReduction(Communicate& comm)
+{
+  if (!sparse_)
+    return;
+  std::vector<int> occupied(brick_slots_.size(), 0);
+  for (int brick : bricks_)
+    occupied[brick] = 1;
+  comm.allreduce(occupied);
+
+  // every rank stores the union in brick id order
+  std::vector<int> aligned_bricks;
+  for (int brick = 0; brick < occupied.size(); ++brick)
+    if (occupied[brick])
+      aligned_bricks.push_back(brick);
+  Data aligned_data(aligned_bricks.size() * brick_size_, 0.0);
+  for (int slot = 0; slot < aligned_bricks.size(); ++slot)
+  {
+    int& old_slot = brick_slots_[aligned_bricks[slot]];
+    if (old_slot >= 0)
+      std::copy_n(data_.begin() + old_slot * brick_size_, brick_size_, aligned_data.begin() + slot * brick_size_);
+    old_slot = slot;
+  }
+  bricks_ = aligned_bricks;
+  data_.swap(aligned_data);
+  reduced_bricks_ = bricks_;
+}
+
+void SpinDensityNew::write(const Data& data)
+{
+  if (!sparse_)
+  {
+    OperatorEstBase::write(data);
+    return;
+  }
+  if (sparse_h5_.group < 0)
+    return;
+  auto append = [](hid_t dset, hid_t mem_type, const void* buffer, hsize_t n) {
+    hid_t space = H5Dget_space(dset);
+    hsize_t current;
+    H5Sget_simple_extent_dims(space, &current, NULL);
+    H5Sclose(space);
+    if (n == 0)
+      return;
+    hsize_t extended = current + n;
+    H5Dset_extent(dset, &extended);
+    space = H5Dget_space(dset);
+    H5Sselect_hyperslab(space, H5S_SELECT_SET, &current, NULL, &n, NULL);
+    hid_t memspace = H5Screate_simple(1, &n, NULL);
+    H5Dwrite(dset, mem_type, memspace, space, H5P_DEFAULT, buffer);
+    H5Sclose(memspace);
+    H5Sclose(space);
+  };
+  const int count = reduced_bricks_.size();
+  append(sparse_h5_.counts, H5T_NATIVE_INT, &count, 1);
+  append(sparse_h5_.bricks, H5T_NATIVE_INT, reduced_bricks_.data(), reduced_bricks_.size());
+  append(sparse_h5_.values, std::is_same<QMCT::RealType, float>::value ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE,
+         data.data(), data.size());
+}
+
+void SpinDensityNew::SparseH5::close()
+{
+  for (hid_t* dset : {&counts, &bricks, &values})
+    if (*dset > -1)
+    {
+      H5Dclose(*dset);
+      *dset = -1;
+    }
+  if (group > -1)
+  {
+    H5Gclose(group);
+    group = -1;
+  }
+}
+
 } // namespace qmcplusplus
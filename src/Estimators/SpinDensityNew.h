@@ -105,6 +105,14 @@ public:
    */
   void registerOperatorEstimator(hid_t gid) override;
 
+  /** sparse storage: the ranks agree on the union of their occupied bricks
+   */
+  void alignDataForReduction(Communicate& comm) override;
+
+  /** sparse storage appends the reduced bricks to the compact stat.h5 layout
+   */
+  void write(const Data& data) override;
+
 private:
   SpinDensityNew(const SpinDensityNew& sdn) = default;
 
@@ -113,6 +121,12 @@ private:
    */
   size_t getFullDataSize();
   void accumulateToData(size_t point, QMCT::RealType weight);
+  /// set up the brick tiling of the grid for the sparse storage
+  void initBricks();
+  /** offset in data_ of a brick, it is added if it is not stored yet
+   * @param brick brick id
+   */
+  size_t getBrickOffset(int brick);
   void reset();
   void report(const std::string& pad);
 
@@ -134,6 +148,40 @@ private:
   SpinDensityInput::DerivedParameters derived_parameters_;
   /**}@*/
 
+  /** @ingroup SpinDensity sparse storage
+   *
+   *  The grid is tiled by bricks of brick^DIM points and data_ only holds the bricks particles have visited,
+   *  brick after brick with the species of a brick stored one after the other.
+   *  @{
+   */
+  /// hdf5 handles of the compact stat.h5 layout, a copy starts without them
+  struct SparseH5
+  {
+    hid_t group   = -1;
+    hid_t counts  = -1;
+    hid_t bricks  = -1;
+    hid_t values  = -1;
+    SparseH5()    = default;
+    SparseH5(const SparseH5&) {}
+    ~SparseH5() { close(); }
+    void close();
+  };
+  const bool sparse_;
+  /// points along each edge of a brick
+  int brick_edge_ = 0;
+  /// bricks along each grid direction
+  TinyVector<int, QMCT::DIM> brick_grid_;
+  /// values stored per brick, all species
+  size_t brick_size_ = 0;
+  /// slot of each brick in data_, -1 if it is not stored
+  std::vector<int> brick_slots_;
+  /// ids of the stored bricks in their data_ order
+  std::vector<int> bricks_;
+  /// ids of the bricks of the last reduction, the layout of the data being written
+  std::vector<int> reduced_bricks_;
+  SparseH5 sparse_h5_;
+  /**}@*/
+
   friend class testing::SpinDensityNewTests;
 };
 
@@ -0,0 +1,152 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "StructureFactorNew.h"
+#include "OhmmsData/AttributeSet.h"
+#include "LongRange/KContainer.h"
+#include "LongRange/StructFact.h"
+
+namespace qmcplusplus
+{
+StructureFactorNew::StructureFactorNew(xmlNodePtr cur, const ParticleSet& pset, DataLocality dl)
+    : OperatorEstBase(dl)
+{
+  my_name_ = "sk";
+  OhmmsAttributeSet attrib;
+  attrib.add(my_name_, "name");
+  attrib.add(write_rhok_, "rhok");
+  attrib.put(cur);
+
+  if (pset.getLattice().SuperCellEnum == SUPERCELL_OPEN)
+    throw std::runtime_error("StructureFactorNew: the structure factor needs periodic boundary conditions");
+  if (!pset.hasSK())
+    throw std::runtime_error("StructureFactorNew: the particle set " + pset.getName() +
+                             " has no structure factor, it needs a long range hamiltonian term");
+
+  const KContainer& k_lists = pset.getSimulationCell().getKLists();
+  num_k_                    = k_lists.numk;
+  kpoints_                  = k_lists.kpts_cart;
+  num_species_              = pset.getSpeciesSet().size();
+  for (int s = 0; s < num_species_; ++s)
+    species_names_.push_back(pset.getSpeciesSet().speciesName[s]);
+  one_over_n_ = 1.0 / static_cast<Real>(pset.getTotalNum());
+
+  data_.resize(write_rhok_ ? getRhokOffset(num_species_) : num_k_, 0.0);
+}
+
+std::unique_ptr<OperatorEstBase> StructureFactorNew::spawnCrowdClone() const
+{
+  auto spawn = std::make_unique<StructureFactorNew>(*this);
+  spawn->get_data().resize(data_.size(), 0.0);
+  return spawn;
+}
+
+void StructureFactorNew::accumulate(const RefVector<MCPWalker>& walkers,
+                                    const RefVector<ParticleSet>& psets,
+                                    const RefVector<TrialWaveFunction>& wfns,
+                                    RandomGenerator& rng)
+{
+  const int nw = walkers.size();
+  if (nw == 0)
+    return;
+  const int nk = num_k_;
+  rhok_tot_r_.resize(nw, nk);
+  rhok_tot_i_.resize(nw, nk);
+
+  // sum rho_k of the species of every walker, and the weighted rho_k per species
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    const StructFact& sk   = psets[iw].get().getSK();
+    const Real w           = walkers[iw].get().Weight;
+    Real* restrict tot_r   = rhok_tot_r_[iw];
+    Real* restrict tot_i   = rhok_tot_i_[iw];
+    walkers_weight_ += walkers[iw].get().Weight;
+    std::fill_n(tot_r, nk, Real(0));
+    std::fill_n(tot_i, nk, Real(0));
+    for (int s = 0; s < num_species_; ++s)
+    {
+#if defined(USE_REAL_STRUCT_FACTOR)
+      const Real* restrict rhok_r = sk.rhok_r[s];
+      const Real* restrict rhok_i = sk.rhok_i[s];
+      for (int k = 0; k < nk; ++k)
+      {
+        tot_r[k] += rhok_r[k];
+        tot_i[k] += rhok_i[k];
+      }
+      if (write_rhok_)
+      {
+        Real* restrict acc_r = data_.data() + getRhokOffset(s);
+        Real* restrict acc_i = acc_r + nk;
+        for (int k = 0; k < nk; ++k)
+        {
+          acc_r[k] += w * rhok_r[k];
+          acc_i[k] += w * rhok_i[k];
+        }
+      }
+#else
+      const auto* restrict rhok = sk.rhok[s];
+      for (int k = 0; k < nk; ++k)
+      {
+        tot_r[k] += rhok[k].real();
+        tot_i[k] += rhok[k].imag();
+      }
+      if (write_rhok_)
+      {
+        Real* restrict acc_r = data_.data() + getRhokOffset(s);
+        Real* restrict acc_i = acc_r + nk;
+        for (int k = 0; k < nk; ++k)
+        {
+          acc_r[k] += w * rhok[k].real();
+          acc_i[k] += w * rhok[k].imag();
+        }
+      }
+#endif
+    }
+  }
+
+  // |rho_k|^2 of the whole crowd
+  Real* restrict sk_acc = data_.data();
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    const Real wn              = walkers[iw].get().Weight * one_over_n_;
+    const Real* restrict tot_r = rhok_tot_r_[iw];
+    const Real* restrict tot_i = rhok_tot_i_[iw];
+    for (int k = 0; k < nk; ++k)
+      sk_acc[k] += wn * (tot_r[k] * tot_r[k] + tot_i[k] * tot_i[k]);
+  }
+}
+
+void StructureFactorNew::registerOperatorEstimator(hid_t gid)
+{
+  hid_t sgid = H5Gcreate2(gid, my_name_.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  h5desc_.emplace_back(std::make_unique<ObservableHelper>("sk"));
+  auto& oh_sk = h5desc_.back();
+  std::vector<int> ng(1, num_k_);
+  oh_sk->set_dimensions(ng, 0);
+  oh_sk->open(sgid);
+  oh_sk->addProperty(kpoints_, "kpoints");
+
+  if (write_rhok_)
+  {
+    // same layout as StaticStructureFactor, [real,imag][k] per species
+    std::vector<int> ng_rhok{2, num_k_};
+    for (int s = 0; s < num_species_; ++s)
+    {
+      h5desc_.emplace_back(std::make_unique<ObservableHelper>("rhok_" + species_names_[s]));
+      auto& oh = h5desc_.back();
+      oh->set_dimensions(ng_rhok, getRhokOffset(s));
+      oh->open(sgid);
+    }
+  }
+  H5Gclose(sgid);
+}
+
+} // namespace qmcplusplus
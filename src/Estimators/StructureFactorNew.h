@@ -0,0 +1,76 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_STRUCTUREFACTORNEW_H
+#define QMCPLUSPLUS_STRUCTUREFACTORNEW_H
+
+#include "OperatorEstBase.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+
+namespace qmcplusplus
+{
+/** @ingroup Estimators
+ * @brief Static structure factor for the batched drivers, replaces SkEstimator, SkAllEstimator and StaticStructureFactor
+ *
+ *  Reads rho_k of the walkers from their StructFact, which the particle sets keep up to date as the walkers move,
+ *  so the estimator makes no structure factor pass of its own.
+ *
+ *  data_ holds \f$ S(k) = \frac{1}{N}|\sum_\alpha \rho^\alpha_k|^2 \f$ for the k-points of the simulation cell,
+ *  followed by the real and imaginary parts of \f$\rho^\alpha_k\f$ of every species if rhok is requested.
+ *  The values are weighted by the walker weights.
+ *
+ *  <estimator type="StructureFactor" name="sk" rhok="yes"/>
+ */
+class StructureFactorNew : public OperatorEstBase
+{
+public:
+  using Real = QMCT::RealType;
+
+  /** read the estimator element
+   * @param cur  estimator element
+   * @param pset golden target particle set, it must have a structure factor
+   */
+  StructureFactorNew(xmlNodePtr cur, const ParticleSet& pset, DataLocality dl = DataLocality::crowd);
+
+  void startBlock(int steps) override {}
+
+  /** accumulate S(k) and rho_k of a crowd
+   */
+  void accumulate(const RefVector<MCPWalker>& walkers,
+                  const RefVector<ParticleSet>& psets,
+                  const RefVector<TrialWaveFunction>& wfns,
+                  RandomGenerator& rng) override;
+
+  std::unique_ptr<OperatorEstBase> spawnCrowdClone() const override;
+
+  void registerOperatorEstimator(hid_t gid) override;
+
+  int getNumK() const { return num_k_; }
+  /// offset of the rho_k of species s in data_
+  int getRhokOffset(int s) const { return num_k_ + s * 2 * num_k_; }
+
+private:
+  /// accumulate the rho_k of every species
+  bool write_rhok_ = true;
+  int num_k_       = 0;
+  int num_species_ = 0;
+  Real one_over_n_ = 0;
+  std::vector<std::string> species_names_;
+  std::vector<QMCT::PosType> kpoints_;
+
+  /// crowd scratch, rho_k summed over the species, [walker][k]
+  Matrix<Real> rhok_tot_r_;
+  Matrix<Real> rhok_tot_i_;
+};
+
+} // namespace qmcplusplus
+
+#endif
@@ -31,9 +31,12 @@
 #include "Utilities/IteratorUtility.h"
 #include "ModernStringUtils.hpp"
 #include "Message/Communicate.h"
+#include "Message/CommOperators.h"
 #include "hdf/hdf_archive.h"
 #include "Concurrency/OpenMP.h"
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <algorithm>
 
@@ -1296,6 +1299,56 @@ struct TraceBuffer
   }
 
 
+  /** append rows to one dataset per quantity, top/columns/domain/quantity with the shape [rows][row_end-row_start]
+   *
+   *  A quantity is stored contiguously, it is read without the others and compresses well.
+   *  @param rows     nrows rows with the layout of buffer
+   *  @param pointers rows already in the dataset of each written quantity
+   */
+  inline void write_columns_hdf(hdf_archive& f,
+                                const T* rows,
+                                hsize_t nrows,
+                                std::vector<hsize_t>& pointers,
+                                hsize_t chunk_rows,
+                                int deflate_level)
+  {
+    if (verbose)
+      app_log() << "TraceBuffer<" << type << ">::write_columns_hdf() " << nrows << " " << buffer.size(1) << std::endl;
+    if (nrows == 0)
+      return;
+    const int row_size = buffer.size(1);
+    std::vector<T> column;
+    int icolumn = 0;
+    f.push(top);
+    f.push("columns");
+    auto write_samples = [&](auto& ordered_samples) {
+      for (int s = 0; s < ordered_samples.size(); s++)
+      {
+        auto& tsample   = *ordered_samples[s];
+        const int width = tsample.buffer_end - tsample.buffer_start;
+        if (!tsample.write || width == 0)
+          continue;
+        column.resize(nrows * width);
+        for (hsize_t r = 0; r < nrows; ++r)
+          std::copy_n(rows + r * row_size + tsample.buffer_start, width, column.data() + r * width);
+        if (icolumn == pointers.size())
+          pointers.push_back(0);
+        hsize_t cdims[2] = {nrows, static_cast<hsize_t>(width)};
+        f.push(tsample.domain);
+        h5d_append(f.top(), tsample.name, pointers[icolumn++], 2, cdims, column.data(), chunk_rows, H5P_DEFAULT,
+                   deflate_level);
+        f.pop();
+      }
+    };
+    write_samples(samples->ordered_samples);
+    if (has_complex)
+      write_samples(complex_samples->ordered_samples);
+    f.pop();
+    f.pop();
+    f.flush();
+  }
+
+
   inline void test_buffer_write(int sample_size)
   {
     //check that the size is correct
@@ -1445,16 +1498,28 @@ public:
   bool verbose;
   std::string format;
   bool hdf_format;
+  /// stream the rows in chunks to one dataset per quantity
+  bool columnar_format;
+  /// rows per chunk of the columnar datasets, a clone streaming to a per rank file writes when it holds a chunk
+  int chunk_rows;
+  /// deflate level of the columnar datasets, 0 is uncompressed
+  int compression;
+  /// the ranks of a node send their rows to the first rank of the node at the end of each block
+  bool node_aggregation;
   std::string file_root;
   Communicate* communicator;
   hdf_archive* hdf_file;
+  /// master copy the full chunks are written through, null if the rows wait for the end of the block
+  TraceManager* chunk_writer;
 
-  TraceManager(Communicate* comm = 0) : verbose(false), hdf_file(0)
+  TraceManager(Communicate* comm = 0) : verbose(false), hdf_file(0), chunk_writer(0)
   {
     reset_permissions();
     master_copy    = true;
     communicator   = comm;
     throttle       = 1;
+    chunk_rows     = 1024;
+    compression    = 0;
     format         = "hdf";
     default_domain = "scalars";
     request.set_scalar_domain(default_domain);
@@ -1490,6 +1555,10 @@ public:
     verbose              = tm.verbose;
     format               = tm.format;
     hdf_format           = tm.hdf_format;
+    columnar_format      = tm.columnar_format;
+    chunk_rows           = tm.chunk_rows;
+    compression          = tm.compression;
+    node_aggregation     = tm.node_aggregation;
     default_domain       = tm.default_domain;
   }
 
@@ -1511,6 +1580,8 @@ public:
     writing_traces       = false;
     verbose              = false;
     hdf_format           = false;
+    columnar_format      = false;
+    node_aggregation     = false;
     request.reset();
   }
 
@@ -1539,6 +1610,7 @@ public:
       std::string scalar_defaults = "yes";
       std::string array_defaults  = "yes";
       std::string verbose_write   = "no";
+      std::string aggregate       = "rank";
       OhmmsAttributeSet attrib;
       attrib.add(writing, "write");
       attrib.add(scalar, "scalar");
@@ -1548,6 +1620,9 @@ public:
       attrib.add(format, "format");
       attrib.add(throttle, "throttle");
       attrib.add(verbose_write, "verbose");
+      attrib.add(chunk_rows, "chunk");
+      attrib.add(compression, "compression");
+      attrib.add(aggregate, "aggregate");
       attrib.add(array, "particle");                   //legacy
       attrib.add(array_defaults, "particle_defaults"); //legacy
       attrib.put(cur);
@@ -1562,9 +1637,21 @@ public:
       {
         hdf_format = true;
       }
+      else if (format == "columnar")
+      {
+        columnar_format = true;
+        if (chunk_rows < 1)
+          APP_ABORT("TraceManager::put chunk must be positive");
+        if (compression < 0 || compression > 9)
+          APP_ABORT("TraceManager::put compression must be a deflate level from 0 to 9");
+        if (aggregate != "rank" && aggregate != "node")
+          APP_ABORT("TraceManager::put " + aggregate + " is not a valid aggregate\n  valid options are: rank, node");
+        node_aggregation = aggregate == "node";
+      }
       else
       {
-        APP_ABORT("TraceManager::put " + format + " is not a valid file format for traces\n  valid options is: hdf");
+        APP_ABORT("TraceManager::put " + format +
+                  " is not a valid file format for traces\n  valid options are: hdf, columnar");
       }
 
       //read scalar and array elements
@@ -1917,6 +2004,8 @@ public:
         app_log() << " TraceManager::buffer_sample() " << master_copy << std::endl;
       int_buffer.collect_sample();
       real_buffer.collect_sample();
+      if (chunk_writer && std::max(int_buffer.buffer.size(0), real_buffer.buffer.size(0)) >= chunk_writer->chunk_rows)
+        chunk_writer->write_chunk(*this);
     }
   }
 
@@ -1935,6 +2024,10 @@ public:
         {
           write_buffers_hdf(clones);
         }
+        else if (columnar_format)
+        {
+          write_buffers_columnar(clones);
+        }
       }
     }
     else
@@ -1956,6 +2049,10 @@ public:
         {
           open_hdf_file(clones);
         }
+        else if (columnar_format)
+        {
+          open_columnar_file(clones);
+        }
       }
     }
     else
@@ -1975,6 +2072,10 @@ public:
         {
           close_hdf_file();
         }
+        else if (columnar_format)
+        {
+          close_columnar_file();
+        }
       }
     }
     else
@@ -2037,6 +2138,7 @@ public:
     app_log() << pad2 << "writing_traces          = " << writing_traces << std::endl;
     app_log() << pad2 << "format                  = " << format << std::endl;
     app_log() << pad2 << "hdf format              = " << hdf_format << std::endl;
+    app_log() << pad2 << "columnar format         = " << columnar_format << std::endl;
     app_log() << pad2 << "default_domain          = " << default_domain << std::endl;
     int_buffer.write_summary(pad2);
     real_buffer.write_summary(pad2);
@@ -2107,6 +2209,145 @@ public:
   }
 
   inline void close_hdf_file() { delete hdf_file; }
+
+  //columnar file operations
+  //  with node aggregation only the first rank of each node opens a file
+  inline void open_columnar_file(std::vector<TraceManager*>& clones)
+  {
+    if (clones.size() == 0)
+      APP_ABORT("TraceManager::open_columnar_file  no trace clones exist, cannot open file");
+    node_comm.reset();
+    if (node_aggregation && communicator->size() > 1)
+    {
+      node_comm = std::make_unique<Communicate>();
+      node_comm->initializeAsNodeComm(*communicator);
+      if (node_comm->size() == 1)
+        node_comm.reset();
+    }
+    // the clones stream full chunks unless the rows are gathered at the end of the block
+    for (int ip = 0; ip < clones.size(); ++ip)
+      clones[ip]->chunk_writer = node_comm ? 0 : this;
+    int_column_pointers.clear();
+    real_column_pointers.clear();
+    if (node_comm && node_comm->rank() != 0)
+      return;
+    int nprocs = communicator->size();
+    int rank   = communicator->rank();
+    char ptoken[32];
+    std::string file_name = file_root;
+    if (nprocs > 1)
+    {
+      if (nprocs > 10000)
+        sprintf(ptoken, ".p%05d", rank);
+      else if (nprocs > 1000)
+        sprintf(ptoken, ".p%04d", rank);
+      else
+        sprintf(ptoken, ".p%03d", rank);
+      file_name += ptoken;
+    }
+    file_name += ".traces.h5";
+    if (verbose)
+      app_log() << "TraceManager::open_columnar_file  opening traces hdf file " << file_name << std::endl;
+    // every writer has a file of its own
+    hdf_file        = new hdf_archive();
+    bool successful = hdf_file->create(file_name);
+    if (!successful)
+      APP_ABORT("TraceManager::open_columnar_file  failed to open hdf file " + file_name);
+    int nranks = node_comm ? node_comm->size() : 1;
+    hdf_file->write(nranks, "ranks");
+    hdf_file->write(chunk_rows, "chunk");
+    TraceManager& tm = *clones[0];
+    tm.int_buffer.register_hdf_data(*hdf_file);
+    tm.real_buffer.register_hdf_data(*hdf_file);
+  }
+
+
+  /// write the rows buffered by a clone and empty its buffers, called by the clones while they run
+  inline void write_chunk(TraceManager& tm)
+  {
+    std::lock_guard<std::mutex> lock(chunk_mutex);
+    if (tm.int_buffer.buffer.size(0) > 0)
+      tm.int_buffer.write_columns_hdf(*hdf_file, tm.int_buffer.buffer.data(), tm.int_buffer.buffer.size(0),
+                                      int_column_pointers, chunk_rows, compression);
+    if (tm.real_buffer.buffer.size(0) > 0)
+      tm.real_buffer.write_columns_hdf(*hdf_file, tm.real_buffer.buffer.data(), tm.real_buffer.buffer.size(0),
+                                       real_column_pointers, chunk_rows, compression);
+    tm.reset_buffers();
+  }
+
+
+  /** gather the rows of all the clones of the ranks of a node on its first rank
+   *  @return number of rows gathered, only on the first rank
+   */
+  template<typename T>
+  inline hsize_t gather_node_rows(const std::vector<TraceBuffer<T>*>& buffers, std::vector<T>& node_rows)
+  {
+    const int row_size = buffers[0]->buffer.size(1);
+    std::vector<T> rows;
+    for (int ip = 0; ip < buffers.size(); ++ip)
+      rows.insert(rows.end(), buffers[ip]->buffer.data(), buffers[ip]->buffer.data() + buffers[ip]->buffer.size());
+    const int nnode = node_comm->size();
+    std::vector<int> count(1, rows.size());
+    std::vector<int> counts(nnode, 0);
+    std::vector<int> displ(nnode, 0);
+    node_comm->gather(count, counts, 0);
+    for (int i = 1; i < nnode; ++i)
+      displ[i] = displ[i - 1] + counts[i - 1];
+    node_rows.resize(std::max(displ[nnode - 1] + counts[nnode - 1], 1));
+    node_comm->gatherv(rows, node_rows, counts, displ, 0);
+    if (node_comm->rank() != 0 || row_size == 0)
+      return 0;
+    return (displ[nnode - 1] + counts[nnode - 1]) / row_size;
+  }
+
+
+  inline void write_buffers_columnar(std::vector<TraceManager*>& clones)
+  {
+    if (verbose)
+      app_log() << "TraceManager::write_buffers_columnar " << master_copy << std::endl;
+    if (!node_comm)
+    {
+      for (int ip = 0; ip < clones.size(); ++ip)
+        write_chunk(*clones[ip]);
+      return;
+    }
+    std::vector<TraceBuffer<TraceInt>*> int_buffers;
+    std::vector<TraceBuffer<TraceReal>*> real_buffers;
+    for (int ip = 0; ip < clones.size(); ++ip)
+    {
+      int_buffers.push_back(&clones[ip]->int_buffer);
+      real_buffers.push_back(&clones[ip]->real_buffer);
+    }
+    std::vector<TraceInt> node_int_rows;
+    std::vector<TraceReal> node_real_rows;
+    hsize_t int_rows  = gather_node_rows(int_buffers, node_int_rows);
+    hsize_t real_rows = gather_node_rows(real_buffers, node_real_rows);
+    if (node_comm->rank() == 0)
+    {
+      TraceManager& tm = *clones[0];
+      tm.int_buffer.write_columns_hdf(*hdf_file, node_int_rows.data(), int_rows, int_column_pointers, chunk_rows,
+                                      compression);
+      tm.real_buffer.write_columns_hdf(*hdf_file, node_real_rows.data(), real_rows, real_column_pointers, chunk_rows,
+                                       compression);
+    }
+  }
+
+
+  inline void close_columnar_file()
+  {
+    delete hdf_file;
+    hdf_file = 0;
+    node_comm.reset();
+  }
+
+private:
+  /// serializes the chunk writes of the clones
+  std::mutex chunk_mutex;
+  /// ranks of this node, only with node aggregation
+  std::unique_ptr<Communicate> node_comm;
+  /// rows in the datasets of the written quantities
+  std::vector<hsize_t> int_column_pointers;
+  std::vector<hsize_t> real_column_pointers;
 };
 
 
@@ -21,7 +21,10 @@
 #ifndef QMCPLUSPLUS_ACCUMULATORS_H
 #define QMCPLUSPLUS_ACCUMULATORS_H
 
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <vector>
 #include "CPU/math.hpp"
 
 /** generic accumulator of a scalar type
@@ -143,6 +146,86 @@ struct accumulator_set
   }
 };
 
+/** online reblocking of a serially correlated series, H. Flyvbjerg and H. G. Petersen, J. Chem. Phys. 91, 461 (1989)
+ *
+ * Level k accumulates the averages of 2^k consecutive samples. A sample is paired with the unpaired
+ * sample of its level and their average moves up a level, so the memory grows as the log of the number
+ * of samples. The standard error from level k is only reliable once the blocks of 2^k samples are longer
+ * than the autocorrelation time, where the errors of the levels reach a plateau.
+ */
+template<typename T, typename = typename std::enable_if<std::is_floating_point<T>::value>::type>
+struct reblocking_accumulator
+{
+  using value_type  = T;
+  using return_type = T;
+
+  /// blocks of each level
+  std::vector<accumulator_set<T>> levels;
+  /// unpaired sample of each level
+  std::vector<T> unpaired;
+  std::vector<bool> has_unpaired;
+
+  /** add a sample */
+  inline void operator()(value_type x)
+  {
+    for (size_t k = 0;; ++k)
+    {
+      if (k == levels.size())
+      {
+        levels.emplace_back();
+        unpaired.push_back(0);
+        has_unpaired.push_back(false);
+      }
+      levels[k](x);
+      if (!has_unpaired[k])
+      {
+        unpaired[k]     = x;
+        has_unpaired[k] = true;
+        return;
+      }
+      x               = 0.5 * (unpaired[k] + x);
+      has_unpaired[k] = false;
+    }
+  }
+
+  inline size_t num_levels() const { return levels.size(); }
+
+  /** return the number of samples */
+  inline return_type count() const { return levels.empty() ? 0 : levels[0].count(); }
+
+  /** return the mean */
+  inline return_type mean() const { return levels.empty() ? 0 : levels[0].mean(); }
+
+  /** return the standard error of the mean treating the blocks of level k as independent */
+  inline return_type level_error(size_t k) const
+  {
+    const T n = k < levels.size() ? levels[k].count() : 0;
+    if (n < 2)
+      return std::numeric_limits<T>::max();
+    return std::sqrt(std::max(levels[k].variance(), T(0)) / (n - 1));
+  }
+
+  /** return the largest error of the levels with at least min_blocks blocks
+   *
+   * The largest error is the plateau value when it is reached, or an upper bound of the error of the
+   * shorter blocks. Returns the max of T until there are min_blocks samples.
+   */
+  inline return_type error(int min_blocks = 32) const
+  {
+    T largest = std::numeric_limits<T>::max();
+    for (size_t k = 0; k < levels.size() && levels[k].count() >= min_blocks; ++k)
+      largest = k == 0 ? level_error(k) : std::max(largest, level_error(k));
+    return largest;
+  }
+
+  inline void clear()
+  {
+    levels.clear();
+    unpaired.clear();
+    has_unpaired.clear();
+  }
+};
+
 template<typename ACC>
 inline typename ACC::value_type mean(const ACC& ac)
 {
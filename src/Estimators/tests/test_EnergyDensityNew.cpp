@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "EnergyDensityNew.h"
+#include "ParticleSet.h"
+#include "OhmmsData/Libxml2Doc.h"
+
+namespace qmcplusplus
+{
+namespace
+{
+const char* cartesian_input = R"XML(
+<estimator type="EnergyDensity" name="EDcell" dynamic="e">
+  <spacegrid coord="cartesian">
+    <origin p1="zero"/>
+    <axis p1="a1" scale=".5" label="x" grid="-1 (1.0) 1"/>
+    <axis p1="a2" scale=".5" label="y" grid="-1 (1.0) 1"/>
+    <axis p1="a3" scale=".5" label="z" grid="-1 (1.0) 1"/>
+  </spacegrid>
+</estimator>
+)XML";
+
+const SimulationCell& makeCubicCell()
+{
+  static const SimulationCell simulation_cell([] {
+    CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> lattice;
+    lattice.BoxBConds = true;
+    lattice.R.diagonal(4.0);
+    lattice.reset();
+    return lattice;
+  }());
+  return simulation_cell;
+}
+} // namespace
+
+TEST_CASE("EnergyDensityNew cartesian grid", "[estimators]")
+{
+  using Real = EnergyDensityNew::FullPrecRealType;
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(cartesian_input));
+
+  ParticleSet pset(makeCubicCell());
+  pset.setName("e");
+  pset.create(2);
+  // the second electron is binned at its minimum image (-1,-1,-1)
+  pset.R[0] = ParticleSet::PosType(1.0, 1.0, 1.0);
+  pset.R[1] = ParticleSet::PosType(3.0, 3.0, 3.0);
+
+  EnergyDensityNew edn(doc.getRoot(), pset);
+  REQUIRE(edn.getNumSpaceGrids() == 1);
+  CHECK(edn.getOutsideOffset() == 8 * EnergyDensityNew::N_ED_VALUES);
+
+  Vector<Real> kinetic{1.0, 0.5};
+  Vector<Real> potential{-3.0, -1.0};
+  Vector<Real> potential_static;
+  edn.accumulateWalker(pset, 2.0, kinetic, potential, potential_static);
+
+  auto& data = edn.get_data();
+  REQUIRE(data.size() == 9 * EnergyDensityNew::N_ED_VALUES);
+  // (1,1,1) lies in the last cell whatever the axis ordering, the image of (3,3,3) in the first
+  const int last = 7 * EnergyDensityNew::N_ED_VALUES;
+  CHECK(data[last + EnergyDensityNew::W] == Approx(2.0));
+  CHECK(data[last + EnergyDensityNew::T] == Approx(2.0));
+  CHECK(data[last + EnergyDensityNew::V] == Approx(-6.0));
+  CHECK(data[EnergyDensityNew::W] == Approx(2.0));
+  CHECK(data[EnergyDensityNew::T] == Approx(1.0));
+  CHECK(data[EnergyDensityNew::V] == Approx(-2.0));
+  // the grid fills the cell, nothing is outside
+  for (int v = 0; v < EnergyDensityNew::N_ED_VALUES; ++v)
+    CHECK(data[edn.getOutsideOffset() + v] == 0.0);
+
+  // a crowd clone has the layout but not the data
+  auto clone = edn.spawnCrowdClone();
+  CHECK(clone->get_data().size() == data.size());
+  CHECK(clone->get_data()[last] == 0.0);
+}
+
+TEST_CASE("EnergyDensityNew bad input", "[estimators]")
+{
+  ParticleSet pset(makeCubicCell());
+  pset.setName("e");
+  pset.create(2);
+
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(R"XML(<estimator type="EnergyDensity" name="ED" dynamic="e" static="ion0"/>)XML"));
+  CHECK_THROWS_AS(EnergyDensityNew(doc.getRoot(), pset), std::runtime_error);
+  REQUIRE(doc.parseFromString(R"XML(<estimator type="EnergyDensity" name="ED" dynamic="p"/>)XML"));
+  CHECK_THROWS_AS(EnergyDensityNew(doc.getRoot(), pset), std::runtime_error);
+  REQUIRE(doc.parseFromString(R"XML(<estimator type="EnergyDensity" name="ED" ion_points="yes"/>)XML"));
+  CHECK_THROWS_AS(EnergyDensityNew(doc.getRoot(), pset), std::runtime_error);
+}
+
+} // namespace qmcplusplus
@@ -214,4 +214,97 @@ TEST_CASE("MomentumDistribution::accumulate", "[estimators]")
 }
 
 
+TEST_CASE("MomentumDistribution::accumulate batched", "[estimators]")
+{
+  using MCPWalker = OperatorEstBase::MCPWalker;
+
+  // clang-format: off
+  const char* xml_loop = R"(
+<estimator type="MomentumDistribution" name="nofk" samples="5" kmax="3"/>
+)";
+  const char* xml_batched = R"(
+<estimator type="MomentumDistribution" name="nofk" samples="5" kmax="3" batched="yes"/>
+)";
+  // clang-format: on
+
+  Communicate* comm;
+  comm = OHMMS::Controller;
+  outputManager.pause();
+  auto particle_pool     = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool = MinimalWaveFunctionPool::make_diamondC_1x1x1(comm, particle_pool);
+  auto& pset             = *(particle_pool.getParticleSet("e"));
+
+  pset.R = ParticleSet::ParticlePos{{1.751870349, 4.381521229, 2.865202269}, {3.244515371, 4.382273176, 4.21105285},
+                                    {3.000459944, 3.329603408, 4.265030556}, {3.748660329, 3.63420622, 5.393637791},
+                                    {3.033228526, 3.391869137, 4.654413566}, {3.114198787, 2.654334594, 5.231075822},
+                                    {3.657151589, 4.883870516, 4.201243939}, {2.97317591, 4.245644974, 4.284564732}};
+
+  auto makeMD = [&pset](const char* xml) {
+    Libxml2Document doc;
+    bool okay = doc.parseFromString(xml);
+    REQUIRE(okay);
+    MomentumDistributionInput mdi;
+    mdi.readXML(doc.getRoot());
+    return std::make_unique<MomentumDistribution>(std::move(mdi), pset.getTotalNum(), pset.getTwist(),
+                                                  pset.getLattice(), DataLocality::crowd);
+  };
+
+  // identical walkers
+  std::vector<MCPWalker> walkers;
+  int nwalkers = 3;
+  for (int iw = 0; iw < nwalkers; ++iw)
+    walkers.emplace_back(8);
+
+  std::vector<ParticleSet> psets;
+  for (int iw = 0; iw < nwalkers; ++iw)
+    psets.emplace_back(pset);
+
+  auto& trial_wavefunction = *(wavefunction_pool.getPrimary());
+  std::vector<UPtr<TrialWaveFunction>> wfns(nwalkers);
+  for (int iw = 0; iw < nwalkers; ++iw)
+    wfns[iw] = trial_wavefunction.makeClone(psets[iw]);
+
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    psets[iw].update(true);
+    psets[iw].donePbyP();
+    wfns[iw]->evaluateLog(psets[iw]);
+    psets[iw].saveWalker(walkers[iw]);
+  }
+
+  auto ref_walkers = makeRefVector<MCPWalker>(walkers);
+  auto ref_psets   = makeRefVector<ParticleSet>(psets);
+  auto ref_wfns    = convertUPtrToRefVector(wfns);
+
+  // a single walker draws the same samples in both evaluations
+  auto md_loop    = makeMD(xml_loop);
+  auto md_batched = makeMD(xml_batched);
+  {
+    RandomGenerator rng_loop;
+    RandomGenerator rng_batched;
+    RefVector<MCPWalker> one_walker{ref_walkers[0]};
+    RefVector<ParticleSet> one_pset{ref_psets[0]};
+    RefVector<TrialWaveFunction> one_wfn{ref_wfns[0]};
+    md_loop->accumulate(one_walker, one_pset, one_wfn, rng_loop);
+    md_batched->accumulate(one_walker, one_pset, one_wfn, rng_batched);
+  }
+  std::vector<RealType>& data_loop    = md_loop->get_data();
+  std::vector<RealType>& data_batched = md_batched->get_data();
+  REQUIRE(data_batched.size() == data_loop.size());
+  for (size_t id = 0; id < data_loop.size(); ++id)
+    CHECK(data_batched[id] == Approx(data_loop[id]));
+
+  // the crowd shares the samples, identical walkers contribute identical n(k)
+  auto md_crowd = makeMD(xml_batched);
+  {
+    RandomGenerator rng;
+    md_crowd->accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+  }
+  std::vector<RealType>& data_crowd = md_crowd->get_data();
+  for (size_t id = 0; id < data_loop.size(); ++id)
+    CHECK(data_crowd[id] == Approx(nwalkers * data_loop[id]));
+
+  outputManager.resume();
+}
+
 } // namespace qmcplusplus
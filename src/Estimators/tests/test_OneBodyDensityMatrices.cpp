@@ -173,6 +173,15 @@ public:
       checkData(data.data(), returned_data.data(), data.size());
   }
 
+  void accumulate(OneBodyDensityMatrices& obdm,
+                  RefVector<MCPWalker>& walkers,
+                  RefVector<ParticleSet>& psets,
+                  RefVector<TrialWaveFunction>& twfcs,
+                  StdRandom<T>& rng)
+  {
+    obdm.implAccumulate(walkers, psets, twfcs, rng);
+  }
+
   /** no change test for evaluateMatrix.
    */
   void testEvaluateMatrix(OneBodyDensityMatrices& obdm,
@@ -408,6 +417,115 @@ TEST_CASE("OneBodyDensityMatrices::accumulate", "[estimators]")
   outputManager.resume();
 }
 
+TEST_CASE("OneBodyDensityMatrices::accumulate batched", "[estimators]")
+{
+  using namespace testing;
+  using namespace onebodydensitymatrices;
+  using MCPWalker = OperatorEstBase::MCPWalker;
+
+  Communicate* comm;
+  comm = OHMMS::Controller;
+  outputManager.pause();
+
+  auto particle_pool     = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool = MinimalWaveFunctionPool::make_diamondC_1x1x1(comm, particle_pool);
+  auto& wf_factory       = *(wavefunction_pool.getWaveFunctionFactory("wavefunction"));
+  wavefunction_pool.setPrimary(wavefunction_pool.getWaveFunction("psi0"));
+  auto& pset_target = *(particle_pool.getParticleSet("e"));
+  auto& pset_source = *(particle_pool.getParticleSet("ion"));
+  auto& species_set = pset_target.getSpeciesSet();
+
+  int nwalkers = 2;
+  std::vector<MCPWalker> walkers;
+  for (int iw = 0; iw < nwalkers; ++iw)
+    walkers.emplace_back(8);
+  std::vector<ParticleSet::ParticlePos> deterministic_rs = {{
+                                                                {-0.6759092808, 0.835668385, 1.985307097},
+                                                                {0.09710352868, -0.76751858, -1.89306891},
+                                                                {-0.5605484247, -0.9578875303, 1.476860642},
+                                                                {2.585144997, 1.862680197, 3.282609463},
+                                                                {-0.1961335093, 1.111888766, -0.578481257},
+                                                                {1.794641614, 1.6000278, -0.9474347234},
+                                                                {2.157717228, 0.9254754186, 2.263158321},
+                                                                {1.883366346, 2.136350632, 3.188981533},
+                                                            },
+                                                            {
+                                                                {-0.2079261839, -0.2796236873, 0.5512072444},
+                                                                {-0.2823159397, 0.7537326217, 0.01526880637},
+                                                                {3.533515453, 2.433290243, 0.9281452894},
+                                                                {2.051767349, 2.312927485, 0.7089259624},
+                                                                {-1.043096781, 0.8190526962, -0.1958218962},
+                                                                {0.9210210443, 0.7726522088, 0.3962054551},
+                                                                {2.043324947, 0.3482068777, 3.39059639},
+                                                                {0.9103830457, 2.167978764, 2.341906071},
+                                                            }};
+  std::vector<ParticleSet> psets = generateRandomParticleSets(pset_target, pset_source, deterministic_rs, nwalkers);
+  auto& trial_wavefunction = *(wavefunction_pool.getPrimary());
+  std::vector<UPtr<TrialWaveFunction>> twfcs(nwalkers);
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    twfcs[iw] = trial_wavefunction.makeClone(psets[iw]);
+    psets[iw].update(true);
+    psets[iw].donePbyP();
+    twfcs[iw]->evaluateLog(psets[iw]);
+    psets[iw].saveWalker(walkers[iw]);
+  }
+  walkers[1].Weight = 0.5;
+
+  auto makeOBDM = [&](int valid_input, bool batched) {
+    std::string xml(valid_one_body_density_matrices_input_sections[valid_input]);
+    if (batched)
+      xml.replace(xml.find("matrix"), 6, "batched");
+    Libxml2Document doc;
+    bool okay = doc.parseFromString(xml);
+    if (!okay)
+      throw std::runtime_error("cannot parse OneBodyDensitMatricesInput section");
+    OneBodyDensityMatricesInput obdmi(doc.getRoot());
+    return OneBodyDensityMatrices(std::move(obdmi), pset_target.getLattice(), species_set, wf_factory, pset_target);
+  };
+
+  OneBodyDensityMatricesTests<double> obdmt;
+  for (auto valid_integrator : std::vector<int>{valid_obdm_input, valid_obdm_input_scale})
+  {
+    // with a single walker the batched evaluator draws the same samples as the matrix evaluator
+    OneBodyDensityMatrices obdm_matrix = makeOBDM(valid_integrator, false);
+    OneBodyDensityMatrices obdm_single = makeOBDM(valid_integrator, true);
+    RefVector<MCPWalker> walker0{walkers[0]};
+    RefVector<ParticleSet> pset0{psets[0]};
+    RefVector<TrialWaveFunction> twfc0{*twfcs[0]};
+    StdRandom<double> rng_matrix;
+    rng_matrix.init(101);
+    obdmt.accumulate(obdm_matrix, walker0, pset0, twfc0, rng_matrix);
+    StdRandom<double> rng_single;
+    rng_single.init(101);
+    obdmt.accumulate(obdm_single, walker0, pset0, twfc0, rng_single);
+    obdmt.checkData(obdm_matrix.get_data().data(), obdm_single.get_data().data(), obdm_matrix.get_data().size());
+
+    // the walkers of a crowd share the samples, so the crowd sums the weighted single walker results
+    OneBodyDensityMatrices obdm_crowd = makeOBDM(valid_integrator, true);
+    auto ref_walkers(makeRefVector<MCPWalker>(walkers));
+    auto ref_psets(makeRefVector<ParticleSet>(psets));
+    auto ref_twfcs(convertUPtrToRefVector(twfcs));
+    StdRandom<double> rng_crowd;
+    rng_crowd.init(101);
+    obdmt.accumulate(obdm_crowd, ref_walkers, ref_psets, ref_twfcs, rng_crowd);
+
+    OneBodyDensityMatrices obdm_second = makeOBDM(valid_integrator, true);
+    RefVector<MCPWalker> walker1{walkers[1]};
+    RefVector<ParticleSet> pset1{psets[1]};
+    RefVector<TrialWaveFunction> twfc1{*twfcs[1]};
+    StdRandom<double> rng_second;
+    rng_second.init(101);
+    obdmt.accumulate(obdm_second, walker1, pset1, twfc1, rng_second);
+
+    auto summed = obdm_single.get_data();
+    for (size_t i = 0; i < summed.size(); ++i)
+      summed[i] += obdm_second.get_data()[i];
+    obdmt.checkData(summed.data(), obdm_crowd.get_data().data(), summed.size());
+  }
+  outputManager.resume();
+}
+
 TEST_CASE("OneBodyDensityMatrices::evaluateMatrix", "[estimators]")
 {
   using namespace testing;
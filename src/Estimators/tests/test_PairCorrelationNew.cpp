@@ -0,0 +1,110 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "PairCorrelationNew.h"
+#include "ParticleSet.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "OhmmsData/Libxml2Doc.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("PairCorrelationNew accumulate", "[estimators]")
+{
+  using MCPWalker = OperatorEstBase::MCPWalker;
+  using Real      = PairCorrelationNew::Real;
+
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> lattice;
+  lattice.BoxBConds = true;
+  lattice.R.diagonal(4.0);
+  lattice.reset();
+  const SimulationCell simulation_cell(lattice);
+
+  ParticleSet ions(simulation_cell);
+  ions.setName("ion0");
+  ions.getSpeciesSet().addSpecies("H");
+  ions.create({1});
+  ions.R[0] = {0.0, 0.0, 0.3};
+
+  std::vector<ParticleSet> psets;
+  psets.emplace_back(simulation_cell);
+  ParticleSet& elec = psets.back();
+  elec.setName("e");
+  elec.getSpeciesSet().addSpecies("u");
+  elec.getSpeciesSet().addSpecies("d");
+  elec.create({2, 1});
+  elec.R[0] = {0.0, 0.0, 0.0};
+  elec.R[1] = {1.0, 0.0, 0.0};
+  elec.R[2] = {0.0, 0.6, 0.0};
+  elec.addTable(elec);
+  elec.addTable(ions);
+  elec.update();
+
+  std::vector<MCPWalker> walkers;
+  walkers.emplace_back(3);
+  walkers.back().Weight = 2.0;
+
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(R"XML(<estimator type="PairCorrelation" name="gofr" num_bin="4" sources="ion0"/>)XML"));
+  PairCorrelationNew pcn(doc.getRoot(), elec);
+  // rmax is the Wigner-Seitz radius of the cell
+  CHECK(pcn.getRmax() == Approx(2.0));
+  REQUIRE(pcn.getNumBins() == 4);
+  // uu, ud, dd and the ion species
+  REQUIRE(pcn.get_data().size() == 4 * 4);
+
+  auto crowd_pcn = pcn.spawnCrowdClone();
+  std::vector<TrialWaveFunction> wfns;
+  auto ref_walkers = makeRefVector<MCPWalker>(walkers);
+  auto ref_psets   = makeRefVector<ParticleSet>(psets);
+  auto ref_wfns    = makeRefVector<TrialWaveFunction>(wfns);
+  RandomGenerator rng;
+  crowd_pcn->accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+  CHECK(crowd_pcn->get_walkers_weight() == Approx(2.0));
+
+  // weight * volume / (pairs * shell volume)
+  auto norm = [](Real npairs, int bin) {
+    const Real r = 0.5 * bin;
+    return 2.0 * 64.0 / (npairs * 4. / 3 * M_PI * (std::pow(r + 0.5, 3) - std::pow(r, 3)));
+  };
+  const auto& data = crowd_pcn->get_data();
+  // |u0 - u1| = 1
+  CHECK(data[pcn.getPairOffset(0, 0) + 2] == Approx(norm(1, 2)));
+  // |d - u0| = 0.6, |d - u1| = 1.17
+  CHECK(data[pcn.getPairOffset(1, 0) + 1] == Approx(norm(2, 1)));
+  CHECK(data[pcn.getPairOffset(0, 1) + 2] == Approx(norm(2, 2)));
+  CHECK(data[pcn.getPairOffset(1, 1) + 1] == 0.0);
+  // ion distances 0.3, 1.04, 0.67 are normalized by the total number of electron pairs
+  CHECK(data[pcn.getSourceOffset(0, 0) + 0] == Approx(norm(3, 0)));
+  CHECK(data[pcn.getSourceOffset(0, 0) + 1] == Approx(norm(3, 1)));
+  CHECK(data[pcn.getSourceOffset(0, 0) + 2] == Approx(norm(3, 2)));
+  CHECK(data[pcn.getSourceOffset(0, 0) + 3] == 0.0);
+}
+
+TEST_CASE("PairCorrelationNew bad input", "[estimators]")
+{
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+  elec.setName("e");
+  elec.create({2});
+
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(R"XML(<estimator type="PairCorrelation" name="gofr"/>)XML"));
+  // no distance table
+  CHECK_THROWS_AS(PairCorrelationNew(doc.getRoot(), elec), std::runtime_error);
+  elec.addTable(elec);
+  REQUIRE(doc.parseFromString(R"XML(<estimator type="PairCorrelation" name="gofr" sources="ion0"/>)XML"));
+  CHECK_THROWS_AS(PairCorrelationNew(doc.getRoot(), elec), std::runtime_error);
+}
+
+} // namespace qmcplusplus
@@ -21,6 +21,7 @@
 #include "EstimatorTesting.h"
 
 #include "OhmmsData/Libxml2Doc.h"
+#include "Message/Communicate.h"
 
 #include <stdio.h>
 #include <sstream>
@@ -44,6 +45,37 @@ public:
     CHECK(sdn.species_size_ == sdn2.species_size_);
     CHECK(sdn.data_ != sdn2.data_);
   }
+
+  /// the dense grid data of a sparse SpinDensityNew
+  std::vector<QMCT::RealType> expandSparse(const SpinDensityNew& sdn)
+  {
+    const auto& dp = sdn.derived_parameters_;
+    std::vector<QMCT::RealType> dense(sdn.species_.size() * dp.npoints, 0.0);
+    const int edge = sdn.brick_edge_;
+    for (int slot = 0; slot < sdn.bricks_.size(); ++slot)
+      for (size_t local = 0; local < sdn.brick_size_; ++local)
+      {
+        // unravel the brick id and the point inside the brick, the species is the slowest index
+        int brick        = sdn.bricks_[slot];
+        size_t rest      = local;
+        size_t point     = 0;
+        bool inside_grid = true;
+        for (int d = QMCT::DIM - 1; d >= 0; --d)
+        {
+          const int ig = (brick % sdn.brick_grid_[d]) * edge + rest % edge;
+          brick /= sdn.brick_grid_[d];
+          rest /= edge;
+          inside_grid = inside_grid && ig < dp.grid[d];
+          point += dp.gdims[d] * ig;
+        }
+        const QMCT::RealType value = sdn.data_[slot * sdn.brick_size_ + local];
+        if (inside_grid)
+          dense[rest * dp.npoints + point] += value;
+        else
+          CHECK(value == 0.0);
+      }
+    return dense;
+  }
 };
 } // namespace testing
 
@@ -367,4 +399,58 @@ TEST_CASE("SpinDensityNew algorithm comparison", "[estimators]")
 }
 
 
+TEST_CASE("SpinDensityNew sparse storage", "[estimators]")
+{
+  std::string sparse_xml(testing::valid_spin_density_input_sections[0]);
+  sparse_xml.replace(sparse_xml.find("report=\"yes\""), 12, "report=\"yes\" sparse=\"yes\" brick=\"4\"");
+
+  SpeciesSet species_set;
+  species_set.addSpecies("u");
+  species_set.addSpecies("d");
+  int iattribute             = species_set.addAttribute("membersize");
+  species_set(iattribute, 0) = 1;
+  species_set(iattribute, 1) = 1;
+
+  auto makeSDN = [&species_set](const char* xml) {
+    Libxml2Document doc;
+    bool okay = doc.parseFromString(xml);
+    REQUIRE(okay);
+    SpinDensityInput sdi;
+    sdi.readXML(doc.getRoot());
+    return std::make_unique<SpinDensityNew>(std::move(sdi), species_set);
+  };
+
+  auto sdn_dense  = makeSDN(testing::valid_spin_density_input_sections[0]);
+  auto sdn_sparse = makeSDN(sparse_xml.c_str());
+  // nothing is stored before the first sample
+  CHECK(sdn_sparse->get_data().size() == 0);
+
+  int ncrowds = 3;
+  int nsteps  = 4;
+  for (auto* sdn : {sdn_dense.get(), sdn_sparse.get()})
+  {
+    UPtrVector<OperatorEstBase> crowd_sdns;
+    accumulateFromPsets(ncrowds, *sdn, crowd_sdns);
+    testing::RandomForTest<QMCT::RealType> rng_for_test;
+    for (int i = 0; i < nsteps; ++i)
+      randomUpdateAccumulate(rng_for_test, crowd_sdns);
+    RefVector<OperatorEstBase> crowd_oeb_refs = convertUPtrToRefVector(crowd_sdns);
+    sdn->collect(crowd_oeb_refs);
+    sdn->alignDataForReduction(*OHMMS::Controller);
+  }
+
+  // 10x10x10 grid in 3x3x3 bricks of 4x4x4 points
+  CHECK(sdn_sparse->get_data().size() < sdn_dense->get_data().size());
+  testing::SpinDensityNewTests sdnt;
+  std::vector<QMCT::RealType> expanded = sdnt.expandSparse(*sdn_sparse);
+  std::vector<QMCT::RealType>& data_dense = sdn_dense->get_data();
+  REQUIRE(expanded.size() == data_dense.size());
+  for (size_t i = 0; i < data_dense.size(); ++i)
+    if (expanded[i] != data_dense[i])
+    {
+      FAIL_CHECK("sparse " << expanded[i] << " != dense " << data_dense[i] << " at index " << i);
+      break;
+    }
+}
+
 } // namespace qmcplusplus
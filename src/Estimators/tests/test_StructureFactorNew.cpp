@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <complex>
+#include "StructureFactorNew.h"
+#include "ParticleSet.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "LongRange/KContainer.h"
+#include "OhmmsData/Libxml2Doc.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("StructureFactorNew accumulate", "[estimators]")
+{
+  using MCPWalker = OperatorEstBase::MCPWalker;
+  using Real      = StructureFactorNew::Real;
+
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> lattice;
+  lattice.BoxBConds = true;
+  lattice.R.diagonal(5.0);
+  lattice.reset();
+  lattice.LR_dim_cutoff = 15;
+  const SimulationCell simulation_cell(lattice);
+  const KContainer& k_lists = simulation_cell.getKLists();
+
+  const std::vector<ParticleSet::PosType> walker_positions[2] = {{{0.0, 1.0, 2.0}, {1.0, 0.2, 3.0}},
+                                                                 {{0.3, 4.0, 1.4}, {3.2, 4.7, 0.7}}};
+  const Real weights[2] = {1.0, 0.5};
+
+  std::vector<ParticleSet> psets;
+  std::vector<MCPWalker> walkers;
+  for (int iw = 0; iw < 2; ++iw)
+  {
+    psets.emplace_back(simulation_cell);
+    ParticleSet& pset = psets.back();
+    pset.getSpeciesSet().addSpecies("u");
+    pset.getSpeciesSet().addSpecies("d");
+    pset.create({1, 1});
+    pset.R[0] = walker_positions[iw][0];
+    pset.R[1] = walker_positions[iw][1];
+    pset.createSK();
+    pset.update();
+    walkers.emplace_back(2);
+    walkers.back().Weight = weights[iw];
+  }
+
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(R"XML(<estimator type="StructureFactor" name="sk" rhok="yes"/>)XML"));
+  StructureFactorNew sfn(doc.getRoot(), psets[0]);
+  const int nk = sfn.getNumK();
+  REQUIRE(nk == k_lists.numk);
+  REQUIRE(sfn.get_data().size() == 5 * nk);
+
+  auto crowd_sfn = sfn.spawnCrowdClone();
+  std::vector<TrialWaveFunction> wfns;
+  auto ref_walkers = makeRefVector<MCPWalker>(walkers);
+  auto ref_psets   = makeRefVector<ParticleSet>(psets);
+  auto ref_wfns    = makeRefVector<TrialWaveFunction>(wfns);
+  RandomGenerator rng;
+  crowd_sfn->accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+  CHECK(crowd_sfn->get_walkers_weight() == Approx(1.5));
+
+  const auto& data = crowd_sfn->get_data();
+  for (int k : {0, nk / 2, nk - 1})
+  {
+    Real sk = 0;
+    std::complex<Real> rhok_u;
+    for (int iw = 0; iw < 2; ++iw)
+    {
+      std::complex<Real> rhok_tot;
+      for (int i = 0; i < 2; ++i)
+      {
+        const Real phase = dot(k_lists.kpts_cart[k], walker_positions[iw][i]);
+        const std::complex<Real> eikr(std::cos(phase), std::sin(phase));
+        rhok_tot += eikr;
+        if (i == 0)
+          rhok_u += weights[iw] * eikr;
+      }
+      sk += weights[iw] * std::norm(rhok_tot) / 2;
+    }
+    CHECK(data[k] == Approx(sk));
+    CHECK(data[sfn.getRhokOffset(0) + k] == Approx(rhok_u.real()));
+    CHECK(data[sfn.getRhokOffset(0) + nk + k] == Approx(rhok_u.imag()));
+  }
+}
+
+TEST_CASE("StructureFactorNew bad input", "[estimators]")
+{
+  const SimulationCell simulation_cell;
+  ParticleSet pset(simulation_cell);
+  pset.create(2);
+
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(R"XML(<estimator type="StructureFactor" name="sk"/>)XML"));
+  CHECK_THROWS_AS(StructureFactorNew(doc.getRoot(), pset), std::runtime_error);
+}
+
+} // namespace qmcplusplus
@@ -18,6 +18,8 @@
 
 
 #include <stdio.h>
+#include <limits>
+#include <random>
 #include <sstream>
 
 namespace qmcplusplus
@@ -111,4 +113,43 @@ TEST_CASE("accumulator with weights float", "[estimators]") { test_real_accumula
 
 TEST_CASE("accumulator with weights double", "[estimators]") { test_real_accumulator_weights<double>(); }
 
+TEST_CASE("reblocking accumulator levels", "[estimators]")
+{
+  reblocking_accumulator<double> r;
+  for (int i = 1; i <= 8; ++i)
+    r(i);
+  REQUIRE(r.num_levels() == 4);
+  CHECK(r.count() == Approx(8));
+  CHECK(r.mean() == Approx(4.5));
+  // level 1 holds 1.5 3.5 5.5 7.5
+  CHECK(r.levels[1].count() == Approx(4));
+  CHECK(r.levels[1].mean() == Approx(4.5));
+  CHECK(r.level_error(1) == Approx(std::sqrt(5.0 / 3.0)));
+  CHECK(r.levels[3].mean() == Approx(4.5));
+  CHECK(r.level_error(3) == std::numeric_limits<double>::max());
+  // too few samples for an estimate
+  CHECK(r.error() == std::numeric_limits<double>::max());
+  r.clear();
+  CHECK(r.num_levels() == 0);
+}
+
+TEST_CASE("reblocking accumulator correlated samples", "[estimators]")
+{
+  // every value is repeated 16 times, the blocks of level 4 and above are independent
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  reblocking_accumulator<double> r;
+  for (int i = 0; i < 128; ++i)
+  {
+    const double x = dist(gen);
+    for (int j = 0; j < 16; ++j)
+      r(x);
+  }
+  CHECK(r.count() == Approx(2048));
+  CHECK(r.level_error(4) > 3.0 * r.level_error(0));
+  const double error = r.error(32);
+  CHECK(error >= r.level_error(4));
+  CHECK(error < 1.5 * r.level_error(4));
+}
+
 } // namespace qmcplusplus
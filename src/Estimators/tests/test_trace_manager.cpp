@@ -151,4 +151,70 @@ TEST_CASE("TraceManager check_trace_build", "[estimators]")
   ac4.reset(tm.checkout_complex<4>(name4, P, 11, 12, 13));
 }
 
+TEST_CASE("TraceManager columnar", "[estimators]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(R"XML(<traces format="columnar" chunk="2" compression="1" array="no"/>)XML"));
+
+  TraceManager tm(c);
+  tm.put(doc.getRoot(), true, "trace_columnar");
+  CHECK(tm.columnar_format);
+  CHECK(tm.chunk_rows == 2);
+  CHECK(tm.compression == 1);
+
+  // the request sequence of QMCHamiltonian::initialize_traces on the master and on a clone
+  auto setup_request = [](TraceManager& t) {
+    TraceRequest req;
+    req.contribute_scalar("energy", true);
+    t.request.incorporate(req);
+    t.request.determine_stream_write();
+    t.update_status();
+  };
+  setup_request(tm);
+  std::unique_ptr<TraceManager> clone{tm.makeClone()};
+  setup_request(*clone);
+  auto energy = std::unique_ptr<Array<TraceReal, 1>>{clone->checkout_real<1>("energy")};
+  clone->screen_writes();
+  clone->initialize_traces();
+  REQUIRE(clone->writing_traces);
+
+  std::vector<TraceManager*> clones{clone.get()};
+  tm.startRun(1, clones);
+  clone->startBlock(1);
+  // the first two samples are written as a chunk while the clone runs, the last one at the end of the block
+  for (int step = 0; step < 3; ++step)
+  {
+    (*energy)(0) = -1.0 - step;
+    clone->buffer_sample(step);
+  }
+  tm.write_buffers(clones, 0);
+  tm.stopRun();
+
+  if (c->size() == 1)
+  {
+    hdf_archive f;
+    REQUIRE(f.open("trace_columnar.traces.h5", H5F_ACC_RDONLY));
+    // [sample][width]
+    Matrix<TraceReal> column(3, 1);
+    f.push("real_data");
+    f.push("columns");
+    f.push("scalars");
+    f.read(column, "energy");
+    CHECK(column(0, 0) == Approx(-1.0));
+    CHECK(column(1, 0) == Approx(-2.0));
+    CHECK(column(2, 0) == Approx(-3.0));
+  }
+}
+
+TEST_CASE("TraceManager columnar node aggregation", "[estimators]")
+{
+  Libxml2Document doc;
+  TraceManager tm;
+  REQUIRE(doc.parseFromString(R"XML(<traces format="columnar" aggregate="node"/>)XML"));
+  tm.put(doc.getRoot(), true, "trace_columnar");
+  CHECK(tm.node_aggregation);
+}
+
 } // namespace qmcplusplus
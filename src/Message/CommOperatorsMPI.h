@@ -351,19 +351,14 @@ inline void Communicate::allreduce(PooledData<double>& g)
 template<>
 inline void Communicate::allreduce(qmcplusplus::Matrix<float>& g)
 {
-  std::vector<float> gt(g.size());
-  std::copy(g.begin(), g.end(), gt.begin());
-  MPI_Allreduce(g.data(), &gt[0], g.size(), MPI_FLOAT, MPI_SUM, myMPI);
-  std::copy(gt.begin(), gt.end(), g.data());
+  // in place, the matrices can be as large as the memory allows
+  MPI_Allreduce(MPI_IN_PLACE, g.data(), g.size(), MPI_FLOAT, MPI_SUM, myMPI);
 }
 
 template<>
 inline void Communicate::allreduce(qmcplusplus::Matrix<double>& g)
 {
-  std::vector<double> gt(g.size());
-  copy(g.begin(), g.end(), gt.begin());
-  MPI_Allreduce(g.data(), &gt[0], g.size(), MPI_DOUBLE, MPI_SUM, myMPI);
-  copy(gt.begin(), gt.end(), g.data());
+  MPI_Allreduce(MPI_IN_PLACE, g.data(), g.size(), MPI_DOUBLE, MPI_SUM, myMPI);
 }
 
 template<>
@@ -1015,19 +1010,13 @@ inline void Communicate::gatherv_in_place(T* buf, TMPI& datatype, IT& counts, IT
 template<>
 inline void Communicate::allreduce(qmcplusplus::Matrix<std::complex<double>>& g)
 {
-  std::vector<std::complex<double>> gt(g.size());
-  std::copy(g.begin(), g.end(), gt.begin());
-  MPI_Allreduce(g.data(), &gt[0], 2 * g.size(), MPI_DOUBLE, MPI_SUM, myMPI);
-  std::copy(gt.begin(), gt.end(), g.data());
+  MPI_Allreduce(MPI_IN_PLACE, g.data(), 2 * g.size(), MPI_DOUBLE, MPI_SUM, myMPI);
 }
 
 template<>
 inline void Communicate::allreduce(qmcplusplus::Matrix<std::complex<float>>& g)
 {
-  std::vector<std::complex<float>> gt(g.size());
-  std::copy(g.begin(), g.end(), gt.begin());
-  MPI_Allreduce(g.data(), &gt[0], 2 * g.size(), MPI_FLOAT, MPI_SUM, myMPI);
-  std::copy(gt.begin(), gt.end(), g.data());
+  MPI_Allreduce(MPI_IN_PLACE, g.data(), 2 * g.size(), MPI_FLOAT, MPI_SUM, myMPI);
 }
 
 template<>
@@ -0,0 +1,159 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file CommProfile.cpp
+ * @brief Implements CommProfile
+ */
+#include "CommProfile.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <vector>
+#include "Message/Communicate.h"
+
+namespace qmcplusplus
+{
+CommProfile comm_profile;
+
+void CommProfile::add(const std::string& site, double seconds, size_t bytes)
+{
+  const std::lock_guard<std::mutex> lock(stats_lock_);
+  CommSiteStats& stats = stats_[site];
+  stats.count++;
+  stats.bytes += bytes;
+  stats.time += seconds;
+}
+
+std::map<std::string, CommSiteStats> CommProfile::getStats() const
+{
+  const std::lock_guard<std::mutex> lock(stats_lock_);
+  return stats_;
+}
+
+CommSiteStats CommProfile::getTotal() const
+{
+  const std::lock_guard<std::mutex> lock(stats_lock_);
+  CommSiteStats total;
+  for (const auto& [site, stats] : stats_)
+  {
+    total.count += stats.count;
+    total.bytes += stats.bytes;
+    total.time += stats.time;
+  }
+  return total;
+}
+
+void CommProfile::report(Communicate& comm, std::ostream& os) const
+{
+  const auto stats    = getStats();
+  const int num_ranks = comm.size();
+
+  // the call sites of all the ranks, one per line, each rank sends at least its newline
+  std::string sites("\n");
+  for (const auto& [site, site_stats] : stats)
+    sites += site + '\n';
+#ifdef HAVE_MPI
+  if (num_ranks > 1)
+  {
+    int my_size = sites.size();
+    std::vector<int> sizes(num_ranks), displ(num_ranks, 0);
+    MPI_Allgather(&my_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, comm.getMPI());
+    for (int i = 1; i < num_ranks; i++)
+      displ[i] = displ[i - 1] + sizes[i - 1];
+    std::vector<char> all_sites(displ.back() + sizes.back());
+    MPI_Gatherv(sites.data(), my_size, MPI_CHAR, all_sites.data(), sizes.data(), displ.data(), MPI_CHAR, 0,
+                comm.getMPI());
+    if (comm.rank() == 0)
+      sites.assign(all_sites.begin(), all_sites.end());
+    int all_size = sites.size();
+    MPI_Bcast(&all_size, 1, MPI_INT, 0, comm.getMPI());
+    sites.resize(all_size);
+    MPI_Bcast(sites.data(), all_size, MPI_CHAR, 0, comm.getMPI());
+  }
+#endif
+  std::set<std::string> site_set;
+  std::istringstream site_lines(sites);
+  for (std::string site; std::getline(site_lines, site);)
+    if (!site.empty())
+      site_set.insert(site);
+  const std::vector<std::string> names(site_set.begin(), site_set.end());
+
+  if (names.empty())
+  {
+    if (comm.rank() == 0)
+      os << "No MPI operation was profiled." << std::endl;
+    return;
+  }
+
+  // time, calls and bytes of every call site on this rank, then gathered rank after rank
+  const int num_values = 3 * names.size();
+  std::vector<double> values(num_values, 0.0);
+  for (int i = 0; i < names.size(); i++)
+    if (auto it = stats.find(names[i]); it != stats.end())
+    {
+      values[3 * i]     = it->second.time;
+      values[3 * i + 1] = it->second.count;
+      values[3 * i + 2] = it->second.bytes;
+    }
+  std::vector<double> all_values(values);
+#ifdef HAVE_MPI
+  if (num_ranks > 1)
+  {
+    all_values.resize(num_ranks * num_values);
+    MPI_Gather(values.data(), num_values, MPI_DOUBLE, all_values.data(), num_values, MPI_DOUBLE, 0, comm.getMPI());
+  }
+#endif
+
+  if (comm.rank() != 0)
+    return;
+
+  const int name_width = std::max_element(names.begin(), names.end(), [](const auto& a, const auto& b) {
+                           return a.size() < b.size();
+                         })->size() + 2;
+  os << "MPI operations per call site over " << num_ranks << " ranks, time in seconds" << std::endl;
+  os << std::setw(name_width) << std::left << "Call site" << std::right << std::setw(12) << "min" << std::setw(12)
+     << "median" << std::setw(12) << "p90" << std::setw(12) << "max" << std::setw(14) << "calls/rank" << std::setw(16)
+     << "MB/rank" << std::endl;
+  std::vector<double> times(num_ranks);
+  for (int i = 0; i < names.size(); i++)
+  {
+    double calls = 0.0, bytes = 0.0;
+    for (int rank = 0; rank < num_ranks; rank++)
+    {
+      times[rank] = all_values[rank * num_values + 3 * i];
+      calls += all_values[rank * num_values + 3 * i + 1];
+      bytes += all_values[rank * num_values + 3 * i + 2];
+    }
+    std::sort(times.begin(), times.end());
+    os << std::setw(name_width) << std::left << names[i] << std::right << std::fixed << std::setprecision(4)
+       << std::setw(12) << times.front() << std::setw(12) << percentile(times, 0.5) << std::setw(12)
+       << percentile(times, 0.9) << std::setw(12) << times.back() << std::setprecision(1) << std::setw(14)
+       << calls / num_ranks << std::setprecision(3) << std::setw(16) << bytes / num_ranks / (1 << 20)
+       << std::defaultfloat << std::endl;
+  }
+}
+
+double CommProfile::percentile(const std::vector<double>& sorted, double q)
+{
+  const int index = static_cast<int>(std::ceil(q * sorted.size())) - 1;
+  return sorted[std::min(std::max(index, 0), static_cast<int>(sorted.size()) - 1)];
+}
+
+void CommProfile::reset()
+{
+  const std::lock_guard<std::mutex> lock(stats_lock_);
+  stats_.clear();
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file CommProfile.h
+ * @brief Count, bytes and time of the MPI operations of each call site
+ */
+#ifndef QMCPLUSPLUS_COMM_PROFILE_H
+#define QMCPLUSPLUS_COMM_PROFILE_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Communicate;
+
+namespace qmcplusplus
+{
+/// MPI operations of a call site
+struct CommSiteStats
+{
+  long count = 0;
+  /// bytes sent or received
+  size_t bytes = 0;
+  /// time in the operations, including the wait for the other ranks
+  double time = 0.0;
+};
+
+/** accumulator of the MPI operations of the call sites, e.g. "WalkerControl::allreduce"
+ *
+ * The call sites time their operations with ScopedCommProfile. For the nonblocking operations
+ * the time is the one of the waits, under their own site. The threads may add concurrently, so the adds lock.
+ * Nothing is measured unless enabled.
+ */
+class CommProfile
+{
+public:
+  void enable(bool enabled) { enabled_ = enabled; }
+  inline bool isEnabled() const { return enabled_; }
+
+  /// add an operation of a call site
+  void add(const std::string& site, double seconds, size_t bytes);
+
+  /// a copy of the stats per call site
+  std::map<std::string, CommSiteStats> getStats() const;
+  /// the stats summed over the call sites
+  CommSiteStats getTotal() const;
+
+  /** print the time, calls and bytes of each call site over the ranks of comm
+   * Collective over comm. The time is given as its minimum, median, 90th percentile and maximum over the ranks,
+   * the calls and bytes as averages per rank. Only rank 0 prints.
+   */
+  void report(Communicate& comm, std::ostream& os) const;
+
+  void reset();
+
+  /// nearest rank percentile q in [0,1] of sorted values
+  static double percentile(const std::vector<double>& sorted, double q);
+
+private:
+  bool enabled_ = false;
+  mutable std::mutex stats_lock_;
+  std::map<std::string, CommSiteStats> stats_;
+};
+
+extern CommProfile comm_profile;
+
+/// times the MPI operations in its scope and adds them to comm_profile under a call site
+class ScopedCommProfile
+{
+public:
+  /** start timing
+   * @param site call site, must outlive this object
+   * @param bytes bytes sent or received in the scope
+   */
+  ScopedCommProfile(const char* site, size_t bytes = 0)
+      : site_(comm_profile.isEnabled() ? site : nullptr), bytes_(bytes)
+  {
+    if (site_)
+      start_ = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedCommProfile()
+  {
+    if (site_)
+      comm_profile.add(site_, std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count(),
+                       bytes_);
+  }
+
+  ScopedCommProfile(const ScopedCommProfile&) = delete;
+  ScopedCommProfile& operator=(const ScopedCommProfile&) = delete;
+
+private:
+  const char* const site_;
+  const size_t bytes_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace qmcplusplus
+#endif
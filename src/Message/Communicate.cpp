@@ -25,6 +25,7 @@
 #include "config.h"
 #include "Platforms/Host/sysutil.h"
 #include "Utilities/FairDivide.h"
+#include "CommProfile.h"
 
 #ifdef HAVE_MPI
 #include "mpi3/shared_communicator.hpp"
@@ -127,7 +128,11 @@ void Communicate::cleanupMessage(void*) {}
 
 void Communicate::abort() const { comm.abort(1); }
 
-void Communicate::barrier() const { comm.barrier(); }
+void Communicate::barrier() const
+{
+  ScopedCommProfile profile("Communicate::barrier");
+  comm.barrier();
+}
 #else
 
 void Communicate::initialize(int argc, char** argv) { std::string when = "qmc." + getDateAndTime("%Y%m%d_%H%M"); }
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_NODE_SHARED_ARRAY_H
+#define QMCPLUSPLUS_NODE_SHARED_ARRAY_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "Message/Communicate.h"
+
+namespace qmcplusplus
+{
+/** read-only array stored once per node
+ *
+ *  With MPI, the array is an MPI-3 shared memory window allocated by the first rank of each node
+ *  and mapped by the other ranks of the node. Only the writer, the first rank of the node, fills it.
+ *  The other ranks may read it after fence() or bcast() returned. Without MPI, it is a plain allocation.
+ */
+template<typename T>
+class NodeSharedArray
+{
+public:
+  /** allocate the array on every node of comm, collective over comm
+   * @param comm communicator of all the ranks holding the array
+   * @param n number of elements
+   */
+  NodeSharedArray(const Communicate& comm, size_t n) : size_(n), data_(nullptr)
+  {
+    node_comm_.initializeAsNodeComm(comm);
+#ifdef HAVE_MPI
+    const MPI_Aint bytes = node_comm_.rank() == 0 ? n * sizeof(T) : 0;
+    void* base           = nullptr;
+    MPI_Win_allocate_shared(bytes, sizeof(T), MPI_INFO_NULL, node_comm_.getMPI(), &base, &window_);
+    MPI_Aint segment_size;
+    int disp_unit;
+    MPI_Win_shared_query(window_, 0, &segment_size, &disp_unit, &base);
+    data_ = static_cast<T*>(base);
+    // the writers of all the nodes, the first rank of comm is the first writer
+    MPI_Comm_split(comm.getMPI(), isWriter() ? 0 : MPI_UNDEFINED, comm.rank(), &writer_comm_);
+    MPI_Win_fence(0, window_);
+#else
+    storage_.resize(n);
+    data_ = storage_.data();
+#endif
+  }
+
+  NodeSharedArray(const NodeSharedArray&) = delete;
+  NodeSharedArray& operator=(const NodeSharedArray&) = delete;
+
+  ~NodeSharedArray()
+  {
+#ifdef HAVE_MPI
+    if (writer_comm_ != MPI_COMM_NULL)
+      MPI_Comm_free(&writer_comm_);
+    MPI_Win_free(&window_);
+#endif
+  }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  /// true if this rank fills the array of its node
+  bool isWriter() const { return node_comm_.rank() == 0; }
+
+  /// make the content written by the writer visible to the ranks of the node, collective over comm
+  void fence()
+  {
+#ifdef HAVE_MPI
+    MPI_Win_fence(0, window_);
+#endif
+  }
+
+  /// copy the content written by the first rank of comm to all the nodes then fence, collective over comm
+  void bcast()
+  {
+#ifdef HAVE_MPI
+    if (writer_comm_ != MPI_COMM_NULL)
+    {
+      // some MPI libraries fail with messages exceeding the range of int
+      const size_t chunk_size = std::numeric_limits<int>::max() / 2;
+      char* buffer            = reinterpret_cast<char*>(data_);
+      const size_t bytes      = size_ * sizeof(T);
+      for (size_t offset = 0; offset < bytes; offset += chunk_size)
+        MPI_Bcast(buffer + offset, static_cast<int>(std::min(chunk_size, bytes - offset)), MPI_CHAR, 0, writer_comm_);
+    }
+#endif
+    fence();
+  }
+
+private:
+  /// number of elements
+  const size_t size_;
+  /// the array, in the window of the writer of the node with MPI
+  T* data_;
+  /// ranks of the node
+  Communicate node_comm_;
+#ifdef HAVE_MPI
+  MPI_Win window_;
+  /// writers of all the nodes, MPI_COMM_NULL on the other ranks
+  MPI_Comm writer_comm_;
+#else
+  std::vector<T> storage_;
+#endif
+};
+
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+#include <sstream>
+#include "Message/Communicate.h"
+#include "Message/CommProfile.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("test_comm_profile", "[message]")
+{
+  Communicate* c = OHMMS::Controller;
+  comm_profile.reset();
+
+  // nothing is measured unless enabled
+  {
+    ScopedCommProfile profile("test::disabled", 8);
+  }
+  CHECK(comm_profile.getStats().empty());
+
+  comm_profile.enable(true);
+  {
+    ScopedCommProfile profile("test::send", 16);
+  }
+  {
+    ScopedCommProfile profile("test::send", 32);
+  }
+  comm_profile.enable(false);
+
+  auto stats = comm_profile.getStats();
+  REQUIRE(stats.size() == 1);
+  CHECK(stats["test::send"].count == 2);
+  CHECK(stats["test::send"].bytes == 48);
+  CHECK(stats["test::send"].time >= 0.0);
+
+  comm_profile.add("test::recv", 0.5, 16);
+  auto total = comm_profile.getTotal();
+  CHECK(total.count == 3);
+  CHECK(total.bytes == 64);
+  CHECK(total.time >= 0.5);
+
+  std::ostringstream report;
+  comm_profile.report(*c, report);
+  if (c->rank() == 0)
+  {
+    CHECK(report.str().find("test::send") != std::string::npos);
+    CHECK(report.str().find("test::recv") != std::string::npos);
+  }
+
+  comm_profile.reset();
+  CHECK(comm_profile.getStats().empty());
+}
+
+} // namespace qmcplusplus
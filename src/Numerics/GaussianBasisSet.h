@@ -107,6 +107,24 @@ struct GaussianCombo
    */
   inline int size() const { return gset.size(); }
 
+  /** return the radius beyond which |f(r)| < tolerance
+   *
+   * Each of the n primitives is bounded by tolerance/n, which is reached at
+   * \f$ r_i = \sqrt{\ln(n|C_i|/tolerance)/\sigma_i} \f$.
+   */
+  inline real_type cutoffRadius(real_type tolerance) const
+  {
+    const real_type n = gset.size();
+    real_type rcut    = 0;
+    for (const BasicGaussian& g : gset)
+    {
+      const real_type ratio = n * std::abs(g.Coeff) / tolerance;
+      if (ratio > 1)
+        rcut = std::max(rcut, std::sqrt(std::log(ratio) / g.Sigma));
+    }
+    return rcut;
+  }
+
   inline real_type f(real_type r)
   {
     real_type res = 0;
@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_ONEDIMCUBICSPLINE_LINEARGRID_H
+#define QMCPLUSPLUS_ONEDIMCUBICSPLINE_LINEARGRID_H
+
+#include <algorithm>
+#include <stdexcept>
+#include "OneDimCubicSpline.h"
+
+namespace qmcplusplus
+{
+/** A copy of OneDimCubicSpline on a LinearGrid for fast evaluation.
+ *
+ * The grid index is computed directly from the uniform spacing instead of calling the virtual grid locate
+ * and the evaluation is not virtual. The extrapolation below r_min and the constant value beyond r_max
+ * are identical to OneDimCubicSpline::splint.
+ */
+template<typename T>
+class OneDimCubicSplineLinearGrid
+{
+public:
+  OneDimCubicSplineLinearGrid(const OneDimCubicSpline<T>& cubic_spline)
+  {
+    const auto& grid = cubic_spline.grid();
+    if (grid.getGridTag() != LINEAR_1DGRID)
+      throw std::runtime_error("OneDimCubicSplineLinearGrid expects a cubic spline on a LinearGrid!");
+
+    r_min_       = cubic_spline.r_min;
+    r_max_       = cubic_spline.r_max;
+    first_deriv_ = cubic_spline.first_deriv;
+    const_value_ = cubic_spline.ConstValue;
+    x0_          = grid.rmin();
+    delta_inv_   = grid.DeltaInv;
+    const int n  = grid.size();
+    X_.resize(n);
+    m_Y_.resize(n);
+    m_Y2_.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+      X_[i]    = grid.r(i);
+      m_Y_[i]  = cubic_spline.m_Y[i];
+      m_Y2_[i] = cubic_spline.m_Y2[i];
+    }
+  }
+
+  /// same as OneDimCubicSpline::splint(r)
+  inline T splint(T r) const
+  {
+    if (r < r_min_)
+      return m_Y_[0] + first_deriv_ * (r - r_min_);
+    else if (r >= r_max_)
+      return const_value_;
+
+    const int loc = getIndex(r);
+    CubicSplineEvaluator<T> eval(r - X_[loc], X_[loc + 1] - X_[loc]);
+    return eval.cubicInterpolate(m_Y_[loc], m_Y_[loc + 1], m_Y2_[loc], m_Y2_[loc + 1]);
+  }
+
+  /// same as OneDimCubicSpline::splint(r, du, d2u)
+  inline T splint(T r, T& du, T& d2u) const
+  {
+    if (r < r_min_)
+    {
+      du  = first_deriv_;
+      d2u = 0.0;
+      return m_Y_[0] + first_deriv_ * (r - r_min_);
+    }
+    else if (r >= r_max_)
+    {
+      du  = 0.0;
+      d2u = 0.0;
+      return const_value_;
+    }
+
+    const int loc = getIndex(r);
+    CubicSplineEvaluator<T> eval(r - X_[loc], X_[loc + 1] - X_[loc]);
+    return eval.cubicInterpolateSecondDeriv(m_Y_[loc], m_Y_[loc + 1], m_Y2_[loc], m_Y2_[loc + 1], du, d2u);
+  }
+
+  /** evaluate the values at n radii
+   * @param n number of radii
+   * @param r radii
+   * @param u values, u[i] = splint(r[i])
+   *
+   * The radii are clamped into the splined region so that every point runs the same interpolation,
+   * the out of range values are selected afterwards.
+   */
+  inline void splint(int n, const T* restrict r, T* restrict u) const
+  {
+    const T* restrict x  = X_.data();
+    const T* restrict y  = m_Y_.data();
+    const T* restrict y2 = m_Y2_.data();
+    const int loc_max    = static_cast<int>(X_.size()) - 2;
+    // the last interval of the spline may end before the grid does
+    const T r_top = std::min(r_max_, X_.back());
+#pragma omp simd
+    for (int i = 0; i < n; i++)
+    {
+      const T rc    = std::min(std::max(r[i], r_min_), r_top);
+      const int loc = std::min(getIndex(rc), loc_max);
+      CubicSplineEvaluator<T> eval(rc - x[loc], x[loc + 1] - x[loc]);
+      const T v    = eval.cubicInterpolate(y[loc], y[loc + 1], y2[loc], y2[loc + 1]);
+      const T vlow = y[0] + first_deriv_ * (r[i] - r_min_);
+      u[i]         = r[i] < r_min_ ? vlow : (r[i] >= r_max_ ? const_value_ : v);
+    }
+  }
+
+  inline T get_r_min() const { return r_min_; }
+  inline T get_r_max() const { return r_max_; }
+
+private:
+  /// same as LinearGrid::locate
+  inline int getIndex(T r) const { return static_cast<int>((static_cast<double>(r) - x0_) * delta_inv_); }
+
+  T r_min_;
+  T r_max_;
+  T first_deriv_;
+  T const_value_;
+  /// the first grid point and the inverse spacing of the linear grid
+  T x0_;
+  double delta_inv_;
+  /// grid points, values and second derivatives
+  std::vector<T> X_, m_Y_, m_Y2_;
+};
+
+} // namespace qmcplusplus
+#endif
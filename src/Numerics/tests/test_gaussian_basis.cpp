@@ -90,6 +90,13 @@ TEST_CASE("Gaussian Combo", "[numerics]")
   REQUIRE(gc.dY == Approx(-0.661028435778766));
   REQUIRE(gc.d2Y == Approx(0.643259180749128));
   REQUIRE(gc.d3Y == Approx(-0.896186412781167));
+
+  // the most diffuse primitive sets the cutoff radius
+  const real_type tolerance = 1e-6;
+  const real_type rcut      = gc.cutoffRadius(tolerance);
+  CHECK(rcut == Approx(std::sqrt(std::log(3 * std::abs(gc.gset[2].Coeff) / tolerance) / gc.gset[2].Sigma)));
+  CHECK(std::abs(gc.f(rcut)) < tolerance);
+  CHECK(std::abs(gc.f(0.9 * rcut)) > std::abs(gc.f(rcut)));
 }
 
 TEST_CASE("Gaussian Combo P", "[numerics]")
@@ -11,6 +11,7 @@
 
 #include "catch.hpp"
 #include "Numerics/OneDimCubicSpline.h"
+#include "Numerics/OneDimCubicSplineLinearGrid.h"
 
 #include <stdio.h>
 #include <string>
@@ -174,4 +175,46 @@ TEST_CASE("one_dim_cubic_spline_1", "[numerics]")
   REQUIRE(check_yvals_d2u[5].d2u == Approx(10.25));
 }
 
+TEST_CASE("one_dim_cubic_spline_linear_grid", "[numerics]")
+{
+  const int n = 11;
+  std::vector<double> yvals(n);
+  for (int i = 0; i < n; i++)
+    yvals[i] = std::sin(0.3 * i) + 0.1 * i;
+
+  auto grid = std::make_unique<LinearGrid<double>>();
+  grid->set(0.5, 3.0, n);
+
+  OneDimCubicSpline<double> cubic_spline(std::move(grid), yvals);
+  // a spline ending before the grid does
+  cubic_spline.spline(0, 0.7, n - 3, 0.0);
+
+  OneDimCubicSplineLinearGrid<double> linear_spline(cubic_spline);
+
+  // below r_min, inside, on the grid points and beyond r_max
+  std::vector<double> rvals = {0.1, 0.5, 0.61, 1.0, 1.25, 1.9, 2.37, 2.5, 2.75, 3.2};
+  std::vector<double> batched(rvals.size());
+  linear_spline.splint(rvals.size(), rvals.data(), batched.data());
+
+  for (int i = 0; i < rvals.size(); i++)
+  {
+    const double r = rvals[i];
+    CHECK(linear_spline.splint(r) == Approx(cubic_spline.splint(r)));
+    CHECK(batched[i] == Approx(cubic_spline.splint(r)));
+
+    double du, d2u, du_ref, d2u_ref;
+    double val     = linear_spline.splint(r, du, d2u);
+    double val_ref = cubic_spline.splint(r, du_ref, d2u_ref);
+    CHECK(val == Approx(val_ref));
+    CHECK(du == Approx(du_ref));
+    CHECK(d2u == Approx(d2u_ref));
+  }
+
+  auto log_grid = std::make_unique<LogGrid<double>>();
+  log_grid->set(0.01, 3.0, n);
+  OneDimCubicSpline<double> log_spline(std::move(log_grid), yvals);
+  log_spline.spline();
+  CHECK_THROWS_AS(OneDimCubicSplineLinearGrid<double>(log_spline), std::runtime_error);
+}
+
 } // namespace qmcplusplus
@@ -19,6 +19,7 @@
 
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 using std::string;
 
@@ -184,6 +185,29 @@ TEST_CASE("SoA Cartesian Tensor evaluateVGL subset", "[numerics]")
   REQUIRE(lap[83] == Approx(128.367962683));
 }
 
+TEST_CASE("SoA Cartesian Tensor evaluateVGL_packed", "[numerics]")
+{
+  for (int lmax : {2, 6})
+  {
+    SoaCartesianTensor<double> ct(lmax);
+    std::vector<double> packed(ct.getNumPackedConstants());
+    ct.packConstants(packed.data());
+
+    double x = 1.3;
+    double y = 1.2;
+    double z = -0.5;
+    ct.evaluateVGL(x, y, z);
+
+    const size_t ntot = ct.size();
+    std::vector<double> vgl(5 * ntot, -1.0);
+    SoaCartesianTensor<double>::evaluateVGL_packed(lmax, packed.data(), x, y, z, vgl.data(), vgl.data() + ntot,
+                                                   vgl.data() + 2 * ntot, vgl.data() + 3 * ntot, vgl.data() + 4 * ntot);
+    for (int icomp = 0; icomp < 5; icomp++)
+      for (size_t i = 0; i < ntot; i++)
+        CHECK(vgl[icomp * ntot + i] == Approx(ct.cXYZ.data(icomp)[i]));
+  }
+}
+
 TEST_CASE("SoA Cartesian Tensor evaluateVGH subset", "[numerics]")
 {
   SoaCartesianTensor<double> ct(6);
@@ -0,0 +1,225 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_CELLLIST_H
+#define QMCPLUSPLUS_CELLLIST_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "OhmmsPETE/TinyVector.h"
+
+namespace qmcplusplus
+{
+/** @ingroup nnlist
+ * @brief linked-cell binning of a static set of particles for cutoff-limited neighbor search
+ *
+ * Particles are sorted into a regular grid of cells whose widths are no smaller than the cutoff radius.
+ * Any particle within the cutoff radius of a query point then resides in the cell of the query point
+ * or one of its nearest neighbor cells.
+ * Periodic directions are binned in reduced coordinates of the lattice so that any cell shape is supported.
+ * With open boundary conditions in all the directions, the bounding box of the particles is binned in Cartesian coordinates.
+ * The lists of particles in each cell are stored contiguously in compressed (CSR) form.
+ */
+template<typename T, unsigned D>
+class CellList
+{
+public:
+  using PosType = TinyVector<T, D>;
+
+  CellList() : rcut_(0), num_cells_total_(0), all_open_(true) {}
+
+  /** bin particles
+   * @param lattice the simulation cell
+   * @param rcut cutoff radius
+   * @param pos particle positions providing operator[] and size()
+   */
+  template<typename LAT, typename POS>
+  void build(const LAT& lattice, T rcut, const POS& pos)
+  {
+    rcut_     = rcut;
+    all_open_ = true;
+    for (int idim = 0; idim < D; idim++)
+      if (lattice.BoxBConds[idim])
+        all_open_ = false;
+
+    const size_t num_ptcls = pos.size();
+    for (int idim = 0; idim < D; idim++)
+    {
+      periodic_[idim] = lattice.BoxBConds[idim];
+      for (int jdim = 0; jdim < D; jdim++)
+        Gv_[idim][jdim] = lattice.Gv[idim][jdim];
+    }
+
+    if (all_open_)
+    {
+      // bounding box of the particles
+      lower_ = std::numeric_limits<T>::max();
+      PosType upper(std::numeric_limits<T>::lowest());
+      for (size_t iat = 0; iat < num_ptcls; iat++)
+        for (int idim = 0; idim < D; idim++)
+        {
+          lower_[idim] = std::min(lower_[idim], static_cast<T>(pos[iat][idim]));
+          upper[idim]  = std::max(upper[idim], static_cast<T>(pos[iat][idim]));
+        }
+      for (int idim = 0; idim < D; idim++)
+      {
+        const T extent   = num_ptcls > 0 ? upper[idim] - lower_[idim] : T(0);
+        num_cells_[idim] = std::max(1, static_cast<int>(std::floor(extent / rcut_)));
+        // avoid a very sparse grid for spread out systems
+        num_cells_[idim] = std::min(num_cells_[idim], std::max(1, static_cast<int>(num_ptcls)));
+        inv_width_[idim] = extent > 0 ? num_cells_[idim] / extent : T(0);
+      }
+    }
+    else
+    {
+      // the distance between lattice planes along a_i is 1/|b_i|
+      for (int idim = 0; idim < D; idim++)
+      {
+        const T plane_distance = T(1) / std::sqrt(dot(Gv_[idim], Gv_[idim]));
+        num_cells_[idim] = periodic_[idim] ? std::max(1, static_cast<int>(std::floor(plane_distance / rcut_))) : 1;
+        inv_width_[idim] = num_cells_[idim];
+      }
+    }
+
+    num_cells_total_ = 1;
+    for (int idim = 0; idim < D; idim++)
+      num_cells_total_ *= num_cells_[idim];
+
+    // counting sort of particles by cells
+    std::vector<int> cell_of_ptcl(num_ptcls);
+    cell_start_.assign(num_cells_total_ + 1, 0);
+    for (size_t iat = 0; iat < num_ptcls; iat++)
+    {
+      cell_of_ptcl[iat] = flatIndex(getCellIndex(pos[iat]));
+      cell_start_[cell_of_ptcl[iat] + 1]++;
+    }
+    for (int icell = 0; icell < num_cells_total_; icell++)
+      cell_start_[icell + 1] += cell_start_[icell];
+    cell_members_.resize(num_ptcls);
+    std::vector<int> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t iat = 0; iat < num_ptcls; iat++)
+      cell_members_[fill[cell_of_ptcl[iat]]++] = iat;
+  }
+
+  /** collect the candidate particles which may reside within the cutoff radius of a point
+   * @param r query position
+   * @param candidates output particle IDs, not ordered. A superset of the particles within the cutoff radius.
+   */
+  template<typename T1>
+  void getCandidates(const TinyVector<T1, D>& r, std::vector<int>& candidates) const
+  {
+    candidates.clear();
+    if (num_cells_total_ == 0)
+      return;
+
+    const TinyVector<int, D> center = getCellIndex(r);
+    TinyVector<int, D> first, last;
+    for (int idim = 0; idim < D; idim++)
+      if (!all_open_ && num_cells_[idim] <= 3)
+      {
+        // all the cells along this direction are neighbors
+        first[idim] = 0;
+        last[idim]  = num_cells_[idim] - 1;
+      }
+      else if (all_open_)
+      {
+        first[idim] = std::max(0, center[idim] - 1);
+        last[idim]  = std::min(num_cells_[idim] - 1, center[idim] + 1);
+      }
+      else
+      {
+        first[idim] = center[idim] - 1;
+        last[idim]  = center[idim] + 1;
+      }
+
+    TinyVector<int, D> cell(first);
+    while (true)
+    {
+      TinyVector<int, D> wrapped;
+      for (int idim = 0; idim < D; idim++)
+        wrapped[idim] = (cell[idim] + num_cells_[idim]) % num_cells_[idim];
+      const int icell = flatIndex(wrapped);
+      candidates.insert(candidates.end(), cell_members_.begin() + cell_start_[icell],
+                        cell_members_.begin() + cell_start_[icell + 1]);
+      // advance the multi-dimensional cell counter
+      int idim = D - 1;
+      while (idim >= 0 && cell[idim] == last[idim])
+      {
+        cell[idim] = first[idim];
+        idim--;
+      }
+      if (idim < 0)
+        break;
+      cell[idim]++;
+    }
+  }
+
+  /// cutoff radius used for binning
+  T getCutoff() const { return rcut_; }
+  /// number of cells in each direction
+  const TinyVector<int, D>& getNumCells() const { return num_cells_; }
+
+private:
+  /// cutoff radius
+  T rcut_;
+  /// number of cells in each direction
+  TinyVector<int, D> num_cells_;
+  /// total number of cells
+  int num_cells_total_;
+  /// open boundary conditions in all the directions
+  bool all_open_;
+  /// periodicity of each direction
+  TinyVector<bool, D> periodic_;
+  /// reciprocal lattice vectors without 2pi, u_i = dot(r, Gv_[i])
+  TinyVector<PosType, D> Gv_;
+  /// lower corner of the bounding box, open boundary conditions only
+  PosType lower_;
+  /// inverse cell width in reduced or Cartesian coordinates
+  PosType inv_width_;
+  /// offset of the first particle of each cell in cell_members_, size num_cells_total_ + 1
+  std::vector<int> cell_start_;
+  /// particle IDs sorted by cells
+  std::vector<int> cell_members_;
+
+  template<typename T1>
+  inline TinyVector<int, D> getCellIndex(const TinyVector<T1, D>& r) const
+  {
+    TinyVector<int, D> index;
+    for (int idim = 0; idim < D; idim++)
+      if (all_open_)
+        index[idim] = std::min(num_cells_[idim] - 1,
+                               std::max(0, static_cast<int>(std::floor((r[idim] - lower_[idim]) * inv_width_[idim]))));
+      else
+      {
+        T u = 0;
+        for (int jdim = 0; jdim < D; jdim++)
+          u += r[jdim] * Gv_[idim][jdim];
+        if (periodic_[idim])
+          u -= std::floor(u);
+        index[idim] = std::min(num_cells_[idim] - 1, std::max(0, static_cast<int>(std::floor(u * inv_width_[idim]))));
+      }
+    return index;
+  }
+
+  inline int flatIndex(const TinyVector<int, D>& index) const
+  {
+    int icell = index[0];
+    for (int idim = 1; idim < D; idim++)
+      icell = icell * num_cells_[idim] + index[idim];
+    return icell;
+  }
+};
+
+} // namespace qmcplusplus
+#endif
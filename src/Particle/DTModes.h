@@ -34,7 +34,15 @@ enum class DTModes : uint_fast8_t
   /** skip data transfer back to host after mw_evalaute full distance table.
    * this optimization can be used for distance table consumed directly on the device without copying back to the host.
    */
-  MW_EVALUATE_RESULT_NO_TRANSFER_TO_HOST = 0x4
+  MW_EVALUATE_RESULT_NO_TRANSFER_TO_HOST = 0x4,
+  /** compute the rows of a full AA table on demand.
+   * evaluate() only marks all the rows stale and a stale row is recomputed when it is read via getDistRow/getDisplRow.
+   * This saves computing the whole triangle when consumers only read a subset of rows or read the table rarely,
+   * for example static particle sets whose energy is precomputed once while they are updated more often.
+   * It is transparent to consumers and thus any consumer may request it. Only supported by SoaDistanceTableAA,
+   * other tables ignore it. Reading a stale row refreshes it and thus must not race with other reads of the same row.
+   */
+  LAZY_FULL_TABLE = 0x8
 };
 
 constexpr bool operator&(DTModes x, DTModes y)
@@ -232,14 +232,15 @@ protected:
    *            When the storage of the table is allocated as a single memory segment,
    *            out-of-bound access is still within the segment and
    *            thus doesn't trigger an alarm by the address sanitizer.
+   *  mutable because stale rows are refreshed by const accessors. See DTModes::LAZY_FULL_TABLE.
    */
-  std::vector<DistRow> distances_;
+  mutable std::vector<DistRow> distances_;
 
   /** displacements_[num_targets_][3][num_sources_], [i][3][j] = r_A2[j] - r_A1[i]
    *  Note: Derived classes decide if it is a memory view or the actual storage
    *        only the lower triangle (j<i) is defined. See the note of distances_.
    */
-  std::vector<DisplRow> displacements_;
+  mutable std::vector<DisplRow> displacements_;
 
   /// temp_r
   DistRow temp_r_;
@@ -253,25 +254,77 @@ protected:
   /// old displacements
   DisplRow old_dr_;
 
+  /** row_stale_[i] is non-zero if the i-th row needs to be recomputed before being read.
+   *  Empty unless the table is evaluated lazily. See DTModes::LAZY_FULL_TABLE.
+   *  char instead of bool to allow reading distinct rows from different threads.
+   */
+  mutable std::vector<char> row_stale_;
+
+  /** recompute a stale row from the current positions of the target particle set
+   *  Only needed by derived classes supporting DTModes::LAZY_FULL_TABLE.
+   */
+  virtual void evaluateRow(int iel) const
+  {
+    throw std::runtime_error(name_ + " lazy evaluation of full table rows not supported");
+  }
+
+  /// bring a row up-to-date if it is stale
+  inline void refreshRow(int iel) const
+  {
+    if (!row_stale_.empty() && row_stale_[iel])
+    {
+      evaluateRow(iel);
+      row_stale_[iel] = 0;
+    }
+  }
+
+  /// bring all the rows up-to-date
+  inline void refreshAllRows() const
+  {
+    for (int iel = 0; iel < row_stale_.size(); iel++)
+      refreshRow(iel);
+  }
+
 public:
   ///constructor using source and target ParticleSet
   DistanceTableAA(const ParticleSet& target, DTModes modes) : DistanceTable(target, target, modes) {}
 
+  /** return true if the iel-th row of the full table can be read without being recomputed.
+   *  Always true unless the table is evaluated lazily. See DTModes::LAZY_FULL_TABLE.
+   */
+  bool isRowCurrent(int iel) const { return row_stale_.empty() || !row_stale_[iel]; }
+
   /** return full table distances
    */
-  const std::vector<DistRow>& getDistances() const { return distances_; }
+  const std::vector<DistRow>& getDistances() const
+  {
+    refreshAllRows();
+    return distances_;
+  }
 
   /** return full table displacements
    */
-  const std::vector<DisplRow>& getDisplacements() const { return displacements_; }
+  const std::vector<DisplRow>& getDisplacements() const
+  {
+    refreshAllRows();
+    return displacements_;
+  }
 
   /** return a row of distances for a given target particle
    */
-  const DistRow& getDistRow(int iel) const { return distances_[iel]; }
+  const DistRow& getDistRow(int iel) const
+  {
+    refreshRow(iel);
+    return distances_[iel];
+  }
 
   /** return a row of displacements for a given target particle
    */
-  const DisplRow& getDisplRow(int iel) const { return displacements_[iel]; }
+  const DisplRow& getDisplRow(int iel) const
+  {
+    refreshRow(iel);
+    return displacements_[iel];
+  }
 
   /** return the temporary distances when a move is proposed
    */
@@ -303,49 +356,190 @@ class DistanceTableAB : public DistanceTable
 protected:
   /** distances_[num_targets_][num_sources_], [i][3][j] = |r_A2[j] - r_A1[i]|
    *  Note: Derived classes decide if it is a memory view or the actual storage
+   *  mutable because partial rows are completed by const accessors. See row_partial_.
    */
-  std::vector<DistRow> distances_;
+  mutable std::vector<DistRow> distances_;
 
   /** displacements_[num_targets_][3][num_sources_], [i][3][j] = r_A2[j] - r_A1[i]
    *  Note: Derived classes decide if it is a memory view or the actual storage
    */
-  std::vector<DisplRow> displacements_;
+  mutable std::vector<DisplRow> displacements_;
 
   /// temp_r
-  DistRow temp_r_;
+  mutable DistRow temp_r_;
 
   /// temp_dr
-  DisplRow temp_dr_;
+  mutable DisplRow temp_dr_;
+
+  /** row_partial_[i] is non-zero if the i-th row only holds the sources in the neighbor list.
+   *  Empty unless the implementation computes partial rows with neighbor lists.
+   *  char instead of bool to allow reading distinct rows from different threads.
+   */
+  mutable std::vector<char> row_partial_;
+
+  /// true if the temporary row only holds the sources in the neighbor list of the proposed move
+  mutable bool temp_partial_;
+
+  /// cutoff radius of neighbor lists, non-positive if neighbor lists are not maintained
+  RealType neighbor_rcut_;
+
+  /// Verlet skin of neighbor lists. Lists contain sources within neighbor_rcut_ + neighbor_skin_
+  RealType neighbor_skin_;
+
+  /// neighbor_ids_[num_targets_], IDs of source particles within neighbor_rcut_ of each target particle
+  std::vector<std::vector<int>> neighbor_ids_;
+
+  /// IDs of source particles within neighbor_rcut_ of the proposed move
+  std::vector<int> temp_neighbor_ids_;
+
+  /** compute all the sources of a partial row
+   *  Only needed by derived classes computing partial rows.
+   */
+  virtual void completeRow(int iel) const
+  {
+    throw std::runtime_error(name_ + " completing partial rows not supported");
+  }
+
+  /// compute all the sources of the partial temporary row
+  virtual void completeTempRow() const
+  {
+    throw std::runtime_error(name_ + " completing partial rows not supported");
+  }
+
+  /// complete a row if it is partial
+  inline void completeRowIfPartial(int iel) const
+  {
+    if (!row_partial_.empty() && row_partial_[iel])
+    {
+      completeRow(iel);
+      row_partial_[iel] = 0;
+    }
+  }
+
+  /// complete all the partial rows
+  inline void completeAllRows() const
+  {
+    for (int iel = 0; iel < row_partial_.size(); iel++)
+      completeRowIfPartial(iel);
+  }
+
+  /// complete the temporary row if it is partial
+  inline void completeTempRowIfPartial() const
+  {
+    if (temp_partial_)
+    {
+      completeTempRow();
+      temp_partial_ = false;
+    }
+  }
 
 public:
   ///constructor using source and target ParticleSet
   DistanceTableAB(const ParticleSet& source, const ParticleSet& target, DTModes modes)
-      : DistanceTable(source, target, modes)
+      : DistanceTable(source, target, modes), temp_partial_(false), neighbor_rcut_(0), neighbor_skin_(0)
   {}
 
+  /** request compact neighbor lists of source particles within a cutoff radius.
+   * Multiple consumers may request neighbor lists and the largest cutoff radius and skin are kept.
+   * Lists are populated by evaluate(), move() and update() of implementations supporting this feature.
+   * With a positive skin, Verlet lists are used. A list contains the sources within rcut + skin
+   * of the position where it was built and is reused as long as the particle stays within skin/2 of that position.
+   * Thus a list is always a superset of the sources within rcut and consumers still need to check distances.
+   * Implementations may then compute only the distances to the sources in the lists. The full row accessors,
+   * getDistRow, getTempDists and the like, complete such partial rows on demand while the neighbor row accessors,
+   * getNeighborDistRow, getTempNeighborDists and the like, return them as they are.
+   * Completing a row is not thread-safe against other reads of the same row.
+   * @param rcut cutoff radius
+   * @param skin Verlet skin
+   * @return true if the implementation maintains neighbor lists
+   */
+  virtual bool enableNeighborList(RealType rcut, RealType skin = 0) { return false; }
+
+  /// return true if neighbor lists are maintained
+  bool hasNeighborList() const { return neighbor_rcut_ > 0; }
+
+  /// return the cutoff radius of neighbor lists
+  RealType getNeighborCutoff() const { return neighbor_rcut_; }
+
+  /// return the Verlet skin of neighbor lists
+  RealType getNeighborSkin() const { return neighbor_skin_; }
+
+  /** return IDs of source particles in the neighbor list of a given target particle in ascending order
+   */
+  const std::vector<int>& getNeighborIDs(int iel) const { return neighbor_ids_[iel]; }
+
+  /** return IDs of source particles in the neighbor list of the proposed move in ascending order
+   */
+  const std::vector<int>& getTempNeighborIDs() const { return temp_neighbor_ids_; }
+
+  /** return true if the iel-th row holds all the sources.
+   *  Always true unless neighbor lists are enabled on an implementation computing partial rows.
+   */
+  bool isRowComplete(int iel) const { return row_partial_.empty() || !row_partial_[iel]; }
+
   /** return full table distances
    */
-  const std::vector<DistRow>& getDistances() const { return distances_; }
+  const std::vector<DistRow>& getDistances() const
+  {
+    completeAllRows();
+    return distances_;
+  }
 
   /** return full table displacements
    */
-  const std::vector<DisplRow>& getDisplacements() const { return displacements_; }
+  const std::vector<DisplRow>& getDisplacements() const
+  {
+    completeAllRows();
+    return displacements_;
+  }
 
   /** return a row of distances for a given target particle
    */
-  const DistRow& getDistRow(int iel) const { return distances_[iel]; }
+  const DistRow& getDistRow(int iel) const
+  {
+    completeRowIfPartial(iel);
+    return distances_[iel];
+  }
 
   /** return a row of displacements for a given target particle
    */
-  const DisplRow& getDisplRow(int iel) const { return displacements_[iel]; }
+  const DisplRow& getDisplRow(int iel) const
+  {
+    completeRowIfPartial(iel);
+    return displacements_[iel];
+  }
 
   /** return the temporary distances when a move is proposed
    */
-  const DistRow& getTempDists() const { return temp_r_; }
+  const DistRow& getTempDists() const
+  {
+    completeTempRowIfPartial();
+    return temp_r_;
+  }
 
   /** return the temporary displacements when a move is proposed
    */
-  const DisplRow& getTempDispls() const { return temp_dr_; }
+  const DisplRow& getTempDispls() const
+  {
+    completeTempRowIfPartial();
+    return temp_dr_;
+  }
+
+  /** return a row of distances for a given target particle, only valid for the sources in getNeighborIDs(iel)
+   */
+  const DistRow& getNeighborDistRow(int iel) const { return distances_[iel]; }
+
+  /** return a row of displacements for a given target particle, only valid for the sources in getNeighborIDs(iel)
+   */
+  const DisplRow& getNeighborDisplRow(int iel) const { return displacements_[iel]; }
+
+  /** return the temporary distances of the proposed move, only valid for the sources in getTempNeighborIDs()
+   */
+  const DistRow& getTempNeighborDists() const { return temp_r_; }
+
+  /** return the temporary displacements of the proposed move, only valid for the sources in getTempNeighborIDs()
+   */
+  const DisplRow& getTempNeighborDispls() const { return temp_dr_; }
 
   /// return multi-walker full (all pairs) distance table data pointer
   virtual const RealType* getMultiWalkerDataPtr() const
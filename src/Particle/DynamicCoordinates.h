@@ -30,6 +30,7 @@ enum class DynamicCoordinateKind
 {
   DC_POS,         // SoA positions
   DC_POS_OFFLOAD, // SoA positions with OpenMP offload
+  DC_POS_AOSOA,   // SoA positions and their AoSoA tiles
 };
 
 /** quantum variables of all the particles
@@ -13,6 +13,7 @@
 #include "DynamicCoordinatesBuilder.h"
 #include "Particle/RealSpacePositions.h"
 #include "Particle/RealSpacePositionsOMPTarget.h"
+#include "Particle/RealSpacePositionsAoSoA.h"
 
 namespace qmcplusplus
 {
@@ -22,6 +23,8 @@ std::unique_ptr<DynamicCoordinates> createDynamicCoordinates(const DynamicCoordi
 {
   if (kind == DynamicCoordinateKind::DC_POS)
     return std::make_unique<RealSpacePositions>();
+  else if (kind == DynamicCoordinateKind::DC_POS_AOSOA)
+    return std::make_unique<RealSpacePositionsAoSoA>();
 #if defined(ENABLE_OFFLOAD)
   else if (kind == DynamicCoordinateKind::DC_POS_OFFLOAD)
     return std::make_unique<RealSpacePositionsOMPTarget>();
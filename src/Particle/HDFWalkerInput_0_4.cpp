@@ -18,6 +18,7 @@
 #include "mpi/mpi_datatype.h"
 #include "mpi/collectives.h"
 #include "Utilities/FairDivide.h"
+#include "HDFWalkerOutput.h"
 
 namespace qmcplusplus
 {
@@ -111,75 +112,28 @@ bool HDFWalkerInput_0_4::put(xmlNodePtr cur)
     FileName = FileStack.top();
     FileStack.pop();
     std::string h5name(FileName);
-    //success |= read_hdf5_scatter(h5name);
+    if (is_aggregated(h5name))
+      success |= read_aggregated(h5name);
+    else
+    {
+      //success |= read_hdf5_scatter(h5name);
 #ifdef ENABLE_PHDF5
-    success |= read_phdf5(h5name);
+      success |= read_phdf5(h5name);
 #else
-    success |= read_hdf5(h5name);
+      success |= read_hdf5(h5name);
 #endif
+    }
   }
   return success;
 }
 
 bool HDFWalkerInput_0_4::read_hdf5(std::string h5name)
 {
-  size_t nw_in = 0;
-
   h5name.append(hdf::config_ext);
-  hdf_archive hin(myComm, false); //everone reads this
-  bool success = hin.open(h5name, H5F_ACC_RDONLY);
-  //check if hdf and xml versions can work together
-  HDFVersion aversion;
-
-  hin.read(aversion, hdf::version);
-  if (!(aversion < i_info.version))
-  {
-    int found_group = hin.is_group(hdf::main_state);
-    hin.push(hdf::main_state);
-    hin.read(nw_in, hdf::num_walkers);
-  }
-  else
-  {
-    app_error() << " Mismatched version. xml = " << i_info.version << " hdf = " << aversion << std::endl;
-  }
-
-  if (nw_in == 0)
-  {
-    app_error() << " No walkers in " << h5name << std::endl;
-    return false;
-  }
-
-  using Buffer_t = std::vector<QMCTraits::RealType>;
-  Buffer_t posin;
-  std::array<size_t, 3> dims{nw_in, num_ptcls_, OHMMS_DIM};
-  posin.resize(dims[0] * dims[1] * dims[2]);
-  hin.readSlabReshaped(posin, dims, hdf::walkers);
-
   std::vector<int> woffsets;
-  hin.read(woffsets, "walker_partition");
-
-  int np1 = myComm->size() + 1;
-  if (woffsets.size() != np1)
-  {
-    woffsets.resize(myComm->size() + 1, 0);
-    FairDivideLow(nw_in, myComm->size(), woffsets);
-  }
-
-  app_log() << " HDFWalkerInput_0_4::put getting " << dims[0] << " walkers " << posin.size() << std::endl;
-  nw_in = woffsets[myComm->rank() + 1] - woffsets[myComm->rank()];
-  {
-    const int nitems    = num_ptcls_ * OHMMS_DIM;
-    const int curWalker = wc_list_.getActiveWalkers();
-    wc_list_.createWalkers(nw_in, num_ptcls_);
-    Buffer_t::iterator it(posin.begin() + woffsets[myComm->rank()] * nitems);
-    for (int i = 0, iw = curWalker; i < nw_in; ++i, ++iw)
-    {
-      copy(it, it + nitems, get_first_address(wc_list_[iw]->R));
-      it += nitems;
-    }
-  }
-
-  return true;
+  if (!read_walker_partition(h5name, woffsets))
+    return false;
+  return read_walker_slab(h5name, woffsets, false);
 }
 
 bool HDFWalkerInput_0_4::read_hdf5_scatter(std::string h5name)
@@ -256,72 +210,84 @@ bool HDFWalkerInput_0_4::read_hdf5_scatter(std::string h5name)
 
 bool HDFWalkerInput_0_4::read_phdf5(std::string h5name)
 {
-  size_t nw_in = 0;
   h5name.append(hdf::config_ext);
   std::vector<int> woffsets;
+  if (!read_walker_partition(h5name, woffsets))
+    return false;
+  return read_walker_slab(h5name, woffsets, true);
+}
+
+bool HDFWalkerInput_0_4::read_walker_partition(const std::string& h5name, std::vector<int>& woffsets)
+{
+  size_t nw_in      = 0;
   int woffsets_size = 0;
   bool success      = false;
 
-  { // handle small dataset with master rank
-    hdf_archive hin(myComm, false);
-    if (!myComm->rank())
-    {
-      success = hin.open(h5name, H5F_ACC_RDONLY);
-      //check if hdf and xml versions can work together
-      HDFVersion aversion;
+  // handle small dataset with master rank
+  if (!myComm->rank())
+  {
+    hdf_archive hin;
+    success = hin.open(h5name, H5F_ACC_RDONLY);
+    //check if hdf and xml versions can work together
+    HDFVersion aversion;
 
-      hin.read(aversion, hdf::version);
-      if (!(aversion < i_info.version))
-      {
-        int found_group = hin.is_group(hdf::main_state);
-        hin.push(hdf::main_state);
-        hin.read(nw_in, hdf::num_walkers);
-        if (nw_in == 0)
-        {
-          app_error() << " No walkers in " << h5name << std::endl;
-          success = false;
-        }
-      }
-      else
+    hin.read(aversion, hdf::version);
+    if (!(aversion < i_info.version))
+    {
+      int found_group = hin.is_group(hdf::main_state);
+      hin.push(hdf::main_state);
+      hin.read(nw_in, hdf::num_walkers);
+      if (nw_in == 0)
       {
-        app_error() << " Mismatched version. xml = " << i_info.version << " hdf = " << aversion << std::endl;
+        app_error() << " No walkers in " << h5name << std::endl;
         success = false;
       }
     }
-    mpi::bcast(*myComm, success);
-    if (!success)
-      return false;
+    else
+    {
+      app_error() << " Mismatched version. xml = " << i_info.version << " hdf = " << aversion << std::endl;
+      success = false;
+    }
 
     // load woffsets by master
     // can not read collectively since the size may differ from Nranks+1.
-    if (!myComm->rank())
+    if (success)
     {
       hin.read(woffsets, "walker_partition");
       woffsets_size = woffsets.size();
       assert(woffsets[woffsets_size - 1] == nw_in);
     }
+  }
+  mpi::bcast(*myComm, success);
+  if (!success)
+    return false;
+
+  mpi::bcast(*myComm, woffsets_size);
+  woffsets.resize(woffsets_size);
+  mpi::bcast(*myComm, woffsets.data(), woffsets_size);
+  nw_in = woffsets[woffsets_size - 1];
 
-    mpi::bcast(*myComm, woffsets_size);
-    woffsets.resize(woffsets_size);
-    mpi::bcast(*myComm, woffsets.data(), woffsets_size);
-    nw_in = woffsets[woffsets_size - 1];
+  // the number of ranks changed since the walkers were written
+  if (woffsets.size() != myComm->size() + 1)
+  {
+    woffsets.resize(myComm->size() + 1, 0);
+    FairDivideLow(nw_in, myComm->size(), woffsets);
   }
+  return true;
+}
 
-  hdf_archive hin(myComm, true); //everone reads this
-  success         = hin.open(h5name, H5F_ACC_RDONLY);
+bool HDFWalkerInput_0_4::read_walker_slab(const std::string& h5name, const std::vector<int>& woffsets, bool collective)
+{
+  hdf_archive hin(myComm, collective); //everone reads this
+  bool success    = hin.open(h5name, H5F_ACC_RDONLY);
   int found_group = hin.is_group(hdf::main_state);
   hin.push(hdf::main_state);
 
   using Buffer_t = std::vector<QMCTraits::RealType>;
   Buffer_t posin;
+  const size_t nw_in = woffsets[myComm->size()];
   std::array<size_t, 3> dims{nw_in, num_ptcls_, OHMMS_DIM};
 
-  if (woffsets.size() != myComm->size() + 1)
-  {
-    woffsets.resize(myComm->size() + 1, 0);
-    FairDivideLow(nw_in, myComm->size(), woffsets);
-  }
-
   const size_t nw_loc = woffsets[myComm->rank() + 1] - woffsets[myComm->rank()];
 
   std::array<size_t, 3> counts{nw_loc, num_ptcls_, OHMMS_DIM};
@@ -332,13 +298,12 @@ bool HDFWalkerInput_0_4::read_phdf5(std::string h5name)
   hin.read(slab, hdf::walkers);
 
   app_log() << " HDFWalkerInput_0_4::put getting " << dims[0] << " walkers " << posin.size() << std::endl;
-  nw_in = woffsets[myComm->rank() + 1] - woffsets[myComm->rank()];
   {
     const int nitems    = num_ptcls_ * OHMMS_DIM;
     const int curWalker = wc_list_.getActiveWalkers();
-    wc_list_.createWalkers(nw_in, num_ptcls_);
+    wc_list_.createWalkers(nw_loc, num_ptcls_);
     Buffer_t::iterator it(posin.begin());
-    for (int i = 0, iw = curWalker; i < nw_in; ++i, ++iw)
+    for (int i = 0, iw = curWalker; i < nw_loc; ++i, ++iw)
     {
       copy(it, it + nitems, get_first_address(wc_list_[iw]->R));
       it += nitems;
@@ -347,4 +312,131 @@ bool HDFWalkerInput_0_4::read_phdf5(std::string h5name)
   return true;
 }
 
+bool HDFWalkerInput_0_4::is_aggregated(std::string h5name)
+{
+  h5name.append(hdf::config_ext);
+  int aggregated = 0;
+  if (!myComm->rank())
+  {
+    hdf_archive hin;
+    if (hin.open(h5name, H5F_ACC_RDONLY) && hin.is_group(hdf::main_state))
+    {
+      hin.push(hdf::main_state);
+      std::vector<int> rank_subfiles;
+      aggregated = hin.readEntry(rank_subfiles, "walker_subfile");
+    }
+  }
+  mpi::bcast(*myComm, aggregated);
+  return aggregated;
+}
+
+bool HDFWalkerInput_0_4::read_aggregated(std::string h5name)
+{
+  // partition of the walkers and subfile of each rank of the run which wrote them, read by the master
+  std::vector<int> woffsets_in, rank_subfiles;
+  std::array<int, 3> sizes{0, 0, 0};
+  int nblock = 0;
+  if (!myComm->rank())
+  {
+    hdf_archive hin;
+    if (hin.open(h5name + hdf::config_ext, H5F_ACC_RDONLY))
+    {
+      HDFVersion aversion;
+      hin.read(aversion, hdf::version);
+      if (aversion < i_info.version)
+        app_error() << " Mismatched version. xml = " << i_info.version << " hdf = " << aversion << std::endl;
+      else
+      {
+        hin.push(hdf::main_state);
+        hin.read(nblock, "block");
+        hin.read(woffsets_in, "walker_partition");
+        hin.read(rank_subfiles, "walker_subfile");
+        sizes = {woffsets_in.back(), static_cast<int>(woffsets_in.size()), static_cast<int>(rank_subfiles.size())};
+      }
+    }
+  }
+  mpi::bcast(*myComm, sizes.data(), sizes.size());
+  const size_t nw_in = sizes[0];
+  if (nw_in == 0 || sizes[1] != sizes[2] + 1)
+  {
+    app_error() << " No walkers in " << h5name << hdf::config_ext << std::endl;
+    return false;
+  }
+  woffsets_in.resize(sizes[1]);
+  rank_subfiles.resize(sizes[2]);
+  mpi::bcast(*myComm, woffsets_in);
+  mpi::bcast(*myComm, rank_subfiles);
+  mpi::bcast(*myComm, nblock);
+
+  // the walkers of a subfile are ordered by the rank which wrote them
+  const int nranks_in = rank_subfiles.size();
+  std::vector<size_t> subfile_offsets(nranks_in), subfile_sizes;
+  for (int ip = 0; ip < nranks_in; ++ip)
+  {
+    const int subfile = rank_subfiles[ip];
+    if (subfile >= subfile_sizes.size())
+      subfile_sizes.resize(subfile + 1, 0);
+    subfile_offsets[ip] = subfile_sizes[subfile];
+    subfile_sizes[subfile] += woffsets_in[ip + 1] - woffsets_in[ip];
+  }
+
+  std::vector<int> woffsets(woffsets_in);
+  if (woffsets.size() != myComm->size() + 1)
+  {
+    woffsets.resize(myComm->size() + 1, 0);
+    FairDivideLow(nw_in, myComm->size(), woffsets);
+  }
+  const int first_walker = woffsets[myComm->rank()];
+  const int last_walker  = woffsets[myComm->rank() + 1];
+
+  using Buffer_t   = std::vector<QMCTraits::RealType>;
+  const int nitems = num_ptcls_ * OHMMS_DIM;
+  Buffer_t posin((last_walker - first_walker) * nitems), slab_buffer;
+  hdf_archive hin;
+  int open_subfile = -1;
+  for (int ip = 0; ip < nranks_in; ++ip)
+  {
+    const int first = std::max(first_walker, woffsets_in[ip]);
+    const int last  = std::min(last_walker, woffsets_in[ip + 1]);
+    if (first >= last)
+      continue;
+    const int subfile = rank_subfiles[ip];
+    if (subfile != open_subfile)
+    {
+      const std::string subfile_name = HDFWalkerOutput::getSubfileName(h5name, subfile);
+      int subfile_block              = -1;
+      if (hin.open(subfile_name, H5F_ACC_RDONLY))
+      {
+        hin.push(hdf::main_state);
+        hin.readEntry(subfile_block, "block");
+      }
+      if (subfile_block != nblock)
+      {
+        app_error() << " Missing or incomplete walker subfile " << subfile_name << std::endl;
+        return false;
+      }
+      open_subfile = subfile;
+    }
+    std::array<size_t, 3> dims{subfile_sizes[subfile], num_ptcls_, OHMMS_DIM};
+    std::array<size_t, 3> counts{static_cast<size_t>(last - first), num_ptcls_, OHMMS_DIM};
+    std::array<size_t, 3> offsets{subfile_offsets[ip] + first - woffsets_in[ip], 0, 0};
+    slab_buffer.resize(counts[0] * nitems);
+    hyperslab_proxy<Buffer_t, 3> slab(slab_buffer, dims, counts, offsets);
+    hin.read(slab, hdf::walkers);
+    std::copy(slab_buffer.begin(), slab_buffer.end(), posin.begin() + (first - first_walker) * nitems);
+  }
+
+  app_log() << " HDFWalkerInput_0_4::put getting " << nw_in << " walkers from " << subfile_sizes.size()
+            << " subfiles" << std::endl;
+  const int curWalker = wc_list_.getActiveWalkers();
+  wc_list_.createWalkers(last_walker - first_walker, num_ptcls_);
+  Buffer_t::iterator it(posin.begin());
+  for (int iw = curWalker; iw < wc_list_.getActiveWalkers(); ++iw)
+  {
+    copy(it, it + nitems, get_first_address(wc_list_[iw]->R));
+    it += nitems;
+  }
+  return true;
+}
+
 } // namespace qmcplusplus
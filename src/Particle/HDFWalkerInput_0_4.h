@@ -80,12 +80,27 @@ struct HDFWalkerInput_0_4
   /** check options from xml */
   void checkOptions(xmlNodePtr cur);
 
-  /** read walkers for small number of MPI tasks */
+  /** read walkers. Each rank reads its own walkers independently */
   bool read_hdf5(std::string h5name);
   /** read walkers. Master reads and scatter the walkers */
   bool read_hdf5_scatter(std::string h5name);
   /** read walkers using PHDF5 */
   bool read_phdf5(std::string h5name);
+  /** return true if the walkers of h5name are in subfiles, see HDFWalkerOutput::setAggregated */
+  bool is_aggregated(std::string h5name);
+  /** read walkers from the subfiles of h5name. Each rank only opens the subfiles holding its walkers */
+  bool read_aggregated(std::string h5name);
+
+private:
+  /** read the walker partition on the master and broadcast it
+   * @param h5name configuration file
+   * @param woffsets first walker of each rank, divided evenly if the number of ranks changed
+   */
+  bool read_walker_partition(const std::string& h5name, std::vector<int>& woffsets);
+  /** read the walkers of this rank
+   * @param collective read collectively with PHDF5, otherwise each rank reads independently
+   */
+  bool read_walker_slab(const std::string& h5name, const std::vector<int>& woffsets, bool collective);
 };
 
 } // namespace qmcplusplus
@@ -24,12 +24,42 @@
 #include <numeric>
 #include <iostream>
 #include <sstream>
+#include <cstdio>
+#include <iomanip>
+#include <algorithm>
 #include "Message/Communicate.h"
+#include "Platforms/Host/OutputManager.h"
 #include "mpi/collectives.h"
+#include "Message/CommProfile.h"
 #include "hdf/hdf_hyperslab.h"
 
 namespace qmcplusplus
 {
+namespace
+{
+/** write the state of a dump under a temporary name and rename the file once complete
+ * @param file_name name of the file
+ * @param nblock block of the dump
+ * @param write_walkers writes the datasets of the walkers to the main state group
+ */
+template<typename F>
+void writeStateFile(const std::string& file_name, int nblock, const F& write_walkers)
+{
+  const std::string tmp_name = file_name + ".tmp";
+  hdf_archive dump_file;
+  if (!dump_file.create(tmp_name))
+    throw std::runtime_error("HDFWalkerOutput failed to create " + tmp_name);
+  HDFVersion cur_version;
+  dump_file.write(cur_version.version, hdf::version);
+  dump_file.push(hdf::main_state);
+  dump_file.write(nblock, "block");
+  write_walkers(dump_file);
+  dump_file.close();
+  if (std::rename(tmp_name.c_str(), file_name.c_str()) != 0)
+    throw std::runtime_error("HDFWalkerOutput failed to rename " + tmp_name + " to " + file_name);
+}
+} // namespace
+
 /* constructor
  * @param W walkers to operate on
  * @param aroot the root file name
@@ -56,7 +86,10 @@ HDFWalkerOutput::HDFWalkerOutput(size_t num_ptcls, const std::string& aroot, Com
       number_of_particles_(num_ptcls),
       myComm(c),
       currentConfigNumber(0),
-      RootName(aroot)
+      RootName(aroot),
+      async_(false),
+      aggregated_(false),
+      subfile_(0)
 //       , fw_out(myComm)
 {
   RemoteData.reserve(4);
@@ -78,6 +111,8 @@ HDFWalkerOutput::HDFWalkerOutput(size_t num_ptcls, const std::string& aroot, Com
 HDFWalkerOutput::~HDFWalkerOutput()
 {
   //     fw_out.close();
+  if (pending_dump_.valid())
+    pending_dump_.wait();
   delete_iter(RemoteData.begin(), RemoteData.end());
 }
 
@@ -94,6 +129,21 @@ HDFWalkerOutput::~HDFWalkerOutput()
  */
 bool HDFWalkerOutput::dump(const WalkerConfigurations& W, int nblock)
 {
+  // the previous file is complete before it is replaced
+  waitForDump();
+  if (aggregated_)
+  {
+    dumpAggregated(W, nblock);
+    currentConfigNumber++;
+    return true;
+  }
+  if (async_)
+  {
+    dumpAsync(W, nblock);
+    currentConfigNumber++;
+    return true;
+  }
+
   std::string FileName = myComm->getName() + hdf::config_ext;
   //rotate files
   //if(!myComm->rank() && currentConfigNumber)
@@ -119,6 +169,177 @@ bool HDFWalkerOutput::dump(const WalkerConfigurations& W, int nblock)
   return true;
 }
 
+void HDFWalkerOutput::setAsync(bool async)
+{
+  hbool_t is_threadsafe = false;
+  H5is_library_threadsafe(&is_threadsafe);
+  if (async && !is_threadsafe)
+  {
+    app_warning() << "The HDF5 library is not thread safe, the walker configurations are written synchronously."
+                  << std::endl;
+    async = false;
+  }
+  async_ = async;
+}
+
+void HDFWalkerOutput::waitForDump()
+{
+  if (pending_dump_.valid())
+    pending_dump_.get();
+}
+
+/** Copy the walkers and gather them on the master, then the master writes them in the background.
+ *
+ * MPI is only called on this thread. The file is written under a temporary name and renamed once complete
+ * so that a failure during the write leaves the previous configurations in place.
+ */
+void HDFWalkerOutput::dumpAsync(const WalkerConfigurations& W, int nblock)
+{
+  const int wb = OHMMS_DIM * number_of_particles_;
+  RemoteData[0]->resize(wb * W.getActiveWalkers());
+  W.putConfigurations(RemoteData[0]->data());
+  block = nblock;
+
+  number_of_walkers_ = W.WalkerOffsets[myComm->size()];
+  if (myComm->size() > 1)
+  {
+    std::vector<int> displ(myComm->size()), counts(myComm->size());
+    for (int i = 0; i < myComm->size(); ++i)
+    {
+      counts[i] = wb * (W.WalkerOffsets[i + 1] - W.WalkerOffsets[i]);
+      displ[i]  = wb * W.WalkerOffsets[i];
+    }
+    if (!myComm->rank())
+      RemoteData[1]->resize(wb * W.WalkerOffsets[myComm->size()]);
+    {
+      ScopedCommProfile profile("HDFWalkerOutput::gatherv", RemoteData[0]->size() * sizeof(BufferType::value_type));
+      mpi::gatherv(*myComm, *RemoteData[0], *RemoteData[1], counts, displ);
+    }
+  }
+  if (myComm->rank())
+    return;
+
+  // the buffer is not touched until the next dump waits for this write
+  BufferType* walkers = RemoteData[(myComm->size() > 1) ? 1 : 0];
+  auto write_dump = [file_name = myComm->getName() + hdf::config_ext, walker_partition = W.WalkerOffsets,
+                     num_walkers = number_of_walkers_, num_ptcls = number_of_particles_, walkers, nblock]() {
+    writeStateFile(file_name, nblock, [&](hdf_archive& dump_file) {
+      dump_file.write(num_walkers, hdf::num_walkers);
+      dump_file.write(walker_partition, "walker_partition");
+      std::array<size_t, 3> gcounts{num_walkers, num_ptcls, OHMMS_DIM};
+      dump_file.writeSlabReshaped(*walkers, gcounts, hdf::walkers);
+    });
+  };
+  pending_dump_ = std::async(std::launch::async, write_dump);
+}
+
+std::string HDFWalkerOutput::getSubfileName(const std::string& root, int subfile)
+{
+  std::ostringstream o;
+  o << root << ".n" << std::setw(5) << std::setfill('0') << subfile << hdf::config_ext;
+  return o.str();
+}
+
+void HDFWalkerOutput::setAggregated(bool aggregated)
+{
+  aggregated_ = aggregated;
+  if (!aggregated_ || node_comm_)
+    return;
+  node_comm_ = std::make_unique<Communicate>();
+  node_comm_->initializeAsNodeComm(*myComm);
+
+  std::vector<int> my_rank(1, myComm->rank());
+  if (!node_comm_->rank())
+    node_ranks_.resize(node_comm_->size());
+  mpi::gather(*node_comm_, my_rank, node_ranks_);
+
+  // the subfiles are numbered in the order of the first ranks of the nodes
+  std::vector<int> node_leader(my_rank);
+  mpi::bcast(*node_comm_, node_leader);
+  std::vector<int> rank_leaders(myComm->rank() ? 0 : myComm->size());
+  mpi::gather(*myComm, node_leader, rank_leaders);
+  if (!myComm->rank())
+  {
+    std::vector<int> leaders(rank_leaders);
+    std::sort(leaders.begin(), leaders.end());
+    leaders.erase(std::unique(leaders.begin(), leaders.end()), leaders.end());
+    rank_subfiles_.resize(rank_leaders.size());
+    for (int i = 0; i < rank_leaders.size(); ++i)
+      rank_subfiles_[i] = std::lower_bound(leaders.begin(), leaders.end(), rank_leaders[i]) - leaders.begin();
+    app_log() << "  Walker configurations are written to " << leaders.size() << " subfiles" << std::endl;
+  }
+  std::vector<int> my_subfile(1, 0);
+  mpi::scatter(*myComm, rank_subfiles_, my_subfile);
+  subfile_ = my_subfile[0];
+}
+
+/** Gather the walkers of each node on its first rank, which writes them to the subfile of the node.
+ *
+ * The ranks of a node are ordered by their rank in myComm. The master also writes the configuration file
+ * with the walker partition and the subfile of each rank. With setAsync the files are written in the background.
+ */
+void HDFWalkerOutput::dumpAggregated(const WalkerConfigurations& W, int nblock)
+{
+  const int wb = OHMMS_DIM * number_of_particles_;
+  RemoteData[0]->resize(wb * W.getActiveWalkers());
+  W.putConfigurations(RemoteData[0]->data());
+  block = nblock;
+
+  number_of_walkers_      = W.WalkerOffsets[myComm->size()];
+  size_t num_node_walkers = W.getActiveWalkers();
+  if (node_comm_->size() > 1)
+  {
+    std::vector<int> displ(node_comm_->size()), counts(node_comm_->size());
+    if (!node_comm_->rank())
+    {
+      num_node_walkers = 0;
+      for (int i = 0; i < node_comm_->size(); ++i)
+      {
+        const int nw = W.WalkerOffsets[node_ranks_[i] + 1] - W.WalkerOffsets[node_ranks_[i]];
+        counts[i]    = wb * nw;
+        displ[i]     = wb * num_node_walkers;
+        num_node_walkers += nw;
+      }
+      RemoteData[1]->resize(wb * num_node_walkers);
+    }
+    {
+      ScopedCommProfile profile("HDFWalkerOutput::gatherv", RemoteData[0]->size() * sizeof(BufferType::value_type));
+      mpi::gatherv(*node_comm_, *RemoteData[0], *RemoteData[1], counts, displ);
+    }
+  }
+  if (node_comm_->rank())
+    return;
+
+  BufferType* walkers = RemoteData[(node_comm_->size() > 1) ? 1 : 0];
+  std::vector<int> walker_partition, rank_subfiles;
+  if (!myComm->rank())
+  {
+    walker_partition = W.WalkerOffsets;
+    rank_subfiles    = rank_subfiles_;
+  }
+  auto write_dump = [root = myComm->getName(), subfile = subfile_, walker_partition = std::move(walker_partition),
+                     rank_subfiles = std::move(rank_subfiles), num_walkers = number_of_walkers_, num_node_walkers,
+                     num_ptcls = number_of_particles_, walkers, nblock]() {
+    writeStateFile(getSubfileName(root, subfile), nblock, [&](hdf_archive& dump_file) {
+      dump_file.write(num_node_walkers, hdf::num_walkers);
+      std::array<size_t, 3> gcounts{num_node_walkers, num_ptcls, OHMMS_DIM};
+      dump_file.writeSlabReshaped(*walkers, gcounts, hdf::walkers);
+    });
+    if (rank_subfiles.empty())
+      return;
+    // the subfiles of the other nodes may still be written, the reader checks their block
+    writeStateFile(root + hdf::config_ext, nblock, [&](hdf_archive& dump_file) {
+      dump_file.write(num_walkers, hdf::num_walkers);
+      dump_file.write(walker_partition, "walker_partition");
+      dump_file.write(rank_subfiles, "walker_subfile");
+    });
+  };
+  if (async_)
+    pending_dump_ = std::async(std::launch::async, std::move(write_dump));
+  else
+    write_dump();
+}
+
 void HDFWalkerOutput::write_configuration(const WalkerConfigurations& W, hdf_archive& hout, int nblock)
 {
   const int wb = OHMMS_DIM * number_of_particles_;
@@ -176,7 +397,10 @@ void HDFWalkerOutput::write_configuration(const WalkerConfigurations& W, hdf_arc
       }
       if (!myComm->rank())
         RemoteData[1]->resize(wb * W.WalkerOffsets[myComm->size()]);
-      mpi::gatherv(*myComm, *RemoteData[0], *RemoteData[1], counts, displ);
+      {
+        ScopedCommProfile profile("HDFWalkerOutput::gatherv", RemoteData[0]->size() * sizeof(BufferType::value_type));
+        mpi::gatherv(*myComm, *RemoteData[0], *RemoteData[1], counts, displ);
+      }
     }
     int buffer_id = (myComm->size() > 1) ? 1 : 0;
     hout.writeSlabReshaped(*RemoteData[buffer_id], gcounts, hdf::walkers);
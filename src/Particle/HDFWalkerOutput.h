@@ -18,6 +18,8 @@
 
 #include "Particle/WalkerConfigurations.h"
 #include <utility>
+#include <future>
+#include <memory>
 #include "hdf/hdf_archive.h"
 
 namespace qmcplusplus
@@ -57,12 +59,46 @@ public:
   bool dump(const WalkerConfigurations& w, int block);
   //     bool dump(ForwardWalkingHistoryObject& FWO);
 
+  /** write the configurations in the background
+   *
+   * dump takes a copy of the walkers, gathers it on the master and returns while the master writes the file.
+   * Ignored with a warning if the HDF5 library is not thread safe.
+   */
+  void setAsync(bool async);
+
+  /// wait for the configurations being written in the background, rethrows the failures of the write
+  void waitForDump();
+
+  /** write the configurations to one subfile per node
+   *
+   * The first rank of each node gathers the walkers of the node and writes them to its subfile.
+   * The configuration file written by the master only holds the partition of the walkers and the subfile of each rank.
+   */
+  void setAggregated(bool aggregated);
+
+  /// name of a subfile of aggregated configurations
+  static std::string getSubfileName(const std::string& root, int subfile);
+
 private:
   ///PooledData<T> is used to define the shape of multi-dimensional array
   using BufferType = PooledData<OHMMS_PRECISION>;
   std::vector<Communicate::request> myRequest;
   std::vector<BufferType*> RemoteData;
   int block;
+  ///write the configurations in the background
+  bool async_;
+  ///background write of the last dump
+  std::future<void> pending_dump_;
+  ///write the configurations to one subfile per node
+  bool aggregated_;
+  ///ranks on the node of this rank
+  std::unique_ptr<Communicate> node_comm_;
+  ///subfile holding the walkers of this rank
+  int subfile_;
+  ///subfile of each rank, on the master
+  std::vector<int> rank_subfiles_;
+  ///rank in myComm of each rank of the node, on the first rank of the node
+  std::vector<int> node_ranks_;
 
   //     //define some types for the FW collection
   //     using FWBufferType = std::vector<ForwardWalkingData>;
@@ -70,6 +106,10 @@ private:
   //     std::vector<std::vector<int> > FWCountData;
 
   void write_configuration(const WalkerConfigurations& W, hdf_archive& hout, int block);
+  ///gather a copy of the walkers on the master and write it in the background
+  void dumpAsync(const WalkerConfigurations& W, int block);
+  ///gather the walkers of the node on its first rank, which writes the subfile
+  void dumpAggregated(const WalkerConfigurations& W, int block);
 };
 
 } // namespace qmcplusplus
@@ -238,6 +238,10 @@ struct CrystalLattice : public LRBreakupParameters<T, D>
     Base::LR_dim_cutoff = rhs.LR_dim_cutoff;
     Base::LR_kc         = rhs.LR_kc;
     Base::LR_rc         = rhs.LR_rc;
+    Base::LR_tol        = rhs.LR_tol;
+
+    Base::LR_dim_cutoff_auto = rhs.LR_dim_cutoff_auto;
+    Base::LR_breakup_cache   = rhs.LR_breakup_cache;
 
     explicitly_defined = rhs.explicitly_defined;
     BoxBConds          = rhs.BoxBConds;
@@ -13,7 +13,9 @@
 #ifndef OHMMS_LRBREAKUP_PARAMETERS_H
 #define OHMMS_LRBREAKUP_PARAMETERS_H
 
+#include <cmath>
 #include <iostream>
+#include <string>
 #include "config.h"
 #include "OhmmsPETE/TinyVector.h"
 
@@ -31,9 +33,13 @@ public:
   T LR_rc;
   T LR_kc;
   T LR_tol;
+  ///if true, LR_dim_cutoff is chosen by tuneLRCutoffs
+  bool LR_dim_cutoff_auto;
+  ///HDF5 file caching the optimized breakup fits, no caching if empty
+  std::string LR_breakup_cache;
 
   ///default constructor
-  LRBreakupParameters() : LR_dim_cutoff(15.0), LR_rc(1e6), LR_kc(0.0), LR_tol(3e-4) {}
+  LRBreakupParameters() : LR_dim_cutoff(15.0), LR_rc(1e6), LR_kc(0.0), LR_tol(3e-4), LR_dim_cutoff_auto(false) {}
 
   ///Set LR_rc = radius of smallest sphere inside box and kc=dim/rc
   void SetLRCutoffs(const TinyVector<TinyVector<T, 3>, 3>& a)
@@ -61,6 +67,45 @@ public:
     LR_kc = LR_dim_cutoff / LR_rc;
   }
 
+  /** estimate the energy error per unit charge of an Ewald sum with the cutoffs LR_rc and dim_cutoff/LR_rc
+   *
+   * Uses the estimates of Kolafa and Perram, Mol. Simul. 9, 351 (1992) with the Gaussian width
+   * of EwaldHandler3D, alpha^2 = kc/(2 rc). The optimized breakup is at least as accurate.
+   * @param dim_cutoff rc*kc
+   * @param volume volume of the cell
+   */
+  T estimateLRError(T dim_cutoff, T volume) const
+  {
+    const T kc           = dim_cutoff / LR_rc;
+    const T alpha        = std::sqrt(kc / (2 * LR_rc));
+    const T kindex       = kc * std::cbrt(volume) / (2 * M_PI);
+    const T expterm      = std::exp(-dim_cutoff / 2);
+    const T real_error   = std::sqrt(LR_rc / (2 * volume)) * expterm / (dim_cutoff / 2);
+    const T kspace_error = alpha / (M_PI * M_PI) * std::pow(kindex, T(-1.5)) * expterm;
+    return std::sqrt(real_error * real_error + kspace_error * kspace_error);
+  }
+
+  /** set LR_dim_cutoff and LR_kc to the cheapest breakup within LR_tol
+   *
+   * LR_rc is fixed by the cell, so the short-range cost does not depend on the cutoffs
+   * while the long-range cost grows with the number of k-vectors within kc.
+   * The cheapest breakup within LR_tol is thus the one with the smallest LR_dim_cutoff.
+   * Call after SetLRCutoffs.
+   * @param volume volume of the cell
+   */
+  void tuneLRCutoffs(T volume, std::ostream& out)
+  {
+    constexpr T dim_min(5), dim_max(60), dim_step(0.5);
+    LR_dim_cutoff = dim_min;
+    while (LR_dim_cutoff < dim_max && estimateLRError(LR_dim_cutoff, volume) > LR_tol)
+      LR_dim_cutoff += dim_step;
+    LR_kc = LR_dim_cutoff / LR_rc;
+    out << "  Tuned long-range breakup for LR_tol = " << LR_tol << " Ha:" << std::endl;
+    out << "    LR_dim_cutoff = " << LR_dim_cutoff << "; estimated error = " << estimateLRError(LR_dim_cutoff, volume)
+        << " Ha per unit charge; about " << static_cast<int>(volume * LR_kc * LR_kc * LR_kc / (6 * M_PI * M_PI))
+        << " k-vectors" << std::endl;
+  }
+
   void printCutoffs(std::ostream& out)
   {
     out << "  Long-range breakup parameters:" << std::endl;
@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include <string>
+#include <sstream>
 
 #include "catch.hpp"
 
@@ -46,4 +47,32 @@ TEST_CASE("LRBreakupParameters", "[lattice]")
   REQUIRE(myLR.LR_kc == Approx(15.0));
 }
 
+TEST_CASE("LRBreakupParameters tuneLRCutoffs", "[lattice]")
+{
+  LRBreakupParameters<double, 3> myLR;
+
+  TinyVector<TinyVector<double, 3>, 3> R;
+  R[0][0]             = 3.8;
+  R[1][1]             = 3.8;
+  R[2][2]             = 3.8;
+  const double volume = 3.8 * 3.8 * 3.8;
+  myLR.SetLRCutoffs(R);
+  REQUIRE(myLR.LR_rc == Approx(1.9));
+
+  CHECK(myLR.estimateLRError(20.0, volume) < myLR.estimateLRError(15.0, volume));
+
+  std::ostringstream log;
+  myLR.tuneLRCutoffs(volume, log);
+  // the smallest cutoff on the 0.5 steps within the tolerance
+  CHECK(myLR.LR_dim_cutoff == Approx(10.0));
+  CHECK(myLR.estimateLRError(myLR.LR_dim_cutoff, volume) <= myLR.LR_tol);
+  CHECK(myLR.estimateLRError(myLR.LR_dim_cutoff - 0.5, volume) > myLR.LR_tol);
+  CHECK(myLR.LR_kc == Approx(myLR.LR_dim_cutoff / 1.9));
+
+  myLR.LR_tol = 1e-8;
+  myLR.tuneLRCutoffs(volume, log);
+  CHECK(myLR.LR_dim_cutoff > 20.0);
+  CHECK(myLR.estimateLRError(myLR.LR_dim_cutoff, volume) <= myLR.LR_tol);
+}
+
 } // namespace qmcplusplus
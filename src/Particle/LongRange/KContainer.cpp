@@ -15,7 +15,7 @@
 #include "Message/Communicate.h"
 #include "KContainer.h"
 #include "Utilities/qmc_common.h"
-#include <map>
+#include <algorithm>
 
 namespace qmcplusplus
 {
@@ -101,20 +101,19 @@ void KContainer::FindApproxMMax(const ParticleLayout& lattice)
 void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
 {
   TinyVector<int, DIM + 1> TempActualMax;
-  TinyVector<int, DIM> kvec;
-  TinyVector<RealType, DIM> kvec_cart;
-  RealType modk2;
   std::vector<TinyVector<int, DIM>> kpts_tmp;
-  std::vector<PosType> kpts_cart_tmp;
-  std::vector<RealType> ksq_tmp;
-  // reserve the space for memory efficiency
 #if OHMMS_DIM == 3
   if (useSphere)
   {
     //Loop over guesses for valid k-points.
-    for (int i = -mmax[0]; i <= mmax[0]; i++)
+    //Each slab of the first index is searched by a thread and the slabs are joined in order.
+    const int nslab = 2 * mmax[0] + 1;
+    std::vector<std::vector<TinyVector<int, DIM>>> kpts_slab(nslab);
+#pragma omp parallel for schedule(dynamic)
+    for (int islab = 0; islab < nslab; islab++)
     {
-      kvec[0] = i;
+      TinyVector<int, DIM> kvec;
+      kvec[0] = islab - mmax[0];
       for (int j = -mmax[1]; j <= mmax[1]; j++)
       {
         kvec[1] = j;
@@ -122,25 +121,29 @@ void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
         {
           kvec[2] = k;
           //Do not include k=0 in evaluations.
-          if (i == 0 && j == 0 && k == 0)
+          if (kvec[0] == 0 && j == 0 && k == 0)
             continue;
-          //Convert kvec to Cartesian
-          kvec_cart = lattice.k_cart(kvec);
-          //Find modk
-          modk2 = dot(kvec_cart, kvec_cart);
-          if (modk2 > kcut2)
-            continue; //Inside cutoff?
-          //This k-point should be added to the list
-          kpts_tmp.push_back(kvec);
-          kpts_cart_tmp.push_back(kvec_cart);
-          ksq_tmp.push_back(modk2);
-          //Update record of the allowed maximum translation.
-          for (int idim = 0; idim < 3; idim++)
-            if (std::abs(kvec[idim]) > TempActualMax[idim])
-              TempActualMax[idim] = std::abs(kvec[idim]);
+          //Inside cutoff?
+          const TinyVector<RealType, DIM> kvec_cart = lattice.k_cart(kvec);
+          if (dot(kvec_cart, kvec_cart) > kcut2)
+            continue;
+          kpts_slab[islab].push_back(kvec);
         }
       }
     }
+    size_t nk_found = 0;
+    for (const auto& slab : kpts_slab)
+      nk_found += slab.size();
+    kpts_tmp.reserve(nk_found);
+    for (auto& slab : kpts_slab)
+    {
+      kpts_tmp.insert(kpts_tmp.end(), slab.begin(), slab.end());
+      std::vector<TinyVector<int, DIM>>().swap(slab);
+    }
+    //Update record of the allowed maximum translation.
+    for (const auto& kvec : kpts_tmp)
+      for (int idim = 0; idim < DIM; idim++)
+        TempActualMax[idim] = std::max(TempActualMax[idim], std::abs(kvec[idim]));
   }
   else
   {
@@ -151,6 +154,8 @@ void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
     const int idimsize = mmax[0] * 2;
     const int jdimsize = mmax[1] * 2;
     const int kdimsize = mmax[2] * 2;
+    TinyVector<int, DIM> kvec;
+    kpts_tmp.reserve(idimsize * jdimsize * kdimsize);
     for (int i = 0; i < idimsize; i++)
     {
       kvec[0] = i;
@@ -166,13 +171,8 @@ void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
           kvec[2] = k;
           if (kvec[2] > mmax[2])
             kvec[2] -= kdimsize;
-          // get cartesian location and modk2
-          kvec_cart = lattice.k_cart(kvec);
-          modk2     = dot(kvec_cart, kvec_cart);
           // add k-point to lists
           kpts_tmp.push_back(kvec);
-          kpts_cart_tmp.push_back(kvec_cart);
-          ksq_tmp.push_back(modk2);
         }
       }
     }
@@ -182,6 +182,7 @@ void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
     TempActualMax[2] = mmax[2];
   }
 #elif OHMMS_DIM == 2
+  TinyVector<int, DIM> kvec;
   if (useSphere)
   {
     //Loop over guesses for valid k-points.
@@ -194,18 +195,14 @@ void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
         //Do not include k=0 in evaluations.
         if (i == 0 && j == 0)
           continue;
-        //Convert kvec to Cartesian
-        kvec_cart = lattice.k_cart(kvec);
-        //Find modk
-        modk2 = dot(kvec_cart, kvec_cart);
-        if (modk2 > kcut2)
-          continue; //Inside cutoff?
+        //Inside cutoff?
+        const TinyVector<RealType, DIM> kvec_cart = lattice.k_cart(kvec);
+        if (dot(kvec_cart, kvec_cart) > kcut2)
+          continue;
         //This k-point should be added to the list
         kpts_tmp.push_back(kvec);
-        kpts_cart_tmp.push_back(kvec_cart);
-        ksq_tmp.push_back(modk2);
         //Update record of the allowed maximum translation.
-        for (int idim = 0; idim < 3; idim++)
+        for (int idim = 0; idim < DIM; idim++)
           if (std::abs(kvec[idim]) > TempActualMax[idim])
             TempActualMax[idim] = std::abs(kvec[idim]);
       }
@@ -229,13 +226,8 @@ void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
         kvec[1] = j;
         if (kvec[1] > mmax[1])
           kvec[1] -= jdimsize;
-        // get cartesian location and modk2
-        kvec_cart = lattice.k_cart(kvec);
-        modk2     = dot(kvec_cart, kvec_cart);
         // add k-point to lists
         kpts_tmp.push_back(kvec);
-        kpts_cart_tmp.push_back(kvec_cart);
-        ksq_tmp.push_back(modk2);
       }
     }
     // set allowed maximum translation
@@ -249,58 +241,43 @@ void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
 #endif
   //Update a record of the number of k vectors
   numk = kpts_tmp.size();
-  std::map<long long, std::vector<int>*> kpts_sorted;
-  //create the map: use simple integer with resolution of 0.00000001 in ksq
+
+  //Sort the k-points into shells by an integer key of |k|^2.
+  //The sort is stable so that the k-points of a shell keep the order of the search.
+  std::vector<long long> shell_key(numk);
+  std::vector<int> order(numk);
+#pragma omp parallel for
   for (int ik = 0; ik < numk; ik++)
   {
+    const PosType kvec_cart = lattice.k_cart(kpts_tmp[ik]);
 #ifdef MIXED_PRECISION
-    long long k_ind = static_cast<long long>(ksq_tmp[ik] * 1000);
+    shell_key[ik] = static_cast<long long>(dot(kvec_cart, kvec_cart) * 1000);
 #else
     //This is a workaround for ewald bug (Issue #2105) for FULL PRECISION ONLY.  Basically, 1e-7 is the resolution of |k|^2 for doubles,
     //so we jack up the tolerance to match that.
-    long long k_ind = static_cast<long long>(ksq_tmp[ik] * 10000000);
+    shell_key[ik] = static_cast<long long>(dot(kvec_cart, kvec_cart) * 10000000);
 #endif
-    std::map<long long, std::vector<int>*>::iterator it(kpts_sorted.find(k_ind));
-    if (it == kpts_sorted.end())
-    {
-      std::vector<int>* newSet = new std::vector<int>;
-      kpts_sorted[k_ind]       = newSet;
-      newSet->push_back(ik);
-    }
-    else
-    {
-      (*it).second->push_back(ik);
-    }
+    order[ik] = ik;
   }
-  std::map<long long, std::vector<int>*>::iterator it(kpts_sorted.begin());
+  std::stable_sort(order.begin(), order.end(), [&shell_key](int a, int b) { return shell_key[a] < shell_key[b]; });
+
   kpts.resize(numk);
   kpts_cart.resize(numk);
   ksq.resize(numk);
-  kshell.resize(kpts_sorted.size() + 1, 0);
-  int ok = 0, ish = 0;
-  while (it != kpts_sorted.end())
-  {
-    std::vector<int>::iterator vit((*it).second->begin());
-    while (vit != (*it).second->end())
-    {
-      int ik        = (*vit);
-      kpts[ok]      = kpts_tmp[ik];
-      kpts_cart[ok] = kpts_cart_tmp[ik];
-      ksq[ok]       = ksq_tmp[ik];
-      ++vit;
-      ++ok;
-    }
-    kshell[ish + 1] = kshell[ish] + (*it).second->size();
-    ++it;
-    ++ish;
-  }
-  it = kpts_sorted.begin();
-  std::map<long long, std::vector<int>*>::iterator e_it(kpts_sorted.end());
-  while (it != e_it)
+#pragma omp parallel for
+  for (int ok = 0; ok < numk; ok++)
   {
-    delete it->second;
-    it++;
+    kpts[ok]      = kpts_tmp[order[ok]];
+    kpts_cart[ok] = lattice.k_cart(kpts[ok]);
+    ksq[ok]       = dot(kpts_cart[ok], kpts_cart[ok]);
   }
+  std::vector<TinyVector<int, DIM>>().swap(kpts_tmp);
+
+  kshell.assign(1, 0);
+  for (int ok = 1; ok <= numk; ok++)
+    if (ok == numk || shell_key[order[ok]] != shell_key[order[ok - 1]])
+      kshell.push_back(ok);
+
   //Finished searching k-points. Copy list of maximum translations.
   mmax[DIM] = 0;
   for (int idim = 0; idim < DIM; idim++)
@@ -309,27 +286,56 @@ void KContainer::BuildKLists(const ParticleLayout& lattice, bool useSphere)
     mmax[DIM]  = std::max(mmax[idim], mmax[DIM]);
     //if(mmax[idim] > mmax[DIM]) mmax[DIM] = mmax[idim];
   }
-  //Now fill the array that returns the index of -k when given the index of k.
-  minusk.resize(numk);
 
-  //Assigns a unique hash value to each kpoint.
-  auto getHashOfVec = [](const auto& inpv, int hashparam) -> long long {
-    long long hash = 0; // this will cause integral promotion below
-    for (int i = 0; i < inpv.Size; ++i)
-      hash += inpv[i] + hash * hashparam;
-    return hash;
+  //Now fill the array that returns the index of -k when given the index of k.
+  //The index of each integer translation within [-mmax, mmax] is stored on a dense grid.
+  TinyVector<int, DIM> grid_size, grid_stride;
+  size_t grid_total = 1;
+  for (int idim = DIM - 1; idim >= 0; idim--)
+  {
+    grid_size[idim]   = 2 * mmax[idim] + 1;
+    grid_stride[idim] = grid_total;
+    grid_total *= grid_size[idim];
+  }
+  auto gridIndex = [&](const TinyVector<int, DIM>& kvec) {
+    size_t g = 0;
+    for (int idim = 0; idim < DIM; idim++)
+      g += (kvec[idim] + mmax[idim]) * grid_stride[idim];
+    return g;
   };
+  std::vector<int> grid_to_index(grid_total, -1);
+#pragma omp parallel for
+  for (int ki = 0; ki < numk; ki++)
+    grid_to_index[gridIndex(kpts[ki])] = ki;
 
-  // Create a map from the hash value for each k vector to the index
-  std::map<long long, int> hashToIndex;
+  minusk.resize(numk);
+  bool inversion_symmetric = true;
+#pragma omp parallel for reduction(&& : inversion_symmetric)
   for (int ki = 0; ki < numk; ki++)
   {
-    hashToIndex[getHashOfVec(kpts[ki], numk)] = ki;
+    const TinyVector<int, DIM> mkvec = -1 * kpts[ki];
+    bool found                       = true;
+    for (int idim = 0; idim < DIM; idim++)
+      found = found && std::abs(mkvec[idim]) <= mmax[idim];
+    const int mki = found ? grid_to_index[gridIndex(mkvec)] : -1;
+    // -k is missing in the parallelpiped used for FFT
+    inversion_symmetric = inversion_symmetric && mki >= 0;
+    minusk[ki]          = mki >= 0 ? mki : 0;
   }
-  // Use the map to find the index of -k from the index of k
-  for (int ki = 0; ki < numk; ki++)
+
+  //Keep one k of each (k, -k) pair if every -k is in the list
+  kpts_half.clear();
+  kpts_cart_half.clear();
+  if (inversion_symmetric)
   {
-    minusk[ki] = hashToIndex[getHashOfVec(-1 * kpts[ki], numk)];
+    kpts_half.reserve(numk / 2);
+    kpts_cart_half.reserve(numk / 2);
+    for (int ki = 0; ki < numk; ki++)
+      if (ki < minusk[ki])
+      {
+        kpts_half.push_back(ki);
+        kpts_cart_half.push_back(kpts_cart[ki]);
+      }
   }
 }
 
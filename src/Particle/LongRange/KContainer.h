@@ -60,6 +60,15 @@ public:
   std::vector<int> minusk;
   /** kpts which belong to the ith-shell [kshell[i], kshell[i+1]) */
   std::vector<int> kshell;
+  /** Index of one k of each (k, -k) pair, ki < minusk[ki]
+   *
+   * Only filled if -k of every k is in the list, i.e. the k-points are inside a sphere.
+   * Quantities odd or even under inversion, like e^{ik.r}, can be computed on this half of the k-points.
+   */
+  std::vector<int> kpts_half;
+  /** K-vector of kpts_half in Cartesian coordinates
+   */
+  std::vector<PosType> kpts_cart_half;
 
   /** k points sorted by the |k|  excluding |k|=0
    *
@@ -92,8 +92,9 @@ struct LRBreakup
         cnk(n, ki)  = Basis.c(n, k);
       }
     }
-    // Now, fill in A and b
+    // Now, fill in A and b, each thread owns the rows l
     A = 0.0;
+#pragma omp parallel for
     for (int l = 0; l < numElem; l++)
     {
       for (int ki = 0; ki < KList.size(); ki++)
@@ -207,6 +208,7 @@ struct LRBreakup
     b.resize(numElem, 0.0);
     cnk.resize(numElem, KList.size());
     // Fill in cnk.
+#pragma omp parallel for shared(cnk)
     for (int n = 0; n < numElem; n++)
     {
       for (int ki = 0; ki < KList.size(); ki++)
@@ -215,9 +217,10 @@ struct LRBreakup
         cnk(n, ki)  = Basis.c(n, k);
       }
     }
-    // Now, fill in A and b
+    // Now, fill in A and b, each thread owns the rows l
 
     A = 0.0;
+#pragma omp parallel for
     for (int l = 0; l < numElem; l++)
     {
       for (int ki = 0; ki < KList.size(); ki++)
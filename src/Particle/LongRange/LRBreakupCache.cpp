@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "LRBreakupCache.h"
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "hdf/hdf_archive.h"
+#include "Platforms/Host/OutputManager.h"
+
+namespace qmcplusplus
+{
+std::string LRBreakupKey::hash() const
+{
+  // 64-bit FNV-1a over the kernel name and the bytes of the parameters
+  std::uint64_t h = 14695981039346656037ULL;
+  auto add_bytes  = [&h](const unsigned char* bytes, size_t n) {
+    for (size_t i = 0; i < n; i++)
+    {
+      h ^= bytes[i];
+      h *= 1099511628211ULL;
+    }
+  };
+  add_bytes(reinterpret_cast<const unsigned char*>(kernel.data()), kernel.size());
+  add_bytes(reinterpret_cast<const unsigned char*>(params.data()), params.size() * sizeof(mRealType));
+
+  std::ostringstream os;
+  os << "breakup_" << std::hex << std::setw(16) << std::setfill('0') << h;
+  return os.str();
+}
+
+bool readLRBreakupCache(const std::string& fname,
+                        const LRBreakupKey& key,
+                        std::vector<LRBreakupKey::mRealType>& coefs,
+                        LRBreakupKey::mRealType& chisqr,
+                        int& max_kshell)
+{
+  if (!std::ifstream(fname).good())
+    return false;
+
+  hdf_archive hin;
+  if (!hin.open(fname, H5F_ACC_RDONLY))
+    return false;
+
+  const std::string group = key.hash();
+  if (!hin.is_group(group))
+    return false;
+
+  hin.push(group, false);
+  std::string kernel;
+  std::vector<LRBreakupKey::mRealType> params;
+  bool found = hin.readEntry(kernel, "kernel") && hin.readEntry(params, "params");
+  // guard against hash collisions
+  found = found && kernel == key.kernel && params == key.params;
+  found = found && hin.readEntry(coefs, "coefs") && hin.readEntry(chisqr, "chisqr") &&
+      hin.readEntry(max_kshell, "max_kshell");
+  hin.pop();
+  hin.close();
+  if (found)
+    app_log() << "  Read the LR breakup " << group << " from " << fname << std::endl;
+  return found;
+}
+
+void writeLRBreakupCache(const std::string& fname,
+                         const LRBreakupKey& key,
+                         const std::vector<LRBreakupKey::mRealType>& coefs,
+                         LRBreakupKey::mRealType chisqr,
+                         int max_kshell)
+{
+  hdf_archive hout;
+  const bool exists = std::ifstream(fname).good();
+  if (!(exists ? hout.open(fname, H5F_ACC_RDWR) : hout.create(fname)))
+  {
+    app_warning() << "Could not write the LR breakup cache " << fname << std::endl;
+    return;
+  }
+
+  const std::string group = key.hash();
+  if (hout.is_group(group))
+    return;
+
+  hout.push(group, true);
+  std::string kernel(key.kernel);
+  std::vector<LRBreakupKey::mRealType> params(key.params);
+  std::vector<LRBreakupKey::mRealType> coefs_out(coefs);
+  hout.write(kernel, "kernel");
+  hout.write(params, "params");
+  hout.write(coefs_out, "coefs");
+  hout.write(chisqr, "chisqr");
+  hout.write(max_kshell, "max_kshell");
+  hout.pop();
+  hout.close();
+  app_log() << "  Saved the LR breakup " << group << " to " << fname << std::endl;
+}
+} // namespace qmcplusplus
@@ -0,0 +1,63 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file LRBreakupCache.h
+ * @brief HDF5 cache of the optimized long-range breakup coefficients
+ */
+#ifndef QMCPLUSPLUS_LRBREAKUPCACHE_H
+#define QMCPLUSPLUS_LRBREAKUPCACHE_H
+
+#include <string>
+#include <vector>
+#include "coulomb_types.h"
+
+namespace qmcplusplus
+{
+/** everything an optimized breakup fit depends on
+ *
+ * The cached fit is reused only if the kernel name and all the parameters match exactly.
+ */
+struct LRBreakupKey
+{
+  using mRealType = OHMMS_PRECISION_FULL;
+
+  /// name of the kernel functor
+  std::string kernel;
+  /// lattice vectors, cutoffs, basis size and samples of the kernel X_k
+  std::vector<mRealType> params;
+
+  /// hash of kernel and params in hexadecimal, names the HDF5 group of the fit
+  std::string hash() const;
+};
+
+/** read a breakup fit from the cache file
+ * @param fname cache file
+ * @param key identifies the fit
+ * @param coefs returns the breakup coefficients
+ * @param chisqr returns chi^2 of the fit
+ * @param max_kshell returns the number of exact k-shells below kc
+ * @return false if the file or the fit does not exist
+ */
+bool readLRBreakupCache(const std::string& fname,
+                        const LRBreakupKey& key,
+                        std::vector<LRBreakupKey::mRealType>& coefs,
+                        LRBreakupKey::mRealType& chisqr,
+                        int& max_kshell);
+
+/// add a breakup fit to the cache file, the file is created if needed
+void writeLRBreakupCache(const std::string& fname,
+                         const LRBreakupKey& key,
+                         const std::vector<LRBreakupKey::mRealType>& coefs,
+                         LRBreakupKey::mRealType chisqr,
+                         int max_kshell);
+} // namespace qmcplusplus
+#endif
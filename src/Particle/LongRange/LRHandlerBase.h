@@ -91,6 +91,56 @@ struct LRHandlerBase
     return vk;
   }
 
+  /** expand Fk_symm to \f$F_{k}\f$ of every vector in the shells used by evaluate
+   * @param kshell degeneracies of the vectors
+   * @param fk resized to the number of vectors kshell[MaxKshell]
+   */
+  inline void getFkPerVector(const std::vector<int>& kshell, Vector<mRealType>& fk) const
+  {
+    fk.resize(kshell[MaxKshell]);
+    for (int ks = 0, ki = 0; ks < MaxKshell; ks++)
+      for (; ki < kshell[ks + 1]; ki++)
+        fk[ki] = Fk_symm[ks];
+  }
+
+  /** evaluate \f$\sum_k F_{k} \Re(\rho_{\bf k} e^{-i{\bf k}\cdot{\bf r}})\f$, the long-range potential of a density at r
+   * @param kpts_cart Cartesian k-vectors
+   * @param fk \f$F_{k}\f$ of every vector, see getFkPerVector
+   * @param rk_r starting address of \f$\Re \rho_{\bf k}\f$
+   * @param rk_i starting address of \f$\Im \rho_{\bf k}\f$
+   * @param r position
+   */
+  template<typename PT>
+  static mRealType evaluateAt(const std::vector<PT>& kpts_cart,
+                              const Vector<mRealType>& fk,
+                              const pRealType* restrict rk_r,
+                              const pRealType* restrict rk_i,
+                              const PT& r)
+  {
+    mRealType vk = 0.0;
+    for (int ki = 0; ki < fk.size(); ki++)
+    {
+      const mRealType kr = dot(kpts_cart[ki], r);
+      vk += fk[ki] * (rk_r[ki] * std::cos(kr) + rk_i[ki] * std::sin(kr));
+    }
+    return vk;
+  }
+
+  template<typename PT>
+  static mRealType evaluateAt(const std::vector<PT>& kpts_cart,
+                              const Vector<mRealType>& fk,
+                              const pComplexType* restrict rk,
+                              const PT& r)
+  {
+    mRealType vk = 0.0;
+    for (int ki = 0; ki < fk.size(); ki++)
+    {
+      const mRealType kr = dot(kpts_cart[ki], r);
+      vk += fk[ki] * (rk[ki].real() * std::cos(kr) + rk[ki].imag() * std::sin(kr));
+    }
+    return vk;
+  }
+
   inline mRealType evaluate_w_sk(const std::vector<int>& kshell, const pRealType* restrict sk) const
   {
     mRealType vk = 0.0;
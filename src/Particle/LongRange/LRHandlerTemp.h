@@ -24,6 +24,9 @@
 #include "LongRange/LRHandlerBase.h"
 #include "LongRange/LPQHIBasis.h"
 #include "LongRange/LRBreakup.h"
+#include "LongRange/LRBreakupCache.h"
+#include "Message/Communicate.h"
+#include <typeinfo>
 #include "OhmmsPETE/OhmmsMatrix.h"
 
 namespace qmcplusplus
@@ -226,7 +229,6 @@ private:
     mRealType kcut = 60 * M_PI * std::pow(Basis.get_CellVolume(), -1.0 / 3.0);
     //Use 3000/LMax here...==6000/rc for non-ortho cells
     mRealType kmax(6000.0 / ref.LR_rc);
-    MaxKshell = static_cast<int>(breakuphandler.SetupKVecs(kc, kcut, kmax));
     if (FirstTime)
     {
       app_log() << " finding kc:  " << ref.LR_kc << " , " << LR_kc << std::endl;
@@ -234,17 +236,29 @@ private:
       app_log() << "    Continuum approximation in k = [" << kcut << "," << kmax << ")" << std::endl;
       FirstTime = false;
     }
-    //Set up x_k
-    //This is the FT of -V(r) from r_c to infinity.
-    //This is the only data that the breakup handler needs to do the breakup.
-    //We temporarily store it in Fk, which is replaced with the full FT (0->inf)
-    //of V_l(r) after the breakup has been done.
-    fillXk(breakuphandler.KList);
-    //Allocate the space for the coefficients.
-    coefs.resize(Basis.NumBasisElem()); //This must be after SetupKVecs.
 
     mRealType chisqr(0.0);
-    chisqr = breakuphandler.DoBreakup(Fk.data(), coefs.data()); //Fill array of coefficients.
+    LRBreakupKey key;
+    const bool use_cache = !ref.LR_breakup_cache.empty();
+    if (use_cache)
+      key = makeBreakupKey(ref, NumKnots, kc, kcut, kmax);
+    if (!use_cache || !readLRBreakupCache(ref.LR_breakup_cache, key, coefs, chisqr, MaxKshell))
+    {
+      MaxKshell = static_cast<int>(breakuphandler.SetupKVecs(kc, kcut, kmax));
+      //Set up x_k
+      //This is the FT of -V(r) from r_c to infinity.
+      //This is the only data that the breakup handler needs to do the breakup.
+      //We temporarily store it in Fk, which is replaced with the full FT (0->inf)
+      //of V_l(r) after the breakup has been done.
+      fillXk(breakuphandler.KList);
+      //Allocate the space for the coefficients.
+      coefs.resize(Basis.NumBasisElem()); //This must be after SetupKVecs.
+
+      chisqr = breakuphandler.DoBreakup(Fk.data(), coefs.data()); //Fill array of coefficients.
+      // every rank does the same fit, one of them saves it
+      if (use_cache && OHMMS::Controller->rank() == 0)
+        writeLRBreakupCache(ref.LR_breakup_cache, key, coefs, chisqr, MaxKshell);
+    }
     //I want this in scientific notation, but I don't want to mess up formatting flags elsewhere.
     //Save stream state.
     std::ios_base::fmtflags app_log_flags(app_log().flags());
@@ -255,6 +269,30 @@ private:
     app_log().flags(app_log_flags);
   }
 
+  /** the inputs of the breakup fit
+   *
+   * The kernel is identified by the types of Func and BreakupBasis and by X_k sampled over the fitted k range,
+   * which also catches the parameters of the kernel, e.g. rs.
+   */
+  LRBreakupKey makeBreakupKey(const ParticleLayout& ref, int nknots, mRealType kc, mRealType kcut, mRealType kmax) const
+  {
+    LRBreakupKey key;
+    key.kernel = std::string(typeid(Func).name()) + ":" + typeid(BreakupBasis).name();
+    for (int i = 0; i < OHMMS_DIM; i++)
+      for (int j = 0; j < OHMMS_DIM; j++)
+        key.params.push_back(ref.R(i, j));
+    key.params.push_back(ref.LR_rc);
+    key.params.push_back(kc);
+    key.params.push_back(kcut);
+    key.params.push_back(kmax);
+    key.params.push_back(nknots);
+    key.params.push_back(Basis.NumBasisElem());
+    constexpr int nsamples = 16;
+    for (int i = 0; i < nsamples; i++)
+      key.params.push_back(myFunc.Xk(kc + (kmax - kc) * i / nsamples, Basis.get_rc()));
+    return key;
+  }
+
   void fillXk(std::vector<TinyVector<mRealType, 2>>& KList)
   {
     Fk.resize(KList.size());
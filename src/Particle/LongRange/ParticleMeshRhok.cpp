@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "ParticleMeshRhok.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <fftw3.h>
+#include "Particle/ParticleSet.h"
+#include "LongRange/KContainer.h"
+
+namespace qmcplusplus
+{
+/// FFTW planner is not thread-safe
+static std::mutex fftw_planner_mutex;
+
+struct ParticleMeshRhok::FFTPlan
+{
+  fftw_plan plan;
+
+  FFTPlan(const TinyVector<int, OHMMS_DIM>& mesh_size, std::complex<double>* mesh)
+  {
+    std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+    auto* data = reinterpret_cast<fftw_complex*>(mesh);
+    plan       = fftw_plan_dft(OHMMS_DIM, mesh_size.data(), data, data, FFTW_BACKWARD, FFTW_ESTIMATE);
+  }
+
+  ~FFTPlan()
+  {
+    std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+    fftw_destroy_plan(plan);
+  }
+};
+
+/// the smallest size no less than nmin with prime factors 2, 3 and 5 only
+static int getFFTFriendlySize(int nmin)
+{
+  for (int n = nmin;; n++)
+  {
+    int m = n;
+    for (int f : {2, 3, 5})
+      while (m % f == 0)
+        m /= f;
+    if (m == 1)
+      return n;
+  }
+}
+
+ParticleMeshRhok::ParticleMeshRhok(const KContainer& k_lists, int order, int oversampling)
+    : k_lists_(k_lists), order_(order)
+{
+  if (OHMMS_DIM != 3)
+    throw std::runtime_error("ParticleMeshRhok is only implemented in 3D.");
+  if (order_ < 2 || order_ % 2 != 0)
+    throw std::runtime_error("ParticleMeshRhok the B-spline order must be even and positive.");
+  if (oversampling < 1)
+    throw std::runtime_error("ParticleMeshRhok the oversampling must be positive.");
+
+  TinyVector<int, OHMMS_DIM> hmax(0);
+  for (const auto& kpt : k_lists_.kpts)
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      hmax[idim] = std::max(hmax[idim], std::abs(kpt[idim]));
+
+  // knots[j] = M_n(order-1-j) at the integers
+  std::vector<double> knots(order_);
+  computeBsplineWeights(0.0, knots);
+
+  size_t mesh_total = 1;
+  for (int idim = 0; idim < OHMMS_DIM; idim++)
+  {
+    const int nmesh   = getFFTFriendlySize(std::max(2 * order_, oversampling * (2 * hmax[idim] + 1)));
+    mesh_size_[idim]  = nmesh;
+    mesh_total       *= nmesh;
+    auto& factors     = bspline_factors_[idim];
+    factors.resize(nmesh);
+    for (int m = 0; m < nmesh; m++)
+    {
+      std::complex<double> denom(0);
+      for (int k = 0; k < order_ - 1; k++)
+        denom += knots[order_ - 2 - k] * std::polar(1.0, 2 * M_PI * m * k / nmesh);
+      factors[m] = std::polar(1.0, 2 * M_PI * (order_ - 1) * m / nmesh) / denom;
+    }
+    weights_[idim].resize(order_);
+  }
+
+  mesh_.resize(mesh_total);
+  fft_plan_ = std::make_shared<const FFTPlan>(mesh_size_, mesh_.data());
+}
+
+void ParticleMeshRhok::computeBsplineWeights(double w, std::vector<double>& weights) const
+{
+  // recursion of the cardinal B-splines, Essmann et al. Eq. (4.1)
+  weights[order_ - 1] = 0.0;
+  weights[1]          = w;
+  weights[0]          = 1.0 - w;
+  for (int k = 3; k <= order_; k++)
+  {
+    const double div = 1.0 / (k - 1);
+    weights[k - 1]   = div * w * weights[k - 2];
+    for (int j = 1; j <= k - 2; j++)
+      weights[k - j - 1] = div * ((w + j) * weights[k - j - 2] + (k - j - w) * weights[k - j - 1]);
+    weights[0] = div * (1.0 - w) * weights[0];
+  }
+}
+
+void ParticleMeshRhok::computeRhok(const ParticleSet& P, Matrix<RealType>& rhok_r, Matrix<RealType>& rhok_i)
+{
+  const auto& lattice = P.getLRBox();
+  const int n0        = mesh_size_[0];
+  const int n1        = mesh_size_[1];
+  const int n2        = mesh_size_[2];
+  const int nk        = k_lists_.numk;
+  auto* restrict mesh = mesh_.data();
+
+  for (int ig = 0; ig < P.groups(); ig++)
+  {
+    std::fill(mesh_.begin(), mesh_.end(), std::complex<double>(0));
+    for (int iat = 0; iat < P.getTotalNum(); iat++)
+    {
+      if (P.getGroupID(iat) != ig)
+        continue;
+      // the first mesh point covered by the B-splines of this particle
+      TinyVector<int, OHMMS_DIM> m0;
+      const auto s = lattice.toUnit(P.R[iat]);
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+      {
+        const double u     = (s[idim] - std::floor(s[idim])) * mesh_size_[idim];
+        const double u_int = std::floor(u);
+        computeBsplineWeights(u - u_int, weights_[idim]);
+        m0[idim] = static_cast<int>(u_int) - order_ + 1 + mesh_size_[idim];
+      }
+
+      for (int j0 = 0; j0 < order_; j0++)
+      {
+        const int i0    = (m0[0] + j0) % n0;
+        const double w0 = weights_[0][j0];
+        for (int j1 = 0; j1 < order_; j1++)
+        {
+          const int i1                      = (m0[1] + j1) % n1;
+          const double w01                  = w0 * weights_[1][j1];
+          std::complex<double>* restrict row = mesh + (i0 * n1 + i1) * n2;
+          for (int j2 = 0; j2 < order_; j2++)
+            row[(m0[2] + j2) % n2] += w01 * weights_[2][j2];
+        }
+      }
+    }
+
+    fftw_execute_dft(fft_plan_->plan, reinterpret_cast<fftw_complex*>(mesh), reinterpret_cast<fftw_complex*>(mesh));
+
+    auto* restrict rhok_r_ptr = rhok_r[ig];
+    auto* restrict rhok_i_ptr = rhok_i[ig];
+    for (int ki = 0; ki < nk; ki++)
+    {
+      const auto& h = k_lists_.kpts[ki];
+      const int m0  = h[0] < 0 ? h[0] + n0 : h[0];
+      const int m1  = h[1] < 0 ? h[1] + n1 : h[1];
+      const int m2  = h[2] < 0 ? h[2] + n2 : h[2];
+      const std::complex<double> rhok =
+          mesh[(m0 * n1 + m1) * n2 + m2] * bspline_factors_[0][m0] * bspline_factors_[1][m1] * bspline_factors_[2][m2];
+      rhok_r_ptr[ki] = rhok.real();
+      rhok_i_ptr[ki] = rhok.imag();
+    }
+  }
+}
+
+} // namespace qmcplusplus
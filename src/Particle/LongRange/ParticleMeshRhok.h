@@ -0,0 +1,84 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_PARTICLEMESHRHOK_H
+#define QMCPLUSPLUS_PARTICLEMESHRHOK_H
+
+#include <array>
+#include <complex>
+#include <memory>
+#include <vector>
+#include "Configuration.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "CPU/SIMD/aligned_allocator.hpp"
+
+namespace qmcplusplus
+{
+class ParticleSet;
+class KContainer;
+
+/** @ingroup longrange
+ *\brief Calculates rhok per species with smooth particle-mesh Ewald interpolation
+ *
+ * Essmann et al., J. Chem. Phys. 103, 8577 (1995).
+ * The particles of each species are spread onto a periodic mesh with cardinal B-splines
+ * and the mesh is Fourier transformed. rhok of each k-vector is the mesh transform
+ * divided by the structure factor of the B-splines. The cost is O(N order^3 + M log M)
+ * for M mesh points instead of O(N N_k) of the direct sum.
+ */
+class ParticleMeshRhok : public QMCTraits
+{
+public:
+  /** constructor
+   * @param k_lists k-vectors in the reciprocal vectors of the long-range box
+   * @param order order of the B-splines, even
+   * @param oversampling ratio between the mesh size and the number of k-vectors along each direction
+   */
+  ParticleMeshRhok(const KContainer& k_lists, int order = 6, int oversampling = 2);
+
+  /** compute rhok of all the species
+   * @param P particle set, positions are taken in the long-range box
+   * @param rhok_r real part, [species][k]
+   * @param rhok_i imaginary part, [species][k]
+   */
+  void computeRhok(const ParticleSet& P, Matrix<RealType>& rhok_r, Matrix<RealType>& rhok_i);
+
+  /// mesh points along each reciprocal vector
+  const TinyVector<int, OHMMS_DIM>& getMeshSize() const { return mesh_size_; }
+
+private:
+  struct FFTPlan;
+
+  /// K-Vector List.
+  const KContainer& k_lists_;
+  /// order of the B-splines
+  const int order_;
+  /// number of mesh points along each reciprocal vector
+  TinyVector<int, OHMMS_DIM> mesh_size_;
+  /// b(m) of the B-splines along each direction, indexed by the mesh frequency
+  std::array<std::vector<std::complex<double>>, OHMMS_DIM> bspline_factors_;
+  /// charge mesh of one species, transformed in place
+  aligned_vector<std::complex<double>> mesh_;
+  /// B-spline weights of a particle along each direction
+  std::array<std::vector<double>, OHMMS_DIM> weights_;
+  /// in-place backward transform of mesh_, shared by the copies
+  std::shared_ptr<const FFTPlan> fft_plan_;
+
+  /** compute the B-spline weights M_n(w+order-1-j), j in [0,order)
+   * @param w fractional part of the scaled coordinate
+   * @param weights output
+   */
+  void computeBsplineWeights(double w, std::vector<double>& weights) const;
+};
+} // namespace qmcplusplus
+
+#endif
@@ -29,6 +29,7 @@ StructFact::StructFact(int nptcls, int ns, const ParticleLayout& lattice, const
       num_ptcls(nptcls),
       num_species(ns),
       StorePerParticle(false),
+      num_rhok_updates_(0),
       update_all_timer_(*timer_manager.createTimer("StructFact::update_all_part", timer_level_fine))
 {
   if (qmc_common.use_ewald && lattice.SuperCellEnum == SUPERCELL_SLAB)
@@ -56,6 +57,8 @@ void StructFact::resize(int nkpts)
   }
   eikr_r_temp.resize(nkpts);
   eikr_i_temp.resize(nkpts);
+  eikr_r_half_.resize(k_lists_.kpts_half.size());
+  eikr_i_half_.resize(k_lists_.kpts_half.size());
 #else
   rhok.resize(num_species, nkpts);
   eikr.resize(num_ptcls, nkpts);
@@ -67,7 +70,7 @@ void StructFact::resize(int nkpts)
 void StructFact::updateAllPart(const ParticleSet& P)
 {
   ScopedTimer local(update_all_timer_);
-  computeRhok(P);
+  updateRhok(P);
 }
 
 void StructFact::mw_updateAllPart(const RefVectorWithLeader<StructFact>& sk_list,
@@ -75,10 +78,111 @@ void StructFact::mw_updateAllPart(const RefVectorWithLeader<StructFact>& sk_list
 {
   auto& sk_leader = sk_list.getLeader();
   ScopedTimer local(sk_leader.update_all_timer_);
+#pragma omp parallel for
   for (int iw = 0; iw < sk_list.size(); iw++)
-    sk_list[iw].computeRhok(p_list[iw]);
+    sk_list[iw].updateRhok(p_list[iw]);
 }
 
+void StructFact::updateRhok(const ParticleSet& P)
+{
+#if defined(USE_REAL_STRUCT_FACTOR)
+  const int npart = P.getTotalNum();
+  if ((!particle_mesh_ || StorePerParticle) && rhok_positions_.size() == npart &&
+      num_rhok_updates_ < RhokRecomputePeriod)
+  {
+    moved_ptcls_.clear();
+    for (int i = 0; i < npart; ++i)
+      if (!(P.R[i] == rhok_positions_[i]))
+        moved_ptcls_.push_back(i);
+    // without the storage per particle, the old phases of a moved particle are evaluated again
+    const size_t cost = StorePerParticle ? moved_ptcls_.size() : 2 * moved_ptcls_.size();
+    if (cost < npart)
+    {
+      computeRhokChange(P);
+      return;
+    }
+  }
+#endif
+  computeRhok(P);
+}
+
+void StructFact::computeRhokChange(const ParticleSet& P)
+{
+#if defined(USE_REAL_STRUCT_FACTOR)
+  if (moved_ptcls_.empty())
+    return;
+  const int nk = k_lists_.numk;
+  for (const int i : moved_ptcls_)
+  {
+    auto* restrict rhok_r_ptr = rhok_r[P.getGroupID(i)];
+    auto* restrict rhok_i_ptr = rhok_i[P.getGroupID(i)];
+    if (StorePerParticle)
+    {
+      computePhases(P.R[i]);
+      auto* restrict eikr_r_ptr = eikr_r[i];
+      auto* restrict eikr_i_ptr = eikr_i[i];
+#pragma omp simd
+      for (int ki = 0; ki < nk; ki++)
+      {
+        rhok_r_ptr[ki] += eikr_r_temp[ki] - eikr_r_ptr[ki];
+        rhok_i_ptr[ki] += eikr_i_temp[ki] - eikr_i_ptr[ki];
+        eikr_r_ptr[ki] = eikr_r_temp[ki];
+        eikr_i_ptr[ki] = eikr_i_temp[ki];
+      }
+    }
+    else
+    {
+      // remove the old phases and add the new ones
+      const PosType pos_pair[2] = {rhok_positions_[i], P.R[i]};
+      for (int inew = 0; inew < 2; inew++)
+      {
+        const RealType sign = inew ? 1 : -1;
+        computePhases(pos_pair[inew]);
+#pragma omp simd
+        for (int ki = 0; ki < nk; ki++)
+        {
+          rhok_r_ptr[ki] += sign * eikr_r_temp[ki];
+          rhok_i_ptr[ki] += sign * eikr_i_temp[ki];
+        }
+      }
+    }
+    rhok_positions_[i] = P.R[i];
+  }
+  num_rhok_updates_++;
+#endif
+}
+
+
+void StructFact::computePhases(const PosType& pos)
+{
+#if defined(USE_REAL_STRUCT_FACTOR)
+  const int nk      = k_lists_.numk;
+  const int nk_half = k_lists_.kpts_half.size();
+  if (nk_half == 0)
+  {
+    for (int ki = 0; ki < nk; ki++)
+      phiV[ki] = dot(k_lists_.kpts_cart[ki], pos);
+    eval_e2iphi(nk, phiV.data(), eikr_r_temp.data(), eikr_i_temp.data());
+    return;
+  }
+
+  // e^{-ik.r} is the complex conjugate of e^{ik.r}
+  for (int ih = 0; ih < nk_half; ih++)
+    phiV[ih] = dot(k_lists_.kpts_cart_half[ih], pos);
+  eval_e2iphi(nk_half, phiV.data(), eikr_r_half_.data(), eikr_i_half_.data());
+  const int* restrict kpts_half = k_lists_.kpts_half.data();
+  const int* restrict minusk    = k_lists_.minusk.data();
+  for (int ih = 0; ih < nk_half; ih++)
+  {
+    const int ki     = kpts_half[ih];
+    const int mki    = minusk[ki];
+    eikr_r_temp[ki]  = eikr_r_half_[ih];
+    eikr_i_temp[ki]  = eikr_i_half_[ih];
+    eikr_r_temp[mki] = eikr_r_half_[ih];
+    eikr_i_temp[mki] = -eikr_i_half_[ih];
+  }
+#endif
+}
 
 /** evaluate rok per species, eikr  per particle
  */
@@ -88,9 +192,13 @@ void StructFact::computeRhok(const ParticleSet& P)
 #if defined(USE_REAL_STRUCT_FACTOR)
   rhok_r = 0.0;
   rhok_i = 0.0;
+  rhok_positions_.assign(P.R.begin(), P.R.end());
+  num_rhok_updates_ = 0;
   //algorithmA
   const int nk = k_lists_.numk;
-  if (StorePerParticle)
+  if (particle_mesh_ && !StorePerParticle)
+    particle_mesh_->computeRhok(P, rhok_r, rhok_i);
+  else if (StorePerParticle)
   {
     // save per particle and species value
     for (int i = 0; i < npart; ++i)
@@ -100,10 +208,12 @@ void StructFact::computeRhok(const ParticleSet& P)
       auto* restrict eikr_i_ptr = eikr_i[i];
       auto* restrict rhok_r_ptr = rhok_r[P.getGroupID(i)];
       auto* restrict rhok_i_ptr = rhok_i[P.getGroupID(i)];
+      computePhases(pos);
 #pragma omp simd
       for (int ki = 0; ki < nk; ki++)
       {
-        qmcplusplus::sincos(dot(k_lists_.kpts_cart[ki], pos), &eikr_i_ptr[ki], &eikr_r_ptr[ki]);
+        eikr_r_ptr[ki] = eikr_r_temp[ki];
+        eikr_i_ptr[ki] = eikr_i_temp[ki];
         rhok_r_ptr[ki] += eikr_r_ptr[ki];
         rhok_i_ptr[ki] += eikr_i_ptr[ki];
       }
@@ -127,9 +237,7 @@ void StructFact::computeRhok(const ParticleSet& P)
         rhok_i_ptr[ki] += s;
       }
 #else
-      for (int ki = 0; ki < nk; ki++)
-        phiV[ki] = dot(k_lists_.kpts_cart[ki], pos);
-      eval_e2iphi(nk, phiV.data(), eikr_r_temp.data(), eikr_i_temp.data());
+      computePhases(pos);
       for (int ki = 0; ki < nk; ki++)
       {
         rhok_r_ptr[ki] += eikr_r_temp[ki];
@@ -170,4 +278,20 @@ void StructFact::turnOnStorePerParticle(const ParticleSet& P)
 #endif
 }
 
+void StructFact::turnOnParticleMesh(const ParticleSet& P)
+{
+#if defined(USE_REAL_STRUCT_FACTOR)
+  if (!particle_mesh_)
+  {
+    particle_mesh_.emplace(k_lists_);
+    const auto& mesh_size = particle_mesh_->getMeshSize();
+    app_log() << "  StructFact evaluates rhok on a particle mesh of " << mesh_size[0];
+    for (int idim = 1; idim < OHMMS_DIM; idim++)
+      app_log() << " x " << mesh_size[idim];
+    app_log() << std::endl;
+    computeRhok(P);
+  }
+#endif
+}
+
 } // namespace qmcplusplus
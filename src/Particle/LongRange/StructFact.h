@@ -19,6 +19,9 @@
 #include "DynamicCoordinates.h"
 #include "OhmmsPETE/OhmmsVector.h"
 #include "OhmmsPETE/OhmmsMatrix.h"
+#include "ParticleMeshRhok.h"
+#include <algorithm>
+#include <optional>
 
 namespace qmcplusplus
 {
@@ -49,6 +52,8 @@ public:
   Matrix<RealType> rhok_r, rhok_i;
   Matrix<RealType> eikr_r, eikr_i;
   Vector<RealType> eikr_r_temp, eikr_i_temp;
+  /// e^{ik.r} of KContainer::kpts_half
+  Vector<RealType> eikr_r_half_, eikr_i_half_;
 #else
   Matrix<ComplexType> rhok;
   ///eikr[particle-index][K]
@@ -66,7 +71,10 @@ public:
   /// desructor
   ~StructFact();
 
-  /**  Update Rhok if all particles moved
+  /** Update Rhok after any particle moves
+   *
+   * The particles moved since the last update are found by their positions.
+   * If few of them moved, their changes are added to rhok instead of summing over all the particles.
    */
   void updateAllPart(const ParticleSet& P);
 
@@ -82,9 +90,60 @@ public:
   /// accessor of StorePerParticle
   bool isStorePerParticle() const { return StorePerParticle; }
 
+  /** @brief switch on the particle-mesh evaluation of rhok
+   * rhok per species is interpolated with smooth particle-mesh Ewald instead of the direct sum over k-vectors.
+   * Not used when the storage per particle is on.
+   */
+  void turnOnParticleMesh(const ParticleSet& P);
+
+  /// true if rhok is evaluated on a particle mesh
+  bool isParticleMesh() const { return particle_mesh_.has_value(); }
+
+  /** compute the charge weighted structure factor \f$\sum_{\alpha} q_{\alpha}\rho^{\alpha}_{\bf k}\f$
+   * @param charges charge of each species
+   * @param nk number of leading k vectors to compute
+   * @param rk_r real part, nk values
+   * @param rk_i imaginary part, nk values
+   */
+  template<typename T>
+  void getChargeWeightedRhok(const std::vector<RealType>& charges, int nk, T* restrict rk_r, T* restrict rk_i) const
+  {
+    std::fill_n(rk_r, nk, T(0));
+    std::fill_n(rk_i, nk, T(0));
+    for (int s = 0; s < num_species; s++)
+    {
+      const T q = charges[s];
+#if defined(USE_REAL_STRUCT_FACTOR)
+      const RealType* restrict rhok_r_s = rhok_r[s];
+      const RealType* restrict rhok_i_s = rhok_i[s];
+      for (int ki = 0; ki < nk; ki++)
+      {
+        rk_r[ki] += q * rhok_r_s[ki];
+        rk_i[ki] += q * rhok_i_s[ki];
+      }
+#else
+      const ComplexType* restrict rhok_s = rhok[s];
+      for (int ki = 0; ki < nk; ki++)
+      {
+        rk_r[ki] += q * rhok_s[ki].real();
+        rk_i[ki] += q * rhok_s[ki].imag();
+      }
+#endif
+    }
+  }
+
 private:
   /// Compute all rhok elements from the start
   void computeRhok(const ParticleSet& P);
+  /// Compute rhok from scratch or from its change due to moved particles, whichever is cheaper
+  void updateRhok(const ParticleSet& P);
+  /// Add the change of rhok due to moved_ptcls_
+  void computeRhokChange(const ParticleSet& P);
+  /** compute e^{ik.r} of all the k-vectors into eikr_r_temp and eikr_i_temp
+   *
+   * Only the half of the k-vectors in KContainer::kpts_half is evaluated if the k-vectors are inversion symmetric.
+   */
+  void computePhases(const PosType& pos);
   /** resize the internal data
    * @param np number of species
    * @param nptcl number of particles
@@ -103,6 +162,16 @@ private:
    * storing data per particle specie is more cost-effective
    */
   bool StorePerParticle;
+  /// particle-mesh evaluation of rhok per species, engaged by turnOnParticleMesh
+  std::optional<ParticleMeshRhok> particle_mesh_;
+  /// number of incremental rhok updates between two evaluations from scratch
+  static constexpr int RhokRecomputePeriod = 100;
+  /// positions of the last rhok update
+  std::vector<PosType> rhok_positions_;
+  /// particles moved since the last rhok update
+  std::vector<int> moved_ptcls_;
+  /// number of incremental updates since the last evaluation from scratch
+  int num_rhok_updates_;
   /// timer for updateAllPart
   NewTimer& update_all_timer_;
 };
@@ -65,4 +65,110 @@ TEST_CASE("StructFact", "[lrhandler]")
   }
 }
 
+TEST_CASE("StructFact incremental update", "[lrhandler]")
+{
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> Lattice;
+  Lattice.BoxBConds = true;
+  Lattice.R.diagonal(5.0);
+  Lattice.reset();
+  Lattice.LR_dim_cutoff = 15;
+  const SimulationCell simulation_cell(Lattice);
+  ParticleSet ref(simulation_cell);
+
+  SpeciesSet& tspecies = ref.getSpeciesSet();
+  tspecies.addSpecies("u");
+  tspecies.addSpecies("d");
+  ref.create({3, 2});
+  ref.R[0] = {0.0, 1.0, 2.0};
+  ref.R[1] = {1.0, 0.2, 3.0};
+  ref.R[2] = {0.3, 4.0, 1.4};
+  ref.R[3] = {3.2, 4.7, 0.7};
+  ref.R[4] = {2.4, 2.2, 4.1};
+
+  const auto& k_lists = simulation_cell.getKLists();
+  // the phases are evaluated on one k of each (k, -k) pair
+  REQUIRE(k_lists.kpts_half.size() * 2 == k_lists.numk);
+  for (const int ki : k_lists.kpts_half)
+  {
+    const int mki = k_lists.minusk[ki];
+    REQUIRE(ki < mki);
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      CHECK(k_lists.kpts[mki][idim] == -k_lists.kpts[ki][idim]);
+  }
+
+  StructFact sk(tspecies.size(), ref.getTotalNum(), ref.getLRBox(), k_lists);
+  sk.updateAllPart(ref);
+  StructFact sk_stored(sk);
+  sk_stored.turnOnStorePerParticle(ref);
+
+  // one particle of each species moved, rhok is updated by the change of these two
+  ref.R[1] = {1.5, 0.1, 2.7};
+  ref.R[3] = {3.0, 4.2, 1.1};
+  sk.updateAllPart(ref);
+  sk_stored.updateAllPart(ref);
+
+  StructFact sk_ref(tspecies.size(), ref.getTotalNum(), ref.getLRBox(), k_lists);
+  sk_ref.updateAllPart(ref);
+  for (int i = 0; i < ref.groups(); i++)
+    for (int ik = 0; ik < k_lists.numk; ik++)
+    {
+      CHECK(sk.rhok_r[i][ik] == Approx(sk_ref.rhok_r[i][ik]).margin(1e-5));
+      CHECK(sk.rhok_i[i][ik] == Approx(sk_ref.rhok_i[i][ik]).margin(1e-5));
+      CHECK(sk_stored.rhok_r[i][ik] == Approx(sk_ref.rhok_r[i][ik]).margin(1e-5));
+      CHECK(sk_stored.rhok_i[i][ik] == Approx(sk_ref.rhok_i[i][ik]).margin(1e-5));
+    }
+  for (int ik = 0; ik < k_lists.numk; ik++)
+  {
+    const auto kr = dot(k_lists.kpts_cart[ik], ref.R[3]);
+    CHECK(sk_stored.eikr_r[3][ik] == Approx(std::cos(kr)));
+    CHECK(sk_stored.eikr_i[3][ik] == Approx(std::sin(kr)));
+  }
+}
+
+TEST_CASE("StructFact particle mesh", "[lrhandler]")
+{
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> Lattice;
+  Lattice.BoxBConds = true;
+  Lattice.R         = {5.0, 0.0, 0.0, 0.5, 4.5, 0.0, 0.0, 0.3, 5.5};
+  Lattice.reset();
+  Lattice.LR_dim_cutoff = 15;
+  const SimulationCell simulation_cell(Lattice);
+  ParticleSet ref(simulation_cell);
+
+  SpeciesSet& tspecies = ref.getSpeciesSet();
+  tspecies.addSpecies("u");
+  tspecies.addSpecies("d");
+  ref.create({3, 2});
+  ref.R[0] = {0.0, 1.0, 2.0};
+  ref.R[1] = {1.0, 0.2, 3.0};
+  ref.R[2] = {0.3, 4.0, 1.4};
+  ref.R[3] = {3.2, 4.7, 0.7};
+  ref.R[4] = {-0.4, 2.2, 6.1};
+
+  const auto& k_lists = simulation_cell.getKLists();
+  StructFact sk(tspecies.size(), ref.getTotalNum(), ref.getLRBox(), k_lists);
+  sk.updateAllPart(ref);
+  StructFact sk_mesh(sk);
+  CHECK(!sk_mesh.isParticleMesh());
+  sk_mesh.turnOnParticleMesh(ref);
+  CHECK(sk_mesh.isParticleMesh());
+
+  // B-splines of order 6 on a mesh twice as fine as the k-vectors
+  auto check_rhok = [&]() {
+    for (int i = 0; i < ref.groups(); i++)
+      for (int ik = 0; ik < k_lists.numk; ik++)
+      {
+        CHECK(sk_mesh.rhok_r[i][ik] == Approx(sk.rhok_r[i][ik]).margin(5e-3));
+        CHECK(sk_mesh.rhok_i[i][ik] == Approx(sk.rhok_i[i][ik]).margin(5e-3));
+      }
+  };
+  check_rhok();
+
+  ref.R[2] = {2.1, -0.6, 3.3};
+  ref.update();
+  sk.updateAllPart(ref);
+  sk_mesh.updateAllPart(ref);
+  check_rhok();
+}
+
 } // namespace qmcplusplus
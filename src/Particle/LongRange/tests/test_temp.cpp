@@ -11,6 +11,8 @@
 
 #include "catch.hpp"
 
+#include <cstdio>
+
 #include "Configuration.h"
 #include "Lattice/CrystalLattice.h"
 #include "Particle/ParticleSet.h"
@@ -75,4 +77,37 @@ TEST_CASE("temp3d", "[lrhandler]")
   }
 }
 
+/** the breakup read from the cache must be the fitted one
+ */
+TEST_CASE("temp3d_breakup_cache", "[lrhandler]")
+{
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> Lattice;
+  Lattice.BoxBConds     = true;
+  Lattice.LR_dim_cutoff = 30.;
+  Lattice.R.diagonal(5.0);
+  Lattice.reset();
+  Lattice.SetLRCutoffs(Lattice.Rv);
+  Lattice.LR_breakup_cache = "temp3d_breakup_cache.h5";
+  std::remove(Lattice.LR_breakup_cache.c_str());
+
+  const SimulationCell simulation_cell(Lattice);
+  ParticleSet ref(simulation_cell);
+  ref.createSK();
+
+  // the first handler fits and saves the breakup, the second one reads it back
+  LRHandlerTemp<EslerCoulomb3D, LPQHIBasis> handler(ref);
+  handler.initBreakup(ref);
+  LRHandlerTemp<EslerCoulomb3D, LPQHIBasis> cached_handler(ref);
+  cached_handler.initBreakup(ref);
+
+  REQUIRE(cached_handler.MaxKshell == handler.MaxKshell);
+  REQUIRE(cached_handler.coefs.size() == handler.coefs.size());
+  for (int n = 0; n < handler.coefs.size(); n++)
+    CHECK(cached_handler.coefs[n] == handler.coefs[n]);
+  REQUIRE(cached_handler.Fk.size() == handler.Fk.size());
+  for (int ki = 0; ki < handler.Fk.size(); ki++)
+    CHECK(cached_handler.Fk[ki] == Approx(handler.Fk[ki]));
+
+}
+
 } // namespace qmcplusplus
@@ -26,27 +26,69 @@
   *\param a the starting pointer
   *\param n the number of type T to be assigned
   *\brief Assign Gaussian distributed random numbers using Box-Mueller algorithm. Called by overloaded funtions makeGaussRandom
+  *
+  * Uniform random numbers are drawn in chunks of GAUSS_RAND_CHUNK into a local buffer before the Box-Mueller transform.
+  * The sequential RNG calls are thus separated from the transform loop which the compiler can vectorize.
+  * The sequence of the output is identical to transforming the uniform random numbers pair by pair.
   */
 namespace qmcplusplus
 {
+/// detects the batched fill(T*, n) of the counter-based generators
+template<class RG, class T, class = void>
+struct HasRandomFill : std::false_type
+{};
+
+template<class RG, class T>
+struct HasRandomFill<RG, T, std::void_t<decltype(std::declval<RG&>().fill(std::declval<T*>(), size_t()))>>
+    : std::true_type
+{};
+
+/** assign n uniform random numbers [0,1), through the batched fill of the generator if it has one
+ *
+ *  The sequence is the same as n calls of rng().
+ */
+template<class T, class RG>
+inline void fillUniformRandWithEngine(T* restrict a, unsigned n, RG& rng)
+{
+  if constexpr (HasRandomFill<RG, T>::value)
+    rng.fill(a, n);
+  else
+    for (unsigned i = 0; i < n; i++)
+      a[i] = rng();
+}
+
+/// number of uniform random numbers buffered by assignGaussRand, must be even
+constexpr unsigned GAUSS_RAND_CHUNK = 256;
+
 template<class T, class RG>
 inline void assignGaussRand(T* restrict a, unsigned n, RG& rng)
 {
-  OHMMS_PRECISION_FULL slightly_less_than_one = 1.0 - std::numeric_limits<OHMMS_PRECISION_FULL>::epsilon();
-  int nm1                                     = n - 1;
-  OHMMS_PRECISION_FULL temp1, temp2;
-  for (int i = 0; i < nm1; i += 2)
+  static_assert(GAUSS_RAND_CHUNK % 2 == 0, "GAUSS_RAND_CHUNK must be even");
+  using FullPrec                        = OHMMS_PRECISION_FULL;
+  const FullPrec slightly_less_than_one = 1.0 - std::numeric_limits<FullPrec>::epsilon();
+  FullPrec uniforms[GAUSS_RAND_CHUNK];
+  unsigned offset = 0;
+  // complete pairs
+  while (offset + 1 < n)
   {
-    temp1    = std::sqrt(-2.0 * std::log(1.0 - slightly_less_than_one * rng()));
-    temp2    = 2.0 * M_PI * rng();
-    a[i]     = temp1 * std::cos(temp2);
-    a[i + 1] = temp1 * std::sin(temp2);
+    const unsigned chunk = std::min(GAUSS_RAND_CHUNK, (n - offset) & ~1u);
+    fillUniformRandWithEngine(uniforms, chunk, rng);
+    T* restrict a_chunk = a + offset;
+#pragma omp simd
+    for (unsigned i = 0; i < chunk; i += 2)
+    {
+      const FullPrec temp1 = std::sqrt(-2.0 * std::log(1.0 - slightly_less_than_one * uniforms[i]));
+      const FullPrec temp2 = 2.0 * M_PI * uniforms[i + 1];
+      a_chunk[i]           = temp1 * std::cos(temp2);
+      a_chunk[i + 1]       = temp1 * std::sin(temp2);
+    }
+    offset += chunk;
   }
   if (n % 2 == 1)
   {
-    temp1  = std::sqrt(-2.0 * std::log(1.0 - slightly_less_than_one * rng()));
-    temp2  = 2.0 * M_PI * rng();
-    a[nm1] = temp1 * std::cos(temp2);
+    const FullPrec temp1 = std::sqrt(-2.0 * std::log(1.0 - slightly_less_than_one * rng()));
+    const FullPrec temp2 = 2.0 * M_PI * rng();
+    a[n - 1]             = temp1 * std::cos(temp2);
   }
 }
 
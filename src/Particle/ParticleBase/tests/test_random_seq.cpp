@@ -105,6 +105,29 @@ TEST_CASE("gaussian random input zero", "[particle_base]")
   REQUIRE(a[1] == Approx(0.0));
 }
 
+TEST_CASE("gaussian random array across chunks", "[particle_base]")
+{
+  // odd length spanning several buffered chunks
+  const unsigned n = 2 * GAUSS_RAND_CHUNK + 7;
+  std::vector<double> a(n);
+  {
+    StdRandom<double> rng;
+    assignGaussRand(a.data(), n, rng);
+  }
+
+  // reference: Box-Mueller transform pair by pair
+  StdRandom<double> rng;
+  const double slightly_less_than_one = 1.0 - std::numeric_limits<double>::epsilon();
+  for (unsigned i = 0; i < n; i += 2)
+  {
+    const double temp1 = std::sqrt(-2.0 * std::log(1.0 - slightly_less_than_one * rng()));
+    const double temp2 = 2.0 * M_PI * rng();
+    CHECK(a[i] == Approx(temp1 * std::cos(temp2)));
+    if (i + 1 < n)
+      CHECK(a[i + 1] == Approx(temp1 * std::sin(temp2)));
+  }
+}
+
 TEST_CASE("makeGaussRandomWithEngine(MCCoords...)", "[particle_base]")
 {
   int size_test = 7;
@@ -105,7 +105,11 @@ bool LatticeParser::put(xmlNodePtr cur)
       }
       else if (aname == "LR_dim_cutoff")
       {
-        putContent(ref_.LR_dim_cutoff, cur);
+        std::string dim_cutoff;
+        putContent(dim_cutoff, cur);
+        ref_.LR_dim_cutoff_auto = lowerCase(dim_cutoff) == "auto";
+        if (!ref_.LR_dim_cutoff_auto)
+          putContent(ref_.LR_dim_cutoff, cur);
       }
       else if (aname == "LR_handler")
       {
@@ -126,6 +130,10 @@ bool LatticeParser::put(xmlNodePtr cur)
       {
         putContent(ref_.LR_tol, cur);
       }
+      else if (aname == "LR_breakup_cache")
+      {
+        putContent(ref_.LR_breakup_cache, cur);
+      }
       else if (aname == "rs")
       {
         lattice_defined = true;
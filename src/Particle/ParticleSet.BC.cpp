@@ -66,6 +66,15 @@ void ParticleSet::turnOnPerParticleSK()
                              "structure_factor_ but structure_factor_ has not been created.");
 }
 
+void ParticleSet::turnOnParticleMeshSK()
+{
+  if (structure_factor_)
+    structure_factor_->turnOnParticleMesh(*this);
+  else
+    throw std::runtime_error("ParticleSet::turnOnParticleMeshSK trying to turn on the particle mesh in "
+                             "structure_factor_ but structure_factor_ has not been created.");
+}
+
 bool ParticleSet::getPerParticleSKState() const
 {
   bool isPerParticleOn = false;
@@ -24,9 +24,12 @@
 #include "Particle/DistanceTable.h"
 #include "Particle/createDistanceTable.h"
 #include "LongRange/StructFact.h"
+#include "Particle/SpaceFillingCurve.h"
+#include "Concurrency/OpenMP.h"
 #include "Utilities/IteratorUtility.h"
 #include "Utilities/RandomGenerator.h"
 #include "ParticleBase/RandomSeqGeneratorGlobal.h"
+#include "MemoryAccounting.h"
 
 //#define PACK_DISTANCETABLES
 
@@ -108,7 +111,11 @@ ParticleSet::ParticleSet(const ParticleSet& p)
   Collectables        = p.Collectables;
   //construct the distance tables with the same order
   for (int i = 0; i < p.DistTables.size(); ++i)
+  {
     addTable(p.DistTables[i]->get_origin(), p.DistTables[i]->getModes());
+    if (auto* dt_ab = dynamic_cast<const DistanceTableAB*>(p.DistTables[i].get()); dt_ab && dt_ab->hasNeighborList())
+      enableNeighborList(i, dt_ab->getNeighborCutoff(), dt_ab->getNeighborSkin());
+  }
 
   if (p.structure_factor_)
     structure_factor_ = std::make_unique<StructFact>(*p.structure_factor_);
@@ -359,6 +366,7 @@ int ParticleSet::addTable(const ParticleSet& psrc, DTModes modes)
   std::map<std::string, int>::iterator tit(myDistTableMap.find(psrc.getName()));
   if (tit == myDistTableMap.end())
   {
+    ScopedMemoryTag memory_tag("distance tables");
     std::ostringstream description;
     tid = DistTables.size();
     if (myName == psrc.getName())
@@ -392,6 +400,11 @@ const DistanceTableAB& ParticleSet::getDistTableAB(int table_ID) const
   return dynamic_cast<DistanceTableAB&>(*DistTables[table_ID]);
 }
 
+bool ParticleSet::enableNeighborList(int table_ID, RealType rcut, RealType skin)
+{
+  return dynamic_cast<DistanceTableAB&>(*DistTables[table_ID]).enableNeighborList(rcut, skin);
+}
+
 void ParticleSet::update(bool skipSK)
 {
   ScopedTimer update_scope(myTimers[PS_update]);
@@ -410,6 +423,26 @@ void ParticleSet::mw_update(const RefVectorWithLeader<ParticleSet>& p_list, bool
   auto& p_leader = p_list.getLeader();
   ScopedTimer update_scope(p_leader.myTimers[PS_update]);
 
+  if (p_leader.coordinates_->getKind() != DynamicCoordinateKind::DC_POS_OFFLOAD &&
+      p_list.size() >= omp_get_max_threads())
+  {
+    /* host only data and enough walkers to occupy all the threads.
+     * Each walker is updated in a single sweep, positions, distance tables and then structure factor,
+     * while its data is still hot in cache. Otherwise, batched table evaluation distributes work within walkers.
+     */
+#pragma omp parallel for
+    for (int iw = 0; iw < p_list.size(); iw++)
+    {
+      ParticleSet& pset = p_list[iw];
+      pset.coordinates_->setAllParticlePos(pset.R);
+      for (int i = 0; i < pset.DistTables.size(); i++)
+        pset.DistTables[i]->evaluate(pset);
+      if (!skipSK && pset.structure_factor_)
+        pset.structure_factor_->updateAllPart(pset);
+    }
+    return;
+  }
+
   for (ParticleSet& pset : p_list)
     pset.coordinates_->setAllParticlePos(pset.R);
 
@@ -476,21 +509,37 @@ bool ParticleSet::makeMoveAndCheck(Index_t iat, const SingleParticlePos& displ)
   active_ptcl_     = iat;
   active_pos_      = R[iat] + displ;
   active_spin_val_ = spins[iat];
-  bool is_valid    = true;
-  auto& Lattice    = simulation_cell_.getLattice();
+  bool is_valid    = isValidMove(displ, active_pos_);
+  computeNewPosDistTables(iat, active_pos_, true);
+  return is_valid;
+}
+
+void ParticleSet::mw_makeMoveAndCheck(const RefVectorWithLeader<ParticleSet>& p_list,
+                                      Index_t iat,
+                                      const std::vector<SingleParticlePos>& displs,
+                                      std::vector<bool>& valid)
+{
+  mw_makeMove(p_list, iat, displs);
+  valid.resize(p_list.size());
+  for (int iw = 0; iw < p_list.size(); iw++)
+    valid[iw] = p_list[iw].isValidMove(displs[iw], p_list[iw].active_pos_);
+}
+
+bool ParticleSet::isValidMove(const SingleParticlePos& displ, const SingleParticlePos& newpos) const
+{
+  auto& Lattice = simulation_cell_.getLattice();
   if (Lattice.explicitly_defined)
   {
     if (Lattice.outOfBound(Lattice.toUnit(displ)))
-      is_valid = false;
+      return false;
     else
     {
-      SingleParticlePos newRedPos = Lattice.toUnit(active_pos_);
+      SingleParticlePos newRedPos = Lattice.toUnit(newpos);
       if (!Lattice.isValid(newRedPos))
-        is_valid = false;
+        return false;
     }
   }
-  computeNewPosDistTables(iat, active_pos_, true);
-  return is_valid;
+  return true;
 }
 
 bool ParticleSet::makeMoveAndCheckWithSpin(Index_t iat, const SingleParticlePos& displ, const Scalar_t& sdispl)
@@ -900,6 +949,25 @@ void ParticleSet::mw_saveWalker(const RefVectorWithLeader<ParticleSet>& psets, c
     psets[iw].saveWalker(walkers[iw]);
 }
 
+void ParticleSet::sortWalkerByZOrder(Walker_t& awalker) const
+{
+  if (!is_grouped_)
+    throw std::runtime_error("ParticleSet::sortWalkerByZOrder requires particles grouped by species.");
+  const ParticlePos R_in(awalker.R);
+  const ParticleScalar spins_in(awalker.spins);
+  std::vector<int> perm;
+  for (int ig = 0; ig < groups(); ++ig)
+  {
+    SpaceFillingCurve::getZOrderPermutation(getLattice(), R_in, first(ig), last(ig), perm);
+    for (int iat = first(ig); iat < last(ig); ++iat)
+    {
+      awalker.R[iat] = R_in[perm[iat - first(ig)]];
+      if (spins_in.size())
+        awalker.spins[iat] = spins_in[perm[iat - first(ig)]];
+    }
+  }
+}
+
 
 void ParticleSet::initPropertyList()
 {
@@ -190,6 +190,14 @@ public:
   ///get a distance table by table_ID and dyanmic_cast to DistanceTableAB
   const DistanceTableAB& getDistTableAB(int table_ID) const;
 
+  /** request compact neighbor lists from an AB distance table
+   * @param table_ID index of an AB distance table returned by addTable
+   * @param rcut cutoff radius of the neighbor lists
+   * @param skin Verlet skin of the neighbor lists
+   * @return true if the distance table maintains neighbor lists
+   */
+  bool enableNeighborList(int table_ID, RealType rcut, RealType skin = 0);
+
   /** reset all the collectable quantities during a MC iteration
    */
   inline void resetCollectables() { std::fill(Collectables.begin(), Collectables.end(), 0.0); }
@@ -219,6 +227,10 @@ public:
    */
   void turnOnPerParticleSK();
 
+  /** Turn on the particle-mesh evaluation of rhok in Structure Factor
+   */
+  void turnOnParticleMeshSK();
+
   /** Get state (on/off) of per particle storage in Structure Factor
    */
   bool getPerParticleSKState() const;
@@ -310,6 +322,13 @@ public:
    * Note: active_pos_ and distances tables are always evaluated no matter the move is valid or not.
    */
   bool makeMoveAndCheck(Index_t iat, const SingleParticlePos& displ);
+  /** batched version of makeMoveAndCheck
+   * @param valid validity of the move of each walker, see makeMoveAndCheck
+   */
+  static void mw_makeMoveAndCheck(const RefVectorWithLeader<ParticleSet>& p_list,
+                                  Index_t iat,
+                                  const std::vector<SingleParticlePos>& displs,
+                                  std::vector<bool>& valid);
   /// makeMoveAndCheck, but now includes an update to the spin variable
   bool makeMoveAndCheckWithSpin(Index_t iat, const SingleParticlePos& displ, const Scalar_t& sdispl);
 
@@ -431,6 +450,14 @@ public:
    */
   static void mw_saveWalker(const RefVectorWithLeader<ParticleSet>& psets, const RefVector<Walker_t>& walkers);
 
+  /** reorder the particles of awalker along a Z-order curve within each group of this particle set
+   *
+   *  Particles of the same group are indistinguishable. Nearby particles get nearby indices,
+   *  which improves memory locality of distance tables and their consumers.
+   *  Only R and spins are reordered, anything derived from them must be recomputed.
+   */
+  void sortWalkerByZOrder(Walker_t& awalker) const;
+
   /** update structure factor and unmark active_ptcl_
    *@param skip SK update if skipSK is true
    *
@@ -660,6 +687,13 @@ protected:
                                          const std::vector<SingleParticlePos>& new_positions,
                                          bool maybe_accept = true);
 
+  /** check a proposed move against the lattice, see makeMoveAndCheck
+   * @param displ displacement of the move
+   * @param newpos proposed position
+   * @return true, if the move is valid
+   */
+  bool isValidMove(const SingleParticlePos& displ, const SingleParticlePos& newpos) const;
+
   /** actual implemenation for accepting a proposed move in forward mode
    *
    * @param iat the index of the particle whose position and other attributes to be updated
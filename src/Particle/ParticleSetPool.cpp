@@ -130,6 +130,7 @@ bool ParticleSetPool::put(xmlNodePtr cur)
   std::string randomsrc;
   std::string useGPU;
   std::string spinor;
+  std::string layout;
   OhmmsAttributeSet pAttrib;
   pAttrib.add(id, "id");
   pAttrib.add(id, "name");
@@ -138,6 +139,7 @@ bool ParticleSetPool::put(xmlNodePtr cur)
   pAttrib.add(randomsrc, "randomsrc");
   pAttrib.add(randomsrc, "random_source");
   pAttrib.add(spinor, "spinor", {"no", "yes"});
+  pAttrib.add(layout, "layout", {"soa", "aosoa"});
 #if defined(ENABLE_OFFLOAD)
   pAttrib.add(useGPU, "gpu", {"yes", "no"});
 #endif
@@ -157,6 +159,8 @@ bool ParticleSetPool::put(xmlNodePtr cur)
     // select OpenMP offload implementation in ParticleSet.
     if (useGPU == "yes")
       pTemp = new MCWalkerConfiguration(*simulation_cell_, DynamicCoordinateKind::DC_POS_OFFLOAD);
+    else if (layout == "aosoa")
+      pTemp = new MCWalkerConfiguration(*simulation_cell_, DynamicCoordinateKind::DC_POS_AOSOA);
     else
       pTemp = new MCWalkerConfiguration(*simulation_cell_, DynamicCoordinateKind::DC_POS);
 
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file RealSpacePositionsAoSoA.h
+ */
+#ifndef QMCPLUSPLUS_REALSPACE_POSITIONS_AOSOA_H
+#define QMCPLUSPLUS_REALSPACE_POSITIONS_AOSOA_H
+
+#include "Particle/DynamicCoordinates.h"
+#include "OhmmsSoA/VectorAoSoAContainer.h"
+
+namespace qmcplusplus
+{
+/** RealSpacePositions keeping the positions in AoSoA tiles as well
+ *
+ * The distance tables compute from the tiles, the other consumers keep using the SoA positions
+ * of getAllParticlePos. Both layouts are updated by every move, this class is meant for layout experiments.
+ */
+class RealSpacePositionsAoSoA : public DynamicCoordinates
+{
+public:
+  using ParticlePos    = PtclOnLatticeTraits::ParticlePos;
+  using RealType       = QMCTraits::RealType;
+  using PosType        = QMCTraits::PosType;
+  using PosVectorAoSoA = VectorAoSoAContainer<RealType, QMCTraits::DIM>;
+
+  RealSpacePositionsAoSoA() : DynamicCoordinates(DynamicCoordinateKind::DC_POS_AOSOA) {}
+
+  std::unique_ptr<DynamicCoordinates> makeClone() override { return std::make_unique<RealSpacePositionsAoSoA>(*this); }
+
+  void resize(size_t n) override
+  {
+    RSoA.resize(n);
+    RAoSoA.resize(n);
+  }
+  size_t size() const override { return RSoA.size(); }
+
+  void setAllParticlePos(const ParticlePos& R) override
+  {
+    resize(R.size());
+    RSoA.copyIn(R);
+    RAoSoA.copyIn(R);
+  }
+  void setOneParticlePos(const PosType& pos, size_t iat) override
+  {
+    RSoA(iat)   = pos;
+    RAoSoA(iat) = pos;
+  }
+
+  void mw_acceptParticlePos(const RefVectorWithLeader<DynamicCoordinates>& coords_list,
+                            size_t iat,
+                            const std::vector<PosType>& new_positions,
+                            const std::vector<bool>& isAccepted) const override
+  {
+    assert(this == &coords_list.getLeader());
+    for (size_t iw = 0; iw < isAccepted.size(); iw++)
+      if (isAccepted[iw])
+        coords_list[iw].setOneParticlePos(new_positions[iw], iat);
+  }
+
+  const PosVectorSoa& getAllParticlePos() const override { return RSoA; }
+  PosType getOneParticlePos(size_t iat) const override { return RSoA[iat]; }
+
+  /// all particle positions in AoSoA tiles
+  const PosVectorAoSoA& getAllParticlePosTiles() const { return RAoSoA; }
+
+private:
+  ///particle positions in SoA layout
+  PosVectorSoa RSoA;
+  ///particle positions in AoSoA layout
+  PosVectorAoSoA RAoSoA;
+};
+} // namespace qmcplusplus
+#endif
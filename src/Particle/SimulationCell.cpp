@@ -49,6 +49,12 @@ void SimulationCell::resetLRBox()
     }
     LRBox_.reset();
     LRBox_.SetLRCutoffs(LRBox_.Rv);
+    if (LRBox_.LR_dim_cutoff_auto)
+    {
+      LRBox_.tuneLRCutoffs(LRBox_.Volume, app_log());
+      lattice_.LR_dim_cutoff = LRBox_.LR_dim_cutoff;
+      lattice_.SetLRCutoffs(lattice_.Rv);
+    }
     LRBox_.printCutoffs(app_log());
 
     if (changed)
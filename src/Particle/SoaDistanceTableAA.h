@@ -14,6 +14,7 @@
 #define QMCPLUSPLUS_DTDIMPL_AA_H
 
 #include "Lattice/ParticleBConds3DSoa.h"
+#include "computeDistancesAoSoA.h"
 #include "DistanceTable.h"
 #include "CPU/SIMD/algorithm.hpp"
 
@@ -80,10 +81,16 @@ struct SoaDistanceTableAA : public DTD_BConds<T, D, SC>, public DistanceTableAA
   inline void evaluate(ParticleSet& P) override
   {
     ScopedTimer local_timer(evaluate_timer_);
-    constexpr T BigR = std::numeric_limits<T>::max();
+    if (modes_ & DTModes::LAZY_FULL_TABLE)
+    {
+      // rows are recomputed when they are read
+      row_stale_.assign(num_targets_, 1);
+      return;
+    }
+    row_stale_.clear();
     for (int iat = 1; iat < num_targets_; ++iat)
-      DTD_BConds<T, D, SC>::computeDistances(P.R[iat], P.getCoordinates().getAllParticlePos(), distances_[iat].data(),
-                                             displacements_[iat], 0, iat, iat);
+      computeDistancesFrom(bconds(), P.getCoordinates(), P.R[iat], distances_[iat].data(), displacements_[iat], 0, iat,
+                           iat);
   }
 
   ///evaluate the temporary pair relations
@@ -94,20 +101,20 @@ struct SoaDistanceTableAA : public DTD_BConds<T, D, SC>, public DistanceTableAA
 #if !defined(NDEBUG)
     old_prepared_elec_id_ = prepare_old ? iat : -1;
 #endif
-    DTD_BConds<T, D, SC>::computeDistances(rnew, P.getCoordinates().getAllParticlePos(), temp_r_.data(), temp_dr_, 0,
-                                           num_targets_, iat);
+    computeDistancesFrom(bconds(), P.getCoordinates(), rnew, temp_r_.data(), temp_dr_, 0, num_targets_, iat);
     // set up old_r_ and old_dr_ for moves may get accepted.
     if (prepare_old)
     {
       //recompute from scratch
-      DTD_BConds<T, D, SC>::computeDistances(P.R[iat], P.getCoordinates().getAllParticlePos(), old_r_.data(), old_dr_,
-                                             0, num_targets_, iat);
+      computeDistancesFrom(bconds(), P.getCoordinates(), P.R[iat], old_r_.data(), old_dr_, 0, num_targets_, iat);
       old_r_[iat] = std::numeric_limits<T>::max(); //assign a big number
     }
   }
 
   int get_first_neighbor(IndexType iat, RealType& r, PosType& dr, bool newpos) const override
   {
+    if (!newpos)
+      refreshAllRows();
     //ensure there are neighbors
     assert(num_targets_ > 1);
     RealType min_dist = std::numeric_limits<RealType>::max();
@@ -166,6 +173,8 @@ struct SoaDistanceTableAA : public DTD_BConds<T, D, SC>, public DistanceTableAA
       distances_[i][iat]     = temp_r_[i];
       displacements_[i](iat) = -temp_dr_[i];
     }
+    if (!row_stale_.empty())
+      row_stale_[iat] = 0;
   }
 
   void updatePartial(IndexType jat, bool from_temp) override
@@ -190,9 +199,24 @@ struct SoaDistanceTableAA : public DTD_BConds<T, D, SC>, public DistanceTableAA
       for (int idim = 0; idim < D; ++idim)
         std::copy_n(old_dr_.data(idim), nupdate, displacements_[jat].data(idim));
     }
+    if (!row_stale_.empty())
+      row_stale_[jat] = 0;
+  }
+
+protected:
+  /// recompute the iel-th row from the positions held by the target particle set
+  void evaluateRow(int iel) const override
+  {
+    ScopedTimer local_timer(evaluate_timer_);
+    const auto& coords = origin_.getCoordinates();
+    computeDistancesFrom(bconds(), coords, coords.getOneParticlePos(iel), distances_[iel].data(), displacements_[iel], 0,
+                         iel, iel);
   }
 
 private:
+  /// the boundary conditions, computing the distances
+  inline const DTD_BConds<T, D, SC>& bconds() const { return *this; }
+
   ///number of targets with padding
   const size_t num_targets_padded_;
 #if !defined(NDEBUG)
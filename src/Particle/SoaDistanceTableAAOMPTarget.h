@@ -50,11 +50,16 @@ struct SoaDistanceTableAAOMPTarget : public DTD_BConds<T, D, SC>, public Distanc
 
     Vector<const RealType*, OMPallocator<const RealType*, PinnedAlignedAllocator<const RealType*>>> rsoa_dev_list;
 
-    DTAAMultiWalkerMem() : Resource("DTAAMultiWalkerMem") {}
+    ///memory needed for each walker by the buffers above
+    const size_t bytes_per_walker;
 
-    DTAAMultiWalkerMem(const DTAAMultiWalkerMem&) : DTAAMultiWalkerMem() {}
+    DTAAMultiWalkerMem(size_t bytes) : Resource("DTAAMultiWalkerMem"), bytes_per_walker(bytes) {}
+
+    DTAAMultiWalkerMem(const DTAAMultiWalkerMem& ref) : DTAAMultiWalkerMem(ref.bytes_per_walker) {}
 
     Resource* makeClone() const override { return new DTAAMultiWalkerMem(*this); }
+
+    size_t getMemoryPerWalker() const override { return bytes_per_walker; }
   };
 
   std::unique_ptr<DTAAMultiWalkerMem> mw_mem_;
@@ -118,7 +123,9 @@ struct SoaDistanceTableAAOMPTarget : public DTD_BConds<T, D, SC>, public Distanc
 
   void createResource(ResourceCollection& collection) const override
   {
-    auto resource_index = collection.addResource(std::make_unique<DTAAMultiWalkerMem>());
+    // temporary and old pairs plus the device pointer to positions of each walker
+    const size_t bytes_per_walker = 2 * num_targets_padded_ * (D + 1) * sizeof(RealType) + sizeof(const RealType*);
+    auto resource_index           = collection.addResource(std::make_unique<DTAAMultiWalkerMem>(bytes_per_walker));
   }
 
   void acquireResource(ResourceCollection& collection, const RefVectorWithLeader<DistanceTable>& dt_list) const override
@@ -13,9 +13,12 @@
 #ifndef QMCPLUSPLUS_DTDIMPL_AB_H
 #define QMCPLUSPLUS_DTDIMPL_AB_H
 
+#include <numeric>
 #include "Lattice/ParticleBConds3DSoa.h"
+#include "computeDistancesAoSoA.h"
 #include "Utilities/FairDivide.h"
 #include "Concurrency/OpenMP.h"
+#include "CellList.h"
 
 namespace qmcplusplus
 {
@@ -64,10 +67,37 @@ struct SoaDistanceTableAB : public DTD_BConds<T, D, SC>, public DistanceTableAB
   SoaDistanceTableAB()                          = delete;
   SoaDistanceTableAB(const SoaDistanceTableAB&) = delete;
 
-  /** evaluate the full table */
+  bool enableNeighborList(RealType rcut, RealType skin) override
+  {
+    if (rcut > neighbor_rcut_ || skin > neighbor_skin_)
+    {
+      neighbor_rcut_ = std::max(rcut, neighbor_rcut_);
+      neighbor_skin_ = std::max(skin, neighbor_skin_);
+      // list all the sources until the next evaluate() since the table may already be up to date
+      // and consumers may read it without another evaluate(). Verlet lists are invalidated.
+      std::vector<int> all_sources(num_sources_);
+      std::iota(all_sources.begin(), all_sources.end(), 0);
+      neighbor_ids_.assign(num_targets_, all_sources);
+      neighbor_ref_pos_.assign(num_targets_, PosType(std::numeric_limits<RealType>::max()));
+      row_partial_.assign(num_targets_, 0);
+      row_pos_.resize(num_targets_);
+      cell_list_.build(origin_.getLattice(), neighbor_rcut_ + neighbor_skin_, origin_.R);
+    }
+    return true;
+  }
+
+  /** evaluate the full table
+   *  With neighbor lists, only the distances to the sources in the cells around each target are computed.
+   */
   inline void evaluate(ParticleSet& P) override
   {
     ScopedTimer local_timer(evaluate_timer_);
+    if (hasNeighborList())
+    {
+      evaluateNeighbors(P);
+      return;
+    }
+
 #pragma omp parallel
     {
       int first, last;
@@ -75,22 +105,75 @@ struct SoaDistanceTableAB : public DTD_BConds<T, D, SC>, public DistanceTableAB
 
       //be aware of the sign of Displacement
       for (int iat = 0; iat < num_targets_; ++iat)
-        DTD_BConds<T, D, SC>::computeDistances(P.R[iat], origin_.getCoordinates().getAllParticlePos(),
-                                               distances_[iat].data(), displacements_[iat], first, last);
+        computeDistancesFrom(bconds(), origin_.getCoordinates(), P.R[iat], distances_[iat].data(),
+                             displacements_[iat], first, last);
     }
   }
 
-  ///evaluate the temporary pair relations
+  /** evaluate the full tables of a walker batch
+   * The target particles of all the walkers are flattened and distributed over threads in a single pass
+   * instead of opening a parallel region per walker. This favors batches with many walkers and a few targets,
+   * for example, virtual particle sets holding the quadrature points of nonlocal pseudopotentials.
+   */
+  void mw_evaluate(const RefVectorWithLeader<DistanceTable>& dt_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override
+  {
+    const size_t nw = dt_list.size();
+    if (nw == 1)
+    {
+      dt_list[0].evaluate(p_list[0]);
+      return;
+    }
+
+    auto& dt_leader = dt_list.getCastedLeader<SoaDistanceTableAB>();
+    ScopedTimer local_timer(dt_leader.evaluate_timer_);
+
+    if (dt_leader.hasNeighborList())
+    {
+#pragma omp parallel for
+      for (size_t iw = 0; iw < nw; iw++)
+        dt_list.getCastedElement<SoaDistanceTableAB>(iw).evaluateNeighbors(p_list[iw]);
+      return;
+    }
+
+    // offsets of each walker in the flattened list of target particles
+    std::vector<size_t> offsets(nw + 1, 0);
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      auto& dt        = dt_list.getCastedElement<SoaDistanceTableAB>(iw);
+      offsets[iw + 1] = offsets[iw] + (dt.num_sources_ > 0 ? dt.num_targets_ : 0);
+    }
+
+#pragma omp parallel for
+    for (size_t irow = 0; irow < offsets[nw]; irow++)
+    {
+      const size_t iw = std::upper_bound(offsets.begin(), offsets.end(), irow) - offsets.begin() - 1;
+      const int iat   = irow - offsets[iw];
+      auto& dt        = dt_list.getCastedElement<SoaDistanceTableAB>(iw);
+      computeDistancesFrom(dt.bconds(), dt.origin_.getCoordinates(), p_list[iw].R[iat], dt.distances_[iat].data(),
+                           dt.displacements_[iat], 0, dt.num_sources_);
+    }
+  }
+
+  /** evaluate the temporary pair relations
+   *  With neighbor lists, only the distances to the sources in the cells around rnew are computed,
+   *  or only those to the sources in the Verlet list while it is valid.
+   */
   inline void move(const ParticleSet& P, const PosType& rnew, const IndexType iat, bool prepare_old) override
   {
     ScopedTimer local_timer(move_timer_);
-    DTD_BConds<T, D, SC>::computeDistances(rnew, origin_.getCoordinates().getAllParticlePos(), temp_r_.data(), temp_dr_,
-                                           0, num_sources_);
+    if (hasNeighborList())
+    {
+      moveNeighbors(P, rnew, iat, prepare_old);
+      return;
+    }
+
+    computeDistancesFrom(bconds(), origin_.getCoordinates(), rnew, temp_r_.data(), temp_dr_, 0, num_sources_);
     // If the full table is not ready all the time, overwrite the current value.
     // If this step is missing, DT values can be undefined in case a move is rejected.
     if (!(modes_ & DTModes::NEED_FULL_TABLE_ANYTIME) && prepare_old)
-      DTD_BConds<T, D, SC>::computeDistances(P.R[iat], origin_.getCoordinates().getAllParticlePos(),
-                                             distances_[iat].data(), displacements_[iat], 0, num_sources_);
+      computeDistancesFrom(bconds(), origin_.getCoordinates(), P.R[iat], distances_[iat].data(), displacements_[iat], 0,
+                           num_sources_);
   }
 
   ///update the stripe for jat-th particle
@@ -100,6 +183,13 @@ struct SoaDistanceTableAB : public DTD_BConds<T, D, SC>, public DistanceTableAB
     std::copy_n(temp_r_.data(), num_sources_, distances_[iat].data());
     for (int idim = 0; idim < D; ++idim)
       std::copy_n(temp_dr_.data(idim), num_sources_, displacements_[iat].data(idim));
+    if (hasNeighborList())
+    {
+      neighbor_ids_[iat]     = temp_neighbor_ids_;
+      neighbor_ref_pos_[iat] = temp_neighbor_ref_pos_;
+      row_partial_[iat]      = temp_partial_;
+      row_pos_[iat]          = temp_pos_;
+    }
   }
 
   int get_first_neighbor(IndexType iat, RealType& r, PosType& dr, bool newpos) const override
@@ -108,10 +198,11 @@ struct SoaDistanceTableAB : public DTD_BConds<T, D, SC>, public DistanceTableAB
     int index         = -1;
     if (newpos)
     {
+      const auto& dist = getTempDists();
       for (int jat = 0; jat < num_sources_; ++jat)
-        if (temp_r_[jat] < min_dist)
+        if (dist[jat] < min_dist)
         {
-          min_dist = temp_r_[jat];
+          min_dist = dist[jat];
           index    = jat;
         }
       if (index >= 0)
@@ -122,10 +213,11 @@ struct SoaDistanceTableAB : public DTD_BConds<T, D, SC>, public DistanceTableAB
     }
     else
     {
+      const auto& dist = getDistRow(iat);
       for (int jat = 0; jat < num_sources_; ++jat)
-        if (distances_[iat][jat] < min_dist)
+        if (dist[jat] < min_dist)
         {
-          min_dist = distances_[iat][jat];
+          min_dist = dist[jat];
           index    = jat;
         }
       if (index >= 0)
@@ -138,7 +230,143 @@ struct SoaDistanceTableAB : public DTD_BConds<T, D, SC>, public DistanceTableAB
     return index;
   }
 
+protected:
+  void completeRow(int iel) const override
+  {
+    computeDistancesFrom(bconds(), origin_.getCoordinates(), row_pos_[iel], distances_[iel].data(),
+                         displacements_[iel], 0, num_sources_);
+  }
+
+  void completeTempRow() const override
+  {
+    computeDistancesFrom(bconds(), origin_.getCoordinates(), temp_pos_, temp_r_.data(), temp_dr_, 0, num_sources_);
+  }
+
 private:
+  /// the boundary conditions, computing the distances
+  inline const DTD_BConds<T, D, SC>& bconds() const { return *this; }
+
+  /// positions of the listed sources and their distances and displacements, gathered for the SoA kernel
+  struct GatherScratch
+  {
+    VectorSoaContainer<T, D> pos;
+    DistRow r;
+    DisplRow dr;
+  };
+
+  /// binning of source particles for neighbor lists
+  CellList<RealType, D> cell_list_;
+  /// scratch space of neighbor candidates for move()
+  std::vector<int> candidates_;
+  /// scratch space of the gathered sources for move()
+  GatherScratch scratch_;
+  /// positions of target particles when their neighbor lists were built
+  std::vector<PosType> neighbor_ref_pos_;
+  /// the position where the neighbor list of the proposed move was built
+  PosType temp_neighbor_ref_pos_;
+  /// positions of target particles when their partial rows were computed
+  std::vector<PosType> row_pos_;
+  /// the proposed position
+  PosType temp_pos_;
+
+  /** compute the distances and displacements from pos to the sources in ids only
+   * The entries of the other sources in dist and displ are left untouched.
+   */
+  template<typename PT>
+  inline void computeDistancesTo(const PT& pos,
+                                 const std::vector<int>& ids,
+                                 T* restrict dist,
+                                 DisplRow& displ,
+                                 GatherScratch& scratch) const
+  {
+    const int n = ids.size();
+    if (scratch.pos.size() < n)
+    {
+      scratch.pos.resize(n);
+      scratch.r.resize(getAlignedSize<T>(n));
+      scratch.dr.resize(n);
+    }
+    for (int i = 0; i < n; ++i)
+      for (int idim = 0; idim < D; ++idim)
+        scratch.pos.data(idim)[i] = origin_.R[ids[i]][idim];
+    bconds().computeDistances(pos, scratch.pos, scratch.r.data(), scratch.dr, 0, n);
+    for (int i = 0; i < n; ++i)
+    {
+      dist[ids[i]] = scratch.r[i];
+      for (int idim = 0; idim < D; ++idim)
+        displ.data(idim)[ids[i]] = scratch.dr.data(idim)[i];
+    }
+  }
+
+  /** compute the partial rows and rebuild the cell list and the neighbor lists of all the target particles
+   * @param P the target particle set
+   */
+  void evaluateNeighbors(const ParticleSet& P)
+  {
+    // source particles may have moved since the last evaluation
+    cell_list_.build(origin_.getLattice(), neighbor_rcut_ + neighbor_skin_, origin_.R);
+#pragma omp parallel
+    {
+      std::vector<int> candidates;
+      GatherScratch scratch;
+#pragma omp for
+      for (int iat = 0; iat < num_targets_; ++iat)
+      {
+        cell_list_.getCandidates(P.R[iat], candidates);
+        computeDistancesTo(P.R[iat], candidates, distances_[iat].data(), displacements_[iat], scratch);
+        selectNeighbors(distances_[iat], candidates, neighbor_ids_[iat]);
+        neighbor_ref_pos_[iat] = P.R[iat];
+        row_pos_[iat]          = P.R[iat];
+        row_partial_[iat]      = 1;
+      }
+    }
+  }
+
+  /// move() with neighbor lists
+  inline void moveNeighbors(const ParticleSet& P, const PosType& rnew, const IndexType iat, bool prepare_old)
+  {
+    const PosType ref_dr = rnew - neighbor_ref_pos_[iat];
+    if (neighbor_skin_ > 0 && dot(ref_dr, ref_dr) < neighbor_skin_ * neighbor_skin_ * 0.25)
+    {
+      // Verlet list is still valid
+      temp_neighbor_ids_     = neighbor_ids_[iat];
+      temp_neighbor_ref_pos_ = neighbor_ref_pos_[iat];
+      computeDistancesTo(rnew, temp_neighbor_ids_, temp_r_.data(), temp_dr_, scratch_);
+    }
+    else
+    {
+      cell_list_.getCandidates(rnew, candidates_);
+      computeDistancesTo(rnew, candidates_, temp_r_.data(), temp_dr_, scratch_);
+      selectNeighbors(temp_r_, candidates_, temp_neighbor_ids_);
+      temp_neighbor_ref_pos_ = rnew;
+    }
+    temp_pos_     = rnew;
+    temp_partial_ = true;
+
+    // the current list holds all the sources within the list cutoff of P.R[iat]
+    if (!(modes_ & DTModes::NEED_FULL_TABLE_ANYTIME) && prepare_old)
+    {
+      computeDistancesTo(P.R[iat], neighbor_ids_[iat], distances_[iat].data(), displacements_[iat], scratch_);
+      row_pos_[iat]     = P.R[iat];
+      row_partial_[iat] = 1;
+    }
+  }
+
+  /** select source particles within the neighbor list cutoff plus skin
+   * @param dist distances between the target particle and the candidates
+   * @param candidates IDs of the sources in the cells around the target particle
+   * @param neighbors output sorted neighbor IDs
+   */
+  inline void selectNeighbors(const DistRow& dist, const std::vector<int>& candidates, std::vector<int>& neighbors) const
+  {
+    neighbors.clear();
+    const RealType rlist = neighbor_rcut_ + neighbor_skin_;
+    for (const int jat : candidates)
+      if (dist[jat] < rlist)
+        neighbors.push_back(jat);
+    std::sort(neighbors.begin(), neighbors.end());
+  }
+
   /// timer for evaluate()
   NewTimer& evaluate_timer_;
   /// timer for move()
@@ -19,6 +19,7 @@
 #include "OMPTarget/OMPallocator.hpp"
 #include "Platforms/PinnedAllocator.h"
 #include "Particle/RealSpacePositionsOMPTarget.h"
+#include "OMPTarget/ScopedDefaultDevice.h"
 #include "ResourceCollection.h"
 
 namespace qmcplusplus
@@ -45,12 +46,19 @@ private:
     OffloadPinnedVector<T> mw_r_dr;
     ///accelerator input buffer for multiple data set
     OffloadPinnedVector<char> offload_input;
+    ///copy of the source positions when they are not on the device of the crowd
+    OffloadPinnedVector<RealType> source_pos_copy;
 
-    DTABMultiWalkerMem() : Resource("DTABMultiWalkerMem") {}
+    ///memory needed for each walker by the buffers above
+    const size_t bytes_per_walker;
 
-    DTABMultiWalkerMem(const DTABMultiWalkerMem&) : DTABMultiWalkerMem() {}
+    DTABMultiWalkerMem(size_t bytes) : Resource("DTABMultiWalkerMem"), bytes_per_walker(bytes) {}
+
+    DTABMultiWalkerMem(const DTABMultiWalkerMem& ref) : DTABMultiWalkerMem(ref.bytes_per_walker) {}
 
     Resource* makeClone() const override { return new DTABMultiWalkerMem(*this); }
+
+    size_t getMemoryPerWalker() const override { return bytes_per_walker; }
   };
 
   std::unique_ptr<DTABMultiWalkerMem> mw_mem_;
@@ -145,7 +153,10 @@ public:
 
   void createResource(ResourceCollection& collection) const override
   {
-    auto resource_index = collection.addResource(std::make_unique<DTABMultiWalkerMem>());
+    // full table of each walker plus the offload input of mw_evaluate: target positions, walker IDs and source pointers
+    const size_t bytes_per_walker = num_targets_ * getPerTargetPctlStrideSize() * sizeof(T) +
+        num_targets_ * (D * sizeof(RealType) + sizeof(int)) + sizeof(RealType*);
+    auto resource_index = collection.addResource(std::make_unique<DTABMultiWalkerMem>(bytes_per_walker));
   }
 
   void acquireResource(ResourceCollection& collection, const RefVectorWithLeader<DistanceTable>& dt_list) const override
@@ -280,6 +291,20 @@ public:
     auto walker_id_ptr =
         reinterpret_cast<int*>(offload_input.data() + ptr_size * nw + total_targets * D * realtype_size);
 
+    // the sources shared by the walkers stay on the device they were created on.
+    // A crowd running on another device transfers them to its own buffer.
+    auto& leader_sources    = static_cast<const RealSpacePositionsOMPTarget&>(dt_leader.origin_.getCoordinates());
+    auto* leader_source_ptr = const_cast<RealType*>(leader_sources.getDevicePtr());
+    const auto& leader_source_pos = leader_sources.getAllParticlePos();
+    if (!isPresentOnDefaultDevice(leader_source_pos.data()))
+    {
+      auto& source_pos_copy = mw_mem.source_pos_copy;
+      source_pos_copy.resize(leader_source_pos.capacity() * D);
+      std::copy_n(leader_source_pos.data(), source_pos_copy.size(), source_pos_copy.data());
+      source_pos_copy.updateTo();
+      leader_source_ptr = source_pos_copy.device_data();
+    }
+
     count_targets = 0;
     for (size_t iw = 0; iw < nw; iw++)
     {
@@ -290,7 +315,8 @@ public:
       assert(num_sources_ == dt.num_sources_);
 
       auto& RSoA_OMPTarget = static_cast<const RealSpacePositionsOMPTarget&>(dt.origin_.getCoordinates());
-      source_ptrs[iw]      = const_cast<RealType*>(RSoA_OMPTarget.getDevicePtr());
+      source_ptrs[iw]      = &RSoA_OMPTarget == &leader_sources ? leader_source_ptr
+                                                                : const_cast<RealType*>(RSoA_OMPTarget.getDevicePtr());
 
       for (size_t iat = 0; iat < pset.getTotalNum(); ++iat, ++count_targets)
       {
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_SPACEFILLINGCURVE_H
+#define QMCPLUSPLUS_SPACEFILLINGCURVE_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include "OhmmsPETE/TinyVector.h"
+
+namespace qmcplusplus
+{
+namespace SpaceFillingCurve
+{
+/// number of bits of each coordinate in a 3D Morton key
+constexpr int MORTON_BITS = 21;
+
+/// spread the lowest MORTON_BITS bits of x such that there are two zero bits between consecutive bits
+inline uint64_t spreadBits3(uint64_t x)
+{
+  x &= (uint64_t(1) << MORTON_BITS) - 1;
+  x = (x | x << 32) & 0x1f00000000ffffULL;
+  x = (x | x << 16) & 0x1f0000ff0000ffULL;
+  x = (x | x << 8) & 0x100f00f00f00f00fULL;
+  x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+  x = (x | x << 2) & 0x1249249249249249ULL;
+  return x;
+}
+
+/// Morton (Z-order) key of 3D integer coordinates
+inline uint64_t mortonKey(uint32_t ix, uint32_t iy, uint32_t iz)
+{
+  return spreadBits3(ix) | (spreadBits3(iy) << 1) | (spreadBits3(iz) << 2);
+}
+
+/** compute the permutation sorting particles [first, last) along a Z-order curve
+ * @param lattice the simulation cell
+ * @param R particle positions in Cartesian coordinates
+ * @param first first particle
+ * @param last one past the last particle
+ * @param perm output, perm[i - first] is the particle placed at the i-th position
+ *
+ * With periodic boundary conditions in all the directions, keys are computed from reduced coordinates wrapped into the cell.
+ * Otherwise, the Cartesian bounding box of the particles is used.
+ */
+template<typename LAT, typename POS>
+void getZOrderPermutation(const LAT& lattice, const POS& R, int first, int last, std::vector<int>& perm)
+{
+  using T              = typename LAT::Scalar_t;
+  constexpr unsigned D = LAT::DIM;
+  static_assert(D == 3, "Z-order keys are only implemented in 3D");
+
+  const int n = last - first;
+  perm.resize(n);
+  std::iota(perm.begin(), perm.end(), first);
+  if (n < 2)
+    return;
+
+  bool all_periodic = true;
+  for (int idim = 0; idim < D; idim++)
+    if (!lattice.BoxBConds[idim])
+      all_periodic = false;
+
+  std::vector<TinyVector<T, D>> u(n);
+  for (int i = 0; i < n; i++)
+    u[i] = all_periodic ? lattice.toUnit(R[first + i]) : TinyVector<T, D>(R[first + i]);
+
+  TinyVector<T, D> lower(0), inv_extent(1);
+  if (all_periodic)
+    for (int i = 0; i < n; i++)
+      for (int idim = 0; idim < D; idim++)
+        u[i][idim] -= std::floor(u[i][idim]);
+  else
+  {
+    TinyVector<T, D> upper(std::numeric_limits<T>::lowest());
+    lower = std::numeric_limits<T>::max();
+    for (int i = 0; i < n; i++)
+      for (int idim = 0; idim < D; idim++)
+      {
+        lower[idim] = std::min(lower[idim], u[i][idim]);
+        upper[idim] = std::max(upper[idim], u[i][idim]);
+      }
+    for (int idim = 0; idim < D; idim++)
+      inv_extent[idim] = upper[idim] > lower[idim] ? T(1) / (upper[idim] - lower[idim]) : T(0);
+  }
+
+  const T scale = static_cast<T>((uint64_t(1) << MORTON_BITS) - 1);
+  std::vector<uint64_t> keys(n);
+  for (int i = 0; i < n; i++)
+  {
+    uint32_t ix[D];
+    for (int idim = 0; idim < D; idim++)
+    {
+      const T s = std::min(T(1), std::max(T(0), (u[i][idim] - lower[idim]) * inv_extent[idim]));
+      ix[idim]  = static_cast<uint32_t>(s * scale);
+    }
+    keys[i] = mortonKey(ix[0], ix[1], ix[2]);
+  }
+
+  std::stable_sort(perm.begin(), perm.end(), [&](int a, int b) { return keys[a - first] < keys[b - first]; });
+}
+
+} // namespace SpaceFillingCurve
+} // namespace qmcplusplus
+#endif
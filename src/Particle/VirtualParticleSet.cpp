@@ -44,7 +44,9 @@ VirtualParticleSet::VirtualParticleSet(const ParticleSet& p, int nptcl) : Partic
   //initialize local data structure
   TotalNum = nptcl;
   R.resize(nptcl);
+  spins.resize(nptcl);
   coordinates_->resize(nptcl);
+  setSpinor(p.isSpinor());
 
   //create distancetables
   for (int i = 0; i < refPS.getNumDistTables(); ++i)
@@ -154,4 +156,92 @@ void VirtualParticleSet::mw_makeMoves(const RefVectorWithLeader<VirtualParticleS
   ParticleSet::mw_update(p_list);
 }
 
+void VirtualParticleSet::mw_makeMovesOnSphere(const RefVectorWithLeader<VirtualParticleSet>& vp_list,
+                                              const RefVector<const std::vector<PosType>>& rot_grid_list,
+                                              const RefVector<std::vector<PosType>>& deltaV_list,
+                                              const RefVector<const NLPPJob<RealType>>& joblist)
+{
+  auto& vp_leader    = vp_list.getLeader();
+  vp_leader.onSphere = true;
+
+  const size_t nVPs = countVPs(vp_list);
+  auto& mw_refPctls = vp_leader.getMultiWalkerRefPctls();
+  mw_refPctls.resize(nVPs);
+
+  RefVectorWithLeader<ParticleSet> p_list(vp_leader);
+  p_list.reserve(vp_list.size());
+
+  size_t ivp = 0;
+  for (int iw = 0; iw < vp_list.size(); iw++)
+  {
+    VirtualParticleSet& vp(vp_list[iw]);
+    const NLPPJob<RealType>& job(joblist[iw]);
+    const size_t nknot = vp.R.size();
+    assert(rot_grid_list[iw].get().size() == nknot);
+    assert(deltaV_list[iw].get().size() == nknot);
+
+    vp.onSphere      = true;
+    vp.refPtcl       = job.electron_id;
+    vp.refSourcePtcl = job.ion_id;
+
+    // flat views of the AoS positions, OHMMS_DIM consecutive components per point
+    const RealType* restrict rot = &rot_grid_list[iw].get()[0][0];
+    RealType* restrict dv        = &deltaV_list[iw].get()[0][0];
+    RealType* restrict pos       = &vp.R[0][0];
+    const RealType r             = job.ion_elec_dist;
+    for (int d = 0; d < OHMMS_DIM; d++)
+    {
+      const RealType displ = job.ion_elec_displ[d];
+      const RealType ref   = job.elec_pos[d];
+#pragma omp simd
+      for (size_t k = 0; k < nknot; k++)
+      {
+        const RealType delta   = r * rot[k * OHMMS_DIM + d] - displ;
+        dv[k * OHMMS_DIM + d]  = delta;
+        pos[k * OHMMS_DIM + d] = ref + delta;
+      }
+    }
+
+    for (size_t k = 0; k < nknot; k++, ivp++)
+      mw_refPctls[ivp] = vp.refPtcl;
+    p_list.push_back(vp);
+  }
+  assert(ivp == nVPs);
+
+  mw_refPctls.updateTo();
+  ParticleSet::mw_update(p_list);
+}
+
+void VirtualParticleSet::makeMovesWithSpin(int jel,
+                                           const PosType& ref_pos,
+                                           const std::vector<PosType>& deltaV,
+                                           const std::vector<RealType>& deltaS,
+                                           bool sphere,
+                                           int iat)
+{
+  assert(spins.size() == deltaS.size());
+  for (size_t ivp = 0; ivp < spins.size(); ivp++)
+    spins[ivp] = refPS.spins[jel] + deltaS[ivp];
+  makeMoves(jel, ref_pos, deltaV, sphere, iat);
+}
+
+void VirtualParticleSet::mw_makeMovesWithSpin(const RefVectorWithLeader<VirtualParticleSet>& vp_list,
+                                              const RefVector<const std::vector<PosType>>& deltaV_list,
+                                              const RefVector<const std::vector<RealType>>& deltaS_list,
+                                              const RefVector<const NLPPJob<RealType>>& joblist,
+                                              bool sphere)
+{
+  for (int iw = 0; iw < vp_list.size(); iw++)
+  {
+    VirtualParticleSet& vp(vp_list[iw]);
+    const std::vector<RealType>& deltaS(deltaS_list[iw]);
+    const NLPPJob<RealType>& job(joblist[iw]);
+    const RealType ref_spin = vp.refPS.spins[job.electron_id];
+    assert(vp.spins.size() == deltaS.size());
+    for (size_t k = 0; k < vp.spins.size(); k++)
+      vp.spins[k] = ref_spin + deltaS[k];
+  }
+  mw_makeMoves(vp_list, deltaV_list, joblist, sphere);
+}
+
 } // namespace qmcplusplus
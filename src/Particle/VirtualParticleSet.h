@@ -91,6 +91,40 @@ public:
                            const RefVector<const NLPPJob<RealType>>& joblist,
                            bool sphere);
 
+  /** move the virtual particles of a crowd onto the quadrature spheres around the ions of their jobs
+     * @param rot_grid_list unit vectors of the rotated quadrature points of each job
+     * @param deltaV_list returns the position deltas from the reference electrons
+     *
+     * deltaV[k] = ion_elec_dist * rot_grid[k] - ion_elec_displ and R[k] = elec_pos + deltaV[k] are
+     * computed in one pass over all the jobs and stored directly, same as building deltaV and calling
+     * mw_makeMoves with sphere = true.
+     */
+  static void mw_makeMovesOnSphere(const RefVectorWithLeader<VirtualParticleSet>& vp_list,
+                                   const RefVector<const std::vector<PosType>>& rot_grid_list,
+                                   const RefVector<std::vector<PosType>>& deltaV_list,
+                                   const RefVector<const NLPPJob<RealType>>& joblist);
+
+  /** move virtual particles to new postions and spins and update distance tables
+     * @param jel reference particle that all the VP moves from
+     * @param ref_pos reference particle position
+     * @param deltaV Position delta for virtual moves.
+     * @param deltaS Spin delta for virtual moves, relative to the spin of jel in refPS.
+     * @param sphere set true if VP are on a sphere around the reference source particle
+     * @param iat reference source particle
+     */
+  void makeMovesWithSpin(int jel,
+                         const PosType& ref_pos,
+                         const std::vector<PosType>& deltaV,
+                         const std::vector<RealType>& deltaS,
+                         bool sphere = false,
+                         int iat     = -1);
+
+  static void mw_makeMovesWithSpin(const RefVectorWithLeader<VirtualParticleSet>& vp_list,
+                                   const RefVector<const std::vector<PosType>>& deltaV_list,
+                                   const RefVector<const std::vector<RealType>>& deltaS_list,
+                                   const RefVector<const NLPPJob<RealType>>& joblist,
+                                   bool sphere);
+
   static RefVectorWithLeader<ParticleSet> RefVectorWithLeaderParticleSet(
       const RefVectorWithLeader<VirtualParticleSet>& vp_list)
   {
@@ -32,6 +32,7 @@
 #include "CUDA_legacy/gpu_vector.h"
 #endif
 #include <assert.h>
+#include <array>
 #include <deque>
 namespace qmcplusplus
 {
@@ -141,6 +142,8 @@ public:
   ///buffer for the data for particle-by-particle update
   WFBuffer_t DataSet;
   size_t block_end, scalar_end;
+  ///end of the arrays in the compact message, see getCompactMessageRanges
+  size_t compact_end;
 
   // This is very useful for debugging transfer damage to walkers
 #ifndef NDEBUG
@@ -312,8 +315,9 @@ public:
     //Drift = a.Drift;
     Properties.copy(a.Properties);
     DataSet    = a.DataSet;
-    block_end  = a.block_end;
-    scalar_end = a.scalar_end;
+    block_end   = a.block_end;
+    scalar_end  = a.scalar_end;
+    compact_end = a.compact_end;
     if (PropertyHistory.size() != a.PropertyHistory.size())
       PropertyHistory.resize(a.PropertyHistory.size());
     for (int i = 0; i < PropertyHistory.size(); i++)
@@ -434,6 +438,18 @@ public:
     return DataSet.byteSize();
   }
 
+  /** byte ranges of DataSet holding the compact message
+   *
+   * The compact message is the walker state without G and L, which the receiver has to recompute.
+   * It is made of the arrays before compact_end and the scalars of the walker.
+   * @return offset and byte size of the two ranges
+   */
+  std::array<std::pair<size_t, size_t>, 2> getCompactMessageRanges() const
+  {
+    return {std::make_pair(size_t(0), compact_end),
+            std::make_pair(size_t(DataSet.scalar_offset()), scalar_end * sizeof(FullPrecRealType))};
+  }
+
   void registerData()
   {
     // walker data must be placed at the beginning
@@ -450,12 +466,6 @@ public:
     DataSet.add(R.first_address(), R.last_address());
     assert(spins.size() != 0);
     DataSet.add(spins.first_address(), spins.last_address());
-#if !defined(SOA_MEMORY_OPTIMIZED)
-    assert(G.size() != 0);
-    DataSet.add(G.first_address(), G.last_address());
-    assert(L.size() != 0);
-    DataSet.add(L.first_address(), L.last_address());
-#endif
     //Don't add the nLocal but the actual allocated size.  We want to register once for the life of a
     //walker so we leave space for additional properties.
     DataSet.add(Properties.data(), Properties.data() + Properties.capacity());
@@ -465,6 +475,14 @@ public:
     for (int iat = 0; iat < PropertyHistory.size(); iat++)
       DataSet.add(PropertyHistory[iat].data(), PropertyHistory[iat].data() + PropertyHistory[iat].size());
     DataSet.add(PHindex.data(), PHindex.data() + PHindex.size());
+    // the data below can be recomputed from the above
+    compact_end = DataSet.current();
+#if !defined(SOA_MEMORY_OPTIMIZED)
+    assert(G.size() != 0);
+    DataSet.add(G.first_address(), G.last_address());
+    assert(L.size() != 0);
+    DataSet.add(L.first_address(), L.last_address());
+#endif
 #ifdef QMC_CUDA
     size_t size = cuda_DataSet.size();
     size_t N    = R_GPU.size();
@@ -481,7 +499,10 @@ public:
     scalar_end = DataSet.current_scalar();
   }
 
-  void copyFromBuffer()
+  /** unpack DataSet
+   * @param compact if true, DataSet holds only the compact message and G, L are left untouched
+   */
+  void copyFromBuffer(bool compact = false)
   {
     assert(DataSet.size() != 0);
     DataSet.rewind();
@@ -491,16 +512,19 @@ public:
     DataSet.get(R.first_address(), R.last_address());
     assert(spins.size() != 0);
     DataSet.get(spins.first_address(), spins.last_address());
+    DataSet.get(Properties.data(), Properties.data() + Properties.capacity());
+    for (int iat = 0; iat < PropertyHistory.size(); iat++)
+      DataSet.get(PropertyHistory[iat].data(), PropertyHistory[iat].data() + PropertyHistory[iat].size());
+    DataSet.get(PHindex.data(), PHindex.data() + PHindex.size());
+    assert(compact_end == DataSet.current());
+    if (compact)
+      return;
 #if !defined(SOA_MEMORY_OPTIMIZED)
     assert(G.size() != 0);
     DataSet.get(G.first_address(), G.last_address());
     assert(L.size() != 0);
     DataSet.get(L.first_address(), L.last_address());
 #endif
-    DataSet.get(Properties.data(), Properties.data() + Properties.capacity());
-    for (int iat = 0; iat < PropertyHistory.size(); iat++)
-      DataSet.get(PropertyHistory[iat].data(), PropertyHistory[iat].data() + PropertyHistory[iat].size());
-    DataSet.get(PHindex.data(), PHindex.data() + PHindex.size());
 #ifdef QMC_CUDA
     // Unpack GPU data
     std::vector<CTS::ValueType> host_data;
@@ -543,14 +567,14 @@ public:
     // vectors
     DataSet.put(R.first_address(), R.last_address());
     DataSet.put(spins.first_address(), spins.last_address());
-#if !defined(SOA_MEMORY_OPTIMIZED)
-    DataSet.put(G.first_address(), G.last_address());
-    DataSet.put(L.first_address(), L.last_address());
-#endif
     DataSet.put(Properties.data(), Properties.data() + Properties.capacity());
     for (int iat = 0; iat < PropertyHistory.size(); iat++)
       DataSet.put(PropertyHistory[iat].data(), PropertyHistory[iat].data() + PropertyHistory[iat].size());
     DataSet.put(PHindex.data(), PHindex.data() + PHindex.size());
+#if !defined(SOA_MEMORY_OPTIMIZED)
+    DataSet.put(G.first_address(), G.last_address());
+    DataSet.put(L.first_address(), L.last_address());
+#endif
 #ifdef QMC_CUDA
     // Pack GPU data
     std::vector<CTS::ValueType> host_data;
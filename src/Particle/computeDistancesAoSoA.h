@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_COMPUTE_DISTANCES_AOSOA_H
+#define QMCPLUSPLUS_COMPUTE_DISTANCES_AOSOA_H
+
+#include <algorithm>
+#include "OhmmsSoA/VectorAoSoAContainer.h"
+#include "Particle/RealSpacePositionsAoSoA.h"
+
+namespace qmcplusplus
+{
+/** computeDistances of the DTD_BConds with the sources in AoSoA tiles
+ * @param bconds DTD_BConds providing the SoA kernel
+ * @param pos the position to compute the distances from
+ * @param R0 the source positions in tiles
+ * @param temp_r distances, indexed by the sources as in the SoA kernel
+ * @param temp_dr displacements, indexed by the sources as in the SoA kernel
+ * @param first first source
+ * @param last one past the last source
+ * @param flip_ind the displacements of the sources from flip_ind are flipped
+ *
+ * The SoA kernel runs on one tile at a time, the outputs stay in the SoA layout of the tables.
+ */
+template<typename BCONDS, typename PT, typename T, unsigned D, unsigned TILE, typename A, typename DISPLSOA>
+void computeDistancesAoSoA(const BCONDS& bconds,
+                           const PT& pos,
+                           const VectorAoSoAContainer<T, D, TILE, A>& R0,
+                           T* restrict temp_r,
+                           DISPLSOA& temp_dr,
+                           int first,
+                           int last,
+                           int flip_ind = 0)
+{
+  for (int t = first / TILE; t * int(TILE) < last; ++t)
+  {
+    const int offset = t * TILE;
+    const auto tile  = R0.getTileSoA(t);
+    VectorSoaContainer<T, D> tile_dr(temp_dr.data() + offset, TILE, temp_dr.capacity());
+    bconds.computeDistances(pos, tile, temp_r + offset, tile_dr, std::max(first - offset, 0),
+                            std::min(last - offset, int(TILE)), flip_ind - offset);
+  }
+}
+
+/** computeDistances of the DTD_BConds with the sources in coords, from the AoSoA tiles when coords has them
+ *
+ * The distance tables of the host call this instead of bconds.computeDistances(pos, coords.getAllParticlePos(), ...)
+ */
+template<typename BCONDS, typename PT, typename T, typename DISPLSOA>
+inline void computeDistancesFrom(const BCONDS& bconds,
+                                 const DynamicCoordinates& coords,
+                                 const PT& pos,
+                                 T* restrict temp_r,
+                                 DISPLSOA& temp_dr,
+                                 int first,
+                                 int last,
+                                 int flip_ind = 0)
+{
+  if (coords.getKind() == DynamicCoordinateKind::DC_POS_AOSOA)
+    computeDistancesAoSoA(bconds, pos, static_cast<const RealSpacePositionsAoSoA&>(coords).getAllParticlePosTiles(),
+                          temp_r, temp_dr, first, last, flip_ind);
+  else
+    bconds.computeDistances(pos, coords.getAllParticlePos(), temp_r, temp_dr, first, last, flip_ind);
+}
+
+} // namespace qmcplusplus
+#endif
@@ -49,4 +49,60 @@ TEST_CASE("SoaDistanceTableAA compute_size", "[distance_table]")
       CHECK(dt_ee.compute_size(i) == ref_results[i]);
   }
 }
+
+TEST_CASE("SoaDistanceTableAA lazy rows", "[distance_table]")
+{
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+  elec.setName("e");
+  elec.create({3, 2});
+  elec.R[0] = {0.1, 0.2, 0.3};
+  elec.R[1] = {-0.5, 0.7, 0.0};
+  elec.R[2] = {1.2, -0.3, 0.4};
+  elec.R[3] = {0.0, 0.9, -1.1};
+  elec.R[4] = {0.6, 0.6, 0.6};
+
+  ParticleSet elec_lazy(elec);
+  const int ee_id      = elec.addTable(elec);
+  const int ee_lazy_id = elec_lazy.addTable(elec_lazy, DTModes::LAZY_FULL_TABLE);
+  elec.update();
+  elec_lazy.update();
+
+  const auto& dt_ref  = elec.getDistTableAA(ee_id);
+  const auto& dt_lazy = elec_lazy.getDistTableAA(ee_lazy_id);
+
+  for (int iel = 0; iel < elec.getTotalNum(); iel++)
+    CHECK(!dt_lazy.isRowCurrent(iel));
+
+  // reading a row only computes that row
+  const auto& row3 = dt_lazy.getDistRow(3);
+  CHECK(dt_lazy.isRowCurrent(3));
+  CHECK(!dt_lazy.isRowCurrent(2));
+  for (int jel = 0; jel < 3; jel++)
+    CHECK(row3[jel] == Approx(dt_ref.getDistRow(3)[jel]));
+
+  // an accepted move brings the row of the moved particle up-to-date
+  const ParticleSet::SingleParticlePos displ(0.2, -0.1, 0.3);
+  elec.makeMove(2, displ);
+  elec.acceptMove(2);
+  elec_lazy.makeMove(2, displ);
+  elec_lazy.acceptMove(2);
+  CHECK(dt_lazy.isRowCurrent(2));
+  CHECK(!dt_lazy.isRowCurrent(4));
+
+  for (int iel = 1; iel < elec.getTotalNum(); iel++)
+    for (int jel = 0; jel < iel; jel++)
+    {
+      CHECK(dt_lazy.getDistRow(iel)[jel] == Approx(dt_ref.getDistRow(iel)[jel]));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        CHECK(dt_lazy.getDisplRow(iel)[jel][idim] == Approx(dt_ref.getDisplRow(iel)[jel][idim]));
+    }
+
+  // first neighbor search reads the column and needs all the rows
+  elec_lazy.update();
+  ParticleSet::RealType r_ref, r_lazy;
+  ParticleSet::PosType dr_ref, dr_lazy;
+  CHECK(dt_lazy.get_first_neighbor(1, r_lazy, dr_lazy, false) == dt_ref.get_first_neighbor(1, r_ref, dr_ref, false));
+  CHECK(r_lazy == Approx(r_ref));
+}
 } // namespace qmcplusplus
@@ -20,7 +20,10 @@
 #include "ParticleIO/XMLParticleIO.h"
 #include "ParticleIO/ParticleLayoutIO.h"
 #include "Particle/DistanceTable.h"
+#include "Particle/CellList.h"
+#include "Concurrency/OpenMP.h"
 #include <ResourceCollection.h>
+#include <random>
 #include "MinimalParticlePool.h"
 
 using std::string;
@@ -560,6 +563,15 @@ void test_distance_pbc_z_batched_APIs(DynamicCoordinateKind test_kind)
 
   ResourceCollection pset_res("test_pset_res");
   electrons.createResource(pset_res);
+
+  // only the offload table keeps multi walker buffers, temporary and old pairs plus a position pointer
+  using RealType = ParticleSet::RealType;
+  if (test_kind == DynamicCoordinateKind::DC_POS_OFFLOAD)
+    CHECK(pset_res.getMemoryPerWalker() ==
+          2 * getAlignedSize<RealType>(electrons.getTotalNum()) * 4 * sizeof(RealType) + sizeof(RealType*));
+  else
+    CHECK(pset_res.getMemoryPerWalker() == 0);
+
   ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, p_list);
 
   std::vector<ParticleSet::SingleParticlePos> disp{{0.2, 0.1, 0.3}, {0.2, 0.1, 0.3}};
@@ -667,4 +679,356 @@ TEST_CASE("test_distance_pbc_diamond", "[distance_table][xml]")
   elecs.addTable(elecs);
   elecs.update();
 }
+
+/// brute force search of particles within rcut including all the periodic images
+std::vector<int> find_neighbors_brute_force(const CrystalLattice<double, 3>& lattice,
+                                            const std::vector<TinyVector<double, 3>>& pos,
+                                            const TinyVector<double, 3>& r,
+                                            double rcut)
+{
+  const int nimage = lattice.SuperCellEnum == SUPERCELL_OPEN ? 0 : 2;
+  std::vector<int> neighbors;
+  for (int iat = 0; iat < pos.size(); iat++)
+  {
+    double min_dist = std::numeric_limits<double>::max();
+    for (int i = -nimage; i <= nimage; i++)
+      for (int j = -nimage; j <= nimage; j++)
+        for (int k = -nimage; k <= nimage; k++)
+        {
+          const TinyVector<double, 3> dr = pos[iat] - r + lattice.toCart(TinyVector<double, 3>(i, j, k));
+          min_dist                       = std::min(min_dist, std::sqrt(dot(dr, dr)));
+        }
+    if (min_dist < rcut)
+      neighbors.push_back(iat);
+  }
+  return neighbors;
+}
+
+void test_cell_list_candidates(const CrystalLattice<double, 3>& lattice, double rcut, double spread)
+{
+  std::mt19937 rng(13);
+  std::uniform_real_distribution<double> uniform(0, 1);
+
+  std::vector<TinyVector<double, 3>> pos(300);
+  for (auto& r : pos)
+    r = lattice.SuperCellEnum == SUPERCELL_OPEN
+        ? TinyVector<double, 3>(uniform(rng), uniform(rng), uniform(rng)) * spread
+        : lattice.toCart(TinyVector<double, 3>(uniform(rng), uniform(rng), uniform(rng)));
+
+  CellList<double, 3> cells;
+  cells.build(lattice, rcut, pos);
+
+  std::vector<int> candidates;
+  for (int iq = 0; iq < 50; iq++)
+  {
+    const TinyVector<double, 3> r = lattice.SuperCellEnum == SUPERCELL_OPEN
+        ? TinyVector<double, 3>(uniform(rng), uniform(rng), uniform(rng)) * (spread + 2 * rcut) - rcut
+        : lattice.toCart(TinyVector<double, 3>(uniform(rng), uniform(rng), uniform(rng)) * 3.0 - 1.0);
+    cells.getCandidates(r, candidates);
+    // no duplicated candidates
+    std::sort(candidates.begin(), candidates.end());
+    CHECK(std::adjacent_find(candidates.begin(), candidates.end()) == candidates.end());
+    // all the neighbors are in the candidate list
+    for (const int iat : find_neighbors_brute_force(lattice, pos, r, rcut))
+      CHECK(std::binary_search(candidates.begin(), candidates.end(), iat));
+  }
+}
+
+TEST_CASE("CellList candidates", "[distance_table]")
+{
+  SECTION("triclinic periodic cell")
+  {
+    CrystalLattice<double, 3> lattice;
+    lattice.BoxBConds = true;
+    lattice.R         = Tensor<double, 3>(12.0, 0.0, 0.0, 3.0, 11.0, 0.0, 1.5, -2.0, 13.0);
+    lattice.reset();
+    test_cell_list_candidates(lattice, 2.5, 0);
+    CellList<double, 3> cells;
+    cells.build(lattice, 2.5, std::vector<TinyVector<double, 3>>(1));
+    CHECK(cells.getNumCells()[0] == 4);
+  }
+
+  SECTION("open boundary conditions")
+  {
+    CrystalLattice<double, 3> lattice;
+    lattice.BoxBConds = false;
+    lattice.reset();
+    test_cell_list_candidates(lattice, 1.5, 10.0);
+  }
+}
+
+TEST_CASE("distance_pbc_z neighbor lists", "[distance_table][xml]")
+{
+  const SimulationCell simulation_cell(parse_pbc_lattice());
+  ParticleSet ions(simulation_cell), electrons(simulation_cell);
+  parse_electron_ion_pbc_z(ions, electrons);
+
+  const double rcut  = 3.2;
+  const int ei_tid   = electrons.addTable(ions);
+  const auto& dtable = electrons.getDistTableAB(ei_tid);
+  CHECK(!dtable.hasNeighborList());
+  REQUIRE(electrons.enableNeighborList(ei_tid, rcut));
+  CHECK(dtable.hasNeighborList());
+  CHECK(dtable.getNeighborCutoff() == Approx(rcut));
+  // before the next evaluate, the lists conservatively hold all the sources
+  for (int iel = 0; iel < electrons.getTotalNum(); iel++)
+    CHECK(dtable.getNeighborIDs(iel).size() == dtable.sources());
+  ions.update();
+  electrons.update();
+
+  auto check_neighbors = [&](const std::vector<int>& neighbors, const DistanceTableAB::DistRow& dist) {
+    std::vector<int> ref;
+    for (int jat = 0; jat < dtable.sources(); jat++)
+      if (dist[jat] < rcut)
+        ref.push_back(jat);
+    CHECK(neighbors == ref);
+  };
+
+  for (int iel = 0; iel < electrons.getTotalNum(); iel++)
+  {
+    // only the distances to the listed sources are computed until the full row is read
+    CHECK(!dtable.isRowComplete(iel));
+    const auto& ids = dtable.getNeighborIDs(iel);
+    std::vector<double> listed;
+    for (const int jat : ids)
+      listed.push_back(dtable.getNeighborDistRow(iel)[jat]);
+    check_neighbors(ids, dtable.getDistRow(iel));
+    CHECK(dtable.isRowComplete(iel));
+    for (int i = 0; i < ids.size(); i++)
+      CHECK(listed[i] == Approx(dtable.getDistRow(iel)[ids[i]]));
+  }
+  // electron 0 sits on ion 0, neighbors are ion 0 and its six images at distance 3
+  CHECK(dtable.getNeighborIDs(0) == std::vector<int>{0, 1, 2, 4});
+
+  ParticleSet::SingleParticlePos disp(1.4, 1.4, 0.1);
+  electrons.makeMove(0, disp);
+  check_neighbors(dtable.getTempNeighborIDs(), dtable.getTempDists());
+  CHECK(dtable.getTempNeighborIDs() == std::vector<int>{0, 1, 2, 3});
+  electrons.acceptMove(0);
+  CHECK(dtable.getNeighborIDs(0) == std::vector<int>{0, 1, 2, 3});
+
+  // a clone keeps the neighbor list request
+  ParticleSet electrons_clone(electrons);
+  CHECK(electrons_clone.getDistTableAB(ei_tid).getNeighborCutoff() == Approx(rcut));
+}
+
+TEST_CASE("distance_pbc_z Verlet neighbor lists", "[distance_table][xml]")
+{
+  const SimulationCell simulation_cell(parse_pbc_lattice());
+  ParticleSet ions(simulation_cell), electrons(simulation_cell);
+  parse_electron_ion_pbc_z(ions, electrons);
+
+  const double rcut  = 2.5;
+  const double skin  = 1.0;
+  const int ei_tid   = electrons.addTable(ions);
+  const auto& dtable = electrons.getDistTableAB(ei_tid);
+  REQUIRE(electrons.enableNeighborList(ei_tid, rcut, skin));
+  CHECK(dtable.getNeighborSkin() == Approx(skin));
+  ions.update();
+  electrons.update();
+
+  // all the sources within rcut must be listed
+  auto check_superset = [&](const std::vector<int>& neighbors, const DistanceTableAB::DistRow& dist) {
+    for (int jat = 0; jat < dtable.sources(); jat++)
+      if (dist[jat] < rcut)
+        CHECK(std::binary_search(neighbors.begin(), neighbors.end(), jat));
+  };
+
+  CHECK(dtable.getNeighborIDs(0) == std::vector<int>{0, 1, 2, 4});
+
+  // a small displacement reuses the list
+  ParticleSet::SingleParticlePos disp(0.2, 0.1, 0.0);
+  electrons.makeMove(0, disp);
+  check_superset(dtable.getTempNeighborIDs(), dtable.getTempDists());
+  CHECK(dtable.getTempNeighborIDs() == std::vector<int>{0, 1, 2, 4});
+  electrons.acceptMove(0);
+
+  // a large displacement rebuilds the list
+  disp = {1.4, 1.4, 0.1};
+  electrons.makeMove(0, disp);
+  check_superset(dtable.getTempNeighborIDs(), dtable.getTempDists());
+  CHECK(dtable.getTempNeighborIDs() == std::vector<int>{0, 1, 2, 3});
+  electrons.rejectMove(0);
+  CHECK(dtable.getNeighborIDs(0) == std::vector<int>{0, 1, 2, 4});
+  check_superset(dtable.getNeighborIDs(0), dtable.getDistRow(0));
+
+  // batched accept/reject keeps lists current
+  ParticleSet electrons_clone(electrons);
+  electrons_clone.update();
+  RefVectorWithLeader<ParticleSet> p_list(electrons);
+  p_list.push_back(electrons);
+  p_list.push_back(electrons_clone);
+  ResourceCollection pset_res("test_pset_res");
+  electrons.createResource(pset_res);
+  ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, p_list);
+
+  std::vector<ParticleSet::SingleParticlePos> displs{{1.4, 1.4, 0.1}, {1.4, 1.4, 0.1}};
+  ParticleSet::mw_makeMove(p_list, 0, displs);
+  ParticleSet::mw_accept_rejectMove(p_list, 0, {true, false});
+  const auto& dtable_clone = electrons_clone.getDistTableAB(ei_tid);
+  CHECK(dtable.getNeighborIDs(0) == std::vector<int>{0, 1, 2, 3});
+  CHECK(dtable_clone.getNeighborIDs(0) == std::vector<int>{0, 1, 2, 4});
+  for (int iel = 0; iel < electrons.getTotalNum(); iel++)
+  {
+    check_superset(dtable.getNeighborIDs(iel), dtable.getDistRow(iel));
+    check_superset(dtable_clone.getNeighborIDs(iel), dtable_clone.getDistRow(iel));
+  }
+}
+
+TEST_CASE("distance_pbc_z AB mw_evaluate", "[distance_table][xml]")
+{
+  const SimulationCell simulation_cell(parse_pbc_lattice());
+  ParticleSet ions(simulation_cell), electrons(simulation_cell);
+  parse_electron_ion_pbc_z(ions, electrons);
+
+  const int ei_tid = electrons.addTable(ions);
+  electrons.enableNeighborList(ei_tid, 2.5);
+  ions.update();
+
+  ParticleSet electrons_clone(electrons);
+  electrons_clone.R[0] = {1.0, 2.0, 0.5};
+  electrons_clone.R[2] = {-0.3, 4.0, 7.5};
+  ParticleSet electrons_ref(electrons_clone);
+
+  RefVectorWithLeader<ParticleSet> p_list(electrons);
+  p_list.push_back(electrons);
+  p_list.push_back(electrons_clone);
+  ParticleSet::mw_update(p_list);
+  electrons_ref.update();
+
+  const auto& dtable     = electrons_clone.getDistTableAB(ei_tid);
+  const auto& dtable_ref = electrons_ref.getDistTableAB(ei_tid);
+  for (int iel = 0; iel < electrons.getTotalNum(); iel++)
+  {
+    for (int iat = 0; iat < ions.getTotalNum(); iat++)
+    {
+      CHECK(dtable.getDistRow(iel)[iat] == Approx(dtable_ref.getDistRow(iel)[iat]));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        CHECK(dtable.getDisplRow(iel)[iat][idim] == Approx(dtable_ref.getDisplRow(iel)[iat][idim]));
+    }
+    CHECK(dtable.getNeighborIDs(iel) == dtable_ref.getNeighborIDs(iel));
+  }
+  CHECK(dtable.getDistRow(0)[0] == Approx(std::sqrt(5.25)));
+}
+
+TEST_CASE("distance_pbc_z mw_update", "[distance_table][xml]")
+{
+  const SimulationCell simulation_cell(parse_pbc_lattice());
+  ParticleSet ions(simulation_cell), electrons(simulation_cell);
+  parse_electron_ion_pbc_z(ions, electrons);
+
+  const int ee_tid = electrons.addTable(electrons);
+  const int ei_tid = electrons.addTable(ions);
+  ions.update();
+
+  // enough walkers to take the per walker single sweep path on any number of threads
+  const int num_walkers = std::max(3, omp_get_max_threads());
+  std::vector<std::unique_ptr<ParticleSet>> walkers, walkers_ref;
+  RefVectorWithLeader<ParticleSet> p_list(electrons);
+  for (int iw = 0; iw < num_walkers; iw++)
+  {
+    walkers.push_back(std::make_unique<ParticleSet>(electrons));
+    walkers[iw]->R[1] += ParticleSet::SingleParticlePos(0.1 * iw, -0.2 * iw, 0.3);
+    walkers_ref.push_back(std::make_unique<ParticleSet>(*walkers[iw]));
+    walkers_ref[iw]->update();
+    p_list.push_back(*walkers[iw]);
+  }
+  ParticleSet::mw_update(p_list);
+
+  for (int iw = 0; iw < num_walkers; iw++)
+  {
+    const auto& ee     = walkers[iw]->getDistTableAA(ee_tid);
+    const auto& ee_ref = walkers_ref[iw]->getDistTableAA(ee_tid);
+    const auto& ei     = walkers[iw]->getDistTableAB(ei_tid);
+    const auto& ei_ref = walkers_ref[iw]->getDistTableAB(ei_tid);
+    for (int iel = 0; iel < electrons.getTotalNum(); iel++)
+    {
+      CHECK(walkers[iw]->getCoordinates().getAllParticlePos()[iel][2] == Approx(walkers_ref[iw]->R[iel][2]));
+      for (int jel = 0; jel < iel; jel++)
+        CHECK(ee.getDistRow(iel)[jel] == Approx(ee_ref.getDistRow(iel)[jel]));
+      for (int iat = 0; iat < ions.getTotalNum(); iat++)
+        CHECK(ei.getDistRow(iel)[iat] == Approx(ei_ref.getDistRow(iel)[iat]));
+    }
+  }
+}
+
+TEST_CASE("distance_pbc AoSoA positions", "[distance_table][xml]")
+{
+  const SimulationCell simulation_cell(parse_pbc_lattice());
+  const auto& lattice = simulation_cell.getLattice();
+
+  // a few tiles of particles with a partial one
+  ParticleSet ions(simulation_cell, DynamicCoordinateKind::DC_POS_AOSOA), ions_ref(simulation_cell);
+  ParticleSet electrons(simulation_cell, DynamicCoordinateKind::DC_POS_AOSOA), electrons_ref(simulation_cell);
+  ions.setName("ion");
+  ions_ref.setName("ion");
+  electrons.setName("e");
+  electrons_ref.setName("e");
+  ions.create({11});
+  electrons.create({13, 8});
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  for (int iat = 0; iat < ions.getTotalNum(); iat++)
+    ions.R[iat] = lattice.toCart(TinyVector<double, 3>(uniform(rng), uniform(rng), uniform(rng)));
+  for (int iel = 0; iel < electrons.getTotalNum(); iel++)
+    electrons.R[iel] = lattice.toCart(TinyVector<double, 3>(uniform(rng), uniform(rng), uniform(rng)));
+  ions_ref.create({11});
+  electrons_ref.create({13, 8});
+  ions_ref.R      = ions.R;
+  electrons_ref.R = electrons.R;
+
+  const int ee_tid = electrons.addTable(electrons);
+  const int ei_tid = electrons.addTable(ions);
+  electrons_ref.addTable(electrons_ref);
+  electrons_ref.addTable(ions_ref);
+  ions.update();
+  ions_ref.update();
+  electrons.update();
+  electrons_ref.update();
+
+  const auto& ee     = electrons.getDistTableAA(ee_tid);
+  const auto& ee_ref = electrons_ref.getDistTableAA(ee_tid);
+  const auto& ei     = electrons.getDistTableAB(ei_tid);
+  const auto& ei_ref = electrons_ref.getDistTableAB(ei_tid);
+  for (int iel = 0; iel < electrons.getTotalNum(); iel++)
+  {
+    for (int jel = 0; jel < iel; jel++)
+    {
+      CHECK(ee.getDistRow(iel)[jel] == Approx(ee_ref.getDistRow(iel)[jel]));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        CHECK(ee.getDisplRow(iel)[jel][idim] == Approx(ee_ref.getDisplRow(iel)[jel][idim]));
+    }
+    for (int iat = 0; iat < ions.getTotalNum(); iat++)
+    {
+      CHECK(ei.getDistRow(iel)[iat] == Approx(ei_ref.getDistRow(iel)[iat]));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        CHECK(ei.getDisplRow(iel)[iat][idim] == Approx(ei_ref.getDisplRow(iel)[iat][idim]));
+    }
+  }
+
+  // moves update the tiles
+  const ParticleSet::SingleParticlePos disp(0.3, -0.2, 0.4);
+  for (int iel : {2, 17})
+  {
+    electrons.makeMove(iel, disp);
+    electrons_ref.makeMove(iel, disp);
+    for (int jel = 0; jel < electrons.getTotalNum(); jel++)
+      if (jel != iel)
+      {
+        CHECK(ee.getTempDists()[jel] == Approx(ee_ref.getTempDists()[jel]));
+        CHECK(ee.getOldDists()[jel] == Approx(ee_ref.getOldDists()[jel]));
+        for (int idim = 0; idim < OHMMS_DIM; idim++)
+          CHECK(ee.getTempDispls()[jel][idim] == Approx(ee_ref.getTempDispls()[jel][idim]));
+      }
+    for (int iat = 0; iat < ions.getTotalNum(); iat++)
+      CHECK(ei.getTempDists()[iat] == Approx(ei_ref.getTempDists()[iat]));
+    electrons.accept_rejectMove(iel, true);
+    electrons_ref.accept_rejectMove(iel, true);
+  }
+  electrons.donePbyP();
+  electrons_ref.donePbyP();
+  for (int iel = 0; iel < electrons.getTotalNum(); iel++)
+    for (int jel = 0; jel < iel; jel++)
+      CHECK(ee.getDistRow(iel)[jel] == Approx(ee_ref.getDistRow(iel)[jel]));
+}
 } // namespace qmcplusplus
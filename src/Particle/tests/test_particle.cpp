@@ -18,6 +18,7 @@
 #include "Lattice/ParticleBConds.h"
 #include "Particle/ParticleSet.h"
 #include "Particle/DistanceTable.h"
+#include "Particle/SpaceFillingCurve.h"
 
 
 #include <stdio.h>
@@ -188,4 +189,55 @@ TEST_CASE("particle set lattice with vacuum", "[particle]")
   }
 }
 
+TEST_CASE("Z-order sorting of walkers", "[particle]")
+{
+  CHECK(SpaceFillingCurve::mortonKey(1, 0, 0) == 1);
+  CHECK(SpaceFillingCurve::mortonKey(0, 1, 0) == 2);
+  CHECK(SpaceFillingCurve::mortonKey(0, 0, 1) == 4);
+  CHECK(SpaceFillingCurve::mortonKey(3, 0, 0) == 9);
+  CHECK(SpaceFillingCurve::mortonKey(1, 1, 1) == 7);
+
+  // open boundary conditions, sorting within each group
+  const SimulationCell simulation_cell;
+  ParticleSet elecs(simulation_cell);
+  elecs.setName("electrons");
+  elecs.create({3, 2});
+
+  ParticleSet::Walker_t walker(elecs.getTotalNum());
+  walker.R[0] = {2.0, 0.0, 0.0};
+  walker.R[1] = {0.0, 0.0, 0.0};
+  walker.R[2] = {1.0, 0.0, 0.0};
+  walker.R[3] = {0.0, 0.0, 5.0};
+  walker.R[4] = {0.0, 0.0, -5.0};
+  for (int iat = 0; iat < elecs.getTotalNum(); iat++)
+    walker.spins[iat] = iat;
+
+  elecs.sortWalkerByZOrder(walker);
+  CHECK(walker.R[0][0] == Approx(0.0));
+  CHECK(walker.R[1][0] == Approx(1.0));
+  CHECK(walker.R[2][0] == Approx(2.0));
+  CHECK(walker.R[3][2] == Approx(-5.0));
+  CHECK(walker.R[4][2] == Approx(5.0));
+  CHECK(walker.spins[0] == Approx(1));
+  CHECK(walker.spins[3] == Approx(4));
+
+  // periodic cell, keys use wrapped reduced coordinates
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> lattice;
+  lattice.BoxBConds = true;
+  lattice.R.diagonal(2.0);
+  lattice.reset();
+  const SimulationCell simulation_cell_pbc(lattice);
+  ParticleSet elecs_pbc(simulation_cell_pbc);
+  elecs_pbc.setName("electrons");
+  elecs_pbc.create({3});
+  ParticleSet::Walker_t walker_pbc(elecs_pbc.getTotalNum());
+  walker_pbc.R[0] = {2.5, 0.0, 0.0};
+  walker_pbc.R[1] = {1.5, 0.0, 0.0};
+  walker_pbc.R[2] = {0.1, 0.0, 0.0};
+  elecs_pbc.sortWalkerByZOrder(walker_pbc);
+  CHECK(walker_pbc.R[0][0] == Approx(0.1));
+  CHECK(walker_pbc.R[1][0] == Approx(2.5));
+  CHECK(walker_pbc.R[2][0] == Approx(1.5));
+}
+
 } // namespace qmcplusplus
@@ -20,6 +20,7 @@
 #include "Particle/HDFWalkerInput_0_4.h"
 #include "QMCDrivers/WalkerProperties.h"
 #include "type_traits/template_types.hpp"
+#include "Utilities/FairDivide.h"
 
 #include <stdio.h>
 #include <string>
@@ -104,6 +105,122 @@ TEST_CASE("walker HDF read and write", "[particle]")
   }
 }
 
+TEST_CASE("walker HDF read with a different number of ranks", "[particle]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  // five walkers written by two ranks of a run with a different number of ranks
+  const size_t num_ptcls   = 1;
+  const size_t num_walkers = 5;
+  if (!c->rank())
+  {
+    hdf_archive hout;
+    hout.create("walker_ranks_test.config.h5");
+    HDFVersion cur_version;
+    hout.write(cur_version.version, hdf::version);
+    hout.push(hdf::main_state);
+    hout.write(num_walkers, hdf::num_walkers);
+    std::vector<int> walker_partition{0, 3, 5};
+    hout.write(walker_partition, "walker_partition");
+    std::vector<QMCTraits::RealType> walkers(num_walkers * OHMMS_DIM);
+    for (int iw = 0; iw < num_walkers; iw++)
+      for (int i = 0; i < OHMMS_DIM; i++)
+        walkers[iw * OHMMS_DIM + i] = iw;
+    std::array<size_t, 3> gcounts{num_walkers, num_ptcls, OHMMS_DIM};
+    hout.writeSlabReshaped(walkers, gcounts, hdf::walkers);
+  }
+  c->barrier();
+
+  WalkerConfigurations wc_list;
+  HDFVersion version(0, 4);
+  HDFWalkerInput_0_4 hinp(wc_list, num_ptcls, c, version);
+  REQUIRE(hinp.read_hdf5("walker_ranks_test"));
+
+  // each rank only reads its share of the walkers
+  std::vector<int> woffsets(c->size() + 1);
+  FairDivideLow(num_walkers, c->size(), woffsets);
+  REQUIRE(wc_list.getActiveWalkers() == woffsets[c->rank() + 1] - woffsets[c->rank()]);
+  for (int iw = 0; iw < wc_list.getActiveWalkers(); iw++)
+    CHECK(wc_list[iw]->R[0][0] == Approx(woffsets[c->rank()] + iw));
+}
+
+TEST_CASE("walker HDF asynchronous write", "[particle]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  const size_t num_ptcls = 1;
+  WalkerConfigurations wc_list;
+  wc_list.createWalkers(2, num_ptcls);
+  wc_list[0]->R[0] = 1.0;
+  wc_list[1]->R[0] = 0.5;
+
+  std::vector<int> walker_offset(c->size() + 1);
+  for (int i = 0; i <= c->size(); i++)
+    walker_offset[i] = 2 * i;
+  wc_list.setWalkerOffsets(walker_offset);
+
+  c->setName("walker_async_test");
+  HDFWalkerOutput hout(num_ptcls, "", c);
+  // falls back to synchronous writes without a thread safe HDF5 library
+  hout.setAsync(true);
+  hout.dump(wc_list, 0);
+  // the walkers can change while the previous dump is written
+  wc_list[0]->R[0] = 2.0;
+  hout.dump(wc_list, 1);
+  wc_list[1]->R[0] = 3.0;
+  hout.waitForDump();
+
+  c->barrier();
+
+  WalkerConfigurations wc_list2;
+  HDFVersion version(0, 4);
+  HDFWalkerInput_0_4 hinp(wc_list2, num_ptcls, c, version);
+  REQUIRE(hinp.read_hdf5("walker_async_test"));
+
+  REQUIRE(wc_list2.getActiveWalkers() == 2);
+  for (int i = 0; i < 3; i++)
+  {
+    CHECK(wc_list2[0]->R[0][i] == Approx(2.0));
+    CHECK(wc_list2[1]->R[0][i] == Approx(0.5));
+  }
+}
+
+TEST_CASE("walker HDF aggregated write and read", "[particle]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  const size_t num_ptcls = 1;
+  WalkerConfigurations wc_list;
+  wc_list.createWalkers(2, num_ptcls);
+  wc_list[0]->R[0] = c->rank() + 1.0;
+  wc_list[1]->R[0] = c->rank() + 0.5;
+
+  std::vector<int> walker_offset(c->size() + 1);
+  for (int i = 0; i <= c->size(); i++)
+    walker_offset[i] = 2 * i;
+  wc_list.setWalkerOffsets(walker_offset);
+
+  c->setName("walker_aggregated_test");
+  HDFWalkerOutput hout(num_ptcls, "", c);
+  hout.setAggregated(true);
+  hout.dump(wc_list, 3);
+
+  c->barrier();
+
+  WalkerConfigurations wc_list2;
+  HDFVersion version(0, 4);
+  HDFWalkerInput_0_4 hinp(wc_list2, num_ptcls, c, version);
+  REQUIRE(hinp.is_aggregated("walker_aggregated_test"));
+  REQUIRE(hinp.read_aggregated("walker_aggregated_test"));
+
+  REQUIRE(wc_list2.getActiveWalkers() == 2);
+  for (int i = 0; i < 3; i++)
+  {
+    CHECK(wc_list2[0]->R[0][i] == Approx(c->rank() + 1.0));
+    CHECK(wc_list2[1]->R[0][i] == Approx(c->rank() + 0.5));
+  }
+}
+
 TEST_CASE("walker buffer add, update, restore", "[particle]")
 {
   int num_particles = 4;
@@ -128,4 +245,37 @@ TEST_CASE("walker buffer add, update, restore", "[particle]")
   CHECK(walkers[1]->Properties(WP::LOCALPOTENTIAL) == Approx(1.6));
 }
 
+TEST_CASE("walker buffer compact message", "[particle]")
+{
+  int num_particles = 4;
+
+  UPtrVector<MCPWalker> walkers(2);
+  for (auto& walker : walkers)
+  {
+    walker = std::make_unique<MCPWalker>(num_particles);
+    walker->registerData();
+    walker->DataSet.allocate();
+  }
+
+  walkers[0]->ID                     = 7;
+  walkers[0]->Age                    = 3;
+  walkers[0]->R[2]                   = {0.1, 0.2, 0.3};
+  walkers[0]->G[2]                   = {1.0, 2.0, 3.0};
+  walkers[0]->Properties(WP::LOGPSI) = 1.2;
+  walkers[0]->updateBuffer();
+  walkers[1]->G[2] = {-1.0, -2.0, -3.0};
+
+  // G and L are not in the message
+  const auto ranges = walkers[0]->getCompactMessageRanges();
+  CHECK(ranges[0].second + ranges[1].second < walkers[0]->DataSet.size());
+  for (const auto& [offset, byte_size] : ranges)
+    std::memcpy(walkers[1]->DataSet.data() + offset, walkers[0]->DataSet.data() + offset, byte_size);
+  walkers[1]->copyFromBuffer(true);
+  CHECK(walkers[1]->ID == 7);
+  CHECK(walkers[1]->Age == 3);
+  CHECK(walkers[1]->R[2][1] == Approx(0.2));
+  CHECK(walkers[1]->Properties(WP::LOGPSI) == Approx(1.2));
+  CHECK(walkers[1]->G[2][0] == ValueApprox(-1.0));
+}
+
 } // namespace qmcplusplus
@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file LargePageAllocator.hpp
+ */
+#ifndef QMCPLUSPLUS_LARGE_PAGE_ALLOCATOR_H
+#define QMCPLUSPLUS_LARGE_PAGE_ALLOCATOR_H
+
+#include "config.h"
+#include "Mallocator.hpp"
+#include "Platforms/Host/LargePages.h"
+
+namespace qmcplusplus
+{
+/** aligned allocator of the large read-only tables, spline coefficients among them
+ *
+ * The allocations follow the LargePageOptions current when they are made, see ScopedLargePageOptions.
+ * With the default options or for the sizes too small for huge pages, it is the aligned allocator.
+ */
+template<typename T, size_t ALIGN = QMC_SIMD_ALIGNMENT>
+struct LargePageAllocator : public Mallocator<T, ALIGN>
+{
+  static_assert(ALIGN <= 4096, "LargePageAllocator cannot align beyond a page.");
+
+  using value_type    = T;
+  using size_type     = size_t;
+  using pointer       = T*;
+  using const_pointer = const T*;
+
+  LargePageAllocator() = default;
+  template<class U>
+  LargePageAllocator(const LargePageAllocator<U, ALIGN>&)
+  {}
+
+  template<class U>
+  struct rebind
+  {
+    using other = LargePageAllocator<U, ALIGN>;
+  };
+
+  T* allocate(std::size_t n)
+  {
+    if (void* pt = allocateLargePages(n * sizeof(T)))
+      return static_cast<T*>(pt);
+    return Mallocator<T, ALIGN>::allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n)
+  {
+    if (!deallocateLargePages(p))
+      Mallocator<T, ALIGN>::deallocate(p, n);
+  }
+};
+
+template<class T1, size_t ALIGN1, class T2, size_t ALIGN2>
+bool operator==(const LargePageAllocator<T1, ALIGN1>&, const LargePageAllocator<T2, ALIGN2>&)
+{
+  return ALIGN1 == ALIGN2;
+}
+template<class T1, size_t ALIGN1, class T2, size_t ALIGN2>
+bool operator!=(const LargePageAllocator<T1, ALIGN1>&, const LargePageAllocator<T2, ALIGN2>&)
+{
+  return ALIGN1 != ALIGN2;
+}
+} // namespace qmcplusplus
+
+#endif
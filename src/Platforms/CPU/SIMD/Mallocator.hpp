@@ -18,6 +18,7 @@
 #include <string>
 #include <stdexcept>
 #include <string>
+#include "MemoryAccounting.h"
 
 namespace qmcplusplus
 {
@@ -68,6 +69,7 @@ struct Mallocator
     if (pt == nullptr)
       throw std::runtime_error("Allocation failed in Mallocator, requested size in bytes = " +
                                std::to_string(n * sizeof(T)));
+    getMemoryAccounting().allocate(MemorySpace::HOST, pt, asize);
     return static_cast<T*>(pt);
   }
 
@@ -75,6 +77,11 @@ struct Mallocator
   {
     if (n == 0)
       throw std::runtime_error("Mallocator::deallocate does not accept size 0 allocations.");
+    std::size_t asize = n * sizeof(T);
+    std::size_t amod  = asize % ALIGN;
+    if (amod != 0)
+      asize += ALIGN - amod;
+    getMemoryAccounting().deallocate(MemorySpace::HOST, p, asize);
     free(p);
   }
 };
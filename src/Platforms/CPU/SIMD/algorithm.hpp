@@ -16,6 +16,10 @@
 #ifndef QMCPLUSPLUS_SIMD_ALGORITHM_HPP
 #define QMCPLUSPLUS_SIMD_ALGORITHM_HPP
 
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
 namespace qmcplusplus
 {
 namespace simd
@@ -38,6 +42,117 @@ inline T3 inner_product_n(const T1* restrict a, const T2* restrict b, int n, T3
   return res;
 }
 
+/// branch free implementation of copy_if_less. It writes every entry and only advances the output position for the selected ones.
+template<typename T>
+inline int copy_if_less_serial(const T* restrict in, int n, T limit, int skip, T* restrict out, int* restrict out_index)
+{
+  int count = 0;
+  if (out_index)
+    for (int i = 0; i < n; ++i)
+    {
+      out[count]       = in[i];
+      out_index[count] = i;
+      count += (in[i] < limit) & (i != skip);
+    }
+  else
+    for (int i = 0; i < n; ++i)
+    {
+      out[count] = in[i];
+      count += (in[i] < limit) & (i != skip);
+    }
+  return count;
+}
+
+/** copy the entries in[i] < limit for i in [0, n) except i == skip, and their indices
+ * @param in input array
+ * @param n size of in
+ * @param limit the selected entries are strictly smaller than limit
+ * @param skip index to be excluded. Out of [0, n) to keep all.
+ * @param out selected entries, must hold n entries
+ * @param out_index indices of the selected entries, must hold n entries. Ignored if nullptr.
+ * @return the number of selected entries
+ *
+ * With AVX-512, vectors of entries are packed by masked compress stores.
+ */
+template<typename T>
+inline int copy_if_less(const T* restrict in, int n, T limit, int skip, T* restrict out, int* restrict out_index)
+{
+  return copy_if_less_serial(in, n, limit, skip, out, out_index);
+}
+
+#if defined(__AVX512F__)
+template<>
+inline int copy_if_less(const double* restrict in,
+                        int n,
+                        double limit,
+                        int skip,
+                        double* restrict out,
+                        int* restrict out_index)
+{
+  constexpr int width = 8;
+  const __m512d vlimit = _mm512_set1_pd(limit);
+  // only the lower 8 lanes carry indices
+  __m512i vindex     = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m512i vinc = _mm512_set1_epi32(width);
+  int count          = 0;
+  int i              = 0;
+  for (; i + width <= n; i += width)
+  {
+    const __m512d v = _mm512_loadu_pd(in + i);
+    __mmask8 mask   = _mm512_cmp_pd_mask(v, vlimit, _CMP_LT_OQ);
+    if (skip >= i && skip < i + width)
+      mask &= static_cast<__mmask8>(~(1u << (skip - i)));
+    _mm512_mask_compressstoreu_pd(out + count, mask, v);
+    if (out_index)
+      _mm512_mask_compressstoreu_epi32(out_index + count, static_cast<__mmask16>(mask), vindex);
+    vindex = _mm512_add_epi32(vindex, vinc);
+    count += __builtin_popcount(mask);
+  }
+  // remainder
+  int* restrict rem_index = out_index ? out_index + count : nullptr;
+  const int rem_count     = copy_if_less_serial(in + i, n - i, limit, skip - i, out + count, rem_index);
+  if (out_index)
+    for (int j = 0; j < rem_count; ++j)
+      rem_index[j] += i;
+  return count + rem_count;
+}
+
+template<>
+inline int copy_if_less(const float* restrict in,
+                        int n,
+                        float limit,
+                        int skip,
+                        float* restrict out,
+                        int* restrict out_index)
+{
+  constexpr int width = 16;
+  const __m512 vlimit = _mm512_set1_ps(limit);
+  __m512i vindex      = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m512i vinc  = _mm512_set1_epi32(width);
+  int count           = 0;
+  int i               = 0;
+  for (; i + width <= n; i += width)
+  {
+    const __m512 v = _mm512_loadu_ps(in + i);
+    __mmask16 mask = _mm512_cmp_ps_mask(v, vlimit, _CMP_LT_OQ);
+    if (skip >= i && skip < i + width)
+      mask &= static_cast<__mmask16>(~(1u << (skip - i)));
+    _mm512_mask_compressstoreu_ps(out + count, mask, v);
+    if (out_index)
+      _mm512_mask_compressstoreu_epi32(out_index + count, mask, vindex);
+    vindex = _mm512_add_epi32(vindex, vinc);
+    count += __builtin_popcount(mask);
+  }
+  // remainder
+  int* restrict rem_index = out_index ? out_index + count : nullptr;
+  const int rem_count     = copy_if_less_serial(in + i, n - i, limit, skip - i, out + count, rem_index);
+  if (out_index)
+    for (int j = 0; j < rem_count; ++j)
+      rem_index[j] += i;
+  return count + rem_count;
+}
+#endif
+
 } // namespace simd
 } // namespace qmcplusplus
 #endif
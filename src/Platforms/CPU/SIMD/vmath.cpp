@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "vmath.hpp"
+#include "vpack_math.hpp"
+
+/** clones of the kernels for the runtime ISA dispatch
+ *
+ * The loader picks the clone through an ifunc, which needs the GNU toolchain on x86_64 Linux.
+ * flatten inlines the vpack operations into each clone, otherwise they are shared at the baseline ISA.
+ * Offload compilers are left out, the device compilation has no use of the host clones.
+ */
+#if defined(__x86_64__) && defined(__linux__) && !defined(__INTEL_COMPILER) && !defined(ENABLE_OFFLOAD) && \
+    defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define QMC_VMATH_DISPATCH __attribute__((flatten, target_clones("arch=skylake-avx512", "arch=haswell", "default")))
+#endif
+#endif
+#ifndef QMC_VMATH_DISPATCH
+#define QMC_VMATH_DISPATCH
+#endif
+
+namespace qmcplusplus
+{
+namespace simd
+{
+namespace
+{
+template<typename T>
+inline void sincosKernel(const T* restrict in, T* restrict s, T* restrict c, int n)
+{
+  using P = vpack<T>;
+  P sv, cv;
+  int i = 0;
+  for (; i + P::width <= n; i += P::width)
+  {
+    sincos(P::load(in + i), sv, cv);
+    sv.store(s + i);
+    cv.store(c + i);
+  }
+  if (i < n)
+  {
+    sincos(P::load(in + i, n - i), sv, cv);
+    sv.store(s + i, n - i);
+    cv.store(c + i, n - i);
+  }
+}
+
+template<typename T>
+inline void cisKernel(const T* restrict in, std::complex<T>* restrict out, int n)
+{
+  using P = vpack<T>;
+  P sv, cv;
+  for (int i = 0; i < n; i += P::width)
+  {
+    const int m = n - i < P::width ? n - i : P::width;
+    sincos(m == P::width ? P::load(in + i) : P::load(in + i, m), sv, cv);
+    for (int j = 0; j < m; j++)
+      out[i + j] = std::complex<T>(cv[j], sv[j]);
+  }
+}
+
+template<typename T>
+inline void expKernel(const T* restrict in, T* restrict out, int n)
+{
+  using P = vpack<T>;
+  int i   = 0;
+  for (; i + P::width <= n; i += P::width)
+    exp(P::load(in + i)).store(out + i);
+  if (i < n)
+    exp(P::load(in + i, n - i)).store(out + i, n - i);
+}
+
+template<typename T>
+inline void logKernel(const T* restrict in, T* restrict out, int n)
+{
+  using P = vpack<T>;
+  int i   = 0;
+  for (; i + P::width <= n; i += P::width)
+    log(P::load(in + i)).store(out + i);
+  // the unused lanes are filled with 1 to stay in the domain
+  if (i < n)
+    log(P::load(in + i, n - i, T(1))).store(out + i, n - i);
+}
+} // namespace
+
+QMC_VMATH_DISPATCH void sincos(const double* restrict in, double* restrict s, double* restrict c, int n)
+{
+  sincosKernel(in, s, c, n);
+}
+
+QMC_VMATH_DISPATCH void sincos(const float* restrict in, float* restrict s, float* restrict c, int n)
+{
+  sincosKernel(in, s, c, n);
+}
+
+QMC_VMATH_DISPATCH void cis(const double* restrict in, std::complex<double>* restrict out, int n)
+{
+  cisKernel(in, out, n);
+}
+
+QMC_VMATH_DISPATCH void cis(const float* restrict in, std::complex<float>* restrict out, int n)
+{
+  cisKernel(in, out, n);
+}
+
+QMC_VMATH_DISPATCH void exp(const double* restrict in, double* restrict out, int n) { expKernel(in, out, n); }
+
+QMC_VMATH_DISPATCH void exp(const float* restrict in, float* restrict out, int n) { expKernel(in, out, n); }
+
+QMC_VMATH_DISPATCH void log(const double* restrict in, double* restrict out, int n) { logKernel(in, out, n); }
+
+QMC_VMATH_DISPATCH void log(const float* restrict in, float* restrict out, int n) { logKernel(in, out, n); }
+
+} // namespace simd
+} // namespace qmcplusplus
@@ -21,6 +21,7 @@
 #define QMCPLUSPLUS_VECTORIZED_STDMATH_HPP
 
 #include <cmath>
+#include <complex>
 #if defined(HAVE_MKL_VML)
 #include <mkl_vml_functions.h>
 #elif defined(HAVE_MASSV)
@@ -91,6 +92,27 @@ inline void inv_sqrt(double* in, double* out, int n) { vrsqrt(out, in, &n); }
 inline void inv_sqrt(float* in, float* out, int n) { vsrsqrt(out, in, &n); }
 #endif
 
+/** @name vpack kernels
+ *
+ * Written with vpack and vpack_math.hpp, the vectorization does not depend on the compiler analysis.
+ * On x86_64 Linux each kernel is compiled for AVX-512, AVX2 and the baseline ISA and the widest
+ * supported by the host is selected at load time.
+ */
+///@{
+/// s[i] = sin(in[i]), c[i] = cos(in[i])
+void sincos(const double* restrict in, double* restrict s, double* restrict c, int n);
+void sincos(const float* restrict in, float* restrict s, float* restrict c, int n);
+/// out[i] = cos(in[i]) + i sin(in[i])
+void cis(const double* restrict in, std::complex<double>* restrict out, int n);
+void cis(const float* restrict in, std::complex<float>* restrict out, int n);
+/// out[i] = exp(in[i])
+void exp(const double* restrict in, double* restrict out, int n);
+void exp(const float* restrict in, float* restrict out, int n);
+/// out[i] = log(in[i])
+void log(const double* restrict in, double* restrict out, int n);
+void log(const float* restrict in, float* restrict out, int n);
+///@}
+
 template<typename T>
 inline void add(int n, const T* restrict in, T* restrict out)
 {
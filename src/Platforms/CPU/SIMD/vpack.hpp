@@ -0,0 +1,381 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file vpack.hpp
+ *
+ * Portable short vector type for the hand written vector kernels.
+ * vpack holds as many lanes as fit in QMC_SIMD_ALIGNMENT and every operation is a fixed length
+ * omp simd loop over the lanes, so the kernels written with it map to vector instructions of any
+ * compiler honoring OpenMP SIMD, without intrinsics. Branches are written with masks and select.
+ */
+#ifndef QMCPLUSPLUS_SIMD_VPACK_HPP
+#define QMCPLUSPLUS_SIMD_VPACK_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "config.h"
+
+namespace qmcplusplus
+{
+namespace simd
+{
+/// the integer type of the size of T, for the masks and the bit manipulations
+template<typename T>
+struct vpack_int;
+template<>
+struct vpack_int<double>
+{
+  using type = std::int64_t;
+};
+template<>
+struct vpack_int<float>
+{
+  using type = std::int32_t;
+};
+template<>
+struct vpack_int<std::int64_t>
+{
+  using type = std::int64_t;
+};
+template<>
+struct vpack_int<std::int32_t>
+{
+  using type = std::int32_t;
+};
+
+template<typename T>
+constexpr int native_width = QMC_SIMD_ALIGNMENT / sizeof(T);
+
+template<typename T, int W>
+struct vmask;
+
+/** W lanes of T
+ *
+ * Loads and stores are unaligned, the partial ones handle the remainder of an array.
+ */
+template<typename T, int W = native_width<T>>
+struct vpack
+{
+  static constexpr int width = W;
+  using value_type           = T;
+  using mask_type            = vmask<T, W>;
+
+  alignas(sizeof(T) * W) T v[W];
+
+  static inline vpack broadcast(T a)
+  {
+    vpack r;
+#pragma omp simd
+    for (int i = 0; i < W; i++)
+      r.v[i] = a;
+    return r;
+  }
+
+  static inline vpack load(const T* restrict p)
+  {
+    vpack r;
+#pragma omp simd
+    for (int i = 0; i < W; i++)
+      r.v[i] = p[i];
+    return r;
+  }
+
+  /// load the first n < W lanes, the others are fill
+  static inline vpack load(const T* restrict p, int n, T fill = T())
+  {
+    vpack r;
+    for (int i = 0; i < W; i++)
+      r.v[i] = i < n ? p[i] : fill;
+    return r;
+  }
+
+  /// v[i] = base[idx[i]]
+  static inline vpack gather(const T* restrict base, const int* restrict idx)
+  {
+    vpack r;
+#pragma omp simd
+    for (int i = 0; i < W; i++)
+      r.v[i] = base[idx[i]];
+    return r;
+  }
+
+  inline void store(T* restrict p) const
+  {
+#pragma omp simd
+    for (int i = 0; i < W; i++)
+      p[i] = v[i];
+  }
+
+  /// store the first n < W lanes
+  inline void store(T* restrict p, int n) const
+  {
+    for (int i = 0; i < n; i++)
+      p[i] = v[i];
+  }
+
+  /// store the lanes of mask
+  inline void store(T* restrict p, const mask_type& mask) const
+  {
+#pragma omp simd
+    for (int i = 0; i < W; i++)
+      if (mask.m[i])
+        p[i] = v[i];
+  }
+
+  inline T& operator[](int i) { return v[i]; }
+  inline T operator[](int i) const { return v[i]; }
+};
+
+/// lane mask of vpack<T, W>, lanes are all bits set or zero
+template<typename T, int W>
+struct vmask
+{
+  using int_type = typename vpack_int<T>::type;
+  alignas(sizeof(T) * W) int_type m[W];
+
+  inline bool operator[](int i) const { return m[i] != 0; }
+};
+
+#define QMC_VPACK_BINARY_OP(OP)                                                \
+  template<typename T, int W>                                                  \
+  inline vpack<T, W> operator OP(const vpack<T, W>& a, const vpack<T, W>& b)   \
+  {                                                                            \
+    vpack<T, W> r;                                                             \
+    _Pragma("omp simd") for (int i = 0; i < W; i++) r.v[i] = a.v[i] OP b.v[i]; \
+    return r;                                                                  \
+  }                                                                            \
+  template<typename T, int W>                                                  \
+  inline vpack<T, W> operator OP(const vpack<T, W>& a, T b)                    \
+  {                                                                            \
+    return a OP vpack<T, W>::broadcast(b);                                     \
+  }                                                                            \
+  template<typename T, int W>                                                  \
+  inline vpack<T, W> operator OP(T a, const vpack<T, W>& b)                    \
+  {                                                                            \
+    return vpack<T, W>::broadcast(a) OP b;                                     \
+  }
+
+QMC_VPACK_BINARY_OP(+)
+QMC_VPACK_BINARY_OP(-)
+QMC_VPACK_BINARY_OP(*)
+QMC_VPACK_BINARY_OP(/)
+// bitwise operators, integer packs only
+QMC_VPACK_BINARY_OP(&)
+QMC_VPACK_BINARY_OP(|)
+#undef QMC_VPACK_BINARY_OP
+
+#define QMC_VPACK_COMPARE_OP(OP)                                                        \
+  template<typename T, int W>                                                           \
+  inline vmask<T, W> operator OP(const vpack<T, W>& a, const vpack<T, W>& b)            \
+  {                                                                                     \
+    vmask<T, W> r;                                                                      \
+    _Pragma("omp simd") for (int i = 0; i < W; i++) r.m[i] = a.v[i] OP b.v[i] ? -1 : 0; \
+    return r;                                                                           \
+  }                                                                                     \
+  template<typename T, int W>                                                           \
+  inline vmask<T, W> operator OP(const vpack<T, W>& a, T b)                             \
+  {                                                                                     \
+    return a OP vpack<T, W>::broadcast(b);                                              \
+  }
+
+QMC_VPACK_COMPARE_OP(<)
+QMC_VPACK_COMPARE_OP(<=)
+QMC_VPACK_COMPARE_OP(>)
+QMC_VPACK_COMPARE_OP(>=)
+QMC_VPACK_COMPARE_OP(==)
+QMC_VPACK_COMPARE_OP(!=)
+#undef QMC_VPACK_COMPARE_OP
+
+template<typename T, int W>
+inline vpack<T, W> operator-(const vpack<T, W>& a)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = -a.v[i];
+  return r;
+}
+
+/// left shift of the lanes of an integer pack
+template<typename T, int W>
+inline vpack<T, W> operator<<(const vpack<T, W>& a, int s)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = a.v[i] << s;
+  return r;
+}
+
+/// arithmetic right shift of the lanes of an integer pack
+template<typename T, int W>
+inline vpack<T, W> operator>>(const vpack<T, W>& a, int s)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = a.v[i] >> s;
+  return r;
+}
+
+template<typename T, int W>
+inline vmask<T, W> operator&(const vmask<T, W>& a, const vmask<T, W>& b)
+{
+  vmask<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.m[i] = a.m[i] & b.m[i];
+  return r;
+}
+
+template<typename T, int W>
+inline vmask<T, W> operator|(const vmask<T, W>& a, const vmask<T, W>& b)
+{
+  vmask<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.m[i] = a.m[i] | b.m[i];
+  return r;
+}
+
+template<typename T, int W>
+inline vmask<T, W> operator!(const vmask<T, W>& a)
+{
+  vmask<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.m[i] = ~a.m[i];
+  return r;
+}
+
+template<typename T, int W>
+inline bool any(const vmask<T, W>& a)
+{
+  typename vmask<T, W>::int_type r = 0;
+#pragma omp simd reduction(| : r)
+  for (int i = 0; i < W; i++)
+    r |= a.m[i];
+  return r != 0;
+}
+
+template<typename T, int W>
+inline bool all(const vmask<T, W>& a)
+{
+  return !any(!a);
+}
+
+/// lanes of a where mask is set, of b elsewhere
+template<typename T, int W>
+inline vpack<T, W> select(const vmask<T, W>& mask, const vpack<T, W>& a, const vpack<T, W>& b)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = mask.m[i] ? a.v[i] : b.v[i];
+  return r;
+}
+
+/// a * b + c
+template<typename T, int W>
+inline vpack<T, W> fma(const vpack<T, W>& a, const vpack<T, W>& b, const vpack<T, W>& c)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = a.v[i] * b.v[i] + c.v[i];
+  return r;
+}
+
+template<typename T, int W>
+inline vpack<T, W> abs(const vpack<T, W>& a)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = std::abs(a.v[i]);
+  return r;
+}
+
+template<typename T, int W>
+inline vpack<T, W> min(const vpack<T, W>& a, const vpack<T, W>& b)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+  return r;
+}
+
+template<typename T, int W>
+inline vpack<T, W> max(const vpack<T, W>& a, const vpack<T, W>& b)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+  return r;
+}
+
+template<typename T, int W>
+inline T reduce_add(const vpack<T, W>& a)
+{
+  T r = T();
+#pragma omp simd reduction(+ : r)
+  for (int i = 0; i < W; i++)
+    r += a.v[i];
+  return r;
+}
+
+/// the bits of the lanes of a as integers
+template<typename T, int W>
+inline vpack<typename vpack_int<T>::type, W> as_int(const vpack<T, W>& a)
+{
+  vpack<typename vpack_int<T>::type, W> r;
+  std::memcpy(r.v, a.v, sizeof(a.v));
+  return r;
+}
+
+/// the lanes of integers a as the bits of T
+template<typename T, typename I, int W>
+inline vpack<T, W> as_float(const vpack<I, W>& a)
+{
+  static_assert(sizeof(T) == sizeof(I), "as_float needs an integer of the size of T");
+  vpack<T, W> r;
+  std::memcpy(r.v, a.v, sizeof(a.v));
+  return r;
+}
+
+/// convert the lanes of a to T, between floating point and integer packs
+template<typename T, typename I, int W>
+inline vpack<T, W> convert(const vpack<I, W>& a)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = static_cast<T>(a.v[i]);
+  return r;
+}
+
+/// round the lanes to the nearest integer, vectorized where the target has a rounding instruction
+template<typename T, int W>
+inline vpack<T, W> round(const vpack<T, W>& a)
+{
+  vpack<T, W> r;
+#pragma omp simd
+  for (int i = 0; i < W; i++)
+    r.v[i] = std::rint(a.v[i]);
+  return r;
+}
+
+} // namespace simd
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,207 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file vpack_math.hpp
+ *
+ * Branch free sincos, exp and log of vpack lanes.
+ * The reductions and polynomials follow fdlibm for double and Cephes for float, the results are within
+ * a few ulps of the standard library. As with -ffast-math, NaN and infinite inputs are not supported
+ * except for the sincos arguments, large arguments are passed to the standard library.
+ */
+#ifndef QMCPLUSPLUS_SIMD_VPACK_MATH_HPP
+#define QMCPLUSPLUS_SIMD_VPACK_MATH_HPP
+
+#include <limits>
+#include "vpack.hpp"
+
+namespace qmcplusplus
+{
+namespace simd
+{
+namespace detail
+{
+template<typename T>
+struct vpack_math_constants;
+
+template<>
+struct vpack_math_constants<double>
+{
+  using int_type                          = std::int64_t;
+  static constexpr int mantissa_bits      = 52;
+  static constexpr int_type exponent_bias = 1023;
+  static constexpr int_type exponent_mask = 0x7ff;
+  static constexpr int_type mantissa_mask = 0xfffffffffffffLL;
+  static constexpr int denormal_shift     = 54;
+
+  // pi/2 in three parts of 33 bits, k*pio2_1 and k*pio2_2 are exact for |k| < 2^20
+  static constexpr double pio2_1       = 1.57079632673412561417e+00;
+  static constexpr double pio2_2       = 6.07710050630396597660e-11;
+  static constexpr double pio2_3       = 2.02226624871116645580e-21;
+  static constexpr double sincos_limit = 1.0e5;
+  static constexpr double sin_coefs[]  = {1.58969099521155010221e-10, -2.50507602534068634195e-08,
+                                         2.75573137070700676789e-06, -1.98412698298579493134e-04,
+                                         8.33333333332248946124e-03, -1.66666666666666324348e-01};
+  static constexpr double cos_coefs[]  = {-1.13596475577881948265e-11, 2.08757232129817482790e-09,
+                                         -2.75573143513906633035e-07, 2.48015872894767294178e-05,
+                                         -1.38888888888741095749e-03, 4.16666666666666019037e-02};
+
+  static constexpr double ln2_hi  = 6.93147180369123816490e-01;
+  static constexpr double ln2_lo  = 1.90821492927058770002e-10;
+  static constexpr double exp_max = 709.782712893384;
+  static constexpr double exp_min = -745.1332191019412;
+  // Taylor series of exp, 1/13! to 1/2!, |r| < ln2/2
+  static constexpr double exp_coefs[] = {1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0,
+                                         1.0 / 362880.0,     1.0 / 40320.0,     1.0 / 5040.0,     1.0 / 720.0,
+                                         1.0 / 120.0,        1.0 / 24.0,        1.0 / 6.0,        0.5};
+  // series of 2 atanh(f), 1/25 to 1/3, |f| < 0.172
+  static constexpr double log_coefs[] = {1.0 / 25, 1.0 / 23, 1.0 / 21, 1.0 / 19, 1.0 / 17, 1.0 / 15,
+                                         1.0 / 13, 1.0 / 11, 1.0 / 9,  1.0 / 7,  1.0 / 5,  1.0 / 3};
+};
+
+template<>
+struct vpack_math_constants<float>
+{
+  using int_type                          = std::int32_t;
+  static constexpr int mantissa_bits      = 23;
+  static constexpr int_type exponent_bias = 127;
+  static constexpr int_type exponent_mask = 0xff;
+  static constexpr int_type mantissa_mask = 0x7fffff;
+  static constexpr int denormal_shift     = 24;
+
+  // Cephes splitting of pi/2, k*pio2_1 and k*pio2_2 are exact for |k| < 2^13
+  static constexpr float pio2_1       = 1.5703125f;
+  static constexpr float pio2_2       = 4.837512969970703125e-4f;
+  static constexpr float pio2_3       = 7.54978995489188216e-8f;
+  static constexpr float sincos_limit = 8192.0f;
+  static constexpr float sin_coefs[]  = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+  static constexpr float cos_coefs[]  = {2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f};
+
+  static constexpr float ln2_hi       = 0.693359375f;
+  static constexpr float ln2_lo       = -2.12194440e-4f;
+  static constexpr float exp_max      = 88.7228391f;
+  static constexpr float exp_min      = -103.972084f;
+  static constexpr float exp_coefs[]  = {1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                                        4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f};
+  static constexpr float log_coefs[]  = {1.0f / 15, 1.0f / 13, 1.0f / 11, 1.0f / 9, 1.0f / 7, 1.0f / 5, 1.0f / 3};
+};
+
+/// c[0] z^(N-1) + ... + c[N-1]
+template<typename T, int W, int N>
+inline vpack<T, W> horner(const vpack<T, W>& z, const T (&c)[N])
+{
+  vpack<T, W> p = vpack<T, W>::broadcast(c[0]);
+  for (int j = 1; j < N; j++)
+    p = fma(p, z, vpack<T, W>::broadcast(c[j]));
+  return p;
+}
+
+/// 2^k for integral k of the exponent range and the denormal range below it
+template<typename T, int W>
+inline vpack<T, W> exp2_int(const vpack<T, W>& k)
+{
+  using C = vpack_math_constants<T>;
+  using I = typename C::int_type;
+  // two factors keep each biased exponent in the normal range
+  const auto ki = convert<I>(k);
+  const auto k1 = ki >> 1;
+  const auto k2 = ki - k1;
+  const auto s1 = as_float<T>((k1 + C::exponent_bias) << C::mantissa_bits);
+  const auto s2 = as_float<T>((k2 + C::exponent_bias) << C::mantissa_bits);
+  return s1 * s2;
+}
+} // namespace detail
+
+/** sin and cos of the lanes of x
+ *
+ * The argument is reduced by pi/2 in three parts, the lanes beyond sincos_limit are computed by the standard library.
+ */
+template<typename T, int W>
+inline void sincos(const vpack<T, W>& x, vpack<T, W>& s, vpack<T, W>& c)
+{
+  using C = detail::vpack_math_constants<T>;
+  using I = typename C::int_type;
+  using P = vpack<T, W>;
+
+  const auto large = abs(x) > C::sincos_limit;
+  const P xr       = select(large, P::broadcast(T(0)), x);
+  const P k        = round(xr * T(2 / M_PI));
+  const P r        = ((xr - k * C::pio2_1) - k * C::pio2_2) - k * C::pio2_3;
+  const P z        = r * r;
+
+  const P sin_r = fma(r * z, detail::horner(z, C::sin_coefs), r);
+  const P cos_r = fma(z * z, detail::horner(z, C::cos_coefs), T(1) - T(0.5) * z);
+
+  const auto q     = convert<I>(k);
+  const auto swap  = convert<T>(q & I(1)) != T(0);
+  const auto s_neg = convert<T>(q & I(2)) != T(0);
+  const auto c_neg = convert<T>((q + I(1)) & I(2)) != T(0);
+  const P sv       = select(swap, cos_r, sin_r);
+  const P cv       = select(swap, sin_r, cos_r);
+  s                = select(s_neg, -sv, sv);
+  c                = select(c_neg, -cv, cv);
+
+  if (any(large))
+    for (int i = 0; i < W; i++)
+      if (large[i])
+      {
+        s[i] = std::sin(x[i]);
+        c[i] = std::cos(x[i]);
+      }
+}
+
+/// exp of the lanes of x, 0 below exp_min and infinity above exp_max
+template<typename T, int W>
+inline vpack<T, W> exp(const vpack<T, W>& x)
+{
+  using C = detail::vpack_math_constants<T>;
+  using P = vpack<T, W>;
+
+  const P xc = min(max(x, P::broadcast(C::exp_min)), P::broadcast(C::exp_max));
+  const P k  = round(xc * T(M_LOG2E));
+  const P r  = (xc - k * C::ln2_hi) - k * C::ln2_lo;
+  const P p  = fma(r * r, detail::horner(r, C::exp_coefs), r + T(1));
+  const P y  = p * detail::exp2_int(k);
+  return select(x > C::exp_max, P::broadcast(std::numeric_limits<T>::infinity()),
+                select(x < C::exp_min, P::broadcast(T(0)), y));
+}
+
+/// log of the lanes of x, -infinity at 0 and NaN below
+template<typename T, int W>
+inline vpack<T, W> log(const vpack<T, W>& x)
+{
+  using C = detail::vpack_math_constants<T>;
+  using I = typename C::int_type;
+  using P = vpack<T, W>;
+
+  // denormals are scaled into the normal range
+  const auto tiny = x < std::numeric_limits<T>::min();
+  const P xs      = select(tiny, x * T(I(1) << C::denormal_shift), x);
+  const auto bits = as_int(xs);
+  const auto e_adj = select(tiny, P::broadcast(T(-C::denormal_shift)), P::broadcast(T(0)));
+  P e              = convert<T>(((bits >> C::mantissa_bits) & C::exponent_mask) - C::exponent_bias) + e_adj;
+  P m              = as_float<T>((bits & C::mantissa_mask) | (C::exponent_bias << C::mantissa_bits));
+  // m in [sqrt(1/2), sqrt(2))
+  const auto high = m > T(M_SQRT2);
+  m               = select(high, m * T(0.5), m);
+  e               = select(high, e + T(1), e);
+
+  const P f  = (m - T(1)) / (m + T(1));
+  const P f2 = f * f;
+  const P lm = T(2) * fma(f * f2, detail::horner(f2, C::log_coefs), f);
+  const P y  = fma(e, P::broadcast(C::ln2_hi), fma(e, P::broadcast(C::ln2_lo), lm));
+  return select(x > T(0), y,
+                select(x == T(0), P::broadcast(-std::numeric_limits<T>::infinity()),
+                       P::broadcast(std::numeric_limits<T>::quiet_NaN())));
+}
+
+} // namespace simd
+} // namespace qmcplusplus
+#endif
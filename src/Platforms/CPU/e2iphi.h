@@ -27,6 +27,7 @@
 #include <vector>
 #include <complex>
 #include "CPU/math.hpp"
+#include "CPU/SIMD/vmath.hpp"
 
 #if defined(HAVE_MASSV)
 #include <massv.h>
@@ -57,6 +58,22 @@ inline void eval_e2iphi(int n, const float* restrict phi, std::complex<float>* r
   vcCIS(n, phi, (MKL_Complex8*)(z));
 }
 #else /* generic case */
+inline void eval_e2iphi(int n, const double* restrict phi, double* restrict phase_r, double* restrict phase_i)
+{
+  qmcplusplus::simd::sincos(phi, phase_i, phase_r, n);
+}
+inline void eval_e2iphi(int n, const float* restrict phi, float* restrict phase_r, float* restrict phase_i)
+{
+  qmcplusplus::simd::sincos(phi, phase_i, phase_r, n);
+}
+inline void eval_e2iphi(int n, const double* restrict phi, std::complex<double>* restrict z)
+{
+  qmcplusplus::simd::cis(phi, z, n);
+}
+inline void eval_e2iphi(int n, const float* restrict phi, std::complex<float>* restrict z)
+{
+  qmcplusplus::simd::cis(phi, z, n);
+}
 template<typename T>
 inline void eval_e2iphi(int n, const T* restrict phi, T* restrict phase_r, T* restrict phase_i)
 {
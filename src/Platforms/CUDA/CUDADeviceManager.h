@@ -40,7 +40,7 @@ public:
       throw std::runtime_error("Inconsistent number of CUDA devices with the previous record!");
     if (cuda_device_count > local_size)
       app_warning() << "More CUDA devices than the number of MPI ranks. "
-                    << "Some devices will be left idle.\n"
+                    << "Some devices will be left idle unless the drivers spread crowds over them with crowd_devices.\n"
                     << "There is potential performance issue with the GPU affinity. "
                     << "Use CUDA_VISIBLE_DEVICE or MPI launcher to expose desired devices.\n";
     if (num_devices > 0)
@@ -18,6 +18,10 @@
 
 namespace qmcplusplus
 {
+/** CUDA stream and cuBLAS handle owned by a crowd
+ *
+ * The stream is non-blocking so that the work of concurrent crowds doesn't serialize through the legacy default stream.
+ */
 struct CUDALinearAlgebraHandles : public Resource
 {
   // CUDA specific variables
@@ -26,7 +30,7 @@ struct CUDALinearAlgebraHandles : public Resource
 
   CUDALinearAlgebraHandles() : Resource("CUDALinearAlgebraHandles")
   {
-    cudaErrorCheck(cudaStreamCreate(&hstream), "cudaStreamCreate failed!");
+    cudaErrorCheck(cudaStreamCreateWithFlags(&hstream, cudaStreamNonBlocking), "cudaStreamCreateWithFlags failed!");
     cublasErrorCheck(cublasCreate(&h_cublas), "cublasCreate failed!");
     cublasErrorCheck(cublasSetStream(h_cublas, hstream), "cublasSetStream failed!");
   }
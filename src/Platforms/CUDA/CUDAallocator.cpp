@@ -12,8 +12,43 @@
 
 #include <cstddef>
 #include <atomic>
+#include "CUDAallocator.hpp"
 
 namespace qmcplusplus
 {
-  std::atomic<size_t> CUDAallocator_device_mem_allocated(0);
+std::atomic<size_t> CUDAallocator_device_mem_allocated(0);
+
+namespace
+{
+void* cudaPoolAllocate(size_t bytes, int device)
+{
+  void* pt;
+  if (cudaMalloc(&pt, bytes) != cudaSuccess)
+  {
+    // clear the sticky error before the pool retries
+    cudaGetLastError();
+    return nullptr;
+  }
+  return pt;
+}
+
+void cudaPoolFree(void* pt, size_t bytes, int device)
+{
+  cudaErrorCheck(cudaFree(pt), "Deallocation failed in CUDAAllocator!");
+}
+
+/** the blocks released without a stream may be in use on the non-blocking streams of the crowds
+ *  cudaFree used to synchronize the device implicitly.
+ */
+void cudaPoolSync(int device)
+{
+  cudaErrorCheck(cudaDeviceSynchronize(), "cudaDeviceSynchronize failed in CUDAAllocator!");
+}
+} // namespace
+
+DeviceMemoryPool& getCUDAdeviceMemPool()
+{
+  static DeviceMemoryPool pool("CUDA device", cudaPoolAllocate, cudaPoolFree, cudaPoolSync);
+  return pool;
 }
+} // namespace qmcplusplus
@@ -27,6 +27,8 @@
 #include "CUDAruntime.hpp"
 #include "allocator_traits.hpp"
 #include "CUDAfill.hpp"
+#include "DeviceMemoryPool.h"
+#include "MemoryAccounting.h"
 
 namespace qmcplusplus
 {
@@ -34,6 +36,9 @@ extern std::atomic<size_t> CUDAallocator_device_mem_allocated;
 
 inline size_t getCUDAdeviceMemAllocated() { return CUDAallocator_device_mem_allocated; }
 
+/// the pool caching the device memory of all the CUDAAllocators
+DeviceMemoryPool& getCUDAdeviceMemPool();
+
 /** allocator for CUDA unified memory
  * @tparam T data type
  */
@@ -62,9 +67,14 @@ struct CUDAManagedAllocator
     cudaErrorCheck(cudaMallocManaged(&pt, n * sizeof(T)), "Allocation failed in CUDAManagedAllocator!");
     if ((size_t(pt)) & (QMC_SIMD_ALIGNMENT - 1))
       throw std::runtime_error("Unaligned memory allocated in CUDAManagedAllocator");
+    getMemoryAccounting().allocate(MemorySpace::DEVICE, pt, n * sizeof(T));
     return static_cast<T*>(pt);
   }
-  void deallocate(T* p, std::size_t) { cudaErrorCheck(cudaFree(p), "Deallocation failed in CUDAManagedAllocator!"); }
+  void deallocate(T* p, std::size_t n)
+  {
+    getMemoryAccounting().deallocate(MemorySpace::DEVICE, p, n * sizeof(T));
+    cudaErrorCheck(cudaFree(p), "Deallocation failed in CUDAManagedAllocator!");
+  }
 };
 
 template<class T1, class T2>
@@ -113,15 +123,22 @@ public:
 
   T* allocate(std::size_t n)
   {
-    void* pt;
-    cudaErrorCheck(cudaMalloc(&pt, n * sizeof(T)), "Allocation failed in CUDAAllocator!");
+    int device;
+    cudaErrorCheck(cudaGetDevice(&device), "cudaGetDevice failed in CUDAAllocator!");
+    void* pt = getCUDAdeviceMemPool().allocate(n * sizeof(T), device);
     CUDAallocator_device_mem_allocated += n * sizeof(T);
+    getMemoryAccounting().allocate(MemorySpace::DEVICE, pt, n * sizeof(T));
     return static_cast<T*>(pt);
   }
   void deallocate(T* p, std::size_t n)
   {
-    cudaErrorCheck(cudaFree(p), "Deallocation failed in CUDAAllocator!");
+    if (p == nullptr)
+      return;
+    cudaPointerAttributes attr;
+    cudaErrorCheck(cudaPointerGetAttributes(&attr, p), "cudaPointerGetAttributes failed in CUDAAllocator!");
+    getCUDAdeviceMemPool().deallocate(p, n * sizeof(T), attr.device);
     CUDAallocator_device_mem_allocated -= n * sizeof(T);
+    getMemoryAccounting().deallocate(MemorySpace::DEVICE, p, n * sizeof(T));
   }
 
   /** Provide a construct for std::allocator_traits::contruct to call.
@@ -152,22 +169,41 @@ public:
   static void destroy(U* p)
   {}
 
+  /* The copies without a stream run on the per-thread default stream of the calling crowd thread.
+   * It is not ordered with the non-blocking streams of the other crowds, so only this copy is waited for.
+   */
   void copyToDevice(T* device_ptr, T* host_ptr, size_t n)
   {
-    cudaErrorCheck(cudaMemcpy(device_ptr, host_ptr, sizeof(T) * n, cudaMemcpyHostToDevice),
-                   "cudaMemcpy failed in copyToDevice");
+    cudaErrorCheck(cudaMemcpyAsync(device_ptr, host_ptr, sizeof(T) * n, cudaMemcpyHostToDevice, cudaStreamPerThread),
+                   "cudaMemcpyAsync failed in copyToDevice");
+    cudaErrorCheck(cudaStreamSynchronize(cudaStreamPerThread), "cudaStreamSynchronize failed in copyToDevice");
   }
 
   void copyFromDevice(T* host_ptr, T* device_ptr, size_t n)
   {
-    cudaErrorCheck(cudaMemcpy(host_ptr, device_ptr, sizeof(T) * n, cudaMemcpyDeviceToHost),
-                   "cudaMemcpy failed in copyFromDevice");
+    cudaErrorCheck(cudaMemcpyAsync(host_ptr, device_ptr, sizeof(T) * n, cudaMemcpyDeviceToHost, cudaStreamPerThread),
+                   "cudaMemcpyAsync failed in copyFromDevice");
+    cudaErrorCheck(cudaStreamSynchronize(cudaStreamPerThread), "cudaStreamSynchronize failed in copyFromDevice");
+  }
+
+  /// copy on stream without fences, ordered with the other work of the stream
+  void copyToDeviceAsync(T* device_ptr, const T* host_ptr, size_t n, cudaStream_t stream)
+  {
+    cudaErrorCheck(cudaMemcpyAsync(device_ptr, host_ptr, sizeof(T) * n, cudaMemcpyHostToDevice, stream),
+                   "cudaMemcpyAsync failed in copyToDeviceAsync");
+  }
+
+  void copyFromDeviceAsync(T* host_ptr, const T* device_ptr, size_t n, cudaStream_t stream)
+  {
+    cudaErrorCheck(cudaMemcpyAsync(host_ptr, device_ptr, sizeof(T) * n, cudaMemcpyDeviceToHost, stream),
+                   "cudaMemcpyAsync failed in copyFromDeviceAsync");
   }
 
   void copyDeviceToDevice(T* to_ptr, size_t n, T* from_ptr)
   {
-    cudaErrorCheck(cudaMemcpy(to_ptr, from_ptr, sizeof(T) * n, cudaMemcpyDeviceToDevice),
-                   "cudaMemcpy failed in copyDeviceToDevice");
+    cudaErrorCheck(cudaMemcpyAsync(to_ptr, from_ptr, sizeof(T) * n, cudaMemcpyDeviceToDevice, cudaStreamPerThread),
+                   "cudaMemcpyAsync failed in copyDeviceToDevice");
+    cudaErrorCheck(cudaStreamSynchronize(cudaStreamPerThread), "cudaStreamSynchronize failed in copyDeviceToDevice");
   }
 };
 
@@ -227,9 +263,16 @@ struct CUDAHostAllocator
   {
     void* pt;
     cudaErrorCheck(cudaMallocHost(&pt, n * sizeof(T)), "Allocation failed in CUDAHostAllocator!");
+    getMemoryAccounting().allocate(MemorySpace::HOST, pt, n * sizeof(T));
+    getMemoryAccounting().allocate(MemorySpace::PINNED, pt, n * sizeof(T));
     return static_cast<T*>(pt);
   }
-  void deallocate(T* p, std::size_t) { cudaErrorCheck(cudaFreeHost(p), "Deallocation failed in CUDAHostAllocator!"); }
+  void deallocate(T* p, std::size_t n)
+  {
+    getMemoryAccounting().deallocate(MemorySpace::HOST, p, n * sizeof(T));
+    getMemoryAccounting().deallocate(MemorySpace::PINNED, p, n * sizeof(T));
+    cudaErrorCheck(cudaFreeHost(p), "Deallocation failed in CUDAHostAllocator!");
+  }
 };
 
 template<class T1, class T2>
@@ -274,11 +317,13 @@ struct CUDALockedPageAllocator : public ULPHA
     value_type* pt = ULPHA::allocate(n);
     cudaErrorCheck(cudaHostRegister(pt, n * sizeof(T), cudaHostRegisterDefault),
                    "cudaHostRegister failed in CUDALockedPageAllocator!");
+    getMemoryAccounting().allocate(MemorySpace::PINNED, pt, n * sizeof(T));
     return pt;
   }
 
   void deallocate(value_type* pt, std::size_t n)
   {
+    getMemoryAccounting().deallocate(MemorySpace::PINNED, pt, n * sizeof(T));
     cudaErrorCheck(cudaHostUnregister(pt), "cudaHostUnregister failed in CUDALockedPageAllocator!");
     ULPHA::deallocate(pt, n);
   }
@@ -0,0 +1,63 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file CUDAevent.hpp
+ * @brief lightweight event marking a point of a stream, to wait for the async transfers and kernels before it
+ */
+#ifndef QMCPLUSPLUS_CUDA_EVENT_H
+#define QMCPLUSPLUS_CUDA_EVENT_H
+
+#include "CUDAruntime.hpp"
+
+namespace qmcplusplus
+{
+/** owns a cudaEvent_t without timing
+ *
+ * record marks the work queued so far on a stream, wait blocks the host until that work is done
+ * and enqueueWait makes another stream wait for it without blocking the host.
+ */
+class CUDAEvent
+{
+public:
+  CUDAEvent() { cudaErrorCheck(cudaEventCreateWithFlags(&event_, cudaEventDisableTiming), "cudaEventCreate failed!"); }
+  ~CUDAEvent() { cudaErrorCheck(cudaEventDestroy(event_), "cudaEventDestroy failed!"); }
+
+  CUDAEvent(const CUDAEvent&) = delete;
+  CUDAEvent& operator=(const CUDAEvent&) = delete;
+
+  /// mark the work queued on stream so far
+  void record(cudaStream_t stream) { cudaErrorCheck(cudaEventRecord(event_, stream), "cudaEventRecord failed!"); }
+  /// block the host until the recorded work is done
+  void wait() { cudaErrorCheck(cudaEventSynchronize(event_), "cudaEventSynchronize failed!"); }
+  /// true if the recorded work is done, never blocks
+  bool isDone()
+  {
+    const cudaError_t status = cudaEventQuery(event_);
+    if (status == cudaErrorNotReady)
+      return false;
+    cudaErrorCheck(status, "cudaEventQuery failed!");
+    return true;
+  }
+  /// make the work queued later on stream wait for the recorded work
+  void enqueueWait(cudaStream_t stream)
+  {
+    cudaErrorCheck(cudaStreamWaitEvent(stream, event_, 0), "cudaStreamWaitEvent failed!");
+  }
+
+  cudaEvent_t get() const { return event_; }
+
+private:
+  cudaEvent_t event_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -22,7 +22,9 @@ void CUDAfill_n(T* ptr, size_t n, const T& value)
   if (value != T())
     throw std::runtime_error("CUDAfill_n doesn't support fill non T() values!");
   // setting 0 value on each byte should be 0 for int, float and double.
-  cudaErrorCheck(cudaMemset(ptr, 0, n * sizeof(T)), "Memset failed in CUDAfill_n!");
+  cudaErrorCheck(cudaMemsetAsync(ptr, 0, n * sizeof(T), cudaStreamPerThread), "Memset failed in CUDAfill_n!");
+  // only wait for this fill, the per-thread stream is not ordered with the non-blocking streams of the other crowds.
+  cudaErrorCheck(cudaStreamSynchronize(cudaStreamPerThread), "cudaStreamSynchronize failed in CUDAfill_n!");
 }
 
 template void CUDAfill_n<int>(int* ptr, size_t n, const int& value);
@@ -74,11 +74,26 @@ namespace qmcplusplus
  */
 namespace cusolver
 {
+inline cusolverStatus_t getrf_bufferSize(cusolverDnHandle_t& handle, int m, int n, float* A, int lda, int* lwork)
+{
+  return cusolverDnSgetrf_bufferSize(handle, m, n, A, lda, lwork);
+}
+
 inline cusolverStatus_t getrf_bufferSize(cusolverDnHandle_t& handle, int m, int n, double* A, int lda, int* lwork)
 {
   return cusolverDnDgetrf_bufferSize(handle, m, n, A, lda, lwork);
 }
 
+inline cusolverStatus_t getrf_bufferSize(cusolverDnHandle_t& handle,
+                                         int m,
+                                         int n,
+                                         std::complex<float>* A,
+                                         int lda,
+                                         int* lwork)
+{
+  return cusolverDnCgetrf_bufferSize(handle, m, n, (cuComplex*)A, lda, lwork);
+}
+
 inline cusolverStatus_t getrf_bufferSize(cusolverDnHandle_t& handle,
                                          int m,
                                          int n,
@@ -89,6 +104,18 @@ inline cusolverStatus_t getrf_bufferSize(cusolverDnHandle_t& handle,
   return cusolverDnZgetrf_bufferSize(handle, m, n, (cuDoubleComplex*)A, lda, lwork);
 }
 
+inline cusolverStatus_t getrf(cusolverDnHandle_t& handle,
+                              int m,
+                              int n,
+                              float* A,
+                              int lda,
+                              float* work,
+                              int* ipiv,
+                              int* info)
+{
+  return cusolverDnSgetrf(handle, m, n, A, lda, work, ipiv, info);
+}
+
 inline cusolverStatus_t getrf(cusolverDnHandle_t& handle,
                               int m,
                               int n,
@@ -101,6 +128,18 @@ inline cusolverStatus_t getrf(cusolverDnHandle_t& handle,
   return cusolverDnDgetrf(handle, m, n, A, lda, work, ipiv, info);
 }
 
+inline cusolverStatus_t getrf(cusolverDnHandle_t& handle,
+                              int m,
+                              int n,
+                              std::complex<float>* A,
+                              int lda,
+                              std::complex<float>* work,
+                              int* ipiv,
+                              int* info)
+{
+  return cusolverDnCgetrf(handle, m, n, (cuComplex*)A, lda, (cuComplex*)work, ipiv, info);
+}
+
 inline cusolverStatus_t getrf(cusolverDnHandle_t& handle,
                               int m,
                               int n,
@@ -113,6 +152,20 @@ inline cusolverStatus_t getrf(cusolverDnHandle_t& handle,
   return cusolverDnZgetrf(handle, m, n, (cuDoubleComplex*)A, lda, (cuDoubleComplex*)work, ipiv, info);
 }
 
+inline cusolverStatus_t getrs(cusolverDnHandle_t& handle,
+                              const cublasOperation_t& transa,
+                              int m,
+                              int n,
+                              const float* A,
+                              int lda,
+                              int* ipiv,
+                              float* B,
+                              int ldb,
+                              int* info)
+{
+  return cusolverDnSgetrs(handle, transa, m, n, A, lda, ipiv, B, ldb, info);
+}
+
 inline cusolverStatus_t getrs(cusolverDnHandle_t& handle,
                               const cublasOperation_t& transa,
                               int m,
@@ -127,6 +180,20 @@ inline cusolverStatus_t getrs(cusolverDnHandle_t& handle,
   return cusolverDnDgetrs(handle, transa, m, n, A, lda, ipiv, B, ldb, info);
 }
 
+inline cusolverStatus_t getrs(cusolverDnHandle_t& handle,
+                              const cublasOperation_t& transa,
+                              int m,
+                              int n,
+                              const std::complex<float>* A,
+                              int lda,
+                              int* ipiv,
+                              std::complex<float>* B,
+                              int ldb,
+                              int* info)
+{
+  return cusolverDnCgetrs(handle, transa, m, n, (const cuComplex*)A, lda, ipiv, (cuComplex*)B, ldb, info);
+}
+
 inline cusolverStatus_t getrs(cusolverDnHandle_t& handle,
                               const cublasOperation_t& transa,
                               int m,
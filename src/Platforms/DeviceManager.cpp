@@ -15,6 +15,7 @@
 #include <memory>
 #include <stdexcept>
 #include "Host/OutputManager.h"
+#include "determineDefaultDeviceNum.h"
 
 namespace qmcplusplus
 {
@@ -33,6 +34,7 @@ DeviceManager::DeviceManager(int local_rank, int local_size)
 {
   if (num_devices > 0)
   {
+    device_nums_ = determineDeviceNums(num_devices, local_rank, local_size);
     if (local_size % num_devices != 0)
       app_warning() << "The number of MPI ranks on the node is not divisible by the number of accelerators. "
                     << "Imbalanced load may cause performance loss.\n";
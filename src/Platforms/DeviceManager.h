@@ -15,6 +15,7 @@
 #define QMCPLUSPLUS_DEVICEMANAGER_H
 
 #include <memory>
+#include <vector>
 #include <config.h>
 #if defined(ENABLE_CUDA)
 #include "CUDA/CUDADeviceManager.h"
@@ -41,6 +42,8 @@ namespace qmcplusplus
  * DeviceManager assumes there is only one type of accelerators although they may support multiple
  * platforms. Under this assumption, the numbers of devices captured on all the platforms must agree.
  *
+ * A process with fewer MPI ranks on the node than devices may drive several devices, see getDeviceNums.
+ *
  * DeviceManager::global is intended to the per-process global instance and should be initialized
  * after MPI initialization in main().
  */
@@ -58,6 +61,8 @@ public:
   // accessors
   int getDefaultDeviceNum() const { return default_device_num; }
   int getNumDevices() const { return num_devices; }
+  /// the devices this process may drive, the default device first. Empty without devices.
+  const std::vector<int>& getDeviceNums() const { return device_nums_; }
 
 #if defined(ENABLE_CUDA)
   const auto& getCUDADM() const { return cuda_dm_; }
@@ -80,6 +85,8 @@ private:
   int default_device_num;
   // the number of devices. Must be defined before platform device manager objects
   int num_devices;
+  // the devices this process may drive, see determineDeviceNums
+  std::vector<int> device_nums_;
 #if defined(ENABLE_CUDA)
   // CUDA device manager object
   CUDADeviceManager cuda_dm_;
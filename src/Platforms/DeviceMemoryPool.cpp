@@ -0,0 +1,177 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "DeviceMemoryPool.h"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+namespace qmcplusplus
+{
+namespace
+{
+std::mutex& registry_mutex()
+{
+  static std::mutex m;
+  return m;
+}
+
+std::vector<DeviceMemoryPool*>& registry()
+{
+  static std::vector<DeviceMemoryPool*> pools;
+  return pools;
+}
+} // namespace
+
+DeviceMemoryPool::DeviceMemoryPool(const std::string& name, AllocFunc alloc, FreeFunc free, SyncFunc sync)
+    : name_(name), alloc_(alloc), free_(free), sync_(sync), max_cached_bytes_(std::numeric_limits<size_t>::max())
+{
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  registry().push_back(this);
+}
+
+DeviceMemoryPool::~DeviceMemoryPool()
+{
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  auto& pools = registry();
+  pools.erase(std::remove(pools.begin(), pools.end(), this), pools.end());
+}
+
+size_t DeviceMemoryPool::roundSize(size_t bytes)
+{
+  if (bytes > large_block_bytes)
+    return (bytes + large_block_bytes - 1) / large_block_bytes * large_block_bytes;
+  size_t size = min_block_bytes;
+  while (size < bytes)
+    size <<= 1;
+  return size;
+}
+
+void* DeviceMemoryPool::allocate(size_t bytes, int device, const void* stream)
+{
+  const size_t size = roundSize(bytes);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto bin = free_lists_.find(BinKey(device, stream, size));
+  if (bin != free_lists_.end() && !bin->second.empty())
+  {
+    if (stream == nullptr && unsynced_[device])
+    {
+      if (sync_)
+      {
+        sync_(device);
+        stats_.syncs++;
+      }
+      unsynced_[device] = false;
+    }
+    void* ptr = bin->second.back();
+    bin->second.pop_back();
+    stats_.cached_bytes -= size;
+    stats_.in_use_bytes += size;
+    stats_.hits++;
+    return ptr;
+  }
+
+  void* ptr = alloc_(size, device);
+  if (ptr == nullptr && stats_.cached_bytes > 0)
+  {
+    releaseLocked();
+    ptr = alloc_(size, device);
+  }
+  if (ptr == nullptr)
+    throw std::runtime_error("DeviceMemoryPool " + name_ + " failed to allocate " + std::to_string(size) + " bytes!");
+  stats_.in_use_bytes += size;
+  stats_.misses++;
+  stats_.peak_bytes = std::max(stats_.peak_bytes, stats_.in_use_bytes + stats_.cached_bytes);
+  return ptr;
+}
+
+void DeviceMemoryPool::deallocate(void* ptr, size_t bytes, int device, const void* stream)
+{
+  if (ptr == nullptr)
+    return;
+  const size_t size = roundSize(bytes);
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.in_use_bytes -= size;
+  if (stats_.cached_bytes + size > max_cached_bytes_)
+  {
+    free_(ptr, size, device);
+    stats_.releases++;
+    return;
+  }
+  free_lists_[BinKey(device, stream, size)].push_back(ptr);
+  stats_.cached_bytes += size;
+  if (stream == nullptr)
+    unsynced_[device] = true;
+}
+
+void DeviceMemoryPool::release()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  releaseLocked();
+}
+
+void DeviceMemoryPool::releaseLocked()
+{
+  for (auto& bin : free_lists_)
+  {
+    for (void* ptr : bin.second)
+      free_(ptr, std::get<2>(bin.first), std::get<0>(bin.first));
+    stats_.releases += bin.second.size();
+  }
+  free_lists_.clear();
+  unsynced_.clear();
+  stats_.cached_bytes = 0;
+}
+
+void DeviceMemoryPool::setMaxCachedBytes(size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_cached_bytes_ = bytes;
+  if (stats_.cached_bytes > max_cached_bytes_)
+    releaseLocked();
+}
+
+DeviceMemoryPool::Stats DeviceMemoryPool::getStats() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void DeviceMemoryPool::printStats(std::ostream& log)
+{
+  std::map<std::string, Stats> by_name;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    for (const DeviceMemoryPool* pool : registry())
+    {
+      const Stats s = pool->getStats();
+      Stats& sum    = by_name[pool->getName()];
+      sum.in_use_bytes += s.in_use_bytes;
+      sum.cached_bytes += s.cached_bytes;
+      sum.peak_bytes += s.peak_bytes;
+      sum.hits += s.hits;
+      sum.misses += s.misses;
+      sum.releases += s.releases;
+      sum.syncs += s.syncs;
+    }
+  }
+  for (const auto& pool : by_name)
+  {
+    const Stats& s = pool.second;
+    log << "Memory pool " << pool.first << " : in use " << (s.in_use_bytes >> 20) << " MiB, cached "
+        << (s.cached_bytes >> 20) << " MiB, peak " << (s.peak_bytes >> 20) << " MiB, " << s.hits << " hits, "
+        << s.misses << " misses, " << s.releases << " releases, " << s.syncs << " syncs" << std::endl;
+  }
+}
+
+} // namespace qmcplusplus
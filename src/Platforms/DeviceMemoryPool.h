@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file DeviceMemoryPool.h
+ * @brief caching pool in front of the device allocation calls of OMPallocator and CUDAAllocator
+ */
+#ifndef QMCPLUSPLUS_DEVICE_MEMORY_POOL_H
+#define QMCPLUSPLUS_DEVICE_MEMORY_POOL_H
+
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace qmcplusplus
+{
+/** caching allocator of device memory with size class bins and per stream free lists
+ *
+ * Released blocks are kept in the free list of their device, stream and size class and
+ * handed out again to the next request of the same size class instead of going back to the runtime.
+ * Sizes are rounded up to a power of two, at least min_block_bytes, or to a multiple of
+ * large_block_bytes above it.
+ *
+ * A block released on a stream is reused on the same stream without synchronization since the
+ * stream orders the work. A block released without a stream may still be used by kernels in flight,
+ * the first reuse after such a release synchronizes the device through the sync function.
+ *
+ * When the runtime cannot allocate a block, the cached blocks are released and the allocation retried.
+ * The cached blocks are not released at destruction because the runtime may already be finalized.
+ */
+class DeviceMemoryPool
+{
+public:
+  /// allocates bytes on a device, returns nullptr on failure
+  using AllocFunc = void* (*)(size_t bytes, int device);
+  /// releases a block of bytes on a device
+  using FreeFunc = void (*)(void* ptr, size_t bytes, int device);
+  /// waits for the work in flight on a device
+  using SyncFunc = void (*)(int device);
+
+  static constexpr size_t min_block_bytes   = 512;
+  static constexpr size_t large_block_bytes = size_t(1) << 20;
+
+  struct Stats
+  {
+    /// bytes handed out, rounded to the size classes
+    size_t in_use_bytes = 0;
+    /// bytes held in the free lists
+    size_t cached_bytes = 0;
+    /// maximum of the bytes held from the runtime
+    size_t peak_bytes = 0;
+    /// allocations served from the free lists
+    size_t hits = 0;
+    /// allocations passed to the runtime
+    size_t misses = 0;
+    /// blocks returned to the runtime
+    size_t releases = 0;
+    /// device synchronizations before reuse
+    size_t syncs = 0;
+  };
+
+  DeviceMemoryPool(const std::string& name, AllocFunc alloc, FreeFunc free, SyncFunc sync = nullptr);
+  ~DeviceMemoryPool();
+
+  DeviceMemoryPool(const DeviceMemoryPool&) = delete;
+  DeviceMemoryPool& operator=(const DeviceMemoryPool&) = delete;
+
+  /** allocate at least bytes on device for the work on stream, nullptr stream if unknown
+   * @return the block, throws std::runtime_error if the runtime fails even after releasing the cache
+   */
+  void* allocate(size_t bytes, int device = 0, const void* stream = nullptr);
+  /// return a block of the same bytes, device and stream as in allocate to the free lists
+  void deallocate(void* ptr, size_t bytes, int device = 0, const void* stream = nullptr);
+
+  /// return all the cached blocks to the runtime
+  void release();
+
+  /// cap the bytes kept in the free lists, the blocks beyond it go back to the runtime, 0 disables caching
+  void setMaxCachedBytes(size_t bytes);
+
+  Stats getStats() const;
+  const std::string& getName() const { return name_; }
+
+  /// the bytes of the size class of a request
+  static size_t roundSize(size_t bytes);
+
+  /// print the statistics of all the pools, summed by name
+  static void printStats(std::ostream& log);
+
+private:
+  using BinKey = std::tuple<int, const void*, size_t>;
+
+  const std::string name_;
+  const AllocFunc alloc_;
+  const FreeFunc free_;
+  const SyncFunc sync_;
+  size_t max_cached_bytes_;
+
+  mutable std::mutex mutex_;
+  /// free blocks by device, stream and size class
+  std::map<BinKey, std::vector<void*>> free_lists_;
+  /// devices with blocks released without a stream since the last synchronization
+  std::map<int, bool> unsynced_;
+  Stats stats_;
+
+  void releaseLocked();
+};
+
+} // namespace qmcplusplus
+#endif
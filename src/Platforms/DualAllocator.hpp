@@ -149,6 +149,22 @@ struct qmc_allocator_traits<DualAllocator<T, DeviceAllocator, HostAllocator>>
     alloc.get_device_allocator().copyFromDevice(host_ptr, alloc.get_device_ptr(), n);
   }
 
+  /// update to the device on queue, a stream of the device allocator
+  template<class Queue>
+  static void updateToAsync(DualAlloc& alloc, T* host_ptr, size_t n, Queue& queue)
+  {
+    assert(host_ptr == alloc.get_host_ptr());
+    alloc.get_device_allocator().copyToDeviceAsync(alloc.get_device_ptr(), host_ptr, n, queue);
+  }
+
+  /// update from the device on queue, a stream of the device allocator
+  template<class Queue>
+  static void updateFromAsync(DualAlloc& alloc, T* host_ptr, size_t n, Queue& queue)
+  {
+    assert(host_ptr == alloc.get_host_ptr());
+    alloc.get_device_allocator().copyFromDeviceAsync(host_ptr, alloc.get_device_ptr(), n, queue);
+  }
+
   static void deviceSideCopyN(DualAlloc& alloc, size_t to, size_t n, size_t from)
   {
     T* device_ptr = alloc.get_device_ptr();
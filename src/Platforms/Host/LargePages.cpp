@@ -0,0 +1,215 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "LargePages.h"
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include "Platforms/MemoryAccounting.h"
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(__linux__) && !defined(MAP_HUGE_SHIFT)
+#define MAP_HUGE_SHIFT 26
+#endif
+
+namespace qmcplusplus
+{
+namespace
+{
+constexpr size_t base_page_bytes  = size_t(1) << 12;
+constexpr size_t huge_page_bytes  = size_t(1) << 21;
+constexpr size_t giant_page_bytes = size_t(1) << 30;
+
+struct LargePageRegion
+{
+  size_t bytes;
+  bool hugetlb;
+  bool pinned;
+};
+
+struct LargePageRegistry
+{
+  std::mutex mutex;
+  LargePageOptions options;
+  std::map<void*, LargePageRegion> regions;
+  LargePageStats stats;
+};
+
+LargePageRegistry& registry()
+{
+  // never destroyed, the large tables of the static objects are released after main
+  static LargePageRegistry* reg = new LargePageRegistry;
+  return *reg;
+}
+
+size_t roundUp(size_t bytes, size_t page) { return (bytes + page - 1) / page * page; }
+
+#if defined(__linux__)
+void* mapAnonymous(size_t bytes, int extra_flags)
+{
+  void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+/// map bytes aligned to the huge page size, the transparent huge pages need aligned 2MB ranges
+void* mapAligned(size_t bytes, size_t align)
+{
+  char* raw = static_cast<char*>(mapAnonymous(bytes + align, 0));
+  if (raw == nullptr)
+    return nullptr;
+  char* ptr = reinterpret_cast<char*>(roundUp(reinterpret_cast<size_t>(raw), align));
+  if (ptr > raw)
+    munmap(raw, ptr - raw);
+  munmap(ptr + bytes, raw + align - ptr);
+  return ptr;
+}
+#endif
+} // namespace
+
+LargePageKind parseLargePageKind(const std::string& kind)
+{
+  if (kind == "no" || kind == "default")
+    return LargePageKind::DEFAULT;
+  if (kind == "yes" || kind == "thp")
+    return LargePageKind::TRANSPARENT;
+  if (kind == "2MB" || kind == "2mb")
+    return LargePageKind::HUGETLB_2MB;
+  if (kind == "1GB" || kind == "1gb")
+    return LargePageKind::HUGETLB_1GB;
+  throw std::runtime_error("Unknown huge page kind '" + kind + "'. Valid values are no, thp, 2MB and 1GB.");
+}
+
+const char* getLargePageKindName(LargePageKind kind)
+{
+  switch (kind)
+  {
+  case LargePageKind::TRANSPARENT:
+    return "thp";
+  case LargePageKind::HUGETLB_2MB:
+    return "2MB";
+  case LargePageKind::HUGETLB_1GB:
+    return "1GB";
+  default:
+    return "no";
+  }
+}
+
+LargePageOptions getLargePageOptions()
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.options;
+}
+
+void setLargePageOptions(const LargePageOptions& options)
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.options = options;
+}
+
+void* allocateLargePages(size_t bytes)
+{
+#if defined(__linux__)
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  const LargePageOptions options = reg.options;
+  // below a huge page the tables only gain from the page locking
+  const bool use_huge = options.kind != LargePageKind::DEFAULT && bytes >= huge_page_bytes;
+  if (!use_huge && !options.pinned)
+    return nullptr;
+
+  void* ptr     = nullptr;
+  size_t mapped = roundUp(bytes, use_huge ? huge_page_bytes : base_page_bytes);
+  bool hugetlb  = false;
+  if (use_huge && options.kind != LargePageKind::TRANSPARENT)
+  {
+    const bool giant   = options.kind == LargePageKind::HUGETLB_1GB;
+    const size_t page  = giant ? giant_page_bytes : huge_page_bytes;
+    const int log_page = giant ? 30 : 21;
+    ptr                = mapAnonymous(roundUp(bytes, page), MAP_HUGETLB | (log_page << MAP_HUGE_SHIFT));
+    if (ptr != nullptr)
+    {
+      mapped  = roundUp(bytes, page);
+      hugetlb = true;
+    }
+    else
+      reg.stats.hugetlb_fallbacks++;
+  }
+  if (ptr == nullptr)
+  {
+    ptr = use_huge ? mapAligned(mapped, huge_page_bytes) : mapAnonymous(mapped, 0);
+    if (ptr == nullptr)
+      return nullptr;
+    if (use_huge)
+      madvise(ptr, mapped, MADV_HUGEPAGE);
+  }
+
+  bool pinned = false;
+  if (options.pinned)
+  {
+    // RLIMIT_MEMLOCK may deny the lock, the memory stays usable
+    pinned = mlock(ptr, mapped) == 0;
+    if (!pinned)
+      reg.stats.pin_failures++;
+  }
+
+  reg.regions[ptr] = {mapped, hugetlb, pinned};
+  reg.stats.regions++;
+  reg.stats.bytes += mapped;
+  if (hugetlb)
+    reg.stats.hugetlb_bytes += mapped;
+  if (pinned)
+    reg.stats.pinned_bytes += mapped;
+  getMemoryAccounting().allocate(pinned ? MemorySpace::PINNED : MemorySpace::HOST, ptr, mapped);
+  return ptr;
+#else
+  return nullptr;
+#endif
+}
+
+bool deallocateLargePages(void* ptr)
+{
+#if defined(__linux__)
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto it = reg.regions.find(ptr);
+  if (it == reg.regions.end())
+    return false;
+  const LargePageRegion region = it->second;
+  reg.regions.erase(it);
+  getMemoryAccounting().deallocate(region.pinned ? MemorySpace::PINNED : MemorySpace::HOST, ptr, region.bytes);
+  if (region.pinned)
+    munlock(ptr, region.bytes);
+  munmap(ptr, region.bytes);
+  reg.stats.regions--;
+  reg.stats.bytes -= region.bytes;
+  if (region.hugetlb)
+    reg.stats.hugetlb_bytes -= region.bytes;
+  if (region.pinned)
+    reg.stats.pinned_bytes -= region.bytes;
+  return true;
+#else
+  return false;
+#endif
+}
+
+LargePageStats getLargePageStats()
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.stats;
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file LargePages.h
+ * @brief huge page and page locked host memory for the large read-only tables
+ */
+#ifndef QMCPLUSPLUS_LARGE_PAGES_H
+#define QMCPLUSPLUS_LARGE_PAGES_H
+
+#include <cstddef>
+#include <string>
+
+namespace qmcplusplus
+{
+/// page kinds backing the large tables
+enum class LargePageKind
+{
+  DEFAULT,     // the pages of the default allocator
+  TRANSPARENT, // transparent huge pages requested by madvise
+  HUGETLB_2MB, // explicit 2MB huge pages, falls back to TRANSPARENT when none is reserved
+  HUGETLB_1GB  // explicit 1GB huge pages, falls back to TRANSPARENT when none is reserved
+};
+
+struct LargePageOptions
+{
+  LargePageKind kind = LargePageKind::DEFAULT;
+  /// lock the pages in host memory, speeds up the transfers to the devices
+  bool pinned = false;
+};
+
+/// parse "no", "thp", "2MB" or "1GB", throws on any other value
+LargePageKind parseLargePageKind(const std::string& kind);
+/// the input name of a kind
+const char* getLargePageKindName(LargePageKind kind);
+
+/// the options applied to the LargePageAllocator allocations of the process
+LargePageOptions getLargePageOptions();
+void setLargePageOptions(const LargePageOptions& options);
+
+/** apply options to the LargePageAllocator allocations of the scope, the previous ones are restored at the end
+ *
+ * Meant for the builders of the large tables, which run on one thread.
+ */
+class ScopedLargePageOptions
+{
+public:
+  ScopedLargePageOptions(const LargePageOptions& options) : previous_(getLargePageOptions())
+  {
+    setLargePageOptions(options);
+  }
+  ~ScopedLargePageOptions() { setLargePageOptions(previous_); }
+
+  ScopedLargePageOptions(const ScopedLargePageOptions&) = delete;
+  ScopedLargePageOptions& operator=(const ScopedLargePageOptions&) = delete;
+
+private:
+  const LargePageOptions previous_;
+};
+
+/** map bytes of zeroed host memory following the current options
+ * @return nullptr when the options are the default ones or bytes is too small to gain from huge pages,
+ *         the caller then uses its own allocator
+ *
+ * The returned memory is aligned to at least 4KB.
+ */
+void* allocateLargePages(size_t bytes);
+
+/** unmap memory returned by allocateLargePages
+ * @return false if ptr was not returned by allocateLargePages
+ */
+bool deallocateLargePages(void* ptr);
+
+struct LargePageStats
+{
+  /// regions currently mapped and their bytes
+  size_t regions = 0;
+  size_t bytes   = 0;
+  /// bytes currently on explicit huge pages and locked in memory
+  size_t hugetlb_bytes = 0;
+  size_t pinned_bytes  = 0;
+  /// explicit huge page requests served by transparent huge pages, failed page locks
+  size_t hugetlb_fallbacks = 0;
+  size_t pin_failures      = 0;
+};
+
+LargePageStats getLargePageStats();
+
+} // namespace qmcplusplus
+#endif
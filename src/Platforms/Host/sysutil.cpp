@@ -84,3 +84,40 @@ size_t memusage()
   return 0;
 #endif
 }
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+int getCurrentCPU()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+    return cpu;
+#endif
+  return -1;
+}
+
+int getCurrentNUMANode()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+    return node;
+#endif
+  return -1;
+}
+
+int getMemoryNUMANode(const void* addr)
+{
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+  // MPOL_F_NODE | MPOL_F_ADDR of numaif.h, the node of the page at addr, without linking libnuma
+  const unsigned long flags = 1 | 2;
+  int node                  = -1;
+  if (syscall(SYS_get_mempolicy, &node, nullptr, 0, addr, flags) == 0)
+    return node;
+#endif
+  return -1;
+}
@@ -34,4 +34,13 @@ size_t freemem();
 
 size_t memusage();
 
+/// return the CPU the calling thread runs on, -1 if unknown
+int getCurrentCPU();
+
+/// return the NUMA node the calling thread runs on, -1 if unknown
+int getCurrentNUMANode();
+
+/// return the NUMA node holding the page of addr, -1 if unknown. An untouched page is placed as if read.
+int getMemoryNUMANode(const void* addr);
+
 #endif
@@ -0,0 +1,180 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "MemoryAccounting.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+namespace qmcplusplus
+{
+namespace
+{
+thread_local int current_tag = 0;
+
+std::mutex& tag_mutex()
+{
+  static std::mutex m;
+  return m;
+}
+
+std::vector<std::string>& tag_names()
+{
+  static std::vector<std::string>* names = new std::vector<std::string>{"other"};
+  return *names;
+}
+} // namespace
+
+MemoryAccounting::MemoryAccounting() : num_tagged_(0)
+{
+  for (auto& tag : current_)
+    for (auto& bytes : tag)
+      bytes = 0;
+  for (auto& tag : peak_)
+    for (auto& bytes : tag)
+      bytes = 0;
+}
+
+int MemoryAccounting::getTagID(const std::string& tag)
+{
+  std::lock_guard<std::mutex> lock(tag_mutex());
+  auto& names = tag_names();
+  auto it     = std::find(names.begin(), names.end(), tag);
+  if (it != names.end())
+    return it - names.begin();
+  if (names.size() == max_tags)
+    return 0;
+  names.push_back(tag);
+  return names.size() - 1;
+}
+
+std::string MemoryAccounting::getTagName(int id)
+{
+  std::lock_guard<std::mutex> lock(tag_mutex());
+  return tag_names()[id];
+}
+
+std::vector<std::string> MemoryAccounting::getTagNames()
+{
+  std::lock_guard<std::mutex> lock(tag_mutex());
+  return tag_names();
+}
+
+int MemoryAccounting::getCurrentTag() { return current_tag; }
+
+int MemoryAccounting::setCurrentTag(int id)
+{
+  const int previous = current_tag;
+  current_tag        = id;
+  return previous;
+}
+
+size_t MemoryAccounting::makeKey(MemorySpace space, const void* ptr)
+{
+  // the allocations are at least 4 byte aligned, the low bits are free for the space
+  return reinterpret_cast<std::uintptr_t>(ptr) ^ static_cast<size_t>(space);
+}
+
+void MemoryAccounting::allocate(MemorySpace space, const void* ptr, size_t bytes)
+{
+  const int tag = current_tag;
+  if (tag != 0)
+  {
+    const size_t key = makeKey(space, ptr);
+    Shard& shard     = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.tags[key] = tag;
+    num_tagged_++;
+  }
+  add(tag, space, bytes);
+}
+
+void MemoryAccounting::deallocate(MemorySpace space, const void* ptr, size_t bytes)
+{
+  int tag = 0;
+  if (num_tagged_ > 0)
+  {
+    const size_t key = makeKey(space, ptr);
+    Shard& shard     = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.tags.find(key);
+    if (it != shard.tags.end())
+    {
+      tag = it->second;
+      shard.tags.erase(it);
+      num_tagged_--;
+    }
+  }
+  remove(tag, space, bytes);
+}
+
+void MemoryAccounting::add(int tag, MemorySpace space, size_t bytes)
+{
+  const int s       = static_cast<int>(space);
+  const size_t held = current_[tag][s] += bytes;
+  size_t peak       = peak_[tag][s];
+  while (held > peak && !peak_[tag][s].compare_exchange_weak(peak, held))
+    ;
+}
+
+void MemoryAccounting::remove(int tag, MemorySpace space, size_t bytes)
+{
+  current_[tag][static_cast<int>(space)] -= bytes;
+}
+
+std::vector<MemoryAccounting::TagStats> MemoryAccounting::getStats() const
+{
+  const std::vector<std::string> names = getTagNames();
+  std::vector<TagStats> stats;
+  for (int tag = 0; tag < names.size(); tag++)
+    for (int s = 0; s < num_spaces; s++)
+      if (peak_[tag][s] > 0)
+        stats.push_back({names[tag], static_cast<MemorySpace>(s), current_[tag][s], peak_[tag][s]});
+  return stats;
+}
+
+const char* MemoryAccounting::getSpaceName(MemorySpace space)
+{
+  switch (space)
+  {
+  case MemorySpace::HOST:
+    return "host";
+  case MemorySpace::PINNED:
+    return "pinned";
+  case MemorySpace::DEVICE:
+    return "device";
+  default:
+    return "unknown";
+  }
+}
+
+void MemoryAccounting::print(std::ostream& log) const
+{
+  char buf[128];
+  snprintf(buf, sizeof(buf), "%-24s %-8s %12s %12s\n", "Memory tag", "space", "current MiB", "peak MiB");
+  log << buf;
+  for (const auto& s : getStats())
+  {
+    snprintf(buf, sizeof(buf), "%-24s %-8s %12.2f %12.2f\n", s.tag.c_str(), getSpaceName(s.space),
+             s.current / 1048576.0, s.peak / 1048576.0);
+    log << buf;
+  }
+}
+
+MemoryAccounting& getMemoryAccounting()
+{
+  // never destroyed, the containers of the static objects release their memory after main
+  static MemoryAccounting* accounting = new MemoryAccounting;
+  return *accounting;
+}
+
+} // namespace qmcplusplus
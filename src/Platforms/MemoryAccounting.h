@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file MemoryAccounting.h
+ * @brief current and peak bytes of the allocators by subsystem tag and memory space
+ */
+#ifndef QMCPLUSPLUS_MEMORY_ACCOUNTING_H
+#define QMCPLUSPLUS_MEMORY_ACCOUNTING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace qmcplusplus
+{
+/** memory spaces of the accounted allocators
+ *
+ * PINNED is the page locked part of the host memory. The pages locked by CUDALockedPageAllocator
+ * are also counted as HOST by the aligned allocator underneath.
+ */
+enum class MemorySpace
+{
+  HOST = 0,
+  PINNED,
+  DEVICE,
+  NUM_SPACES
+};
+
+/** registry of the bytes held by the allocators, by subsystem tag and memory space
+ *
+ * An allocation is charged to the tag current on the allocating thread, see ScopedMemoryTag,
+ * and is remembered by pointer so that its release is credited to the same tag from any thread.
+ * The allocations outside any tag are charged to the tag "other" and not remembered.
+ */
+class MemoryAccounting
+{
+public:
+  static constexpr int max_tags   = 32;
+  static constexpr int num_spaces = static_cast<int>(MemorySpace::NUM_SPACES);
+
+  struct TagStats
+  {
+    std::string tag;
+    MemorySpace space;
+    size_t current;
+    size_t peak;
+  };
+
+  MemoryAccounting();
+
+  /// the id of tag, registered on first use and shared by all the registries, the tags beyond max_tags share "other"
+  static int getTagID(const std::string& tag);
+  /// the tag of an id
+  static std::string getTagName(int id);
+  /// the tags in the order of their ids
+  static std::vector<std::string> getTagNames();
+
+  /// the tag id current on this thread
+  static int getCurrentTag();
+  /// set the tag id current on this thread, returns the previous one
+  static int setCurrentTag(int id);
+
+  /// charge an allocation of bytes at ptr in space to the current tag
+  void allocate(MemorySpace space, const void* ptr, size_t bytes);
+  /// credit the release of an allocation to the tag it was charged to
+  void deallocate(MemorySpace space, const void* ptr, size_t bytes);
+
+  /// charge bytes to a tag without remembering a pointer, for the memory resources outside the allocators
+  void add(int tag, MemorySpace space, size_t bytes);
+  /// credit bytes charged by add
+  void remove(int tag, MemorySpace space, size_t bytes);
+
+  /// the current and peak bytes of the tags and spaces ever used, in the order of the tag ids
+  std::vector<TagStats> getStats() const;
+
+  /// print the current and peak bytes of the tags ever used
+  void print(std::ostream& log) const;
+
+  static const char* getSpaceName(MemorySpace space);
+
+private:
+  struct Shard
+  {
+    std::mutex mutex;
+    /// tag id of the tagged allocations, keyed by pointer and space
+    std::unordered_map<size_t, int> tags;
+  };
+  static constexpr int num_shards = 16;
+
+  std::array<std::array<std::atomic<size_t>, num_spaces>, max_tags> current_;
+  std::array<std::array<std::atomic<size_t>, num_spaces>, max_tags> peak_;
+  std::array<Shard, num_shards> shards_;
+  /// number of the remembered allocations, their lookup is skipped while zero
+  std::atomic<size_t> num_tagged_;
+
+  static size_t makeKey(MemorySpace space, const void* ptr);
+  Shard& getShard(size_t key) { return shards_[(key >> 6) % num_shards]; }
+};
+
+/// the registry of the process, valid during the static initialization and destruction
+MemoryAccounting& getMemoryAccounting();
+
+/** charge the allocations of the current thread to a tag for the scope
+ *
+ * Scopes nest, the enclosing tag is restored at the end of the scope.
+ */
+class ScopedMemoryTag
+{
+public:
+  ScopedMemoryTag(const std::string& tag)
+      : previous_(MemoryAccounting::setCurrentTag(MemoryAccounting::getTagID(tag)))
+  {}
+  ~ScopedMemoryTag() { MemoryAccounting::setCurrentTag(previous_); }
+
+  ScopedMemoryTag(const ScopedMemoryTag&) = delete;
+  ScopedMemoryTag& operator=(const ScopedMemoryTag&) = delete;
+
+private:
+  const int previous_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -15,6 +15,8 @@
 #include <string>
 #include <iomanip>
 #include "Host/sysutil.h"
+#include "DeviceMemoryPool.h"
+#include "MemoryAccounting.h"
 #include "OMPTarget/OMPallocator.hpp"
 #ifdef ENABLE_CUDA
 #include "CUDA/CUDAallocator.hpp"
@@ -44,6 +46,10 @@ void print_mem(const std::string& title, std::ostream& log)
   log << "Device memory allocated via OpenMP offload : " << std::setw(7) << (getOMPdeviceMemAllocated() >> 20) << " MiB"
       << std::endl;
 #endif
+#if defined(ENABLE_CUDA) || defined(ENABLE_OFFLOAD)
+  DeviceMemoryPool::printStats(log);
+#endif
+  getMemoryAccounting().print(log);
   log << line_separator << std::endl;
 }
 
@@ -39,7 +39,7 @@ public:
       throw std::runtime_error("Inconsistent number of OpenMP devices with the previous record!");
     if (omp_device_count > local_size)
       app_warning() << "More OpenMP devices than the number of MPI ranks. "
-                    << "Some devices will be left idle.\n"
+                    << "Some devices will be left idle unless the drivers spread crowds over them with crowd_devices.\n"
                     << "There is potential performance issue with the GPU affinity.\n";
     if (num_devices > 0)
     {
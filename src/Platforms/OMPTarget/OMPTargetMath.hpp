@@ -26,5 +26,28 @@ inline void sincos(float a, float* restrict s, float* restrict c)
 {
   ::sincosf(a,s,c);
 }
+
+/** compensated (Kahan) update sum += delta
+ * @param sum running sum
+ * @param comp running compensation, the low-order part lost by previous updates. Must start from zero.
+ * @param delta increment
+ *
+ * Reassociation is disabled locally because -ffast-math would fold the compensation away,
+ * with a pragma for clang and a function attribute for GCC.
+ */
+template<typename T>
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-associative-math")))
+#endif
+inline void kahanAdd(T& sum, T& comp, const T delta)
+{
+#if defined(__clang__)
+#pragma clang fp reassociate(off)
+#endif
+  const T y = delta - comp;
+  const T t = sum + y;
+  comp      = (t - sum) - y;
+  sum       = t;
+}
 }
 #endif
@@ -20,9 +20,13 @@
 #include <atomic>
 #include "config.h"
 #include "allocator_traits.hpp"
+#include "DeviceMemoryPool.h"
+#include "MemoryAccounting.h"
 
-#if defined(QMC_OFFLOAD_MEM_ASSOCIATED)
+#if defined(QMC_OFFLOAD_MEM_ASSOCIATED) || defined(ENABLE_CUDA)
 #include <CUDA/CUDAruntime.hpp>
+#endif
+#if defined(ENABLE_OFFLOAD)
 #include <omp.h>
 #endif
 
@@ -68,9 +72,9 @@ struct OMPallocator : public HostAllocator
    *  However until allocators are correct > c++11 this is retained since
    *  our < c++11 compliant containers may expect it.
    */
-  OMPallocator(const OMPallocator&) : device_ptr_(nullptr) {}
+  OMPallocator(const OMPallocator&) : device_ptr_(nullptr), device_num_(0) {}
   template<class U, class V>
-  OMPallocator(const OMPallocator<U, V>&) : device_ptr_(nullptr)
+  OMPallocator(const OMPallocator<U, V>&) : device_ptr_(nullptr), device_num_(0)
   {}
 
   template<class U, class V>
@@ -82,15 +86,14 @@ struct OMPallocator : public HostAllocator
   value_type* allocate(std::size_t n)
   {
     static_assert(std::is_same<T, value_type>::value, "OMPallocator and HostAllocator data types must agree!");
-    value_type* pt = HostAllocator::allocate(n);
-#if defined(QMC_OFFLOAD_MEM_ASSOCIATED)
-    cudaErrorCheck(cudaMalloc(&device_ptr_, n * sizeof(T)), "cudaMalloc failed in OMPallocator!");
-    const int status = omp_target_associate_ptr(pt, device_ptr_, n * sizeof(T), 0, omp_get_default_device());
-    if (status != 0)
-      throw std::runtime_error("omp_target_associate_ptr failed in OMPallocator!");
+#if defined(ENABLE_OFFLOAD)
+    device_num_ = omp_get_default_device();
+    value_type* pt = static_cast<value_type*>(getPool().allocate(n * sizeof(T), device_num_));
+    device_ptr_    = getOffloadDevicePtr(pt);
+    getMemoryAccounting().allocate(MemorySpace::DEVICE, pt, n * sizeof(T));
 #else
-    PRAGMA_OFFLOAD("omp target enter data map(alloc:pt[0:n])")
-    device_ptr_ = getOffloadDevicePtr(pt);
+    value_type* pt = HostAllocator::allocate(n);
+    device_ptr_    = pt;
 #endif
     OMPallocator_device_mem_allocated += n * sizeof(T);
     return pt;
@@ -99,29 +102,78 @@ struct OMPallocator : public HostAllocator
   void deallocate(value_type* pt, std::size_t n)
   {
     OMPallocator_device_mem_allocated -= n * sizeof(T);
-#if defined(QMC_OFFLOAD_MEM_ASSOCIATED)
-    T* device_ptr_from_omp = getOffloadDevicePtr(pt);
-    const int status       = omp_target_disassociate_ptr(pt, omp_get_default_device());
-    if (status != 0)
-      throw std::runtime_error("omp_target_disassociate_ptr failed in OMPallocator!");
-    cudaErrorCheck(cudaFree(device_ptr_from_omp), "cudaFree failed in OMPallocator!");
+#if defined(ENABLE_OFFLOAD)
+    getMemoryAccounting().deallocate(MemorySpace::DEVICE, pt, n * sizeof(T));
+    // cached for the device holding the memory which may differ from the current default device
+    getPool().deallocate(pt, n * sizeof(T), device_num_);
 #else
-    PRAGMA_OFFLOAD("omp target exit data map(delete:pt[0:n])")
-#endif
     HostAllocator::deallocate(pt, n);
+#endif
   }
 
   void attachReference(const OMPallocator& from, std::ptrdiff_t ptr_offset)
   {
     device_ptr_ = const_cast<typename OMPallocator::pointer>(from.get_device_ptr()) + ptr_offset;
+    device_num_ = from.device_num_;
   }
 
   T* get_device_ptr() { return device_ptr_; }
   const T* get_device_ptr() const { return device_ptr_; }
+  /// the OpenMP device holding the memory
+  int get_device_num() const { return device_num_; }
+
+  /** the pool of the host/device pairs, blocks stay mapped while cached
+   *  Sized by DeviceMemoryPool::roundSize, the blocks are shared by the OMPallocators of T and HostAllocator.
+   */
+  static DeviceMemoryPool& getPool()
+  {
+    static DeviceMemoryPool pool("OpenMP offload", poolAllocate, poolFree);
+    return pool;
+  }
 
 private:
+  static void* poolAllocate(size_t bytes, int device_num)
+  {
+    const size_t n = (bytes + sizeof(T) - 1) / sizeof(T);
+    HostAllocator host_allocator;
+    T* pt = host_allocator.allocate(n);
+#if defined(QMC_OFFLOAD_MEM_ASSOCIATED)
+    T* device_ptr;
+    if (cudaMalloc(&device_ptr, n * sizeof(T)) != cudaSuccess)
+    {
+      host_allocator.deallocate(pt, n);
+      return nullptr;
+    }
+    const int status = omp_target_associate_ptr(pt, device_ptr, n * sizeof(T), 0, device_num);
+    if (status != 0)
+      throw std::runtime_error("omp_target_associate_ptr failed in OMPallocator!");
+#else
+    PRAGMA_OFFLOAD("omp target enter data map(alloc:pt[0:n]) device(device_num)")
+#endif
+    return pt;
+  }
+
+  static void poolFree(void* ptr, size_t bytes, int device_num)
+  {
+    const size_t n = (bytes + sizeof(T) - 1) / sizeof(T);
+    T* pt          = static_cast<T*>(ptr);
+#if defined(QMC_OFFLOAD_MEM_ASSOCIATED)
+    T* device_ptr_from_omp = getOffloadDevicePtr(pt);
+    const int status       = omp_target_disassociate_ptr(pt, device_num);
+    if (status != 0)
+      throw std::runtime_error("omp_target_disassociate_ptr failed in OMPallocator!");
+    cudaErrorCheck(cudaFree(device_ptr_from_omp), "cudaFree failed in OMPallocator!");
+#else
+    PRAGMA_OFFLOAD("omp target exit data map(delete:pt[0:n]) device(device_num)")
+#endif
+    HostAllocator host_allocator;
+    host_allocator.deallocate(pt, n);
+  }
+
   // pointee is on device.
   T* device_ptr_ = nullptr;
+  // OpenMP device number at the time of allocation
+  int device_num_ = 0;
 };
 
 /** Specialization for OMPallocator which is a special DualAllocator with fused
@@ -148,16 +200,47 @@ struct qmc_allocator_traits<OMPallocator<T, HostAllocator>>
     to.attachReference(from, ptr_offset);
   }
 
+  /// transfers go to the device holding the memory, whatever the default device of the calling thread
   static void updateTo(OMPallocator<T, HostAllocator>& alloc, T* host_ptr, size_t n)
   {
-    PRAGMA_OFFLOAD("omp target update to(host_ptr[:n])");
+    PRAGMA_OFFLOAD("omp target update to(host_ptr[:n]) device(alloc.get_device_num())");
   }
 
   static void updateFrom(OMPallocator<T, HostAllocator>& alloc, T* host_ptr, size_t n)
   {
-    PRAGMA_OFFLOAD("omp target update from(host_ptr[:n])");
+    PRAGMA_OFFLOAD("omp target update from(host_ptr[:n]) device(alloc.get_device_num())");
   }
 
+  /// OpenMP cannot queue on a user stream, synchronous transfers
+  template<class Queue>
+  static void updateToAsync(OMPallocator<T, HostAllocator>& alloc, T* host_ptr, size_t n, Queue& queue)
+  {
+    updateTo(alloc, host_ptr, n);
+  }
+
+  template<class Queue>
+  static void updateFromAsync(OMPallocator<T, HostAllocator>& alloc, T* host_ptr, size_t n, Queue& queue)
+  {
+    updateFrom(alloc, host_ptr, n);
+  }
+
+#if defined(ENABLE_OFFLOAD) && defined(ENABLE_CUDA)
+  /// the OpenMP runtime allocates with the CUDA runtime, copy on the stream to the mapped device memory
+  static void updateToAsync(OMPallocator<T, HostAllocator>& alloc, T* host_ptr, size_t n, cudaStream_t& stream)
+  {
+    T* device_ptr = getOffloadDevicePtr(host_ptr);
+    cudaErrorCheck(cudaMemcpyAsync(device_ptr, host_ptr, sizeof(T) * n, cudaMemcpyHostToDevice, stream),
+                   "cudaMemcpyAsync failed in OMPallocator updateToAsync");
+  }
+
+  static void updateFromAsync(OMPallocator<T, HostAllocator>& alloc, T* host_ptr, size_t n, cudaStream_t& stream)
+  {
+    T* device_ptr = getOffloadDevicePtr(host_ptr);
+    cudaErrorCheck(cudaMemcpyAsync(host_ptr, device_ptr, sizeof(T) * n, cudaMemcpyDeviceToHost, stream),
+                   "cudaMemcpyAsync failed in OMPallocator updateFromAsync");
+  }
+#endif
+
   // Not very optimized device side copy.  Only used for testing.
   static void deviceSideCopyN(OMPallocator<T, HostAllocator>& alloc, size_t to, size_t n, size_t from)
   {
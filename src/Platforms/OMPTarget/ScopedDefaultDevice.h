@@ -0,0 +1,108 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_SCOPED_DEFAULT_DEVICE_H
+#define QMCPLUSPLUS_SCOPED_DEFAULT_DEVICE_H
+
+#include "config.h"
+#if defined(ENABLE_OFFLOAD)
+#include <omp.h>
+#endif
+#if defined(ENABLE_CUDA)
+#include "CUDA/CUDAruntime.hpp"
+#endif
+
+namespace qmcplusplus
+{
+/** switch the OpenMP default device of the calling thread within a scope
+ *
+ * The default device is a per-thread setting. Offload regions and OMPallocator allocations
+ * inside the scope go to device_num. The previous default device is restored at the exit of the scope.
+ * A negative device_num keeps the current default device. Without offload, this class does nothing.
+ * In CUDA builds the current CUDA device of the thread is switched as well, the numbering being the same.
+ */
+class ScopedDefaultDevice
+{
+public:
+  ScopedDefaultDevice(int device_num)
+  {
+#if defined(ENABLE_OFFLOAD)
+    saved_device_num_ = omp_get_default_device();
+    if (device_num >= 0)
+      omp_set_default_device(device_num);
+#endif
+#if defined(ENABLE_CUDA)
+    cudaErrorCheck(cudaGetDevice(&saved_cuda_device_num_), "cudaGetDevice failed!");
+    cuda_switched_ = device_num >= 0 && device_num != saved_cuda_device_num_;
+    if (cuda_switched_)
+      cudaErrorCheck(cudaSetDevice(device_num), "cudaSetDevice failed!");
+#endif
+  }
+
+  ~ScopedDefaultDevice()
+  {
+#if defined(ENABLE_OFFLOAD)
+    omp_set_default_device(saved_device_num_);
+#endif
+#if defined(ENABLE_CUDA)
+    if (cuda_switched_)
+      cudaSetDevice(saved_cuda_device_num_);
+#endif
+  }
+
+  ScopedDefaultDevice(const ScopedDefaultDevice&) = delete;
+  ScopedDefaultDevice& operator=(const ScopedDefaultDevice&) = delete;
+
+private:
+  int saved_device_num_ = 0;
+#if defined(ENABLE_CUDA)
+  int saved_cuda_device_num_ = 0;
+  bool cuda_switched_         = false;
+#endif
+};
+
+/// return the number of OpenMP offload devices, 0 without offload
+inline int getNumOffloadDevices()
+{
+#if defined(ENABLE_OFFLOAD)
+  return omp_get_num_devices();
+#else
+  return 0;
+#endif
+}
+
+/// return the OpenMP default device of the calling thread, 0 without offload
+inline int getDefaultOffloadDevice()
+{
+#if defined(ENABLE_OFFLOAD)
+  return omp_get_default_device();
+#else
+  return 0;
+#endif
+}
+
+/** return true if the host memory ptr has a copy on the OpenMP default device of the calling thread
+ *
+ * Shared read-only tables are allocated on the device of the thread creating them. A clone made under another
+ * default device uses this to find that it needs its own device copy. Always true without offload.
+ */
+inline bool isPresentOnDefaultDevice(const void* ptr)
+{
+#if defined(ENABLE_OFFLOAD)
+  return omp_target_is_present(ptr, omp_get_default_device());
+#else
+  return true;
+#endif
+}
+
+} // namespace qmcplusplus
+#endif
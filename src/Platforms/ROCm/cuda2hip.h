@@ -78,17 +78,25 @@
 #define cudaDeviceReset                 hipDeviceReset
 #define cudaDeviceSynchronize           hipDeviceSynchronize
 #define cudaError_t                     hipError_t
+#define cudaErrorNotReady               hipErrorNotReady
 #define cudaEvent_t                     hipEvent_t
 #define cudaEventCreate                 hipEventCreate
 #define cudaEventCreateWithFlags        hipEventCreateWithFlags
 #define cudaEventDestroy                hipEventDestroy
 #define cudaEventDisableTiming          hipEventDisableTiming
 #define cudaEventElapsedTime            hipEventElapsedTime
+#define cudaEventQuery                  hipEventQuery
 #define cudaEventRecord                 hipEventRecord
 #define cudaEventSynchronize            hipEventSynchronize
 #define cudaFilterModeLinear            hipFilterModeLinear
 #define cudaFree                        hipFree
 #define cudaFreeHost                    hipHostFree
+#define cudaGraphDestroy                hipGraphDestroy
+#define cudaGraphExecDestroy            hipGraphExecDestroy
+#define cudaGraphExec_t                 hipGraphExec_t
+#define cudaGraphInstantiateWithFlags   hipGraphInstantiateWithFlags
+#define cudaGraphLaunch                 hipGraphLaunch
+#define cudaGraph_t                     hipGraph_t
 #define cudaGetDevice                   hipGetDevice
 #define cudaGetDeviceCount              hipGetDeviceCount
 #define cudaGetDeviceProperties         hipGetDeviceProperties
@@ -127,13 +135,20 @@
 #define cudaMemcpyToSymbol              hipMemcpyToSymbol
 #define cudaMemcpyToSymbolAsync         hipMemcpyToSymbolAsync
 #define cudaMemset                      hipMemset
+#define cudaMemsetAsync                 hipMemsetAsync
 #define cudaMemGetInfo                  hipMemGetInfo
 #define cudaMemPrefetchAsync            hipMemPrefetchAsync
 #define cudaReadModeElementType         hipReadModeElementType
 #define cudaSetDevice                   hipSetDevice
 #define cudaStream_t                    hipStream_t
+#define cudaStreamBeginCapture          hipStreamBeginCapture
+#define cudaStreamCaptureModeThreadLocal hipStreamCaptureModeThreadLocal
 #define cudaStreamCreate                hipStreamCreate
+#define cudaStreamCreateWithFlags       hipStreamCreateWithFlags
 #define cudaStreamDestroy               hipStreamDestroy
+#define cudaStreamEndCapture            hipStreamEndCapture
+#define cudaStreamNonBlocking           hipStreamNonBlocking
+#define cudaStreamPerThread             hipStreamPerThread
 #define cudaStreamSynchronize           hipStreamSynchronize
 #define cudaStreamWaitEvent             hipStreamWaitEvent
 #define cudaSuccess                     hipSuccess
@@ -37,6 +37,20 @@ struct qmc_allocator_traits
   // These abstract synchronous transfers, async semantics are vender specific
   static void updateTo(Allocator& a, value_type* host_ptr, size_t n) {}
   static void updateFrom(Allocator& a, value_type* host_ptr, size_t n) {}
+  /** transfers ordered on a device queue, e.g. a cudaStream_t,
+   *  the host may not touch host_ptr[0:n] until they are done.
+   *  The allocators without such a queue fall back to the synchronous transfers.
+   */
+  template<class Queue>
+  static void updateToAsync(Allocator& a, value_type* host_ptr, size_t n, Queue& queue)
+  {
+    qmc_allocator_traits<Allocator>::updateTo(a, host_ptr, n);
+  }
+  template<class Queue>
+  static void updateFromAsync(Allocator& a, value_type* host_ptr, size_t n, Queue& queue)
+  {
+    qmc_allocator_traits<Allocator>::updateFrom(a, host_ptr, n);
+  }
   static void deviceSideCopyN(Allocator& a, size_t to, size_t n, size_t from) {}
 };
 
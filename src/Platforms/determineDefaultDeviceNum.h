@@ -14,6 +14,8 @@
 #ifndef QMCPLUSPLUS_DETERMINEDEFAULTDEVICENUM_H
 #define QMCPLUSPLUS_DETERMINEDEFAULTDEVICENUM_H
 
+#include <vector>
+
 namespace qmcplusplus
 {
 /** distribute MPI ranks among devices
@@ -35,6 +37,25 @@ inline int determineDefaultDeviceNum(int num_devices, int rank_id, int num_ranks
     assigned_device_id = (rank_id + num_devices - residual) / (min_ranks_per_device + 1);
   return assigned_device_id;
 }
+
+/** list the devices a MPI rank may drive
+ *
+ * With at least as many ranks as devices, it is the default device only.
+ * With fewer ranks, the devices are dealt to the ranks in turn so that none is left idle.
+ * The first device of the list is always the one given by determineDefaultDeviceNum.
+ */
+inline std::vector<int> determineDeviceNums(int num_devices, int rank_id, int num_ranks)
+{
+  std::vector<int> device_nums;
+  if (num_devices <= 0)
+    return device_nums;
+  if (num_ranks >= num_devices)
+    device_nums.push_back(determineDefaultDeviceNum(num_devices, rank_id, num_ranks));
+  else
+    for (int device_num = rank_id; device_num < num_devices; device_num += num_ranks)
+      device_nums.push_back(device_num);
+  return device_nums;
 }
+} // namespace qmcplusplus
 
 #endif
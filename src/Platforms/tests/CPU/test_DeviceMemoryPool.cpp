@@ -0,0 +1,157 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <cstdlib>
+#include <sstream>
+#include "DeviceMemoryPool.h"
+
+namespace qmcplusplus
+{
+namespace
+{
+int num_allocs = 0;
+int num_frees  = 0;
+int num_syncs  = 0;
+// allocations above it fail
+size_t alloc_limit = 1 << 30;
+
+void* testAllocate(size_t bytes, int device)
+{
+  if (bytes > alloc_limit)
+    return nullptr;
+  num_allocs++;
+  return std::malloc(bytes);
+}
+
+void testFree(void* ptr, size_t bytes, int device)
+{
+  num_frees++;
+  std::free(ptr);
+}
+
+void testSync(int device) { num_syncs++; }
+} // namespace
+
+TEST_CASE("DeviceMemoryPool size classes", "[platform]")
+{
+  CHECK(DeviceMemoryPool::roundSize(0) == 512);
+  CHECK(DeviceMemoryPool::roundSize(1) == 512);
+  CHECK(DeviceMemoryPool::roundSize(513) == 1024);
+  CHECK(DeviceMemoryPool::roundSize(4096) == 4096);
+  CHECK(DeviceMemoryPool::roundSize((1 << 20) - 1) == (1 << 20));
+  CHECK(DeviceMemoryPool::roundSize((1 << 20) + 1) == (2 << 20));
+  CHECK(DeviceMemoryPool::roundSize((5 << 20) + 7) == (6 << 20));
+}
+
+TEST_CASE("DeviceMemoryPool reuse", "[platform]")
+{
+  num_allocs = num_frees = num_syncs = 0;
+  DeviceMemoryPool pool("test", testAllocate, testFree, testSync);
+
+  void* a = pool.allocate(1000);
+  CHECK(num_allocs == 1);
+  pool.deallocate(a, 1000);
+  CHECK(pool.getStats().cached_bytes == 1024);
+
+  // same size class, released without a stream: reused after one synchronization
+  void* b = pool.allocate(700);
+  CHECK(b == a);
+  CHECK(num_allocs == 1);
+  CHECK(num_syncs == 1);
+
+  // another size class and another device miss the cache
+  void* c = pool.allocate(3000);
+  void* d = pool.allocate(700, 1);
+  CHECK(num_allocs == 3);
+
+  pool.deallocate(b, 700);
+  pool.deallocate(c, 3000);
+  pool.deallocate(d, 700, 1);
+  b = pool.allocate(1024);
+  c = pool.allocate(2049);
+  CHECK(num_allocs == 3);
+  // one synchronization covers the blocks released before it
+  CHECK(num_syncs == 2);
+  pool.deallocate(b, 1024);
+  pool.deallocate(c, 2049);
+
+  auto stats = pool.getStats();
+  CHECK(stats.in_use_bytes == 0);
+  CHECK(stats.cached_bytes == 1024 + 4096 + 1024);
+  CHECK(stats.peak_bytes == 1024 + 4096 + 1024);
+  CHECK(stats.hits == 3);
+  CHECK(stats.misses == 3);
+
+  pool.release();
+  CHECK(num_frees == 3);
+  CHECK(pool.getStats().cached_bytes == 0);
+  CHECK(pool.getStats().releases == 3);
+}
+
+TEST_CASE("DeviceMemoryPool streams", "[platform]")
+{
+  num_allocs = num_frees = num_syncs = 0;
+  DeviceMemoryPool pool("test", testAllocate, testFree, testSync);
+  int stream1, stream2;
+
+  void* a = pool.allocate(100, 0, &stream1);
+  pool.deallocate(a, 100, 0, &stream1);
+  // the free list of stream1 is not visible to stream2 nor to the requests without a stream
+  void* b = pool.allocate(100, 0, &stream2);
+  void* c = pool.allocate(100);
+  CHECK(b != a);
+  CHECK(c != a);
+  CHECK(num_allocs == 3);
+  // stream ordered reuse needs no synchronization
+  void* d = pool.allocate(100, 0, &stream1);
+  CHECK(d == a);
+  CHECK(num_syncs == 0);
+  pool.deallocate(b, 100, 0, &stream2);
+  pool.deallocate(c, 100);
+  pool.deallocate(d, 100, 0, &stream1);
+  pool.release();
+  CHECK(num_frees == 3);
+}
+
+TEST_CASE("DeviceMemoryPool limits", "[platform]")
+{
+  num_allocs = num_frees = num_syncs = 0;
+  DeviceMemoryPool pool("test", testAllocate, testFree, testSync);
+
+  // beyond the cap the blocks go back to the runtime
+  pool.setMaxCachedBytes(1024);
+  void* a = pool.allocate(1024);
+  void* b = pool.allocate(512);
+  pool.deallocate(a, 1024);
+  pool.deallocate(b, 512);
+  CHECK(num_frees == 1);
+  CHECK(pool.getStats().cached_bytes == 1024);
+
+  // a failed allocation releases the cache and is retried
+  alloc_limit = 4096;
+  void* c     = pool.allocate(4096);
+  CHECK(num_frees == 1);
+  CHECK_THROWS_AS(pool.allocate(8192), std::runtime_error);
+  CHECK(num_frees == 2);
+  CHECK(pool.getStats().cached_bytes == 0);
+  alloc_limit = 1 << 30;
+  pool.deallocate(c, 4096);
+  CHECK(num_frees == 3);
+
+  std::ostringstream log;
+  DeviceMemoryPool::printStats(log);
+  CHECK(log.str().find("Memory pool test") != std::string::npos);
+}
+
+} // namespace qmcplusplus
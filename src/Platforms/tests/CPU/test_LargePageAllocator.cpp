@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <vector>
+#include "CPU/SIMD/LargePageAllocator.hpp"
+
+namespace qmcplusplus
+{
+TEST_CASE("LargePageAllocator default options", "[platform]")
+{
+  CHECK(getLargePageOptions().kind == LargePageKind::DEFAULT);
+  const size_t regions = getLargePageStats().regions;
+  std::vector<double, LargePageAllocator<double>> v(1 << 20, 1.0);
+  // served by the aligned allocator
+  CHECK(getLargePageStats().regions == regions);
+  CHECK(reinterpret_cast<std::uintptr_t>(v.data()) % QMC_SIMD_ALIGNMENT == 0);
+}
+
+TEST_CASE("LargePageAllocator huge pages", "[platform]")
+{
+  for (const std::string kind : {"thp", "2MB", "1GB"})
+  {
+    LargePageOptions options;
+    options.kind = parseLargePageKind(kind);
+    const LargePageStats before(getLargePageStats());
+    {
+      ScopedLargePageOptions scope(options);
+      LargePageAllocator<float> allocator;
+      // too small for huge pages
+      float* small = allocator.allocate(100);
+      CHECK(getLargePageStats().regions == before.regions);
+      allocator.deallocate(small, 100);
+
+      const size_t n = 3 << 20;
+      float* large   = allocator.allocate(n);
+      large[0]       = 1.0f;
+      large[n - 1]   = 2.0f;
+      CHECK(large[1] == 0.0f);
+      const LargePageStats stats(getLargePageStats());
+      CHECK(stats.regions == before.regions + 1);
+      CHECK(stats.bytes >= before.bytes + n * sizeof(float));
+      // the explicit huge pages are served or counted as a fallback
+      if (options.kind != LargePageKind::TRANSPARENT)
+        CHECK(stats.hugetlb_bytes + stats.hugetlb_fallbacks > before.hugetlb_bytes + before.hugetlb_fallbacks);
+      allocator.deallocate(large, n);
+    }
+    CHECK(getLargePageOptions().kind == LargePageKind::DEFAULT);
+    CHECK(getLargePageStats().regions == before.regions);
+  }
+  CHECK_THROWS(parseLargePageKind("4KB"));
+}
+
+TEST_CASE("LargePageAllocator pinned", "[platform]")
+{
+  LargePageOptions options;
+  options.pinned = true;
+  ScopedLargePageOptions scope(options);
+  const LargePageStats before(getLargePageStats());
+  {
+    std::vector<double, LargePageAllocator<double>> v(1000, 2.0);
+    const LargePageStats stats(getLargePageStats());
+    CHECK(stats.regions == before.regions + 1);
+    // the lock is either taken or counted as a failure under a small memlock limit
+    CHECK(stats.pinned_bytes + stats.pin_failures > before.pinned_bytes + before.pin_failures);
+    CHECK(v[999] == 2.0);
+  }
+  CHECK(getLargePageStats().regions == before.regions);
+  CHECK(getLargePageStats().pinned_bytes == before.pinned_bytes);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <sstream>
+#include <thread>
+#include "MemoryAccounting.h"
+#include "CPU/SIMD/aligned_allocator.hpp"
+
+namespace qmcplusplus
+{
+namespace
+{
+MemoryAccounting::TagStats findStats(const MemoryAccounting& accounting, const std::string& tag, MemorySpace space)
+{
+  for (const auto& s : accounting.getStats())
+    if (s.tag == tag && s.space == space)
+      return s;
+  return {tag, space, 0, 0};
+}
+} // namespace
+
+TEST_CASE("MemoryAccounting tags", "[platform]")
+{
+  MemoryAccounting accounting;
+  int a, b, c;
+  {
+    ScopedMemoryTag tag("test splines");
+    const int id = accounting.getTagID("test splines");
+    CHECK(accounting.getTagName(id) == "test splines");
+    accounting.allocate(MemorySpace::HOST, &a, 1000);
+    {
+      ScopedMemoryTag inner("test determinants");
+      accounting.allocate(MemorySpace::DEVICE, &b, 300);
+    }
+    accounting.allocate(MemorySpace::HOST, &c, 200);
+  }
+  CHECK(MemoryAccounting::getCurrentTag() == 0);
+  // &c shares its address in another space, told apart by the space
+  accounting.allocate(MemorySpace::DEVICE, &c, 50);
+
+  CHECK(findStats(accounting, "test splines", MemorySpace::HOST).current == 1200);
+  CHECK(findStats(accounting, "test determinants", MemorySpace::DEVICE).current == 300);
+  CHECK(findStats(accounting, "other", MemorySpace::DEVICE).current == 50);
+
+  // released on another thread, without any tag current, credited to the tag of the allocation
+  std::thread t([&]() {
+    accounting.deallocate(MemorySpace::HOST, &a, 1000);
+    accounting.deallocate(MemorySpace::DEVICE, &b, 300);
+  });
+  t.join();
+  accounting.deallocate(MemorySpace::DEVICE, &c, 50);
+
+  auto splines = findStats(accounting, "test splines", MemorySpace::HOST);
+  CHECK(splines.current == 200);
+  CHECK(splines.peak == 1200);
+  auto dets = findStats(accounting, "test determinants", MemorySpace::DEVICE);
+  CHECK(dets.current == 0);
+  CHECK(dets.peak == 300);
+  CHECK(findStats(accounting, "other", MemorySpace::DEVICE).peak == 50);
+
+  accounting.add(accounting.getTagID("test buffers"), MemorySpace::DEVICE, 4096);
+  accounting.remove(accounting.getTagID("test buffers"), MemorySpace::DEVICE, 4096);
+  CHECK(findStats(accounting, "test buffers", MemorySpace::DEVICE).peak == 4096);
+
+  std::ostringstream log;
+  accounting.print(log);
+  CHECK(log.str().find("test determinants") != std::string::npos);
+}
+
+TEST_CASE("MemoryAccounting aligned allocator", "[platform]")
+{
+  auto& accounting = getMemoryAccounting();
+  {
+    ScopedMemoryTag tag("test aligned");
+    aligned_vector<double> v(100);
+    CHECK(findStats(accounting, "test aligned", MemorySpace::HOST).current >= 100 * sizeof(double));
+  }
+  CHECK(findStats(accounting, "test aligned", MemorySpace::HOST).current == 0);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,34 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "determineDefaultDeviceNum.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("determineDeviceNums", "[platforms]")
+{
+  // more ranks than devices, one device per rank
+  CHECK(determineDeviceNums(2, 0, 4) == std::vector<int>{0});
+  CHECK(determineDeviceNums(2, 3, 4) == std::vector<int>{1});
+  // fewer ranks than devices, the devices are dealt in turn
+  CHECK(determineDeviceNums(4, 0, 1) == std::vector<int>{0, 1, 2, 3});
+  CHECK(determineDeviceNums(6, 1, 4) == std::vector<int>{1, 5});
+  CHECK(determineDeviceNums(6, 3, 4) == std::vector<int>{3});
+  // the first device is the default one
+  for (int rank = 0; rank < 4; rank++)
+    CHECK(determineDeviceNums(6, rank, 4)[0] == determineDefaultDeviceNum(6, rank, 4));
+  CHECK(determineDeviceNums(0, 0, 1).empty());
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,59 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <vector>
+#include "config.h"
+#include "CPU/SIMD/algorithm.hpp"
+
+namespace qmcplusplus
+{
+template<typename T>
+void test_copy_if_less(int n, int skip)
+{
+  std::vector<T> in(n), out(n);
+  std::vector<int> out_index(n);
+  for (int i = 0; i < n; i++)
+    in[i] = (i * 7) % 11;
+
+  const T limit   = 5;
+  const int count = simd::copy_if_less(in.data(), n, limit, skip, out.data(), out_index.data());
+
+  int ref_count = 0;
+  for (int i = 0; i < n; i++)
+    if (in[i] < limit && i != skip)
+    {
+      REQUIRE(ref_count < count);
+      CHECK(out[ref_count] == in[i]);
+      CHECK(out_index[ref_count] == i);
+      ref_count++;
+    }
+  CHECK(count == ref_count);
+
+  std::vector<T> out_no_index(n);
+  CHECK(simd::copy_if_less(in.data(), n, limit, skip, out_no_index.data(), static_cast<int*>(nullptr)) == count);
+  for (int i = 0; i < count; i++)
+    CHECK(out_no_index[i] == out[i]);
+}
+
+TEST_CASE("copy_if_less", "[numerics]")
+{
+  for (int n : {0, 1, 7, 8, 16, 37})
+    for (int skip : {-1, 0, 3, 9, 20, 36})
+    {
+      test_copy_if_less<float>(n, skip);
+      test_copy_if_less<double>(n, skip);
+    }
+}
+
+} // namespace qmcplusplus
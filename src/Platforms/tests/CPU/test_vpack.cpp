@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <vector>
+#include "CPU/SIMD/vpack_math.hpp"
+#include "CPU/SIMD/vmath.hpp"
+
+namespace qmcplusplus
+{
+TEST_CASE("vpack masks and gathers", "[platform]")
+{
+  using P         = simd::vpack<double>;
+  constexpr int W = P::width;
+
+  double a[W], b[W], out[W];
+  int idx[W];
+  for (int i = 0; i < W; i++)
+  {
+    a[i]   = i;
+    b[i]   = W - i;
+    idx[i] = W - 1 - i;
+  }
+  const P pa = P::load(a);
+  const P pb = P::load(b);
+
+  const auto less = pa < pb;
+  CHECK(simd::any(less));
+  CHECK(!simd::all(less));
+  CHECK(simd::all(less | !less));
+  simd::select(less, pa, pb).store(out);
+  for (int i = 0; i < W; i++)
+    CHECK(out[i] == std::min(a[i], b[i]));
+
+  P::gather(a, idx).store(out);
+  for (int i = 0; i < W; i++)
+    CHECK(out[i] == a[W - 1 - i]);
+
+  // masked and partial stores leave the other entries
+  std::fill(out, out + W, -1.0);
+  pa.store(out, less);
+  for (int i = 0; i < W; i++)
+    CHECK(out[i] == (a[i] < b[i] ? a[i] : -1.0));
+  std::fill(out, out + W, -1.0);
+  P::load(a, 1, 7.0).store(out, 2);
+  CHECK(out[0] == a[0]);
+  CHECK(out[1] == 7.0);
+  if (W > 2)
+    CHECK(out[2] == -1.0);
+
+  CHECK(simd::reduce_add(simd::fma(pa, pb, P::broadcast(1.0))) == Approx(W * (W * W - 1) / 6.0 + W));
+}
+
+template<typename T>
+void test_vmath_kernels(T tol)
+{
+  // a length with a remainder for any vpack width
+  const int n = 1003;
+  std::vector<T> x(n), s(n), c(n), y(n);
+  std::vector<std::complex<T>> z(n);
+
+  for (int i = 0; i < n; i++)
+    x[i] = T(-60) + T(0.12) * i;
+  // beyond the reduced range
+  x[n - 1] = T(2.0e5);
+  simd::sincos(x.data(), s.data(), c.data(), n);
+  simd::cis(x.data(), z.data(), n);
+  for (int i = 0; i < n; i++)
+  {
+    CHECK(s[i] == Approx(std::sin(x[i])).margin(tol));
+    CHECK(c[i] == Approx(std::cos(x[i])).margin(tol));
+    CHECK(z[i].real() == Approx(c[i]));
+    CHECK(z[i].imag() == Approx(s[i]));
+  }
+
+  for (int i = 0; i < n; i++)
+    x[i] = T(-80) + T(0.16) * i;
+  simd::exp(x.data(), y.data(), n);
+  for (int i = 0; i < n; i++)
+    CHECK(y[i] == Approx(std::exp(x[i])).epsilon(tol));
+
+  for (int i = 0; i < n; i++)
+    x[i] = std::exp(T(-30) + T(0.06) * i);
+  x[0] = std::numeric_limits<T>::min();
+  simd::log(x.data(), y.data(), n);
+  for (int i = 0; i < n; i++)
+    CHECK(y[i] == Approx(std::log(x[i])).epsilon(tol).margin(tol));
+}
+
+TEST_CASE("vmath vpack kernels", "[platform]")
+{
+  test_vmath_kernels<double>(1e-14);
+  test_vmath_kernels<float>(2e-6f);
+
+  double x[2] = {0.0, 1.0}, y[2];
+  simd::log(x, y, 2);
+  CHECK(y[0] == -std::numeric_limits<double>::infinity());
+  CHECK(y[1] == 0.0);
+  x[0] = 1000.0;
+  x[1] = -1000.0;
+  simd::exp(x, y, 2);
+  CHECK(y[0] == std::numeric_limits<double>::infinity());
+  CHECK(y[1] == 0.0);
+}
+
+} // namespace qmcplusplus
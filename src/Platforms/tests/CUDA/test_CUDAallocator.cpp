@@ -16,6 +16,8 @@
 #include <iostream>
 #include "CUDA/CUDAruntime.hpp"
 #include "CUDA/CUDAallocator.hpp"
+#include "CUDA/CUDAevent.hpp"
+#include "DualAllocatorAliases.hpp"
 #include "OhmmsPETE/OhmmsVector.h"
 
 namespace qmcplusplus
@@ -67,4 +69,27 @@ TEST_CASE("CUDA_allocators", "[CUDA]")
   }
 }
 
+TEST_CASE("CUDA_async_transfers", "[CUDA]")
+{
+  cudaStream_t stream;
+  cudaErrorCheck(cudaStreamCreate(&stream), "cudaStreamCreate failed!");
+  {
+    Vector<double, PinnedDualAllocator<double>> vec(1024);
+    for (int i = 0; i < vec.size(); i++)
+      vec[i] = i;
+    vec.updateToAsync(stream);
+    CUDAEvent copied;
+    copied.record(stream);
+    copied.wait();
+    CHECK(copied.isDone());
+
+    std::fill(vec.begin(), vec.end(), -1.0);
+    vec.updateFromAsync(stream);
+    cudaErrorCheck(cudaStreamSynchronize(stream), "cudaStreamSynchronize failed!");
+    CHECK(vec[0] == 0.0);
+    CHECK(vec[1023] == 1023.0);
+  }
+  cudaErrorCheck(cudaStreamDestroy(stream), "cudaStreamDestroy failed!");
+}
+
 } // namespace qmcplusplus
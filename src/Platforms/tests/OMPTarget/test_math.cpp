@@ -16,6 +16,7 @@
 #include <vector>
 #include <iostream>
 #include "OMPTarget/OMPallocator.hpp"
+#include "OMPTarget/OMPTargetMath.hpp"
 
 namespace qmcplusplus
 {
@@ -46,4 +47,24 @@ TEST_CASE("OMPmath", "[OMP]")
   REQUIRE(A[1] == Approx(4.3943968404));
 }
 
+TEST_CASE("OMPmath kahanAdd", "[OMP]")
+{
+  using vec_t = std::vector<float, OMPallocator<float>>;
+  vec_t A(2);
+  A[0] = 1.0f;
+  A[1] = 0.0f;
+
+  // half an ulp of 1.0f is lost by plain summation, kept by the compensation.
+  auto* A_ptr = A.data();
+  PRAGMA_OFFLOAD("omp target map(always, tofrom:A_ptr[0:2])")
+  {
+    const float half_ulp = 0x1p-24f;
+    for (int i = 0; i < 4; i++)
+      omptarget::kahanAdd(A_ptr[0], A_ptr[1], half_ulp);
+  }
+
+  CHECK(A[0] == 1.0f + 0x1p-22f);
+  CHECK(A[1] == 0.0f);
+}
+
 } // namespace qmcplusplus
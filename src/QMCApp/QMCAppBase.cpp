@@ -14,6 +14,7 @@
 
 #include "Configuration.h"
 #include "QMCAppBase.h"
+#include "Utilities/StartupProfile.h"
 
 namespace qmcplusplus
 {
@@ -64,6 +65,7 @@ void QMCAppBase::popDocument()
 bool QMCAppBase::parse(const std::string& infile)
 {
   app_summary() << "  Input XML = " << infile << std::endl;
+  ScopedStartupPhase phase("QMCAppBase::ParseXML");
   return pushDocument(infile);
 }
 
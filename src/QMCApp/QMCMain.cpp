@@ -30,6 +30,8 @@
 #include "Platforms/Host/OutputManager.h"
 #include "Utilities/Timer.h"
 #include "Utilities/TimerManager.h"
+#include "Utilities/StartupProfile.h"
+#include "Utilities/MemoryAccountingReport.h"
 #include "Utilities/RunTimeManager.h"
 #include "Particle/HDFWalkerIO.h"
 #include "Particle/InitMolecularSystem.h"
@@ -211,6 +213,7 @@ bool QMCMain::execute()
 
   NewTimer* t3 = timer_manager.createTimer("Startup", timer_level_coarse);
   t3->start();
+  startup_profile.push("Startup");
 
   //validate the input file
   bool success = validateXML();
@@ -218,7 +221,10 @@ bool QMCMain::execute()
     myComm->barrier_and_abort("QMCMain::execute. Input document does not contain valid objects");
 
   //initialize all the instances of distance tables and evaluate them
-  ptclPool->reset();
+  {
+    ScopedStartupPhase phase("QMCMain::DistanceTables");
+    ptclPool->reset();
+  }
   infoSummary.flush();
   infoLog.flush();
   app_log() << "  Initialization Execution time = " << std::setprecision(4) << t0.elapsed() << " secs" << std::endl;
@@ -234,6 +240,7 @@ bool QMCMain::execute()
     app_log() << "  dryrun == 1 Ignore qmc/loop elements " << std::endl;
     APP_ABORT("QMCMain::execute");
   }
+  startup_profile.pop();
   t3->stop();
   Timer t1;
   curMethod              = std::string("invalid");
@@ -272,6 +279,9 @@ bool QMCMain::execute()
       xmlFreeNode(qmcactionPair.first);
 
   m_qmcaction.clear();
+  // no driver reached its first step
+  startup_profile.finish(myComm);
+  reportMemoryPeaks(myComm, app_summary());
   t2->stop();
   app_log() << "  Total Execution time = " << std::setprecision(4) << t1.elapsed() << " secs" << std::endl;
   if (is_manager())
@@ -441,14 +451,17 @@ bool QMCMain::validateXML()
     }
     else if (cname == "particleset")
     {
+      ScopedStartupPhase phase("QMCMain::ParticleSets");
       ptclPool->put(cur);
     }
     else if (cname == "wavefunction")
     {
+      ScopedStartupPhase phase("QMCMain::WaveFunctions");
       psiPool->put(cur);
     }
     else if (cname == "hamiltonian")
     {
+      ScopedStartupPhase phase("QMCMain::Hamiltonians");
       hamPool->put(cur);
     }
     else if (cname == "include")
@@ -539,16 +552,19 @@ bool QMCMain::processPWH(xmlNodePtr cur)
     else if (cname == "particleset")
     {
       inputnode = true;
+      ScopedStartupPhase phase("QMCMain::ParticleSets");
       ptclPool->put(cur);
     }
     else if (cname == "wavefunction")
     {
       inputnode = true;
+      ScopedStartupPhase phase("QMCMain::WaveFunctions");
       psiPool->put(cur);
     }
     else if (cname == "hamiltonian")
     {
       inputnode = true;
+      ScopedStartupPhase phase("QMCMain::Hamiltonians");
       hamPool->put(cur);
     }
     else
@@ -580,6 +596,7 @@ bool QMCMain::runQMC(xmlNodePtr cur, bool reuse)
     QMCDriverFactory driver_factory(myProject);
     QMCDriverFactory::DriverAssemblyState das = driver_factory.readSection(cur);
 
+    ScopedStartupPhase phase("QMCMain::CreateDriver");
     qmc_driver = driver_factory.createQMCDriver(cur, das, *qmcSystem, *ptclPool, *psiPool, *hamPool, myComm);
     append_run = das.append_run;
   }
@@ -607,11 +624,16 @@ bool QMCMain::runQMC(xmlNodePtr cur, bool reuse)
 #if !defined(REMOVE_TRACEMANAGER)
     qmc_driver->putTraces(traces_xml);
 #endif
-    qmc_driver->process(cur);
+    {
+      ScopedStartupPhase phase("QMCMain::ProcessDriver");
+      qmc_driver->process(cur);
+    }
     infoSummary.flush();
     infoLog.flush();
     Timer qmcTimer;
     qmc_driver->run();
+    // the batched drivers finish the startup profile before their first step, the legacy ones do not
+    startup_profile.finish(myComm);
     app_log() << "  QMC Execution time = " << std::setprecision(4) << qmcTimer.elapsed() << " secs" << std::endl;
     // transfer the states of a driver before its destruction
     last_branch_engine_legacy_driver = qmc_driver->getBranchEngine();
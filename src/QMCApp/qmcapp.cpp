@@ -16,8 +16,10 @@
 // File created by: Jeongnim Kim, jeongnim.kim@gmail.com, University of Illinois at Urbana-Champaign
 //////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <stdexcept>
 #include <memory>
+#include <fstream>
 #include "Configuration.h"
 #include "Message/Communicate.h"
 #include "Utilities/SimpleParser.h"
@@ -29,6 +31,12 @@
 #include "ProjectData.h"
 #include "QMCApp/QMCMain.h"
 #include "Utilities/qmc_common.h"
+#include "Utilities/StartupProfile.h"
+#include "Utilities/TimerTrace.h"
+#include "Utilities/TimerSampler.h"
+#include "Utilities/PerfCounters.h"
+#include "Utilities/DeviceProfile.h"
+#include "Message/CommProfile.h"
 
 void output_hardware_info(Communicate* comm, Libxml2Document& doc, xmlNodePtr root);
 
@@ -59,6 +67,9 @@ int main(int argc, char** argv)
     bool useGPU(false);
 #endif
     std::vector<std::string> fgroup1, fgroup2;
+    // write the startup profile as JSON, to <title>.startup.json without a file name
+    bool startup_json = false;
+    std::string startup_json_file;
     int i = 1;
     while (i < argc)
     {
@@ -88,6 +99,74 @@ int main(int argc, char** argv)
             timer_manager.set_timer_threshold(timer_level);
           }
         }
+        if (c.find("-startup-profile") < c.size())
+        {
+          startup_json = true;
+          int pos      = c.find("=");
+          if (pos != std::string::npos)
+            startup_json_file = c.substr(pos + 1);
+        }
+        if (c.find("-perf-counters") < c.size())
+        {
+#ifndef ENABLE_PERF_COUNTERS
+          std::cerr << "The '-perf-counters' command line option will have no effect. This executable was built "
+                       "without ENABLE_PERF_COUNTERS set."
+                    << std::endl;
+#else
+          if (!perf_counters.open())
+            std::cerr << "The hardware counters are not available, check /proc/sys/kernel/perf_event_paranoid."
+                      << std::endl;
+#endif
+        }
+        if (c.find("-device-timers") < c.size())
+        {
+#if !defined(ENABLE_TIMERS) || !defined(ENABLE_CUDA)
+          std::cerr << "The '-device-timers' command line option will have no effect. This executable was built "
+                       "without ENABLE_TIMERS or ENABLE_CUDA set."
+                    << std::endl;
+#endif
+          device_profile.enable(true);
+        }
+        if (c.find("-comm-profile") < c.size())
+          comm_profile.enable(true);
+        // record the timer events of blocks first:last, or of a single block
+        if (c.find("-timer-trace") < c.size())
+        {
+          int pos = c.find("=");
+          if (pos != std::string::npos)
+          {
+            std::string range = c.substr(pos + 1);
+            int sep           = range.find(":");
+            int first_block   = std::atoi(range.substr(0, sep).c_str());
+            int last_block    = sep != std::string::npos ? std::atoi(range.substr(sep + 1).c_str()) : first_block;
+            timer_trace.configure(first_block, last_block);
+          }
+          else
+            std::cerr << "The '-timer-trace' command line option needs a block range, e.g. --timer-trace=2:3"
+                      << std::endl;
+        }
+        // enable the timers of a level in one block of every period, e.g. fine:10
+        if (c.find("-timer-sampling") < c.size())
+        {
+#ifndef ENABLE_TIMERS
+          std::cerr << "The '-timer-sampling' command line option will have no effect. This executable was built "
+                       "without ENABLE_TIMERS set."
+                    << std::endl;
+#endif
+          const auto pos   = c.find("=");
+          const auto sep   = c.find(":", pos);
+          const auto level = pos != std::string::npos
+              ? std::find(timer_level_names.begin(), timer_level_names.end(), c.substr(pos + 1, sep - pos - 1))
+              : timer_level_names.end();
+          const int period = sep != std::string::npos ? std::atoi(c.substr(sep + 1).c_str()) : 0;
+          if (level != timer_level_names.end() && period > 0)
+            timer_sampler.configure(static_cast<timer_levels>(std::distance(timer_level_names.begin(), level)),
+                                    period);
+          else
+            std::cerr << "The '-timer-sampling' command line option needs a timer level and a block period, e.g. "
+                         "--timer-sampling=fine:10"
+                      << std::endl;
+        }
         if (c.find("-verbosity") < c.size())
         {
           int pos = c.find("=");
@@ -230,11 +309,33 @@ int main(int argc, char** argv)
     timingDoc.newDoc("resources");
     output_hardware_info(qmcComm, timingDoc, timingDoc.getRoot());
     timer_manager.output_timing(qmcComm, timingDoc, timingDoc.getRoot());
+    timer_sampler.output(timingDoc, timingDoc.getRoot());
     qmc->ptclPool->output_particleset_info(timingDoc, timingDoc.getRoot());
     if (OHMMS::Controller->rank() == 0)
     {
       timingDoc.dump(qmc->getTitle() + ".info.xml");
+      if (startup_json)
+      {
+        if (startup_json_file.empty())
+          startup_json_file = qmc->getTitle() + ".startup.json";
+        if (!startup_profile.writeJSON(startup_json_file))
+          app_warning() << "Cannot write the startup profile to " << startup_json_file << std::endl;
+      }
+    }
+    if (timer_trace.isConfigured())
+    {
+      const std::string trace_file = qmc->getTitle() + ".trace.r" + std::to_string(OHMMS::Controller->rank()) + ".json";
+      std::ofstream trace_out(trace_file);
+      if (trace_out)
+        timer_trace.writeJSON(trace_out, OHMMS::Controller->rank(),
+                              [](timer_id_t id) { return timer_manager.get_timer_name(id); });
+      else
+        app_warning() << "Cannot write the timer trace to " << trace_file << std::endl;
     }
+    if (OHMMS::Controller->rank() == 0)
+      timer_sampler.report(app_summary());
+    if (comm_profile.isEnabled())
+      comm_profile.report(*OHMMS::Controller, app_summary());
     timer_manager.print(qmcComm);
 
     qmc.reset();
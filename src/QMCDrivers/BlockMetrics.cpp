@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file BlockMetrics.cpp
+ * @brief Implements BlockMetrics
+ */
+#include "BlockMetrics.h"
+#include <algorithm>
+#include "Utilities/DeviceProfile.h"
+
+namespace qmcplusplus
+{
+template<class CLOCK>
+void BlockMetrics<CLOCK>::addCategory(const std::string& name, const std::vector<std::reference_wrapper<TIMER>>& timers)
+{
+  categories_.push_back({name, timers});
+}
+
+template<class CLOCK>
+double BlockMetrics<CLOCK>::getTime(const Category& category)
+{
+  double time = 0.0;
+  for (const TIMER& timer : category.timers)
+    for (const auto& profile : timer.get_per_thread_profiles())
+      time += profile.total_time;
+  return time;
+}
+
+template<class CLOCK>
+size_t BlockMetrics<CLOCK>::getDeviceBytes()
+{
+  size_t bytes = 0;
+  if (device_profile.isEnabled())
+    for (const auto& [id, stats] : device_profile.getStats())
+      bytes += stats.transfer_bytes;
+  return bytes;
+}
+
+template<class CLOCK>
+void BlockMetrics<CLOCK>::startBlock()
+{
+  block_count_++;
+  for (auto& category : categories_)
+    category.time_at_start = getTime(category);
+  bytes_at_start_ = getDeviceBytes();
+  if (comm_profile.isEnabled())
+    comm_at_start_ = comm_profile.getTotal();
+  block_start_    = CLOCK()();
+}
+
+template<class CLOCK>
+typename BlockMetrics<CLOCK>::Record BlockMetrics<CLOCK>::stopBlock(double walker_moves,
+                                                                    double electron_moves,
+                                                                    double accepted,
+                                                                    double energy_evaluations)
+{
+  Record record;
+  record.block              = block_count_ - 1;
+  record.wall_time          = CLOCK()() - block_start_;
+  record.walker_moves       = walker_moves;
+  record.electron_moves     = electron_moves;
+  record.accepted           = accepted;
+  record.energy_evaluations = energy_evaluations;
+  for (const auto& category : categories_)
+    record.category_times.push_back(getTime(category) - category.time_at_start);
+  record.device_bytes = getDeviceBytes() - bytes_at_start_;
+  if (comm_profile.isEnabled())
+  {
+    const CommSiteStats comm_total = comm_profile.getTotal();
+    record.comm_time               = comm_total.time - comm_at_start_.time;
+    record.comm_calls              = comm_total.count - comm_at_start_.count;
+    record.comm_bytes              = comm_total.bytes - comm_at_start_.bytes;
+  }
+  return record;
+}
+
+template<class CLOCK>
+void BlockMetrics<CLOCK>::writeJSON(std::ostream& os, const std::string& driver, const Record& record) const
+{
+  const double rate = record.wall_time > 0.0 ? 1.0 / record.wall_time : 0.0;
+  os << "{\"driver\":\"" << driver << "\",\"block\":" << record.block << ",\"wall_time\":" << record.wall_time
+     << ",\"walker_moves_per_s\":" << record.walker_moves * rate
+     << ",\"electron_moves_per_s\":" << record.electron_moves * rate
+     << ",\"local_energies_per_s\":" << record.energy_evaluations * rate << ",\"acceptance\":"
+     << (record.electron_moves > 0.0 ? record.accepted / record.electron_moves : 0.0) << ",\"time\":{";
+  for (int i = 0; i < categories_.size(); i++)
+    os << (i > 0 ? "," : "") << "\"" << categories_[i].name << "\":" << record.category_times[i];
+  os << "}";
+  if (device_profile.isEnabled())
+    os << ",\"device_bytes\":" << record.device_bytes;
+  if (comm_profile.isEnabled())
+  {
+    os << ",\"comm_time\":" << record.comm_time << ",\"comm_calls\":" << record.comm_calls
+       << ",\"comm_bytes\":" << record.comm_bytes;
+    if (!record.rank_comm_times.empty())
+    {
+      std::vector<double> times(record.rank_comm_times);
+      std::sort(times.begin(), times.end());
+      os << ",\"comm_time_ranks\":{\"min\":" << times.front()
+         << ",\"median\":" << CommProfile::percentile(times, 0.5)
+         << ",\"p90\":" << CommProfile::percentile(times, 0.9) << ",\"max\":" << times.back() << "}";
+    }
+  }
+  os << "}" << std::endl;
+}
+
+template class BlockMetrics<CPUClock>;
+template class BlockMetrics<FakeCPUClock>;
+
+} // namespace qmcplusplus
@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file BlockMetrics.h
+ * @brief throughput and time split of the blocks of a batched driver
+ */
+#ifndef QMCPLUSPLUS_BLOCK_METRICS_H
+#define QMCPLUSPLUS_BLOCK_METRICS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Utilities/TimerManager.h"
+#include "Message/CommProfile.h"
+
+namespace qmcplusplus
+{
+/** measures the blocks of a driver for performance tracking
+ *
+ * The time of each category, e.g. the wave function or the Hamiltonian, is the time of its timers
+ * summed over the threads of the outermost parallel level, one per crowd, during the block.
+ * The counts are given by the driver, summed over the ranks, and the rates are per second of the block wall time.
+ * The device transfer bytes are those of device_profile, only counted with --device-timers.
+ * The MPI time, calls and bytes are those of comm_profile on this rank, only counted with --comm-profile.
+ * The driver may fill in the MPI time of every rank to report its spread.
+ */
+template<class CLOCK = CPUClock>
+class BlockMetrics
+{
+public:
+  using TIMER = TimerType<CLOCK>;
+
+  struct Record
+  {
+    int block                 = 0;
+    double wall_time          = 0.0;
+    double walker_moves       = 0.0;
+    double electron_moves     = 0.0;
+    double accepted           = 0.0;
+    double energy_evaluations = 0.0;
+    /// time of each category in the order they were added
+    std::vector<double> category_times;
+    size_t device_bytes = 0;
+    double comm_time    = 0.0;
+    long comm_calls     = 0;
+    size_t comm_bytes   = 0;
+    /// MPI time of the block on each rank, if gathered by the driver
+    std::vector<double> rank_comm_times;
+  };
+
+  /// add a category of the time split, the timers must outlive this object
+  void addCategory(const std::string& name, const std::vector<std::reference_wrapper<TIMER>>& timers);
+
+  /// start measuring a block, reads the wall clock and the category timers
+  void startBlock();
+
+  /** finish the block started last
+   * @param walker_moves walkers moved times the steps and the substeps of the block
+   * @param electron_moves proposed single electron moves
+   * @param accepted accepted single electron moves
+   * @param energy_evaluations local energies evaluated
+   */
+  Record stopBlock(double walker_moves, double electron_moves, double accepted, double energy_evaluations);
+
+  /// write a record as a JSON line
+  void writeJSON(std::ostream& os, const std::string& driver, const Record& record) const;
+
+private:
+  struct Category
+  {
+    std::string name;
+    std::vector<std::reference_wrapper<TIMER>> timers;
+    double time_at_start = 0.0;
+  };
+  std::vector<Category> categories_;
+  /// blocks started
+  int block_count_       = 0;
+  double block_start_    = 0.0;
+  size_t bytes_at_start_ = 0;
+  CommSiteStats comm_at_start_;
+
+  /// time of a category so far
+  static double getTime(const Category& category);
+  /// device transfer bytes so far
+  static size_t getDeviceBytes();
+};
+
+extern template class BlockMetrics<CPUClock>;
+extern template class BlockMetrics<FakeCPUClock>;
+
+} // namespace qmcplusplus
+#endif
@@ -32,4 +32,24 @@ ContextForSteps::ContextForSteps(int num_walkers,
   walker_deltas_.resize(num_walkers * num_particles);
 }
 
+int ContextForSteps::acceptMoves(int iat, const std::vector<RealType>& prob, std::vector<bool>& is_accepted) const
+{
+  const int num_walkers = prob.size();
+  assert(accept_uniforms_.size() >= (iat + 1) * num_walkers);
+  const FullPrecRealType* restrict uniforms = accept_uniforms_.data() + iat * num_walkers;
+  const RealType* restrict probs            = prob.data();
+  // std::vector<bool> cannot be written in a simd loop
+  std::vector<char> accepted(num_walkers);
+  char* restrict accepted_ptr = accepted.data();
+  int num_accepted            = 0;
+#pragma omp simd reduction(+ : num_accepted)
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    accepted_ptr[iw] = uniforms[iw] < probs[iw];
+    num_accepted += accepted_ptr[iw];
+  }
+  is_accepted.assign(accepted.begin(), accepted.end());
+  return num_accepted;
+}
+
 } // namespace qmcplusplus
@@ -37,6 +37,7 @@ public:
   using PosType           = QMCTraits::PosType;
   using MCPWalker         = Walker<QMCTraits, PtclOnLatticeTraits>;
   using RealType          = QMCTraits::RealType;
+  using FullPrecRealType  = QMCTraits::FullPrecRealType;
 
   ContextForSteps(int num_walkers,
                   int num_particles,
@@ -56,11 +57,43 @@ public:
   std::vector<PosType>& get_walker_deltas() { return walker_deltas_; }
   auto deltaRsBegin() { return walker_deltas_.begin(); };
 
+  /// spin displacements of an entire step for spinor particle sets, ordered like the deltas
+  void nextDeltaSpins(size_t num_rs)
+  {
+    walker_spin_deltas_.resize(num_rs);
+    makeGaussRandomWithEngine(walker_spin_deltas_, random_gen_);
+  }
+
+  const std::vector<ParticleSet::Scalar_t>& get_walker_spin_deltas() const { return walker_spin_deltas_; }
+
+  /** draw the acceptance uniforms of an entire step in one batch
+   *
+   *  one number per walker and particle, ordered like the deltas. Unlike drawing a number
+   *  for each move that passes the cheap rejection tests, the random sequence does not depend
+   *  on the ratios, so all the numbers can be generated ahead of the moves.
+   */
+  void nextAcceptUniforms(size_t num_rs)
+  {
+    accept_uniforms_.resize(num_rs);
+    fillUniformRandWithEngine(accept_uniforms_.data(), num_rs, random_gen_);
+  }
+
+  /** accept or reject the proposed moves of particle iat with the batched uniforms
+   *  @param iat particle index
+   *  @param prob acceptance probabilities of the walkers, 0 for the moves rejected upfront
+   *  @param is_accepted accept flags of the walkers
+   *  @return number of accepted moves
+   */
+  int acceptMoves(int iat, const std::vector<RealType>& prob, std::vector<bool>& is_accepted) const;
+
   int getPtclGroupStart(int group) const { return particle_group_indexes_[group].first; }
   int getPtclGroupEnd(int group) const { return particle_group_indexes_[group].second; }
 
 protected:
   std::vector<PosType> walker_deltas_;
+  std::vector<ParticleSet::Scalar_t> walker_spin_deltas_;
+  /// uniforms of the batched acceptance, fastest in walkers then particles
+  std::vector<FullPrecRealType> accept_uniforms_;
 
   /** indexes of start and stop of each particle group;
    *
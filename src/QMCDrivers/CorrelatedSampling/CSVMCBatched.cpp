@@ -0,0 +1,469 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "CSVMCBatched.h"
+#include <iomanip>
+#include <numeric>
+#include "Concurrency/ParallelExecutor.hpp"
+#include "Message/UniformCommunicateError.h"
+#include "Message/CommOperators.h"
+#include "Utilities/RunTimeManager.h"
+#include "Utilities/StartupProfile.h"
+#include "MemoryUsage.h"
+#include "Utilities/TimerTrace.h"
+
+namespace qmcplusplus
+{
+CSVMCBatched::CSVMCBatched(const ProjectData& project_data,
+                           QMCDriverInput&& qmcdriver_input,
+                           MCPopulation&& pop,
+                           Communicate* comm)
+    : QMCDriverNew(project_data, std::move(qmcdriver_input), std::move(pop), "CSVMCBatched::", comm, "CSVMCBatched")
+{}
+
+void CSVMCBatched::add_H_and_Psi(QMCHamiltonian* h, TrialWaveFunction* psi)
+{
+  if (!h_pool_.empty() && h != h_pool_.front())
+    h->setPrimary(false);
+  h_pool_.push_back(h);
+  psi_pool_.push_back(psi);
+}
+
+void CSVMCBatched::process(xmlNodePtr node)
+{
+  print_mem("CSVMCBatched before initialization", app_log());
+  try
+  {
+    if (psi_pool_.size() < 2)
+      throw UniformCommunicateError("CSVMCBatched needs at least two qmcsystem elements, one per correlated pair.");
+
+    QMCDriverNew::AdjustedWalkerCounts awc =
+        adjustGlobalWalkerCount(myComm->size(), myComm->rank(), qmcdriver_input_.get_total_walkers(),
+                                qmcdriver_input_.get_walkers_per_rank(), 1.0, qmcdriver_input_.get_num_crowds(),
+                                getMultiWalkerMemoryPerWalker(),
+                                static_cast<size_t>(qmcdriver_input_.get_walker_memory_budget()) << 20);
+
+    Base::startup(node, awc);
+  }
+  catch (const UniformCommunicateError& ue)
+  {
+    myComm->barrier_and_abort(ue.what());
+  }
+
+  avg_norm_.assign(psi_pool_.size(), 1.0);
+  createCorrelatedSets();
+}
+
+void CSVMCBatched::createCorrelatedSets()
+{
+  const int num_psi = psi_pool_.size();
+  golden_cs_resources_.clear();
+  for (int ipsi = 1; ipsi < num_psi; ++ipsi)
+  {
+    auto res = std::make_unique<DriverWalkerResourceCollection>();
+    if (dispatchers_.are_walkers_batched())
+    {
+      psi_pool_[ipsi]->createResource(res->twf_res);
+      h_pool_[ipsi]->createResource(res->ham_res);
+    }
+    golden_cs_resources_.push_back(std::move(res));
+  }
+
+  crowd_cs_.clear();
+  crowd_cs_.resize(crowds_.size());
+  for (int crowd_id = 0; crowd_id < crowds_.size(); ++crowd_id)
+  {
+    Crowd& crowd            = *crowds_[crowd_id];
+    CrowdCorrelatedSet& cs = crowd_cs_[crowd_id];
+    cs.twfs.resize(num_psi);
+    cs.hams.resize(num_psi);
+    cs.twfs[0] = crowd.get_walker_twfs();
+    cs.hams[0] = crowd.get_walker_hamiltonians();
+    cs.resources.push_back(crowd.getSharedResource());
+    for (int ipsi = 1; ipsi < num_psi; ++ipsi)
+    {
+      for (ParticleSet& elecs : crowd.get_walker_elecs())
+      {
+        cs.twf_clones.push_back(psi_pool_[ipsi]->makeClone(elecs));
+        cs.ham_clones.push_back(h_pool_[ipsi]->makeClone(elecs, *cs.twf_clones.back()));
+        cs.twfs[ipsi].push_back(*cs.twf_clones.back());
+        cs.hams[ipsi].push_back(*cs.ham_clones.back());
+      }
+      cs.resource_clones.push_back(std::make_unique<DriverWalkerResourceCollection>(*golden_cs_resources_[ipsi - 1]));
+      cs.resources.push_back(*cs.resource_clones.back());
+    }
+    cs.accumulator.resize(num_psi);
+  }
+}
+
+void CSVMCBatched::computeUmbrellaWeights(const std::vector<FullPrecRealType>& log_psi,
+                                          const std::vector<FullPrecRealType>& avg_norm,
+                                          std::vector<FullPrecRealType>& weights)
+{
+  const int num_psi = log_psi.size();
+  weights.resize(num_psi);
+  // shift by the largest exponent, |Psi_i|^2 alone easily overflows
+  for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    weights[ipsi] = 2 * log_psi[ipsi] - std::log(avg_norm[ipsi]);
+  const FullPrecRealType shift = *std::max_element(weights.begin(), weights.end());
+  FullPrecRealType sum         = 0;
+  for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+  {
+    weights[ipsi] = std::exp(weights[ipsi] - shift);
+    sum += weights[ipsi];
+  }
+  for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    weights[ipsi] /= sum;
+}
+
+void CSVMCBatched::initCorrelatedWalkers(const StateForThread& sft, Crowd& crowd, CrowdCorrelatedSet& cs)
+{
+  if (crowd.size() == 0)
+    return;
+  auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
+  const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
+  ResourceCollectionTeamLock<ParticleSet> pset_res_lock(crowd.getSharedResource().pset_res, walker_elecs);
+  // the primary pair was evaluated by initialLogEvaluation
+  for (int ipsi = 1; ipsi < cs.twfs.size(); ++ipsi)
+  {
+    const RefVectorWithLeader<TrialWaveFunction> walker_twfs(cs.twfs[ipsi][0], cs.twfs[ipsi]);
+    ResourceCollectionTeamLock<TrialWaveFunction> twfs_res_lock(cs.resources[ipsi].get().twf_res, walker_twfs);
+    twf_dispatcher.flex_evaluateLog(walker_twfs, walker_elecs);
+  }
+}
+
+void CSVMCBatched::advanceWalkers(const StateForThread& sft,
+                                  Crowd& crowd,
+                                  CrowdCorrelatedSet& cs,
+                                  DriverTimers& timers,
+                                  ContextForSteps& step_context,
+                                  bool recompute,
+                                  bool accumulate_this_step)
+{
+  if (crowd.size() == 0)
+    return;
+  auto& ps_dispatcher  = crowd.dispatchers_.ps_dispatcher_;
+  auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
+  auto& ham_dispatcher = crowd.dispatchers_.ham_dispatcher_;
+  auto& walkers        = crowd.get_walkers();
+  const int num_walkers = crowd.size();
+  const int num_psi     = cs.twfs.size();
+
+  const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
+  std::vector<RefVectorWithLeader<TrialWaveFunction>> walker_twfs;
+  walker_twfs.reserve(num_psi);
+  for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    walker_twfs.emplace_back(cs.twfs[ipsi][0], cs.twfs[ipsi]);
+
+  // every wavefunction of the crowd holds its resource during the moves
+  timers.resource_timer.start();
+  ResourceCollectionTeamLock<ParticleSet> pset_res_lock(crowd.getSharedResource().pset_res, walker_elecs);
+  std::vector<std::unique_ptr<ResourceCollectionTeamLock<TrialWaveFunction>>> twfs_res_locks;
+  for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    twfs_res_locks.push_back(
+        std::make_unique<ResourceCollectionTeamLock<TrialWaveFunction>>(cs.resources[ipsi].get().twf_res,
+                                                                        walker_twfs[ipsi]));
+  timers.resource_timer.stop();
+
+  timers.movepbyp_timer.start();
+  // umbrella weights of the current configuration of each walker
+  std::vector<std::vector<FullPrecRealType>> weights(num_walkers);
+  std::vector<FullPrecRealType> log_psi(num_psi);
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+      log_psi[ipsi] = cs.twfs[ipsi][iw].get().getLogPsi();
+    computeUmbrellaWeights(log_psi, sft.avg_norm, weights[iw]);
+  }
+
+  std::vector<std::vector<TrialWaveFunction::PsiValueType>> ratios(num_psi,
+                                                                   std::vector<TrialWaveFunction::PsiValueType>(
+                                                                       num_walkers));
+  std::vector<PosType> drifts(num_walkers);
+  std::vector<bool> isAccepted;
+  isAccepted.reserve(num_walkers);
+
+  for (int sub_step = 0; sub_step < sft.qmcdrv_input.get_sub_steps(); sub_step++)
+  {
+    //This generates an entire steps worth of deltas.
+    step_context.nextDeltaRs(num_walkers * sft.population.get_num_particles());
+
+    for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+    {
+      const RealType sqrttau = std::sqrt(sft.qmcdrv_input.get_tau() * sft.population.get_ptclgrp_inv_mass()[ig]);
+
+      for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+        twf_dispatcher.flex_prepareGroup(walker_twfs[ipsi], walker_elecs, ig);
+
+      for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+      {
+        // fastest in walkers then particles
+        auto delta_r_start = step_context.deltaRsBegin() + iat * num_walkers;
+        std::transform(delta_r_start, delta_r_start + num_walkers, drifts.begin(),
+                       [sqrttau](const PosType& delta_r) { return sqrttau * delta_r; });
+
+        ps_dispatcher.flex_makeMove(walker_elecs, iat, drifts);
+
+        for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+          twf_dispatcher.flex_calcRatio(walker_twfs[ipsi], walker_elecs, iat, ratios[ipsi]);
+
+        isAccepted.clear();
+        for (int iw = 0; iw < num_walkers; ++iw)
+        {
+          // ratio of the sampled density, \sum_i w_i |Psi_i(R')/Psi_i(R)|^2
+          FullPrecRealType prob = 0;
+          for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+            prob += weights[iw][ipsi] * std::norm(ratios[ipsi][iw]);
+
+          if (prob >= std::numeric_limits<RealType>::epsilon() && step_context.get_random_gen()() < prob)
+          {
+            crowd.incAccept();
+            isAccepted.push_back(true);
+            for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+              weights[iw][ipsi] *= std::norm(ratios[ipsi][iw]) / prob;
+          }
+          else
+          {
+            crowd.incReject();
+            isAccepted.push_back(false);
+          }
+        }
+
+        for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+          twf_dispatcher.flex_accept_rejectMove(walker_twfs[ipsi], walker_elecs, iat, isAccepted, true);
+
+        ps_dispatcher.flex_accept_rejectMove(walker_elecs, iat, isAccepted);
+      }
+    }
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+      twf_dispatcher.flex_completeUpdates(walker_twfs[ipsi]);
+  }
+
+  ps_dispatcher.flex_donePbyP(walker_elecs);
+  timers.movepbyp_timer.stop();
+
+  // the primary pair goes last so that the particle sets are left with its gradients and laplacians
+  std::vector<std::vector<QMCHamiltonian::FullPrecRealType>> local_energies(num_psi);
+  for (int ipsi = num_psi - 1; ipsi >= 0; --ipsi)
+  {
+    timers.buffer_timer.start();
+    twf_dispatcher.flex_evaluateGL(walker_twfs[ipsi], walker_elecs, recompute);
+    timers.buffer_timer.stop();
+
+    ScopedTimer local_timer(timers.hamiltonian_timer);
+    const RefVectorWithLeader<QMCHamiltonian> walker_hamiltonians(cs.hams[ipsi][0], cs.hams[ipsi]);
+    ResourceCollectionTeamLock<QMCHamiltonian> hams_res_lock(cs.resources[ipsi].get().ham_res, walker_hamiltonians);
+    local_energies[ipsi] = ham_dispatcher.flex_evaluate(walker_hamiltonians, walker_twfs[ipsi], walker_elecs);
+  }
+
+  timers.collectables_timer.start();
+  CSAccumulator& acc = cs.accumulator;
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    // start again from the logs, the weights updated move by move accumulate round-off
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+      log_psi[ipsi] = cs.twfs[ipsi][iw].get().getLogPsi();
+    computeUmbrellaWeights(log_psi, sft.avg_norm, weights[iw]);
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    {
+      acc.weight[ipsi] += weights[iw][ipsi];
+      acc.weighted_energy[ipsi] += weights[iw][ipsi] * local_energies[ipsi][iw];
+    }
+    acc.num_samples += 1;
+
+    MCPWalker& walker       = walkers[iw];
+    TrialWaveFunction& twf  = cs.twfs[0][iw];
+    QMCHamiltonian& ham     = cs.hams[0][iw];
+    walker.resetProperty(twf.getLogPsi(), twf.getPhase(), local_energies[0][iw]);
+    ham.auxHevaluate(walker_elecs[iw], walker);
+    ham.saveProperty(walker.getPropertyBase());
+    // the regular estimators see the primary wavefunction reweighted from the sampled density
+    walker.Weight = weights[iw][0];
+  }
+  timers.collectables_timer.stop();
+
+  if (accumulate_this_step)
+  {
+    ScopedTimer est_timer(timers.estimators_timer);
+    crowd.accumulate(step_context.get_random_gen());
+  }
+}
+
+std::vector<CSVMCBatched::FullPrecRealType> CSVMCBatched::reduceAccumulators()
+{
+  const int num_psi = psi_pool_.size();
+  std::vector<FullPrecRealType> sums(2 * num_psi + 1, 0);
+  for (CrowdCorrelatedSet& cs : crowd_cs_)
+  {
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    {
+      sums[ipsi] += cs.accumulator.weight[ipsi];
+      sums[num_psi + ipsi] += cs.accumulator.weighted_energy[ipsi];
+    }
+    sums[2 * num_psi] += cs.accumulator.num_samples;
+    cs.accumulator.reset();
+  }
+  myComm->allreduce(sums);
+  return sums;
+}
+
+void CSVMCBatched::writeCSdat(int block, const std::vector<FullPrecRealType>& sums)
+{
+  if (!cs_stream_)
+    return;
+  const int num_psi                   = psi_pool_.size();
+  const FullPrecRealType num_samples = sums[2 * num_psi];
+  std::vector<FullPrecRealType> energies(num_psi);
+  for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    energies[ipsi] = sums[num_psi + ipsi] / sums[ipsi];
+
+  std::ostream& os = *cs_stream_;
+  os << std::setw(10) << block;
+  for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    os << std::setw(20) << energies[ipsi] << std::setw(20) << sums[ipsi] / num_samples;
+  for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+    for (int jpsi = ipsi + 1; jpsi < num_psi; ++jpsi)
+      os << std::setw(20) << energies[ipsi] - energies[jpsi];
+  os << std::endl;
+}
+
+/** Runs the CSVMC section
+ *
+ *  The warmup sets the normalization of each wavefunction from its average umbrella weight,
+ *  as CSUpdateBase::updateNorms does.
+ */
+bool CSVMCBatched::run()
+{
+  IndexType num_blocks = qmcdriver_input_.get_max_blocks();
+  const int num_psi    = psi_pool_.size();
+  estimator_manager_->startDriverRun();
+
+  StateForThread cs_state(qmcdriver_input_, population_, avg_norm_);
+
+  LoopTimer<> cs_loop;
+  RunTimeControl<> runtimeControl(run_time_manager, project_data_.getMaxCPUSeconds(), project_data_.getTitle(),
+                                  myComm->rank() == 0);
+
+  if (myComm->rank() == 0)
+  {
+    cs_stream_ = std::make_unique<std::ofstream>(project_data_.CurrentMainRoot() + ".cs.dat");
+    cs_stream_->setf(std::ios::scientific, std::ios::floatfield);
+    cs_stream_->precision(10);
+    std::ostream& os = *cs_stream_;
+    os << "# Index ";
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+      os << std::setw(20) << "LocEne_" + std::to_string(ipsi) << std::setw(20) << "wpsi_" + std::to_string(ipsi);
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+      for (int jpsi = ipsi + 1; jpsi < num_psi; ++jpsi)
+        os << std::setw(20) << "dLocEne_" + std::to_string(ipsi) + "_" + std::to_string(jpsi);
+    os << std::endl;
+  }
+
+  { // walker initialization
+    ScopedTimer local_timer(timers_.init_walkers_timer);
+    startup_profile.push("InitialLogEvaluation");
+    ParallelExecutor<> section_start_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
+    section_start_task(crowds_.size(), initialLogEvaluation, std::ref(crowds_), std::ref(step_contexts_));
+
+    auto initTask = [](int crowd_id, const StateForThread& sft, UPtrVector<Crowd>& crowds,
+                       std::vector<CrowdCorrelatedSet>& crowd_cs) {
+      initCorrelatedWalkers(sft, *crowds[crowd_id], crowd_cs[crowd_id]);
+    };
+    section_start_task(crowds_.size(), initTask, cs_state, std::ref(crowds_), std::ref(crowd_cs_));
+    startup_profile.pop();
+  }
+
+  // the first step follows
+  startup_profile.finish(myComm);
+  print_mem("CSVMCBatched after initialLogEvaluation", app_summary());
+
+  ParallelExecutor<> crowd_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
+  auto runCSVMCStep = [](int crowd_id, const StateForThread& sft, DriverTimers& timers,
+                         UPtrVector<ContextForSteps>& context_for_steps, UPtrVector<Crowd>& crowds,
+                         std::vector<CrowdCorrelatedSet>& crowd_cs, bool recompute, bool accumulate_this_step) {
+    Crowd& crowd = *crowds[crowd_id];
+    crowd.setRNGForHamiltonian(context_for_steps[crowd_id]->get_random_gen());
+    advanceWalkers(sft, crowd, crowd_cs[crowd_id], timers, *context_for_steps[crowd_id], recompute,
+                   accumulate_this_step);
+  };
+
+  if (qmcdriver_input_.get_warmup_steps() > 0)
+  {
+    for (int step = 0; step < qmcdriver_input_.get_warmup_steps(); ++step)
+    {
+      ScopedTimer local_timer(timers_.run_steps_timer);
+      crowd_task(crowds_.size(), runCSVMCStep, cs_state, std::ref(timers_), std::ref(step_contexts_),
+                 std::ref(crowds_), std::ref(crowd_cs_), false, false);
+    }
+
+    // N_i is proportional to the average umbrella weight of Psi_i under the current normalization
+    const std::vector<FullPrecRealType> sums = reduceAccumulators();
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+      avg_norm_[ipsi] *= sums[ipsi] / sums[2 * num_psi];
+    const FullPrecRealType norm_sum = std::accumulate(avg_norm_.begin(), avg_norm_.end(), FullPrecRealType(0));
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+      avg_norm_[ipsi] /= norm_sum;
+    app_log() << "Warm-up is completed!" << std::endl;
+    app_log() << "  Umbrella sampling normalization:";
+    for (int ipsi = 0; ipsi < num_psi; ++ipsi)
+      app_log() << " " << avg_norm_[ipsi];
+    app_log() << std::endl;
+    print_mem("CSVMCBatched after Warmup", app_log());
+  }
+
+  for (int block = 0; block < num_blocks; ++block)
+  {
+    timer_trace.startBlock();
+    cs_loop.start();
+    const bool is_recomputing_block = qmcdriver_input_.get_blocks_between_recompute()
+        ? (1 + block) % qmcdriver_input_.get_blocks_between_recompute() == 0
+        : false;
+
+    estimator_manager_->startBlock(qmcdriver_input_.get_max_steps());
+
+    for (auto& crowd : crowds_)
+      crowd->startBlock(qmcdriver_input_.get_max_steps());
+    for (int step = 0; step < qmcdriver_input_.get_max_steps(); ++step)
+    {
+      ScopedTimer local_timer(timers_.run_steps_timer);
+      const bool recompute_this_step = is_recomputing_block && (step + 1) == qmcdriver_input_.get_max_steps();
+      crowd_task(crowds_.size(), runCSVMCStep, cs_state, std::ref(timers_), std::ref(step_contexts_),
+                 std::ref(crowds_), std::ref(crowd_cs_), recompute_this_step, true);
+    }
+    print_mem("CSVMCBatched after a block", app_debug_stream());
+    endBlock(qmcdriver_input_.get_max_steps());
+    writeCSdat(block, reduceAccumulators());
+    cs_loop.stop();
+
+    bool stop_requested = false;
+    // Rank 0 decides whether the time limit was reached
+    if (!myComm->rank())
+      stop_requested = runtimeControl.checkStop(cs_loop);
+    myComm->bcast(stop_requested);
+
+    if (stop_requested)
+    {
+      if (!myComm->rank())
+        app_log() << runtimeControl.generateStopMessage("CSVMCBatched", block);
+      run_time_manager.markStop();
+      break;
+    }
+  }
+
+  cs_stream_.reset();
+  print_mem("CSVMCBatched ends", app_log());
+
+  estimator_manager_->stopDriverRun();
+
+  return finalize(num_blocks, true);
+}
+
+} // namespace qmcplusplus
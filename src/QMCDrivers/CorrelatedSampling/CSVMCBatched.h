@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/**@file CSVMCBatched.h
+ * @brief Definition of CSVMCBatched
+ */
+#ifndef QMCPLUSPLUS_CSVMCBATCHED_H
+#define QMCPLUSPLUS_CSVMCBATCHED_H
+
+#include <fstream>
+#include "QMCDrivers/QMCDriverNew.h"
+#include "QMCDrivers/MCPopulation.h"
+#include "QMCDrivers/ContextForSteps.h"
+#include "QMCDrivers/DriverWalkerTypes.h"
+
+namespace qmcplusplus
+{
+/** @ingroup QMCDrivers ParticleByParticle MultiplePsi
+ * @brief Implements the VMC algorithm using umbrella sampling with batched particle-by-particle moves.
+ *
+ * Energy difference method with multiple H/Psi, the batched counterpart of CSVMC with CSVMCUpdatePbyP.
+ * The walkers sample \f$\sum_i |\Psi_i|^2/N_i\f$. Every walker carries its own copy of each
+ * TrialWaveFunction/QMCHamiltonian pair, the pairs of a crowd are evaluated together with the multi walker APIs.
+ * The umbrella weights and the weighted local energies of each pair are summed in crowd-local accumulators
+ * and reduced at the end of every block into the \<project\>.cs.dat file.
+ * Moves are made without drift, as in CSVMCUpdatePbyP.
+ */
+class CSVMCBatched : public QMCDriverNew
+{
+public:
+  using Base              = QMCDriverNew;
+  using FullPrecRealType  = QMCTraits::FullPrecRealType;
+  using PosType           = QMCTraits::PosType;
+  using ParticlePositions = PtclOnLatticeTraits::ParticlePos;
+
+  /// crowd-local sums over the samples of each wavefunction
+  struct CSAccumulator
+  {
+    /// sum of the umbrella weights
+    std::vector<FullPrecRealType> weight;
+    /// sum of the umbrella weighted local energies
+    std::vector<FullPrecRealType> weighted_energy;
+    /// number of samples
+    FullPrecRealType num_samples = 0;
+
+    void resize(int num_psi)
+    {
+      weight.resize(num_psi);
+      weighted_energy.resize(num_psi);
+      reset();
+    }
+
+    void reset()
+    {
+      std::fill(weight.begin(), weight.end(), 0);
+      std::fill(weighted_energy.begin(), weighted_energy.end(), 0);
+      num_samples = 0;
+    }
+  };
+
+  /** the correlated pairs of the walkers of one crowd
+   *
+   *  Pair 0 is the crowd's own TrialWaveFunction/QMCHamiltonian, the others are owned here.
+   */
+  struct CrowdCorrelatedSet
+  {
+    /// [ipsi][iw] wavefunction ipsi of walker iw
+    std::vector<RefVector<TrialWaveFunction>> twfs;
+    /// [ipsi][iw] hamiltonian ipsi of walker iw
+    std::vector<RefVector<QMCHamiltonian>> hams;
+    /// multi walker resources of each pair
+    RefVector<DriverWalkerResourceCollection> resources;
+    UPtrVector<TrialWaveFunction> twf_clones;
+    UPtrVector<QMCHamiltonian> ham_clones;
+    UPtrVector<DriverWalkerResourceCollection> resource_clones;
+    CSAccumulator accumulator;
+  };
+
+  /** To avoid 10's of arguments to runCSVMCStep
+   */
+  struct StateForThread
+  {
+    const QMCDriverInput& qmcdrv_input;
+    const MCPopulation& population;
+    /// normalization of each wavefunction
+    const std::vector<FullPrecRealType>& avg_norm;
+
+    StateForThread(const QMCDriverInput& qmci, MCPopulation& pop, const std::vector<FullPrecRealType>& norm)
+        : qmcdrv_input(qmci), population(pop), avg_norm(norm)
+    {}
+  };
+
+  /// Constructor.
+  CSVMCBatched(const ProjectData& project_data, QMCDriverInput&& qmcdriver_input, MCPopulation&& pop, Communicate* comm);
+
+  /** register a correlated pair, the first one is the primary pair the population is built on
+   */
+  void add_H_and_Psi(QMCHamiltonian* h, TrialWaveFunction* psi) override;
+
+  void process(xmlNodePtr node) override;
+
+  bool run() override;
+
+  /** umbrella weights of the correlated wavefunctions at one configuration
+   * @param log_psi log of each wavefunction
+   * @param avg_norm normalization of each wavefunction
+   * @param weights output \f$ w_i = (|\Psi_i|^2/N_i) / \sum_j |\Psi_j|^2/N_j \f$
+   */
+  static void computeUmbrellaWeights(const std::vector<FullPrecRealType>& log_psi,
+                                     const std::vector<FullPrecRealType>& avg_norm,
+                                     std::vector<FullPrecRealType>& weights);
+
+  /// evaluate the correlated wavefunctions of a crowd after initialLogEvaluation
+  static void initCorrelatedWalkers(const StateForThread& sft, Crowd& crowd, CrowdCorrelatedSet& cs);
+
+  /** move all the walkers of a crowd by one step and accumulate the correlated pairs
+   */
+  static void advanceWalkers(const StateForThread& sft,
+                             Crowd& crowd,
+                             CrowdCorrelatedSet& cs,
+                             DriverTimers& timers,
+                             ContextForSteps& step_context,
+                             bool recompute,
+                             bool accumulate_this_step);
+
+  QMCRunType getRunType() override { return QMCRunType::CSVMC_BATCH; }
+
+private:
+  /// give every walker its own copy of the correlated pairs
+  void createCorrelatedSets();
+
+  /** sum the crowd accumulators over the crowds and ranks
+   * @return weight sums, then weighted energy sums, then the number of samples
+   */
+  std::vector<FullPrecRealType> reduceAccumulators();
+
+  /// write a block of the correlated sampling estimates
+  void writeCSdat(int block, const std::vector<FullPrecRealType>& sums);
+
+  ///primary pair first
+  std::vector<TrialWaveFunction*> psi_pool_;
+  std::vector<QMCHamiltonian*> h_pool_;
+  /// normalization of each wavefunction, set by the warmup
+  std::vector<FullPrecRealType> avg_norm_;
+  /// multi walker resources of the non primary pairs, copied by every crowd
+  UPtrVector<DriverWalkerResourceCollection> golden_cs_resources_;
+  std::vector<CrowdCorrelatedSet> crowd_cs_;
+  /// output of the correlated sampling estimates
+  std::unique_ptr<std::ofstream> cs_stream_;
+
+  /// copy constructor (disabled)
+  CSVMCBatched(const CSVMCBatched&) = delete;
+  /// Copy operator (disabled).
+  CSVMCBatched& operator=(const CSVMCBatched&) = delete;
+};
+
+} // namespace qmcplusplus
+
+#endif
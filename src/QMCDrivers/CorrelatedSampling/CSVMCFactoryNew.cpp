@@ -0,0 +1,35 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "CSVMCFactoryNew.h"
+#include "QMCDrivers/CorrelatedSampling/CSVMCBatched.h"
+
+namespace qmcplusplus
+{
+QMCDriverInterface* CSVMCFactoryNew::create(const ProjectData& project_data, MCPopulation&& pop, Communicate* comm)
+{
+#if defined(QMC_CUDA)
+  comm->barrier_and_abort("CSVMC batched driver is not supported by legacy CUDA builds.");
+#endif
+
+  app_summary() << "\n========================================"
+                   "\n  Reading CSVMC driver XML input section"
+                   "\n========================================"
+                << std::endl;
+
+  QMCDriverInput qmcdriver_input;
+  qmcdriver_input.readXML(input_node_);
+  QMCDriverInterface* qmc = new CSVMCBatched(project_data, std::move(qmcdriver_input), std::move(pop), comm);
+  // the correlated wavefunctions are only moved particle by particle
+  qmc->setUpdateMode(1);
+  return qmc;
+}
+} // namespace qmcplusplus
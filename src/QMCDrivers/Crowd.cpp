@@ -14,8 +14,12 @@ namespace qmcplusplus
 {
 Crowd::Crowd(EstimatorManagerNew& emb,
              const DriverWalkerResourceCollection& driverwalker_res,
-             const MultiWalkerDispatchers& dispatchers)
-    : dispatchers_(dispatchers), driverwalker_resource_collection_(driverwalker_res), estimator_manager_crowd_(emb)
+             const MultiWalkerDispatchers& dispatchers,
+             int device_num)
+    : dispatchers_(dispatchers),
+      driverwalker_resource_collection_(driverwalker_res),
+      estimator_manager_crowd_(emb),
+      device_num_(device_num)
 {}
 
 Crowd::~Crowd() = default;
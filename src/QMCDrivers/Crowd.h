@@ -41,10 +41,14 @@ public:
   using RealType         = QMCTraits::RealType;
   using FullPrecRealType = QMCTraits::FullPrecRealType;
   /** This is the data structure for walkers within a crowd
+   *  @param device_num OpenMP device holding the resources and the walkers of the crowd, negative for the default
+   *
+   *  The shared resources are cloned on the current default device, so construct it with device_num as the default.
    */
   Crowd(EstimatorManagerNew& emb,
         const DriverWalkerResourceCollection& driverwalker_res,
-        const MultiWalkerDispatchers& dispatchers);
+        const MultiWalkerDispatchers& dispatchers,
+        int device_num = -1);
   ~Crowd();
   /** Because so many vectors allocate them upfront.
    *
@@ -71,7 +75,7 @@ public:
   {
     if (this->size() == 0)
       return;
-    estimator_manager_crowd_.accumulate(mcp_walkers_, walker_elecs_, walker_twfs_, rng);
+    estimator_manager_crowd_.accumulate(mcp_walkers_, walker_elecs_, walker_twfs_, walker_hamiltonians_, rng);
   }
 
   void setRNGForHamiltonian(RandomGenerator& rng);
@@ -94,8 +98,11 @@ public:
 
   int size() const { return mcp_walkers_.size(); }
 
-  void incReject() { ++n_reject_; }
-  void incAccept() { ++n_accept_; }
+  /// OpenMP device the crowd runs on, negative for the default device of the rank
+  int getDeviceNum() const { return device_num_; }
+
+  void incReject(unsigned long n = 1) { n_reject_ += n; }
+  void incAccept(unsigned long n = 1) { n_accept_ += n; }
   void incNonlocalAccept(int n = 1) { n_nonlocal_accept_ += n; }
   unsigned long get_nonlocal_accept() { return n_nonlocal_accept_; }
   unsigned long get_accept() { return n_accept_; }
@@ -120,6 +127,8 @@ private:
   DriverWalkerResourceCollection driverwalker_resource_collection_;
   /// per crowd estimator manager
   EstimatorManagerCrowd estimator_manager_crowd_;
+  /// OpenMP device the crowd runs on
+  const int device_num_;
 
   /** @name Step State
    * 
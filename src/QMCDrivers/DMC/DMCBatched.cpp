@@ -16,16 +16,19 @@
 
 #include "DMCBatched.h"
 #include "QMCDrivers/GreenFunctionModifiers/DriftModifierBase.h"
+#include "QMCDrivers/DriftOperators.h"
 #include "Concurrency/ParallelExecutor.hpp"
 #include "Concurrency/Info.hpp"
 #include "Message/UniformCommunicateError.h"
 #include "Message/CommOperators.h"
 #include "ParticleBase/RandomSeqGenerator.h"
 #include "Utilities/RunTimeManager.h"
+#include "Utilities/StartupProfile.h"
 #include "Utilities/ProgressReportEngine.h"
 #include "QMCDrivers/DMC/WalkerControl.h"
 #include "QMCDrivers/SFNBranch.h"
 #include "MemoryUsage.h"
+#include "Utilities/TimerTrace.h"
 
 namespace qmcplusplus
 {
@@ -49,6 +52,8 @@ DMCBatched::DMCBatched(const ProjectData& project_data,
       dmcdriver_input_(input),
       dmc_timers_("DMCBatched::")
 {
+  if (block_metrics_)
+    block_metrics_->addCategory("branching", {dmc_timers_.branch_timer});
 }
 // clang-format on
 
@@ -60,50 +65,49 @@ void DMCBatched::setNonLocalMoveHandler(QMCHamiltonian& golden_hamiltonian)
                                       dmcdriver_input_.get_alpha(), dmcdriver_input_.get_gamma());
 }
 
-void DMCBatched::advanceWalkers(const StateForThread& sft,
-                                Crowd& crowd,
-                                DriverTimers& timers,
-                                DMCTimers& dmc_timers,
-                                ContextForSteps& step_context,
-                                bool recompute,
-                                bool accumulate_this_step)
+void DMCBatched::changeTimeStep(StateForThread& sft, RealType tau, int warmup_steps)
+{
+  sft.tau = tau;
+  // T-moves scale with the time step, spawned walkers clone the golden hamiltonian or reuse a dead one
+  auto set_tau = [this, tau](QMCHamiltonian& ham) {
+    ham.setNonLocalMoves(dmcdriver_input_.get_non_local_move(), tau, dmcdriver_input_.get_alpha(),
+                         dmcdriver_input_.get_gamma());
+  };
+  set_tau(population_.get_golden_hamiltonian());
+  for (UPtr<QMCHamiltonian>& ham : population_.get_hamiltonians())
+    set_tau(*ham);
+  for (UPtr<QMCHamiltonian>& ham : population_.get_dead_hamiltonians())
+    set_tau(*ham);
+  branch_engine_->resetTimeStep(tau, warmup_steps);
+}
+
+void DMCBatched::advanceWalkersPbyP(const StateForThread& sft,
+                                    Crowd& crowd,
+                                    DriverTimers& timers,
+                                    ContextForSteps& step_context,
+                                    bool recompute,
+                                    std::vector<RealType>& rr_proposed,
+                                    std::vector<RealType>& rr_accepted)
 {
   auto& ps_dispatcher  = crowd.dispatchers_.ps_dispatcher_;
   auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
-  auto& ham_dispatcher = crowd.dispatchers_.ham_dispatcher_;
 
-  auto& walkers = crowd.get_walkers();
   const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
   const RefVectorWithLeader<TrialWaveFunction> walker_twfs(crowd.get_walker_twfs()[0], crowd.get_walker_twfs());
   const RefVectorWithLeader<QMCHamiltonian> walker_hamiltonians(crowd.get_walker_hamiltonians()[0],
                                                                 crowd.get_walker_hamiltonians());
 
-  timers.resource_timer.start();
-  ResourceCollectionTeamLock<ParticleSet> pset_res_lock(crowd.getSharedResource().pset_res, walker_elecs);
-  ResourceCollectionTeamLock<TrialWaveFunction> twfs_res_lock(crowd.getSharedResource().twf_res, walker_twfs);
-  ResourceCollectionTeamLock<QMCHamiltonian> hams_res_lock(crowd.getSharedResource().ham_res, walker_hamiltonians);
-  timers.resource_timer.stop();
-
-  {
-    ScopedTimer recompute_timer(dmc_timers.step_begin_recompute_timer);
-    std::vector<bool> recompute_mask;
-    recompute_mask.reserve(walkers.size());
-    for (MCPWalker& awalker : walkers)
-      if (awalker.wasTouched)
-      {
-        recompute_mask.push_back(true);
-        awalker.wasTouched = false;
-      }
-      else
-        recompute_mask.push_back(false);
-    ps_dispatcher.flex_loadWalker(walker_elecs, walkers, recompute_mask, true);
-    twf_dispatcher.flex_recompute(walker_twfs, walker_elecs, recompute_mask);
-  }
-
   const int num_walkers = crowd.size();
 
   //This generates an entire steps worth of deltas.
   step_context.nextDeltaRs(num_walkers * sft.population.get_num_particles());
+  // spins are moved together with the positions and the ratios include the spin gradients
+  const bool is_spinor = walker_elecs.getLeader().isSpinor();
+  if (is_spinor)
+    step_context.nextDeltaSpins(num_walkers * sft.population.get_num_particles());
+  const bool batched_acceptance = sft.qmcdrv_input.get_batched_acceptance();
+  if (batched_acceptance)
+    step_context.nextAcceptUniforms(num_walkers * sft.population.get_num_particles());
   auto it_delta_r = step_context.deltaRsBegin();
 
   std::vector<TrialWaveFunction::GradType> grads_now(num_walkers, TrialWaveFunction::GradType(0.0));
@@ -118,21 +122,31 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
   std::vector<bool> isAccepted;
   isAccepted.reserve(num_walkers);
 
-  //save the old energies for branching needs.
-  std::vector<FullPrecRealType> old_energies(num_walkers);
-  for (int iw = 0; iw < num_walkers; ++iw)
-    old_energies[iw] = walkers[iw].get().Properties(WP::LOCALENERGY);
+  // per move scratch, allocated once to keep the host work between the kernels of successive moves short
+  std::vector<RealType> rr(num_walkers, 0.0);
+  std::vector<int> rejects(num_walkers); // instead of std::vector<bool>
 
-  std::vector<RealType> rr_proposed(num_walkers, 0.0);
-  std::vector<RealType> rr_accepted(num_walkers, 0.0);
+  const RealType spin_mass = sft.qmcdrv_input.get_spin_mass();
+  std::vector<TrialWaveFunction::ComplexType> spingrads_now(is_spinor ? num_walkers : 0);
+  std::vector<TrialWaveFunction::ComplexType> spingrads_new(is_spinor ? num_walkers : 0);
+  std::vector<ParticleSet::Scalar_t> spin_drifts(is_spinor ? num_walkers : 0);
+
+  // the drift and diffusion of the legacy DMCUpdatePbyPL2, used only if the Hamiltonian has an L2 potential
+  const bool use_L2 = sft.dmcdrv_input.get_L2_diffusion() && walker_hamiltonians.getLeader().has_L2();
+  std::vector<QMCHamiltonian::TensorType> l2_D;
+  std::vector<QMCHamiltonian::PosType> l2_K;
+  const std::vector<bool> reject_all(use_L2 ? num_walkers : 0, false);
 
   {
     ScopedTimer pbyp_local_timer(timers.movepbyp_timer);
     for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
     {
-      RealType tauovermass = sft.qmcdrv_input.get_tau() * sft.population.get_ptclgrp_inv_mass()[ig];
+      RealType tauovermass = sft.tau * sft.population.get_ptclgrp_inv_mass()[ig];
       RealType oneover2tau = 0.5 / (tauovermass);
       RealType sqrttau     = std::sqrt(tauovermass);
+      // the spin moves of the legacy SODMCUpdatePbyPWithRejectionFast
+      const RealType spin_tauovermass = tauovermass / spin_mass;
+      const RealType spin_sqrttau     = std::sqrt(spin_tauovermass);
 
       twf_dispatcher.flex_prepareGroup(walker_twfs, walker_elecs, ig);
 
@@ -145,6 +159,7 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
 
         //This is very useful thing to be able to look at in the debugger
 #ifndef NDEBUG
+        auto& walkers = crowd.get_walkers();
         std::vector<int> walkers_who_have_been_on_wire(num_walkers, 0);
         for (int iw = 0; iw < walkers.size(); ++iw)
         {
@@ -153,15 +168,43 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
         }
 #endif
         //get the displacement
-        twf_dispatcher.flex_evalGrad(walker_twfs, walker_elecs, iat, grads_now);
-        sft.drift_modifier.getDrifts(tauovermass, grads_now, drifts);
+        if (is_spinor)
+        {
+          twf_dispatcher.flex_evalGradWithSpin(walker_twfs, walker_elecs, iat, grads_now, spingrads_now);
+          sft.drift_modifier.getDrifts(spin_tauovermass, spingrads_now, spin_drifts);
+          const auto* delta_spins = step_context.get_walker_spin_deltas().data() + iat * num_walkers;
+          for (int iw = 0; iw < num_walkers; ++iw)
+            spin_drifts[iw] += spin_sqrttau * delta_spins[iw];
+        }
+        else
+          twf_dispatcher.flex_evalGrad(walker_twfs, walker_elecs, iat, grads_now);
+        if (!use_L2)
+        {
+          sft.drift_modifier.getDrifts(tauovermass, grads_now, drifts);
 
-        std::transform(drifts.begin(), drifts.end(), delta_r_start, drifts.begin(),
-                       [sqrttau](PosType& drift, PosType& delta_r) { return drift + (sqrttau * delta_r); });
+          std::transform(drifts.begin(), drifts.end(), delta_r_start, drifts.begin(),
+                         [sqrttau](PosType& drift, PosType& delta_r) { return drift + (sqrttau * delta_r); });
+        }
+        else
+        {
+          // a move of zero distance makes the temporary distances at the current position valid
+          std::fill(drifts.begin(), drifts.end(), PosType(0.0));
+          ps_dispatcher.flex_makeMove(walker_elecs, iat, drifts);
+          QMCHamiltonian::mw_computeL2DK(walker_hamiltonians, walker_elecs, iat, l2_D, l2_K);
+          for (int iw = 0; iw < num_walkers; ++iw)
+            getScaledDriftL2(tauovermass, grads_now[iw], l2_D[iw], l2_K[iw], drifts[iw]);
+          ps_dispatcher.flex_accept_rejectMove(walker_elecs, iat, reject_all);
+
+          // the diffusion matrix is evaluated after the drift
+          ps_dispatcher.flex_makeMove(walker_elecs, iat, drifts);
+          QMCHamiltonian::mw_computeL2D(walker_hamiltonians, walker_elecs, iat, l2_D);
+          for (int iw = 0; iw < num_walkers; ++iw)
+            drifts[iw] += sqrttau * dot(cholesky(l2_D[iw]), *(delta_r_start + iw));
+          ps_dispatcher.flex_accept_rejectMove(walker_elecs, iat, reject_all);
+        }
 
         // only DMC does this
         // TODO: rr needs a real name
-        std::vector<RealType> rr(num_walkers, 0.0);
         assert(rr.size() == delta_r_end - delta_r_start);
         std::transform(delta_r_start, delta_r_end, rr.begin(),
                        [tauovermass](auto& delta_r) { return tauovermass * dot(delta_r, delta_r); });
@@ -176,9 +219,16 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
         for (int i = 0; i < rr.size(); ++i)
           assert(std::isfinite(rr[i]));
 #endif
-        ps_dispatcher.flex_makeMove(walker_elecs, iat, drifts);
-
-        twf_dispatcher.flex_calcRatioGrad(walker_twfs, walker_elecs, iat, ratios, grads_new);
+        if (is_spinor)
+        {
+          ps_dispatcher.flex_makeMoveWithSpin(walker_elecs, iat, drifts, spin_drifts);
+          twf_dispatcher.flex_calcRatioGradWithSpin(walker_twfs, walker_elecs, iat, ratios, grads_new, spingrads_new);
+        }
+        else
+        {
+          ps_dispatcher.flex_makeMove(walker_elecs, iat, drifts);
+          twf_dispatcher.flex_calcRatioGrad(walker_twfs, walker_elecs, iat, ratios, grads_new);
+        }
 
         auto checkPhaseChanged = [&sft](const TrialWaveFunction& twf, int& is_reject) {
           if (sft.branch_engine.phaseChanged(twf.getPhaseDiff()))
@@ -188,7 +238,6 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
         };
 
         // Hopefully a phase change doesn't make any of these transformations fail.
-        std::vector<int> rejects(num_walkers); // instead of std::vector<bool>
         for (int iw = 0; iw < num_walkers; ++iw)
         {
           checkPhaseChanged(walker_twfs[iw], rejects[iw]);
@@ -209,26 +258,52 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
         std::transform(drifts.begin(), drifts.end(), log_gb.begin(),
                        [oneover2tau](auto& drift) { return -oneover2tau * dot(drift, drift); });
 
+        if (is_spinor)
+        {
+          sft.drift_modifier.getDrifts(spin_tauovermass, spingrads_new, spin_drifts);
+          const auto* delta_spins = step_context.get_walker_spin_deltas().data() + iat * num_walkers;
+          for (int iw = 0; iw < num_walkers; ++iw)
+          {
+            const ParticleSet& elecs = walker_elecs[iw];
+            const auto ds            = elecs.spins[iat] - elecs.getActiveSpinVal() - spin_drifts[iw];
+            log_gb[iw] += -spin_mass * oneover2tau * ds * ds;
+            log_gf[iw] += RealType(-0.5) * delta_spins[iw] * delta_spins[iw];
+          }
+        }
+
         for (int iw = 0; iw < num_walkers; ++iw)
           prob[iw] = std::norm(ratios[iw]) * std::exp(log_gb[iw] - log_gf[iw]);
 
         isAccepted.clear();
 
-        for (int iw = 0; iw < num_walkers; ++iw)
+        if (batched_acceptance)
         {
-          if ((!rejects[iw]) && prob[iw] >= std::numeric_limits<RealType>::epsilon() &&
-              step_context.get_random_gen()() < prob[iw])
-          {
-            crowd.incAccept();
-            isAccepted.push_back(true);
-            rr_accepted[iw] += rr[iw];
-          }
-          else
+          for (int iw = 0; iw < num_walkers; ++iw)
+            if (rejects[iw] || prob[iw] < std::numeric_limits<RealType>::epsilon())
+              prob[iw] = 0;
+          const int num_accepted = step_context.acceptMoves(iat, prob, isAccepted);
+          crowd.incAccept(num_accepted);
+          crowd.incReject(num_walkers - num_accepted);
+          for (int iw = 0; iw < num_walkers; ++iw)
+            if (isAccepted[iw])
+              rr_accepted[iw] += rr[iw];
+        }
+        else
+          for (int iw = 0; iw < num_walkers; ++iw)
           {
-            crowd.incReject();
-            isAccepted.push_back(false);
+            if ((!rejects[iw]) && prob[iw] >= std::numeric_limits<RealType>::epsilon() &&
+                step_context.get_random_gen()() < prob[iw])
+            {
+              crowd.incAccept();
+              isAccepted.push_back(true);
+              rr_accepted[iw] += rr[iw];
+            }
+            else
+            {
+              crowd.incReject();
+              isAccepted.push_back(false);
+            }
           }
-        }
 
         twf_dispatcher.flex_accept_rejectMove(walker_twfs, walker_elecs, iat, isAccepted, true);
 
@@ -243,6 +318,72 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
   { // collect GL for KE.
     ScopedTimer buffer_local(timers.buffer_timer);
     twf_dispatcher.flex_evaluateGL(walker_twfs, walker_elecs, recompute);
+  }
+}
+
+void DMCBatched::advanceWalkers(const StateForThread& sft,
+                                Crowd& crowd,
+                                DriverTimers& timers,
+                                DMCTimers& dmc_timers,
+                                ContextForSteps& step_context,
+                                bool recompute,
+                                bool accumulate_this_step)
+{
+  auto& ps_dispatcher  = crowd.dispatchers_.ps_dispatcher_;
+  auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
+  auto& ham_dispatcher = crowd.dispatchers_.ham_dispatcher_;
+
+  auto& walkers = crowd.get_walkers();
+  const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
+  const RefVectorWithLeader<TrialWaveFunction> walker_twfs(crowd.get_walker_twfs()[0], crowd.get_walker_twfs());
+  const RefVectorWithLeader<QMCHamiltonian> walker_hamiltonians(crowd.get_walker_hamiltonians()[0],
+                                                                crowd.get_walker_hamiltonians());
+
+  timers.resource_timer.start();
+  ResourceCollectionTeamLock<ParticleSet> pset_res_lock(crowd.getSharedResource().pset_res, walker_elecs);
+  ResourceCollectionTeamLock<TrialWaveFunction> twfs_res_lock(crowd.getSharedResource().twf_res, walker_twfs);
+  ResourceCollectionTeamLock<QMCHamiltonian> hams_res_lock(crowd.getSharedResource().ham_res, walker_hamiltonians);
+  timers.resource_timer.stop();
+
+  {
+    ScopedTimer recompute_timer(dmc_timers.step_begin_recompute_timer);
+    std::vector<bool> recompute_mask;
+    recompute_mask.reserve(walkers.size());
+    for (MCPWalker& awalker : walkers)
+      if (awalker.wasTouched)
+      {
+        recompute_mask.push_back(true);
+        awalker.wasTouched = false;
+      }
+      else
+        recompute_mask.push_back(false);
+    ps_dispatcher.flex_loadWalker(walker_elecs, walkers, recompute_mask, true);
+    twf_dispatcher.flex_recompute(walker_twfs, walker_elecs, recompute_mask);
+  }
+
+  const int num_walkers = crowd.size();
+
+  //save the old energies for branching needs.
+  std::vector<FullPrecRealType> old_energies(num_walkers);
+  for (int iw = 0; iw < num_walkers; ++iw)
+    old_energies[iw] = walkers[iw].get().Properties(WP::LOCALENERGY);
+
+  std::vector<RealType> rr_proposed(num_walkers, 0.0);
+  std::vector<RealType> rr_accepted(num_walkers, 0.0);
+
+  if (sft.qmcdrv_input.get_update_mode() != "pbyp")
+  {
+    if (sft.dmcdrv_input.get_L2_diffusion() && walker_hamiltonians.getLeader().has_L2())
+      throw std::runtime_error("DMCBatched::advanceWalkers the L2 diffusion is only implemented for move=\"pbyp\"");
+    ScopedTimer move_timer(timers.movepbyp_timer);
+    moveAllElectrons(crowd, step_context, sft.drift_modifier, sft.population.get_ptclgrp_inv_mass(), sft.tau, true,
+                     &sft.branch_engine, 1, rr_proposed, rr_accepted);
+  }
+  else
+    advanceWalkersPbyP(sft, crowd, timers, step_context, recompute, rr_proposed, rr_accepted);
+
+  {
+    ScopedTimer buffer_local(timers.buffer_timer);
     if (sft.qmcdrv_input.get_debug_checks() & DriverDebugChecks::CHECKGL_AFTER_MOVES)
       checkLogAndGL(crowd, "checkGL_after_moves");
     ps_dispatcher.flex_saveWalker(walker_elecs, walkers);
@@ -276,7 +417,8 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
 
     // evaluate non-physical hamiltonian elements
     for (int iw = 0; iw < walkers.size(); ++iw)
-      walker_hamiltonians[iw].auxHevaluate(walker_elecs[iw], walkers[iw]);
+      walker_hamiltonians[iw].auxHevaluate(walker_elecs[iw], walkers[iw], sft.step, sft.block_steps,
+                                           accumulate_this_step);
 
     // save properties into walker
     for (int iw = 0; iw < walkers.size(); ++iw)
@@ -293,7 +435,6 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
     ScopedTimer tmove_timer(dmc_timers.tmove_timer);
 
     const auto num_walkers = walkers.size();
-    std::vector<int> walker_non_local_moves_accepted(num_walkers, 0);
     RefVector<MCPWalker> moved_nonlocal_walkers;
     RefVectorWithLeader<ParticleSet> moved_nonlocal_walker_elecs(crowd.get_walker_elecs()[0]);
     RefVectorWithLeader<TrialWaveFunction> moved_nonlocal_walker_twfs(crowd.get_walker_twfs()[0]);
@@ -301,10 +442,11 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
     moved_nonlocal_walker_elecs.reserve(num_walkers);
     moved_nonlocal_walker_twfs.reserve(num_walkers);
 
+    const std::vector<int> walker_non_local_moves_accepted(
+        ham_dispatcher.flex_makeNonLocalMoves(walker_hamiltonians, walker_twfs, walker_elecs));
+
     for (int iw = 0; iw < walkers.size(); ++iw)
     {
-      walker_non_local_moves_accepted[iw] = walker_hamiltonians[iw].makeNonLocalMoves(walker_elecs[iw]);
-
       if (walker_non_local_moves_accepted[iw] > 0)
       {
         crowd.incNonlocalAccept(walker_non_local_moves_accepted[iw]);
@@ -339,11 +481,10 @@ void DMCBatched::runDMCStep(int crowd_id,
   auto& rng = context_for_steps[crowd_id]->get_random_gen();
   crowd.setRNGForHamiltonian(rng);
 
-  const int max_steps  = sft.qmcdrv_input.get_max_steps();
   const IndexType step = sft.step;
   // Are we entering the the last step of a block to recompute at?
-  const bool recompute_this_step  = (sft.is_recomputing_block && (step + 1) == max_steps);
-  const bool accumulate_this_step = true;
+  const bool recompute_this_step  = (sft.is_recomputing_block && (step + 1) == sft.block_steps);
+  const bool accumulate_this_step = sft.is_accumulating;
   advanceWalkers(sft, crowd, timers, dmc_timers, *context_for_steps[crowd_id], recompute_this_step,
                  accumulate_this_step);
 }
@@ -353,10 +494,15 @@ void DMCBatched::process(xmlNodePtr node)
   print_mem("DMCBatched before initialization", app_log());
   try
   {
+    // the walkers move between crowds at every branching, they cannot stay on the device of a crowd
+    if (qmcdriver_input_.get_crowd_devices())
+      throw UniformCommunicateError("DMCBatched does not support crowd_devices, run one MPI rank per device instead.");
+
     QMCDriverNew::AdjustedWalkerCounts awc =
         adjustGlobalWalkerCount(myComm->size(), myComm->rank(), qmcdriver_input_.get_total_walkers(),
                                 qmcdriver_input_.get_walkers_per_rank(), dmcdriver_input_.get_reserve(),
-                                qmcdriver_input_.get_num_crowds());
+                                qmcdriver_input_.get_num_crowds(), getMultiWalkerMemoryPerWalker(),
+                                static_cast<size_t>(qmcdriver_input_.get_walker_memory_budget()) << 20);
 
     Base::startup(node, awc);
   }
@@ -377,12 +523,14 @@ void DMCBatched::process(xmlNodePtr node)
 
     walker_controller_ = std::make_unique<WalkerControl>(myComm, Random, dmcdriver_input_.get_reconfiguration());
     walker_controller_->setMinMax(population_.get_num_global_walkers(), 0);
+    walker_controller_->setScalarOutput(qmcdriver_input_.get_scalar_output_text(),
+                                        qmcdriver_input_.get_scalar_output_binary());
     walker_controller_->start();
     walker_controller_->put(node);
 
     std::ostringstream o;
     if (dmcdriver_input_.get_reconfiguration())
-      o << "  Fixed population using reconfiguration method\n";
+      o << "  Fixed population per rank using local reconfiguration, no walkers are exchanged\n";
     else
       o << "  Fluctuating population\n";
 
@@ -399,85 +547,135 @@ void DMCBatched::process(xmlNodePtr node)
 bool DMCBatched::run()
 {
   IndexType num_blocks = qmcdriver_input_.get_max_blocks();
+  // a time step sequence runs all the blocks at every time step, each into its own scalar streams
+  const std::vector<RealType>& timesteps = dmcdriver_input_.get_timesteps();
+  const int num_timesteps                = timesteps.empty() ? 1 : timesteps.size();
+  auto stream_tag = [&timesteps](int itau) { return timesteps.empty() ? std::string() : ".t" + std::to_string(itau); };
 
-  estimator_manager_->startDriverRun();
+  estimator_manager_->startDriverRun(stream_tag(0));
   StateForThread dmc_state(qmcdriver_input_, dmcdriver_input_, *drift_modifier_, *branch_engine_, population_);
+  // the first time step of the sequence keeps the warmup of the input
+  if (!timesteps.empty())
+    changeTimeStep(dmc_state, timesteps[0], branch_engine_->getWarmupToDoSteps());
 
   LoopTimer<> dmc_loop;
   RunTimeControl<> runtimeControl(run_time_manager, project_data_.getMaxCPUSeconds(), project_data_.getTitle(),
                                   myComm->rank() == 0);
+  const double finish_time = run_time_manager.elapsed() + qmcdriver_input_.get_target_time();
+  dmc_state.block_steps    = qmcdriver_input_.get_max_steps();
 
   { // walker initialization
     ScopedTimer local_timer(timers_.init_walkers_timer);
-    ParallelExecutor<> section_start_task;
+    startup_profile.push("InitialLogEvaluation");
+    ParallelExecutor<> section_start_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
     section_start_task(crowds_.size(), initialLogEvaluation, std::ref(crowds_), std::ref(step_contexts_));
+    startup_profile.pop();
   }
 
+  // the first step follows
+  startup_profile.finish(myComm);
   print_mem("DMCBatched after initialLogEvaluation", app_summary());
 
-  {
+  auto init_branch_engine = [this]() {
     FullPrecRealType energy, variance;
     population_.measureGlobalEnergyVariance(*myComm, energy, variance);
     // false indicates we do not support kill at node crossings.
     branch_engine_->initParam(population_, energy, variance, dmcdriver_input_.get_reconfiguration(), false);
     walker_controller_->setTrialEnergy(branch_engine_->getEtrial());
-  }
+  };
+  init_branch_engine();
 
-  ParallelExecutor<> crowd_task;
+  ParallelExecutor<> crowd_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
 
-  for (int block = 0; block < num_blocks; ++block)
-  {
-    dmc_loop.start();
-    estimator_manager_->startBlock(qmcdriver_input_.get_max_steps());
+  // steps taken over all the time steps, indexes the dmc.dat records
+  int iter = 0;
+  auto dmc_step = [&](int step) {
+    ScopedTimer local_timer(timers_.run_steps_timer);
+    dmc_state.step = step;
+    crowd_task(crowds_.size(), runDMCStep, dmc_state, timers_, dmc_timers_, std::ref(step_contexts_),
+               std::ref(crowds_));
 
-    dmc_state.recalculate_properties_period = (qmc_driver_mode_[QMC_UPDATE_MODE])
-        ? qmcdriver_input_.get_recalculate_properties_period()
-        : (qmcdriver_input_.get_max_blocks() + 1) * qmcdriver_input_.get_max_steps();
-    dmc_state.is_recomputing_block          = qmcdriver_input_.get_blocks_between_recompute()
-                 ? (1 + block) % qmcdriver_input_.get_blocks_between_recompute() == 0
-                 : false;
+    {
+      ScopedTimer branch_timer(dmc_timers_.branch_timer);
+      const int population_now = walker_controller_->branch(iter, population_, iter == 0);
+      branch_engine_->updateParamAfterPopControl(population_now, walker_controller_->get_ensemble_property(),
+                                                 population_.get_num_particles());
+      walker_controller_->setTrialEnergy(branch_engine_->getEtrial());
+    }
 
-    for (UPtr<Crowd>& crowd : crowds_)
-      crowd->startBlock(qmcdriver_input_.get_max_steps());
+    population_.redistributeWalkers(crowds_, dmcdriver_input_.get_balance_recompute());
+    ++iter;
+  };
 
-    for (int step = 0; step < qmcdriver_input_.get_max_steps(); ++step)
+  bool stop_requested = false;
+  for (int itau = 0; itau < num_timesteps && !stop_requested; ++itau)
+  {
+    if (itau > 0)
     {
-      ScopedTimer local_timer(timers_.run_steps_timer);
-      dmc_state.step = step;
-      crowd_task(crowds_.size(), runDMCStep, dmc_state, timers_, dmc_timers_, std::ref(step_contexts_),
-                 std::ref(crowds_));
+      // the population, crowds and their resources carry over, only the branching restarts at the new time step
+      estimator_manager_->stopDriverRun();
+      estimator_manager_->startDriverRun(stream_tag(itau));
+      changeTimeStep(dmc_state, timesteps[itau], dmcdriver_input_.get_timestep_warmup_steps());
+      app_log() << "  DMCBatched switching to time step " << timesteps[itau] << ", re-equilibrating for "
+                << dmcdriver_input_.get_timestep_warmup_steps() << " steps" << std::endl;
+      init_branch_engine();
+
+      dmc_state.is_accumulating      = false;
+      dmc_state.is_recomputing_block = false;
+      for (int step = 0; step < dmcdriver_input_.get_timestep_warmup_steps(); ++step)
+        dmc_step(step);
+      if (walker_controller_->completeWalkerExchange(population_))
+        population_.redistributeWalkers(crowds_, dmcdriver_input_.get_balance_recompute());
+      dmc_state.is_accumulating = true;
+    }
+    if (!timesteps.empty())
+      app_log() << "  DMCBatched time step " << dmc_state.tau << " writes to " << myComm->getName() << stream_tag(itau)
+                << ".scalar.dat" << std::endl;
 
+    for (int block = 0; block < num_blocks; ++block)
+    {
+      timer_trace.startBlock();
+      if (block_metrics_)
+        block_metrics_->startBlock();
+      dmc_loop.start();
+      estimator_manager_->startBlock(dmc_state.block_steps);
+
+      dmc_state.recalculate_properties_period = (qmc_driver_mode_[QMC_UPDATE_MODE])
+          ? qmcdriver_input_.get_recalculate_properties_period()
+          : (qmcdriver_input_.get_max_blocks() + 1) * qmcdriver_input_.get_max_steps();
+      dmc_state.is_recomputing_block          = qmcdriver_input_.get_blocks_between_recompute()
+                   ? (1 + block) % qmcdriver_input_.get_blocks_between_recompute() == 0
+                   : false;
+
+      for (UPtr<Crowd>& crowd : crowds_)
+        crowd->startBlock(dmc_state.block_steps);
+
+      for (int step = 0; step < dmc_state.block_steps; ++step)
+        dmc_step(step);
+      // walkers still in flight join the population before the block ends
+      if (walker_controller_->completeWalkerExchange(population_))
+        population_.redistributeWalkers(crowds_, dmcdriver_input_.get_balance_recompute());
+      print_mem("DMCBatched after a block", app_debug_stream());
+      endBlock(dmc_state.block_steps);
+      dmc_loop.stop(dmc_state.block_steps);
+
+      const int blocks_left = (num_timesteps - itau) * num_blocks - block - 1;
+      stop_requested        = checkStop(runtimeControl, dmc_loop, finish_time, blocks_left, dmc_state.block_steps);
+
+      if (stop_requested)
       {
-        int iter                 = block * qmcdriver_input_.get_max_steps() + step;
-        const int population_now = walker_controller_->branch(iter, population_, iter == 0);
-        branch_engine_->updateParamAfterPopControl(population_now, walker_controller_->get_ensemble_property(),
-                                                   population_.get_num_particles());
-        walker_controller_->setTrialEnergy(branch_engine_->getEtrial());
+        if (!myComm->rank())
+          app_log() << runtimeControl.generateStopMessage("DMCBatched", block);
+        run_time_manager.markStop();
+        break;
       }
-
-      population_.redistributeWalkers(crowds_);
+      if (isTargetErrorReached("DMCBatched", block))
+        break;
     }
-    print_mem("DMCBatched after a block", app_debug_stream());
-    endBlock();
-    dmc_loop.stop();
 
-    bool stop_requested = false;
-    // Rank 0 decides whether the time limit was reached
-    if (!myComm->rank())
-      stop_requested = runtimeControl.checkStop(dmc_loop);
-    myComm->bcast(stop_requested);
-
-    if (stop_requested)
-    {
-      if (!myComm->rank())
-        app_log() << runtimeControl.generateStopMessage("DMCBatched", block);
-      run_time_manager.markStop();
-      break;
-    }
+    branch_engine_->printStatus();
   }
 
-  branch_engine_->printStatus();
-
   print_mem("DMCBatched ends", app_log());
 
   estimator_manager_->stopDriverRun();
@@ -52,13 +52,24 @@ public:
     SFNBranch& branch_engine;
     IndexType recalculate_properties_period;
     IndexType step            = -1;
+    /// steps of the current block, fewer than the input steps when the block is shortened
+    IndexType block_steps     = 0;
     bool is_recomputing_block = false;
+    /// false during the re-equilibration after a time step change
+    bool is_accumulating = true;
+    /// current time step, changes along a time step sequence
+    RealType tau;
     StateForThread(const QMCDriverInput& qmci,
                    const DMCDriverInput& dmci,
                    DriftModifierBase& drift_mod,
                    SFNBranch& branch_eng,
                    MCPopulation& pop)
-        : qmcdrv_input(qmci), dmcdrv_input(dmci), drift_modifier(drift_mod), population(pop), branch_engine(branch_eng)
+        : qmcdrv_input(qmci),
+          dmcdrv_input(dmci),
+          drift_modifier(drift_mod),
+          population(pop),
+          branch_engine(branch_eng),
+          tau(qmci.get_tau())
     {}
   };
 
@@ -67,9 +78,11 @@ public:
   public:
     NewTimer& tmove_timer;
     NewTimer& step_begin_recompute_timer;
+    NewTimer& branch_timer;
     DMCTimers(const std::string& prefix)
         : tmove_timer(*timer_manager.createTimer(prefix + "Tmove", timer_level_medium)),
-          step_begin_recompute_timer(*timer_manager.createTimer(prefix + "Step_begin_recompute", timer_level_medium))
+          step_begin_recompute_timer(*timer_manager.createTimer(prefix + "Step_begin_recompute", timer_level_medium)),
+          branch_timer(*timer_manager.createTimer(prefix + "Branch", timer_level_medium))
     {}
   };
 
@@ -120,6 +133,11 @@ public:
   void setNonLocalMoveHandler(QMCHamiltonian& golden_hamiltonian);
 
 private:
+  /** move the population to a new time step of the timesteps sequence
+   *  @param warmup_steps number of steps the branch engine spends in warmup at the new time step
+   */
+  void changeTimeStep(StateForThread& sft, RealType tau, int warmup_steps);
+
   const DMCDriverInput dmcdriver_input_;
 
   /** I think its better if these have there own type and variable name
@@ -140,6 +158,18 @@ private:
                              bool recompute,
                              bool accumulate_this_step);
 
+  /** particle-by-particle moves and the update of G and L of the walkers of a crowd
+   *  @param rr_proposed incremented by the squared diffusive displacements of the proposed moves
+   *  @param rr_accepted incremented by those of the accepted moves
+   */
+  static void advanceWalkersPbyP(const StateForThread& sft,
+                                 Crowd& crowd,
+                                 DriverTimers& timers,
+                                 ContextForSteps& move_context,
+                                 bool recompute,
+                                 std::vector<RealType>& rr_proposed,
+                                 std::vector<RealType>& rr_accepted);
+
   friend class qmcplusplus::testing::DMCBatchedTest;
 };
 
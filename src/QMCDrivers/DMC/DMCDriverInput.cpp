@@ -10,6 +10,7 @@
 //////////////////////////////////////////////////////////////////////////////////////
 
 #include "DMCDriverInput.h"
+#include "OhmmsData/XMLParsingString.h"
 
 namespace qmcplusplus
 {
@@ -19,7 +20,9 @@ void DMCDriverInput::readXML(xmlNodePtr node)
 {
   ParameterSet parameter_set_;
   std::string reconfig_str;
-  parameter_set_.add(reconfig_str, "reconfiguration", {"no", "yes", "runwhileincorrect"});
+  std::string balance_recompute;
+  std::string L2_diffusion;
+  parameter_set_.add(reconfig_str, "reconfiguration", {"no", "yes", "local"});
   parameter_set_.add(NonLocalMove, "nonlocalmove", {"no", "yes", "v0", "v1", "v3"});
   parameter_set_.add(NonLocalMove, "nonlocalmoves", {"no", "yes", "v0", "v1", "v3"});
   parameter_set_.add(max_age_, "MaxAge");
@@ -36,15 +39,28 @@ void DMCDriverInput::readXML(xmlNodePtr node)
   parameter_set_.add(gamma_, "gamma");
 
   parameter_set_.add(reserve_, "reserve");
+  parameter_set_.add(balance_recompute, "balance_recompute", {"no", "yes"});
+  parameter_set_.add(timestep_warmup_steps_, "timestep_warmup_steps");
+  parameter_set_.add(L2_diffusion, "L2_diffusion", {"no", "yes"});
 
   parameter_set_.put(node);
 
+  // ParameterSet only handles scalars, the time step sequence is a list
+  xmlNodePtr child = node->children;
+  while (child != NULL)
+  {
+    if (getNodeName(child) == "parameter" && getXMLAttributeValue(child, "name") == "timesteps")
+      putContent(timesteps_, child);
+    child = child->next;
+  }
+
   if (reconfig_str == "yes")
-    throw std::runtime_error("Reconfiguration is currently broken and gives incorrect results. Use dynamic "
-                             "population control by setting reconfiguration=\"no\" or removing the reconfiguration "
-                             "option from the DMC input section. If accessing the broken reconfiguration code path "
-                             "is still desired, set reconfiguration to \"runwhileincorrect\" instead of \"yes\".");
-  reconfiguration_ = (reconfig_str == "yes");
+    throw std::runtime_error("Global reconfiguration is not supported by the batched DMC driver. Set "
+                             "reconfiguration=\"local\" to fix the number of walkers on each rank or set "
+                             "reconfiguration=\"no\" for dynamic population control.");
+  reconfiguration_   = (reconfig_str == "local");
+  balance_recompute_ = balance_recompute == "yes";
+  L2_diffusion_      = L2_diffusion == "yes";
 
   if (NonLocalMove == "yes" || NonLocalMove == "v0")
     app_summary() << "  Using Non-local T-moves v0, M. Casula, PRB 74, 161102(R) (2006)";
@@ -64,6 +80,12 @@ void DMCDriverInput::readXML(xmlNodePtr node)
 
   if (reserve_ < 1.0)
     throw std::runtime_error("You can only reserve walkers above the target walker count");
+
+  for (const RealType tau : timesteps_)
+    if (tau <= 0.0)
+      throw std::runtime_error("Illegal input for timesteps in DMC input section, time steps must be positive");
+  if (timestep_warmup_steps_ < 0)
+    throw std::runtime_error("Illegal input for timestep_warmup_steps in DMC input section");
 }
 
 std::ostream& operator<<(std::ostream& o_stream, const DMCDriverInput& dmci) { return o_stream; }
@@ -36,6 +36,10 @@ public:
   double get_alpha() const { return alpha_; }
   double get_gamma() const { return gamma_; }
   RealType get_reserve() const { return reserve_; }
+  bool get_balance_recompute() const { return balance_recompute_; }
+  bool get_L2_diffusion() const { return L2_diffusion_; }
+  const std::vector<RealType>& get_timesteps() const { return timesteps_; }
+  IndexType get_timestep_warmup_steps() const { return timestep_warmup_steps_; }
 
 private:
   /** @ingroup Parameters for DMC Driver
@@ -50,8 +54,8 @@ private:
   std::string KillWalker;
   ///input std::string to determine swap walkers among mpi processors
   std::string SwapWalkers;
-  /// reconfiguration flag
-  bool reconfiguration_ = true;
+  /// fixed population per rank by local reconfiguration
+  bool reconfiguration_ = false;
   ///input std::string to determine to use nonlocal move
   std::string NonLocalMove;
   ///input std::string to use fast gradient
@@ -60,6 +64,14 @@ private:
   IndexType max_age_ = 10;
   /// reserved walkers for population growth
   RealType reserve_ = 1.0;
+  /// spread the walkers to be recomputed after branching evenly over the crowds
+  bool balance_recompute_ = false;
+  /// use the drift and diffusion modified by the L2 potential
+  bool L2_diffusion_ = false;
+  /// sequence of time steps run one after another on the same population, empty for the single timestep
+  std::vector<RealType> timesteps_;
+  /// re-equilibration steps when the time step of the sequence changes
+  IndexType timestep_warmup_steps_ = 20;
   double alpha_     = 0.0;
   double gamma_     = 0.0;
   /** @} */
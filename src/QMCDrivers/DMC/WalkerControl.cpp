@@ -15,7 +15,9 @@
 //////////////////////////////////////////////////////////////////////////////////////
 
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <stdexcept>
 #include <numeric>
 #include <sstream>
@@ -25,6 +27,7 @@
 #include "OhmmsData/ParameterSet.h"
 #include "type_traits/template_types.hpp"
 #include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "Message/CommProfile.h"
 
 namespace qmcplusplus
 {
@@ -64,12 +67,26 @@ WalkerControl::WalkerControl(Communicate* c, RandomGenerator& rng, bool use_fixe
       num_ranks_(c->size()),
       SwapMode(0),
       use_nonblocking_(true),
+      use_compact_message_(true),
+      use_async_exchange_(false),
+      use_node_first_balance_(true),
       debug_disable_branching_(false),
       saved_num_walkers_sent_(0)
 {
   num_per_rank_.resize(num_ranks_);
   fair_offset_.resize(num_ranks_ + 1);
 
+#if defined(HAVE_MPI)
+  { // contexts sharing the memory of a node are identified by the lowest context on the node
+    Communicate node_comm;
+    node_comm.initializeAsNodeComm(*myComm);
+    std::vector<int> node_leader(1, rank_num_);
+    node_comm.bcast(node_leader[0]);
+    node_of_rank_.resize(num_ranks_);
+    myComm->allgather(node_leader, node_of_rank_, 1);
+  }
+#endif
+
   setup_timers(my_timers_, WalkerControlTimerNames, timer_level_medium);
 }
 
@@ -83,15 +100,24 @@ void WalkerControl::start()
     hname.append(".dmc.dat");
     if (hname != dmcFname)
     {
-      dmcStream = std::make_unique<std::ofstream>(hname.c_str());
-      dmcStream->setf(std::ios::scientific, std::ios::floatfield);
-      dmcStream->precision(10);
-      (*dmcStream) << "# Index " << std::setw(20) << "LocalEnergy" << std::setw(20) << "Variance" << std::setw(20)
-                   << "Weight" << std::setw(20) << "NumOfWalkers" << std::setw(20)
-                   << "AvgSentWalkers"; //add the number of walkers
-      (*dmcStream) << std::setw(20) << "TrialEnergy" << std::setw(20) << "DiffEff";
-      (*dmcStream) << std::setw(20) << "LivingFraction";
-      (*dmcStream) << std::endl;
+      if (write_dmc_text_)
+      {
+        dmcStream = std::make_unique<std::ofstream>(hname.c_str());
+        dmcStream->setf(std::ios::scientific, std::ios::floatfield);
+        dmcStream->precision(10);
+        (*dmcStream) << "# Index " << std::setw(20) << "LocalEnergy" << std::setw(20) << "Variance" << std::setw(20)
+                     << "Weight" << std::setw(20) << "NumOfWalkers" << std::setw(20)
+                     << "AvgSentWalkers"; //add the number of walkers
+        (*dmcStream) << std::setw(20) << "TrialEnergy" << std::setw(20) << "DiffEff";
+        (*dmcStream) << std::setw(20) << "LivingFraction";
+        (*dmcStream) << std::endl;
+      }
+      if (write_dmc_binary_)
+        dmc_binary_ = std::make_unique<ScalarTableWriter>(myComm->getName() + ".dmc.bin",
+                                                          std::vector<std::string>{"index", "LocalEnergy", "Variance",
+                                                                                   "Weight", "NumOfWalkers",
+                                                                                   "AvgSentWalkers", "TrialEnergy",
+                                                                                   "DiffEff", "LivingFraction"});
       dmcFname = hname;
     }
   }
@@ -133,6 +159,19 @@ void WalkerControl::writeDMCdat(int iter, const std::vector<FullPrecRealType>& c
     (*dmcStream)
         << std::endl; //'\n'; // this is definitely not a place to put an endl as that is also a signal for a flush.
   }
+  if (dmc_binary_)
+  {
+    const double row[] = {static_cast<double>(iter),
+                          ensemble_property_.Energy,
+                          ensemble_property_.Variance,
+                          ensemble_property_.Weight,
+                          static_cast<double>(ensemble_property_.NumSamples),
+                          curData[SENTWALKERS_INDEX] / static_cast<double>(num_ranks_),
+                          trial_energy_,
+                          ensemble_property_.R2Accepted / ensemble_property_.R2Proposed,
+                          ensemble_property_.LivingFraction};
+    dmc_binary_->append(row);
+  }
 }
 
 int WalkerControl::branch(int iter, MCPopulation& pop, bool do_not_branch)
@@ -144,8 +183,8 @@ int WalkerControl::branch(int iter, MCPopulation& pop, bool do_not_branch)
     2. compute curData, collect multiplicity on every rank
 
      fix population
-    1. compute curData, collect weight on every rank
-    2. compute multiplicity by comb method
+    1. compute multiplicity by comb method within the rank
+    2. compute curData, collect weight on every rank
 
     3. figure out final distribution, apply walker count ceiling
     4. collect good, bad walkers
@@ -155,56 +194,69 @@ int WalkerControl::branch(int iter, MCPopulation& pop, bool do_not_branch)
 
   ScopedTimer branch_timer(my_timers_[WC_branch]);
   auto& walkers = pop.get_walkers();
+  // weight of the walkers after a local reconfiguration
+  FullPrecRealType fixed_pop_weight = 1.0;
+
+  // walkers in [0, untouched_walkers) keep their state. Walkers received during the last step are not among them.
+  auto untouched_walkers = walkers.size();
+  completeWalkerExchange(pop);
 
   {
     ScopedTimer prebalance_timer(my_timers_[WC_prebalance]);
     ///any temporary data includes many ridiculous conversions of integral types to and from fp
     std::vector<FullPrecRealType> curData(LE_MAX + num_ranks_, 0.0);
 
-    if (use_fixed_pop_)
-    {
-      computeCurData(walkers, curData);
-      // convert  node local num of walkers after combing
-      // curData[LE_MAX + rank_num_] = wsum to num_total_copies
-      // calculate walker->Multiplicity;
-    }
+    pop.syncBranchingData();
+    auto& branching_data = pop.get_branching_data();
+    // no branching at the first iteration to avoid large population change.
+    auto& multiplicities = branching_data.multiplicities;
+    if (do_not_branch)
+      std::fill(multiplicities.begin(), multiplicities.end(), 1);
+    else if (use_fixed_pop_)
+      combWalkersOnRank(branching_data.weights, multiplicities, rng_());
     else
-    {
-      // no branching at the first iteration to avoid large population change.
-      if (do_not_branch)
-        for (auto& walker : walkers)
-          walker->Multiplicity = 1.0;
-      else
-        for (auto& walker : walkers)
-          walker->Multiplicity = static_cast<int>(walker->Weight + rng_());
-      computeCurData(walkers, curData);
-      for (int i = 0, j = LE_MAX; i < num_ranks_; i++, j++)
-        num_per_rank_[i] = static_cast<int>(curData[j]);
-    }
+      for (size_t iw = 0; iw < multiplicities.size(); iw++)
+        multiplicities[iw] = static_cast<int>(branching_data.weights[iw] + rng_());
+    pop.applyMultiplicities();
+    computeCurData(branching_data, curData);
+    for (int i = 0, j = LE_MAX; i < num_ranks_; i++, j++)
+      num_per_rank_[i] = static_cast<int>(curData[j]);
     // at this point, curData[LE_MAX + rank_num_] and walker->Multiplicity are ready.
 
+    // the combed walkers carry the average weight of their rank relative to the global average weight
+    const auto& weights = branching_data.weights;
+    if (use_fixed_pop_ && !weights.empty())
+      fixed_pop_weight = std::accumulate(weights.begin(), weights.end(), FullPrecRealType(0)) / weights.size() *
+          curData[WALKERSIZE_INDEX] / curData[WEIGHT_INDEX];
+
     writeDMCdat(iter, curData);
     pop.set_ensemble_property(ensemble_property_);
   }
 
-  auto untouched_walkers = walkers.size();
+  // kill dead walkers and remove them from the untouched range
+  auto kill_dead_walkers = [&pop, &walkers, &untouched_walkers]() {
+    untouched_walkers -= std::count_if(walkers.begin(), walkers.begin() + untouched_walkers,
+                                       [](const auto& walker) { return static_cast<int>(walker->Multiplicity) == 0; });
+    killDeadWalkersOnRank(pop);
+  };
+
+  bool exchange_in_flight = false;
 #if defined(HAVE_MPI)
   {
     ScopedTimer loadbalance_timer(my_timers_[WC_loadbalance]);
     // kill walkers, actually put them in deadlist for be recycled for receiving walkers
-    killDeadWalkersOnRank(pop);
-    // ranks receiving walkers from other ranks have the lowest walker count now.
-    untouched_walkers = std::min(untouched_walkers, walkers.size());
+    kill_dead_walkers();
 
-    // load balancing over MPI
-    swapWalkersSimple(pop);
+    // load balancing over MPI, a fixed population per rank needs none
+    if (!use_fixed_pop_)
+      swapWalkersSimple(pop);
+    exchange_in_flight = !exchange_requests_.empty();
   }
 #endif
 
   // kill dead walker to be recycled by the following copy
-  killDeadWalkersOnRank(pop);
-  // ranks sending walkers from other ranks have the lowest walker count now.
-  untouched_walkers = std::min(untouched_walkers, walkers.size());
+  if (!exchange_in_flight)
+    kill_dead_walkers();
 
   { // copy good walkers
     ScopedTimer copywalkers_timer(my_timers_[WC_copyWalkers]);
@@ -221,19 +273,29 @@ int WalkerControl::branch(int iter, MCPopulation& pop, bool do_not_branch)
     }
   }
 
+  // the walkers in flight are killed after the copy which must not recycle them before the sends complete.
+  if (exchange_in_flight)
+    kill_dead_walkers();
+
   const int current_num_global_walkers = std::accumulate(num_per_rank_.begin(), num_per_rank_.end(), 0);
-  pop.set_num_global_walkers(current_num_global_walkers);
 #ifndef NDEBUG
   pop.checkIntegrity();
   pop.syncWalkersPerRank(myComm);
-  if (current_num_global_walkers != pop.get_num_global_walkers())
+  int num_incoming_walkers = 0;
+#if defined(HAVE_MPI)
+  for (int ncopy : incoming_copies_)
+    num_incoming_walkers += ncopy + 1;
+#endif
+  myComm->allreduce(num_incoming_walkers);
+  if (current_num_global_walkers != pop.get_num_global_walkers() + num_incoming_walkers)
     throw std::runtime_error("Potential bug! Population num_global_walkers mismatched!");
 #endif
+  pop.set_num_global_walkers(current_num_global_walkers);
 
   if (!do_not_branch)
     for (UPtr<MCPWalker>& walker : pop.get_walkers())
     {
-      walker->Weight       = 1.0;
+      walker->Weight       = fixed_pop_weight;
       walker->Multiplicity = 1.0;
     }
 
@@ -246,21 +308,30 @@ int WalkerControl::branch(int iter, MCPopulation& pop, bool do_not_branch)
   return pop.get_num_global_walkers();
 }
 
-void WalkerControl::computeCurData(const UPtrVector<MCPWalker>& walkers, std::vector<FullPrecRealType>& curData)
+void WalkerControl::computeCurData(const MCPopulation::BranchingData& branching_data,
+                                   std::vector<FullPrecRealType>& curData)
 {
+  const FullPrecRealType* restrict weights        = branching_data.weights.data();
+  const FullPrecRealType* restrict local_energies = branching_data.local_energies.data();
+  const FullPrecRealType* restrict r2_acc         = branching_data.r2_accepted.data();
+  const FullPrecRealType* restrict r2_prop        = branching_data.r2_proposed.data();
+  const int* restrict multiplicities              = branching_data.multiplicities.data();
+  const int num_walkers                           = branching_data.weights.size();
+
   FullPrecRealType esum = 0.0, e2sum = 0.0, wsum = 0.0;
   FullPrecRealType r2_accepted = 0.0, r2_proposed = 0.0;
   int num_good_walkers(0), num_total_copies(0);
-  for (const auto& walker : walkers)
+#pragma omp simd reduction(+ : esum, e2sum, wsum, r2_accepted, r2_proposed, num_good_walkers, num_total_copies)
+  for (int iw = 0; iw < num_walkers; iw++)
   {
-    const int num_copies = static_cast<int>(walker->Multiplicity);
+    const int num_copies = multiplicities[iw];
     num_good_walkers += num_copies > 0 ? 1 : 0;
     num_total_copies += num_copies;
     // Ye : not sure about these r2
-    r2_accepted += walker->Properties(WP::R2ACCEPTED);
-    r2_proposed += walker->Properties(WP::R2PROPOSED);
-    FullPrecRealType e   = walker->Properties(WP::LOCALENERGY);
-    FullPrecRealType wgt = walker->Weight;
+    r2_accepted += r2_acc[iw];
+    r2_proposed += r2_prop[iw];
+    const FullPrecRealType e   = local_energies[iw];
+    const FullPrecRealType wgt = weights[iw];
     esum += wgt * e;
     e2sum += wgt * e * e;
     wsum += wgt;
@@ -269,40 +340,107 @@ void WalkerControl::computeCurData(const UPtrVector<MCPWalker>& walkers, std::ve
   std::fill(curData.begin(), curData.end(), 0);
   curData[ENERGY_INDEX]      = esum;
   curData[ENERGY_SQ_INDEX]   = e2sum;
-  curData[WALKERSIZE_INDEX]  = walkers.size(); // num of all the current walkers (good+bad)
+  curData[WALKERSIZE_INDEX]  = num_walkers; // num of all the current walkers (good+bad)
   curData[WEIGHT_INDEX]      = wsum;
   curData[R2ACCEPTED_INDEX]  = r2_accepted;
   curData[R2PROPOSED_INDEX]  = r2_proposed;
   curData[FNSIZE_INDEX]      = num_good_walkers; // num of good walkers before branching
   curData[SENTWALKERS_INDEX] = saved_num_walkers_sent_;
-  if (use_fixed_pop_)
-    curData[LE_MAX + rank_num_] = wsum; // node sum of walker weights
-  else
-    curData[LE_MAX + rank_num_] = num_total_copies; // node num of walkers after local branching
+  curData[LE_MAX + rank_num_] = num_total_copies; // node num of walkers after local branching
 
   {
     ScopedTimer allreduce_timer(my_timers_[WC_allreduce]);
+    ScopedCommProfile profile("WalkerControl::allreduce", curData.size() * sizeof(FullPrecRealType));
     myComm->allreduce(curData);
   }
 }
 
+void WalkerControl::combWalkersOnRank(const std::vector<FullPrecRealType>& weights,
+                                     std::vector<int>& multiplicities,
+                                     FullPrecRealType zeta)
+{
+  const int num_walkers = weights.size();
+  multiplicities.resize(num_walkers);
+  const FullPrecRealType wsum = std::accumulate(weights.begin(), weights.end(), FullPrecRealType(0));
+  if (num_walkers > 0 && !(wsum > 0))
+    throw std::runtime_error("WalkerControl::combWalkersOnRank all the walkers of the rank have zero weight.");
+  const FullPrecRealType tooth_spacing = wsum / num_walkers;
+  FullPrecRealType cumulated_weight    = 0.0;
+  int num_teeth                        = 0;
+  for (int iw = 0; iw < num_walkers; iw++)
+  {
+    cumulated_weight += weights[iw];
+    // teeth (zeta + k) * tooth_spacing below the cumulated weight, the last walker takes the rounding error
+    int teeth_below = num_walkers;
+    if (iw + 1 < num_walkers)
+      teeth_below = std::clamp(static_cast<int>(std::ceil(cumulated_weight / tooth_spacing - zeta)), num_teeth,
+                               num_walkers);
+    multiplicities[iw] = teeth_below - num_teeth;
+    num_teeth          = teeth_below;
+  }
+}
+
+/** pair the contexts with walkers in excess and the contexts in deficit, both in the given order
+ * @param contexts contexts to pair
+ * @param excess number of walkers in excess of each context, reduced by the pairing
+ * @param minus receiving contexts, appended
+ * @param plus sending contexts, appended
+ */
+static void pairContexts(const std::vector<int>& contexts,
+                         std::vector<int>& excess,
+                         std::vector<int>& minus,
+                         std::vector<int>& plus)
+{
+  auto sender   = contexts.begin();
+  auto receiver = contexts.begin();
+  while (true)
+  {
+    sender   = std::find_if(sender, contexts.end(), [&excess](int ip) { return excess[ip] > 0; });
+    receiver = std::find_if(receiver, contexts.end(), [&excess](int ip) { return excess[ip] < 0; });
+    if (sender == contexts.end() || receiver == contexts.end())
+      break;
+    const int num_walkers = std::min(excess[*sender], -excess[*receiver]);
+    plus.insert(plus.end(), num_walkers, *sender);
+    minus.insert(minus.end(), num_walkers, *receiver);
+    excess[*sender] -= num_walkers;
+    excess[*receiver] += num_walkers;
+  }
+}
+
 // determine new walker population on each node
 void WalkerControl::determineNewWalkerPopulation(const std::vector<int>& num_per_rank,
                                                  std::vector<int>& fair_offset,
                                                  std::vector<int>& minus,
-                                                 std::vector<int>& plus)
+                                                 std::vector<int>& plus,
+                                                 const std::vector<int>& node_of_rank)
 {
   const int num_contexts       = num_per_rank.size();
   const int current_population = std::accumulate(num_per_rank.begin(), num_per_rank.end(), 0);
   FairDivideLow(current_population, num_contexts, fair_offset);
+  std::vector<int> excess(num_contexts);
   for (int ip = 0; ip < num_contexts; ip++)
+    excess[ip] = num_per_rank[ip] - (fair_offset[ip + 1] - fair_offset[ip]);
+
+  std::vector<int> contexts(num_contexts);
+  std::iota(contexts.begin(), contexts.end(), 0);
+  if (!node_of_rank.empty())
   {
-    int dn = num_per_rank[ip] - (fair_offset[ip + 1] - fair_offset[ip]);
-    if (dn > 0)
-      plus.insert(plus.end(), dn, ip);
-    else if (dn < 0)
-      minus.insert(minus.end(), -dn, ip);
+    // the walkers move within each node first
+    std::vector<int> node_contexts(contexts);
+    std::stable_sort(node_contexts.begin(), node_contexts.end(),
+                     [&node_of_rank](int ip, int jp) { return node_of_rank[ip] < node_of_rank[jp]; });
+    std::vector<int> same_node;
+    for (auto first = node_contexts.begin(); first != node_contexts.end();)
+    {
+      auto last = std::find_if(first, node_contexts.end(),
+                               [&node_of_rank, first](int ip) { return node_of_rank[ip] != node_of_rank[*first]; });
+      same_node.assign(first, last);
+      pairContexts(same_node, excess, minus, plus);
+      first = last;
+    }
   }
+  // the remaining imbalance crosses the nodes
+  pairContexts(contexts, excess, minus, plus);
 #ifndef NDEBUG
   if (plus.size() != minus.size())
   {
@@ -318,7 +456,8 @@ void WalkerControl::determineNewWalkerPopulation(const std::vector<int>& num_per
 void WalkerControl::swapWalkersSimple(MCPopulation& pop)
 {
   std::vector<int> minus, plus;
-  determineNewWalkerPopulation(num_per_rank_, fair_offset_, minus, plus);
+  determineNewWalkerPopulation(num_per_rank_, fair_offset_, minus, plus,
+                               use_node_first_balance_ ? node_of_rank_ : std::vector<int>());
 
 #ifdef MCWALKERSET_MPI_DEBUG
   char fname[128];
@@ -380,7 +519,10 @@ void WalkerControl::swapWalkersSimple(MCPopulation& pop)
         }
 
       // send the number of copies to the target
-      myComm->comm.send_value(nsentcopy, minus[ic]);
+      {
+        ScopedCommProfile profile("WalkerControl::send_copies", sizeof(nsentcopy));
+        myComm->comm.send_value(nsentcopy, minus[ic]);
+      }
       job_list.push_back(job(ncopy_pairs.back().second, minus[ic]));
 #ifdef MCWALKERSET_MPI_DEBUG
       fout << "rank " << plus[ic] << " sends a walker with " << nsentcopy << " copies to rank " << minus[ic]
@@ -405,11 +547,16 @@ void WalkerControl::swapWalkersSimple(MCPopulation& pop)
 
     if (minus[ic] == rank_num_)
     {
-      newW.push_back(pop.spawnWalker());
+      // incoming walkers of the asynchronous exchange stay out of the population until they are merged
+      if (!use_async_exchange_)
+        newW.push_back(pop.spawnWalker());
 
       // recv the number of copies from the target
-      myComm->comm.receive_n(&nsentcopy, 1, plus[ic]);
-      job_list.push_back(job(newW.size() - 1, plus[ic]));
+      {
+        ScopedCommProfile profile("WalkerControl::recv_copies", sizeof(nsentcopy));
+        myComm->comm.receive_n(&nsentcopy, 1, plus[ic]);
+      }
+      job_list.push_back(job(ncopy_newW.size(), plus[ic]));
       if (plus[ic] != plus[ic + nsentcopy] || minus[ic] != minus[ic + nsentcopy])
         throw std::runtime_error("WalkerControl::swapWalkersSimple send/recv pair checking failed!");
 #ifdef MCWALKERSET_MPI_DEBUG
@@ -433,52 +580,87 @@ void WalkerControl::swapWalkersSimple(MCPopulation& pop)
     for (auto jobit = job_list.begin(); jobit != job_list.end(); jobit++)
     {
       // pack data and send
-      auto& awalker   = good_walkers[jobit->walkerID];
-      size_t byteSize = awalker->byteSize();
+      auto& awalker = good_walkers[jobit->walkerID];
       if (!awalker->SendInProgress)
       {
         awalker->updateBuffer();
         awalker->SendInProgress = true;
       }
-      if (use_nonblocking_)
-        requests.push_back(myComm->comm.isend_n(awalker->DataSet.data(), byteSize, jobit->target));
-      else
-      {
-        ScopedTimer local_timer(my_timers_[WC_send]);
-        myComm->comm.send_n(awalker->DataSet.data(), byteSize, jobit->target);
-      }
+      for (const auto& [offset, byteSize] : getMessageRanges(*awalker))
+        if (use_nonblocking_)
+        {
+          ScopedCommProfile profile("WalkerControl::isend", byteSize);
+          requests.push_back(myComm->comm.isend_n(awalker->DataSet.data() + offset, byteSize, jobit->target));
+        }
+        else
+        {
+          ScopedTimer local_timer(my_timers_[WC_send]);
+          ScopedCommProfile profile("WalkerControl::send", byteSize);
+          myComm->comm.send_n(awalker->DataSet.data() + offset, byteSize, jobit->target);
+        }
     }
-    if (use_nonblocking_)
+    if (use_async_exchange_)
+      exchange_requests_ = std::move(requests);
+    else if (use_nonblocking_)
     {
       // wait all the isend
       for (int im = 0; im < requests.size(); im++)
       {
         ScopedTimer local_timer(my_timers_[WC_send]);
+        ScopedCommProfile profile("WalkerControl::wait_send");
         requests[im].wait();
       }
       requests.clear();
     }
   }
+  else if (use_async_exchange_)
+  {
+    // grow the receive buffers from any walker, the layout of DataSet is the same
+    for (int iw = incoming_walkers_.size(); iw < job_list.size(); iw++)
+      incoming_walkers_.push_back(
+          std::make_unique<MCPWalker>(good_walkers.empty() ? *pop.get_dead_walkers().back() : *good_walkers.front()));
+    for (int ij = 0; ij < job_list.size(); ij++)
+    {
+      auto& awalker = *incoming_walkers_[job_list[ij].walkerID];
+      for (const auto& [offset, byteSize] : getMessageRanges(awalker))
+      {
+        ScopedCommProfile profile("WalkerControl::irecv", byteSize);
+        exchange_requests_.push_back(
+            myComm->comm.ireceive_n(awalker.DataSet.data() + offset, byteSize, job_list[ij].target));
+      }
+    }
+    incoming_copies_ = ncopy_newW;
+  }
   else
   {
     std::vector<mpi3::request> requests;
-    for (auto jobit = job_list.begin(); jobit != job_list.end(); jobit++)
+    // the job of each request and the number of pending requests of each job
+    std::vector<int> request_jobs, pending_requests(job_list.size(), 0);
+    for (int ij = 0; ij < job_list.size(); ij++)
     {
       // recv and unpack data
-      auto& walker_elements = newW[jobit->walkerID];
+      auto& walker_elements = newW[job_list[ij].walkerID];
       auto& awalker         = walker_elements.walker;
-      size_t byteSize       = awalker.byteSize();
-      if (use_nonblocking_)
-        requests.push_back(myComm->comm.ireceive_n(awalker.DataSet.data(), byteSize, jobit->target));
-      else
-      {
-        ScopedTimer local_timer(my_timers_[WC_recv]);
-        myComm->comm.receive_n(awalker.DataSet.data(), byteSize, jobit->target);
-        awalker.copyFromBuffer();
-      }
+      for (const auto& [offset, byteSize] : getMessageRanges(awalker))
+        if (use_nonblocking_)
+        {
+          ScopedCommProfile profile("WalkerControl::irecv", byteSize);
+          requests.push_back(myComm->comm.ireceive_n(awalker.DataSet.data() + offset, byteSize, job_list[ij].target));
+          request_jobs.push_back(ij);
+          pending_requests[ij]++;
+        }
+        else
+        {
+          ScopedTimer local_timer(my_timers_[WC_recv]);
+          ScopedCommProfile profile("WalkerControl::recv", byteSize);
+          myComm->comm.receive_n(awalker.DataSet.data() + offset, byteSize, job_list[ij].target);
+        }
+      if (!use_nonblocking_)
+        awalker.copyFromBuffer(use_compact_message_);
     }
     if (use_nonblocking_)
     {
+      ScopedCommProfile profile("WalkerControl::wait_recv");
       std::vector<bool> not_completed(requests.size(), true);
       bool completed = false;
       while (!completed)
@@ -489,9 +671,12 @@ void WalkerControl::swapWalkersSimple(MCPopulation& pop)
           {
             if (requests[im].completed())
             {
-              auto& walker_elements = newW[job_list[im].walkerID];
-              walker_elements.walker.copyFromBuffer();
               not_completed[im] = false;
+              if (--pending_requests[request_jobs[im]] == 0)
+              {
+                auto& walker_elements = newW[job_list[request_jobs[im]].walkerID];
+                walker_elements.walker.copyFromBuffer(use_compact_message_);
+              }
             }
             else
               completed = false;
@@ -515,23 +700,65 @@ void WalkerControl::swapWalkersSimple(MCPopulation& pop)
   FullPrecRealType TotalMultiplicity = 0;
   for (int iw = 0; iw < good_walkers.size(); iw++)
     TotalMultiplicity += good_walkers[iw]->Multiplicity;
+  for (int ncopy : incoming_copies_)
+    TotalMultiplicity += ncopy + 1;
   if (static_cast<int>(TotalMultiplicity) != fair_offset_[rank_num_ + 1] - fair_offset_[rank_num_])
     throw std::runtime_error("Multiplicity check failed in WalkerControl::swapWalkersSimple!");
 #endif
 }
+
+bool WalkerControl::completeWalkerExchange(MCPopulation& pop)
+{
+  if (exchange_requests_.empty())
+    return false;
+
+  ScopedTimer loadbalance_timer(my_timers_[WC_loadbalance]);
+  {
+    // each MPI rank either sends or receives
+    ScopedTimer local_timer(my_timers_[incoming_copies_.empty() ? WC_send : WC_recv]);
+    ScopedCommProfile profile("WalkerControl::wait_exchange");
+    for (auto& request : exchange_requests_)
+      request.wait();
+    exchange_requests_.clear();
+  }
+
+  for (int iw = 0; iw < incoming_copies_.size(); iw++)
+  {
+    auto& incoming = *incoming_walkers_[iw];
+    incoming.copyFromBuffer(use_compact_message_);
+    for (int icopy = 0; icopy <= incoming_copies_[iw]; icopy++)
+    {
+      auto walker_elements                = pop.spawnWalker();
+      walker_elements.walker              = incoming;
+      walker_elements.walker.Weight       = 1.0;
+      walker_elements.walker.Multiplicity = 1.0;
+      walker_elements.walker.wasTouched   = true;
+    }
+  }
+  const bool merged = !incoming_copies_.empty();
+  incoming_copies_.clear();
+  return merged;
+}
+
+std::vector<std::pair<size_t, size_t>> WalkerControl::getMessageRanges(MCPWalker& walker) const
+{
+  // allocates DataSet if not yet
+  const size_t byte_size = walker.byteSize();
+  if (use_compact_message_)
+  {
+    const auto ranges = walker.getCompactMessageRanges();
+    return {ranges.begin(), ranges.end()};
+  }
+  return {{0, byte_size}};
+}
+#else
+bool WalkerControl::completeWalkerExchange(MCPopulation& pop) { return false; }
 #endif
 
 void WalkerControl::killDeadWalkersOnRank(MCPopulation& pop)
 {
   // kill walkers, actually put them in deadlist
-  RefVector<MCPWalker> bad_walkers;
-  auto& walkers = pop.get_walkers();
-  bad_walkers.reserve(walkers.size());
-  for (auto& walker : walkers)
-    if (static_cast<int>(walker->Multiplicity) == 0)
-      bad_walkers.push_back(*walker);
-  for (MCPWalker& bad_walker : bad_walkers)
-    pop.killWalker(bad_walker);
+  pop.killDeadWalkers();
 #ifndef NDEBUG
   pop.checkIntegrity();
 #endif
@@ -550,12 +777,18 @@ bool WalkerControl::put(xmlNodePtr cur)
 {
   int nw_target = 0, nw_max = 0;
   std::string nonblocking;
+  std::string compact_message;
+  std::string async_exchange;
+  std::string node_first_balance;
   std::string debug_disable_branching;
   ParameterSet params;
   params.add(max_copy_, "maxCopy");
   params.add(nw_target, "targetwalkers");
   params.add(nw_max, "max_walkers");
   params.add(nonblocking, "use_nonblocking", {"yes", "no"});
+  params.add(compact_message, "compact_walker_message", {"yes", "no"});
+  params.add(async_exchange, "async_walker_exchange", {"no", "yes"});
+  params.add(node_first_balance, "node_first_balance", {"yes", "no"});
   params.add(debug_disable_branching, "debug_disable_branching", {"no", "yes"});
 
   try
@@ -568,6 +801,14 @@ bool WalkerControl::put(xmlNodePtr cur)
   }
 
   use_nonblocking_         = nonblocking == "yes";
+  use_compact_message_     = compact_message == "yes";
+  use_async_exchange_      = async_exchange == "yes";
+  use_node_first_balance_  = node_first_balance == "yes";
+  if (use_async_exchange_ && !use_nonblocking_)
+  {
+    app_warning() << "WalkerControl::put async_walker_exchange requires use_nonblocking. Ignored." << std::endl;
+    use_async_exchange_ = false;
+  }
   debug_disable_branching_ = debug_disable_branching == "yes";
 
   setMinMax(nw_target, nw_max);
@@ -579,6 +820,12 @@ bool WalkerControl::put(xmlNodePtr cur)
   app_log() << "    Max Walkers per MPI rank " << n_max_ << std::endl;
   app_log() << "    Min Walkers per MPI rank " << n_min_ << std::endl;
   app_log() << "    Using " << (use_nonblocking_ ? "non-" : "") << "blocking send/recv" << std::endl;
+  if (!use_compact_message_)
+    app_log() << "    Sending the full walker buffer during load balancing" << std::endl;
+  if (use_async_exchange_)
+    app_log() << "    Overlapping the walker exchange with the next step" << std::endl;
+  if (!use_node_first_balance_)
+    app_log() << "    Balancing the walkers over all the MPI ranks at once" << std::endl;
   if (debug_disable_branching_)
     app_log() << "    Disable branching for debugging as the user input request." << std::endl;
   return true;
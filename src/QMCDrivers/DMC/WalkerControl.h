@@ -24,6 +24,7 @@
 #include "Message/MPIObjectBase.h"
 #include "Message/CommOperators.h"
 #include "Utilities/RandomGenerator.h"
+#include "Utilities/ScalarTable.h"
 
 namespace qmcplusplus
 {
@@ -59,6 +60,16 @@ public:
   /** start a block */
   void start();
 
+  /** select the files of the population records, call before start
+   * @param write_text write the formatted dmc.dat
+   * @param write_binary write the binary dmc.bin, a ScalarTable of the same columns
+   */
+  void setScalarOutput(bool write_text, bool write_binary)
+  {
+    write_dmc_text_   = write_text;
+    write_dmc_binary_ = write_binary;
+  }
+
   /** take averages and writes to a file */
   void writeDMCdat(int iter, const std::vector<FullPrecRealType>& curData);
 
@@ -72,6 +83,14 @@ public:
    */
   int branch(int iter, MCPopulation& pop, bool do_not_branch);
 
+  /** complete the walker exchange left in flight by branch and merge the received walkers
+   *
+   *  No-op unless the asynchronous exchange is on. branch calls it before the population is reduced.
+   *  The driver calls it before the walkers are needed on every rank, e.g. at the end of a block.
+   *  \return true if any walker was merged
+   */
+  bool completeWalkerExchange(MCPopulation& pop);
+
   bool put(xmlNodePtr cur);
 
   void setMinMax(int nw_in, int nmax_in);
@@ -91,22 +110,38 @@ private:
 
   static std::vector<IndexType> syncFutureWalkersPerRank(Communicate* comm, IndexType n_walkers);
 
-  /// compute curData
-  void computeCurData(const UPtrVector<MCPWalker>& walkers, std::vector<FullPrecRealType>& curData);
+  /** stochastic reconfiguration of the walkers of a rank keeping their number
+   *
+   *  A comb with one tooth per walker, evenly spaced and shifted by zeta, is laid over the cumulated weights.
+   *  Each walker gets a copy per tooth falling on its weight.
+   *  \param[in] weights walker weights
+   *  \param[out] multiplicities number of copies of each walker, summing to the number of walkers
+   *  \param[in] zeta shift of the comb in [0,1)
+   */
+  static void combWalkersOnRank(const std::vector<FullPrecRealType>& weights,
+                                std::vector<int>& multiplicities,
+                                FullPrecRealType zeta);
+
+  /// compute curData from the branching data of the population
+  void computeCurData(const MCPopulation::BranchingData& branching_data, std::vector<FullPrecRealType>& curData);
 
   /** creates the distribution plan
    *
    *  populates the minus and plus vectors they contain 1 copy of a partition index 
    *  for each adjustment in population to the context.
+   *  plus[i] sends a walker to minus[i]. If the node of each context is given,
+   *  the contexts are paired within each node first and only the remaining imbalance crosses the nodes.
    *  \param[in] num_per_rank as if all walkers were copied out to multiplicity
    *  \param[out] fair_offset running population count at each partition boundary
    *  \param[out] minus list of partition indexes one occurrence for each walker removed
    *  \param[out] plus list of partition indexes one occurrence for each walker added
+   *  \param[in] node_of_rank node id of each context, empty if the nodes are ignored
    */
   static void determineNewWalkerPopulation(const std::vector<int>& num_per_rank,
                                            std::vector<int>& fair_offset,
                                            std::vector<int>& minus,
-                                           std::vector<int>& plus);
+                                           std::vector<int>& plus,
+                                           const std::vector<int>& node_of_rank = {});
 
 #if defined(HAVE_MPI)
   /** swap Walkers with Recv/Send or Irecv/Isend
@@ -119,8 +154,16 @@ private:
    * Then the walkers are transferred via blocking or non-blocking send/recv.
    * The blocking send/recv may become serialized and worsen load imbalance.
    * Non blocking send/recv algorithm avoids serialization completely.
+   * With the asynchronous exchange, the requests are left in flight and completed by completeWalkerExchange.
+   * The incoming walkers are received outside the population and merged at the next step boundary.
    */
   void swapWalkersSimple(MCPopulation& pop);
+
+  /** byte ranges of the walker DataSet sent during load balancing
+   *
+   * The received walkers are always recomputed before they move, so the compact message without G and L suffices.
+   */
+  std::vector<std::pair<size_t, size_t>> getMessageRanges(MCPWalker& walker) const;
 #endif
 
   /** An enum to access curData for reduction
@@ -142,7 +185,7 @@ private:
 
   ///random number generator
   RandomGenerator& rng_;
-  ///if true, use fixed population
+  ///if true, use fixed population per rank by local reconfiguration, no walker crosses the ranks
   bool use_fixed_pop_;
   ///minimum number of walkers
   IndexType n_min_;
@@ -160,6 +203,12 @@ private:
   std::string dmcFname;
   ///file to save energy histogram
   std::unique_ptr<std::ofstream> dmcStream;
+  ///binary table of the same records
+  std::unique_ptr<ScalarTableWriter> dmc_binary_;
+  ///if true, write dmc.dat
+  bool write_dmc_text_ = true;
+  ///if true, write dmc.bin
+  bool write_dmc_binary_ = false;
   ///context id
   const IndexType rank_num_;
   ///number of contexts
@@ -170,6 +219,22 @@ private:
   std::vector<FullPrecRealType> curData;
   ///Use non-blocking isend/irecv
   bool use_nonblocking_;
+  ///Send the compact walker message without the data recomputed by the receiver
+  bool use_compact_message_;
+  ///Leave the walker exchange in flight while the next step advances the local walkers
+  bool use_async_exchange_;
+  ///Balance the walkers within each node before crossing the nodes
+  bool use_node_first_balance_;
+  ///node id of each context, the lowest context on the node
+  std::vector<int> node_of_rank_;
+#if defined(HAVE_MPI)
+  ///requests of the walker exchange in flight
+  std::vector<mpi3::request> exchange_requests_;
+  ///receive buffers of the walker exchange in flight, reused over the steps
+  UPtrVector<MCPWalker> incoming_walkers_;
+  ///number of extra copies of each incoming walker
+  std::vector<int> incoming_copies_;
+#endif
   ///disable branching for debugging
   bool debug_disable_branching_;
   ///ensemble properties
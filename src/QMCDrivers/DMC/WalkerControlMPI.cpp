@@ -270,8 +270,8 @@ void WalkerControlMPI::swapWalkersSimple(MCWalkerConfiguration& W)
       }
       else
       {
+        // the walker is recycled once its send is complete
         ncopy_pairs.pop_back();
-        bad_w.push_back(std::make_unique<Walker_t>(*awalker));
       }
     }
     if (minus[ic] == MyContext)
@@ -294,15 +294,8 @@ void WalkerControlMPI::swapWalkersSimple(MCWalkerConfiguration& W)
            << std::endl;
 #endif
 
-      // save the new walker
-      if (awalker)
-      {
-        newW.push_back(std::make_unique<Walker_t>(*awalker));
-      }
-      else
-      {
-        newW.push_back(nullptr);
-      }
+      // save the new walker, its buffer is overwritten by the received one
+      newW.push_back(std::move(awalker));
       ncopy_newW.push_back(nsentcopy);
       // update cursor
       ic += nsentcopy;
@@ -352,7 +345,7 @@ void WalkerControlMPI::swapWalkersSimple(MCWalkerConfiguration& W)
       // recv and unpack data
       auto& awalker = newW[jobit->walkerID];
       if (!awalker)
-        awalker = std::make_unique<Walker_t>(wRef);
+        awalker = makeWalkerCopy(wRef);
       size_t byteSize = awalker->byteSize();
       if (use_nonblocking)
         requests.push_back(myComm->comm.ireceive_n(awalker->DataSet.data(), byteSize, jobit->target));
@@ -396,6 +389,10 @@ void WalkerControlMPI::swapWalkersSimple(MCWalkerConfiguration& W)
     good_w[iw]  = std::move(good_w_temp[ncopy_pairs[iw].second]);
     ncopy_w[iw] = ncopy_pairs[iw].first;
   }
+  //the walkers sent without any copy left on this rank
+  for (auto& awalker : good_w_temp)
+    if (awalker)
+      bad_w.push_back(std::move(awalker));
   //add walkers from other rank
   if (newW.size())
   {
@@ -16,7 +16,10 @@ enum class QMCRunType
   WF_TEST,
   VMC_BATCH,
   DMC_BATCH,
-  LINEAR_OPTIMIZE_BATCH
+  RMC_BATCH,
+  CSVMC_BATCH,
+  LINEAR_OPTIMIZE_BATCH,
+  WF_TEST_BATCH
 };
 
 /** enum to set the bit to determine the QMC mode 
@@ -90,6 +90,14 @@ void DriftModifierUNR::getDrifts(RealType tau, const std::vector<GradType>& qf,
   }
 }
 
+void DriftModifierUNR::getDrifts(RealType tau,
+                                 const std::vector<ComplexType>& qf,
+                                 std::vector<ParticleSet::Scalar_t>& drift) const
+{
+  for (int i = 0; i < qf.size(); ++i)
+    getDrift(tau, qf[i], drift[i]);
+}
+
 bool DriftModifierUNR::parseXML(xmlNodePtr cur)
 {
   ParameterSet m_param;
@@ -25,6 +25,8 @@ public:
 
   void getDrifts(RealType tau, const std::vector<GradType>& qf, std::vector<PosType>&) const final;
 
+  void getDrifts(RealType tau, const std::vector<ComplexType>& qf, std::vector<ParticleSet::Scalar_t>& drift) const final;
+
   void getDrift(RealType tau, const GradType& qf, PosType& drift) const final;
 
   void getDrift(RealType tau, const ComplexType& qf, ParticleSet::Scalar_t& drift) const final;
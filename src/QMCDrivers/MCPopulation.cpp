@@ -17,9 +17,22 @@
 #include "Message/CommOperators.h"
 #include "QMCWaveFunctions/TrialWaveFunction.h"
 #include "QMCHamiltonians/QMCHamiltonian.h"
+#include "MemoryAccounting.h"
+#include "OMPTarget/ScopedDefaultDevice.h"
 
 namespace qmcplusplus
 {
+using WP = WalkerProperties::Indexes;
+
+/// bytes currently held by the accounted allocators in all the memory spaces
+static size_t getAccountedBytes()
+{
+  size_t bytes = 0;
+  for (const auto& stats : getMemoryAccounting().getStats())
+    bytes += stats.current;
+  return bytes;
+}
+
 MCPopulation::MCPopulation(int num_ranks,
                            int this_rank,
                            WalkerConfigurations& mcwc,
@@ -68,7 +81,10 @@ MCPopulation::~MCPopulation()
     saveWalkerConfigurations();
 }
 
-void MCPopulation::createWalkers(IndexType num_walkers, RealType reserve)
+void MCPopulation::createWalkers(IndexType num_walkers,
+                                 RealType reserve,
+                                 int num_crowds,
+                                 const std::vector<int>& crowd_device_nums)
 {
   IndexType num_walkers_plus_reserve = static_cast<IndexType>(num_walkers * reserve);
 
@@ -88,10 +104,17 @@ void MCPopulation::createWalkers(IndexType num_walkers, RealType reserve)
 
   outputManager.pause();
 
-  //this part is time consuming, it must be threaded and calls should be thread-safe.
-#pragma omp parallel for
-  for (size_t iw = 0; iw < num_walkers_plus_reserve; iw++)
-  {
+  auto createWalker = [this](size_t iw, WalkerBytes* bytes) {
+    // charges the bytes allocated since the previous call to an element, only when measuring alone
+    size_t accounted = bytes ? getAccountedBytes() : 0;
+    auto charge      = [bytes, &accounted](size_t WalkerBytes::*element) {
+      if (!bytes)
+        return;
+      const size_t now = getAccountedBytes();
+      bytes->*element  = now > accounted ? now - accounted : 0;
+      accounted        = now;
+    };
+
     walkers_[iw]             = std::make_unique<MCPWalker>(num_particles_);
     walkers_[iw]->R          = elec_particle_set_->R;
     walkers_[iw]->spins      = elec_particle_set_->spins;
@@ -101,15 +124,63 @@ void MCPopulation::createWalkers(IndexType num_walkers, RealType reserve)
 
     if (iw < walker_configs_ref_.WalkerList.size())
       *walkers_[iw] = *walker_configs_ref_[iw];
+    charge(&WalkerBytes::walker);
 
-    walker_elec_particle_sets_[iw]  = std::make_unique<ParticleSet>(*elec_particle_set_);
+    walker_elec_particle_sets_[iw] = std::make_unique<ParticleSet>(*elec_particle_set_);
+    charge(&WalkerBytes::particle_set);
     walker_trial_wavefunctions_[iw] = trial_wf_->makeClone(*walker_elec_particle_sets_[iw]);
+    charge(&WalkerBytes::trial_wavefunction);
     walker_hamiltonians_[iw] =
         hamiltonian_->makeClone(*walker_elec_particle_sets_[iw], *walker_trial_wavefunctions_[iw]);
+    charge(&WalkerBytes::hamiltonian);
+  };
+
+  auto crowdDeviceNum = [&crowd_device_nums](int crowd_id) {
+    return static_cast<size_t>(crowd_id) < crowd_device_nums.size() ? crowd_device_nums[crowd_id] : -1;
   };
 
+  // the first walker is created alone so that no other thread allocates while its elements are measured
+  // it is also the first walker of crowd 0, run by the master thread
+  if (num_walkers_plus_reserve > 0)
+  {
+    ScopedDefaultDevice device_scope(crowdDeviceNum(0));
+    createWalker(0, &walker_bytes_);
+  }
+
+  //this part is time consuming, it must be threaded and calls should be thread-safe.
+  size_t num_placed = 0;
+  if (num_crowds > 0)
+  {
+    // same split as redistributeWalkers, crowd i is run by thread i % num_threads of a pinned ParallelExecutor
+    const auto walkers_per_crowd = fairDivide(num_walkers, num_crowds);
+    std::vector<size_t> crowd_offsets(num_crowds + 1, 0);
+    std::partial_sum(walkers_per_crowd.begin(), walkers_per_crowd.end(), crowd_offsets.begin() + 1);
+#pragma omp parallel for schedule(static, 1)
+    for (int crowd_id = 0; crowd_id < num_crowds; crowd_id++)
+    {
+      ScopedDefaultDevice device_scope(crowdDeviceNum(crowd_id));
+      for (size_t iw = std::max<size_t>(crowd_offsets[crowd_id], 1); iw < crowd_offsets[crowd_id + 1]; iw++)
+        createWalker(iw, nullptr);
+    }
+    num_placed = crowd_offsets[num_crowds];
+  }
+
+#pragma omp parallel for
+  for (size_t iw = std::max<size_t>(num_placed, 1); iw < num_walkers_plus_reserve; iw++)
+    createWalker(iw, nullptr);
+
   outputManager.resume();
 
+  if (num_walkers_plus_reserve > 0)
+  {
+    auto kib = [](size_t bytes) { return bytes >> 10; };
+    app_log() << "  Memory of each walker held by the accounted allocators" << std::endl
+              << "    Walker            : " << kib(walker_bytes_.walker) << " KiB" << std::endl
+              << "    ParticleSet       : " << kib(walker_bytes_.particle_set) << " KiB" << std::endl
+              << "    TrialWaveFunction : " << kib(walker_bytes_.trial_wavefunction) << " KiB" << std::endl
+              << "    QMCHamiltonian    : " << kib(walker_bytes_.hamiltonian) << " KiB" << std::endl;
+  }
+
   int num_walkers_created = 0;
   for (auto& walker_ptr : walkers_)
   {
@@ -252,6 +323,66 @@ void MCPopulation::killWalker(MCPWalker& walker)
   throw std::runtime_error("Attempt to kill nonexistent walker in MCPopulation!");
 }
 
+MCPopulation::IndexType MCPopulation::killDeadWalkers()
+{
+  // compact the living walkers in place and append the dead ones to the dead lists, one pass over all the lists
+  const size_t num_walkers = walkers_.size();
+  size_t num_alive         = 0;
+  for (size_t iw = 0; iw < num_walkers; iw++)
+    if (static_cast<int>(walkers_[iw]->Multiplicity) == 0)
+    {
+      dead_walkers_.push_back(std::move(walkers_[iw]));
+      dead_walker_elec_particle_sets_.push_back(std::move(walker_elec_particle_sets_[iw]));
+      dead_walker_trial_wavefunctions_.push_back(std::move(walker_trial_wavefunctions_[iw]));
+      dead_walker_hamiltonians_.push_back(std::move(walker_hamiltonians_[iw]));
+    }
+    else
+    {
+      if (num_alive != iw)
+      {
+        walkers_[num_alive]                    = std::move(walkers_[iw]);
+        walker_elec_particle_sets_[num_alive]  = std::move(walker_elec_particle_sets_[iw]);
+        walker_trial_wavefunctions_[num_alive] = std::move(walker_trial_wavefunctions_[iw]);
+        walker_hamiltonians_[num_alive]        = std::move(walker_hamiltonians_[iw]);
+      }
+      num_alive++;
+    }
+  walkers_.resize(num_alive);
+  walker_elec_particle_sets_.resize(num_alive);
+  walker_trial_wavefunctions_.resize(num_alive);
+  walker_hamiltonians_.resize(num_alive);
+
+  const IndexType num_killed = num_walkers - num_alive;
+  num_local_walkers_ -= num_killed;
+  return num_killed;
+}
+
+void MCPopulation::syncBranchingData()
+{
+  const size_t num_walkers = walkers_.size();
+  branching_data_.weights.resize(num_walkers);
+  branching_data_.local_energies.resize(num_walkers);
+  branching_data_.r2_accepted.resize(num_walkers);
+  branching_data_.r2_proposed.resize(num_walkers);
+  branching_data_.multiplicities.resize(num_walkers);
+  for (size_t iw = 0; iw < num_walkers; iw++)
+  {
+    const MCPWalker& walker            = *walkers_[iw];
+    branching_data_.weights[iw]        = walker.Weight;
+    branching_data_.local_energies[iw] = walker.Properties(WP::LOCALENERGY);
+    branching_data_.r2_accepted[iw]    = walker.Properties(WP::R2ACCEPTED);
+    branching_data_.r2_proposed[iw]    = walker.Properties(WP::R2PROPOSED);
+    branching_data_.multiplicities[iw] = static_cast<int>(walker.Multiplicity);
+  }
+}
+
+void MCPopulation::applyMultiplicities()
+{
+  assert(branching_data_.multiplicities.size() == walkers_.size());
+  for (size_t iw = 0; iw < walkers_.size(); iw++)
+    walkers_[iw]->Multiplicity = branching_data_.multiplicities[iw];
+}
+
 void MCPopulation::syncWalkersPerRank(Communicate* comm)
 {
   std::vector<IndexType> num_local_walkers_per_rank(comm->size(), 0);
@@ -48,6 +48,32 @@ public:
   using FullPrecRealType   = QMCTraits::FullPrecRealType;
   using opt_variables_type = optimize::VariableSet;
 
+  /** the walker quantities read by the population control, in SoA layout
+   *
+   * Entry iw belongs to the living walker iw. The arrays are refreshed by syncBranchingData
+   * and the multiplicities are written back to the walkers by applyMultiplicities.
+   */
+  struct BranchingData
+  {
+    std::vector<FullPrecRealType> weights;
+    std::vector<FullPrecRealType> local_energies;
+    std::vector<FullPrecRealType> r2_accepted;
+    std::vector<FullPrecRealType> r2_proposed;
+    std::vector<int> multiplicities;
+  };
+
+  /** bytes held by each element of one walker, measured on the first walker created
+   *
+   * Only the memory of the allocators reporting to MemoryAccounting is counted, std::vector members are not.
+   */
+  struct WalkerBytes
+  {
+    size_t walker             = 0;
+    size_t particle_set       = 0;
+    size_t trial_wavefunction = 0;
+    size_t hamiltonian        = 0;
+  };
+
 private:
   // Potential thread safety issue
   MCDataType<QMCTraits::FullPrecRealType> ensemble_property_;
@@ -97,6 +123,12 @@ private:
   // reference to the captured WalkerConfigurations
   WalkerConfigurations& walker_configs_ref_;
 
+  /// SoA mirror of the living walkers for the branching
+  BranchingData branching_data_;
+
+  /// memory of the elements of a walker
+  WalkerBytes walker_bytes_;
+
 public:
   /** Temporary constructor to deal with MCWalkerConfiguration be the only source of some information
    *  in QMCDriverFactory.
@@ -123,14 +155,34 @@ public:
   WalkerElementsRef spawnWalker();
   void killWalker(MCPWalker&);
   void killLastWalker();
+  /** kill all the walkers with zero multiplicity in a single pass
+   *
+   *  The surviving walkers keep their order.
+   *  @return the number of killed walkers
+   */
+  IndexType killDeadWalkers();
   /** }@ */
 
+  /// gather the branching data of the living walkers
+  void syncBranchingData();
+  /// set the multiplicities of the living walkers from the branching data
+  void applyMultiplicities();
+
   /** Creates walkers with a clone of the golden electron particle set and golden trial wavefunction
    *
    *  \param[in] num_walkers number of living walkers in initial population
    *  \param[in] reserve multiple above that to reserve >=1.0
+   *  \param[in] num_crowds if positive, the walkers that redistributeWalkers hands to crowd i are created and
+   *             first touched by the thread running task i of a pinned ParallelExecutor
+   *  \param[in] crowd_device_nums if not empty, the walkers of crowd i are created with crowd_device_nums[i] as
+   *             the OpenMP default device, negative entries keeping the default device of the rank
+   *
+   *  The first walker is created alone and the memory of its elements is reported.
    */
-  void createWalkers(IndexType num_walkers, RealType reserve = 1.0);
+  void createWalkers(IndexType num_walkers,
+                     RealType reserve                          = 1.0,
+                     int num_crowds                            = 0,
+                     const std::vector<int>& crowd_device_nums = {});
 
   /** distributes walkers and their "cloned" elements to the elements of a vector
    *  of unique_ptr to "walker_consumers". 
@@ -139,12 +191,41 @@ public:
    *  void addWalker(MCPWalker& walker, ParticleSet& elecs, TrialWaveFunction& twf, QMCHamiltonian& hamiltonian);
    */
   template<typename WTTV>
-  void redistributeWalkers(WTTV& walker_consumers)
+  void redistributeWalkers(WTTV& walker_consumers, bool spread_touched = false)
   {
     // The type returned here is dependent on the integral type that the walker_consumers
     // use to return there size.
     auto walkers_per_crowd = fairDivide(walkers_.size(), walker_consumers.size());
 
+    if (spread_touched)
+    {
+      // walkers to be recomputed are dealt out first, so that each consumer gets its share of the expensive ones.
+      std::vector<std::vector<size_t>> walker_indexes(walker_consumers.size());
+      size_t consumer = 0;
+      auto deal = [&](size_t walker_index) {
+        while (walker_indexes[consumer].size() == walkers_per_crowd[consumer])
+          consumer = (consumer + 1) % walker_consumers.size();
+        walker_indexes[consumer].push_back(walker_index);
+        consumer = (consumer + 1) % walker_consumers.size();
+      };
+      for (size_t iw = 0; iw < walkers_.size(); ++iw)
+        if (walkers_[iw]->wasTouched)
+          deal(iw);
+      for (size_t iw = 0; iw < walkers_.size(); ++iw)
+        if (!walkers_[iw]->wasTouched)
+          deal(iw);
+
+      for (int i = 0; i < walker_consumers.size(); ++i)
+      {
+        walker_consumers[i]->clearWalkers();
+        for (size_t walker_index : walker_indexes[i])
+          walker_consumers[i]->addWalker(*walkers_[walker_index], *walker_elec_particle_sets_[walker_index],
+                                         *walker_trial_wavefunctions_[walker_index],
+                                         *walker_hamiltonians_[walker_index]);
+      }
+      return;
+    }
+
     auto walker_index = 0;
     for (int i = 0; i < walker_consumers.size(); ++i)
     {
@@ -205,6 +286,9 @@ public:
   }
 
   UPtrVector<MCPWalker>& get_walkers() { return walkers_; }
+  BranchingData& get_branching_data() { return branching_data_; }
+  const BranchingData& get_branching_data() const { return branching_data_; }
+  const WalkerBytes& get_walker_bytes() const { return walker_bytes_; }
   const UPtrVector<MCPWalker>& get_walkers() const { return walkers_; }
   const UPtrVector<MCPWalker>& get_dead_walkers() const { return dead_walkers_; }
 
@@ -24,7 +24,9 @@ enum class OptimizerType
   ADAPTIVE,
   DESCENT,
   HYBRID,
-  GRADIENT_TEST
+  GRADIENT_TEST,
+  SR,
+  PIPELINED_DESCENT
 };
 
 const std::map<std::string, OptimizerType> OptimizerNames = {{"quartic", OptimizerType::QUARTIC},
@@ -34,7 +36,9 @@ const std::map<std::string, OptimizerType> OptimizerNames = {{"quartic", Optimiz
                                                              {"adaptive", OptimizerType::ADAPTIVE},
                                                              {"descent", OptimizerType::DESCENT},
                                                              {"hybrid", OptimizerType::HYBRID},
-                                                             {"gradient_test", OptimizerType::GRADIENT_TEST}};
+                                                             {"gradient_test", OptimizerType::GRADIENT_TEST},
+                                                             {"sr", OptimizerType::SR},
+                                                             {"pipelined_descent", OptimizerType::PIPELINED_DESCENT}};
 
 } // namespace qmcplusplus
 #endif
@@ -58,12 +58,14 @@ QMCDriver::QMCDriver(MCWalkerConfiguration& w,
       driver_scope_timer_(*timer_manager.createTimer(QMC_driver_type, timer_level_coarse)),
       driver_scope_profiler_(enable_profiling)
 {
-  ResetRandom  = false;
-  AppendRun    = false;
-  DumpConfig   = false;
-  IsQMCDriver  = true;
-  allow_traces = false;
-  MyCounter    = 0;
+  ResetRandom         = false;
+  AppendRun           = false;
+  DumpConfig          = false;
+  AsyncCheckpoint     = false;
+  AggregateCheckpoint = false;
+  IsQMCDriver         = true;
+  allow_traces        = false;
+  MyCounter           = 0;
   //<parameter name=" "> value </parameter>
   //accept multiple names for the same value
   //recommend using all lower cases for a new parameter
@@ -227,6 +229,8 @@ void QMCDriver::process(xmlNodePtr cur)
   Estimators->put(H, cur);
   if (!wOut)
     wOut = std::make_unique<HDFWalkerOutput>(W.getTotalNum(), RootName, myComm);
+  wOut->setAsync(DumpConfig && AsyncCheckpoint);
+  wOut->setAggregated(DumpConfig && AggregateCheckpoint);
   branchEngine->start(RootName);
   branchEngine->write(RootName);
   //use new random seeds
@@ -336,6 +340,9 @@ bool QMCDriver::finalize(int block, bool dumpwalkers)
 {
   if (DumpConfig && dumpwalkers)
     wOut->dump(W, block);
+  // the configurations are complete at the end of the section
+  if (DumpConfig)
+    wOut->waitForDump();
   nTargetWalkers = W.getActiveWalkers();
   MyCounter++;
   infoSummary.flush();
@@ -412,6 +419,10 @@ void QMCDriver::setWalkerOffsets()
  *   -- 1 = do not write anything
  *   -- 0 = dump after the completion of a qmc section
  *   -- n = dump after n blocks
+ * - async_checkpoint="yes|no" default=no
+ *   -- yes = write the walker configurations of the checkpoints in the background
+ * - aggregate_checkpoint="yes|no" default=no
+ *   -- yes = write the walker configurations of the checkpoints to one subfile per node
  * - kdelay = "0|1|n" default=0
  */
 bool QMCDriver::putQMCInfo(xmlNodePtr cur)
@@ -434,10 +445,16 @@ bool QMCDriver::putQMCInfo(xmlNodePtr cur)
   kDelay = Psi.getndelay();
 #endif
   int defaultw = omp_get_max_threads();
+  std::string async_checkpoint("no");
+  std::string aggregate_checkpoint("no");
   OhmmsAttributeSet aAttrib;
   aAttrib.add(Period4CheckPoint, "checkpoint");
+  aAttrib.add(async_checkpoint, "async_checkpoint", {"no", "yes"});
+  aAttrib.add(aggregate_checkpoint, "aggregate_checkpoint", {"no", "yes"});
   aAttrib.add(kDelay, "kdelay");
   aAttrib.put(cur);
+  AsyncCheckpoint     = async_checkpoint == "yes";
+  AggregateCheckpoint = aggregate_checkpoint == "yes";
 #ifdef QMC_CUDA
   W.setkDelay(kDelay);
   kDelay = W.getkDelay(); // in case number is sanitized
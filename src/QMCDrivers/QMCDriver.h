@@ -211,6 +211,10 @@ protected:
   bool AppendRun;
   ///flag to turn off dumping configurations
   bool DumpConfig;
+  ///flag to write the walker configurations of the checkpoints in the background
+  bool AsyncCheckpoint;
+  ///flag to write the walker configurations of the checkpoints to one subfile per node
+  bool AggregateCheckpoint;
   ///true, if it is a real QMC engine
   bool IsQMCDriver;
   /** the number of times this QMCDriver is executed
@@ -34,9 +34,12 @@
 #include "QMCDrivers/DMC/DMCFactory.h"
 #include "QMCDrivers/DMC/DMCFactoryNew.h"
 #include "QMCDrivers/RMC/RMCFactory.h"
+#include "QMCDrivers/RMC/RMCFactoryNew.h"
+#include "QMCDrivers/CorrelatedSampling/CSVMCFactoryNew.h"
 #include "QMCDrivers/WFOpt/QMCFixedSampleLinearOptimize.h"
 #include "QMCDrivers/WFOpt/QMCFixedSampleLinearOptimizeBatched.h"
 #include "QMCDrivers/WaveFunctionTester.h"
+#include "QMCDrivers/WaveFunctionTesterBatched.h"
 #include "OhmmsData/AttributeSet.h"
 #include "OhmmsData/ParameterSet.h"
 #include "QMCDrivers/WFOpt/QMCWFOptFactoryNew.h"
@@ -124,7 +127,16 @@ QMCDriverFactory::DriverAssemblyState QMCDriverFactory::readSection(xmlNodePtr c
     //         das.new_run_type=RMC_PBYP_RUN;
     //       }
     //       else
-    if (qmc_mode.find("rmc") < nchars)
+    if (qmc_mode.find("csvmc_batch") < nchars) // order matters here
+    {
+      das.new_run_type              = QMCRunType::CSVMC_BATCH;
+      das.what_to_do[MULTIPLE_MODE] = 1;
+    }
+    else if (qmc_mode.find("rmc_batch") < nchars) // order matters here
+    {
+      das.new_run_type = QMCRunType::RMC_BATCH;
+    }
+    else if (qmc_mode.find("rmc") < nchars)
     {
       das.new_run_type = QMCRunType::RMC;
     }
@@ -144,6 +156,10 @@ QMCDriverFactory::DriverAssemblyState QMCDriverFactory::readSection(xmlNodePtr c
     {
       das.new_run_type = QMCRunType::DMC;
     }
+    else if (qmc_mode == wf_test_name + "_batch")
+    {
+      das.new_run_type = QMCRunType::WF_TEST_BATCH;
+    }
     else if (qmc_mode == wf_test_name)
     {
       das.new_run_type = QMCRunType::WF_TEST;
@@ -261,6 +277,20 @@ std::unique_ptr<QMCDriverInterface> QMCDriverFactory::createQMCDriver(xmlNodePtr
     RMCFactory fac(das.what_to_do[UPDATE_MODE], cur);
     new_driver.reset(fac.create(qmc_system, *primaryPsi, *primaryH, comm));
   }
+  else if (das.new_run_type == QMCRunType::RMC_BATCH)
+  {
+    RMCFactoryNew fac(cur);
+    new_driver.reset(fac.create(project_data_,
+                                MCPopulation(comm->size(), comm->rank(), qmc_system, &qmc_system, primaryPsi, wf_factory, primaryH),
+                                comm));
+  }
+  else if (das.new_run_type == QMCRunType::CSVMC_BATCH)
+  {
+    CSVMCFactoryNew fac(cur);
+    new_driver.reset(fac.create(project_data_,
+                                MCPopulation(comm->size(), comm->rank(), qmc_system, &qmc_system, primaryPsi, wf_factory, primaryH),
+                                comm));
+  }
   else if (das.new_run_type == QMCRunType::LINEAR_OPTIMIZE)
   {
 #ifdef MIXED_PRECISION
@@ -293,6 +323,20 @@ std::unique_ptr<QMCDriverInterface> QMCDriverFactory::createQMCDriver(xmlNodePtr
     QMCDriverInterface* temp_ptr = new WaveFunctionTester(qmc_system, *primaryPsi, *primaryH, particle_pool, comm);
     new_driver.reset(temp_ptr);
   }
+  else if (das.new_run_type == QMCRunType::WF_TEST_BATCH)
+  {
+#if defined(QMC_CUDA)
+    comm->barrier_and_abort("Batched wavefunction tester is not supported by legacy CUDA builds.");
+#endif
+    app_log() << "Testing the batched API of the wavefunction components." << std::endl;
+    QMCDriverInput qmcdriver_input;
+    qmcdriver_input.readXML(cur);
+    new_driver = std::make_unique<WaveFunctionTesterBatched>(project_data_, std::move(qmcdriver_input),
+                                                             MCPopulation(comm->size(), comm->rank(), qmc_system,
+                                                                          &qmc_system, primaryPsi, wf_factory,
+                                                                          primaryH),
+                                                             comm);
+  }
   else
   {
     APP_ABORT("Unhandled run type: " << static_cast<int>(das.new_run_type));
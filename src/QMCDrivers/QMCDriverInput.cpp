@@ -35,6 +35,14 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
   // so its better it not live long
 
   std::string serialize_walkers;
+  std::string zorder_electrons;
+  std::string numa_first_touch("no");
+  std::string crowd_devices("no");
+  std::string batched_acceptance("no");
+  std::string async_estimator_io;
+  std::string scalar_output("text");
+  std::string block_metrics("no");
+  std::string shorten_last_block("no");
   std::string debug_checks_str;
 
   ParameterSet parameter_set;
@@ -53,10 +61,18 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
   parameter_set.add(warmup_steps_, "warmupsteps");
   parameter_set.add(warmup_steps_, "warmup_steps");
   parameter_set.add(num_crowds_, "crowds");
+  parameter_set.add(crowd_threads_, "crowd_threads");
   parameter_set.add(serialize_walkers, "crowd_serialize_walkers", {"no", "yes"});
+  parameter_set.add(zorder_electrons, "zorder_electrons", {"no", "yes"});
+  parameter_set.add(numa_first_touch, "numa_first_touch", {"no", "yes", "report"});
+  parameter_set.add(crowd_devices, "crowd_devices", {"no", "yes"});
+  parameter_set.add(batched_acceptance, "batched_acceptance", {"no", "yes"});
+  parameter_set.add(spin_mass_, "spin_mass");
+  parameter_set.add(spin_mass_, "SpinMass");
   parameter_set.add(walkers_per_rank_, "walkers_per_rank");
   parameter_set.add(walkers_per_rank_, "walkers", {}, TagStatus::UNSUPPORTED);
   parameter_set.add(total_walkers_, "total_walkers");
+  parameter_set.add(walker_memory_budget_, "walker_memory_budget");
   parameter_set.add(steps_between_samples_, "stepsbetweensamples", {}, TagStatus::UNSUPPORTED);
   parameter_set.add(samples_per_thread_, "samplesperthread", {}, TagStatus::UNSUPPORTED);
   parameter_set.add(requested_samples_, "samples");
@@ -64,6 +80,13 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
   parameter_set.add(tau_, "time_step");
   parameter_set.add(tau_, "tau");
   parameter_set.add(blocks_between_recompute_, "blocks_between_recompute");
+  parameter_set.add(operator_reduction_period_, "operator_reduction_period");
+  parameter_set.add(async_estimator_io, "async_estimator_io", {"no", "yes"});
+  parameter_set.add(scalar_output, "scalar_output", {"text", "binary", "both"});
+  parameter_set.add(target_error_, "target_error");
+  parameter_set.add(shorten_last_block, "shorten_last_block", {"no", "yes"});
+  parameter_set.add(target_time_, "target_time");
+  parameter_set.add(block_metrics, "block_metrics", {"no", "yes"});
   parameter_set.add(drift_modifier_, "drift_modifier");
   parameter_set.add(drift_modifier_unr_a_, "drift_UNR_a");
   parameter_set.add(max_disp_sq_, "maxDisplSq");
@@ -123,6 +146,16 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
   crowd_serialize_walkers_ = serialize_walkers == "yes";
   if (crowd_serialize_walkers_)
     app_summary() << "  Batched operations are serialized over walkers." << std::endl;
+  zorder_electrons_   = zorder_electrons == "yes";
+  numa_first_touch_   = numa_first_touch != "no";
+  numa_report_        = numa_first_touch == "report";
+  crowd_devices_      = crowd_devices == "yes";
+  batched_acceptance_ = batched_acceptance == "yes";
+  async_estimator_io_ = async_estimator_io == "yes";
+  scalar_output_text_   = scalar_output != "binary";
+  scalar_output_binary_ = scalar_output != "text";
+  block_metrics_        = block_metrics == "yes";
+  shorten_last_block_   = shorten_last_block == "yes";
   if (scoped_profiling_)
     app_summary() << "  Profiler data collection is enabled in this driver scope." << std::endl;
 
@@ -140,6 +173,12 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
 
   if (check_point_period_.period < 1)
     check_point_period_.period = max_blocks_;
+  if (operator_reduction_period_ < 1)
+    throw std::runtime_error("Illegal input for operator_reduction_period, it must be positive");
+  if (target_error_ < 0)
+    throw std::runtime_error("Illegal input for target_error, it must not be negative");
+  if (target_time_ < 0)
+    throw std::runtime_error("Illegal input for target_time, it must not be negative");
 }
 
 } // namespace qmcplusplus
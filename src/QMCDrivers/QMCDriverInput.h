@@ -51,6 +51,18 @@ protected:
 
   /// if true, batched operations are serialized over walkers
   bool crowd_serialize_walkers_ = false;
+  /// if true, electrons of each walker are reordered along a Z-order curve at the driver startup
+  bool zorder_electrons_ = false;
+  /// if true, each crowd and its walkers are created and run by the same thread so their memory is NUMA local
+  bool numa_first_touch_ = false;
+  /// if true, the NUMA placement of the crowds is reported at the driver startup
+  bool numa_report_ = false;
+  /// if true, the crowds are spread over the devices of the rank, each crowd and its walkers living on one device
+  bool crowd_devices_ = false;
+  /// if true, the acceptance uniforms of a step are drawn in one batch with the displacements
+  bool batched_acceptance_ = false;
+  /// mass of the spin degree of freedom of spinor particle sets
+  RealType spin_mass_ = 1.0;
   /// period of dumping walker positions and IDs for Forward Walking (steps)
   int store_config_period_ = 0;
   /// period to recalculate the walker properties from scratch.
@@ -59,6 +71,8 @@ protected:
   input::PeriodStride config_dump_period_;
   IndexType starting_step_ = 0;
   IndexType num_crowds_    = 0;
+  /// threads of the nested parallel regions and BLAS calls of each crowd, 0 shares the spare threads among the crowds
+  IndexType crowd_threads_ = 0;
   // This is the global walkers it is a hard limit for VMC and the target for DMC
   IndexType total_walkers_     = 0;
   IndexType walkers_per_rank_  = 0;
@@ -74,6 +88,24 @@ protected:
   // call recompute at the end of each block in the full/mixed precision case.
   IndexType blocks_between_recompute_ = std::is_same<RealType, FullPrecisionRealType>::value ? 0 : 1;
   bool append_run_                    = false;
+  /// number of blocks accumulated by the operator estimators between two rank reductions
+  IndexType operator_reduction_period_ = 1;
+  /// if true, the estimator block records are written to stat.h5 on a background thread
+  bool async_estimator_io_ = false;
+  /// write the scalar block records and the DMC population records as text, scalar.dat and dmc.dat
+  bool scalar_output_text_ = true;
+  /// write the same records as binary tables, scalar.bin and dmc.bin
+  bool scalar_output_binary_ = false;
+  /// stop once the reblocked error of the block energies is below this, 0 disables it
+  RealType target_error_ = 0.0;
+  /// if true, the last block is shortened to end before the walltime limit instead of being skipped
+  bool shorten_last_block_ = false;
+  /// seconds the driver should take, the steps per block are scaled to end the blocks in time, 0 disables it
+  RealType target_time_ = 0.0;
+  /// write the throughput and the time split of each block as a JSON line to metrics.jsonl
+  bool block_metrics_ = false;
+  /// memory budget in MiB of the multi walker resources on each rank, 0 means no limit
+  IndexType walker_memory_budget_ = 0;
 
   // from QMCDriverFactory
   std::string qmc_method_{"invalid"};
@@ -102,8 +134,10 @@ public:
   input::PeriodStride get_config_dump_period() const { return config_dump_period_; }
   IndexType get_starting_step() const { return starting_step_; }
   IndexType get_num_crowds() const { return num_crowds_; }
+  IndexType get_crowd_threads() const { return crowd_threads_; }
   IndexType get_walkers_per_rank() const { return walkers_per_rank_; }
   IndexType get_total_walkers() const { return total_walkers_; }
+  IndexType get_walker_memory_budget() const { return walker_memory_budget_; }
   IndexType get_requested_samples() const { return requested_samples_; }
   IndexType get_sub_steps() const { return sub_steps_; }
   RealType get_max_disp_sq() const { return max_disp_sq_; }
@@ -114,6 +148,14 @@ public:
   IndexType get_samples_per_thread() const { return samples_per_thread_; }
   RealType get_tau() const { return tau_; }
   IndexType get_blocks_between_recompute() const { return blocks_between_recompute_; }
+  IndexType get_operator_reduction_period() const { return operator_reduction_period_; }
+  bool get_async_estimator_io() const { return async_estimator_io_; }
+  bool get_scalar_output_text() const { return scalar_output_text_; }
+  bool get_scalar_output_binary() const { return scalar_output_binary_; }
+  RealType get_target_error() const { return target_error_; }
+  bool get_shorten_last_block() const { return shorten_last_block_; }
+  RealType get_target_time() const { return target_time_; }
+  bool get_block_metrics() const { return block_metrics_; }
   bool get_append_run() const { return append_run_; }
   input::PeriodStride get_walker_dump_period() const { return walker_dump_period_; }
   input::PeriodStride get_check_point_period() const { return check_point_period_; }
@@ -126,6 +168,12 @@ public:
   DriverDebugChecks get_debug_checks() const { return debug_checks_; }
   bool get_scoped_profiling() const { return scoped_profiling_; }
   bool are_walkers_serialized() const { return crowd_serialize_walkers_; }
+  bool get_zorder_electrons() const { return zorder_electrons_; }
+  bool get_numa_first_touch() const { return numa_first_touch_; }
+  bool get_numa_report() const { return numa_report_; }
+  bool get_crowd_devices() const { return crowd_devices_; }
+  bool get_batched_acceptance() const { return batched_acceptance_; }
+  RealType get_spin_mass() const { return spin_mass_; }
 
   const std::string get_drift_modifier() const { return drift_modifier_; }
   RealType get_drift_modifier_unr_a() const { return drift_modifier_unr_a_; }
@@ -14,6 +14,7 @@
 #include <cmath>
 #include <sstream>
 #include <numeric>
+#include <iomanip>
 
 #include "QMCDriverNew.h"
 #include "Concurrency/ParallelExecutor.hpp"
@@ -24,14 +25,22 @@
 #include "OhmmsData/AttributeSet.h"
 #include "Message/Communicate.h"
 #include "Message/CommOperators.h"
+#include "Message/CommProfile.h"
 #include "RandomNumberControl.h"
 #include "Estimators/EstimatorManagerNew.h"
 #include "hdf/HDFVersion.h"
 #include "Utilities/qmc_common.h"
+#include "Utilities/StartupProfile.h"
 #include "Concurrency/Info.hpp"
 #include "QMCDrivers/GreenFunctionModifiers/DriftModifierBuilder.h"
+#include "QMCDrivers/SFNBranch.h"
 #include "Utilities/StlPrettyPrint.hpp"
 #include "Message/UniformCommunicateError.h"
+#include "Platforms/Host/sysutil.h"
+#include "CPU/BlasThreadingEnv.h"
+#include "Utilities/TimerTrace.h"
+#include "DeviceManager.h"
+#include "OMPTarget/ScopedDefaultDevice.h"
 
 namespace qmcplusplus
 {
@@ -72,6 +81,14 @@ QMCDriverNew::QMCDriverNew(const ProjectData& project_data,
     auto& lattice = population.get_golden_electrons()->getLattice();
     max_disp_sq_  = lattice.LR_rc * lattice.LR_rc;
   }
+
+  if (qmcdriver_input_.get_block_metrics())
+  {
+    block_metrics_ = std::make_unique<BlockMetrics<>>();
+    block_metrics_->addCategory("wavefunction", {timers_.movepbyp_timer, timers_.buffer_timer});
+    block_metrics_->addCategory("hamiltonian", {timers_.hamiltonian_timer});
+    block_metrics_->addCategory("estimators", {timers_.collectables_timer, timers_.estimators_timer});
+  }
 }
 
 // The Rng pointers are transferred from global storage (RandomNumberControl::Children)
@@ -105,6 +122,32 @@ void QMCDriverNew::checkNumCrowdsLTNumThreads(const int num_crowds)
   }
 }
 
+int QMCDriverNew::determineThreadsPerCrowd(int requested, int num_crowds)
+{
+  const int num_threads(Concurrency::maxCapacity<>());
+  if (requested == 0)
+    return std::max(1, num_threads / std::max(1, num_crowds));
+  if (requested < 0 || requested * num_crowds > num_threads)
+  {
+    std::stringstream error_msg;
+    error_msg << "Bad Input: crowd_threads (" << requested << ") times num_crowds (" << num_crowds
+              << ") must be positive and not exceed num_threads (" << num_threads << ")\n";
+    throw UniformCommunicateError(error_msg.str());
+  }
+  return requested;
+}
+
+std::vector<int> QMCDriverNew::assignCrowdDevices(const std::vector<int>& device_nums, int num_crowds)
+{
+  std::vector<int> crowd_device_nums(num_crowds, -1);
+  if (device_nums.empty())
+    return crowd_device_nums;
+  // crowd 0 creates the first walker with the golden objects, so it stays on the default device
+  for (int i = 0; i < num_crowds; ++i)
+    crowd_device_nums[i] = device_nums[static_cast<size_t>(i) * device_nums.size() / num_crowds];
+  return crowd_device_nums;
+}
+
 /** process a <qmc/> element
  * @param cur xmlNode with qmc tag
  *
@@ -122,42 +165,95 @@ void QMCDriverNew::checkNumCrowdsLTNumThreads(const int num_crowds)
  */
 void QMCDriverNew::startup(xmlNodePtr cur, const QMCDriverNew::AdjustedWalkerCounts& awc)
 {
+  const int num_crowds = awc.walkers_per_crowd.size();
+  threads_per_crowd_   = determineThreadsPerCrowd(qmcdriver_input_.get_crowd_threads(), num_crowds);
+
   app_summary() << QMCType << " Driver running with" << std::endl
                 << "             total_walkers     = " << awc.global_walkers << std::endl
                 << "             walkers_per_rank  = " << awc.walkers_per_rank << std::endl
-                << "             num_crowds        = " << awc.walkers_per_crowd.size() << std::endl
+                << "             num_crowds        = " << num_crowds << std::endl
+                << "             threads_per_crowd = " << threads_per_crowd_ << std::endl
                 << "  on rank 0, walkers_per_crowd = " << awc.walkers_per_crowd << std::endl
                 << std::endl;
+  reportThreadLayout(num_crowds);
+
+  // each crowd, its walkers and its resources live on one device
+  std::vector<int> crowd_device_nums(num_crowds, -1);
+  if (qmcdriver_input_.get_crowd_devices())
+  {
+    crowd_device_nums = assignCrowdDevices(DeviceManager::getGlobal().getDeviceNums(), num_crowds);
+    app_log() << "  Devices of the crowds on rank " << myComm->rank() << ": " << crowd_device_nums << std::endl;
+  }
 
   // set num_global_walkers explicitly and then make local walkers.
   population_.set_num_global_walkers(awc.global_walkers);
 
+  const bool place_walkers = qmcdriver_input_.get_numa_first_touch() || qmcdriver_input_.get_crowd_devices();
   makeLocalWalkers(awc.walkers_per_rank[myComm->rank()], awc.reserve_walkers,
-                   ParticleAttrib<TinyVector<QMCTraits::RealType, 3>>(population_.get_num_particles()));
+                   ParticleAttrib<TinyVector<QMCTraits::RealType, 3>>(population_.get_num_particles()),
+                   place_walkers ? num_crowds : 0, crowd_device_nums);
+
+  // walkers are evaluated from scratch by initialLogEvaluation, so reordering needs no other update
+  if (qmcdriver_input_.get_zorder_electrons())
+  {
+    app_log() << "  Reordering the electrons of each walker along a Z-order curve" << std::endl;
+    for (auto& walker : population_.get_walkers())
+      population_.get_golden_electrons()->sortWalkerByZOrder(*walker);
+  }
 
   estimator_manager_->put(population_.get_golden_hamiltonian(), *population_.get_golden_electrons(),
                           population_.get_golden_twf(), population_.get_wf_factory(), cur);
+  estimator_manager_->setOperatorReductionPeriod(qmcdriver_input_.get_operator_reduction_period());
+  estimator_manager_->setAsyncIO(qmcdriver_input_.get_async_estimator_io());
+  estimator_manager_->setScalarOutput(qmcdriver_input_.get_scalar_output_text(),
+                                      qmcdriver_input_.get_scalar_output_binary());
+  estimator_manager_->setTargetEnergyError(qmcdriver_input_.get_target_error());
 
   if (dispatchers_.are_walkers_batched())
   {
     app_debug() << "Creating multi walker shared resources" << std::endl;
-    population_.get_golden_electrons()->createResource(golden_resource_.pset_res);
-    population_.get_golden_twf().createResource(golden_resource_.twf_res);
-    population_.get_golden_hamiltonian().createResource(golden_resource_.ham_res);
+    {
+      ScopedStartupPhase phase("QMCDriverNew::CreateResources");
+      population_.get_golden_electrons()->createResource(golden_resource_.pset_res);
+      population_.get_golden_twf().createResource(golden_resource_.twf_res);
+      population_.get_golden_hamiltonian().createResource(golden_resource_.ham_res);
+    }
     app_debug() << "Multi walker shared resources creation completed" << std::endl;
+    const size_t bytes_per_walker = golden_resource_.pset_res.getMemoryPerWalker() +
+        golden_resource_.twf_res.getMemoryPerWalker() + golden_resource_.ham_res.getMemoryPerWalker();
+    app_summary() << "  Multi walker shared resources need " << (bytes_per_walker >> 10) << " KiB per walker, "
+                  << ((bytes_per_walker * awc.walkers_per_rank[myComm->rank()]) >> 20) << " MiB on this rank"
+                  << std::endl;
   }
 
-  crowds_.resize(awc.walkers_per_crowd.size());
+  crowds_.resize(num_crowds);
 
   // at this point we can finally construct the Crowd objects.
-  for (int i = 0; i < crowds_.size(); ++i)
+  if (qmcdriver_input_.get_numa_first_touch())
   {
-    crowds_[i] = std::make_unique<Crowd>(*estimator_manager_, golden_resource_, dispatchers_);
+    // the crowd resources are cloned by the thread that runs the crowd in the pinned crowd tasks
+    outputManager.pause();
+#pragma omp parallel for schedule(static, 1)
+    for (int i = 0; i < crowds_.size(); ++i)
+    {
+      ScopedDefaultDevice device_scope(crowd_device_nums[i]);
+      crowds_[i] = std::make_unique<Crowd>(*estimator_manager_, golden_resource_, dispatchers_, crowd_device_nums[i]);
+    }
+    outputManager.resume();
   }
+  else
+    for (int i = 0; i < crowds_.size(); ++i)
+    {
+      ScopedDefaultDevice device_scope(crowd_device_nums[i]);
+      crowds_[i] = std::make_unique<Crowd>(*estimator_manager_, golden_resource_, dispatchers_, crowd_device_nums[i]);
+    }
 
   //now give walkers references to their walkers
   population_.redistributeWalkers(crowds_);
 
+  if (qmcdriver_input_.get_numa_report())
+    reportNUMAPlacement();
+
   // Once they are created move contexts can be created.
   createRngsStepContexts(crowds_.size());
 }
@@ -220,6 +316,7 @@ void QMCDriverNew::recordBlock(int block)
   if (qmcdriver_input_.get_dump_config() && block % qmcdriver_input_.get_check_point_period().period == 0)
   {
     timers_.checkpoint_timer.start();
+    estimator_manager_->waitForWrites();
     RandomNumberControl::write(root_name_, myComm);
     timers_.checkpoint_timer.stop();
   }
@@ -227,23 +324,29 @@ void QMCDriverNew::recordBlock(int block)
 
 bool QMCDriverNew::finalize(int block, bool dumpwalkers)
 {
+  timer_trace.stopBlocks();
   RefVector<MCPWalker> walkers(convertUPtrToRefVector(population_.get_walkers()));
 
   if (qmcdriver_input_.get_dump_config())
+  {
+    estimator_manager_->waitForWrites();
     RandomNumberControl::write(root_name_, myComm);
+  }
 
   return true;
 }
 
 void QMCDriverNew::makeLocalWalkers(IndexType nwalkers,
                                     RealType reserve,
-                                    const ParticleAttrib<TinyVector<QMCTraits::RealType, 3>>& positions)
+                                    const ParticleAttrib<TinyVector<QMCTraits::RealType, 3>>& positions,
+                                    int num_crowds,
+                                    const std::vector<int>& crowd_device_nums)
 {
   ScopedTimer local_timer(timers_.create_walkers_timer);
   // ensure nwalkers local walkers in population_
   if (population_.get_walkers().size() == 0)
   {
-    population_.createWalkers(nwalkers, reserve);
+    population_.createWalkers(nwalkers, reserve, num_crowds, crowd_device_nums);
   }
   else if (population_.get_walkers().size() < nwalkers)
   {
@@ -273,6 +376,59 @@ void QMCDriverNew::makeLocalWalkers(IndexType nwalkers,
   // ////myComm->allreduce(nw);
 }
 
+void QMCDriverNew::reportThreadLayout(int num_crowds) const
+{
+  const int num_threads(Concurrency::maxCapacity<>());
+  app_log() << "  Thread layout: " << num_crowds << " crowds x " << threads_per_crowd_ << " threads of "
+            << num_threads << " OpenMP threads" << std::endl;
+  if (threads_per_crowd_ > 1)
+  {
+    if (BlasThreadingEnv::NestedThreadingSupported())
+      app_log() << "    The BLAS calls of each crowd run on its " << threads_per_crowd_ << " threads." << std::endl;
+    else
+      app_log() << "    The BLAS library threads are not set per crowd, the large determinant updates of each crowd"
+                << " are threaded with OpenMP on its " << threads_per_crowd_ << " threads." << std::endl;
+  }
+  if (num_crowds * threads_per_crowd_ < num_threads)
+    app_log() << "    " << num_threads - num_crowds * threads_per_crowd_ << " OpenMP threads are idle." << std::endl;
+}
+
+void QMCDriverNew::reportNUMAPlacement()
+{
+  struct CrowdPlacement
+  {
+    int thread = -1;
+    int cpu    = -1;
+    int node   = -1;
+    // walkers whose electron positions are on the node of the crowd thread
+    int local_walkers = 0;
+  };
+  std::vector<CrowdPlacement> placements(crowds_.size());
+  // same mapping of crowds to threads as the crowd tasks of the driver
+  ParallelExecutor<> placement_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
+  placement_task(crowds_.size(), [this, &placements](int crowd_id) {
+    CrowdPlacement& placement = placements[crowd_id];
+    placement.thread          = omp_get_thread_num();
+    placement.cpu             = getCurrentCPU();
+    placement.node            = getCurrentNUMANode();
+    for (const ParticleSet& pset : crowds_[crowd_id]->get_walker_elecs())
+      if (placement.node >= 0 && getMemoryNUMANode(pset.R.data()) == placement.node)
+        placement.local_walkers++;
+  });
+
+  app_log() << "  NUMA placement of the crowds on rank " << myComm->rank() << std::endl
+            << "    crowd  thread     cpu    node  walkers on node" << std::endl;
+  for (int i = 0; i < crowds_.size(); ++i)
+  {
+    const CrowdPlacement& placement = placements[i];
+    app_log() << "    " << std::setw(5) << i << std::setw(8) << placement.thread << std::setw(8) << placement.cpu
+              << std::setw(8) << placement.node << std::setw(9) << placement.local_walkers << "/"
+              << crowds_[i]->size() << std::endl;
+  }
+  if (!placements.empty() && placements[0].node < 0)
+    app_log() << "    NUMA nodes are not available on this system." << std::endl;
+}
+
 /** Creates Random Number generators for crowds and step contexts
  *
  *  This is quite dangerous in that number of crowds can be > omp_get_max_threads()
@@ -307,6 +463,7 @@ void QMCDriverNew::initialLogEvaluation(int crowd_id,
   if (crowd.size() == 0)
     return;
 
+  ScopedDefaultDevice device_scope(crowd.getDeviceNum());
   crowd.setRNGForHamiltonian(context_for_steps[crowd_id]->get_random_gen());
   auto& ps_dispatcher  = crowd.dispatchers_.ps_dispatcher_;
   auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
@@ -406,7 +563,9 @@ QMCDriverNew::AdjustedWalkerCounts QMCDriverNew::adjustGlobalWalkerCount(int num
                                                                          IndexType required_total,
                                                                          IndexType walkers_per_rank,
                                                                          RealType reserve_walkers,
-                                                                         int num_crowds)
+                                                                         int num_crowds,
+                                                                         size_t memory_per_walker,
+                                                                         size_t memory_budget)
 {
   // Step 1. set num_crowds by input and Concurrency::maxCapacity<>()
   checkNumCrowdsLTNumThreads(num_crowds);
@@ -415,6 +574,20 @@ QMCDriverNew::AdjustedWalkerCounts QMCDriverNew::adjustGlobalWalkerCount(int num
 
   AdjustedWalkerCounts awc{0, {}, {}, reserve_walkers};
 
+  // the largest walkers_per_crowd allowed by the memory budget, 0 means no limit
+  IndexType max_walkers_per_crowd = 0;
+  if (memory_budget > 0 && memory_per_walker > 0)
+  {
+    max_walkers_per_crowd = memory_budget / (memory_per_walker * num_crowds);
+    if (max_walkers_per_crowd == 0)
+    {
+      std::ostringstream error;
+      error << "The memory budget of " << (memory_budget >> 20) << " MiB cannot hold a single walker in each of the "
+            << num_crowds << " crowds. Each walker needs " << memory_per_walker << " bytes of multi walker resources.";
+      throw UniformCommunicateError(error.str());
+    }
+  }
+
   // Step 2. decide awc.global_walkers and awc.walkers_per_rank based on input values
   if (required_total != 0)
   {
@@ -439,6 +612,8 @@ QMCDriverNew::AdjustedWalkerCounts QMCDriverNew::adjustGlobalWalkerCount(int num
   {
     if (walkers_per_rank != 0)
       awc.walkers_per_rank = std::vector<IndexType>(num_ranks, walkers_per_rank);
+    else if (max_walkers_per_crowd != 0)
+      awc.walkers_per_rank = std::vector<IndexType>(num_ranks, num_crowds * max_walkers_per_crowd);
     else
       awc.walkers_per_rank = std::vector<IndexType>(num_ranks, num_crowds);
     awc.global_walkers = awc.walkers_per_rank[0] * num_ranks;
@@ -455,15 +630,29 @@ QMCDriverNew::AdjustedWalkerCounts QMCDriverNew::adjustGlobalWalkerCount(int num
     app_warning() << "Walkers per rank (" << awc.walkers_per_rank[rank_id] << ") not divisible by number of crowds ("
                   << num_crowds << "). This will result in a loss of efficiency.\n";
 
+  if (max_walkers_per_crowd != 0 && awc.walkers_per_crowd[0] > max_walkers_per_crowd)
+    app_warning() << "Walkers per crowd (" << awc.walkers_per_crowd[0] << ") exceeds " << max_walkers_per_crowd
+                  << " allowed by the walker memory budget of " << (memory_budget >> 20) << " MiB.\n";
+
   // \todo some warning if unreasonable number of threads are being used.
 
   return awc;
 }
 
+size_t QMCDriverNew::getMultiWalkerMemoryPerWalker()
+{
+  DriverWalkerResourceCollection probe_resource;
+  population_.get_golden_electrons()->createResource(probe_resource.pset_res);
+  population_.get_golden_twf().createResource(probe_resource.twf_res);
+  population_.get_golden_hamiltonian().createResource(probe_resource.ham_res);
+  return probe_resource.pset_res.getMemoryPerWalker() + probe_resource.twf_res.getMemoryPerWalker() +
+      probe_resource.ham_res.getMemoryPerWalker();
+}
+
 /** The scalar estimator collection is quite strange
  *
  */
-void QMCDriverNew::endBlock()
+void QMCDriverNew::endBlock(IndexType block_steps)
 {
   RefVector<ScalarEstimatorBase> all_scalar_estimators;
 
@@ -501,6 +690,72 @@ void QMCDriverNew::endBlock()
   /// cpu_block_time /= crowds_.size();
 
   estimator_manager_->stopBlock(block_accept, block_reject, total_block_weight);
+
+  if (block_metrics_)
+  {
+    const double walker_steps = population_.get_num_local_walkers() * block_steps;
+    std::vector<double> counts{walker_steps, static_cast<double>(block_accept + block_reject),
+                               static_cast<double>(block_accept)};
+    myComm->allreduce(counts);
+    auto record =
+        block_metrics_->stopBlock(counts[0] * qmcdriver_input_.get_sub_steps(), counts[1], counts[2], counts[0]);
+    if (comm_profile.isEnabled())
+    {
+      record.rank_comm_times.assign(myComm->size(), 0.0);
+      record.rank_comm_times[myComm->rank()] = record.comm_time;
+      myComm->allreduce(record.rank_comm_times);
+    }
+    if (myComm->rank() == 0)
+    {
+      if (!block_metrics_out_)
+        block_metrics_out_ = std::make_unique<std::ofstream>(myComm->getName() + ".metrics.jsonl", std::ios::app);
+      block_metrics_->writeJSON(*block_metrics_out_, QMCType, record);
+    }
+  }
+}
+
+bool QMCDriverNew::checkStop(RunTimeControl<>& runtime_control,
+                             LoopTimer<>& loop_timer,
+                             double finish_time,
+                             int blocks_left,
+                             IndexType& block_steps)
+{
+  bool stop_requested = false;
+  int next_steps      = qmcdriver_input_.get_max_steps();
+  if (!myComm->rank())
+  {
+    if (qmcdriver_input_.get_target_time() > 0)
+      next_steps = runtime_control.getStepsToFinishAt(loop_timer, finish_time, blocks_left, next_steps);
+    if (qmcdriver_input_.get_shorten_last_block())
+    {
+      const int full_steps = next_steps;
+      stop_requested       = runtime_control.checkStop(loop_timer, next_steps);
+      if (!stop_requested && next_steps < full_steps)
+        app_log() << "  " << QMCType << " shortens the next block to " << next_steps << " steps to end before the "
+                  << "time limit" << std::endl;
+    }
+    else
+      stop_requested = runtime_control.checkStop(loop_timer);
+  }
+  myComm->bcast(stop_requested);
+  myComm->bcast(next_steps);
+  block_steps = next_steps;
+  return stop_requested;
+}
+
+bool QMCDriverNew::isTargetErrorReached(const std::string& driver_name, int block)
+{
+  if (qmcdriver_input_.get_target_error() <= 0)
+    return false;
+  bool reached = false;
+  if (!myComm->rank())
+    reached = estimator_manager_->isTargetEnergyErrorReached();
+  myComm->bcast(reached);
+  if (reached && !myComm->rank())
+    app_log() << "  " << driver_name << " stops after block " << block << ", the reblocked energy error "
+              << estimator_manager_->getEnergyError() << " is below target_error " << qmcdriver_input_.get_target_error()
+              << std::endl;
+  return reached;
 }
 
 void QMCDriverNew::checkLogAndGL(Crowd& crowd, const std::string_view location)
@@ -573,4 +828,130 @@ void QMCDriverNew::checkLogAndGL(Crowd& crowd, const std::string_view location)
     throw std::runtime_error(std::string("checkLogAndGL failed at ") + std::string(location) + std::string("\n"));
 }
 
+void QMCDriverNew::moveAllElectrons(Crowd& crowd,
+                                    ContextForSteps& step_context,
+                                    const DriftModifierBase& drift_modifier,
+                                    const std::vector<RealType>& ptclgrp_inv_mass,
+                                    RealType tau,
+                                    bool use_drift,
+                                    const SFNBranch* branch_engine,
+                                    int sub_steps,
+                                    std::vector<RealType>& rr_proposed,
+                                    std::vector<RealType>& rr_accepted)
+{
+  using WP             = WalkerProperties::Indexes;
+  using PosType        = QMCTraits::PosType;
+  auto& ps_dispatcher  = crowd.dispatchers_.ps_dispatcher_;
+  auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
+  auto& walkers        = crowd.get_walkers();
+  const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
+  const RefVectorWithLeader<TrialWaveFunction> walker_twfs(crowd.get_walker_twfs()[0], crowd.get_walker_twfs());
+  if (walker_elecs.getLeader().isSpinor())
+    throw std::runtime_error("QMCDriverNew::moveAllElectrons all-electron moves do not move spins, use move=\"pbyp\"");
+
+  const int num_walkers   = crowd.size();
+  const int num_particles = walker_elecs.getLeader().getTotalNum();
+
+  // the walker properties are only refreshed once the hamiltonian is evaluated, the log value and the phase
+  // of the current configurations are followed here across the sub-steps
+  std::vector<FullPrecRealType> log_psi(num_walkers);
+  std::vector<FullPrecRealType> phase(num_walkers);
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    log_psi[iw] = walkers[iw].get().Properties(WP::LOGPSI);
+    phase[iw]   = walkers[iw].get().Properties(WP::SIGN);
+  }
+
+  std::vector<ParticleSet::ParticlePos> old_positions(num_walkers);
+  std::vector<RealType> log_gf(num_walkers);
+  std::vector<RealType> log_gb(num_walkers);
+  std::vector<RealType> rr(num_walkers);
+  PosType drift_iat;
+
+  for (int sub_step = 0; sub_step < sub_steps; ++sub_step)
+  {
+    step_context.nextDeltaRs(num_walkers * num_particles);
+    auto it_delta_r = step_context.deltaRsBegin();
+    std::fill(log_gf.begin(), log_gf.end(), 0.0);
+    std::fill(log_gb.begin(), log_gb.end(), 0.0);
+    std::fill(rr.begin(), rr.end(), 0.0);
+
+    // the forward move drifts with the gradients of the current positions
+    for (int iw = 0; iw < num_walkers; ++iw)
+    {
+      ParticleSet& elecs = walker_elecs[iw];
+      old_positions[iw]  = elecs.R;
+      for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+      {
+        const RealType tauovermass = tau * ptclgrp_inv_mass[ig];
+        const RealType sqrttau     = std::sqrt(tauovermass);
+        for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+        {
+          // fastest in walkers then particles like the deltas of the particle-by-particle moves
+          const PosType& delta_r = *(it_delta_r + iat * num_walkers + iw);
+          if (use_drift)
+          {
+            drift_modifier.getDrift(tauovermass, elecs.G[iat], drift_iat);
+            log_gf[iw] -= 0.5 * dot(delta_r, delta_r);
+          }
+          else
+            drift_iat = 0.0;
+          elecs.R[iat] += drift_iat + sqrttau * delta_r;
+          rr[iw] += tauovermass * dot(delta_r, delta_r);
+        }
+      }
+    }
+
+    ps_dispatcher.flex_update(walker_elecs);
+    twf_dispatcher.flex_evaluateLog(walker_twfs, walker_elecs);
+
+    RefVectorWithLeader<ParticleSet> rejected_elecs(walker_elecs.getLeader());
+    RefVectorWithLeader<TrialWaveFunction> rejected_twfs(walker_twfs.getLeader());
+    for (int iw = 0; iw < num_walkers; ++iw)
+    {
+      ParticleSet& elecs     = walker_elecs[iw];
+      TrialWaveFunction& twf = walker_twfs[iw];
+      // the backward move drifts with the gradients of the proposed positions
+      if (use_drift)
+        for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+        {
+          const RealType tauovermass = tau * ptclgrp_inv_mass[ig];
+          const RealType oneover2tau = 0.5 / tauovermass;
+          for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+          {
+            drift_modifier.getDrift(tauovermass, elecs.G[iat], drift_iat);
+            const PosType dr = old_positions[iw][iat] - elecs.R[iat] - drift_iat;
+            log_gb[iw] -= oneover2tau * dot(dr, dr);
+          }
+        }
+      rr_proposed[iw] += rr[iw];
+
+      const bool phase_changed = branch_engine && branch_engine->phaseChanged(twf.getPhase() - phase[iw]);
+      const RealType prob      = std::exp(2.0 * (twf.getLogPsi() - log_psi[iw]) + log_gb[iw] - log_gf[iw]);
+      if (!phase_changed && step_context.get_random_gen()() < prob)
+      {
+        crowd.incAccept();
+        rr_accepted[iw] += rr[iw];
+        log_psi[iw] = twf.getLogPsi();
+        phase[iw]   = twf.getPhase();
+      }
+      else
+      {
+        // log_psi and phase keep the values of the restored configuration
+        crowd.incReject();
+        elecs.R = old_positions[iw];
+        rejected_elecs.push_back(elecs);
+        rejected_twfs.push_back(twf);
+      }
+    }
+
+    // the rejected walkers are evaluated again at their old positions
+    if (rejected_elecs.size() > 0)
+    {
+      ps_dispatcher.flex_update(rejected_elecs);
+      twf_dispatcher.flex_evaluateLog(rejected_twfs, rejected_elecs);
+    }
+  }
+}
+
 } // namespace qmcplusplus
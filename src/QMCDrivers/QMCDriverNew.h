@@ -27,16 +27,19 @@
 #define QMCPLUSPLUS_QMCDRIVERNEW_H
 
 #include <type_traits>
+#include <fstream>
 
 #include "Configuration.h"
 #include "Pools/PooledData.h"
 #include "Utilities/TimerManager.h"
 #include "Utilities/ScopedProfiler.h"
+#include "Utilities/RunTimeManager.h"
 #include "QMCDrivers/MCPopulation.h"
 #include "QMCDrivers/QMCDriverInterface.h"
 #include "QMCDrivers/GreenFunctionModifiers/DriftModifierBase.h"
 #include "QMCDrivers/QMCDriverInput.h"
 #include "QMCDrivers/ContextForSteps.h"
+#include "QMCDrivers/BlockMetrics.h"
 #include "ProjectData.h"
 #include "MultiWalkerDispatchers.h"
 #include "DriverWalkerTypes.h"
@@ -51,6 +54,7 @@ class TraceManager;
 class EstimatorManagerNew;
 class TrialWaveFunction;
 class QMCHamiltonian;
+class SFNBranch;
 
 namespace testing
 {
@@ -99,7 +103,28 @@ public:
   std::bitset<QMC_MODE_MAX> qmc_driver_mode_;
 
 protected:
-  void endBlock();
+  /// collect the estimators of a block of block_steps steps
+  void endBlock(IndexType block_steps);
+  /** true on all ranks if the run needs to stop after this block, sets the steps of the next block
+   *
+   *  Rank 0 decides and broadcasts, call it on every rank after the loop timer of the block stopped.
+   *  With target_time the steps per block are scaled from the measured time per step to end the blocks left
+   *  at finish_time. With shorten_last_block the next block is shortened to the remaining walltime
+   *  instead of stopping the run when a full block no longer fits.
+   *  @param finish_time elapsed time of run_time_manager at which the driver should end for target_time
+   *  @param blocks_left blocks still to run
+   *  @param block_steps steps of the next block
+   */
+  bool checkStop(RunTimeControl<>& runtime_control,
+                 LoopTimer<>& loop_timer,
+                 double finish_time,
+                 int blocks_left,
+                 IndexType& block_steps);
+  /** true on all ranks if the reblocked energy error reached the target_error input
+   *
+   *  Rank 0 decides and broadcasts, call it on every rank after endBlock.
+   */
+  bool isTargetErrorReached(const std::string& driver_name, int block);
   /** This is a data structure strictly for QMCDriver and its derived classes
    *
    *  i.e. its nested in scope for a reason
@@ -135,11 +160,15 @@ public:
 
   /** Adjust populations local walkers to this number
   * @param nwalkers number of walkers to add
+  * @param num_crowds if positive, new walkers are first touched by the threads running their crowds
+  * @param crowd_device_nums if not empty, the walkers of each crowd are created on its device
   *
   */
   void makeLocalWalkers(int nwalkers,
                         RealType reserve,
-                        const ParticleAttrib<TinyVector<QMCTraits::RealType, 3>>& positions);
+                        const ParticleAttrib<TinyVector<QMCTraits::RealType, 3>>& positions,
+                        int num_crowds                            = 0,
+                        const std::vector<int>& crowd_device_nums = {});
 
   DriftModifierBase& get_drift_modifier() const { return *drift_modifier_; }
 
@@ -178,6 +207,12 @@ public:
 
   void createRngsStepContexts(int num_crowds);
 
+  /// print how the OpenMP threads are shared by the crowds and their BLAS calls
+  void reportThreadLayout(int num_crowds) const;
+
+  /// print the CPU and NUMA node running each crowd and how many of its walkers sit on that node
+  void reportNUMAPlacement();
+
   void putWalkers(std::vector<xmlNodePtr>& wset) override;
 
   ///set global offsets of the walkers
@@ -252,22 +287,70 @@ protected:
    *  You can have crowds or ranks with no walkers.
    *  You cannot have more crowds than threads.
    *
+   *  If a memory budget is given and the walker counts are absent,
+   *  each crowd gets the largest number of walkers whose multi walker resources fit the budget.
+   *
    *  passing num_ranks instead of internally querying comm->size()
    *  makes unit testing much quicker.
    *
+   *  @param memory_per_walker bytes of multi walker resources needed by each walker
+   *  @param memory_budget bytes available to multi walker resources on each rank, 0 means no limit
    */
   static QMCDriverNew::AdjustedWalkerCounts adjustGlobalWalkerCount(int num_ranks,
                                                                     int rank_id,
                                                                     IndexType desired_count,
                                                                     IndexType walkers_per_rank,
                                                                     RealType reserve_walkers,
-                                                                    int num_crowds);
+                                                                    int num_crowds,
+                                                                    size_t memory_per_walker = 0,
+                                                                    size_t memory_budget     = 0);
+
+  /** memory in bytes of the multi walker resources needed by each walker
+   *  Summed over the resources of the golden particle set, trial wavefunction and hamiltonian.
+   */
+  size_t getMultiWalkerMemoryPerWalker();
 
   static void checkNumCrowdsLTNumThreads(const int num_crowds);
 
+  /** threads of the nested parallel regions and BLAS calls of each crowd
+   *  @param requested crowd_threads input, 0 shares the threads left over by the crowds among them
+   *  @param num_crowds crowds on this rank
+   */
+  static int determineThreadsPerCrowd(int requested, int num_crowds);
+
+  /** devices of the crowds
+   *  @param device_nums devices driven by this rank, the default device first
+   *  @param num_crowds crowds on this rank
+   *  @return device of each crowd, the crowds being split into contiguous blocks, one per device
+   */
+  static std::vector<int> assignCrowdDevices(const std::vector<int>& device_nums, int num_crowds);
+
   /// check logpsi and grad and lap against values computed from scratch
   static void checkLogAndGL(Crowd& crowd, const std::string_view location);
 
+  /** all-electron move of the walkers of a crowd, the batched VMCUpdateAll and DMCUpdateAllWithRejection
+   *
+   *  Every walker proposes a move of all its particles. The proposed configurations are evaluated from scratch
+   *  for the whole crowd at once, the rejected walkers are restored and evaluated again. On return the
+   *  wavefunctions, G and L of the particle sets are those of the current positions.
+   *  @param tau time step
+   *  @param use_drift the moves are drifted by the quantum force
+   *  @param branch_engine rejects the moves changing the phase of the wavefunction, nullptr in VMC
+   *  @param sub_steps number of successive moves, each one accepted against the configuration left by the previous
+   *  @param rr_proposed incremented by the squared diffusive displacements, tau/m dr^2, of the proposed moves
+   *  @param rr_accepted incremented by those of the accepted moves
+   */
+  static void moveAllElectrons(Crowd& crowd,
+                               ContextForSteps& step_context,
+                               const DriftModifierBase& drift_modifier,
+                               const std::vector<RealType>& ptclgrp_inv_mass,
+                               RealType tau,
+                               bool use_drift,
+                               const SFNBranch* branch_engine,
+                               int sub_steps,
+                               std::vector<RealType>& rr_proposed,
+                               std::vector<RealType>& rr_accepted);
+
   const std::string& get_root_name() const override { return project_data_.CurrentMainRoot(); }
 
   /** The timers for the driver.
@@ -319,6 +402,8 @@ protected:
   /**}@*/
 
   std::vector<std::unique_ptr<Crowd>> crowds_;
+  /// threads of the nested parallel regions and BLAS calls of each crowd, sizes the crowd tasks
+  int threads_per_crowd_ = 1;
 
   std::string h5_file_root_;
 
@@ -415,6 +500,11 @@ protected:
   ///profile the driver lifetime
   ScopedProfiler driver_scope_profiler_;
 
+  /// throughput and time split of the blocks, only with the block_metrics input
+  std::unique_ptr<BlockMetrics<>> block_metrics_;
+  /// rank 0 stream of the block metrics
+  std::unique_ptr<std::ofstream> block_metrics_out_;
+
   /// project info for accessing global fileroot and series id
   const ProjectData& project_data_;
 
@@ -0,0 +1,395 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "RMCBatched.h"
+#include <limits>
+#include "QMCDrivers/SFNBranch.h"
+#include "Concurrency/ParallelExecutor.hpp"
+#include "Message/UniformCommunicateError.h"
+#include "Message/CommOperators.h"
+#include "Utilities/RunTimeManager.h"
+#include "MemoryUsage.h"
+#include "Utilities/TimerTrace.h"
+
+namespace qmcplusplus
+{
+using WP = WalkerProperties::Indexes;
+
+/** drift of all the particles
+ * @param G gradients of the log of the trial wavefunction
+ * @param drift output
+ */
+static void computeDrift(const RMCBatched::StateForThread& sft,
+                         const ContextForSteps& step_context,
+                         const ParticleSet::ParticleGradient& G,
+                         ParticleSet::ParticlePos& drift)
+{
+  for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+  {
+    const QMCTraits::RealType tauovermass = sft.qmcdrv_input.get_tau() * sft.population.get_ptclgrp_inv_mass()[ig];
+    for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+    {
+      const QMCTraits::GradType grad = G[iat];
+      sft.drift_modifier.getDrift(tauovermass, grad, drift[iat]);
+    }
+  }
+}
+
+/** log of the transition probability from R_from to R_to, up to the normalization
+ * @param drift drift at R_from
+ */
+static QMCTraits::RealType computeLogG(const RMCBatched::StateForThread& sft,
+                                       const ContextForSteps& step_context,
+                                       const ParticleSet::ParticlePos& R_to,
+                                       const ParticleSet::ParticlePos& R_from,
+                                       const ParticleSet::ParticlePos& drift)
+{
+  QMCTraits::RealType log_g = 0;
+  for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+  {
+    const QMCTraits::RealType oneover2tau =
+        0.5 / (sft.qmcdrv_input.get_tau() * sft.population.get_ptclgrp_inv_mass()[ig]);
+    for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+    {
+      const QMCTraits::PosType dr = R_to[iat] - R_from[iat] - drift[iat];
+      log_g -= oneover2tau * dot(dr, dr);
+    }
+  }
+  return log_g;
+}
+
+/// true if the move crossed a node of the trial wavefunction
+static bool isNodeCrossed(QMCTraits::FullPrecRealType phase_new, QMCTraits::FullPrecRealType phase_old)
+{
+#if defined(QMC_COMPLEX)
+  return false;
+#else
+  return std::cos(phase_new - phase_old) < std::numeric_limits<QMCTraits::RealType>::epsilon();
+#endif
+}
+
+RMCBatched::RMCBatched(const ProjectData& project_data,
+                       QMCDriverInput&& qmcdriver_input,
+                       RMCDriverInput&& input,
+                       MCPopulation&& pop,
+                       Communicate* comm)
+    : QMCDriverNew(project_data, std::move(qmcdriver_input), std::move(pop), "RMCBatched::", comm, "RMCBatched"),
+      rmcdriver_input_(input)
+{}
+
+RMCBatched::~RMCBatched() = default;
+
+void RMCBatched::process(xmlNodePtr node)
+{
+  print_mem("RMCBatched before initialization", app_log());
+  try
+  {
+    QMCDriverNew::AdjustedWalkerCounts awc =
+        adjustGlobalWalkerCount(myComm->size(), myComm->rank(), qmcdriver_input_.get_total_walkers(),
+                                qmcdriver_input_.get_walkers_per_rank(), 1.0, qmcdriver_input_.get_num_crowds(),
+                                getMultiWalkerMemoryPerWalker(),
+                                static_cast<size_t>(qmcdriver_input_.get_walker_memory_budget()) << 20);
+
+    Base::startup(node, awc);
+  }
+  catch (const UniformCommunicateError& ue)
+  {
+    myComm->barrier_and_abort(ue.what());
+  }
+
+  branch_engine_ = std::make_unique<SFNBranch>(qmcdriver_input_.get_tau(), population_.get_num_global_walkers());
+  branch_engine_->put(node);
+}
+
+void RMCBatched::initReptiles(const StateForThread& sft,
+                              Crowd& crowd,
+                              ContextForSteps& step_context,
+                              UPtrVector<ReptileBeads>& reptiles)
+{
+  reptiles.clear();
+  ParticleSet::ParticlePos drift(sft.population.get_num_particles());
+  for (MCPWalker& walker : crowd.get_walkers())
+  {
+    ReptileBeads::Bead seed;
+    seed.R            = walker.R;
+    seed.G            = walker.G;
+    seed.log_psi      = walker.Properties(WP::LOGPSI);
+    seed.phase        = walker.Properties(WP::SIGN);
+    seed.local_energy = walker.Properties(WP::LOCALENERGY);
+    seed.properties.assign(walker.getPropertyBase(), walker.getPropertyBase() + walker.Properties.cols());
+    computeDrift(sft, step_context, seed.G, drift);
+    const RealType log_g = computeLogG(sft, step_context, seed.R, seed.R, drift);
+    reptiles.push_back(std::make_unique<ReptileBeads>(sft.num_beads, seed, log_g));
+  }
+}
+
+void RMCBatched::advanceReptiles(const StateForThread& sft,
+                                 Crowd& crowd,
+                                 UPtrVector<ReptileBeads>& reptiles,
+                                 DriverTimers& timers,
+                                 ContextForSteps& step_context,
+                                 bool accumulate_this_step)
+{
+  if (crowd.size() == 0)
+    return;
+  auto& ps_dispatcher  = crowd.dispatchers_.ps_dispatcher_;
+  auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
+  auto& ham_dispatcher = crowd.dispatchers_.ham_dispatcher_;
+  auto& walkers        = crowd.get_walkers();
+  const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
+  const RefVectorWithLeader<TrialWaveFunction> walker_twfs(crowd.get_walker_twfs()[0], crowd.get_walker_twfs());
+  const RefVectorWithLeader<QMCHamiltonian> walker_hamiltonians(crowd.get_walker_hamiltonians()[0],
+                                                                crowd.get_walker_hamiltonians());
+  timers.resource_timer.start();
+  ResourceCollectionTeamLock<ParticleSet> pset_res_lock(crowd.getSharedResource().pset_res, walker_elecs);
+  ResourceCollectionTeamLock<TrialWaveFunction> twfs_res_lock(crowd.getSharedResource().twf_res, walker_twfs);
+  ResourceCollectionTeamLock<QMCHamiltonian> hams_res_lock(crowd.getSharedResource().ham_res, walker_hamiltonians);
+  timers.resource_timer.stop();
+
+  const int num_walkers   = crowd.size();
+  const int num_particles = sft.population.get_num_particles();
+  const RealType tau      = sft.qmcdrv_input.get_tau();
+  ParticleSet::ParticlePos drift(num_particles);
+  std::vector<RealType> log_gf(num_walkers);
+
+  // propose the new heads, all-electron moves from the current heads
+  timers.movepbyp_timer.start();
+  step_context.nextDeltaRs(num_walkers * num_particles);
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    const ReptileBeads::Bead& head = reptiles[iw]->getHead();
+    ParticleSet& elecs             = walker_elecs[iw];
+    computeDrift(sft, step_context, head.G, drift);
+    log_gf[iw] = 0;
+    for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+    {
+      const RealType sqrttau = std::sqrt(tau * sft.population.get_ptclgrp_inv_mass()[ig]);
+      for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+      {
+        // deltas are fastest in walkers then particles
+        const PosType& delta_r = *(step_context.deltaRsBegin() + iat * num_walkers + iw);
+        elecs.R[iat]           = head.R[iat] + drift[iat] + sqrttau * delta_r;
+        log_gf[iw] -= 0.5 * dot(delta_r, delta_r);
+      }
+    }
+  }
+  ps_dispatcher.flex_update(walker_elecs);
+  timers.movepbyp_timer.stop();
+
+  timers.buffer_timer.start();
+  twf_dispatcher.flex_evaluateLog(walker_twfs, walker_elecs);
+  timers.buffer_timer.stop();
+
+  timers.hamiltonian_timer.start();
+  std::vector<QMCHamiltonian::FullPrecRealType> local_energies(
+      ham_dispatcher.flex_evaluate(walker_hamiltonians, walker_twfs, walker_elecs));
+  timers.hamiltonian_timer.stop();
+
+  timers.collectables_timer.start();
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    ReptileBeads& reptile    = *reptiles[iw];
+    ParticleSet& elecs       = walker_elecs[iw];
+    TrialWaveFunction& twf   = walker_twfs[iw];
+    MCPWalker& walker        = walkers[iw];
+    const int nbeads         = reptile.size();
+    const RealType log_psi   = twf.getLogPsi();
+    const RealType eloc      = local_energies[iw];
+    const auto& head         = reptile.getHead();
+    const auto& tail         = reptile.getTail();
+    const auto& next         = reptile.getNext();
+    computeDrift(sft, step_context, elecs.G, drift);
+    const RealType log_gb = computeLogG(sft, step_context, head.R, elecs.R, drift);
+
+    RealType log_accept;
+    if (sft.vmc_growth)
+      log_accept = log_gb - log_gf[iw] + 2 * (log_psi - head.log_psi);
+    else if (sft.rmcdrv_input.get_use_sym_action())
+    {
+      // symmetrized link action of the new head link and of the removed tail link
+      const RealType tail_gf = reptile.logGTowardTail(nbeads - 2);
+      const RealType tail_gb = reptile.logGTowardHead(nbeads - 2);
+      const RealType ds_head = sft.branch_engine.symLinkAction(log_gf[iw], log_gb, eloc, head.local_energy);
+      const RealType ds_tail = sft.branch_engine.symLinkAction(tail_gf, tail_gb, tail.local_energy, next.local_energy);
+      log_accept = -(ds_head - ds_tail) + (log_psi + next.log_psi - head.log_psi - tail.log_psi) + tail_gf - log_gf[iw];
+    }
+    else
+      log_accept = -(sft.branch_engine.DMCLinkAction(eloc, head.local_energy) -
+                     sft.branch_engine.DMCLinkAction(tail.local_energy, next.local_energy));
+
+    const bool forced = sft.rmcdrv_input.get_max_age() > 0 && reptile.getAge() >= sft.rmcdrv_input.get_max_age();
+    if (!isNodeCrossed(twf.getPhase(), head.phase) &&
+        (forced || step_context.get_random_gen()() < std::exp(log_accept)))
+    {
+      walker.resetProperty(log_psi, twf.getPhase(), eloc);
+      walker_hamiltonians[iw].auxHevaluate(elecs, walker);
+      walker_hamiltonians[iw].saveProperty(walker.getPropertyBase());
+
+      ReptileBeads::Bead& new_head = reptile.growHead();
+      new_head.R                   = elecs.R;
+      new_head.G                   = elecs.G;
+      new_head.log_psi             = log_psi;
+      new_head.phase               = twf.getPhase();
+      new_head.local_energy        = eloc;
+      std::copy_n(walker.getPropertyBase(), new_head.properties.size(), new_head.properties.data());
+      reptile.logGTowardTail(0) = log_gb;
+      reptile.logGTowardHead(0) = log_gf[iw];
+      crowd.incAccept();
+    }
+    else
+    {
+      crowd.incReject();
+      if (!sft.vmc_growth)
+        reptile.flip();
+    }
+
+    // the walker carries the mixed estimate, the average over the two ends of the reptile
+    const auto& mixed_head = reptile.getHead();
+    const auto& mixed_tail = reptile.getTail();
+    walker.R               = mixed_head.R;
+    walker.G               = mixed_head.G;
+    FullPrecRealType* restrict properties = walker.getPropertyBase();
+    for (int ip = 0; ip < mixed_head.properties.size(); ++ip)
+      properties[ip] = 0.5 * (mixed_head.properties[ip] + mixed_tail.properties[ip]);
+    walker.Weight = 1;
+  }
+  timers.collectables_timer.stop();
+
+  if (accumulate_this_step)
+  {
+    ScopedTimer est_timer(timers.estimators_timer);
+    // pure estimates are taken at the center bead, the wavefunction is not evaluated there
+    for (int iw = 0; iw < num_walkers; ++iw)
+      walker_elecs[iw].R = reptiles[iw]->getCenter().R;
+    ps_dispatcher.flex_update(walker_elecs);
+    crowd.accumulate(step_context.get_random_gen());
+  }
+}
+
+/** Runs the RMC section
+ *
+ *  The reptiles are grown from the evaluated walkers with VMC steps,
+ *  then warmed up and sampled with RMC steps.
+ */
+bool RMCBatched::run()
+{
+  IndexType num_blocks = qmcdriver_input_.get_max_blocks();
+  estimator_manager_->startDriverRun();
+
+  StateForThread rmc_state(qmcdriver_input_, rmcdriver_input_, *drift_modifier_, *branch_engine_, population_);
+  const RealType tau = qmcdriver_input_.get_tau();
+  if (rmcdriver_input_.get_beta() > 0)
+    rmc_state.num_beads = static_cast<int>(rmcdriver_input_.get_beta() / tau);
+  else
+    rmc_state.num_beads = rmcdriver_input_.get_beads();
+  if (rmc_state.num_beads < 3)
+    throw std::runtime_error("RMCBatched needs at least 3 beads per reptile, increase beta or beads.");
+  app_log() << "  Projection time:  " << rmc_state.num_beads * tau << " Ha^-1 with " << rmc_state.num_beads
+            << " beads per reptile" << std::endl;
+
+  LoopTimer<> rmc_loop;
+  RunTimeControl<> runtimeControl(run_time_manager, project_data_.getMaxCPUSeconds(), project_data_.getTitle(),
+                                  myComm->rank() == 0);
+
+  { // walker and reptile initialization
+    ScopedTimer local_timer(timers_.init_walkers_timer);
+    ParallelExecutor<> section_start_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
+    section_start_task(crowds_.size(), initialLogEvaluation, std::ref(crowds_), std::ref(step_contexts_));
+
+    // the link actions filter the energies against the reference energy of the starting population
+    FullPrecRealType energy, variance;
+    population_.measureGlobalEnergyVariance(*myComm, energy, variance);
+    branch_engine_->initParam(population_, energy, variance, true, false);
+
+    auto initReptilesTask = [](int crowd_id, const StateForThread& sft, UPtrVector<Crowd>& crowds,
+                               UPtrVector<ContextForSteps>& context_for_steps,
+                               std::vector<UPtrVector<ReptileBeads>>& crowd_reptiles) {
+      initReptiles(sft, *crowds[crowd_id], *context_for_steps[crowd_id], crowd_reptiles[crowd_id]);
+    };
+    crowd_reptiles_.resize(crowds_.size());
+    section_start_task(crowds_.size(), initReptilesTask, rmc_state, std::ref(crowds_), std::ref(step_contexts_),
+                       std::ref(crowd_reptiles_));
+  }
+
+  print_mem("RMCBatched after initialLogEvaluation", app_summary());
+
+  ParallelExecutor<> crowd_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
+  auto runRMCStep = [](int crowd_id, const StateForThread& sft, DriverTimers& timers,
+                       UPtrVector<ContextForSteps>& context_for_steps, UPtrVector<Crowd>& crowds,
+                       std::vector<UPtrVector<ReptileBeads>>& crowd_reptiles, bool accumulate_this_step) {
+    Crowd& crowd = *crowds[crowd_id];
+    crowd.setRNGForHamiltonian(context_for_steps[crowd_id]->get_random_gen());
+    advanceReptiles(sft, crowd, crowd_reptiles[crowd_id], timers, *context_for_steps[crowd_id], accumulate_this_step);
+  };
+
+  // unroll the reptiles, a rejected VMC move does not bounce
+  const int vmc_presteps =
+      rmcdriver_input_.get_vmc_presteps() < 0 ? rmc_state.num_beads + 2 : rmcdriver_input_.get_vmc_presteps();
+  rmc_state.vmc_growth = true;
+  for (int step = 0; step < vmc_presteps; ++step)
+  {
+    ScopedTimer local_timer(timers_.run_steps_timer);
+    crowd_task(crowds_.size(), runRMCStep, rmc_state, std::ref(timers_), std::ref(step_contexts_), std::ref(crowds_),
+               std::ref(crowd_reptiles_), false);
+  }
+  rmc_state.vmc_growth = false;
+  app_log() << "  Finished " << vmc_presteps << " VMC presteps" << std::endl;
+
+  for (int step = 0; step < qmcdriver_input_.get_warmup_steps(); ++step)
+  {
+    ScopedTimer local_timer(timers_.run_steps_timer);
+    crowd_task(crowds_.size(), runRMCStep, rmc_state, std::ref(timers_), std::ref(step_contexts_), std::ref(crowds_),
+               std::ref(crowd_reptiles_), false);
+  }
+  if (qmcdriver_input_.get_warmup_steps() > 0)
+    app_log() << "Warm-up is completed!" << std::endl;
+
+  for (int block = 0; block < num_blocks; ++block)
+  {
+    timer_trace.startBlock();
+    rmc_loop.start();
+    estimator_manager_->startBlock(qmcdriver_input_.get_max_steps());
+
+    for (auto& crowd : crowds_)
+      crowd->startBlock(qmcdriver_input_.get_max_steps());
+    for (int step = 0; step < qmcdriver_input_.get_max_steps(); ++step)
+    {
+      ScopedTimer local_timer(timers_.run_steps_timer);
+      crowd_task(crowds_.size(), runRMCStep, rmc_state, std::ref(timers_), std::ref(step_contexts_),
+                 std::ref(crowds_), std::ref(crowd_reptiles_), true);
+    }
+    print_mem("RMCBatched after a block", app_debug_stream());
+    endBlock(qmcdriver_input_.get_max_steps());
+    rmc_loop.stop();
+
+    bool stop_requested = false;
+    // Rank 0 decides whether the time limit was reached
+    if (!myComm->rank())
+      stop_requested = runtimeControl.checkStop(rmc_loop);
+    myComm->bcast(stop_requested);
+
+    if (stop_requested)
+    {
+      if (!myComm->rank())
+        app_log() << runtimeControl.generateStopMessage("RMCBatched", block);
+      run_time_manager.markStop();
+      break;
+    }
+  }
+
+  print_mem("RMCBatched ends", app_log());
+
+  estimator_manager_->stopDriverRun();
+
+  return finalize(num_blocks, true);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_RMCBATCHED_H
+#define QMCPLUSPLUS_RMCBATCHED_H
+
+#include "QMCDrivers/QMCDriverNew.h"
+#include "QMCDrivers/RMC/RMCDriverInput.h"
+#include "QMCDrivers/RMC/ReptileBeads.h"
+#include "QMCDrivers/MCPopulation.h"
+#include "QMCDrivers/ContextForSteps.h"
+#include "QMCDrivers/GreenFunctionModifiers/DriftModifierBase.h"
+
+namespace qmcplusplus
+{
+class SFNBranch;
+
+/** @ingroup QMCDrivers
+ * @brief Implements a RMC with batched all-electron moves of the reptile heads.
+ *
+ * Each walker of the population carries one reptile. The beads live in ReptileBeads,
+ * the proposed heads of all the reptiles of a crowd are evaluated together in the walker ParticleSets
+ * with the multi walker APIs. Ceperley's bounce algorithm is used, a rejected move reverses the reptile.
+ * Mixed estimates are accumulated at the reptile ends, operator estimators see the center bead.
+ */
+class RMCBatched : public QMCDriverNew
+{
+public:
+  using Base              = QMCDriverNew;
+  using FullPrecRealType  = QMCTraits::FullPrecRealType;
+  using PosType           = QMCTraits::PosType;
+  using ParticlePositions = PtclOnLatticeTraits::ParticlePos;
+
+  /** To avoid 10's of arguments to runRMCStep
+   */
+  struct StateForThread
+  {
+    const QMCDriverInput& qmcdrv_input;
+    const RMCDriverInput& rmcdrv_input;
+    const DriftModifierBase& drift_modifier;
+    /// provides the link actions with the effective time step and the energy filter
+    const SFNBranch& branch_engine;
+    const MCPopulation& population;
+    /// number of beads of each reptile
+    int num_beads = 0;
+    /// grow the reptiles with the VMC acceptance and without bouncing
+    bool vmc_growth = false;
+
+    StateForThread(const QMCDriverInput& qmci,
+                   const RMCDriverInput& rmci,
+                   DriftModifierBase& drift_mod,
+                   const SFNBranch& branch_eng,
+                   MCPopulation& pop)
+        : qmcdrv_input(qmci), rmcdrv_input(rmci), drift_modifier(drift_mod), branch_engine(branch_eng), population(pop)
+    {}
+  };
+
+  /// Constructor.
+  RMCBatched(const ProjectData& project_data,
+             QMCDriverInput&& qmcdriver_input,
+             RMCDriverInput&& input,
+             MCPopulation&& pop,
+             Communicate* comm);
+
+  ~RMCBatched() override;
+
+  void process(xmlNodePtr node) override;
+
+  bool run() override;
+
+  /** create the reptiles of a crowd from its evaluated walkers
+   *
+   *  Every bead starts at the walker configuration.
+   */
+  static void initReptiles(const StateForThread& sft,
+                           Crowd& crowd,
+                           ContextForSteps& step_context,
+                           UPtrVector<ReptileBeads>& reptiles);
+
+  /** propose and evaluate new heads for all the reptiles of a crowd, then accept or bounce
+   */
+  static void advanceReptiles(const StateForThread& sft,
+                              Crowd& crowd,
+                              UPtrVector<ReptileBeads>& reptiles,
+                              DriverTimers& timers,
+                              ContextForSteps& step_context,
+                              bool accumulate_this_step);
+
+  QMCRunType getRunType() override { return QMCRunType::RMC_BATCH; }
+
+private:
+  const RMCDriverInput rmcdriver_input_;
+  /// reference energy and branch cutoff of the link actions, set from the population before the RMC steps
+  std::unique_ptr<SFNBranch> branch_engine_;
+  /// reptiles of each crowd, one per walker of the crowd
+  std::vector<UPtrVector<ReptileBeads>> crowd_reptiles_;
+
+  /// copy constructor (disabled)
+  RMCBatched(const RMCBatched&) = delete;
+  /// Copy operator (disabled).
+  RMCBatched& operator=(const RMCBatched&) = delete;
+};
+
+} // namespace qmcplusplus
+
+#endif
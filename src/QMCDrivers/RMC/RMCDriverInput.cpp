@@ -0,0 +1,43 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "RMCDriverInput.h"
+
+namespace qmcplusplus
+{
+void RMCDriverInput::readXML(xmlNodePtr node)
+{
+  ParameterSet parameter_set_;
+  std::string action("SLA");
+  parameter_set_.add(beta_, "beta");
+  parameter_set_.add(beads_, "beads");
+  parameter_set_.add(vmc_presteps_, "vmcpresteps");
+  parameter_set_.add(max_age_, "maxAge");
+  parameter_set_.add(max_age_, "MaxAge");
+  parameter_set_.add(action, "action", {"SLA", "DMC"});
+  parameter_set_.add(action, "Action", {"SLA", "DMC"});
+  parameter_set_.put(node);
+
+  use_sym_action_ = action == "SLA";
+  if (beta_ <= 0 && beads_ < 1)
+    throw std::runtime_error("RMC input section needs either beta or beads");
+  if (max_age_ < 0)
+    throw std::runtime_error("Illegal input for maxAge in RMC input section");
+
+  if (use_sym_action_)
+    app_log() << "  Using the symmetrized link action" << std::endl;
+  else
+    app_log() << "  Using the DMC link action" << std::endl;
+}
+
+std::ostream& operator<<(std::ostream& o_stream, const RMCDriverInput& rmci) { return o_stream; }
+
+} // namespace qmcplusplus
@@ -0,0 +1,59 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_RMCDRIVERINPUT_H
+#define QMCPLUSPLUS_RMCDRIVERINPUT_H
+
+#include "Configuration.h"
+#include "OhmmsData/ParameterSet.h"
+
+namespace qmcplusplus
+{
+/** Input representation for RMC driver class runtime parameters
+ */
+class RMCDriverInput
+{
+public:
+  using IndexType = QMCTraits::IndexType;
+  using RealType  = QMCTraits::RealType;
+  RMCDriverInput(){};
+  void readXML(xmlNodePtr xml_input);
+
+protected:
+  /** @ingroup Parameters for RMC Driver
+   *  @{
+   */
+  ///projection time of the reptile, overrides beads if positive
+  RealType beta_ = -1;
+  ///number of beads of each reptile
+  IndexType beads_ = -1;
+  ///VMC steps growing the reptiles before the RMC steps, beads + 2 if negative
+  IndexType vmc_presteps_ = -1;
+  ///bounces of a reptile before the move is forced, 0 disables
+  IndexType max_age_ = 0;
+  ///use the symmetrized link action, otherwise the DMC link action
+  bool use_sym_action_ = true;
+  /** @} */
+
+public:
+  RealType get_beta() const { return beta_; }
+  IndexType get_beads() const { return beads_; }
+  IndexType get_vmc_presteps() const { return vmc_presteps_; }
+  IndexType get_max_age() const { return max_age_; }
+  bool get_use_sym_action() const { return use_sym_action_; }
+
+  friend std::ostream& operator<<(std::ostream& o_stream, const RMCDriverInput& rmci);
+};
+
+extern std::ostream& operator<<(std::ostream& o_stream, const RMCDriverInput& rmci);
+
+} // namespace qmcplusplus
+#endif
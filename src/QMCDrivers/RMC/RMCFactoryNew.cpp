@@ -0,0 +1,38 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "RMCFactoryNew.h"
+#include "QMCDrivers/RMC/RMCBatched.h"
+
+namespace qmcplusplus
+{
+QMCDriverInterface* RMCFactoryNew::create(const ProjectData& project_data, MCPopulation&& pop, Communicate* comm)
+{
+#if defined(QMC_CUDA)
+  comm->barrier_and_abort("RMC batched driver is not supported by legacy CUDA builds.");
+#endif
+
+  app_summary() << "\n========================================"
+                   "\n  Reading RMC driver XML input section"
+                   "\n========================================"
+                << std::endl;
+
+  QMCDriverInput qmcdriver_input;
+  qmcdriver_input.readXML(input_node_);
+  RMCDriverInput rmcdriver_input;
+  rmcdriver_input.readXML(input_node_);
+  QMCDriverInterface* qmc =
+      new RMCBatched(project_data, std::move(qmcdriver_input), std::move(rmcdriver_input), std::move(pop), comm);
+  // the reptile heads always move all the electrons
+  qmc->setUpdateMode(0);
+  return qmc;
+}
+} // namespace qmcplusplus
@@ -0,0 +1,35 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_RMCFACTORYNEW_H
+#define QMCPLUSPLUS_RMCFACTORYNEW_H
+#include "QMCDrivers/QMCDriverInterface.h"
+#include "Message/Communicate.h"
+
+namespace qmcplusplus
+{
+class MCPopulation;
+class ProjectData;
+
+class RMCFactoryNew
+{
+private:
+  xmlNodePtr input_node_;
+
+public:
+  RMCFactoryNew(xmlNodePtr cur) : input_node_(cur) {}
+
+  QMCDriverInterface* create(const ProjectData& project_data, MCPopulation&& pop, Communicate* comm);
+};
+} // namespace qmcplusplus
+
+#endif
@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_REPTILEBEADS_H
+#define QMCPLUSPLUS_REPTILEBEADS_H
+
+#include <vector>
+#include "Configuration.h"
+
+namespace qmcplusplus
+{
+/** the beads of one reptile for the batched RMC driver
+ *
+ * Unlike Reptile, the beads are not walkers of an MCWalkerConfiguration.
+ * A bead only keeps what the link action and the estimators need, the reptile head is
+ * moved and evaluated in the ParticleSet of its population walker.
+ * The beads form a circular queue. Growing a new head overwrites the tail and a bounce
+ * reverses the direction, neither copies any bead.
+ * Bead 0 is the head and bead size()-1 is the tail.
+ */
+class ReptileBeads : public QMCTraits
+{
+public:
+  using ParticlePos      = PtclOnLatticeTraits::ParticlePos;
+  using ParticleGradient = PtclOnLatticeTraits::ParticleGradient;
+
+  struct Bead
+  {
+    ParticlePos R;
+    ParticleGradient G;
+    FullPrecRealType log_psi      = 0;
+    FullPrecRealType phase        = 0;
+    FullPrecRealType local_energy = 0;
+    /// walker properties evaluated at this bead
+    std::vector<FullPrecRealType> properties;
+  };
+
+  /** constructor
+   * @param nbeads number of beads
+   * @param seed every bead starts as a copy of the seed
+   * @param log_g log of the transition probability between two seed beads
+   */
+  ReptileBeads(int nbeads, const Bead& seed, RealType log_g)
+      : beads_(nbeads, seed), log_g_up_(nbeads, log_g), log_g_down_(nbeads, log_g), head_(0), direction_(1), age_(0)
+  {}
+
+  int size() const { return beads_.size(); }
+
+  Bead& operator[](int i) { return beads_[getBeadIndex(i)]; }
+  const Bead& operator[](int i) const { return beads_[getBeadIndex(i)]; }
+
+  Bead& getHead() { return (*this)[0]; }
+  Bead& getTail() { return (*this)[size() - 1]; }
+  Bead& getNext() { return (*this)[size() - 2]; }
+  Bead& getCenter() { return (*this)[(size() - 1) / 2]; }
+
+  /// log of the transition probability from bead i to bead i+1
+  RealType& logGTowardTail(int i) { return direction_ > 0 ? log_g_up_[getLinkIndex(i)] : log_g_down_[getLinkIndex(i)]; }
+  /// log of the transition probability from bead i+1 to bead i
+  RealType& logGTowardHead(int i) { return direction_ > 0 ? log_g_down_[getLinkIndex(i)] : log_g_up_[getLinkIndex(i)]; }
+
+  /** move the reptile forward by one bead
+   * @return the new head, in the storage of the old tail
+   */
+  Bead& growHead()
+  {
+    head_ = getBeadIndex(size() - 1);
+    age_  = 0;
+    return beads_[head_];
+  }
+
+  /// bounce, the tail becomes the head
+  void flip()
+  {
+    head_ = wrapIndex(head_ - direction_);
+    direction_ *= -1;
+    age_++;
+  }
+
+  /// number of bounces since the last growth
+  int getAge() const { return age_; }
+
+private:
+  int wrapIndex(int i) const { return (i % size() + size()) % size(); }
+  int getBeadIndex(int i) const { return wrapIndex(head_ + direction_ * i); }
+  /// link between bead i and i+1, link k connects storage k and k+1
+  int getLinkIndex(int i) const { return direction_ > 0 ? getBeadIndex(i) : getBeadIndex(i + 1); }
+
+  std::vector<Bead> beads_;
+  /// log of the transition probability from storage k to k+1
+  std::vector<RealType> log_g_up_;
+  /// log of the transition probability from storage k+1 to k
+  std::vector<RealType> log_g_down_;
+  /// storage index of the head
+  int head_;
+  /// +1 if the beads toward the tail follow the storage order, -1 otherwise
+  int direction_;
+  int age_;
+};
+
+} // namespace qmcplusplus
+#endif
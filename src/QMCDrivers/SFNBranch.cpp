@@ -128,6 +128,21 @@ int SFNBranch::initParam(const MCPopulation& population,
   return int(round(double(iParam[B_TARGETWALKERS]) / double(nwtot_now)));
 }
 
+void SFNBranch::resetTimeStep(RealType tau, int warmup_steps)
+{
+  vParam[SBVP::TAU]    = tau;
+  vParam[SBVP::TAUEFF] = tau;
+  R2Accepted.clear();
+  R2Proposed.clear();
+  R2Accepted(1.0e-10);
+  R2Proposed(1.0e-10);
+  EnergyHist.clear();
+  VarianceHist.clear();
+  iParam[B_WARMUPSTEPS] = warmup_steps;
+  WarmUpToDoSteps       = warmup_steps;
+  EtrialUpdateToDoSteps = iParam[B_ENERGYUPDATEINTERVAL];
+}
+
 void SFNBranch::updateParamAfterPopControl(int pop_int, const MCDataType<FullPrecRealType>& wc_ensemble_prop, int Nelec)
 {
   FullPrecRealType logN    = std::log(static_cast<FullPrecRealType>(iParam[B_TARGETWALKERS]));
@@ -167,8 +182,7 @@ void SFNBranch::updateParamAfterPopControl(int pop_int, const MCDataType<FullPre
     }
     else
     {
-      throw UniformCommunicateError("Bug: FIXME SBVP::EREF should be calculated based on weights");
-      /// FIXME
+      // the fixed population carries the weights, ENOW and EREF are weighted averages
       vParam[SBVP::ETRIAL] = vParam[SBVP::EREF];
     }
   }
@@ -189,8 +203,6 @@ void SFNBranch::updateParamAfterPopControl(int pop_int, const MCDataType<FullPre
     }
     else
     {
-      throw UniformCommunicateError("Bug: FIXME SBVP::EREF should be calculated based on weights");
-      /// FIXME
       vParam[SBVP::ETRIAL] = vParam[SBVP::ENOW];
     }
 
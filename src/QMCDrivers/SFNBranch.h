@@ -180,6 +180,15 @@ public:
    */
   int initParam(const MCPopulation& population, FullPrecRealType ene, FullPrecRealType var, bool fixW, bool killwalker);
 
+  /** switch to a new time step on the current population
+   * @param tau new time step
+   * @param warmup_steps number of warmup steps at the new time step
+   *
+   * Drops the energy, variance and acceptance history of the previous time step.
+   * initParam has to be called again before branching.
+   */
+  void resetTimeStep(RealType tau, int warmup_steps);
+
   /** return the bare branch weight
    *
    * This is equivalent to calling branchWeight(enew,eold,1.0,1.0)
@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_STREAMING_SAMPLE_ACCUMULATOR_H
+#define QMCPLUSPLUS_STREAMING_SAMPLE_ACCUMULATOR_H
+
+#include <vector>
+#include "Particle/ParticleSet.h"
+#include "VariableSet.h"
+#include "type_traits/template_types.hpp"
+
+namespace qmcplusplus
+{
+/** Consumer of the walker configurations of a batched VMC run in place of a SampleStack
+ *
+ *  The driver calls evaluateCrowdSamples from each crowd task after every step, then accumulateStep once
+ *  all the crowds have finished the step. The configurations are never stored.
+ *  An accumulator may change the variational parameters between steps, the driver then moves its walkers
+ *  to the new wavefunction and the sampling continues.
+ */
+class StreamingSampleAccumulator
+{
+public:
+  virtual ~StreamingSampleAccumulator() = default;
+
+  /** prepare for a run
+   *  @param walkers_per_crowd number of walkers of each crowd, constant during the run
+   */
+  virtual void startAccumulation(const std::vector<int>& walkers_per_crowd) = 0;
+
+  /** evaluate the current configurations of the walkers of a crowd, called concurrently by the crowds
+   *  @param crowd_id index of the crowd
+   *  @param walker_elecs particle sets of the walkers of the crowd
+   */
+  virtual void evaluateCrowdSamples(int crowd_id, const RefVector<ParticleSet>& walker_elecs) = 0;
+
+  /** accumulate the evaluations of all the crowds of a step
+   *  @return true if the variational parameters were changed, they are given by getVariationalParameters
+   */
+  virtual bool accumulateStep() = 0;
+
+  /// variational parameters the walkers must be sampled with after accumulateStep returned true
+  virtual const optimize::VariableSet& getVariationalParameters() const = 0;
+
+  /// finish the run and reduce the accumulated values over the ranks
+  virtual void stopAccumulation() = 0;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -15,9 +15,12 @@
 #include "Message/UniformCommunicateError.h"
 #include "Message/CommOperators.h"
 #include "Utilities/RunTimeManager.h"
+#include "Utilities/StartupProfile.h"
 #include "ParticleBase/RandomSeqGenerator.h"
 #include "Particle/MCSample.h"
 #include "MemoryUsage.h"
+#include "Utilities/TimerTrace.h"
+#include "OMPTarget/ScopedDefaultDevice.h"
 
 namespace qmcplusplus
 {
@@ -32,7 +35,8 @@ VMCBatched::VMCBatched(const ProjectData& project_data,
     : QMCDriverNew(project_data, std::move(qmcdriver_input), std::move(pop), "VMCBatched::", comm, "VMCBatched"),
       vmcdriver_input_(input),
       samples_(samples),
-      collect_samples_(false)
+      collect_samples_(false),
+      sample_accumulator_(nullptr)
 {}
 
 void VMCBatched::advanceWalkers(const StateForThread& sft,
@@ -44,8 +48,7 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
 {
   if (crowd.size() == 0)
     return;
-  auto& ps_dispatcher  = crowd.dispatchers_.ps_dispatcher_;
-  auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
+  ScopedDefaultDevice device_scope(crowd.getDeviceNum());
   auto& ham_dispatcher = crowd.dispatchers_.ham_dispatcher_;
   auto& walkers        = crowd.get_walkers();
   const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
@@ -60,12 +63,78 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
   if (sft.qmcdrv_input.get_debug_checks() & DriverDebugChecks::CHECKGL_AFTER_LOAD)
     checkLogAndGL(crowd, "checkGL_after_load");
 
+  if (sft.qmcdrv_input.get_update_mode() != "pbyp")
+  {
+    ScopedTimer move_timer(timers.movepbyp_timer);
+    std::vector<RealType> rr(crowd.size(), 0.0);
+    moveAllElectrons(crowd, step_context, sft.drift_modifier, sft.population.get_ptclgrp_inv_mass(),
+                     sft.qmcdrv_input.get_tau(), sft.vmcdrv_input.get_use_drift(), nullptr,
+                     sft.qmcdrv_input.get_sub_steps(), rr, rr);
+  }
+  else
+    advanceWalkersPbyP(sft, crowd, timers, step_context, recompute);
+
+  if (sft.qmcdrv_input.get_debug_checks() & DriverDebugChecks::CHECKGL_AFTER_MOVES)
+    checkLogAndGL(crowd, "checkGL_after_moves");
+
+  timers.hamiltonian_timer.start();
+  const RefVectorWithLeader<QMCHamiltonian> walker_hamiltonians(crowd.get_walker_hamiltonians()[0],
+                                                                crowd.get_walker_hamiltonians());
+  ResourceCollectionTeamLock<QMCHamiltonian> hams_res_lock(crowd.getSharedResource().ham_res, walker_hamiltonians);
+  std::vector<QMCHamiltonian::FullPrecRealType> local_energies(
+      ham_dispatcher.flex_evaluate(walker_hamiltonians, walker_twfs, walker_elecs));
+  timers.hamiltonian_timer.stop();
+
+  auto resetSigNLocalEnergy = [](MCPWalker& walker, TrialWaveFunction& twf, auto& local_energy) {
+    walker.resetProperty(twf.getLogPsi(), twf.getPhase(), local_energy);
+  };
+  for (int iw = 0; iw < crowd.size(); ++iw)
+    resetSigNLocalEnergy(walkers[iw], walker_twfs[iw], local_energies[iw]);
+
+  // moved to be consistent with DMC
+  timers.collectables_timer.start();
+  auto evaluateNonPhysicalHamiltonianElements = [&sft, accumulate_this_step](QMCHamiltonian& ham, ParticleSet& pset,
+                                                                           MCPWalker& walker) {
+    ham.auxHevaluate(pset, walker, sft.step, sft.block_steps, accumulate_this_step);
+  };
+  for (int iw = 0; iw < crowd.size(); ++iw)
+    evaluateNonPhysicalHamiltonianElements(walker_hamiltonians[iw], walker_elecs[iw], walkers[iw]);
+
+  auto savePropertiesIntoWalker = [](QMCHamiltonian& ham, MCPWalker& walker) {
+    ham.saveProperty(walker.getPropertyBase());
+  };
+  for (int iw = 0; iw < crowd.size(); ++iw)
+    savePropertiesIntoWalker(walker_hamiltonians[iw], walkers[iw]);
+  timers.collectables_timer.stop();
+
+  if (accumulate_this_step)
+  {
+    ScopedTimer est_timer(timers.estimators_timer);
+    crowd.accumulate(step_context.get_random_gen());
+  }
+  // TODO:
+  //  check if all moves failed
+}
+
+
+void VMCBatched::advanceWalkersPbyP(const StateForThread& sft,
+                                    Crowd& crowd,
+                                    QMCDriverNew::DriverTimers& timers,
+                                    ContextForSteps& step_context,
+                                    bool recompute)
+{
+  auto& ps_dispatcher  = crowd.dispatchers_.ps_dispatcher_;
+  auto& twf_dispatcher = crowd.dispatchers_.twf_dispatcher_;
+  const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
+  const RefVectorWithLeader<TrialWaveFunction> walker_twfs(crowd.get_walker_twfs()[0], crowd.get_walker_twfs());
+
   timers.movepbyp_timer.start();
   const int num_walkers = crowd.size();
   // Note std::vector<bool> is not like the rest of stl.
   std::vector<bool> moved(num_walkers, false);
   constexpr RealType mhalf(-0.5);
-  const bool use_drift = sft.vmcdrv_input.get_use_drift();
+  const bool use_drift          = sft.vmcdrv_input.get_use_drift();
+  const bool batched_acceptance = sft.qmcdrv_input.get_batched_acceptance();
   std::vector<TrialWaveFunction::GradType> grads_now(num_walkers);
   std::vector<TrialWaveFunction::GradType> grads_new(num_walkers);
   std::vector<TrialWaveFunction::PsiValueType> ratios(num_walkers);
@@ -75,6 +144,13 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
   std::vector<RealType> log_gb(num_walkers);
   std::vector<RealType> prob(num_walkers);
 
+  // spins are moved together with the positions and the ratios include the spin gradients
+  const bool is_spinor     = walker_elecs.getLeader().isSpinor();
+  const RealType spin_mass = sft.qmcdrv_input.get_spin_mass();
+  std::vector<TrialWaveFunction::ComplexType> spingrads_now(is_spinor ? num_walkers : 0);
+  std::vector<TrialWaveFunction::ComplexType> spingrads_new(is_spinor ? num_walkers : 0);
+  std::vector<ParticleSet::Scalar_t> spin_drifts(is_spinor ? num_walkers : 0);
+
   // local list to handle accept/reject
   std::vector<bool> isAccepted;
   std::vector<std::reference_wrapper<TrialWaveFunction>> twf_accept_list, twf_reject_list;
@@ -84,6 +160,10 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
   {
     //This generates an entire steps worth of deltas.
     step_context.nextDeltaRs(num_walkers * sft.population.get_num_particles());
+    if (is_spinor)
+      step_context.nextDeltaSpins(num_walkers * sft.population.get_num_particles());
+    if (batched_acceptance)
+      step_context.nextAcceptUniforms(num_walkers * sft.population.get_num_particles());
 
     // up and down electrons are "species" within qmpack
     for (int ig = 0; ig < step_context.get_num_groups(); ++ig) //loop over species
@@ -91,6 +171,9 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
       RealType tauovermass = sft.qmcdrv_input.get_tau() * sft.population.get_ptclgrp_inv_mass()[ig];
       RealType oneover2tau = 0.5 / (tauovermass);
       RealType sqrttau     = std::sqrt(tauovermass);
+      // the spin moves of the legacy SOVMCUpdatePbyP
+      const RealType spin_tauovermass = tauovermass / spin_mass;
+      const RealType spin_sqrttau     = std::sqrt(spin_tauovermass);
 
       twf_dispatcher.flex_prepareGroup(walker_twfs, walker_elecs, ig);
 
@@ -105,7 +188,13 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
 
         if (use_drift)
         {
-          twf_dispatcher.flex_evalGrad(walker_twfs, walker_elecs, iat, grads_now);
+          if (is_spinor)
+          {
+            twf_dispatcher.flex_evalGradWithSpin(walker_twfs, walker_elecs, iat, grads_now, spingrads_now);
+            sft.drift_modifier.getDrifts(spin_tauovermass, spingrads_now, spin_drifts);
+          }
+          else
+            twf_dispatcher.flex_evalGrad(walker_twfs, walker_elecs, iat, grads_now);
           sft.drift_modifier.getDrifts(tauovermass, grads_now, drifts);
 
           std::transform(drifts.begin(), drifts.end(), delta_r_start, drifts.begin(),
@@ -117,14 +206,27 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
         {
           std::transform(delta_r_start, delta_r_end, drifts.begin(),
                          [sqrttau](const PosType& delta_r) { return sqrttau * delta_r; });
+          if (is_spinor)
+            std::fill(spin_drifts.begin(), spin_drifts.end(), 0);
         }
 
-        ps_dispatcher.flex_makeMove(walker_elecs, iat, drifts);
+        if (is_spinor)
+        {
+          const auto* delta_spins = step_context.get_walker_spin_deltas().data() + iat * num_walkers;
+          for (int iw = 0; iw < num_walkers; ++iw)
+            spin_drifts[iw] += spin_sqrttau * delta_spins[iw];
+          ps_dispatcher.flex_makeMoveWithSpin(walker_elecs, iat, drifts, spin_drifts);
+        }
+        else
+          ps_dispatcher.flex_makeMove(walker_elecs, iat, drifts);
 
         // This is inelegant
         if (use_drift)
         {
-          twf_dispatcher.flex_calcRatioGrad(walker_twfs, walker_elecs, iat, ratios, grads_new);
+          if (is_spinor)
+            twf_dispatcher.flex_calcRatioGradWithSpin(walker_twfs, walker_elecs, iat, ratios, grads_new, spingrads_new);
+          else
+            twf_dispatcher.flex_calcRatioGrad(walker_twfs, walker_elecs, iat, ratios, grads_new);
           std::transform(delta_r_start, delta_r_end, log_gf.begin(),
                          [](const PosType& delta_r) { return mhalf * dot(delta_r, delta_r); });
 
@@ -137,6 +239,19 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
 
           std::transform(drifts.begin(), drifts.end(), log_gb.begin(),
                          [oneover2tau](const PosType& drift) { return -oneover2tau * dot(drift, drift); });
+
+          if (is_spinor)
+          {
+            sft.drift_modifier.getDrifts(spin_tauovermass, spingrads_new, spin_drifts);
+            const auto* delta_spins = step_context.get_walker_spin_deltas().data() + iat * num_walkers;
+            for (int iw = 0; iw < num_walkers; ++iw)
+            {
+              const ParticleSet& elecs = walker_elecs[iw];
+              const auto ds            = elecs.spins[iat] - elecs.getActiveSpinVal() - spin_drifts[iw];
+              log_gb[iw] += -spin_mass * oneover2tau * ds * ds;
+              log_gf[iw] += mhalf * delta_spins[iw] * delta_spins[iw];
+            }
+          }
         }
         else
         {
@@ -147,18 +262,29 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
 
         isAccepted.clear();
 
-        for (int i_accept = 0; i_accept < num_walkers; ++i_accept)
-          if (prob[i_accept] >= std::numeric_limits<RealType>::epsilon() &&
-              step_context.get_random_gen()() < prob[i_accept] * std::exp(log_gb[i_accept] - log_gf[i_accept]))
-          {
-            crowd.incAccept();
-            isAccepted.push_back(true);
-          }
-          else
-          {
-            crowd.incReject();
-            isAccepted.push_back(false);
-          }
+        if (batched_acceptance)
+        {
+          for (int iw = 0; iw < num_walkers; ++iw)
+            prob[iw] = prob[iw] >= std::numeric_limits<RealType>::epsilon()
+                ? prob[iw] * std::exp(log_gb[iw] - log_gf[iw])
+                : RealType(0);
+          const int num_accepted = step_context.acceptMoves(iat, prob, isAccepted);
+          crowd.incAccept(num_accepted);
+          crowd.incReject(num_walkers - num_accepted);
+        }
+        else
+          for (int i_accept = 0; i_accept < num_walkers; ++i_accept)
+            if (prob[i_accept] >= std::numeric_limits<RealType>::epsilon() &&
+                step_context.get_random_gen()() < prob[i_accept] * std::exp(log_gb[i_accept] - log_gf[i_accept]))
+            {
+              crowd.incAccept();
+              isAccepted.push_back(true);
+            }
+            else
+            {
+              crowd.incReject();
+              isAccepted.push_back(false);
+            }
 
         twf_dispatcher.flex_accept_rejectMove(walker_twfs, walker_elecs, iat, isAccepted, true);
 
@@ -173,49 +299,9 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
 
   timers.buffer_timer.start();
   twf_dispatcher.flex_evaluateGL(walker_twfs, walker_elecs, recompute);
-  if (sft.qmcdrv_input.get_debug_checks() & DriverDebugChecks::CHECKGL_AFTER_MOVES)
-    checkLogAndGL(crowd, "checkGL_after_moves");
   timers.buffer_timer.stop();
-
-  timers.hamiltonian_timer.start();
-  const RefVectorWithLeader<QMCHamiltonian> walker_hamiltonians(crowd.get_walker_hamiltonians()[0],
-                                                                crowd.get_walker_hamiltonians());
-  ResourceCollectionTeamLock<QMCHamiltonian> hams_res_lock(crowd.getSharedResource().ham_res, walker_hamiltonians);
-  std::vector<QMCHamiltonian::FullPrecRealType> local_energies(
-      ham_dispatcher.flex_evaluate(walker_hamiltonians, walker_twfs, walker_elecs));
-  timers.hamiltonian_timer.stop();
-
-  auto resetSigNLocalEnergy = [](MCPWalker& walker, TrialWaveFunction& twf, auto& local_energy) {
-    walker.resetProperty(twf.getLogPsi(), twf.getPhase(), local_energy);
-  };
-  for (int iw = 0; iw < crowd.size(); ++iw)
-    resetSigNLocalEnergy(walkers[iw], walker_twfs[iw], local_energies[iw]);
-
-  // moved to be consistent with DMC
-  timers.collectables_timer.start();
-  auto evaluateNonPhysicalHamiltonianElements = [](QMCHamiltonian& ham, ParticleSet& pset, MCPWalker& walker) {
-    ham.auxHevaluate(pset, walker);
-  };
-  for (int iw = 0; iw < crowd.size(); ++iw)
-    evaluateNonPhysicalHamiltonianElements(walker_hamiltonians[iw], walker_elecs[iw], walkers[iw]);
-
-  auto savePropertiesIntoWalker = [](QMCHamiltonian& ham, MCPWalker& walker) {
-    ham.saveProperty(walker.getPropertyBase());
-  };
-  for (int iw = 0; iw < crowd.size(); ++iw)
-    savePropertiesIntoWalker(walker_hamiltonians[iw], walkers[iw]);
-  timers.collectables_timer.stop();
-
-  if (accumulate_this_step)
-  {
-    ScopedTimer est_timer(timers.estimators_timer);
-    crowd.accumulate(step_context.get_random_gen());
-  }
-  // TODO:
-  //  check if all moves failed
 }
 
-
 /** Thread body for VMC step
  *
  */
@@ -227,13 +313,14 @@ void VMCBatched::runVMCStep(int crowd_id,
 {
   Crowd& crowd = *(crowds[crowd_id]);
   crowd.setRNGForHamiltonian(context_for_steps[crowd_id]->get_random_gen());
-  const int max_steps  = sft.qmcdrv_input.get_max_steps();
   const IndexType step = sft.step;
   // Are we entering the the last step of a block to recompute at?
-  const bool recompute_this_step = (sft.is_recomputing_block && (step + 1) == max_steps);
+  const bool recompute_this_step = (sft.is_recomputing_block && (step + 1) == sft.block_steps);
   // For VMC we don't call this method for warmup steps.
   const bool accumulate_this_step = true;
   advanceWalkers(sft, crowd, timers, *context_for_steps[crowd_id], recompute_this_step, accumulate_this_step);
+  if (sft.sample_accumulator && crowd.size() > 0)
+    sft.sample_accumulator->evaluateCrowdSamples(crowd_id, crowd.get_walker_elecs());
 }
 
 void VMCBatched::process(xmlNodePtr node)
@@ -244,7 +331,9 @@ void VMCBatched::process(xmlNodePtr node)
   {
     QMCDriverNew::AdjustedWalkerCounts awc =
         adjustGlobalWalkerCount(myComm->size(), myComm->rank(), qmcdriver_input_.get_total_walkers(),
-                                qmcdriver_input_.get_walkers_per_rank(), 1.0, qmcdriver_input_.get_num_crowds());
+                                qmcdriver_input_.get_walkers_per_rank(), 1.0, qmcdriver_input_.get_num_crowds(),
+                                getMultiWalkerMemoryPerWalker(),
+                                static_cast<size_t>(qmcdriver_input_.get_walker_memory_budget()) << 20);
 
     Base::startup(node, awc);
   }
@@ -285,16 +374,22 @@ bool VMCBatched::run()
   LoopTimer<> vmc_loop;
   RunTimeControl<> runtimeControl(run_time_manager, project_data_.getMaxCPUSeconds(), project_data_.getTitle(),
                                   myComm->rank() == 0);
+  const double finish_time = run_time_manager.elapsed() + qmcdriver_input_.get_target_time();
+  vmc_state.block_steps    = qmcdriver_input_.get_max_steps();
 
   { // walker initialization
     ScopedTimer local_timer(timers_.init_walkers_timer);
-    ParallelExecutor<> section_start_task;
+    startup_profile.push("InitialLogEvaluation");
+    ParallelExecutor<> section_start_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
     section_start_task(crowds_.size(), initialLogEvaluation, std::ref(crowds_), std::ref(step_contexts_));
+    startup_profile.pop();
   }
 
+  // the first step follows
+  startup_profile.finish(myComm);
   print_mem("VMCBatched after initialLogEvaluation", app_summary());
 
-  ParallelExecutor<> crowd_task;
+  ParallelExecutor<> crowd_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
 
   if (qmcdriver_input_.get_warmup_steps() > 0)
   {
@@ -318,8 +413,20 @@ bool VMCBatched::run()
     print_mem("VMCBatched after Warmup", app_log());
   }
 
+  if (sample_accumulator_)
+  {
+    std::vector<int> walkers_per_crowd;
+    for (const auto& crowd : crowds_)
+      walkers_per_crowd.push_back(crowd->size());
+    sample_accumulator_->startAccumulation(walkers_per_crowd);
+    vmc_state.sample_accumulator = sample_accumulator_;
+  }
+
   for (int block = 0; block < num_blocks; ++block)
   {
+    timer_trace.startBlock();
+    if (block_metrics_)
+      block_metrics_->startBlock();
     vmc_loop.start();
     vmc_state.recalculate_properties_period =
         (qmc_driver_mode_[QMC_UPDATE_MODE]) ? qmcdriver_input_.get_recalculate_properties_period() : 0;
@@ -327,11 +434,11 @@ bool VMCBatched::run()
         ? (1 + block) % qmcdriver_input_.get_blocks_between_recompute() == 0
         : false;
 
-    estimator_manager_->startBlock(qmcdriver_input_.get_max_steps());
+    estimator_manager_->startBlock(vmc_state.block_steps);
 
     for (auto& crowd : crowds_)
-      crowd->startBlock(qmcdriver_input_.get_max_steps());
-    for (int step = 0; step < qmcdriver_input_.get_max_steps(); ++step)
+      crowd->startBlock(vmc_state.block_steps);
+    for (int step = 0; step < vmc_state.block_steps; ++step)
     {
       ScopedTimer local_timer(timers_.run_steps_timer);
       vmc_state.step = step;
@@ -345,16 +452,19 @@ bool VMCBatched::run()
           samples_.appendSample(MCSample(*walker));
         }
       }
+      if (sample_accumulator_ && sample_accumulator_->accumulateStep())
+      {
+        // the walkers continue with the new parameters, their stored values are recomputed
+        population_.set_variational_parameters(sample_accumulator_->getVariationalParameters());
+        crowd_task(crowds_.size(), initialLogEvaluation, std::ref(crowds_), std::ref(step_contexts_));
+      }
     }
     print_mem("VMCBatched after a block", app_debug_stream());
-    endBlock();
-    vmc_loop.stop();
+    endBlock(vmc_state.block_steps);
+    vmc_loop.stop(vmc_state.block_steps);
 
-    bool stop_requested = false;
-    // Rank 0 decides whether the time limit was reached
-    if (!myComm->rank())
-      stop_requested = runtimeControl.checkStop(vmc_loop);
-    myComm->bcast(stop_requested);
+    const bool stop_requested =
+        checkStop(runtimeControl, vmc_loop, finish_time, num_blocks - block - 1, vmc_state.block_steps);
 
     if (stop_requested)
     {
@@ -363,6 +473,8 @@ bool VMCBatched::run()
       run_time_manager.markStop();
       break;
     }
+    if (isTargetErrorReached("VMCBatched", block))
+      break;
   }
   // This is confusing logic from VMC.cpp want this functionality write documentation of this
   // and clean it up
@@ -390,6 +502,9 @@ bool VMCBatched::run()
     app_log() << o.str() << std::endl;
   }
 
+  if (sample_accumulator_)
+    sample_accumulator_->stopAccumulation();
+
   print_mem("VMCBatched ends", app_log());
 
   estimator_manager_->stopDriverRun();
@@ -408,4 +523,14 @@ void VMCBatched::enable_sample_collection()
   app_log() << "                                      total samples    = " << total_samples << '\n';
 }
 
+void VMCBatched::enable_sample_accumulation(StreamingSampleAccumulator& accumulator)
+{
+  sample_accumulator_ = &accumulator;
+  collect_samples_    = false;
+
+  int total_samples = compute_samples_per_rank(qmcdriver_input_, population_.get_num_local_walkers()) *
+      population_.get_num_ranks();
+  app_log() << "VMCBatched Driver streaming samples, total samples = " << total_samples << '\n';
+}
+
 } // namespace qmcplusplus
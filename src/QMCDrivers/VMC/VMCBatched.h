@@ -18,6 +18,7 @@
 #include "QMCDrivers/MCPopulation.h"
 #include "QMCDrivers/ContextForSteps.h"
 #include "QMCDrivers/GreenFunctionModifiers/DriftModifierBase.h"
+#include "QMCDrivers/StreamingSampleAccumulator.h"
 
 #include "Utilities/Timer.h"
 
@@ -29,7 +30,7 @@ class VMCBatchedTest;
 }
 
 /** @ingroup QMCDrivers  ParticleByParticle
- * @brief Implements a VMC using particle-by-particle move. Threaded execution.
+ * @brief Implements a VMC using particle-by-particle or all-electron moves. Threaded execution.
  */
 class VMCBatched : public QMCDriverNew
 {
@@ -52,7 +53,11 @@ public:
     const MCPopulation& population;
     IndexType recalculate_properties_period;
     IndexType step            = -1;
+    /// steps of the current block, fewer than the input steps when the block is shortened
+    IndexType block_steps     = 0;
     bool is_recomputing_block = false;
+    /// evaluates the walkers after each step when samples are streamed
+    StreamingSampleAccumulator* sample_accumulator = nullptr;
 
     StateForThread(const QMCDriverInput& qmci,
                    const VMCDriverInput& vmci,
@@ -87,6 +92,14 @@ public:
                              bool recompute,
                              bool accumulate_this_step);
 
+  /** particle-by-particle moves of the sub steps and the update of G and L of the walkers of a crowd
+   */
+  static void advanceWalkersPbyP(const StateForThread& sft,
+                                 Crowd& crowd,
+                                 DriverTimers& timers,
+                                 ContextForSteps& move_context,
+                                 bool recompute);
+
   // This is the task body executed at crowd scope
   // it does not have access to object member variables by design
   static void runVMCStep(int crowd_id,
@@ -108,6 +121,13 @@ public:
    */
   void enable_sample_collection();
 
+  /** Stream the samples to an accumulator instead of collecting them
+   *
+   *  The accumulator evaluates the walkers of each crowd after every step,
+   *  nothing is stored in the SampleStack.
+   */
+  void enable_sample_accumulation(StreamingSampleAccumulator& accumulator);
+
 private:
   int prevSteps;
   int prevStepsBetweenSamples;
@@ -125,6 +145,8 @@ private:
   SampleStack& samples_;
   /// Sample collection flag
   bool collect_samples_;
+  /// consumer of the samples when they are streamed, not owned
+  StreamingSampleAccumulator* sample_accumulator_;
   /** function to calculate samples per MPI rank
    */
   static int compute_samples_per_rank(const QMCDriverInput& qmcdriver_input, const IndexType local_walkers);
@@ -21,6 +21,8 @@
  * Tests for variational parameter derivatives
  *
  * This optimization type will compare finite difference derivatives with the analytic derivatives.
+ * Each finite difference is a correlated sampling of the cost at shifted parameters, evaluated in batches over
+ * the samples of all the crowds and ranks without recomputing the parameter derivatives.
  * It can also output a file that can be used with 'qmca' to get error bars.
  *
  * The input is placed under the batched linear optimizer (method="opt_batch").
@@ -65,8 +65,9 @@ QMCCostFunctionBase::QMCCostFunctionBase(MCWalkerConfiguration& w,
   //default: don't check fo MinNumWalkers
   MinNumWalkers = 0.3;
   SumValue.resize(SUM_INDEX_SIZE, 0.0);
-  IsValid      = true;
-  useNLPPDeriv = false;
+  IsValid               = true;
+  useNLPPDeriv          = false;
+  use_linear_fast_path_ = true;
 #if defined(QMCCOSTFUNCTION_DEBUG)
   char fname[16];
   sprintf(fname, "optdebug.p%d", OHMMS::Controller->mycontext());
@@ -330,6 +331,7 @@ bool QMCCostFunctionBase::put(xmlNodePtr q)
   std::string writeXmlPerStep("no");
   std::string computeNLPPderiv("no");
   std::string output_override_str("no");
+  std::string linear_fast_path_str("yes");
   ParameterSet m_param;
   m_param.add(writeXmlPerStep, "dumpXML");
   m_param.add(MinNumWalkers, "minwalkers");
@@ -341,8 +343,11 @@ bool QMCCostFunctionBase::put(xmlNodePtr q)
   m_param.add(targetExcitedStr, "targetExcited");
   m_param.add(omega_shift, "omega");
   m_param.add(output_override_str, "output_vp_override", {"no", "yes"});
+  m_param.add(linear_fast_path_str, "linear_fast_path", {"yes", "no"});
   m_param.put(q);
 
+  use_linear_fast_path_ = (linear_fast_path_str == "yes");
+
   targetExcitedStr = lowerCase(targetExcitedStr);
   targetExcited    = (targetExcitedStr == "yes");
 
@@ -134,6 +134,50 @@ public:
 
   virtual Return_rt fillOverlapHamiltonianMatrices(Matrix<Return_rt>& Left, Matrix<Return_rt>& Right) = 0;
 
+  /** diagonals of the matrices of fillOverlapHamiltonianMatrices, for the matrix-free linear method
+   *
+   *  Must be called before applyOverlapHamiltonian for a new set of samples.
+   */
+  virtual Return_rt fillOverlapHamiltonianDiagonals(std::vector<Return_rt>& Left, std::vector<Return_rt>& Right)
+  {
+    throw std::runtime_error(
+        "QMCCostFunctionBase::fillOverlapHamiltonianDiagonals is not supported by this cost function");
+  }
+
+  /** products of the matrices of fillOverlapHamiltonianMatrices with a vector, without building the matrices
+   * @param x       vector of length NumOptimizables+1
+   * @param Left_x  Hamiltonian matrix times x
+   * @param Right_x overlap matrix times x
+   */
+  virtual void applyOverlapHamiltonian(const std::vector<Return_rt>& x,
+                                       std::vector<Return_rt>& Left_x,
+                                       std::vector<Return_rt>& Right_x)
+  {
+    throw std::runtime_error("QMCCostFunctionBase::applyOverlapHamiltonian is not supported by this cost function");
+  }
+
+  /** energy gradient and diagonal of the overlap matrix of the parameter derivatives, for stochastic reconstruction
+   *
+   *  Must be called before applyParameterOverlap for a new set of samples.
+   * @param gradient derivatives of the energy with respect to the parameters
+   * @param S_diag   diagonal of the overlap matrix
+   * @return the energy
+   */
+  virtual Return_rt fillEnergyGradientOverlapDiagonal(std::vector<Return_rt>& gradient, std::vector<Return_rt>& S_diag)
+  {
+    throw std::runtime_error(
+        "QMCCostFunctionBase::fillEnergyGradientOverlapDiagonal is not supported by this cost function");
+  }
+
+  /** product of the overlap matrix of the parameter derivatives with a vector, without building the matrix
+   * @param x   vector of length NumOptimizables
+   * @param S_x overlap matrix times x
+   */
+  virtual void applyParameterOverlap(const std::vector<Return_rt>& x, std::vector<Return_rt>& S_x)
+  {
+    throw std::runtime_error("QMCCostFunctionBase::applyParameterOverlap is not supported by this cost function");
+  }
+
 #ifdef HAVE_LMY_ENGINE
   Return_rt LMYEngineCost(const bool needDeriv, cqmc::engine::LMYEngine<Return_t>* EngineObj);
 #endif
@@ -181,6 +225,8 @@ protected:
   bool Write2OneXml;
   ///if true, use analytic derivatives for the non-local potential component
   bool useNLPPDeriv;
+  ///if true, correlated sampling over changes of linear parameters only uses the stored derivatives
+  bool use_linear_fast_path_;
   /** |E-E_T|^PowerE is used for the cost function
    *
    * default PowerE=1
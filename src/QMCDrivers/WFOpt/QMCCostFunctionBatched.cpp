@@ -23,6 +23,7 @@
 #include "Message/CommOperators.h"
 #include "QMCDrivers/Optimizers/DescentEngine.h"
 #include "Concurrency/ParallelExecutor.hpp"
+#include "CPU/BLAS.hpp"
 //#define QMCCOSTFUNCTION_DEBUG
 
 namespace qmcplusplus
@@ -38,6 +39,13 @@ QMCCostFunctionBatched::QMCCostFunctionBatched(MCWalkerConfiguration& w,
       samples_(samples),
       opt_batch_size_(crowd_size),
       opt_num_crowds_(num_opt_crowds),
+      samples_streamed_(false),
+      stream_e_(0.0),
+      stream_e2_(0.0),
+      stream_count_(0.0),
+      descent_engine_(nullptr),
+      descent_update_steps_(1),
+      descent_pending_steps_(0),
       check_config_timer_(
           *timer_manager.createTimer("QMCCostFunctionBatched::checkConfigurations", timer_level_medium)),
       corr_sampling_timer_(
@@ -59,17 +67,23 @@ void QMCCostFunctionBatched::GradCost(std::vector<Return_rt>& PGradient,
 {
   if (FiniteDiff > 0)
   {
-    QMCTraits::RealType dh = 1.0 / (2.0 * FiniteDiff);
+    // The shifted costs only need the new energies and weights, the derivative records would be recomputed
+    // for every parameter at each shift. The numeric gradient must not come from the stored derivatives either.
+    const bool use_linear_fast_path = use_linear_fast_path_;
+    use_linear_fast_path_           = false;
+    QMCTraits::RealType dh          = 1.0 / (2.0 * FiniteDiff);
+    for (int j = 0; j < NumOptimizables; j++)
+      OptVariables[j] = PM[j];
     for (int i = 0; i < NumOptimizables; i++)
     {
-      for (int j = 0; j < NumOptimizables; j++)
-        OptVariables[j] = PM[j];
       OptVariables[i]               = PM[i] + FiniteDiff;
-      QMCTraits::RealType CostPlus  = this->Cost();
+      QMCTraits::RealType CostPlus  = this->Cost(false);
       OptVariables[i]               = PM[i] - FiniteDiff;
-      QMCTraits::RealType CostMinus = this->Cost();
+      QMCTraits::RealType CostMinus = this->Cost(false);
+      OptVariables[i]               = PM[i];
       PGradient[i]                  = (CostPlus - CostMinus) * dh;
     }
+    use_linear_fast_path_ = use_linear_fast_path;
   }
   else
   {
@@ -232,6 +246,42 @@ void compute_batch_parameters(int sample_size, int batch_size, int& num_batches,
   }
 }
 
+/** prepare the configurations loaded into a batch of crowd copies for the evaluation of the local energies
+ *  and the parameter derivatives: distance tables, log psi and the fixed gradients and laplacians
+ */
+void setupLoadedConfigurations(CostFunctionCrowdData& opt_data,
+                               const RefVectorWithLeader<ParticleSet>& p_list,
+                               const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                               const RefVectorWithLeader<QMCHamiltonian>& h_list,
+                               RefVector<ParticleSet::ParticleGradient>& dLogPsi,
+                               RefVector<ParticleSet::ParticleLaplacian>& d2LogPsi)
+{
+  for (int ib = 0; ib < p_list.size(); ib++)
+  {
+    // Set the RNG used in QMCHamiltonian.  This is used to offset the grid
+    // during spherical integration in the non-local pseudopotential.
+    // The RNG state gets reset to the same starting point in correlatedSampling
+    // to use the same grid offsets in the correlated sampling values.
+    // Currently this code sets the RNG to the same state for every configuration
+    // on this node.  Every configuration of electrons is different, and so in
+    // theory using the same spherical integration grid should not be a problem.
+    // If this needs to be changed, one possibility is to advance the RNG state
+    // differently for each configuration.  Make sure the same initialization is
+    // performed in correlatedSampling.
+    *opt_data.get_rng_ptr_list()[ib] = opt_data.get_rng_save();
+    h_list[ib].setRandomGenerator(opt_data.get_rng_ptr_list()[ib].get());
+  }
+
+  // Compute distance tables.
+  ParticleSet::mw_update(p_list);
+
+  // Log psi and prepare for difference the log psi
+  opt_data.zero_log_psi();
+
+  TrialWaveFunction::mw_evaluateDeltaLogSetup(wf_list, p_list, opt_data.get_log_psi_fixed(), opt_data.get_log_psi_opt(),
+                                              dLogPsi, d2LogPsi);
+}
+
 /** evaluate everything before optimization */
 void QMCCostFunctionBatched::checkConfigurations()
 {
@@ -321,31 +371,9 @@ void QMCCostFunctionBatched::checkConfigurations()
 
       // Load samples into the crowd data
       for (int ib = 0; ib < curr_crowd_size; ib++)
-      {
         samples.loadSample(p_list[ib], base_sample_index + ib);
 
-        // Set the RNG used in QMCHamiltonian.  This is used to offset the grid
-        // during spherical integration in the non-local pseudopotential.
-        // The RNG state gets reset to the same starting point in correlatedSampling
-        // to use the same grid offsets in the correlated sampling values.
-        // Currently this code sets the RNG to the same state for every configuration
-        // on this node.  Every configuration of electrons is different, and so in
-        // theory using the same spherical integration grid should not be a problem.
-        // If this needs to be changed, one possibility is to advance the RNG state
-        // differently for each configuration.  Make sure the same initialization is
-        // performed in correlatedSampling.
-        *opt_data.get_rng_ptr_list()[ib] = opt_data.get_rng_save();
-        h_list[ib].setRandomGenerator(opt_data.get_rng_ptr_list()[ib].get());
-      }
-
-      // Compute distance tables.
-      ParticleSet::mw_update(p_list);
-
-      // Log psi and prepare for difference the log psi
-      opt_data.zero_log_psi();
-
-      TrialWaveFunction::mw_evaluateDeltaLogSetup(wf_list, p_list, opt_data.get_log_psi_fixed(),
-                                                  opt_data.get_log_psi_opt(), ref_dLogPsi, ref_d2LogPsi);
+      setupLoadedConfigurations(opt_data, p_list, wf_list, h_list, ref_dLogPsi, ref_d2LogPsi);
 
       if (needGrads)
       {
@@ -425,12 +453,24 @@ void QMCCostFunctionBatched::checkConfigurations()
   }
 
   OptVariablesForPsi.setComputed();
+  samples_streamed_ = false;
+
+  // the records are the exact first order change of the wavefunction at these parameters
+  linear_ref_params_.clear();
+  if (needGrads)
+    for (int i = 0; i < OptVariablesForPsi.size(); i++)
+      linear_ref_params_.push_back(std::real(OptVariablesForPsi[i]));
+  reduceEnergySums(et_tot, e2_tot, static_cast<Return_rt>(rank_local_num_samples_));
+}
+
+void QMCCostFunctionBatched::reduceEnergySums(Return_rt e_sum, Return_rt e2_sum, Return_rt num_samples)
+{
   //     app_log() << "  VMC Efavg = " << eft_tot/static_cast<Return_t>(wPerNode[NumThreads]) << std::endl;
   //Need to sum over the processors
   std::vector<Return_rt> etemp(3);
-  etemp[0] = et_tot;
-  etemp[1] = static_cast<Return_rt>(rank_local_num_samples_);
-  etemp[2] = e2_tot;
+  etemp[0] = e_sum;
+  etemp[1] = num_samples;
+  etemp[2] = e2_sum;
   // Sum energy values over nodes
   myComm->allreduce(etemp);
   Etarget    = static_cast<Return_rt>(etemp[0] / etemp[1]);
@@ -453,6 +493,285 @@ void QMCCostFunctionBatched::checkConfigurations()
   SumValue[SUM_ABSE_BARE] = 0.0;
 }
 
+void QMCCostFunctionBatched::startAccumulation(const std::vector<int>& walkers_per_crowd)
+{
+  if (std::abs(w_beta) > 0.0)
+    throw std::runtime_error("QMCCostFunctionBatched: streamed samples only support energy minimization, w_beta must be 0");
+
+  const int num_crowds = walkers_per_crowd.size();
+  stream_crowd_offsets_.resize(num_crowds + 1);
+  stream_crowd_offsets_[0] = 0;
+  for (int i = 0; i < num_crowds; i++)
+    stream_crowd_offsets_[i + 1] = stream_crowd_offsets_[i] + walkers_per_crowd[i];
+  const int num_walkers = stream_crowd_offsets_[num_crowds];
+
+  // the crowd copies are cloned from Psi, which must hold the parameters the VMC walkers are sampled with
+  resetPsi(false);
+  Psi.startOptimization();
+
+  // fixed gradients and laplacians, one per walker
+  if (dLogPsi.size() != num_walkers)
+  {
+    delete_iter(dLogPsi.begin(), dLogPsi.end());
+    delete_iter(d2LogPsi.begin(), d2LogPsi.end());
+    int nptcl = W.getTotalNum();
+    dLogPsi.resize(num_walkers);
+    d2LogPsi.resize(num_walkers);
+    for (int i = 0; i < num_walkers; ++i)
+      dLogPsi[i] = new ParticleGradient(nptcl);
+    for (int i = 0; i < num_walkers; ++i)
+      d2LogPsi[i] = new ParticleLaplacian(nptcl);
+  }
+
+  // one set of copies per VMC crowd, the VMC RNG must not be reset during the run
+  outputManager.pause();
+  opt_eval_.resize(num_crowds);
+  for (int i = 0; i < num_crowds; i++)
+    opt_eval_[i] = std::make_unique<CostFunctionCrowdData>(std::max(1, std::min(opt_batch_size_, walkers_per_crowd[i])),
+                                                           W, Psi, H, H_KE_node_names_, *RngSaved[0]);
+  outputManager.resume();
+
+  resetStreamingMoments(num_walkers);
+  if (descent_engine_)
+  {
+    // the first order averages of the descent engine replace the moments
+    descent_engine_->prepareStorage(num_crowds, NumOptimizables);
+    descent_pending_steps_ = 0;
+  }
+}
+
+void QMCCostFunctionBatched::setStreamingDescent(DescentEngine* engine, int update_steps)
+{
+  descent_engine_       = engine;
+  descent_update_steps_ = update_steps;
+}
+
+void QMCCostFunctionBatched::resetStreamingMoments(int num_walkers)
+{
+  const int nparam = getNumParams();
+  StepDerivRecords_.resize(num_walkers, NumOptimizables);
+  StepHDerivRecords_.resize(num_walkers, NumOptimizables);
+  StepDerivEnergyRecords_.resize(num_walkers, NumOptimizables);
+  step_energies_.resize(num_walkers);
+
+  stream_e_     = 0.0;
+  stream_e2_    = 0.0;
+  stream_count_ = 0.0;
+
+  if (descent_engine_)
+    return;
+
+  stream_D_.assign(nparam, 0.0);
+  stream_HD_.assign(nparam, 0.0);
+  stream_DE_.assign(nparam, 0.0);
+  stream_DD_.resize(nparam, nparam);
+  stream_DHD_.resize(nparam, nparam);
+  stream_DDE_.resize(nparam, nparam);
+  stream_DD_  = 0.0;
+  stream_DHD_ = 0.0;
+  stream_DDE_ = 0.0;
+}
+
+void QMCCostFunctionBatched::evaluateCrowdSamples(int crowd_id, const RefVector<ParticleSet>& walker_elecs)
+{
+  CostFunctionCrowdData& opt_data = *opt_eval_[crowd_id];
+  OperatorBase* nlpp              = (includeNonlocalH == "no") ? nullptr : H.getHamiltonian(includeNonlocalH);
+  const bool compute_nlpp         = useNLPPDeriv && nlpp;
+  const int crowd_size            = opt_data.get_wf_ptr_list().size();
+  const int nparam                = OptVariablesForPsi.size();
+
+  int num_batches;
+  int final_batch_size;
+  compute_batch_parameters(walker_elecs.size(), crowd_size, num_batches, final_batch_size);
+
+  for (int inb = 0; inb < num_batches; inb++)
+  {
+    const int curr_crowd_size   = (inb == num_batches - 1) ? final_batch_size : crowd_size;
+    const int first_walker      = inb * crowd_size;
+    const int base_record_index = stream_crowd_offsets_[crowd_id] + first_walker;
+
+    auto wf_list_no_leader = opt_data.get_wf_list(curr_crowd_size);
+    auto p_list_no_leader  = opt_data.get_p_list(curr_crowd_size);
+    auto h_list_no_leader  = opt_data.get_h_list(curr_crowd_size);
+    const RefVectorWithLeader<ParticleSet> p_list(p_list_no_leader[0], p_list_no_leader);
+    const RefVectorWithLeader<TrialWaveFunction> wf_list(wf_list_no_leader[0], wf_list_no_leader);
+    const RefVectorWithLeader<QMCHamiltonian> h_list(h_list_no_leader[0], h_list_no_leader);
+
+    ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(opt_data.getSharedResource().pset_res, p_list);
+    ResourceCollectionTeamLock<TrialWaveFunction> twfs_res_lock(opt_data.getSharedResource().twf_res, wf_list);
+    ResourceCollectionTeamLock<QMCHamiltonian> hams_res_lock(opt_data.getSharedResource().ham_res, h_list);
+
+    auto ref_dLogPsi  = convertPtrToRefVectorSubset(dLogPsi, base_record_index, curr_crowd_size);
+    auto ref_d2LogPsi = convertPtrToRefVectorSubset(d2LogPsi, base_record_index, curr_crowd_size);
+
+    // copy the walker configurations, as SampleStack::loadSample
+    for (int ib = 0; ib < curr_crowd_size; ib++)
+    {
+      const ParticleSet& walker_elec = walker_elecs[first_walker + ib];
+      p_list[ib].R                   = walker_elec.R;
+      p_list[ib].spins               = walker_elec.spins;
+    }
+
+    setupLoadedConfigurations(opt_data, p_list, wf_list, h_list, ref_dLogPsi, ref_d2LogPsi);
+
+    RecordArray<Return_t> dlogpsi_array(nparam, curr_crowd_size);
+    RecordArray<Return_t> dhpsioverpsi_array(nparam, curr_crowd_size);
+    TrialWaveFunction::mw_evaluateParameterDerivatives(wf_list, p_list, OptVariablesForPsi, dlogpsi_array,
+                                                       dhpsioverpsi_array);
+    auto energy_list = QMCHamiltonian::mw_evaluateValueAndDerivatives(h_list, wf_list, p_list, OptVariablesForPsi,
+                                                                      dlogpsi_array, dhpsioverpsi_array, compute_nlpp);
+
+    for (int ib = 0; ib < curr_crowd_size; ib++)
+    {
+      const int is         = base_record_index + ib;
+      const Return_rt etmp = energy_list[ib];
+      for (int j = 0; j < nparam; j++)
+      {
+        StepDerivRecords_[is][j]       = std::real(dlogpsi_array.getValue(j, ib));
+        StepHDerivRecords_[is][j]      = std::real(dhpsioverpsi_array.getValue(j, ib));
+        StepDerivEnergyRecords_[is][j] = StepDerivRecords_[is][j] * etmp;
+      }
+      step_energies_[is] = etmp;
+    }
+  }
+}
+
+bool QMCCostFunctionBatched::accumulateStep()
+{
+  const int nparam      = getNumParams();
+  const int num_walkers = step_energies_.size();
+  const int ld          = StepDerivRecords_.cols();
+  if (num_walkers == 0)
+    return false;
+
+  for (int iw = 0; iw < num_walkers; iw++)
+  {
+    stream_e_ += step_energies_[iw];
+    stream_e2_ += step_energies_[iw] * step_energies_[iw];
+  }
+  stream_count_ += num_walkers;
+
+  if (descent_engine_)
+  {
+    takeDescentSamples();
+    if (++descent_pending_steps_ < descent_update_steps_)
+      return false;
+    updateDescentParameters();
+    return true;
+  }
+
+  // each crowd owns a block of rows of the moments, the products over the walkers of a step are rank-k updates
+  std::vector<int> params_per_crowd(opt_num_crowds_ + 1);
+  FairDivide(nparam, opt_num_crowds_, params_per_crowd);
+
+  auto updateMoments = [](int crowd_id, std::vector<int>& crowd_ranges, int nparam, int num_walkers, int ld,
+                          const Matrix<Return_rt>& D, const Matrix<Return_rt>& HD, const Matrix<Return_rt>& DE,
+                          std::vector<Return_rt>& sum_D, std::vector<Return_rt>& sum_HD,
+                          std::vector<Return_rt>& sum_DE, Matrix<Return_rt>& sum_DD, Matrix<Return_rt>& sum_DHD,
+                          Matrix<Return_rt>& sum_DDE) {
+    const int pm_start = crowd_ranges[crowd_id];
+    const int nrows    = crowd_ranges[crowd_id + 1] - pm_start;
+    if (nrows == 0)
+      return;
+
+    for (int iw = 0; iw < num_walkers; iw++)
+      for (int pm = pm_start; pm < pm_start + nrows; pm++)
+      {
+        sum_D[pm] += D[iw][pm];
+        sum_HD[pm] += HD[iw][pm];
+        sum_DE[pm] += DE[iw][pm];
+      }
+
+    // row-major sum(pm, pm2) += X[iw][pm] * Y[iw][pm2] is the column-major Y^T X update
+    const Return_rt one(1);
+    BLAS::gemm('N', 'T', nparam, nrows, num_walkers, one, D.data(), ld, D.data() + pm_start, ld, one,
+               sum_DD[pm_start], nparam);
+    BLAS::gemm('N', 'T', nparam, nrows, num_walkers, one, HD.data(), ld, D.data() + pm_start, ld, one,
+               sum_DHD[pm_start], nparam);
+    BLAS::gemm('N', 'T', nparam, nrows, num_walkers, one, D.data(), ld, DE.data() + pm_start, ld, one,
+               sum_DDE[pm_start], nparam);
+  };
+
+  ParallelExecutor<> crowd_tasks;
+  crowd_tasks(opt_num_crowds_, updateMoments, params_per_crowd, nparam, num_walkers, ld, StepDerivRecords_,
+              StepHDerivRecords_, StepDerivEnergyRecords_, stream_D_, stream_HD_, stream_DE_, stream_DD_, stream_DHD_,
+              stream_DDE_);
+  return false;
+}
+
+void QMCCostFunctionBatched::takeDescentSamples()
+{
+  const int nparam = getNumParams();
+
+  auto takeSamples = [](int crowd_id, const std::vector<int>& crowd_offsets, int nparam, const Matrix<Return_rt>& D,
+                        const Matrix<Return_rt>& HD, const std::vector<Return_rt>& energies, DescentEngine& engine) {
+    // <n|Psi_i>/<n|Psi> and <n|H|Psi_i>/<n|Psi>, with Psi_0 = Psi
+    std::vector<FullPrecValueType> der_rat_samp(nparam + 1);
+    std::vector<FullPrecValueType> le_der_samp(nparam + 1);
+    for (int iw = crowd_offsets[crowd_id]; iw < crowd_offsets[crowd_id + 1]; iw++)
+    {
+      der_rat_samp[0] = 1.0;
+      le_der_samp[0]  = energies[iw];
+      for (int j = 0; j < nparam; j++)
+      {
+        der_rat_samp[j + 1] = D[iw][j];
+        le_der_samp[j + 1]  = HD[iw][j] + energies[iw] * D[iw][j];
+      }
+      engine.takeSample(crowd_id, der_rat_samp, le_der_samp, le_der_samp, 1.0, 1.0);
+    }
+  };
+
+  ParallelExecutor<> crowd_tasks;
+  crowd_tasks(stream_crowd_offsets_.size() - 1, takeSamples, stream_crowd_offsets_, nparam, StepDerivRecords_,
+              StepHDerivRecords_, step_energies_, *descent_engine_);
+}
+
+void QMCCostFunctionBatched::updateDescentParameters()
+{
+  descent_engine_->sample_finish();
+  if (descent_engine_->getDescentNum() == 0)
+    descent_engine_->setupUpdate(OptVariables);
+  descent_engine_->storeDerivRecord();
+  descent_engine_->updateParameters();
+
+  const std::vector<ValueType>& new_params = descent_engine_->retrieveNewParams();
+  for (int i = 0; i < new_params.size(); i++)
+    OptVariables[i] = new_params[i];
+  // the crowd copies evaluate the next samples with the new parameters
+  resetPsi(false);
+
+  descent_engine_->prepareStorage(stream_crowd_offsets_.size() - 1, NumOptimizables);
+  descent_pending_steps_ = 0;
+}
+
+void QMCCostFunctionBatched::stopAccumulation()
+{
+  OptVariablesForPsi.setComputed();
+  samples_streamed_ = true;
+  linear_ref_params_.clear();
+
+  if (descent_engine_)
+  {
+    // the steps after the last update make one more, every rank took the same number of steps
+    if (descent_pending_steps_ > 0)
+      updateDescentParameters();
+    rank_local_num_samples_ = 0;
+    reduceEnergySums(stream_e_, stream_e2_, stream_count_);
+    return;
+  }
+
+  myComm->allreduce(stream_D_);
+  myComm->allreduce(stream_HD_);
+  myComm->allreduce(stream_DE_);
+  myComm->allreduce(stream_DD_);
+  myComm->allreduce(stream_DHD_);
+  myComm->allreduce(stream_DDE_);
+
+  // nothing is kept for correlated sampling
+  rank_local_num_samples_ = 0;
+  reduceEnergySums(stream_e_, stream_e2_, stream_count_);
+}
+
 #ifdef HAVE_LMY_ENGINE
 void QMCCostFunctionBatched::engine_checkConfigurations(cqmc::engine::LMYEngine<Return_t>* EngineObj,
                                                         DescentEngine& descentEngineObj,
@@ -650,15 +969,27 @@ QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::correlatedSampling(boo
     }
   };
 
-  ParallelExecutor<> crowd_tasks;
-  crowd_tasks(opt_num_crowds_, evalOptCorrelated, opt_eval_, samples_per_crowd, opt_batch_size_, dLogPsi, d2LogPsi,
-              RecordsOnNode_, DerivRecords_, HDerivRecords_, samples_, OptVariablesForPsi, compute_all_from_scratch,
-              vmc_or_dmc, needGrad, compute_nlpp);
-  // Sum weights over crowds
-  for (int i = 0; i < opt_eval_.size(); i++)
+  std::vector<Return_rt> linear_delta;
+  if (!needGrad && getLinearParameterChange(linear_delta))
   {
-    wgt_tot += opt_eval_[i]->get_wgt();
-    wgt_tot2 += opt_eval_[i]->get_wgt2();
+    // only linear parameters changed, the stored derivatives give the new wavefunction without evaluating it
+    evaluateLinearParameterChange(linear_delta, inv_n_samples, wgt_tot, wgt_tot2);
+  }
+  else
+  {
+    ParallelExecutor<> crowd_tasks;
+    crowd_tasks(opt_num_crowds_, evalOptCorrelated, opt_eval_, samples_per_crowd, opt_batch_size_, dLogPsi, d2LogPsi,
+                RecordsOnNode_, DerivRecords_, HDerivRecords_, samples_, OptVariablesForPsi, compute_all_from_scratch,
+                vmc_or_dmc, needGrad, compute_nlpp);
+    // Sum weights over crowds
+    for (int i = 0; i < opt_eval_.size(); i++)
+    {
+      wgt_tot += opt_eval_[i]->get_wgt();
+      wgt_tot2 += opt_eval_[i]->get_wgt2();
+    }
+    // the records now hold derivatives at other parameters
+    if (needGrad)
+      linear_ref_params_.clear();
   }
 
   //this is MPI barrier
@@ -723,6 +1054,82 @@ QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::correlatedSampling(boo
 }
 
 
+bool QMCCostFunctionBatched::getLinearParameterChange(std::vector<Return_rt>& delta) const
+{
+#if defined(QMC_COMPLEX)
+  // the records only keep the real part of the derivatives
+  return false;
+#else
+  const int nparam = OptVariablesForPsi.size();
+  if (!use_linear_fast_path_ || linear_ref_params_.size() != nparam || DerivRecords_.size2() != nparam)
+    return false;
+  // the recomputed non-local potential changes linearly only with its derivatives in the records
+  if (includeNonlocalH != "no" && !useNLPPDeriv)
+    return false;
+  delta.resize(nparam);
+  for (int i = 0; i < nparam; i++)
+  {
+    delta[i] = std::real(OptVariablesForPsi[i]) - linear_ref_params_[i];
+    if (delta[i] != 0 && OptVariablesForPsi.getType(i) != optimize::LINEAR_P)
+      return false;
+  }
+  return true;
+#endif
+}
+
+// For psi = sum_i c_i phi_i times factors not depending on the c_i, D_i = phi_i/psi and
+// HD_i = H phi_i/psi - E D_i, with E the part of the local energy recomputed by correlatedSampling.
+void QMCCostFunctionBatched::evaluateLinearParameterChange(const std::vector<Return_rt>& delta,
+                                                           Return_rt inv_n_samples,
+                                                           Return_rt& wgt_sum,
+                                                           Return_rt& wgt2_sum)
+{
+  std::vector<int> changed;
+  for (int i = 0; i < delta.size(); i++)
+    if (delta[i] != 0)
+      changed.push_back(i);
+
+  std::vector<int> samples_per_crowd(opt_num_crowds_ + 1);
+  FairDivide(rank_local_num_samples_, opt_num_crowds_, samples_per_crowd);
+  // [crowd][sum of the log weights, sum of their squares]
+  Matrix<Return_rt> crowd_wgt(opt_num_crowds_, 2);
+  crowd_wgt = 0.0;
+
+  auto evalLinearChange = [](int crowd_id, const std::vector<int>& crowd_ranges, Matrix<Return_rt>& records,
+                             const Matrix<Return_rt>& deriv_records, const Matrix<Return_rt>& hderiv_records,
+                             const std::vector<int>& changed, const std::vector<Return_rt>& delta,
+                             Return_rt vmc_or_dmc, Return_rt inv_n_samples, Matrix<Return_rt>& crowd_wgt) {
+    for (int is = crowd_ranges[crowd_id]; is < crowd_ranges[crowd_id + 1]; is++)
+    {
+      Return_rt* restrict saved = records[is];
+      const Return_rt* Dsaved   = deriv_records[is];
+      const Return_rt* HDsaved  = hderiv_records[is];
+      const Return_rt e_free    = saved[ENERGY_TOT] - saved[ENERGY_FIXED];
+      Return_rt psi_ratio(1), hpsi_ratio(e_free);
+      for (int i : changed)
+      {
+        psi_ratio += delta[i] * Dsaved[i];
+        hpsi_ratio += delta[i] * (HDsaved[i] + e_free * Dsaved[i]);
+      }
+      saved[ENERGY_NEW]      = saved[ENERGY_FIXED] + hpsi_ratio / psi_ratio;
+      const Return_rt weight = vmc_or_dmc * std::log(std::abs(psi_ratio));
+      saved[REWEIGHT]        = weight;
+      crowd_wgt(crowd_id, 0) += inv_n_samples * weight;
+      crowd_wgt(crowd_id, 1) += inv_n_samples * weight * weight;
+    }
+  };
+
+  ParallelExecutor<> crowd_tasks;
+  crowd_tasks(opt_num_crowds_, evalLinearChange, samples_per_crowd, RecordsOnNode_, DerivRecords_, HDerivRecords_,
+              changed, delta, vmc_or_dmc, inv_n_samples, crowd_wgt);
+  for (int crowd_id = 0; crowd_id < opt_num_crowds_; crowd_id++)
+  {
+    wgt_sum += crowd_wgt(crowd_id, 0);
+    wgt2_sum += crowd_wgt(crowd_id, 1);
+  }
+}
+
+
 // Construct the overlap and Hamiltonian matrices for the linear method
 // A sum over samples.  Inputs are
 //   DerivRecords - derivative of log psi ( d ln (psi) / dp = 1/psi * d psi / dp )
@@ -739,6 +1146,9 @@ QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonian
 {
   ScopedTimer tmp_timer(fill_timer_);
 
+  if (samples_streamed_)
+    return fillOverlapHamiltonianFromMoments(Left, Right);
+
   RealType b1, b2;
   if (GEVType == "H2")
   {
@@ -778,24 +1188,25 @@ QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonian
 
   myComm->allreduce(D_avg);
 
-  for (int iw = 0; iw < rank_local_num_samples_; iw++)
-  {
-    const Return_rt* restrict saved = RecordsOnNode_[iw];
-    Return_rt weight                = saved[REWEIGHT] * wgtinv;
-    Return_rt eloc_new              = saved[ENERGY_NEW];
-    const Return_rt* Dsaved         = DerivRecords_[iw];
-    const Return_rt* HDsaved        = HDerivRecords_[iw];
-
-    std::vector<int> params_per_crowd(opt_num_crowds_ + 1);
-    FairDivide(getNumParams(), opt_num_crowds_, params_per_crowd);
+  // each crowd owns a block of rows of the matrices and sweeps all the samples once
+  std::vector<int> params_per_crowd(opt_num_crowds_ + 1);
+  FairDivide(getNumParams(), opt_num_crowds_, params_per_crowd);
 
+  auto constructMatrices = [](int crowd_id, std::vector<int>& crowd_ranges, int numParams, int num_samples,
+                              const Matrix<Return_rt>& records, const Matrix<Return_rt>& deriv_records,
+                              const Matrix<Return_rt>& hderiv_records, Return_rt wgtinv, RealType H2_avg,
+                              RealType V_avg, std::vector<Return_rt>& D_avg, RealType b1, RealType b2,
+                              RealType curAvg_w, Matrix<Return_rt>& Left, Matrix<Return_rt>& Right) {
+    int local_pm_start = crowd_ranges[crowd_id];
+    int local_pm_end   = crowd_ranges[crowd_id + 1];
 
-    auto constructMatrices = [](int crowd_id, std::vector<int>& crowd_ranges, int numParams, const Return_rt* Dsaved,
-                                const Return_rt* HDsaved, Return_rt weight, Return_rt eloc_new, RealType H2_avg,
-                                RealType V_avg, std::vector<Return_rt>& D_avg, RealType b1, RealType b2,
-                                RealType curAvg_w, Matrix<Return_rt>& Left, Matrix<Return_rt>& Right) {
-      int local_pm_start = crowd_ranges[crowd_id];
-      int local_pm_end   = crowd_ranges[crowd_id + 1];
+    for (int iw = 0; iw < num_samples; iw++)
+    {
+      const Return_rt* restrict saved = records[iw];
+      Return_rt weight                = saved[REWEIGHT] * wgtinv;
+      Return_rt eloc_new              = saved[ENERGY_NEW];
+      const Return_rt* Dsaved         = deriv_records[iw];
+      const Return_rt* HDsaved        = hderiv_records[iw];
 
       for (int pm = local_pm_start; pm < local_pm_end; pm++)
       {
@@ -827,12 +1238,13 @@ QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonian
           Right(pm + 1, pm2 + 1) += b1 * H2_avg * varij;
         }
       }
-    };
+    }
+  };
 
-    ParallelExecutor<> crowd_tasks;
-    crowd_tasks(opt_num_crowds_, constructMatrices, params_per_crowd, getNumParams(), Dsaved, HDsaved, weight, eloc_new,
-                H2_avg, V_avg, D_avg, b1, b2, curAvg_w, Left, Right);
-  }
+  ParallelExecutor<> crowd_tasks;
+  crowd_tasks(opt_num_crowds_, constructMatrices, params_per_crowd, getNumParams(), rank_local_num_samples_,
+              RecordsOnNode_, DerivRecords_, HDerivRecords_, wgtinv, H2_avg, V_avg, D_avg, b1, b2, curAvg_w, Left,
+              Right);
   myComm->allreduce(Right);
   myComm->allreduce(Left);
   Left(0, 0)  = (1 - b2) * curAvg_w + b2 * V_avg;
@@ -842,4 +1254,304 @@ QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonian
 
   return 1.0;
 }
+
+// The energy minimization matrices of fillOverlapHamiltonianMatrices written with the unweighted sums over the samples,
+// with d = D - <D>:  S_ij = <d_i d_j>,  H_ij = <d_i (HD_j + d_j E)>,  H_0j = <HD_j + d_j E>,  H_i0 = <d_i E>
+QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonianFromMoments(Matrix<Return_rt>& Left,
+                                                                                            Matrix<Return_rt>& Right)
+{
+  const int nparam       = getNumParams();
+  curAvg_w               = SumValue[SUM_E_WGT] / SumValue[SUM_WGT];
+  const Return_rt wgtinv = 1.0 / SumValue[SUM_WGT];
+  std::vector<Return_rt> D_avg(nparam), HD_avg(nparam), DE_avg(nparam);
+  for (int pm = 0; pm < nparam; pm++)
+  {
+    D_avg[pm]  = stream_D_[pm] * wgtinv;
+    HD_avg[pm] = stream_HD_[pm] * wgtinv;
+    DE_avg[pm] = stream_DE_[pm] * wgtinv;
+  }
+
+  for (int pm = 0; pm < nparam; pm++)
+  {
+    const Return_rt dE = DE_avg[pm] - D_avg[pm] * curAvg_w;
+    Left(0, pm + 1)    = HD_avg[pm] + dE;
+    Left(pm + 1, 0)    = dE;
+    Right(0, pm + 1)   = 0.0;
+    Right(pm + 1, 0)   = 0.0;
+    for (int pm2 = 0; pm2 < nparam; pm2++)
+    {
+      Right(pm + 1, pm2 + 1) = stream_DD_(pm, pm2) * wgtinv - D_avg[pm] * D_avg[pm2];
+      Left(pm + 1, pm2 + 1)  = stream_DHD_(pm, pm2) * wgtinv - D_avg[pm] * HD_avg[pm2] +
+          stream_DDE_(pm, pm2) * wgtinv - D_avg[pm] * DE_avg[pm2] - D_avg[pm2] * DE_avg[pm] +
+          D_avg[pm] * D_avg[pm2] * curAvg_w;
+    }
+  }
+  Left(0, 0)  = curAvg_w;
+  Right(0, 0) = 1.0;
+  return 1.0;
+}
+
+void QMCCostFunctionBatched::getLinearMethodAverages(RealType& b1, RealType& b2, RealType& H2_avg, RealType& V_avg)
+{
+  if (GEVType == "H2")
+  {
+    b1 = w_beta;
+    b2 = 0;
+  }
+  else
+  {
+    b2 = w_beta;
+    b1 = 0;
+  }
+  curAvg_w            = SumValue[SUM_E_WGT] / SumValue[SUM_WGT];
+  Return_rt curAvg2_w = SumValue[SUM_ESQ_WGT] / SumValue[SUM_WGT];
+  H2_avg              = 1.0 / (curAvg_w * curAvg_w);
+  V_avg               = curAvg2_w - curAvg_w * curAvg_w;
+}
+
+void QMCCostFunctionBatched::computeDerivativeAverages()
+{
+  const int numParams    = getNumParams();
+  const Return_rt wgtinv = 1.0 / SumValue[SUM_WGT];
+
+  D_avg_.assign(numParams, 0.0);
+  for (int iw = 0; iw < rank_local_num_samples_; iw++)
+  {
+    const Return_rt* restrict saved = RecordsOnNode_[iw];
+    Return_rt weight                = saved[REWEIGHT] * wgtinv;
+    const Return_rt* Dsaved         = DerivRecords_[iw];
+    for (int pm = 0; pm < numParams; pm++)
+      D_avg_[pm] += Dsaved[pm] * weight;
+  }
+  myComm->allreduce(D_avg_);
+}
+
+// The diagonals of the Hamiltonian (Left) and overlap (Right) matrices of fillOverlapHamiltonianMatrices.
+// Used to precondition the matrix-free eigensolver.
+QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonianDiagonals(std::vector<Return_rt>& Left,
+                                                                                          std::vector<Return_rt>& Right)
+{
+  ScopedTimer tmp_timer(fill_timer_);
+
+  RealType b1, b2, H2_avg, V_avg;
+  getLinearMethodAverages(b1, b2, H2_avg, V_avg);
+  const int numParams    = getNumParams();
+  const Return_rt wgtinv = 1.0 / SumValue[SUM_WGT];
+
+  computeDerivativeAverages();
+
+  std::vector<int> params_per_crowd(opt_num_crowds_ + 1);
+  FairDivide(numParams, opt_num_crowds_, params_per_crowd);
+  Left.assign(numParams + 1, 0.0);
+  Right.assign(numParams + 1, 0.0);
+
+  auto constructDiagonals = [](int crowd_id, std::vector<int>& crowd_ranges, int num_samples,
+                               const Matrix<Return_rt>& records, const Matrix<Return_rt>& deriv_records,
+                               const Matrix<Return_rt>& hderiv_records, const std::vector<Return_rt>& D_avg,
+                               Return_rt wgtinv, RealType H2_avg, RealType V_avg, RealType b1, RealType b2,
+                               std::vector<Return_rt>& Left, std::vector<Return_rt>& Right) {
+    for (int iw = 0; iw < num_samples; iw++)
+    {
+      const Return_rt weight   = records[iw][REWEIGHT] * wgtinv;
+      const Return_rt eloc_new = records[iw][ENERGY_NEW];
+      const Return_rt* Dsaved  = deriv_records[iw];
+      const Return_rt* HDsaved = hderiv_records[iw];
+      for (int pm = crowd_ranges[crowd_id]; pm < crowd_ranges[crowd_id + 1]; pm++)
+      {
+        const Return_rt dD  = Dsaved[pm] - D_avg[pm];
+        const Return_rt var = HDsaved[pm] - 2.0 * dD * eloc_new;
+        Left[pm + 1] += weight * ((1 - b2) * dD * (HDsaved[pm] + dD * eloc_new) + b2 * (var * var + V_avg * dD * dD));
+        Right[pm + 1] += weight * (dD * dD + b1 * H2_avg * var * var);
+      }
+    }
+  };
+
+  ParallelExecutor<> crowd_tasks;
+  crowd_tasks(opt_num_crowds_, constructDiagonals, params_per_crowd, rank_local_num_samples_, RecordsOnNode_,
+              DerivRecords_, HDerivRecords_, D_avg_, wgtinv, H2_avg, V_avg, b1, b2, Left, Right);
+  myComm->allreduce(Left);
+  myComm->allreduce(Right);
+  Left[0]  = (1 - b2) * curAvg_w + b2 * V_avg;
+  Right[0] = 1.0 + b1 * H2_avg * V_avg;
+  if (GEVType == "H2")
+    return H2_avg;
+
+  return 1.0;
+}
+
+// The products of the Hamiltonian (Left) and overlap (Right) matrices of fillOverlapHamiltonianMatrices with x.
+// Every matrix element is a sum over samples of products of derivatives, so the products are accumulated
+// sample by sample from the projections of the derivatives of the sample on x.
+// Only the two products of length NumOptimizables+1 are reduced over the ranks.
+void QMCCostFunctionBatched::applyOverlapHamiltonian(const std::vector<Return_rt>& x,
+                                                     std::vector<Return_rt>& Left_x,
+                                                     std::vector<Return_rt>& Right_x)
+{
+  ScopedTimer tmp_timer(fill_timer_);
+
+  RealType b1, b2, H2_avg, V_avg;
+  getLinearMethodAverages(b1, b2, H2_avg, V_avg);
+  const int numParams    = getNumParams();
+  const int N            = numParams + 1;
+  const Return_rt wgtinv = 1.0 / SumValue[SUM_WGT];
+  if (x.size() != N || D_avg_.size() != numParams)
+    throw std::runtime_error("QMCCostFunctionBatched::applyOverlapHamiltonian called with a vector of the wrong size "
+                             "or before fillOverlapHamiltonianDiagonals");
+
+  std::vector<int> samples_per_crowd(opt_num_crowds_ + 1);
+  FairDivide(rank_local_num_samples_, opt_num_crowds_, samples_per_crowd);
+  // [crowd][Left_x, Right_x] summed over the samples of the crowd
+  Matrix<Return_rt> crowd_products(opt_num_crowds_, 2 * N);
+  crowd_products = 0.0;
+
+  auto applyMatrices = [](int crowd_id, std::vector<int>& crowd_ranges, int numParams, const Matrix<Return_rt>& records,
+                          const Matrix<Return_rt>& deriv_records, const Matrix<Return_rt>& hderiv_records,
+                          const std::vector<Return_rt>& D_avg, const std::vector<Return_rt>& x, Return_rt wgtinv,
+                          RealType H2_avg, RealType V_avg, RealType b1, RealType b2, RealType curAvg_w,
+                          Matrix<Return_rt>& crowd_products) {
+    Return_rt* restrict Lx = crowd_products[crowd_id];
+    Return_rt* restrict Rx = Lx + numParams + 1;
+    const Return_rt x0     = x[0];
+    for (int iw = crowd_ranges[crowd_id]; iw < crowd_ranges[crowd_id + 1]; iw++)
+    {
+      const Return_rt weight   = records[iw][REWEIGHT] * wgtinv;
+      const Return_rt eloc_new = records[iw][ENERGY_NEW];
+      const Return_rt* Dsaved  = deriv_records[iw];
+      const Return_rt* HDsaved = hderiv_records[iw];
+      // projections of the centered derivatives and of the Hamiltonian derivatives on x
+      Return_rt dDx(0), HDx(0);
+      for (int pm = 0; pm < numParams; pm++)
+      {
+        dDx += (Dsaved[pm] - D_avg[pm]) * x[pm + 1];
+        HDx += HDsaved[pm] * x[pm + 1];
+      }
+      const Return_rt varx   = HDx - 2.0 * eloc_new * dDx;
+      const Return_rt vtermx = HDx * (eloc_new - curAvg_w) + dDx * eloc_new * (eloc_new - 2.0 * curAvg_w);
+      const Return_rt wfex   = HDx + dDx * eloc_new;
+      Lx[0] += weight * (b2 * vtermx + (1 - b2) * wfex);
+      Rx[0] += weight * b1 * H2_avg * vtermx;
+      for (int pm = 0; pm < numParams; pm++)
+      {
+        const Return_rt dD    = Dsaved[pm] - D_avg[pm];
+        const Return_rt var   = HDsaved[pm] - 2.0 * dD * eloc_new;
+        const Return_rt vterm = HDsaved[pm] * (eloc_new - curAvg_w) + dD * eloc_new * (eloc_new - 2.0 * curAvg_w);
+        Lx[pm + 1] += weight *
+            (x0 * (b2 * vterm + (1 - b2) * dD * eloc_new) + (1 - b2) * dD * wfex +
+             b2 * (var * varx + V_avg * dD * dDx));
+        Rx[pm + 1] += weight * (x0 * b1 * H2_avg * vterm + dD * dDx + b1 * H2_avg * var * varx);
+      }
+    }
+  };
+
+  ParallelExecutor<> crowd_tasks;
+  crowd_tasks(opt_num_crowds_, applyMatrices, samples_per_crowd, numParams, RecordsOnNode_, DerivRecords_,
+              HDerivRecords_, D_avg_, x, wgtinv, H2_avg, V_avg, b1, b2, curAvg_w, crowd_products);
+
+  std::vector<Return_rt> products(2 * N, 0.0);
+  for (int crowd_id = 0; crowd_id < opt_num_crowds_; crowd_id++)
+    for (int i = 0; i < 2 * N; i++)
+      products[i] += crowd_products(crowd_id, i);
+  myComm->allreduce(products);
+
+  Left_x.assign(products.begin(), products.begin() + N);
+  Right_x.assign(products.begin() + N, products.end());
+  Left_x[0] += ((1 - b2) * curAvg_w + b2 * V_avg) * x[0];
+  Right_x[0] += (1.0 + b1 * H2_avg * V_avg) * x[0];
+}
+
+// The energy gradient of GradCost without correlated sampling, g_i = <HD_i + 2 (D_i - <D_i>) (E_L - <E_L>)>,
+// and the diagonal of the overlap matrix S_ij = <(D_i - <D_i>) (D_j - <D_j>)> of stochastic reconstruction.
+QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillEnergyGradientOverlapDiagonal(
+    std::vector<Return_rt>& gradient,
+    std::vector<Return_rt>& S_diag)
+{
+  ScopedTimer tmp_timer(fill_timer_);
+
+  if (samples_streamed_)
+    throw std::runtime_error("QMCCostFunctionBatched::fillEnergyGradientOverlapDiagonal requires the sample records, "
+                             "not streamed samples");
+
+  curAvg_w               = SumValue[SUM_E_WGT] / SumValue[SUM_WGT];
+  const int numParams    = getNumParams();
+  const Return_rt wgtinv = 1.0 / SumValue[SUM_WGT];
+
+  computeDerivativeAverages();
+
+  std::vector<int> params_per_crowd(opt_num_crowds_ + 1);
+  FairDivide(numParams, opt_num_crowds_, params_per_crowd);
+  gradient.assign(numParams, 0.0);
+  S_diag.assign(numParams, 0.0);
+
+  auto constructGradient = [](int crowd_id, std::vector<int>& crowd_ranges, int num_samples,
+                              const Matrix<Return_rt>& records, const Matrix<Return_rt>& deriv_records,
+                              const Matrix<Return_rt>& hderiv_records, const std::vector<Return_rt>& D_avg,
+                              Return_rt wgtinv, Return_rt curAvg_w, std::vector<Return_rt>& gradient,
+                              std::vector<Return_rt>& S_diag) {
+    for (int iw = 0; iw < num_samples; iw++)
+    {
+      const Return_rt weight   = records[iw][REWEIGHT] * wgtinv;
+      const Return_rt delta_l  = records[iw][ENERGY_NEW] - curAvg_w;
+      const Return_rt* Dsaved  = deriv_records[iw];
+      const Return_rt* HDsaved = hderiv_records[iw];
+      for (int pm = crowd_ranges[crowd_id]; pm < crowd_ranges[crowd_id + 1]; pm++)
+      {
+        const Return_rt dD = Dsaved[pm] - D_avg[pm];
+        gradient[pm] += weight * (HDsaved[pm] + 2.0 * dD * delta_l);
+        S_diag[pm] += weight * dD * dD;
+      }
+    }
+  };
+
+  ParallelExecutor<> crowd_tasks;
+  crowd_tasks(opt_num_crowds_, constructGradient, params_per_crowd, rank_local_num_samples_, RecordsOnNode_,
+              DerivRecords_, HDerivRecords_, D_avg_, wgtinv, curAvg_w, gradient, S_diag);
+  myComm->allreduce(gradient);
+  myComm->allreduce(S_diag);
+  return curAvg_w;
+}
+
+// S x accumulated sample by sample from the projection of the centered derivatives of the sample on x,
+// so the cost is linear in the number of parameters and only the product is reduced over the ranks.
+void QMCCostFunctionBatched::applyParameterOverlap(const std::vector<Return_rt>& x, std::vector<Return_rt>& S_x)
+{
+  ScopedTimer tmp_timer(fill_timer_);
+
+  const int numParams    = getNumParams();
+  const Return_rt wgtinv = 1.0 / SumValue[SUM_WGT];
+  if (x.size() != numParams || D_avg_.size() != numParams)
+    throw std::runtime_error("QMCCostFunctionBatched::applyParameterOverlap called with a vector of the wrong size "
+                             "or before fillEnergyGradientOverlapDiagonal");
+
+  std::vector<int> samples_per_crowd(opt_num_crowds_ + 1);
+  FairDivide(rank_local_num_samples_, opt_num_crowds_, samples_per_crowd);
+  Matrix<Return_rt> crowd_products(opt_num_crowds_, numParams);
+  crowd_products = 0.0;
+
+  auto applyOverlap = [](int crowd_id, std::vector<int>& crowd_ranges, int numParams, const Matrix<Return_rt>& records,
+                         const Matrix<Return_rt>& deriv_records, const std::vector<Return_rt>& D_avg,
+                         const std::vector<Return_rt>& x, Return_rt wgtinv, Matrix<Return_rt>& crowd_products) {
+    Return_rt* restrict Sx = crowd_products[crowd_id];
+    for (int iw = crowd_ranges[crowd_id]; iw < crowd_ranges[crowd_id + 1]; iw++)
+    {
+      const Return_rt weight  = records[iw][REWEIGHT] * wgtinv;
+      const Return_rt* Dsaved = deriv_records[iw];
+      Return_rt dDx(0);
+      for (int pm = 0; pm < numParams; pm++)
+        dDx += (Dsaved[pm] - D_avg[pm]) * x[pm];
+      dDx *= weight;
+      for (int pm = 0; pm < numParams; pm++)
+        Sx[pm] += (Dsaved[pm] - D_avg[pm]) * dDx;
+    }
+  };
+
+  ParallelExecutor<> crowd_tasks;
+  crowd_tasks(opt_num_crowds_, applyOverlap, samples_per_crowd, numParams, RecordsOnNode_, DerivRecords_, D_avg_, x,
+              wgtinv, crowd_products);
+
+  S_x.assign(numParams, 0.0);
+  for (int crowd_id = 0; crowd_id < opt_num_crowds_; crowd_id++)
+    for (int pm = 0; pm < numParams; pm++)
+      S_x[pm] += crowd_products(crowd_id, pm);
+  myComm->allreduce(S_x);
+}
 } // namespace qmcplusplus
@@ -17,6 +17,7 @@
 
 #include "QMCDrivers/WFOpt/QMCCostFunctionBase.h"
 #include "QMCDrivers/CloneManager.h"
+#include "QMCDrivers/StreamingSampleAccumulator.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
 
 namespace qmcplusplus
@@ -26,9 +27,15 @@ namespace qmcplusplus
  *
  * Optimization by correlated sampling method with configurations
  * generated from VMC running on a single thread.
+ *
+ * As a StreamingSampleAccumulator the configurations are evaluated during the VMC run instead,
+ * only the moments of the derivatives entering the linear method matrices are kept.
+ * With a descent engine set, the derivatives are passed to the engine and the parameters are updated
+ * during the VMC run.
  */
 
 class CostFunctionCrowdData;
+class DescentEngine;
 
 namespace testing
 {
@@ -36,7 +43,7 @@ class LinearMethodTestSupport;
 };
 
 
-class QMCCostFunctionBatched : public QMCCostFunctionBase, public QMCTraits
+class QMCCostFunctionBatched : public QMCCostFunctionBase, public QMCTraits, public StreamingSampleAccumulator
 {
 public:
   ///Constructor.
@@ -63,8 +70,100 @@ public:
   void resetPsi(bool final_reset = false) override;
   void GradCost(std::vector<Return_rt>& PGradient, const std::vector<Return_rt>& PM, Return_rt FiniteDiff = 0) override;
   Return_rt fillOverlapHamiltonianMatrices(Matrix<Return_rt>& Left, Matrix<Return_rt>& Right) override;
+  Return_rt fillOverlapHamiltonianDiagonals(std::vector<Return_rt>& Left, std::vector<Return_rt>& Right) override;
+  void applyOverlapHamiltonian(const std::vector<Return_rt>& x,
+                               std::vector<Return_rt>& Left_x,
+                               std::vector<Return_rt>& Right_x) override;
+  Return_rt fillEnergyGradientOverlapDiagonal(std::vector<Return_rt>& gradient,
+                                              std::vector<Return_rt>& S_diag) override;
+  void applyParameterOverlap(const std::vector<Return_rt>& x, std::vector<Return_rt>& S_x) override;
+
+  void startAccumulation(const std::vector<int>& walkers_per_crowd) override;
+  void evaluateCrowdSamples(int crowd_id, const RefVector<ParticleSet>& walker_elecs) override;
+  bool accumulateStep() override;
+  void stopAccumulation() override;
+  const opt_variables_type& getVariationalParameters() const override { return OptVariables; }
+
+  /** update the parameters with a descent engine while the samples are streamed
+   * @param engine descent engine computing the updates, nullptr to accumulate the linear method moments instead
+   * @param update_steps number of VMC steps whose walkers enter each update
+   */
+  void setStreamingDescent(DescentEngine* engine, int update_steps);
 
 protected:
+  /// weights of the H2 and variance terms and the averages of the samples entering the linear method matrices
+  void getLinearMethodAverages(RealType& b1, RealType& b2, RealType& H2_avg, RealType& V_avg);
+
+  /// set D_avg_ from the derivative records of the samples
+  void computeDerivativeAverages();
+
+  /// weighted average of the parameter derivatives of the samples, set by computeDerivativeAverages
+  std::vector<Return_rt> D_avg_;
+
+  /// set the energy averages and SumValue from the energy sums of the samples of this rank
+  void reduceEnergySums(Return_rt e_sum, Return_rt e2_sum, Return_rt num_samples);
+
+  /// size the records of a step and zero the moments of the streamed samples
+  void resetStreamingMoments(int num_walkers);
+
+  /// fillOverlapHamiltonianMatrices from the moments of the streamed samples
+  Return_rt fillOverlapHamiltonianFromMoments(Matrix<Return_rt>& Left, Matrix<Return_rt>& Right);
+
+  /// the linear method matrices come from the moments of streamed samples, not from the records
+  bool samples_streamed_;
+  /// first walker of each VMC crowd in the records of a step
+  std::vector<int> stream_crowd_offsets_;
+  /// derivatives and local energies of the walkers of the current step, same layout as the records
+  Matrix<Return_rt> StepDerivRecords_;
+  Matrix<Return_rt> StepHDerivRecords_;
+  Matrix<Return_rt> StepDerivEnergyRecords_;
+  std::vector<Return_rt> step_energies_;
+  /** sums over the streamed samples of D_i, HD_i, D_i E_L and of the products D_i D_j, D_i HD_j, D_i D_j E_L
+   *  with D and HD the derivatives of log psi and of the local energy
+   */
+  std::vector<Return_rt> stream_D_;
+  std::vector<Return_rt> stream_HD_;
+  std::vector<Return_rt> stream_DE_;
+  Matrix<Return_rt> stream_DD_;
+  Matrix<Return_rt> stream_DHD_;
+  Matrix<Return_rt> stream_DDE_;
+  /// sums over the streamed samples of E_L, E_L^2 and the number of samples
+  Return_rt stream_e_;
+  Return_rt stream_e2_;
+  Return_rt stream_count_;
+
+  /// pass the walkers of the current step to the descent engine, one engine replica per crowd
+  void takeDescentSamples();
+  /// descent update of the parameters from the samples taken since the last update
+  void updateDescentParameters();
+
+  /// engine updating the parameters during the VMC run, not owned
+  DescentEngine* descent_engine_;
+  /// number of VMC steps per descent update
+  int descent_update_steps_;
+  /// steps taken by the descent engine since the last update
+  int descent_pending_steps_;
+
+  /** parameter changes since the derivative records were computed
+   * @param delta change of each parameter
+   * @return true if only linear parameters changed and the records give the new wavefunction exactly
+   */
+  bool getLinearParameterChange(std::vector<Return_rt>& delta) const;
+
+  /** set the new energies and log weights of the samples from the derivative records for a change of linear
+   *  parameters, psi_new/psi = 1 + sum_i delta_i D_i and H psi_new/psi = E + sum_i delta_i (HD_i + E D_i)
+   * @param delta change of each parameter
+   * @param wgt_sum sum of the log weights, scaled by inv_n_samples
+   * @param wgt2_sum sum of the squares of the log weights, scaled by inv_n_samples
+   */
+  void evaluateLinearParameterChange(const std::vector<Return_rt>& delta,
+                                     Return_rt inv_n_samples,
+                                     Return_rt& wgt_sum,
+                                     Return_rt& wgt2_sum);
+
+  /// parameters the derivative records were computed at by checkConfigurations, empty if not usable
+  std::vector<Return_rt> linear_ref_params_;
+
   /// H components used in correlated sampling. It can be KE or KE+NLPP
   std::vector<std::string> H_KE_node_names_;
 
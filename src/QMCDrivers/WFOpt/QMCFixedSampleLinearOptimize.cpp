@@ -526,6 +526,11 @@ bool QMCFixedSampleLinearOptimize::processOptXML(xmlNodePtr opt_xml,
   previous_optimizer_type_ = current_optimizer_type_;
   current_optimizer_type_  = OptimizerNames.at(MinMethod);
 
+  if (current_optimizer_type_ == OptimizerType::SR)
+    throw std::runtime_error("MinMethod sr is only available with the batched drivers");
+  if (current_optimizer_type_ == OptimizerType::PIPELINED_DESCENT)
+    throw std::runtime_error("MinMethod pipelined_descent is only available with the batched drivers");
+
   if (current_optimizer_type_ == OptimizerType::DESCENT)
   {
     if (!descentEngineObj)
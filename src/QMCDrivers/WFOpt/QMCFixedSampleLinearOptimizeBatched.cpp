@@ -38,6 +38,7 @@
 #endif
 #include <iostream>
 #include <fstream>
+#include <numeric>
 #include <stdexcept>
 
 
@@ -101,6 +102,16 @@ QMCFixedSampleLinearOptimizeBatched::QMCFixedSampleLinearOptimizeBatched(const P
       do_output_matrices_hdf_(false),
       output_matrices_initialized_(false),
       freeze_parameters_(false),
+      matrix_free_(false),
+      matrix_free_max_its_(60),
+      matrix_free_tol_(1e-6),
+      stream_samples_(false),
+      davidson_eigensolver_(false),
+      sr_tau_(0.02),
+      sr_lambda_(0.001),
+      sr_max_its_(100),
+      sr_tol_(1e-6),
+      descent_update_steps_(1),
       generate_samples_timer_(
           *timer_manager.createTimer("QMCLinearOptimizeBatched::GenerateSamples", timer_level_medium)),
       initialize_timer_(*timer_manager.createTimer("QMCLinearOptimizeBatched::Initialize", timer_level_medium)),
@@ -140,6 +151,13 @@ QMCFixedSampleLinearOptimizeBatched::QMCFixedSampleLinearOptimizeBatched(const P
   m_param.add(crowd_size_, "opt_crowd_size");
   m_param.add(opt_num_crowds_, "opt_num_crowds");
   m_param.add(param_tol, "alloweddifference");
+  m_param.add(matrix_free_max_its_, "matrix_free_max_its");
+  m_param.add(matrix_free_tol_, "matrix_free_tol");
+  m_param.add(sr_tau_, "sr_tau");
+  m_param.add(sr_lambda_, "sr_lambda");
+  m_param.add(sr_max_its_, "sr_max_its");
+  m_param.add(sr_tol_, "sr_tol");
+  m_param.add(descent_update_steps_, "descent_update_steps");
 
 
 #ifdef HAVE_LMY_ENGINE
@@ -203,6 +221,14 @@ QMCFixedSampleLinearOptimizeBatched::RealType QMCFixedSampleLinearOptimizeBatche
 
 void QMCFixedSampleLinearOptimizeBatched::start()
 {
+  if (stream_samples_)
+  {
+    // the cost function evaluates the walkers during the VMC run
+    optTarget->setRootName(get_root_name());
+    optTarget->setWaveFunctionNode(wfNode);
+    optTarget->getConfigurations("");
+    optTarget->setRng(vmcEngine->getRngRefs());
+  }
   //close files automatically generated by QMCDriver
   //     branchEngine->finalize();
   //generate samples
@@ -215,13 +241,16 @@ void QMCFixedSampleLinearOptimizeBatched::start()
   //reset the rootname
   optTarget->setRootName(get_root_name());
   optTarget->setWaveFunctionNode(wfNode);
-  app_log() << "   Reading configurations from h5FileRoot " << std::endl;
-  //get configuration from the previous run
   Timer t1;
   initialize_timer_.start();
-  optTarget->getConfigurations("");
-  optTarget->setRng(vmcEngine->getRngRefs());
-  optTarget->checkConfigurations();
+  if (!stream_samples_)
+  {
+    app_log() << "   Reading configurations from h5FileRoot " << std::endl;
+    //get configuration from the previous run
+    optTarget->getConfigurations("");
+    optTarget->setRng(vmcEngine->getRngRefs());
+    optTarget->checkConfigurations();
+  }
   initialize_timer_.stop();
   app_log() << "  Execution time = " << std::setprecision(4) << t1.elapsed() << std::endl;
   app_log() << "  </log>" << std::endl;
@@ -332,6 +361,12 @@ bool QMCFixedSampleLinearOptimizeBatched::run()
   if (current_optimizer_type_ == OptimizerType::ONESHIFTONLY)
     return one_shift_run();
 
+  if (current_optimizer_type_ == OptimizerType::SR)
+    return sr_run();
+
+  if (current_optimizer_type_ == OptimizerType::PIPELINED_DESCENT)
+    return pipelined_descent_run();
+
   return previous_linear_methods_run();
 }
 
@@ -582,6 +617,9 @@ void QMCFixedSampleLinearOptimizeBatched::process(xmlNodePtr q)
   std::string OutputMatrices("no");
   std::string OutputMatricesHDF("no");
   std::string FreezeParameters("no");
+  std::string MatrixFree("no");
+  std::string StreamSamples("no");
+  std::string EigenSolver("lapack");
   OhmmsAttributeSet oAttrib;
   oAttrib.add(useGPU, "gpu");
   oAttrib.add(vmcMove, "move");
@@ -590,6 +628,9 @@ void QMCFixedSampleLinearOptimizeBatched::process(xmlNodePtr q)
   m_param.add(OutputMatrices, "output_matrices_csv", {"no", "yes"});
   m_param.add(OutputMatricesHDF, "output_matrices_hdf", {"no", "yes"});
   m_param.add(FreezeParameters, "freeze_parameters", {"no", "yes"});
+  m_param.add(MatrixFree, "matrix_free", {"no", "yes"});
+  m_param.add(StreamSamples, "stream_samples", {"no", "yes"});
+  m_param.add(EigenSolver, "eigensolver", {"lapack", "davidson"});
 
   oAttrib.put(q);
   m_param.put(q);
@@ -597,6 +638,18 @@ void QMCFixedSampleLinearOptimizeBatched::process(xmlNodePtr q)
   do_output_matrices_csv_ = (OutputMatrices == "yes");
   do_output_matrices_hdf_ = (OutputMatricesHDF == "yes");
   freeze_parameters_      = (FreezeParameters == "yes");
+  matrix_free_            = (MatrixFree == "yes");
+  // the pipelined descent only sees the walkers during the VMC run
+  stream_samples_         = (StreamSamples == "yes") || MinMethod == "pipelined_descent";
+  davidson_eigensolver_   = (EigenSolver == "davidson");
+
+  if (matrix_free_ && (do_output_matrices_csv_ || do_output_matrices_hdf_))
+  {
+    app_warning() << "  The option 'matrix_free' does not build the linear method matrices, they will not be written."
+                  << std::endl;
+    do_output_matrices_csv_ = false;
+    do_output_matrices_hdf_ = false;
+  }
 
   // Use freeze_parameters with output_matrices to generate multiple lines in the output with
   // the same parameters so statistics can be computed in post-processing.
@@ -651,7 +704,9 @@ void QMCFixedSampleLinearOptimizeBatched::process(xmlNodePtr q)
   // This code is also called when setting up vmcEngine.  Would be nice to not duplicate the call.
   QMCDriverNew::AdjustedWalkerCounts awc =
       adjustGlobalWalkerCount(myComm->size(), myComm->rank(), qmcdriver_input_.get_total_walkers(),
-                              qmcdriver_input_.get_walkers_per_rank(), 1.0, qmcdriver_input_.get_num_crowds());
+                              qmcdriver_input_.get_walkers_per_rank(), 1.0, qmcdriver_input_.get_num_crowds(),
+                              getMultiWalkerMemoryPerWalker(),
+                              static_cast<size_t>(qmcdriver_input_.get_walker_memory_budget()) << 20);
   QMCDriverNew::startup(q, awc);
 }
 
@@ -673,7 +728,9 @@ bool QMCFixedSampleLinearOptimizeBatched::processOptXML(xmlNodePtr opt_xml,
   previous_optimizer_type_ = current_optimizer_type_;
   current_optimizer_type_  = OptimizerNames.at(MinMethod);
 
-  if (current_optimizer_type_ == OptimizerType::DESCENT && !descentEngineObj)
+  if ((current_optimizer_type_ == OptimizerType::DESCENT ||
+       current_optimizer_type_ == OptimizerType::PIPELINED_DESCENT) &&
+      !descentEngineObj)
     descentEngineObj = std::make_unique<DescentEngine>(myComm, opt_xml);
 
   // sanity check
@@ -706,6 +763,32 @@ bool QMCFixedSampleLinearOptimizeBatched::processOptXML(xmlNodePtr opt_xml,
   if (cost_increase_tol < 0.0)
     throw std::runtime_error("cost_increase_tol must be non-negative in QMCFixedSampleLinearOptimizeBatched::put");
 
+  // check matrix-free eigensolver sanity
+  if (matrix_free_max_its_ < 1)
+    throw std::runtime_error("matrix_free_max_its must be positive in QMCFixedSampleLinearOptimizeBatched::put");
+  if (matrix_free_tol_ <= 0.0)
+    throw std::runtime_error("matrix_free_tol must be positive in QMCFixedSampleLinearOptimizeBatched::put");
+
+  // check stochastic reconstruction sanity
+  if (sr_tau_ <= 0.0)
+    throw std::runtime_error("sr_tau must be positive in QMCFixedSampleLinearOptimizeBatched::put");
+  if (sr_lambda_ < 0.0)
+    throw std::runtime_error("sr_lambda must be non-negative in QMCFixedSampleLinearOptimizeBatched::put");
+  if (sr_max_its_ < 1)
+    throw std::runtime_error("sr_max_its must be positive in QMCFixedSampleLinearOptimizeBatched::put");
+  if (sr_tol_ <= 0.0)
+    throw std::runtime_error("sr_tol must be positive in QMCFixedSampleLinearOptimizeBatched::put");
+
+  // streamed samples only provide the linear method matrices or the descent updates, no correlated sampling
+  if (stream_samples_ && current_optimizer_type_ != OptimizerType::PIPELINED_DESCENT &&
+      (current_optimizer_type_ != OptimizerType::ONESHIFTONLY || matrix_free_))
+    throw std::runtime_error("stream_samples requires MinMethod OneShiftOnly without matrix_free in "
+                             "QMCFixedSampleLinearOptimizeBatched::put");
+
+  // check pipelined descent sanity
+  if (descent_update_steps_ < 1)
+    throw std::runtime_error("descent_update_steps must be positive in QMCFixedSampleLinearOptimizeBatched::put");
+
   // if this is the first time this function has been called, set the initial shifts
   if (bestShift_i < 0.0 && (current_optimizer_type_ == OptimizerType::ADAPTIVE || doHybrid))
     bestShift_i = shift_i_input;
@@ -748,7 +831,8 @@ bool QMCFixedSampleLinearOptimizeBatched::processOptXML(xmlNodePtr opt_xml,
   vmcEngine->setStatus(get_root_name(), h5_file_root_, AppendRun);
   vmcEngine->process(qsave);
 
-  vmcEngine->enable_sample_collection();
+  if (!stream_samples_)
+    vmcEngine->enable_sample_collection();
 
   // Code to check and set crowds take from QMCDriverNew::adjustGlobalWalkerCount
   checkNumCrowdsLTNumThreads(opt_num_crowds_);
@@ -759,9 +843,14 @@ bool QMCFixedSampleLinearOptimizeBatched::processOptXML(xmlNodePtr opt_xml,
 
   bool success = true;
   //allways reset optTarget
-  optTarget =
+  auto cost_function =
       std::make_unique<QMCCostFunctionBatched>(W, population_.get_golden_twf(), population_.get_golden_hamiltonian(),
                                                samples_, opt_num_crowds_, crowd_size_, myComm);
+  if (stream_samples_)
+    vmcEngine->enable_sample_accumulation(*cost_function);
+  if (current_optimizer_type_ == OptimizerType::PIPELINED_DESCENT)
+    cost_function->setStreamingDescent(descentEngineObj.get(), descent_update_steps_);
+  optTarget = std::move(cost_function);
   optTarget->setStream(&app_log());
   if (reportH5)
     optTarget->reportH5 = true;
@@ -1397,72 +1486,97 @@ bool QMCFixedSampleLinearOptimizeBatched::one_shift_run()
   const RealType initCost = optTarget->computedCost();
 #endif
 
-  // say what we are doing
-  app_log() << std::endl
-            << "*****************************************" << std::endl
-            << "Building overlap and Hamiltonian matrices" << std::endl
-            << "*****************************************" << std::endl;
-
-  // allocate the matrices we will need
-  Matrix<RealType> ovlMat(N, N);
-  ovlMat = 0.0;
-  Matrix<RealType> hamMat(N, N);
-  hamMat = 0.0;
-  Matrix<RealType> invMat(N, N);
-  invMat = 0.0;
-  Matrix<RealType> prdMat(N, N);
-  prdMat = 0.0;
+  RealType lowestEV(0);
+  hdf_archive hout;
+  if (matrix_free_)
+  {
+    app_log() << std::endl
+              << "****************************************************" << std::endl
+              << "Solving the linear method without building matrices" << std::endl
+              << "****************************************************" << std::endl;
 
-  // build the overlap and hamiltonian matrices
-  optTarget->fillOverlapHamiltonianMatrices(hamMat, ovlMat);
-  invMat.copy(ovlMat);
+    // apply the Hamiltonian and overlap matrices to vectors straight from the derivatives of the samples
+    lowestEV = getLowestEigenvectorMatrixFree(parameterDirections);
 
-  if (do_output_matrices_csv_)
-  {
-    output_overlap_.output(ovlMat);
-    output_hamiltonian_.output(hamMat);
+    // compute the scaling constant to apply to the update
+    objFuncWrapper_.Lambda = getNonLinearRescaleMatrixFree(parameterDirections);
   }
-
-  hdf_archive hout;
-  if (do_output_matrices_hdf_)
+  else
   {
-    std::string newh5 = get_root_name() + ".linear_matrices.h5";
-    hout.create(newh5, H5F_ACC_TRUNC);
-    hout.write(ovlMat, "overlap");
-    hout.write(hamMat, "Hamiltonian");
-    hout.write(bestShift_i, "bestShift_i");
-    hout.write(bestShift_s, "bestShift_s");
-  }
+    // say what we are doing
+    app_log() << std::endl
+              << "*****************************************" << std::endl
+              << "Building overlap and Hamiltonian matrices" << std::endl
+              << "*****************************************" << std::endl;
+
+    // allocate the matrices we will need
+    Matrix<RealType> ovlMat(N, N);
+    ovlMat = 0.0;
+    Matrix<RealType> hamMat(N, N);
+    hamMat = 0.0;
+    Matrix<RealType> invMat(N, N);
+    invMat = 0.0;
+    Matrix<RealType> prdMat(N, N);
+    prdMat = 0.0;
+
+    // build the overlap and hamiltonian matrices
+    optTarget->fillOverlapHamiltonianMatrices(hamMat, ovlMat);
+    invMat.copy(ovlMat);
+
+    if (do_output_matrices_csv_)
+    {
+      output_overlap_.output(ovlMat);
+      output_hamiltonian_.output(hamMat);
+    }
 
-  // apply the identity shift
-  for (int i = 1; i < N; i++)
-  {
-    hamMat(i, i) += bestShift_i;
-    if (invMat(i, i) == 0)
-      invMat(i, i) = bestShift_i * bestShift_s;
-  }
+    if (do_output_matrices_hdf_)
+    {
+      std::string newh5 = get_root_name() + ".linear_matrices.h5";
+      hout.create(newh5, H5F_ACC_TRUNC);
+      hout.write(ovlMat, "overlap");
+      hout.write(hamMat, "Hamiltonian");
+      hout.write(bestShift_i, "bestShift_i");
+      hout.write(bestShift_s, "bestShift_s");
+    }
 
-  // compute the inverse of the overlap matrix
-  invert_matrix(invMat, false);
+    // apply the identity shift
+    for (int i = 1; i < N; i++)
+    {
+      hamMat(i, i) += bestShift_i;
+      if (invMat(i, i) == 0)
+        invMat(i, i) = bestShift_i * bestShift_s;
+    }
 
-  // apply the overlap shift
-  for (int i = 1; i < N; i++)
-    for (int j = 1; j < N; j++)
-      hamMat(i, j) += bestShift_s * ovlMat(i, j);
+    // apply the overlap shift
+    for (int i = 1; i < N; i++)
+      for (int j = 1; j < N; j++)
+        hamMat(i, j) += bestShift_s * ovlMat(i, j);
 
-  // multiply the shifted hamiltonian matrix by the inverse of the overlap matrix
-  qmcplusplus::MatrixOperators::product(invMat, hamMat, prdMat);
+    if (davidson_eigensolver_)
+    {
+      // only the lowest eigenvector is needed, the ranks share the matrix-vector products
+      lowestEV = getLowestEigenvectorDistributed(hamMat, invMat, parameterDirections);
+    }
+    else
+    {
+      // compute the inverse of the overlap matrix
+      invert_matrix(invMat, false);
 
-  // transpose the result (why?)
-  for (int i = 0; i < N; i++)
-    for (int j = i + 1; j < N; j++)
-      std::swap(prdMat(i, j), prdMat(j, i));
+      // multiply the shifted hamiltonian matrix by the inverse of the overlap matrix
+      qmcplusplus::MatrixOperators::product(invMat, hamMat, prdMat);
+
+      // transpose the result (why?)
+      for (int i = 0; i < N; i++)
+        for (int j = i + 1; j < N; j++)
+          std::swap(prdMat(i, j), prdMat(j, i));
 
-  // compute the lowest eigenvalue of the product matrix and the corresponding eigenvector
-  RealType lowestEV = getLowestEigenvector(prdMat, parameterDirections);
+      // compute the lowest eigenvalue of the product matrix and the corresponding eigenvector
+      lowestEV = getLowestEigenvector(prdMat, parameterDirections);
+    }
 
-  // compute the scaling constant to apply to the update
-  objFuncWrapper_.Lambda = getNonLinearRescale(parameterDirections, ovlMat);
+    // compute the scaling constant to apply to the update
+    objFuncWrapper_.Lambda = getNonLinearRescale(parameterDirections, ovlMat);
+  }
 
   if (do_output_matrices_hdf_)
   {
@@ -1498,9 +1612,9 @@ bool QMCFixedSampleLinearOptimizeBatched::one_shift_run()
             << "Among totally " << numParams << " optimized parameters, "
             << "largest LM parameter change : " << largestChange << " at parameter " << max_element << std::endl;
 
-  // compute the new cost
+  // compute the new cost, the streamed samples were not kept for correlated sampling and the update is always taken
   optTarget->IsValid     = true;
-  const RealType newCost = optTarget->Cost(false);
+  const RealType newCost = stream_samples_ ? initCost : optTarget->Cost(false);
 
   app_log() << std::endl
             << "******************************************************************************" << std::endl
@@ -1525,7 +1639,8 @@ bool QMCFixedSampleLinearOptimizeBatched::one_shift_run()
   }
   else
   {
-    if (bestShift_s > 1.0e-2)
+    // without a new cost there is no evidence to lower the shift
+    if (!stream_samples_ && bestShift_s > 1.0e-2)
       bestShift_s = bestShift_s / shift_s_base;
     // say what we are doing
     app_log() << std::endl << "The new set of parameters is valid. Updating the trial wave function!" << std::endl;
@@ -1547,6 +1662,147 @@ bool QMCFixedSampleLinearOptimizeBatched::one_shift_run()
   return (optTarget->getReportCounter() > 0);
 }
 
+bool QMCFixedSampleLinearOptimizeBatched::sr_run()
+{
+  // ensure the cost function is set to compute derivative vectors
+  optTarget->setneedGrads(true);
+
+  // generate samples and compute weights, local energies, and derivative vectors
+  start();
+
+  const int numParams = optTarget->getNumParams();
+  std::vector<RealType> currentParameters(numParams, 0.0);
+  for (int i = 0; i < numParams; i++)
+    currentParameters.at(i) = std::real(optTarget->Params(i));
+
+  app_log() << std::endl
+            << "**************************************************" << std::endl
+            << "Solving the stochastic reconstruction overlap system" << std::endl
+            << "**************************************************" << std::endl;
+
+  // the overlap matrix is only applied to vectors, straight from the derivatives of the samples
+  std::vector<RealType> gradient, S_diag;
+  const RealType energy = optTarget->fillEnergyGradientOverlapDiagonal(gradient, S_diag);
+  std::vector<RealType> parameterDirections(numParams, 0.0);
+  solveSRSystem(gradient, S_diag, parameterDirections);
+
+  // now that the derivatives are used, prevent further computation of derivative vectors
+  optTarget->setneedGrads(false);
+
+  RealType largestChange(0);
+  int max_element = 0;
+  for (int i = 0; i < numParams; i++)
+    if (sr_tau_ * std::abs(parameterDirections.at(i)) > largestChange)
+    {
+      largestChange = sr_tau_ * std::abs(parameterDirections.at(i));
+      max_element   = i;
+    }
+
+  // limit the step as the linear method limits its update
+  RealType step = sr_tau_;
+  if (largestChange > max_param_change)
+  {
+    step *= max_param_change / largestChange;
+    app_log() << "  Largest SR parameter change " << largestChange << " exceeds max_param_change, step reduced to "
+              << step << std::endl;
+  }
+
+  if (!freeze_parameters_)
+  {
+    for (int i = 0; i < numParams; i++)
+      optTarget->Params(i) = currentParameters.at(i) - step * parameterDirections.at(i);
+  }
+
+  const RealType gradientNorm =
+      std::sqrt(std::inner_product(gradient.begin(), gradient.end(), gradient.begin(), RealType(0)));
+  app_log() << std::endl
+            << "Among totally " << numParams << " optimized parameters, "
+            << "largest SR parameter change : " << std::min(largestChange, max_param_change) << " at parameter "
+            << max_element << std::endl;
+  app_log() << std::endl
+            << "******************************************************************************" << std::endl
+            << "Energy = " << std::scientific << std::right << std::setw(12) << std::setprecision(4) << energy
+            << "    Gradient norm = " << std::scientific << std::right << std::setw(12) << std::setprecision(4)
+            << gradientNorm << std::endl
+            << "******************************************************************************" << std::endl;
+
+  // perform some finishing touches for this iteration
+  finish();
+
+  // return whether the cost function's report counter is positive
+  return (optTarget->getReportCounter() > 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief  solves the regularized stochastic reconstruction system (S + sr_lambda I) x = g by
+///         conjugate gradient preconditioned with the diagonal of the system
+///
+/// \param[in]      gradient  the energy gradient g
+/// \param[in]      S_diag    the diagonal of the overlap matrix S
+/// \param[out]     x         the solution, the update is -sr_tau x
+///
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void QMCFixedSampleLinearOptimizeBatched::solveSRSystem(const std::vector<RealType>& gradient,
+                                                        const std::vector<RealType>& S_diag,
+                                                        std::vector<RealType>& x)
+{
+  const int n = gradient.size();
+  std::vector<RealType> precond(n), r(gradient), z(n), p(n), Sp;
+  for (int i = 0; i < n; i++)
+  {
+    const RealType d = S_diag[i] + sr_lambda_;
+    precond[i]       = d > 0 ? 1.0 / d : 1.0;
+    z[i]             = precond[i] * r[i];
+  }
+  p = z;
+  std::fill(x.begin(), x.end(), 0.0);
+
+  const RealType gNorm = std::sqrt(std::inner_product(gradient.begin(), gradient.end(), gradient.begin(), RealType(0)));
+  RealType rz          = std::inner_product(r.begin(), r.end(), z.begin(), RealType(0));
+  RealType residualNorm(gNorm);
+  int k = 0;
+  while (k < sr_max_its_ && residualNorm > sr_tol_ * gNorm)
+  {
+    optTarget->applyParameterOverlap(p, Sp);
+    for (int i = 0; i < n; i++)
+      Sp[i] += sr_lambda_ * p[i];
+    const RealType pSp = std::inner_product(p.begin(), p.end(), Sp.begin(), RealType(0));
+    if (pSp <= 0)
+      break;
+    const RealType alpha = rz / pSp;
+    for (int i = 0; i < n; i++)
+    {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * Sp[i];
+      z[i] = precond[i] * r[i];
+    }
+    const RealType rz_new = std::inner_product(r.begin(), r.end(), z.begin(), RealType(0));
+    for (int i = 0; i < n; i++)
+      p[i] = z[i] + (rz_new / rz) * p[i];
+    rz           = rz_new;
+    residualNorm = std::sqrt(std::inner_product(r.begin(), r.end(), r.begin(), RealType(0)));
+    k++;
+  }
+
+  app_log() << "  SR conjugate gradient used " << k << " iterations, residual norm " << residualNorm << std::endl;
+  if (residualNorm > sr_tol_ * gNorm)
+    app_warning() << "  SR conjugate gradient did not reach sr_tol = " << sr_tol_ << ", consider increasing sr_max_its"
+                  << std::endl;
+}
+
+// Descent with the parameters updated during the VMC run. The walkers keep sampling after each update
+// with the new parameters, the samples entering an update are at most descent_update_steps old.
+bool QMCFixedSampleLinearOptimizeBatched::pipelined_descent_run()
+{
+  // the updates are made by the cost function as the VMC steps are accumulated
+  start();
+
+  app_log() << "  Pipelined descent made " << descentEngineObj->getDescentNum() << " updates in total" << std::endl;
+
+  finish();
+  return (optTarget->getReportCounter() > 0);
+}
+
 #ifdef HAVE_LMY_ENGINE
 //Function for optimizing using gradient descent
 bool QMCFixedSampleLinearOptimizeBatched::descent_run()
@@ -1720,6 +1976,240 @@ QMCFixedSampleLinearOptimizeBatched::RealType QMCFixedSampleLinearOptimizeBatche
   //     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds the lowest eigenvector of the shifted linear method matrices without building them.
+///         Each Davidson iteration costs one product with the Hamiltonian and overlap matrices,
+///         computed by the cost function from the derivatives of the samples.
+///
+/// \param[out]  ev   the eigenvector, normalized so its first element is one
+///
+/// \return  the eigenvalue
+///
+///////////////////////////////////////////////////////////////////////////////////////////////////
+QMCFixedSampleLinearOptimizeBatched::RealType QMCFixedSampleLinearOptimizeBatched::getLowestEigenvectorMatrixFree(
+    std::vector<RealType>& ev)
+{
+  const int N = ev.size();
+
+  // diagonals of the shifted matrices, for the preconditioner
+  std::vector<RealType> hamDiag, ovlDiag;
+  optTarget->fillOverlapHamiltonianDiagonals(hamDiag, ovlDiag);
+  std::vector<RealType> hamDiagShifted(hamDiag), ovlDiagShifted(ovlDiag);
+  for (int i = 1; i < N; i++)
+  {
+    hamDiagShifted[i] += bestShift_i + bestShift_s * ovlDiag[i];
+    if (ovlDiag[i] == 0)
+      ovlDiagShifted[i] = bestShift_i * bestShift_s;
+  }
+
+  // the overlap matrix applied to the first unit vector, to apply the overlap shift to the parameter block only
+  std::vector<RealType> unit0(N, 0.0), hamCol0, ovlCol0;
+  unit0[0] = 1.0;
+  optTarget->applyOverlapHamiltonian(unit0, hamCol0, ovlCol0);
+
+  // apply the same shifts as one_shift_run
+  auto applyShifted = [&](const std::vector<RealType>& vec, std::vector<RealType>& hamVec,
+                          std::vector<RealType>& ovlVec) {
+    optTarget->applyOverlapHamiltonian(vec, hamVec, ovlVec);
+    for (int i = 1; i < N; i++)
+    {
+      hamVec[i] += bestShift_i * vec[i] + bestShift_s * (ovlVec[i] - vec[0] * ovlCol0[i]);
+      if (ovlDiag[i] == 0)
+        ovlVec[i] += bestShift_i * bestShift_s * vec[i];
+    }
+  };
+
+  return getLowestEigenvectorDavidson(applyShifted, hamDiagShifted, ovlDiagShifted, ev);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds the lowest eigenvector of the shifted linear method matrices built by one_shift_run
+///         with the Davidson solver instead of inverting the overlap matrix and diagonalizing the
+///         product. The rows of the matrix-vector products are divided among the MPI ranks.
+///
+/// \param[in]   hamMat  the shifted Hamiltonian matrix
+/// \param[in]   ovlMat  the shifted overlap matrix
+/// \param[out]  ev      the eigenvector, normalized so its first element is one
+///
+/// \return  the eigenvalue
+///
+///////////////////////////////////////////////////////////////////////////////////////////////////
+QMCFixedSampleLinearOptimizeBatched::RealType QMCFixedSampleLinearOptimizeBatched::getLowestEigenvectorDistributed(
+    const Matrix<RealType>& hamMat,
+    const Matrix<RealType>& ovlMat,
+    std::vector<RealType>& ev)
+{
+  const int N = ev.size();
+  std::vector<RealType> hamDiag(N), ovlDiag(N);
+  for (int i = 0; i < N; i++)
+  {
+    hamDiag[i] = hamMat(i, i);
+    ovlDiag[i] = ovlMat(i, i);
+  }
+
+  std::vector<int> rows_per_rank(myComm->size() + 1);
+  FairDivide(N, myComm->size(), rows_per_rank);
+  const int first = rows_per_rank[myComm->rank()];
+  const int last  = rows_per_rank[myComm->rank() + 1];
+
+  // [Hamiltonian product, overlap product], each rank fills its rows
+  std::vector<RealType> products(2 * N);
+  auto applyMatrices = [&](const std::vector<RealType>& vec, std::vector<RealType>& hamVec,
+                           std::vector<RealType>& ovlVec) {
+    std::fill(products.begin(), products.end(), 0.0);
+    for (int i = first; i < last; i++)
+    {
+      products[i]     = std::inner_product(hamMat[i], hamMat[i] + N, vec.begin(), RealType(0));
+      products[N + i] = std::inner_product(ovlMat[i], ovlMat[i] + N, vec.begin(), RealType(0));
+    }
+    myComm->allreduce(products);
+    hamVec.assign(products.begin(), products.begin() + N);
+    ovlVec.assign(products.begin() + N, products.end());
+  };
+
+  return getLowestEigenvectorDavidson(applyMatrices, hamDiag, ovlDiag, ev);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief  Davidson solver for the lowest eigenvector of the shifted linear method matrices.
+///         A subspace is grown from the first unit vector with corrections preconditioned by the
+///         diagonals of the matrices. The projected problem is solved as the dense matrices are in
+///         one_shift_run, so the same eigenvalue is targeted.
+///
+/// \param[in]   apply    applies the shifted Hamiltonian and overlap matrices to a vector
+/// \param[in]   hamDiag  diagonal of the shifted Hamiltonian matrix
+/// \param[in]   ovlDiag  diagonal of the shifted overlap matrix
+/// \param[out]  ev       the eigenvector, normalized so its first element is one
+///
+/// \return  the eigenvalue
+///
+///////////////////////////////////////////////////////////////////////////////////////////////////
+QMCFixedSampleLinearOptimizeBatched::RealType QMCFixedSampleLinearOptimizeBatched::getLowestEigenvectorDavidson(
+    const ApplyMatrices& apply,
+    const std::vector<RealType>& hamDiag,
+    const std::vector<RealType>& ovlDiag,
+    std::vector<RealType>& ev)
+{
+  const int N       = ev.size();
+  const int max_its = std::min(matrix_free_max_its_, N);
+
+  // the subspace basis, the shifted matrices applied to it and the projected matrices
+  Matrix<RealType> basis(max_its, N), hamBasis(max_its, N), ovlBasis(max_its, N);
+  Matrix<RealType> projHam(max_its, max_its), projOvl(max_its, max_its);
+  basis = 0.0;
+
+  std::vector<RealType> vec(N), hamVec, ovlVec;
+
+  // apply the matrices to the k-th basis vector and extend the projected matrices
+  auto addBasisVector = [&](int k) {
+    std::copy(basis[k], basis[k] + N, vec.begin());
+    apply(vec, hamVec, ovlVec);
+    std::copy(hamVec.begin(), hamVec.end(), hamBasis[k]);
+    std::copy(ovlVec.begin(), ovlVec.end(), ovlBasis[k]);
+    for (int j = 0; j <= k; j++)
+    {
+      projHam(j, k) = std::inner_product(basis[j], basis[j] + N, hamBasis[k], RealType(0));
+      projHam(k, j) = std::inner_product(basis[k], basis[k] + N, hamBasis[j], RealType(0));
+      projOvl(j, k) = std::inner_product(basis[j], basis[j] + N, ovlBasis[k], RealType(0));
+      projOvl(k, j) = std::inner_product(basis[k], basis[k] + N, ovlBasis[j], RealType(0));
+    }
+  };
+
+  basis(0, 0) = 1.0;
+  addBasisVector(0);
+
+  RealType lowestEV(0), residualNorm(0);
+  std::vector<RealType> residual(N), correction(N);
+  int k = 1;
+  while (true)
+  {
+    // solve the projected problem as the dense problem is solved
+    Matrix<RealType> subHam(k, k), subInv(k, k), subPrd(k, k);
+    for (int i = 0; i < k; i++)
+      for (int j = 0; j < k; j++)
+      {
+        subHam(i, j) = projHam(i, j);
+        subInv(i, j) = projOvl(i, j);
+      }
+    invert_matrix(subInv, false);
+    qmcplusplus::MatrixOperators::product(subInv, subHam, subPrd);
+    for (int i = 0; i < k; i++)
+      for (int j = i + 1; j < k; j++)
+        std::swap(subPrd(i, j), subPrd(j, i));
+    std::vector<RealType> y(k, 0.0);
+    lowestEV = getLowestEigenvector(subPrd, y);
+
+    // the Ritz vector and its residual
+    std::fill(ev.begin(), ev.end(), 0.0);
+    std::fill(residual.begin(), residual.end(), 0.0);
+    for (int j = 0; j < k; j++)
+      for (int i = 0; i < N; i++)
+      {
+        ev[i] += y[j] * basis(j, i);
+        residual[i] += y[j] * (hamBasis(j, i) - lowestEV * ovlBasis(j, i));
+      }
+    residualNorm = std::sqrt(std::inner_product(residual.begin(), residual.end(), residual.begin(), RealType(0)) /
+                             std::inner_product(ev.begin(), ev.end(), ev.begin(), RealType(0)));
+    if (residualNorm < matrix_free_tol_ || k == max_its)
+      break;
+
+    // precondition the residual and orthogonalize it twice against the basis
+    for (int i = 0; i < N; i++)
+    {
+      RealType denom = hamDiag[i] - lowestEV * ovlDiag[i];
+      if (std::abs(denom) < 1e-8)
+        denom = 1e-8;
+      correction[i] = -residual[i] / denom;
+    }
+    for (int pass = 0; pass < 2; pass++)
+      for (int j = 0; j < k; j++)
+      {
+        const RealType c = std::inner_product(basis[j], basis[j] + N, correction.begin(), RealType(0));
+        for (int i = 0; i < N; i++)
+          correction[i] -= c * basis(j, i);
+      }
+    const RealType norm =
+        std::sqrt(std::inner_product(correction.begin(), correction.end(), correction.begin(), RealType(0)));
+    if (norm < 1e-12)
+      break;
+    for (int i = 0; i < N; i++)
+      basis(k, i) = correction[i] / norm;
+    addBasisVector(k);
+    k++;
+  }
+
+  app_log() << "  Davidson eigensolver used " << k << " basis vectors, residual norm " << residualNorm << std::endl;
+  if (residualNorm >= matrix_free_tol_)
+    app_warning() << "  Davidson eigensolver did not reach matrix_free_tol = " << matrix_free_tol_
+                  << ", consider increasing matrix_free_max_its" << std::endl;
+
+  // the basis vectors after the first have no first element, normalize as getLowestEigenvector does
+  const RealType ev0 = ev[0];
+  for (int i = 0; i < N; i++)
+    ev[i] /= ev0;
+  return lowestEV;
+}
+
+QMCFixedSampleLinearOptimizeBatched::RealType QMCFixedSampleLinearOptimizeBatched::getNonLinearRescaleMatrixFree(
+    const std::vector<RealType>& dP)
+{
+  int first(0), last(0);
+  getNonLinearRange(first, last);
+  if (first == last)
+    return 1.0;
+  // the non-linear part of the update
+  std::vector<RealType> dPnl(dP.size(), 0.0), ham_dPnl, ovl_dPnl;
+  for (int i = first; i < last; i++)
+    dPnl[i + 1] = dP[i + 1];
+  optTarget->applyOverlapHamiltonian(dPnl, ham_dPnl, ovl_dPnl);
+  RealType rescale(1.0);
+  RealType xi(0.5);
+  RealType D = std::inner_product(dPnl.begin(), dPnl.end(), ovl_dPnl.begin(), RealType(0));
+  rescale    = (1 - xi) * D / ((1 - xi) + xi * std::sqrt(1 + D));
+  rescale    = 1.0 / (1.0 - rescale);
+  return rescale;
+}
+
 void QMCFixedSampleLinearOptimizeBatched::getNonLinearRange(int& first, int& last)
 {
   std::vector<int> types;
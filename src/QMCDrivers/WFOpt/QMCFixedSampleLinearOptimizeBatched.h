@@ -31,6 +31,7 @@
 #include "QMCDrivers/Optimizers/DescentEngine.h"
 #include "QMCDrivers/Optimizers/HybridEngine.h"
 #include "QMCDrivers/WFOpt/OutputMatrix.h"
+#include <functional>
 
 namespace qmcplusplus
 {
@@ -117,6 +118,22 @@ private:
   RealType getLowestEigenvector(Matrix<RealType>& A, std::vector<RealType>& ev);
   void getNonLinearRange(int& first, int& last);
   RealType getNonLinearRescale(std::vector<RealType>& dP, Matrix<RealType>& S);
+  // applies the shifted Hamiltonian and overlap matrices to a vector
+  using ApplyMatrices =
+      std::function<void(const std::vector<RealType>&, std::vector<RealType>&, std::vector<RealType>&)>;
+  // lowest eigenvector of the shifted linear method matrices with a Davidson solver using only matrix-vector products
+  RealType getLowestEigenvectorDavidson(const ApplyMatrices& apply,
+                                        const std::vector<RealType>& hamDiag,
+                                        const std::vector<RealType>& ovlDiag,
+                                        std::vector<RealType>& ev);
+  // getLowestEigenvectorDavidson with the products computed from the derivatives of the samples
+  RealType getLowestEigenvectorMatrixFree(std::vector<RealType>& ev);
+  // getLowestEigenvectorDavidson with the products of the shifted matrices divided among the ranks
+  RealType getLowestEigenvectorDistributed(const Matrix<RealType>& hamMat,
+                                           const Matrix<RealType>& ovlMat,
+                                           std::vector<RealType>& ev);
+  // getNonLinearRescale using a product with the overlap matrix
+  RealType getNonLinearRescaleMatrixFree(const std::vector<RealType>& dP);
 
   // perform the adaptive three-shift update
   bool adaptive_three_shift_run();
@@ -124,9 +141,19 @@ private:
   // perform the single-shift update, no sample regeneration
   bool one_shift_run();
 
+  // perform a stochastic reconstruction step, solving the overlap system with conjugate gradient
+  bool sr_run();
+  // solve (S + sr_lambda I) x = g using products with the overlap matrix S only
+  void solveSRSystem(const std::vector<RealType>& gradient,
+                     const std::vector<RealType>& S_diag,
+                     std::vector<RealType>& x);
+
   // perform optimization using a gradient descent algorithm
   bool descent_run();
 
+  // perform descent updates of the parameters during the VMC run, see QMCCostFunctionBatched::accumulateStep
+  bool pipelined_descent_run();
+
   // Previous linear optimizers ("quartic" and "rescale")
   bool previous_linear_methods_run();
 
@@ -271,6 +298,31 @@ private:
   // Freeze variational parameters.  Do not update them during each step.
   bool freeze_parameters_;
 
+  // Solve the linear method eigenproblem without building the Hamiltonian and overlap matrices
+  bool matrix_free_;
+  // Maximum number of Davidson iterations, also the maximum size of the subspace
+  int matrix_free_max_its_;
+  // Convergence threshold on the norm of the Davidson residual
+  RealType matrix_free_tol_;
+
+  // Accumulate the linear method matrices during the VMC run instead of storing the samples
+  bool stream_samples_;
+
+  // Find only the lowest eigenvector of the built matrices with the Davidson solver
+  bool davidson_eigensolver_;
+
+  // Step size of the stochastic reconstruction update
+  RealType sr_tau_;
+  // Diagonal shift regularizing the overlap matrix of stochastic reconstruction
+  RealType sr_lambda_;
+  // Maximum number of conjugate gradient iterations of stochastic reconstruction
+  int sr_max_its_;
+  // Convergence threshold on the relative conjugate gradient residual of stochastic reconstruction
+  RealType sr_tol_;
+
+  // Number of VMC steps whose walkers enter each update of the pipelined descent
+  int descent_update_steps_;
+
   NewTimer& generate_samples_timer_;
   NewTimer& initialize_timer_;
   NewTimer& eigenvalue_timer_;
@@ -504,14 +504,19 @@ int WalkerControlBase::copyWalkers(MCWalkerConfiguration& W)
   {
     for (int j = 0; j < ncopy_w[i]; j++)
     {
-      if (bad_w.empty())
+      if (!bad_w.empty())
       {
-        good_w.push_back(nullptr);
+        good_w.push_back(std::move(bad_w.back()));
+        bad_w.pop_back();
+      }
+      else if (!spare_w.empty())
+      {
+        good_w.push_back(std::move(spare_w.back()));
+        spare_w.pop_back();
       }
       else
       {
-        good_w.push_back(std::move(bad_w.back()));
-        bad_w.pop_back();
+        good_w.push_back(nullptr);
       }
       copy_list.push_back(i);
     }
@@ -522,7 +527,7 @@ int WalkerControlBase::copyWalkers(MCWalkerConfiguration& W)
   {
     auto& wRef    = good_w[copy_list[i - size_good_w]];
     auto& awalker = good_w[i];
-    if (awalker == nullptr)
+    if (awalker == nullptr || awalker->DataSet.size() != wRef->DataSet.size())
       awalker = std::make_unique<Walker_t>(*wRef);
     else
       *awalker = *wRef;
@@ -535,13 +540,37 @@ int WalkerControlBase::copyWalkers(MCWalkerConfiguration& W)
   W.clear();
   W.insert(W.begin(), std::make_move_iterator(good_w.begin()), std::make_move_iterator(good_w.end()));
 
-  //clear good_w and ncopy_w for the next branch
+  //clear good_w and ncopy_w for the next branch, the remaining bad walkers are kept for the next copies
   good_w.clear();
+  for (auto& awalker : bad_w)
+    recycleWalker(std::move(awalker));
   bad_w.clear();
   ncopy_w.clear();
   return W.getActiveWalkers();
 }
 
+std::unique_ptr<WalkerControlBase::Walker_t> WalkerControlBase::makeWalkerCopy(const Walker_t& from)
+{
+  while (!spare_w.empty())
+  {
+    std::unique_ptr<Walker_t> awalker(std::move(spare_w.back()));
+    spare_w.pop_back();
+    // spare walkers left by a different buffer layout are released
+    if (awalker->DataSet.size() == from.DataSet.size())
+    {
+      *awalker = from;
+      return awalker;
+    }
+  }
+  return std::make_unique<Walker_t>(from);
+}
+
+void WalkerControlBase::recycleWalker(std::unique_ptr<Walker_t>&& awalker)
+{
+  if (awalker)
+    spare_w.push_back(std::move(awalker));
+}
+
 bool WalkerControlBase::put(xmlNodePtr cur)
 {
   int nw_target = 0, nw_max = 0;
@@ -205,6 +205,8 @@ protected:
   std::vector<std::unique_ptr<Walker_t>> good_w, bad_w;
   ///temporary storage for copy counters
   std::vector<int> ncopy_w;
+  ///walkers of the rank recycled across branching steps, their buffers are reused by the new copies
+  std::vector<std::unique_ptr<Walker_t>> spare_w;
   ///Add released-node fields to .dmc.dat file
   bool write_release_nodes_;
   ///Use non-blocking isend/irecv
@@ -212,6 +214,15 @@ protected:
 
   ///ensemble properties
   MCDataType<FullPrecRealType> ensemble_property_;
+
+  /** return a copy of a walker, reusing a spare walker of the same buffer layout if any
+   *
+   *  The assignment to a spare walker keeps its DataSet and particle arrays, no allocation.
+   */
+  std::unique_ptr<Walker_t> makeWalkerCopy(const Walker_t& from);
+
+  /// keep a walker no longer needed by the rank for the next copies
+  void recycleWalker(std::unique_ptr<Walker_t>&& awalker);
 };
 
 } // namespace qmcplusplus
@@ -0,0 +1,391 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "WaveFunctionTesterBatched.h"
+#include <iomanip>
+#include <limits>
+#include "Concurrency/ParallelExecutor.hpp"
+#include "Message/UniformCommunicateError.h"
+#include "Message/CommOperators.h"
+#include "OhmmsData/ParameterSet.h"
+#include "Utilities/Timer.h"
+#include "OMPTarget/ScopedDefaultDevice.h"
+
+namespace qmcplusplus
+{
+namespace
+{
+/// difference relative to the reference, absolute when the reference is below 1
+template<typename T>
+double scaledError(const T& value, const T& ref)
+{
+  return std::abs(value - ref) / std::max(1.0, static_cast<double>(std::abs(ref)));
+}
+
+template<typename T, unsigned D>
+double scaledError(const TinyVector<T, D>& value, const TinyVector<T, D>& ref)
+{
+  double error = 0.0;
+  for (int d = 0; d < D; d++)
+    error = std::max(error, scaledError(value[d], ref[d]));
+  return error;
+}
+
+template<typename T>
+double logError(const std::complex<T>& log_value, const std::complex<T>& ref)
+{
+  return std::max(static_cast<double>(std::abs(log_value.real() - ref.real())),
+                  std::abs(std::remainder(static_cast<double>(log_value.imag() - ref.imag()), 2 * M_PI)));
+}
+} // namespace
+
+WaveFunctionTesterBatched::WaveFunctionTesterBatched(const ProjectData& project_data,
+                                                     QMCDriverInput&& qmcdriver_input,
+                                                     MCPopulation&& pop,
+                                                     Communicate* comm)
+    : QMCDriverNew(project_data,
+                   std::move(qmcdriver_input),
+                   std::move(pop),
+                   "WaveFunctionTesterBatched::",
+                   comm,
+                   "WaveFunctionTesterBatched"),
+      ratio_tolerance_(std::numeric_limits<RealType>::epsilon() < 1e-10 ? 1e-6 : 1e-3),
+      grad_tolerance_(ratio_tolerance_),
+      log_tolerance_(ratio_tolerance_)
+{}
+
+void WaveFunctionTesterBatched::process(xmlNodePtr node)
+{
+  ParameterSet parameter_set;
+  parameter_set.add(ratio_tolerance_, "ratio_tolerance");
+  parameter_set.add(grad_tolerance_, "grad_tolerance");
+  parameter_set.add(log_tolerance_, "log_tolerance");
+  parameter_set.put(node);
+
+  if (qmcdriver_input_.are_walkers_serialized())
+    myComm->barrier_and_abort("WaveFunctionTesterBatched needs the mw_ API, crowd_serialize_walkers must be no.");
+
+  try
+  {
+    QMCDriverNew::AdjustedWalkerCounts awc =
+        adjustGlobalWalkerCount(myComm->size(), myComm->rank(), qmcdriver_input_.get_total_walkers(),
+                                qmcdriver_input_.get_walkers_per_rank(), 1.0, qmcdriver_input_.get_num_crowds(),
+                                getMultiWalkerMemoryPerWalker(),
+                                static_cast<size_t>(qmcdriver_input_.get_walker_memory_budget()) << 20);
+
+    Base::startup(node, awc);
+  }
+  catch (const UniformCommunicateError& ue)
+  {
+    myComm->barrier_and_abort(ue.what());
+  }
+}
+
+void WaveFunctionTesterBatched::testCrowd(int crowd_id,
+                                          const StateForThread& sft,
+                                          UPtrVector<ContextForSteps>& context_for_steps,
+                                          UPtrVector<Crowd>& crowds,
+                                          std::vector<CrowdReport>& reports)
+{
+  Crowd& crowd = *(crowds[crowd_id]);
+  if (crowd.size() == 0)
+    return;
+  ScopedDefaultDevice device_scope(crowd.getDeviceNum());
+  ContextForSteps& step_context = *context_for_steps[crowd_id];
+  const RefVectorWithLeader<ParticleSet> walker_elecs(crowd.get_walker_elecs()[0], crowd.get_walker_elecs());
+  const RefVectorWithLeader<TrialWaveFunction> walker_twfs(crowd.get_walker_twfs()[0], crowd.get_walker_twfs());
+  const int num_walkers    = crowd.size();
+  const int num_particles  = sft.population.get_num_particles();
+  const int num_components = walker_twfs.getLeader().getOrbitals().size();
+
+  CrowdReport& report = reports[crowd_id];
+  report.components.resize(num_components);
+
+  // the displacements of the particles, fastest in walkers, shared by both paths
+  std::vector<PosType> displs(num_particles * num_walkers);
+  step_context.nextDeltaRs(num_particles * num_walkers);
+  for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+  {
+    const RealType sqrttau = std::sqrt(sft.qmcdrv_input.get_tau() * sft.population.get_ptclgrp_inv_mass()[ig]);
+    for (int i = step_context.getPtclGroupStart(ig) * num_walkers; i < step_context.getPtclGroupEnd(ig) * num_walkers;
+         ++i)
+      displs[i] = sqrttau * *(step_context.deltaRsBegin() + i);
+  }
+
+  // results of the per-walker path
+  auto index = [num_particles, num_walkers](int ic, int iat, int iw) {
+    return (ic * num_particles + iat) * num_walkers + iw;
+  };
+  std::vector<LogValueType> log_ref(num_components * num_walkers);
+  std::vector<ParticleSet::ParticleGradient> G_ref(num_components * num_walkers);
+  std::vector<ParticleSet::ParticleLaplacian> L_ref(num_components * num_walkers);
+  std::vector<GradType> grad_now_ref(num_components * num_particles * num_walkers);
+  std::vector<GradType> grad_new_ref(num_components * num_particles * num_walkers);
+  std::vector<PsiValueType> ratio_ref(num_components * num_particles * num_walkers);
+
+  Timer timer;
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    ParticleSet& elecs = walker_elecs[iw];
+    auto& components   = walker_twfs[iw].getOrbitals();
+    elecs.update();
+    LogValueType log_total(0.0);
+    for (int ic = 0; ic < num_components; ++ic)
+    {
+      auto& G = G_ref[ic * num_walkers + iw];
+      auto& L = L_ref[ic * num_walkers + iw];
+      G.resize(num_particles);
+      L.resize(num_particles);
+      G = 0;
+      L = 0;
+      timer.restart();
+      log_ref[ic * num_walkers + iw] = components[ic]->evaluateLog(elecs, G, L);
+      report.components[ic].serial_time += timer.elapsed();
+      log_total += log_ref[ic * num_walkers + iw];
+    }
+    // the walker was left by initialLogEvaluation or by the moves of the previous step
+    const LogValueType log_updated(walker_twfs[iw].getLogPsi(), walker_twfs[iw].getPhase());
+    report.update_log_error = std::max(report.update_log_error, logError(log_total, log_updated));
+
+    for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+    {
+      for (int ic = 0; ic < num_components; ++ic)
+      {
+        timer.restart();
+        components[ic]->prepareGroup(elecs, ig);
+        report.components[ic].serial_time += timer.elapsed();
+      }
+      for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+      {
+        for (int ic = 0; ic < num_components; ++ic)
+        {
+          timer.restart();
+          grad_now_ref[index(ic, iat, iw)] = components[ic]->evalGrad(elecs, iat);
+          report.components[ic].serial_time += timer.elapsed();
+        }
+        elecs.makeMove(iat, displs[iat * num_walkers + iw]);
+        for (int ic = 0; ic < num_components; ++ic)
+        {
+          GradType grad_new(0);
+          timer.restart();
+          ratio_ref[index(ic, iat, iw)] = components[ic]->ratioGrad(elecs, iat, grad_new);
+          components[ic]->restore(iat);
+          report.components[ic].serial_time += timer.elapsed();
+          grad_new_ref[index(ic, iat, iw)] = grad_new;
+        }
+        elecs.accept_rejectMove(iat, false);
+      }
+    }
+    elecs.donePbyP();
+  }
+
+  ResourceCollectionTeamLock<ParticleSet> pset_res_lock(crowd.getSharedResource().pset_res, walker_elecs);
+  ResourceCollectionTeamLock<TrialWaveFunction> twfs_res_lock(crowd.getSharedResource().twf_res, walker_twfs);
+
+  std::vector<RefVectorWithLeader<WaveFunctionComponent>> wfc_lists;
+  wfc_lists.reserve(num_components);
+  for (int ic = 0; ic < num_components; ++ic)
+  {
+    wfc_lists.emplace_back(*walker_twfs.getLeader().getOrbitals()[ic]);
+    for (TrialWaveFunction& twf : walker_twfs)
+      wfc_lists.back().push_back(*twf.getOrbitals()[ic]);
+  }
+
+  std::vector<ParticleSet::ParticleGradient> G_list(num_walkers);
+  std::vector<ParticleSet::ParticleLaplacian> L_list(num_walkers);
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    G_list[iw].resize(num_particles);
+    L_list[iw].resize(num_particles);
+  }
+  const auto G_refs = makeRefVector<ParticleSet::ParticleGradient>(G_list);
+  const auto L_refs = makeRefVector<ParticleSet::ParticleLaplacian>(L_list);
+
+  ParticleSet::mw_update(walker_elecs);
+  for (int ic = 0; ic < num_components; ++ic)
+  {
+    ComponentReport& component_report = report.components[ic];
+    for (int iw = 0; iw < num_walkers; ++iw)
+    {
+      G_list[iw] = 0;
+      L_list[iw] = 0;
+    }
+    timer.restart();
+    wfc_lists[ic].getLeader().mw_evaluateLog(wfc_lists[ic], walker_elecs, G_refs, L_refs);
+    component_report.mw_time += timer.elapsed();
+    for (int iw = 0; iw < num_walkers; ++iw)
+    {
+      const double log_error = logError(wfc_lists[ic][iw].get_log_value(), log_ref[ic * num_walkers + iw]);
+      component_report.log_error = std::max(component_report.log_error, log_error);
+      for (int iat = 0; iat < num_particles; ++iat)
+        component_report.gl_error =
+            std::max({component_report.gl_error, scaledError(G_list[iw][iat], G_ref[ic * num_walkers + iw][iat]),
+                      scaledError(L_list[iw][iat], L_ref[ic * num_walkers + iw][iat])});
+    }
+  }
+
+  std::vector<PosType> move_displs(num_walkers);
+  std::vector<GradType> grads(num_walkers);
+  std::vector<PsiValueType> ratios(num_walkers);
+  const std::vector<bool> rejected(num_walkers, false);
+  for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+  {
+    for (int ic = 0; ic < num_components; ++ic)
+    {
+      timer.restart();
+      wfc_lists[ic].getLeader().mw_prepareGroup(wfc_lists[ic], walker_elecs, ig);
+      report.components[ic].mw_time += timer.elapsed();
+    }
+    for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+    {
+      for (int ic = 0; ic < num_components; ++ic)
+      {
+        ComponentReport& component_report = report.components[ic];
+        std::fill(grads.begin(), grads.end(), GradType(0));
+        timer.restart();
+        wfc_lists[ic].getLeader().mw_evalGrad(wfc_lists[ic], walker_elecs, iat, grads);
+        component_report.mw_time += timer.elapsed();
+        for (int iw = 0; iw < num_walkers; ++iw)
+          component_report.grad_error =
+              std::max(component_report.grad_error, scaledError(grads[iw], grad_now_ref[index(ic, iat, iw)]));
+      }
+      std::copy_n(displs.begin() + iat * num_walkers, num_walkers, move_displs.begin());
+      ParticleSet::mw_makeMove(walker_elecs, iat, move_displs);
+      for (int ic = 0; ic < num_components; ++ic)
+      {
+        ComponentReport& component_report = report.components[ic];
+        std::fill(grads.begin(), grads.end(), GradType(0));
+        std::fill(ratios.begin(), ratios.end(), PsiValueType(0));
+        timer.restart();
+        wfc_lists[ic].getLeader().mw_ratioGrad(wfc_lists[ic], walker_elecs, iat, ratios, grads);
+        wfc_lists[ic].getLeader().mw_accept_rejectMove(wfc_lists[ic], walker_elecs, iat, rejected);
+        component_report.mw_time += timer.elapsed();
+        for (int iw = 0; iw < num_walkers; ++iw)
+        {
+          component_report.ratio_error =
+              std::max(component_report.ratio_error, scaledError(ratios[iw], ratio_ref[index(ic, iat, iw)]));
+          component_report.grad_error =
+              std::max(component_report.grad_error, scaledError(grads[iw], grad_new_ref[index(ic, iat, iw)]));
+        }
+      }
+      ParticleSet::mw_accept_rejectMove(walker_elecs, iat, rejected);
+    }
+  }
+  ParticleSet::mw_donePbyP(walker_elecs);
+
+  // a Metropolis sweep through TrialWaveFunction, its log value is checked at the next step
+  TrialWaveFunction::mw_evaluateLog(walker_twfs, walker_elecs);
+  step_context.nextDeltaRs(num_particles * num_walkers);
+  std::vector<bool> is_accepted(num_walkers);
+  for (int ig = 0; ig < step_context.get_num_groups(); ++ig)
+  {
+    const RealType sqrttau = std::sqrt(sft.qmcdrv_input.get_tau() * sft.population.get_ptclgrp_inv_mass()[ig]);
+    TrialWaveFunction::mw_prepareGroup(walker_twfs, walker_elecs, ig);
+    for (int iat = step_context.getPtclGroupStart(ig); iat < step_context.getPtclGroupEnd(ig); ++iat)
+    {
+      auto delta_r_start = step_context.deltaRsBegin() + iat * num_walkers;
+      std::transform(delta_r_start, delta_r_start + num_walkers, move_displs.begin(),
+                     [sqrttau](const PosType& delta_r) { return sqrttau * delta_r; });
+      ParticleSet::mw_makeMove(walker_elecs, iat, move_displs);
+      TrialWaveFunction::mw_calcRatio(walker_twfs, walker_elecs, iat, ratios);
+      for (int iw = 0; iw < num_walkers; ++iw)
+        is_accepted[iw] = step_context.get_random_gen()() < std::norm(ratios[iw]);
+      TrialWaveFunction::mw_accept_rejectMove(walker_twfs, walker_elecs, iat, is_accepted, true);
+      ParticleSet::mw_accept_rejectMove(walker_elecs, iat, is_accepted);
+    }
+  }
+  TrialWaveFunction::mw_completeUpdates(walker_twfs);
+  ParticleSet::mw_donePbyP(walker_elecs);
+  TrialWaveFunction::mw_evaluateGL(walker_twfs, walker_elecs, false);
+}
+
+bool WaveFunctionTesterBatched::run()
+{
+  app_log() << "\n  WaveFunctionTesterBatched compares the per-walker and the mw_ API of the wavefunction components"
+            << "\n    steps           = " << qmcdriver_input_.get_max_steps()
+            << "\n    ratio_tolerance = " << ratio_tolerance_ << "\n    grad_tolerance  = " << grad_tolerance_
+            << "\n    log_tolerance   = " << log_tolerance_ << std::endl;
+
+  {
+    ScopedTimer local_timer(timers_.init_walkers_timer);
+    ParallelExecutor<> section_start_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
+    section_start_task(crowds_.size(), initialLogEvaluation, std::ref(crowds_), std::ref(step_contexts_));
+  }
+
+  StateForThread tester_state(qmcdriver_input_, population_);
+  std::vector<CrowdReport> reports(crowds_.size());
+  ParallelExecutor<> crowd_task(qmcdriver_input_.get_numa_first_touch(), threads_per_crowd_);
+  for (int step = 0; step < qmcdriver_input_.get_max_steps(); ++step)
+  {
+    ScopedTimer local_timer(timers_.run_steps_timer);
+    crowd_task(crowds_.size(), testCrowd, tester_state, std::ref(step_contexts_), std::ref(crowds_),
+               std::ref(reports));
+  }
+
+  return reportResults(reports);
+}
+
+bool WaveFunctionTesterBatched::reportResults(const std::vector<CrowdReport>& reports)
+{
+  auto& components         = population_.get_golden_twf().getOrbitals();
+  const int num_components = components.size();
+
+  // times are summed and errors maximized over the crowds and the ranks
+  std::vector<double> times(2 * num_components, 0.0);
+  std::vector<double> errors(4 * num_components + 1, 0.0);
+  for (const CrowdReport& report : reports)
+  {
+    for (int ic = 0; ic < report.components.size(); ++ic)
+    {
+      const ComponentReport& component_report = report.components[ic];
+      times[2 * ic] += component_report.serial_time;
+      times[2 * ic + 1] += component_report.mw_time;
+      errors[4 * ic]     = std::max(errors[4 * ic], component_report.log_error);
+      errors[4 * ic + 1] = std::max(errors[4 * ic + 1], component_report.gl_error);
+      errors[4 * ic + 2] = std::max(errors[4 * ic + 2], component_report.grad_error);
+      errors[4 * ic + 3] = std::max(errors[4 * ic + 3], component_report.ratio_error);
+    }
+    errors.back() = std::max(errors.back(), report.update_log_error);
+  }
+  myComm->allreduce(times);
+#ifdef HAVE_MPI
+  myComm->comm.all_reduce_in_place_n(errors.begin(), errors.size(), mpi3::max<>{});
+#endif
+
+  bool all_passed = true;
+  std::ostringstream o;
+  o << "\n  Per-walker and mw_ API of the wavefunction components, times summed over the crowds and the ranks\n"
+    << std::setw(28) << std::left << "  component" << std::right << std::setw(13) << "serial (s)" << std::setw(13)
+    << "mw_ (s)" << std::setw(13) << "log err" << std::setw(13) << "G/L err" << std::setw(13) << "grad err"
+    << std::setw(13) << "ratio err" << "\n";
+  o << std::scientific << std::setprecision(3);
+  for (int ic = 0; ic < num_components; ++ic)
+  {
+    const bool passed = errors[4 * ic] <= log_tolerance_ && errors[4 * ic + 1] <= grad_tolerance_ &&
+        errors[4 * ic + 2] <= grad_tolerance_ && errors[4 * ic + 3] <= ratio_tolerance_;
+    all_passed = all_passed && passed;
+    o << "  " << std::setw(26) << std::left << (std::to_string(ic) + " " + components[ic]->ClassName) << std::right;
+    o << std::setw(13) << times[2 * ic] << std::setw(13) << times[2 * ic + 1];
+    for (int i = 0; i < 4; ++i)
+      o << std::setw(13) << errors[4 * ic + i];
+    o << (passed ? "  PASS" : "  FAIL") << "\n";
+  }
+  const bool update_passed = errors.back() <= log_tolerance_;
+  all_passed               = all_passed && update_passed;
+  o << "  " << std::setw(26) << std::left << "updated log value" << std::right << std::setw(39) << errors.back()
+    << (update_passed ? "  PASS" : "  FAIL") << "\n";
+  o << "  WaveFunctionTesterBatched " << (all_passed ? "PASSED" : "FAILED") << "\n";
+  app_log() << o.str() << std::endl;
+  return all_passed;
+}
+
+} // namespace qmcplusplus
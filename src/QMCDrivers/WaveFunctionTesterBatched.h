@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_WAVEFUNCTIONTESTERBATCHED_H
+#define QMCPLUSPLUS_WAVEFUNCTIONTESTERBATCHED_H
+
+#include "QMCDrivers/QMCDriverNew.h"
+#include "QMCDrivers/MCPopulation.h"
+#include "QMCDrivers/ContextForSteps.h"
+
+namespace qmcplusplus
+{
+/** @ingroup QMCDrivers
+ * @brief Checks the mw_ API of every wavefunction component against its per-walker API
+ *
+ * Every step the walkers of each crowd go through the same particle-by-particle displacements twice,
+ * once calling the single walker functions of each component walker by walker and once calling the mw_ functions
+ * on the whole crowd. All the moves are rejected so both paths start from the same state. The log values,
+ * the gradients and laplacians, the ratios and the gradients before and after the moves are compared and both
+ * paths are timed per component. A Metropolis sweep through TrialWaveFunction then moves the walkers, the log
+ * value updated along the sweep is compared with the one from scratch at the next step.
+ */
+class WaveFunctionTesterBatched : public QMCDriverNew
+{
+public:
+  using Base         = QMCDriverNew;
+  using PosType      = QMCTraits::PosType;
+  using GradType     = WaveFunctionComponent::GradType;
+  using PsiValueType = WaveFunctionComponent::PsiValueType;
+  using LogValueType = WaveFunctionComponent::LogValueType;
+
+  /// largest differences between the two paths and time spent in each for one component
+  struct ComponentReport
+  {
+    double serial_time = 0.0;
+    double mw_time     = 0.0;
+    /// log values, the phases are compared modulo 2 pi
+    double log_error = 0.0;
+    /// gradients and laplacians from evaluateLog
+    double gl_error = 0.0;
+    /// gradients from evalGrad and ratioGrad
+    double grad_error = 0.0;
+    double ratio_error = 0.0;
+  };
+
+  struct CrowdReport
+  {
+    std::vector<ComponentReport> components;
+    /// log value of the TrialWaveFunction updated along the moves against the one from scratch
+    double update_log_error = 0.0;
+  };
+
+  struct StateForThread
+  {
+    const QMCDriverInput& qmcdrv_input;
+    const MCPopulation& population;
+
+    StateForThread(const QMCDriverInput& qmci, const MCPopulation& pop) : qmcdrv_input(qmci), population(pop) {}
+  };
+
+  /// Constructor.
+  WaveFunctionTesterBatched(const ProjectData& project_data,
+                            QMCDriverInput&& qmcdriver_input,
+                            MCPopulation&& pop,
+                            Communicate* comm);
+
+  void process(xmlNodePtr node) override;
+
+  /** run the tests for the steps of the input
+   * @return true if all the differences are within the tolerances
+   */
+  bool run() override;
+
+  /** compare the per-walker and the mw_ paths on the walkers of a crowd and move them
+   *
+   *  The per-walker path runs before the crowd resources are acquired.
+   */
+  static void testCrowd(int crowd_id,
+                        const StateForThread& sft,
+                        UPtrVector<ContextForSteps>& context_for_steps,
+                        UPtrVector<Crowd>& crowds,
+                        std::vector<CrowdReport>& reports);
+
+private:
+  QMCRunType getRunType() override { return QMCRunType::WF_TEST_BATCH; }
+
+  /// largest difference of the ratios relative to the per-walker ones, absolute below 1
+  RealType ratio_tolerance_;
+  /// largest difference of the gradients and laplacians relative to the per-walker ones, absolute below 1
+  RealType grad_tolerance_;
+  /// largest difference of the log values
+  RealType log_tolerance_;
+
+  /// reduce the reports over the crowds and the ranks and print them, true if all pass
+  bool reportResults(const std::vector<CrowdReport>& reports);
+};
+
+} // namespace qmcplusplus
+
+#endif
@@ -29,6 +29,7 @@ class QMCDriverNewTestWrapper : public QMCDriverNew
 {
 public:
   using Base = QMCDriverNew;
+  using Base::moveAllElectrons;
   QMCDriverNewTestWrapper(QMCDriverInput&& input, MCPopulation&& population, SampleStack samples, Communicate* comm)
       : QMCDriverNew(test_project,
                      std::move(input),
@@ -118,6 +119,38 @@ public:
     // Ask for 14 total walkers on 16 ranks (inconsistent input)
     // results in fatal exception on all ranks.
     CHECK_THROWS_AS(adjustGlobalWalkerCount(16, 0, 14, 0, 0, 0), UniformCommunicateError);
+
+    // 1 MiB per walker with a budget of 10 MiB on each rank allows 2 walkers in each of the 4 crowds
+    awc = adjustGlobalWalkerCount(2, 1, 0, 0, 1.0, 4, 1 << 20, 10 << 20);
+    CHECK(awc.global_walkers == 16);
+    CHECK(awc.walkers_per_rank[1] == 8);
+    CHECK(awc.walkers_per_crowd.size() == 4);
+    CHECK(awc.walkers_per_crowd[3] == 2);
+    // explicit walker counts take precedence over the memory budget
+    awc = adjustGlobalWalkerCount(2, 1, 0, 32, 1.0, 4, 1 << 20, 10 << 20);
+    CHECK(awc.walkers_per_crowd[3] == 8);
+    // not enough memory for one walker in each crowd
+    CHECK_THROWS_AS(adjustGlobalWalkerCount(2, 1, 0, 0, 1.0, 4, 1 << 20, 3 << 20), UniformCommunicateError);
+  }
+
+  void testThreadsPerCrowd()
+  {
+    // 8 threads
+    CHECK(determineThreadsPerCrowd(0, 8) == 1);
+    CHECK(determineThreadsPerCrowd(0, 3) == 2);
+    CHECK(determineThreadsPerCrowd(0, 1) == 8);
+    CHECK(determineThreadsPerCrowd(2, 4) == 2);
+    CHECK_THROWS_AS(determineThreadsPerCrowd(3, 4), UniformCommunicateError);
+    CHECK_THROWS_AS(determineThreadsPerCrowd(-1, 4), UniformCommunicateError);
+  }
+
+  void testAssignCrowdDevices()
+  {
+    CHECK(assignCrowdDevices({}, 2) == std::vector<int>{-1, -1});
+    CHECK(assignCrowdDevices({1}, 3) == std::vector<int>{1, 1, 1});
+    CHECK(assignCrowdDevices({0, 2}, 4) == std::vector<int>{0, 0, 2, 2});
+    CHECK(assignCrowdDevices({0, 2}, 3) == std::vector<int>{0, 0, 2});
+    CHECK(assignCrowdDevices({1, 3, 5}, 2) == std::vector<int>{1, 3});
   }
 
   bool run() override { return false; }
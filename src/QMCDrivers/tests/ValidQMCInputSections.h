@@ -116,6 +116,40 @@ constexpr std::array<const char*, 2> valid_opt_input_sections{
   </qmc>
 )"};
 
+constexpr std::array<const char*, 1> valid_rmc_input_sections{
+    R"(
+  <qmc method="rmc_batch" move="pbyp">
+    <parameter name="crowds">                 2 </parameter>
+    <estimator name="LocalEnergy" hdf5="no" />
+    <parameter name="total_walkers">          4 </parameter>
+    <parameter name="beads">                  8 </parameter>
+    <parameter name="vmcpresteps">            4 </parameter>
+    <parameter name="warmupSteps">            2 </parameter>
+    <parameter name="steps">                  2 </parameter>
+    <parameter name="blocks">                 2 </parameter>
+    <parameter name="timestep">             0.1 </parameter>
+    <parameter name="maxAge">                20 </parameter>
+  </qmc>
+)"};
+
+constexpr int valid_rmc_input_rmc_batch_index = 0;
+
+constexpr std::array<const char*, 1> valid_csvmc_input_sections{
+    R"(
+  <qmc method="csvmc_batch" move="pbyp">
+    <qmcsystem wavefunction="psi0" hamiltonian="h0"/>
+    <parameter name="crowds">                 2 </parameter>
+    <estimator name="LocalEnergy" hdf5="no" />
+    <parameter name="total_walkers">          4 </parameter>
+    <parameter name="warmupSteps">            2 </parameter>
+    <parameter name="steps">                  2 </parameter>
+    <parameter name="blocks">                 2 </parameter>
+    <parameter name="timestep">             0.1 </parameter>
+  </qmc>
+)"};
+
+constexpr int valid_csvmc_input_csvmc_batch_index = 0;
+
 // clang-format: on
 } // namespace testing
 } // namespace qmcplusplus
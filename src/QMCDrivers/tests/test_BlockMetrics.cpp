@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include <sstream>
+#include "QMCDrivers/BlockMetrics.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("BlockMetrics", "[drivers]")
+{
+  TimerManager<FakeTimer> tm;
+  tm.set_timer_threshold(timer_level_fine);
+  FakeTimer& t1 = *tm.createTimer("timer1");
+  FakeTimer& t2 = *tm.createTimer("timer2");
+
+  BlockMetrics<FakeCPUClock> metrics;
+  metrics.addCategory("wavefunction", {t1});
+  metrics.addCategory("hamiltonian", {t2});
+
+  // the fake clock advances by 1 at each reading
+  FakeCPUClock::fake_cpu_clock_increment = 1.0;
+  t1.start();
+  t1.stop();
+  metrics.startBlock();
+  t1.start();
+  t1.stop();
+  t2.start();
+  t2.stop();
+  t1.start();
+  t1.stop();
+  const auto record = metrics.stopBlock(8, 100, 25, 4);
+
+  CHECK(record.block == 0);
+  CHECK(record.wall_time == Approx(7.0));
+  CHECK(record.walker_moves == Approx(8.0));
+  REQUIRE(record.category_times.size() == 2);
+#ifdef ENABLE_TIMERS
+  // the time before the block is not counted
+  CHECK(record.category_times[0] == Approx(2.0));
+  CHECK(record.category_times[1] == Approx(1.0));
+#endif
+
+  std::ostringstream os;
+  metrics.writeJSON(os, "VMCBatched", record);
+  const std::string line = os.str();
+  CHECK(line.find("\"driver\":\"VMCBatched\",\"block\":0,") != std::string::npos);
+  CHECK(line.find("\"acceptance\":0.25,") != std::string::npos);
+  CHECK(line.find("\"time\":{\"wavefunction\":") != std::string::npos);
+  CHECK(line.back() == '\n');
+
+  metrics.startBlock();
+  CHECK(metrics.stopBlock(0, 0, 0, 0).block == 1);
+}
+
+TEST_CASE("BlockMetrics comm profile", "[drivers]")
+{
+  BlockMetrics<FakeCPUClock> metrics;
+  comm_profile.reset();
+  comm_profile.add("test::before", 1.0, 8);
+  comm_profile.enable(true);
+  metrics.startBlock();
+  comm_profile.add("test::send", 0.5, 64);
+  comm_profile.add("test::send", 0.25, 32);
+  auto record = metrics.stopBlock(1, 1, 1, 1);
+  comm_profile.enable(false);
+
+  // only the operations of the block are counted
+  CHECK(record.comm_time == Approx(0.75));
+  CHECK(record.comm_calls == 2);
+  CHECK(record.comm_bytes == 96);
+
+  record.rank_comm_times = {0.75, 0.5, 1.0};
+  comm_profile.enable(true);
+  std::ostringstream os;
+  metrics.writeJSON(os, "DMCBatched", record);
+  comm_profile.enable(false);
+  const std::string line = os.str();
+  CHECK(line.find("\"comm_calls\":2,\"comm_bytes\":96") != std::string::npos);
+  CHECK(line.find("\"comm_time_ranks\":{\"min\":0.5,\"median\":0.75,") != std::string::npos);
+  comm_profile.reset();
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "QMCDrivers/CorrelatedSampling/CSVMCBatched.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("CSVMCBatched umbrella weights", "[drivers]")
+{
+  using FullPrecRealType = CSVMCBatched::FullPrecRealType;
+  std::vector<FullPrecRealType> weights;
+
+  // equal wavefunctions and norms share the weight
+  CSVMCBatched::computeUmbrellaWeights({-3.0, -3.0}, {1.0, 1.0}, weights);
+  REQUIRE(weights.size() == 2);
+  CHECK(weights[0] == Approx(0.5));
+  CHECK(weights[1] == Approx(0.5));
+
+  // w_i = (|psi_i|^2/N_i) / sum_j |psi_j|^2/N_j, log|psi_1| - log|psi_0| = 0.5 and N_1 = 2 N_0
+  CSVMCBatched::computeUmbrellaWeights({0.0, 0.5}, {1.0, 2.0}, weights);
+  const FullPrecRealType r = std::exp(1.0) / 2.0;
+  CHECK(weights[0] == Approx(1.0 / (1.0 + r)));
+  CHECK(weights[1] == Approx(r / (1.0 + r)));
+
+  // logs far beyond the range of exp
+  CSVMCBatched::computeUmbrellaWeights({-2000.0, -2000.0, -2000.0 + 0.5 * std::log(2.0)}, {1.0, 1.0, 1.0}, weights);
+  CHECK(weights[0] == Approx(0.25));
+  CHECK(weights[1] == Approx(0.25));
+  CHECK(weights[2] == Approx(0.5));
+}
+
+TEST_CASE("CSVMCBatched accumulator", "[drivers]")
+{
+  CSVMCBatched::CSAccumulator acc;
+  acc.resize(3);
+  acc.weight[1]          = 0.5;
+  acc.weighted_energy[2] = -1.0;
+  acc.num_samples        = 4;
+  acc.reset();
+  CHECK(acc.weight.size() == 3);
+  CHECK(acc.weight[1] == 0.0);
+  CHECK(acc.weighted_energy[2] == 0.0);
+  CHECK(acc.num_samples == 0.0);
+}
+
+} // namespace qmcplusplus
@@ -23,6 +23,30 @@
 
 namespace qmcplusplus
 {
+TEST_CASE("ContextForSteps::acceptMoves", "[drivers]")
+{
+  const int num_walkers   = 3;
+  const int num_particles = 2;
+  RandomGenerator rng(13);
+  RandomGenerator rng_ref(rng);
+  ContextForSteps step_context(num_walkers, num_particles, {{0, 2}}, rng);
+
+  step_context.nextAcceptUniforms(num_walkers * num_particles);
+  std::vector<ContextForSteps::FullPrecRealType> uniforms(num_walkers * num_particles);
+  for (auto& u : uniforms)
+    u = rng_ref();
 
+  // always accepted, always rejected, and right at the uniform of the walker
+  const int iat       = 1;
+  const auto u_walker = uniforms[iat * num_walkers + 2];
+  std::vector<ContextForSteps::RealType> prob{1.0, 0.0, static_cast<ContextForSteps::RealType>(u_walker)};
+  std::vector<bool> is_accepted;
+  const int num_accepted = step_context.acceptMoves(iat, prob, is_accepted);
+  REQUIRE(is_accepted.size() == num_walkers);
+  CHECK(is_accepted[0]);
+  CHECK(!is_accepted[1]);
+  CHECK(is_accepted[2] == (u_walker < prob[2]));
+  CHECK(num_accepted == static_cast<int>(is_accepted[0]) + static_cast<int>(is_accepted[2]));
+}
 
 } // namespace qmcplusplus
@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "QMCDrivers/DMC/DMCDriverInput.h"
+#include "QMCDrivers/tests/ValidQMCInputSections.h"
+#include "OhmmsData/Libxml2Doc.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("DMCDriverInput readXML", "[drivers]")
+{
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(testing::valid_dmc_input_sections[testing::valid_dmc_input_dmc_batch_index]);
+  REQUIRE(okay);
+  DMCDriverInput dmcdriver_input;
+  dmcdriver_input.readXML(doc.getRoot());
+  CHECK(dmcdriver_input.get_reserve() == Approx(1.25));
+  CHECK(dmcdriver_input.get_timesteps().empty());
+  CHECK(!dmcdriver_input.get_L2_diffusion());
+}
+
+TEST_CASE("DMCDriverInput L2_diffusion", "[drivers]")
+{
+  const char* dmc_xml = R"(
+  <qmc method="dmc_batch" move="pbyp">
+    <parameter name="steps">          1 </parameter>
+    <parameter name="L2_diffusion"> yes </parameter>
+  </qmc>
+)";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(dmc_xml);
+  REQUIRE(okay);
+  DMCDriverInput dmcdriver_input;
+  dmcdriver_input.readXML(doc.getRoot());
+  CHECK(dmcdriver_input.get_L2_diffusion());
+}
+
+TEST_CASE("DMCDriverInput timesteps", "[drivers]")
+{
+  const char* dmc_xml = R"(
+  <qmc method="dmc_batch" move="pbyp">
+    <parameter name="steps">                  1 </parameter>
+    <parameter name="blocks">                 2 </parameter>
+    <parameter name="timesteps">   0.04 0.02 0.01 </parameter>
+    <parameter name="timestep_warmup_steps">  7 </parameter>
+  </qmc>
+)";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(dmc_xml);
+  REQUIRE(okay);
+  DMCDriverInput dmcdriver_input;
+  dmcdriver_input.readXML(doc.getRoot());
+  REQUIRE(dmcdriver_input.get_timesteps().size() == 3);
+  CHECK(dmcdriver_input.get_timesteps()[0] == Approx(0.04));
+  CHECK(dmcdriver_input.get_timesteps()[2] == Approx(0.01));
+  CHECK(dmcdriver_input.get_timestep_warmup_steps() == 7);
+
+  const char* bad_xml = R"(
+  <qmc method="dmc_batch" move="pbyp">
+    <parameter name="timesteps">   0.04 -0.02 </parameter>
+  </qmc>
+)";
+  okay = doc.parseFromString(bad_xml);
+  REQUIRE(okay);
+  DMCDriverInput bad_input;
+  CHECK_THROWS_AS(bad_input.readXML(doc.getRoot()), std::runtime_error);
+}
+
+TEST_CASE("DMCDriverInput reconfiguration", "[drivers]")
+{
+  auto read_reconfiguration = [](const std::string& value) {
+    const std::string dmc_xml = R"(
+  <qmc method="dmc_batch" move="pbyp">
+    <parameter name="reconfiguration"> )" +
+        value + R"( </parameter>
+  </qmc>
+)";
+    Libxml2Document doc;
+    REQUIRE(doc.parseFromString(dmc_xml));
+    DMCDriverInput dmcdriver_input;
+    dmcdriver_input.readXML(doc.getRoot());
+    return dmcdriver_input.get_reconfiguration();
+  };
+
+  CHECK(!read_reconfiguration("no"));
+  CHECK(read_reconfiguration("local"));
+  CHECK_THROWS_AS(read_reconfiguration("yes"), std::runtime_error);
+  CHECK_THROWS_AS(read_reconfiguration("runwhileincorrect"), std::runtime_error);
+}
+
+} // namespace qmcplusplus
@@ -43,18 +43,31 @@ TEST_CASE("MCPopulation::createWalkers", "[particle][population]")
   CHECK(population.get_num_local_walkers() == 8);
 }
 
-// TEST_CASE("MCPopulation::createWalkers first touch", "[particle][population]")
-// {
-//   MCPopulation population(1, 2);
-//   ParticleAttrib<TinyVector<QMCTraits::RealType, 3>> some_pos(2);
-//   some_pos[0] = TinyVector<double, 3>(1.0, 0.0, 0.0);
-//   some_pos[1] = TinyVector<double, 3>(0.0, 1.0, 0.0);
-
-//   population.createWalkers(8, 2, 16, some_pos);
-//   REQUIRE(population.get_walkers().size() == 16);
-//   // Someday here we should use hwloc or similar to query that the memory is close to
-//   // each thread.
-// }
+TEST_CASE("MCPopulation::createWalkers first touch", "[particle][population]")
+{
+  using namespace testing;
+  Communicate* comm;
+  comm = OHMMS::Controller;
+
+  auto particle_pool     = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool = MinimalWaveFunctionPool::make_diamondC_1x1x1(comm, particle_pool);
+  wavefunction_pool.setPrimary(wavefunction_pool.getWaveFunction("psi0"));
+  auto wf_factory       = wavefunction_pool.getWaveFunctionFactory("wavefunction");
+  auto hamiltonian_pool = MinimalHamiltonianPool::make_hamWithEE(comm, particle_pool, wavefunction_pool);
+  TrialWaveFunction twf;
+  WalkerConfigurations walker_confs;
+
+  MCPopulation population(1, comm->rank(), walker_confs, particle_pool.getParticleSet("e"), &twf, wf_factory,
+                          hamiltonian_pool.getPrimary());
+
+  // walkers created by the threads of 3 crowds, the reserve ones by any thread
+  population.createWalkers(8, 1.5, 3);
+  CHECK(population.get_walkers().size() == 8);
+  CHECK(population.get_dead_walkers().size() == 4);
+  CHECK(population.get_num_local_walkers() == 8);
+  for (auto& walker : population.get_walkers())
+    CHECK(walker->R.size() == particle_pool.getParticleSet("e")->getTotalNum());
+}
 
 TEST_CASE("MCPopulation::redistributeWalkers", "[particle][population]")
 {
@@ -88,6 +101,68 @@ TEST_CASE("MCPopulation::redistributeWalkers", "[particle][population]")
   population.redistributeWalkers(walker_consumers_incommensurate);
   REQUIRE((*walker_consumers_incommensurate[0]).walkers.size() == 3);
   REQUIRE((*walker_consumers_incommensurate[2]).walkers.size() == 2);
+
+  // the last three walkers are to be recomputed, as copies made by branching are
+  for (int iw = 0; iw < 8; iw++)
+    population.get_walkers()[iw]->wasTouched = iw >= 5;
+  population.redistributeWalkers(walker_consumers_incommensurate, true);
+  for (auto& consumer : walker_consumers_incommensurate)
+  {
+    auto num_touched = std::count_if(consumer->walkers.begin(), consumer->walkers.end(),
+                                     [](const auto& walker) { return walker.get().wasTouched; });
+    CHECK(num_touched == 1);
+  }
+  REQUIRE((*walker_consumers_incommensurate[0]).walkers.size() == 3);
+  REQUIRE((*walker_consumers_incommensurate[2]).walkers.size() == 2);
+}
+
+TEST_CASE("MCPopulation::killDeadWalkers", "[particle][population]")
+{
+  using namespace testing;
+  Communicate* comm;
+  comm = OHMMS::Controller;
+
+  auto particle_pool     = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool = MinimalWaveFunctionPool::make_diamondC_1x1x1(comm, particle_pool);
+  wavefunction_pool.setPrimary(wavefunction_pool.getWaveFunction("psi0"));
+  auto wf_factory       = wavefunction_pool.getWaveFunctionFactory("wavefunction");
+  auto hamiltonian_pool = MinimalHamiltonianPool::make_hamWithEE(comm, particle_pool, wavefunction_pool);
+  TrialWaveFunction twf;
+  WalkerConfigurations walker_confs;
+
+  MCPopulation population(1, comm->rank(), walker_confs, particle_pool.getParticleSet("e"), &twf, wf_factory,
+                          hamiltonian_pool.getPrimary());
+
+  population.createWalkers(6);
+  auto& walkers = population.get_walkers();
+  for (int iw = 0; iw < 6; iw++)
+    walkers[iw]->Weight = iw + 0.5;
+
+  population.syncBranchingData();
+  auto& branching_data = population.get_branching_data();
+  REQUIRE(branching_data.weights.size() == 6);
+  CHECK(branching_data.weights[3] == Approx(3.5));
+  CHECK(branching_data.multiplicities[3] == 1);
+
+  // walkers 1 and 4 die
+  for (int iw = 0; iw < 6; iw++)
+    branching_data.multiplicities[iw] = (iw == 1 || iw == 4) ? 0 : 2;
+  population.applyMultiplicities();
+  CHECK(walkers[1]->Multiplicity == Approx(0.0));
+  CHECK(walkers[2]->Multiplicity == Approx(2.0));
+
+  CHECK(population.killDeadWalkers() == 2);
+  REQUIRE(walkers.size() == 4);
+  CHECK(population.get_num_local_walkers() == 4);
+  CHECK(population.get_elec_particle_sets().size() == 4);
+  CHECK(population.get_dead_walkers().size() == 2);
+  // the surviving walkers keep their order
+  CHECK(walkers[0]->Weight == Approx(0.5));
+  CHECK(walkers[1]->Weight == Approx(2.5));
+  CHECK(walkers[2]->Weight == Approx(3.5));
+  CHECK(walkers[3]->Weight == Approx(5.5));
+  CHECK(population.get_dead_walkers()[0]->Weight == Approx(1.5));
+  CHECK(population.get_dead_walkers()[1]->Weight == Approx(4.5));
 }
 
 } // namespace qmcplusplus
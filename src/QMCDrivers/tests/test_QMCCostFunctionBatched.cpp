@@ -11,6 +11,8 @@
 
 #include "catch.hpp"
 #include "QMCDrivers/WFOpt/QMCCostFunctionBatched.h"
+#include "QMCDrivers/Optimizers/DescentEngine.h"
+#include "OhmmsData/Libxml2Doc.h"
 #include "FillData.h"
 // Input data and gold data for fillFromText test
 #include "diamond_fill_data.h"
@@ -83,6 +85,83 @@ public:
     getDerivRecords().resize(numSamples, numParam);
     getHDerivRecords().resize(numSamples, numParam);
   }
+
+  // feed the samples to the streaming accumulation as VMC steps of walkers_per_step walkers
+  void stream_samples(const Matrix<QMCCostFunctionBase::Return_rt>& deriv_records,
+                      const Matrix<QMCCostFunctionBase::Return_rt>& hderiv_records,
+                      const std::vector<QMCCostFunctionBase::Return_rt>& energies,
+                      int walkers_per_step)
+  {
+    costFn.resetStreamingMoments(walkers_per_step);
+    for (int first = 0; first < numSamples; first += walkers_per_step)
+    {
+      for (int iw = 0; iw < walkers_per_step; iw++)
+      {
+        for (int j = 0; j < numParam; j++)
+        {
+          costFn.StepDerivRecords_(iw, j)       = deriv_records(first + iw, j);
+          costFn.StepHDerivRecords_(iw, j)      = hderiv_records(first + iw, j);
+          costFn.StepDerivEnergyRecords_(iw, j) = deriv_records(first + iw, j) * energies[first + iw];
+        }
+        costFn.step_energies_[iw] = energies[first + iw];
+      }
+      costFn.accumulateStep();
+    }
+    costFn.stopAccumulation();
+  }
+
+  // stream the samples to a descent engine updating the parameters every update_steps steps, returns the number of updates
+  int stream_descent_samples(DescentEngine& engine,
+                             int update_steps,
+                             const Matrix<QMCCostFunctionBase::Return_rt>& deriv_records,
+                             const Matrix<QMCCostFunctionBase::Return_rt>& hderiv_records,
+                             const std::vector<QMCCostFunctionBase::Return_rt>& energies,
+                             int walkers_per_step)
+  {
+    costFn.OptVariablesForPsi    = costFn.OptVariables;
+    costFn.stream_crowd_offsets_ = {0, walkers_per_step};
+    costFn.setStreamingDescent(&engine, update_steps);
+    costFn.resetStreamingMoments(walkers_per_step);
+    engine.prepareStorage(1, numParam);
+    int num_updates = 0;
+    for (int first = 0; first < numSamples; first += walkers_per_step)
+    {
+      for (int iw = 0; iw < walkers_per_step; iw++)
+      {
+        for (int j = 0; j < numParam; j++)
+        {
+          costFn.StepDerivRecords_(iw, j)  = deriv_records(first + iw, j);
+          costFn.StepHDerivRecords_(iw, j) = hderiv_records(first + iw, j);
+        }
+        costFn.step_energies_[iw] = energies[first + iw];
+      }
+      if (costFn.accumulateStep())
+        num_updates++;
+    }
+    costFn.stopAccumulation();
+    return num_updates;
+  }
+
+  // linear parameters at ref_params when the records were computed, now at new_params
+  void set_linear_params(const std::vector<QMCCostFunctionBase::Return_rt>& ref_params,
+                         const std::vector<QMCCostFunctionBase::Return_rt>& new_params)
+  {
+    for (int i = 0; i < new_params.size(); i++)
+      costFn.OptVariablesForPsi.insert("lin" + std::to_string(i), new_params[i], true, optimize::LINEAR_P);
+    costFn.linear_ref_params_ = ref_params;
+  }
+
+  bool getLinearParameterChange(std::vector<QMCCostFunctionBase::Return_rt>& delta) const
+  {
+    return costFn.getLinearParameterChange(delta);
+  }
+
+  void evaluateLinearParameterChange(const std::vector<QMCCostFunctionBase::Return_rt>& delta,
+                                     QMCCostFunctionBase::Return_rt& wgt_sum,
+                                     QMCCostFunctionBase::Return_rt& wgt2_sum)
+  {
+    costFn.evaluateLinearParameterChange(delta, 1.0 / numSamples, wgt_sum, wgt2_sum);
+  }
 };
 
 } // namespace testing
@@ -207,4 +286,276 @@ TEST_CASE("fillfromText", "[drivers]")
 }
 
 
+// The matrix-free products should match the products with the matrices of fillOverlapHamiltonianMatrices
+TEST_CASE("applyOverlapHamiltonian", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+
+  FillData fd;
+  get_diamond_fill_data(fd);
+
+  Communicate* comm = OHMMS::Controller;
+  for (int num_opt_crowds = 1; num_opt_crowds < 3; num_opt_crowds++)
+  {
+    testing::LinearMethodTestSupport lin(num_opt_crowds, 1, comm);
+    lin.set_samples_and_param(fd.numSamples, fd.numParam);
+
+    std::vector<Return_rt>& SumValue           = lin.getSumValue();
+    SumValue[QMCCostFunctionBase::SUM_WGT]     = fd.sum_wgt;
+    SumValue[QMCCostFunctionBase::SUM_E_WGT]   = fd.sum_e_wgt;
+    SumValue[QMCCostFunctionBase::SUM_ESQ_WGT] = fd.sum_esq_wgt;
+    auto& RecordsOnNode                        = lin.getRecordsOnNode();
+    for (int iw = 0; iw < fd.numSamples; iw++)
+    {
+      RecordsOnNode(iw, QMCCostFunctionBase::REWEIGHT)   = fd.reweight[iw];
+      RecordsOnNode(iw, QMCCostFunctionBase::ENERGY_NEW) = fd.energy_new[iw];
+    }
+    lin.getDerivRecords()  = fd.derivRecords;
+    lin.getHDerivRecords() = fd.HDerivRecords;
+
+    const int N = fd.numParam + 1;
+    Matrix<Return_rt> ham(N, N);
+    Matrix<Return_rt> ovlp(N, N);
+    lin.costFn.fillOverlapHamiltonianMatrices(ham, ovlp);
+
+    std::vector<Return_rt> ham_diag, ovlp_diag;
+    lin.costFn.fillOverlapHamiltonianDiagonals(ham_diag, ovlp_diag);
+    REQUIRE(ham_diag.size() == N);
+    for (int i = 0; i < N; i++)
+    {
+      CHECK(ham_diag[i] == Approx(ham(i, i)));
+      CHECK(ovlp_diag[i] == Approx(ovlp(i, i)));
+    }
+
+    std::vector<Return_rt> x(N), ham_x, ovlp_x;
+    for (int i = 0; i < N; i++)
+      x[i] = 1.0 - 0.1 * i;
+    lin.costFn.applyOverlapHamiltonian(x, ham_x, ovlp_x);
+    REQUIRE(ham_x.size() == N);
+    for (int i = 0; i < N; i++)
+    {
+      Return_rt ham_x_ref(0), ovlp_x_ref(0);
+      for (int j = 0; j < N; j++)
+      {
+        ham_x_ref += ham(i, j) * x[j];
+        ovlp_x_ref += ovlp(i, j) * x[j];
+      }
+      CHECK(ham_x[i] == Approx(ham_x_ref));
+      CHECK(ovlp_x[i] == Approx(ovlp_x_ref));
+    }
+  }
+}
+
+
+// The stochastic reconstruction gradient and overlap products should match the energy blocks of the
+// linear method matrices, g_i = H_0i + H_i0 and S_ij = O_ij
+TEST_CASE("applyParameterOverlap", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+
+  FillData fd;
+  get_diamond_fill_data(fd);
+
+  Communicate* comm = OHMMS::Controller;
+  for (int num_opt_crowds = 1; num_opt_crowds < 3; num_opt_crowds++)
+  {
+    testing::LinearMethodTestSupport lin(num_opt_crowds, 1, comm);
+    lin.set_samples_and_param(fd.numSamples, fd.numParam);
+
+    std::vector<Return_rt>& SumValue           = lin.getSumValue();
+    SumValue[QMCCostFunctionBase::SUM_WGT]     = fd.sum_wgt;
+    SumValue[QMCCostFunctionBase::SUM_E_WGT]   = fd.sum_e_wgt;
+    SumValue[QMCCostFunctionBase::SUM_ESQ_WGT] = fd.sum_esq_wgt;
+    auto& RecordsOnNode                        = lin.getRecordsOnNode();
+    for (int iw = 0; iw < fd.numSamples; iw++)
+    {
+      RecordsOnNode(iw, QMCCostFunctionBase::REWEIGHT)   = fd.reweight[iw];
+      RecordsOnNode(iw, QMCCostFunctionBase::ENERGY_NEW) = fd.energy_new[iw];
+    }
+    lin.getDerivRecords()  = fd.derivRecords;
+    lin.getHDerivRecords() = fd.HDerivRecords;
+
+    const int N = fd.numParam + 1;
+    Matrix<Return_rt> ham(N, N);
+    Matrix<Return_rt> ovlp(N, N);
+    lin.costFn.fillOverlapHamiltonianMatrices(ham, ovlp);
+
+    std::vector<Return_rt> gradient, S_diag;
+    Return_rt energy = lin.costFn.fillEnergyGradientOverlapDiagonal(gradient, S_diag);
+    CHECK(energy == Approx(ham(0, 0)));
+    REQUIRE(gradient.size() == fd.numParam);
+    for (int i = 0; i < fd.numParam; i++)
+    {
+      CHECK(gradient[i] == Approx(ham(0, i + 1) + ham(i + 1, 0)));
+      CHECK(S_diag[i] == Approx(ovlp(i + 1, i + 1)));
+    }
+
+    std::vector<Return_rt> x(fd.numParam), S_x;
+    for (int i = 0; i < fd.numParam; i++)
+      x[i] = 1.0 - 0.1 * i;
+    lin.costFn.applyParameterOverlap(x, S_x);
+    REQUIRE(S_x.size() == fd.numParam);
+    for (int i = 0; i < fd.numParam; i++)
+    {
+      Return_rt S_x_ref(0);
+      for (int j = 0; j < fd.numParam; j++)
+        S_x_ref += ovlp(i + 1, j + 1) * x[j];
+      CHECK(S_x[i] == Approx(S_x_ref));
+    }
+  }
+}
+
+
+// The matrices built from the moments of streamed samples should match the matrices built from the records
+TEST_CASE("streamed samples", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+
+  FillData fd;
+  // all the samples of the diamond data have unit weight, as streamed samples
+  get_diamond_fill_data(fd);
+
+  Communicate* comm = OHMMS::Controller;
+  for (int num_opt_crowds = 1; num_opt_crowds < 3; num_opt_crowds++)
+  {
+    testing::LinearMethodTestSupport lin(num_opt_crowds, 1, comm);
+    lin.set_samples_and_param(fd.numSamples, fd.numParam);
+    lin.stream_samples(fd.derivRecords, fd.HDerivRecords, fd.energy_new, 5);
+
+    std::vector<Return_rt>& SumValue = lin.getSumValue();
+    CHECK(SumValue[QMCCostFunctionBase::SUM_WGT] == Approx(fd.sum_wgt));
+    CHECK(SumValue[QMCCostFunctionBase::SUM_E_WGT] == Approx(fd.sum_e_wgt));
+    CHECK(SumValue[QMCCostFunctionBase::SUM_ESQ_WGT] == Approx(fd.sum_esq_wgt));
+
+    const int N = fd.numParam + 1;
+    Matrix<Return_rt> ham(N, N);
+    Matrix<Return_rt> ovlp(N, N);
+    lin.costFn.fillOverlapHamiltonianMatrices(ham, ovlp);
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < N; j++)
+      {
+        CHECK(ovlp(i, j) == Approx(fd.ovlp_gold(i, j)).margin(1e-10));
+        CHECK(ham(i, j) == Approx(fd.ham_gold(i, j)).margin(1e-10));
+      }
+  }
+}
+
+// The parameters updated while streaming should match the updates of an engine given the same samples
+TEST_CASE("streamed descent", "[drivers]")
+{
+  using Return_rt         = qmcplusplus::QMCTraits::RealType;
+  using ValueType         = qmcplusplus::QMCTraits::ValueType;
+  using FullPrecValueType = qmcplusplus::QMCTraits::FullPrecValueType;
+
+  FillData fd;
+  get_diamond_fill_data(fd);
+
+  Communicate* comm = OHMMS::Controller;
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString("<tmp> <parameter name=\"flavor\">AMSGrad</parameter> </tmp>"));
+
+  // five steps of two walkers, two updates during the steps and one for the last step
+  const int walkers_per_step = 2;
+  const int update_steps     = 2;
+
+  testing::LinearMethodTestSupport lin(1, 1, comm);
+  lin.set_samples_and_param(fd.numSamples, fd.numParam);
+  DescentEngine engine(comm, doc.getRoot());
+  const int num_updates =
+      lin.stream_descent_samples(engine, update_steps, fd.derivRecords, fd.HDerivRecords, fd.energy_new, walkers_per_step);
+  const int num_steps = fd.numSamples / walkers_per_step;
+  CHECK(num_updates == num_steps / update_steps);
+
+  // the same samples given to the engine directly, the last partial group of steps makes one more update
+  DescentEngine ref_engine(comm, doc.getRoot());
+  optimize::VariableSet ref_vars;
+  for (int j = 0; j < fd.numParam; j++)
+    ref_vars.insert("var" + std::to_string(j), 1.0);
+  std::vector<FullPrecValueType> der_rat_samp(fd.numParam + 1), le_der_samp(fd.numParam + 1);
+  for (int step = 0; step < num_steps; step += update_steps)
+  {
+    ref_engine.prepareStorage(1, fd.numParam);
+    for (int is = step * walkers_per_step; is < std::min(step + update_steps, num_steps) * walkers_per_step; is++)
+    {
+      der_rat_samp[0] = 1.0;
+      le_der_samp[0]  = fd.energy_new[is];
+      for (int j = 0; j < fd.numParam; j++)
+      {
+        der_rat_samp[j + 1] = fd.derivRecords(is, j);
+        le_der_samp[j + 1]  = fd.HDerivRecords(is, j) + fd.energy_new[is] * fd.derivRecords(is, j);
+      }
+      ref_engine.takeSample(0, der_rat_samp, le_der_samp, le_der_samp, 1.0, 1.0);
+    }
+    ref_engine.sample_finish();
+    if (step == 0)
+      ref_engine.setupUpdate(ref_vars);
+    ref_engine.storeDerivRecord();
+    ref_engine.updateParameters();
+  }
+
+  const std::vector<ValueType>& ref_params = ref_engine.retrieveNewParams();
+  for (int j = 0; j < fd.numParam; j++)
+    CHECK(std::real(lin.costFn.Params(j)) == Approx(std::real(ref_params[j])));
+}
+
+#if !defined(QMC_COMPLEX)
+// psi = c_0 phi_0 + c_1 phi_1, the energy and weight after a change of the c_i from the records at the old c_i
+TEST_CASE("linear parameter change", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+
+  const int numSamples = 4;
+  const int numParam   = 2;
+  // phi_i, the kinetic term T phi_i and the local potential at each sample
+  const Return_rt phi[numSamples][numParam]  = {{1.0, 0.5}, {0.8, -0.3}, {-0.4, 1.2}, {0.6, 0.9}};
+  const Return_rt tphi[numSamples][numParam] = {{-0.7, 0.2}, {0.3, -1.1}, {0.5, 0.4}, {-0.2, 0.6}};
+  const Return_rt vloc[numSamples]           = {-1.5, -0.9, -2.1, -1.2};
+  const std::vector<Return_rt> ref_params{1.0, 0.5};
+  const std::vector<Return_rt> new_params{1.2, 0.3};
+
+  Communicate* comm = OHMMS::Controller;
+  for (int num_opt_crowds = 1; num_opt_crowds < 3; num_opt_crowds++)
+  {
+    testing::LinearMethodTestSupport lin(num_opt_crowds, 1, comm);
+    lin.set_samples_and_param(numSamples, numParam);
+    lin.set_linear_params(ref_params, new_params);
+
+    Matrix<Return_rt>& records = lin.getRecordsOnNode();
+    for (int is = 0; is < numSamples; is++)
+    {
+      const Return_rt psi  = ref_params[0] * phi[is][0] + ref_params[1] * phi[is][1];
+      const Return_rt tpsi = ref_params[0] * tphi[is][0] + ref_params[1] * tphi[is][1];
+      const Return_rt e_kin = tpsi / psi;
+      for (int j = 0; j < numParam; j++)
+      {
+        lin.getDerivRecords()(is, j)  = phi[is][j] / psi;
+        lin.getHDerivRecords()(is, j) = tphi[is][j] / psi - e_kin * phi[is][j] / psi;
+      }
+      records(is, QMCCostFunctionBase::ENERGY_FIXED) = vloc[is];
+      records(is, QMCCostFunctionBase::ENERGY_TOT)   = vloc[is] + e_kin;
+    }
+
+    std::vector<Return_rt> delta;
+    REQUIRE(lin.getLinearParameterChange(delta));
+    Return_rt wgt_sum(0), wgt2_sum(0);
+    lin.evaluateLinearParameterChange(delta, wgt_sum, wgt2_sum);
+
+    Return_rt wgt_gold(0), wgt2_gold(0);
+    for (int is = 0; is < numSamples; is++)
+    {
+      const Return_rt psi      = ref_params[0] * phi[is][0] + ref_params[1] * phi[is][1];
+      const Return_rt psi_new  = new_params[0] * phi[is][0] + new_params[1] * phi[is][1];
+      const Return_rt tpsi_new = new_params[0] * tphi[is][0] + new_params[1] * tphi[is][1];
+      const Return_rt weight   = 2.0 * std::log(std::abs(psi_new / psi));
+      CHECK(records(is, QMCCostFunctionBase::ENERGY_NEW) == Approx(vloc[is] + tpsi_new / psi_new));
+      CHECK(records(is, QMCCostFunctionBase::REWEIGHT) == Approx(weight));
+      wgt_gold += weight / numSamples;
+      wgt2_gold += weight * weight / numSamples;
+    }
+    CHECK(wgt_sum == Approx(wgt_gold));
+    CHECK(wgt2_sum == Approx(wgt2_gold));
+  }
+}
+#endif
+
 } // namespace qmcplusplus
@@ -147,4 +147,64 @@ TEST_CASE("QMCDriverFactory create DMCBatched driver", "[qmcapp]")
   REQUIRE(qmc_driver != nullptr);
 }
 
+TEST_CASE("QMCDriverFactory create RMCBatched driver", "[qmcapp]")
+{
+  using namespace testing;
+  Communicate* comm;
+  comm = OHMMS::Controller;
+
+  ProjectData test_project;
+  QMCDriverFactory driver_factory(test_project);
+
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(valid_rmc_input_sections[valid_rmc_input_rmc_batch_index]);
+  REQUIRE(okay);
+  xmlNodePtr node                           = doc.getRoot();
+  QMCDriverFactory::DriverAssemblyState das = driver_factory.readSection(node);
+  REQUIRE(das.new_run_type == QMCRunType::RMC_BATCH);
+
+  auto particle_pool     = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool = MinimalWaveFunctionPool::make_diamondC_1x1x1(comm, particle_pool);
+  wavefunction_pool.setPrimary(wavefunction_pool.getWaveFunction("psi0"));
+  auto hamiltonian_pool = MinimalHamiltonianPool::make_hamWithEE(comm, particle_pool, wavefunction_pool);
+  std::string target("e");
+  MCWalkerConfiguration* qmc_system = particle_pool.getWalkerSet(target);
+
+  std::unique_ptr<QMCDriverInterface> qmc_driver;
+  qmc_driver =
+      driver_factory.createQMCDriver(node, das, *qmc_system, particle_pool, wavefunction_pool, hamiltonian_pool, comm);
+  REQUIRE(qmc_driver != nullptr);
+}
+
+TEST_CASE("QMCDriverFactory create CSVMCBatched driver", "[qmcapp]")
+{
+  using namespace testing;
+  Communicate* comm;
+  comm = OHMMS::Controller;
+
+  ProjectData test_project;
+  QMCDriverFactory driver_factory(test_project);
+
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(valid_csvmc_input_sections[valid_csvmc_input_csvmc_batch_index]);
+  REQUIRE(okay);
+  xmlNodePtr node                           = doc.getRoot();
+  QMCDriverFactory::DriverAssemblyState das = driver_factory.readSection(node);
+  REQUIRE(das.new_run_type == QMCRunType::CSVMC_BATCH);
+  REQUIRE(das.what_to_do[MULTIPLE_MODE]);
+
+  auto particle_pool     = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool = MinimalWaveFunctionPool::make_diamondC_1x1x1(comm, particle_pool);
+  wavefunction_pool.setPrimary(wavefunction_pool.getWaveFunction("psi0"));
+  auto hamiltonian_pool = MinimalHamiltonianPool::make_hamWithEE(comm, particle_pool, wavefunction_pool);
+  std::string target("e");
+  MCWalkerConfiguration* qmc_system = particle_pool.getWalkerSet(target);
+
+  std::unique_ptr<QMCDriverInterface> qmc_driver;
+  qmc_driver =
+      driver_factory.createQMCDriver(node, das, *qmc_system, particle_pool, wavefunction_pool, hamiltonian_pool, comm);
+  REQUIRE(qmc_driver != nullptr);
+  CHECK(qmc_driver->getRunType() == QMCRunType::CSVMC_BATCH);
+}
+
 } // namespace qmcplusplus
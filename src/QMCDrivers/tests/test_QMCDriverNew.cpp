@@ -22,6 +22,11 @@
 #include "QMCDrivers/MCPopulation.h"
 #include "Concurrency/Info.hpp"
 #include "Concurrency/UtilityFunctions.hpp"
+#include "QMCDrivers/Crowd.h"
+#include "QMCDrivers/ContextForSteps.h"
+#include "QMCDrivers/GreenFunctionModifiers/DriftModifierUNR.h"
+#include "Estimators/EstimatorManagerNew.h"
+#include "ParticleBase/RandomSeqGenerator.h"
 
 namespace qmcplusplus
 {
@@ -70,6 +75,107 @@ TEST_CASE("QMCDriverNew tiny case", "[drivers]")
   // What else should we expect after process
 }
 
+TEST_CASE("QMCDriverNew moveAllElectrons sub-steps", "[drivers]")
+{
+  using namespace testing;
+  using MCPWalker = QMCDriverNew::MCPWalker;
+  using RealType  = QMCTraits::RealType;
+  using PosType   = QMCTraits::PosType;
+  using WP        = WalkerProperties::Indexes;
+  Communicate* comm;
+  comm = OHMMS::Controller;
+
+  auto particle_pool     = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool = MinimalWaveFunctionPool::make_diamondC_1x1x1(comm, particle_pool);
+  wavefunction_pool.setPrimary(wavefunction_pool.getWaveFunction("psi0"));
+  auto hamiltonian_pool = MinimalHamiltonianPool::make_hamWithEE(comm, particle_pool, wavefunction_pool);
+
+  const int num_walkers = 2;
+  const int sub_steps   = 3;
+  const RealType tau    = 0.5;
+  EstimatorManagerNew em(comm);
+  DriverWalkerResourceCollection driverwalker_resource_collection;
+  const MultiWalkerDispatchers dispatchers(false);
+  Crowd crowd(em, driverwalker_resource_collection, dispatchers);
+
+  ParticleSet& elecs_primary = *particle_pool.getParticleSet("e");
+  const int num_particles    = elecs_primary.getTotalNum();
+  UPtrVector<MCPWalker> walkers;
+  UPtrVector<ParticleSet> psets;
+  UPtrVector<TrialWaveFunction> twfs;
+  UPtrVector<QMCHamiltonian> hams;
+  // reference copies moved by hand
+  UPtrVector<ParticleSet> ref_psets;
+  UPtrVector<TrialWaveFunction> ref_twfs;
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    psets.emplace_back(std::make_unique<ParticleSet>(elecs_primary));
+    psets.back()->update();
+    twfs.emplace_back(wavefunction_pool.getPrimary()->makeClone(*psets.back()));
+    twfs.back()->evaluateLog(*psets.back());
+    hams.emplace_back(hamiltonian_pool.getPrimary()->makeClone(*psets.back(), *twfs.back()));
+    walkers.emplace_back(std::make_unique<MCPWalker>(num_particles));
+    // the properties are those left by the previous step
+    walkers.back()->resetProperty(twfs.back()->getLogPsi(), twfs.back()->getPhase(), 0.0);
+    crowd.addWalker(*walkers.back(), *psets.back(), *twfs.back(), *hams.back());
+
+    ref_psets.emplace_back(std::make_unique<ParticleSet>(elecs_primary));
+    ref_twfs.emplace_back(wavefunction_pool.getPrimary()->makeClone(*ref_psets.back()));
+  }
+
+  RandomGenerator rng(13);
+  RandomGenerator rng_ref(rng);
+  ContextForSteps step_context(num_walkers, num_particles, {{0, 4}, {4, 8}}, rng);
+  DriftModifierUNR drift_modifier;
+  std::vector<RealType> inv_mass{1.0, 1.0};
+  std::vector<RealType> rr_proposed(num_walkers, 0.0);
+  std::vector<RealType> rr_accepted(num_walkers, 0.0);
+  QMCDriverNewTestWrapper::moveAllElectrons(crowd, step_context, drift_modifier, inv_mass, tau, false, nullptr,
+                                            sub_steps, rr_proposed, rr_accepted);
+
+  // without drift the acceptance of each sub-step is |Psi(R')/Psi(R)|^2 with R the configuration left by the
+  // previous sub-step, not the one of the walker properties
+  std::vector<ParticleSet::ParticlePos> positions;
+  std::vector<RealType> log_psi;
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    positions.push_back(elecs_primary.R);
+    log_psi.push_back(walkers[iw]->Properties(WP::LOGPSI));
+  }
+  std::vector<PosType> deltas(num_walkers * num_particles);
+  unsigned long num_accept = 0;
+  for (int sub_step = 0; sub_step < sub_steps; ++sub_step)
+  {
+    makeGaussRandomWithEngine(deltas, rng_ref);
+    for (int iw = 0; iw < num_walkers; ++iw)
+    {
+      ParticleSet& ref_elecs = *ref_psets[iw];
+      for (int iat = 0; iat < num_particles; ++iat)
+        ref_elecs.R[iat] = positions[iw][iat] + std::sqrt(tau) * deltas[iat * num_walkers + iw];
+      ref_elecs.update();
+      ref_twfs[iw]->evaluateLog(ref_elecs);
+      const RealType new_log_psi = ref_twfs[iw]->getLogPsi();
+      const RealType prob        = std::exp(2.0 * (new_log_psi - log_psi[iw]));
+      if (rng_ref() < prob)
+      {
+        ++num_accept;
+        positions[iw] = ref_elecs.R;
+        log_psi[iw]   = new_log_psi;
+      }
+    }
+  }
+
+  CHECK(crowd.get_accept() == num_accept);
+  CHECK(crowd.get_reject() == num_walkers * sub_steps - num_accept);
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    CHECK(twfs[iw]->getLogPsi() == Approx(log_psi[iw]));
+    for (int iat = 0; iat < num_particles; ++iat)
+      for (int idim = 0; idim < 3; ++idim)
+        CHECK(psets[iw]->R[iat][idim] == Approx(positions[iw][iat][idim]));
+  }
+}
+
 #ifdef _OPENMP
 TEST_CASE("QMCDriverNew more crowds than threads", "[drivers]")
 {
@@ -152,6 +258,8 @@ TEST_CASE("QMCDriverNew walker counts", "[drivers]")
                                       samples, comm);
 
   qmc_batched.testAdjustGlobalWalkerCount();
+  qmc_batched.testThreadsPerCrowd();
+  qmc_batched.testAssignCrowdDevices();
 }
 #endif
 
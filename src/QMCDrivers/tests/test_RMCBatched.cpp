@@ -0,0 +1,237 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "QMCDrivers/RMC/ReptileBeads.h"
+#include "QMCDrivers/RMC/RMCDriverInput.h"
+#include "QMCDrivers/RMC/RMCBatched.h"
+#include "QMCDrivers/SFNBranch.h"
+#include "QMCDrivers/tests/ValidQMCInputSections.h"
+#include "QMCDrivers/GreenFunctionModifiers/DriftModifierUNR.h"
+#include "Particle/tests/MinimalParticlePool.h"
+#include "QMCWaveFunctions/tests/MinimalWaveFunctionPool.h"
+#include "QMCHamiltonians/tests/MinimalHamiltonianPool.h"
+#include "Estimators/EstimatorManagerNew.h"
+#include "ParticleBase/RandomSeqGenerator.h"
+#include "OhmmsData/Libxml2Doc.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("RMCDriverInput readXML", "[drivers]")
+{
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(testing::valid_rmc_input_sections[testing::valid_rmc_input_rmc_batch_index]);
+  REQUIRE(okay);
+  xmlNodePtr node = doc.getRoot();
+  RMCDriverInput rmcdriver_input;
+  rmcdriver_input.readXML(node);
+  CHECK(rmcdriver_input.get_beads() == 8);
+  CHECK(rmcdriver_input.get_beta() < 0);
+  CHECK(rmcdriver_input.get_vmc_presteps() == 4);
+  CHECK(rmcdriver_input.get_max_age() == 20);
+  CHECK(rmcdriver_input.get_use_sym_action());
+}
+
+TEST_CASE("ReptileBeads grow and bounce", "[drivers]")
+{
+  ReptileBeads::Bead seed;
+  seed.local_energy = 0;
+  ReptileBeads reptile(4, seed, -1.0);
+  REQUIRE(reptile.size() == 4);
+
+  // label the beads head to tail
+  for (int i = 0; i < reptile.size(); i++)
+    reptile[i].local_energy = i;
+
+  auto& new_head        = reptile.growHead();
+  new_head.local_energy = -1;
+  reptile.logGTowardTail(0) = -2.0;
+  reptile.logGTowardHead(0) = -3.0;
+  // the old tail was dropped
+  CHECK(reptile.getHead().local_energy == Approx(-1));
+  CHECK(reptile[1].local_energy == Approx(0));
+  CHECK(reptile.getTail().local_energy == Approx(2));
+  CHECK(reptile.logGTowardTail(1) == Approx(-1.0));
+
+  reptile.flip();
+  CHECK(reptile.getAge() == 1);
+  CHECK(reptile.getHead().local_energy == Approx(2));
+  CHECK(reptile.getNext().local_energy == Approx(0));
+  CHECK(reptile.getTail().local_energy == Approx(-1));
+  // the link keeps its direction after the bounce
+  CHECK(reptile.logGTowardTail(2) == Approx(-3.0));
+  CHECK(reptile.logGTowardHead(2) == Approx(-2.0));
+
+  reptile.growHead().local_energy = 3;
+  CHECK(reptile.getAge() == 0);
+  CHECK(reptile.getHead().local_energy == Approx(3));
+  CHECK(reptile.getTail().local_energy == Approx(0));
+  CHECK(reptile.logGTowardTail(2) == Approx(-1.0));
+}
+
+namespace testing
+{
+/// exposes the driver timers taken by advanceReptiles
+class RMCBatchedTest : public RMCBatched
+{
+public:
+  using RMCBatched::DriverTimers;
+};
+} // namespace testing
+
+TEST_CASE("RMCBatched advanceReptiles link action", "[drivers]")
+{
+  using namespace testing;
+  using MCPWalker = RMCBatched::MCPWalker;
+  using RealType  = QMCTraits::RealType;
+  using PosType   = QMCTraits::PosType;
+  using WP        = WalkerProperties::Indexes;
+  Communicate* comm;
+  comm = OHMMS::Controller;
+  outputManager.pause();
+
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(valid_rmc_input_sections[valid_rmc_input_rmc_batch_index]);
+  REQUIRE(okay);
+  xmlNodePtr node = doc.getRoot();
+  QMCDriverInput qmcdriver_input;
+  qmcdriver_input.readXML(node);
+  RMCDriverInput rmcdriver_input;
+  rmcdriver_input.readXML(node);
+  REQUIRE(rmcdriver_input.get_use_sym_action());
+
+  auto particle_pool     = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool = MinimalWaveFunctionPool::make_diamondC_1x1x1(comm, particle_pool);
+  wavefunction_pool.setPrimary(wavefunction_pool.getWaveFunction("psi0"));
+  auto hamiltonian_pool = MinimalHamiltonianPool::make_hamWithEE(comm, particle_pool, wavefunction_pool);
+  WalkerConfigurations walker_confs;
+  MCPopulation population(1, comm->rank(), walker_confs, particle_pool.getParticleSet("e"),
+                          wavefunction_pool.getPrimary(), wavefunction_pool.getWaveFunctionFactory("wavefunction"),
+                          hamiltonian_pool.getPrimary());
+
+  const int num_walkers = 2;
+  const RealType tau    = qmcdriver_input.get_tau();
+  EstimatorManagerNew em(comm);
+  DriverWalkerResourceCollection driverwalker_resource_collection;
+  const MultiWalkerDispatchers dispatchers(false);
+  Crowd crowd(em, driverwalker_resource_collection, dispatchers);
+
+  ParticleSet& elecs_primary = *particle_pool.getParticleSet("e");
+  const int num_particles    = elecs_primary.getTotalNum();
+  UPtrVector<MCPWalker> walkers;
+  UPtrVector<ParticleSet> psets;
+  UPtrVector<TrialWaveFunction> twfs;
+  UPtrVector<QMCHamiltonian> hams;
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    psets.emplace_back(std::make_unique<ParticleSet>(elecs_primary));
+    psets.back()->update();
+    twfs.emplace_back(wavefunction_pool.getPrimary()->makeClone(*psets.back()));
+    twfs.back()->evaluateLog(*psets.back());
+    hams.emplace_back(hamiltonian_pool.getPrimary()->makeClone(*psets.back(), *twfs.back()));
+    const RealType eloc = hams.back()->evaluate(*psets.back());
+    walkers.emplace_back(std::make_unique<MCPWalker>(num_particles));
+    walkers.back()->R = psets.back()->R;
+    walkers.back()->G = psets.back()->G;
+    walkers.back()->resetProperty(twfs.back()->getLogPsi(), twfs.back()->getPhase(), eloc);
+    crowd.addWalker(*walkers.back(), *psets.back(), *twfs.back(), *hams.back());
+  }
+  const ParticleSet::ParticlePos R0        = psets[0]->R;
+  const ParticleSet::ParticleGradient G0   = psets[0]->G;
+  const RealType log_psi0                  = twfs[0]->getLogPsi();
+  const QMCTraits::FullPrecRealType phase0 = twfs[0]->getPhase();
+  const RealType e0                        = walkers[0]->Properties(WP::LOCALENERGY);
+
+  // a reference energy far above the local energies switches the energy part of the link actions off,
+  // the bare 0.5 * tau * (E_new + E_old) would not
+  SFNBranch branch_engine(tau, num_walkers);
+  branch_engine.put(node);
+  branch_engine.initParam(population, e0 + 1000.0, 0.0, true, false);
+
+  DriftModifierUNR drift_modifier;
+  RMCBatched::StateForThread sft(qmcdriver_input, rmcdriver_input, drift_modifier, branch_engine, population);
+  sft.num_beads = rmcdriver_input.get_beads();
+
+  RandomGenerator rng(13);
+  RandomGenerator rng_ref(rng);
+  ContextForSteps step_context(num_walkers, num_particles, {{0, 4}, {4, 8}}, rng);
+  UPtrVector<ReptileBeads> reptiles;
+  RMCBatched::initReptiles(sft, crowd, step_context, reptiles);
+  REQUIRE(reptiles.size() == num_walkers);
+
+  RMCBatchedTest::DriverTimers timers("RMCBatchedTest::");
+  RMCBatched::advanceReptiles(sft, crowd, reptiles, timers, step_context, false);
+
+  // every bead of the fresh reptiles is the walker configuration, the tail links are the bead to itself
+  auto drift_at = [&](const ParticleSet::ParticleGradient& G) {
+    ParticleSet::ParticlePos drift(num_particles);
+    for (int iat = 0; iat < num_particles; ++iat)
+      drift_modifier.getDrift(tau, G[iat], drift[iat]);
+    return drift;
+  };
+  const ParticleSet::ParticlePos drift0 = drift_at(G0);
+  ParticleSet ref_elecs(elecs_primary);
+  UPtr<TrialWaveFunction> ref_twf(wavefunction_pool.getPrimary()->makeClone(ref_elecs));
+  std::vector<PosType> deltas(num_walkers * num_particles);
+  makeGaussRandomWithEngine(deltas, rng_ref);
+  unsigned long num_accept = 0;
+  for (int iw = 0; iw < num_walkers; ++iw)
+  {
+    RealType log_gf = 0;
+    for (int iat = 0; iat < num_particles; ++iat)
+    {
+      const PosType& delta = deltas[iat * num_walkers + iw];
+      ref_elecs.R[iat]     = R0[iat] + drift0[iat] + std::sqrt(tau) * delta;
+      log_gf -= 0.5 * dot(delta, delta);
+    }
+    ref_elecs.update();
+    ref_twf->evaluateLog(ref_elecs);
+    const ParticleSet::ParticlePos drift1 = drift_at(ref_elecs.G);
+    RealType log_gb                       = 0;
+    for (int iat = 0; iat < num_particles; ++iat)
+    {
+      const PosType dr = R0[iat] - ref_elecs.R[iat] - drift1[iat];
+      log_gb -= 0.5 / tau * dot(dr, dr);
+    }
+    // the drift actions of the old tail link cancel its forward Green's function,
+    // with the energy actions filtered out only the head link and the wavefunction ratio are left
+    const RealType log_accept = 0.5 * (log_gb - log_gf) + ref_twf->getLogPsi() - log_psi0;
+    const bool accepted       = std::cos(ref_twf->getPhase() - phase0) >= std::numeric_limits<RealType>::epsilon() &&
+        rng_ref() < std::exp(log_accept);
+
+    ReptileBeads& reptile = *reptiles[iw];
+    if (accepted)
+    {
+      ++num_accept;
+      CHECK(reptile.getAge() == 0);
+      CHECK(reptile.getHead().log_psi == Approx(ref_twf->getLogPsi()));
+      for (int iat = 0; iat < num_particles; ++iat)
+        for (int idim = 0; idim < 3; ++idim)
+          CHECK(reptile.getHead().R[iat][idim] == Approx(ref_elecs.R[iat][idim]));
+    }
+    else
+    {
+      // bounced, the old tail is the new head
+      CHECK(reptile.getAge() == 1);
+      CHECK(reptile.getHead().log_psi == Approx(log_psi0));
+      for (int iat = 0; iat < num_particles; ++iat)
+        for (int idim = 0; idim < 3; ++idim)
+          CHECK(reptile.getHead().R[iat][idim] == Approx(R0[iat][idim]));
+    }
+  }
+  CHECK(crowd.get_accept() == num_accept);
+  CHECK(crowd.get_reject() == num_walkers - num_accept);
+  outputManager.resume();
+}
+
+} // namespace qmcplusplus
@@ -100,5 +100,20 @@ TEST_CASE("SFNBranch::branch(MCPopulation...)", "[drivers]")
                  *pools.hamiltonian_pool->getPrimary());
 }
 
+TEST_CASE("SFNBranch::resetTimeStep", "[drivers]")
+{
+  using namespace testing;
+  SetupPools pools;
+  SetupSFNBranch setup_sfnb(pools.comm);
+  std::unique_ptr<SFNBranch> sfnb =
+      setup_sfnb(*pools.particle_pool->getParticleSet("e"), *pools.wavefunction_pool->getPrimary(),
+                 *pools.wavefunction_pool->getWaveFunctionFactory("wavefunction"),
+                 *pools.hamiltonian_pool->getPrimary());
+  sfnb->resetTimeStep(0.25, 3);
+  CHECK(sfnb->getTau() == Approx(0.25));
+  CHECK(sfnb->getTauEff() == Approx(0.25));
+  CHECK(sfnb->getWarmupToDoSteps() == 3);
+}
+
 
 } // namespace qmcplusplus
@@ -11,6 +11,7 @@
 
 
 #include <functional>
+#include <numeric>
 #include "catch.hpp"
 
 #include "test_WalkerControl.h"
@@ -97,6 +98,21 @@ void UnifiedDriverWalkerControlMPITest::testNewDistribution(std::vector<int>& mi
   WalkerControl::determineNewWalkerPopulation(num_per_rank, fair_offset, minus, plus);
 }
 
+void UnifiedDriverWalkerControlMPITest::testNodeFirstDistribution(std::vector<int>& minus, std::vector<int>& plus)
+{
+  std::vector<int> num_per_rank = {3, 3, 1, 1};
+  std::vector<int> node_of_rank = {0, 1, 1, 0};
+  std::vector<int> fair_offset;
+  WalkerControl::determineNewWalkerPopulation(num_per_rank, fair_offset, minus, plus, node_of_rank);
+}
+
+void UnifiedDriverWalkerControlMPITest::testCombWalkers(const std::vector<QMCTraits::FullPrecRealType>& weights,
+                                                        std::vector<int>& multiplicities,
+                                                        QMCTraits::FullPrecRealType zeta)
+{
+  WalkerControl::combWalkersOnRank(weights, multiplicities, zeta);
+}
+
 } // namespace testing
 
 TEST_CASE("WalkerControl::determineNewWalkerPopulation", "[drivers][walker_control]")
@@ -109,6 +125,31 @@ TEST_CASE("WalkerControl::determineNewWalkerPopulation", "[drivers][walker_contr
   CHECK(plus.size() == 2);
 }
 
+TEST_CASE("WalkerControl::determineNewWalkerPopulation node first", "[drivers][walker_control]")
+{
+  std::vector<int> minus;
+  std::vector<int> plus;
+
+  testing::UnifiedDriverWalkerControlMPITest::testNodeFirstDistribution(minus, plus);
+  // without the nodes, rank 0 would send to rank 2 and rank 1 to rank 3
+  CHECK(plus == std::vector<int>{0, 1});
+  CHECK(minus == std::vector<int>{3, 2});
+}
+
+TEST_CASE("WalkerControl::combWalkersOnRank", "[drivers][walker_control]")
+{
+  std::vector<int> multiplicities;
+  // teeth at 0.5, 1.5, 2.5 and 3.5
+  testing::UnifiedDriverWalkerControlMPITest::testCombWalkers({0.1, 2.0, 0.9, 1.0}, multiplicities, 0.5);
+  CHECK(multiplicities == std::vector<int>{0, 2, 1, 1});
+  // dead walkers get no copy and the number of walkers is kept
+  testing::UnifiedDriverWalkerControlMPITest::testCombWalkers({0.0, 3.0, 0.0, 1.0}, multiplicities, 0.25);
+  CHECK(multiplicities == std::vector<int>{0, 3, 0, 1});
+  testing::UnifiedDriverWalkerControlMPITest::testCombWalkers({1.3, 0.7, 1.1, 0.2, 0.9}, multiplicities, 0.99);
+  CHECK(multiplicities == std::vector<int>{1, 1, 1, 0, 2});
+  CHECK(std::accumulate(multiplicities.begin(), multiplicities.end(), 0) == 5);
+}
+
 /** Here we manipulate just the Multiplicity of a set of 1 walkers per rank
  */
 // Fails in debug after PR #2855 run unit tests in debug!
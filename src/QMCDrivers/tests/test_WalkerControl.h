@@ -29,6 +29,10 @@ public:
   void testPopulationDiff(std::vector<int>& rank_counts_before, std::vector<int>& rank_counts_after);
   void makeValidWalkers();
   static void testNewDistribution(std::vector<int>& minus, std::vector<int>& plus);
+  static void testNodeFirstDistribution(std::vector<int>& minus, std::vector<int>& plus);
+  static void testCombWalkers(const std::vector<QMCTraits::FullPrecRealType>& weights,
+                              std::vector<int>& multiplicities,
+                              QMCTraits::FullPrecRealType zeta);
 
 private:
   void reportWalkersPerRank(Communicate* c, MCPopulation& pop);
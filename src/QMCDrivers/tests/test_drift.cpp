@@ -169,4 +169,22 @@ TEST_CASE("get scaled drift complex", "[drivers][drift]")
 }
 #endif
 
+TEST_CASE("get scaled spin drifts", "[drivers][drift]")
+{
+  using RealType    = DriftModifierBase::RealType;
+  using ComplexType = DriftModifierBase::ComplexType;
+  const RealType tau_over_mass = 0.5 / 0.25;
+
+  DriftModifierUNR DM;
+  std::vector<ComplexType> spingrads{ComplexType(-2.0, 0.3), ComplexType(0.1, -1.0), ComplexType(3.0, 0.0)};
+  std::vector<ParticleSet::Scalar_t> spin_drifts(spingrads.size());
+  DM.getDrifts(tau_over_mass, spingrads, spin_drifts);
+  for (int i = 0; i < spingrads.size(); i++)
+  {
+    ParticleSet::Scalar_t spin_drift;
+    DM.getDrift(tau_over_mass, spingrads[i], spin_drift);
+    CHECK(spin_drifts[i] == Approx(spin_drift));
+  }
+}
+
 } // namespace qmcplusplus
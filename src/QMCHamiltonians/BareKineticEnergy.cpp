@@ -101,29 +101,65 @@ Return_t BareKineticEnergy::evaluate(ParticleSet& P)
   }
   else
 #endif
-      if (SameMass)
   {
-//app_log() << "Here" << std::endl;
+    value_ = evaluateFromGL(P);
+  }
+  return value_;
+}
+
+void BareKineticEnergy::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                                    const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                    const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  // per particle traces are collected by the single walker evaluation
+  if (streaming_particles_)
+  {
+    OperatorBase::mw_evaluate(o_list, wf_list, p_list);
+    return;
+  }
+
+  const auto& O_leader = o_list.getCastedLeader<BareKineticEnergy>();
+  const size_t nw      = o_list.size();
+#pragma omp parallel for
+  for (size_t iw = 0; iw < nw; iw++)
+    o_list.getCastedElement<BareKineticEnergy>(iw).value_ = O_leader.evaluateFromGL(p_list[iw]);
+}
+
+Return_t BareKineticEnergy::evaluateFromGL(const ParticleSet& P) const
+{
+  Return_t value;
+  if (SameMass)
+  {
 #ifdef QMC_COMPLEX
-    value_ = std::real(CplxDot(P.G, P.G) + CplxSum(P.L));
-    value_ *= -OneOver2M;
+    value = std::real(CplxDot(P.G, P.G) + CplxSum(P.L));
+    value *= -OneOver2M;
 #else
-    value_ = Dot(P.G, P.G) + Sum(P.L);
-    value_ *= -OneOver2M;
+    value = Dot(P.G, P.G) + Sum(P.L);
+    value *= -OneOver2M;
 #endif
   }
   else
   {
-    value_ = 0.0;
+    value = 0.0;
     for (int i = 0; i < MinusOver2M.size(); ++i)
     {
       Return_t x = 0.0;
       for (int j = P.first(i); j < P.last(i); ++j)
         x += laplacian(P.G[j], P.L[j]);
-      value_ += x * MinusOver2M[i];
+      value += x * MinusOver2M[i];
     }
   }
-  return value_;
+  return value;
+}
+
+bool BareKineticEnergy::evaluatePerParticle(ParticleSet& P,
+                                            const std::string& static_name,
+                                            Vector<Return_t>& e_dynamic,
+                                            Vector<Return_t>& e_static)
+{
+  for (int i = 0; i < P.getTotalNum(); ++i)
+    e_dynamic[i] += MinusOver2M[P.GroupID[i]] * laplacian(P.G[i], P.L[i]);
+  return true;
 }
 
 /**@brief Function to compute the value, direct ionic gradient terms, and pulay terms for the local kinetic energy.
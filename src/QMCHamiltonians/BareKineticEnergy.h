@@ -84,6 +84,19 @@ public:
 
   Return_t evaluate(ParticleSet& P) override;
 
+  /** evaluate the kinetic energy of a crowd in one pass over the gradients and laplacians of the walkers
+   */
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
+  /** kinetic energy of each particle from the gradients and laplacians of the last evaluation
+   */
+  bool evaluatePerParticle(ParticleSet& P,
+                           const std::string& static_name,
+                           Vector<Return_t>& e_dynamic,
+                           Vector<Return_t>& e_static) override;
+
   /**@brief Function to compute the value, direct ionic gradient terms, and pulay terms for the local kinetic energy.
  *  
  *  This general function represents the OperatorBase interface for computing.  For an operator \hat{O}, this
@@ -130,6 +143,10 @@ public:
   // Nothing is done on GPU here, just copy into vector
   void addEnergy(MCWalkerConfiguration& W, std::vector<RealType>& LocalEnergy) override;
 #endif
+
+private:
+  /// kinetic energy from P.G and P.L
+  Return_t evaluateFromGL(const ParticleSet& P) const;
 };
 
 } // namespace qmcplusplus
@@ -18,6 +18,7 @@
 #include "CoulombPBCAA.h"
 #include "Particle/DistanceTable.h"
 #include "Utilities/ProgressReportEngine.h"
+#include "CPU/BLAS.hpp"
 #include <numeric>
 
 namespace qmcplusplus
@@ -29,7 +30,10 @@ CoulombPBCAA::CoulombPBCAA(ParticleSet& ref, bool active, bool computeForces)
       myConst(0.0),
       ComputeForces(computeForces),
       Ps(ref),
-      d_aa_ID(ref.addTable(ref)),
+      incremental_sr_(false),
+      num_sr_updates_(0),
+      sr_value_(0.0),
+      d_aa_ID(ref.addTable(ref, active ? DTModes::ALL_OFF : DTModes::LAZY_FULL_TABLE)),
       evalLR_timer_(*timer_manager.createTimer("CoulombPBCAA::LongRange", timer_level_fine)),
       evalSR_timer_(*timer_manager.createTimer("CoulombPBCAA::ShortRange", timer_level_fine))
 
@@ -169,11 +173,94 @@ CoulombPBCAA::Return_t CoulombPBCAA::evaluate(ParticleSet& P)
       value_ = evaluate_sp(P);
     else
 #endif
-      value_ = evalLR(P) + evalSR(P) + myConst;
+      value_ = evalLR(P) + (incremental_sr_ ? evalSRIncremental(P) : evalSR(P)) + myConst;
   }
   return value_;
 }
 
+void CoulombPBCAA::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                               const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                               const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  assert(this == &o_list.getLeader());
+  if (!is_active)
+    return;
+#if !defined(REMOVE_TRACEMANAGER)
+  const bool use_single_walker = streaming_particles_;
+#else
+  const bool use_single_walker = false;
+#endif
+  if (use_single_walker || p_list.getLeader().getSK().SuperCellEnum == SUPERCELL_SLAB)
+  {
+    OperatorBase::mw_evaluate(o_list, wf_list, p_list);
+    return;
+  }
+
+  std::vector<mRealType> v_lr(o_list.size());
+  mw_evalLR(p_list, v_lr);
+
+#pragma omp parallel for
+  for (int iw = 0; iw < o_list.size(); iw++)
+  {
+    auto& caa  = o_list.getCastedElement<CoulombPBCAA>(iw);
+    caa.value_ = v_lr[iw] + (incremental_sr_ ? caa.evalSRIncremental(p_list[iw]) : caa.evalSR(p_list[iw])) + myConst;
+  }
+}
+
+bool CoulombPBCAA::evaluatePerParticle(ParticleSet& P,
+                                       const std::string& static_name,
+                                       Vector<Return_t>& e_dynamic,
+                                       Vector<Return_t>& e_static)
+{
+  if (!is_active && Ps.getName() != static_name)
+    return true;
+  ParticleSet& Pa(is_active ? P : Ps);
+  Vector<Return_t>& e(is_active ? e_dynamic : e_static);
+  const StructFact& PtclRhoK(Pa.getSK());
+  if (PtclRhoK.SuperCellEnum == SUPERCELL_SLAB)
+    throw std::runtime_error("CoulombPBCAA::evaluatePerParticle is not implemented for slab geometry");
+
+  //SR
+  const auto& d_aa(Pa.getDistTableAA(d_aa_ID));
+  for (int ipart = 1; ipart < NumCenters; ipart++)
+  {
+    const mRealType z = .5 * Zat[ipart];
+    const auto& dist  = d_aa.getDistRow(ipart);
+    for (int jpart = 0; jpart < ipart; ++jpart)
+    {
+      const mRealType pairpot = z * Zat[jpart] * rVs->splint(dist[jpart]) / dist[jpart];
+      e[ipart] += pairpot;
+      e[jpart] += pairpot;
+    }
+  }
+
+  //LR
+  const auto& kLists = Pa.getSimulationCell().getKLists();
+  Vector<mRealType> fk;
+  AA->getFkPerVector(kLists.kshell, fk);
+  for (int i = 0; i < NumCenters; i++)
+  {
+    mRealType v1 = 0.0;
+    for (int s = 0; s < NumSpecies; ++s)
+#if defined(USE_REAL_STRUCT_FACTOR)
+      v1 += Zspec[s] * LRHandlerType::evaluateAt(kLists.kpts_cart, fk, PtclRhoK.rhok_r[s], PtclRhoK.rhok_i[s], Pa.R[i]);
+#else
+      v1 += Zspec[s] * LRHandlerType::evaluateAt(kLists.kpts_cart, fk, PtclRhoK.rhok[s], Pa.R[i]);
+#endif
+    e[i] += .5 * Zat[i] * v1;
+  }
+
+  //constants, see evalConsts
+  const mRealType vl_r0 = AA->evaluateLR_r0();
+  const mRealType vs_k0 = AA->evaluateSR_k0();
+  mRealType total_charge = 0.0;
+  for (int spec = 0; spec < NumSpecies; spec++)
+    total_charge += NofSpecies[spec] * Zspec[spec];
+  for (int i = 0; i < NumCenters; i++)
+    e[i] += -.5 * Zat[i] * (Zat[i] * vl_r0 + total_charge * vs_k0);
+  return true;
+}
+
 CoulombPBCAA::Return_t CoulombPBCAA::evaluateWithIonDerivs(ParticleSet& P,
                                                            ParticleSet& ions,
                                                            TrialWaveFunction& psi,
@@ -466,6 +553,82 @@ CoulombPBCAA::Return_t CoulombPBCAA::evalSR(ParticleSet& P)
   return SR;
 }
 
+bool CoulombPBCAA::enableIncrementalSR()
+{
+  incremental_sr_ = is_active && !ComputeForces && Ps.getLattice().SuperCellEnum == SUPERCELL_BULK;
+  return incremental_sr_;
+}
+
+CoulombPBCAA::Return_t CoulombPBCAA::evalSRIncremental(ParticleSet& P)
+{
+  sr_moved_.clear();
+  if (sr_positions_.size() == NumCenters)
+  {
+    sr_is_moved_.assign(NumCenters, 0);
+    for (int iat = 0; iat < NumCenters; iat++)
+      if (!(P.R[iat] == sr_positions_[iat]))
+      {
+        sr_moved_.push_back(iat);
+        sr_is_moved_[iat] = 1;
+      }
+  }
+
+  // updating a particle costs about four times its share of the full evaluation
+  if (sr_positions_.size() != NumCenters || num_sr_updates_ >= SRRecomputePeriod || sr_moved_.size() * 4 > NumCenters)
+  {
+    sr_value_       = evalSR(P);
+    num_sr_updates_ = 0;
+  }
+  else if (!sr_moved_.empty())
+  {
+    ScopedTimer local_timer(evalSR_timer_);
+    sr_value_ += evalSRChange(P);
+    num_sr_updates_++;
+  }
+  sr_positions_.assign(P.R.begin(), P.R.end());
+  return sr_value_;
+}
+
+CoulombPBCAA::mRealType CoulombPBCAA::evalSRChange(const ParticleSet& P) const
+{
+  const auto& d_aa(P.getDistTableAA(d_aa_ID));
+  const auto& lattice = P.getLattice();
+  // old distances in the minimum image convention, neighboring images are searched for skewed cells
+  auto old_distance = [&lattice](const PosType& ri, const PosType& rj) {
+    PosType dr = rj - ri;
+    lattice.applyMinimumImage(dr);
+    RealType r2 = dot(dr, dr);
+    if (!lattice.DiagonalOnly)
+      for (int i = -1; i <= 1; i++)
+        for (int j = -1; j <= 1; j++)
+          for (int k = -1; k <= 1; k++)
+          {
+            const PosType image = dr + i * lattice.a(0) + j * lattice.a(1) + k * lattice.a(2);
+            r2                  = std::min(r2, dot(image, image));
+          }
+    return std::sqrt(r2);
+  };
+
+  mRealType delta = 0.0;
+  for (const int iat : sr_moved_)
+  {
+    const auto& dist = d_aa.getDistRow(iat);
+    mRealType esum   = 0.0;
+    for (int jat = 0; jat < NumCenters; jat++)
+    {
+      // a pair of moved particles is visited once from the larger index
+      if (jat == iat || (jat > iat && sr_is_moved_[jat]))
+        continue;
+      // only the lower triangle of the distance table is up to date
+      const RealType r_new = jat < iat ? dist[jat] : d_aa.getDistRow(jat)[iat];
+      const RealType r_old = old_distance(sr_positions_[iat], sr_positions_[jat]);
+      esum += Zat[jat] * (rVs->splint(r_new) / r_new - rVs->splint(r_old) / r_old);
+    }
+    delta += Zat[iat] * esum;
+  }
+  return delta;
+}
+
 CoulombPBCAA::Return_t CoulombPBCAA::evalLR(ParticleSet& P)
 {
   ScopedTimer local_timer(evalLR_timer_);
@@ -511,6 +674,33 @@ CoulombPBCAA::Return_t CoulombPBCAA::evalLR(ParticleSet& P)
   return res;
 }
 
+void CoulombPBCAA::mw_evalLR(const RefVectorWithLeader<ParticleSet>& p_list, std::vector<mRealType>& v_lr) const
+{
+  ScopedTimer local_timer(evalLR_timer_);
+  const int nw = p_list.size();
+  // F_k of every k vector, repeated for the real and the imaginary parts
+  Vector<mRealType> fk;
+  AA->getFkPerVector(p_list.getLeader().getSimulationCell().getKLists().kshell, fk);
+  const int nk = fk.size();
+  Vector<mRealType> fk2(2 * nk);
+  std::copy_n(fk.data(), nk, fk2.data());
+  std::copy_n(fk.data(), nk, fk2.data() + nk);
+
+  // squared real and imaginary parts of sum_s Z_s rho^s_k, one row per walker
+  Matrix<mRealType> rhok2(nw, 2 * nk);
+#pragma omp parallel for
+  for (int iw = 0; iw < nw; iw++)
+  {
+    mRealType* restrict rk = rhok2[iw];
+    p_list[iw].getSK().getChargeWeightedRhok(Zspec, nk, rk, rk + nk);
+    for (int ki = 0; ki < 2 * nk; ki++)
+      rk[ki] *= rk[ki];
+  }
+
+  // 1/2 sum_k F_k |rho_k|^2 of all the walkers as a single matrix-vector product
+  BLAS::gemv('T', 2 * nk, nw, mRealType(0.5), rhok2.data(), 2 * nk, fk2.data(), 1, mRealType(0), v_lr.data(), 1);
+}
+
 std::unique_ptr<OperatorBase> CoulombPBCAA::makeClone(ParticleSet& qp, TrialWaveFunction& psi)
 {
   return std::make_unique<CoulombPBCAA>(*this);
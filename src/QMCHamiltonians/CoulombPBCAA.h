@@ -84,6 +84,24 @@ struct CoulombPBCAA : public OperatorBase, public ForceBase
 
   Return_t evaluate(ParticleSet& P) override;
 
+  /** evaluate the potential of a crowd of walkers
+   *
+   * The long-range parts of all the walkers are contracted against F_k at once.
+   * Slab geometry and particle traces use the single walker evaluate.
+   */
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
+  /** short-range pair energies are shared equally, the long-range energy of a particle is its charge
+   *  times half the potential of the charge density at its position, the constants are split as in evalConsts.
+   *  The active interaction is shared among the particles of P, the inactive one among the static particles.
+   */
+  bool evaluatePerParticle(ParticleSet& P,
+                           const std::string& static_name,
+                           Vector<Return_t>& e_dynamic,
+                           Vector<Return_t>& e_static) override;
+
   Return_t evaluateWithIonDerivs(ParticleSet& P,
                                  ParticleSet& ions,
                                  TrialWaveFunction& psi,
@@ -104,6 +122,11 @@ struct CoulombPBCAA : public OperatorBase, public ForceBase
 
   void initBreakup(ParticleSet& P);
 
+  /** track the short-range energy incrementally, see evalSRIncremental
+   * @return true if enabled, only bulk cells of quantum particles without forces are supported
+   */
+  bool enableIncrementalSR();
+
 #if !defined(REMOVE_TRACEMANAGER)
   void contributeParticleQuantities() override;
   void checkoutParticleQuantities(TraceManager& tm) override;
@@ -113,6 +136,11 @@ struct CoulombPBCAA : public OperatorBase, public ForceBase
 
   Return_t evalSR(ParticleSet& P);
   Return_t evalLR(ParticleSet& P);
+  /** short-range energy updated from the particles moved since the previous call
+   *
+   * Falls back to evalSR on the first call, when many particles moved or every SRRecomputePeriod updates.
+   */
+  Return_t evalSRIncremental(ParticleSet& P);
   Return_t evalSRwithForces(ParticleSet& P);
   Return_t evalLRwithForces(ParticleSet& P);
   Return_t evalConsts(bool report = true);
@@ -134,6 +162,31 @@ struct CoulombPBCAA : public OperatorBase, public ForceBase
   }
 
 private:
+  /// number of incremental short-range updates between two full evaluations
+  static constexpr int SRRecomputePeriod = 100;
+
+  /// if true, evaluate uses evalSRIncremental
+  bool incremental_sr_;
+  /// number of incremental updates since the last full short-range evaluation
+  int num_sr_updates_;
+  /// short-range energy of sr_positions_
+  mRealType sr_value_;
+  /// positions of the last short-range evaluation
+  std::vector<PosType> sr_positions_;
+  /// particles moved since the last short-range evaluation
+  std::vector<int> sr_moved_;
+  /// flag of the moved particles
+  std::vector<char> sr_is_moved_;
+
+  /// short-range energy change of the particles in sr_moved_ relative to sr_positions_
+  mRealType evalSRChange(const ParticleSet& P) const;
+
+  /** long-range energies of a crowd of walkers
+   * @param p_list particle sets of the walkers
+   * @param v_lr long-range energy of each walker
+   */
+  void mw_evalLR(const RefVectorWithLeader<ParticleSet>& p_list, std::vector<mRealType>& v_lr) const;
+
   // AA table ID
   const int d_aa_ID;
   // Timer for long range
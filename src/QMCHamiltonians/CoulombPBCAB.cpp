@@ -18,6 +18,7 @@
 #include "Particle/DistanceTable.h"
 #include "Message/Communicate.h"
 #include "Utilities/ProgressReportEngine.h"
+#include "CPU/BLAS.hpp"
 
 namespace qmcplusplus
 {
@@ -111,6 +112,103 @@ CoulombPBCAB::Return_t CoulombPBCAB::evaluate(ParticleSet& P)
   return value_;
 }
 
+void CoulombPBCAB::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                               const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                               const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  assert(this == &o_list.getLeader());
+#if !defined(REMOVE_TRACEMANAGER)
+  const bool use_single_walker = ComputeForces || streaming_particles_;
+#else
+  const bool use_single_walker = ComputeForces;
+#endif
+  if (use_single_walker || PtclA.getSK().SuperCellEnum == SUPERCELL_SLAB)
+  {
+    OperatorBase::mw_evaluate(o_list, wf_list, p_list);
+    return;
+  }
+
+  std::vector<mRealType> v_lr(o_list.size());
+  mw_evalLR(p_list, v_lr);
+
+#pragma omp parallel for
+  for (int iw = 0; iw < o_list.size(); iw++)
+  {
+    auto& cab  = o_list.getCastedElement<CoulombPBCAB>(iw);
+    cab.value_ = v_lr[iw] + cab.evalSR(p_list[iw]) + myConst;
+  }
+}
+
+bool CoulombPBCAB::evaluatePerParticle(ParticleSet& P,
+                                       const std::string& static_name,
+                                       Vector<Return_t>& e_dynamic,
+                                       Vector<Return_t>& e_static)
+{
+  const StructFact& RhoKA(PtclA.getSK());
+  const StructFact& RhoKB(P.getSK());
+  if (RhoKA.SuperCellEnum == SUPERCELL_SLAB)
+    throw std::runtime_error("CoulombPBCAB::evaluatePerParticle is not implemented for slab geometry");
+  const bool ions_are_static = PtclA.getName() == static_name;
+  // the electron keeps the whole electron-ion energy if the ions are not resolved
+  const mRealType electron_share = ions_are_static ? 0.5 : 1.0;
+
+  //SR
+  const auto& d_ab(P.getDistTableAB(myTableIndex));
+  for (size_t b = 0; b < NptclB; ++b)
+  {
+    const auto& dist = d_ab.getDistRow(b);
+    for (size_t a = 0; a < NptclA; ++a)
+    {
+      const mRealType pairpot = Qat[b] * Zat[a] * Vat[a]->splint(dist[a]) / dist[a];
+      e_dynamic[b] += electron_share * pairpot;
+      if (ions_are_static)
+        e_static[a] += .5 * pairpot;
+    }
+  }
+
+  //LR, the electron and the ion halves have the same total
+  const auto& kLists = PtclA.getSimulationCell().getKLists();
+  Vector<mRealType> fk;
+  AB->getFkPerVector(kLists.kshell, fk);
+  for (int i = 0; i < NptclB; ++i)
+  {
+    mRealType v1 = 0.0;
+    for (int s = 0; s < NumSpeciesA; s++)
+#if defined(USE_REAL_STRUCT_FACTOR)
+      v1 += Zspec[s] * LRHandlerType::evaluateAt(kLists.kpts_cart, fk, RhoKA.rhok_r[s], RhoKA.rhok_i[s], P.R[i]);
+#else
+      v1 += Zspec[s] * LRHandlerType::evaluateAt(kLists.kpts_cart, fk, RhoKA.rhok[s], P.R[i]);
+#endif
+    e_dynamic[i] += electron_share * Qat[i] * v1;
+  }
+  if (ions_are_static)
+    for (int i = 0; i < NptclA; ++i)
+    {
+      mRealType v1 = 0.0;
+      for (int s = 0; s < NumSpeciesB; s++)
+#if defined(USE_REAL_STRUCT_FACTOR)
+        v1 += Qspec[s] * LRHandlerType::evaluateAt(kLists.kpts_cart, fk, RhoKB.rhok_r[s], RhoKB.rhok_i[s], PtclA.R[i]);
+#else
+        v1 += Qspec[s] * LRHandlerType::evaluateAt(kLists.kpts_cart, fk, RhoKB.rhok[s], PtclA.R[i]);
+#endif
+      e_static[i] += .5 * Zat[i] * v1;
+    }
+
+  //background, see evalConsts
+  const mRealType vs_k0 = AB->evaluateSR_k0();
+  mRealType ion_charge = 0.0, electron_charge = 0.0;
+  for (int s = 0; s < NumSpeciesA; s++)
+    ion_charge += NofSpeciesA[s] * Zspec[s];
+  for (int s = 0; s < NumSpeciesB; s++)
+    electron_charge += NofSpeciesB[s] * Qspec[s];
+  for (int i = 0; i < NptclB; ++i)
+    e_dynamic[i] += -electron_share * Qat[i] * ion_charge * vs_k0;
+  if (ions_are_static)
+    for (int i = 0; i < NptclA; ++i)
+      e_static[i] += -.5 * Zat[i] * electron_charge * vs_k0;
+  return true;
+}
+
 CoulombPBCAB::Return_t CoulombPBCAB::evaluateWithIonDerivs(ParticleSet& P,
                                                            ParticleSet& ions,
                                                            TrialWaveFunction& psi,
@@ -360,6 +458,32 @@ CoulombPBCAB::Return_t CoulombPBCAB::evalLR(ParticleSet& P)
 }
 
 
+void CoulombPBCAB::mw_evalLR(const RefVectorWithLeader<ParticleSet>& p_list, std::vector<mRealType>& v_lr) const
+{
+  const int nw = p_list.size();
+  Vector<mRealType> fk;
+  AB->getFkPerVector(PtclA.getSimulationCell().getKLists().kshell, fk);
+  const int nk = fk.size();
+
+  // F_k times sum_i Z_i rho^i_k of the sources, shared by all the walkers
+  Vector<mRealType> fk_rhok_A(2 * nk);
+  PtclA.getSK().getChargeWeightedRhok(Zspec, nk, fk_rhok_A.data(), fk_rhok_A.data() + nk);
+  for (int ki = 0; ki < nk; ki++)
+  {
+    fk_rhok_A[ki] *= fk[ki];
+    fk_rhok_A[nk + ki] *= fk[ki];
+  }
+
+  // real and imaginary parts of sum_j Q_j rho^j_k, one row per walker
+  Matrix<mRealType> rhok_B(nw, 2 * nk);
+#pragma omp parallel for
+  for (int iw = 0; iw < nw; iw++)
+    p_list[iw].getSK().getChargeWeightedRhok(Qspec, nk, rhok_B[iw], rhok_B[iw] + nk);
+
+  BLAS::gemv('T', 2 * nk, nw, mRealType(1), rhok_B.data(), 2 * nk, fk_rhok_A.data(), 1, mRealType(0), v_lr.data(), 1);
+}
+
+
 void CoulombPBCAB::initBreakup(ParticleSet& P)
 {
   SpeciesSet& tspeciesA(PtclA.getSpeciesSet());
@@ -142,6 +142,25 @@ struct CoulombPBCAB : public OperatorBase, public ForceBase
 
 
   Return_t evaluate(ParticleSet& P) override;
+
+  /** evaluate the potential of a crowd of walkers
+   *
+   * The long-range parts of all the walkers are contracted against F_k and the ion structure factor at once.
+   * Forces, slab geometry and particle traces use the single walker evaluate.
+   */
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
+  /** short-range pair energies and the long-range energies are split between the electron and the ion
+   *  as in the particle traces. The ion shares go to the static particles if the ions are the static set,
+   *  otherwise the whole energy goes to the electrons.
+   */
+  bool evaluatePerParticle(ParticleSet& P,
+                           const std::string& static_name,
+                           Vector<Return_t>& e_dynamic,
+                           Vector<Return_t>& e_static) override;
+
   Return_t evaluateWithIonDerivs(ParticleSet& P,
                                  ParticleSet& ions,
                                  TrialWaveFunction& psi,
@@ -166,6 +185,8 @@ struct CoulombPBCAB : public OperatorBase, public ForceBase
   Return_t evalSR(ParticleSet& P);
   ///Computes the long-range contribution to the coulomb energy.
   Return_t evalLR(ParticleSet& P);
+  ///Computes the long-range contribution to the coulomb energy of a crowd of walkers.
+  void mw_evalLR(const RefVectorWithLeader<ParticleSet>& p_list, std::vector<mRealType>& v_lr) const;
   ///Computes the short-range contribution to the coulomb energy and forces.
   Return_t evalSRwithForces(ParticleSet& P);
   ///Computes the long-range contribution to the coulomb energy and forces.
@@ -66,7 +66,7 @@ struct CoulombPotential : public OperatorBase, public ForceBase
       : ForceBase(s, s),
         Pa(s),
         Pb(s),
-        myTableIndex(s.addTable(s)),
+        myTableIndex(s.addTable(s, active ? DTModes::ALL_OFF : DTModes::LAZY_FULL_TABLE)),
         is_AA(true),
         is_active(active),
         ComputeForces(computeForces)
@@ -338,6 +338,62 @@ struct CoulombPotential : public OperatorBase, public ForceBase
     return value_;
   }
 
+  /** half of each pair energy goes to either particle
+   *
+   * The active AA interaction is shared among the particles of P, the inactive one among the static particles.
+   * The source shares of an AB interaction go to the static particles if the source is the static set,
+   * otherwise the whole pair energy goes to the target particle.
+   */
+  bool evaluatePerParticle(ParticleSet& P,
+                           const std::string& static_name,
+                           Vector<Return_t>& e_dynamic,
+                           Vector<Return_t>& e_static) override
+  {
+    if (is_AA)
+    {
+      if (is_active)
+        addPairSharesAA(P.getDistTableAA(myTableIndex), P.Z.first_address(), e_dynamic);
+      else if (Pa.getName() == static_name)
+        addPairSharesAA(Pa.getDistTableAA(myTableIndex), Pa.Z.first_address(), e_static);
+    }
+    else
+    {
+      const auto& d               = P.getDistTableAB(myTableIndex);
+      const bool source_is_static = Pa.getName() == static_name;
+      const ParticleScalar* restrict Za = Pa.Z.first_address();
+      for (size_t b = 0; b < d.targets(); ++b)
+      {
+        const auto& dist = d.getDistRow(b);
+        for (size_t a = 0; a < nCenters; ++a)
+        {
+          const T pairpot = Za[a] * P.Z[b] / dist[a];
+          if (source_is_static)
+          {
+            e_dynamic[b] += 0.5 * pairpot;
+            e_static[a] += 0.5 * pairpot;
+          }
+          else
+            e_dynamic[b] += pairpot;
+        }
+      }
+    }
+    return true;
+  }
+
+  inline void addPairSharesAA(const DistanceTableAA& d, const ParticleScalar* restrict Z, Vector<Return_t>& e) const
+  {
+    for (size_t iat = 1; iat < nCenters; ++iat)
+    {
+      const auto& dist = d.getDistRow(iat);
+      for (size_t j = 0; j < iat; ++j)
+      {
+        const T pairpot = 0.5 * Z[iat] * Z[j] / dist[j];
+        e[iat] += pairpot;
+        e[j] += pairpot;
+      }
+    }
+  }
+
   inline Return_t evaluateWithIonDerivs(ParticleSet& P,
                                         ParticleSet& ions,
                                         TrialWaveFunction& psi,
@@ -76,6 +76,8 @@ void HamiltonianFactory::addCoulombPotential(xmlNodePtr cur)
   std::string sourceInp(targetPtcl.getName());
   std::string title("ElecElec"), pbc("yes");
   std::string forces("no");
+  std::string incremental("no");
+  std::string pme("no");
   bool physical = true;
   OhmmsAttributeSet hAttrib;
   hAttrib.add(title, "id");
@@ -85,6 +87,8 @@ void HamiltonianFactory::addCoulombPotential(xmlNodePtr cur)
   hAttrib.add(pbc, "pbc");
   hAttrib.add(physical, "physical");
   hAttrib.add(forces, "forces");
+  hAttrib.add(incremental, "incremental");
+  hAttrib.add(pme, "pme");
   hAttrib.put(cur);
   bool applyPBC      = (PBCType && pbc == "yes");
   bool doForces      = (forces == "yes") || (forces == "true");
@@ -122,7 +126,25 @@ void HamiltonianFactory::addCoulombPotential(xmlNodePtr cur)
     }
 #else
     if (applyPBC)
-      targetH->addOperator(std::make_unique<CoulombPBCAA>(*ptclA, quantum, doForces), title, physical);
+    {
+      auto caa = std::make_unique<CoulombPBCAA>(*ptclA, quantum, doForces);
+      if (incremental == "yes" || incremental == "true")
+      {
+        if (caa->enableIncrementalSR())
+          app_log() << "  Short-range part of " << title << " is updated incrementally." << std::endl;
+        else
+          app_warning() << "  incremental=\"yes\" of " << title
+                        << " ignored. It requires quantum particles, a bulk cell and no forces." << std::endl;
+      }
+      if (pme == "yes" || pme == "true")
+      {
+        ptclA->turnOnParticleMeshSK();
+        if (ptclA->getPerParticleSKState())
+          app_warning() << "  pme=\"yes\" of " << title
+                        << " ignored. The structure factor of " << sourceInp << " is stored per particle." << std::endl;
+      }
+      targetH->addOperator(std::move(caa), title, physical);
+    }
     else
     {
       targetH->addOperator(std::make_unique<CoulombPotential<Return_t>>(*ptclA, quantum, doForces), title, physical);
@@ -68,6 +68,8 @@ bool ECPotentialBuilder::put(xmlNodePtr cur)
   std::string pbc;
   std::string forces;
   std::string physicalSO;
+  int sample_pairs       = 0;
+  RealType neighbor_skin = 0;
 
   OhmmsAttributeSet pAttrib;
   pAttrib.add(ecpFormat, "format", {"table", "xml"});
@@ -76,6 +78,8 @@ bool ECPotentialBuilder::put(xmlNodePtr cur)
   pAttrib.add(pbc, "pbc", {"yes", "no"});
   pAttrib.add(forces, "forces", {"no", "yes"});
   pAttrib.add(physicalSO, "physicalSO", {"yes", "no"});
+  pAttrib.add(sample_pairs, "samplePairs");
+  pAttrib.add(neighbor_skin, "neighborSkin");
   pAttrib.put(cur);
 
   bool doForces = (forces == "yes") || (forces == "true");
@@ -150,6 +154,17 @@ bool ECPotentialBuilder::put(xmlNodePtr cur)
               << "    Maximum grid on a sphere for NonLocalECPotential: " << nknot_max << std::endl;
     if (NLPP_algo == "batched")
       app_log() << "    Using batched ratio computing in NonLocalECP" << std::endl;
+    if (sample_pairs > 0)
+    {
+      app_log() << "    Sampling on average " << sample_pairs << " ion-electron pairs per walker in NonLocalECP"
+                << std::endl;
+      apot->setPairSampling(sample_pairs);
+    }
+    if (neighbor_skin > 0)
+    {
+      app_log() << "    Using ion neighbor lists with a skin of " << neighbor_skin << " bohr in NonLocalECP" << std::endl;
+      apot->setNeighborSkin(neighbor_skin);
+    }
 
     targetH.addOperator(std::move(apot), "NonLocalECP");
   }
@@ -174,12 +189,16 @@ bool ECPotentialBuilder::put(xmlNodePtr cur)
       {
         nknot_max = std::max(nknot_max, soPot[i]->getNknot());
         sknot_max = std::max(sknot_max, soPot[i]->getSknot());
+        if (NLPP_algo == "batched")
+          soPot[i]->initVirtualParticle(targetPtcl);
         apot->addComponent(i, std::move(soPot[i]));
       }
     }
     app_log() << "\n  Using SOECP potential \n"
               << "    Maximum grid on a sphere for SOECPotential: " << nknot_max << std::endl;
     app_log() << "    Maximum grid for Simpson's rule for spin integral: " << sknot_max << std::endl;
+    if (NLPP_algo == "batched")
+      app_log() << "    Using batched ratio computing in SOECP" << std::endl;
 
     if (physicalSO == "yes")
       targetH.addOperator(std::move(apot), "SOECP"); //default is physical operator
@@ -68,7 +68,7 @@ bool EnergyDensityEstimator::put(xmlNodePtr cur)
   if (Pdynamic->hasSK())
     Pdynamic->turnOnPerParticleSK();
   nparticles = Pdynamic->getTotalNum();
-  std::vector<ParticleSet*> Pref;
+  std::vector<const ParticleSet*> Pref;
   if (stat == "")
   {
     Pstatic      = 0;
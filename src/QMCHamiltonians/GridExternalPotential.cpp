@@ -14,6 +14,7 @@
 
 #include "GridExternalPotential.h"
 #include "OhmmsData/AttributeSet.h"
+#include "spline2/MultiBsplineEval_helper.hpp"
 
 
 namespace qmcplusplus
@@ -111,16 +112,13 @@ GridExternalPotential::Return_t GridExternalPotential::evaluate(ParticleSet& P)
   else
   {
 #endif
+    const size_t n = P.getTotalNum();
+    std::vector<double> pos(3 * n), vals(n);
+    gatherPositions(P, pos, 0, n);
+    evaluatePoints(n, pos.data(), vals.data());
     value_ = 0.0;
-    for (int i = 0; i < P.getTotalNum(); ++i)
-    {
-      PosType r = P.R[i];
-      P.getLattice().applyMinimumImage(r);
-      double val = 0.0;
-      eval_UBspline_3d_d(spline_data.get(), r[0], r[1], r[2], &val);
-
-      value_ += val;
-    }
+    for (size_t i = 0; i < n; ++i)
+      value_ += vals[i];
 #if !defined(REMOVE_TRACEMANAGER)
   }
 #endif
@@ -128,6 +126,93 @@ GridExternalPotential::Return_t GridExternalPotential::evaluate(ParticleSet& P)
 }
 
 
+void GridExternalPotential::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                                        const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                        const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  // per particle traces are collected by the single walker evaluation
+  if (streaming_particles_)
+  {
+    OperatorBase::mw_evaluate(o_list, wf_list, p_list);
+    return;
+  }
+
+  const size_t nw = o_list.size();
+  std::vector<size_t> offsets(nw + 1, 0);
+  for (size_t iw = 0; iw < nw; iw++)
+    offsets[iw + 1] = offsets[iw] + p_list[iw].getTotalNum();
+  const size_t n = offsets[nw];
+
+  std::vector<double> pos(3 * n), vals(n);
+  for (size_t iw = 0; iw < nw; iw++)
+    gatherPositions(p_list[iw], pos, offsets[iw], n);
+  evaluatePoints(n, pos.data(), vals.data());
+
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    Return_t value(0);
+    for (size_t i = offsets[iw]; i < offsets[iw + 1]; ++i)
+      value += vals[i];
+    o_list.getCastedElement<GridExternalPotential>(iw).value_ = value;
+  }
+}
+
+
+void GridExternalPotential::gatherPositions(const ParticleSet& P,
+                                            std::vector<double>& pos,
+                                            size_t offset,
+                                            size_t num_points)
+{
+  for (int i = 0; i < P.getTotalNum(); ++i)
+  {
+    PosType r = P.R[i];
+    P.getLattice().applyMinimumImage(r);
+    for (int d = 0; d < OHMMS_DIM; ++d)
+      pos[d * num_points + offset + i] = r[d];
+  }
+}
+
+
+void GridExternalPotential::evaluatePoints(size_t n, const double* restrict pos, double* restrict vals) const
+{
+  const UBspline_3d_d& spline   = *spline_data;
+  const double* restrict coefs = spline.coefs;
+  const intptr_t xs            = spline.x_stride;
+  const intptr_t ys            = spline.y_stride;
+  // the last interval starts at the last grid point only for periodic boundaries
+  auto maxIndex = [](const Ugrid& grid, const BCtype_d& bc) {
+    return (bc.lCode == PERIODIC || bc.lCode == ANTIPERIODIC) ? grid.num - 1 : grid.num - 2;
+  };
+  const int nx_max = maxIndex(spline.x_grid, spline.xBC);
+  const int ny_max = maxIndex(spline.y_grid, spline.yBC);
+  const int nz_max = maxIndex(spline.z_grid, spline.zBC);
+
+#pragma omp parallel for simd
+  for (size_t i = 0; i < n; ++i)
+  {
+    double tx, ty, tz;
+    int ix, iy, iz;
+    spline2::getSplineBound((pos[i] - spline.x_grid.start) * spline.x_grid.delta_inv, tx, ix, nx_max);
+    spline2::getSplineBound((pos[n + i] - spline.y_grid.start) * spline.y_grid.delta_inv, ty, iy, ny_max);
+    spline2::getSplineBound((pos[2 * n + i] - spline.z_grid.start) * spline.z_grid.delta_inv, tz, iz, nz_max);
+
+    double a[4], b[4], c[4];
+    spline2::MultiBsplineData<double>::compute_prefactors(a, tx);
+    spline2::MultiBsplineData<double>::compute_prefactors(b, ty);
+    spline2::MultiBsplineData<double>::compute_prefactors(c, tz);
+
+    double val = 0.0;
+    for (int j = 0; j < 4; j++)
+      for (int k = 0; k < 4; k++)
+      {
+        const double* restrict coefs_jk = coefs + (ix + j) * xs + (iy + k) * ys + iz;
+        val += a[j] * b[k] * (coefs_jk[0] * c[0] + coefs_jk[1] * c[1] + coefs_jk[2] * c[2] + coefs_jk[3] * c[3]);
+      }
+    vals[i] = val;
+  }
+}
+
+
 #if !defined(REMOVE_TRACEMANAGER)
 GridExternalPotential::Return_t GridExternalPotential::evaluate_sp(ParticleSet& P)
 {
@@ -54,6 +54,14 @@ struct GridExternalPotential : public OperatorBase
   Return_t evaluate(ParticleSet& P) override;
   inline Return_t evaluate(ParticleSet& P, std::vector<NonLocalData>& Txy) { return evaluate(P); }
 
+  /** evaluate the potential of a crowd
+   *
+   * The electrons of all the walkers are interpolated together in a single pass over the points.
+   */
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
 #if !defined(REMOVE_TRACEMANAGER)
   //traces interface
   void contributeParticleQuantities() override { request_.contribute_array(name_); }
@@ -74,6 +82,17 @@ struct GridExternalPotential : public OperatorBase
   //  not really for interface, just collects traces
   inline Return_t evaluate_sp(ParticleSet& P);
 #endif
+
+private:
+  /// gather the minimum image positions of the particles of P into pos starting at the point offset
+  static void gatherPositions(const ParticleSet& P, std::vector<double>& pos, size_t offset, size_t num_points);
+
+  /** evaluate the spline at n points
+   * @param n number of points
+   * @param pos coordinates in SoA layout, x of all the points followed by y and z
+   * @param vals values, vals[i] of point i
+   */
+  void evaluatePoints(size_t n, const double* restrict pos, double* restrict vals) const;
 };
 } // namespace qmcplusplus
 #endif
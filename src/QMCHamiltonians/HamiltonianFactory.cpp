@@ -433,6 +433,12 @@ bool HamiltonianFactory::build(xmlNodePtr cur, bool buildtree)
       }
       //APP_ABORT("HamiltonianFactory::build\n  a name for operator of type "+cname+" "+potType+" must be provided in the xml input");
       targetH->addOperatorType(potName, potType);
+      ObservableLayout h5_layout;
+      if (h5_layout.put(cur))
+        targetH->setObservableLayout(potName, h5_layout);
+      OperatorEvaluationSchedule schedule;
+      if (schedule.put(cur))
+        targetH->setEvaluationSchedule(potName, schedule);
     }
 
     if (attach2Node)
@@ -82,6 +82,34 @@ HarmonicExternalPotential::Return_t HarmonicExternalPotential::evaluate(Particle
 }
 
 
+void HarmonicExternalPotential::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                                            const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                            const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  // per particle traces are collected by the single walker evaluation
+  if (streaming_particles_)
+  {
+    OperatorBase::mw_evaluate(o_list, wf_list, p_list);
+    return;
+  }
+
+  const RealType prefactor = .5 * energy / (length * length);
+  const size_t nw          = o_list.size();
+#pragma omp parallel for
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    const ParticleSet& P(p_list[iw]);
+    Return_t value(0);
+    for (int i = 0; i < P.getTotalNum(); ++i)
+    {
+      PosType r = P.R[i] - center;
+      value += prefactor * dot(r, r);
+    }
+    o_list.getCastedElement<HarmonicExternalPotential>(iw).value_ = value;
+  }
+}
+
+
 #if !defined(REMOVE_TRACEMANAGER)
 HarmonicExternalPotential::Return_t HarmonicExternalPotential::evaluate_sp(ParticleSet& P)
 {
@@ -54,6 +54,11 @@ struct HarmonicExternalPotential : public OperatorBase
   Return_t evaluate(ParticleSet& P) override;
   inline Return_t evaluate(ParticleSet& P, std::vector<NonLocalData>& Txy) { return evaluate(P); }
 
+  /// evaluate the potential of a crowd
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
 #if !defined(REMOVE_TRACEMANAGER)
   //traces interface
   void contributeParticleQuantities() override { request_.contribute_array(name_); }
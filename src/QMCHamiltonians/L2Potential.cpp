@@ -54,6 +54,36 @@ L2Potential::Return_t L2Potential::evaluate(ParticleSet& P)
   TrialWaveFunction::HessVector D2;
   // evaluateHessian gives the Hessian(log(Psi))
   psi_ref->evaluateHessian(P, D2);
+  return evaluateFromHessian(P, D2);
+}
+
+
+void L2Potential::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                              const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                              const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  assert(this == &o_list.getLeader());
+  const size_t nw = o_list.size();
+#pragma omp parallel
+  {
+    // Hessian of a walker, reused by the walkers of a thread
+    TrialWaveFunction::HessVector D2;
+#pragma omp for
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      auto& O = o_list.getCastedElement<L2Potential>(iw);
+      // evaluateHessian accumulates into D2
+      D2.resize(p_list[iw].getTotalNum());
+      D2 = 0.0;
+      wf_list[iw].evaluateHessian(p_list[iw], D2);
+      O.evaluateFromHessian(p_list[iw], D2);
+    }
+  }
+}
+
+
+L2Potential::Return_t L2Potential::evaluateFromHessian(ParticleSet& P, TrialWaveFunction::HessVector& D2)
+{
   // add gradient terms to get (Hessian(Psi))/Psi instead
   const size_t N = P.getTotalNum();
   for (size_t n = 0; n < N; n++)
@@ -94,6 +124,32 @@ L2Potential::Return_t L2Potential::evaluate(ParticleSet& P)
 }
 
 
+void L2Potential::mw_evaluateDK(const RefVectorWithLeader<L2Potential>& o_list,
+                                const RefVectorWithLeader<ParticleSet>& p_list,
+                                int iel,
+                                std::vector<TensorType>& D,
+                                std::vector<PosType>& K)
+{
+  const size_t nw = o_list.size();
+  D.resize(nw);
+  K.resize(nw);
+  for (size_t iw = 0; iw < nw; iw++)
+    o_list[iw].evaluateDK(p_list[iw], iel, D[iw], K[iw]);
+}
+
+
+void L2Potential::mw_evaluateD(const RefVectorWithLeader<L2Potential>& o_list,
+                               const RefVectorWithLeader<ParticleSet>& p_list,
+                               int iel,
+                               std::vector<TensorType>& D)
+{
+  const size_t nw = o_list.size();
+  D.resize(nw);
+  for (size_t iw = 0; iw < nw; iw++)
+    o_list[iw].evaluateD(p_list[iw], iel, D[iw]);
+}
+
+
 void L2Potential::evaluateDK(ParticleSet& P, int iel, TensorType& D, PosType& K)
 {
   K = 0.0;
@@ -75,6 +75,32 @@ struct L2Potential : public OperatorBase
 
   Return_t evaluate(ParticleSet& P) override;
 
+  /** evaluate the L2 energy of a crowd
+   *
+   * The Hessian of each walker is taken from its own wavefunction in wf_list.
+   */
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
+  /** compute D and K of the active particle of every walker of a crowd
+   * @param o_list L2Potential of the walkers
+   * @param p_list walkers with iel as the active particle
+   * @param D diffusion matrices, D[iw] of walker iw
+   * @param K drift modification vectors, K[iw] of walker iw
+   */
+  static void mw_evaluateDK(const RefVectorWithLeader<L2Potential>& o_list,
+                            const RefVectorWithLeader<ParticleSet>& p_list,
+                            int iel,
+                            std::vector<TensorType>& D,
+                            std::vector<PosType>& K);
+
+  /// compute D of the active particle of every walker of a crowd
+  static void mw_evaluateD(const RefVectorWithLeader<L2Potential>& o_list,
+                           const RefVectorWithLeader<ParticleSet>& p_list,
+                           int iel,
+                           std::vector<TensorType>& D);
+
   void evaluateDK(ParticleSet& P, int iel, TensorType& D, PosType& K);
   void evaluateD(ParticleSet& P, int iel, TensorType& D);
 
@@ -93,6 +119,13 @@ struct L2Potential : public OperatorBase
    * @param ppot L2 pseudopotential
    */
   void add(int groupID, std::unique_ptr<L2RadialPotential>&& ppot);
+
+private:
+  /** evaluate the energy from the Hessian of log(Psi)
+   * @param P quantum particleset with valid G and L
+   * @param D2 Hessian of log(Psi), turned into Hessian(Psi)/Psi on return
+   */
+  Return_t evaluateFromHessian(ParticleSet& P, TrialWaveFunction::HessVector& D2);
 };
 } // namespace qmcplusplus
 #endif
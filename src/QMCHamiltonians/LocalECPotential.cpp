@@ -29,6 +29,7 @@ LocalECPotential::LocalECPotential(const ParticleSet& ions, ParticleSet& els) :
   myTableIndex = els.addTable(ions);
   //allocate null
   PPset.resize(ions.getSpeciesSet().getTotalNum());
+  PPset_linear.resize(ions.getSpeciesSet().getTotalNum());
   PP.resize(NumIons, nullptr);
   Zeff.resize(NumIons, 0.0);
   gZeff.resize(ions.getSpeciesSet().getTotalNum(), 0);
@@ -53,10 +54,53 @@ void LocalECPotential::add(int groupID, std::unique_ptr<RadialPotentialType>&& p
       Zeff[iat] = z;
     }
   }
+  if (ppot->grid().getGridTag() == LINEAR_1DGRID)
+    PPset_linear[groupID] = std::make_shared<const OneDimCubicSplineLinearGrid<RealType>>(*ppot);
+  else
+    PPset_linear[groupID].reset();
   PPset[groupID] = std::move(ppot);
   gZeff[groupID] = z;
 }
 
+LocalECPotential::Return_t LocalECPotential::evaluateSpecies(int ig,
+                                                             const DistanceTableAB& d_table,
+                                                             std::vector<RealType>& r_buf,
+                                                             std::vector<RealType>& v_buf) const
+{
+  const size_t Nelec = d_table.targets();
+  Return_t esum(0);
+  if (!PPset_linear[ig])
+  {
+    const RadialPotentialType& pp = *PPset[ig];
+    for (size_t iel = 0; iel < Nelec; ++iel)
+    {
+      const auto& dist = d_table.getDistRow(iel);
+      for (size_t iat = 0; iat < NumIons; ++iat)
+        if (IonConfig.GroupID[iat] == ig)
+          esum += pp.RadialPotentialType::splint(dist[iat]) / dist[iat]; // qualified, no virtual dispatch
+    }
+    return esum;
+  }
+
+  r_buf.clear();
+  for (size_t iel = 0; iel < Nelec; ++iel)
+  {
+    const auto& dist = d_table.getDistRow(iel);
+    for (size_t iat = 0; iat < NumIons; ++iat)
+      if (IonConfig.GroupID[iat] == ig)
+        r_buf.push_back(dist[iat]);
+  }
+  const int npairs = r_buf.size();
+  v_buf.resize(npairs);
+  PPset_linear[ig]->splint(npairs, r_buf.data(), v_buf.data());
+  const RealType* restrict r = r_buf.data();
+  const RealType* restrict v = v_buf.data();
+#pragma omp simd reduction(+ : esum)
+  for (int i = 0; i < npairs; i++)
+    esum += v[i] / r[i];
+  return esum;
+}
+
 #if !defined(REMOVE_TRACEMANAGER)
 void LocalECPotential::contributeParticleQuantities() { request_.contribute_array(name_); }
 
@@ -90,19 +134,67 @@ LocalECPotential::Return_t LocalECPotential::evaluate(ParticleSet& P)
 #endif
   {
     const auto& d_table(P.getDistTableAB(myTableIndex));
-    value_             = 0.0;
-    const size_t Nelec = P.getTotalNum();
-    for (size_t iel = 0; iel < Nelec; ++iel)
+    std::vector<RealType> r_buf, v_buf;
+    value_ = 0.0;
+    for (int ig = 0; ig < PPset.size(); ++ig)
+      if (PPset[ig])
+        value_ -= evaluateSpecies(ig, d_table, r_buf, v_buf) * gZeff[ig];
+  }
+  return value_;
+}
+
+void LocalECPotential::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                   const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  // per particle traces are collected by the single walker evaluation
+  if (streaming_particles_)
+  {
+    OperatorBase::mw_evaluate(o_list, wf_list, p_list);
+    return;
+  }
+
+  const size_t nw = o_list.size();
+#pragma omp parallel
+  {
+    // scratch of the batched spline evaluation, reused by the walkers of a thread
+    std::vector<RealType> r_buf, v_buf;
+#pragma omp for
+    for (size_t iw = 0; iw < nw; iw++)
     {
-      const auto& dist = d_table.getDistRow(iel);
-      Return_t esum(0);
-      for (size_t iat = 0; iat < NumIons; ++iat)
-        if (PP[iat] != nullptr)
-          esum += PP[iat]->splint(dist[iat]) * Zeff[iat] / dist[iat];
-      value_ -= esum;
+      auto& O = o_list.getCastedElement<LocalECPotential>(iw);
+      const ParticleSet& P(p_list[iw]);
+      const auto& d_table(P.getDistTableAB(O.myTableIndex));
+      Return_t value(0);
+      for (int ig = 0; ig < PPset.size(); ++ig)
+        if (PPset[ig])
+          value -= evaluateSpecies(ig, d_table, r_buf, v_buf) * gZeff[ig];
+      O.value_ = value;
     }
   }
-  return value_;
+}
+
+bool LocalECPotential::evaluatePerParticle(ParticleSet& P,
+                                           const std::string& static_name,
+                                           Vector<Return_t>& e_dynamic,
+                                           Vector<Return_t>& e_static)
+{
+  const bool ions_are_static  = IonConfig.getName() == static_name;
+  const Return_t electron_share = ions_are_static ? 0.5 : 1.0;
+  const auto& d_table(P.getDistTableAB(myTableIndex));
+  for (size_t iel = 0; iel < P.getTotalNum(); ++iel)
+  {
+    const auto& dist = d_table.getDistRow(iel);
+    for (size_t iat = 0; iat < NumIons; ++iat)
+      if (PP[iat] != nullptr)
+      {
+        const Return_t pairpot = -PP[iat]->splint(dist[iat]) * Zeff[iat] / dist[iat];
+        e_dynamic[iel] += electron_share * pairpot;
+        if (ions_are_static)
+          e_static[iat] += 0.5 * pairpot;
+      }
+  }
+  return true;
 }
 
 LocalECPotential::Return_t LocalECPotential::evaluateWithIonDerivs(ParticleSet& P,
@@ -220,14 +312,12 @@ LocalECPotential::Return_t LocalECPotential::evaluate_orig(ParticleSet& P)
 std::unique_ptr<OperatorBase> LocalECPotential::makeClone(ParticleSet& qp, TrialWaveFunction& psi)
 {
   std::unique_ptr<LocalECPotential> myclone = std::make_unique<LocalECPotential>(IonConfig, qp);
-
-  for (int ig = 0; ig < PPset.size(); ++ig)
-  {
-    if (PPset[ig])
-    {
-      myclone->add(ig, std::unique_ptr<RadialPotentialType>(PPset[ig]->makeClone()), gZeff[ig]);
-    }
-  }
+  // the radial potentials are read-only, the clones share them
+  myclone->PPset        = PPset;
+  myclone->PPset_linear = PPset_linear;
+  myclone->PP           = PP;
+  myclone->Zeff         = Zeff;
+  myclone->gZeff        = gZeff;
   return myclone;
 }
 } // namespace qmcplusplus
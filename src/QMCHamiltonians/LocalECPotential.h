@@ -22,6 +22,7 @@
 #include "Numerics/OneDimGridFunctor.h"
 #include "Numerics/OneDimLinearSpline.h"
 #include "Numerics/OneDimCubicSpline.h"
+#include "Numerics/OneDimCubicSplineLinearGrid.h"
 #include "Particle/DistanceTable.h"
 
 namespace qmcplusplus
@@ -43,10 +44,12 @@ struct LocalECPotential : public OperatorBase
   int myTableIndex;
   ///temporary energy per particle for pbyp move
   RealType PPtmp;
-  ///unique set of local ECP to cleanup
-  std::vector<std::unique_ptr<RadialPotentialType>> PPset;
+  ///unique set of local ECP, read-only and shared by the clones
+  std::vector<std::shared_ptr<const RadialPotentialType>> PPset;
+  ///linear grid copies of PPset for the batched evaluation, nullptr if the spline is not on a LinearGrid
+  std::vector<std::shared_ptr<const OneDimCubicSplineLinearGrid<RealType>>> PPset_linear;
   ///PP[iat] is the local potential for the iat-th particle
-  std::vector<RadialPotentialType*> PP;
+  std::vector<const RadialPotentialType*> PP;
   ///effective charge per ion
   std::vector<RealType> Zeff;
   ///effective charge per species
@@ -74,6 +77,22 @@ struct LocalECPotential : public OperatorBase
 
   Return_t evaluate(ParticleSet& P) override;
 
+  /** evaluate the local potential of a crowd
+   *
+   * The splines of the leader are used for all the walkers, one ion species after another.
+   */
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
+  /** electron-ion pair energies are shared equally if the ions are the static set,
+   *  otherwise they go to the electrons
+   */
+  bool evaluatePerParticle(ParticleSet& P,
+                           const std::string& static_name,
+                           Vector<Return_t>& e_dynamic,
+                           Vector<Return_t>& e_static) override;
+
   Return_t evaluateWithIonDerivs(ParticleSet& P,
                                  ParticleSet& ions,
                                  TrialWaveFunction& psi,
@@ -99,6 +118,18 @@ struct LocalECPotential : public OperatorBase
    * @param z effective charge of groupID particle
    */
   void add(int groupID, std::unique_ptr<RadialPotentialType>&& ppot, RealType z);
+
+private:
+  /** sum V(r)/r of species ig over all the electron-ion pairs
+   * @param r_buf scratch for the distances
+   * @param v_buf scratch for the potential values
+   *
+   * The distances to the ions of the species are gathered and splined in one batch if PPset_linear[ig] exists.
+   */
+  Return_t evaluateSpecies(int ig,
+                           const DistanceTableAB& d_table,
+                           std::vector<RealType>& r_buf,
+                           std::vector<RealType>& v_buf) const;
 };
 } // namespace qmcplusplus
 #endif
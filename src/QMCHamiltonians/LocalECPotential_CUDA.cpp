@@ -57,9 +57,9 @@ LocalECPotential_CUDA::LocalECPotential_CUDA(ParticleSet& ions, ParticleSet& eln
 
 void LocalECPotential_CUDA::add(int groupID, std::unique_ptr<RadialPotentialType>&& ppot, RealType z)
 {
-  RadialPotentialType* savefunc = PPset[groupID].get();
+  const RadialPotentialType* savefunc = PPset[groupID].get();
   LocalECPotential::add(groupID, std::move(ppot), z);
-  RadialPotentialType* rfunc = PPset[groupID].get();
+  const RadialPotentialType* rfunc = PPset[groupID].get();
   if (rfunc != savefunc)
   {
     // Setup CUDA spline
@@ -20,6 +20,7 @@
 #include "Particle/DistanceTable.h"
 #include "Particle/MCWalkerConfiguration.h"
 #include "Utilities/IteratorUtility.h"
+#include "spline2/MultiBsplineEval_helper.hpp"
 
 #if defined(HAVE_LIBFFTW)
 #include <fftw3.h>
@@ -342,19 +343,60 @@ MPC::Return_t MPC::evalSR(ParticleSet& P) const
 
 MPC::Return_t MPC::evalLR(ParticleSet& P) const
 {
+  const size_t n = P.getTotalNum();
+  std::vector<double> u(OHMMS_DIM * n), vals(n);
+  gatherUnitPositions(P, u, 0, n);
+  evalLRPoints(n, u.data(), vals.data());
   RealType LR = 0.0;
-  double val;
-  for (int i = 0; i < NParticles; i++)
+  for (size_t i = 0; i < n; i++)
+    LR += vals[i];
+  return LR;
+}
+
+void MPC::gatherUnitPositions(const ParticleSet& P, std::vector<double>& u, size_t offset, size_t num_points)
+{
+  for (int i = 0; i < P.getTotalNum(); i++)
   {
-    //PosType r = P.R[i];
-    //PosType u = P.getLattice().toUnit(r);
-    PosType u = P.getLattice().toUnit(P.R[i]);
+    PosType ui = P.getLattice().toUnit(P.R[i]);
     for (int j = 0; j < OHMMS_DIM; j++)
-      u[j] -= std::floor(u[j]);
-    eval_UBspline_3d_d(VlongSpline.get(), u[0], u[1], u[2], &val);
-    LR += val;
+      u[j * num_points + offset + i] = ui[j] - std::floor(ui[j]);
+  }
+}
+
+void MPC::evalLRPoints(size_t n, const double* restrict u, double* restrict vals) const
+{
+  // same as eval_UBspline_3d_d on the periodic grids over [0,1) of init_spline
+  const UBspline_3d_d& spline  = *VlongSpline;
+  const double* restrict coefs = spline.coefs;
+  const intptr_t xs            = spline.x_stride;
+  const intptr_t ys            = spline.y_stride;
+  const int nx_max             = spline.x_grid.num - 1;
+  const int ny_max             = spline.y_grid.num - 1;
+  const int nz_max             = spline.z_grid.num - 1;
+
+#pragma omp parallel for simd
+  for (size_t i = 0; i < n; ++i)
+  {
+    double tx, ty, tz;
+    int ix, iy, iz;
+    spline2::getSplineBound((u[i] - spline.x_grid.start) * spline.x_grid.delta_inv, tx, ix, nx_max);
+    spline2::getSplineBound((u[n + i] - spline.y_grid.start) * spline.y_grid.delta_inv, ty, iy, ny_max);
+    spline2::getSplineBound((u[2 * n + i] - spline.z_grid.start) * spline.z_grid.delta_inv, tz, iz, nz_max);
+
+    double a[4], b[4], c[4];
+    spline2::MultiBsplineData<double>::compute_prefactors(a, tx);
+    spline2::MultiBsplineData<double>::compute_prefactors(b, ty);
+    spline2::MultiBsplineData<double>::compute_prefactors(c, tz);
+
+    double val = 0.0;
+    for (int j = 0; j < 4; j++)
+      for (int k = 0; k < 4; k++)
+      {
+        const double* restrict coefs_jk = coefs + (ix + j) * xs + (iy + k) * ys + iz;
+        val += a[j] * b[k] * (coefs_jk[0] * c[0] + coefs_jk[1] * c[1] + coefs_jk[2] * c[2] + coefs_jk[3] * c[3]);
+      }
+    vals[i] = val;
   }
-  return LR;
 }
 
 MPC::Return_t MPC::evaluate(ParticleSet& P)
@@ -364,6 +406,32 @@ MPC::Return_t MPC::evaluate(ParticleSet& P)
   return value_;
 }
 
+void MPC::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                      const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                      const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  const size_t nw = o_list.size();
+  std::vector<size_t> offsets(nw + 1, 0);
+  for (size_t iw = 0; iw < nw; iw++)
+    offsets[iw + 1] = offsets[iw] + p_list[iw].getTotalNum();
+  const size_t n = offsets[nw];
+
+  // reduced coordinates of all the electrons of the crowd
+  std::vector<double> u(OHMMS_DIM * n), vals(n);
+  for (size_t iw = 0; iw < nw; iw++)
+    gatherUnitPositions(p_list[iw], u, offsets[iw], n);
+  evalLRPoints(n, u.data(), vals.data());
+
+#pragma omp parallel for
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    Return_t LR(0);
+    for (size_t i = offsets[iw]; i < offsets[iw + 1]; i++)
+      LR += vals[i];
+    o_list.getCastedElement<MPC>(iw).value_ = evalSR(p_list[iw]) + LR + Vconst;
+  }
+}
+
 void MPC::addEnergy(MCWalkerConfiguration& W, std::vector<RealType>& LocalEnergy)
 {
   //only used for debugging
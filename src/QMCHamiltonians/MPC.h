@@ -47,6 +47,14 @@ protected:
   int MaxDim;
   Return_t evalSR(ParticleSet& P) const;
   Return_t evalLR(ParticleSet& P) const;
+  /// gather the reduced coordinates in [0,1) of the particles of P into u starting at the point offset
+  static void gatherUnitPositions(const ParticleSet& P, std::vector<double>& u, size_t offset, size_t num_points);
+  /** evaluate the long-range spline at n points
+   * @param n number of points
+   * @param u reduced coordinates in [0,1), all x then all y then all z
+   * @param vals spline values
+   */
+  void evalLRPoints(size_t n, const double* restrict u, double* restrict vals) const;
   // AA table ID
   const int d_aa_ID;
 
@@ -79,6 +87,14 @@ public:
 
   Return_t evaluate(ParticleSet& P) override;
 
+  /** batched version of evaluate
+   *
+   *  The long-range spline is evaluated at the electrons of all the walkers in a single vectorized loop.
+   */
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
   /** implement all-walker stuff */
   void addEnergy(MCWalkerConfiguration& W, std::vector<RealType>& LocalEnergy) override;
 
@@ -26,8 +26,6 @@ NonLocalECPComponent::NonLocalECPComponent() : lmax(0), nchannel(0), nknot(0), R
 
 NonLocalECPComponent::~NonLocalECPComponent()
 {
-  for (int ip = 0; ip < nlpp_m.size(); ip++)
-    delete nlpp_m[ip];
   if (VP)
     delete VP;
 }
@@ -35,8 +33,6 @@ NonLocalECPComponent::~NonLocalECPComponent()
 NonLocalECPComponent* NonLocalECPComponent::makeClone(const ParticleSet& qp)
 {
   NonLocalECPComponent* myclone = new NonLocalECPComponent(*this);
-  for (int i = 0; i < nlpp_m.size(); ++i)
-    myclone->nlpp_m[i] = nlpp_m[i]->makeClone();
   if (VP)
     myclone->VP = new VirtualParticleSet(qp, nknot);
   return myclone;
@@ -61,7 +57,7 @@ void NonLocalECPComponent::add(int l, RadialPotentialType* pp)
 {
   angpp_m.push_back(l);
   wgt_angpp_m.push_back(static_cast<RealType>(2 * l + 1));
-  nlpp_m.push_back(pp);
+  nlpp_m.emplace_back(pp);
 }
 
 void NonLocalECPComponent::resize_warrays(int n, int m, int l)
@@ -72,6 +68,9 @@ void NonLocalECPComponent::resize_warrays(int n, int m, int l)
   cosgrad.resize(n);
   wfngrad.resize(n);
   knot_pots.resize(n);
+  knot_zz.resize(n);
+  knot_lpol.resize(n);
+  knot_lpolprev.resize(n);
   vrad.resize(m);
   dvrad.resize(m);
   vgrad.resize(m);
@@ -101,6 +100,74 @@ void NonLocalECPComponent::resize_warrays(int n, int m, int l)
       Lfactor2[nl] = 1.0e0 / static_cast<RealType>(nl + 1);
     }
   }
+  buildProjectorTable();
+}
+
+void NonLocalECPComponent::buildProjectorTable()
+{
+  projector_table_.reset();
+  nlpp_linear_.reset();
+  if (nlpp_m.empty())
+    return;
+
+  if (std::all_of(nlpp_m.begin(), nlpp_m.end(),
+                  [](const auto& pp) { return pp->grid().getGridTag() == LINEAR_1DGRID; }))
+  {
+    auto linear = std::make_shared<std::vector<OneDimCubicSplineLinearGrid<RealType>>>();
+    linear->reserve(nlpp_m.size());
+    for (const auto& pp : nlpp_m)
+      linear->emplace_back(*pp);
+    nlpp_linear_ = std::move(linear);
+  }
+
+  const RadialPotentialType& first = *nlpp_m[0];
+  const GridType& agrid            = first.grid();
+  for (const auto& pp : nlpp_m)
+  {
+    const GridType& pgrid = pp->grid();
+    if (pgrid.getGridTag() != LINEAR_1DGRID || pgrid.size() != agrid.size() || pgrid.rmin() != agrid.rmin() ||
+        pgrid.DeltaInv != agrid.DeltaInv || pp->r_min != first.r_min || pp->r_max != first.r_max)
+      return;
+  }
+
+  auto table       = std::make_shared<ProjectorTable>();
+  const int ngrid  = agrid.size();
+  table->r_min     = first.r_min;
+  table->r_max     = first.r_max;
+  table->delta_inv = agrid.DeltaInv;
+  table->grid.resize(ngrid);
+  table->y.resize(ngrid * nchannel);
+  table->y2.resize(ngrid * nchannel);
+  for (int ig = 0; ig < ngrid; ig++)
+  {
+    table->grid[ig] = agrid.r(ig);
+    for (int ip = 0; ip < nchannel; ip++)
+    {
+      table->y[ig * nchannel + ip]  = nlpp_m[ip]->m_Y[ig];
+      table->y2[ig * nchannel + ip] = nlpp_m[ip]->m_Y2[ig];
+    }
+  }
+  projector_table_ = std::move(table);
+}
+
+void NonLocalECPComponent::evaluateRadialProjectors(RealType r)
+{
+  // outside of the splined region, splint handles the extrapolation
+  if (!projector_table_ || r < projector_table_->r_min || r >= projector_table_->r_max)
+  {
+    for (int ip = 0; ip < nchannel; ip++)
+      vrad[ip] = splintChannel(ip, r) * wgt_angpp_m[ip];
+    return;
+  }
+
+  const ProjectorTable& table = *projector_table_;
+  // same as LinearGrid::getIndexAndDistanceFromGridPoint
+  const int loc = static_cast<int>((static_cast<double>(r) - table.grid[0]) * table.delta_inv);
+  CubicSplineEvaluator<RealType> eval(r - table.grid[loc], table.grid[loc + 1] - table.grid[loc]);
+  const RealType* restrict y  = table.y.data() + loc * nchannel;
+  const RealType* restrict y2 = table.y2.data() + loc * nchannel;
+  for (int ip = 0; ip < nchannel; ip++)
+    vrad[ip] = eval.cubicInterpolate(y[ip], y[ip + nchannel], y2[ip], y2[ip + nchannel]) * wgt_angpp_m[ip];
 }
 
 void NonLocalECPComponent::print(std::ostream& os)
@@ -156,37 +223,58 @@ NonLocalECPComponent::RealType NonLocalECPComponent::evaluateOne(ParticleSet& W,
   return calculateProjector(r, dr);
 }
 
+NonLocalECPComponent::RealType NonLocalECPComponent::getProjectorMagnitude(RealType r) const
+{
+  RealType magnitude(0);
+  for (int ip = 0; ip < nchannel; ip++)
+    magnitude += std::abs(splintChannel(ip, r)) * wgt_angpp_m[ip];
+  return magnitude;
+}
+
 NonLocalECPComponent::RealType NonLocalECPComponent::calculateProjector(RealType r, const PosType& dr)
 {
   for (int j = 0; j < nknot; j++)
     psiratio[j] *= sgridweight_m[j];
 
   // Compute radial potential, multiplied by (2l+1) factor.
-  for (int ip = 0; ip < nchannel; ip++)
-    vrad[ip] = nlpp_m[ip]->splint(r) * wgt_angpp_m[ip];
+  evaluateRadialProjectors(r);
 
   constexpr RealType czero(0);
   constexpr RealType cone(1);
 
   const RealType rinv = cone / r;
-  RealType pairpot    = czero;
   // Compute spherical harmonics on grid
   for (int j = 0; j < nknot; j++)
   {
-    RealType zz = dot(dr, rrotsgrid_m[j]) * rinv;
-    // Forming the Legendre polynomials
-    lpol[0]           = cone;
-    RealType lpolprev = czero;
-    for (int l = 0; l < lmax; l++)
-    {
-      lpol[l + 1] = (Lfactor1[l] * zz * lpol[l] - l * lpolprev) * Lfactor2[l];
-      lpolprev    = lpol[l];
-    }
+    knot_zz[j]       = dot(dr, rrotsgrid_m[j]) * rinv;
+    knot_lpol[j]     = cone;
+    knot_lpolprev[j] = czero;
+    knot_pots[j]     = czero;
+  }
 
-    RealType lsum = 0.0;
-    for (int l = 0; l < nchannel; l++)
-      lsum += vrad[l] * lpol[angpp_m[l]];
-    knot_pots[j] = lsum * std::real(psiratio[j]);
+  // Forming the Legendre polynomials of all the knots one l at a time
+  for (int l = 0; l <= lmax; l++)
+  {
+    RealType vl = czero;
+    for (int ip = 0; ip < nchannel; ip++)
+      if (angpp_m[ip] == l)
+        vl += vrad[ip];
+    for (int j = 0; j < nknot; j++)
+      knot_pots[j] += vl * knot_lpol[j];
+
+    if (l < lmax)
+      for (int j = 0; j < nknot; j++)
+      {
+        const RealType lpolnext = (Lfactor1[l] * knot_zz[j] * knot_lpol[j] - l * knot_lpolprev[j]) * Lfactor2[l];
+        knot_lpolprev[j]        = knot_lpol[j];
+        knot_lpol[j]            = lpolnext;
+      }
+  }
+
+  RealType pairpot = czero;
+  for (int j = 0; j < nknot; j++)
+  {
+    knot_pots[j] *= std::real(psiratio[j]);
     pairpot += knot_pots[j];
   }
 
@@ -207,29 +295,34 @@ void NonLocalECPComponent::mw_evaluateOne(const RefVectorWithLeader<NonLocalECPC
     // Compute ratios with VP
     RefVectorWithLeader<VirtualParticleSet> vp_list(*ecp_component_leader.VP);
     RefVectorWithLeader<const VirtualParticleSet> const_vp_list(*ecp_component_leader.VP);
-    RefVector<const std::vector<PosType>> deltaV_list;
-    RefVector<std::vector<ValueType>> psiratios_list;
+    auto& scratch             = collection.getScratchArena();
+    auto rot_grid_list_lease  = scratch.lease<std::reference_wrapper<const std::vector<PosType>>>();
+    auto deltaV_list_lease    = scratch.lease<std::reference_wrapper<std::vector<PosType>>>();
+    auto psiratios_list_lease = scratch.lease<std::reference_wrapper<std::vector<ValueType>>>();
+    RefVector<const std::vector<PosType>>& rot_grid_list = *rot_grid_list_lease;
+    RefVector<std::vector<PosType>>& deltaV_list         = *deltaV_list_lease;
+    RefVector<std::vector<ValueType>>& psiratios_list    = *psiratios_list_lease;
+    rot_grid_list.clear();
+    deltaV_list.clear();
+    psiratios_list.clear();
     vp_list.reserve(ecp_component_list.size());
     const_vp_list.reserve(ecp_component_list.size());
-    deltaV_list.reserve(ecp_component_list.size());
-    psiratios_list.reserve(ecp_component_list.size());
 
     for (size_t i = 0; i < ecp_component_list.size(); i++)
     {
       NonLocalECPComponent& component(ecp_component_list[i]);
-      const NLPPJob<RealType>& job = joblist[i];
-
-      component.buildQuadraturePointDeltaPositions(job.ion_elec_dist, job.ion_elec_displ, component.deltaV);
 
       vp_list.push_back(*component.VP);
       const_vp_list.push_back(*component.VP);
+      rot_grid_list.push_back(component.rrotsgrid_m);
       deltaV_list.push_back(component.deltaV);
       psiratios_list.push_back(component.psiratio);
     }
 
     ResourceCollectionTeamLock<VirtualParticleSet> vp_res_lock(collection, vp_list);
 
-    VirtualParticleSet::mw_makeMoves(vp_list, deltaV_list, joblist, true);
+    // deltaV and the quadrature points of all the jobs are placed in one pass
+    VirtualParticleSet::mw_makeMovesOnSphere(vp_list, rot_grid_list, deltaV_list, joblist);
 
     if (use_DLA)
       TrialWaveFunction::mw_evaluateRatios(psi_list, const_vp_list, psiratios_list,
@@ -348,7 +441,7 @@ NonLocalECPComponent::RealType NonLocalECPComponent::evaluateOneWithForces(Parti
   for (int ip = 0; ip < nchannel; ip++)
   {
     //fun fact.  NLPComponent stores v(r) as v(r), and not as r*v(r) like in other places.
-    vrad[ip]  = nlpp_m[ip]->splint(r, dvrad[ip], secondderiv) * wgt_angpp_m[ip];
+    vrad[ip]  = splintChannel(ip, r, dvrad[ip], secondderiv) * wgt_angpp_m[ip];
     vgrad[ip] = dvrad[ip] * dr * wgt_angpp_m[ip] * rinv;
   }
 
@@ -498,7 +591,7 @@ NonLocalECPComponent::RealType NonLocalECPComponent::evaluateOneWithForces(Parti
   for (int ip = 0; ip < nchannel; ip++)
   {
     //fun fact.  NLPComponent stores v(r) as v(r), and not as r*v(r) like in other places.
-    vrad[ip]  = nlpp_m[ip]->splint(r, dvrad[ip], secondderiv) * wgt_angpp_m[ip];
+    vrad[ip]  = splintChannel(ip, r, dvrad[ip], secondderiv) * wgt_angpp_m[ip];
     vgrad[ip] = dvrad[ip] * dr * wgt_angpp_m[ip] * rinv;
   }
 
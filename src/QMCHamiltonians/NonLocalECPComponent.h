@@ -23,6 +23,7 @@
 #include "Numerics/OneDimGridFunctor.h"
 #include "Numerics/OneDimLinearSpline.h"
 #include "Numerics/OneDimCubicSpline.h"
+#include "Numerics/OneDimCubicSplineLinearGrid.h"
 #include "NLPPJob.h"
 
 namespace qmcplusplus
@@ -52,8 +53,8 @@ private:
   RealType Lfactor1[8];
   /// Lfactor1[l]=(l)/(l+1)
   RealType Lfactor2[8];
-  ///Non-Local part of the pseudo-potential
-  std::vector<RadialPotentialType*> nlpp_m;
+  ///Non-Local part of the pseudo-potential, read-only and shared by the clones
+  std::vector<std::shared_ptr<const RadialPotentialType>> nlpp_m;
   ///fixed Spherical Grid for species
   SpherGridType sgridxyz_m;
   ///randomized spherical grid
@@ -86,6 +87,24 @@ private:
   std::vector<PosType> wfngrad;
   //This stores potential contribution per knot:
   std::vector<RealType> knot_pots;
+  //cos(theta), P_l[cos(theta)] and P_{l-1}[cos(theta)] per knot, used by calculateProjector
+  std::vector<RealType> knot_zz, knot_lpol, knot_lpolprev;
+
+  /** spline data of all the channels on their common linear grid
+   * y and y2 store the values and second derivatives of the splines, [grid point][channel]
+   */
+  struct ProjectorTable
+  {
+    RealType r_min;
+    RealType r_max;
+    double delta_inv;
+    std::vector<RealType> grid;
+    aligned_vector<RealType> y, y2;
+  };
+  ///shared by the clones, nullptr if the channels use different grids
+  std::shared_ptr<const ProjectorTable> projector_table_;
+  ///linear grid copies of nlpp_m shared by the clones, nullptr unless all the channels are on a LinearGrid
+  std::shared_ptr<const std::vector<OneDimCubicSplineLinearGrid<RealType>>> nlpp_linear_;
 
   /// scratch spaces used by evaluateValueAndDerivatives
   Matrix<ValueType> dratio;
@@ -110,6 +129,24 @@ private:
    */
   RealType calculateProjector(RealType r, const PosType& dr);
 
+  /// build projector_table_ if all the channels share the same linear grid and nlpp_linear_ if they are all linear
+  void buildProjectorTable();
+
+  /// value of channel ip at r without virtual dispatch when nlpp_linear_ is available
+  inline RealType splintChannel(int ip, RealType r) const
+  {
+    return nlpp_linear_ ? (*nlpp_linear_)[ip].splint(r) : nlpp_m[ip]->splint(r);
+  }
+
+  /// value, derivative and second derivative of channel ip at r
+  inline RealType splintChannel(int ip, RealType r, RealType& du, RealType& d2u) const
+  {
+    return nlpp_linear_ ? (*nlpp_linear_)[ip].splint(r, du, d2u) : nlpp_m[ip]->splint(r, du, d2u);
+  }
+
+  /// compute vrad, the radial potential of all the channels multiplied by (2l+1)
+  void evaluateRadialProjectors(RealType r);
+
 public:
   NonLocalECPComponent();
 
@@ -246,6 +283,11 @@ public:
 
   inline void setRmax(int rmax) { Rmax = rmax; }
   inline RealType getRmax() const { return Rmax; }
+
+  /** magnitude of the projector of a pair at distance r, \f$\sum_l (2l+1)|v_l(r)|\f$.
+   * It bounds the pair potential when all the wave function ratios are one.
+   */
+  RealType getProjectorMagnitude(RealType r) const;
   inline int getNknot() const { return nknot; }
   inline void setLmax(int Lmax) { lmax = Lmax; }
   inline int getLmax() const { return lmax; }
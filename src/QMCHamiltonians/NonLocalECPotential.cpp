@@ -20,6 +20,10 @@
 #include <ResourceCollection.h>
 #include "NonLocalECPComponent.h"
 #include "NLPPJob.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
 
 namespace qmcplusplus
 {
@@ -53,7 +57,9 @@ NonLocalECPotential::NonLocalECPotential(ParticleSet& ions,
       Peln(els),
       ElecNeighborIons(els),
       IonNeighborElecs(ions),
-      UseTMove(TMOVE_OFF)
+      UseTMove(TMOVE_OFF),
+      max_sampled_pairs_(0),
+      neighbor_skin_(0)
 {
   setEnergyDomain(POTENTIAL);
   twoBodyQuantumDomain(ions, els);
@@ -61,15 +67,19 @@ NonLocalECPotential::NonLocalECPotential(ParticleSet& ions,
   NumIons      = ions.getTotalNum();
   //els.resizeSphere(NumIons);
   PP.resize(NumIons, nullptr);
+  all_ion_ids_.resize(NumIons);
+  std::iota(all_ion_ids_.begin(), all_ion_ids_.end(), 0);
   prefix = "FNL";
   PPset.resize(IonConfig.getSpeciesSet().getTotalNum());
   PulayTerm.resize(NumIons);
   update_mode_.set(NONLOCAL, 1);
   nlpp_jobs.resize(els.groups());
+  nlpp_job_scales_.resize(els.groups());
   for (size_t ig = 0; ig < els.groups(); ig++)
   {
     // this should be enough in most calculations assuming that every electron cannot be in more than two pseudo regions.
     nlpp_jobs[ig].reserve(2 * els.groupsize(ig));
+    nlpp_job_scales_[ig].reserve(2 * els.groupsize(ig));
   }
 }
 
@@ -171,10 +181,10 @@ void NonLocalECPotential::evaluateImpl(ParticleSet& P, bool Tmove, bool keepGrid
       Psi.prepareGroup(P, ig);
       for (int jel = P.first(ig); jel < P.last(ig); ++jel)
       {
-        const auto& dist               = myTable.getDistRow(jel);
-        const auto& displ              = myTable.getDisplRow(jel);
+        const auto& dist               = myTable.getNeighborDistRow(jel);
+        const auto& displ              = myTable.getNeighborDisplRow(jel);
         std::vector<int>& NeighborIons = ElecNeighborIons.getNeighborList(jel);
-        for (int iat = 0; iat < NumIons; iat++)
+        for (const int iat : getCandidateIons(myTable, jel))
           if (PP[iat] != nullptr && dist[iat] < PP[iat]->getRmax())
           {
             RealType pairpot = PP[iat]->evaluateOneWithForces(P, iat, Psi, jel, dist[iat], -displ[iat], forces[iat]);
@@ -189,23 +199,30 @@ void NonLocalECPotential::evaluateImpl(ParticleSet& P, bool Tmove, bool keepGrid
   }
   else
   {
+    const bool sample_pairs = max_sampled_pairs_ > 0 && !Tmove && !keepGrid;
+    if (sample_pairs)
+      samplePairs(P);
+    size_t ipair = 0;
     for (int ig = 0; ig < P.groups(); ++ig) //loop over species
     {
       Psi.prepareGroup(P, ig);
       for (int jel = P.first(ig); jel < P.last(ig); ++jel)
       {
-        const auto& dist               = myTable.getDistRow(jel);
-        const auto& displ              = myTable.getDisplRow(jel);
+        const auto& dist               = myTable.getNeighborDistRow(jel);
+        const auto& displ              = myTable.getNeighborDisplRow(jel);
         std::vector<int>& NeighborIons = ElecNeighborIons.getNeighborList(jel);
-        for (int iat = 0; iat < NumIons; iat++)
+        for (const int iat : getCandidateIons(myTable, jel))
           if (PP[iat] != nullptr && dist[iat] < PP[iat]->getRmax())
           {
-            RealType pairpot = PP[iat]->evaluateOne(P, iat, Psi, jel, dist[iat], -displ[iat], use_DLA);
+            NeighborIons.push_back(iat);
+            IonNeighborElecs.getNeighborList(iat).push_back(jel);
+            const RealType scale = sample_pairs ? pair_scales_[ipair++] : 1;
+            if (scale == 0)
+              continue;
+            RealType pairpot = scale * PP[iat]->evaluateOne(P, iat, Psi, jel, dist[iat], -displ[iat], use_DLA);
             if (Tmove)
               PP[iat]->contributeTxy(jel, tmove_xy_);
             value_ += pairpot;
-            NeighborIons.push_back(iat);
-            IonNeighborElecs.getNeighborList(iat).push_back(jel);
             if (streaming_particles_)
             {
               Ve_samp(jel) += 0.5 * pairpot;
@@ -273,22 +290,32 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVectorWithLeader<OperatorBase
     for (int jel = 0; jel < P.getTotalNum(); jel++)
       O.ElecNeighborIons.getNeighborList(jel).clear();
 
+    const bool sample_pairs = O.max_sampled_pairs_ > 0 && !Tmove;
+    if (sample_pairs)
+      O.samplePairs(P);
+    size_t ipair = 0;
     for (int ig = 0; ig < P.groups(); ++ig) //loop over species
     {
-      auto& joblist = O.nlpp_jobs[ig];
+      auto& joblist    = O.nlpp_jobs[ig];
+      auto& job_scales = O.nlpp_job_scales_[ig];
       joblist.clear();
+      job_scales.clear();
 
       for (int jel = P.first(ig); jel < P.last(ig); ++jel)
       {
-        const auto& dist               = myTable.getDistRow(jel);
-        const auto& displ              = myTable.getDisplRow(jel);
+        const auto& dist               = myTable.getNeighborDistRow(jel);
+        const auto& displ              = myTable.getNeighborDisplRow(jel);
         std::vector<int>& NeighborIons = O.ElecNeighborIons.getNeighborList(jel);
-        for (int iat = 0; iat < O.NumIons; iat++)
+        for (const int iat : O.getCandidateIons(myTable, jel))
           if (O.PP[iat] != nullptr && dist[iat] < O.PP[iat]->getRmax())
           {
             NeighborIons.push_back(iat);
             O.IonNeighborElecs.getNeighborList(iat).push_back(jel);
+            const RealType scale = sample_pairs ? O.pair_scales_[ipair++] : 1;
+            if (scale == 0)
+              continue;
             joblist.emplace_back(iat, jel, P.R[jel], dist[iat], -displ[iat]);
+            job_scales.push_back(scale);
           }
       }
     }
@@ -314,7 +341,17 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVectorWithLeader<OperatorBase
   auto pp_component = std::find_if(O_leader.PPset.begin(), O_leader.PPset.end(), [](auto& ptr) { return bool(ptr); });
   assert(pp_component != std::end(O_leader.PPset));
 
-  RefVector<NonLocalECPotential> ecp_potential_list;
+  // the lists are cleared before each use
+  auto& scratch                 = O_leader.mw_res_->collection.getScratchArena();
+  auto ecp_potential_list_lease = scratch.lease<std::reference_wrapper<NonLocalECPotential>>();
+  auto batch_list_lease         = scratch.lease<std::reference_wrapper<const NLPPJob<RealType>>>();
+  auto batch_scales_lease       = scratch.lease<RealType>();
+  auto pairpots_lease           = scratch.getVector<RealType>(nw);
+
+  RefVector<NonLocalECPotential>& ecp_potential_list = *ecp_potential_list_lease;
+  RefVector<const NLPPJob<RealType>>& batch_list     = *batch_list_lease;
+  std::vector<RealType>& batch_scales                = *batch_scales_lease;
+  std::vector<RealType>& pairpots                    = *pairpots_lease;
   RefVectorWithLeader<NonLocalECPComponent> ecp_component_list(**pp_component);
   RefVectorWithLeader<ParticleSet> pset_list(pset_leader);
   RefVectorWithLeader<TrialWaveFunction> psi_list(O_leader.Psi);
@@ -323,14 +360,9 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVectorWithLeader<OperatorBase
   for (size_t iw = 0; iw < nw; iw++)
     assert(&o_list.getCastedElement<NonLocalECPotential>(iw).Psi == &wf_list[iw]);
 
-  RefVector<const NLPPJob<RealType>> batch_list;
-  std::vector<RealType> pairpots(nw);
-
-  ecp_potential_list.reserve(nw);
   ecp_component_list.reserve(nw);
   pset_list.reserve(nw);
   psi_list.reserve(nw);
-  batch_list.reserve(nw);
 
   for (int ig = 0; ig < pset_leader.groups(); ++ig) //loop over species
   {
@@ -351,6 +383,7 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVectorWithLeader<OperatorBase
       pset_list.clear();
       psi_list.clear();
       batch_list.clear();
+      batch_scales.clear();
       for (size_t iw = 0; iw < nw; iw++)
       {
         auto& O = o_list.getCastedElement<NonLocalECPotential>(iw);
@@ -362,6 +395,7 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVectorWithLeader<OperatorBase
           pset_list.push_back(p_list[iw]);
           psi_list.push_back(wf_list[iw]);
           batch_list.push_back(job);
+          batch_scales.push_back(O.nlpp_job_scales_[ig][jobid]);
         }
       }
 
@@ -380,7 +414,7 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVectorWithLeader<OperatorBase
             std::cout << "check " << check_value << " wrong " << pairpots[j] << " diff "
                       << std::abs(check_value - pairpots[j]) << std::endl;
         }
-        ecp_potential_list[j].get().value_ += pairpots[j];
+        ecp_potential_list[j].get().value_ += batch_scales[j] * pairpots[j];
         if (Tmove)
           ecp_component_list[j].contributeTxy(batch_list[j].get().electron_id, ecp_potential_list[j].get().tmove_xy_);
       }
@@ -389,6 +423,57 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVectorWithLeader<OperatorBase
 }
 
 
+void NonLocalECPotential::computeSamplingProbabilities(const std::vector<RealType>& weights,
+                                                       int max_samples,
+                                                       std::vector<RealType>& probs)
+{
+  const size_t n = weights.size();
+  probs.resize(n);
+  if (n <= static_cast<size_t>(max_samples))
+  {
+    std::fill(probs.begin(), probs.end(), RealType(1));
+    return;
+  }
+
+  // the pairs with the largest weights are taken with certainty, the rest proportional to their weights
+  std::vector<RealType> sorted(weights);
+  std::sort(sorted.begin(), sorted.end(), std::greater<RealType>());
+  RealType rest   = std::accumulate(sorted.begin(), sorted.end(), RealType(0));
+  int num_certain = 0;
+  while (num_certain < max_samples && rest > 0 && sorted[num_certain] * (max_samples - num_certain) >= rest)
+    rest -= sorted[num_certain++];
+  const RealType c         = rest > 0 ? (max_samples - num_certain) / rest : 0;
+  const RealType threshold = num_certain > 0 ? sorted[num_certain - 1] : std::numeric_limits<RealType>::max();
+
+  // a pair of zero weight does not contribute and is never taken
+  for (size_t i = 0; i < n; i++)
+    probs[i] = (weights[i] > 0 && weights[i] >= threshold) ? RealType(1) : std::min(RealType(1), c * weights[i]);
+}
+
+void NonLocalECPotential::samplePairs(const ParticleSet& P)
+{
+  const auto& myTable = P.getDistTableAB(myTableIndex);
+  pair_weights_.clear();
+  for (int jel = 0; jel < P.getTotalNum(); ++jel)
+  {
+    const auto& dist = myTable.getNeighborDistRow(jel);
+    for (const int iat : getCandidateIons(myTable, jel))
+      if (PP[iat] != nullptr && dist[iat] < PP[iat]->getRmax())
+        pair_weights_.push_back(PP[iat]->getProjectorMagnitude(dist[iat]));
+  }
+
+  computeSamplingProbabilities(pair_weights_, max_sampled_pairs_, pair_probs_);
+  pair_scales_.resize(pair_probs_.size());
+  for (size_t ipair = 0; ipair < pair_probs_.size(); ipair++)
+  {
+    const RealType prob = pair_probs_[ipair];
+    if (prob >= 1)
+      pair_scales_[ipair] = 1;
+    else
+      pair_scales_[ipair] = (prob > 0 && (*myRNG)() < prob) ? 1 / prob : 0;
+  }
+}
+
 void NonLocalECPotential::evalIonDerivsImpl(ParticleSet& P,
                                             ParticleSet& ions,
                                             TrialWaveFunction& psi,
@@ -424,10 +509,10 @@ void NonLocalECPotential::evalIonDerivsImpl(ParticleSet& P,
     Psi.prepareGroup(P, ig);
     for (int jel = P.first(ig); jel < P.last(ig); ++jel)
     {
-      const auto& dist               = myTable.getDistRow(jel);
-      const auto& displ              = myTable.getDisplRow(jel);
+      const auto& dist               = myTable.getNeighborDistRow(jel);
+      const auto& displ              = myTable.getNeighborDisplRow(jel);
       std::vector<int>& NeighborIons = ElecNeighborIons.getNeighborList(jel);
-      for (int iat = 0; iat < NumIons; iat++)
+      for (const int iat : getCandidateIons(myTable, jel))
         if (PP[iat] != nullptr && dist[iat] < PP[iat]->getRmax())
         {
           value_ +=
@@ -471,8 +556,9 @@ void NonLocalECPotential::computeOneElectronTxy(ParticleSet& P, const int ref_el
   const auto& myTable                  = P.getDistTableAB(myTableIndex);
   const std::vector<int>& NeighborIons = ElecNeighborIons.getNeighborList(ref_elec);
 
-  const auto& dist  = myTable.getDistRow(ref_elec);
-  const auto& displ = myTable.getDisplRow(ref_elec);
+  // the neighbor ions are in the neighbor list of the distance table
+  const auto& dist  = myTable.getNeighborDistRow(ref_elec);
+  const auto& displ = myTable.getNeighborDisplRow(ref_elec);
   for (int atom_index = 0; atom_index < NeighborIons.size(); atom_index++)
   {
     const int iat = NeighborIons[atom_index];
@@ -573,17 +659,152 @@ int NonLocalECPotential::makeNonLocalMovesPbyP(ParticleSet& P)
   return NonLocalMoveAccepted;
 }
 
+std::vector<int> NonLocalECPotential::mw_makeNonLocalMovesPbyP(const RefVectorWithLeader<NonLocalECPotential>& o_list,
+                                                              const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                                              const RefVectorWithLeader<ParticleSet>& p_list)
+{
+  auto& O_leader  = o_list.getLeader();
+  auto& p_leader  = p_list.getLeader();
+  const size_t nw = o_list.size();
+  const int tmove = O_leader.UseTMove;
+  std::vector<int> num_accepts(nw, 0);
+  if (tmove == TMOVE_OFF)
+    return num_accepts;
+
+  // V0 makes a single move per walker selected from Txy of the last energy evaluation
+  std::vector<const NonLocalData*> walker_tmoves(nw, nullptr);
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    auto& O = o_list[iw];
+    if (tmove == TMOVE_V0)
+      walker_tmoves[iw] = O.nonLocalOps.selectMove((*O.myRNG)(), O.tmove_xy_);
+    else if (tmove == TMOVE_V3)
+    {
+      O.elecTMAffected.assign(p_list[iw].getTotalNum(), false);
+      O.nonLocalOps.groupByElectron(p_list[iw].getTotalNum(), O.tmove_xy_);
+    }
+  }
+
+  RefVectorWithLeader<ParticleSet> moved_p_list(p_leader);
+  RefVectorWithLeader<TrialWaveFunction> moved_wf_list(wf_list.getLeader());
+  std::vector<int> moved_walkers;
+  std::vector<PosType> displs;
+  std::vector<TrialWaveFunction::PsiValueType> ratios;
+  std::vector<GradType> grads_new;
+  std::vector<bool> isAccepted;
+  moved_p_list.reserve(nw);
+  moved_wf_list.reserve(nw);
+  moved_walkers.reserve(nw);
+  displs.reserve(nw);
+
+  for (int ig = 0; ig < p_leader.groups(); ++ig) //loop over species
+  {
+    TrialWaveFunction::mw_prepareGroup(wf_list, p_list, ig);
+    for (int iat = p_leader.first(ig); iat < p_leader.last(ig); ++iat)
+    {
+      moved_p_list.clear();
+      moved_wf_list.clear();
+      moved_walkers.clear();
+      displs.clear();
+      for (size_t iw = 0; iw < nw; iw++)
+      {
+        auto& O = o_list[iw];
+        ParticleSet& P(p_list[iw]);
+        RandomGenerator& RandomGen(*O.myRNG);
+        const NonLocalData* oneTMove = nullptr;
+        if (tmove == TMOVE_V0)
+        {
+          if (walker_tmoves[iw] && walker_tmoves[iw]->PID == iat)
+            oneTMove = walker_tmoves[iw];
+        }
+        else if (tmove == TMOVE_V1 || O.elecTMAffected[iat])
+        {
+          // recompute Txy for the given electron, V3 only when it is affected by Tmoves
+          O.computeOneElectronTxy(P, iat);
+          oneTMove = O.nonLocalOps.selectMove(RandomGen(), O.tmove_xy_);
+        }
+        else
+          oneTMove = O.nonLocalOps.selectMove(RandomGen(), iat);
+
+        if (oneTMove)
+        {
+          moved_p_list.push_back(P);
+          moved_wf_list.push_back(wf_list[iw]);
+          moved_walkers.push_back(iw);
+          displs.push_back(oneTMove->Delta);
+        }
+      }
+
+      if (moved_walkers.empty())
+        continue;
+
+      ParticleSet::mw_makeMoveAndCheck(moved_p_list, iat, displs, isAccepted);
+      TrialWaveFunction::mw_calcRatioGrad(moved_wf_list, moved_p_list, iat, ratios, grads_new);
+      for (int i = 0; i < moved_walkers.size(); i++)
+        if (isAccepted[i])
+        {
+          auto& O = o_list[moved_walkers[i]];
+          // mark all affected electrons
+          if (tmove == TMOVE_V3)
+            O.markAffectedElecs(moved_p_list[i].getDistTableAB(O.myTableIndex), iat);
+          num_accepts[moved_walkers[i]]++;
+        }
+      TrialWaveFunction::mw_accept_rejectMove(moved_wf_list, moved_p_list, iat, isAccepted, true);
+      ParticleSet::mw_accept_rejectMove(moved_p_list, iat, isAccepted, true);
+    }
+  }
+
+  moved_p_list.clear();
+  moved_wf_list.clear();
+  for (size_t iw = 0; iw < nw; iw++)
+    if (num_accepts[iw] > 0)
+    {
+      moved_p_list.push_back(p_list[iw]);
+      moved_wf_list.push_back(wf_list[iw]);
+    }
+
+  if (moved_p_list.size())
+  {
+    TrialWaveFunction::mw_completeUpdates(moved_wf_list);
+    // this step also updates electron positions on the device.
+    ParticleSet::mw_donePbyP(moved_p_list, true);
+  }
+
+  return num_accepts;
+}
+
+const std::vector<int>& NonLocalECPotential::getCandidateIons(const DistanceTableAB& myTable, int jel) const
+{
+  return myTable.hasNeighborList() ? myTable.getNeighborIDs(jel) : all_ion_ids_;
+}
+
 void NonLocalECPotential::markAffectedElecs(const DistanceTableAB& myTable, int iel)
 {
   std::vector<int>& NeighborIons = ElecNeighborIons.getNeighborList(iel);
-  for (int iat = 0; iat < NumIons; iat++)
+  const auto& old_dist           = myTable.getNeighborDistRow(iel);
+  const auto& new_dist           = myTable.getTempNeighborDists();
+  const bool has_list            = myTable.hasNeighborList();
+  if (has_list)
+  {
+    // ions outside of both the old and the new neighbor lists are out of range before and after the move
+    const auto& old_ids = myTable.getNeighborIDs(iel);
+    const auto& new_ids = myTable.getTempNeighborIDs();
+    affected_ion_ids_.clear();
+    std::set_union(old_ids.begin(), old_ids.end(), new_ids.begin(), new_ids.end(),
+                   std::back_inserter(affected_ion_ids_));
+  }
+  // an ion outside of a list is beyond the list cutoff and its distance is not computed
+  auto listed_distance = [](const std::vector<int>& ids, const DistanceTableAB::DistRow& dist, int iat) {
+    return std::binary_search(ids.begin(), ids.end(), iat) ? dist[iat] : std::numeric_limits<RealType>::max();
+  };
+  for (const int iat : has_list ? affected_ion_ids_ : all_ion_ids_)
   {
     if (PP[iat] == nullptr)
       continue;
-    RealType old_distance = 0.0;
-    RealType new_distance = 0.0;
-    old_distance          = myTable.getDistRow(iel)[iat];
-    new_distance          = myTable.getTempDists()[iat];
+    const RealType old_distance =
+        has_list ? listed_distance(myTable.getNeighborIDs(iel), old_dist, iat) : old_dist[iat];
+    const RealType new_distance =
+        has_list ? listed_distance(myTable.getTempNeighborIDs(), new_dist, iat) : new_dist[iat];
     bool moved            = false;
     // move out
     if (old_distance < PP[iat]->getRmax() && new_distance >= PP[iat]->getRmax())
@@ -621,9 +842,20 @@ void NonLocalECPotential::addComponent(int groupID, std::unique_ptr<NonLocalECPC
   for (int iat = 0; iat < PP.size(); iat++)
     if (IonConfig.GroupID[iat] == groupID)
       PP[iat] = ppot.get();
+  if (neighbor_skin_ > 0)
+    Peln.enableNeighborList(myTableIndex, ppot->getRmax(), neighbor_skin_);
   PPset[groupID] = std::move(ppot);
 }
 
+void NonLocalECPotential::setNeighborSkin(RealType skin)
+{
+  neighbor_skin_ = skin;
+  if (neighbor_skin_ > 0)
+    for (const auto& ppot : PPset)
+      if (ppot)
+        Peln.enableNeighborList(myTableIndex, ppot->getRmax(), neighbor_skin_);
+}
+
 void NonLocalECPotential::createResource(ResourceCollection& collection) const
 {
   auto new_res = std::make_unique<NonLocalECPotentialMultiWalkerResource>();
@@ -657,6 +889,8 @@ std::unique_ptr<OperatorBase> NonLocalECPotential::makeClone(ParticleSet& qp, Tr
 {
   std::unique_ptr<NonLocalECPotential> myclone =
       std::make_unique<NonLocalECPotential>(IonConfig, qp, psi, ComputeForces, use_DLA);
+  myclone->max_sampled_pairs_ = max_sampled_pairs_;
+  myclone->neighbor_skin_     = neighbor_skin_;
   for (int ig = 0; ig < PPset.size(); ++ig)
     if (PPset[ig])
       myclone->addComponent(ig, std::unique_ptr<NonLocalECPComponent>(PPset[ig]->makeClone(qp)));
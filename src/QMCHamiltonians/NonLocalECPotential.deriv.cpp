@@ -105,8 +105,7 @@ NonLocalECPComponent::RealType NonLocalECPComponent::evaluateValueAndDerivatives
   for (int j = 0; j < nknot; ++j)
     psiratio[j] *= sgridweight_m[j];
 
-  for (int ip = 0; ip < nchannel; ip++)
-    vrad[ip] = nlpp_m[ip]->splint(r) * wgt_angpp_m[ip];
+  evaluateRadialProjectors(r);
 
   RealType pairpot(0);
   const RealType rinv = RealType(1) / r;
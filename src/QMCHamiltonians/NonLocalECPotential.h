@@ -88,6 +88,17 @@ public:
    */
   int makeNonLocalMovesPbyP(ParticleSet& P);
 
+  /** batched version of makeNonLocalMovesPbyP
+   * The moves of all the walkers are proposed, evaluated and accepted per electron across the batch.
+   * @param o_list the list of NonLocalECPotential in a walker batch
+   * @param wf_list the list of TrialWaveFunction in a walker batch
+   * @param p_list the list of ParticleSet in a walker batch
+   * @return the number of accepted moves of each walker
+   */
+  static std::vector<int> mw_makeNonLocalMovesPbyP(const RefVectorWithLeader<NonLocalECPotential>& o_list,
+                                                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                                   const RefVectorWithLeader<ParticleSet>& p_list);
+
   Return_t evaluateValueAndDerivatives(ParticleSet& P,
                                        const opt_variables_type& optvars,
                                        const std::vector<ValueType>& dlogpsi,
@@ -131,6 +142,31 @@ public:
 
   void registerObservables(std::vector<ObservableHelper>& h5list, hid_t gid) const override;
 
+  /** evaluate a random subset of the ion-electron pairs instead of all of them
+   * @param max_pairs expected number of pairs evaluated per walker and step, 0 evaluates all the pairs
+   *
+   * Pair i is evaluated with probability p_i proportional to the magnitude of its projector
+   * and its contribution is divided by p_i which keeps the estimate unbiased.
+   * The sampling is not applied when T-moves need the projector of every pair.
+   */
+  void setPairSampling(int max_pairs) { max_sampled_pairs_ = max_pairs; }
+
+  /** let the ion-electron distance table maintain Verlet lists of the ions within the pseudopotential cutoffs
+   * @param skin width added to the cutoff, the lists are rebuilt once an electron moved by more than skin/2
+   *
+   * Off by default, the ions within the cutoff are then found by scanning all the ions.
+   */
+  void setNeighborSkin(RealType skin);
+
+  /** compute the probabilities p_i = min(1, c w_i) with c such that the sum of p_i is max_samples
+   * @param weights non-negative importance weights
+   * @param max_samples the expected number of samples
+   * @param probs the probabilities, all one if there are no more than max_samples weights
+   */
+  static void computeSamplingProbabilities(const std::vector<RealType>& weights,
+                                           int max_samples,
+                                           std::vector<RealType>& probs);
+
   /** Set the flag whether to compute forces or not.
    * @param val The boolean value for computing forces
    */
@@ -163,6 +199,10 @@ private:
   NeighborLists ElecNeighborIons;
   ///neighborlist of ions
   NeighborLists IonNeighborElecs;
+  ///IDs of all the ions, used when the distance table doesn't maintain neighbor lists
+  std::vector<int> all_ion_ids_;
+  ///union of the old and the new neighbor lists of an electron moved by a T-move
+  std::vector<int> affected_ion_ids_;
   ///use T-moves
   int UseTMove;
   ///ture if an electron is affected by other electrons moved by T-moves
@@ -180,6 +220,16 @@ private:
 #endif
   ///NLPP job list of ion-electron pairs by spin group
   std::vector<std::vector<NLPPJob<RealType>>> nlpp_jobs;
+  ///the factor applied to the pair potential of each job, 1/p_i when sampling pairs
+  std::vector<std::vector<RealType>> nlpp_job_scales_;
+  ///expected number of ion-electron pairs evaluated per step, 0 evaluates all the pairs
+  int max_sampled_pairs_;
+  ///Verlet skin of the ion neighbor lists of the distance table, the lists are not used if 0
+  RealType neighbor_skin_;
+  ///the factor of each ion-electron pair within the cutoff when sampling pairs, 0 if the pair is skipped
+  std::vector<RealType> pair_scales_;
+  ///importance weights and probabilities of the pairs
+  std::vector<RealType> pair_weights_, pair_probs_;
   /// mult walker shared resource
   std::unique_ptr<NonLocalECPotentialMultiWalkerResource> mw_res_;
 
@@ -213,6 +263,18 @@ private:
    */
   void computeOneElectronTxy(ParticleSet& P, const int ref_elec);
 
+  /** ions possibly within the pseudopotential cutoff of an electron
+   * @param myTable the ion-electron distance table
+   * @param jel electron index
+   * @return the neighbor list of the distance table if available, otherwise all the ions
+   */
+  const std::vector<int>& getCandidateIons(const DistanceTableAB& myTable, int jel) const;
+
+  /** draw the ion-electron pairs of P evaluated in this step, see setPairSampling
+   * pair_scales_ follows the order of the electrons and their candidate ions.
+   */
+  void samplePairs(const ParticleSet& P);
+
   /** mark all the electrons affected by Tmoves and update ElecNeighborIons and IonNeighborElecs
    * @param myTable electron ion distance table
    * @param iel reference electron
@@ -17,9 +17,26 @@
  *@brief Definition of ObservableHelper class
  */
 #include "ObservableHelper.h"
+#include "OhmmsData/AttributeSet.h"
 
 namespace qmcplusplus
 {
+/// registered id of the zstd filter plugin
+constexpr H5Z_filter_t H5Z_FILTER_ZSTD = 32015;
+
+bool ObservableLayout::put(xmlNodePtr cur)
+{
+  const ObservableLayout given(*this);
+  OhmmsAttributeSet attrib;
+  attrib.add(chunk_blocks, "h5_chunk_blocks");
+  attrib.add(compression, "h5_compression", {"none", "gzip", "szip", "zstd"});
+  attrib.add(compression_level, "h5_compression_level");
+  attrib.add(chunk_cache_bytes, "h5_chunk_cache");
+  attrib.put(cur);
+  return chunk_blocks != given.chunk_blocks || compression != given.compression ||
+      compression_level != given.compression_level || chunk_cache_bytes != given.chunk_cache_bytes;
+}
+
 ObservableHelper::ObservableHelper(const std::string& title)
     : data_id(-1), space1_id(-1), value1_id(-1), group_name(title), isopened(false)
 {}
@@ -34,6 +51,7 @@ ObservableHelper::ObservableHelper(ObservableHelper&& in) noexcept
       curdims(in.curdims),
       offsets(in.offsets),
       group_name(in.group_name),
+      layout(in.layout),
       isopened(in.isopened)
 {
   in.isopened = false;
@@ -72,27 +90,46 @@ void ObservableHelper::set_dimensions(std::vector<int>& dims, int first)
 
 void ObservableHelper::open(hid_t grp_id)
 {
-  data_id      = H5Gcreate2(grp_id, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-  hsize_t rank = mydims.size();
-  if (rank)
+  data_id  = H5Gcreate2(grp_id, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  isopened = true;
+}
+
+void ObservableHelper::createDataset()
+{
+  const hsize_t rank = mydims.size();
+  hsize_t row_bytes  = sizeof(value_type);
+  for (int i = 1; i < rank; ++i)
+    row_bytes *= mydims[i];
+  std::vector<hsize_t> chunk(mydims);
+  chunk[0] = layout.chunk_blocks > 0 ? layout.chunk_blocks : std::max<hsize_t>(1, layout.chunk_bytes / row_bytes);
+
+  hid_t p = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(p, rank, chunk.data());
+  if (layout.compression == "gzip" && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
   {
-    //create empty data to write something
-    hsize_t nd = 1;
-    for (int i = 1; i < rank; ++i)
-    {
-      nd *= mydims[i];
-    }
-    std::vector<value_type> zeros(nd, 0.0);
-    hid_t p = H5Pcreate(H5P_DATASET_CREATE);
-    H5Pset_chunk(p, rank, &mydims[0]);
-    space1_id      = H5Screate_simple(rank, &mydims[0], &maxdims[0]);
-    value1_id      = H5Dcreate(data_id, "value", H5T_NATIVE_DOUBLE, space1_id, p);
-    hid_t memspace = H5Screate_simple(rank, &mydims[0], NULL);
-    herr_t ret     = H5Dwrite(value1_id, H5T_NATIVE_DOUBLE, memspace, space1_id, H5P_DEFAULT, &zeros[0]);
-    H5Sclose(memspace);
-    H5Pclose(p);
+    H5Pset_shuffle(p);
+    H5Pset_deflate(p, layout.compression_level);
   }
-  isopened = true;
+  else if (layout.compression == "szip" && H5Zfilter_avail(H5Z_FILTER_SZIP) > 0)
+    H5Pset_szip(p, H5_SZIP_NN_OPTION_MASK, 8);
+  else if (layout.compression == "zstd" && H5Zfilter_avail(H5Z_FILTER_ZSTD) > 0)
+  {
+    const unsigned int level = layout.compression_level;
+    H5Pset_shuffle(p);
+    H5Pset_filter(p, H5Z_FILTER_ZSTD, H5Z_FLAG_MANDATORY, 1, &level);
+  }
+  else if (layout.compression != "none")
+    app_warning() << "ObservableHelper: the HDF5 " << layout.compression << " filter is not available, " << group_name
+                  << " is not compressed" << std::endl;
+
+  hid_t dapl = H5Pcreate(H5P_DATASET_ACCESS);
+  if (layout.chunk_cache_bytes > 0)
+    H5Pset_chunk_cache(dapl, H5D_CHUNK_CACHE_NSLOTS_DEFAULT, layout.chunk_cache_bytes, H5D_CHUNK_CACHE_W0_DEFAULT);
+
+  space1_id = H5Screate_simple(rank, &mydims[0], &maxdims[0]);
+  value1_id = H5Dcreate2(data_id, "value", H5T_NATIVE_DOUBLE, space1_id, H5P_DEFAULT, p, dapl);
+  H5Pclose(dapl);
+  H5Pclose(p);
 }
 
 void ObservableHelper::addProperty(float& p, const std::string& pname)
@@ -146,6 +183,8 @@ void ObservableHelper::write(const value_type* first_v, const value_type* /*firs
   hsize_t rank = mydims.size();
   if (rank)
   {
+    if (value1_id < 0)
+      createDataset();
     H5Sset_extent_simple(space1_id, rank, &curdims[0], &maxdims[0]);
     H5Sselect_hyperslab(space1_id, H5S_SELECT_SET, &offsets[0], NULL, &mydims[0], NULL);
     H5Dextend(value1_id, &curdims[0]);
@@ -165,6 +204,11 @@ void ObservableHelper::close()
 {
   if (isopened)
   {
+    if (value1_id > -1)
+    {
+      H5Dclose(value1_id);
+      value1_id = -1;
+    }
     if (space1_id > -1)
     {
       H5Sclose(space1_id);
@@ -20,6 +20,7 @@
 #define QMCPLUSPLUS_OBSERVABLEHELPER_H
 
 #include "Configuration.h"
+#include "OhmmsData/libxmldefs.h"
 #include "OhmmsData/HDFAttribIO.h"
 #include "Numerics/HDFNumericAttrib.h"
 #include "Numerics/HDFSTLAttrib.h"
@@ -28,6 +29,30 @@ namespace qmcplusplus
 {
 using value_type = QMCTraits::FullPrecRealType;
 
+/** storage layout of the value dataset of an observable in stat.h5
+ *
+ * The defaults favor appending one block at a time: the chunks hold several blocks, up to chunk_bytes,
+ * so that the blocks of a chunk are gathered in the chunk cache and the file is not fragmented.
+ */
+struct ObservableLayout
+{
+  /// blocks per chunk, 0 to fill chunks of about chunk_bytes
+  hsize_t chunk_blocks = 0;
+  /// target size of a chunk in bytes when chunk_blocks is 0, a chunk holds at least one block
+  size_t chunk_bytes = 64 * 1024;
+  /// compression filter: none, gzip, szip or zstd. zstd requires the HDF5 filter plugin
+  std::string compression = "none";
+  /// compression level of gzip and zstd
+  int compression_level = 4;
+  /// size of the chunk cache of the dataset in bytes, 0 for the HDF5 default
+  size_t chunk_cache_bytes = 0;
+
+  /** read the h5_chunk_blocks, h5_compression, h5_compression_level and h5_chunk_cache attributes
+   * @return true if any of them is given
+   */
+  bool put(xmlNodePtr cur);
+};
+
 /** define ObservableHelper
  *
  * This is a helper class to manage a hdf5 dagroup for each collectable.
@@ -55,6 +80,8 @@ public:
   std::vector<hsize_t> offsets;
   ///name of this observable
   std::string group_name;
+  ///layout of the value dataset, used when it is created by the first write
+  ObservableLayout layout;
 
   /**
    * default constructor
@@ -88,7 +115,7 @@ public:
 
   /**
    * open a h5 group of this observable
-   * Create a group for an observable and dataspace
+   * Create a group for an observable. The value dataset is created by the first write.
    */
   void open(hid_t grp_id);
 
@@ -125,6 +152,9 @@ private:
 
   ///closes remaining hdf5 handlers in destructor if isopened = true
   void close();
+
+  ///create the value dataset with layout
+  void createDataset();
 };
 } // namespace qmcplusplus
 #endif
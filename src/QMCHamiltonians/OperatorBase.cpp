@@ -148,6 +148,27 @@ void OperatorBase::mw_evaluateWithToperator(const RefVectorWithLeader<OperatorBa
   mw_evaluate(o_list, wf_list, p_list);
 }
 
+bool OperatorBase::evaluatePerParticle(ParticleSet& P,
+                                       const std::string& static_name,
+                                       Vector<Return_t>& e_dynamic,
+                                       Vector<Return_t>& e_static)
+{
+  return false;
+}
+
+bool OperatorBase::mw_evaluatePerParticle(const RefVectorWithLeader<OperatorBase>& o_list,
+                                          const RefVectorWithLeader<ParticleSet>& p_list,
+                                          const std::string& static_name,
+                                          const RefVector<Vector<Return_t>>& e_dynamic,
+                                          const RefVector<Vector<Return_t>>& e_static) const
+{
+  assert(this == &o_list.getLeader());
+  bool has_shares = true;
+  for (int iw = 0; iw < o_list.size(); iw++)
+    has_shares = o_list[iw].evaluatePerParticle(p_list[iw], static_name, e_dynamic[iw], e_static[iw]) && has_shares;
+  return has_shares;
+}
+
 OperatorBase::Return_t OperatorBase::evaluateValueAndDerivatives(ParticleSet& P,
                                                                  const opt_variables_type& optvars,
                                                                  const std::vector<ValueType>& dlogpsi,
@@ -228,6 +249,8 @@ bool OperatorBase::isQuantumClassical() const noexcept { return quantum_domain_
 
 bool OperatorBase::isQuantumQuantum() const noexcept { return quantum_domain_ == QUANTUM_QUANTUM; }
 
+bool OperatorBase::isKinetic() const noexcept { return energy_domain_ == KINETIC; }
+
 bool OperatorBase::getMode(const int i) const noexcept { return update_mode_[i]; }
 
 bool OperatorBase::isNonLocal() const noexcept { return update_mode_[NONLOCAL]; }
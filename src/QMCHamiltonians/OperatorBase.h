@@ -279,6 +279,39 @@ public:
                                         const RefVectorWithLeader<TrialWaveFunction>& wf_list,
                                         const RefVectorWithLeader<ParticleSet>& p_list) const;
 
+  /**
+   * @brief Add the per particle shares of the value of this component at the current configuration.
+   * Used by spatially resolved estimators, e.g. the energy density, in place of the per particle traces.
+   * The shares summed over both particle sets give the value of the last evaluate.
+   * The default has no decomposition.
+
+   * @param P target particle set, distance tables and G, L as left by the last evaluate
+   * @param static_name name of the static (e.g. ion) particle set whose shares are wanted, empty for none
+   * @param e_dynamic shares of the particles of P are added to it
+   * @param e_static shares of the particles of the static set are added to it
+   * @return false if this component has no per particle decomposition
+   */
+  virtual bool evaluatePerParticle(ParticleSet& P,
+                                   const std::string& static_name,
+                                   Vector<Return_t>& e_dynamic,
+                                   Vector<Return_t>& e_static);
+
+  /**
+   * @brief Multi walker version of evaluatePerParticle. Default calls the single walker one for each walker.
+
+   * @param o_list 
+   * @param p_list 
+   * @param static_name 
+   * @param e_dynamic [iw] shares of the particles of p_list[iw]
+   * @param e_static [iw] shares of the particles of the static set
+   * @return false if this component has no per particle decomposition
+   */
+  virtual bool mw_evaluatePerParticle(const RefVectorWithLeader<OperatorBase>& o_list,
+                                      const RefVectorWithLeader<ParticleSet>& p_list,
+                                      const std::string& static_name,
+                                      const RefVector<Vector<Return_t>>& e_dynamic,
+                                      const RefVector<Vector<Return_t>>& e_static) const;
+
   /**
    * @brief Evaluate value and derivatives wrt the optimizables. Default uses evaluate.
 
@@ -401,6 +434,7 @@ public:
   bool isClassicalClassical() const noexcept;
   bool isQuantumClassical() const noexcept;
   bool isQuantumQuantum() const noexcept;
+  bool isKinetic() const noexcept;
 
   /** 
    * @brief Return the mode i
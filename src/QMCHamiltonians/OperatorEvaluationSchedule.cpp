@@ -0,0 +1,39 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "OperatorEvaluationSchedule.h"
+#include <stdexcept>
+#include "OhmmsData/AttributeSet.h"
+
+namespace qmcplusplus
+{
+bool OperatorEvaluationSchedule::put(xmlNodePtr cur)
+{
+  std::string evaluate("always");
+  int evaluate_period(0);
+  OhmmsAttributeSet attrib;
+  attrib.add(evaluate, "evaluate", {"always", "accumulate", "block"});
+  attrib.add(evaluate_period, "evaluate_period");
+  attrib.put(cur);
+  if (evaluate_period < 0)
+    throw std::runtime_error("OperatorEvaluationSchedule::put evaluate_period must be positive.");
+
+  if (evaluate == "accumulate")
+    steps = Steps::ACCUMULATE;
+  else if (evaluate == "block")
+    steps = Steps::BLOCK;
+  if (evaluate_period > 0)
+    period = evaluate_period;
+  return steps != Steps::ALWAYS || evaluate_period > 0;
+}
+
+} // namespace qmcplusplus
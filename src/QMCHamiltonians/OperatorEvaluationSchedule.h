@@ -0,0 +1,63 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_OPERATOR_EVALUATION_SCHEDULE_H
+#define QMCPLUSPLUS_OPERATOR_EVALUATION_SCHEDULE_H
+
+#include "OhmmsData/libxmldefs.h"
+
+namespace qmcplusplus
+{
+/** steps at which an auxiliary operator, one not contributing to the local energy, is evaluated
+ *
+ * On the other steps a walker keeps the values of its last evaluation, which the estimators accumulate.
+ * The default evaluates every step, warm-up included.
+ */
+struct OperatorEvaluationSchedule
+{
+  enum class Steps
+  {
+    ALWAYS,     ///< every step
+    ACCUMULATE, ///< the steps accumulated by the estimators, warm-up excluded
+    BLOCK       ///< the last step of every block
+  };
+  Steps steps = Steps::ALWAYS;
+  /// among those steps, every period-th step of a block
+  int period = 1;
+
+  /** read the evaluate and evaluate_period attributes
+   * @return true if any of them is given
+   */
+  bool put(xmlNodePtr cur);
+
+  /// true if the operator is evaluated every step
+  bool isAlways() const { return steps == Steps::ALWAYS && period == 1; }
+
+  /** true if the operator is evaluated at this step
+   * @param step step within the block
+   * @param block_steps steps of the block
+   * @param accumulating true if the estimators accumulate this step
+   */
+  bool isDue(int step, int block_steps, bool accumulating) const
+  {
+    if (isAlways())
+      return true;
+    if (!accumulating)
+      return false;
+    if (steps == Steps::BLOCK)
+      return step + 1 == block_steps;
+    return (step + 1) % period == 0;
+  }
+};
+
+} // namespace qmcplusplus
+#endif
@@ -113,6 +113,7 @@ void QMCHamiltonian::addOperator(std::unique_ptr<OperatorBase>&& h, const std::s
     app_log() << "  QMCHamiltonian::addOperator " << aname << " to auxH " << std::endl;
     h->setName(aname);
     auxH.push_back(std::move(h));
+    aux_schedules_.emplace_back();
   }
 
   //assign save NLPP if found
@@ -162,6 +163,47 @@ const std::string& QMCHamiltonian::getOperatorType(const std::string& name)
   return type->second;
 }
 
+void QMCHamiltonian::setObservableLayout(const std::string& name, const ObservableLayout& layout)
+{
+  observable_layouts_[name] = layout;
+}
+
+void QMCHamiltonian::setEvaluationSchedule(const std::string& name, const OperatorEvaluationSchedule& schedule)
+{
+  for (int i = 0; i < auxH.size(); ++i)
+    if (auxH[i]->getName() == name)
+    {
+      if (auxH[i]->getMode(OperatorBase::COLLECTABLE))
+        app_warning() << "QMCHamiltonian::setEvaluationSchedule " << name
+                      << " accumulates collectables, it is evaluated every step." << std::endl;
+      else
+      {
+        aux_schedules_[i] = schedule;
+        app_log() << "  QMCHamiltonian::setEvaluationSchedule " << name;
+        if (schedule.steps == OperatorEvaluationSchedule::Steps::BLOCK)
+          app_log() << " is evaluated at the last step of every block" << std::endl;
+        else if (!schedule.isAlways())
+          app_log() << " is evaluated every " << schedule.period << " accumulated steps" << std::endl;
+        else
+          app_log() << " is evaluated every step" << std::endl;
+      }
+      return;
+    }
+  app_warning() << "QMCHamiltonian::setEvaluationSchedule " << name
+                << " is not an auxiliary operator, it is evaluated every step." << std::endl;
+}
+
+void QMCHamiltonian::applyObservableLayout(const OperatorBase& op,
+                                           std::vector<ObservableHelper>& h5desc,
+                                           size_t first) const
+{
+  auto it = observable_layouts_.find(op.getName());
+  if (it == observable_layouts_.end())
+    return;
+  for (size_t i = first; i < h5desc.size(); ++i)
+    h5desc[i].layout = it->second;
+}
+
 ///** remove a named Hamiltonian from the list
 // *@param aname the name of the Hamiltonian
 // *@return true, if the request hamiltonian exists and is removed.
@@ -212,8 +254,13 @@ int QMCHamiltonian::addObservables(ParticleSet& P)
   P.Collectables.rewind();
   for (int i = 0; i < H.size(); ++i)
     H[i]->addObservables(Observables, P.Collectables);
+  aux_observable_ranges_.resize(auxH.size());
   for (int i = 0; i < auxH.size(); ++i)
+  {
+    aux_observable_ranges_[i].first = Observables.size();
     auxH[i]->addObservables(Observables, P.Collectables);
+    aux_observable_ranges_[i].second = Observables.size();
+  }
   myIndex = P.PropertyList.add(Observables.Names[0]);
   for (int i = 1; i < Observables.size(); ++i)
     P.PropertyList.add(Observables.Names[i]);
@@ -232,8 +279,13 @@ void QMCHamiltonian::resetObservables(int start, int ncollects)
   collectables.rewind();
   for (int i = 0; i < H.size(); ++i)
     H[i]->addObservables(Observables, collectables);
+  aux_observable_ranges_.resize(auxH.size());
   for (int i = 0; i < auxH.size(); ++i)
+  {
+    aux_observable_ranges_[i].first = Observables.size();
     auxH[i]->addObservables(Observables, collectables);
+    aux_observable_ranges_[i].second = Observables.size();
+  }
   if (collectables.size() != ncollects)
   {
     APP_ABORT("  QMCHamiltonian::resetObservables numCollectables != ncollects");
@@ -245,16 +297,28 @@ void QMCHamiltonian::resetObservables(int start, int ncollects)
 void QMCHamiltonian::registerObservables(std::vector<ObservableHelper>& h5desc, hid_t gid) const
 {
   for (int i = 0; i < H.size(); ++i)
+  {
+    const size_t first = h5desc.size();
     H[i]->registerObservables(h5desc, gid);
+    applyObservableLayout(*H[i], h5desc, first);
+  }
   for (int i = 0; i < auxH.size(); ++i)
+  {
+    const size_t first = h5desc.size();
     auxH[i]->registerObservables(h5desc, gid);
+    applyObservableLayout(*auxH[i], h5desc, first);
+  }
 }
 
 void QMCHamiltonian::registerCollectables(std::vector<ObservableHelper>& h5desc, hid_t gid) const
 {
   //The physical operators cannot add to collectables
   for (int i = 0; i < auxH.size(); ++i)
+  {
+    const size_t first = h5desc.size();
     auxH[i]->registerCollectables(h5desc, gid);
+    applyObservableLayout(*auxH[i], h5desc, first);
+  }
 }
 
 
@@ -749,6 +813,31 @@ void QMCHamiltonian::auxHevaluate(ParticleSet& P, Walker_t& ThisWalker, bool do_
   }
 }
 
+void QMCHamiltonian::auxHevaluate(ParticleSet& P, Walker_t& ThisWalker, int step, int block_steps, bool accumulating)
+{
+#if !defined(REMOVE_TRACEMANAGER)
+  collect_walker_traces(ThisWalker, P.current_step);
+#endif
+  for (int i = 0; i < auxH.size(); ++i)
+  {
+    if (!aux_schedules_[i].isDue(step, block_steps, accumulating))
+    {
+      const auto* walker_observables = ThisWalker.getPropertyBase() + myIndex;
+      std::copy(walker_observables + aux_observable_ranges_[i].first,
+                walker_observables + aux_observable_ranges_[i].second,
+                Observables.begin() + aux_observable_ranges_[i].first);
+      continue;
+    }
+    auxH[i]->setHistories(ThisWalker);
+    RealType sink = auxH[i]->evaluate(P);
+    auxH[i]->setObservables(Observables);
+#if !defined(REMOVE_TRACEMANAGER)
+    auxH[i]->collectScalarTraces();
+#endif
+    auxH[i]->setParticlePropertyList(P.PropertyList, myIndex);
+  }
+}
+
 /** Looks like a hack see DMCBatched.cpp and DMC.cpp weight is used like temporary flag
  *  from DMC.
  */
@@ -820,6 +909,39 @@ std::vector<QMCHamiltonian::FullPrecRealType> QMCHamiltonian::mw_evaluateWithTop
 
   return local_energies;
 }
+
+std::vector<std::string> QMCHamiltonian::mw_evaluatePerParticle(const RefVectorWithLeader<QMCHamiltonian>& ham_list,
+                                                                const RefVectorWithLeader<ParticleSet>& p_list,
+                                                                const std::string& static_name,
+                                                                const RefVector<Vector<FullPrecRealType>>& kinetic,
+                                                                const RefVector<Vector<FullPrecRealType>>& potential,
+                                                                const RefVector<Vector<FullPrecRealType>>& potential_static)
+{
+  for (int iw = 0; iw < ham_list.size(); ++iw)
+  {
+    kinetic[iw].get()          = 0.0;
+    potential[iw].get()        = 0.0;
+    potential_static[iw].get() = 0.0;
+  }
+  // the static particles carry no kinetic energy
+  std::vector<Vector<FullPrecRealType>> no_static(ham_list.size());
+  RefVector<Vector<FullPrecRealType>> no_static_refs(no_static.begin(), no_static.end());
+
+  std::vector<std::string> missing;
+  auto& ham_leader = ham_list.getLeader();
+  for (int i_ham_op = 0; i_ham_op < ham_leader.H.size(); ++i_ham_op)
+  {
+    const auto HC_list(extract_HC_list(ham_list, i_ham_op));
+    OperatorBase& op_leader = *ham_leader.H[i_ham_op];
+    const bool has_shares   = op_leader.isKinetic()
+          ? op_leader.mw_evaluatePerParticle(HC_list, p_list, "", kinetic, no_static_refs)
+          : op_leader.mw_evaluatePerParticle(HC_list, p_list, static_name, potential, potential_static);
+    if (!has_shares)
+      missing.push_back(op_leader.getName());
+  }
+  return missing;
+}
+
 void QMCHamiltonian::evaluateElecGrad(ParticleSet& P,
                                       TrialWaveFunction& psi,
                                       ParticleSet::ParticlePos& Egrad,
@@ -968,19 +1090,37 @@ int QMCHamiltonian::makeNonLocalMoves(ParticleSet& P)
 }
 
 
+void QMCHamiltonian::mw_computeL2DK(const RefVectorWithLeader<QMCHamiltonian>& ham_list,
+                                    const RefVectorWithLeader<ParticleSet>& p_list,
+                                    int iel,
+                                    std::vector<TensorType>& D,
+                                    std::vector<PosType>& K)
+{
+  L2Potential::mw_evaluateDK(extract_L2_list(ham_list), p_list, iel, D, K);
+}
+
+void QMCHamiltonian::mw_computeL2D(const RefVectorWithLeader<QMCHamiltonian>& ham_list,
+                                   const RefVectorWithLeader<ParticleSet>& p_list,
+                                   int iel,
+                                   std::vector<TensorType>& D)
+{
+  L2Potential::mw_evaluateD(extract_L2_list(ham_list), p_list, iel, D);
+}
+
 std::vector<int> QMCHamiltonian::mw_makeNonLocalMoves(const RefVectorWithLeader<QMCHamiltonian>& ham_list,
                                                       const RefVectorWithLeader<TrialWaveFunction>& wf_list,
                                                       const RefVectorWithLeader<ParticleSet>& p_list)
 {
   auto& ham_leader = ham_list.getLeader();
 
-  std::vector<int> num_accepts(ham_list.size(), 0);
-  if (ham_list.getLeader().nlpp_ptr)
-  {
-    for (int iw = 0; iw < ham_list.size(); ++iw)
-      num_accepts[iw] = ham_list[iw].nlpp_ptr->makeNonLocalMovesPbyP(p_list[iw]);
-  }
-  return num_accepts;
+  if (ham_leader.nlpp_ptr == nullptr)
+    return std::vector<int>(ham_list.size(), 0);
+
+  RefVectorWithLeader<NonLocalECPotential> nlpp_list(*ham_leader.nlpp_ptr);
+  nlpp_list.reserve(ham_list.size());
+  for (QMCHamiltonian& ham : ham_list)
+    nlpp_list.push_back(*ham.nlpp_ptr);
+  return NonLocalECPotential::mw_makeNonLocalMovesPbyP(nlpp_list, wf_list, p_list);
 }
 
 void QMCHamiltonian::createResource(ResourceCollection& collection) const
@@ -1018,6 +1158,9 @@ std::unique_ptr<QMCHamiltonian> QMCHamiltonian::makeClone(ParticleSet& qp, Trial
     H[i]->add2Hamiltonian(qp, psi, *myclone);
   for (int i = 0; i < auxH.size(); ++i)
     auxH[i]->add2Hamiltonian(qp, psi, *myclone);
+  myclone->observable_layouts_ = observable_layouts_;
+  if (myclone->aux_schedules_.size() == aux_schedules_.size())
+    myclone->aux_schedules_ = aux_schedules_;
   //sync indices
   myclone->resetObservables(myIndex, numCollectables);
   //Hamiltonian needs to make sure qp.Collectables are the same as defined by the original Hamiltonian
@@ -1121,4 +1264,15 @@ RefVectorWithLeader<OperatorBase> QMCHamiltonian::extract_HC_list(const RefVecto
   return HC_list;
 }
 
+RefVectorWithLeader<L2Potential> QMCHamiltonian::extract_L2_list(const RefVectorWithLeader<QMCHamiltonian>& ham_list)
+{
+  if (ham_list.getLeader().l2_ptr == nullptr)
+    throw std::runtime_error("QMCHamiltonian::extract_L2_list the Hamiltonian has no L2 potential!");
+  RefVectorWithLeader<L2Potential> L2_list(*ham_list.getLeader().l2_ptr);
+  L2_list.reserve(ham_list.size());
+  for (QMCHamiltonian& H : ham_list)
+    L2_list.push_back(*H.l2_ptr);
+  return L2_list;
+}
+
 } // namespace qmcplusplus
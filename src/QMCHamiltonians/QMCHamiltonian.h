@@ -24,6 +24,7 @@
 #include "Configuration.h"
 #include "QMCDrivers/WalkerProperties.h"
 #include "QMCHamiltonians/OperatorBase.h"
+#include "QMCHamiltonians/OperatorEvaluationSchedule.h"
 #if !defined(REMOVE_TRACEMANAGER)
 #include "Estimators/TraceManager.h"
 #endif
@@ -74,6 +75,12 @@ public:
   ///return type of named H element or fail
   const std::string& getOperatorType(const std::string& name);
 
+  ///set the stat.h5 layout of the observables of the named operator
+  void setObservableLayout(const std::string& name, const ObservableLayout& layout);
+
+  ///set the steps at which the named auxiliary operator is evaluated
+  void setEvaluationSchedule(const std::string& name, const OperatorEvaluationSchedule& schedule);
+
   ///return the number of Hamiltonians
   inline int size() const { return H.size(); }
 
@@ -185,6 +192,15 @@ public:
   void auxHevaluate(ParticleSet& P);
   void auxHevaluate(ParticleSet& P, Walker_t& ThisWalker);
   void auxHevaluate(ParticleSet& P, Walker_t& ThisWalker, bool do_properties, bool do_collectables);
+  /** evaluate the auxiliary operators due at this step according to their schedules
+   * @param step step within the block
+   * @param block_steps steps of the block
+   * @param accumulating true if the estimators accumulate this step
+   *
+   * The operators not due restore their observables from the properties of ThisWalker,
+   * so that saveProperty leaves the values of their last evaluation in the walker.
+   */
+  void auxHevaluate(ParticleSet& P, Walker_t& ThisWalker, int step, int block_steps, bool accumulating);
   void rejectedMove(ParticleSet& P, Walker_t& ThisWalker);
   ///** set Tau for each Hamiltonian
   // */
@@ -259,6 +275,23 @@ public:
       const RefVectorWithLeader<TrialWaveFunction>& wf_list,
       const RefVectorWithLeader<ParticleSet>& p_list);
 
+  /** per particle kinetic and potential energies of a crowd at the configurations of the last evaluation
+   *
+   *  Used by spatially resolved estimators in place of the per particle traces.
+   *  The vectors must be sized to the particle sets and are overwritten.
+   * @param static_name name of the static (e.g. ion) particle set whose potential shares are wanted, empty for none
+   * @param kinetic [iw] kinetic energy of the particles of p_list[iw]
+   * @param potential [iw] potential energy shares of the particles of p_list[iw]
+   * @param potential_static [iw] potential energy shares of the static particles
+   * @return names of the components without a per particle decomposition, they are left out
+   */
+  static std::vector<std::string> mw_evaluatePerParticle(const RefVectorWithLeader<QMCHamiltonian>& ham_list,
+                                                         const RefVectorWithLeader<ParticleSet>& p_list,
+                                                         const std::string& static_name,
+                                                         const RefVector<Vector<FullPrecRealType>>& kinetic,
+                                                         const RefVector<Vector<FullPrecRealType>>& potential,
+                                                         const RefVector<Vector<FullPrecRealType>>& potential_static);
+
 
   /** evaluate energy and derivatives wrt to the variables
    * @param P ParticleSet
@@ -372,6 +405,24 @@ public:
       l2_ptr->evaluateD(P, iel, D);
   }
 
+  /** compute D matrices and K vectors of the L2 propagator for the active particle of a crowd
+   * @param ham_list Hamiltonians of the walkers, the leader must have an L2 potential
+   * @param p_list walkers with iel as the active particle
+   * @param D diffusion matrices (outputted)
+   * @param K drift modification vectors (outputted)
+   */
+  static void mw_computeL2DK(const RefVectorWithLeader<QMCHamiltonian>& ham_list,
+                             const RefVectorWithLeader<ParticleSet>& p_list,
+                             int iel,
+                             std::vector<TensorType>& D,
+                             std::vector<PosType>& K);
+
+  /// compute D matrices of the L2 propagator for the active particle of a crowd
+  static void mw_computeL2D(const RefVectorWithLeader<QMCHamiltonian>& ham_list,
+                            const RefVectorWithLeader<ParticleSet>& p_list,
+                            int iel,
+                            std::vector<TensorType>& D);
+
   static std::vector<int> mw_makeNonLocalMoves(const RefVectorWithLeader<QMCHamiltonian>& ham_list,
                                                const RefVectorWithLeader<TrialWaveFunction>& wf_list,
                                                const RefVectorWithLeader<ParticleSet>& p_list);
@@ -453,12 +504,20 @@ private:
   L2Potential* l2_ptr;
   ///vector of Hamiltonians
   std::vector<std::unique_ptr<OperatorBase>> auxH;
+  ///evaluation schedules of auxH
+  std::vector<OperatorEvaluationSchedule> aux_schedules_;
+  ///ranges of the observables of auxH in Observables
+  std::vector<std::pair<int, int>> aux_observable_ranges_;
   /// Total timer for H evaluation
   NewTimer& ham_timer_;
   /// timers for H components
   TimerList_t my_timers_;
   ///types of component operators
   std::map<std::string, std::string> operator_types;
+  ///stat.h5 layouts of the observables of the component operators, by operator name
+  std::map<std::string, ObservableLayout> observable_layouts_;
+  ///apply the layout of op to the helpers it added to h5desc from index first
+  void applyObservableLayout(const OperatorBase& op, std::vector<ObservableHelper>& h5desc, size_t first) const;
   ///data
   PropertySetType Observables;
   /** reset Observables and counters
@@ -469,6 +528,8 @@ private:
 
   // helper function for extracting a list of Hamiltonian components from a list of QMCHamiltonian::H.
   static RefVectorWithLeader<OperatorBase> extract_HC_list(const RefVectorWithLeader<QMCHamiltonian>& ham_list, int id);
+  // helper function for extracting the list of L2 potentials from a list of QMCHamiltonian.
+  static RefVectorWithLeader<L2Potential> extract_L2_list(const RefVectorWithLeader<QMCHamiltonian>& ham_list);
 
 #if !defined(REMOVE_TRACEMANAGER)
   ///traces variables
@@ -17,7 +17,7 @@
 
 namespace qmcplusplus
 {
-bool ReferencePoints::put(xmlNodePtr cur, ParticleSet& P, std::vector<ParticleSet*>& Pref)
+bool ReferencePoints::put(xmlNodePtr cur, const ParticleSet& P, const std::vector<const ParticleSet*>& Pref)
 {
   app_log() << "  Entering ReferencePoints::put" << std::endl;
   bool succeeded = true;
@@ -79,7 +79,7 @@ bool ReferencePoints::put(xmlNodePtr cur, ParticleSet& P, std::vector<ParticleSe
   return succeeded;
 }
 
-bool ReferencePoints::put(ParticleSet& P, std::vector<ParticleSet*>& Psets)
+bool ReferencePoints::put(const ParticleSet& P, const std::vector<const ParticleSet*>& Psets)
 {
   //get axes and origin information from the ParticleSet
   points["zero"] = 0 * P.getLattice().a(0);
@@ -107,7 +107,7 @@ bool ReferencePoints::put(ParticleSet& P, std::vector<ParticleSet*>& Psets)
   int cshift = 1;
   for (int i = 0; i < Psets.size(); i++)
   {
-    ParticleSet& PS = *Psets[i];
+    const ParticleSet& PS = *Psets[i];
     for (int p = 0; p < PS.getTotalNum(); p++)
     {
       std::stringstream ss;
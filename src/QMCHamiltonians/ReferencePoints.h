@@ -31,8 +31,8 @@ public:
   std::map<std::string, Point> points;
   Tensor_t axes;
 
-  bool put(xmlNodePtr cur, ParticleSet& P, std::vector<ParticleSet*>& Pref);
-  bool put(ParticleSet& P, std::vector<ParticleSet*>& Pref);
+  bool put(xmlNodePtr cur, const ParticleSet& P, const std::vector<const ParticleSet*>& Pref);
+  bool put(const ParticleSet& P, const std::vector<const ParticleSet*>& Pref);
   void write_description(std::ostream& os, std::string& indent);
   void save(std::vector<ObservableHelper>& h5desc, hid_t gid) const;
 
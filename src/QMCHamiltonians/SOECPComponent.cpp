@@ -14,15 +14,16 @@
 #include "Particle/DistanceTable.h"
 #include "SOECPComponent.h"
 #include "Numerics/Ylm.h"
+#include "ResourceCollection.h"
 
 namespace qmcplusplus
 {
-SOECPComponent::SOECPComponent() : lmax(0), nchannel(0), nknot(0), sknot(0), Rmax(-1) {}
+SOECPComponent::SOECPComponent() : lmax(0), nchannel(0), nknot(0), sknot(0), Rmax(-1), VP(nullptr) {}
 
 SOECPComponent::~SOECPComponent()
 {
-  for (int i = 0; i < sopp_m.size(); i++)
-    delete sopp_m[i];
+  if (VP)
+    delete VP;
 }
 
 void SOECPComponent::print(std::ostream& os) {}
@@ -30,21 +31,35 @@ void SOECPComponent::print(std::ostream& os) {}
 void SOECPComponent::add(int l, RadialPotentialType* pp)
 {
   angpp_m.push_back(l);
-  sopp_m.push_back(pp);
+  sopp_m.emplace_back(pp);
 }
 
 SOECPComponent* SOECPComponent::makeClone(const ParticleSet& qp)
 {
   SOECPComponent* myclone = new SOECPComponent(*this);
-  for (int i = 0; i < sopp_m.size(); i++)
-    myclone->sopp_m[i] = sopp_m[i]->makeClone();
+  if (VP)
+    myclone->VP = new VirtualParticleSet(qp, nknot * (sknot + 1));
   return myclone;
 }
 
+void SOECPComponent::initVirtualParticle(const ParticleSet& qp)
+{
+  assert(VP == nullptr);
+  VP = new VirtualParticleSet(qp, nknot * (sknot + 1));
+}
+
+void SOECPComponent::deleteVirtualParticle()
+{
+  if (VP)
+    delete VP;
+  VP = nullptr;
+}
+
 void SOECPComponent::resize_warrays(int n, int m, int s)
 {
-  psiratio.resize(n);
-  deltaV.resize(n);
+  psiratio.resize(n * (s + 1));
+  deltaV.resize(n * (s + 1));
+  deltaS.resize(n * (s + 1));
   vrad.resize(m);
   rrotsgrid_m.resize(n);
   nchannel = sopp_m.size();
@@ -110,60 +125,71 @@ SOECPComponent::ComplexType SOECPComponent::lmMatrixElements(int l, int m1, int
   }
 }
 
-SOECPComponent::ComplexType SOECPComponent::getAngularIntegral(RealType sold,
-                                                               RealType snew,
-                                                               ParticleSet& W,
-                                                               TrialWaveFunction& Psi,
-                                                               int iel,
-                                                               RealType r,
-                                                               const PosType& dr)
+void SOECPComponent::buildTotalQuadrature(RealType r, const PosType& dr, RealType sold)
 {
-  //quadrature sum for angular integral
-  constexpr RealType fourpi = 2.0 * TWOPI;
-  for (int j = 0; j < nknot; j++)
+  const RealType dS = TWOPI / sknot; //step size for spin
+  int count         = 0;
+  for (int is = 0; is <= sknot; is++)
   {
-    deltaV[j] = r * rrotsgrid_m[j] - dr;
-    W.makeMoveWithSpin(iel, deltaV[j], snew - sold);
-    psiratio[j] = Psi.calcRatio(W, iel) * sgridweight_m[j] * fourpi;
-    W.rejectMove(iel);
-    Psi.resetPhaseDiff();
+    const RealType snew = is * dS;
+    for (int iq = 0; iq < nknot; iq++, count++)
+    {
+      deltaV[count] = r * rrotsgrid_m[iq] - dr;
+      deltaS[count] = snew - sold;
+    }
   }
+}
+
+SOECPComponent::RealType SOECPComponent::calculateProjector(RealType r, const PosType& dr, RealType sold)
+{
+  constexpr RealType fourpi = 2.0 * TWOPI;
+  const RealType dS         = TWOPI / sknot; //step size for spin
+
+  for (int ip = 0; ip < nchannel; ip++)
+    vrad[ip] = sopp_m[ip]->splint(r);
 
-  ComplexType angint(0.0);
-  for (int j = 0; j < nknot; j++)
+  //Seemingly Numerics/Ylm takes unit vector with order z,x,y...why
+  const RealType rmag = std::sqrt(dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2]);
+  const PosType rr    = dr / rmag;
+  const PosType rhat(rr[2], rr[0], rr[1]);
+
+  ComplexType sint(0.0);
+  for (int iq = 0; iq < nknot; iq++)
   {
-    ComplexType lsum(0.0);
+    // the angular part does not depend on the spin, contract it once per knot with each component of L
+    const PosType rrot(rrotsgrid_m[iq][2], rrotsgrid_m[iq][0], rrotsgrid_m[iq][1]);
+    ComplexType ldots[3] = {0.0, 0.0, 0.0};
     for (int il = 0; il < nchannel; il++)
     {
       int l = il + 1; //nchannels starts at l=1, so 0th element is p not s
-      ComplexType msums(0.0);
       for (int m1 = -l; m1 <= l; m1++)
       {
+        const ComplexType Y = Ylm(l, m1, rhat);
         for (int m2 = -l; m2 <= l; m2++)
         {
-          ComplexType ldots(0.0);
+          const ComplexType vYcY = vrad[il] * Y * std::conj(Ylm(l, m2, rrot));
           for (int d = 0; d < 3; d++)
-            ldots += lmMatrixElements(l, m1, m2, d) * sMatrixElements(sold, snew, d);
-          //Seemingly Numerics/Ylm takes unit vector with order z,x,y...why
-          RealType rmag = std::sqrt(dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2]);
-          PosType rr    = dr / rmag;
-          PosType tmp;
-          tmp[0]         = rr[2];
-          tmp[1]         = rr[0];
-          tmp[2]         = rr[1];
-          ComplexType Y  = Ylm(l, m1, tmp);
-          tmp[0]         = rrotsgrid_m[j][2];
-          tmp[1]         = rrotsgrid_m[j][0];
-          tmp[2]         = rrotsgrid_m[j][1];
-          ComplexType cY = std::conj(Ylm(l, m2, tmp));
-          msums += Y * cY * ldots;
+            ldots[d] += vYcY * lmMatrixElements(l, m1, m2, d);
         }
       }
-      lsum += vrad[il] * msums;
     }
-    angint += psiratio[j] * lsum;
+
+    //Simpson's rule for the spin integral
+    for (int is = 0; is <= sknot; is++)
+    {
+      const RealType snew = is * dS;
+      RealType sweight    = (is % 2 == 1) ? RealType(4. / 3.) : RealType(2. / 3.);
+      if (is == 0 || is == sknot)
+        sweight = RealType(1. / 3.);
+      ComplexType sdots(0.0);
+      for (int d = 0; d < 3; d++)
+        sdots += ldots[d] * sMatrixElements(sold, snew, d);
+      sint += sweight * dS * fourpi * sgridweight_m[iq] * psiratio[is * nknot + iq] * sdots;
+    }
   }
-  return angint;
+
+  RealType pairpot = std::real(sint) / TWOPI;
+  return pairpot;
 }
 
 SOECPComponent::RealType SOECPComponent::evaluateOne(ParticleSet& W,
@@ -179,35 +205,110 @@ SOECPComponent::RealType SOECPComponent::evaluateOne(ParticleSet& W,
   if (sknot % 2 != 0)
     APP_ABORT("Spin knots uses Simpson's rule. Must have even number of knots");
 
-  for (int ip = 0; ip < nchannel; ip++)
+  const RealType sold = W.spins[iel];
+  buildTotalQuadrature(r, dr, sold);
+
+  if (VP)
   {
-    vrad[ip] = sopp_m[ip]->splint(r);
+    // Compute ratios with VP
+    VP->makeMovesWithSpin(iel, W.R[iel], deltaV, deltaS, true, iat);
+    Psi.evaluateRatios(*VP, psiratio);
+  }
+  else
+  {
+    // Compute ratio of wave functions
+    for (int iq = 0; iq < psiratio.size(); iq++)
+    {
+      W.makeMoveWithSpin(iel, deltaV[iq], deltaS[iq]);
+      psiratio[iq] = Psi.calcRatio(W, iel);
+      W.rejectMove(iel);
+      Psi.resetPhaseDiff();
+    }
   }
 
-  RealType smin(0.0);
-  RealType smax(TWOPI);
-  RealType dS = (smax - smin) / sknot; //step size for spin
+  return calculateProjector(r, dr, sold);
+}
 
-  RealType sold = W.spins[iel];
-  ComplexType sint(0.0);
+void SOECPComponent::mw_evaluateOne(const RefVectorWithLeader<SOECPComponent>& soecp_component_list,
+                                    const RefVectorWithLeader<ParticleSet>& p_list,
+                                    const RefVectorWithLeader<TrialWaveFunction>& psi_list,
+                                    const RefVector<const NLPPJob<RealType>>& joblist,
+                                    std::vector<RealType>& pairpots,
+                                    ResourceCollection& collection)
+{
+  auto& soecp_component_leader = soecp_component_list.getLeader();
+  if (soecp_component_leader.sknot < 2)
+    APP_ABORT("Spin knots must be greater than 2\n");
 
-  for (int is = 1; is <= sknot - 1; is += 2)
+  if (soecp_component_leader.sknot % 2 != 0)
+    APP_ABORT("Spin knots uses Simpson's rule. Must have even number of knots");
+
+  if (soecp_component_leader.VP)
   {
-    RealType snew      = smin + is * dS;
-    ComplexType angint = getAngularIntegral(sold, snew, W, Psi, iel, r, dr);
-    sint += RealType(4. / 3.) * dS * angint;
+    // Compute ratios with VP
+    RefVectorWithLeader<VirtualParticleSet> vp_list(*soecp_component_leader.VP);
+    RefVectorWithLeader<const VirtualParticleSet> const_vp_list(*soecp_component_leader.VP);
+    RefVector<const std::vector<PosType>> deltaV_list;
+    RefVector<const std::vector<RealType>> deltaS_list;
+    RefVector<std::vector<ValueType>> psiratios_list;
+    vp_list.reserve(soecp_component_list.size());
+    const_vp_list.reserve(soecp_component_list.size());
+    deltaV_list.reserve(soecp_component_list.size());
+    deltaS_list.reserve(soecp_component_list.size());
+    psiratios_list.reserve(soecp_component_list.size());
+
+    for (size_t i = 0; i < soecp_component_list.size(); i++)
+    {
+      SOECPComponent& component(soecp_component_list[i]);
+      const NLPPJob<RealType>& job = joblist[i];
+      const RealType sold          = p_list[i].spins[job.electron_id];
+
+      component.buildTotalQuadrature(job.ion_elec_dist, job.ion_elec_displ, sold);
+
+      vp_list.push_back(*component.VP);
+      const_vp_list.push_back(*component.VP);
+      deltaV_list.push_back(component.deltaV);
+      deltaS_list.push_back(component.deltaS);
+      psiratios_list.push_back(component.psiratio);
+    }
+
+    ResourceCollectionTeamLock<VirtualParticleSet> vp_res_lock(collection, vp_list);
+
+    VirtualParticleSet::mw_makeMovesWithSpin(vp_list, deltaV_list, deltaS_list, joblist, true);
+
+    TrialWaveFunction::mw_evaluateRatios(psi_list, const_vp_list, psiratios_list);
   }
-  for (int is = 2; is <= sknot - 2; is += 2)
+  else
   {
-    RealType snew      = smin + is * dS;
-    ComplexType angint = getAngularIntegral(sold, snew, W, Psi, iel, r, dr);
-    sint += RealType(2. / 3.) * dS * angint;
+    // Compute ratios without VP. This is working but very slow code path.
+#pragma omp parallel for
+    for (size_t i = 0; i < p_list.size(); i++)
+    {
+      SOECPComponent& component(soecp_component_list[i]);
+      ParticleSet& W(p_list[i]);
+      TrialWaveFunction& psi(psi_list[i]);
+      const NLPPJob<RealType>& job = joblist[i];
+
+      component.buildTotalQuadrature(job.ion_elec_dist, job.ion_elec_displ, W.spins[job.electron_id]);
+
+      // Compute ratio of wave functions
+      for (int iq = 0; iq < component.psiratio.size(); iq++)
+      {
+        W.makeMoveWithSpin(job.electron_id, component.deltaV[iq], component.deltaS[iq]);
+        component.psiratio[iq] = psi.calcRatio(W, job.electron_id);
+        W.rejectMove(job.electron_id);
+        psi.resetPhaseDiff();
+      }
+    }
   }
-  sint += RealType(1. / 3.) * dS * getAngularIntegral(sold, smin, W, Psi, iel, r, dr);
-  sint += RealType(1. / 3.) * dS * getAngularIntegral(sold, smax, W, Psi, iel, r, dr);
 
-  RealType pairpot = std::real(sint) / TWOPI;
-  return pairpot;
+  for (size_t i = 0; i < p_list.size(); i++)
+  {
+    SOECPComponent& component(soecp_component_list[i]);
+    const NLPPJob<RealType>& job = joblist[i];
+    pairpots[i] =
+        component.calculateProjector(job.ion_elec_dist, job.ion_elec_displ, p_list[i].spins[job.electron_id]);
+  }
 }
 
 void SOECPComponent::randomize_grid(RandomGenerator& myRNG)
@@ -15,10 +15,12 @@
 #define QMCPLUSPLUS_SO_ECPOTENTIAL_COMPONENT_H
 #include "QMCHamiltonians/OperatorBase.h"
 #include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "Particle/VirtualParticleSet.h"
 #include "Numerics/OneDimGridBase.h"
 #include "Numerics/OneDimGridFunctor.h"
 #include "Numerics/OneDimLinearSpline.h"
 #include "Numerics/OneDimCubicSpline.h"
+#include "QMCHamiltonians/NLPPJob.h"
 
 namespace qmcplusplus
 {
@@ -48,21 +50,29 @@ private:
   ///Angular momentum map
   aligned_vector<int> angpp_m;
   ///Non-Local part of the pseudo-potential
-  std::vector<RadialPotentialType*> sopp_m;
+  std::vector<std::shared_ptr<const RadialPotentialType>> sopp_m;
 
   ComplexType sMatrixElements(RealType s1, RealType s2, int dim);
   ComplexType lmMatrixElements(int l, int m1, int m2, int dim);
   int kroneckerDelta(int x, int y);
 
-  ComplexType getAngularIntegral(RealType sold,
-                                 RealType snew,
-                                 ParticleSet& W,
-                                 TrialWaveFunction& Psi,
-                                 int iel,
-                                 RealType r,
-                                 const PosType& dr);
+  /** build the spatial and spin displacements of all the quadrature points.
+   * The spin knots are the outer index and the angular knots the inner one.
+   * @param r the distance between the ion and the electron
+   * @param dr displacement from the ion to the electron
+   * @param sold the spin of the electron
+   */
+  void buildTotalQuadrature(RealType r, const PosType& dr, RealType sold);
+
+  /** contract the wave function ratios at all the quadrature points with the projector
+   * @return the spin-orbit pair potential
+   */
+  RealType calculateProjector(RealType r, const PosType& dr, RealType sold);
 
+  ///virtual particle set holding all the quadrature points, nknot * (sknot + 1)
+  VirtualParticleSet* VP;
   std::vector<PosType> deltaV;
+  std::vector<RealType> deltaS;
   SpherGridType sgridxyz_m;
   SpherGridType rrotsgrid_m;
   std::vector<ValueType> psiratio;
@@ -101,6 +111,23 @@ public:
    */
   RealType evaluateOne(ParticleSet& W, int iat, TrialWaveFunction& Psi, int iel, RealType r, const PosType& dr);
 
+  /** @brief Evaluate the spin orbit pp contribution of a batch of ion-electron pairs,
+   * one per walker. The ratios of all the spatial and spin quadrature points are computed in one batched call.
+   *
+   * @param soecp_component_list a list of SOECPComponent of the walkers
+   * @param p_list a list of electron particle set
+   * @param psi_list a list of trial wave function object
+   * @param joblist a list of ion-electron pairs
+   * @param pairpots the contributions, one per walker
+   * @param collection the resource collection holding the virtual particle set resource
+   */
+  static void mw_evaluateOne(const RefVectorWithLeader<SOECPComponent>& soecp_component_list,
+                             const RefVectorWithLeader<ParticleSet>& p_list,
+                             const RefVectorWithLeader<TrialWaveFunction>& psi_list,
+                             const RefVector<const NLPPJob<RealType>>& joblist,
+                             std::vector<RealType>& pairpots,
+                             ResourceCollection& collection);
+
   // This function needs to be updated to SoA. myTableIndex is introduced temporarily.
   inline RealType evaluateValueAndDerivatives(ParticleSet& P,
                                               int iat,
@@ -116,7 +143,8 @@ public:
 
   void print(std::ostream& os);
 
-  //void initVirtualParticle(const ParticleSet& qp){};
+  void initVirtualParticle(const ParticleSet& qp);
+  void deleteVirtualParticle();
 
   inline void setRmax(int rmax) { Rmax = rmax; }
   inline RealType getRmax() const { return Rmax; }
@@ -125,6 +153,8 @@ public:
   inline int getNknot() const { return nknot; }
   inline int getSknot() const { return sknot; }
 
+  const VirtualParticleSet* getVP() const { return VP; };
+
   friend struct ECPComponentBuilder;
   friend void copyGridUnrotatedForTest(SOECPComponent& nlpp);
 };
@@ -12,9 +12,19 @@
 #include "Particle/DistanceTable.h"
 #include "SOECPotential.h"
 #include "Utilities/IteratorUtility.h"
+#include "ResourceCollection.h"
 
 namespace qmcplusplus
 {
+struct SOECPotentialMultiWalkerResource : public Resource
+{
+  SOECPotentialMultiWalkerResource() : Resource("SOECPotential"), collection("SOPPcollection") {}
+
+  Resource* makeClone() const override { return new SOECPotentialMultiWalkerResource(*this); }
+
+  ResourceCollection collection;
+};
+
 /** constructor
  *\param ionic positions
  *\param els electronic poitions
@@ -29,8 +39,11 @@ SOECPotential::SOECPotential(ParticleSet& ions, ParticleSet& els, TrialWaveFunct
   NumIons      = ions.getTotalNum();
   PP.resize(NumIons, nullptr);
   PPset.resize(IonConfig.getSpeciesSet().getTotalNum());
+  sopp_jobs_.reserve(2 * els.getTotalNum());
 }
 
+SOECPotential::~SOECPotential() = default;
+
 void SOECPotential::resetTargetParticleSet(ParticleSet& P) {}
 
 SOECPotential::Return_t SOECPotential::evaluate(ParticleSet& P)
@@ -62,6 +75,112 @@ SOECPotential::Return_t SOECPotential::evaluate(ParticleSet& P)
   return value_;
 }
 
+void SOECPotential::mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                                const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                const RefVectorWithLeader<ParticleSet>& p_list) const
+{
+  auto& O_leader           = o_list.getCastedLeader<SOECPotential>();
+  ParticleSet& pset_leader = p_list.getLeader();
+  const size_t nw          = o_list.size();
+
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    auto& O = o_list.getCastedElement<SOECPotential>(iw);
+    const ParticleSet& P(p_list[iw]);
+
+    for (int ipp = 0; ipp < O.PPset.size(); ipp++)
+      if (O.PPset[ipp])
+        O.PPset[ipp]->randomize_grid(*O.myRNG);
+
+    const auto& myTable = P.getDistTableAB(O.myTableIndex);
+    for (int iat = 0; iat < O.NumIons; iat++)
+      O.IonNeighborElecs.getNeighborList(iat).clear();
+    for (int jel = 0; jel < P.getTotalNum(); jel++)
+      O.ElecNeighborIons.getNeighborList(jel).clear();
+
+    O.sopp_jobs_.clear();
+    for (int jel = 0; jel < P.getTotalNum(); jel++)
+    {
+      const auto& dist               = myTable.getDistRow(jel);
+      const auto& displ              = myTable.getDisplRow(jel);
+      std::vector<int>& NeighborIons = O.ElecNeighborIons.getNeighborList(jel);
+      for (int iat = 0; iat < O.NumIons; iat++)
+        if (O.PP[iat] != nullptr && dist[iat] < O.PP[iat]->getRmax())
+        {
+          NeighborIons.push_back(iat);
+          O.IonNeighborElecs.getNeighborList(iat).push_back(jel);
+          O.sopp_jobs_.emplace_back(iat, jel, P.R[jel], dist[iat], -displ[iat]);
+        }
+    }
+
+    O.value_ = 0.0;
+  }
+
+  // make this class unit tests friendly without the need of setup resources.
+  if (!O_leader.mw_res_)
+  {
+    app_warning() << "SOECPotential: This message should not be seen in production (performance bug) runs "
+                     "but only unit tests (expected)."
+                  << std::endl;
+    O_leader.mw_res_ = std::make_unique<SOECPotentialMultiWalkerResource>();
+    for (int ig = 0; ig < O_leader.PPset.size(); ++ig)
+      if (O_leader.PPset[ig] && O_leader.PPset[ig]->getVP())
+      {
+        O_leader.PPset[ig]->getVP()->createResource(O_leader.mw_res_->collection);
+        break;
+      }
+  }
+
+  auto pp_component = std::find_if(O_leader.PPset.begin(), O_leader.PPset.end(), [](auto& ptr) { return bool(ptr); });
+  assert(pp_component != std::end(O_leader.PPset));
+
+  RefVector<SOECPotential> soecp_potential_list;
+  RefVectorWithLeader<SOECPComponent> soecp_component_list(**pp_component);
+  RefVectorWithLeader<ParticleSet> pset_list(pset_leader);
+  RefVectorWithLeader<TrialWaveFunction> psi_list(wf_list.getLeader());
+  RefVector<const NLPPJob<RealType>> batch_list;
+  std::vector<RealType> pairpots(nw);
+
+  soecp_potential_list.reserve(nw);
+  soecp_component_list.reserve(nw);
+  pset_list.reserve(nw);
+  psi_list.reserve(nw);
+  batch_list.reserve(nw);
+
+  // find the max number of jobs of all the walkers
+  size_t max_num_jobs = 0;
+  for (size_t iw = 0; iw < nw; iw++)
+    max_num_jobs = std::max(max_num_jobs, o_list.getCastedElement<SOECPotential>(iw).sopp_jobs_.size());
+
+  for (size_t jobid = 0; jobid < max_num_jobs; jobid++)
+  {
+    soecp_potential_list.clear();
+    soecp_component_list.clear();
+    pset_list.clear();
+    psi_list.clear();
+    batch_list.clear();
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      auto& O = o_list.getCastedElement<SOECPotential>(iw);
+      if (jobid < O.sopp_jobs_.size())
+      {
+        const auto& job = O.sopp_jobs_[jobid];
+        soecp_potential_list.push_back(O);
+        soecp_component_list.push_back(*O.PP[job.ion_id]);
+        pset_list.push_back(p_list[iw]);
+        psi_list.push_back(wf_list[iw]);
+        batch_list.push_back(job);
+      }
+    }
+
+    SOECPComponent::mw_evaluateOne(soecp_component_list, pset_list, psi_list, batch_list, pairpots,
+                                   O_leader.mw_res_->collection);
+
+    for (size_t j = 0; j < soecp_potential_list.size(); j++)
+      soecp_potential_list[j].get().value_ += pairpots[j];
+  }
+}
+
 std::unique_ptr<OperatorBase> SOECPotential::makeClone(ParticleSet& qp, TrialWaveFunction& psi)
 {
   std::unique_ptr<SOECPotential> myclone = std::make_unique<SOECPotential>(IonConfig, qp, psi);
@@ -79,4 +198,33 @@ void SOECPotential::addComponent(int groupID, std::unique_ptr<SOECPComponent>&&
   PPset[groupID] = std::move(ppot);
 }
 
+void SOECPotential::createResource(ResourceCollection& collection) const
+{
+  auto new_res = std::make_unique<SOECPotentialMultiWalkerResource>();
+  for (int ig = 0; ig < PPset.size(); ++ig)
+    if (PPset[ig] && PPset[ig]->getVP())
+    {
+      PPset[ig]->getVP()->createResource(new_res->collection);
+      break;
+    }
+  collection.addResource(std::move(new_res));
+}
+
+void SOECPotential::acquireResource(ResourceCollection& collection,
+                                    const RefVectorWithLeader<OperatorBase>& o_list) const
+{
+  auto& O_leader = o_list.getCastedLeader<SOECPotential>();
+  auto res_ptr   = dynamic_cast<SOECPotentialMultiWalkerResource*>(collection.lendResource().release());
+  if (!res_ptr)
+    throw std::runtime_error("SOECPotential::acquireResource dynamic_cast failed");
+  O_leader.mw_res_.reset(res_ptr);
+}
+
+void SOECPotential::releaseResource(ResourceCollection& collection,
+                                    const RefVectorWithLeader<OperatorBase>& o_list) const
+{
+  auto& O_leader = o_list.getCastedLeader<SOECPotential>();
+  collection.takebackResource(std::move(O_leader.mw_res_));
+}
+
 } // namespace qmcplusplus
@@ -17,15 +17,23 @@
 
 namespace qmcplusplus
 {
+struct SOECPotentialMultiWalkerResource;
+
 class SOECPotential : public OperatorBase
 {
 public:
   SOECPotential(ParticleSet& ions, ParticleSet& els, TrialWaveFunction& psi);
 
+  ~SOECPotential() override;
+
   void resetTargetParticleSet(ParticleSet& P) override;
 
   Return_t evaluate(ParticleSet& P) override;
 
+  void mw_evaluate(const RefVectorWithLeader<OperatorBase>& o_list,
+                   const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list) const override;
+
   bool put(xmlNodePtr cur) override { return true; }
 
   bool get(std::ostream& os) const override
@@ -40,6 +48,18 @@ public:
 
   void setRandomGenerator(RandomGenerator* rng) override { myRNG = rng; }
 
+  /** initialize a shared resource and hand it to a collection
+   */
+  void createResource(ResourceCollection& collection) const override;
+
+  /** acquire a shared resource from a collection
+   */
+  void acquireResource(ResourceCollection& collection, const RefVectorWithLeader<OperatorBase>& o_list) const override;
+
+  /** return a shared resource to a collection
+   */
+  void releaseResource(ResourceCollection& collection, const RefVectorWithLeader<OperatorBase>& o_list) const override;
+
 protected:
   RandomGenerator* myRNG;
   std::vector<SOECPComponent*> PP;
@@ -58,6 +78,10 @@ private:
   NeighborLists ElecNeighborIons;
   ///neighborlist of ions
   NeighborLists IonNeighborElecs;
+  ///ion-electron pairs within the cutoff of the SO pseudopotentials
+  std::vector<NLPPJob<RealType>> sopp_jobs_;
+  ///multi walker shared resource
+  std::unique_ptr<SOECPotentialMultiWalkerResource> mw_res_;
 };
 } // namespace qmcplusplus
 
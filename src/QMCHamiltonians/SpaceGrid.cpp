@@ -819,11 +819,12 @@ void SpaceGrid::registerCollectables(std::vector<ObservableHelper>& h5desc, hid_
 #define SPACEGRID_CHECK
 
 
-void SpaceGrid::evaluate(const ParticlePos& R,
-                         const Matrix<RealType>& values,
-                         BufferType& buf,
-                         std::vector<bool>& particles_outside,
-                         const DistanceTableAB& dtab)
+template<typename BUF>
+void SpaceGrid::evaluateInto(const ParticlePos& R,
+                             const Matrix<RealType>& values,
+                             BUF& buf,
+                             std::vector<bool>& particles_outside,
+                             const DistanceTableAB* dtab)
 {
   int p, v;
   int nparticles = values.size1();
@@ -913,7 +914,7 @@ void SpaceGrid::evaluate(const ParticlePos& R,
       RealType dist;
       for (p = 0; p < ndparticles; p++)
       {
-        const auto& dist = dtab.getDistRow(p);
+        const auto& dist = dtab->getDistRow(p);
         for (nd = 0; nd < ndomains; nd++)
           if (dist[nd] < nearcell[p].r)
           {
@@ -1068,6 +1069,24 @@ void SpaceGrid::evaluate(const ParticlePos& R,
   }
 }
 
+void SpaceGrid::evaluate(const ParticlePos& R,
+                         const Matrix<RealType>& values,
+                         BufferType& buf,
+                         std::vector<bool>& particles_outside,
+                         const DistanceTableAB& dtab)
+{
+  evaluateInto(R, values, buf, particles_outside, &dtab);
+}
+
+void SpaceGrid::evaluate(const ParticlePos& R,
+                         const Matrix<RealType>& values,
+                         std::vector<RealType>& buf,
+                         std::vector<bool>& particles_outside,
+                         const DistanceTableAB* dtab)
+{
+  evaluateInto(R, values, buf, particles_outside, dtab);
+}
+
 
 void SpaceGrid::sum(const BufferType& buf, RealType* vals)
 {
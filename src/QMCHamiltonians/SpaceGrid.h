@@ -55,6 +55,14 @@ public:
                 BufferType& buf,
                 std::vector<bool>& particles_outside,
                 const DistanceTableAB& dtab);
+  /** accumulate into a vector laid out as the buffer allocated by allocate_buffer_space
+   * @param dtab distance table from the static particles, only used by voronoi grids
+   */
+  void evaluate(const ParticlePos& R,
+                const Matrix<RealType>& values,
+                std::vector<RealType>& buf,
+                std::vector<bool>& particles_outside,
+                const DistanceTableAB* dtab);
 
   bool check_grid(void);
   inline int nDomains(void) { return ndomains; }
@@ -122,6 +130,14 @@ public:
 
   //used only in evaluate
   Point u, ub;
+
+private:
+  template<typename BUF>
+  void evaluateInto(const ParticlePos& R,
+                    const Matrix<RealType>& values,
+                    BUF& buf,
+                    std::vector<bool>& particles_outside,
+                    const DistanceTableAB* dtab);
 };
 
 
@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "Particle/ParticleSet.h"
+#include "QMCHamiltonians/MPC.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+
+namespace qmcplusplus
+{
+namespace testing
+{
+class MPCTest : public MPC
+{
+public:
+  using MPC::MPC;
+  using MPC::evalLRPoints;
+  using MPC::VlongSpline;
+};
+} // namespace testing
+
+TEST_CASE("MPC mw_evaluate", "[hamiltonian]")
+{
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> lattice;
+  lattice.BoxBConds = true; // periodic
+  lattice.R.diagonal(4.0);
+  lattice.reset();
+
+  const SimulationCell simulation_cell(lattice);
+  ParticleSet elec(simulation_cell);
+
+  elec.setName("elec");
+  elec.create({2, 1});
+  elec.R[0] = {0.5, 0.0, 0.0};
+  elec.R[1] = {0.0, 1.5, 0.3};
+  elec.R[2] = {1.2, 0.4, 3.9};
+
+  SpeciesSet& tspecies         = elec.getSpeciesSet();
+  int upIdx                    = tspecies.addSpecies("u");
+  int downIdx                  = tspecies.addSpecies("d");
+  int chargeIdx                = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx)   = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+
+  // the uniform density plus the first shell of G-vectors of a real density
+  const ParticleSet::RealType rho0 = 3.0 / lattice.Volume;
+  elec.DensityReducedGvecs.push_back({0, 0, 0});
+  elec.Density_G.push_back(rho0);
+  const std::vector<ParticleSet::ComplexType> rho_G{{0.1 * rho0, 0.05 * rho0}, {-0.2 * rho0, 0.0}, {0.0, 0.1 * rho0}};
+  for (int idim = 0; idim < OHMMS_DIM; idim++)
+  {
+    TinyVector<int, OHMMS_DIM> gint(0);
+    gint[idim] = 1;
+    elec.DensityReducedGvecs.push_back(gint);
+    elec.Density_G.push_back(rho_G[idim]);
+    elec.DensityReducedGvecs.push_back(-gint);
+    elec.Density_G.push_back(std::conj(rho_G[idim]));
+  }
+
+  // only the first shell is below the cutoff
+  testing::MPCTest mpc(elec, 2.0);
+  elec.update();
+
+  // evalLRPoints against eval_UBspline_3d_d including points near the cell boundaries
+  const std::vector<TinyVector<double, OHMMS_DIM>> points{{0.0, 0.0, 0.0},
+                                                          {0.1, 0.7, 0.35},
+                                                          {0.999, 0.5, 0.01},
+                                                          {0.25, 0.999999, 0.75},
+                                                          {0.6, 0.3, 0.9}};
+  const size_t n = points.size();
+  std::vector<double> u(OHMMS_DIM * n), vals(n);
+  for (size_t i = 0; i < n; i++)
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      u[idim * n + i] = points[i][idim];
+  mpc.evalLRPoints(n, u.data(), vals.data());
+  for (size_t i = 0; i < n; i++)
+  {
+    double ref;
+    eval_UBspline_3d_d(mpc.VlongSpline.get(), points[i][0], points[i][1], points[i][2], &ref);
+    CHECK(vals[i] == Approx(ref));
+  }
+
+  ParticleSet elec2(elec);
+  elec2.R[1] = {2.1, 0.2, 1.1};
+  elec2.update();
+
+  TrialWaveFunction psi;
+  auto mpc2 = mpc.makeClone(elec2, psi);
+
+  RefVectorWithLeader<OperatorBase> o_list(mpc, {mpc, *mpc2});
+  RefVectorWithLeader<TrialWaveFunction> wf_list(psi, {psi, psi});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  mpc.mw_evaluate(o_list, wf_list, p_list);
+
+  const auto mw_value  = mpc.getValue();
+  const auto mw_value2 = mpc2->getValue();
+  CHECK(mw_value == Approx(mpc.evaluate(elec)));
+  CHECK(mw_value2 == Approx(mpc2->evaluate(elec2)));
+  CHECK(mw_value != Approx(mw_value2));
+}
+
+} // namespace qmcplusplus
@@ -95,4 +95,72 @@ TEST_CASE("ObservableHelper::ObservableHelper()", "[hamiltonian]")
   H5Fclose(hFile);
 }
 
+TEST_CASE("ObservableHelper chunked compressed layout", "[hamiltonian]")
+{
+  hid_t hFile = H5Fcreate("tmp_ObservableHelper3.h5", H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+
+  std::vector<value_type> data(20);
+  {
+    ObservableHelper oh("u");
+    std::vector<int> dims = {4, 5};
+    oh.set_dimensions(dims, 0);
+    oh.layout.chunk_blocks      = 3;
+    oh.layout.compression       = "gzip";
+    oh.layout.chunk_cache_bytes = 1024 * 1024;
+    oh.open(hFile);
+    for (int block = 0; block < 7; ++block)
+    {
+      for (int i = 0; i < data.size(); ++i)
+        data[i] = block * 100 + i;
+      oh.write(data.data(), 0);
+    }
+  }
+
+  hid_t dset = H5Dopen2(hFile, "u/value", H5P_DEFAULT);
+  REQUIRE(dset >= 0);
+  hid_t space = H5Dget_space(dset);
+  hsize_t dims[3];
+  REQUIRE(H5Sget_simple_extent_ndims(space) == 3);
+  H5Sget_simple_extent_dims(space, dims, nullptr);
+  CHECK(dims[0] == 7);
+  CHECK(dims[1] == 4);
+  CHECK(dims[2] == 5);
+
+  hid_t dcpl = H5Dget_create_plist(dset);
+  CHECK(H5Pget_layout(dcpl) == H5D_CHUNKED);
+  hsize_t chunk[3];
+  H5Pget_chunk(dcpl, 3, chunk);
+  CHECK(chunk[0] == 3);
+  CHECK(chunk[1] == 4);
+  CHECK(chunk[2] == 5);
+  if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+  {
+    bool has_deflate = false;
+    for (int i = 0; i < H5Pget_nfilters(dcpl); ++i)
+    {
+      unsigned int flags;
+      size_t nelmts = 0;
+      if (H5Pget_filter2(dcpl, i, &flags, &nelmts, nullptr, 0, nullptr, nullptr) == H5Z_FILTER_DEFLATE)
+        has_deflate = true;
+    }
+    CHECK(has_deflate);
+  }
+
+  // the last block reads back unchanged
+  hsize_t offset[3] = {6, 0, 0};
+  hsize_t count[3]  = {1, 4, 5};
+  H5Sselect_hyperslab(space, H5S_SELECT_SET, offset, nullptr, count, nullptr);
+  hid_t memspace = H5Screate_simple(3, count, nullptr);
+  std::vector<double> last(20);
+  H5Dread(dset, H5T_NATIVE_DOUBLE, memspace, space, H5P_DEFAULT, last.data());
+  for (int i = 0; i < last.size(); ++i)
+    CHECK(last[i] == Approx(600 + i));
+
+  H5Sclose(memspace);
+  H5Pclose(dcpl);
+  H5Sclose(space);
+  H5Dclose(dset);
+  H5Fclose(hFile);
+}
+
 } // namespace qmcplusplus
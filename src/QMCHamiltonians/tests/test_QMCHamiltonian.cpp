@@ -13,6 +13,7 @@
 #include "catch.hpp"
 
 #include "type_traits/template_types.hpp"
+#include "OhmmsData/Libxml2Doc.h"
 #include "QMCHamiltonians/QMCHamiltonian.h"
 #include "Particle/tests/MinimalParticlePool.h"
 #include "QMCWaveFunctions/tests/MinimalWaveFunctionPool.h"
@@ -45,4 +46,36 @@ TEST_CASE("QMCHamiltonian::flex_evaluate", "[hamiltonian]")
   //TODO: Would be nice to check some values but I think the system needs a little more setup
 }
 
+TEST_CASE("OperatorEvaluationSchedule", "[hamiltonian]")
+{
+  OperatorEvaluationSchedule always;
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString("<estimator type=\"specieskinetic\" name=\"skinetic\"/>"));
+  CHECK(!always.put(doc.getRoot()));
+  CHECK(always.isAlways());
+  CHECK(always.isDue(0, 4, false));
+  CHECK(always.isDue(1, 4, true));
+
+  OperatorEvaluationSchedule periodic;
+  REQUIRE(doc.parseFromString("<estimator type=\"specieskinetic\" name=\"skinetic\" evaluate_period=\"2\"/>"));
+  CHECK(periodic.put(doc.getRoot()));
+  CHECK(!periodic.isDue(0, 4, true));
+  CHECK(periodic.isDue(1, 4, true));
+  CHECK(!periodic.isDue(1, 4, false));
+  CHECK(periodic.isDue(3, 4, true));
+
+  OperatorEvaluationSchedule accumulated;
+  REQUIRE(doc.parseFromString("<estimator type=\"specieskinetic\" name=\"skinetic\" evaluate=\"accumulate\"/>"));
+  CHECK(accumulated.put(doc.getRoot()));
+  CHECK(!accumulated.isDue(0, 4, false));
+  CHECK(accumulated.isDue(0, 4, true));
+
+  OperatorEvaluationSchedule block_end;
+  REQUIRE(doc.parseFromString("<estimator type=\"specieskinetic\" name=\"skinetic\" evaluate=\"block\"/>"));
+  CHECK(block_end.put(doc.getRoot()));
+  CHECK(!block_end.isDue(2, 4, true));
+  CHECK(block_end.isDue(3, 4, true));
+  CHECK(!block_end.isDue(3, 4, false));
+}
+
 } // namespace qmcplusplus
@@ -89,6 +89,40 @@ TEST_CASE("Bare Kinetic Energy", "[hamiltonian]")
   REQUIRE(v == -0.5);
 }
 
+TEST_CASE("Bare Kinetic Energy mw_evaluate", "[hamiltonian]")
+{
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+  elec.setName("elec");
+  elec.create({1, 1});
+
+  SpeciesSet& tspecies       = elec.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int downIdx                = tspecies.addSpecies("d");
+  int massIdx                = tspecies.addAttribute("mass");
+  tspecies(massIdx, upIdx)   = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+  ParticleSet elec2(elec);
+
+  TrialWaveFunction psi;
+  BareKineticEnergy bare_ke(elec);
+  auto bare_ke2 = bare_ke.makeClone(elec2, psi);
+
+  elec.L[0]     = 1.0;
+  elec.L[1]     = 0.5;
+  elec.G[0][0]  = 1.0;
+  elec2.L[0]    = -1.0;
+  elec2.L[1]    = 0.0;
+  elec2.G[1][2] = 2.0;
+
+  RefVectorWithLeader<OperatorBase> o_list(bare_ke, {bare_ke, *bare_ke2});
+  RefVectorWithLeader<TrialWaveFunction> wf_list(psi, {psi, psi});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  bare_ke.mw_evaluate(o_list, wf_list, p_list);
+  CHECK(bare_ke.getValue() == Approx(-1.25));
+  CHECK(bare_ke2->getValue() == Approx(-1.5));
+}
+
 TEST_CASE("Bare KE Pulay PBC", "[hamiltonian]")
 {
   using RealType  = QMCTraits::RealType;
@@ -16,6 +16,7 @@
 #include "OhmmsPETE/OhmmsMatrix.h"
 #include "Particle/ParticleSet.h"
 #include "QMCHamiltonians/CoulombPBCAA.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
 
 
 #include <stdio.h>
@@ -110,6 +111,20 @@ TEST_CASE("Coulomb PBC A-A BCC H", "[hamiltonian]")
   double val = caa.evaluate(elec);
   CHECK(val == Approx(-0.9628996199)); // not validated
 
+  // the per particle energies of the static ions add up to the energy
+  Vector<CoulombPBCAA::Return_t> e_dynamic, e_static(ions.getTotalNum());
+  CHECK(caa.evaluatePerParticle(elec, "ion", e_dynamic, e_static));
+  CHECK(e_static[0] == Approx(e_static[1]));
+  CHECK(e_static[0] + e_static[1] == Approx(val));
+
+  // the table of the static ions is evaluated lazily
+  const auto& ii_table = ions.getDistTableAA(0);
+  CHECK(ii_table.getModes() & DTModes::LAZY_FULL_TABLE);
+  ions.update();
+  CHECK(!ii_table.isRowCurrent(1));
+  CHECK(ii_table.getDistRow(1)[0] == Approx(std::sqrt(3.0) * 1.88972614));
+  CHECK(ii_table.isRowCurrent(1));
+
   // supercell Madelung energy
   val = caa.MC0;
   CHECK(val == Approx(vmad_sc));
@@ -200,4 +215,115 @@ TEST_CASE("Coulomb PBC A-A BCC", "[hamiltonian]")
 }
 
 
+TEST_CASE("Coulomb PBC A-A mw_evaluate", "[hamiltonian]")
+{
+  LRCoulombSingleton::CoulombHandler = 0;
+
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> lattice;
+  lattice.BoxBConds = true; // periodic
+  lattice.R.diagonal(3.77945227);
+  lattice.reset();
+
+  const SimulationCell simulation_cell(lattice);
+  ParticleSet elec(simulation_cell);
+
+  elec.setName("elec");
+  elec.create({2, 1});
+  elec.R[0] = {0.5, 0.0, 0.0};
+  elec.R[1] = {0.0, 1.5, 0.3};
+  elec.R[2] = {1.2, 0.4, 2.9};
+
+  SpeciesSet& tspecies              = elec.getSpeciesSet();
+  int upIdx                         = tspecies.addSpecies("u");
+  int downIdx                       = tspecies.addSpecies("d");
+  int chargeIdx                     = tspecies.addAttribute("charge");
+  int pMembersizeIdx                = tspecies.addAttribute("membersize");
+  tspecies(pMembersizeIdx, upIdx)   = 2;
+  tspecies(pMembersizeIdx, downIdx) = 1;
+  tspecies(chargeIdx, upIdx)        = -1;
+  tspecies(chargeIdx, downIdx)      = -1;
+
+  elec.createSK();
+  elec.update();
+
+  CoulombPBCAA caa(elec, true);
+  elec.update();
+
+  ParticleSet elec2(elec);
+  elec2.R[1] = {2.1, 0.2, 1.1};
+  elec2.update();
+
+  TrialWaveFunction psi;
+  auto caa2 = caa.makeClone(elec2, psi);
+
+  RefVectorWithLeader<OperatorBase> o_list(caa, {caa, *caa2});
+  RefVectorWithLeader<TrialWaveFunction> wf_list(psi, {psi, psi});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  caa.mw_evaluate(o_list, wf_list, p_list);
+
+  const double val1 = caa.getValue();
+  const double val2 = caa2->getValue();
+  CHECK(val1 != Approx(val2));
+  CHECK(val1 == Approx(caa.evaluate(elec)));
+  CHECK(val2 == Approx(caa2->evaluate(elec2)));
+}
+
+TEST_CASE("Coulomb PBC A-A incremental short range", "[hamiltonian]")
+{
+  using PosType                      = QMCTraits::PosType;
+  LRCoulombSingleton::CoulombHandler = 0;
+
+  // skewed cell to exercise the image search of the old distances
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> lattice;
+  lattice.BoxBConds = true; // periodic
+  lattice.R         = 1.5;
+  lattice.R(0, 0)   = -1.5;
+  lattice.R(1, 1)   = -1.5;
+  lattice.R(2, 2)   = -1.5;
+  lattice.reset();
+
+  const SimulationCell simulation_cell(lattice);
+  ParticleSet elec(simulation_cell);
+
+  elec.setName("elec");
+  elec.create({4, 4});
+  for (int iat = 0; iat < elec.getTotalNum(); iat++)
+    elec.R[iat] = {0.37 * iat - 1.1, 0.29 * ((iat * 5) % 7) - 0.8, 0.13 * iat * iat - 1.3};
+
+  SpeciesSet& tspecies              = elec.getSpeciesSet();
+  int upIdx                         = tspecies.addSpecies("u");
+  int downIdx                       = tspecies.addSpecies("d");
+  int chargeIdx                     = tspecies.addAttribute("charge");
+  int pMembersizeIdx                = tspecies.addAttribute("membersize");
+  tspecies(pMembersizeIdx, upIdx)   = 4;
+  tspecies(pMembersizeIdx, downIdx) = 4;
+  tspecies(chargeIdx, upIdx)        = -1;
+  tspecies(chargeIdx, downIdx)      = -1;
+
+  elec.createSK();
+  elec.update();
+
+  CoulombPBCAA caa(elec, true);
+  REQUIRE(caa.enableIncrementalSR());
+  elec.update();
+
+  CHECK(caa.evalSRIncremental(elec) == Approx(caa.evalSR(elec)));
+  // nothing moved
+  CHECK(caa.evalSRIncremental(elec) == Approx(caa.evalSR(elec)));
+
+  // one particle
+  elec.R[3] += PosType(0.4, -0.3, 0.9);
+  elec.update();
+  CHECK(caa.evalSRIncremental(elec) == Approx(caa.evalSR(elec)));
+
+  // two particles, the pair between them is updated once
+  elec.R[1] += PosType(-0.2, 0.6, 0.1);
+  elec.R[6] += PosType(1.1, 0.2, -0.7);
+  elec.update();
+  CHECK(caa.evalSRIncremental(elec) == Approx(caa.evalSR(elec)));
+
+  const double val = caa.evaluate(elec);
+  CHECK(val == Approx(caa.evalLR(elec) + caa.evalSR(elec) + caa.myConst));
+}
+
 } // namespace qmcplusplus
@@ -17,8 +17,10 @@
 #include "Particle/ParticleSet.h"
 #include "QMCHamiltonians/CoulombPBCAB.h"
 #include "QMCHamiltonians/CoulombPBCAA.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
 
 
+#include <numeric>
 #include <stdio.h>
 #include <string>
 
@@ -158,6 +160,19 @@ TEST_CASE("Coulomb PBC A-B BCC H", "[hamiltonian]")
   double val_ei = cab.evaluate(elec);
   REQUIRE(val_ei == Approx(-2.219665062 + 0.0267892759 * 4)); // not validated
 
+  // split between the electrons and the static ions, or all on the electrons
+  using Return_t = CoulombPBCAB::Return_t;
+  Vector<Return_t> e_dynamic(elec.getTotalNum()), e_static(ions.getTotalNum());
+  CHECK(cab.evaluatePerParticle(elec, "ion", e_dynamic, e_static));
+  CHECK(std::accumulate(e_dynamic.begin(), e_dynamic.end(), Return_t(0)) +
+            std::accumulate(e_static.begin(), e_static.end(), Return_t(0)) ==
+        Approx(val_ei));
+  e_dynamic = 0.0;
+  e_static  = 0.0;
+  CHECK(cab.evaluatePerParticle(elec, "", e_dynamic, e_static));
+  CHECK(std::accumulate(e_dynamic.begin(), e_dynamic.end(), Return_t(0)) == Approx(val_ei));
+  CHECK(e_static[0] == 0.0);
+
 
   CoulombPBCAA caa_elec = CoulombPBCAA(elec, false);
   CoulombPBCAA caa_ion  = CoulombPBCAA(ions, false);
@@ -168,4 +183,76 @@ TEST_CASE("Coulomb PBC A-B BCC H", "[hamiltonian]")
                                         // -3.14349127313640
 }
 
+TEST_CASE("Coulomb PBC A-B mw_evaluate", "[hamiltonian]")
+{
+  LRCoulombSingleton::CoulombHandler = 0;
+
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> lattice;
+  lattice.BoxBConds = true; // periodic
+  lattice.R.diagonal(3.77945227);
+  lattice.reset();
+
+  const SimulationCell simulation_cell(lattice);
+  ParticleSet ions(simulation_cell);
+  ParticleSet elec(simulation_cell);
+
+  ions.setName("ion");
+  ions.create({1, 1});
+  ions.R[0] = {0.0, 0.0, 0.0};
+  ions.R[1] = {1.88972614, 1.88972614, 1.88972614};
+
+  SpeciesSet& ion_species            = ions.getSpeciesSet();
+  int pIdx                           = ion_species.addSpecies("H");
+  int heIdx                          = ion_species.addSpecies("He");
+  int pChargeIdx                     = ion_species.addAttribute("charge");
+  int pMembersizeIdx                 = ion_species.addAttribute("membersize");
+  ion_species(pChargeIdx, pIdx)      = 1;
+  ion_species(pChargeIdx, heIdx)     = 2;
+  ion_species(pMembersizeIdx, pIdx)  = 1;
+  ion_species(pMembersizeIdx, heIdx) = 1;
+  ions.createSK();
+  ions.update();
+
+  elec.setName("elec");
+  elec.create({2, 1});
+  elec.R[0] = {0.5, 0.0, 0.0};
+  elec.R[1] = {0.0, 0.5, 0.0};
+  elec.R[2] = {1.2, 3.1, 0.7};
+
+  SpeciesSet& tspecies             = elec.getSpeciesSet();
+  int upIdx                        = tspecies.addSpecies("u");
+  int downIdx                      = tspecies.addSpecies("d");
+  int chargeIdx                    = tspecies.addAttribute("charge");
+  int MembersizeIdx                = tspecies.addAttribute("membersize");
+  tspecies(MembersizeIdx, upIdx)   = 2;
+  tspecies(MembersizeIdx, downIdx) = 1;
+  tspecies(chargeIdx, upIdx)       = -1;
+  tspecies(chargeIdx, downIdx)     = -1;
+
+  elec.resetGroups();
+  elec.createSK();
+  elec.addTable(ions);
+  elec.update();
+
+  CoulombPBCAB cab(ions, elec);
+
+  ParticleSet elec2(elec);
+  elec2.R[2] = {2.2, 0.3, 1.6};
+  elec2.update();
+
+  TrialWaveFunction psi;
+  auto cab2 = cab.makeClone(elec2, psi);
+
+  RefVectorWithLeader<OperatorBase> o_list(cab, {cab, *cab2});
+  RefVectorWithLeader<TrialWaveFunction> wf_list(psi, {psi, psi});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  cab.mw_evaluate(o_list, wf_list, p_list);
+
+  const double val1 = cab.getValue();
+  const double val2 = cab2->getValue();
+  CHECK(val1 != Approx(val2));
+  CHECK(val1 == Approx(cab.evaluate(elec)));
+  CHECK(val2 == Approx(cab2->evaluate(elec2)));
+}
+
 } // namespace qmcplusplus
@@ -17,7 +17,10 @@
 #include "Numerics/Quadrature.h"
 #include "QMCHamiltonians/ECPComponentBuilder.h"
 #include "QMCHamiltonians/NonLocalECPComponent.h"
+#include "QMCHamiltonians/NonLocalECPotential.h"
+#include "QMCHamiltonians/LocalECPotential.h"
 #include "QMCHamiltonians/SOECPComponent.h"
+#include "ResourceCollection.h"
 
 //for wavefunction
 #include "OhmmsData/Libxml2Doc.h"
@@ -442,6 +445,184 @@ TEST_CASE("Evaluate_ecp", "[hamiltonian]")
   //HFTerm[1][2]+PulayTerm[1][2] =  0.0
 }
 
+TEST_CASE("NonLocalECPotential pair sampling probabilities", "[hamiltonian]")
+{
+  using RealType = QMCTraits::RealType;
+  std::vector<RealType> probs;
+
+  // no more pairs than samples, all of them are taken
+  NonLocalECPotential::computeSamplingProbabilities({4.0, 1.0, 2.0}, 3, probs);
+  CHECK(probs == std::vector<RealType>{1.0, 1.0, 1.0});
+
+  // the two largest are taken with certainty, the others proportional to their weights
+  NonLocalECPotential::computeSamplingProbabilities({4.0, 1.0, 1.0, 2.0, 0.0}, 3, probs);
+  REQUIRE(probs.size() == 5);
+  CHECK(probs[0] == Approx(1.0));
+  CHECK(probs[1] == Approx(0.5));
+  CHECK(probs[2] == Approx(0.5));
+  CHECK(probs[3] == Approx(1.0));
+  CHECK(probs[4] == Approx(0.0));
+
+  // pairs of zero weight are never taken
+  NonLocalECPotential::computeSamplingProbabilities({0.0, 5.0, 0.0}, 2, probs);
+  CHECK(probs[0] == Approx(0.0));
+  CHECK(probs[1] == Approx(1.0));
+  CHECK(probs[2] == Approx(0.0));
+
+  // proportional to the weights when none of them dominates
+  NonLocalECPotential::computeSamplingProbabilities({1.0, 2.0, 3.0, 2.0}, 2, probs);
+  CHECK(probs[0] == Approx(0.25));
+  CHECK(probs[1] == Approx(0.5));
+  CHECK(probs[2] == Approx(0.75));
+  CHECK(probs[3] == Approx(0.5));
+}
+
+TEST_CASE("LocalECPotential mw_evaluate", "[hamiltonian]")
+{
+  using PosType = QMCTraits::PosType;
+
+  const SimulationCell simulation_cell;
+  ParticleSet ions(simulation_cell);
+  ParticleSet elec(simulation_cell);
+
+  ions.setName("ion0");
+  ions.create(2);
+  ions.R[1]                     = PosType(6.0, 0.0, 0.0);
+  SpeciesSet& ion_species       = ions.getSpeciesSet();
+  int pIdx                      = ion_species.addSpecies("Na");
+  int pChargeIdx                = ion_species.addAttribute("charge");
+  ion_species(pChargeIdx, pIdx) = 1;
+  ions.resetGroups();
+
+  elec.setName("e");
+  elec.create({1, 1});
+  elec.R[0]                    = PosType(2.0, 0.0, 0.0);
+  elec.R[1]                    = PosType(3.0, 0.5, 0.0);
+  SpeciesSet& tspecies         = elec.getSpeciesSet();
+  int upIdx                    = tspecies.addSpecies("u");
+  int downIdx                  = tspecies.addSpecies("d");
+  int chargeIdx                = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx)   = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  elec.resetGroups();
+
+  ECPComponentBuilder ecp("test_local_ecp", OHMMS::Controller);
+  REQUIRE(ecp.read_pp_file("Na.BFD.xml"));
+
+  TrialWaveFunction psi;
+  LocalECPotential local_ecp(ions, elec);
+  local_ecp.add(0, std::move(ecp.pp_loc), ecp.Zeff);
+
+  ParticleSet elec2(elec);
+  elec2.R[1] = PosType(5.0, 0.2, 0.1);
+  auto local_ecp2 = local_ecp.makeClone(elec2, psi);
+
+  ions.update();
+  elec.update();
+  elec2.update();
+  const double value  = local_ecp.evaluate(elec);
+  const double value2 = local_ecp2->evaluate(elec2);
+  CHECK(value != Approx(value2));
+
+  RefVectorWithLeader<OperatorBase> o_list(local_ecp, {local_ecp, *local_ecp2});
+  RefVectorWithLeader<TrialWaveFunction> wf_list(psi, {psi, psi});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  local_ecp.mw_evaluate(o_list, wf_list, p_list);
+  CHECK(local_ecp.getValue() == Approx(value));
+  CHECK(local_ecp2->getValue() == Approx(value2));
+}
+
+TEST_CASE("NonLocalECPotential mw_makeNonLocalMovesPbyP", "[hamiltonian]")
+{
+  using PosType = QMCTraits::PosType;
+
+  Communicate* c = OHMMS::Controller;
+
+  const SimulationCell simulation_cell;
+  ParticleSet ions(simulation_cell);
+  ParticleSet elec(simulation_cell);
+
+  ions.setName("ion0");
+  ions.create(2);
+  ions.R[1]                     = PosType(3.0, 0.0, 0.0);
+  SpeciesSet& ion_species       = ions.getSpeciesSet();
+  int pIdx                      = ion_species.addSpecies("Na");
+  int pChargeIdx                = ion_species.addAttribute("charge");
+  ion_species(pChargeIdx, pIdx) = 1;
+  ions.resetGroups();
+
+  elec.setName("e");
+  elec.create({1, 1});
+  elec.R[0]                    = PosType(0.4, 0.1, 0.0);
+  elec.R[1]                    = PosType(2.5, -0.2, 0.3);
+  SpeciesSet& tspecies         = elec.getSpeciesSet();
+  int upIdx                    = tspecies.addSpecies("u");
+  int downIdx                  = tspecies.addSpecies("d");
+  int chargeIdx                = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx)   = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  elec.resetGroups();
+
+  TrialWaveFunction psi;
+  const char* jastrow_xml = "<jastrow name=\"J2\" type=\"Two-Body\" function=\"Bspline\"> \
+      <correlation speciesA=\"u\" speciesB=\"d\" rcut=\"10\" size=\"4\"> \
+          <coefficients id=\"ud\" type=\"Array\"> 0.8 0.5 0.2 0.1</coefficients> \
+      </correlation> \
+  </jastrow>";
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(jastrow_xml));
+  RadialJastrowBuilder jastrow(c, elec);
+  psi.addComponent(jastrow.buildComponent(doc.getRoot()));
+
+  ECPComponentBuilder ecp("test_tmove_ecp", c);
+  REQUIRE(ecp.read_pp_file("Na.BFD.xml"));
+  NonLocalECPotential nlpp(ions, elec, psi, false, false);
+  nlpp.addComponent(0, std::move(ecp.pp_nonloc));
+
+  for (const std::string tmove : {"v0", "v1", "v3"})
+  {
+    INFO("non_local_move " << tmove);
+    // two walkers moved one at a time and the same two walkers moved in a batch
+    std::vector<std::unique_ptr<ParticleSet>> elecs;
+    std::vector<std::unique_ptr<TrialWaveFunction>> psis;
+    std::vector<std::unique_ptr<OperatorBase>> nlpps;
+    std::vector<std::unique_ptr<RandomGenerator>> rngs;
+    for (int i = 0; i < 4; i++)
+    {
+      elecs.push_back(std::make_unique<ParticleSet>(elec));
+      if (i % 2)
+        elecs.back()->R[1] = PosType(3.3, 0.4, -0.2);
+      psis.push_back(psi.makeClone(*elecs.back()));
+      nlpps.push_back(nlpp.makeClone(*elecs.back(), *psis.back()));
+      rngs.push_back(std::make_unique<RandomGenerator>(13 + i % 2));
+      auto& nlpp_clone = dynamic_cast<NonLocalECPotential&>(*nlpps.back());
+      nlpp_clone.setNonLocalMoves(tmove, 2.0, 0.0, 0.0);
+      nlpp_clone.setRandomGenerator(rngs.back().get());
+      ions.update();
+      elecs.back()->update();
+      psis.back()->evaluateLog(*elecs.back());
+      nlpp_clone.evaluateWithToperator(*elecs.back());
+    }
+
+    std::vector<int> num_accepts(2);
+    for (int iw = 0; iw < 2; iw++)
+      num_accepts[iw] = dynamic_cast<NonLocalECPotential&>(*nlpps[iw]).makeNonLocalMovesPbyP(*elecs[iw]);
+    CHECK(num_accepts[0] + num_accepts[1] > 0);
+
+    RefVectorWithLeader<NonLocalECPotential> o_list(dynamic_cast<NonLocalECPotential&>(*nlpps[2]));
+    RefVectorWithLeader<TrialWaveFunction> wf_list(*psis[2], {*psis[2], *psis[3]});
+    RefVectorWithLeader<ParticleSet> p_list(*elecs[2], {*elecs[2], *elecs[3]});
+    o_list.push_back(dynamic_cast<NonLocalECPotential&>(*nlpps[2]));
+    o_list.push_back(dynamic_cast<NonLocalECPotential&>(*nlpps[3]));
+    const std::vector<int> mw_num_accepts = NonLocalECPotential::mw_makeNonLocalMovesPbyP(o_list, wf_list, p_list);
+    CHECK(mw_num_accepts == num_accepts);
+    for (int iw = 0; iw < 2; iw++)
+      for (int iel = 0; iel < elec.getTotalNum(); iel++)
+        for (int idim = 0; idim < OHMMS_DIM; idim++)
+          CHECK(elecs[iw + 2]->R[iel][idim] == Approx(elecs[iw]->R[iel][idim]));
+  }
+}
+
 #ifdef QMC_COMPLEX
 TEST_CASE("Evaluate_soecp", "[hamiltonian]")
 {
@@ -573,6 +754,40 @@ TEST_CASE("Evaluate_soecp", "[hamiltonian]")
     }
   }
   REQUIRE(Value1 == Approx(-0.3214176962));
+
+  // all the spatial and spin quadrature points in a virtual particle set
+  sopp->initVirtualParticle(elec);
+  REQUIRE(sopp->getVP()->getTotalNum() == sopp->getNknot() * (sopp->getSknot() + 1));
+  RealType Value2 =
+      sopp->evaluateOne(elec, 0, psi, 0, myTable.getDistRow(0)[0], RealType(-1) * myTable.getDisplRow(0)[0]);
+  CHECK(Value2 == Approx(Value1));
+
+  // batched over two walkers, the second one with a different spin
+  ParticleSet elec2(elec);
+  elec2.spins[0] = 0.2;
+  elec2.update();
+  TrialWaveFunction psi2;
+  auto spinor_set2 = std::make_unique<SpinorSet>();
+  spinor_set2->set_spos(std::make_unique<EGOSet>(kup, k2up), std::make_unique<EGOSet>(kdn, k2dn));
+  psi2.addComponent(std::make_unique<DiracDeterminant<>>(std::move(spinor_set2), 0, nelec));
+  psi2.evaluateLog(elec2);
+  std::unique_ptr<SOECPComponent> sopp2(sopp->makeClone(elec2));
+  const auto& myTable2 = elec2.getDistTableAB(myTableIndex);
+  RealType Value3 =
+      sopp2->evaluateOne(elec2, 0, psi2, 0, myTable2.getDistRow(0)[0], RealType(-1) * myTable2.getDisplRow(0)[0]);
+
+  ResourceCollection collection("test_soecp");
+  sopp->getVP()->createResource(collection);
+  RefVectorWithLeader<SOECPComponent> sopp_list(*sopp, {*sopp, *sopp2});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  RefVectorWithLeader<TrialWaveFunction> psi_list(psi, {psi, psi2});
+  NLPPJob<RealType> job1(0, 0, elec.R[0], myTable.getDistRow(0)[0], RealType(-1) * myTable.getDisplRow(0)[0]);
+  NLPPJob<RealType> job2(0, 0, elec2.R[0], myTable2.getDistRow(0)[0], RealType(-1) * myTable2.getDisplRow(0)[0]);
+  RefVector<const NLPPJob<RealType>> job_list{job1, job2};
+  std::vector<RealType> pairpots(2);
+  SOECPComponent::mw_evaluateOne(sopp_list, p_list, psi_list, job_list, pairpots, collection);
+  CHECK(pairpots[0] == Approx(Value1));
+  CHECK(pairpots[1] == Approx(Value3));
 }
 #endif
 
@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "OhmmsData/Libxml2Doc.h"
+#include "Particle/ParticleSet.h"
+#include "QMCHamiltonians/GridExternalPotential.h"
+#include "QMCHamiltonians/HarmonicExternalPotential.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("Harmonic External Potential mw_evaluate", "[hamiltonian]")
+{
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+  elec.setName("elec");
+  elec.create({2});
+  elec.R[0] = {0.0, 1.0, 0.0};
+  elec.R[1] = {1.0, 1.0, -0.5};
+  ParticleSet elec2(elec);
+  elec2.R[1] = {0.3, -0.2, 0.1};
+
+  const char* harmonic_xml = R"(<extpot type="HarmonicExt" mass="1.0" energy="2.0" center="0.1 0.0 0.0"/>)";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(harmonic_xml);
+  REQUIRE(okay);
+
+  TrialWaveFunction psi;
+  HarmonicExternalPotential hext(elec);
+  hext.put(doc.getRoot());
+  auto hext2 = hext.makeClone(elec2, psi);
+
+  const double v  = hext.evaluate(elec);
+  const double v2 = hext2->evaluate(elec2);
+
+  RefVectorWithLeader<OperatorBase> o_list(hext, {hext, *hext2});
+  RefVectorWithLeader<TrialWaveFunction> wf_list(psi, {psi, psi});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  hext.mw_evaluate(o_list, wf_list, p_list);
+  CHECK(hext.getValue() == Approx(v));
+  CHECK(hext2->getValue() == Approx(v2));
+}
+
+TEST_CASE("Grid External Potential mw_evaluate", "[hamiltonian]")
+{
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+  elec.setName("elec");
+  elec.create({3});
+  elec.R[0] = {0.0, 1.0, 0.0};
+  elec.R[1] = {1.2, -1.7, 0.4};
+  elec.R[2] = {-1.9, 0.5, 1.3};
+  ParticleSet elec2(elec);
+  elec2.R[1] = {0.3, -0.2, 0.1};
+
+  TrialWaveFunction psi;
+  GridExternalPotential gext(elec);
+
+  // a smooth potential on the default grid of put, start -2, end 2 and 11 points
+  Ugrid grid;
+  grid.start = -2.0;
+  grid.end   = 2.0;
+  grid.num   = 11;
+  BCtype_d bc;
+  bc.lCode = NATURAL;
+  bc.rCode = NATURAL;
+  const double delta = (grid.end - grid.start) / (grid.num - 1);
+  Array<double, 3> data(grid.num, grid.num, grid.num);
+  for (int i = 0; i < grid.num; i++)
+    for (int j = 0; j < grid.num; j++)
+      for (int k = 0; k < grid.num; k++)
+      {
+        const double x = grid.start + i * delta;
+        const double y = grid.start + j * delta;
+        const double z = grid.start + k * delta;
+        data(i, j, k)  = x * x + 0.5 * y - std::cos(z);
+      }
+  gext.spline_data.reset(create_UBspline_3d_d(grid, grid, grid, bc, bc, bc, data.data()), destroy_Bspline);
+  auto gext2 = gext.makeClone(elec2, psi);
+
+  // the interpolation of a single walker matches einspline
+  double ref = 0.0;
+  for (int i = 0; i < elec.getTotalNum(); i++)
+  {
+    double val;
+    eval_UBspline_3d_d(gext.spline_data.get(), elec.R[i][0], elec.R[i][1], elec.R[i][2], &val);
+    ref += val;
+  }
+  const double v = gext.evaluate(elec);
+  CHECK(v == Approx(ref));
+  const double v2 = gext2->evaluate(elec2);
+
+  RefVectorWithLeader<OperatorBase> o_list(gext, {gext, *gext2});
+  RefVectorWithLeader<TrialWaveFunction> wf_list(psi, {psi, psi});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  gext.mw_evaluate(o_list, wf_list, p_list);
+  CHECK(gext.getValue() == Approx(v));
+  CHECK(gext2->getValue() == Approx(v2));
+}
+
+} // namespace qmcplusplus
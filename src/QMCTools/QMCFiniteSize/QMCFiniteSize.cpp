@@ -10,15 +10,7 @@
 
 namespace qmcplusplus
 {
-QMCFiniteSize::QMCFiniteSize()
-    : skparser(NULL), ptclPool(NULL), myRcut(0.0), myConst(0.0), P(NULL), h(0.0), sphericalgrid(0), myGrid(NULL)
-{
-  IndexType mtheta = 80;
-  IndexType mphi   = 80;
-  app_log() << "Building spherical grid. n_theta x n_phi = " << mtheta << " x " << mphi << endl;
-  build_spherical_grid(mtheta, mphi);
-  h = 0.1;
-}
+QMCFiniteSize::QMCFiniteSize() : QMCFiniteSize(nullptr) {}
 
 QMCFiniteSize::QMCFiniteSize(SkParserBase* skparser_i)
     : skparser(skparser_i), ptclPool(NULL), myRcut(0.0), myConst(0.0), P(NULL), h(0.0), sphericalgrid(0), myGrid(NULL)
@@ -145,8 +137,10 @@ void QMCFiniteSize::initBreakup()
   app_log() << "=========================================================\n";
   app_log() << " Initializing Long Range Breakup (Esler) \n";
   app_log() << "=========================================================\n";
-  P      = ptclPool.getParticleSet("e");
-  AA     = LRCoulombSingleton::getHandler(*P);
+  P = ptclPool.getParticleSet("e");
+  //the breakup is shared by all the S(k) files of a batch
+  if (AA == nullptr)
+    AA = LRCoulombSingleton::getHandler(*P);
   myRcut = AA->get_rc();
   if (rVs == nullptr)
   {
@@ -170,23 +164,9 @@ UBspline_3d_d* QMCFiniteSize::getSkSpline(vector<RealType> sk, RealType limit)
   //pieces beyond the k-cutoff equal to 1.
   //A violent approximation if S(k) is not converged, but
   //better than S(k)=0.
-  double kc     = AA->get_kc();
-  double kcutsq = kc * kc;
-
-  for (int i = int(gridx.lower_bound), skindex = 0; i <= int(gridx.upper_bound); i++)
-    for (int j = int(gridy.lower_bound); j <= int(gridy.upper_bound); j++)
-      for (int k = int(gridz.lower_bound); k <= int(gridz.upper_bound); k++)
-      {
-        PosType v;
-        v[0]         = i;
-        v[1]         = j;
-        v[2]         = k;
-        RealType ksq = P->getLattice().ksq(v);
-
-        if (ksq > kcutsq)
-          sk[skindex] = limit;
-        skindex++;
-      }
+  //The grid points beyond the cutoff are found once in initSampleCache.
+  for (const IndexType skindex : sk_beyond_kc)
+    sk[skindex] = limit;
   //No particular BC's on the edge of S(k).
 
   bcx.lCode = NATURAL;
@@ -269,10 +249,10 @@ QMCFiniteSize::RealType QMCFiniteSize::sphericalAvgSk(UBspline_3d_d* spline, Rea
   RealType sum         = 0.0;
   FullPrecRealType val = 0.0;
   PosType kvec(0);
-  IndexType ngrid = sphericalgrid.size();
+  IndexType ngrid = sphericalgrid_unit.size();
   for (IndexType i = 0; i < ngrid; i++)
   {
-    kvec     = P->getLattice().k_unit(k * sphericalgrid[i]); // to reduced coordinates
+    kvec     = k * sphericalgrid_unit[i]; // to reduced coordinates
     bool inx = true;
     bool iny = true;
     bool inz = true;
@@ -294,8 +274,8 @@ QMCFiniteSize::RealType QMCFiniteSize::sphericalAvgSk(UBspline_3d_d* spline, Rea
   return sum / RealType(ngrid);
 }
 
-UBspline_1d_d* QMCFiniteSize::spline_clamped(vector<RealType>& grid,
-                                             vector<RealType>& vals,
+UBspline_1d_d* QMCFiniteSize::spline_clamped(const vector<RealType>& grid,
+                                             const vector<RealType>& vals,
                                              RealType lVal,
                                              RealType rVal)
 {
@@ -369,6 +349,48 @@ void QMCFiniteSize::initialize()
   cout << "Grid computed.\n";
 
   skparser->get_grid(gridx, gridy, gridz);
+  initSampleCache();
+}
+
+void QMCFiniteSize::initSampleCache()
+{
+  sphericalgrid_unit.resize(sphericalgrid.size());
+  for (IndexType i = 0; i < sphericalgrid.size(); i++)
+    sphericalgrid_unit[i] = P->getLattice().k_unit(sphericalgrid[i]);
+
+  //This piece finds the points of the S(k) grid beyond the k-cutoff.
+  //getSkSpline sets S(k) on them to the large k limit.
+  RealType kc     = AA->get_kc();
+  RealType kcutsq = kc * kc;
+  sk_beyond_kc.clear();
+  for (int i = int(gridx.lower_bound), skindex = 0; i <= int(gridx.upper_bound); i++)
+    for (int j = int(gridy.lower_bound); j <= int(gridy.upper_bound); j++)
+      for (int k = int(gridz.lower_bound); k <= int(gridz.upper_bound); k++)
+      {
+        PosType v;
+        v[0]         = i;
+        v[1]         = j;
+        v[2]         = k;
+        RealType ksq = P->getLattice().ksq(v);
+
+        if (ksq > kcutsq)
+          sk_beyond_kc.push_back(skindex);
+        skindex++;
+      }
+
+  //radial grid of calcPotentialInt, finer than the k-shells
+  IndexType ngrid = 2 * Klist.kshell.size() - 1;
+  RealType dk     = kc / ngrid;
+  kgrid1d.resize(ngrid + 1);
+  k2vk_half.resize(ngrid + 1);
+  for (int i = 0; i < ngrid; i++)
+  {
+    RealType kval = i * dk;
+    kgrid1d[i]    = kval;
+    k2vk_half[i]  = (i == 0) ? 0.0 : 0.5 * kval * kval * AA->evaluate_vlr_k(kval); //evaluation for arbitrary kshell for any LRHandler
+  }
+  kgrid1d[ngrid]   = kc;
+  k2vk_half[ngrid] = 0.0;
 }
 
 void QMCFiniteSize::printSkRawSphAvg(const vector<RealType>& sk)
@@ -447,46 +469,36 @@ void QMCFiniteSize::printSkSplineSphAvg(UBspline_3d_d* spline)
   app_log() << "\nSpherically averaged splined S(k):\n";
   app_log() << setw(12) << "k" << setw(12) << "S(k)"
             << "\n";
+  vector<RealType> skavg(nk);
+#pragma omp parallel for
+  for (int k = 0; k < int(nk); k++)
+    skavg[k] = sphericalAvgSk(spline, kdel * k);
   for (int k = 0; k < nk; k++)
   {
     RealType kval = kdel * k;
-    app_log() << setw(12) << setprecision(8) << kval << setw(12) << setprecision(8) << sphericalAvgSk(spline, kval)
-              << "\n";
+    app_log() << setw(12) << setprecision(8) << kval << setw(12) << setprecision(8) << skavg[k] << "\n";
   }
 }
 
-QMCFiniteSize::RealType QMCFiniteSize::calcPotentialDiscrete(vector<RealType> sk)
+QMCFiniteSize::RealType QMCFiniteSize::calcPotentialDiscrete(const vector<RealType>& sk)
 {
   //This is the \frac{1}{Omega} \sum_{\mathbf{k}} \frac{v_k}{2} S(\mathbf{k}) term.
   return 0.5 * AA->evaluate_w_sk(Klist.kshell, sk.data());
 }
 
-QMCFiniteSize::RealType QMCFiniteSize::calcPotentialInt(vector<RealType> sk)
+QMCFiniteSize::RealType QMCFiniteSize::calcPotentialInt(const vector<RealType>& sk)
 {
   auto spline = std::unique_ptr<UBspline_3d_d, void (*)(void*)>{getSkSpline(sk), destroy_Bspline};
 
-  RealType kmax   = AA->get_kc();
-  IndexType ngrid = 2 * Klist.kshell.size() - 1; //make a lager kmesh
-
-  vector<RealType> unigrid1d, k2vksk;
-  RealType dk = kmax / ngrid;
-
-  unigrid1d.push_back(0.0);
-  k2vksk.push_back(0.0);
-  for (int i = 1; i < ngrid; i++)
-  {
-    RealType kval = i * dk;
-    unigrid1d.push_back(kval);
-    RealType skavg = sphericalAvgSk(spline.get(), kval);
-    RealType k2vk  = kval * kval * AA->evaluate_vlr_k(kval); //evaluation for arbitrary kshell for any LRHandler
-    k2vksk.push_back(0.5 * k2vk * skavg);
-  }
+  RealType kmax = AA->get_kc();
 
-  k2vksk.push_back(0.0);
-  unigrid1d.push_back(kmax);
+  //the radial grid and k^2 v_k/2 are the same for every sample
+  vector<RealType> k2vksk(kgrid1d.size(), 0.0);
+  for (int i = 1; i < kgrid1d.size() - 1; i++)
+    k2vksk[i] = k2vk_half[i] * sphericalAvgSk(spline.get(), kgrid1d[i]);
 
   auto integrand =
-      std::unique_ptr<UBspline_1d_d, void (*)(void*)>{spline_clamped(unigrid1d, k2vksk, 0.0, 0.0), destroy_Bspline};
+      std::unique_ptr<UBspline_1d_d, void (*)(void*)>{spline_clamped(kgrid1d, k2vksk, 0.0, 0.0), destroy_Bspline};
 
   //Integrate the spline and compute the thermodynamic limit.
   RealType integratedval = integrate_spline(integrand.get(), 0.0, kmax, 200);
@@ -504,26 +516,32 @@ void QMCFiniteSize::calcPotentialCorrection()
   vints.resize(NumSamples);
 
   RandomGenerator rng;
-#pragma omp parallel for
-  for (int i = 0; i < NumSamples; i++)
+#pragma omp parallel
   {
     vector<RealType> newSK_raw(SK_raw.size());
-    for (int j = 0; j < SK_raw.size(); j++)
-    {
-      FullPrecRealType chi;
-      chi = rng();
-      newSK_raw[j] = SK_raw[j] + SKerr_raw[j] * chi;
-    }
-    vsums[i] = calcPotentialDiscrete(newSK_raw);
-
     vector<RealType> newSK(SK.size());
-    for (int j = 0; j < SK.size(); j++)
+#pragma omp for schedule(dynamic)
+    for (int i = 0; i < NumSamples; i++)
     {
-      FullPrecRealType chi;
-      chi = rng();
-      newSK[j] = SK[j] + SKerr[j] * chi;
+      //the generator is shared, only the draws are serialized
+#pragma omp critical(fs_resample)
+      {
+        for (int j = 0; j < SK_raw.size(); j++)
+        {
+          FullPrecRealType chi;
+          chi          = rng();
+          newSK_raw[j] = SK_raw[j] + SKerr_raw[j] * chi;
+        }
+        for (int j = 0; j < SK.size(); j++)
+        {
+          FullPrecRealType chi;
+          chi      = rng();
+          newSK[j] = SK[j] + SKerr[j] * chi;
+        }
+      }
+      vsums[i] = calcPotentialDiscrete(newSK_raw);
+      vints[i] = calcPotentialInt(newSK);
     }
-    vints[i] = calcPotentialInt(newSK);
   }
 
   RealType vint, vinterr;
@@ -541,20 +559,25 @@ void QMCFiniteSize::calcLeadingOrderCorrections()
   RandomGenerator rng;
 
   vector<RealType> bs(NumSamples);
-#pragma omp parallel for
-  for (int i = 0; i < NumSamples; i++)
+#pragma omp parallel
   {
     vector<RealType> newSK(SK.size());
-    for (int j = 0; j < SK.size(); j++)
+    vector<RealType> Amat;
+#pragma omp for schedule(dynamic)
+    for (int i = 0; i < NumSamples; i++)
     {
-      FullPrecRealType chi;
-      chi = rng();
-      newSK[j] = SK[j] + SKerr[j] * chi;
+      //the generator is shared, only the draws are serialized
+#pragma omp critical(fs_resample)
+      for (int j = 0; j < SK.size(); j++)
+      {
+        FullPrecRealType chi;
+        chi      = rng();
+        newSK[j] = SK[j] + SKerr[j] * chi;
+      }
+      auto spline = std::unique_ptr<UBspline_3d_d, void (*)(void*)>{getSkSpline(newSK), destroy_Bspline};
+      getSkInfo(spline.get(), Amat);
+      bs[i] = (Amat[0] + Amat[1] + Amat[2]) / 3.0;
     }
-    UBspline_3d_d* spline = getSkSpline(newSK);
-    vector<RealType> Amat;
-    getSkInfo(spline, Amat);
-    bs[i] = (Amat[0] + Amat[1] + Amat[2]) / 3.0;
   }
 
   RealType b, berr;
@@ -618,8 +641,8 @@ bool QMCFiniteSize::execute()
       SKerr[i] /= RealType(Ne);
     }
   }
-  UBspline_3d_d* sk3d_spline = getSkSpline(SK);
-  printSkSplineSphAvg(sk3d_spline);
+  auto sk3d_spline = std::unique_ptr<UBspline_3d_d, void (*)(void*)>{getSkSpline(SK), destroy_Bspline};
+  printSkSplineSphAvg(sk3d_spline.get());
 
   calcLeadingOrderCorrections();
   calcPotentialCorrection();
@@ -42,14 +42,14 @@ public:
   RealType sphericalAvgSk(UBspline_3d_d* spline, RealType k);
 
   RealType integrate_spline(UBspline_1d_d* spline, RealType a, RealType b, IndexType N);
-  UBspline_1d_d* spline_clamped(vector<RealType>& grid, vector<RealType>& vals, RealType lVal, RealType rVal);
+  UBspline_1d_d* spline_clamped(const vector<RealType>& grid, const vector<RealType>& vals, RealType lVal, RealType rVal);
 
   void initialize();
   void calcPotentialCorrection();
   void calcLeadingOrderCorrections();
   void summary();
-  RealType calcPotentialDiscrete(vector<RealType> sk);
-  RealType calcPotentialInt(vector<RealType> sk);
+  RealType calcPotentialDiscrete(const vector<RealType>& sk);
+  RealType calcPotentialInt(const vector<RealType>& sk);
 
 private:
   SkParserBase* skparser;
@@ -59,12 +59,21 @@ private:
   ParticleSet* P;
   RealType h; //this is for finite differencing.
   vector<PosType> sphericalgrid;
+  ///directions of sphericalgrid in reduced coordinates
+  vector<PosType> sphericalgrid_unit;
+  ///index of the S(k) grid points beyond the k-cutoff
+  vector<IndexType> sk_beyond_kc;
+  ///radial grid of the integrated potential correction and k^2 v_k/2 on it
+  vector<RealType> kgrid1d;
+  vector<RealType> k2vk_half;
   GridType* myGrid;
   std::unique_ptr<LRHandlerType> AA;
   std::unique_ptr<RadFunctorType> rVs;
   bool processPWH(xmlNodePtr cur);
   void wfnPut(xmlNodePtr cur);
   void initBreakup();
+  /// compute the data shared by all the S(k) samples of the current grid
+  void initSampleCache();
   Grid_t gridx;
   Grid_t gridy;
   Grid_t gridz;
@@ -30,49 +30,49 @@ void SkParserHDF5::parse(const string& fname)
   }
   int nKpts = kgridraw.size();
 
-  //read the <rho_-k*rho_k> term
+  //check the shapes of the <rho_-k*rho_k>, Im(rho_k) and Re(rho_k) terms
   statfile.getShape<int>(skname + "/rhok_e_e/value", readShape);
   assert(readShape[1] == nKpts);
-  vector<RealType> rhok_e_tmp;
-  array<int, 2> rhok_e_dims{readShape[0], readShape[1]};
-  statfile.readSlabReshaped(rhok_e_tmp, rhok_e_dims, skname + "/rhok_e_e/value");
   int nBlocks = readShape[0];
-
-  //read the Im(rho_k) term
   statfile.getShape<int>(skname + "/rhok_e_i/value", readShape);
-  vector<RealType> rhok_i_tmp;
-  array<int, 2> rhok_i_dims{readShape[0], readShape[1]};
-  statfile.readSlabReshaped(rhok_i_tmp, rhok_i_dims, skname + "/rhok_e_i/value");
   assert(readShape[0] == nBlocks);
   assert(readShape[1] == nKpts);
-
-  //read the Re(rho_k)
   statfile.getShape<int>(skname + "/rhok_e_r/value", readShape);
-  vector<RealType> rhok_r_tmp;
-  array<int, 2> rhok_r_dims{readShape[0], readShape[1]};
-  statfile.readSlabReshaped(rhok_r_tmp, rhok_r_dims, skname + "/rhok_e_r/value");
   assert(readShape[0] == nBlocks);
   assert(readShape[1] == nKpts);
 
-  //For each k, evaluate the flucuating S(k) for all blocks.
-  //Then perform a simple equilibration estimate for this particular S(k) value
-  //Store the  average and error after throwing out the equilibration
-  for (int ik = 0; ik < nKpts; ik++)
+  //Stream the blocks one at a time and keep only the flucuating S(k) of each block.
+  //sk_blocks[ik][ib] holds the block data of k-point ik.
+  vector<vector<RealType>> sk_blocks(nKpts, vector<RealType>(nBlocks));
+  vector<RealType> rhok_e_tmp, rhok_i_tmp, rhok_r_tmp;
+  for (int ib = 0; ib < nBlocks; ib++)
   {
-    vector<RealType> block_data;
-    for (int ib = 0; ib < nBlocks; ib++)
+    array<int, 2> block_spec{ib, -1};
+    statfile.readSlabSelection(rhok_e_tmp, block_spec, skname + "/rhok_e_e/value");
+    statfile.readSlabSelection(rhok_i_tmp, block_spec, skname + "/rhok_e_i/value");
+    statfile.readSlabSelection(rhok_r_tmp, block_spec, skname + "/rhok_e_r/value");
+    for (int ik = 0; ik < nKpts; ik++)
     {
       RealType re, rr, ri;
-      re = rhok_e_tmp[nKpts * ib + ik];
-      rr = rhok_r_tmp[nKpts * ib + ik];
-      ri = rhok_i_tmp[nKpts * ib + ik];
-      block_data.push_back(re - (rr * rr + ri * ri));
+      re                = rhok_e_tmp[ik];
+      rr                = rhok_r_tmp[ik];
+      ri                = rhok_i_tmp[ik];
+      sk_blocks[ik][ib] = re - (rr * rr + ri * ri);
     }
-    int ieq = estimateEquilibration(block_data);
+  }
+
+  //For each k, perform a simple equilibration estimate for this particular S(k) value
+  //Store the  average and error after throwing out the equilibration
+  skraw.resize(nKpts);
+  skerr_raw.resize(nKpts);
+#pragma omp parallel for schedule(dynamic)
+  for (int ik = 0; ik < nKpts; ik++)
+  {
+    int ieq = estimateEquilibration(sk_blocks[ik]);
     RealType avg, err;
-    getStats(block_data, avg, err, ieq);
-    skraw.push_back(avg);
-    skerr_raw.push_back(err);
+    getStats(sk_blocks[ik], avg, err, ieq);
+    skraw[ik]     = avg;
+    skerr_raw[ik] = err;
   }
 
   hasGrid        = false;
@@ -88,6 +88,7 @@ QMCGaussianParserBase::QMCGaussianParserBase()
       NbKpts(0),
       nbexcitedstates(0),
       ci_threshold(1e-20),
+      ci_chunk_size(1 << 16),
       Title("sample"),
       basisType("Gaussian"),
       basisName("generic"),
@@ -153,6 +154,7 @@ QMCGaussianParserBase::QMCGaussianParserBase(int argc, char** argv)
       NbKpts(0),
       nbexcitedstates(0),
       ci_threshold(1e-20),
+      ci_chunk_size(1 << 16),
       Title("sample"),
       basisType("Gaussian"),
       basisName("generic"),
@@ -1108,54 +1110,40 @@ xmlNodePtr QMCGaussianParserBase::createMultiDeterminantSetCIHDF5()
   hout.write(N_int, "Nbits");
   hout.write(nbexcitedstates, "nexcitedstate");
 
-  Matrix<int64_t> tempAlpha(ci_size, N_int);
-  Matrix<int64_t> tempBeta(ci_size, N_int);
-  for (int i = 0; i < CIcoeff.size(); i++)
+  // pack and write the occupations chunk by chunk, the strings of a written chunk are released
+  // so the packed expansion is never held in memory next to the strings
+  const int chunk_size = std::max(1, std::min(ci_chunk_size, ci_size));
+  const std::array<size_t, 2> shape{static_cast<size_t>(ci_size), static_cast<size_t>(N_int)};
+  std::vector<int64_t> chunkAlpha(chunk_size * N_int), chunkBeta(chunk_size * N_int);
+  for (int first = 0; first < ci_size; first += chunk_size)
   {
-    std::string loc_alpha = CIalpha[i].substr(0, ci_nstates);
-    std::string loc_beta  = CIbeta[i].substr(0, ci_nstates);
-    std::string BiteSizeStringAlpha;
-    std::string BiteSizeStringBeta;
-    BiteSizeStringAlpha.resize(N_int * bit_kind);
-    BiteSizeStringBeta.resize(N_int * bit_kind);
-
-    for (std::size_t n = 0; n < (N_int * bit_kind); n++)
-    {
-      BiteSizeStringAlpha[n] = '0';
-      BiteSizeStringBeta[n]  = '0';
-    }
-
-    for (std::size_t n = 0; n < ci_nstates; n++)
+    const int n = std::min(chunk_size, ci_size - first);
+#pragma omp parallel for
+    for (int i = 0; i < n; i++)
     {
-      BiteSizeStringAlpha[n] = loc_alpha[n];
-      BiteSizeStringBeta[n]  = loc_beta[n];
-    }
-
-    std::size_t offset = 0;
-    for (std::size_t l = 0; l < N_int; l++)
-    {
-      offset = bit_kind * l;
-      int64_t Val;
-      std::string Var_alpha, Var_beta;
-      Var_alpha.resize(bit_kind);
-      Var_beta.resize(bit_kind);
-
-      for (auto j = 0; j < bit_kind; j++)
+      packOccupation(CIalpha[first + i], ci_nstates, chunkAlpha.data() + i * N_int, N_int);
+      std::string().swap(CIalpha[first + i]);
+      if (!isSpinor)
       {
-        Var_alpha[j] = BiteSizeStringAlpha[j + offset];
-        Var_beta[j]  = BiteSizeStringBeta[j + offset];
+        packOccupation(CIbeta[first + i], ci_nstates, chunkBeta.data() + i * N_int, N_int);
+        std::string().swap(CIbeta[first + i]);
       }
-      std::reverse(Var_alpha.begin(), Var_alpha.end());
-      std::reverse(Var_beta.begin(), Var_beta.end());
-      std::bitset<bit_kind> bit_alpha(Var_alpha);
-      std::bitset<bit_kind> bit_beta(Var_beta);
-      tempAlpha[i][l] = bit_alpha.to_ullong();
-      tempBeta[i][l]  = bit_beta.to_ullong();
+    }
+    chunkAlpha.resize(n * N_int);
+    chunkBeta.resize(n * N_int);
+    const std::array<size_t, 2> counts{static_cast<size_t>(n), static_cast<size_t>(N_int)};
+    const std::array<size_t, 2> offsets{static_cast<size_t>(first), 0};
+    hyperslab_proxy<std::vector<int64_t>, 2> slab_alpha(chunkAlpha, shape, counts, offsets);
+    hout.write(slab_alpha, "CI_Alpha");
+    if (!isSpinor)
+    {
+      hyperslab_proxy<std::vector<int64_t>, 2> slab_beta(chunkBeta, shape, counts, offsets);
+      hout.write(slab_beta, "CI_Beta");
     }
   }
-  hout.write(tempAlpha, "CI_Alpha");
-  if (!isSpinor)
-    hout.write(tempBeta, "CI_Beta");
+  // the occupation strings are consumed
+  CIalpha.clear();
+  CIbeta.clear();
 
   hout.pop();
   xmlAddChild(multislaterdet, detlist);
@@ -1163,6 +1151,15 @@ xmlNodePtr QMCGaussianParserBase::createMultiDeterminantSetCIHDF5()
   return multislaterdet;
 }
 
+void QMCGaussianParserBase::packOccupation(const std::string& occ, int nstates, int64_t* bits, int n_int)
+{
+  std::fill(bits, bits + n_int, 0);
+  const int n = std::min(nstates, static_cast<int>(occ.size()));
+  for (int i = 0; i < n; i++)
+    if (occ[i] == '1')
+      bits[i / 64] |= int64_t(1) << (i % 64);
+}
+
 xmlNodePtr QMCGaussianParserBase::createMultiDeterminantSet()
 {
   xmlNodePtr multislaterdet = xmlNewNode(NULL, (const xmlChar*)"multideterminant");
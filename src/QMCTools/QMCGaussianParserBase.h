@@ -74,6 +74,8 @@ struct QMCGaussianParserBase
   int NbKpts;
   int nbexcitedstates;
   double ci_threshold;
+  /// number of determinants packed and written to HDF5 at a time
+  int ci_chunk_size;
 
 
   std::vector<double> STwist_Coord; //Super Twist Coordinates
@@ -157,6 +159,13 @@ struct QMCGaussianParserBase
 
   int numberOfExcitationsCSF(std::string&);
 
+  /** pack the occupation string of a determinant into bits, orbital n is bit n%64 of word n/64
+   * @param occ occupation of each orbital, '1' if occupied, only the first nstates are read
+   * @param nstates number of orbitals
+   * @param bits n_int words to fill
+   */
+  static void packOccupation(const std::string& occ, int nstates, int64_t* bits, int n_int);
+
   virtual void parse(const std::string& fname) = 0;
 
   virtual void dumpPBC(const std::string& psi_tag, const std::string& ion_tag);
@@ -12,8 +12,11 @@
 #include "WriteEshdf.h"
 #include "XmlRep.h"
 #include "FftContainer.h"
+#include "Concurrency/OpenMP.h"
+#include <algorithm>
 #include <sstream>
 #include <map>
+#include <memory>
 using namespace std;
 //using namespace hdfhelper;
 using namespace qmcplusplus;
@@ -107,51 +110,67 @@ double EshdfFile::getOccupation(const XmlNode* nd) const
 }
 
 // before you enter here, better be in the a spin group of the hdf file
-void EshdfFile::handleSpinGroup(const XmlNode* nd, double& nocc, FftContainer& cont)
+void EshdfFile::handleSpinGroup(const XmlNode* nd, double& nocc, std::vector<std::unique_ptr<FftContainer>>& conts)
 {
-  nocc             = getOccupation(nd);
-  int stateCounter = 0;
-  vector<double> eigvals;
-
+  nocc = getOccupation(nd);
+  vector<int> stateNodes;
   for (int chIdx = 0; chIdx < nd->getNumChildren(); chIdx++)
-  {
     if (nd->getChild(chIdx).getName() == "grid_function")
+      stateNodes.push_back(chIdx);
+
+  // the states are transformed a batch at a time, one per thread
+  // the text of the states is read from the shared input stream and the eshdf file is written serially
+  const int batchSize = conts.size();
+  vector<string> types(batchSize), values(batchSize);
+  for (int first = 0; first < stateNodes.size(); first += batchSize)
+  {
+    const int nstates = std::min(batchSize, static_cast<int>(stateNodes.size()) - first);
+    for (int i = 0; i < nstates; i++)
+      readEigFcnText(nd->getChild(stateNodes[first + i]), types[i], values[i]);
+
+#pragma omp parallel for
+    for (int i = 0; i < nstates; i++)
+      transformEigFcn(types[i], values[i], *conts[i]);
+
+    for (int i = 0; i < nstates; i++)
     {
+      const int stateCounter = first + i;
       //cout << "Working on state " << stateCounter << endl;
       stringstream statess;
       statess << "state_" << stateCounter;
       outfile_.push(statess.str());
 
-      // HACK_HACK_HACK!!!
-      // QBOX does not write out the eigenvalues for the states in the
-      // sample file, so just make sure they are treated in ascending order
-      eigvals.push_back(-5000.0 + stateCounter);
-
-      const XmlNode& eigFcnNode = nd->getChild(chIdx);
-      readInEigFcn(eigFcnNode, cont);
+      const FftContainer& cont = *conts[i];
       // write eigfcn to proper place
       array<int, 2> psig_dims{cont.fullSize, 2};
 
-      vector<double> temp;
-      for (int i = 0; i < cont.fullSize; i++)
+      vector<double> temp(cont.fullSize * 2);
+      for (int j = 0; j < cont.fullSize; j++)
       {
-        temp.push_back(cont.kspace[i][0]);
-        temp.push_back(cont.kspace[i][1]);
+        temp[2 * j]     = cont.kspace[j][0];
+        temp[2 * j + 1] = cont.kspace[j][1];
       }
 
       outfile_.writeSlabReshaped(temp, psig_dims, "psi_g");
-      stateCounter++;
       outfile_.pop();
     }
   }
 
+  // HACK_HACK_HACK!!!
+  // QBOX does not write out the eigenvalues for the states in the
+  // sample file, so just make sure they are treated in ascending order
+  vector<double> eigvals;
+  for (int stateCounter = 0; stateCounter < stateNodes.size(); stateCounter++)
+    eigvals.push_back(-5000.0 + stateCounter);
+
+  const int stateCounter = stateNodes.size();
   outfile_.write(stateCounter, "number_of_states");
   outfile_.write(eigvals, "eigenvalues");
 }
 
-void EshdfFile::readInEigFcn(const XmlNode& nd, FftContainer& cont)
+void EshdfFile::readEigFcnText(const XmlNode& nd, string& type, string& values)
 {
-  const string type     = nd.getAttribute("type");
+  type                  = nd.getAttribute("type");
   const string encoding = nd.getAttribute("encoding");
 
   if (encoding != "text")
@@ -159,9 +178,18 @@ void EshdfFile::readInEigFcn(const XmlNode& nd, FftContainer& cont)
     cerr << "Don't yet know how to handle encoding of wavefunction values other than text" << endl;
     exit(1);
   }
+  values = nd.getValue();
+}
 
+void EshdfFile::transformEigFcn(const string& type, const string& text, FftContainer& cont)
+{
   vector<double> values;
-  nd.getValue(values);
+  values.reserve(type == "complex" ? 2 * cont.fullSize : cont.fullSize);
+  stringstream ss(text);
+  double temp;
+  while (ss >> temp)
+    values.push_back(temp);
+
   const double fixnorm = 1 / std::sqrt(static_cast<double>(cont.fullSize));
   if (type == "complex")
   {
@@ -197,10 +225,10 @@ void EshdfFile::readInEigFcn(const XmlNode& nd, FftContainer& cont)
       }
     }
   }
-  //cout << "in readInEigFcn, before fft, real space L2 norm = " << cont.getL2NormRS() << endl;
+  //cout << "in transformEigFcn, before fft, real space L2 norm = " << cont.getL2NormRS() << endl;
   cont.executeFFT();
   cont.fixKsNorm(fixnorm);
-  //cout << "in readInEigFcn, after fft, k space L2 norm = " << cont.getL2NormKS() << endl;
+  //cout << "in transformEigFcn, after fft, k space L2 norm = " << cont.getL2NormKS() << endl;
 }
 
 void EshdfFile::writeApplication(const string& appName, int major, int minor, int sub)
@@ -791,10 +819,7 @@ void EshdfFile::handleKpt(int kpt_num,
     if (noncol == 0)
       upcoefs.resize(ng * 2);
     if (noncol == 1)
-    {
       upcoefs.resize(ng * 4);
-      dncoefs.resize(ng * 2);
-    }
   }
   else
   {
@@ -802,8 +827,68 @@ void EshdfFile::handleKpt(int kpt_num,
     dncoefs.resize(ng * 2);
   }
 
-  vector<momap_t> states_up;
-  vector<momap_t> states_dn;
+  //now write to eshdf
+  if (kpt_num == 0)
+  {
+    vector<int> allgvs;
+    int nallgvs = moref.size();
+    int dim     = moref.begin()->first.size();
+    array<int, 2> shape{nallgvs, dim};
+    for (auto& v : moref)
+    {
+      for (int d = 0; d < dim; d++)
+        allgvs.push_back(v.first[d]);
+    }
+    outfile_.writeSlabReshaped(allgvs, shape, "gvectors");
+    outfile_.write(nallgvs, "number_of_gvectors");
+  }
+
+  // position of each g-vector of this kpoint in the ordered global g-vectors,
+  // found by walking both in order, the global ones not at this kpoint stay zero
+  vector<int> order(ng);
+  for (int i = 0; i < ng; i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&gvs](int a, int b) { return gvs[a] < gvs[b]; });
+  vector<int> gindex(ng);
+  {
+    auto it     = moref.begin();
+    int iglobal = 0;
+    for (int i : order)
+    {
+      while (it != moref.end() && it->first < gvs[i])
+      {
+        ++it;
+        ++iglobal;
+      }
+      if (it == moref.end() || it->first != gvs[i])
+      {
+        cerr << "g-vector of kpoint " << kpt_num << " is missing from the global g-vectors" << endl;
+        exit(1);
+      }
+      gindex[i] = iglobal;
+    }
+  }
+
+  // scatters the coefficients of a state at this kpoint into the global g-vectors and writes them
+  const int nallgvs = moref.size();
+  vector<double> c(nallgvs * 2);
+  auto writeState = [&](const double* coefs, const string& spin_group, const string& state_group) {
+    std::fill(c.begin(), c.end(), 0.0);
+#pragma omp parallel for
+    for (int i = 0; i < ng; i++)
+    {
+      c[gindex[i] * 2]     = coefs[i * 2];
+      c[gindex[i] * 2 + 1] = coefs[i * 2 + 1];
+    }
+    outfile_.push(spin_group);
+    outfile_.push(state_group);
+    array<int, 2> dims{nallgvs, 2};
+    outfile_.writeSlabReshaped(c, dims, "psi_g");
+    outfile_.pop();
+    outfile_.pop();
+  };
+
+  // each state is read, scattered and written before the next one is read
   int states_to_loop = eigenvalues.size();
   if (spinpol == 1)
     states_to_loop /= 2;
@@ -827,112 +912,19 @@ void EshdfFile::handleKpt(int kpt_num,
       spin_1_file.readSlabSelection(dncoefs, read_from, "evc");
     }
 
-    if (spinpol == 0)
-    {
-      if (noncol == 0)
-      {
-        momap_t moup;
-        for (int i = 0; i < ng; i++)
-        {
-          complex<double> c(upcoefs[i * 2], upcoefs[i * 2 + 1]);
-          mopair_t p(gvs[i], c);
-          moup.insert(p);
-        }
-        //now fill in rest of gvecs with zeros
-        moup.insert(moref.begin(), moref.end());
-        states_up.push_back(moup);
-      }
-      else
-      {
-        //dn part of spinor in second half of upcoefs
-        for (int i = 0; i < ng * 2; i++)
-          dncoefs[i] = upcoefs[i + 2 * ng];
-        momap_t moup, modn;
-        for (int i = 0; i < ng; i++)
-        {
-          complex<double> c(upcoefs[i * 2], upcoefs[i * 2 + 1]);
-          mopair_t p(gvs[i], c);
-          moup.insert(p);
-          c = complex<double>(dncoefs[i * 2], dncoefs[i * 2 + 1]);
-          p = mopair_t(gvs[i], c);
-          modn.insert(p);
-        }
-        //now fill in rest of gvecs with zeros
-        moup.insert(moref.begin(), moref.end());
-        modn.insert(moref.begin(), moref.end());
-        states_up.push_back(moup);
-        states_dn.push_back(modn);
-      }
-    }
-    else
-    {
-      momap_t moup, modn;
-      for (int i = 0; i < ng; i++)
-      {
-        complex<double> c(upcoefs[i * 2], upcoefs[i * 2 + 1]);
-        mopair_t p(gvs[i], c);
-        moup.insert(p);
-        c = complex<double>(dncoefs[i * 2], dncoefs[i * 2 + 1]);
-        p = mopair_t(gvs[i], c);
-        modn.insert(p);
-      }
-      moup.insert(moref.begin(), moref.end());
-      modn.insert(moref.begin(), moref.end());
-      states_up.push_back(moup);
-      states_dn.push_back(modn);
-    }
-  }
-  spin_0_file.close();
-  spin_1_file.close();
-
-  //now write to eshdf
-  if (kpt_num == 0)
-  {
-    vector<int> allgvs;
-    int nallgvs = moref.size();
-    int dim     = moref.begin()->first.size();
-    array<int, 2> shape{nallgvs, dim};
-    for (auto& v : moref)
-    {
-      for (int d = 0; d < dim; d++)
-        allgvs.push_back(v.first[d]);
-    }
-    outfile_.writeSlabReshaped(allgvs, shape, "gvectors");
-    outfile_.write(nallgvs, "number_of_gvectors");
-  }
-
-  for (int state = 0; state < states_up.size(); state++)
-  {
     stringstream ss;
     ss << "state_" << state;
-    outfile_.push("spin_0");
-    outfile_.push(ss.str());
-    vector<double> c;
-    for (auto& v : states_up[state])
-    {
-      c.push_back(v.second.real());
-      c.push_back(v.second.imag());
-    }
-    array<int, 2> dims{static_cast<int>(states_up[state].size()), 2};
-    outfile_.writeSlabReshaped(c, dims, "psi_g");
-    outfile_.pop();
-    outfile_.pop();
-    if (noncol == 1 || spinpol == 1)
+    writeState(upcoefs.data(), "spin_0", ss.str());
+    if (spinpol == 1)
+      writeState(dncoefs.data(), "spin_1", ss.str());
+    else if (noncol == 1)
     {
-      outfile_.push("spin_1");
-      outfile_.push(ss.str());
-      vector<double> c;
-      for (auto& v : states_dn[state])
-      {
-        c.push_back(v.second.real());
-        c.push_back(v.second.imag());
-      }
-      array<int, 2> dims{static_cast<int>(states_dn[state].size()), 2};
-      outfile_.writeSlabReshaped(c, dims, "psi_g");
-      outfile_.pop();
-      outfile_.pop();
+      //dn part of spinor in second half of upcoefs
+      writeState(upcoefs.data() + 2 * ng, "spin_1", ss.str());
     }
   }
+  spin_0_file.close();
+  spin_1_file.close();
 
   // now all the states are written, so write out eigenvalues and number of states
   vector<double> eigval = eigenvalues;
@@ -1055,7 +1047,10 @@ void EshdfFile::writeQboxElectrons(const XmlNode& qboxSample)
   gridNode.getAttribute("ny", ny);
   gridNode.getAttribute("nz", nz);
 
-  FftContainer fftCont(nx, ny, nz);
+  // one container per thread, the FFTW plans are created serially
+  std::vector<std::unique_ptr<FftContainer>> fftConts;
+  for (int ip = 0; ip < omp_get_max_threads(); ip++)
+    fftConts.push_back(std::make_unique<FftContainer>(nx, ny, nz));
 
   vector<KPoint> kpts;
   map<KPoint, const XmlNode*> kptToUpNode;
@@ -1172,14 +1167,14 @@ void EshdfFile::writeQboxElectrons(const XmlNode& qboxSample)
 
     outfile_.push("spin_0");
     const XmlNode* upnd = kptToUpNode[kpts[i]];
-    handleSpinGroup(upnd, nup, fftCont);
+    handleSpinGroup(upnd, nup, fftConts);
     outfile_.pop();
 
     if (nspin == 2)
     {
       outfile_.push("spin_1");
       const XmlNode* dnnd = kptToDnNode[kpts[i]];
-      handleSpinGroup(dnnd, ndn, fftCont);
+      handleSpinGroup(dnnd, ndn, fftConts);
       outfile_.pop();
     }
     else
@@ -19,6 +19,7 @@
 #include <cmath>
 #include <map>
 #include <complex>
+#include <memory>
 
 class XmlNode;
 class FftContainer;
@@ -51,14 +52,18 @@ private:
   void writeVersion();
 
   // helper functions meant for qbox
-  /*! to be handed a grid_function tag of the qbox sample file.  Will then read in the
-      eigenfunciton (spo) in real-space and use the FftContainer cont to transform
-      them to k-space */
-  void readInEigFcn(const XmlNode& nd, FftContainer& cont);
+  /*! to be handed a grid_function tag of the qbox sample file.  Will read the type
+      and the text of the values of the eigenfunction (spo) in real-space, reading
+      from the input stream so only one thread may call it at a time */
+  void readEigFcnText(const XmlNode& nd, std::string& type, std::string& values);
+  /*! parses the text of the values of an eigenfunction in real-space and uses the
+      FftContainer cont to transform it to k-space, safe to call concurrently
+      with different containers */
+  static void transformEigFcn(const std::string& type, const std::string& values, FftContainer& cont);
   /*! to be handed a slater_determinant tag of the qbox sample file.  Will read in the
-      occupations and call readInEigFcn for each state, also needs an FftContainer to
-      pass on to readInEigFcn */
-  void handleSpinGroup(const XmlNode* nd, double& nocc, FftContainer& cont);
+      occupations and transform the states in batches, one per FftContainer in conts
+      with the states of a batch transformed by the OpenMP threads */
+  void handleSpinGroup(const XmlNode* nd, double& nocc, std::vector<std::unique_ptr<FftContainer>>& conts);
   /*! to be handed a slater_determinant tag from the qbox sample file.  Will read in 
       the occupations from the density_matrix subnode add the total which will be
       returned as output */
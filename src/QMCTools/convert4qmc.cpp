@@ -39,7 +39,7 @@ int main(int argc, char** argv)
     std::cout << "[-nojastrow -hdf5 -prefix title -addCusp -production -NbImages NimageX NimageY NimageZ]" << std::endl;
     std::cout << "[-psi_tag psi0 -ion_tag ion0 -gridtype log|log0|linear -first ri -last rf]" << std::endl;
     std::cout << "[-size npts -multidet multidet.h5 -ci file.out -threshold cimin -TargetState state_number "
-                 "-NaturalOrbitals NumToRead -optDetCoeffs]"
+                 "-NaturalOrbitals NumToRead -optDetCoeffs -ciChunkSize ndets]"
               << std::endl;
     std::cout << "Defaults : -gridtype log -first 1e-6 -last 100 -size 1001 -ci required -threshold 0.01 -TargetState "
                  "0 -prefix sample"
@@ -83,6 +83,7 @@ int main(int argc, char** argv)
       bool ci = false, zeroCI = false, orderByExcitation = false, addCusp = false, multidet = false,
            optDetCoeffs = false;
       double thres      = 1e-20;
+      int ciChunkSize   = 1 << 16; // determinants packed and written to HDF5 at a time
       int readNO        = 0; // if > 0, read Natural Orbitals from gamess output
       int readGuess     = 0; // if > 0, read Initial Guess from gamess output
       std::vector<int> Image;
@@ -169,6 +170,10 @@ int main(int argc, char** argv)
         {
           thres = atof(argv[++iargc]);
         }
+        else if (a == "-ciChunkSize")
+        {
+          ciChunkSize = atoi(argv[++iargc]);
+        }
         else if (a == "-optDetCoeffs")
         {
           optDetCoeffs = true;
@@ -285,6 +290,7 @@ int main(int argc, char** argv)
       parser->multih5file       = punch_file;
       parser->production        = prod;
       parser->ci_threshold      = thres;
+      parser->ci_chunk_size     = ciChunkSize;
       parser->optDetCoeffs      = optDetCoeffs;
       parser->target_state      = TargetState;
       parser->readNO            = readNO;
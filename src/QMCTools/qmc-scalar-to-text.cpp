@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "Utilities/ScalarTable.h"
+
+/** convert the binary scalar.bin and dmc.bin tables to the text layout of scalar.dat and dmc.dat
+ *
+ * usage: qmc-scalar-to-text input.bin [output.dat], the text goes to stdout without an output file
+ */
+int main(int argc, char* argv[])
+{
+  using namespace qmcplusplus;
+  if (argc != 2 && argc != 3)
+  {
+    std::cout << "Usage: qmc-scalar-to-text input.bin [output.dat]" << std::endl;
+    return 1;
+  }
+  try
+  {
+    ScalarTableReader table(argv[1]);
+    if (argc == 3)
+    {
+      std::ofstream fout(argv[2]);
+      if (!fout)
+        throw std::runtime_error(std::string("cannot create ") + argv[2]);
+      writeScalarTableText(fout, table);
+    }
+    else
+      writeScalarTableText(std::cout, table);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -56,12 +56,12 @@ int main(int argc, char** argv)
   std::cout.setf(std::ios::right, std::ios::adjustfield);
   std::cout.precision(12);
 
-  std::unique_ptr<SkParserBase> skparser(nullptr);
+  std::string skformat;
 
   bool show_usage = false;
   bool show_warn  = false;
   std::string skname;
-  std::string skfile;
+  std::vector<std::string> skfiles;
   /* For a successful execution of the code, atleast 3 arguments will need to be
    * provided along with the executable. Therefore, print usage information if
    * argc is less than 4.
@@ -79,29 +79,18 @@ int main(int argc, char** argv)
     {
       std::string a(argv[iargc]);
       std::string anxt(argv[iargc + 1]);
-      if (a == "--ascii")
+      if (a == "--ascii" || a == "--scalardat" || a == "--hdf5")
       {
-        skparser = std::make_unique<SkParserASCII>();
-        skfile   = anxt;
-        if (skf_found)
-          show_warn = true;
-        skf_found = true;
-      }
-      else if (a == "--scalardat")
-      {
-        skparser = std::make_unique<SkParserScalarDat>();
-        skfile   = anxt;
-        if (skf_found)
-          show_warn = true;
-        skf_found = true;
-      }
-      else if (a == "--hdf5")
-      {
-        skparser = std::make_unique<SkParserHDF5>();
-        skfile   = anxt;
+        skformat = a;
+        skfiles.clear();
+        //all the following arguments up to the next flag are S(k) files
+        while (iargc + 1 < argc && std::string(argv[iargc + 1]).rfind("--", 0) != 0)
+          skfiles.push_back(argv[++iargc]);
         if (skf_found)
           show_warn = true;
         skf_found = true;
+        iargc++;
+        continue;
       }
       else if (a == "--skname")
       {
@@ -114,19 +103,21 @@ int main(int argc, char** argv)
       }
       iargc += 2;
     }
+    if (skfiles.empty())
+      show_usage = true;
   }
 
   if (show_usage)
   {
-    std::cout << "Usage:  qmcfinitesize [main.xml] --[skformat] [SK_FILE] --[optional_arg] [option]\n";
+    std::cout << "Usage:  qmcfinitesize [main.xml] --[skformat] [SK_FILE]... --[optional_arg] [option]\n";
     std::cout << "  [main.xml]\n";
     std::cout << "    input file to qmcpack corresponding that calculated S(k) data. ";
     std::cout << "  [skformat]\n";
     std::cout << "    ascii:      S(k) given in kx ky kz sk sk_err format.  Header necessary.\n";
     std::cout << "    scalardat:  File containing skall elements with energy.pl output format.\n";
     std::cout << "    hdf5:       stat.h5 file containing skall data.\n";
-    std::cout << "  [SK_FILE]\n";
-    std::cout << "    filename containing the S(k) data\n";
+    std::cout << "  [SK_FILE]...\n";
+    std::cout << "    one or more filenames containing the S(k) data, corrected one after another\n";
     std::cout << "  [optional_args]\n";
     std::cout << "    --skname:     in the stat.h5, the S(k) group name. Set to \"name\" defined in qmcpack input file "
                  "where SkAll estimator was specified\n";
@@ -135,6 +126,7 @@ int main(int argc, char** argv)
     std::cout << "---------------------------\n";
     std::cout << "Examples:\n";
     std::cout << "  qmcfinitesize qmc.in.xml --hdf5 qmc.g000.s000.stat.h5 --skname SkAll\n";
+    std::cout << "  qmcfinitesize qmc.in.xml --hdf5 qmc.g000.s000.stat.h5 qmc.g001.s000.stat.h5\n";
     std::cout << "  qmcfinitesize qmc.in.xml --ascii processed_sk.dat\n";
     return 0;
   }
@@ -142,19 +134,32 @@ int main(int argc, char** argv)
   if (show_warn)
     std::cout << "WARNING:  multiple skformats were provided. All but the last will be ignored.\n\n";
 
-  if (!skname.empty())
-    skparser->setName(skname);
-  skparser->parse(skfile);
-
-  if (skparser == NULL)
-  {
-    APP_ABORT("qmcfinitesize:  skparser failed to initialize");
-  }
+  auto createSkParser = [&skformat]() -> std::unique_ptr<SkParserBase> {
+    if (skformat == "--ascii")
+      return std::make_unique<SkParserASCII>();
+    else if (skformat == "--scalardat")
+      return std::make_unique<SkParserScalarDat>();
+    else
+      return std::make_unique<SkParserHDF5>();
+  };
 
-  QMCFiniteSize qmcfs(skparser.get());
+  //The system and the long range breakup are set up once and shared by all the S(k) files.
+  QMCFiniteSize qmcfs;
   qmcfs.parse(std::string(argv[1]));
   qmcfs.validateXML();
-  qmcfs.execute();
+  for (const auto& skfile : skfiles)
+  {
+    std::unique_ptr<SkParserBase> skparser = createSkParser();
+    if (!skname.empty())
+      skparser->setName(skname);
+    skparser->parse(skfile);
+
+    app_log() << "\n=========================================================\n";
+    app_log() << " S(k) file: " << skfile << "\n";
+    app_log() << "=========================================================\n";
+    qmcfs.setSkParser(skparser.get());
+    qmcfs.execute();
+  }
 
   // Jobs done. Clean up.
   OHMMS::Controller->finalize();
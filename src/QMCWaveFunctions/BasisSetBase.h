@@ -23,6 +23,7 @@
 
 #include "Particle/ParticleSet.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
+#include "type_traits/RefVectorWithLeader.h"
 
 namespace qmcplusplus
 {
@@ -140,6 +141,8 @@ struct SoaBasisSetBase
   using vgl_type   = VectorSoaContainer<T, OHMMS_DIM + 2>;
   using vgh_type   = VectorSoaContainer<T, 10>;
   using vghgh_type = VectorSoaContainer<T, 20>;
+  ///[first, last) ranges of the basis functions which are not screened out
+  using BasisRanges = std::vector<std::pair<int, int>>;
   ///size of the basis set
   int BasisSetSize;
 
@@ -165,6 +168,54 @@ struct SoaBasisSetBase
                                      int jion,
                                      vghgh_type& vghgh)                            = 0;
   virtual void evaluateV(const ParticleSet& P, int iat, value_type* restrict vals) = 0;
+
+  /** evaluate VGL of electrons [first, last) for multiple walkers
+   * @param basis_list the basis sets of all the walkers, this object is the leader
+   * @param P_list the particle sets of all the walkers
+   * @param vgl_mw output stacked as [walker][electron][DIM+2][ld]
+   * @param ld leading dimension of vgl_mw, no smaller than BasisSetSize
+   */
+  virtual void mw_evaluateVGL(const RefVectorWithLeader<SoaBasisSetBase>& basis_list,
+                              const RefVectorWithLeader<ParticleSet>& P_list,
+                              int first,
+                              int last,
+                              value_type* vgl_mw,
+                              size_t ld)
+  {
+    const size_t nel = last - first;
+#pragma omp parallel for
+    for (int iw = 0; iw < basis_list.size(); iw++)
+      for (size_t i = 0; i < nel; i++)
+      {
+        vgl_type vgl(vgl_mw + (iw * nel + i) * (OHMMS_DIM + 2) * ld, BasisSetSize, ld);
+        basis_list[iw].evaluateVGL(P_list[iw], first + i, vgl);
+      }
+  }
+
+  /** evaluate VGL of electron iat skipping the basis functions which vanish at its position
+   * @param ranges the ranges of the evaluated basis functions, sorted and not overlapping
+   *
+   * Only the entries of vgl within ranges are updated, the rest must be treated as zero.
+   */
+  virtual void evaluateVGLScreened(const ParticleSet& P, int iat, vgl_type& vgl, BasisRanges& ranges)
+  {
+    evaluateVGL(P, iat, vgl);
+    ranges.assign(1, {0, BasisSetSize});
+  }
+
+  /// same as evaluateVGLScreened but for values only
+  virtual void evaluateVScreened(const ParticleSet& P, int iat, value_type* restrict vals, BasisRanges& ranges)
+  {
+    evaluateV(P, iat, vals);
+    ranges.assign(1, {0, BasisSetSize});
+  }
+
+  /** the ranges of the basis functions with a nonzero gradient with respect to ion jion
+   *
+   * Only the entries of evaluateGradSourceV and evaluateGradSourceVGL output within ranges need to be used.
+   */
+  virtual void getGradSourceRanges(int jion, BasisRanges& ranges) const { ranges.assign(1, {0, BasisSetSize}); }
+
   virtual bool is_S_orbital(int mo_idx, int ao_idx) { return false; }
 
   /// Determine which orbitals are S-type.  Used for cusp correction.
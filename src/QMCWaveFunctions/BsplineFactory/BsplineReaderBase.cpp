@@ -21,11 +21,24 @@
 #include "BsplineReaderBase.h"
 #include "OhmmsData/AttributeSet.h"
 #include "Message/CommOperators.h"
+#include "Utilities/FairDivide.h"
+#include "OMPTarget/ScopedDefaultDevice.h"
+#include "ShardedSplineSet.h"
+#include "SplineCoefsCache.h"
+#include <iomanip>
+#include <sys/stat.h>
 
 namespace qmcplusplus
 {
 BsplineReaderBase::BsplineReaderBase(EinsplineSetBuilder* e)
-    : mybuilder(e), MeshSize(0), checkNorm(true), saveSplineCoefs(false), rotate(true)
+    : mybuilder(e),
+      MeshSize(0),
+      checkNorm(true),
+      saveSplineCoefs(false),
+      nodeSharedCoefs(false),
+      irreducibleKPoints(false),
+      rotate(true),
+      shardOverDevices(false)
 {
   myComm = mybuilder->getCommunicator();
 }
@@ -85,9 +98,14 @@ void BsplineReaderBase::setCommon(xmlNodePtr cur)
   // check orbital normalization by default
   std::string checkOrbNorm("yes");
   std::string saveCoefs("no");
+  std::string nodeShared("no");
+  std::string irreducible("no");
   OhmmsAttributeSet a;
   a.add(checkOrbNorm, "check_orb_norm");
   a.add(saveCoefs, "save_coefs");
+  a.add(coefsCacheDir, "coefs_cache");
+  a.add(nodeShared, "node_shared", {"no", "yes"});
+  a.add(irreducible, "irreducible_kpoints", {"no", "yes"});
   a.put(cur);
 
   // allow user to turn off norm check with a warning
@@ -97,6 +115,146 @@ void BsplineReaderBase::setCommon(xmlNodePtr cur)
     checkNorm = false;
   }
   saveSplineCoefs = saveCoefs == "yes";
+  nodeSharedCoefs    = nodeShared == "yes";
+  irreducibleKPoints = irreducible == "yes";
+}
+
+std::uint64_t BsplineReaderBase::coefs_cache_key(const BandInfoGroup& bandgroup,
+                                                 const std::string& classname,
+                                                 int sizeof_data,
+                                                 const TinyVector<int, 3>& halfg) const
+{
+  std::ostringstream key;
+  key << std::setprecision(17);
+  // a rewritten orbital file invalidates the cache
+  struct stat h5_stat;
+  key << mybuilder->H5FileName;
+  if (stat(mybuilder->H5FileName.c_str(), &h5_stat) == 0)
+    key << " " << h5_stat.st_size << " " << h5_stat.st_mtime;
+  key << " " << classname << " " << sizeof_data << " " << bandgroup.myName << " " << MeshSize << " " << halfg << " "
+      << rotate << " " << irreducibleKPoints << " " << bandgroup.getFirstSPO() << " " << bandgroup.getNumSPOs();
+  for (const BandInfo& band : bandgroup.myBands)
+    key << " " << band.TwistIndex << " " << band.BandIndex << " " << band.MakeTwoCopies << " "
+        << mybuilder->TwistAngles[band.TwistIndex];
+  return hashSplineCoefsKey(key.str());
+}
+
+std::string BsplineReaderBase::coefs_cache_filename(const BandInfoGroup& bandgroup, std::uint64_t key) const
+{
+  std::ostringstream oo;
+  oo << coefsCacheDir << "/" << bandgroup.myName << ".g" << MeshSize[0] << "x" << MeshSize[1] << "x" << MeshSize[2]
+     << "." << std::hex << std::setw(16) << std::setfill('0') << key << ".coefs";
+  return oo.str();
+}
+
+std::vector<Tensor<int, 3>> BsplineReaderBase::find_point_group() const
+{
+  constexpr double tol = 1.0e-6;
+  const auto& prim     = mybuilder->PrimCell;
+  Tensor<double, 3> metric(dot(prim.R, transpose(prim.R)));
+  double metric_scale = 0.0;
+  for (int i = 0; i < 9; i++)
+    metric_scale = std::max(metric_scale, std::abs(metric[i]));
+
+  std::vector<TinyVector<double, 3>> ion_u;
+  std::vector<int> ion_group;
+  if (mybuilder->SourcePtcl != nullptr)
+    for (int iat = 0; iat < mybuilder->SourcePtcl->getTotalNum(); iat++)
+    {
+      ion_u.push_back(prim.toUnit(mybuilder->SourcePtcl->R[iat]));
+      ion_group.push_back(mybuilder->SourcePtcl->GroupID[iat]);
+    }
+  else
+    app_warning() << "No ions to find the point group, only the symmetry of the lattice is used." << std::endl;
+
+  auto is_integer = [&](const TinyVector<double, 3>& v) {
+    for (int i = 0; i < 3; i++)
+      if (std::abs(v[i] - std::round(v[i])) > tol)
+        return false;
+    return true;
+  };
+
+  std::vector<Tensor<int, 3>> ops(1, Tensor<int, 3>(1, 0, 0, 0, 1, 0, 0, 0, 1));
+  for (int code = 0; code < 19683; code++)
+  {
+    Tensor<int, 3> op;
+    Tensor<double, 3> op_d;
+    for (int i = 0, c = code; i < 9; i++, c /= 3)
+    {
+      op[i]   = c % 3 - 1;
+      op_d[i] = op[i];
+    }
+    if (op == ops[0] || std::abs(det(op)) != 1)
+      continue;
+    // an operation of the lattice preserves the metric, N^T g N = g
+    const Tensor<double, 3> metric_op(dot(transpose(op_d), dot(metric, op_d)));
+    bool is_symmetry = true;
+    for (int i = 0; i < 9; i++)
+      is_symmetry = is_symmetry && std::abs(metric_op[i] - metric[i]) < tol * metric_scale;
+    // and maps every ion onto an ion of the same species
+    for (int iat = 0; iat < ion_u.size() && is_symmetry; iat++)
+    {
+      const TinyVector<double, 3> u(dot(op_d, ion_u[iat]));
+      bool found = false;
+      for (int jat = 0; jat < ion_u.size() && !found; jat++)
+        found = ion_group[jat] == ion_group[iat] && is_integer(u - ion_u[jat]);
+      is_symmetry = found;
+    }
+    if (is_symmetry)
+      ops.push_back(op);
+  }
+  return ops;
+}
+
+int BsplineReaderBase::find_kpoint_images(const BandInfoGroup& bandgroup,
+                                          const std::vector<Tensor<int, 3>>& ops,
+                                          std::vector<int>& band_op,
+                                          std::vector<int>& band_source,
+                                          std::vector<TinyVector<double, 3>>& band_twist) const
+{
+  constexpr double tol               = 1.0e-6;
+  const std::vector<BandInfo>& bands = bandgroup.myBands;
+  const int N                        = bandgroup.getNumDistinctOrbitals();
+  band_op.assign(N, 0);
+  band_source.resize(N);
+  band_twist.resize(N);
+  std::vector<int> sources;
+  for (int iorb = 0; iorb < N; iorb++)
+  {
+    const TinyVector<double, 3>& twist = mybuilder->TwistAngles[bands[iorb].TwistIndex];
+    band_source[iorb]                  = iorb;
+    band_twist[iorb]                   = twist;
+    for (int is = 0; is < sources.size() && band_op[iorb] == 0; is++)
+    {
+      const int source = sources[is];
+      if (bands[source].BandIndex != bands[iorb].BandIndex)
+        continue;
+      const TinyVector<double, 3>& source_twist = mybuilder->TwistAngles[bands[source].TwistIndex];
+      for (int o = 1; o < ops.size(); o++)
+      {
+        TinyVector<double, 3> image_twist;
+        for (int i = 0; i < 3; i++)
+          image_twist[i] = ops[o](0, i) * source_twist[0] + ops[o](1, i) * source_twist[1] +
+              ops[o](2, i) * source_twist[2];
+        bool same_twist = true;
+        for (int i = 0; i < 3; i++)
+        {
+          const double diff = image_twist[i] - twist[i];
+          same_twist        = same_twist && std::abs(diff - std::round(diff)) < tol;
+        }
+        if (same_twist)
+        {
+          band_op[iorb]     = o;
+          band_source[iorb] = source;
+          band_twist[iorb]  = image_twist;
+          break;
+        }
+      }
+    }
+    if (band_op[iorb] == 0)
+      sources.push_back(iorb);
+  }
+  return sources.size();
 }
 
 std::unique_ptr<SPOSet> BsplineReaderBase::create_spline_set(int spin, xmlNodePtr cur)
@@ -129,6 +287,8 @@ std::unique_ptr<SPOSet> BsplineReaderBase::create_spline_set(int spin, xmlNodePt
   vals.myName = make_bandgroup_name(mybuilder->getName(), spin, mybuilder->twist_num_, mybuilder->TileMatrix, 0, ns);
   vals.selectBands(fullband, 0, ns, false);
 
+  if (shardOverDevices)
+    return create_sharded_spline_set(spin, vals);
   return create_spline_set(spin, vals);
 }
 
@@ -156,9 +316,58 @@ std::unique_ptr<SPOSet> BsplineReaderBase::create_spline_set(int spin, xmlNodePt
   vals.selectBands(fullband, spo2band[spin][input_info.min_index()], input_info.max_index() - input_info.min_index(),
                    false);
 
+  if (shardOverDevices)
+    return create_sharded_spline_set(spin, vals);
   return create_spline_set(spin, vals);
 }
 
+std::unique_ptr<SPOSet> BsplineReaderBase::create_sharded_spline_set(int spin, const BandInfoGroup& bandgroup)
+{
+  const int num_devices = getNumOffloadDevices();
+  const int num_bands   = bandgroup.getNumDistinctOrbitals();
+  const int num_shards  = std::min(num_devices, num_bands);
+  if (!canShardOverDevices() || num_shards < 2)
+  {
+    app_log() << "  Spline bands are not split over devices. The spline set supports it: " << std::boolalpha
+              << canShardOverDevices() << ". Number of offload devices: " << num_devices << std::endl;
+    return create_spline_set(spin, bandgroup);
+  }
+
+  std::vector<int> band_offsets(num_shards + 1, 0);
+  FairDivideLow(num_bands, num_shards, band_offsets);
+
+  auto sharded_set    = std::make_unique<ShardedSplineSet>();
+  const int first_dev = getDefaultOffloadDevice();
+  const int last_spo  = bandgroup.getLastSPO();
+  int first_spo       = bandgroup.getFirstSPO();
+  for (int ishard = 0; ishard < num_shards; ishard++)
+  {
+    BandInfoGroup shard;
+    shard.GroupID    = bandgroup.GroupID;
+    shard.TwistIndex = bandgroup.TwistIndex;
+    shard.FirstBand  = bandgroup.FirstBand + band_offsets[ishard];
+    shard.FirstSPO   = first_spo;
+    shard.NumSPOs    = 0;
+    shard.myName     = bandgroup.myName + ".shard" + std::to_string(ishard);
+    // count two copies in the same way as check_twists of the full set
+    for (int ib = band_offsets[ishard]; ib < band_offsets[ishard + 1]; ib++)
+    {
+      shard.myBands.push_back(bandgroup.myBands[ib]);
+      shard.NumSPOs += (bandgroup.myBands[ib].MakeTwoCopies && first_spo + shard.NumSPOs + 1 < last_spo) ? 2 : 1;
+    }
+    first_spo += shard.NumSPOs;
+
+    const int device_num = (first_dev + ishard) % num_devices;
+    app_log() << "  Shard " << ishard << " holds orbitals [" << shard.getFirstSPO() << ", " << shard.getLastSPO()
+              << ") on OpenMP device " << device_num << std::endl;
+    // all the device memory of the shard is allocated on its own device
+    ScopedDefaultDevice device_scope(device_num);
+    sharded_set->addShard(create_spline_set(spin, shard), device_num);
+  }
+  sharded_set->setOrbitalSetSize(bandgroup.getNumSPOs());
+  return sharded_set;
+}
+
 /** build index tables to map a state to band with k-point folidng
    * @param bigspace full BandInfo constructed by EinsplineSetBuilder
    * @param sposet SPOSetInfo owned by someone, most likely EinsplinseSetBuilder
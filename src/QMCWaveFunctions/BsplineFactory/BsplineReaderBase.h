@@ -21,6 +21,7 @@
 #define QMCPLUSPLUS_BSPLINE_READER_BASE_H
 #include "mpi/collectives.h"
 #include "mpi/point2point.h"
+#include <cstdint>
 namespace qmcplusplus
 {
 struct SPOSetInputInfo;
@@ -44,8 +45,16 @@ struct BsplineReaderBase
   bool checkNorm;
   ///save spline coefficients to storage
   bool saveSplineCoefs;
+  ///directory of the binary spline coefficient cache, empty if disabled
+  std::string coefsCacheDir;
+  ///store the coefficient table once per node instead of on every rank
+  bool nodeSharedCoefs;
+  ///store only the bands of the irreducible twists and evaluate the others by symmetry
+  bool irreducibleKPoints;
   ///apply orbital rotations
   bool rotate;
+  ///split the bands over the offload devices of this rank
+  bool shardOverDevices;
   ///map from spo index to band index
   std::vector<std::vector<int>> spo2band;
 
@@ -163,6 +172,43 @@ struct BsplineReaderBase
    */
   void get_psi_g(int ti, int spin, int ib, Vector<std::complex<double>>& cG);
 
+  /** return the key of the binary coefficient cache of a band group
+   * hashes the orbital file and all the reader settings the coefficients depend on
+   * @param bandgroup band group of the spline set
+   * @param classname class name of the spline set
+   * @param sizeof_data size of the coefficient data type
+   * @param halfg HalfG of the spline set
+   */
+  std::uint64_t coefs_cache_key(const BandInfoGroup& bandgroup,
+                                const std::string& classname,
+                                int sizeof_data,
+                                const TinyVector<int, 3>& halfg) const;
+
+  /// return the binary coefficient cache file of a band group
+  std::string coefs_cache_filename(const BandInfoGroup& bandgroup, std::uint64_t key) const;
+
+  /** return the point group operations of the primitive cell mapping the ions onto themselves
+   * The operations N act on the reduced coordinates of the primitive cell, the identity is the first.
+   * Only the operations without a fractional translation and with all the matrix elements in {-1,0,1} are found.
+   */
+  std::vector<Tensor<int, 3>> find_point_group() const;
+
+  /** find the bands which are the images of other bands by a point group operation
+   * @param bandgroup band group of the spline set
+   * @param ops point group operations, see find_point_group
+   * @param band_op operation of each band, 0 for the bands to be splined
+   * @param band_source band of which each band is the image, psi_band(u) = psi_source(N u)
+   * @param band_twist twist of the orbital of each band, N^T applied to the twist of its source
+   * @return the number of bands to be splined
+   *
+   * The image of band b at twist k is band b at a twist equal to N^T k up to a reciprocal lattice vector.
+   */
+  int find_kpoint_images(const BandInfoGroup& bandgroup,
+                         const std::vector<Tensor<int, 3>>& ops,
+                         std::vector<int>& band_op,
+                         std::vector<int>& band_source,
+                         std::vector<TinyVector<double, 3>>& band_twist) const;
+
   /** create the actual spline sets
    */
   virtual std::unique_ptr<SPOSet> create_spline_set(int spin, const BandInfoGroup& bandgroup) = 0;
@@ -177,6 +223,17 @@ struct BsplineReaderBase
   /** create the spline set */
   std::unique_ptr<SPOSet> create_spline_set(int spin, xmlNodePtr cur);
 
+  /** create a ShardedSplineSet with one band slice per offload device
+   * falls back to a single spline set if the spline type cannot be sharded or there is only one device
+   */
+  std::unique_ptr<SPOSet> create_sharded_spline_set(int spin, const BandInfoGroup& bandgroup);
+
+  /// return true if the spline sets created by this reader can hold a band slice, see is_band_shardable
+  virtual bool canShardOverDevices() const { return false; }
+
+  /** Set the flag of splitting the bands over the offload devices of this rank */
+  inline void setShardOverDevices(bool new_shard) { shardOverDevices = new_shard; }
+
   /** Set the checkNorm variable */
   inline void setCheckNorm(bool new_checknorm) { checkNorm = new_checknorm; };
 
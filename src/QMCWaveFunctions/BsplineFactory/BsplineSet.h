@@ -21,6 +21,7 @@
 #ifndef QMCPLUSPLUS_BSPLINESET_H
 #define QMCPLUSPLUS_BSPLINESET_H
 
+#include <type_traits>
 #include "QMCWaveFunctions/SPOSet.h"
 #include "spline/einspline_engine.hpp"
 #include "spline/einspline_util.hpp"
@@ -112,6 +113,7 @@ public:
   using SPOSet::mw_evaluateDetRatios;
   using SPOSet::mw_evaluateVGL;
   using SPOSet::mw_evaluateVGLandDetRatioGrads;
+  using SPOSet::mw_evaluateVandDetRatio;
 
   using SPOSet::acquireResource;
   using SPOSet::createResource;
@@ -251,5 +253,26 @@ public:
   friend struct BsplineReaderBase;
 };
 
+/** tells if a spline set holding only a band slice writes only its orbitals [first_spo, last_spo)
+ * Such spline sets can be used as the shards of ShardedSplineSet.
+ */
+template<typename SA>
+struct is_band_shardable : std::false_type
+{};
+
+/** tells if the table of a spline set can be stored once per node by share_tables_on_node
+ * The host table must be the only copy of the coefficients, which excludes the offload and hybrid sets.
+ */
+template<typename SA>
+struct is_node_shareable : std::false_type
+{};
+
+/** tells if a spline set can evaluate the orbitals of symmetry related twists from those of the irreducible ones
+ * The spline set must have a SplineKPointImages member kpoint_images_ used by all its evaluation functions.
+ */
+template<typename SA>
+struct is_kpoint_unfoldable : std::false_type
+{};
+
 } // namespace qmcplusplus
 #endif
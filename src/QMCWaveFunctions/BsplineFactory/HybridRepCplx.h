@@ -37,10 +37,12 @@ public:
   using RealType         = typename SPLINEBASE::RealType;
   // types for evaluation results
   using typename SPLINEBASE::GGGVector;
+  using typename SPLINEBASE::GradType;
   using typename SPLINEBASE::GradVector;
   using typename SPLINEBASE::HessVector;
   using typename SPLINEBASE::ValueType;
   using typename SPLINEBASE::ValueVector;
+  using typename SPLINEBASE::VGLVector;
 
 private:
   ValueVector psi_AO, d2psi_AO;
@@ -157,6 +159,52 @@ public:
     }
   }
 
+  /** split the walkers by the region of their quadrature points
+   *
+   * Walkers with all the quadrature points inside an atomic region are completed with the atomic orbitals only.
+   * The rest go through the B-spline orbitals in a second pass.
+   */
+  void mw_evaluateDetRatios(const RefVectorWithLeader<SPOSet>& spo_list,
+                            const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                            const RefVector<ValueVector>& psi_list,
+                            const std::vector<const ValueType*>& invRow_ptr_list,
+                            std::vector<std::vector<ValueType>>& ratios_list) const override
+  {
+    assert(this == &spo_list.getLeader());
+    const size_t nw = spo_list.size();
+    const RealType cone(1);
+    std::vector<char> in_atomic_region(nw, 0);
+
+#pragma omp parallel for
+    for (int iw = 0; iw < nw; iw++)
+    {
+      auto& spo                    = spo_list.template getCastedElement<HybridRepCplx>(iw);
+      const VirtualParticleSet& VP = vp_list[iw];
+      if (!VP.isOnSphere())
+        continue;
+      if (spo.multi_myV.rows() < VP.getTotalNum())
+        spo.multi_myV.resize(VP.getTotalNum(), spo.myV.size());
+      if (spo.HYBRIDBASE::evaluateValuesC2X(VP, spo.multi_myV) != cone)
+        continue;
+      in_atomic_region[iw] = 1;
+      ValueVector& psi     = psi_list[iw];
+      for (int iat = 0; iat < VP.getTotalNum(); ++iat)
+      {
+        Vector<ST, aligned_allocator<ST>> myV_one(spo.multi_myV[iat], spo.myV.size());
+        spo.SPLINEBASE::assign_v(VP.R[iat], myV_one, psi, 0, spo.myV.size() / 2);
+        ratios_list[iw][iat] = simd::dot(psi.data(), invRow_ptr_list[iw], psi.size());
+      }
+    }
+
+#pragma omp parallel for
+    for (int iw = 0; iw < nw; iw++)
+      if (!in_atomic_region[iw])
+      {
+        Vector<ValueType> invRow(const_cast<ValueType*>(invRow_ptr_list[iw]), psi_list[iw].get().size());
+        spo_list[iw].evaluateDetRatios(vp_list[iw], psi_list[iw], invRow, ratios_list[iw]);
+      }
+  }
+
   void evaluateVGL(const ParticleSet& P, const int iat, ValueVector& psi, GradVector& dpsi, ValueVector& d2psi) override
   {
     const RealType smooth_factor = HYBRIDBASE::evaluate_vgl(P, iat, myV, myG, myL);
@@ -182,6 +230,101 @@ public:
     }
   }
 
+  /** split the walkers into atomic-region and interstitial sets
+   *
+   * The atomic orbitals of all the electrons inside the atomic regions are evaluated in a first pass.
+   * The B-spline orbitals are only evaluated for the electrons in the interstitial and buffer regions
+   * in a second pass, which also blends the buffer region.
+   */
+  void mw_evaluateVGL(const RefVectorWithLeader<SPOSet>& sa_list,
+                      const RefVectorWithLeader<ParticleSet>& P_list,
+                      int iat,
+                      const RefVector<ValueVector>& psi_v_list,
+                      const RefVector<GradVector>& dpsi_v_list,
+                      const RefVector<ValueVector>& d2psi_v_list) const override
+  {
+    assert(this == &sa_list.getLeader());
+    const size_t nw = sa_list.size();
+    const RealType cone(1);
+    std::vector<RealType> smooth_factors(nw);
+
+#pragma omp parallel for
+    for (int iw = 0; iw < nw; iw++)
+    {
+      auto& spo          = sa_list.template getCastedElement<HybridRepCplx>(iw);
+      smooth_factors[iw] = spo.HYBRIDBASE::evaluate_vgl(P_list[iw], iat, spo.myV, spo.myG, spo.myL);
+      if (smooth_factors[iw] < 0)
+        continue;
+      const PointType& r = P_list[iw].activeR(iat);
+      if (smooth_factors[iw] == cone)
+        spo.SPLINEBASE::assign_vgl_from_l(r, psi_v_list[iw], dpsi_v_list[iw], d2psi_v_list[iw]);
+      else
+      {
+        // myV, myG and myL get overwritten by the B-spline orbitals of the second pass
+        const size_t norb = psi_v_list[iw].get().size();
+        spo.psi_AO.resize(norb);
+        spo.dpsi_AO.resize(norb);
+        spo.d2psi_AO.resize(norb);
+        spo.SPLINEBASE::assign_vgl_from_l(r, spo.psi_AO, spo.dpsi_AO, spo.d2psi_AO);
+      }
+    }
+
+    std::vector<int> spline_walkers;
+    spline_walkers.reserve(nw);
+    for (int iw = 0; iw < nw; iw++)
+      if (smooth_factors[iw] != cone)
+        spline_walkers.push_back(iw);
+
+#pragma omp parallel for
+    for (int iwalker = 0; iwalker < spline_walkers.size(); iwalker++)
+    {
+      const int iw = spline_walkers[iwalker];
+      auto& spo    = sa_list.template getCastedElement<HybridRepCplx>(iw);
+      spo.SPLINEBASE::evaluateVGL(P_list[iw], iat, psi_v_list[iw], dpsi_v_list[iw], d2psi_v_list[iw]);
+      if (smooth_factors[iw] >= 0)
+        spo.HYBRIDBASE::interpolate_buffer_vgl(psi_v_list[iw].get(), dpsi_v_list[iw].get(), d2psi_v_list[iw].get(),
+                                               spo.psi_AO, spo.dpsi_AO, spo.d2psi_AO);
+    }
+  }
+
+  void mw_evaluateVGLandDetRatioGrads(const RefVectorWithLeader<SPOSet>& spo_list,
+                                      const RefVectorWithLeader<ParticleSet>& P_list,
+                                      int iat,
+                                      const std::vector<const ValueType*>& invRow_ptr_list,
+                                      VGLVector& phi_vgl_v,
+                                      std::vector<ValueType>& ratios,
+                                      std::vector<GradType>& grads) const override
+  {
+    assert(this == &spo_list.getLeader());
+    const size_t nw             = spo_list.size();
+    const size_t norb_requested = phi_vgl_v.size() / nw;
+
+    std::vector<ValueVector> phi_v, d2phi_v;
+    std::vector<GradVector> dphi_v;
+    phi_v.reserve(nw);
+    dphi_v.reserve(nw);
+    d2phi_v.reserve(nw);
+    RefVector<ValueVector> phi_v_list, d2phi_v_list;
+    RefVector<GradVector> dphi_v_list;
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      phi_v.emplace_back(phi_vgl_v.data() + norb_requested * iw, norb_requested);
+      dphi_v.emplace_back(reinterpret_cast<GradType*>(phi_vgl_v.data(1)) + norb_requested * iw, norb_requested);
+      d2phi_v.emplace_back(phi_vgl_v.data(4) + norb_requested * iw, norb_requested);
+      phi_v_list.push_back(phi_v.back());
+      dphi_v_list.push_back(dphi_v.back());
+      d2phi_v_list.push_back(d2phi_v.back());
+    }
+
+    mw_evaluateVGL(spo_list, P_list, iat, phi_v_list, dphi_v_list, d2phi_v_list);
+
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      ratios[iw] = simd::dot(invRow_ptr_list[iw], phi_v[iw].data(), norb_requested);
+      grads[iw]  = simd::dot(invRow_ptr_list[iw], dphi_v[iw].data(), norb_requested) / ratios[iw];
+    }
+  }
+
   void evaluateVGH(const ParticleSet& P,
                    const int iat,
                    ValueVector& psi,
@@ -151,6 +151,10 @@ public:
 
   HybridRepSetReader(EinsplineSetBuilder* e) : BaseReader(e) {}
 
+  /// the atomic center orbitals are not part of the multi spline table
+  bool canCacheCoefs() const override { return false; }
+  bool needs_double_psi_g() const override { return true; }
+
   /** initialize basic parameters of atomic orbitals */
   void initialize_hybridrep_atomic_centers() override
   {
@@ -0,0 +1,241 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "ShardedSplineSet.h"
+#include <algorithm>
+#include <cassert>
+#include "CPU/SIMD/simd.hpp"
+#include "OMPTarget/ScopedDefaultDevice.h"
+
+namespace qmcplusplus
+{
+ShardedSplineSet::ShardedSplineSet()
+{
+  className = "ShardedSplineSet";
+}
+
+ShardedSplineSet::ShardedSplineSet(const ShardedSplineSet& in) : SPOSet(in), device_nums_(in.device_nums_)
+{
+  shards_.reserve(in.shards_.size());
+  for (size_t ishard = 0; ishard < in.shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_.push_back(in.shards_[ishard]->makeClone());
+  }
+}
+
+ShardedSplineSet::~ShardedSplineSet()
+{
+  // device memory owned by a shard is released on its own device
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_[ishard].reset();
+  }
+}
+
+void ShardedSplineSet::addShard(std::unique_ptr<SPOSet> shard, int device_num)
+{
+  shards_.push_back(std::move(shard));
+  device_nums_.push_back(device_num);
+}
+
+std::unique_ptr<SPOSet> ShardedSplineSet::makeClone() const { return std::make_unique<ShardedSplineSet>(*this); }
+
+void ShardedSplineSet::finalizeConstruction()
+{
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_[ishard]->finalizeConstruction();
+  }
+}
+
+RefVectorWithLeader<SPOSet> ShardedSplineSet::extractShardList(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                                size_t ishard)
+{
+  auto& leader = spo_list.getCastedLeader<ShardedSplineSet>();
+  RefVectorWithLeader<SPOSet> shard_list(*leader.shards_[ishard]);
+  shard_list.reserve(spo_list.size());
+  for (int iw = 0; iw < spo_list.size(); iw++)
+    shard_list.push_back(*spo_list.getCastedElement<ShardedSplineSet>(iw).shards_[ishard]);
+  return shard_list;
+}
+
+void ShardedSplineSet::createResource(ResourceCollection& collection) const
+{
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_[ishard]->createResource(collection);
+  }
+}
+
+void ShardedSplineSet::acquireResource(ResourceCollection& collection,
+                                       const RefVectorWithLeader<SPOSet>& spo_list) const
+{
+  assert(this == &spo_list.getLeader());
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    auto shard_list = extractShardList(spo_list, ishard);
+    shard_list.getLeader().acquireResource(collection, shard_list);
+  }
+}
+
+void ShardedSplineSet::releaseResource(ResourceCollection& collection,
+                                       const RefVectorWithLeader<SPOSet>& spo_list) const
+{
+  assert(this == &spo_list.getLeader());
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    auto shard_list = extractShardList(spo_list, ishard);
+    shard_list.getLeader().releaseResource(collection, shard_list);
+  }
+}
+
+void ShardedSplineSet::evaluateValue(const ParticleSet& P, int iat, ValueVector& psi)
+{
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_[ishard]->evaluateValue(P, iat, psi);
+  }
+}
+
+void ShardedSplineSet::evaluateDetRatios(const VirtualParticleSet& VP,
+                                         ValueVector& psi,
+                                         const ValueVector& psiinv,
+                                         std::vector<ValueType>& ratios)
+{
+  std::fill(ratios.begin(), ratios.end(), ValueType(0));
+  shard_ratios_.resize(ratios.size());
+  // each shard only sums over its own orbitals
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_[ishard]->evaluateDetRatios(VP, psi, psiinv, shard_ratios_);
+    for (size_t i = 0; i < ratios.size(); i++)
+      ratios[i] += shard_ratios_[i];
+  }
+}
+
+void ShardedSplineSet::mw_evaluateDetRatios(const RefVectorWithLeader<SPOSet>& spo_list,
+                                            const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                                            const RefVector<ValueVector>& psi_list,
+                                            const std::vector<const ValueType*>& invRow_ptr_list,
+                                            std::vector<std::vector<ValueType>>& ratios_list) const
+{
+  assert(this == &spo_list.getLeader());
+  // invRow is on the host because this SPOSet doesn't claim OpenMP offload
+  for (int iw = 0; iw < spo_list.size(); iw++)
+  {
+    Vector<ValueType> invRow(const_cast<ValueType*>(invRow_ptr_list[iw]), psi_list[iw].get().size());
+    spo_list[iw].evaluateDetRatios(vp_list[iw], psi_list[iw], invRow, ratios_list[iw]);
+  }
+}
+
+void ShardedSplineSet::evaluateVGL(const ParticleSet& P,
+                                   int iat,
+                                   ValueVector& psi,
+                                   GradVector& dpsi,
+                                   ValueVector& d2psi)
+{
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_[ishard]->evaluateVGL(P, iat, psi, dpsi, d2psi);
+  }
+}
+
+void ShardedSplineSet::mw_evaluateVGL(const RefVectorWithLeader<SPOSet>& spo_list,
+                                      const RefVectorWithLeader<ParticleSet>& P_list,
+                                      int iat,
+                                      const RefVector<ValueVector>& psi_v_list,
+                                      const RefVector<GradVector>& dpsi_v_list,
+                                      const RefVector<ValueVector>& d2psi_v_list) const
+{
+  assert(this == &spo_list.getLeader());
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    auto shard_list = extractShardList(spo_list, ishard);
+    shard_list.getLeader().mw_evaluateVGL(shard_list, P_list, iat, psi_v_list, dpsi_v_list, d2psi_v_list);
+  }
+}
+
+void ShardedSplineSet::mw_evaluateVGLandDetRatioGrads(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                      const RefVectorWithLeader<ParticleSet>& P_list,
+                                                      int iat,
+                                                      const std::vector<const ValueType*>& invRow_ptr_list,
+                                                      VGLVector& phi_vgl_v,
+                                                      std::vector<ValueType>& ratios,
+                                                      std::vector<GradType>& grads) const
+{
+  assert(this == &spo_list.getLeader());
+  const size_t nw             = spo_list.size();
+  const size_t norb_requested = phi_vgl_v.size() / nw;
+
+  // views of phi_vgl_v with the same layout as SPOSet::mw_evaluateVGLandDetRatioGrads
+  std::vector<ValueVector> phi_v, d2phi_v;
+  std::vector<GradVector> dphi_v;
+  phi_v.reserve(nw);
+  dphi_v.reserve(nw);
+  d2phi_v.reserve(nw);
+  RefVector<ValueVector> phi_v_list, d2phi_v_list;
+  RefVector<GradVector> dphi_v_list;
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    phi_v.emplace_back(phi_vgl_v.data() + norb_requested * iw, norb_requested);
+    dphi_v.emplace_back(reinterpret_cast<GradType*>(phi_vgl_v.data(1)) + norb_requested * iw, norb_requested);
+    d2phi_v.emplace_back(phi_vgl_v.data(4) + norb_requested * iw, norb_requested);
+    phi_v_list.push_back(phi_v.back());
+    dphi_v_list.push_back(dphi_v.back());
+    d2phi_v_list.push_back(d2phi_v.back());
+  }
+
+  mw_evaluateVGL(spo_list, P_list, iat, phi_v_list, dphi_v_list, d2phi_v_list);
+
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    ratios[iw] = simd::dot(invRow_ptr_list[iw], phi_v[iw].data(), norb_requested);
+    grads[iw]  = simd::dot(invRow_ptr_list[iw], dphi_v[iw].data(), norb_requested) / ratios[iw];
+  }
+}
+
+void ShardedSplineSet::evaluateVGH(const ParticleSet& P,
+                                   int iat,
+                                   ValueVector& psi,
+                                   GradVector& dpsi,
+                                   HessVector& grad_grad_psi)
+{
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_[ishard]->evaluateVGH(P, iat, psi, dpsi, grad_grad_psi);
+  }
+}
+
+void ShardedSplineSet::evaluate_notranspose(const ParticleSet& P,
+                                            int first,
+                                            int last,
+                                            ValueMatrix& logdet,
+                                            GradMatrix& dlogdet,
+                                            ValueMatrix& d2logdet)
+{
+  for (size_t ishard = 0; ishard < shards_.size(); ishard++)
+  {
+    ScopedDefaultDevice device_scope(device_nums_[ishard]);
+    shards_[ishard]->evaluate_notranspose(P, first, last, logdet, dlogdet, d2logdet);
+  }
+}
+
+} // namespace qmcplusplus
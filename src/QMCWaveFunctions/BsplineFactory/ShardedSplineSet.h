@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file ShardedSplineSet.h
+ *
+ * spline orbitals with the bands split over the offload devices of a rank
+ */
+#ifndef QMCPLUSPLUS_SHARDED_SPLINESET_H
+#define QMCPLUSPLUS_SHARDED_SPLINESET_H
+
+#include <memory>
+#include <vector>
+#include "QMCWaveFunctions/SPOSet.h"
+
+namespace qmcplusplus
+{
+/** orbital set made of band slices, each held by a spline set on its own offload device
+ *
+ * Each shard holds the coefficient table of a contiguous band slice and writes only its orbitals
+ * [first_spo, last_spo) into the output of the full orbital set. Shards are evaluated one after another
+ * with the OpenMP default device switched to the device holding the shard.
+ * The outputs are assembled on the host, so the determinants are handed host pointers.
+ * Intended for running one rank with several devices when a single table exceeds the memory of one device.
+ */
+class ShardedSplineSet : public SPOSet
+{
+public:
+  ShardedSplineSet();
+  ShardedSplineSet(const ShardedSplineSet& in);
+  ~ShardedSplineSet() override;
+
+  /** add a band slice
+   * @param shard spline set holding the band slice, created with device_num as the default device
+   * @param device_num OpenMP device holding the shard
+   */
+  void addShard(std::unique_ptr<SPOSet> shard, int device_num);
+
+  size_t getNumShards() const { return shards_.size(); }
+
+  void setOrbitalSetSize(int norbs) override { OrbitalSetSize = norbs; }
+
+  std::unique_ptr<SPOSet> makeClone() const override;
+
+  void resetParameters(const opt_variables_type& active) override {}
+
+  void finalizeConstruction() override;
+
+  void createResource(ResourceCollection& collection) const override;
+
+  void acquireResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const override;
+
+  void releaseResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const override;
+
+  void evaluateValue(const ParticleSet& P, int iat, ValueVector& psi) override;
+
+  void evaluateDetRatios(const VirtualParticleSet& VP,
+                         ValueVector& psi,
+                         const ValueVector& psiinv,
+                         std::vector<ValueType>& ratios) override;
+
+  void mw_evaluateDetRatios(const RefVectorWithLeader<SPOSet>& spo_list,
+                            const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                            const RefVector<ValueVector>& psi_list,
+                            const std::vector<const ValueType*>& invRow_ptr_list,
+                            std::vector<std::vector<ValueType>>& ratios_list) const override;
+
+  void evaluateVGL(const ParticleSet& P, int iat, ValueVector& psi, GradVector& dpsi, ValueVector& d2psi) override;
+
+  void mw_evaluateVGL(const RefVectorWithLeader<SPOSet>& spo_list,
+                      const RefVectorWithLeader<ParticleSet>& P_list,
+                      int iat,
+                      const RefVector<ValueVector>& psi_v_list,
+                      const RefVector<GradVector>& dpsi_v_list,
+                      const RefVector<ValueVector>& d2psi_v_list) const override;
+
+  void mw_evaluateVGLandDetRatioGrads(const RefVectorWithLeader<SPOSet>& spo_list,
+                                      const RefVectorWithLeader<ParticleSet>& P_list,
+                                      int iat,
+                                      const std::vector<const ValueType*>& invRow_ptr_list,
+                                      VGLVector& phi_vgl_v,
+                                      std::vector<ValueType>& ratios,
+                                      std::vector<GradType>& grads) const override;
+
+  void evaluateVGH(const ParticleSet& P,
+                   int iat,
+                   ValueVector& psi,
+                   GradVector& dpsi,
+                   HessVector& grad_grad_psi) override;
+
+  void evaluate_notranspose(const ParticleSet& P,
+                            int first,
+                            int last,
+                            ValueMatrix& logdet,
+                            GradMatrix& dlogdet,
+                            ValueMatrix& d2logdet) override;
+
+private:
+  /// band slices
+  std::vector<std::unique_ptr<SPOSet>> shards_;
+  /// OpenMP device of each shard
+  std::vector<int> device_nums_;
+  /// ratios of a single shard
+  std::vector<ValueType> shard_ratios_;
+
+  /// collect the ishard-th shard of every walker
+  static RefVectorWithLeader<SPOSet> extractShardList(const RefVectorWithLeader<SPOSet>& spo_list, size_t ishard);
+};
+
+} // namespace qmcplusplus
+#endif
@@ -848,6 +848,123 @@ void SplineC2COMPTarget<ST>::mw_evaluateVGLandDetRatioGrads(const RefVectorWithL
     grads[iw] = GradType{grad_x / ratio, grad_y / ratio, grad_z / ratio};
   }
 }
+template<typename ST>
+void SplineC2COMPTarget<ST>::mw_evaluateVandDetRatio(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                     const RefVectorWithLeader<ParticleSet>& P_list,
+                                                     int iat,
+                                                     const std::vector<const ValueType*>& invRow_ptr_list,
+                                                     VGLVector& phi_vgl_v,
+                                                     std::vector<ValueType>& ratios) const
+{
+  assert(this == &spo_list.getLeader());
+  auto& phi_leader         = spo_list.getCastedLeader<SplineC2COMPTarget<ST>>();
+  auto& mw_mem             = *phi_leader.mw_mem_;
+  auto& buffer_H2D         = mw_mem.buffer_H2D;
+  auto& rg_private         = mw_mem.rg_private;
+  auto& mw_offload_scratch = mw_mem.mw_offload_scratch;
+  auto& mw_results_scratch = mw_mem.mw_results_scratch;
+  const int nwalkers       = spo_list.size();
+  buffer_H2D.resize(nwalkers, sizeof(ST) * 6 + sizeof(ValueType*));
+
+  // pack particle positions and invRow pointers.
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    const PointType& r = P_list[iw].activeR(iat);
+    PointType ru(PrimLattice.toUnit_floor(r));
+    Vector<ST> pos_copy(reinterpret_cast<ST*>(buffer_H2D[iw]), 6);
+
+    pos_copy[0] = r[0];
+    pos_copy[1] = r[1];
+    pos_copy[2] = r[2];
+    pos_copy[3] = ru[0];
+    pos_copy[4] = ru[1];
+    pos_copy[5] = ru[2];
+
+    auto& invRow_ptr = *reinterpret_cast<const ValueType**>(buffer_H2D[iw] + sizeof(ST) * 6);
+    invRow_ptr       = invRow_ptr_list[iw];
+  }
+
+  const size_t num_pos       = nwalkers;
+  const int ChunkSizePerTeam = 128;
+  const int NumTeams         = (myV.size() + ChunkSizePerTeam - 1) / ChunkSizePerTeam;
+  const auto padded_size     = myV.size();
+  // for V(1) intermediate result
+  mw_offload_scratch.resize(padded_size * num_pos);
+  const auto orb_size = phi_vgl_v.size() / num_pos;
+  // for V(1) final result
+  mw_results_scratch.resize(orb_size * num_pos);
+  // per team ratio
+  rg_private.resize(num_pos, NumTeams);
+
+  // Ye: need to extract sizes and pointers before entering target region
+  const auto* spline_ptr         = SplineInst->getSplinePtr();
+  auto* buffer_H2D_ptr           = buffer_H2D.data();
+  auto* offload_scratch_ptr      = mw_offload_scratch.data();
+  auto* results_scratch_ptr      = mw_results_scratch.data();
+  const auto myKcart_padded_size = myKcart->capacity();
+  auto* myKcart_ptr              = myKcart->data();
+  auto* phi_vgl_ptr              = phi_vgl_v.data();
+  auto* rg_private_ptr           = rg_private.data();
+  const size_t buffer_H2D_stride = buffer_H2D.cols();
+  const size_t first_spo_local   = first_spo;
+
+  {
+    ScopedTimer offload(offload_timer_);
+    PRAGMA_OFFLOAD("omp target teams distribute collapse(2) num_teams(NumTeams*num_pos) \
+                    map(always, to: buffer_H2D_ptr[:buffer_H2D.size()]) \
+                    map(always, from: rg_private_ptr[0:rg_private.size()])")
+    for (int iw = 0; iw < num_pos; iw++)
+      for (int team_id = 0; team_id < NumTeams; team_id++)
+      {
+        const int first = ChunkSizePerTeam * team_id;
+        const int last  = (first + ChunkSizePerTeam) > padded_size ? padded_size : first + ChunkSizePerTeam;
+        auto* restrict offload_scratch_iw_ptr = offload_scratch_ptr + padded_size * iw;
+        auto* restrict psi_iw_ptr             = results_scratch_ptr + orb_size * iw;
+        const auto* restrict pos_iw_ptr       = reinterpret_cast<ST*>(buffer_H2D_ptr + buffer_H2D_stride * iw);
+        const auto* restrict invRow_iw_ptr =
+            *reinterpret_cast<ValueType**>(buffer_H2D_ptr + buffer_H2D_stride * iw + sizeof(ST) * 6);
+
+        int ix, iy, iz;
+        ST a[4], b[4], c[4];
+        spline2::computeLocationAndFractional(spline_ptr, pos_iw_ptr[3], pos_iw_ptr[4], pos_iw_ptr[5], ix, iy, iz, a, b,
+                                              c);
+
+        PRAGMA_OFFLOAD("omp parallel for")
+        for (int index = 0; index < last - first; index++)
+          spline2offload::evaluate_v_impl_v2(spline_ptr, ix, iy, iz, a, b, c, offload_scratch_iw_ptr + first, first,
+                                             index);
+        const int first_cplx = first / 2;
+        const int last_cplx  = last / 2 < orb_size ? last / 2 : orb_size;
+        PRAGMA_OFFLOAD("omp parallel for")
+        for (int index = first_cplx; index < last_cplx; index++)
+          C2C::assign_v(pos_iw_ptr[0], pos_iw_ptr[1], pos_iw_ptr[2], psi_iw_ptr, orb_size, offload_scratch_iw_ptr,
+                        myKcart_ptr, myKcart_padded_size, first_spo_local, index);
+
+        ValueType* restrict out_phi_v = phi_vgl_ptr + iw * orb_size;
+
+        ValueType ratio(0);
+        PRAGMA_OFFLOAD("omp parallel for reduction(+: ratio)")
+        for (size_t j = first_cplx; j < last_cplx; j++)
+        {
+          const size_t psiIndex = first_spo_local + j;
+
+          out_phi_v[psiIndex] = psi_iw_ptr[psiIndex];
+          ratio += psi_iw_ptr[psiIndex] * invRow_iw_ptr[psiIndex];
+        }
+
+        rg_private_ptr[iw * NumTeams + team_id] = ratio;
+      }
+  }
+
+  for (int iw = 0; iw < num_pos; iw++)
+  {
+    ValueType ratio(0);
+    for (int team_id = 0; team_id < NumTeams; team_id++)
+      ratio += rg_private[iw][team_id];
+    ratios[iw] = ratio;
+  }
+}
+
 template<typename ST>
 void SplineC2COMPTarget<ST>::assign_vgh(const PointType& r,
                                         ValueVector& psi,
@@ -25,6 +25,8 @@
 #include "QMCWaveFunctions/BsplineFactory/BsplineSet.h"
 #include "OhmmsSoA/VectorSoaContainer.h"
 #include "spline2/MultiBspline.hpp"
+#include "QMCWaveFunctions/BsplineFactory/SplineKPointImages.h"
+#include "CPU/SIMD/LargePageAllocator.hpp"
 #include "Utilities/FairDivide.h"
 
 namespace qmcplusplus
@@ -67,7 +69,11 @@ private:
   ///number of complex bands
   int nComplexBands;
   ///multi bspline set
-  std::shared_ptr<MultiBspline<ST>> SplineInst;
+  std::shared_ptr<MultiBspline<ST, LargePageAllocator<ST>>> SplineInst;
+  ///coefficients of SplineInst stored once per node, only with share_tables_on_node
+  std::shared_ptr<NodeSharedArray<ST>> shared_coefs_;
+  ///bands evaluated from the splines of other bands, empty if every band is in SplineInst
+  SplineKPointImages<ST> kpoint_images_;
 
   vContainer_type mKK;
   VectorSoaContainer<ST, 3> myKcart;
@@ -106,11 +112,17 @@ public:
 
   void bcast_tables(Communicate* comm) { chunked_bcast(comm, SplineInst->getSplinePtr()); }
 
+  /// replaces bcast_tables, the table of the first rank of comm is stored once per node
+  void share_tables_on_node(Communicate* comm)
+  {
+    shared_coefs_ = qmcplusplus::share_tables_on_node<ST>(comm, *SplineInst);
+  }
+
   void gather_tables(Communicate* comm)
   {
     if (comm->size() == 1)
       return;
-    const int Nbands      = kPoints.size();
+    const int Nbands      = kpoint_images_.empty() ? kPoints.size() : kpoint_images_.getNumSources();
     const int Nbandgroups = comm->size();
     offset.resize(Nbandgroups + 1, 0);
     FairDivideLow(Nbands, Nbandgroups, offset);
@@ -124,8 +136,10 @@ public:
   void create_spline(GT& xyz_g, BCT& xyz_bc)
   {
     resize_kpoints();
-    SplineInst = std::make_shared<MultiBspline<ST>>();
-    SplineInst->create(xyz_g, xyz_bc, myV.size());
+    SplineInst = std::make_shared<MultiBspline<ST, LargePageAllocator<ST>>>();
+    const size_t num_splines =
+        kpoint_images_.empty() ? myV.size() : getAlignedSize<ST>(2 * kpoint_images_.getNumSources());
+    SplineInst->create(xyz_g, xyz_bc, num_splines);
 
     app_log() << "MEMORY " << SplineInst->sizeInByte() / (1 << 20) << " MB allocated "
               << "for the coefficients in 3D spline orbital representation" << std::endl;
@@ -140,6 +154,8 @@ public:
     // GPU CUDA code doesn't allow a change of the ordering
     nComplexBands = this->remap_kpoints();
 #endif
+    if (!kpoint_images_.empty())
+      kpoint_images_.sortColumns(kPoints, BandIndexMap, nComplexBands);
     int nk = kPoints.size();
     mKK.resize(nk);
     myKcart.resize(nk);
@@ -213,6 +229,14 @@ public:
   friend struct BsplineReaderBase;
 };
 
+template<typename ST>
+struct is_node_shareable<SplineC2R<ST>> : std::true_type
+{};
+
+template<typename ST>
+struct is_kpoint_unfoldable<SplineC2R<ST>> : std::true_type
+{};
+
 extern template class SplineC2R<float>;
 extern template class SplineC2R<double>;
 
@@ -254,6 +254,7 @@ void SplineC2ROMPTarget<ST>::evaluateValue(const ParticleSet& P, const int iat,
     const auto myKcart_padded_size = myKcart->capacity();
     auto* myKcart_ptr              = myKcart->data();
     const size_t first_spo_local   = first_spo;
+    const int num_cplx_local       = std::min<size_t>(orb_size, kPoints.size());
     const int nComplexBands_local  = nComplexBands;
 
     {
@@ -274,7 +275,7 @@ void SplineC2ROMPTarget<ST>::evaluateValue(const ParticleSet& P, const int iat,
           spline2offload::evaluate_v_impl_v2(spline_ptr, ix, iy, iz, a, b, c, offload_scratch_ptr + first, first,
                                              index);
         const int first_cplx = first / 2;
-        const int last_cplx  = last / 2 < orb_size ? last / 2 : orb_size;
+        const int last_cplx  = last / 2 < num_cplx_local ? last / 2 : num_cplx_local;
         PRAGMA_OFFLOAD("omp parallel for")
         for (int index = first_cplx; index < last_cplx; index++)
           C2R::assign_v(x, y, z, psi_ptr, orb_size, offload_scratch_ptr, myKcart_ptr, myKcart_padded_size,
@@ -327,6 +328,7 @@ void SplineC2ROMPTarget<ST>::evaluateDetRatios(const VirtualParticleSet& VP,
   auto* psiinv_ptr               = psiinv_pos_copy.data();
   auto* ratios_private_ptr       = ratios_private.data();
   const size_t first_spo_local   = first_spo;
+  const int num_cplx_local       = std::min<size_t>(orb_size, kPoints.size());
   const int nComplexBands_local  = nComplexBands;
 
   {
@@ -353,7 +355,7 @@ void SplineC2ROMPTarget<ST>::evaluateDetRatios(const VirtualParticleSet& VP,
           spline2offload::evaluate_v_impl_v2(spline_ptr, ix, iy, iz, a, b, c, offload_scratch_iat_ptr + first, first,
                                              index);
         const int first_cplx = first / 2;
-        const int last_cplx  = last / 2 < orb_size ? last / 2 : orb_size;
+        const int last_cplx  = last / 2 < num_cplx_local ? last / 2 : num_cplx_local;
         PRAGMA_OFFLOAD("omp parallel for")
         for (int index = first_cplx; index < last_cplx; index++)
           C2R::assign_v(ST(pos_scratch[iat * 6]), ST(pos_scratch[iat * 6 + 1]), ST(pos_scratch[iat * 6 + 2]),
@@ -364,7 +366,7 @@ void SplineC2ROMPTarget<ST>::evaluateDetRatios(const VirtualParticleSet& VP,
         const int last_real  = last_cplx + std::min(nComplexBands_local, last_cplx);
         TT sum(0);
         PRAGMA_OFFLOAD("omp parallel for simd reduction(+:sum)")
-        for (int i = first_real; i < last_real; i++)
+        for (int i = first_spo_local + first_real; i < first_spo_local + last_real; i++)
           sum += psi_iat_ptr[i] * psiinv_ptr[i];
         ratios_private_ptr[iat * NumTeams + team_id] = sum;
       }
@@ -448,6 +450,7 @@ void SplineC2ROMPTarget<ST>::mw_evaluateDetRatios(const RefVectorWithLeader<SPOS
   auto* buffer_H2D_ptr           = det_ratios_buffer_H2D.data();
   auto* ratios_private_ptr       = mw_ratios_private.data();
   const size_t first_spo_local   = first_spo;
+  const int num_cplx_local       = std::min<size_t>(orb_size, kPoints.size());
   const int nComplexBands_local  = nComplexBands;
 
   {
@@ -476,7 +479,7 @@ void SplineC2ROMPTarget<ST>::mw_evaluateDetRatios(const RefVectorWithLeader<SPOS
           spline2offload::evaluate_v_impl_v2(spline_ptr, ix, iy, iz, a, b, c, offload_scratch_iat_ptr + first, first,
                                              index);
         const int first_cplx = first / 2;
-        const int last_cplx  = last / 2 < orb_size ? last / 2 : orb_size;
+        const int last_cplx  = last / 2 < num_cplx_local ? last / 2 : num_cplx_local;
         PRAGMA_OFFLOAD("omp parallel for")
         for (int index = first_cplx; index < last_cplx; index++)
           C2R::assign_v(ST(pos_scratch[iat * 6]), ST(pos_scratch[iat * 6 + 1]), ST(pos_scratch[iat * 6 + 2]),
@@ -487,7 +490,7 @@ void SplineC2ROMPTarget<ST>::mw_evaluateDetRatios(const RefVectorWithLeader<SPOS
         const int last_real  = last_cplx + std::min(nComplexBands_local, last_cplx);
         TT sum(0);
         PRAGMA_OFFLOAD("omp parallel for simd reduction(+:sum)")
-        for (int i = first_real; i < last_real; i++)
+        for (int i = first_spo_local + first_real; i < first_spo_local + last_real; i++)
           sum += psi_iat_ptr[i] * psiinv_ptr[i];
         ratios_private_ptr[iat * NumTeams + team_id] = sum;
       }
@@ -659,6 +662,7 @@ void SplineC2ROMPTarget<ST>::evaluateVGL(const ParticleSet& P,
   auto* PrimLattice_G_ptr        = PrimLattice_G_offload->data();
   auto* myKcart_ptr              = myKcart->data();
   const size_t first_spo_local   = first_spo;
+  const int num_cplx_local       = std::min<size_t>(orb_size, kPoints.size());
   const int nComplexBands_local  = nComplexBands;
 
   {
@@ -686,7 +690,7 @@ void SplineC2ROMPTarget<ST>::evaluateVGL(const ParticleSet& P,
                                              offload_scratch_ptr + first, offload_scratch_ptr + padded_size + first,
                                              offload_scratch_ptr + padded_size * 4 + first, padded_size, first, index);
       const int first_cplx = first / 2;
-      const int last_cplx  = last / 2 < orb_size ? last / 2 : orb_size;
+      const int last_cplx  = last / 2 < num_cplx_local ? last / 2 : num_cplx_local;
       PRAGMA_OFFLOAD("omp parallel for")
       for (int index = first_cplx; index < last_cplx; index++)
         C2R::assign_vgl(x, y, z, results_scratch_ptr, mKK_ptr, orb_size, offload_scratch_ptr, padded_size, symGGt, G,
@@ -694,7 +698,9 @@ void SplineC2ROMPTarget<ST>::evaluateVGL(const ParticleSet& P,
     }
   }
 
-  for (size_t i = 0; i < orb_size; i++)
+  // only the orbitals [first_spo, last_spo) are computed by this object
+  const size_t last_spo_local = std::min<size_t>(last_spo, orb_size);
+  for (size_t i = first_spo; i < last_spo_local; i++)
   {
     psi[i]     = results_scratch[i];
     dpsi[i][0] = results_scratch[orb_size + i * 3];
@@ -733,6 +739,7 @@ void SplineC2ROMPTarget<ST>::evaluateVGLMultiPos(const Vector<ST, OffloadPinnedA
   auto* PrimLattice_G_ptr        = PrimLattice_G_offload->data();
   auto* myKcart_ptr              = myKcart->data();
   const size_t first_spo_local   = first_spo;
+  const int num_cplx_local       = std::min<size_t>(orb_size, kPoints.size());
   const int nComplexBands_local  = nComplexBands;
 
   {
@@ -767,7 +774,7 @@ void SplineC2ROMPTarget<ST>::evaluateVGLMultiPos(const Vector<ST, OffloadPinnedA
                                                offload_scratch_iw_ptr + padded_size * 4 + first, padded_size, first,
                                                index);
         const int first_cplx = first / 2;
-        const int last_cplx  = last / 2 < orb_size ? last / 2 : orb_size;
+        const int last_cplx  = last / 2 < num_cplx_local ? last / 2 : num_cplx_local;
         PRAGMA_OFFLOAD("omp parallel for")
         for (int index = first_cplx; index < last_cplx; index++)
           C2R::assign_vgl(pos_copy_ptr[iw * 6], pos_copy_ptr[iw * 6 + 1], pos_copy_ptr[iw * 6 + 2], psi_iw_ptr, mKK_ptr,
@@ -776,13 +783,15 @@ void SplineC2ROMPTarget<ST>::evaluateVGLMultiPos(const Vector<ST, OffloadPinnedA
       }
   }
 
+  // only the orbitals [first_spo, last_spo) are computed by this object
+  const size_t last_spo_local = std::min<size_t>(last_spo, orb_size);
   for (int iw = 0; iw < num_pos; ++iw)
   {
     auto* restrict results_iw_ptr = results_scratch_ptr + orb_size * iw * 5;
     ValueVector& psi_v(psi_v_list[iw]);
     GradVector& dpsi_v(dpsi_v_list[iw]);
     ValueVector& d2psi_v(d2psi_v_list[iw]);
-    for (size_t i = 0; i < orb_size; i++)
+    for (size_t i = first_spo; i < last_spo_local; i++)
     {
       psi_v[i]     = results_iw_ptr[i];
       dpsi_v[i][0] = results_iw_ptr[orb_size + i * 3];
@@ -898,6 +907,7 @@ void SplineC2ROMPTarget<ST>::mw_evaluateVGLandDetRatioGrads(const RefVectorWithL
   auto* rg_private_ptr           = rg_private.data();
   const size_t buffer_H2D_stride = buffer_H2D.cols();
   const size_t first_spo_local   = first_spo;
+  const int num_cplx_local       = std::min<size_t>(orb_size, kPoints.size());
   const size_t phi_vgl_stride    = phi_vgl_v.capacity();
   const int nComplexBands_local  = nComplexBands;
 
@@ -936,7 +946,7 @@ void SplineC2ROMPTarget<ST>::mw_evaluateVGLandDetRatioGrads(const RefVectorWithL
                                                offload_scratch_iw_ptr + padded_size * 4 + first, padded_size, first,
                                                index);
         const int first_cplx = first / 2;
-        const int last_cplx  = last / 2 < orb_size ? last / 2 : orb_size;
+        const int last_cplx  = last / 2 < num_cplx_local ? last / 2 : num_cplx_local;
         PRAGMA_OFFLOAD("omp parallel for")
         for (int index = first_cplx; index < last_cplx; index++)
           C2R::assign_vgl(pos_iw_ptr[0], pos_iw_ptr[1], pos_iw_ptr[2], psi_iw_ptr, mKK_ptr, orb_size,
@@ -994,6 +1004,125 @@ void SplineC2ROMPTarget<ST>::mw_evaluateVGLandDetRatioGrads(const RefVectorWithL
   }
 }
 
+template<typename ST>
+void SplineC2ROMPTarget<ST>::mw_evaluateVandDetRatio(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                     const RefVectorWithLeader<ParticleSet>& P_list,
+                                                     int iat,
+                                                     const std::vector<const ValueType*>& invRow_ptr_list,
+                                                     VGLVector& phi_vgl_v,
+                                                     std::vector<ValueType>& ratios) const
+{
+  assert(this == &spo_list.getLeader());
+  auto& phi_leader         = spo_list.getCastedLeader<SplineC2ROMPTarget<ST>>();
+  auto& mw_mem             = *phi_leader.mw_mem_;
+  auto& buffer_H2D         = mw_mem.buffer_H2D;
+  auto& rg_private         = mw_mem.rg_private;
+  auto& mw_offload_scratch = mw_mem.mw_offload_scratch;
+  auto& mw_results_scratch = mw_mem.mw_results_scratch;
+  const int nwalkers       = spo_list.size();
+  buffer_H2D.resize(nwalkers, sizeof(ST) * 6 + sizeof(ValueType*));
+
+  // pack particle positions and invRow pointers.
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    const PointType& r = P_list[iw].activeR(iat);
+    PointType ru(PrimLattice.toUnit_floor(r));
+    Vector<ST> pos_copy(reinterpret_cast<ST*>(buffer_H2D[iw]), 6);
+
+    pos_copy[0] = r[0];
+    pos_copy[1] = r[1];
+    pos_copy[2] = r[2];
+    pos_copy[3] = ru[0];
+    pos_copy[4] = ru[1];
+    pos_copy[5] = ru[2];
+
+    auto& invRow_ptr = *reinterpret_cast<const ValueType**>(buffer_H2D[iw] + sizeof(ST) * 6);
+    invRow_ptr       = invRow_ptr_list[iw];
+  }
+
+  const size_t num_pos       = nwalkers;
+  const int ChunkSizePerTeam = 128;
+  const int NumTeams         = (myV.size() + ChunkSizePerTeam - 1) / ChunkSizePerTeam;
+  const auto padded_size     = myV.size();
+  // for V(1) intermediate result
+  mw_offload_scratch.resize(padded_size * num_pos);
+  const auto orb_size = phi_vgl_v.size() / num_pos;
+  // for V(1) final result
+  mw_results_scratch.resize(orb_size * num_pos);
+  // per team ratio
+  rg_private.resize(num_pos, NumTeams);
+
+  // Ye: need to extract sizes and pointers before entering target region
+  const auto* spline_ptr         = SplineInst->getSplinePtr();
+  auto* buffer_H2D_ptr           = buffer_H2D.data();
+  auto* offload_scratch_ptr      = mw_offload_scratch.data();
+  auto* results_scratch_ptr      = mw_results_scratch.data();
+  const auto myKcart_padded_size = myKcart->capacity();
+  auto* myKcart_ptr              = myKcart->data();
+  auto* phi_vgl_ptr              = phi_vgl_v.data();
+  auto* rg_private_ptr           = rg_private.data();
+  const size_t buffer_H2D_stride = buffer_H2D.cols();
+  const size_t first_spo_local   = first_spo;
+  const int num_cplx_local       = std::min<size_t>(orb_size, kPoints.size());
+  const int nComplexBands_local  = nComplexBands;
+
+  {
+    ScopedTimer offload(offload_timer_);
+    PRAGMA_OFFLOAD("omp target teams distribute collapse(2) num_teams(NumTeams*num_pos) \
+                    map(always, to: buffer_H2D_ptr[:buffer_H2D.size()]) \
+                    map(always, from: rg_private_ptr[0:rg_private.size()])")
+    for (int iw = 0; iw < num_pos; iw++)
+      for (int team_id = 0; team_id < NumTeams; team_id++)
+      {
+        const int first = ChunkSizePerTeam * team_id;
+        const int last  = (first + ChunkSizePerTeam) > padded_size ? padded_size : first + ChunkSizePerTeam;
+        auto* restrict offload_scratch_iw_ptr = offload_scratch_ptr + padded_size * iw;
+        auto* restrict psi_iw_ptr             = results_scratch_ptr + orb_size * iw;
+        const auto* restrict pos_iw_ptr       = reinterpret_cast<ST*>(buffer_H2D_ptr + buffer_H2D_stride * iw);
+        const auto* restrict invRow_iw_ptr =
+            *reinterpret_cast<ValueType**>(buffer_H2D_ptr + buffer_H2D_stride * iw + sizeof(ST) * 6);
+
+        int ix, iy, iz;
+        ST a[4], b[4], c[4];
+        spline2::computeLocationAndFractional(spline_ptr, pos_iw_ptr[3], pos_iw_ptr[4], pos_iw_ptr[5], ix, iy, iz, a, b,
+                                              c);
+
+        PRAGMA_OFFLOAD("omp parallel for")
+        for (int index = 0; index < last - first; index++)
+          spline2offload::evaluate_v_impl_v2(spline_ptr, ix, iy, iz, a, b, c, offload_scratch_iw_ptr + first, first,
+                                             index);
+        const int first_cplx = first / 2;
+        const int last_cplx  = last / 2 < num_cplx_local ? last / 2 : num_cplx_local;
+        PRAGMA_OFFLOAD("omp parallel for")
+        for (int index = first_cplx; index < last_cplx; index++)
+          C2R::assign_v(pos_iw_ptr[0], pos_iw_ptr[1], pos_iw_ptr[2], psi_iw_ptr, orb_size, offload_scratch_iw_ptr,
+                        myKcart_ptr, myKcart_padded_size, first_spo_local, nComplexBands_local, index);
+
+        ValueType* restrict out_phi_v = phi_vgl_ptr + iw * orb_size;
+
+        const int first_real = first_cplx + std::min(nComplexBands_local, first_cplx);
+        const int last_real  = last_cplx + std::min(nComplexBands_local, last_cplx);
+        ValueType ratio(0);
+        PRAGMA_OFFLOAD("omp parallel for reduction(+: ratio)")
+        for (size_t j = first_spo_local + first_real; j < first_spo_local + last_real; j++)
+        {
+          out_phi_v[j] = psi_iw_ptr[j];
+          ratio += psi_iw_ptr[j] * invRow_iw_ptr[j];
+        }
+
+        rg_private_ptr[iw * NumTeams + team_id] = ratio;
+      }
+  }
+
+  for (int iw = 0; iw < num_pos; iw++)
+  {
+    ValueType ratio(0);
+    for (int team_id = 0; team_id < NumTeams; team_id++)
+      ratio += rg_private[iw][team_id];
+    ratios[iw] = ratio;
+  }
+}
+
 template<typename ST>
 void SplineC2ROMPTarget<ST>::assign_vgh(const PointType& r,
                                         ValueVector& psi,
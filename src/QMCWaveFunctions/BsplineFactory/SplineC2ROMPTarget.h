@@ -23,9 +23,11 @@
 #include "OhmmsSoA/VectorSoaContainer.h"
 #include "spline2/MultiBspline.hpp"
 #include "OMPTarget/OffloadAlignedAllocators.hpp"
+#include "CPU/SIMD/LargePageAllocator.hpp"
 #include "Utilities/FairDivide.h"
 #include "Utilities/TimerManager.h"
 #include "SplineOMPTargetMultiWalkerMem.h"
+#include "SplineOMPTargetDeviceCopies.h"
 
 namespace qmcplusplus
 {
@@ -63,6 +65,8 @@ public:
   using OffloadVector = Vector<DT, OffloadAllocator<DT>>;
   template<typename DT>
   using OffloadPosVector = VectorSoaContainer<DT, 3, OffloadAllocator<DT>>;
+  /// the coefficients on the host follow the large page options, see LargePageAllocator
+  using OffloadMultiBspline = MultiBspline<ST, OMPallocator<ST, LargePageAllocator<ST>>, OffloadAllocator<SplineType>>;
 
 private:
   /// timer for offload portion
@@ -74,12 +78,14 @@ private:
   ///number of complex bands
   int nComplexBands;
   ///multi bspline set
-  std::shared_ptr<MultiBspline<ST, OffloadAllocator<ST>, OffloadAllocator<SplineType>>> SplineInst;
+  std::shared_ptr<OffloadMultiBspline> SplineInst;
 
   std::shared_ptr<OffloadVector<ST>> mKK;
   std::shared_ptr<OffloadPosVector<ST>> myKcart;
   std::shared_ptr<OffloadVector<ST>> GGt_offload;
   std::shared_ptr<OffloadVector<ST>> PrimLattice_G_offload;
+  /// device copies of SplineInst on the other devices, released before SplineInst
+  std::shared_ptr<SplineOMPTargetDeviceCopies<SplineType>> device_copies_;
 
   std::unique_ptr<SplineOMPTargetMultiWalkerMem<ST, TT>> mw_mem_;
 
@@ -94,6 +100,20 @@ private:
   ///position scratch space, used to avoid allocation on the fly and faster transfer
   Vector<ST, OffloadPinnedAllocator<ST>> multi_pos_copy;
 
+  /// make the small tables owned by this set and map the shared coefficients on the current default device
+  void copyTablesToDefaultDevice()
+  {
+    mKK                   = std::make_shared<OffloadVector<ST>>(*mKK);
+    myKcart               = std::make_shared<OffloadPosVector<ST>>(*myKcart);
+    GGt_offload           = std::make_shared<OffloadVector<ST>>(*GGt_offload);
+    PrimLattice_G_offload = std::make_shared<OffloadVector<ST>>(*PrimLattice_G_offload);
+    mKK->updateTo();
+    myKcart->updateTo();
+    GGt_offload->updateTo();
+    PrimLattice_G_offload->updateTo();
+    device_copies_->mapToDefaultDevice(SplineInst->getSplinePtr());
+  }
+
   void evaluateVGLMultiPos(const Vector<ST, OffloadPinnedAllocator<ST>>& multi_pos_copy,
                            Vector<ST, OffloadPinnedAllocator<ST>>& offload_scratch,
                            Vector<TT, OffloadPinnedAllocator<TT>>& results_scratch,
@@ -115,7 +135,8 @@ public:
         offload_timer_(*timer_manager.createTimer("SplineC2ROMPTarget::offload", timer_level_fine)),
         nComplexBands(0),
         GGt_offload(std::make_shared<OffloadVector<ST>>(9)),
-        PrimLattice_G_offload(std::make_shared<OffloadVector<ST>>(9))
+        PrimLattice_G_offload(std::make_shared<OffloadVector<ST>>(9)),
+        device_copies_(std::make_shared<SplineOMPTargetDeviceCopies<SplineType>>())
   {
     is_complex = true;
     className  = "SplineC2ROMPTarget";
@@ -133,12 +154,17 @@ public:
         myKcart(in.myKcart),
         GGt_offload(in.GGt_offload),
         PrimLattice_G_offload(in.PrimLattice_G_offload),
+        device_copies_(in.device_copies_),
         myV(in.myV),
         myL(in.myL),
         myG(in.myG),
         myH(in.myH),
         mygH(in.mygH)
-  {}
+  {
+    // a clone made for a crowd on another device needs the tables on that device
+    if (mKK && !isPresentOnDefaultDevice(mKK->data()))
+      copyTablesToDefaultDevice();
+  }
 
   void createResource(ResourceCollection& collection) const override
   {
@@ -195,7 +221,7 @@ public:
   void create_spline(GT& xyz_g, BCT& xyz_bc)
   {
     resize_kpoints();
-    SplineInst = std::make_shared<MultiBspline<ST, OffloadAllocator<ST>, OffloadAllocator<SplineType>>>();
+    SplineInst = std::make_shared<OffloadMultiBspline>();
     SplineInst->create(xyz_g, xyz_bc, myV.size());
 
     app_log() << "MEMORY " << SplineInst->sizeInByte() / (1 << 20) << " MB allocated "
@@ -295,6 +321,13 @@ public:
                                               std::vector<ValueType>& ratios,
                                               std::vector<GradType>& grads) const override;
 
+  void mw_evaluateVandDetRatio(const RefVectorWithLeader<SPOSet>& spo_list,
+                               const RefVectorWithLeader<ParticleSet>& P_list,
+                               int iat,
+                               const std::vector<const ValueType*>& invRow_ptr_list,
+                               VGLVector& phi_vgl_v,
+                               std::vector<ValueType>& ratios) const override;
+
   void assign_vgh(const PointType& r,
                   ValueVector& psi,
                   GradVector& dpsi,
@@ -335,6 +368,10 @@ public:
   friend struct BsplineReaderBase;
 };
 
+template<typename ST>
+struct is_band_shardable<SplineC2ROMPTarget<ST>> : std::true_type
+{};
+
 extern template class SplineC2ROMPTarget<float>;
 extern template class SplineC2ROMPTarget<double>;
 
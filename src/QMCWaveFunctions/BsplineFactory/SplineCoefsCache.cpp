@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "SplineCoefsCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qmcplusplus
+{
+std::uint64_t hashSplineCoefsKey(const std::string& key)
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const unsigned char c : key)
+  {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool readSplineCoefsCache(const std::string& filename, const SplineCoefsCacheHeader& expected, void* coefs)
+{
+  const size_t coefs_bytes = expected.coefs_size * expected.sizeof_data;
+  const size_t file_bytes  = sizeof(SplineCoefsCacheHeader) + coefs_bytes;
+
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) != file_bytes)
+  {
+    close(fd);
+    return false;
+  }
+
+  void* mapped = mmap(nullptr, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after closing the descriptor
+  close(fd);
+  if (mapped == MAP_FAILED)
+    return false;
+  madvise(mapped, file_bytes, MADV_SEQUENTIAL);
+
+  const bool matched = std::memcmp(mapped, &expected, sizeof(SplineCoefsCacheHeader)) == 0;
+  if (matched)
+    std::memcpy(coefs, static_cast<const char*>(mapped) + sizeof(SplineCoefsCacheHeader), coefs_bytes);
+  munmap(mapped, file_bytes);
+  return matched;
+}
+
+bool writeSplineCoefsCache(const std::string& filename, const SplineCoefsCacheHeader& header, const void* coefs)
+{
+  const std::string tmp_filename = filename + ".tmp." + std::to_string(getpid());
+  {
+    std::ofstream fout(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (!fout)
+      return false;
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(SplineCoefsCacheHeader));
+    fout.write(static_cast<const char*>(coefs), header.coefs_size * header.sizeof_data);
+    if (!fout)
+    {
+      fout.close();
+      std::remove(tmp_filename.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+  {
+    std::remove(tmp_filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+} // namespace qmcplusplus
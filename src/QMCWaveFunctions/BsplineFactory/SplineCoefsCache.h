@@ -0,0 +1,85 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file SplineCoefsCache.h
+ *
+ * binary cache of the coefficient table of a multi_UBspline_3d_(s,d)
+ *
+ * The file is a fixed size header followed by the raw coefficient array of the table.
+ * The key is a hash of everything the coefficients depend on. A cache file is only accepted
+ * if the key and the table layout recorded in the header match the table to be filled.
+ */
+#ifndef QMCPLUSPLUS_SPLINE_COEFS_CACHE_H
+#define QMCPLUSPLUS_SPLINE_COEFS_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+namespace qmcplusplus
+{
+struct SplineCoefsCacheHeader
+{
+  char magic[8]             = {'Q', 'M', 'C', 'S', 'P', 'L', 'C', '1'};
+  std::uint64_t key         = 0;
+  std::uint32_t sizeof_data = 0;
+  std::int32_t num_splines  = 0;
+  std::int32_t grid[3]      = {0, 0, 0};
+  std::int32_t padding      = 0;
+  std::uint64_t coefs_size  = 0;
+};
+
+/// 64-bit FNV-1a hash of a string, stable across runs and builds unlike std::hash
+std::uint64_t hashSplineCoefsKey(const std::string& key);
+
+/** fill coefs from a cache file mapped into memory
+ * @param filename cache file
+ * @param expected header of the table to be filled
+ * @param coefs coefficient array of the table
+ * @return true if the file exists and matches expected, false otherwise and coefs is untouched
+ */
+bool readSplineCoefsCache(const std::string& filename, const SplineCoefsCacheHeader& expected, void* coefs);
+
+/** write coefs to a cache file
+ * The file is written under a temporary name and renamed, so a partially written file is never picked up.
+ * @return true on success
+ */
+bool writeSplineCoefsCache(const std::string& filename, const SplineCoefsCacheHeader& header, const void* coefs);
+
+/// make the header describing the table of a multi_UBspline_3d_(s,d)
+template<typename SPLINE>
+SplineCoefsCacheHeader makeSplineCoefsCacheHeader(const SPLINE& spline, std::uint64_t key)
+{
+  SplineCoefsCacheHeader header;
+  header.key         = key;
+  header.sizeof_data = sizeof(*spline.coefs);
+  header.num_splines = spline.num_splines;
+  header.grid[0]     = spline.x_grid.num;
+  header.grid[1]     = spline.y_grid.num;
+  header.grid[2]     = spline.z_grid.num;
+  header.coefs_size  = spline.coefs_size;
+  return header;
+}
+
+template<typename SPLINE>
+bool readSplineCoefsCache(const std::string& filename, std::uint64_t key, SPLINE& spline)
+{
+  return readSplineCoefsCache(filename, makeSplineCoefsCacheHeader(spline, key), spline.coefs);
+}
+
+template<typename SPLINE>
+bool writeSplineCoefsCache(const std::string& filename, std::uint64_t key, const SPLINE& spline)
+{
+  return writeSplineCoefsCache(filename, makeSplineCoefsCacheHeader(spline, key), spline.coefs);
+}
+
+} // namespace qmcplusplus
+#endif
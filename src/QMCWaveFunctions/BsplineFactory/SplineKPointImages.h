@@ -0,0 +1,311 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file SplineKPointImages.h
+ *
+ * orbitals at symmetry related twists evaluated from the complex splines of the irreducible twists
+ *
+ * The orbital of band b at the twist N^T k is psi_{k,b}(N u), N being a point group operation of the crystal
+ * in the reduced coordinates u of the primitive cell. Only the orbitals of the irreducible twists are splined.
+ */
+#ifndef QMCPLUSPLUS_SPLINE_KPOINT_IMAGES_H
+#define QMCPLUSPLUS_SPLINE_KPOINT_IMAGES_H
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <vector>
+#include "OhmmsPETE/TinyVector.h"
+#include "OhmmsPETE/Tensor.h"
+#include "CPU/SIMD/aligned_allocator.hpp"
+#include "spline2/MultiBsplineEval.hpp"
+
+namespace qmcplusplus
+{
+/** maps the complex bands of a spline set to the splines of their sources
+ * @tparam ST precision of spline
+ *
+ * The table holds the sources only. The bands sharing the operation and having consecutive sources are
+ * evaluated as blocks. The values and the derivatives in reduced coordinates are written to the columns
+ * of all the bands, so the phase factors and the conversion to cartesian coordinates are applied by the
+ * spline set as if every band had its own spline.
+ */
+template<typename ST>
+class SplineKPointImages
+{
+public:
+  using PointType = TinyVector<ST, 3>;
+
+  /// number of real columns evaluated at once in the thread private buffers
+  static constexpr int chunk_size = 128;
+
+  /// true if every band has its own spline
+  bool empty() const { return band_op_.empty(); }
+
+  /** set the source of every band
+   * @param ops point group operations in reduced coordinates, ops[0] is the identity
+   * @param band_op operation of each band, 0 for the bands stored in the table
+   * @param band_source band of which each band is the image, itself for the bands stored in the table
+   */
+  void setBands(const std::vector<Tensor<int, 3>>& ops,
+                const std::vector<int>& band_op,
+                const std::vector<int>& band_source)
+  {
+    ops_.resize(ops.size());
+    for (int o = 0; o < ops.size(); o++)
+      for (int i = 0; i < 9; i++)
+        ops_[o][i] = static_cast<ST>(ops[o][i]);
+    band_op_     = band_op;
+    band_source_ = band_source;
+  }
+
+  /** order the columns by operation and source, and build the evaluation blocks
+   * @param kpoints k point of each column, permuted
+   * @param band_index_map band of each column, permuted
+   * @param num_first columns [0, num_first) and the rest are ordered separately
+   */
+  template<typename KV, typename MV>
+  void sortColumns(KV& kpoints, MV& band_index_map, int num_first)
+  {
+    const int n = band_index_map.size();
+    std::vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    auto by_op_source = [&](int a, int b) {
+      const int band_a = band_index_map[a];
+      const int band_b = band_index_map[b];
+      return std::make_tuple(band_op_[band_a], band_source_[band_a], band_a) <
+          std::make_tuple(band_op_[band_b], band_source_[band_b], band_b);
+    };
+    std::sort(perm.begin(), perm.begin() + num_first, by_op_source);
+    std::sort(perm.begin() + num_first, perm.end(), by_op_source);
+
+    const KV kpoints_copy(kpoints);
+    const MV map_copy(band_index_map);
+    for (int c = 0; c < n; c++)
+    {
+      kpoints[c]        = kpoints_copy[perm[c]];
+      band_index_map[c] = map_copy[perm[c]];
+    }
+
+    // the sources take the spline columns in the order of their columns
+    std::vector<int> source_column(n, -1);
+    source_bands_.clear();
+    for (int c = 0; c < n; c++)
+      if (band_op_[band_index_map[c]] == 0)
+      {
+        source_column[band_index_map[c]] = source_bands_.size();
+        source_bands_.push_back(band_index_map[c]);
+      }
+
+    blocks_.clear();
+    for (int c = 0; c < n; c++)
+    {
+      const int band   = band_index_map[c];
+      const int op     = band_op_[band];
+      const int source = source_column[band_source_[band]];
+      if (!blocks_.empty())
+      {
+        Block& last = blocks_.back();
+        if (last.op == op && last.source + last.num == source)
+        {
+          last.num++;
+          continue;
+        }
+      }
+      blocks_.push_back({op, source, c, 1});
+    }
+  }
+
+  /// number of complex splines in the table
+  int getNumSources() const { return source_bands_.size(); }
+  /// band stored in each complex spline of the table
+  const std::vector<int>& getSourceBands() const { return source_bands_; }
+
+  /** evaluate the values of the bands in [first/2, last/2)
+   * @param spline table of the sources
+   * @param ru reduced coordinates in [0,1)
+   * @param psi values in the columns of all the bands
+   */
+  template<typename SPLINET, typename VT>
+  void evaluate_v(const SPLINET* spline, const PointType& ru, VT& psi, int first, int last) const
+  {
+    if (empty())
+    {
+      spline2::evaluate3d(spline, ru, psi, first, last);
+      return;
+    }
+    alignas(QMC_SIMD_ALIGNMENT) ST v[chunk_size];
+    for_each_chunk(ru, first, last, [&](const PointType& u, int s_first, int s_last, int offset, int dest, int num, int) {
+      spline2::evaluate_v_impl(spline, u[0], u[1], u[2], v, s_first, s_last);
+      for (int k = 0; k < num; k++)
+        psi[dest + k] = v[offset + k];
+    });
+  }
+
+  /** evaluate the values, gradients and hessians in reduced coordinates of the bands in [first/2, last/2)
+   */
+  template<typename SPLINET, typename VT, typename GT, typename HT>
+  void evaluate_vgh(const SPLINET* spline, const PointType& ru, VT& psi, GT& grad, HT& hess, int first, int last)
+      const
+  {
+    if (empty())
+    {
+      spline2::evaluate3d_vgh(spline, ru, psi, grad, hess, first, last);
+      return;
+    }
+    alignas(QMC_SIMD_ALIGNMENT) ST v[chunk_size];
+    alignas(QMC_SIMD_ALIGNMENT) ST g[3 * chunk_size];
+    alignas(QMC_SIMD_ALIGNMENT) ST h[6 * chunk_size];
+    for_each_chunk(ru, first, last, [&](const PointType& u, int s_first, int s_last, int offset, int dest, int num,
+                                        int op) {
+      spline2::evaluate_vgh_impl(spline, u[0], u[1], u[2], v, g, h, chunk_size, s_first, s_last);
+      for (int k = 0; k < num; k++)
+      {
+        psi[dest + k] = v[offset + k];
+        transform_gh(ops_[op], g + offset + k, h + offset + k, grad, hess, dest + k);
+      }
+    });
+  }
+
+  /** evaluate the values and the derivatives up to the third order in reduced coordinates of the bands in [first/2, last/2)
+   */
+  template<typename SPLINET, typename VT, typename GT, typename HT, typename GHT>
+  void evaluate_vghgh(const SPLINET* spline,
+                      const PointType& ru,
+                      VT& psi,
+                      GT& grad,
+                      HT& hess,
+                      GHT& ghess,
+                      int first,
+                      int last) const
+  {
+    if (empty())
+    {
+      spline2::evaluate3d_vghgh(spline, ru, psi, grad, hess, ghess, first, last);
+      return;
+    }
+    alignas(QMC_SIMD_ALIGNMENT) ST v[chunk_size];
+    alignas(QMC_SIMD_ALIGNMENT) ST g[3 * chunk_size];
+    alignas(QMC_SIMD_ALIGNMENT) ST h[6 * chunk_size];
+    alignas(QMC_SIMD_ALIGNMENT) ST gh[10 * chunk_size];
+    for_each_chunk(ru, first, last, [&](const PointType& u, int s_first, int s_last, int offset, int dest, int num,
+                                        int op) {
+      spline2::evaluate_vghgh_impl(spline, u[0], u[1], u[2], v, g, h, gh, chunk_size, s_first, s_last);
+      for (int k = 0; k < num; k++)
+      {
+        psi[dest + k] = v[offset + k];
+        transform_gh(ops_[op], g + offset + k, h + offset + k, grad, hess, dest + k);
+        transform_ggg(ops_[op], gh + offset + k, ghess, dest + k);
+      }
+    });
+  }
+
+private:
+  /// bands [dest, dest + num) are the images of the splines [source, source + num) by ops_[op]
+  struct Block
+  {
+    int op;
+    int source;
+    int dest;
+    int num;
+  };
+
+  std::vector<Tensor<ST, 3>> ops_;
+  std::vector<int> band_op_;
+  std::vector<int> band_source_;
+  std::vector<int> source_bands_;
+  std::vector<Block> blocks_;
+
+  /** split the bands in [first/2, last/2) into aligned chunks of the table
+   * @param f called with the transformed reduced coordinates, the aligned real column range of the table,
+   *        the offset of the first wanted column in the range, the first real destination column,
+   *        the number of real columns and the operation
+   */
+  template<typename F>
+  void for_each_chunk(const PointType& ru, int first, int last, const F& f) const
+  {
+    const int align = getAlignment<ST>();
+    const int band_first = first / 2;
+    const int band_last  = last / 2;
+    for (const Block& block : blocks_)
+    {
+      const int d_first = std::max(block.dest, band_first);
+      const int d_last  = std::min(block.dest + block.num, band_last);
+      if (d_first >= d_last)
+        continue;
+      PointType u = dot(ops_[block.op], ru);
+      for (int i = 0; i < 3; i++)
+        u[i] -= std::floor(u[i]);
+      for (int d = d_first; d < d_last;)
+      {
+        const int s_first = 2 * (block.source + d - block.dest);
+        const int offset  = s_first % align;
+        const int num     = std::min(d_last - d, (chunk_size - offset) / 2);
+        f(u, s_first - offset, getAlignedSize<ST>(s_first + 2 * num), offset, 2 * d, 2 * num, block.op);
+        d += num;
+      }
+    }
+  }
+
+  /// derivatives of psi(N u) from those of psi at N u, g' = N^T g and h' = N^T h N
+  template<typename GT, typename HT>
+  static void transform_gh(const Tensor<ST, 3>& op, const ST* g, const ST* h, GT& grad, HT& hess, int col)
+  {
+    constexpr int hidx[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+    ST g_in[3], h_in[3][3];
+    for (int i = 0; i < 3; i++)
+    {
+      g_in[i] = g[i * chunk_size];
+      for (int j = 0; j < 3; j++)
+        h_in[i][j] = h[hidx[i][j] * chunk_size];
+    }
+    for (int a = 0; a < 3; a++)
+    {
+      ST ga(0);
+      for (int i = 0; i < 3; i++)
+        ga += op(i, a) * g_in[i];
+      grad.data(a)[col] = ga;
+      for (int c = a; c < 3; c++)
+      {
+        ST hac(0);
+        for (int i = 0; i < 3; i++)
+          for (int j = 0; j < 3; j++)
+            hac += op(i, a) * h_in[i][j] * op(j, c);
+        hess.data(hidx[a][c])[col] = hac;
+      }
+    }
+  }
+
+  /// third derivatives of psi(N u), t'_{abc} = N_ia N_jb N_kc t_ijk
+  template<typename GHT>
+  static void transform_ggg(const Tensor<ST, 3>& op, const ST* gh, GHT& ghess, int col)
+  {
+    constexpr int tidx[3][3][3] = {{{0, 1, 2}, {1, 3, 4}, {2, 4, 5}},
+                                   {{1, 3, 4}, {3, 6, 7}, {4, 7, 8}},
+                                   {{2, 4, 5}, {4, 7, 8}, {5, 8, 9}}};
+    for (int a = 0; a < 3; a++)
+      for (int b = a; b < 3; b++)
+        for (int c = b; c < 3; c++)
+        {
+          ST t(0);
+          for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+              for (int k = 0; k < 3; k++)
+                t += op(i, a) * op(j, b) * op(k, c) * gh[tidx[i][j][k] * chunk_size];
+          ghess.data(tidx[a][b][c])[col] = t;
+        }
+  }
+};
+
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_SPLINE_OMPTARGET_DEVICE_COPIES_H
+#define QMCPLUSPLUS_SPLINE_OMPTARGET_DEVICE_COPIES_H
+
+#include <mutex>
+#include <vector>
+#include "OMPTarget/ScopedDefaultDevice.h"
+
+namespace qmcplusplus
+{
+/** copies of a shared spline table on the devices other than the one it was allocated on
+ * @tparam SplineType spline structure holding the coefficient pointer
+ *
+ * The table is allocated with OMPallocator on the default device of the thread creating it. When crowds run on
+ * several devices, the clones made for another device map the same host table there, once per device.
+ * An instance is shared by all the spline sets sharing the table and must be destroyed before the table.
+ */
+template<typename SplineType>
+class SplineOMPTargetDeviceCopies
+{
+public:
+  SplineOMPTargetDeviceCopies() = default;
+  SplineOMPTargetDeviceCopies(const SplineOMPTargetDeviceCopies&) = delete;
+
+  ~SplineOMPTargetDeviceCopies()
+  {
+#if defined(ENABLE_OFFLOAD)
+    for (const DeviceCopy& copy : device_copies_)
+    {
+      const int device_num = copy.device_num;
+      auto* spline         = copy.spline;
+      auto* coefs          = spline->coefs;
+      PRAGMA_OFFLOAD("omp target exit data map(delete: spline[0:1], coefs[0:spline->coefs_size]) device(device_num)")
+    }
+#endif
+  }
+
+  /// map the table to the default device of the calling thread unless it is already there
+  void mapToDefaultDevice(SplineType* spline)
+  {
+#if defined(ENABLE_OFFLOAD)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isPresentOnDefaultDevice(spline))
+      return;
+    auto* coefs = spline->coefs;
+    PRAGMA_OFFLOAD("omp target enter data map(to: spline[0:1], coefs[0:spline->coefs_size])")
+    // attach the device coefficients to the device structure
+    PRAGMA_OFFLOAD("omp target map(to: spline[0:1], coefs[0:spline->coefs_size])")
+    {
+      spline->coefs = coefs;
+    }
+    device_copies_.push_back({getDefaultOffloadDevice(), spline});
+#endif
+  }
+
+private:
+  struct DeviceCopy
+  {
+    int device_num;
+    SplineType* spline;
+  };
+  std::mutex mutex_;
+  std::vector<DeviceCopy> device_copies_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -20,6 +20,7 @@
 #include "QMCWaveFunctions/BsplineFactory/BsplineSet.h"
 #include "OhmmsSoA/VectorSoaContainer.h"
 #include "spline2/MultiBspline.hpp"
+#include "CPU/SIMD/LargePageAllocator.hpp"
 #include "Utilities/FairDivide.h"
 
 namespace qmcplusplus
@@ -56,7 +57,9 @@ private:
   ///\f$GGt=G^t G \f$, transformation for tensor in LatticeUnit to CartesianUnit, e.g. Hessian
   Tensor<ST, 3> GGt;
   ///multi bspline set
-  std::shared_ptr<MultiBspline<ST>> SplineInst;
+  std::shared_ptr<MultiBspline<ST, LargePageAllocator<ST>>> SplineInst;
+  ///coefficients of SplineInst stored once per node, only with share_tables_on_node
+  std::shared_ptr<NodeSharedArray<ST>> shared_coefs_;
 
   ///thread private ratios for reduction when using nested threading, numVP x numThread
   Matrix<TT> ratios_private;
@@ -96,6 +99,12 @@ public:
 
   void bcast_tables(Communicate* comm) { chunked_bcast(comm, SplineInst->getSplinePtr()); }
 
+  /// replaces bcast_tables, the table of the first rank of comm is stored once per node
+  void share_tables_on_node(Communicate* comm)
+  {
+    shared_coefs_ = qmcplusplus::share_tables_on_node<ST>(comm, *SplineInst);
+  }
+
   void gather_tables(Communicate* comm)
   {
     if (comm->size() == 1)
@@ -111,7 +120,7 @@ public:
   void create_spline(GT& xyz_g, BCT& xyz_bc)
   {
     GGt        = dot(transpose(PrimLattice.G), PrimLattice.G);
-    SplineInst = std::make_shared<MultiBspline<ST>>();
+    SplineInst = std::make_shared<MultiBspline<ST, LargePageAllocator<ST>>>();
     SplineInst->create(xyz_g, xyz_bc, myV.size());
 
     app_log() << "MEMORY " << SplineInst->sizeInByte() / (1 << 20) << " MB allocated "
@@ -193,6 +202,10 @@ public:
   friend struct BsplineReaderBase;
 };
 
+template<typename ST>
+struct is_node_shareable<SplineR2R<ST>> : std::true_type
+{};
+
 extern template class SplineR2R<float>;
 extern template class SplineR2R<double>;
 
@@ -25,9 +25,14 @@
  */
 #ifndef QMCPLUSPLUS_SPLINESET_READER_H
 #define QMCPLUSPLUS_SPLINESET_READER_H
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <type_traits>
 #include "mpi/collectives.h"
 #include "mpi/point2point.h"
 #include "Utilities/FairDivide.h"
+#include "SplineCoefsCache.h"
 
 namespace qmcplusplus
 {
@@ -40,33 +45,59 @@ struct SplineSetReader : public BsplineReaderBase
   using DataType    = typename splineset_t::DataType;
   using SplineType  = typename splineset_t::SplineType;
 
-  Array<std::complex<double>, 3> FFTbox;
+  ///FFT boxes of the two bands in flight in the pipeline
+  Array<std::complex<double>, 3> FFTbox[2];
   Array<double, 3> splineData_r, splineData_i;
   double rotate_phase_r, rotate_phase_i;
   UBspline_3d_d* spline_r;
   UBspline_3d_d* spline_i;
   splineset_t* bspline;
-  fftw_plan FFTplan;
+  ///band stored in each complex or real spline of the table
+  std::vector<int> spline_bands;
+  ///in-place FFT plans of FFTbox
+  fftw_plan FFTplan[2];
 
   SplineSetReader(EinsplineSetBuilder* e)
-      : BsplineReaderBase(e), spline_r(nullptr), spline_i(nullptr), bspline(nullptr), FFTplan(nullptr)
+      : BsplineReaderBase(e), spline_r(nullptr), spline_i(nullptr), bspline(nullptr), FFTplan{nullptr, nullptr}
   {}
 
   ~SplineSetReader() override { clear(); }
 
+  /// release the plans and the scratch memory of the transformation, the reader outlives the spline sets
   void clear()
   {
     einspline::destroy(spline_r);
     einspline::destroy(spline_i);
-    if (FFTplan != nullptr)
-      fftw_destroy_plan(FFTplan);
-    FFTplan = nullptr;
+    for (auto& plan : FFTplan)
+    {
+      if (plan != nullptr)
+        fftw_destroy_plan(plan);
+      plan = nullptr;
+    }
+    for (auto& box : FFTbox)
+      release(box);
+    release(splineData_r);
+    release(splineData_i);
+  }
+
+  template<typename T>
+  static void release(Array<T, 3>& a)
+  {
+    a.resize(0, 0, 0);
+    a.storage().shrink_to_fit();
   }
 
+  bool canShardOverDevices() const override { return is_band_shardable<splineset_t>::value; }
+
+  /// return true if the multi spline table holds all the coefficients of the spline set
+  virtual bool canCacheCoefs() const { return true; }
+
   // set info for Hybrid
   virtual void initialize_hybridrep_atomic_centers() {}
   // transform cG to radial functions
   virtual void create_atomic_centers_Gspace(Vector<std::complex<double>>& cG, Communicate& band_group_comm, int iorb) {}
+  /// return true if create_atomic_centers_Gspace needs psi_g in double precision
+  virtual bool needs_double_psi_g() const { return false; }
 
   /** for exporting data from multi_UBspline_3d_d to multi_UBspline_3d_z
    *  This is only used by the legacy EinsplineSet class. To be deleted together with EinsplineSet.
@@ -143,6 +174,15 @@ struct SplineSetReader : public BsplineReaderBase
     //baseclass handles twists
     check_twists(bspline, bandgroup);
 
+    if constexpr (is_kpoint_unfoldable<splineset_t>::value)
+    {
+      if (irreducibleKPoints)
+        set_kpoint_images(bandgroup);
+    }
+    else if (irreducibleKPoints)
+      app_warning() << "irreducible_kpoints is not supported by " << bspline->getClassName()
+                    << ", the orbitals of all the twists are splined." << std::endl;
+
     Ugrid xyz_grid[3];
 
     typename splineset_t::BCType xyz_bc[3];
@@ -150,15 +190,37 @@ struct SplineSetReader : public BsplineReaderBase
     if (!havePsig)
       myComm->barrier_and_abort("SplineSetReader needs psi_g. Set precision=\"double\".");
     bspline->create_spline(xyz_grid, xyz_bc);
+    spline_bands.assign(bspline->BandIndexMap.begin(), bspline->BandIndexMap.end());
+    if constexpr (is_kpoint_unfoldable<splineset_t>::value)
+      if (!bspline->kpoint_images_.empty())
+        spline_bands = bspline->kpoint_images_.getSourceBands();
 
     std::ostringstream oo;
-    oo << bandgroup.myName << ".g" << MeshSize[0] << "x" << MeshSize[1] << "x" << MeshSize[2] << ".h5";
+    oo << bandgroup.myName << (irreducibleKPoints ? ".irr" : "") << ".g" << MeshSize[0] << "x" << MeshSize[1] << "x" << MeshSize[2] << ".h5";
 
     const std::string splinefile(oo.str());
     bool root       = (myComm->rank() == 0);
     int foundspline = 0;
     Timer now;
-    if (root)
+
+    const bool use_cache = !coefsCacheDir.empty() && canCacheCoefs();
+    std::uint64_t cache_key(0);
+    std::string cachefile;
+    if (use_cache)
+    {
+      cache_key = coefs_cache_key(bandgroup, bspline->getClassName(), sizeof(DataType), bspline->HalfG);
+      cachefile = coefs_cache_filename(bandgroup, cache_key);
+    }
+
+    if (root && use_cache)
+    {
+      now.restart();
+      foundspline = readSplineCoefsCache(cachefile, cache_key, *bspline->SplineInst->getSplinePtr());
+      if (foundspline)
+        app_log() << "  Successfully mapped coefficients from the cache " << cachefile << ". The reading time is "
+                  << now.elapsed() << " sec." << std::endl;
+    }
+    if (root && !foundspline)
     {
       now.restart();
       hdf_archive h5f(myComm);
@@ -188,7 +250,7 @@ struct SplineSetReader : public BsplineReaderBase
     if (foundspline)
     {
       now.restart();
-      bspline->bcast_tables(myComm);
+      distribute_tables();
       app_log() << "  SplineSetReader bcast the full table " << now.elapsed() << " sec." << std::endl;
       app_log().flush();
     }
@@ -201,9 +263,13 @@ struct SplineSetReader : public BsplineReaderBase
       int nz = MeshSize[2];
       if (havePsig) //perform FFT using FFTW
       {
-        FFTbox.resize(nx, ny, nz);
-        FFTplan = fftw_plan_dft_3d(nx, ny, nz, reinterpret_cast<fftw_complex*>(FFTbox.data()),
-                                   reinterpret_cast<fftw_complex*>(FFTbox.data()), +1, FFTW_ESTIMATE);
+        // planning is not thread-safe, create the plans of both pipeline slots here
+        for (int slot = 0; slot < 2; slot++)
+        {
+          FFTbox[slot].resize(nx, ny, nz);
+          FFTplan[slot] = fftw_plan_dft_3d(nx, ny, nz, reinterpret_cast<fftw_complex*>(FFTbox[slot].data()),
+                                           reinterpret_cast<fftw_complex*>(FFTbox[slot].data()), +1, FFTW_ESTIMATE);
+        }
         splineData_r.resize(nx, ny, nz);
         if (bspline->is_complex)
           splineData_i.resize(nx, ny, nz);
@@ -218,8 +284,7 @@ struct SplineSetReader : public BsplineReaderBase
         initialize_spline_pio_gather(spin, bandgroup);
         app_log() << "  SplineSetReader initialize_spline_pio " << now.elapsed() << " sec" << std::endl;
 
-        fftw_destroy_plan(FFTplan);
-        FFTplan = NULL;
+        clear();
       }
       else //why, don't know
         initialize_spline_psi_r(spin, bandgroup);
@@ -237,31 +302,91 @@ struct SplineSetReader : public BsplineReaderBase
         app_log() << "  Stored spline coefficients in " << splinefile << " for potential reuse. The writing time is "
                   << now.elapsed() << " sec." << std::endl;
       }
+      if (use_cache && root)
+      {
+        now.restart();
+        if (writeSplineCoefsCache(cachefile, cache_key, *bspline->SplineInst->getSplinePtr()))
+          app_log() << "  Stored spline coefficients in the cache " << cachefile << ". The writing time is "
+                    << now.elapsed() << " sec." << std::endl;
+        else
+          app_warning() << "Failed to store spline coefficients in the cache " << cachefile << std::endl;
+      }
     }
 
     clear();
     return std::unique_ptr<SPOSet>{bspline};
   }
 
-  /** fft and spline cG
-   * @param cG psi_g to be processed
+  /** spline only the bands of the irreducible twists, the other bands are evaluated as their images
+   * @param bandgroup band group of the spline set
+   *
+   * Sets the k points of the images, must be called before the spline is created.
+   */
+  void set_kpoint_images(const BandInfoGroup& bandgroup)
+  {
+    const auto ops = find_point_group();
+    std::vector<int> band_op, band_source;
+    std::vector<TinyVector<double, 3>> band_twist;
+    const int num_sources = find_kpoint_images(bandgroup, ops, band_op, band_source, band_twist);
+    app_log() << "  Found " << ops.size() << " point group operations. " << num_sources << " of the "
+              << band_op.size() << " bands are splined, the others are their symmetry images." << std::endl;
+    if (num_sources == band_op.size())
+      return;
+    for (int iorb = 0; iorb < band_op.size(); iorb++)
+      bspline->kPoints[iorb] = mybuilder->PrimCell.k_cart(-band_twist[iorb]);
+    bspline->kpoint_images_.setBands(ops, band_op, band_source);
+  }
+
+  /** read psi_g of a band and FFT it to FFTbox[slot]
+   * @param h5f opened orbital file
+   * @param spin spin index
+   * @param band band to be read
+   * @param cG psi_g of the band, HDF5 converts it to TG while reading
+   * @param slot pipeline slot
+   *
+   * Touches only cG and the slot, so it can run concurrently with spline_band on the other slot.
+   */
+  template<typename TG>
+  inline void read_fft_band(hdf_archive& h5f, int spin, const BandInfo& band, Vector<std::complex<TG>>& cG, int slot)
+  {
+    std::string s = psi_g_path(band.TwistIndex, spin, band.BandIndex);
+    if (!h5f.readEntry(cG, s))
+    {
+      std::ostringstream msg;
+      msg << "SplineSetReader Failed to read band(s) from h5 file. "
+          << "Attempted dataset " << s << " with " << cG.size() << " complex numbers." << std::endl;
+      throw std::runtime_error(msg.str());
+    }
+    double total_norm = compute_norm(cG);
+    if ((checkNorm) && (std::abs(total_norm - 1.0) > PW_COEFF_NORM_TOLERANCE))
+    {
+      std::ostringstream msg;
+      msg << "SplineSetReader The orbital " << s << " has a wrong norm " << total_norm
+          << ", computed from plane wave coefficients!" << std::endl
+          << "This may indicate a problem with the HDF5 library versions used "
+          << "during wavefunction conversion or read." << std::endl;
+      throw std::runtime_error(msg.str());
+    }
+    unpack4fftw(cG, mybuilder->Gvecs[0], MeshSize, FFTbox[slot]);
+    fftw_execute(FFTplan[slot]);
+  }
+
+  /** spline the FFT-ed band in FFTbox[slot]
    * @param ti twist index
-   * @param iorb orbital index
+   * @param slot pipeline slot
    *
-   * Perform FFT and spline to spline_r and spline_i
+   * Fix the phase and spline to spline_r and spline_i
    */
-  inline void fft_spline(Vector<std::complex<double>>& cG, int ti)
+  inline void spline_band(int ti, int slot)
   {
-    unpack4fftw(cG, mybuilder->Gvecs[0], MeshSize, FFTbox);
-    fftw_execute(FFTplan);
     if (bspline->is_complex)
     {
       if (rotate)
-        fix_phase_rotate_c2c(FFTbox, splineData_r, splineData_i, mybuilder->TwistAngles[ti], rotate_phase_r,
+        fix_phase_rotate_c2c(FFTbox[slot], splineData_r, splineData_i, mybuilder->TwistAngles[ti], rotate_phase_r,
                              rotate_phase_i);
       else
       {
-        split_real_components_c2c(FFTbox, splineData_r, splineData_i);
+        split_real_components_c2c(FFTbox[slot], splineData_r, splineData_i);
         rotate_phase_r = 1.0;
         rotate_phase_i = 0.0;
       }
@@ -270,18 +395,35 @@ struct SplineSetReader : public BsplineReaderBase
     }
     else
     {
-      fix_phase_rotate_c2r(FFTbox, splineData_r, mybuilder->TwistAngles[ti], rotate_phase_r, rotate_phase_i);
+      fix_phase_rotate_c2r(FFTbox[slot], splineData_r, mybuilder->TwistAngles[ti], rotate_phase_r, rotate_phase_i);
       einspline::set(spline_r, splineData_r.data());
     }
   }
 
 
   /** initialize the splines
+   *
+   * psi_g is read in the storage precision of the splines unless the hybrid representation needs it in double.
+   * The FFT and the spline solver remain in double precision.
    */
   void initialize_spline_pio_gather(int spin, const BandInfoGroup& bandgroup)
+  {
+    if (std::is_same<DataType, float>::value && !needs_double_psi_g())
+      initialize_spline_pio_gather_impl<float>(spin, bandgroup);
+    else
+      initialize_spline_pio_gather_impl<double>(spin, bandgroup);
+  }
+
+  /** initialize the splines reading psi_g in the precision TG
+   *
+   * On the band group leader, the bands are processed in a two-stage pipeline. A helper thread reads
+   * and FFTs band iorb+1 while the OpenMP threads fix the phase and solve the spline coefficients of band iorb.
+   */
+  template<typename TG>
+  void initialize_spline_pio_gather_impl(int spin, const BandInfoGroup& bandgroup)
   {
     //distribute bands over processor groups
-    int Nbands            = bandgroup.getNumDistinctOrbitals();
+    int Nbands            = spline_bands.size();
     const int Nprocs      = myComm->size();
     const int Nbandgroups = std::min(Nbands, Nprocs);
     Communicate band_group_comm(*myComm, Nbandgroups);
@@ -292,40 +434,52 @@ struct SplineSetReader : public BsplineReaderBase
 
     app_log() << "Start transforming plane waves to 3D B-Splines." << std::endl;
     hdf_archive h5f(&band_group_comm, false);
-    Vector<std::complex<double>> cG(mybuilder->Gvecs[0].size());
+    Vector<std::complex<TG>> cG[2];
+    for (auto& cG_slot : cG)
+      cG_slot.resize(mybuilder->Gvecs[0].size());
     const std::vector<BandInfo>& cur_bands = bandgroup.myBands;
-    if (band_group_comm.isGroupLeader())
+    // relative error of each orbital due to the reduced storage precision
+    constexpr bool reduced_precision = !std::is_same<DataType, double>::value;
+    std::vector<double> storage_errors(reduced_precision ? Nbands : 0, 0.0);
+    const bool is_leader = band_group_comm.isGroupLeader();
+    if (is_leader)
+    {
       h5f.open(mybuilder->H5FileName, H5F_ACC_RDONLY);
+      if (iorb_first < iorb_last)
+        read_fft_band(h5f, spin, cur_bands[spline_bands[iorb_first]], cG[0], 0);
+    }
     for (int iorb = iorb_first; iorb < iorb_last; iorb++)
     {
-      if (band_group_comm.isGroupLeader())
+      const int slot = (iorb - iorb_first) % 2;
+      std::future<void> next_band;
+      if (is_leader)
       {
-        int iorb_h5   = bspline->BandIndexMap[iorb];
-        int ti        = cur_bands[iorb_h5].TwistIndex;
-        std::string s = psi_g_path(ti, spin, cur_bands[iorb_h5].BandIndex);
-        if (!h5f.readEntry(cG, s))
-        {
-          std::ostringstream msg;
-          msg << "SplineSetReader Failed to read band(s) from h5 file. "
-              << "Attempted dataset " << s << " with " << cG.size() << " complex numbers." << std::endl;
-          throw std::runtime_error(msg.str());
-        }
-        double total_norm = compute_norm(cG);
-        if ((checkNorm) && (std::abs(total_norm - 1.0) > PW_COEFF_NORM_TOLERANCE))
+        if (iorb + 1 < iorb_last)
+          next_band = std::async(std::launch::async, &SplineSetReader::read_fft_band<TG>, this, std::ref(h5f), spin,
+                                 std::cref(cur_bands[spline_bands[iorb + 1]]), std::ref(cG[1 - slot]),
+                                 1 - slot);
+        int iorb_h5 = spline_bands[iorb];
+        spline_band(cur_bands[iorb_h5].TwistIndex, slot);
+        bspline->set_spline(spline_r, spline_i, cur_bands[iorb_h5].TwistIndex, iorb, 0);
+        if (reduced_precision)
         {
-          std::ostringstream msg;
-          msg << "SplineSetReader The orbital " << iorb_h5 << " has a wrong norm " << total_norm
-              << ", computed from plane wave coefficients!" << std::endl
-              << "This may indicate a problem with the HDF5 library versions used "
-              << "during wavefunction conversion or read." << std::endl;
-          throw std::runtime_error(msg.str());
+          if (bspline->is_complex)
+            storage_errors[iorb] = std::max(bspline->SplineInst->copy_error(spline_r, 2 * iorb),
+                                            bspline->SplineInst->copy_error(spline_i, 2 * iorb + 1));
+          else
+            storage_errors[iorb] = bspline->SplineInst->copy_error(spline_r, iorb);
         }
-        fft_spline(cG, ti);
-        bspline->set_spline(spline_r, spline_i, cur_bands[iorb_h5].TwistIndex, iorb, 0);
       }
-      this->create_atomic_centers_Gspace(cG, band_group_comm, iorb);
+      if constexpr (std::is_same<TG, double>::value)
+        this->create_atomic_centers_Gspace(cG[slot], band_group_comm, iorb);
+      // rethrows the read failures of the next band
+      if (next_band.valid())
+        next_band.get();
     }
 
+    if (reduced_precision)
+      check_storage_errors(storage_errors);
+
     myComm->barrier();
     Timer now;
     if (band_group_comm.isGroupLeader())
@@ -335,10 +489,49 @@ struct SplineSetReader : public BsplineReaderBase
       app_log() << "  Time to gather the table = " << now.elapsed() << std::endl;
     }
     now.restart();
-    bspline->bcast_tables(myComm);
+    distribute_tables();
     app_log() << "  Time to bcast the table = " << now.elapsed() << std::endl;
   }
 
+  /** make the table complete on the first rank available to all the ranks of myComm
+   *
+   *  With node_shared, the table is stored once per node. In an ensemble of twists, the ranks of each twist
+   *  on a node then hold a single copy of the orbitals of that twist.
+   */
+  void distribute_tables()
+  {
+    if constexpr (is_node_shareable<splineset_t>::value)
+      if (nodeSharedCoefs)
+      {
+        bspline->share_tables_on_node(myComm);
+        return;
+      }
+    if (nodeSharedCoefs)
+      app_warning() << "node_shared is not supported by " << bspline->getClassName()
+                    << ", the table is stored on every rank." << std::endl;
+    bspline->bcast_tables(myComm);
+  }
+
+  /** report the accuracy of the reduced precision storage against the double precision splines
+   * @param storage_errors relative error of each orbital, only set on the band group leader computing it
+   */
+  void check_storage_errors(std::vector<double>& storage_errors)
+  {
+    myComm->allreduce(storage_errors);
+    const auto worst = std::max_element(storage_errors.begin(), storage_errors.end());
+    if (worst == storage_errors.end())
+      return;
+    app_log() << "  Spline coefficients stored with " << sizeof(DataType)
+              << " bytes. The largest relative error against double precision is " << *worst << " in orbital "
+              << worst - storage_errors.begin() << "." << std::endl;
+    if (!std::isfinite(*worst))
+      myComm->barrier_and_abort("SplineSetReader spline coefficients overflow the storage precision. "
+                                "Set precision=\"double\".");
+    if (*worst > SPLINE_STORAGE_ERROR_TOLERANCE)
+      app_warning() << "The spline coefficients lose more accuracy than " << SPLINE_STORAGE_ERROR_TOLERANCE
+                    << " in the storage precision. Consider precision=\"double\"." << std::endl;
+  }
+
   void initialize_spline_psi_r(int spin, const BandInfoGroup& bandgroup)
   {
     // old implementation buried in the history
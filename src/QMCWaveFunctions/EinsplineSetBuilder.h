@@ -30,6 +30,7 @@
 #include <map>
 
 #define PW_COEFF_NORM_TOLERANCE 1e-6
+#define SPLINE_STORAGE_ERROR_TOLERANCE 1e-5
 
 class Communicate;
 
@@ -35,6 +35,7 @@
 #include "QMCWaveFunctions/BsplineFactory/BsplineReaderBase.h"
 #include "QMCWaveFunctions/BsplineFactory/BsplineSet.h"
 #include "QMCWaveFunctions/BsplineFactory/createBsplineReader.h"
+#include "Platforms/Host/LargePages.h"
 
 namespace qmcplusplus
 {
@@ -128,6 +129,8 @@ std::unique_ptr<SPOSet> EinsplineSetBuilder::createSPOSetFromXML(xmlNodePtr cur)
   std::string useGPU = "no";
 #endif
   std::string GPUsharing = "no";
+  std::string hugepages("no");
+  std::string pinned("no");
   ScopedTimer spo_timer_scope(*timer_manager.createTimer("einspline::CreateSPOSetFromXML", timer_level_medium));
 
   {
@@ -148,6 +151,8 @@ std::unique_ptr<SPOSet> EinsplineSetBuilder::createSPOSetFromXML(xmlNodePtr cur)
     a.add(use_einspline_set_extended, "use_old_spline");
     a.add(myName, "tag");
     a.add(skip_checks, "skip_checks");
+    a.add(hugepages, "hugepages", {"no", "thp", "2MB", "1GB"});
+    a.add(pinned, "pinned", {"no", "yes"});
 #if defined(QMC_CUDA)
     a.add(gpu::MaxGPUSpineSizeMB, "Spline_Size_Limit_MB");
 #endif
@@ -322,12 +327,39 @@ std::unique_ptr<SPOSet> EinsplineSetBuilder::createSPOSetFromXML(xmlNodePtr cur)
   }
 
   MixedSplineReader->setCommon(XMLRoot);
+#if defined(ENABLE_OFFLOAD)
+  // split the bands over the OpenMP offload devices visible to this rank
+  MixedSplineReader->setShardOverDevices(useGPU == "yes" && (GPUsharing == "yes" || GPUsharing == "1"));
+#endif
   // temporary disable the following function call, Ye Luo
   // RotateBands_ESHDF(spinSet, dynamic_cast<EinsplineSetExtended<std::complex<double> >*>(OrbitalSet));
-  HasCoreOrbs     = bcastSortBands(spinSet, NumDistinctOrbitals, myComm->rank() == 0);
-  auto OrbitalSet = MixedSplineReader->create_spline_set(spinSet, spo_cur);
+  HasCoreOrbs = bcastSortBands(spinSet, NumDistinctOrbitals, myComm->rank() == 0);
+  LargePageOptions coefs_pages;
+  coefs_pages.kind   = parseLargePageKind(hugepages);
+  coefs_pages.pinned = pinned == "yes";
+  std::unique_ptr<SPOSet> OrbitalSet;
+  {
+    // the spline coefficients are allocated by the reader
+    ScopedLargePageOptions coefs_pages_scope(coefs_pages);
+    OrbitalSet = MixedSplineReader->create_spline_set(spinSet, spo_cur);
+  }
   if (!OrbitalSet)
     myComm->barrier_and_abort("Failed to create SPOSet*");
+  if (coefs_pages.kind != LargePageKind::DEFAULT || coefs_pages.pinned)
+  {
+    const LargePageStats stats = getLargePageStats();
+    app_log() << "  Spline coefficients on " << getLargePageKindName(coefs_pages.kind) << " huge pages"
+              << (coefs_pages.pinned ? ", pinned" : "") << ". Process large page regions " << (stats.bytes >> 20)
+              << " MB, explicit huge pages " << (stats.hugetlb_bytes >> 20) << " MB, pinned "
+              << (stats.pinned_bytes >> 20) << " MB." << std::endl;
+    if (stats.hugetlb_fallbacks > 0)
+      app_warning() << "  " << stats.hugetlb_fallbacks
+                    << " requests of explicit huge pages fell back to transparent huge pages."
+                    << " Reserve them with /proc/sys/vm/nr_hugepages." << std::endl;
+    if (stats.pin_failures > 0)
+      app_warning() << "  " << stats.pin_failures << " page locks failed, raise the memlock limit (ulimit -l)."
+                    << std::endl;
+  }
 #if defined(MIXED_PRECISION)
   if (use_einspline_set_extended == "yes")
     myComm->barrier_and_abort("Option use_old_spline is not supported by the mixed precision build!");
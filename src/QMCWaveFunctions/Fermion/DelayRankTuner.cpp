@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "DelayRankTuner.h"
+#include <algorithm>
+#include <stdexcept>
+#include "Platforms/Host/OutputManager.h"
+
+namespace qmcplusplus
+{
+DelayRankTuner::DelayRankTuner(const std::string& name, int norb, int samples_per_rank, int max_rank)
+    : name_(name), samples_per_rank_(samples_per_rank), current_(0)
+{
+  if (norb < 1 || samples_per_rank < 1)
+    throw std::runtime_error("DelayRankTuner requires positive norb and samples_per_rank!");
+  const int highest = std::min(norb, max_rank);
+  candidates_.push_back(1);
+  for (int rank = 2; rank <= highest; rank *= 2)
+    candidates_.push_back(rank);
+  total_time_.resize(candidates_.size(), 0.0);
+  num_samples_.resize(candidates_.size(), 0);
+  current_rank_ = candidates_[0];
+  tuning_       = candidates_.size() > 1;
+}
+
+void DelayRankTuner::recordCycle(int rank, double elapsed, int num_walkers)
+{
+  if (!tuning_)
+    return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!tuning_ || rank != candidates_[current_])
+    return;
+  // the first cycle of a candidate pays for allocations and cold caches.
+  if (num_samples_[current_]++ > 0)
+    total_time_[current_] += elapsed / std::max(num_walkers, 1);
+  if (num_samples_[current_] > samples_per_rank_)
+  {
+    if (current_ + 1 < candidates_.size())
+      current_rank_ = candidates_[++current_];
+    else
+      finalize();
+  }
+}
+
+void DelayRankTuner::finalize()
+{
+  int best = 0;
+  for (int i = 1; i < candidates_.size(); i++)
+    if (total_time_[i] < total_time_[best])
+      best = i;
+  current_rank_ = candidates_[best];
+  tuning_       = false;
+
+  app_log() << "  " << name_ << " delay rank tuning, average time per walker update cycle:" << std::endl;
+  for (int i = 0; i < candidates_.size(); i++)
+    app_log() << "    rank-" << candidates_[i] << " " << total_time_[i] / samples_per_rank_ << " s" << std::endl;
+  app_log() << "  " << name_ << " selected rank-" << current_rank_ << " delayed update" << std::endl;
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_DELAYRANKTUNER_H
+#define QMCPLUSPLUS_DELAYRANKTUNER_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Utilities/Timer.h"
+
+namespace qmcplusplus
+{
+/** select the delayed update rank of a determinant by timing its update cycles.
+ *
+ * The candidate ranks are tried one after another. Each candidate is used for
+ * a number of update cycles, a cycle being all the row updates between two
+ * calls of completeUpdates. The candidate with the lowest average time per walker
+ * cycle is then locked in and reported in the log.
+ * A single tuner is shared by all the copies of a determinant, possibly running on
+ * different threads. Timings measured with a rank other than the current
+ * candidate are discarded.
+ */
+class DelayRankTuner
+{
+public:
+  /** constructor
+   * @param name label used in the report
+   * @param norb number of orbitals in the determinant. Candidates are 1 and the powers of 2 up to min(norb, max_rank)
+   * @param samples_per_rank number of timed cycles per candidate
+   */
+  DelayRankTuner(const std::string& name, int norb, int samples_per_rank = 8, int max_rank = 128);
+
+  /// the rank to be used by the next update cycle
+  int getRank() const { return current_rank_; }
+
+  /// true until a rank is locked in
+  bool isTuning() const { return tuning_; }
+
+  const std::vector<int>& getCandidates() const { return candidates_; }
+
+  /** record the time spent by one update cycle
+   * @param rank delay rank used during the cycle
+   * @param elapsed time in seconds
+   * @param num_walkers number of walkers updated together in the cycle
+   */
+  void recordCycle(int rank, double elapsed, int num_walkers = 1);
+
+  /// accumulate the wall time of a scope when the tuner is still tuning
+  class ScopedCycleTimer
+  {
+  public:
+    ScopedCycleTimer(const DelayRankTuner* tuner, double& elapsed)
+        : elapsed_(elapsed), active_(tuner != nullptr && tuner->isTuning())
+    {}
+    ~ScopedCycleTimer()
+    {
+      if (active_)
+        elapsed_ += timer_.elapsed();
+    }
+
+  private:
+    double& elapsed_;
+    const bool active_;
+    Timer timer_;
+  };
+
+private:
+  const std::string name_;
+  const int samples_per_rank_;
+  /// candidate ranks in the order of trial
+  std::vector<int> candidates_;
+  /// accumulated time per walker cycle for each candidate
+  std::vector<double> total_time_;
+  /// number of cycles accumulated for each candidate, the first one is discarded as warmup
+  std::vector<int> num_samples_;
+  /// index of the candidate under trial
+  int current_;
+  std::atomic<int> current_rank_;
+  std::atomic<bool> tuning_;
+  std::mutex mutex_;
+
+  /// lock in the fastest candidate and report it
+  void finalize();
+};
+
+} // namespace qmcplusplus
+#endif
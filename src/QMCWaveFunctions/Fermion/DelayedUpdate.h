@@ -89,6 +89,11 @@ public:
 
   inline int getDelayCount() const { return delay_count; }
 
+  /// set the number of refinement steps of the mixed precision inversion
+  inline void setRefinementSteps(int steps) { detEng.setRefinementSteps(steps); }
+
+  inline int getDelayRank() const { return Binv.rows(); }
+
   /** compute the row of up-to-date Ainv
    * @param Ainv inverse matrix
    * @param rowchanged the row id corresponding to the proposed electron
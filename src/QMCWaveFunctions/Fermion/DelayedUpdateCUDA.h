@@ -163,6 +163,18 @@ public:
 
   inline int getDelayCount() const { return delay_count; }
 
+  /// set the number of refinement steps of the mixed precision inversion
+  inline void setRefinementSteps(int steps)
+  {
+#if defined(QMC_CUDA2HIP)
+    host_inverter_.setRefinementSteps(steps);
+#else
+    cusolver_invertor.setRefinementSteps(steps);
+#endif
+  }
+
+  inline int getDelayRank() const { return Binv.rows(); }
+
   /** compute the row of up-to-date Ainv
    * @param Ainv inverse matrix
    * @param rowchanged the row id corresponding to the proposed electron
@@ -34,12 +34,22 @@ DiracDeterminant<DU_TYPE>::DiracDeterminant(std::unique_ptr<SPOSet>&& spos,
                                             int first,
                                             int last,
                                             int ndelay,
-                                            DetMatInvertor matrix_inverter_kind)
+                                            DetMatInvertor matrix_inverter_kind,
+                                            bool tune_delay_rank,
+                                            int inverse_refinement_steps)
     : DiracDeterminantBase("DiracDeterminant", std::move(spos), first, last),
       ndelay_(ndelay),
       invRow_id(-1),
-      matrix_inverter_kind_(matrix_inverter_kind)
+      matrix_inverter_kind_(matrix_inverter_kind),
+      tuning_cycle_time_(0.0)
 {
+  host_inverter_.setRefinementSteps(inverse_refinement_steps);
+  updateEng.setRefinementSteps(inverse_refinement_steps);
+  if (tune_delay_rank)
+  {
+    const std::string tuner_name = ClassName + "[" + std::to_string(first) + "," + std::to_string(last) + ")";
+    delay_rank_tuner_            = std::make_shared<DelayRankTuner>(tuner_name, NumPtcls);
+  }
   resize(NumPtcls, NumPtcls);
 
   if (Optimizable)
@@ -77,7 +87,7 @@ void DiracDeterminant<DU_TYPE>::resize(int nel, int morb)
   int norb = morb;
   if (norb <= 0)
     norb = nel; // for morb == -1 (default)
-  updateEng.resize(norb, ndelay_);
+  updateEng.resize(norb, delay_rank_tuner_ ? delay_rank_tuner_->getRank() : ndelay_);
   psiM.resize(nel, norb);
   dpsiM.resize(nel, norb);
   d2psiM.resize(nel, norb);
@@ -92,6 +102,14 @@ void DiracDeterminant<DU_TYPE>::resize(int nel, int morb)
   LastAddressOfdV  = FirstAddressOfdV + NumPtcls * NumOrbitals * DIM;
 }
 
+template<typename DU_TYPE>
+void DiracDeterminant<DU_TYPE>::syncDelayRank()
+{
+  assert(updateEng.getDelayCount() == 0);
+  if (delay_rank_tuner_ && updateEng.getDelayRank() != delay_rank_tuner_->getRank())
+    updateEng.resize(NumOrbitals, delay_rank_tuner_->getRank());
+}
+
 template<typename DU_TYPE>
 typename DiracDeterminant<DU_TYPE>::GradType DiracDeterminant<DU_TYPE>::evalGrad(ParticleSet& P, int iat)
 {
@@ -99,7 +117,10 @@ typename DiracDeterminant<DU_TYPE>::GradType DiracDeterminant<DU_TYPE>::evalGrad
   const int WorkingIndex = iat - FirstIndex;
   assert(WorkingIndex >= 0);
   invRow_id = WorkingIndex;
-  updateEng.getInvRow(psiM, WorkingIndex, invRow);
+  {
+    DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), tuning_cycle_time_);
+    updateEng.getInvRow(psiM, WorkingIndex, invRow);
+  }
   GradType g = simd::dot(invRow.data(), dpsiM[WorkingIndex], invRow.size());
   assert(checkG(g));
   return g;
@@ -150,6 +171,7 @@ typename DiracDeterminant<DU_TYPE>::PsiValueType DiracDeterminant<DU_TYPE>::rati
   // invRow is recomputed.
   if (invRow_id != WorkingIndex)
   {
+    DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), tuning_cycle_time_);
     invRow_id = WorkingIndex;
     updateEng.getInvRow(psiM, WorkingIndex, invRow);
   }
@@ -238,9 +260,12 @@ void DiracDeterminant<DU_TYPE>::acceptMove(ParticleSet& P, int iat, bool safe_to
   const int WorkingIndex = iat - FirstIndex;
   assert(WorkingIndex >= 0);
   log_value_ += convertValueToLog(curRatio);
-  updateEng.acceptRow(psiM, WorkingIndex, psiV, curRatio);
-  if (!safe_to_delay)
-    updateEng.updateInvMat(psiM);
+  {
+    DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), tuning_cycle_time_);
+    updateEng.acceptRow(psiM, WorkingIndex, psiV, curRatio);
+    if (!safe_to_delay)
+      updateEng.updateInvMat(psiM);
+  }
   // invRow becomes invalid after accepting a move
   invRow_id = -1;
   if (UpdateMode == ORB_PBYP_PARTIAL)
@@ -265,7 +290,16 @@ void DiracDeterminant<DU_TYPE>::completeUpdates()
   ScopedTimer local_timer(UpdateTimer);
   // invRow becomes invalid after updating the inverse matrix
   invRow_id = -1;
-  updateEng.updateInvMat(psiM);
+  {
+    DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), tuning_cycle_time_);
+    updateEng.updateInvMat(psiM);
+  }
+  if (delay_rank_tuner_ && delay_rank_tuner_->isTuning() && tuning_cycle_time_ > 0.0)
+  {
+    delay_rank_tuner_->recordCycle(updateEng.getDelayRank(), tuning_cycle_time_);
+    tuning_cycle_time_ = 0.0;
+  }
+  syncDelayRank();
 }
 
 template<typename DU_TYPE>
@@ -386,6 +420,7 @@ typename DiracDeterminant<DU_TYPE>::PsiValueType DiracDeterminant<DU_TYPE>::rati
     // This is intended to save redundant compuation in TM1 and TM3
     if (invRow_id != WorkingIndex)
     {
+      DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), tuning_cycle_time_);
       invRow_id = WorkingIndex;
       updateEng.getInvRow(psiM, WorkingIndex, invRow);
     }
@@ -675,8 +710,15 @@ void DiracDeterminant<DU_TYPE>::evaluateDerivatives(ParticleSet& P,
 template<typename DU_TYPE>
 std::unique_ptr<DiracDeterminantBase> DiracDeterminant<DU_TYPE>::makeCopy(std::unique_ptr<SPOSet>&& spo) const
 {
-  return std::make_unique<DiracDeterminant<DU_TYPE>>(std::move(spo), FirstIndex, LastIndex, ndelay_,
-                                                     matrix_inverter_kind_);
+  auto copy = std::make_unique<DiracDeterminant<DU_TYPE>>(std::move(spo), FirstIndex, LastIndex, ndelay_,
+                                                          matrix_inverter_kind_, false,
+                                                          host_inverter_.getRefinementSteps());
+  if (delay_rank_tuner_)
+  {
+    copy->delay_rank_tuner_ = delay_rank_tuner_;
+    copy->syncDelayRank();
+  }
+  return copy;
 }
 
 template<typename DU_TYPE>
@@ -24,6 +24,7 @@
 
 #include "QMCWaveFunctions/Fermion/DiracDeterminantBase.h"
 #include "QMCWaveFunctions/Fermion/DelayedUpdate.h"
+#include "QMCWaveFunctions/Fermion/DelayRankTuner.h"
 #if defined(ENABLE_CUDA)
 #include "QMCWaveFunctions/Fermion/DelayedUpdateCUDA.h"
 #endif
@@ -56,12 +57,16 @@ public:
    *@param first index of the first particle
    *@param last index of last particle
    *@param ndelay delayed update rank
+   *@param tune_delay_rank select the delayed update rank by timing the update cycles, ndelay is ignored
+   *@param inverse_refinement_steps number of refinement steps after a single precision inversion, 0 for full precision
    */
   DiracDeterminant(std::unique_ptr<SPOSet>&& spos,
                    int first,
                    int last,
                    int ndelay                          = 1,
-                   DetMatInvertor matrix_inverter_kind = DetMatInvertor::ACCEL);
+                   DetMatInvertor matrix_inverter_kind = DetMatInvertor::ACCEL,
+                   bool tune_delay_rank                = false,
+                   int inverse_refinement_steps        = 0);
 
   // copy constructor and assign operator disabled
   DiracDeterminant(const DiracDeterminant& s)            = delete;
@@ -252,6 +257,14 @@ private:
   /// selected scheme for inversion
   const DetMatInvertor matrix_inverter_kind_;
 
+  /// delayed update rank tuner shared by all the copies, nullptr if the rank is fixed
+  std::shared_ptr<DelayRankTuner> delay_rank_tuner_;
+  /// time spent by updateEng in the current update cycle, only accumulated while tuning
+  double tuning_cycle_time_;
+
+  /// adopt the rank selected by delay_rank_tuner_. Only allowed without pending delayed updates.
+  void syncDelayRank();
+
   /// invert psiM or its copies
   void invertPsiM(const ValueMatrix& logdetT, ValueMatrix& invMat);
 
@@ -31,14 +31,23 @@ DiracDeterminantBatched<DET_ENGINE>::DiracDeterminantBatched(std::unique_ptr<SPO
                                                              int first,
                                                              int last,
                                                              int ndelay,
-                                                             DetMatInvertor matrix_inverter_kind)
+                                                             DetMatInvertor matrix_inverter_kind,
+                                                             bool tune_delay_rank,
+                                                             int inverse_refinement_steps)
     : DiracDeterminantBase("DiracDeterminantBatched", std::move(spos), first, last),
       ndelay_(ndelay),
       matrix_inverter_kind_(matrix_inverter_kind),
+      tuning_cycle_time_(0.0),
       D2HTimer(*timer_manager.createTimer("DiracDeterminantBatched::D2H", timer_level_fine)),
       H2DTimer(*timer_manager.createTimer("DiracDeterminantBatched::H2D", timer_level_fine))
 {
   static_assert(std::is_same<SPOSet::ValueType, typename DET_ENGINE::Value>::value);
+  host_inverter_.setRefinementSteps(inverse_refinement_steps);
+  if (tune_delay_rank)
+  {
+    const std::string tuner_name = ClassName + "[" + std::to_string(first) + "," + std::to_string(last) + ")";
+    delay_rank_tuner_            = std::make_shared<DelayRankTuner>(tuner_name, NumPtcls);
+  }
   resize(NumPtcls, NumPtcls);
   if (Optimizable)
     Phi->buildOptVariables(NumPtcls);
@@ -125,7 +134,7 @@ void DiracDeterminantBatched<DET_ENGINE>::resize(int nel, int morb)
   dpsiM.attachReference(reinterpret_cast<Grad*>(psiM_vgl.data(1)), nel, norb);
   d2psiM.attachReference(psiM_vgl.data(4), nel, norb);
 
-  det_engine_.resize(norb, ndelay_);
+  det_engine_.resize(norb, delay_rank_tuner_ ? delay_rank_tuner_->getRank() : ndelay_);
 
   psiV.resize(NumOrbitals);
   psiV_host_view.attachReference(psiV.data(), NumOrbitals);
@@ -171,7 +180,10 @@ void DiracDeterminantBatched<DET_ENGINE>::mw_evalGrad(const RefVectorWithLeader<
     engine_list.push_back(det.det_engine_);
   }
 
-  DET_ENGINE::mw_evalGrad(engine_list, dpsiM_row_list, WorkingIndex, grad_now);
+  {
+    DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), wfc_leader.tuning_cycle_time_);
+    DET_ENGINE::mw_evalGrad(engine_list, dpsiM_row_list, WorkingIndex, grad_now);
+  }
 
 #ifndef NDEBUG
   for (int iw = 0; iw < nw; iw++)
@@ -188,7 +200,7 @@ typename DiracDeterminantBatched<DET_ENGINE>::PsiValue DiracDeterminantBatched<D
 
   {
     ScopedTimer local_timer(SPOVGLTimer);
-    Phi->evaluateVGL(P, iat, psiV_host_view, dpsiV_host_view, d2psiV_host_view);
+    evaluateVGLWithCache(P, iat, psiV_host_view, dpsiV_host_view, d2psiV_host_view);
   }
 
   {
@@ -230,7 +242,11 @@ void DiracDeterminantBatched<DET_ENGINE>::mw_ratioGrad(const RefVectorWithLeader
       engine_list.push_back(det.det_engine_);
     }
 
-    auto psiMinv_row_dev_ptr_list = DET_ENGINE::mw_getInvRow(engine_list, WorkingIndex, !Phi->isOMPoffload());
+    std::vector<const Value*> psiMinv_row_dev_ptr_list;
+    {
+      DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), wfc_leader.tuning_cycle_time_);
+      psiMinv_row_dev_ptr_list = DET_ENGINE::mw_getInvRow(engine_list, WorkingIndex, !Phi->isOMPoffload());
+    }
 
     phi_vgl_v.resize(NumOrbitals * wfc_list.size());
     ratios_local.resize(wfc_list.size());
@@ -238,8 +254,23 @@ void DiracDeterminantBatched<DET_ENGINE>::mw_ratioGrad(const RefVectorWithLeader
 
     VectorSoaContainer<Value, DIM + 2> phi_vgl_v_view(phi_vgl_v.data(), NumOrbitals * wfc_list.size(),
                                                       phi_vgl_v.capacity());
-    wfc_leader.Phi->mw_evaluateVGLandDetRatioGrads(phi_list, p_list, iat, psiMinv_row_dev_ptr_list, phi_vgl_v_view,
-                                                   ratios_local, grad_new_local);
+    if (!Phi->isOMPoffload() && wfc_leader.getSharedSPOEvaluationCache())
+    {
+      // host orbitals shared with another determinant, same layout as SPOSet::mw_evaluateVGLandDetRatioGrads
+      for (int iw = 0; iw < wfc_list.size(); iw++)
+      {
+        auto& det = wfc_list.getCastedElement<DiracDeterminantBatched<DET_ENGINE>>(iw);
+        Vector<Value> phi_v(phi_vgl_v_view.data() + NumOrbitals * iw, NumOrbitals);
+        Vector<Grad> dphi_v(reinterpret_cast<Grad*>(phi_vgl_v_view.data(1)) + NumOrbitals * iw, NumOrbitals);
+        Vector<Value> d2phi_v(phi_vgl_v_view.data(4) + NumOrbitals * iw, NumOrbitals);
+        det.evaluateVGLWithCache(p_list[iw], iat, phi_v, dphi_v, d2phi_v);
+        ratios_local[iw]   = simd::dot(psiMinv_row_dev_ptr_list[iw], phi_v.data(), NumOrbitals);
+        grad_new_local[iw] = simd::dot(psiMinv_row_dev_ptr_list[iw], dphi_v.data(), NumOrbitals) / ratios_local[iw];
+      }
+    }
+    else
+      wfc_leader.Phi->mw_evaluateVGLandDetRatioGrads(phi_list, p_list, iat, psiMinv_row_dev_ptr_list, phi_vgl_v_view,
+                                                     ratios_local, grad_new_local);
   }
 
   wfc_leader.UpdateMode = ORB_PBYP_PARTIAL;
@@ -324,6 +355,11 @@ void DiracDeterminantBatched<DET_ENGINE>::mw_accept_rejectMove(
     PRAGMA_OFFLOAD("omp target update to(phi_vgl_v_ptr[:phi_vgl_v.capacity()*5])")
   }
 
+  // a new update cycle starts, the rank can be changed safely
+  if (wfc_leader.det_engine_.getDelayCount() == 0)
+    mw_syncDelayRank(engine_list);
+
+  DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), wfc_leader.tuning_cycle_time_);
   DET_ENGINE::mw_accept_rejectRow(engine_list, WorkingIndex, psiM_g_dev_ptr_list, psiM_l_dev_ptr_list, isAccepted,
                                   phi_vgl_v.device_data(), phi_vgl_v.capacity(), ratios_local);
 
@@ -339,6 +375,97 @@ void DiracDeterminantBatched<DET_ENGINE>::restore(int iat)
   curRatio = 1.0;
 }
 
+template<typename DET_ENGINE>
+typename DiracDeterminantBatched<DET_ENGINE>::PsiValue DiracDeterminantBatched<DET_ENGINE>::ratioBlock(
+    const ParticleSet& P,
+    const std::vector<int>& iats)
+{
+  if (det_engine_.getDelayCount() != 0)
+    throw std::runtime_error("DiracDeterminantBatched::ratioBlock cannot be called with pending delayed updates!");
+  const int k = iats.size();
+  if (k == 0)
+    throw std::runtime_error("DiracDeterminantBatched::ratioBlock requires at least one electron!");
+  block_rows_.resize(k);
+  block_psiV_.resize(k, NumOrbitals);
+  block_dpsiV_.resize(k, NumOrbitals);
+  block_d2psiV_.resize(k, NumOrbitals);
+  {
+    ScopedTimer local_timer(SPOVGLTimer);
+    for (int a = 0; a < k; a++)
+    {
+      block_rows_[a] = iats[a] - FirstIndex;
+      Vector<Value> psi_v(block_psiV_[a], NumOrbitals);
+      Vector<Grad> dpsi_v(block_dpsiV_[a], NumOrbitals);
+      Vector<Value> d2psi_v(block_d2psiV_[a], NumOrbitals);
+      Phi->evaluateVGL(P, iats[a], psi_v, dpsi_v, d2psi_v);
+    }
+  }
+
+  ScopedTimer local_timer(RatioTimer);
+  auto& psiMinv = det_engine_.get_psiMinv();
+  // column major M(a,b) = psiMinv[row_b] . phi_a
+  block_lu_.resize(k, k);
+  block_pivot_.resize(k);
+  for (int b = 0; b < k; b++)
+    for (int a = 0; a < k; a++)
+      block_lu_[b][a] = simd::dot(psiMinv[block_rows_[b]], block_psiV_[a], NumOrbitals);
+  const int status = Xgetrf(k, k, block_lu_.data(), k, block_pivot_.data());
+  if (status < 0)
+  {
+    std::ostringstream msg;
+    msg << "Xgetrf failed with error " << status << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+  block_ratio_ = 1.0;
+  for (int i = 0; i < k; i++)
+    block_ratio_ *= (block_pivot_[i] == i + 1) ? block_lu_[i][i] : -block_lu_[i][i];
+  return block_ratio_;
+}
+
+template<typename DET_ENGINE>
+void DiracDeterminantBatched<DET_ENGINE>::acceptBlock()
+{
+  ScopedTimer local_timer(UpdateTimer);
+  const int k = block_rows_.size();
+  if (k == 0)
+    return;
+  const int norb = NumOrbitals;
+  auto& psiMinv  = det_engine_.get_ref_psiMinv();
+  const int lda  = psiMinv.cols();
+
+  // Minv = M^-1
+  int lwork = k * k;
+  std::vector<Value> work(lwork);
+  int status = Xgetri(k, block_lu_.data(), k, block_pivot_.data(), work.data(), lwork);
+  if (status != 0)
+  {
+    std::ostringstream msg;
+    msg << "Xgetri failed with error " << status << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+
+  // In the column major view, psiMinv holds B = A^-1 and the new rows are U.
+  // W = U B, D = W - E^T, Y = Minv D and B <- B - B E Y with E selecting the moved rows.
+  Matrix<Value> W(norb, k), Y(norb, k), R(k, lda);
+  BLAS::gemm('T', 'N', k, norb, norb, Value(1), block_psiV_.data(), norb, psiMinv.data(), lda, Value(0), W.data(), k);
+  for (int a = 0; a < k; a++)
+    W.data()[block_rows_[a] * k + a] -= Value(1);
+  BLAS::gemm('N', 'N', k, norb, k, Value(1), block_lu_.data(), k, W.data(), k, Value(0), Y.data(), k);
+  for (int b = 0; b < k; b++)
+    std::copy_n(psiMinv[block_rows_[b]], lda, R[b]);
+  BLAS::gemm('N', 'N', norb, norb, k, Value(-1), R.data(), lda, Y.data(), k, Value(1), psiMinv.data(), lda);
+  psiMinv.updateTo();
+
+  log_value_ += convertValueToLog(block_ratio_);
+  for (int a = 0; a < k; a++)
+  {
+    simd::copy(dpsiM[block_rows_[a]], block_dpsiV_[a], norb);
+    simd::copy(d2psiM[block_rows_[a]], block_d2psiV_[a], norb);
+  }
+  UpdateMode = ORB_PBYP_PARTIAL;
+  block_rows_.clear();
+}
+
 template<typename DET_ENGINE>
 void DiracDeterminantBatched<DET_ENGINE>::completeUpdates()
 {
@@ -369,6 +496,7 @@ void DiracDeterminantBatched<DET_ENGINE>::mw_completeUpdates(
 
   {
     ScopedTimer update(UpdateTimer);
+    DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), wfc_leader.tuning_cycle_time_);
     DET_ENGINE::mw_updateInvMat(engine_list);
   }
 
@@ -392,6 +520,26 @@ void DiracDeterminantBatched<DET_ENGINE>::mw_completeUpdates(
       PRAGMA_OFFLOAD("omp taskwait")
     }
   }
+
+  if (delay_rank_tuner_ && delay_rank_tuner_->isTuning() && wfc_leader.tuning_cycle_time_ > 0.0)
+  {
+    delay_rank_tuner_->recordCycle(wfc_leader.det_engine_.getDelayRank(), wfc_leader.tuning_cycle_time_, nw);
+    wfc_leader.tuning_cycle_time_ = 0.0;
+  }
+}
+
+template<typename DET_ENGINE>
+void DiracDeterminantBatched<DET_ENGINE>::mw_syncDelayRank(const RefVectorWithLeader<DET_ENGINE>& engine_list) const
+{
+  if (!delay_rank_tuner_)
+    return;
+  const int rank = delay_rank_tuner_->getRank();
+  for (DET_ENGINE& engine : engine_list)
+  {
+    assert(engine.getDelayCount() == 0);
+    if (engine.getDelayRank() != rank)
+      engine.resize(NumOrbitals, rank);
+  }
 }
 
 template<typename DET_ENGINE>
@@ -554,7 +702,7 @@ typename DiracDeterminantBatched<DET_ENGINE>::PsiValue DiracDeterminantBatched<D
   const int WorkingIndex = iat - FirstIndex;
   {
     ScopedTimer local_timer(SPOVTimer);
-    Phi->evaluateValue(P, iat, psiV_host_view);
+    evaluateValueWithCache(P, iat, psiV_host_view);
   }
   {
     auto& psiMinv = det_engine_.get_psiMinv();
@@ -573,10 +721,9 @@ void DiracDeterminantBatched<DET_ENGINE>::mw_calcRatio(const RefVectorWithLeader
   assert(this == &wfc_list.getLeader());
   auto& wfc_leader = wfc_list.getCastedLeader<DiracDeterminantBatched<DET_ENGINE>>();
   wfc_leader.guardMultiWalkerRes();
-  auto& mw_res         = *wfc_leader.mw_res_;
-  auto& phi_vgl_v      = mw_res.phi_vgl_v;
-  auto& ratios_local   = mw_res.ratios_local;
-  auto& grad_new_local = mw_res.grad_new_local;
+  auto& mw_res       = *wfc_leader.mw_res_;
+  auto& phi_vgl_v    = mw_res.phi_vgl_v;
+  auto& ratios_local = mw_res.ratios_local;
 
   {
     ScopedTimer local_timer(SPOVTimer);
@@ -593,18 +740,29 @@ void DiracDeterminantBatched<DET_ENGINE>::mw_calcRatio(const RefVectorWithLeader
       engine_list.push_back(det.det_engine_);
     }
 
-    auto psiMinv_row_dev_ptr_list = DET_ENGINE::mw_getInvRow(engine_list, WorkingIndex, !Phi->isOMPoffload());
+    std::vector<const Value*> psiMinv_row_dev_ptr_list;
+    {
+      DelayRankTuner::ScopedCycleTimer tuning_timer(delay_rank_tuner_.get(), wfc_leader.tuning_cycle_time_);
+      psiMinv_row_dev_ptr_list = DET_ENGINE::mw_getInvRow(engine_list, WorkingIndex, !Phi->isOMPoffload());
+    }
 
     phi_vgl_v.resize(NumOrbitals * wfc_list.size());
     ratios_local.resize(wfc_list.size());
-    grad_new_local.resize(wfc_list.size());
 
     VectorSoaContainer<Value, DIM + 2> phi_vgl_v_view(phi_vgl_v.data(), NumOrbitals * wfc_list.size(),
                                                       phi_vgl_v.capacity());
-    // calling Phi->mw_evaluateVGLandDetRatioGrads is a temporary workaround.
-    // We may implement mw_evaluateVandDetRatio in the future.
-    wfc_leader.Phi->mw_evaluateVGLandDetRatioGrads(phi_list, p_list, iat, psiMinv_row_dev_ptr_list, phi_vgl_v_view,
-                                                   ratios_local, grad_new_local);
+    // only values are needed here. dpsiM and d2psiM are recomputed in evaluateGL in the ORB_PBYP_RATIO mode.
+    if (!Phi->isOMPoffload() && wfc_leader.getSharedSPOEvaluationCache())
+      for (int iw = 0; iw < wfc_list.size(); iw++)
+      {
+        auto& det = wfc_list.getCastedElement<DiracDeterminantBatched<DET_ENGINE>>(iw);
+        Vector<Value> phi_v(phi_vgl_v_view.data() + NumOrbitals * iw, NumOrbitals);
+        det.evaluateValueWithCache(p_list[iw], iat, phi_v);
+        ratios_local[iw] = simd::dot(psiMinv_row_dev_ptr_list[iw], phi_v.data(), NumOrbitals);
+      }
+    else
+      wfc_leader.Phi->mw_evaluateVandDetRatio(phi_list, p_list, iat, psiMinv_row_dev_ptr_list, phi_vgl_v_view,
+                                              ratios_local);
   }
 
   wfc_leader.UpdateMode = ORB_PBYP_RATIO;
@@ -970,8 +1128,56 @@ void DiracDeterminantBatched<DET_ENGINE>::registerTWFFastDerivWrapper(const Part
 template<typename DET_ENGINE>
 std::unique_ptr<DiracDeterminantBase> DiracDeterminantBatched<DET_ENGINE>::makeCopy(std::unique_ptr<SPOSet>&& spo) const
 {
-  return std::make_unique<DiracDeterminantBatched<DET_ENGINE>>(std::move(spo), FirstIndex, LastIndex, ndelay_,
-                                                               matrix_inverter_kind_);
+  auto copy = std::make_unique<DiracDeterminantBatched<DET_ENGINE>>(std::move(spo), FirstIndex, LastIndex, ndelay_,
+                                                                    matrix_inverter_kind_, false,
+                                                                    host_inverter_.getRefinementSteps());
+  if (delay_rank_tuner_)
+  {
+    copy->delay_rank_tuner_ = delay_rank_tuner_;
+    copy->det_engine_.resize(NumOrbitals, delay_rank_tuner_->getRank());
+  }
+  return copy;
+}
+
+template<typename DET_ENGINE>
+void DiracDeterminantBatched<DET_ENGINE>::resetParameters(const opt_variables_type& active)
+{
+  Phi->resetParameters(active);
+  // the orbitals may have changed
+  if (spo_eval_cache_)
+    spo_eval_cache_->invalidate();
+}
+
+template<typename DET_ENGINE>
+void DiracDeterminantBatched<DET_ENGINE>::registerSPOEvaluationCache(SPOEvaluationCacheRegistry& registry)
+{
+  spo_eval_cache_ = registry.getCache(Phi->getName(), FirstIndex, LastIndex);
+}
+
+template<typename DET_ENGINE>
+void DiracDeterminantBatched<DET_ENGINE>::evaluateValueWithCache(const ParticleSet& P, int iat, Vector<Value>& psi)
+{
+  auto* cache = getSharedSPOEvaluationCache();
+  if (cache && cache->getValue(P, iat, psi))
+    return;
+  Phi->evaluateValue(P, iat, psi);
+  if (cache)
+    cache->putValue(P, iat, psi);
+}
+
+template<typename DET_ENGINE>
+void DiracDeterminantBatched<DET_ENGINE>::evaluateVGLWithCache(const ParticleSet& P,
+                                                               int iat,
+                                                               Vector<Value>& psi,
+                                                               Vector<Grad>& dpsi,
+                                                               Vector<Value>& d2psi)
+{
+  auto* cache = getSharedSPOEvaluationCache();
+  if (cache && cache->getVGL(P, iat, psi, dpsi, d2psi))
+    return;
+  Phi->evaluateVGL(P, iat, psi, dpsi, d2psi);
+  if (cache)
+    cache->putVGL(P, iat, psi, dpsi, d2psi);
 }
 
 template<typename DET_ENGINE>
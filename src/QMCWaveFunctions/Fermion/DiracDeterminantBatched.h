@@ -19,6 +19,8 @@
 
 #include "QMCWaveFunctions/Fermion/DiracDeterminantBase.h"
 #include "QMCWaveFunctions/Fermion/MatrixUpdateOMPTarget.h"
+#include "QMCWaveFunctions/Fermion/DelayRankTuner.h"
+#include "QMCWaveFunctions/SPOEvaluationCache.h"
 #if defined(ENABLE_CUDA) && defined(ENABLE_OFFLOAD)
 #include "QMCWaveFunctions/Fermion/MatrixDelayedUpdateCUDA.h"
 #endif
@@ -77,12 +79,16 @@ public:
    *@param first index of the first particle
    *@param last index of last particle
    *@param ndelay delayed update rank
+   *@param tune_delay_rank select the delayed update rank by timing the update cycles, ndelay is ignored
+   *@param inverse_refinement_steps number of refinement steps after a single precision inversion, 0 for full precision
    */
   DiracDeterminantBatched(std::unique_ptr<SPOSet>&& spos,
                           int first,
                           int last,
                           int ndelay                          = 1,
-                          DetMatInvertor matrix_inverter_kind = DetMatInvertor::ACCEL);
+                          DetMatInvertor matrix_inverter_kind = DetMatInvertor::ACCEL,
+                          bool tune_delay_rank                = false,
+                          int inverse_refinement_steps        = 0);
 
   // copy constructor and assign operator disabled
   DiracDeterminantBatched(const DiracDeterminantBatched& s)            = delete;
@@ -167,6 +173,21 @@ public:
    */
   void restore(int iat) override;
 
+  /** compute the ratio of a block move of several electrons of this determinant
+   * The proposed positions are read from P.R, so they must be set in P before the call.
+   * The ratio is the determinant of the kxk matrix M(a,b) = psiMinv[iats[b]] . phi(r'_a).
+   * Only valid outside of a particle-by-particle sweep, when psiMinv on the host is up to date.
+   * @param P particle set holding the proposed positions
+   * @param iats indices of the moved electrons
+   * @return psi(r')/psi(r)
+   */
+  PsiValue ratioBlock(const ParticleSet& P, const std::vector<int>& iats);
+
+  /** accept the block move computed by the last ratioBlock
+   * psiMinv is updated by a rank-k Woodbury update instead of k Sherman-Morrison updates.
+   */
+  void acceptBlock();
+
   /** evaluate from scratch pretty much everything for this single walker determinant
    *
    *  return of the log of the dirac determinant is the least of what it does.
@@ -206,6 +227,11 @@ public:
 
   void evaluateHessian(ParticleSet& P, HessVector& grad_grad_psi) override;
 
+  void resetParameters(const opt_variables_type& active) override;
+
+  /// share the orbital evaluations with the other users of the same SPOSet, see SPOEvaluationCache
+  void registerSPOEvaluationCache(SPOEvaluationCacheRegistry& registry) override;
+
   void createResource(ResourceCollection& collection) const override;
   void acquireResource(ResourceCollection& collection,
                        const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override;
@@ -266,11 +292,38 @@ public:
 
   /// psi(r')/psi(r) during a PbyP move
   PsiValue curRatio;
+
+  /// working indices of the electrons of the pending block move
+  std::vector<int> block_rows_;
+  /// orbital values, gradients and laplacians at the proposed positions of the block move, one row per electron
+  Matrix<Value> block_psiV_;
+  Matrix<Grad> block_dpsiV_;
+  Matrix<Value> block_d2psiV_;
+  /// LU factorization of the kxk matrix of the block move and its pivots
+  Matrix<Value> block_lu_;
+  std::vector<int> block_pivot_;
+  /// psi(r')/psi(r) of the pending block move
+  PsiValue block_ratio_;
   /**@}*/
 
   std::unique_ptr<DiracDeterminantBatchedMultiWalkerResource> mw_res_;
 
 private:
+  /// orbital evaluations shared with other determinants on the same SPOSet and particles, if any
+  std::shared_ptr<SPOEvaluationCache> spo_eval_cache_;
+
+  /// spo_eval_cache_ if another user shares it, nullptr otherwise
+  SPOEvaluationCache* getSharedSPOEvaluationCache() const
+  {
+    return spo_eval_cache_ && spo_eval_cache_->isShared() ? spo_eval_cache_.get() : nullptr;
+  }
+
+  /// Phi->evaluateValue unless a shared cache already holds the values
+  void evaluateValueWithCache(const ParticleSet& P, int iat, Vector<Value>& psi);
+
+  /// Phi->evaluateVGL unless a shared cache already holds the values, gradients and laplacians
+  void evaluateVGLWithCache(const ParticleSet& P, int iat, Vector<Value>& psi, Vector<Grad>& dpsi, Vector<Value>& d2psi);
+
   ///reset the size: with the number of particles and number of orbtials
   void resize(int nel, int morb);
 
@@ -326,6 +379,16 @@ private:
   /// selected scheme for inversion with walker batching
   const DetMatInvertor matrix_inverter_kind_;
 
+  /// delayed update rank tuner shared by all the copies, nullptr if the rank is fixed
+  std::shared_ptr<DelayRankTuner> delay_rank_tuner_;
+  /// time spent by the engines of a crowd in the current update cycle, only accumulated by the leader while tuning
+  double tuning_cycle_time_;
+
+  /** adopt the rank selected by delay_rank_tuner_ in all the engines.
+   *  Only allowed without pending delayed updates. All the engines of a crowd must use the same rank.
+   */
+  void mw_syncDelayRank(const RefVectorWithLeader<DET_ENGINE>& engine_list) const;
+
   /// timers
   NewTimer &D2HTimer, &H2DTimer;
 };
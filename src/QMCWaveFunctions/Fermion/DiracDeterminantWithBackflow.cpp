@@ -65,6 +65,7 @@ void DiracDeterminantWithBackflow::resize(int nel, int morb)
   Ajk_sum.resize(nel, norb);
   Qmat.resize(nel, norb);
   Fmat.resize(nel, norb);
+  dpsiM_packed.resize(norb, OHMMS_DIM * nel);
   Fmatdiag.resize(norb);
   psiMinv_temp.resize(NumPtcls, norb);
   psiV.resize(norb);
@@ -191,37 +192,100 @@ void DiracDeterminantWithBackflow::copyFromBuffer(ParticleSet& P, WFBufferType&
  * @param iat the particle thas is being moved
  */
 DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratio(ParticleSet& P, int iat)
+{
+  UpdateMode = ORB_PBYP_RATIO;
+  evaluateMovedQPs(false);
+  // FIX FIX FIX : code Woodbury formula
+  psiMinv_temp = psiM_temp;
+  // FIX FIX FIX : code Woodbury formula
+  InverseTimer.start();
+  LogValueType NewLog;
+  InvertWithLog(psiMinv_temp.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), NewLog);
+  InverseTimer.stop();
+  return curRatio = LogToValue<PsiValueType>::convert(NewLog - log_value_);
+}
+
+void DiracDeterminantWithBackflow::evaluateMovedQPs(bool with_grad)
 {
   // FIX FIX FIX : code Woodbury formula
   psiM_temp = psiM;
+  if (with_grad)
+    dpsiM_temp = dpsiM;
   // either code Woodbury or do multiple single particle updates
-  UpdateMode                        = ORB_PBYP_RATIO;
-  std::vector<int>::iterator it     = BFTrans_.indexQP.begin();
-  std::vector<int>::iterator it_end = BFTrans_.indexQP.end();
-  while (it != it_end)
+  for (int qp : BFTrans_.indexQP)
   {
-    if (*it < FirstIndex || *it >= LastIndex)
-    {
-      ++it;
+    if (qp < FirstIndex || qp >= LastIndex)
       continue;
+    int jat    = qp - FirstIndex;
+    PosType dr = BFTrans_.newQP[qp] - BFTrans_.QP.R[qp];
+    BFTrans_.QP.makeMove(qp, dr);
+    if (with_grad)
+    {
+      Phi->evaluateVGL(BFTrans_.QP, qp, psiV, dpsiV, d2psiV);
+      std::copy(dpsiV.begin(), dpsiV.end(), dpsiM_temp.begin(jat));
+      std::copy(grad_gradV.begin(), grad_gradV.end(), grad_grad_psiM_temp.begin(jat));
     }
-    int jat    = *it - FirstIndex;
-    PosType dr = BFTrans_.newQP[*it] - BFTrans_.QP.R[*it];
-    BFTrans_.QP.makeMove(*it, dr);
-    Phi->evaluateValue(BFTrans_.QP, *it, psiV);
+    else
+      Phi->evaluateValue(BFTrans_.QP, qp, psiV);
     for (int orb = 0; orb < psiV.size(); orb++)
       psiM_temp(orb, jat) = psiV[orb];
-    BFTrans_.QP.rejectMove(*it);
-    it++;
+    BFTrans_.QP.rejectMove(qp);
+  }
+}
+
+DiracDeterminantWithBackflow::GradType DiracDeterminantWithBackflow::computeGradTemp(int iat)
+{
+  GradType grad_iat;
+  for (int j = 0; j < NumPtcls; j++)
+  {
+    Fmatdiag_temp[j] = simd::dot(psiMinv_temp[j], dpsiM_temp[j], NumOrbitals);
+    grad_iat += dot(BFTrans_.Amat_temp(iat, FirstIndex + j), Fmatdiag_temp[j]);
+  }
+  return grad_iat;
+}
+
+const DiracDeterminantWithBackflow::MatrixInverter::OffloadPinnedVector<DiracDeterminantWithBackflow::LogValueType>&
+    DiracDeterminantWithBackflow::mw_invert(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list, bool temp)
+{
+  auto& leader = wfc_list.getCastedLeader<DiracDeterminantWithBackflow>();
+  if (!leader.mw_inverter_)
+    leader.mw_inverter_ = std::make_unique<MatrixInverter>();
+
+  RefVector<const ValueMatrix> a_mats;
+  RefVector<ValueMatrix> inv_a_mats;
+  a_mats.reserve(wfc_list.size());
+  inv_a_mats.reserve(wfc_list.size());
+  for (WaveFunctionComponent& wfc : wfc_list)
+  {
+    auto& det = static_cast<DiracDeterminantWithBackflow&>(wfc);
+    a_mats.push_back(temp ? det.psiM_temp : det.psiM);
+    inv_a_mats.push_back(temp ? det.psiMinv_temp : det.psiMinv);
+  }
+
+  ScopedTimer inverse_timer(leader.InverseTimer);
+  MatrixInverter::HandleResource dummy;
+  leader.mw_inverter_->mw_invert(dummy, a_mats, inv_a_mats, leader.mw_log_values_);
+  return leader.mw_log_values_;
+}
+
+void DiracDeterminantWithBackflow::mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                const RefVectorWithLeader<ParticleSet>& p_list,
+                                                int iat,
+                                                std::vector<PsiValueType>& ratios) const
+{
+  for (WaveFunctionComponent& wfc : wfc_list)
+  {
+    auto& det      = static_cast<DiracDeterminantWithBackflow&>(wfc);
+    det.UpdateMode = ORB_PBYP_RATIO;
+    det.evaluateMovedQPs(false);
+  }
+
+  const auto& new_logs = mw_invert(wfc_list, true);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& det  = wfc_list.getCastedElement<DiracDeterminantWithBackflow>(iw);
+    ratios[iw] = det.curRatio = LogToValue<PsiValueType>::convert(new_logs[iw] - det.log_value_);
   }
-  // FIX FIX FIX : code Woodbury formula
-  psiMinv_temp = psiM_temp;
-  // FIX FIX FIX : code Woodbury formula
-  InverseTimer.start();
-  LogValueType NewLog;
-  InvertWithLog(psiMinv_temp.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), NewLog);
-  InverseTimer.stop();
-  return curRatio = LogToValue<PsiValueType>::convert(NewLog - log_value_);
 }
 
 void DiracDeterminantWithBackflow::evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios)
@@ -263,31 +327,8 @@ DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratioGr
                                                                                    int iat,
                                                                                    GradType& grad_iat)
 {
-  // FIX FIX FIX : code Woodbury formula
-  psiM_temp                         = psiM;
-  dpsiM_temp                        = dpsiM;
-  UpdateMode                        = ORB_PBYP_PARTIAL;
-  std::vector<int>::iterator it     = BFTrans_.indexQP.begin();
-  std::vector<int>::iterator it_end = BFTrans_.indexQP.end();
-  ParticleSet::ParticlePos dr;
-  while (it != it_end)
-  {
-    if (*it < FirstIndex || *it >= LastIndex)
-    {
-      ++it;
-      continue;
-    }
-    int jat    = *it - FirstIndex;
-    PosType dr = BFTrans_.newQP[*it] - BFTrans_.QP.R[*it];
-    BFTrans_.QP.makeMove(*it, dr);
-    Phi->evaluateVGL(BFTrans_.QP, *it, psiV, dpsiV, d2psiV);
-    for (int orb = 0; orb < psiV.size(); orb++)
-      psiM_temp(orb, jat) = psiV[orb];
-    std::copy(dpsiV.begin(), dpsiV.end(), dpsiM_temp.begin(jat));
-    std::copy(grad_gradV.begin(), grad_gradV.end(), grad_grad_psiM_temp.begin(jat));
-    BFTrans_.QP.rejectMove(*it);
-    it++;
-  }
+  UpdateMode = ORB_PBYP_PARTIAL;
+  evaluateMovedQPs(true);
   // FIX FIX FIX : code Woodbury formula
   psiMinv_temp = psiM_temp;
   // FIX FIX FIX : code Woodbury formula
@@ -295,13 +336,30 @@ DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratioGr
   LogValueType NewLog;
   InvertWithLog(psiMinv_temp.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), NewLog);
   InverseTimer.stop();
-  // update Fmatdiag_temp
-  for (int j = 0; j < NumPtcls; j++)
+  grad_iat += computeGradTemp(iat);
+  return curRatio = LogToValue<PsiValueType>::convert(NewLog - log_value_);
+}
+
+void DiracDeterminantWithBackflow::mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                const RefVectorWithLeader<ParticleSet>& p_list,
+                                                int iat,
+                                                std::vector<PsiValueType>& ratios,
+                                                std::vector<GradType>& grad_new) const
+{
+  for (WaveFunctionComponent& wfc : wfc_list)
   {
-    Fmatdiag_temp[j] = simd::dot(psiMinv_temp[j], dpsiM_temp[j], NumOrbitals);
-    grad_iat += dot(BFTrans_.Amat_temp(iat, FirstIndex + j), Fmatdiag_temp[j]);
+    auto& det      = static_cast<DiracDeterminantWithBackflow&>(wfc);
+    det.UpdateMode = ORB_PBYP_PARTIAL;
+    det.evaluateMovedQPs(true);
+  }
+
+  const auto& new_logs = mw_invert(wfc_list, true);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& det = wfc_list.getCastedElement<DiracDeterminantWithBackflow>(iw);
+    grad_new[iw] += det.computeGradTemp(iat);
+    ratios[iw] = det.curRatio = LogToValue<PsiValueType>::convert(new_logs[iw] - det.log_value_);
   }
-  return curRatio = LogToValue<PsiValueType>::convert(NewLog - log_value_);
 }
 
 void DiracDeterminantWithBackflow::testL(ParticleSet& P)
@@ -494,16 +552,50 @@ DiracDeterminantWithBackflow::LogValueType DiracDeterminantWithBackflow::evaluat
   InverseTimer.start();
   InvertWithLog(psiMinv.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), log_value_);
   InverseTimer.stop();
+  computeGL(P, G, L);
+  return log_value_;
+}
+
+void DiracDeterminantWithBackflow::mw_evaluateLog(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                  const RefVectorWithLeader<ParticleSet>& p_list,
+                                                  const RefVector<ParticleSet::ParticleGradient>& G_list,
+                                                  const RefVector<ParticleSet::ParticleLaplacian>& L_list) const
+{
+  for (WaveFunctionComponent& wfc : wfc_list)
+  {
+    auto& det = static_cast<DiracDeterminantWithBackflow&>(wfc);
+    det.evaluate_SPO(det.psiM, det.dpsiM, det.grad_grad_psiM);
+  }
+
+  const auto& logs = mw_invert(wfc_list, false);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& det      = wfc_list.getCastedElement<DiracDeterminantWithBackflow>(iw);
+    det.log_value_ = logs[iw];
+    det.computeGL(p_list[iw], G_list[iw], L_list[iw]);
+  }
+}
+
+void DiracDeterminantWithBackflow::computeFmat()
+{
+  // pack dpsiM so that F = psiMinv * dpsiM_packed is a single gemm instead of NumPtcls^2 dot products
+  for (int j = 0; j < NumPtcls; j++)
+    for (int orb = 0; orb < NumOrbitals; orb++)
+      for (int d = 0; d < OHMMS_DIM; d++)
+        dpsiM_packed(orb, OHMMS_DIM * j + d) = dpsiM(j, orb)[d];
+  const int ncols = OHMMS_DIM * NumPtcls;
+  BLAS::gemm('N', 'N', ncols, NumPtcls, NumOrbitals, ValueType(1), dpsiM_packed.data(), dpsiM_packed.cols(),
+             psiMinv.data(), psiMinv.cols(), ValueType(0), Fmat.data()->data(), OHMMS_DIM * Fmat.cols());
+}
+
+void DiracDeterminantWithBackflow::computeGL(const ParticleSet& P,
+                                             ParticleSet::ParticleGradient& G,
+                                             ParticleSet::ParticleLaplacian& L)
+{
   // calculate F matrix (gradients wrt bf coordinates)
-  // could use dgemv with increments of 3*nCols
+  computeFmat();
   for (int i = 0; i < NumPtcls; i++)
-  {
-    for (int j = 0; j < NumPtcls; j++)
-    {
-      Fmat(i, j) = simd::dot(psiMinv[i], dpsiM[j], NumOrbitals);
-    }
     Fmatdiag[i] = Fmat(i, i);
-  }
   // calculate gradients and first piece of laplacians
   GradType temp;
   ValueType temp2;
@@ -555,7 +647,6 @@ DiracDeterminantWithBackflow::LogValueType DiracDeterminantWithBackflow::evaluat
     L[i] += myL[i];
     G[i] += myG[i];
   }
-  return log_value_;
 }
 
 
@@ -624,12 +715,7 @@ void DiracDeterminantWithBackflow::evaluateDerivatives(ParticleSet& P,
     InvertWithLog(psiMinv.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), log_value_);
     InverseTimer.stop();
     //       calculate F matrix (gradients wrt bf coordinates)
-    //       could use dgemv with increments of 3*nCols
-    for (int i = 0; i < NumPtcls; i++)
-      for (int j = 0; j < NumPtcls; j++)
-      {
-        Fmat(i, j) = simd::dot(psiMinv[i], dpsiM[j], NumOrbitals);
-      }
+    computeFmat();
   }
   int num = P.getTotalNum();
   //mmorales: cheap trick for now
@@ -766,12 +852,7 @@ void DiracDeterminantWithBackflow::evaluateDerivatives(ParticleSet& P,
   InvertWithLog(psiMinv.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), log_value_);
   InverseTimer.stop();
   // calculate F matrix (gradients wrt bf coordinates)
-  // could use dgemv with increments of 3*nCols
-  for (int i = 0; i < NumPtcls; i++)
-    for (int j = 0; j < NumPtcls; j++)
-    {
-      Fmat(i, j) = simd::dot(psiMinv[i], dpsiM[j], NumOrbitals);
-    }
+  computeFmat();
   //for(int i=0, iat=FirstIndex; i<NumPtcls; i++, iat++)
   // G(iat) += Fmat(i,i);
   const ValueType ConstZero(0.0);
@@ -889,12 +970,7 @@ void DiracDeterminantWithBackflow::evaluateDerivatives(ParticleSet& P,
   InvertWithLog(psiMinv.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), log_value_);
   InverseTimer.stop();
   // calculate F matrix (gradients wrt bf coordinates)
-  // could use dgemv with increments of 3*nCols
-  for (int i = 0; i < NumPtcls; i++)
-    for (int j = 0; j < NumPtcls; j++)
-    {
-      Fmat(i, j) = simd::dot(psiMinv[i], dpsiM[j], NumOrbitals);
-    }
+  computeFmat();
   //for(int i=0, iat=FirstIndex; i<NumPtcls; i++, iat++)
   // G(iat) += Fmat(i,i);
   // this is a mess, there should be a better way
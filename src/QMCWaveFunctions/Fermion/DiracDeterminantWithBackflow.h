@@ -23,6 +23,7 @@
 #include "Utilities/TimerManager.h"
 #include "QMCWaveFunctions/Fermion/DiracDeterminantBase.h"
 #include "OhmmsPETE/OhmmsArray.h"
+#include "QMCWaveFunctions/Fermion/DiracMatrixComputeOMPTarget.hpp"
 
 namespace qmcplusplus
 {
@@ -98,6 +99,30 @@ public:
 
   PsiValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat) override;
   GradType evalGrad(ParticleSet& P, int iat) override;
+
+  /** ratios of a batch of walkers.
+   *  The quasiparticles must have been moved by the backflow transformation of each walker.
+   *  The matrices of all the walkers are inverted at once.
+   */
+  void mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios) const override;
+
+  /// batched version of ratioGrad, see mw_calcRatio
+  void mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new) const override;
+
+  /** batched version of evaluateLog.
+   *  The backflow transformation of each walker must be up to date.
+   */
+  void mw_evaluateLog(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                      const RefVectorWithLeader<ParticleSet>& p_list,
+                      const RefVector<ParticleSet::ParticleGradient>& G_list,
+                      const RefVector<ParticleSet::ParticleLaplacian>& L_list) const override;
   GradType evalGradSource(ParticleSet& P, ParticleSet& source, int iat) override;
 
   GradType evalGradSource(ParticleSet& P,
@@ -212,8 +237,40 @@ private:
   ParticleSet::ParticleGradient myG, myG_temp;
   ParticleSet::ParticleLaplacian myL, myL_temp;
 
+  /// packed copy of dpsiM, dpsiM_packed(orb, 3*j+d) = dpsiM(j, orb)[d]
+  Matrix<ValueType> dpsiM_packed;
+
+  using MatrixInverter = DiracMatrixComputeOMPTarget<QMCTraits::QTFull::ValueType>;
+  /// batched inversion engine, only used by the leader of a walker batch
+  std::unique_ptr<MatrixInverter> mw_inverter_;
+  /// log values of the matrices inverted by mw_inverter_
+  MatrixInverter::OffloadPinnedVector<LogValueType> mw_log_values_;
+
   void dummyEvalLi(ValueType& L1, ValueType& L2, ValueType& L3);
 
+  /// Fmat(i,j) = sum_orb psiMinv(i,orb) dpsiM(j,orb) as a single gemm
+  void computeFmat();
+
+  /// gradients and laplacians from psiMinv, Fmat and the backflow matrices
+  void computeGL(const ParticleSet& P, ParticleSet::ParticleGradient& G, ParticleSet::ParticleLaplacian& L);
+
+  /** copy psiM to psiM_temp and replace the columns of the quasiparticles moved by the backflow transformation
+   * @param with_grad if true, dpsiM_temp and grad_grad_psiM_temp are updated as well
+   */
+  void evaluateMovedQPs(bool with_grad);
+
+  /// Fmatdiag_temp from psiMinv_temp and dpsiM_temp, returns the gradient of iat
+  GradType computeGradTemp(int iat);
+
+  /** invert a matrix of each determinant in a batch of walkers at once
+   * @param wfc_list the determinants of a walker batch
+   * @param temp if true, psiM_temp is inverted into psiMinv_temp, otherwise psiM into psiMinv
+   * @return the log values of the inverted matrices
+   */
+  static const MatrixInverter::OffloadPinnedVector<LogValueType>& mw_invert(
+      const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+      bool temp);
+
   void evaluate_SPO(ValueMatrix& logdet, GradMatrix& dlogdet, HessMatrix& grad_grad_logdet);
   void evaluate_SPO(ValueMatrix& logdet,
                     GradMatrix& dlogdet,
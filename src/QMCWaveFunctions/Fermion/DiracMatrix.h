@@ -12,7 +12,9 @@
 #ifndef QMCPLUSPLUS_DIRAC_MATRIX_H
 #define QMCPLUSPLUS_DIRAC_MATRIX_H
 
+#include <algorithm>
 #include "CPU/Blasf.h"
+#include "CPU/BLAS.hpp"
 #include "CPU/BlasThreadingEnv.h"
 #include "OhmmsPETE/OhmmsMatrix.h"
 #include "type_traits/complex_help.hpp"
@@ -104,13 +106,38 @@ inline void computeLogDet(const T* restrict diag, int n, const int* restrict piv
     logdet += std::log(std::complex<T_FP>((pivot[i] == i + 1) ? diag[i] : -diag[i]));
 }
 
+/// single precision counterpart of a value type, used by the refined mixed precision inversion
+template<typename T>
+struct LowerPrecision
+{
+  using type = T;
+};
+
+template<>
+struct LowerPrecision<double>
+{
+  using type = float;
+};
+
+template<>
+struct LowerPrecision<std::complex<double>>
+{
+  using type = std::complex<float>;
+};
+
 /** helper class to compute matrix inversion and the log value of determinant
  * @tparam T_FP the datatype used in the actual computation of matrix inversion
+ *
+ * When refinement steps are requested and T_FP is a double precision type, the matrix is
+ * factorized and inverted in single precision and the inverse is then refined in T_FP
+ * by Newton-Schulz iterations X <- X (2I - A X). Each iteration squares the residual.
+ * The log value of determinant comes from the single precision LU factorization.
  */
 template<typename T_FP>
 class DiracMatrix
 {
   using Real_FP = RealAlias<T_FP>;
+  using T_LP    = typename LowerPrecision<T_FP>::type;
   aligned_vector<T_FP> m_work;
   aligned_vector<int> m_pivot;
   int Lwork;
@@ -118,6 +145,15 @@ class DiracMatrix
   Matrix<T_FP> psiM_fp;
   /// LU diagonal elements
   aligned_vector<T_FP> LU_diag;
+  /// number of Newton-Schulz steps after a single precision inversion, 0 disables the refined path
+  int num_refinement_steps_;
+  /// single precision work space of the refined path
+  Matrix<T_LP> psiM_lp_;
+  aligned_vector<T_LP> work_lp_;
+  aligned_vector<T_LP> LU_diag_lp_;
+  int lwork_lp_;
+  /// copy of the matrix to be inverted and temporaries of the refinement steps
+  Matrix<T_FP> refine_a_, refine_t_, refine_x_;
 
   /// reset internal work space
   inline void reset(T_FP* invMat_ptr, const int lda)
@@ -149,6 +185,11 @@ class DiracMatrix
   template<typename TREAL>
   inline void computeInvertAndLog(T_FP* invMat, const int n, const int lda, std::complex<TREAL>& LogDet)
   {
+    if (num_refinement_steps_ > 0 && !std::is_same<T_LP, T_FP>::value)
+    {
+      computeRefinedInvertAndLog(invMat, n, lda, LogDet);
+      return;
+    }
     BlasThreadingEnv knob(getNextLevelNumThreads());
     if (Lwork < lda)
       reset(invMat, lda);
@@ -171,8 +212,78 @@ class DiracMatrix
     }
   }
 
+  /** compute the inverse of invMat (in place) in single precision followed by Newton-Schulz refinement steps
+   * invMat is handled as a column major matrix with leading dimension lda.
+   * @tparam TREAL real type
+   * @param n invMat is n x n matrix
+   * @param lda the first dimension of invMat
+   * @param LogDet log determinant value of invMat before inversion, from the single precision LU
+   */
+  template<typename TREAL>
+  inline void computeRefinedInvertAndLog(T_FP* invMat, const int n, const int lda, std::complex<TREAL>& LogDet)
+  {
+    BlasThreadingEnv knob(getNextLevelNumThreads());
+    if (m_pivot.size() < lda)
+      m_pivot.resize(lda);
+    refine_a_.resize(n, lda);
+    refine_t_.resize(n, lda);
+    refine_x_.resize(n, lda);
+    psiM_lp_.resize(n, lda);
+    if (lwork_lp_ < lda)
+    {
+      lwork_lp_ = -1;
+      T_LP tmp;
+      int status = Xgetri(lda, psiM_lp_.data(), lda, m_pivot.data(), &tmp, lwork_lp_);
+      if (status != 0)
+      {
+        std::ostringstream msg;
+        msg << "Xgetri failed with error " << status << std::endl;
+        throw std::runtime_error(msg.str());
+      }
+      lwork_lp_ = std::max(static_cast<int>(std::real(tmp)), lda);
+      work_lp_.resize(lwork_lp_);
+      LU_diag_lp_.resize(lda);
+    }
+
+    const size_t size = static_cast<size_t>(n) * lda;
+    std::copy_n(invMat, size, refine_a_.data());
+    std::copy_n(invMat, size, psiM_lp_.data());
+    int status = Xgetrf(n, n, psiM_lp_.data(), lda, m_pivot.data());
+    if (status != 0)
+    {
+      std::ostringstream msg;
+      msg << "Xgetrf failed with error " << status << std::endl;
+      throw std::runtime_error(msg.str());
+    }
+    for (int i = 0; i < n; i++)
+      LU_diag_lp_[i] = psiM_lp_.data()[i * lda + i];
+    computeLogDet(LU_diag_lp_.data(), n, m_pivot.data(), LogDet);
+    status = Xgetri(n, psiM_lp_.data(), lda, m_pivot.data(), work_lp_.data(), lwork_lp_);
+    if (status != 0)
+    {
+      std::ostringstream msg;
+      msg << "Xgetri failed with error " << status << std::endl;
+      throw std::runtime_error(msg.str());
+    }
+    std::copy_n(psiM_lp_.data(), size, invMat);
+
+    for (int step = 0; step < num_refinement_steps_; step++)
+    {
+      // T = A X, X <- 2 X - X T
+      BLAS::gemm('N', 'N', n, n, n, T_FP(1), refine_a_.data(), lda, invMat, lda, T_FP(0), refine_t_.data(), lda);
+      std::copy_n(invMat, size, refine_x_.data());
+      BLAS::gemm('N', 'N', n, n, n, T_FP(-1), refine_x_.data(), lda, refine_t_.data(), lda, T_FP(2), invMat, lda);
+    }
+  }
+
 public:
-  DiracMatrix() : Lwork(0) {}
+  DiracMatrix() : Lwork(0), num_refinement_steps_(0), lwork_lp_(0) {}
+
+  /** set the number of Newton-Schulz steps applied after a single precision inversion
+   * @param steps 0 keeps the inversion fully in T_FP. Ignored if T_FP is already single precision.
+   */
+  void setRefinementSteps(int steps) { num_refinement_steps_ = steps; }
+  int getRefinementSteps() const { return num_refinement_steps_; }
 
   /** compute the inverse of the transpose of matrix A and its determinant value in log
    * when T_FP and TMAT are the same
@@ -69,26 +69,18 @@ private:
   OffloadPinnedVector<int> pivots_;
   OffloadPinnedVector<int> infos_;
 
-  /** reset internal work space.
-   *  My understanding might be off.
-   *
-   *  it smells that this is so complex.
+  /** reset internal work space for a batch of matrices.
+   *  All the matrices have the same shape, a single workspace query is enough.
    */
   inline void reset(OffloadPinnedVector<VALUE_FP>& psi_Ms, const int n, const int lda, const int batch_size)
   {
-    const int nw = batch_size;
-    pivots_.resize(lda * nw);
-    for (int iw = 0; iw < nw; ++iw)
-    {
-      lwork_ = -1;
-      VALUE_FP tmp;
-      FullPrecReal lw;
-      auto psi_M_ptr = psi_Ms.data() + iw * n * n;
-      Xgetri(lda, psi_M_ptr, lda, pivots_.data() + iw * n, &tmp, lwork_);
-      convert(tmp, lw);
-      lwork_ = static_cast<int>(lw);
-      m_work_.resize(lwork_);
-    }
+    pivots_.resize(lda * batch_size);
+    lwork_ = -1;
+    VALUE_FP tmp;
+    FullPrecReal lw;
+    Xgetri(lda, psi_Ms.data(), lda, pivots_.data(), &tmp, lwork_);
+    lw     = std::real(tmp);
+    lwork_ = static_cast<int>(lw);
   }
 
   /** reset internal work space for single walker case
@@ -130,33 +122,58 @@ private:
     Xgetri(n, a_mat.data(), lda, pivots_.data(), m_work_.data(), lwork_);
   }
 
-  template<typename TMAT>
-  inline void computeInvertAndLog(OffloadPinnedVector<TMAT>& psi_Ms,
+  /** compute the inverses (in place) and the log values of determinants of a batch of matrices
+   *  The matrices are stored one after another in psi_Ms with a stride n * lda.
+   *  Walkers are distributed over the threads and each thread calls single threaded LAPACK
+   *  which is much more efficient than threaded LAPACK on a sequence of small matrices.
+   * \param[inout] psi_Ms     the matrices
+   * \param[in]    n          actual dimension of square matrices
+   * \param[in]    lda        leading dimension of each matrix
+   * \param[in]    nw         number of matrices
+   * \param[out]   log_values log of the matrices before inversion
+   */
+  inline void computeInvertAndLog(OffloadPinnedVector<VALUE_FP>& psi_Ms,
                                   const int n,
                                   const int lda,
+                                  const int nw,
                                   OffloadPinnedVector<LogValue>& log_values)
   {
-    const int nw = log_values.size();
-    BlasThreadingEnv knob(getNextLevelNumThreads());
     if (lwork_ < lda)
       reset(psi_Ms, n, lda, nw);
     pivots_.resize(n * nw);
     LU_diags_fp_.resize(n * nw);
+    infos_.resize(nw);
+    m_work_.resize(lwork_ * nw);
+
+    const size_t stride = static_cast<size_t>(n) * lda;
+    BlasThreadingEnv knob(nw > 1 ? 1 : getNextLevelNumThreads());
+#pragma omp parallel for if (nw > 1)
     for (int iw = 0; iw < nw; ++iw)
     {
-      VALUE_FP* LU_M = psi_Ms.data() + iw * n * n;
-      Xgetrf(n, n, LU_M, lda, pivots_.data() + iw * n);
+      VALUE_FP* LU_M  = psi_Ms.data() + iw * stride;
+      int* pivots     = pivots_.data() + iw * n;
+      VALUE_FP* diags = LU_diags_fp_.data() + iw * n;
+      infos_[iw]      = Xgetrf(n, n, LU_M, lda, pivots);
+      if (infos_[iw] != 0)
+        continue;
       for (int i = 0; i < n; i++)
-        *(LU_diags_fp_.data() + iw * n + i) = LU_M[i * lda + i];
+        diags[i] = LU_M[i * lda + i];
       LogValue log_value{0.0, 0.0};
-      computeLogDet(LU_diags_fp_.data() + iw * n, n, pivots_.data() + iw * n, log_value);
+      computeLogDet(diags, n, pivots, log_value);
       log_values[iw] = log_value;
-      Xgetri(n, LU_M, lda, pivots_.data() + iw * n, m_work_.data(), lwork_);
+      int lwork      = lwork_;
+      infos_[iw]     = Xgetri(n, LU_M, lda, pivots, m_work_.data() + iw * lwork_, lwork);
     }
-  }
 
-  /// matrix inversion engine
-  DiracMatrix<VALUE_FP> detEng_;
+    for (int iw = 0; iw < nw; ++iw)
+      if (infos_[iw] != 0)
+      {
+        std::ostringstream msg;
+        msg << "DiracMatrixComputeOMPTarget LU inversion failed for walker " << iw << " with error " << infos_[iw]
+            << std::endl;
+        throw std::runtime_error(msg.str());
+      }
+  }
 
 public:
   DiracMatrixComputeOMPTarget() : Resource("DiracMatrixComputeOMPTarget"), lwork_(0) {}
@@ -216,8 +233,7 @@ public:
   }
 
   /** This covers both mixed and Full precision case.
-   *  
-   *  \todo measure if using the a_mats without a copy to contiguous vector is better.
+   *  The transposed matrices are packed in a compact layout and inverted all at once.
    */
   template<typename TMAT>
   inline void mw_invertTranspose(HandleResource& resource,
@@ -225,30 +241,67 @@ public:
                                  const RefVector<OffloadPinnedMatrix<TMAT>>& inv_a_mats,
                                  OffloadPinnedVector<LogValue>& log_values)
   {
-    for (int iw = 0; iw < a_mats.size(); iw++)
+    const int nw = a_mats.size();
+    if (nw == 0)
+      return;
+    const int n       = a_mats[0].get().rows();
+    const size_t nsqr = static_cast<size_t>(n) * n;
+    psiM_fp_.resize(nsqr * nw);
+
+#pragma omp parallel for if (nw > 1)
+    for (int iw = 0; iw < nw; ++iw)
+    {
+      const auto& a_mat = a_mats[iw].get();
+      simd::transpose(a_mat.data(), n, a_mat.cols(), psiM_fp_.data() + nsqr * iw, n, n);
+    }
+
+    computeInvertAndLog(psiM_fp_, n, n, nw, log_values);
+
+#pragma omp parallel for if (nw > 1)
+    for (int iw = 0; iw < nw; ++iw)
     {
       auto& Ainv = inv_a_mats[iw].get();
-      detEng_.invert_transpose(a_mats[iw].get(), Ainv, log_values[iw]);
-      Ainv.updateTo();
+      simd::remapCopy(n, n, psiM_fp_.data() + nsqr * iw, n, Ainv.data(), Ainv.cols());
     }
 
-    /* FIXME
-    const int nw     = a_mats.size();
-    const size_t n   = a_mats[0].get().rows();
-    const size_t lda = a_mats[0].get().cols();
-    const size_t ldb = inv_a_mats[0].get().cols();
+    for (int iw = 0; iw < nw; ++iw)
+      inv_a_mats[iw].get().updateTo();
+  }
+
+  /** compute the inverses of a batch of host matrices and their determinant values in log
+   *  The matrices are packed in a compact layout without transposition and inverted all at once.
+   *  Any host matrix container works, nothing is transferred to the device.
+   * @tparam MAT host matrix type
+   */
+  template<typename MAT>
+  inline void mw_invert(HandleResource& resource,
+                        const RefVector<const MAT>& a_mats,
+                        const RefVector<MAT>& inv_a_mats,
+                        OffloadPinnedVector<LogValue>& log_values)
+  {
+    const int nw = a_mats.size();
+    if (nw == 0)
+      return;
+    const int n       = a_mats[0].get().rows();
+    const size_t nsqr = static_cast<size_t>(n) * n;
+    psiM_fp_.resize(nsqr * nw);
+    log_values.resize(nw);
 
-    size_t nsqr{n * n};
-    psiM_fp_.resize(n * lda * nw);
+#pragma omp parallel for if (nw > 1)
     for (int iw = 0; iw < nw; ++iw)
-      simd::transpose(a_mats[iw].get().data(), n, lda, psiM_fp_.data() + nsqr * iw, n, lda);
+    {
+      const auto& a_mat = a_mats[iw].get();
+      simd::remapCopy(n, n, a_mat.data(), a_mat.cols(), psiM_fp_.data() + nsqr * iw, n);
+    }
 
-    computeInvertAndLog(psiM_fp_, n, lda, log_values);
+    computeInvertAndLog(psiM_fp_, n, n, nw, log_values);
+
+#pragma omp parallel for if (nw > 1)
     for (int iw = 0; iw < nw; ++iw)
     {
-      simd::remapCopy(n, n, psiM_fp_.data() + nsqr * iw, lda, inv_a_mats[iw].get().data(), ldb);
+      auto& Ainv = inv_a_mats[iw].get();
+      simd::remapCopy(n, n, psiM_fp_.data() + nsqr * iw, n, Ainv.data(), Ainv.cols());
     }
-    */
   }
 };
 } // namespace qmcplusplus
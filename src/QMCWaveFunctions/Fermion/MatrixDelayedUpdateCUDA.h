@@ -13,6 +13,9 @@
 #ifndef QMCPLUSPLUS_MATRIX_DELAYED_UPDATE_CUDA_H
 #define QMCPLUSPLUS_MATRIX_DELAYED_UPDATE_CUDA_H
 
+#include <array>
+#include <cstdint>
+#include "config.h"
 #include "OhmmsPETE/OhmmsVector.h"
 #include "OhmmsPETE/OhmmsMatrix.h"
 #include "DualAllocatorAliases.hpp"
@@ -23,6 +26,7 @@
 #include "CUDA/cuBLAS_missing_functions.hpp"
 #include "CUDA/CUDALinearAlgebraHandles.h"
 #include "QMCWaveFunctions/detail/CUDA/matrix_update_helper.hpp"
+#include "QMCWaveFunctions/detail/CUDA/DeviceTimerCUDA.hpp"
 #include "DualAllocatorAliases.hpp"
 #include "DiracMatrixComputeCUDA.hpp"
 #include "ResourceCollection.h"
@@ -83,6 +87,18 @@ public:
     UnpinnedDualVector<Value> mw_temp;
     // scratch space for keeping one row of Ainv
     UnpinnedDualVector<Value> mw_rcopy;
+    /// device time of the kernels and transfers on the crowd stream
+    DeviceTimerCUDA device_timer;
+#if defined(QMC_CUDA_GRAPHS)
+    /// instantiated graph and the launch parameters it was captured with
+    struct CapturedGraph
+    {
+      cudaGraphExec_t exec = nullptr;
+      std::array<std::uintptr_t, 8> key{};
+    };
+    /// mw_prepareInvRow graphs indexed by delay_count
+    std::vector<CapturedGraph> prepare_inv_row_graphs;
+#endif
 
     MatrixDelayedUpdateCUDAMultiWalkerMem() : Resource("MatrixDelayedUpdateCUDAMultiWalkerMem") {}
 
@@ -90,6 +106,15 @@ public:
         : MatrixDelayedUpdateCUDAMultiWalkerMem()
     {}
 
+#if defined(QMC_CUDA_GRAPHS)
+    ~MatrixDelayedUpdateCUDAMultiWalkerMem() override
+    {
+      for (auto& graph : prepare_inv_row_graphs)
+        if (graph.exec)
+          cudaGraphExecDestroy(graph.exec);
+    }
+#endif
+
     Resource* makeClone() const override { return new MatrixDelayedUpdateCUDAMultiWalkerMem(*this); }
   };
 
@@ -189,6 +214,9 @@ private:
   /** compute the row of up-to-date Ainv
    * @param Ainv inverse matrix
    * @param rowchanged the row id corresponding to the proposed electron
+   *
+   * With QMC_CUDA_GRAPHS, the pointer upload and the four batched kernels are captured once per delay_count
+   * and replayed with a single graph launch. The graph is captured again if the crowd or its buffers changed.
    */
   static void mw_prepareInvRow(const RefVectorWithLeader<This_t>& engines, const int rowchanged)
   {
@@ -199,6 +227,7 @@ private:
     auto& cone_vec                   = engine_leader.mw_mem_->cone_vec;
     auto& czero_vec                  = engine_leader.mw_mem_->czero_vec;
     auto& prepare_inv_row_buffer_H2D = engine_leader.mw_mem_->prepare_inv_row_buffer_H2D;
+    auto& device_timer               = engine_leader.mw_mem_->device_timer;
     const int norb                   = engine_leader.get_psiMinv().rows();
     const int nw                     = engines.size();
     int& delay_count                 = engine_leader.delay_count;
@@ -220,10 +249,6 @@ private:
       ptr_buffer[6][iw] = engine.V_gpu.data();
     }
 
-    cudaErrorCheck(cudaMemcpyAsync(prepare_inv_row_buffer_H2D.device_data(), prepare_inv_row_buffer_H2D.data(),
-                                   prepare_inv_row_buffer_H2D.size(), cudaMemcpyHostToDevice, hstream),
-                   "cudaMemcpyAsync prepare_inv_row_buffer_H2D failed!");
-
     Value** oldRow_mw_ptr = reinterpret_cast<Value**>(prepare_inv_row_buffer_H2D.device_data());
     Value** invRow_mw_ptr = reinterpret_cast<Value**>(prepare_inv_row_buffer_H2D.device_data() + sizeof(Value*) * nw);
     Value** U_mw_ptr    = reinterpret_cast<Value**>(prepare_inv_row_buffer_H2D.device_data() + sizeof(Value*) * nw * 2);
@@ -233,24 +258,61 @@ private:
         reinterpret_cast<Value**>(prepare_inv_row_buffer_H2D.device_data() + sizeof(Value*) * nw * 5);
     Value** V_mw_ptr = reinterpret_cast<Value**>(prepare_inv_row_buffer_H2D.device_data() + sizeof(Value*) * nw * 6);
 
-    // save Ainv[rowchanged] to invRow
-    //std::copy_n(Ainv[rowchanged], norb, invRow.data());
-    cudaErrorCheck(cuBLAS_MFs::copy_batched(hstream, norb, oldRow_mw_ptr, 1, invRow_mw_ptr, 1, nw),
-                   "cuBLAS_MFs::copy_batched failed!");
-    // multiply V (NxK) Binv(KxK) U(KxN) invRow right to the left
-    //BLAS::gemv('T', norb, delay_count, cone, U_gpu.data(), norb, invRow.data(), 1, czero, p_gpu.data(), 1);
-    //BLAS::gemv('N', delay_count, delay_count, -cone, Binv.data(), lda_Binv, p.data(), 1, czero, Binv[delay_count], 1);
-    //BLAS::gemv('N', norb, delay_count, cone, V.data(), norb, Binv[delay_count], 1, cone, invRow.data(), 1);
-    cudaErrorCheck(cuBLAS_MFs::gemv_batched(hstream, 'T', norb, delay_count, cone_vec.device_data(), U_mw_ptr, norb,
-                                            invRow_mw_ptr, 1, czero_vec.device_data(), p_mw_ptr, 1, nw),
-                   "cuBLAS_MFs::gemv_batched failed!");
-    cudaErrorCheck(cuBLAS_MFs::gemv_batched(hstream, 'N', delay_count, delay_count, cminusone_vec.device_data(),
-                                            Binv_mw_ptr, lda_Binv, p_mw_ptr, 1, czero_vec.device_data(), BinvRow_mw_ptr,
-                                            1, nw),
-                   "cuBLAS_MFs::gemv_batched failed!");
-    cudaErrorCheck(cuBLAS_MFs::gemv_batched(hstream, 'N', norb, delay_count, cone_vec.device_data(), V_mw_ptr, norb,
-                                            BinvRow_mw_ptr, 1, cone_vec.device_data(), invRow_mw_ptr, 1, nw),
-                   "cuBLAS_MFs::gemv_batched failed!");
+    auto enqueue_kernels = [&]() {
+      prepare_inv_row_buffer_H2D.updateToAsync(hstream);
+      // save Ainv[rowchanged] to invRow
+      //std::copy_n(Ainv[rowchanged], norb, invRow.data());
+      cudaErrorCheck(cuBLAS_MFs::copy_batched(hstream, norb, oldRow_mw_ptr, 1, invRow_mw_ptr, 1, nw),
+                     "cuBLAS_MFs::copy_batched failed!");
+      // multiply V (NxK) Binv(KxK) U(KxN) invRow right to the left
+      //BLAS::gemv('T', norb, delay_count, cone, U_gpu.data(), norb, invRow.data(), 1, czero, p_gpu.data(), 1);
+      //BLAS::gemv('N', delay_count, delay_count, -cone, Binv.data(), lda_Binv, p.data(), 1, czero, Binv[delay_count], 1);
+      //BLAS::gemv('N', norb, delay_count, cone, V.data(), norb, Binv[delay_count], 1, cone, invRow.data(), 1);
+      cudaErrorCheck(cuBLAS_MFs::gemv_batched(hstream, 'T', norb, delay_count, cone_vec.device_data(), U_mw_ptr, norb,
+                                              invRow_mw_ptr, 1, czero_vec.device_data(), p_mw_ptr, 1, nw),
+                     "cuBLAS_MFs::gemv_batched failed!");
+      cudaErrorCheck(cuBLAS_MFs::gemv_batched(hstream, 'N', delay_count, delay_count, cminusone_vec.device_data(),
+                                              Binv_mw_ptr, lda_Binv, p_mw_ptr, 1, czero_vec.device_data(), BinvRow_mw_ptr,
+                                              1, nw),
+                     "cuBLAS_MFs::gemv_batched failed!");
+      cudaErrorCheck(cuBLAS_MFs::gemv_batched(hstream, 'N', norb, delay_count, cone_vec.device_data(), V_mw_ptr, norb,
+                                              BinvRow_mw_ptr, 1, cone_vec.device_data(), invRow_mw_ptr, 1, nw),
+                     "cuBLAS_MFs::gemv_batched failed!");
+    };
+
+    device_timer.begin(hstream);
+#if defined(QMC_CUDA_GRAPHS)
+    auto& graphs = engine_leader.mw_mem_->prepare_inv_row_graphs;
+    if (graphs.size() <= static_cast<size_t>(delay_count))
+      graphs.resize(delay_count + 1);
+    auto& captured = graphs[delay_count];
+    // kernel arguments baked into the graph, the pointers in the pinned buffer are uploaded at every launch
+    const std::array<std::uintptr_t, 8> key{static_cast<std::uintptr_t>(nw),
+                                            static_cast<std::uintptr_t>(norb),
+                                            static_cast<std::uintptr_t>(lda_Binv),
+                                            reinterpret_cast<std::uintptr_t>(prepare_inv_row_buffer_H2D.data()),
+                                            reinterpret_cast<std::uintptr_t>(prepare_inv_row_buffer_H2D.device_data()),
+                                            reinterpret_cast<std::uintptr_t>(cone_vec.device_data()),
+                                            reinterpret_cast<std::uintptr_t>(cminusone_vec.device_data()),
+                                            reinterpret_cast<std::uintptr_t>(czero_vec.device_data())};
+    if (captured.exec == nullptr || captured.key != key)
+    {
+      if (captured.exec)
+        cudaErrorCheck(cudaGraphExecDestroy(captured.exec), "cudaGraphExecDestroy failed!");
+      cudaGraph_t graph;
+      cudaErrorCheck(cudaStreamBeginCapture(hstream, cudaStreamCaptureModeThreadLocal),
+                     "cudaStreamBeginCapture failed!");
+      enqueue_kernels();
+      cudaErrorCheck(cudaStreamEndCapture(hstream, &graph), "cudaStreamEndCapture failed!");
+      cudaErrorCheck(cudaGraphInstantiateWithFlags(&captured.exec, graph, 0), "cudaGraphInstantiateWithFlags failed!");
+      cudaErrorCheck(cudaGraphDestroy(graph), "cudaGraphDestroy failed!");
+      captured.key = key;
+    }
+    cudaErrorCheck(cudaGraphLaunch(captured.exec, hstream), "cudaGraphLaunch failed!");
+#else
+    enqueue_kernels();
+#endif
+    device_timer.endKernels(hstream, 4);
     // mark row prepared
     engine_leader.invRow_id = rowchanged;
   }
@@ -325,9 +387,7 @@ private:
     // update the inverse matrix
     engine_leader.resize_fill_constant_arrays(n_accepted);
 
-    cudaErrorCheck(cudaMemcpyAsync(updateRow_buffer_H2D.device_data(), updateRow_buffer_H2D.data(),
-                                   updateRow_buffer_H2D.size(), cudaMemcpyHostToDevice, hstream),
-                   "cudaMemcpyAsync updateRow_buffer_H2D failed!");
+    updateRow_buffer_H2D.updateToAsync(hstream);
 
     {
       Value** Ainv_mw_ptr = reinterpret_cast<Value**>(updateRow_buffer_H2D.device_data());
@@ -386,6 +446,10 @@ public:
     psiMinv_.resize(norb, getAlignedSize<Value>(norb));
   }
 
+  inline int getDelayRank() const { return Binv_gpu.rows(); }
+
+  inline int getDelayCount() const { return delay_count; }
+
   void createResource(ResourceCollection& collection) const
   {
     //the semantics of the ResourceCollection are such that we don't want to add a Resource that we need
@@ -463,9 +527,7 @@ public:
       ptr_buffer[1][iw] = dpsiM_row_list[iw];
     }
 
-    cudaErrorCheck(cudaMemcpyAsync(evalGrad_buffer_H2D.device_data(), evalGrad_buffer_H2D.data(),
-                                   evalGrad_buffer_H2D.size(), cudaMemcpyHostToDevice, hstream),
-                   "cudaMemcpyAsync evalGrad_buffer_H2D failed!");
+    evalGrad_buffer_H2D.updateToAsync(hstream);
 
     if (grads_value_v.rows() != nw || grads_value_v.cols() != GT::Size)
       grads_value_v.resize(nw, GT::Size);
@@ -474,11 +536,11 @@ public:
     const Value** dpsiM_row_ptr = reinterpret_cast<const Value**>(evalGrad_buffer_H2D.device_data()) + nw;
 
     const int norb = engine_leader.get_ref_psiMinv().rows();
+    engine_leader.mw_mem_->device_timer.begin(hstream);
     cudaErrorCheck(CUDA::calcGradients_cuda(hstream, norb, invRow_ptr, dpsiM_row_ptr, grads_value_v.device_data(), nw),
                    "CUDA::calcGradients_cuda failed!");
-    cudaErrorCheck(cudaMemcpyAsync(grads_value_v.data(), grads_value_v.device_data(),
-                                   grads_value_v.size() * sizeof(Value), cudaMemcpyDeviceToHost, hstream),
-                   "cudaMemcpyAsync grads_value_v failed!");
+    engine_leader.mw_mem_->device_timer.endKernels(hstream);
+    grads_value_v.updateFromAsync(hstream);
     engine_leader.waitStream();
 
     for (int iw = 0; iw < nw; iw++)
@@ -619,9 +681,7 @@ public:
       }
     }
 
-    cudaErrorCheck(cudaMemcpyAsync(accept_rejectRow_buffer_H2D.device_data(), accept_rejectRow_buffer_H2D.data(),
-                                   accept_rejectRow_buffer_H2D.size(), cudaMemcpyHostToDevice, hstream),
-                   "cudaMemcpyAsync prepare_inv_row_buffer_H2D failed!");
+    accept_rejectRow_buffer_H2D.updateToAsync(hstream);
 
     Value** invRow_mw_ptr = reinterpret_cast<Value**>(accept_rejectRow_buffer_H2D.device_data());
     Value** V_mw_ptr      = reinterpret_cast<Value**>(accept_rejectRow_buffer_H2D.device_data() + sizeof(Value*) * nw);
@@ -651,6 +711,7 @@ public:
     Value* ratio_inv_mw_ptr =
         reinterpret_cast<Value*>(accept_rejectRow_buffer_H2D.device_data() + sizeof(Value*) * nw * 14);
 
+    engine_leader.mw_mem_->device_timer.begin(hstream);
     //std::copy_n(Ainv[rowchanged], norb, V[delay_count]);
     cudaErrorCheck(cuBLAS_MFs::copy_batched(hstream, norb, invRow_mw_ptr, 1, V_row_mw_ptr, 1, nw),
                    "cuBLAS_MFs::copy_batched failed!");
@@ -679,6 +740,7 @@ public:
                                                                dpsiM_mw_in, d2psiM_mw_in, U_row_mw_ptr, dpsiM_mw_out,
                                                                d2psiM_mw_out, norb, n_accepted, nw),
                    "CUDA::add_delay_list_save_y_VGL_batched failed!");
+    engine_leader.mw_mem_->device_timer.endKernels(hstream, 5);
     delay_count++;
     // update Ainv when maximal delay is reached
     if (delay_count == lda_Binv)
@@ -716,9 +778,7 @@ public:
       ptr_buffer[5][iw] = engine.Binv_gpu.data();
     }
 
-    cudaErrorCheck(cudaMemcpyAsync(updateInv_buffer_H2D.device_data(), updateInv_buffer_H2D.data(),
-                                   updateInv_buffer_H2D.size(), cudaMemcpyHostToDevice, hstream),
-                   "cudaMemcpyAsync updateInv_buffer_H2D failed!");
+    updateInv_buffer_H2D.updateToAsync(hstream);
 
     Value** U_mw_ptr        = reinterpret_cast<Value**>(updateInv_buffer_H2D.device_data());
     Value** Ainv_mw_ptr     = reinterpret_cast<Value**>(updateInv_buffer_H2D.device_data() + sizeof(Value*) * nw);
@@ -741,6 +801,7 @@ public:
     {
       const int lda_Binv = engine_leader.Binv_gpu.cols();
       constexpr Value cone(1), czero(0), cminusone(-1);
+      engine_leader.mw_mem_->device_timer.begin(hstream);
       cublasErrorCheck(cuBLAS::gemm_batched(h_cublas, CUBLAS_OP_T, CUBLAS_OP_N, delay_count, norb, norb, &cone,
                                             U_mw_ptr, norb, Ainv_mw_ptr, lda, &czero, tempMat_mw_ptr, lda_Binv, nw),
                        "cuBLAS::gemm_batched failed!");
@@ -752,6 +813,7 @@ public:
       cublasErrorCheck(cuBLAS::gemm_batched(h_cublas, CUBLAS_OP_N, CUBLAS_OP_N, norb, norb, delay_count, &cminusone,
                                             U_mw_ptr, norb, tempMat_mw_ptr, lda_Binv, &cone, Ainv_mw_ptr, lda, nw),
                        "cuBLAS::gemm_batched failed!");
+      engine_leader.mw_mem_->device_timer.endKernels(hstream, 4);
     }
     delay_count = 0;
   }
@@ -823,12 +885,17 @@ public:
   {
     auto& engine_leader = engines.getLeader();
     auto& hstream       = engine_leader.cuda_handles_->hstream;
+    auto& device_timer  = engine_leader.mw_mem_->device_timer;
     engine_leader.guard_no_delay();
 
+    size_t bytes = 0;
+    device_timer.begin(hstream);
     for (This_t& engine : engines)
-      cudaErrorCheck(cudaMemcpyAsync(engine.get_ref_psiMinv().data(), engine.get_ref_psiMinv().device_data(),
-                                     engine.get_psiMinv().size() * sizeof(Value), cudaMemcpyDeviceToHost, hstream),
-                     "cudaMemcpyAsync Ainv failed!");
+    {
+      engine.get_ref_psiMinv().updateFromAsync(hstream);
+      bytes += engine.get_ref_psiMinv().size() * sizeof(Value);
+    }
+    device_timer.endTransfer(hstream, bytes);
     engine_leader.waitStream();
   }
 
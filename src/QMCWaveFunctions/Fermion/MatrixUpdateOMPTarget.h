@@ -122,6 +122,11 @@ public:
    */
   inline void resize(int norb, int delay) { psiMinv_.resize(norb, getAlignedSize<Value>(norb)); }
 
+  /// only SM-1 is implemented
+  inline int getDelayRank() const { return 1; }
+
+  inline int getDelayCount() const { return 0; }
+
   void createResource(ResourceCollection& collection) const
   {
     collection.addResource(std::make_unique<MatrixUpdateOMPTargetMultiWalkerMem>());
@@ -46,16 +46,38 @@ void MultiDiracDeterminant::BuildDotProductsAndCalculateRatios_impl(int ref,
   }
   buildTableTimer.stop();
   readMatTimer.start();
-  std::vector<int>::const_iterator it2 = data.begin();
-  const size_t nitems                  = sign.size();
-  // explore Inclusive Scan for OpenMP
-  for (size_t count = 0; count < nitems; ++count)
+  // determinants screened out of the expansion are skipped
+  const char* restrict active = (active_dets_ && screening_enabled_) ? active_dets_->data() : nullptr;
+  const auto& groups          = *excitation_groups_;
+  if (&data == detData.get() && !groups.offsets.empty())
   {
-    const size_t n = *it2;
-    //ratios[count]=(count!=ref)?sign[count]*det0*CalculateRatioFromMatrixElements(n,dotProducts,it2+1):det0;
-    if (count != ref)
-      ratios[count] = sign[count] * det0 * CalculateRatioFromMatrixElements(n, dotProducts, it2 + 1);
-    it2 += 3 * n + 1;
+    // walk the determinants level by level in the order of the compact table
+    const ExcitationGroups::IndexType* restrict it = groups.indices.data();
+    for (int n = 0; n + 1 < groups.offsets.size(); ++n)
+      for (size_t k = groups.offsets[n]; k < groups.offsets[n + 1]; ++k, it += 2 * n)
+      {
+        const int count = groups.det_ids[k];
+        if (count != ref)
+          ratios[count] = (active && !active[count])
+              ? ValueType(0)
+              : groups.signs[k] * det0 * CalculateRatioFromMatrixElements(n, dotProducts, it);
+      }
+  }
+  else
+  {
+    std::vector<int>::const_iterator it2 = data.begin();
+    const size_t nitems                  = sign.size();
+    // explore Inclusive Scan for OpenMP
+    for (size_t count = 0; count < nitems; ++count)
+    {
+      const size_t n = *it2;
+      //ratios[count]=(count!=ref)?sign[count]*det0*CalculateRatioFromMatrixElements(n,dotProducts,it2+1):det0;
+      if (count != ref)
+        ratios[count] = (active && !active[count])
+            ? ValueType(0)
+            : sign[count] * det0 * CalculateRatioFromMatrixElements(n, dotProducts, it2 + 1);
+      it2 += 3 * n + 1;
+    }
   }
   ratios[ref] = det0;
   readMatTimer.stop();
@@ -197,6 +219,10 @@ void MultiDiracDeterminant::mw_evaluateDetsForPtclMove(const RefVectorWithLeader
   det_leader.RatioTimer.start();
 
   det_leader.UpdateMode = ORB_PBYP_RATIO;
+  // the dot products and the ratios of all the walkers are computed by the offload kernels
+  // unless an excitation level is too high for calcExcitedDeterminant
+  const bool use_offload          = det_leader.prepareMWTables();
+  det_leader.mw_ratios_on_device_ = false;
   /*  FOR YE: THIS IS NOT compiling...
   std::vector<RefVector<Vector<ValueVector>>> psiV_list;
   for (size_t iw=0;iw<nw;iw++)
@@ -241,18 +267,149 @@ void MultiDiracDeterminant::mw_evaluateDetsForPtclMove(const RefVectorWithLeader
     det.curRatio                                     = DetRatioByColumn(det.psiMinv_temp, det.psiV_temp, WorkingIndex);
     det.new_ratios_to_ref_[det.ReferenceDeterminant] = ValueType(1);
     InverseUpdateByColumn(det.psiMinv_temp, det.psiV_temp, det.workV1, det.workV2, WorkingIndex, det.curRatio);
+    det.ExtraStuffTimer.stop();
+    if (use_offload)
+      continue;
+
     for (size_t i = 0; i < det_leader.NumOrbitals; i++)
       det.TpsiM(i, WorkingIndex) = det.psiV[i];
-    det.ExtraStuffTimer.stop();
     det.BuildDotProductsAndCalculateRatios(det.ReferenceDeterminant, det.new_ratios_to_ref_, det.psiMinv_temp,
                                            det.TpsiM, det.dotProducts, *det.detData, *det.uniquePairs, *det.DetSigns);
 
     for (size_t i = 0; i < det_leader.NumOrbitals; i++)
       det.TpsiM(i, WorkingIndex) = det.psiM(WorkingIndex, i);
   }
+
+  if (use_offload)
+    mw_BuildDotProductsAndCalculateRatios(det_list, iat - det_leader.FirstIndex);
   det_leader.RatioTimer.stop();
 }
 
+bool MultiDiracDeterminant::prepareMWTables()
+{
+  const size_t ndets = getNumDets();
+  if (mw_det_offsets_.size() != ndets)
+  {
+    const auto& data  = *detData;
+    const auto& pairs = *uniquePairs;
+    mw_det_offsets_.resize(ndets);
+    max_excitation_level_ = 0;
+    size_t offset         = 0;
+    for (size_t i = 0; i < ndets; ++i)
+    {
+      mw_det_offsets_[i]    = offset;
+      max_excitation_level_ = std::max(max_excitation_level_, data[offset]);
+      offset += 3 * data[offset] + 1;
+    }
+    mw_det_data_.resize(data.size());
+    std::copy(data.begin(), data.end(), mw_det_data_.begin());
+    mw_pairs_.resize(2 * pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+      mw_pairs_[2 * i]     = pairs[i].first;
+      mw_pairs_[2 * i + 1] = pairs[i].second;
+    }
+    mw_det_signs_.resize(ndets);
+    std::copy(DetSigns->begin(), DetSigns->end(), mw_det_signs_.begin());
+
+    if (active_dets_)
+    {
+      mw_active_dets_.resize(ndets);
+      std::copy(active_dets_->begin(), active_dets_->end(), mw_active_dets_.begin());
+      mw_active_dets_.updateTo();
+    }
+
+    mw_det_offsets_.updateTo();
+    mw_det_data_.updateTo();
+    mw_pairs_.updateTo();
+    mw_det_signs_.updateTo();
+  }
+  return max_excitation_level_ <= MaxOffloadExcitationLevel;
+}
+
+void MultiDiracDeterminant::mw_BuildDotProductsAndCalculateRatios(
+    const RefVectorWithLeader<MultiDiracDeterminant>& det_list,
+    int WorkingIndex)
+{
+  auto& det_leader = det_list.getLeader();
+  const int nw     = det_list.size();
+  const int nel    = det_leader.NumPtcls;
+  const int norb   = det_leader.NumOrbitals;
+  const int ndets  = det_leader.getNumDets();
+  const int npairs = det_leader.mw_pairs_.size() / 2;
+  const int ref    = det_leader.ReferenceDeterminant;
+  auto& mw_psiMinv = det_leader.mw_psiMinv_;
+  auto& mw_TpsiM   = det_leader.mw_TpsiM_;
+  auto& mw_dots    = det_leader.mw_dotProducts_;
+  auto& mw_ratios  = det_leader.mw_ratios_;
+  mw_psiMinv.resize(nw * nel * nel);
+  mw_TpsiM.resize(nw * norb * nel);
+  mw_dots.resize(nw * nel * norb);
+  mw_ratios.resize(nw * ndets);
+
+  det_leader.buildTableTimer.start();
+  // pack the updated inverses and the orbital matrices with the moved electron column replaced
+  for (int iw = 0; iw < nw; iw++)
+  {
+    MultiDiracDeterminant& det = det_list[iw];
+    std::copy_n(det.psiMinv_temp.data(), nel * nel, mw_psiMinv.data() + iw * nel * nel);
+    ValueType* restrict TpsiM = mw_TpsiM.data() + iw * norb * nel;
+    std::copy_n(det.TpsiM.data(), norb * nel, TpsiM);
+    for (int i = 0; i < norb; i++)
+      TpsiM[i * nel + WorkingIndex] = det.psiV[i];
+  }
+  mw_psiMinv.updateTo();
+  mw_TpsiM.updateTo();
+
+  auto* psiMinv_ptr = mw_psiMinv.device_data();
+  auto* TpsiM_ptr   = mw_TpsiM.device_data();
+  auto* dots_ptr    = mw_dots.device_data();
+  auto* pairs_ptr   = det_leader.mw_pairs_.device_data();
+  PRAGMA_OFFLOAD("omp target teams distribute parallel for collapse(2) \
+                  is_device_ptr(psiMinv_ptr, TpsiM_ptr, dots_ptr, pairs_ptr)")
+  for (int iw = 0; iw < nw; iw++)
+    for (int ip = 0; ip < npairs; ip++)
+    {
+      const int I                   = pairs_ptr[2 * ip];
+      const int J                   = pairs_ptr[2 * ip + 1];
+      const ValueType* restrict inv = psiMinv_ptr + (iw * nel + I) * nel;
+      const ValueType* restrict psi = TpsiM_ptr + (iw * norb + J) * nel;
+      ValueType dot(0);
+      for (int k = 0; k < nel; k++)
+        dot += inv[k] * psi[k];
+      dots_ptr[(iw * nel + I) * norb + J] = dot;
+    }
+  det_leader.buildTableTimer.stop();
+
+  det_leader.readMatTimer.start();
+  auto* ratios_ptr  = mw_ratios.device_data();
+  auto* data_ptr    = det_leader.mw_det_data_.device_data();
+  auto* offsets_ptr = det_leader.mw_det_offsets_.device_data();
+  auto* signs_ptr   = det_leader.mw_det_signs_.device_data();
+  // determinants screened out of the expansion are skipped
+  const bool use_active = det_leader.active_dets_ && det_leader.screening_enabled_;
+  auto* active_ptr      = use_active ? det_leader.mw_active_dets_.device_data() : nullptr;
+  PRAGMA_OFFLOAD("omp target teams distribute parallel for collapse(2) \
+                  is_device_ptr(dots_ptr, ratios_ptr, data_ptr, offsets_ptr, signs_ptr, active_ptr)")
+  for (int iw = 0; iw < nw; iw++)
+    for (int count = 0; count < ndets; count++)
+    {
+      const int* restrict it = data_ptr + offsets_ptr[count];
+      if (count == ref)
+        ratios_ptr[iw * ndets + count] = ValueType(1);
+      else if (use_active && !active_ptr[count])
+        ratios_ptr[iw * ndets + count] = ValueType(0);
+      else
+        ratios_ptr[iw * ndets + count] =
+            signs_ptr[count] * calcExcitedDeterminant(*it, dots_ptr + iw * nel * norb, norb, it + 1);
+    }
+  mw_ratios.updateFrom();
+  for (int iw = 0; iw < nw; iw++)
+    std::copy_n(mw_ratios.data() + iw * ndets, ndets, det_list[iw].new_ratios_to_ref_.data());
+  det_leader.mw_ratios_on_device_ = true;
+  det_leader.readMatTimer.stop();
+}
+
 void MultiDiracDeterminant::evaluateDetsForPtclMove(const ParticleSet& P, int iat, int refPtcl)
 {
   UpdateMode = ORB_PBYP_RATIO;
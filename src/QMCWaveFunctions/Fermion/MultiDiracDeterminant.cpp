@@ -20,7 +20,11 @@
 #include "Numerics/DeterminantOperators.h"
 #include "CPU/BLAS.hpp"
 #include "Numerics/MatrixOperators.h"
+#include "Concurrency/OpenMP.h"
+#include "Utilities/FairDivide.h"
 #include <algorithm>
+#include <limits>
+#include <numeric>
 #include <vector>
 
 // mmorales:
@@ -39,6 +43,7 @@ void MultiDiracDeterminant::set(int first, int nel, int ref_det_id)
   ReferenceDeterminant = ref_det_id;
   resize(nel);
   createDetData((*ciConfigList)[ReferenceDeterminant], *detData, *uniquePairs, *DetSigns);
+  buildExcitationGroups();
 }
 
 void MultiDiracDeterminant::createDetData(const ci_configuration2& ref,
@@ -48,35 +53,53 @@ void MultiDiracDeterminant::createDetData(const ci_configuration2& ref,
 {
   const auto& confgList = *ciConfigList;
 
-  size_t nci = confgList.size(), nex;
-  std::vector<size_t> pos(NumPtcls);
-  std::vector<size_t> ocp(NumPtcls);
-  std::vector<size_t> uno(NumPtcls);
-  data.clear();
+  const size_t nci = confgList.size();
   sign.resize(nci);
+  // each thread analyzes a contiguous range of determinants, the ranges are joined in order
+  const int num_threads = omp_get_max_threads();
+  std::vector<size_t> ranges;
+  FairDivideLow(nci, num_threads, ranges);
+  std::vector<std::vector<int>> thread_data(num_threads);
+  std::vector<std::vector<std::pair<int, int>>> thread_pairs(num_threads);
+#pragma omp parallel for
+  for (int ip = 0; ip < num_threads; ip++)
+  {
+    size_t nex;
+    std::vector<size_t> pos(NumPtcls);
+    std::vector<size_t> ocp(NumPtcls);
+    std::vector<size_t> uno(NumPtcls);
+    auto& my_data  = thread_data[ip];
+    auto& my_pairs = thread_pairs[ip];
+    for (size_t i = ranges[ip]; i < ranges[ip + 1]; i++)
+    {
+      sign[i] = ref.calculateExcitations(confgList[i], nex, pos, ocp, uno);
+      my_data.push_back(nex);
+      for (int k = 0; k < nex; k++)
+        my_data.push_back(pos[k]);
+      for (int k = 0; k < nex; k++)
+        my_data.push_back(uno[k]);
+      for (int k = 0; k < nex; k++)
+        my_data.push_back(ocp[k]);
+      // collect the pairs needed by the matrix elements, duplicates are removed below
+      for (int k1 = 0; k1 < nex; k1++)
+        for (int k2 = 0; k2 < nex; k2++)
+          my_pairs.emplace_back(pos[k1], uno[k2]);
+    }
+    std::sort(my_pairs.begin(), my_pairs.end());
+    my_pairs.erase(std::unique(my_pairs.begin(), my_pairs.end()), my_pairs.end());
+  }
+
+  data.clear();
   pairs.clear();
-  for (size_t i = 0; i < nci; i++)
+  for (int ip = 0; ip < num_threads; ip++)
   {
-    sign[i] = ref.calculateExcitations(confgList[i], nex, pos, ocp, uno);
-    data.push_back(nex);
-    for (int k = 0; k < nex; k++)
-      data.push_back(pos[k]);
-    for (int k = 0; k < nex; k++)
-      data.push_back(uno[k]);
-    for (int k = 0; k < nex; k++)
-      data.push_back(ocp[k]);
-    // determine unique pairs, to avoid redundant calculation of matrix elements
-    // if storing the entire MOxMO matrix is too much, then make an array and a mapping to it.
-    // is there an easier way??
-    for (int k1 = 0; k1 < nex; k1++)
-      for (int k2 = 0; k2 < nex; k2++)
-      {
-        //           std::pair<int,int> temp(ocp[k1],uno[k2]);
-        std::pair<int, int> temp(pos[k1], uno[k2]);
-        if (find(pairs.begin(), pairs.end(), temp) == pairs.end()) //pair is new
-          pairs.push_back(temp);
-      }
+    data.insert(data.end(), thread_data[ip].begin(), thread_data[ip].end());
+    pairs.insert(pairs.end(), thread_pairs[ip].begin(), thread_pairs[ip].end());
   }
+  // determine unique pairs, to avoid redundant calculation of matrix elements.
+  // sorting also groups the pairs sharing a row of the inverse.
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
   app_log() << "Number of terms in pairs array: " << pairs.size() << std::endl;
   /*
        std::cout <<"ref: " <<ref << std::endl;
@@ -90,6 +113,66 @@ void MultiDiracDeterminant::createDetData(const ci_configuration2& ref,
   */
 }
 
+void MultiDiracDeterminant::buildExcitationGroups()
+{
+  using IndexType = ExcitationGroups::IndexType;
+  auto& groups    = *excitation_groups_;
+  groups.offsets.clear();
+  groups.det_ids.clear();
+  groups.indices.clear();
+  groups.signs.clear();
+  if (std::max(NumPtcls, NumOrbitals) > std::numeric_limits<IndexType>::max())
+  {
+    app_log() << "  MultiDiracDeterminant: too many orbitals for the compact excitation table, using detData"
+              << std::endl;
+    return;
+  }
+
+  const auto& data              = *detData;
+  const std::vector<int> levels = getExcitationLevels();
+  const size_t ndets            = levels.size();
+  std::vector<size_t> start(ndets);
+  int max_level = 0;
+  for (size_t i = 0, pos = 0; i < ndets; ++i)
+  {
+    start[i] = pos;
+    pos += 3 * levels[i] + 1;
+    max_level = std::max(max_level, levels[i]);
+  }
+
+  // order by excitation level. Within a level the determinants keep their order so that
+  // the ratios are written at increasing addresses.
+  std::vector<int> order(ndets);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return levels[a] < levels[b]; });
+
+  groups.offsets.assign(max_level + 2, 0);
+  for (const int level : levels)
+    groups.offsets[level + 1]++;
+  std::partial_sum(groups.offsets.begin(), groups.offsets.end(), groups.offsets.begin());
+  groups.det_ids.reserve(ndets);
+  groups.signs.reserve(ndets);
+  for (const int i : order)
+  {
+    groups.det_ids.push_back(i);
+    groups.signs.push_back((*DetSigns)[i]);
+    for (int k = 0; k < 2 * levels[i]; k++)
+      groups.indices.push_back(static_cast<IndexType>(data[start[i] + 1 + k]));
+  }
+}
+
+std::vector<int> MultiDiracDeterminant::getExcitationLevels() const
+{
+  std::vector<int> levels(getNumDets());
+  auto it = detData->begin();
+  for (size_t i = 0; i < levels.size(); ++i)
+  {
+    levels[i] = *it;
+    it += 3 * levels[i] + 1;
+  }
+  return levels;
+}
+
 //erase
 void out1(int n, std::string str = "NULL") {}
 //{ std::cout <<"MDD: " <<str <<"  " <<n << std::endl; std::cout.flush(); }
@@ -413,7 +496,9 @@ MultiDiracDeterminant::MultiDiracDeterminant(const MultiDiracDeterminant& s)
       is_spinor_(s.is_spinor_),
       detData(s.detData),
       uniquePairs(s.uniquePairs),
-      DetSigns(s.DetSigns)
+      DetSigns(s.DetSigns),
+      excitation_groups_(s.excitation_groups_),
+      active_dets_(s.active_dets_)
 {
   Optimizable = s.Optimizable;
 
@@ -456,10 +541,11 @@ MultiDiracDeterminant::MultiDiracDeterminant(std::unique_ptr<SPOSet>&& spos, boo
 {
   (Phi->isOptimizable() == true) ? Optimizable = true : Optimizable = false;
 
-  ciConfigList = std::make_shared<std::vector<ci_configuration2>>();
-  detData      = std::make_shared<std::vector<int>>();
-  uniquePairs  = std::make_shared<std::vector<std::pair<int, int>>>();
-  DetSigns     = std::make_shared<std::vector<RealType>>();
+  ciConfigList       = std::make_shared<std::vector<ci_configuration2>>();
+  detData            = std::make_shared<std::vector<int>>();
+  uniquePairs        = std::make_shared<std::vector<std::pair<int, int>>>();
+  DetSigns           = std::make_shared<std::vector<RealType>>();
+  excitation_groups_ = std::make_shared<ExcitationGroups>();
 
   registerTimers();
 }
@@ -19,12 +19,14 @@
  */
 #ifndef QMCPLUSPLUS_MULTIDIRACDETERMINANT_H
 #define QMCPLUSPLUS_MULTIDIRACDETERMINANT_H
+#include <cstdint>
 #include "QMCWaveFunctions/WaveFunctionComponent.h"
 #include "QMCWaveFunctions/SPOSet.h"
 #include "QMCWaveFunctions/Fermion/ci_configuration2.h"
 #include "QMCWaveFunctions/Fermion/MultiDiracDeterminantCalculator.h"
 #include "Message/Communicate.h"
 #include "Numerics/DeterminantOperators.h"
+#include "OMPTarget/OffloadAlignedAllocators.hpp"
 //#include "CPU/BLAS.hpp"
 
 namespace qmcplusplus
@@ -406,6 +408,21 @@ public:
   inline int getFirstIndex() const { return FirstIndex; }
   inline std::vector<ci_configuration2>& getCIConfigList() { return *ciConfigList; }
 
+  /// excitation level of each unique determinant with respect to the reference determinant
+  std::vector<int> getExcitationLevels() const;
+  /// excitation tables built by createDetData, shared by the copies of this determinant
+  const std::vector<int>& getDetData() const { return *detData; }
+  const std::vector<std::pair<int, int>>& getUniquePairs() const { return *uniquePairs; }
+  const std::vector<RealType>& getDetSigns() const { return *DetSigns; }
+
+  /** restrict the evaluation of the ratios to a subset of the unique determinants.
+   * The ratios of the other determinants are set to zero.
+   * @param active_dets one flag per unique determinant, shared by the copies of this determinant
+   */
+  void setActiveDets(const std::shared_ptr<std::vector<char>>& active_dets) { active_dets_ = active_dets; }
+  /// turn on and off the restriction set by setActiveDets
+  void enableScreening(bool on) { screening_enabled_ = on; }
+
   const ValueVector& getRatiosToRefDet() const { return ratios_to_ref_; }
   const ValueVector& getNewRatiosToRefDet() const { return new_ratios_to_ref_; }
   const GradMatrix& getGrads() const { return grads; }
@@ -415,6 +432,14 @@ public:
   const ValueMatrix& getSpinGrads() const { return spingrads; }
   const ValueMatrix& getNewSpinGrads() const { return new_spingrads; }
 
+  /** device pointer to the new ratios of walker iw computed by the last mw_evaluateDetsForPtclMove.
+   * Only valid on the crowd leader. nullptr if the last call computed the ratios on the host.
+   */
+  const ValueType* getMWNewRatiosToRefDetDevicePtr(int iw) const
+  {
+    return mw_ratios_on_device_ ? mw_ratios_.device_data() + iw * getNumDets() : nullptr;
+  }
+
   PsiValueType getRefDetRatio() const { return static_cast<PsiValueType>(curRatio); }
   LogValueType getLogValueRefDet() const { return log_value_ref_det_; }
 
@@ -422,6 +447,41 @@ private:
   ///reset the size: with the number of particles
   void resize(int nel);
 
+  template<typename DT>
+  using OffloadVector = Vector<DT, OffloadPinnedAllocator<DT>>;
+
+  /** excitation table of the unique determinants ordered for the ratio evaluation.
+   * The determinants are grouped by excitation level so that the evaluation of a group
+   * does not branch on the level. Within a group they keep their order in the expansion.
+   * The indices i1..in, a1..an of each determinant are stored as 16 bit integers.
+   */
+  struct ExcitationGroups
+  {
+    using IndexType = uint16_t;
+    /// the determinants of level n are the entries [offsets[n], offsets[n+1])
+    std::vector<size_t> offsets;
+    /// unique determinant id of each entry
+    std::vector<int> det_ids;
+    /// 2n indices per entry of level n, stored consecutively in the entry order
+    std::vector<IndexType> indices;
+    /// sign of each entry
+    std::vector<RealType> signs;
+  };
+
+  /** build excitation_groups_ from detData and DetSigns.
+   * excitation_groups_ is left empty if the indices do not fit in ExcitationGroups::IndexType.
+   */
+  void buildExcitationGroups();
+
+  /** copy the excitation tables to the device, done once by the crowd leader
+   * @return true if all the excitation levels can be handled by the device kernels
+   */
+  bool prepareMWTables();
+
+  /// multi walker BuildDotProductsAndCalculateRatios of the new ratios, run as offload kernels over the crowd
+  static void mw_BuildDotProductsAndCalculateRatios(const RefVectorWithLeader<MultiDiracDeterminant>& det_list,
+                                                    int WorkingIndex);
+
   ///a set of single-particle orbitals used to fill in the  values of the matrix
   const std::unique_ptr<SPOSet> Phi;
   ///number of single-particle orbitals which belong to this Dirac determinant
@@ -502,7 +562,25 @@ private:
   std::shared_ptr<std::vector<int>> detData;
   std::shared_ptr<std::vector<std::pair<int, int>>> uniquePairs;
   std::shared_ptr<std::vector<RealType>> DetSigns;
+  /// detData reordered by buildExcitationGroups, used by BuildDotProductsAndCalculateRatios_impl
+  std::shared_ptr<ExcitationGroups> excitation_groups_;
   MultiDiracDeterminantCalculator<ValueType> DetCalculator;
+  /// flags of the unique determinants evaluated when the expansion is screened, nullptr if not screened
+  std::shared_ptr<std::vector<char>> active_dets_;
+  /// if false, evaluate all the unique determinants even if active_dets_ is set
+  bool screening_enabled_ = true;
+
+  /// crowd leader only. device copies of detData, of the offset of each det in detData, uniquePairs and DetSigns
+  OffloadVector<int> mw_det_data_, mw_det_offsets_, mw_pairs_;
+  /// crowd leader only. device copy of active_dets_
+  OffloadVector<char> mw_active_dets_;
+  OffloadVector<RealType> mw_det_signs_;
+  /// crowd leader only. highest excitation level in detData
+  int max_excitation_level_ = 0;
+  /// crowd leader only. psiMinv_temp, TpsiM, dotProducts and new ratios of all the walkers packed for the device
+  OffloadVector<ValueType> mw_psiMinv_, mw_TpsiM_, mw_dotProducts_, mw_ratios_;
+  /// crowd leader only. true if mw_ratios_ holds the result of the last mw_evaluateDetsForPtclMove
+  bool mw_ratios_on_device_ = false;
 };
 
 
@@ -20,6 +20,7 @@
 #ifndef QMCPLUSPLUS_MULTIDIRACDETERMINANTCALCULATOR_H
 #define QMCPLUSPLUS_MULTIDIRACDETERMINANTCALCULATOR_H
 
+#include <complex>
 #include "OhmmsPETE/OhmmsMatrix.h"
 #include "Numerics/DeterminantOperators.h"
 
@@ -145,5 +146,92 @@ struct MultiDiracDeterminantCalculator
   }
 };
 
+/// highest excitation level handled by calcExcitedDeterminant
+constexpr int MaxOffloadExcitationLevel = 8;
+
+/// magnitude used to select the pivot in calcExcitedDeterminant
+template<typename T>
+inline T pivotWeight(T x)
+{
+  return x < T(0) ? -x : x;
+}
+
+template<typename T>
+inline T pivotWeight(const std::complex<T>& x)
+{
+  return x.real() * x.real() + x.imag() * x.imag();
+}
+
+/** determinant of the n x n matrix of dot products selected by an excitation.
+ *  Free of allocations and library calls such that it can be called inside offload regions.
+ *  @param n excitation level, no larger than MaxOffloadExcitationLevel
+ *  @param dots row major matrix of dot products with leading dimension ld
+ *  @param it the excitation encoded as i1,...,in,a1,...,an
+ */
+template<typename T>
+inline T calcExcitedDeterminant(int n, const T* dots, int ld, const int* it)
+{
+  switch (n)
+  {
+  case 0:
+    return T(1);
+  case 1:
+    return dots[it[0] * ld + it[1]];
+  case 2: {
+    const T* restrict r1 = dots + it[0] * ld;
+    const T* restrict r2 = dots + it[1] * ld;
+    return r1[it[2]] * r2[it[3]] - r1[it[3]] * r2[it[2]];
+  }
+  case 3: {
+    const T* restrict r1 = dots + it[0] * ld;
+    const T* restrict r2 = dots + it[1] * ld;
+    const T* restrict r3 = dots + it[2] * ld;
+    const int a1 = it[3], a2 = it[4], a3 = it[5];
+    return r1[a1] * (r2[a2] * r3[a3] - r3[a2] * r2[a3]) - r2[a1] * (r1[a2] * r3[a3] - r3[a2] * r1[a3]) +
+        r3[a1] * (r1[a2] * r2[a3] - r2[a2] * r1[a3]);
+  }
+  default: {
+    // Gaussian elimination with partial pivoting
+    T M[MaxOffloadExcitationLevel * MaxOffloadExcitationLevel];
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++)
+        M[i * n + j] = dots[it[i] * ld + it[n + j]];
+    T det(1);
+    for (int k = 0; k < n; k++)
+    {
+      int piv    = k;
+      auto w_max = pivotWeight(M[k * n + k]);
+      for (int i = k + 1; i < n; i++)
+        if (pivotWeight(M[i * n + k]) > w_max)
+        {
+          w_max = pivotWeight(M[i * n + k]);
+          piv   = i;
+        }
+      if (piv != k)
+      {
+        for (int j = k; j < n; j++)
+        {
+          const T tmp    = M[k * n + j];
+          M[k * n + j]   = M[piv * n + j];
+          M[piv * n + j] = tmp;
+        }
+        det = -det;
+      }
+      const T pivot = M[k * n + k];
+      if (pivot == T(0))
+        return T(0);
+      det *= pivot;
+      for (int i = k + 1; i < n; i++)
+      {
+        const T factor = M[i * n + k] / pivot;
+        for (int j = k + 1; j < n; j++)
+          M[i * n + j] -= factor * M[k * n + j];
+      }
+    }
+    return det;
+  }
+  }
+}
+
 } // namespace qmcplusplus
 #endif
@@ -16,6 +16,7 @@
 #include "MultiSlaterDetTableMethod.h"
 #include "QMCWaveFunctions/Fermion/MultiDiracDeterminant.h"
 #include "ParticleBase/ParticleAttribOps.h"
+#include <algorithm>
 
 namespace qmcplusplus
 {
@@ -85,6 +86,10 @@ std::unique_ptr<WaveFunctionComponent> MultiSlaterDetTableMethod::makeClone(Part
 
   clone->CI_Optimizable = CI_Optimizable;
 
+  clone->active_terms_           = active_terms_;
+  clone->screening_check_        = screening_check_;
+  clone->screening_check_period_ = screening_check_period_;
+
   if (usingCSF)
   {
     clone->CSFcoeff     = CSFcoeff;
@@ -138,8 +143,11 @@ WaveFunctionComponent::LogValueType MultiSlaterDetTableMethod::evaluateLog(const
                                                                             ParticleSet::ParticleLaplacian& L)
 {
   ScopedTimer local_timer(EvaluateTimer);
+  // the full expansion check needs all the unique determinants
+  const bool check_screening = screening_check_ && ++screening_check_counter_ >= screening_check_period_;
   for (size_t id = 0; id < Dets.size(); id++)
   {
+    Dets[id]->enableScreening(!check_screening);
     if (P.isSpinor())
       Dets[id]->evaluateForWalkerMoveWithSpin(P);
     else
@@ -148,6 +156,14 @@ WaveFunctionComponent::LogValueType MultiSlaterDetTableMethod::evaluateLog(const
 
   log_value_ = evaluate_vgl_impl(P, myG, myL);
 
+  if (check_screening)
+  {
+    recordScreeningCheck();
+    screening_check_counter_ = 0;
+    for (size_t id = 0; id < Dets.size(); id++)
+      Dets[id]->enableScreening(true);
+  }
+
   G += myG;
   for (size_t i = 0; i < L.size(); i++)
     L[i] += myL[i] - dot(myG[i], myG[i]);
@@ -336,11 +352,12 @@ WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::evalGrad_impl_no_
   const auto& detValues0         = (newpos) ? Dets[det_id]->getNewRatiosToRefDet() : Dets[det_id]->getRatiosToRefDet();
   const size_t* restrict det0    = (*C2node)[det_id].data();
   const ValueType* restrict cptr = C->data();
-  const size_t nc                = C->size();
+  const size_t nc                = getNumActiveTerms();
   const size_t noffset           = Dets[det_id]->getFirstIndex();
   PsiValueType psi(0);
-  for (size_t i = 0; i < nc; ++i)
+  for (size_t k = 0; k < nc; ++k)
   {
+    const size_t i  = getActiveTerm(k);
     const size_t d0 = det0[i];
     ValueType t     = cptr[i];
     for (size_t id = 0; id < Dets.size(); id++)
@@ -371,11 +388,12 @@ WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::evalGradWithSpin_
   const auto& spingrads          = (newpos) ? Dets[det_id]->getNewSpinGrads() : Dets[det_id]->getSpinGrads();
   const size_t* restrict det0    = (*C2node)[det_id].data();
   const ValueType* restrict cptr = C->data();
-  const size_t nc                = C->size();
+  const size_t nc                = getNumActiveTerms();
   const size_t noffset           = Dets[det_id]->getFirstIndex();
   PsiValueType psi(0);
-  for (size_t i = 0; i < nc; ++i)
+  for (size_t k = 0; k < nc; ++k)
   {
+    const size_t i  = getActiveTerm(k);
     const size_t d0 = det0[i];
     ValueType t     = cptr[i];
     for (size_t id = 0; id < Dets.size(); id++)
@@ -539,12 +557,13 @@ WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::ratio_impl_no_pre
   const ValueVector& detValues0  = Dets[det_id]->getNewRatiosToRefDet(); //always new
   const size_t* restrict det0    = (*C2node)[det_id].data();
   const ValueType* restrict cptr = C->data();
-  const size_t nc                = C->size();
+  const size_t nc                = getNumActiveTerms();
 
   PsiValueType psi = 0;
-  for (size_t i = 0; i < nc; ++i)
+  for (size_t k = 0; k < nc; ++k)
   {
-    ValueType t = cptr[i];
+    const size_t i = getActiveTerm(k);
+    ValueType t    = cptr[i];
     for (size_t id = 0; id < Dets.size(); id++)
       if (id != det_id)
         t *= Dets[id]->getRatiosToRefDet()[(*C2node)[id][i]];
@@ -600,6 +619,8 @@ void MultiSlaterDetTableMethod::mw_calcRatio(const RefVectorWithLeader<WaveFunct
   }
 
   det_leader.Dets[det_id]->mw_evaluateDetsForPtclMove(det_list, P_list, iat);
+  // the new ratios are already on the device if they were computed by the offload kernels
+  const bool ratios_on_device = det_list.getLeader().getMWNewRatiosToRefDetDevicePtr(0) != nullptr;
 
   det_value_ptr_list.resize(nw);
   C_otherDs_ptr_list.resize(nw);
@@ -609,10 +630,15 @@ void MultiSlaterDetTableMethod::mw_calcRatio(const RefVectorWithLeader<WaveFunct
     auto& det      = WFC_list.getCastedElement<MultiSlaterDetTableMethod>(iw);
     det.UpdateMode = ORB_PBYP_RATIO;
 
-    const ValueType* restrict detValues0 = det.Dets[det_id]->getNewRatiosToRefDet().data(); //always new
-    // allocate device memory and transfer content to device
-    PRAGMA_OFFLOAD("omp target enter data map(to : detValues0[:ndets])")
-    det_value_ptr_list[iw] = getOffloadDevicePtr(detValues0);
+    if (ratios_on_device)
+      det_value_ptr_list[iw] = det_list.getLeader().getMWNewRatiosToRefDetDevicePtr(iw);
+    else
+    {
+      const ValueType* restrict detValues0 = det.Dets[det_id]->getNewRatiosToRefDet().data(); //always new
+      // allocate device memory and transfer content to device
+      PRAGMA_OFFLOAD("omp target enter data map(to : detValues0[:ndets])")
+      det_value_ptr_list[iw] = getOffloadDevicePtr(detValues0);
+    }
     C_otherDs_ptr_list[iw] = det.C_otherDs[det_id].device_data();
   }
 
@@ -638,8 +664,11 @@ void MultiSlaterDetTableMethod::mw_calcRatio(const RefVectorWithLeader<WaveFunct
     det.new_psi_ratio_to_new_ref_det_ = psi_list[iw];
     ratios[iw] = det.curRatio = det.Dets[det_id]->getRefDetRatio() * psi_list[iw] / det.psi_ratio_to_ref_det_;
 
-    const ValueType* restrict detValues0 = det.Dets[det_id]->getNewRatiosToRefDet().data(); //always new
-    PRAGMA_OFFLOAD("omp target exit data map(delete : detValues0[:ndets])")                 //free memory on device.
+    if (!ratios_on_device)
+    {
+      const ValueType* restrict detValues0 = det.Dets[det_id]->getNewRatiosToRefDet().data(); //always new
+      PRAGMA_OFFLOAD("omp target exit data map(delete : detValues0[:ndets])") //free memory on device.
+    }
   }
 }
 
@@ -662,11 +691,12 @@ void MultiSlaterDetTableMethod::evaluateRatios(const VirtualParticleSet& VP, std
     {
       const size_t* restrict det0    = (*C2node)[det_id].data();
       const ValueType* restrict cptr = C->data();
-      const size_t nc                = C->size();
+      const size_t nc                = getNumActiveTerms();
 
-      for (size_t i = 0; i < nc; ++i)
+      for (size_t k = 0; k < nc; ++k)
       {
-        ValueType t = cptr[i];
+        const size_t i = getActiveTerm(k);
+        ValueType t    = cptr[i];
         for (size_t id = 0; id < Dets.size(); id++)
           if (id != det_id)
             t *= Dets[id]->getRatiosToRefDet()[(*C2node)[id][i]];
@@ -827,6 +857,89 @@ void MultiSlaterDetTableMethod::resetParameters(const opt_variables_type& active
 void MultiSlaterDetTableMethod::reportStatus(std::ostream& os) {}
 
 
+void MultiSlaterDetTableMethod::setScreening(RealType coeff_cutoff, RealType order_weight_cutoff, int check_period)
+{
+  const size_t nc = C->size();
+  // the excitation order of a term is the sum of the excitation levels of its unique determinants
+  std::vector<int> order(nc, 0);
+  for (size_t id = 0; id < Dets.size(); id++)
+  {
+    const std::vector<int> levels = Dets[id]->getExcitationLevels();
+    for (size_t i = 0; i < nc; i++)
+      order[i] += levels[(*C2node)[id][i]];
+  }
+  const int max_order = *std::max_element(order.begin(), order.end());
+
+  RealType total_weight = 0;
+  std::vector<RealType> order_weight(max_order + 1, 0);
+  for (size_t i = 0; i < nc; i++)
+  {
+    order_weight[order[i]] += std::norm((*C)[i]);
+    total_weight += std::norm((*C)[i]);
+  }
+
+  // the reference determinant is always kept
+  active_terms_ = std::make_shared<std::vector<size_t>>();
+  std::vector<size_t> num_terms(max_order + 1, 0), num_kept(max_order + 1, 0);
+  for (size_t i = 0; i < nc; i++)
+  {
+    num_terms[order[i]]++;
+    if (order[i] == 0 ||
+        (std::abs((*C)[i]) >= coeff_cutoff && order_weight[order[i]] >= order_weight_cutoff * total_weight))
+    {
+      active_terms_->push_back(i);
+      num_kept[order[i]]++;
+    }
+  }
+
+  for (size_t id = 0; id < Dets.size(); id++)
+  {
+    auto active_dets = std::make_shared<std::vector<char>>(Dets[id]->getNumDets(), 0);
+    for (size_t i : *active_terms_)
+      (*active_dets)[(*C2node)[id][i]] = 1;
+    Dets[id]->setActiveDets(active_dets);
+  }
+
+  screening_check_period_ = check_period;
+  if (check_period > 0)
+    screening_check_ = std::make_shared<ScreeningCheck>();
+
+  app_log() << "  Screened CI expansion, |c| cutoff " << coeff_cutoff << ", excitation order weight cutoff "
+            << order_weight_cutoff << ". Kept " << active_terms_->size() << " of " << nc << " terms." << std::endl;
+  for (int k = 0; k <= max_order; k++)
+    if (num_terms[k] > 0)
+      app_log() << "    excitation order " << k << " : kept " << num_kept[k] << " of " << num_terms[k]
+                << " terms, weight " << order_weight[k] / total_weight << std::endl;
+}
+
+void MultiSlaterDetTableMethod::recordScreeningCheck()
+{
+  PsiValueType psi_full(0);
+  for (size_t i = 0; i < C->size(); i++)
+  {
+    PsiValueType product = (*C)[i];
+    for (size_t id = 0; id < Dets.size(); id++)
+      product *= Dets[id]->getRatiosToRefDet()[(*C2node)[id][i]];
+    psi_full += product;
+  }
+  const double w = std::norm(psi_full / psi_ratio_to_ref_det_);
+
+  std::lock_guard<std::mutex> lock(screening_check_->mutex);
+  screening_check_->count++;
+  screening_check_->sum_w += w;
+  screening_check_->sum_w2 += w * w;
+}
+
+MultiSlaterDetTableMethod::ScreeningCheck::~ScreeningCheck()
+{
+  if (count == 0)
+    return;
+  const double mean  = sum_w / count;
+  const double error = std::sqrt(std::max(sum_w2 / count - mean * mean, 0.0) / count);
+  app_log() << "  Screened CI expansion, " << count << " full expansion checks: <|Psi_full/Psi_screened|^2> = " << mean
+            << " +/- " << error << std::endl;
+}
+
 void MultiSlaterDetTableMethod::evaluateDerivatives(ParticleSet& P,
                                                      const opt_variables_type& optvars,
                                                      std::vector<ValueType>& dlogpsi,
@@ -1137,8 +1250,9 @@ void MultiSlaterDetTableMethod::precomputeC_otherDs(const ParticleSet& P, int ig
   ScopedTimer local_timer(PrepareGroupTimer);
   C_otherDs[ig].resize(Dets[ig]->getNumDets());
   std::fill(C_otherDs[ig].begin(), C_otherDs[ig].end(), ValueType(0));
-  for (size_t i = 0; i < C->size(); i++)
+  for (size_t k = 0; k < getNumActiveTerms(); k++)
   {
+    const size_t i = getActiveTerm(k);
     // enforce full precision reduction on C_otherDs due to numerical sensitivity
     PsiValueType product = (*C)[i];
     for (size_t id = 0; id < Dets.size(); id++)
@@ -15,6 +15,7 @@
 
 #ifndef QMCPLUSPLUS_MULTISLATERDETERMINANTFAST_ORBITAL_H
 #define QMCPLUSPLUS_MULTISLATERDETERMINANTFAST_ORBITAL_H
+#include <mutex>
 #include <Configuration.h>
 #include "QMCWaveFunctions/WaveFunctionComponent.h"
 #include "QMCWaveFunctions/Fermion/MultiDiracDeterminant.h"
@@ -153,6 +154,20 @@ public:
   void resize(int, int);
   void initialize();
 
+  /** screen the CI expansion, only the selected terms are evaluated during the propagation
+   * @param coeff_cutoff terms with |c_i| below coeff_cutoff are dropped
+   * @param order_weight_cutoff all the terms of an excitation order are dropped if their aggregated weight
+   *        sum |c_i|^2 over the total weight is below order_weight_cutoff
+   * @param check_period evaluate the full expansion every check_period evaluateLog calls to measure
+   *        the screening bias. 0 disables the checks.
+   */
+  void setScreening(RealType coeff_cutoff, RealType order_weight_cutoff, int check_period);
+
+  /// number of evaluated CI terms, all of them unless the expansion is screened
+  size_t getNumActiveTerms() const { return active_terms_ ? active_terms_->size() : C->size(); }
+  /// index of the k-th evaluated CI term
+  size_t getActiveTerm(size_t k) const { return active_terms_ ? (*active_terms_)[k] : k; }
+
   /// if true, the CI coefficients are optimized
   bool CI_Optimizable;
   size_t ActiveSpin;
@@ -239,6 +254,27 @@ private:
    */
   void precomputeC_otherDs(const ParticleSet& P, int ig);
 
+  /** statistics of the full expansion checks of a screened expansion, shared by the clones.
+   * The average of |Psi_full/Psi_screened|^2 over samples of the screened wavefunction is reported at the end.
+   */
+  struct ScreeningCheck
+  {
+    std::mutex mutex;
+    size_t count = 0;
+    double sum_w = 0, sum_w2 = 0;
+    ~ScreeningCheck();
+  };
+
+  /// evaluate the full expansion with the unique determinants from the last evaluateForWalkerMove and record it
+  void recordScreeningCheck();
+
+  /// CI terms kept by setScreening, nullptr if the expansion is not screened
+  std::shared_ptr<std::vector<size_t>> active_terms_;
+  std::shared_ptr<ScreeningCheck> screening_check_;
+  int screening_check_period_ = 0;
+  /// number of evaluateLog calls since the last full expansion check
+  int screening_check_counter_ = 0;
+
   ///the last particle of each group
   std::vector<int> Last;
   ///use pre-compute (fast) algorithm
@@ -196,6 +196,12 @@ void SlaterDet::evaluateHessian(ParticleSet& P, HessVector& grad_grad_psi)
   }
 }
 
+void SlaterDet::registerSPOEvaluationCache(SPOEvaluationCacheRegistry& registry)
+{
+  for (int i = 0; i < Dets.size(); ++i)
+    Dets[i]->registerSPOEvaluationCache(registry);
+}
+
 void SlaterDet::createResource(ResourceCollection& collection) const
 {
   for (int i = 0; i < Dets.size(); ++i)
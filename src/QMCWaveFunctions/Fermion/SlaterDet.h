@@ -96,6 +96,8 @@ public:
 
   void copyFromBuffer(ParticleSet& P, WFBufferType& buf) override;
 
+  void registerSPOEvaluationCache(SPOEvaluationCacheRegistry& registry) override;
+
   void createResource(ResourceCollection& collection) const override;
 
   void acquireResource(ResourceCollection& collection,
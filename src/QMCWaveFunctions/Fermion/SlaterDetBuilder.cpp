@@ -23,6 +23,7 @@
 #include "QMCWaveFunctions/SPOSetBuilderFactory.h"
 #include "Utilities/ProgressReportEngine.h"
 #include "OhmmsData/AttributeSet.h"
+#include "MemoryAccounting.h"
 
 #include "QMCWaveFunctions/Fermion/SlaterDet.h"
 #include "QMCWaveFunctions/Fermion/MultiSlaterDetTableMethod.h"
@@ -64,6 +65,8 @@ SlaterDetBuilder::SlaterDetBuilder(Communicate* comm,
 std::unique_ptr<WaveFunctionComponent> SlaterDetBuilder::buildComponent(xmlNodePtr cur)
 {
   ReportEngine PRE(ClassName, "put(xmlNodePtr)");
+  // the SPOs built inside are charged to their own tag
+  ScopedMemoryTag memory_tag("determinants");
   ///save the current node
   xmlNodePtr curRoot = cur;
   std::map<std::string, SPOSetPtr> spomap;
@@ -190,6 +193,8 @@ std::unique_ptr<WaveFunctionComponent> SlaterDetBuilder::buildComponent(xmlNodeP
       std::vector<std::string> spoNames(nGroups);
 
       std::string fastAlg;
+      RealType screening_cutoff(0), screening_order_weight(0);
+      int screening_check_period(0);
       OhmmsAttributeSet spoAttrib;
       for (int grp = 0; grp < nGroups; grp++)
         spoAttrib.add(spoNames[grp], "spo_" + std::to_string(grp));
@@ -200,8 +205,15 @@ std::unique_ptr<WaveFunctionComponent> SlaterDetBuilder::buildComponent(xmlNodeP
       }
       spoAttrib.add(fastAlg, "Fast", {"", "yes", "no"}, TagStatus::DELETED);
       spoAttrib.add(msd_algorithm, "algorithm", {"precomputed_table_method", "table_method"});
+      spoAttrib.add(screening_cutoff, "screening_cutoff");
+      spoAttrib.add(screening_order_weight, "screening_order_weight");
+      spoAttrib.add(screening_check_period, "screening_check_period");
       spoAttrib.put(cur);
 
+      if (screening_cutoff < 0 || screening_order_weight < 0 || screening_check_period < 0)
+        myComm->barrier_and_abort("The screening_cutoff, screening_order_weight and screening_check_period attributes of "
+                                  "multideterminant must not be negative!");
+
       //new format
       std::vector<std::unique_ptr<SPOSet>> spo_clones;
 
@@ -251,6 +263,18 @@ std::unique_ptr<WaveFunctionComponent> SlaterDetBuilder::buildComponent(xmlNodeP
         // But if orbital rotation parameters were supplied by the user it will also apply a unitary transformation
         // and then remove the orbital rotation parameters
         msd_fast->buildOptVariables();
+
+        if (screening_cutoff > 0 || screening_order_weight > 0)
+        {
+          if (msd_fast->Optimizable)
+            myComm->barrier_and_abort("Screening the CI expansion is not supported when optimizing the wavefunction!");
+          app_summary() << "    Screening the CI expansion. |c| cutoff " << screening_cutoff
+                        << ", excitation order weight cutoff " << screening_order_weight << std::endl;
+          if (screening_check_period > 0)
+            app_summary() << "    Full expansion check every " << screening_check_period << " evaluations."
+                          << std::endl;
+          msd_fast->setScreening(screening_cutoff, screening_order_weight, screening_check_period);
+        }
         built_singledet_or_multidets = std::move(msd_fast);
     }
     cur = cur->next;
@@ -316,10 +340,12 @@ std::unique_ptr<DiracDeterminantBase> SlaterDetBuilder::putDeterminant(
   std::string matrix_inverter;
   std::string use_batch;
   std::string useGPU;
-  int delay_rank(0);
+  std::string delay_rank_input("0");
+  int inverse_refinement_steps(0);
 
   OhmmsAttributeSet sdAttrib;
-  sdAttrib.add(delay_rank, "delay_rank");
+  sdAttrib.add(delay_rank_input, "delay_rank");
+  sdAttrib.add(inverse_refinement_steps, "inverse_refinement_steps");
   sdAttrib.add(optimize, "optimize", {"no", "yes"});
   sdAttrib.add(matrix_inverter, "matrix_inverter", {"gpu", "host"});
 #if defined(ENABLE_OFFLOAD)
@@ -372,13 +398,27 @@ std::unique_ptr<DiracDeterminantBase> SlaterDetBuilder::putDeterminant(
   int firstIndex = targetPtcl.first(spin_group);
   int lastIndex  = targetPtcl.last(spin_group);
 
+  const bool tune_delay_rank = delay_rank_input == "auto";
+  int delay_rank(1);
+  if (!tune_delay_rank)
+  {
+    try
+    {
+      delay_rank = std::stoi(delay_rank_input);
+    }
+    catch (...)
+    {
+      delay_rank = -1;
+    }
+  }
+
   if (delay_rank < 0 || delay_rank > lastIndex - firstIndex)
   {
     std::ostringstream err_msg;
     err_msg << "SlaterDetBuilder::putDeterminant delay_rank must be positive "
             << "and no larger than the electron count within a determinant!\n"
-            << "Acceptable value [1," << lastIndex - firstIndex << "], "
-            << "user input " + std::to_string(delay_rank);
+            << "Acceptable value [1," << lastIndex - firstIndex << "] or auto, "
+            << "user input " + delay_rank_input;
     APP_ABORT(err_msg.str());
   }
   else if (delay_rank == 0)
@@ -390,7 +430,9 @@ std::unique_ptr<DiracDeterminantBase> SlaterDetBuilder::putDeterminant(
     app_summary() << "      Setting delay_rank to default value " << delay_rank << std::endl;
   }
 
-  if (delay_rank > 1)
+  if (tune_delay_rank)
+    app_summary() << "      Selecting the delayed update rank by timing the update cycles during warmup" << std::endl;
+  else if (delay_rank > 1)
     app_summary() << "      Using rank-" << delay_rank << " delayed update" << std::endl;
   else
     app_summary() << "      Using rank-1 Sherman-Morrison Fahy update (SM1)" << std::endl;
@@ -414,6 +456,14 @@ std::unique_ptr<DiracDeterminantBase> SlaterDetBuilder::putDeterminant(
     if (matrix_inverter_kind == DetMatInvertor::HOST)
       app_summary() << "      Matrix inversion running on host." << std::endl;
 
+    if (inverse_refinement_steps < 0)
+    {
+      APP_ABORT("SlaterDetBuilder::putDeterminant inverse_refinement_steps must be non-negative!");
+    }
+    else if (inverse_refinement_steps > 0)
+      app_summary() << "      Matrix inversion in single precision followed by " << inverse_refinement_steps
+                    << " refinement step(s)." << std::endl;
+
     if (use_batch == "yes")
     {
       app_summary() << "      Using walker batching." << std::endl;
@@ -425,7 +475,9 @@ std::unique_ptr<DiracDeterminantBase> SlaterDetBuilder::putDeterminant(
             MatrixDelayedUpdateCUDA<QMCTraits::ValueType, QMCTraits::QTFull::ValueType>>>(std::move(psi_clone),
                                                                                           firstIndex, lastIndex,
                                                                                           delay_rank,
-                                                                                          matrix_inverter_kind);
+                                                                                          matrix_inverter_kind,
+                                                                                          tune_delay_rank,
+                                                                                          inverse_refinement_steps);
       }
       else
 #endif
@@ -434,7 +486,7 @@ std::unique_ptr<DiracDeterminantBase> SlaterDetBuilder::putDeterminant(
                          "delay_rank is ignored."
                       << std::endl;
         adet = std::make_unique<DiracDeterminantBatched<>>(std::move(psi_clone), firstIndex, lastIndex, delay_rank,
-                                                           matrix_inverter_kind);
+                                                           matrix_inverter_kind, false, inverse_refinement_steps);
       }
     }
     else
@@ -447,14 +499,16 @@ std::unique_ptr<DiracDeterminantBase> SlaterDetBuilder::putDeterminant(
             DiracDeterminant<DelayedUpdateCUDA<ValueType, QMCTraits::QTFull::ValueType>>>(std::move(psi_clone),
                                                                                           firstIndex, lastIndex,
                                                                                           delay_rank,
-                                                                                          matrix_inverter_kind);
+                                                                                          matrix_inverter_kind,
+                                                                                          tune_delay_rank,
+                                                                                          inverse_refinement_steps);
       }
       else
 #endif
       {
         app_summary() << "      Running on CPU." << std::endl;
         adet = std::make_unique<DiracDeterminant<>>(std::move(psi_clone), firstIndex, lastIndex, delay_rank,
-                                                    matrix_inverter_kind);
+                                                    matrix_inverter_kind, tune_delay_rank, inverse_refinement_steps);
       }
     }
   }
@@ -506,14 +560,41 @@ bool SlaterDetBuilder::createMSDFast(std::vector<std::unique_ptr<MultiDiracDeter
 
   bool success = true;
   std::string HDF5Path(getXMLAttributeValue(DetListNode, "href"));
+  std::string cache_name(getXMLAttributeValue(DetListNode, "cache"));
   if (!HDF5Path.empty())
   {
     app_log() << "Found Multideterminants in H5 File" << std::endl;
     success = readDetListH5(cur, uniqueConfgs, C2nodes, CItags, C, optimizeCI, nptcls);
   }
-  else
+  else if (cache_name.empty())
     success = readDetList(cur, uniqueConfgs, C2nodes, CItags, C, optimizeCI, nptcls, CSFcoeff, DetsPerCSF, CSFexpansion,
                           usingCSF);
+  else
+  {
+    // the cache is only valid for the same multideterminant input and number of particles
+    std::ostringstream input;
+    xmlBufferPtr buffer = xmlBufferCreate();
+    xmlNodeDump(buffer, cur->doc, cur, 0, 0);
+    input << reinterpret_cast<const char*>(xmlBufferContent(buffer)) << sizeof(ValueType);
+    xmlBufferFree(buffer);
+    for (int grp = 0; grp < nGroups; grp++)
+      input << " " << nptcls[grp];
+    const std::string fingerprint = std::to_string(std::hash<std::string>{}(input.str()));
+
+    if (readDetListCache(cache_name, fingerprint, uniqueConfgs, C2nodes, CItags, C, optimizeCI, CSFcoeff, DetsPerCSF,
+                         CSFexpansion, usingCSF))
+      app_log() << "Read the CI expansion from the cache " << cache_name << std::endl;
+    else
+    {
+      success = readDetList(cur, uniqueConfgs, C2nodes, CItags, C, optimizeCI, nptcls, CSFcoeff, DetsPerCSF,
+                            CSFexpansion, usingCSF);
+      // every rank has looked for the cache before it is replaced
+      myComm->barrier();
+      if (success && !myComm->rank())
+        writeDetListCache(cache_name, fingerprint, uniqueConfgs, C2nodes, CItags, C, optimizeCI, CSFcoeff, DetsPerCSF,
+                          CSFexpansion, usingCSF);
+    }
+  }
 
   if (!success)
     return false;
@@ -980,6 +1061,118 @@ bool SlaterDetBuilder::readDetList(xmlNodePtr cur,
   return success;
 }
 
+bool SlaterDetBuilder::readDetListCache(const std::string& cache_name,
+                                        const std::string& fingerprint,
+                                        std::vector<std::vector<ci_configuration>>& uniqueConfgs,
+                                        std::vector<std::vector<size_t>>& C2nodes,
+                                        std::vector<std::string>& CItags,
+                                        std::vector<ValueType>& coeff,
+                                        bool& optimizeCI,
+                                        std::vector<ValueType>& CSFcoeff,
+                                        std::vector<size_t>& DetsPerCSF,
+                                        std::vector<RealType>& CSFexpansion,
+                                        bool& usingCSF) const
+{
+  hdf_archive hin;
+  if (!hin.open(cache_name, H5F_ACC_RDONLY))
+    return false;
+  std::string cache_fingerprint;
+  if (!hin.readEntry(cache_fingerprint, "fingerprint") || cache_fingerprint != fingerprint)
+  {
+    app_log() << "The CI expansion cache " << cache_name << " was written for another input and is replaced."
+              << std::endl;
+    return false;
+  }
+
+  int using_csf = 0, optimize_ci = 0;
+  hin.read(using_csf, "using_csf");
+  hin.read(optimize_ci, "optimize_ci");
+  usingCSF   = using_csf;
+  optimizeCI = optimize_ci;
+  hin.read(coeff, "coefficients");
+  hin.read(CItags, "tags");
+  CSFcoeff.clear();
+  DetsPerCSF.clear();
+  CSFexpansion.clear();
+  if (usingCSF)
+  {
+    hin.read(CSFcoeff, "csf_coefficients");
+    hin.read(DetsPerCSF, "dets_per_csf");
+    hin.read(CSFexpansion, "csf_expansion");
+  }
+
+  for (int grp = 0; grp < uniqueConfgs.size(); grp++)
+  {
+    hin.push("group" + std::to_string(grp), false);
+    hin.read(C2nodes[grp], "C2node");
+    size_t num_states = 0;
+    std::vector<char> occupations;
+    hin.read(num_states, "num_states");
+    hin.read(occupations, "occupations");
+    uniqueConfgs[grp].resize(num_states ? occupations.size() / num_states : 0);
+    for (size_t i = 0; i < uniqueConfgs[grp].size(); i++)
+    {
+      uniqueConfgs[grp][i].occup.resize(num_states);
+      for (size_t k = 0; k < num_states; k++)
+        uniqueConfgs[grp][i].occup[k] = occupations[i * num_states + k];
+    }
+    hin.pop();
+  }
+
+  app_log() << "Found " << coeff.size() << " terms in the MSD expansion.\n";
+  for (int grp = 0; grp < uniqueConfgs.size(); grp++)
+    app_log() << "Found " << uniqueConfgs[grp].size() << " unique group" << grp << " determinants.\n";
+  return true;
+}
+
+void SlaterDetBuilder::writeDetListCache(const std::string& cache_name,
+                                         const std::string& fingerprint,
+                                         const std::vector<std::vector<ci_configuration>>& uniqueConfgs,
+                                         const std::vector<std::vector<size_t>>& C2nodes,
+                                         const std::vector<std::string>& CItags,
+                                         const std::vector<ValueType>& coeff,
+                                         bool optimizeCI,
+                                         const std::vector<ValueType>& CSFcoeff,
+                                         const std::vector<size_t>& DetsPerCSF,
+                                         const std::vector<RealType>& CSFexpansion,
+                                         bool usingCSF) const
+{
+  hdf_archive hout;
+  if (!hout.create(cache_name))
+  {
+    app_warning() << "Failed to create the CI expansion cache " << cache_name << std::endl;
+    return;
+  }
+  app_log() << "Writing the CI expansion to the cache " << cache_name << std::endl;
+  int using_csf = usingCSF, optimize_ci = optimizeCI;
+  hout.write(using_csf, "using_csf");
+  hout.write(optimize_ci, "optimize_ci");
+  hout.write(coeff, "coefficients");
+  hout.write(CItags, "tags");
+  if (usingCSF)
+  {
+    hout.write(CSFcoeff, "csf_coefficients");
+    hout.write(DetsPerCSF, "dets_per_csf");
+    hout.write(CSFexpansion, "csf_expansion");
+  }
+
+  for (int grp = 0; grp < uniqueConfgs.size(); grp++)
+  {
+    hout.push("group" + std::to_string(grp));
+    hout.write(C2nodes[grp], "C2node");
+    size_t num_states = uniqueConfgs[grp].empty() ? 0 : uniqueConfgs[grp][0].occup.size();
+    std::vector<char> occupations(uniqueConfgs[grp].size() * num_states);
+    for (size_t i = 0; i < uniqueConfgs[grp].size(); i++)
+      for (size_t k = 0; k < num_states; k++)
+        occupations[i * num_states + k] = uniqueConfgs[grp][i].occup[k];
+    hout.write(num_states, "num_states");
+    hout.write(occupations, "occupations");
+    hout.pop();
+  }
+  // written last, an incomplete cache is not used
+  hout.write(fingerprint, "fingerprint");
+}
+
 bool SlaterDetBuilder::readDetListH5(xmlNodePtr cur,
                                      std::vector<std::vector<ci_configuration>>& uniqueConfgs,
                                      std::vector<std::vector<size_t>>& C2nodes,
@@ -1001,7 +1194,6 @@ bool SlaterDetBuilder::readDetListH5(xmlNodePtr cur,
   std::string CICoeffH5path("");
   std::vector<std::vector<ci_configuration>> confgLists(nGroups);
   std::vector<ValueType> CIcoeff;
-  std::vector<std::string> ConfigTag;
   std::string optCI = "no";
   RealType cutoff   = 0.0;
   OhmmsAttributeSet ciAttrib;
@@ -1033,7 +1225,7 @@ bool SlaterDetBuilder::readDetListH5(xmlNodePtr cur,
   const unsigned bit_kind = 64;
   static_assert(bit_kind == sizeof(int64_t) * 8, "Must be 64 bit fixed width integer");
   /// the number of 64 bit integers which represent the binary string for occupation
-  int N_int;
+  int N_int = 0;
   std::string Dettype = "DETS";
   ValueType sumsq     = 0.0;
   OhmmsAttributeSet spoAttrib;
@@ -1054,164 +1246,149 @@ bool SlaterDetBuilder::readDetListH5(xmlNodePtr cur,
               "(type=\"Determinants\") .\n");
   app_log() << "Reading CI expansion from HDF5:" << multidetH5path << std::endl;
 
-  hdf_archive hin;
-  if (!hin.open(multidetH5path.c_str(), H5F_ACC_RDONLY))
+  // only the first rank reads the file, the others receive the bit strings of the occupations
+  std::vector<Matrix<int64_t>> temps(nGroups);
+  if (myComm->rank() == 0)
   {
-    std::cerr << "Could not open H5 file" << std::endl;
-    abort();
-  }
-
-  if (!hin.push("MultiDet"))
-  {
-    std::cerr << "Could not open Multidet Group in H5 file" << std::endl;
-    abort();
-  }
-
-  hin.read(H5_ndets, "NbDet");
-  if (ndets != H5_ndets)
-  {
-    std::cerr << "Number of determinants in H5 file (" << H5_ndets << ") different from number of dets in XML ("
-              << ndets << ")" << std::endl;
-    abort();
-  }
-
-  hin.read(H5_nstates, "nstate");
-  if (nstates == 0)
-    nstates = H5_nstates;
-  else if (nstates != H5_nstates)
-  {
-    std::cerr << "Number of states/orbitals in H5 file (" << H5_nstates
-              << ") different from number of states/orbitals in XML (" << nstates << ")" << std::endl;
-    abort();
-  }
-
-  hin.read(N_int, "Nbits");
-  CIcoeff.resize(ndets);
-  ConfigTag.resize(ndets);
+    hdf_archive hin;
+    if (!hin.open(multidetH5path.c_str(), H5F_ACC_RDONLY))
+    {
+      std::cerr << "Could not open H5 file" << std::endl;
+      abort();
+    }
 
-  readCoeffs(hin, CIcoeff, ndets, extlevel);
+    if (!hin.push("MultiDet"))
+    {
+      std::cerr << "Could not open Multidet Group in H5 file" << std::endl;
+      abort();
+    }
 
-  ///IF OPTIMIZED COEFFICIENTS ARE PRESENT IN opt_coeffs Path
-  ///THEY ARE READ FROM DIFFERENT HDF5 the replace the previous coeff
-  ///It is important to still read all old coeffs and only replace the optimized ones
-  ///in order to keep coherence with the cutoff on the number of determinants
-  ///REMEMBER!! FIRST COEFF IS FIXED. THEREFORE WE DO NOT REPLACE IT!!!
-  if (CICoeffH5path != "")
-  {
-    int OptCiSize = 0;
-    std::vector<ValueType> CIcoeffopt;
-    hdf_archive coeffin;
-    if (!coeffin.open(CICoeffH5path.c_str(), H5F_ACC_RDONLY))
+    hin.read(H5_ndets, "NbDet");
+    if (ndets != H5_ndets)
     {
-      std::cerr << "Could not open H5 file containing Optimized Coefficients" << std::endl;
+      std::cerr << "Number of determinants in H5 file (" << H5_ndets << ") different from number of dets in XML ("
+                << ndets << ")" << std::endl;
       abort();
     }
 
-    if (!coeffin.push("MultiDet"))
+    hin.read(H5_nstates, "nstate");
+    if (nstates == 0)
+      nstates = H5_nstates;
+    else if (nstates != H5_nstates)
     {
-      std::cerr << "Could not open Multidet Group in H5 file" << std::endl;
+      std::cerr << "Number of states/orbitals in H5 file (" << H5_nstates
+                << ") different from number of states/orbitals in XML (" << nstates << ")" << std::endl;
       abort();
     }
-    coeffin.read(OptCiSize, "NbDet");
-    CIcoeffopt.resize(OptCiSize);
 
-    readCoeffs(coeffin, CIcoeffopt, ndets, extlevel);
+    hin.read(N_int, "Nbits");
+    CIcoeff.resize(ndets);
 
-    coeffin.close();
+    readCoeffs(hin, CIcoeff, ndets, extlevel);
 
-    for (int i = 0; i < OptCiSize; i++)
-      CIcoeff[i + 1] = CIcoeffopt[i];
+    ///IF OPTIMIZED COEFFICIENTS ARE PRESENT IN opt_coeffs Path
+    ///THEY ARE READ FROM DIFFERENT HDF5 the replace the previous coeff
+    ///It is important to still read all old coeffs and only replace the optimized ones
+    ///in order to keep coherence with the cutoff on the number of determinants
+    ///REMEMBER!! FIRST COEFF IS FIXED. THEREFORE WE DO NOT REPLACE IT!!!
+    if (CICoeffH5path != "")
+    {
+      int OptCiSize = 0;
+      std::vector<ValueType> CIcoeffopt;
+      hdf_archive coeffin;
+      if (!coeffin.open(CICoeffH5path.c_str(), H5F_ACC_RDONLY))
+      {
+        std::cerr << "Could not open H5 file containing Optimized Coefficients" << std::endl;
+        abort();
+      }
 
-    app_log() << "The first " << OptCiSize
-              << " Optimized coefficients were substituted to the original set of coefficients." << std::endl;
-  }
+      if (!coeffin.push("MultiDet"))
+      {
+        std::cerr << "Could not open Multidet Group in H5 file" << std::endl;
+        abort();
+      }
+      coeffin.read(OptCiSize, "NbDet");
+      CIcoeffopt.resize(OptCiSize);
 
-  std::vector<Matrix<int64_t>> temps;
-  for (int grp = 0; grp < nGroups; grp++)
-  {
-    Matrix<int64_t> tmp(ndets, N_int);
-    temps.push_back(tmp);
-    std::string ci_str;
+      readCoeffs(coeffin, CIcoeffopt, ndets, extlevel);
+
+      coeffin.close();
 
-    if (!hin.readEntry(temps[grp], "CI_" + std::to_string(grp)))
+      for (int i = 0; i < OptCiSize; i++)
+        CIcoeff[i + 1] = CIcoeffopt[i];
+
+      app_log() << "The first " << OptCiSize
+                << " Optimized coefficients were substituted to the original set of coefficients." << std::endl;
+    }
+
+    for (int grp = 0; grp < nGroups; grp++)
     {
-      //for backwards compatibility
-      if (grp == 0)
-        hin.read(temps[grp], "CI_Alpha");
-      else if (grp == 1)
-        hin.read(temps[grp], "CI_Beta");
-      else
-        APP_ABORT("Unknown HDF5 CI format");
+      temps[grp].resize(ndets, N_int);
+      if (!hin.readEntry(temps[grp], "CI_" + std::to_string(grp)))
+      {
+        //for backwards compatibility
+        if (grp == 0)
+          hin.read(temps[grp], "CI_Alpha");
+        else if (grp == 1)
+          hin.read(temps[grp], "CI_Beta");
+        else
+          APP_ABORT("Unknown HDF5 CI format");
+      }
     }
+
+    hin.close();
   }
 
-  std::vector<std::string> MyCIs(nGroups);
-  std::vector<ci_configuration> dummyCs(nGroups);
-  for (int grp = 0; grp < nGroups; grp++)
+#ifdef HAVE_MPI
+  myComm->comm.broadcast_n(&nstates, 1);
+  myComm->comm.broadcast_n(&N_int, 1);
+  if (myComm->rank())
   {
-    MyCIs[grp].resize(nstates);
-    dummyCs[grp].occup.resize(nstates, false);
-    for (size_t i = 0; i < nstates; i++)
-      dummyCs[grp].occup[i] = true;
+    CIcoeff.resize(ndets);
+    for (int grp = 0; grp < nGroups; grp++)
+      temps[grp].resize(ndets, N_int);
   }
-
-  hin.close();
+  myComm->comm.broadcast_n(CIcoeff.data(), CIcoeff.size());
+  for (int grp = 0; grp < nGroups; grp++)
+    myComm->comm.broadcast_n(temps[grp].data(), temps[grp].size());
+#endif
   app_log() << " Done reading " << ndets << " CIs from H5!" << std::endl;
 
-  std::vector<int> cnts(nGroups, 0);
-  std::vector<std::unordered_map<std::string, int>> MyMaps(nGroups);
-
   app_log() << " Sorting unique CIs" << std::endl;
-  ///This loop will find all unique Determinants in and store them "unsorted" in a new container uniqueConfg_up
-  ///and uniqueConfg_dn. The sorting is not done here
-  for (int ni = 0; ni < ndets; ni++)
-  {
-    if (std::abs(CIcoeff[ni]) < cutoff)
-      continue;
-
-    int j = 0;
-    for (int k = 0; k < N_int; k++)
+  std::vector<size_t> kept;
+  kept.reserve(ndets);
+  for (size_t ni = 0; ni < ndets; ni++)
+    if (std::abs(CIcoeff[ni]) >= cutoff)
     {
-      std::vector<std::bitset<bit_kind>> a2s(nGroups);
-      for (int grp = 0; grp < nGroups; grp++)
-      {
-        int64_t a = temps[grp][ni][k];
-        a2s[grp]  = a;
-      }
-
-      for (int i = 0; i < bit_kind; i++)
-      {
-        if (j < nstates)
-        {
-          for (int grp = 0; grp < nGroups; grp++)
-            MyCIs[grp][j] = a2s[grp][i] ? '1' : '0';
-          j++;
-        }
-      }
+      kept.push_back(ni);
+      coeff.push_back(CIcoeff[ni]);
+      CItags.push_back("CIcoeff_" + std::to_string(ni));
+      sumsq += CIcoeff[ni] * CIcoeff[ni];
     }
-    coeff.push_back(CIcoeff[ni]);
-    std::ostringstream h5tag;
-    h5tag << "CIcoeff_" << ni;
-    CItags.push_back(h5tag.str());
 
-    for (int grp = 0; grp < nGroups; grp++)
+  ///This loop will find all unique Determinants of each group and store them "unsorted" in uniqueConfgs
+  ///in the order of their first appearance. The groups are independent and processed by different threads.
+  ///The bit strings are used as keys, the occupations are only expanded for the unique determinants.
+#pragma omp parallel for
+  for (int grp = 0; grp < nGroups; grp++)
+  {
+    std::unordered_map<std::string, size_t> MyMap;
+    MyMap.reserve(kept.size());
+    C2nodes[grp].reserve(kept.size());
+    std::string occupation(nstates, '0');
+    for (const size_t ni : kept)
     {
-      std::unordered_map<std::string, int>::const_iterator got = MyMaps[grp].find(MyCIs[grp]);
-
-      if (got == MyMaps[grp].end())
-      {
-        uniqueConfgs[grp].push_back(dummyCs[grp]);
-        uniqueConfgs[grp].back().add_occupation(MyCIs[grp]);
-        C2nodes[grp].push_back(cnts[grp]);
-        MyMaps[grp].insert(std::pair<std::string, int>(MyCIs[grp], cnts[grp]));
-        cnts[grp]++;
-      }
-      else
-      {
-        C2nodes[grp].push_back(got->second);
-      }
+      const std::string key(reinterpret_cast<const char*>(temps[grp][ni]), N_int * sizeof(int64_t));
+      const auto inserted = MyMap.emplace(key, uniqueConfgs[grp].size());
+      C2nodes[grp].push_back(inserted.first->second);
+      if (!inserted.second)
+        continue;
+
+      for (size_t j = 0; j < nstates; j++)
+        occupation[j] = (temps[grp][ni][j / bit_kind] >> (j % bit_kind)) & 1 ? '1' : '0';
+      uniqueConfgs[grp].emplace_back();
+      uniqueConfgs[grp].back().add_occupation(occupation);
     }
-    sumsq += CIcoeff[ni] * CIcoeff[ni];
   }
 
   app_log() << " Done Sorting unique CIs" << std::endl;
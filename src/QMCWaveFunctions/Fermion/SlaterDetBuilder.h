@@ -96,6 +96,36 @@ private:
                    std::vector<RealType>& CSFexpansion,
                    bool& usingCSF) const;
 
+  /** read the CI expansion parsed by readDetList from a cache file
+   * @param cache_name cache file written by writeDetListCache
+   * @param fingerprint identifies the multideterminant input the cache was written for
+   * @return false if the file is missing or was written for another input
+   */
+  bool readDetListCache(const std::string& cache_name,
+                        const std::string& fingerprint,
+                        std::vector<std::vector<ci_configuration>>& uniqueConfgs,
+                        std::vector<std::vector<size_t>>& C2nodes,
+                        std::vector<std::string>& CItags,
+                        std::vector<ValueType>& coeff,
+                        bool& optimizeCI,
+                        std::vector<ValueType>& CSFcoeff,
+                        std::vector<size_t>& DetsPerCSF,
+                        std::vector<RealType>& CSFexpansion,
+                        bool& usingCSF) const;
+
+  /// write the CI expansion parsed by readDetList to a cache file
+  void writeDetListCache(const std::string& cache_name,
+                         const std::string& fingerprint,
+                         const std::vector<std::vector<ci_configuration>>& uniqueConfgs,
+                         const std::vector<std::vector<size_t>>& C2nodes,
+                         const std::vector<std::string>& CItags,
+                         const std::vector<ValueType>& coeff,
+                         bool optimizeCI,
+                         const std::vector<ValueType>& CSFcoeff,
+                         const std::vector<size_t>& DetsPerCSF,
+                         const std::vector<RealType>& CSFexpansion,
+                         bool usingCSF) const;
+
   bool readDetListH5(xmlNodePtr cur,
                      std::vector<std::vector<ci_configuration>>& uniqueConfgs,
                      std::vector<std::vector<size_t>>& C2nodes,
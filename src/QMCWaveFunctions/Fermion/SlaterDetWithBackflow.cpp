@@ -56,6 +56,76 @@ SlaterDetWithBackflow::LogValueType SlaterDetWithBackflow::evaluateLog(const Par
   return log_value_;
 }
 
+void SlaterDetWithBackflow::mw_evaluateLog(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                           const RefVectorWithLeader<ParticleSet>& p_list,
+                                           const RefVector<ParticleSet::ParticleGradient>& G_list,
+                                           const RefVector<ParticleSet::ParticleLaplacian>& L_list) const
+{
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& slater      = wfc_list.getCastedElement<SlaterDetWithBackflow>(iw);
+    slater.log_value_ = 0.0;
+    slater.BFTrans->evaluate(p_list[iw]);
+  }
+
+  for (int i = 0; i < Dets.size(); ++i)
+  {
+    const auto Det_list(extract_DetRef_list(wfc_list, i));
+    Dets[i]->mw_evaluateLog(Det_list, p_list, G_list, L_list);
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      wfc_list.getCastedElement<SlaterDetWithBackflow>(iw).log_value_ += Det_list[iw].get_log_value();
+  }
+}
+
+void SlaterDetWithBackflow::mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                         const RefVectorWithLeader<ParticleSet>& p_list,
+                                         int iat,
+                                         std::vector<PsiValueType>& ratios) const
+{
+  // a move changes all the quasiparticles, every determinant contributes to the ratio
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+    wfc_list.getCastedElement<SlaterDetWithBackflow>(iw).BFTrans->evaluatePbyP(p_list[iw], iat);
+
+  std::fill(ratios.begin(), ratios.end(), PsiValueType(1));
+  std::vector<PsiValueType> det_ratios(wfc_list.size());
+  for (int i = 0; i < Dets.size(); ++i)
+  {
+    Dets[i]->mw_calcRatio(extract_DetRef_list(wfc_list, i), p_list, iat, det_ratios);
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      ratios[iw] *= det_ratios[iw];
+  }
+}
+
+void SlaterDetWithBackflow::mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                         const RefVectorWithLeader<ParticleSet>& p_list,
+                                         int iat,
+                                         std::vector<PsiValueType>& ratios,
+                                         std::vector<GradType>& grad_now) const
+{
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+    wfc_list.getCastedElement<SlaterDetWithBackflow>(iw).BFTrans->evaluatePbyPWithGrad(p_list[iw], iat);
+
+  std::fill(ratios.begin(), ratios.end(), PsiValueType(1));
+  std::vector<PsiValueType> det_ratios(wfc_list.size());
+  for (int i = 0; i < Dets.size(); ++i)
+  {
+    Dets[i]->mw_ratioGrad(extract_DetRef_list(wfc_list, i), p_list, iat, det_ratios, grad_now);
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      ratios[iw] *= det_ratios[iw];
+  }
+}
+
+RefVectorWithLeader<WaveFunctionComponent> SlaterDetWithBackflow::extract_DetRef_list(
+    const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+    int det_id) const
+{
+  RefVectorWithLeader<WaveFunctionComponent> Det_list(*wfc_list.getCastedLeader<SlaterDetWithBackflow>().Dets[det_id]);
+  Det_list.reserve(wfc_list.size());
+  for (WaveFunctionComponent& wfc : wfc_list)
+    Det_list.push_back(*static_cast<SlaterDetWithBackflow&>(wfc).Dets[det_id]);
+  return Det_list;
+}
+
 void SlaterDetWithBackflow::registerData(ParticleSet& P, WFBufferType& buf)
 {
   BFTrans->registerData(P, buf);
@@ -17,16 +17,22 @@
 #include "CUDA/CUDAruntime.hpp"
 #include "CUDA/CUDAallocator.hpp"
 #include "CUDA/cusolver.hpp"
+#include "CUDA/cuBLAS.hpp"
+#include "QMCWaveFunctions/Fermion/DiracMatrix.h"
 #include "QMCWaveFunctions/detail/CUDA/delayed_update_helper.h"
 
 namespace qmcplusplus
 {
 /** implements matrix inversion via cuSolverDN
  * @tparam T_FP high precision for matrix inversion, T_FP >= T
+ *
+ * With refinement steps, the LU factorization and the solve run in single precision
+ * and the inverse is refined in T_FP by Newton-Schulz iterations using cuBLAS gemm.
  */
 template<typename T_FP>
 class cuSolverInverter
 {
+  using T_LP = typename LowerPrecision<T_FP>::type;
   /// scratch memory for cusolverDN
   Matrix<T_FP, CUDAAllocator<T_FP>> Mat1_gpu;
   /// scratch memory for cusolverDN
@@ -40,8 +46,21 @@ class cuSolverInverter
   /// workspace
   Vector<T_FP, CUDAAllocator<T_FP>> work_gpu;
 
+  /// number of Newton-Schulz steps after a single precision inversion, 0 disables the refined path
+  int num_refinement_steps_;
+  /// single precision scratch memory of the refined path
+  Matrix<T_LP, CUDAAllocator<T_LP>> Mat_lp_gpu;
+  Matrix<T_LP, CUDAAllocator<T_LP>> Inv_lp_gpu;
+  Vector<T_LP, CUDAHostAllocator<T_LP>> LU_diag_lp;
+  Vector<T_LP, CUDAAllocator<T_LP>> LU_diag_lp_gpu;
+  Vector<T_LP, CUDAAllocator<T_LP>> work_lp_gpu;
+  /// temporaries of the refinement steps
+  Matrix<T_FP, CUDAAllocator<T_FP>> refine_t_gpu;
+  Matrix<T_FP, CUDAAllocator<T_FP>> refine_x_gpu;
+
   // CUDA specific variables
   cusolverDnHandle_t h_cusolver_;
+  cublasHandle_t h_cublas_;
   cudaStream_t hstream_;
 
   /** resize the internal storage
@@ -65,21 +84,111 @@ class cuSolverInverter
     }
   }
 
+  /// resize the internal storage of the refined path
+  inline void resizeRefined(int norb)
+  {
+    if (Mat_lp_gpu.rows() != norb)
+    {
+      Mat_lp_gpu.resize(norb, norb);
+      Inv_lp_gpu.resize(norb, norb);
+      LU_diag_lp.resize(norb);
+      LU_diag_lp_gpu.resize(norb);
+      refine_t_gpu.resize(norb, norb);
+      refine_x_gpu.resize(norb, norb);
+      int lwork;
+      cusolverErrorCheck(cusolver::getrf_bufferSize(h_cusolver_, norb, norb, Mat_lp_gpu.data(), norb, &lwork),
+                         "cusolver::getrf_bufferSize failed!");
+      work_lp_gpu.resize(lwork);
+    }
+  }
+
+  /** invert the transpose of a_gpu in single precision and refine the result in T_FP
+   * @param norb a_gpu is norb x norb matrix
+   * @param a_gpu device matrix to be inverted, unchanged
+   * @param ainv_gpu device matrix holding the inverse of the transpose of a_gpu on output
+   * @param log_value log determinant value of a_gpu, from the single precision LU
+   */
+  template<typename TREAL>
+  void invertRefined(const int norb, const T_FP* a_gpu, T_FP* ainv_gpu, std::complex<TREAL>& log_value)
+  {
+    resizeRefined(norb);
+    copy_matrix_cuda(norb, norb, a_gpu, norb, Mat_lp_gpu.data(), norb, hstream_);
+    cusolverErrorCheck(cusolver::getrf(h_cusolver_, norb, norb, Mat_lp_gpu.data(), norb, work_lp_gpu.data(),
+                                       ipiv_gpu.data() + 1, ipiv_gpu.data()),
+                       "cusolver::getrf failed!");
+    cudaErrorCheck(cudaMemcpyAsync(ipiv.data(), ipiv_gpu.data(), ipiv_gpu.size() * sizeof(int), cudaMemcpyDeviceToHost,
+                                   hstream_),
+                   "cudaMemcpyAsync failed!");
+    extract_matrix_diagonal_cuda(norb, Mat_lp_gpu.data(), norb, LU_diag_lp_gpu.data(), hstream_);
+    cudaErrorCheck(cudaMemcpyAsync(LU_diag_lp.data(), LU_diag_lp_gpu.data(), LU_diag_lp.size() * sizeof(T_LP),
+                                   cudaMemcpyDeviceToHost, hstream_),
+                   "cudaMemcpyAsync failed!");
+    // check LU success
+    cudaErrorCheck(cudaStreamSynchronize(hstream_), "cudaStreamSynchronize failed!");
+    if (ipiv[0] != 0)
+    {
+      std::ostringstream err;
+      err << "cusolver::getrf calculation failed with devInfo = " << ipiv[0] << std::endl;
+      std::cerr << err.str();
+      throw std::runtime_error(err.str());
+    }
+    computeLogDet(LU_diag_lp.data(), norb, ipiv.data() + 1, log_value);
+    make_identity_matrix_cuda(norb, Inv_lp_gpu.data(), norb, hstream_);
+    cusolverErrorCheck(cusolver::getrs(h_cusolver_, CUBLAS_OP_T, norb, norb, Mat_lp_gpu.data(), norb,
+                                       ipiv_gpu.data() + 1, Inv_lp_gpu.data(), norb, ipiv_gpu.data()),
+                       "cusolver::getrs failed!");
+    cudaErrorCheck(cudaMemcpyAsync(ipiv.data(), ipiv_gpu.data(), sizeof(int), cudaMemcpyDeviceToHost, hstream_),
+                   "cudaMemcpyAsync failed!");
+    copy_matrix_cuda(norb, norb, Inv_lp_gpu.data(), norb, ainv_gpu, norb, hstream_);
+
+    // In the column major view, a_gpu holds M and ainv_gpu holds X ~ M^-T.
+    // T = M^T X, X <- 2 X - X T
+    const T_FP one(1), zero(0), two(2), minus_one(-1);
+    for (int step = 0; step < num_refinement_steps_; step++)
+    {
+      cublasErrorCheck(cuBLAS::gemm(h_cublas_, CUBLAS_OP_T, CUBLAS_OP_N, norb, norb, norb, &one, a_gpu, norb, ainv_gpu,
+                                    norb, &zero, refine_t_gpu.data(), norb),
+                       "cuBLAS::gemm failed!");
+      cudaErrorCheck(cudaMemcpyAsync(refine_x_gpu.data(), ainv_gpu, refine_x_gpu.size() * sizeof(T_FP),
+                                     cudaMemcpyDeviceToDevice, hstream_),
+                     "cudaMemcpyAsync failed!");
+      cublasErrorCheck(cuBLAS::gemm(h_cublas_, CUBLAS_OP_N, CUBLAS_OP_N, norb, norb, norb, &minus_one,
+                                    refine_x_gpu.data(), norb, refine_t_gpu.data(), norb, &two, ainv_gpu, norb),
+                       "cuBLAS::gemm failed!");
+    }
+    cudaErrorCheck(cudaStreamSynchronize(hstream_), "cudaStreamSynchronize failed!");
+    if (ipiv[0] != 0)
+    {
+      std::ostringstream err;
+      err << "cusolver::getrs calculation failed with devInfo = " << ipiv[0] << std::endl;
+      std::cerr << err.str();
+      throw std::runtime_error(err.str());
+    }
+  }
+
 public:
   /// default constructor
-  cuSolverInverter()
+  cuSolverInverter() : num_refinement_steps_(0)
   {
     cudaErrorCheck(cudaStreamCreate(&hstream_), "cudaStreamCreate failed!");
     cusolverErrorCheck(cusolverDnCreate(&h_cusolver_), "cusolverCreate failed!");
     cusolverErrorCheck(cusolverDnSetStream(h_cusolver_, hstream_), "cusolverSetStream failed!");
+    cublasErrorCheck(cublasCreate(&h_cublas_), "cublasCreate failed!");
+    cublasErrorCheck(cublasSetStream(h_cublas_, hstream_), "cublasSetStream failed!");
   }
 
   ~cuSolverInverter()
   {
+    cublasErrorCheck(cublasDestroy(h_cublas_), "cublasDestroy failed!");
     cusolverErrorCheck(cusolverDnDestroy(h_cusolver_), "cusolverDestroy failed!");
     cudaErrorCheck(cudaStreamDestroy(hstream_), "cudaStreamDestroy failed!");
   }
 
+  /** set the number of Newton-Schulz steps applied after a single precision inversion
+   * @param steps 0 keeps the inversion fully in T_FP. Ignored if T_FP is already single precision.
+   */
+  void setRefinementSteps(int steps) { num_refinement_steps_ = std::is_same<T_LP, T_FP>::value ? 0 : steps; }
+
   /** compute the inverse of the transpose of matrix A and its determinant value in log
    * when T_FP and TMAT are the same
    * @tparam TREAL real type
@@ -95,6 +204,14 @@ public:
     cudaErrorCheck(cudaMemcpyAsync(Mat1_gpu.data(), logdetT.data(), logdetT.size() * sizeof(TMAT),
                                    cudaMemcpyHostToDevice, hstream_),
                    "cudaMemcpyAsync failed!");
+    if (num_refinement_steps_ > 0)
+    {
+      invertRefined(norb, Mat1_gpu.data(), Ainv_gpu.data(), log_value);
+      cudaErrorCheck(cudaMemcpyAsync(Ainv.data(), Ainv_gpu.data(), Ainv.size() * sizeof(TMAT), cudaMemcpyDeviceToHost,
+                                     hstream_),
+                     "cudaMemcpyAsync failed!");
+      return;
+    }
     cusolverErrorCheck(cusolver::getrf(h_cusolver_, norb, norb, Mat1_gpu.data(), norb, work_gpu.data(),
                                        ipiv_gpu.data() + 1, ipiv_gpu.data()),
                        "cusolver::getrf failed!");
@@ -151,6 +268,15 @@ public:
                                    cudaMemcpyHostToDevice, hstream_),
                    "cudaMemcpyAsync failed!");
     copy_matrix_cuda(norb, norb, (TMAT*)Mat2_gpu.data(), norb, Mat1_gpu.data(), norb, hstream_);
+    if (num_refinement_steps_ > 0)
+    {
+      invertRefined(norb, Mat1_gpu.data(), Mat2_gpu.data(), log_value);
+      copy_matrix_cuda(norb, norb, Mat2_gpu.data(), norb, Ainv_gpu.data(), norb, hstream_);
+      cudaErrorCheck(cudaMemcpyAsync(Ainv.data(), Ainv_gpu.data(), Ainv.size() * sizeof(TMAT), cudaMemcpyDeviceToHost,
+                                     hstream_),
+                     "cudaMemcpyAsync failed!");
+      return;
+    }
     cusolverErrorCheck(cusolver::getrf(h_cusolver_, norb, norb, Mat1_gpu.data(), norb, work_gpu.data(),
                                        ipiv_gpu.data() + 1, ipiv_gpu.data()),
                        "cusolver::getrf failed!");
@@ -29,6 +29,9 @@
 #include "OhmmsPETE/OhmmsVector.h"
 #include "Numerics/LinearFit.h"
 #include "OMPTarget/OffloadAlignedAllocators.hpp"
+#include "OMPTarget/OMPTargetMath.hpp"
+#include "OMPTarget/ScopedDefaultDevice.h"
+#include "CPU/SIMD/algorithm.hpp"
 
 
 namespace qmcplusplus
@@ -58,7 +61,31 @@ struct BsplineFunctor : public OptimizableFunctorBase
   static constexpr real_type d3A8 = 0.0, d3A9 = 0.0, d3A10 = 0.0, d3A11 = -3.0;
   static constexpr real_type d3A12 = 0.0, d3A13 = 0.0, d3A14 = 0.0, d3A15 = 1.0;
 
-  std::shared_ptr<Vector<real_type, OffloadAllocator<value_type>>> spline_coefs_;
+  using CoefsType = Vector<real_type, OffloadAllocator<value_type>>;
+  /** coefficients shared by the copies made on the same device
+   *
+   * A copy made under another default device, for a crowd running there, holds its own coefficients.
+   */
+  struct SharedCoefs : public std::shared_ptr<CoefsType>
+  {
+    SharedCoefs() = default;
+    SharedCoefs(const SharedCoefs& in) : std::shared_ptr<CoefsType>(in)
+    {
+      if (in && !isPresentOnDefaultDevice(in->data()))
+      {
+        std::shared_ptr<CoefsType>::operator=(std::make_shared<CoefsType>(*in));
+        (*this)->updateTo();
+      }
+    }
+    SharedCoefs& operator=(const SharedCoefs&) = default;
+    SharedCoefs& operator=(std::shared_ptr<CoefsType>&& coefs)
+    {
+      std::shared_ptr<CoefsType>::operator=(std::move(coefs));
+      return *this;
+    }
+  };
+
+  SharedCoefs spline_coefs_;
 
   int NumParams;
   real_type DeltaR, DeltaRInv;
@@ -95,7 +122,7 @@ struct BsplineFunctor : public OptimizableFunctorBase
     DeltaR       = cutoff_radius / (real_type)(numKnots - 1);
     DeltaRInv    = 1.0 / DeltaR;
     Parameters.resize(n);
-    spline_coefs_ = std::make_shared<Vector<real_type, OffloadAllocator<value_type>>>(numCoefs);
+    spline_coefs_ = std::make_shared<CoefsType>(numCoefs);
     SplineDerivs.resize(numCoefs);
   }
 
@@ -486,11 +513,14 @@ struct BsplineFunctor : public OptimizableFunctorBase
    * @param n_padded the padded size of source particles
    * @param mw_dist Multi walker distance table [new + old][nw][1(distance)+DIM(displacements)][n_padded]
    * @param mw_allUat, returned results. Multi walker value, gradient and laplacian of pair potentials [nw][1(v)+DIM(g)+1(l)][n_padded]
+   * @param mw_allUat_comp Kahan compensation of mw_allUat, same layout. Kept on the device only.
    * @param mw_cur_allu Multi walker value, first and second derivatives of pair potentials [nw][DIM][n_padded]
    * @param transfer_buffer temporary transfer buffer
    *
    * If mw_dist is dual space, up-to-date data is assumed on device.
    * If mw_cur_allu is dual space, data on the device is consumed and no transfer is needed.
+   * The incremental updates of mw_allUat use compensated summation so that the error stays O(eps)
+   * instead of growing with the number of accepted moves in single precision.
    */
   static void mw_updateVGL(const int iat,
                            const std::vector<bool>& isAccepted,
@@ -502,8 +532,9 @@ struct BsplineFunctor : public OptimizableFunctorBase
                            T* mw_vgl, // [nw][DIM+2]
                            const int n_padded,
                            const T* mw_dist, // [nw][DIM+1][n_padded]
-                           T* mw_allUat,     // [nw][DIM+2][n_padded]
-                           T* mw_cur_allu,   // [nw][3][n_padded]
+                           T* mw_allUat,      // [nw][DIM+2][n_padded]
+                           T* mw_allUat_comp, // [nw][DIM+2][n_padded]
+                           T* mw_cur_allu,    // [nw][3][n_padded]
                            Vector<char, OffloadPinnedAllocator<char>>& transfer_buffer)
   {
     constexpr unsigned DIM = OHMMS_DIM;
@@ -539,7 +570,8 @@ struct BsplineFunctor : public OptimizableFunctorBase
                     map(to: grp_ids[:n_src]) \
                     map(to: mw_dist[:dist_stride*nw]) \
                     map(to: mw_vgl[:(DIM+2)*nw]) \
-                    map(always, from: mw_allUat[:nw * n_padded * (DIM + 2)])")
+                    map(always, from: mw_allUat[:nw * n_padded * (DIM + 2)]) \
+                    map(to: mw_allUat_comp[:nw * n_padded * (DIM + 2)])")
     for (int iw = 0; iw < nw_accepted; iw++)
     {
       T** mw_coefs          = reinterpret_cast<T**>(transfer_buffer_ptr);
@@ -564,6 +596,12 @@ struct BsplineFunctor : public OptimizableFunctorBase
       T* dUat_z = dUat_y + n_padded;
       T* d2Uat  = mw_allUat + n_padded * (DIM + 1) * nw + ip * n_padded;
 
+      T* Uat_c    = mw_allUat_comp + ip * n_padded;
+      T* dUat_x_c = mw_allUat_comp + n_padded * nw + ip * n_padded * DIM;
+      T* dUat_y_c = dUat_x_c + n_padded;
+      T* dUat_z_c = dUat_y_c + n_padded;
+      T* d2Uat_c  = mw_allUat_comp + n_padded * (DIM + 1) * nw + ip * n_padded;
+
       T* cur_allu = mw_cur_allu + ip * n_padded * 3;
 
 #if !defined(QMC_OFFLOAD_ROCM_WORKAROUND_BRANCH_IN_PARALLEL)
@@ -590,12 +628,12 @@ struct BsplineFunctor : public OptimizableFunctorBase
         T cur_u      = cur_allu[j];
         T cur_dudr   = cur_allu[j + n_padded];
         T cur_d2udr2 = cur_allu[j + n_padded * 2];
-        Uat[j] += cur_u - u;
-        dUat_x[j] -= dipl_x_new[j] * cur_dudr - dipl_x_old[j] * dudr;
-        dUat_y[j] -= dipl_y_new[j] * cur_dudr - dipl_y_old[j] * dudr;
-        dUat_z[j] -= dipl_z_new[j] * cur_dudr - dipl_z_old[j] * dudr;
+        omptarget::kahanAdd(Uat[j], Uat_c[j], cur_u - u);
+        omptarget::kahanAdd(dUat_x[j], dUat_x_c[j], dipl_x_old[j] * dudr - dipl_x_new[j] * cur_dudr);
+        omptarget::kahanAdd(dUat_y[j], dUat_y_c[j], dipl_y_old[j] * dudr - dipl_y_new[j] * cur_dudr);
+        omptarget::kahanAdd(dUat_z[j], dUat_z_c[j], dipl_z_old[j] * dudr - dipl_z_new[j] * cur_dudr);
         constexpr T lapfac(DIM - 1);
-        d2Uat[j] -= cur_d2udr2 + lapfac * cur_dudr - (d2udr2 + lapfac * dudr);
+        omptarget::kahanAdd(d2Uat[j], d2Uat_c[j], d2udr2 + lapfac * dudr - (cur_d2udr2 + lapfac * cur_dudr));
       }
       T* vgl      = mw_vgl + ip * (DIM + 2);
       Uat[iat]    = vgl[0];
@@ -603,6 +641,12 @@ struct BsplineFunctor : public OptimizableFunctorBase
       dUat_y[iat] = vgl[2];
       dUat_z[iat] = vgl[3];
       d2Uat[iat]  = vgl[4];
+      // the row of iat is freshly computed, drop its accumulated error
+      Uat_c[iat]    = T(0);
+      dUat_x_c[iat] = T(0);
+      dUat_y_c[iat] = T(0);
+      dUat_z_c[iat] = T(0);
+      d2Uat_c[iat]  = T(0);
     }
   }
 
@@ -961,17 +1005,10 @@ inline T BsplineFunctor<T>::evaluateV(const int iat,
   const real_type* restrict distArray = _distArray + iStart;
 
   ASSUME_ALIGNED(distArrayCompressed);
-  int iCount       = 0;
   const int iLimit = iEnd - iStart;
-
-#pragma vector always
-  for (int jat = 0; jat < iLimit; jat++)
-  {
-    real_type r = distArray[jat];
-    // pick the distances smaller than the cutoff and avoid the reference atom
-    if (r < cutoff_radius && iStart + jat != iat)
-      distArrayCompressed[iCount++] = distArray[jat];
-  }
+  // pick the distances smaller than the cutoff and avoid the reference atom
+  const int iCount = simd::copy_if_less(distArray, iLimit, static_cast<real_type>(cutoff_radius), iat - iStart,
+                                        distArrayCompressed, static_cast<int*>(nullptr));
 
   real_type d = 0.0;
   auto& coefs = *spline_coefs_;
@@ -1009,24 +1046,15 @@ inline void BsplineFunctor<T>::evaluateVGL(const int iat,
 
   ASSUME_ALIGNED(distIndices);
   ASSUME_ALIGNED(distArrayCompressed);
-  int iCount                 = 0;
   int iLimit                 = iEnd - iStart;
   const real_type* distArray = _distArray + iStart;
   real_type* valArray        = _valArray + iStart;
   real_type* gradArray       = _gradArray + iStart;
   real_type* laplArray       = _laplArray + iStart;
 
-#pragma vector always
-  for (int jat = 0; jat < iLimit; jat++)
-  {
-    real_type r = distArray[jat];
-    if (r < cutoff_radius && iStart + jat != iat)
-    {
-      distIndices[iCount]         = jat;
-      distArrayCompressed[iCount] = r;
-      iCount++;
-    }
-  }
+  // pick the distances smaller than the cutoff and avoid the reference atom
+  const int iCount = simd::copy_if_less(distArray, iLimit, static_cast<real_type>(cutoff_radius), iat - iStart,
+                                        distArrayCompressed, distIndices);
 
   auto& coefs = *spline_coefs_;
 #pragma omp simd
@@ -63,10 +63,11 @@ protected:
   std::vector<PosType> Jgrad;
   std::vector<RealType> Jlap;
 
-  // Jastrow exponent values and gradients at proposed position
+  // Jastrow exponent value and the moved particle's gradient and laplacian at proposed position.
+  // The gradients and laplacians of the other particles are only updated in acceptMove.
   RealType Jval_t;
-  std::vector<PosType> Jgrad_t;
-  std::vector<RealType> Jlap_t;
+  PosType Jgrad_t;
+  RealType Jlap_t;
 
   // containers for counting function derivative quantities
   Matrix<RealType> dCsum;
@@ -157,9 +158,6 @@ public:
     Jgrad.resize(num_els);
     Jlap.resize(num_els);
 
-    Jgrad_t.resize(num_els);
-    Jlap_t.resize(num_els);
-
     // check that F, C dimensions match
     if (F.size() != num_regions * num_regions)
     {
@@ -224,6 +222,24 @@ public:
   }
 
 
+  LogValueType evaluateGL(const ParticleSet& P,
+                          ParticleSet::ParticleGradient& G,
+                          ParticleSet::ParticleLaplacian& L,
+                          bool fromscratch) override
+  {
+    // Jgrad and Jlap are kept up to date by acceptMove
+    if (fromscratch)
+      evaluateExponents(P);
+    for (int i = 0; i < num_els; ++i)
+    {
+      G[i] += Jgrad[i];
+      L[i] += Jlap[i];
+    }
+    log_value_ = Jval;
+    return log_value_;
+  }
+
+
   void recompute(const ParticleSet& P) override
   {
     evaluateExponents(P);
@@ -298,13 +314,19 @@ public:
   }
 
 
+  /** evaluate the exponent for a single particle move
+   *
+   * Only the counting functions of the moved particle are evaluated by the region.
+   * The exponent and the moved particle's gradient and laplacian cost O(num_regions^2).
+   * Updating the gradients and laplacians of the other particles is deferred to acceptMove.
+   */
   void evaluateTempExponents(ParticleSet& P, int iat)
   {
     // evaluate temporary counting regions
     C->evaluateTemp(P, iat);
-    Jval_t = 0;
-    std::fill(Jgrad_t.begin(), Jgrad_t.end(), 0);
-    std::fill(Jlap_t.begin(), Jlap_t.end(), 0);
+    Jval_t  = 0;
+    Jgrad_t = 0;
+    Jlap_t  = 0;
     std::fill(FCsum_t.begin(), FCsum_t.end(), 0);
     std::fill(FCgrad_t.begin(), FCgrad_t.end(), 0);
     std::fill(FClap_t.begin(), FClap_t.end(), 0);
@@ -323,19 +345,8 @@ public:
     for (int I = 0; I < num_regions; ++I)
     {
       Jval_t += C->sum_t[I] * FCsum_t[I];
-      for (int i = 0; i < num_els; ++i)
-      {
-        if (i == iat)
-        {
-          Jgrad_t[i] += C->grad_t[I] * 2 * FCsum_t[I];
-          Jlap_t[i] += C->lap_t[I] * 2 * FCsum_t[I] + 2 * dot(C->grad_t[I], FCgrad_t[I]);
-        }
-        else
-        {
-          Jgrad_t[i] += C->grad(I, i) * 2 * FCsum_t[I];
-          Jlap_t[i] += C->lap(I, i) * 2 * FCsum_t[I] + 2 * dot(C->grad(I, i), FCgrad(I, i));
-        }
-      }
+      Jgrad_t += C->grad_t[I] * 2 * FCsum_t[I];
+      Jlap_t += C->lap_t[I] * 2 * FCsum_t[I] + 2 * dot(C->grad_t[I], FCgrad_t[I]);
     }
     // print out results every so often
     if (debug)
@@ -362,24 +373,17 @@ public:
     std::copy(FClap_t.begin(), FClap_t.end(), std::ostream_iterator<RealType>(os, ", "));
     // Jval, Jgrad, Jlap
     os << std::endl << "Jval_t: " << Jval_t;
-    os << std::endl << "Jgrad_t: ";
-    std::copy(Jgrad_t.begin(), Jgrad_t.end(), std::ostream_iterator<PosType>(os, ", "));
-    os << std::endl << "Jlap_t:  ";
-    std::copy(Jlap_t.begin(), Jlap_t.end(), std::ostream_iterator<RealType>(os, ", "));
+    os << std::endl << "Jgrad_t: " << Jgrad_t;
+    os << std::endl << "Jlap_t:  " << Jlap_t;
     os << std::endl << std::endl;
   }
 
-  GradType evalGrad(ParticleSet& P, int iat) override
-  {
-    evaluateExponents(P);
-    log_value_ = Jval;
-    return Jgrad[iat];
-  }
+  GradType evalGrad(ParticleSet& P, int iat) override { return Jgrad[iat]; }
 
   PsiValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat) override
   {
     evaluateTempExponents(P, iat);
-    grad_iat += Jgrad_t[iat];
+    grad_iat += Jgrad_t;
     return std::exp(static_cast<PsiValueType>(Jval_t - Jval));
   }
 
@@ -397,10 +401,24 @@ public:
     // update exponent values to that at proposed position
     Jval       = Jval_t;
     log_value_ = Jval;
+    // FCsum changed, the gradients and laplacians of all the particles need an update
     for (int i = 0; i < num_els; ++i)
     {
-      Jgrad[i] = Jgrad_t[i];
-      Jlap[i]  = Jlap_t[i];
+      if (i == iat)
+      {
+        Jgrad[i] = Jgrad_t;
+        Jlap[i]  = Jlap_t;
+        continue;
+      }
+      PosType Jgrad_i  = 0;
+      RealType Jlap_i = 0;
+      for (int I = 0; I < num_regions; ++I)
+      {
+        Jgrad_i += C->grad(I, i) * 2 * FCsum[I];
+        Jlap_i += C->lap(I, i) * 2 * FCsum[I] + 2 * dot(C->grad(I, i), FCgrad(I, i));
+      }
+      Jgrad[i] = Jgrad_i;
+      Jlap[i]  = Jlap_i;
     }
   }
 
@@ -412,6 +430,96 @@ public:
     return std::exp(static_cast<PsiValueType>(Jval_t - Jval));
   }
 
+  /** mw_ overloads loop over the walkers without virtual dispatch.
+   * The per-walker work is dominated by the counting functions of the moved particle which are not shared among walkers.
+   */
+  void mw_evaluateLog(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                      const RefVectorWithLeader<ParticleSet>& p_list,
+                      const RefVector<ParticleSet::ParticleGradient>& G_list,
+                      const RefVector<ParticleSet::ParticleLaplacian>& L_list) const override
+  {
+    assert(this == &wfc_list.getLeader());
+#pragma omp parallel for
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      wfc_list.getCastedElement<CountingJastrow>(iw).CountingJastrow::evaluateLog(p_list[iw], G_list[iw], L_list[iw]);
+  }
+
+  void mw_evaluateGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                     const RefVectorWithLeader<ParticleSet>& p_list,
+                     const RefVector<ParticleSet::ParticleGradient>& G_list,
+                     const RefVector<ParticleSet::ParticleLaplacian>& L_list,
+                     bool fromscratch) const override
+  {
+    assert(this == &wfc_list.getLeader());
+#pragma omp parallel for
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      wfc_list.getCastedElement<CountingJastrow>(iw).CountingJastrow::evaluateGL(p_list[iw], G_list[iw], L_list[iw],
+                                                                                 fromscratch);
+  }
+
+  void mw_recompute(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    const std::vector<bool>& recompute) const override
+  {
+    assert(this == &wfc_list.getLeader());
+#pragma omp parallel for
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      if (recompute[iw])
+        wfc_list.getCastedElement<CountingJastrow>(iw).CountingJastrow::recompute(p_list[iw]);
+  }
+
+  void mw_evalGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                   const RefVectorWithLeader<ParticleSet>& p_list,
+                   int iat,
+                   std::vector<GradType>& grad_now) const override
+  {
+    assert(this == &wfc_list.getLeader());
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      grad_now[iw] = wfc_list.getCastedElement<CountingJastrow>(iw).Jgrad[iat];
+  }
+
+  void mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios) const override
+  {
+    assert(this == &wfc_list.getLeader());
+#pragma omp parallel for
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      ratios[iw] = wfc_list.getCastedElement<CountingJastrow>(iw).CountingJastrow::ratio(p_list[iw], iat);
+  }
+
+  void mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new) const override
+  {
+    assert(this == &wfc_list.getLeader());
+#pragma omp parallel for
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      ratios[iw] =
+          wfc_list.getCastedElement<CountingJastrow>(iw).CountingJastrow::ratioGrad(p_list[iw], iat, grad_new[iw]);
+  }
+
+  void mw_accept_rejectMove(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                            const RefVectorWithLeader<ParticleSet>& p_list,
+                            int iat,
+                            const std::vector<bool>& isAccepted,
+                            bool safe_to_delay = false) const override
+  {
+    assert(this == &wfc_list.getLeader());
+#pragma omp parallel for
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      auto& wfc = wfc_list.getCastedElement<CountingJastrow>(iw);
+      if (isAccepted[iw])
+        wfc.CountingJastrow::acceptMove(p_list[iw], iat, safe_to_delay);
+      else
+        wfc.CountingJastrow::restore(iat);
+    }
+  }
+
   void registerData(ParticleSet& P, WFBufferType& buf) override
   {
     LogValueType logValue = evaluateLog(P, P.G, P.L);
@@ -452,7 +560,9 @@ public:
     buf.get(Jlap_begin, Jlap_end);
     buf.get(Jgrad_begin, Jgrad_end);
     DEBUG_PSIBUFFER(" CountingJastrow::copyFromBuffer ", buf.current());
-    return;
+    // the per-particle counting region values are not stored in the buffer, rebuild them for single particle moves
+    evaluateExponents(P);
+    log_value_ = Jval;
   }
 
   std::unique_ptr<WaveFunctionComponent> makeClone(ParticleSet& tqp) const override
@@ -22,13 +22,39 @@
 #include "Utilities/IteratorUtility.h"
 #include "CPU/SIMD/aligned_allocator.hpp"
 #include "CPU/SIMD/algorithm.hpp"
+#include "ResourceCollection.h"
 #include <map>
 #include <numeric>
 
 namespace qmcplusplus
 {
+template<typename T>
+struct J1OrbitalSoAMultiWalkerMem : public Resource
+{
+  /// distances of all the walkers [nw][Nions] reordered into [Nions][nw] blocks by ion groups
+  aligned_vector<T> mw_dist;
+  /// value, first and second derivatives of the one-body functions in the layout of mw_dist
+  aligned_vector<T> mw_u, mw_du, mw_d2u;
+  /// scratch space of the functors
+  aligned_vector<T> mw_dist_compressed;
+  aligned_vector<int> mw_dist_indice;
+  /// multi walker result of value, gradient and laplacian
+  std::vector<T> mw_vals;
+  std::vector<TinyVector<T, OHMMS_DIM>> mw_grads;
+  std::vector<T> mw_laps;
+
+  J1OrbitalSoAMultiWalkerMem() : Resource("J1OrbitalSoAMultiWalkerMem") {}
+
+  J1OrbitalSoAMultiWalkerMem(const J1OrbitalSoAMultiWalkerMem&) : J1OrbitalSoAMultiWalkerMem() {}
+
+  Resource* makeClone() const override { return new J1OrbitalSoAMultiWalkerMem(*this); }
+};
+
 /** @ingroup WaveFunctionComponent
  *  @brief Specialization for one-body Jastrow function using multiple functors
+ *
+ * When ions are grouped, the mw_ APIs pack the distances of all the walkers in a crowd
+ * and call each functor once per ion group.
  */
 template<class FT>
 struct J1OrbitalSoA : public WaveFunctionComponent
@@ -83,6 +109,8 @@ struct J1OrbitalSoA : public WaveFunctionComponent
   std::vector<GradDerivVec> gradLogPsi;
   std::vector<ValueDerivVec> lapLogPsi;
 
+  std::unique_ptr<J1OrbitalSoAMultiWalkerMem<valT>> mw_mem_;
+
   void resizeWFOptVectors()
   {
     dLogPsi.resize(myVars.size());
@@ -144,6 +172,28 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     J1UniqueFunctors[source_type] = std::move(afunc);
   }
 
+  void createResource(ResourceCollection& collection) const override
+  {
+    collection.addResource(std::make_unique<J1OrbitalSoAMultiWalkerMem<valT>>());
+  }
+
+  void acquireResource(ResourceCollection& collection,
+                       const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override
+  {
+    auto& wfc_leader = wfc_list.getCastedLeader<J1OrbitalSoA<FT>>();
+    auto res_ptr     = dynamic_cast<J1OrbitalSoAMultiWalkerMem<valT>*>(collection.lendResource().release());
+    if (!res_ptr)
+      throw std::runtime_error("J1OrbitalSoA::acquireResource dynamic_cast failed");
+    wfc_leader.mw_mem_.reset(res_ptr);
+  }
+
+  void releaseResource(ResourceCollection& collection,
+                       const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override
+  {
+    auto& wfc_leader = wfc_list.getCastedLeader<J1OrbitalSoA<FT>>();
+    collection.takebackResource(std::move(wfc_leader.mw_mem_));
+  }
+
   void recompute(const ParticleSet& P) override
   {
     const auto& d_ie(P.getDistTableAB(myTableID));
@@ -198,12 +248,71 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     return std::exp(static_cast<PsiValueType>(Vat[iat] - curAt));
   }
 
+  void mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios) const override
+  {
+    if (NumGroups == 0)
+    {
+      WaveFunctionComponent::mw_calcRatio(wfc_list, p_list, iat, ratios);
+      return;
+    }
+    // values only as in ratio(), acceptMove computes the gradient and laplacian of accepted moves
+    auto& wfc_leader = wfc_list.getCastedLeader<J1OrbitalSoA<FT>>();
+    RefVector<const DistRow> dist_list;
+    dist_list.reserve(wfc_list.size());
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      dist_list.push_back(p_list[iw].getDistTableAB(myTableID).getTempDists());
+    mw_computeVGL(wfc_leader, dist_list, {});
+
+    const auto& mw_vals = wfc_leader.mw_mem_->mw_vals;
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      auto& wfc      = wfc_list.getCastedElement<J1OrbitalSoA<FT>>(iw);
+      wfc.UpdateMode = ORB_PBYP_RATIO;
+      wfc.curAt      = mw_vals[iw];
+      ratios[iw]     = std::exp(static_cast<PsiValueType>(wfc.Vat[iat] - wfc.curAt));
+    }
+  }
+
   inline void evaluateRatios(const VirtualParticleSet& VP, std::vector<ValueType>& ratios) override
   {
     for (int k = 0; k < ratios.size(); ++k)
       ratios[k] = std::exp(Vat[VP.refPtcl] - computeU(VP.getDistTableAB(myTableID).getDistRow(k)));
   }
 
+  void mw_evaluateRatios(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                         const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                         std::vector<std::vector<ValueType>>& ratios) const override
+  {
+    if (NumGroups == 0)
+    {
+      WaveFunctionComponent::mw_evaluateRatios(wfc_list, vp_list, ratios);
+      return;
+    }
+    auto& wfc_leader = wfc_list.getCastedLeader<J1OrbitalSoA<FT>>();
+    RefVector<const DistRow> dist_list;
+    for (int iw = 0; iw < vp_list.size(); iw++)
+    {
+      const auto& d_table = vp_list[iw].getDistTableAB(myTableID);
+      for (int k = 0; k < vp_list[iw].getTotalNum(); ++k)
+        dist_list.push_back(d_table.getDistRow(k));
+    }
+    mw_computeVGL(wfc_leader, dist_list, {});
+
+    const auto& mw_vals = wfc_leader.mw_mem_->mw_vals;
+    size_t ivp          = 0;
+    for (int iw = 0; iw < vp_list.size(); iw++)
+    {
+      const auto& wfc = wfc_list.getCastedElement<J1OrbitalSoA<FT>>(iw);
+      const auto& vp  = vp_list[iw];
+      for (int k = 0; k < vp.getTotalNum(); ++k, ivp++)
+        ratios[iw][k] = std::exp(wfc.Vat[vp.refPtcl] - mw_vals[ivp]);
+    }
+    assert(ivp == dist_list.size());
+  }
+
   void evaluateDerivatives(ParticleSet& P,
                            const opt_variables_type& active,
                            std::vector<ValueType>& dlogpsi,
@@ -316,6 +425,86 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     }
   }
 
+  /** fused kernel, accumulates the derivatives of every walker directly
+   *  without the per-parameter gradient and laplacian arrays of evaluateDerivatives
+   */
+  void mw_evaluateParameterDerivatives(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                       const RefVectorWithLeader<ParticleSet>& p_list,
+                                       const opt_variables_type& optvars,
+                                       RecordArray<ValueType>& dlogpsi,
+                                       RecordArray<ValueType>& dhpsioverpsi) const override
+  {
+    assert(this == &wfc_list.getLeader());
+    const size_t NumVars = myVars.size();
+    bool recalculate(false);
+    std::vector<bool> rcsingles(NumVars, false);
+    for (int k = 0; k < NumVars; ++k)
+    {
+      int kk = myVars.where(k);
+      if (kk < 0)
+        continue;
+      if (optvars.recompute(kk))
+        recalculate = true;
+      rcsingles[k] = true;
+    }
+    if (!recalculate)
+      return;
+
+    std::vector<TinyVector<RealType, 3>> derivs(NumVars);
+    std::vector<ValueType> dLogPsi_w(NumVars);
+    std::vector<ValueType> dHPsi_w(NumVars);
+    constexpr RealType cone(1);
+    constexpr RealType lapfac(OHMMS_DIM - cone);
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      const auto& j1       = wfc_list.getCastedElement<J1OrbitalSoA<FT>>(iw);
+      const ParticleSet& P = p_list[iw];
+      const auto& d_table  = P.getDistTableAB(myTableID);
+      const size_t ns      = d_table.sources();
+      const size_t nt      = P.getTotalNum();
+      std::fill(dLogPsi_w.begin(), dLogPsi_w.end(), 0.0);
+      std::fill(dHPsi_w.begin(), dHPsi_w.end(), 0.0);
+      for (size_t i = 0; i < ns; ++i)
+      {
+        FT* func = j1.J1Functors[i];
+        if (func == nullptr)
+          continue;
+        const int first(OffSet[i].first);
+        const int last(OffSet[i].second);
+        bool recalcFunc(false);
+        for (int rcs = first; rcs < last; rcs++)
+          if (rcsingles[rcs])
+            recalcFunc = true;
+        if (!recalcFunc)
+          continue;
+        for (size_t j = 0; j < nt; ++j)
+        {
+          std::fill(derivs.begin(), derivs.end(), 0);
+          const auto dist = d_table.getDistRow(j)[i];
+          if (!func->evaluateDerivatives(dist, derivs))
+            continue;
+          const RealType rinv(cone / dist);
+          const PosType& dr = d_table.getDisplRow(j)[i];
+          // -0.5 * lap_j - G_j . grad_j of the gradient and laplacian arrays of evaluateDerivatives
+          for (int p = first, ip = 0; p < last; ++p, ++ip)
+          {
+            const RealType dudr(rinv * derivs[ip][1]);
+            dLogPsi_w[p] -= derivs[ip][0];
+            dHPsi_w[p] += RealType(0.5) * (derivs[ip][2] + lapfac * dudr) - ValueType(dot(P.G[j], dudr * dr));
+          }
+        }
+      }
+      for (int k = 0; k < NumVars; ++k)
+      {
+        int kk = myVars.where(k);
+        if (kk < 0 || !rcsingles[k])
+          continue;
+        dlogpsi.setValue(kk, iw, dlogpsi.getValue(kk, iw) + dLogPsi_w[k]);
+        dhpsioverpsi.setValue(kk, iw, dhpsioverpsi.getValue(kk, iw) + dHPsi_w[k]);
+      }
+    }
+  }
+
   inline valT computeU(const DistRow& dist)
   {
     valT curVat(0);
@@ -382,6 +571,54 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     return log_value_ = -simd::accumulate_n(Vat.data(), Nelec, valT());
   }
 
+  void mw_evaluateGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                     const RefVectorWithLeader<ParticleSet>& p_list,
+                     const RefVector<ParticleSet::ParticleGradient>& G_list,
+                     const RefVector<ParticleSet::ParticleLaplacian>& L_list,
+                     bool fromscratch) const override
+  {
+    if (NumGroups == 0)
+    {
+      WaveFunctionComponent::mw_evaluateGL(wfc_list, p_list, G_list, L_list, fromscratch);
+      return;
+    }
+    const int nw = wfc_list.size();
+    if (fromscratch)
+    {
+      // recompute electron by electron for all the walkers at once
+      auto& wfc_leader = wfc_list.getCastedLeader<J1OrbitalSoA<FT>>();
+      RefVector<const DistRow> dist_list;
+      RefVector<const DisplRow> displ_list;
+      dist_list.reserve(nw);
+      displ_list.reserve(nw);
+      for (int iat = 0; iat < Nelec; ++iat)
+      {
+        dist_list.clear();
+        displ_list.clear();
+        for (int iw = 0; iw < nw; iw++)
+        {
+          const auto& d_ie = p_list[iw].getDistTableAB(myTableID);
+          dist_list.push_back(d_ie.getDistRow(iat));
+          displ_list.push_back(d_ie.getDisplRow(iat));
+        }
+        mw_computeVGL(wfc_leader, dist_list, displ_list);
+
+        const auto& mw_mem = *wfc_leader.mw_mem_;
+#pragma omp parallel for
+        for (int iw = 0; iw < nw; iw++)
+        {
+          auto& wfc     = wfc_list.getCastedElement<J1OrbitalSoA<FT>>(iw);
+          wfc.Vat[iat]  = mw_mem.mw_vals[iw];
+          wfc.Grad[iat] = mw_mem.mw_grads[iw];
+          wfc.Lap[iat]  = mw_mem.mw_laps[iw];
+        }
+      }
+    }
+#pragma omp parallel for
+    for (int iw = 0; iw < nw; iw++)
+      wfc_list[iw].evaluateGL(p_list[iw], G_list[iw], L_list[iw], false);
+  }
+
   /** compute gradient and lap
    * @return lap
    */
@@ -440,6 +677,118 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     }
   }
 
+  /** compute the value, gradient and laplacian of the one-body terms of an electron for a batch of walkers
+   * @param wfc_leader the leader holding the multi walker resource
+   * @param dist_list distances between the electron and the ions of each walker
+   * @param displ_list displacements between the electron and the ions of each walker. If empty, only values are computed.
+   *
+   * The distances are packed by ion groups such that every functor is called once for the whole batch.
+   * The results are stored in mw_vals, mw_grads and mw_laps of the multi walker resource.
+   */
+  void mw_computeVGL(J1OrbitalSoA& wfc_leader,
+                     const RefVector<const DistRow>& dist_list,
+                     const RefVector<const DisplRow>& displ_list) const
+  {
+    auto& mw_mem        = *wfc_leader.mw_mem_;
+    const int nw        = dist_list.size();
+    const size_t nfused = static_cast<size_t>(nw) * Nions;
+    auto& mw_dist       = mw_mem.mw_dist;
+    auto& mw_u          = mw_mem.mw_u;
+    auto& mw_du         = mw_mem.mw_du;
+    auto& mw_d2u        = mw_mem.mw_d2u;
+    mw_dist.resize(nfused);
+    mw_u.resize(nfused);
+    mw_du.resize(nfused);
+    mw_d2u.resize(nfused);
+    mw_mem.mw_dist_compressed.resize(nfused);
+    mw_mem.mw_dist_indice.resize(nfused);
+
+    // the block of the group jg starts at nw * Ions.first(jg) and holds the group of each walker contiguously
+    for (int jg = 0; jg < NumGroups; ++jg)
+    {
+      const int first = Ions.first(jg);
+      const int ng    = Ions.last(jg) - first;
+      for (int iw = 0; iw < nw; iw++)
+        std::copy_n(dist_list[iw].get().data() + first, ng, mw_dist.data() + nw * first + iw * ng);
+    }
+
+    constexpr valT czero(0);
+    std::fill_n(mw_u.data(), nfused, czero);
+    std::fill_n(mw_du.data(), nfused, czero);
+    std::fill_n(mw_d2u.data(), nfused, czero);
+    for (int jg = 0; jg < NumGroups; ++jg)
+      if (J1UniqueFunctors[jg] != nullptr)
+        J1UniqueFunctors[jg]->evaluateVGL(-1, nw * Ions.first(jg), nw * Ions.last(jg), mw_dist.data(), mw_u.data(),
+                                          mw_du.data(), mw_d2u.data(), mw_mem.mw_dist_compressed.data(),
+                                          mw_mem.mw_dist_indice.data());
+
+    const bool need_gl = !displ_list.empty();
+    mw_mem.mw_vals.resize(nw);
+    mw_mem.mw_grads.resize(nw);
+    mw_mem.mw_laps.resize(nw);
+    constexpr valT lapfac = OHMMS_DIM - RealType(1);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      valT val(0), lap(0);
+      posT grad(0);
+      for (int jg = 0; jg < NumGroups; ++jg)
+      {
+        const int first = Ions.first(jg);
+        const int ng    = Ions.last(jg) - first;
+        const int shift = nw * first + iw * ng;
+        val += simd::accumulate_n(mw_u.data() + shift, ng, valT());
+        if (!need_gl)
+          continue;
+        const valT* restrict du  = mw_du.data() + shift;
+        const valT* restrict d2u = mw_d2u.data() + shift;
+        for (int jat = 0; jat < ng; ++jat)
+          lap += d2u[jat] + lapfac * du[jat];
+        for (int idim = 0; idim < OHMMS_DIM; ++idim)
+        {
+          const valT* restrict dX = displ_list[iw].get().data(idim) + first;
+          valT s                  = valT();
+          for (int jat = 0; jat < ng; ++jat)
+            s += du[jat] * dX[jat];
+          grad[idim] += s;
+        }
+      }
+      mw_mem.mw_vals[iw]  = val;
+      mw_mem.mw_grads[iw] = grad;
+      mw_mem.mw_laps[iw]  = lap;
+    }
+  }
+
+  /** compute curAt, curGrad and curLap of the proposed move of all the walkers
+   * Using getTempDists() and getTempDispls(). UpdateMode is set to ORB_PBYP_PARTIAL.
+   */
+  void mw_computeTempVGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                         const RefVectorWithLeader<ParticleSet>& p_list) const
+  {
+    auto& wfc_leader = wfc_list.getCastedLeader<J1OrbitalSoA<FT>>();
+    const int nw     = wfc_list.size();
+    RefVector<const DistRow> dist_list;
+    RefVector<const DisplRow> displ_list;
+    dist_list.reserve(nw);
+    displ_list.reserve(nw);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      const auto& d_ie = p_list[iw].getDistTableAB(myTableID);
+      dist_list.push_back(d_ie.getTempDists());
+      displ_list.push_back(d_ie.getTempDispls());
+    }
+    mw_computeVGL(wfc_leader, dist_list, displ_list);
+
+    const auto& mw_mem = *wfc_leader.mw_mem_;
+    for (int iw = 0; iw < nw; iw++)
+    {
+      auto& wfc      = wfc_list.getCastedElement<J1OrbitalSoA<FT>>(iw);
+      wfc.UpdateMode = ORB_PBYP_PARTIAL;
+      wfc.curAt      = mw_mem.mw_vals[iw];
+      wfc.curGrad    = mw_mem.mw_grads[iw];
+      wfc.curLap     = mw_mem.mw_laps[iw];
+    }
+  }
+
   /** compute the gradient during particle-by-particle update
    * @param P quantum particleset
    * @param iat particle index
@@ -463,6 +812,26 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     return std::exp(static_cast<PsiValueType>(Vat[iat] - curAt));
   }
 
+  void mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new) const override
+  {
+    if (NumGroups == 0)
+    {
+      WaveFunctionComponent::mw_ratioGrad(wfc_list, p_list, iat, ratios, grad_new);
+      return;
+    }
+    mw_computeTempVGL(wfc_list, p_list);
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      const auto& wfc = wfc_list.getCastedElement<J1OrbitalSoA<FT>>(iw);
+      grad_new[iw] += wfc.curGrad;
+      ratios[iw] = std::exp(static_cast<PsiValueType>(wfc.Vat[iat] - wfc.curAt));
+    }
+  }
+
   /** Rejected move. Nothing to do */
   inline void restore(int iat) override {}
 
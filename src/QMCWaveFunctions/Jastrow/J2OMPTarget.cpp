@@ -40,6 +40,8 @@ struct J2OMPTargetMultiWalkerMem : public Resource
   Matrix<T, OffloadPinnedAllocator<T>> mw_vgl;
   /// memory pool for Uat, dUat, d2Uat [Nw][N_padded] + [Nw][DIM][N_padded] + [Nw][N_padded]
   Vector<T, OffloadPinnedAllocator<T>> mw_allUat;
+  /// Kahan compensation of mw_allUat with the same layout. Only lives on the device after acquireResource.
+  Vector<T, OffloadPinnedAllocator<T>> mw_allUat_comp;
   /// memory pool for cur_u, cur_du, cur_d2u [3][Nw][N_padded]. 3 is for value, first and second derivatives.
   Vector<T, OffloadPinnedAllocator<T>> mw_cur_allu;
 
@@ -91,6 +93,10 @@ void J2OMPTarget<FT>::acquireResource(ResourceCollection& collection,
     wfc.d2Uat.attachReference(mw_allUat.data() + nw * N_padded * (DIM + 1) + iw * N_padded, N);
   }
   wfc_leader.mw_mem_->mw_cur_allu.resize(N_padded * 3 * nw);
+  auto& mw_allUat_comp = wfc_leader.mw_mem_->mw_allUat_comp;
+  mw_allUat_comp.resize(N_padded * (DIM + 2) * nw);
+  std::fill(mw_allUat_comp.begin(), mw_allUat_comp.end(), 0);
+  mw_allUat_comp.updateTo();
 }
 
 template<typename FT>
@@ -321,7 +327,9 @@ J2OMPTarget<FT>::J2OMPTarget(const std::string& obj_name, ParticleSet& p)
       N_padded(getAlignedSize<valT>(N)),
       NumGroups(p.groups()),
       my_table_ID_(p.addTable(p)),
-      j2_ke_corr_helper(p, F)
+      j2_ke_corr_helper(p, F),
+      steps_between_recompute_(0),
+      steps_since_recompute_(0)
 {
   if (myName.empty())
     throw std::runtime_error("J2OMPTarget object name cannot be empty!");
@@ -415,8 +423,9 @@ std::unique_ptr<WaveFunctionComponent> J2OMPTarget<FT>::makeClone(ParticleSet& t
         j2copy->addFunc(ig, jg, std::move(fc));
       }
     }
-  j2copy->KEcorr      = KEcorr;
-  j2copy->Optimizable = Optimizable;
+  j2copy->KEcorr                   = KEcorr;
+  j2copy->Optimizable              = Optimizable;
+  j2copy->steps_between_recompute_ = steps_between_recompute_;
 
   j2copy->myVars.clear();
   j2copy->myVars.insertFrom(myVars);
@@ -658,12 +667,13 @@ void J2OMPTarget<FT>::mw_accept_rejectMove(const RefVectorWithLeader<WaveFunctio
   // this call may go asynchronous, then need to wait at mw_calcRatio mw_ratioGrad and mw_completeUpdates
   FT::mw_updateVGL(iat, isAccepted, NumGroups, F.data() + p_leader.GroupID[iat] * NumGroups, wfc_leader.N,
                    grp_ids.data(), nw, mw_vgl.data(), N_padded, dt_leader.getMultiWalkerTempDataPtr(), mw_allUat.data(),
-                   mw_cur_allu.data(), wfc_leader.mw_mem_->mw_update_buffer);
+                   wfc_leader.mw_mem_->mw_allUat_comp.data(), mw_cur_allu.data(), wfc_leader.mw_mem_->mw_update_buffer);
 }
 
 template<typename FT>
 void J2OMPTarget<FT>::recompute(const ParticleSet& P)
 {
+  steps_since_recompute_ = 0;
   const auto& d_table = P.getDistTableAA(my_table_ID_);
   for (int ig = 0; ig < NumGroups; ++ig)
   {
@@ -718,11 +728,30 @@ void J2OMPTarget<FT>::mw_recompute(const RefVectorWithLeader<WaveFunctionCompone
 {
   auto& wfc_leader = wfc_list.getCastedLeader<J2OMPTarget<FT>>();
   assert(this == &wfc_leader);
+  const size_t nw      = wfc_list.size();
+  auto& mw_allUat      = wfc_leader.mw_mem_->mw_allUat;
+  auto& mw_allUat_comp = wfc_leader.mw_mem_->mw_allUat_comp;
 #pragma omp parallel for
-  for (int iw = 0; iw < wfc_list.size(); iw++)
+  for (int iw = 0; iw < nw; iw++)
+    if (recompute[iw])
+    {
+      auto& wfc = wfc_list.getCastedElement<J2OMPTarget<FT>>(iw);
+      wfc.recompute(p_list[iw]);
+      wfc.steps_since_recompute_ = 0;
+      // fresh sums carry no error
+      std::fill_n(mw_allUat_comp.data() + iw * N_padded, N_padded, 0);
+      std::fill_n(mw_allUat_comp.data() + nw * N_padded + iw * N_padded * DIM, N_padded * DIM, 0);
+      std::fill_n(mw_allUat_comp.data() + nw * N_padded * (DIM + 1) + iw * N_padded, N_padded, 0);
+    }
+  // only the Uat, dUat and d2Uat of the recomputed walkers changed on the host
+  for (int iw = 0; iw < nw; iw++)
     if (recompute[iw])
-      wfc_list[iw].recompute(p_list[iw]);
-  wfc_leader.mw_mem_->mw_allUat.updateTo();
+      for (auto* buffer : {&mw_allUat, &mw_allUat_comp})
+      {
+        buffer->updateTo(N_padded, iw * N_padded);
+        buffer->updateTo(N_padded * DIM, nw * N_padded + iw * N_padded * DIM);
+        buffer->updateTo(N_padded, nw * N_padded * (DIM + 1) + iw * N_padded);
+      }
 }
 
 template<typename FT>
@@ -782,6 +811,20 @@ void J2OMPTarget<FT>::mw_evaluateGL(const RefVectorWithLeader<WaveFunctionCompon
     const std::vector<bool> recompute_all(wfc_list.size(), true);
     mw_recompute(wfc_list, p_list, recompute_all);
   }
+  else if (steps_between_recompute_ > 0)
+  {
+    // bound the drift of the incremental updates by forcing a recompute every steps_between_recompute_ calls
+    std::vector<bool> recompute_due(wfc_list.size(), false);
+    bool any_due = false;
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      auto& wfc = wfc_list.getCastedElement<J2OMPTarget<FT>>(iw);
+      if (++wfc.steps_since_recompute_ >= steps_between_recompute_)
+        recompute_due[iw] = any_due = true;
+    }
+    if (any_due)
+      mw_recompute(wfc_list, p_list, recompute_due);
+  }
 
   for (int iw = 0; iw < wfc_list.size(); iw++)
   {
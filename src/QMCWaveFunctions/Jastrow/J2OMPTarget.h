@@ -108,6 +108,11 @@ private:
 
   std::unique_ptr<J2OMPTargetMultiWalkerMem<RealType>> mw_mem_;
 
+  /// force mw_recompute after this many mw_evaluateGL calls without one. 0 disables.
+  int steps_between_recompute_;
+  /// mw_evaluateGL calls since the last recompute of this walker
+  int steps_since_recompute_;
+
   void resizeWFOptVectors()
   {
     dLogPsi.resize(myVars.size());
@@ -237,6 +242,12 @@ public:
 
   const std::vector<FT*>& getPairFunctions() const { return F; }
 
+  /** set how often the batched evaluateGL forces a recompute of Uat, dUat and d2Uat
+   * @param steps the number of calls between forced recomputes, 0 disables it
+   */
+  void setStepsBetweenRecompute(int steps) { steps_between_recompute_ = steps; }
+  int getStepsBetweenRecompute() const { return steps_between_recompute_; }
+
   QTFull::RealType computeGL(ParticleSet::ParticleGradient& G, ParticleSet::ParticleLaplacian& L) const;
 
   void evaluateDerivatives(ParticleSet& P,
@@ -562,6 +562,92 @@ void J2OrbitalSoA<FT>::evaluateDerivatives(ParticleSet& P,
   }
 }
 
+template<typename FT>
+void J2OrbitalSoA<FT>::mw_evaluateParameterDerivatives(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                       const RefVectorWithLeader<ParticleSet>& p_list,
+                                                       const opt_variables_type& optvars,
+                                                       RecordArray<ValueType>& dlogpsi,
+                                                       RecordArray<ValueType>& dhpsioverpsi) const
+{
+  assert(this == &wfc_list.getLeader());
+  const size_t NumVars = myVars.size();
+  if (NumVars == 0)
+    return;
+
+  bool recalculate(false);
+  std::vector<bool> rcsingles(NumVars, false);
+  for (int k = 0; k < NumVars; ++k)
+  {
+    int kk = myVars.where(k);
+    if (kk < 0)
+      continue;
+    if (optvars.recompute(kk))
+      recalculate = true;
+    rcsingles[k] = true;
+  }
+  if (!recalculate)
+    return;
+
+  ///precomputed recalculation switch
+  std::vector<bool> RecalcSwitch(F.size(), false);
+  for (int i = 0; i < F.size(); ++i)
+    if (OffSet[i].first >= 0)
+      for (int rcs = OffSet[i].first; rcs < OffSet[i].second; rcs++)
+        if (rcsingles[rcs])
+          RecalcSwitch[i] = true;
+
+  std::vector<TinyVector<RealType, 3>> derivs(NumVars);
+  std::vector<ValueType> dLogPsi_w(NumVars);
+  std::vector<ValueType> dHPsi_w(NumVars);
+  constexpr RealType cone(1);
+  constexpr RealType lapfac(OHMMS_DIM - cone);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    const auto& j2       = wfc_list.template getCastedElement<J2OrbitalSoA<FT>>(iw);
+    const ParticleSet& P = p_list[iw];
+    const auto& d_table  = P.getDistTableAA(my_table_ID_);
+    const size_t n       = d_table.sources();
+    const size_t ng      = P.groups();
+    std::fill(dLogPsi_w.begin(), dLogPsi_w.end(), 0.0);
+    std::fill(dHPsi_w.begin(), dHPsi_w.end(), 0.0);
+    for (size_t i = 1; i < n; ++i)
+    {
+      const size_t ig   = P.GroupID[i] * ng;
+      const auto& dist  = d_table.getDistRow(i);
+      const auto& displ = d_table.getDisplRow(i);
+      for (size_t j = 0; j < i; ++j)
+      {
+        const size_t ptype = ig + P.GroupID[j];
+        if (!RecalcSwitch[ptype])
+          continue;
+        std::fill(derivs.begin(), derivs.end(), 0.0);
+        if (!j2.F[ptype]->evaluateDerivatives(dist[j], derivs))
+          continue;
+        const RealType rinv(cone / dist[j]);
+        const PosType dr(displ[j]);
+        // -0.5 * (lap_i + lap_j) - G_i . gr + G_j . gr of the gradient and laplacian arrays of evaluateDerivatives
+        const auto dG = P.G[i] - P.G[j];
+        for (int p = OffSet[ptype].first, ip = 0; p < OffSet[ptype].second; ++p, ++ip)
+        {
+          const RealType dudr(rinv * derivs[ip][1]);
+          const RealType lap(derivs[ip][2] + lapfac * dudr);
+          const PosType gr(dudr * dr);
+          dLogPsi_w[p] -= derivs[ip][0];
+          dHPsi_w[p] += lap - ValueType(dot(dG, gr));
+        }
+      }
+    }
+    for (int k = 0; k < NumVars; ++k)
+    {
+      int kk = myVars.where(k);
+      if (kk < 0 || !rcsingles[k])
+        continue;
+      dlogpsi.setValue(kk, iw, dlogpsi.getValue(kk, iw) + dLogPsi_w[k]);
+      dhpsioverpsi.setValue(kk, iw, dhpsioverpsi.getValue(kk, iw) + dHPsi_w[k]);
+    }
+  }
+}
+
 template<typename FT>
 void J2OrbitalSoA<FT>::evaluateDerivativesWF(ParticleSet& P,
                                              const opt_variables_type& active,
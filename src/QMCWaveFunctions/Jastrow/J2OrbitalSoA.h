@@ -204,6 +204,15 @@ public:
                              const opt_variables_type& active,
                              std::vector<ValueType>& dlogpsi) override;
 
+  /** fused pair kernel, accumulates the derivatives of every walker directly
+   *  without the per-parameter gradient and laplacian arrays of evaluateDerivatives
+   */
+  void mw_evaluateParameterDerivatives(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                       const RefVectorWithLeader<ParticleSet>& p_list,
+                                       const opt_variables_type& optvars,
+                                       RecordArray<ValueType>& dlogpsi,
+                                       RecordArray<ValueType>& dhpsioverpsi) const override;
+
   void evaluateDerivRatios(const VirtualParticleSet& VP,
                            const opt_variables_type& optvars,
                            std::vector<ValueType>& ratios,
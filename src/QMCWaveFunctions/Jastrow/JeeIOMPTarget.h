@@ -0,0 +1,670 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_EEIJASTROW_OMPTARGET_H
+#define QMCPLUSPLUS_EEIJASTROW_OMPTARGET_H
+
+#include "JeeIOrbitalSoA.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "OMPTarget/OffloadAlignedAllocators.hpp"
+#include "ResourceCollection.h"
+
+namespace qmcplusplus
+{
+template<typename T>
+struct JeeIOMPTargetMultiWalkerMem : public Resource
+{
+  /// functor ids of the (ion, electron, electron) group triplets, -1 if missing, and {gamma offset, N_eI, N_ee, C}
+  Vector<int, OffloadPinnedAllocator<int>> mw_functor_index;
+  /// L = cutoff_radius/2 of each functor followed by the packed gamma coefficients
+  Vector<T, OffloadPinnedAllocator<T>> mw_coefs;
+  /// memory pool for Uat, dUat, d2Uat [Nw][N_padded] + [Nw][DIM][N_padded] + [Nw][N_padded]
+  Vector<T, OffloadPinnedAllocator<T>> mw_allUat;
+  /** e-I distances and displacements of all the electrons [Nw][Nion][DIM+1][N_padded].
+   * It replaces the compact lists of JeeIOrbitalSoA on the device and is only updated there between transfers.
+   */
+  Vector<T, OffloadPinnedAllocator<T>> mw_eI;
+  /// per walker slot, Uat, dUat, d2Uat and the e-I table on the device are out of date since acquireResource
+  std::vector<bool> stale_slots;
+  /// fused buffer of the e-I data of the proposed positions [nw][DIM+1][Nion_padded] and the walker slots [nw]
+  Vector<char, OffloadPinnedAllocator<char>> mw_ratiograd_buffer;
+  /// indices of the accepted walkers for mw_accept_rejectMove
+  Vector<int, OffloadPinnedAllocator<int>> mw_update_buffer;
+  // multi walker result for V, G and L of the moved electron
+  Matrix<T, OffloadPinnedAllocator<T>> mw_vgl;
+  /// contributions of the proposed positions to the other electrons [nw][DIM+2][N_padded]. Only lives on the device.
+  Vector<T, OffloadPinnedAllocator<T>> mw_cur_allu;
+
+  JeeIOMPTargetMultiWalkerMem() : Resource("JeeIOMPTargetMultiWalkerMem") {}
+
+  JeeIOMPTargetMultiWalkerMem(const JeeIOMPTargetMultiWalkerMem&) : JeeIOMPTargetMultiWalkerMem() {}
+
+  Resource* makeClone() const override { return new JeeIOMPTargetMultiWalkerMem(*this); }
+};
+
+/** @ingroup WaveFunctionComponent
+ *  @brief three-body eeI Jastrow with the batched particle-by-particle moves offloaded
+ *
+ * The functor coefficients, Uat, dUat, d2Uat and the e-I distances of all the walkers of a crowd live in a multi walker
+ * resource. mw_calcRatio and mw_ratioGrad run one kernel computing the value, gradient and laplacian of the moved
+ * electron and its contributions to the other electrons.
+ * mw_accept_rejectMove updates Uat, dUat and d2Uat on the device.
+ * The polynomial is evaluated without the optional table on the device.
+ * The single walker APIs and the compact lists of JeeIOrbitalSoA stay valid on the host.
+ * FT must provide gamma, N_eI, N_ee, C and evaluateVGL_impl as PolynomialFunctor3D does.
+ */
+template<class FT>
+class JeeIOMPTarget : public JeeIOrbitalSoA<FT>
+{
+  using Base         = JeeIOrbitalSoA<FT>;
+  using valT         = typename Base::valT;
+  using RealType     = WaveFunctionComponent::RealType;
+  using PsiValueType = WaveFunctionComponent::PsiValueType;
+  using GradType     = WaveFunctionComponent::GradType;
+  using Base::d2Uat;
+  using Base::dUat;
+  using Base::eGroups;
+  using Base::ee_Table_ID_;
+  using Base::ei_Table_ID_;
+  using Base::F;
+  using Base::iGroups;
+  using Base::Nelec;
+  using Base::Nelec_padded;
+  using Base::Nion;
+  using Base::Uat;
+
+  /// ion group ids followed by electron group ids
+  Vector<int, OffloadPinnedAllocator<int>> grp_ids_;
+  /// slot of this walker in the multi walker resource
+  int walker_slot_;
+  std::unique_ptr<JeeIOMPTargetMultiWalkerMem<valT>> mw_mem_;
+
+  /// pack the coefficients of the unique functors and the functor lookup table and transfer them
+  void packFunctors(JeeIOMPTargetMultiWalkerMem<valT>& mw_mem) const
+  {
+    const int num_triplets = iGroups * eGroups * eGroups;
+    std::vector<const FT*> unique_functors;
+    std::map<const FT*, int> functor_ids;
+    std::vector<int> triplet_ids(num_triplets, -1);
+    for (int i = 0; i < num_triplets; i++)
+      if (const FT* f = F.data()[i]; f != nullptr)
+      {
+        auto it = functor_ids.find(f);
+        if (it == functor_ids.end())
+        {
+          it = functor_ids.emplace(f, unique_functors.size()).first;
+          unique_functors.push_back(f);
+        }
+        triplet_ids[i] = it->second;
+      }
+
+    const int num_functors = unique_functors.size();
+    auto& index            = mw_mem.mw_functor_index;
+    auto& coefs            = mw_mem.mw_coefs;
+    index.resize(num_triplets + 4 * num_functors);
+    std::copy(triplet_ids.begin(), triplet_ids.end(), index.begin());
+    size_t num_coefs = num_functors;
+    for (const FT* f : unique_functors)
+      num_coefs += f->gamma.size();
+    coefs.resize(num_coefs);
+
+    size_t offset = num_functors;
+    for (int ifunc = 0; ifunc < num_functors; ifunc++)
+    {
+      const FT& f                         = *unique_functors[ifunc];
+      coefs[ifunc]                        = 0.5 * f.cutoff_radius;
+      index[num_triplets + ifunc * 4]     = offset;
+      index[num_triplets + ifunc * 4 + 1] = f.N_eI;
+      index[num_triplets + ifunc * 4 + 2] = f.N_ee;
+      index[num_triplets + ifunc * 4 + 3] = f.C;
+      std::copy_n(f.gamma.data(), f.gamma.size(), coefs.data() + offset);
+      offset += f.gamma.size();
+    }
+    index.updateTo();
+    coefs.updateTo();
+  }
+
+  /// copy the e-I table of the host to the slot of this walker and transfer the slot with Uat, dUat and d2Uat
+  void updateDeviceSlot(const ParticleSet& P, JeeIOMPTargetMultiWalkerMem<valT>& mw_mem) const
+  {
+    const size_t np        = Nelec_padded;
+    const size_t nslots    = mw_mem.mw_allUat.size() / (np * (OHMMS_DIM + 2));
+    const size_t eI_stride = Nion * (OHMMS_DIM + 1) * np;
+    const auto& eI_table   = P.getDistTableAB(ei_Table_ID_);
+    valT* eI               = mw_mem.mw_eI.data() + walker_slot_ * eI_stride;
+    for (int jel = 0; jel < Nelec; jel++)
+    {
+      const auto& dist  = eI_table.getDistRow(jel);
+      const auto& displ = eI_table.getDisplRow(jel);
+      for (int ion = 0; ion < Nion; ion++)
+      {
+        eI[ion * (OHMMS_DIM + 1) * np + jel] = dist[ion];
+        for (int idim = 0; idim < OHMMS_DIM; idim++)
+          eI[(ion * (OHMMS_DIM + 1) + idim + 1) * np + jel] = displ.data(idim)[ion];
+      }
+    }
+    mw_mem.mw_eI.updateTo(eI_stride, walker_slot_ * eI_stride);
+    mw_mem.mw_allUat.updateTo(np, walker_slot_ * np);
+    mw_mem.mw_allUat.updateTo(np * OHMMS_DIM, nslots * np + walker_slot_ * np * OHMMS_DIM);
+    mw_mem.mw_allUat.updateTo(np, nslots * np * (OHMMS_DIM + 1) + walker_slot_ * np);
+  }
+
+  /// bring the stale walker slots of the device up to date after acquireResource
+  static void syncDevice(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                         const RefVectorWithLeader<ParticleSet>& p_list)
+  {
+    auto& mw_mem = *wfc_list.getCastedLeader<JeeIOMPTarget<FT>>().mw_mem_;
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      auto& wfc = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw);
+      if (mw_mem.stale_slots[wfc.walker_slot_])
+      {
+        wfc.updateDeviceSlot(p_list[iw], mw_mem);
+        mw_mem.stale_slots[wfc.walker_slot_] = false;
+      }
+    }
+  }
+
+  /** compute the value, gradient and laplacian of the proposed move of iat into mw_vgl
+   * The contributions of the proposed positions to the other electrons stay on the device in mw_cur_allu.
+   */
+  void mw_evaluateVGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                      const RefVectorWithLeader<ParticleSet>& p_list,
+                      int iat) const
+  {
+    constexpr unsigned DIM = OHMMS_DIM;
+    static_assert(DIM == 3, "only support 3D due to explicit x,y,z coded.");
+    auto& wfc_leader      = wfc_list.getCastedLeader<JeeIOMPTarget<FT>>();
+    auto& mw_mem          = *wfc_leader.mw_mem_;
+    auto& p_leader        = p_list.getLeader();
+    const auto& ee_leader = p_leader.getDistTableAA(ee_Table_ID_);
+    const int nw          = wfc_list.size();
+
+    syncDevice(wfc_list, p_list);
+
+    const size_t np          = Nelec_padded;
+    const size_t ee_padded   = getAlignedSize<RealType>(Nelec);
+    const size_t ee_stride   = ee_padded * (DIM + 1);
+    const size_t nion_padded = getAlignedSize<valT>(Nion);
+    const size_t eI_stride   = Nion * (DIM + 1) * np;
+
+    // the e-I data of the proposed positions are only computed on the host
+    auto& buffer           = mw_mem.mw_ratiograd_buffer;
+    const size_t eI_nbytes = sizeof(valT) * nw * (DIM + 1) * nion_padded;
+    buffer.resize(eI_nbytes + sizeof(int) * nw);
+    valT* eI_new_all = reinterpret_cast<valT*>(buffer.data());
+    int* slots       = reinterpret_cast<int*>(buffer.data() + eI_nbytes);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      const auto& eI_table = p_list[iw].getDistTableAB(ei_Table_ID_);
+      const auto& dist     = eI_table.getTempDists();
+      const auto& displ    = eI_table.getTempDispls();
+      valT* eI_new         = eI_new_all + iw * (DIM + 1) * nion_padded;
+      std::copy_n(dist.data(), Nion, eI_new);
+      for (int idim = 0; idim < DIM; idim++)
+        std::copy_n(displ.data(idim), Nion, eI_new + (idim + 1) * nion_padded);
+      slots[iw] = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw).walker_slot_;
+    }
+
+    auto& mw_vgl = mw_mem.mw_vgl;
+    mw_vgl.resize(nw, DIM + 2);
+
+    const int nelec         = Nelec;
+    const int nion          = Nion;
+    const int num_egroups   = eGroups;
+    const int jg            = p_leader.GroupID[iat];
+    const int num_triplets  = iGroups * eGroups * eGroups;
+    const size_t grp_size   = grp_ids_.size();
+    const size_t index_size = mw_mem.mw_functor_index.size();
+    const size_t coefs_size = mw_mem.mw_coefs.size();
+    const size_t eI_size    = mw_mem.mw_eI.size();
+    const size_t buf_size   = buffer.size();
+
+    auto* buffer_ptr      = buffer.data();
+    const int* grp_ptr    = grp_ids_.data();
+    const int* index_ptr  = mw_mem.mw_functor_index.data();
+    const valT* coefs_ptr = mw_mem.mw_coefs.data();
+    const valT* eI_ptr    = mw_mem.mw_eI.data();
+    const RealType* ee    = ee_leader.getMultiWalkerTempDataPtr();
+    valT* cur_allu_ptr    = mw_mem.mw_cur_allu.data();
+    valT* vgl_ptr         = mw_vgl.data();
+
+    PRAGMA_OFFLOAD("omp target teams distribute map(always, to: buffer_ptr[:buf_size]) \
+                    map(to: grp_ptr[:grp_size], index_ptr[:index_size], coefs_ptr[:coefs_size]) \
+                    map(to: ee[:ee_stride * nw], eI_ptr[:eI_size]) \
+                    map(from: cur_allu_ptr[:np * (DIM + 2) * nw]) \
+                    map(always, from: vgl_ptr[:(DIM + 2) * nw])")
+    for (int iw = 0; iw < nw; iw++)
+    {
+      const valT* eI_new     = reinterpret_cast<const valT*>(buffer_ptr) + iw * (DIM + 1) * nion_padded;
+      const int slot         = reinterpret_cast<const int*>(buffer_ptr + eI_nbytes)[iw];
+      const valT* eI_all     = eI_ptr + slot * eI_stride;
+      const RealType* ee_new = ee + iw * ee_stride;
+      valT* cur_allu         = cur_allu_ptr + iw * np * (DIM + 2);
+
+      valT val_sum(0);
+      valT grad_x(0);
+      valT grad_y(0);
+      valT grad_z(0);
+      valT lapl(0);
+
+      PRAGMA_OFFLOAD("omp parallel for reduction(+: val_sum, grad_x, grad_y, grad_z, lapl)")
+      for (int kel = 0; kel < nelec; kel++)
+      {
+        valT u(0), du_x(0), du_y(0), du_z(0), d2u(0);
+        if (kel != iat)
+        {
+          const valT r_jk  = ee_new[kel];
+          const valT jk_x  = ee_new[ee_padded + kel];
+          const valT jk_y  = ee_new[ee_padded * 2 + kel];
+          const valT jk_z  = ee_new[ee_padded * 3 + kel];
+          const int* f_ids = index_ptr + (jg * num_egroups + grp_ptr[nion + kel]);
+          for (int ion = 0; ion < nion; ion++)
+          {
+            const int ifunc = f_ids[grp_ptr[ion] * num_egroups * num_egroups];
+            if (ifunc < 0)
+              continue;
+            const valT L      = coefs_ptr[ifunc];
+            const valT r_jI   = eI_new[ion];
+            const valT* eI_kI = eI_all + ion * (DIM + 1) * np;
+            const valT r_kI   = eI_kI[kel];
+            if (r_jI >= L || r_kI >= L)
+              continue;
+            const int* f = index_ptr + num_triplets + ifunc * 4;
+            valT v, g0, g1, g2, h00, h11, h22, h01, h02;
+            FT::evaluateVGL_impl(coefs_ptr + f[0], f[1], f[2], f[3], L, r_jk, r_jI, r_kI, v, g0, g1, g2, h00, h11, h22,
+                                 h01, h02);
+            g0 /= r_jk;
+            g1 /= r_jI;
+            g2 /= r_kI;
+            h01 /= r_jk * r_jI;
+            h02 /= r_jk * r_kI;
+            const valT jI_x = eI_new[nion_padded + ion];
+            const valT jI_y = eI_new[nion_padded * 2 + ion];
+            const valT jI_z = eI_new[nion_padded * 3 + ion];
+            const valT kI_x = eI_kI[np + kel];
+            const valT kI_y = eI_kI[np * 2 + kel];
+            const valT kI_z = eI_kI[np * 3 + kel];
+            constexpr valT lapfac(DIM - 1);
+            // contribution to the moved electron
+            val_sum += v;
+            grad_x += g0 * jk_x + g1 * jI_x;
+            grad_y += g0 * jk_y + g1 * jI_y;
+            grad_z += g0 * jk_z + g1 * jI_z;
+            lapl += h00 + h11 + lapfac * (g0 + g1) + valT(2) * h01 * (jk_x * jI_x + jk_y * jI_y + jk_z * jI_z);
+            // contribution to kel
+            u += v;
+            du_x += kI_x * g2 - jk_x * g0;
+            du_y += kI_y * g2 - jk_y * g0;
+            du_z += kI_z * g2 - jk_z * g0;
+            d2u -= h00 + h22 + lapfac * (g0 + g2) - valT(2) * h02 * (kI_x * jk_x + kI_y * jk_y + kI_z * jk_z);
+          }
+        }
+        cur_allu[kel]          = u;
+        cur_allu[np + kel]     = du_x;
+        cur_allu[np * 2 + kel] = du_y;
+        cur_allu[np * 3 + kel] = du_z;
+        cur_allu[np * 4 + kel] = d2u;
+      }
+
+      valT* vgl = vgl_ptr + iw * (DIM + 2);
+      vgl[0]    = val_sum;
+      vgl[1]    = grad_x;
+      vgl[2]    = grad_y;
+      vgl[3]    = grad_z;
+      vgl[4]    = -lapl;
+    }
+  }
+
+  /** remove the contributions of the old positions of iat, add those of the accepted ones on the device
+   * and update the e-I table with the accepted positions.
+   */
+  void mw_updateVGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    const std::vector<bool>& isAccepted) const
+  {
+    constexpr unsigned DIM = OHMMS_DIM;
+    auto& wfc_leader       = wfc_list.getCastedLeader<JeeIOMPTarget<FT>>();
+    auto& mw_mem           = *wfc_leader.mw_mem_;
+    auto& p_leader         = p_list.getLeader();
+    const auto& ee_leader  = p_leader.getDistTableAA(ee_Table_ID_);
+    const int nw           = wfc_list.size();
+
+    auto& accepted = mw_mem.mw_update_buffer;
+    accepted.resize(nw);
+    int nw_accepted = 0;
+    for (int iw = 0; iw < nw; iw++)
+      if (isAccepted[iw])
+        accepted[nw_accepted++] = iw;
+    if (nw_accepted == 0)
+      return;
+
+    const size_t np          = Nelec_padded;
+    const size_t nslots      = mw_mem.mw_allUat.size() / (np * (DIM + 2));
+    const size_t ee_padded   = getAlignedSize<RealType>(Nelec);
+    const size_t ee_stride   = ee_padded * (DIM + 1);
+    const size_t nion_padded = getAlignedSize<valT>(Nion);
+    const size_t eI_stride   = Nion * (DIM + 1) * np;
+    const size_t eI_nbytes   = sizeof(valT) * nw * (DIM + 1) * nion_padded;
+
+    const int nelec         = Nelec;
+    const int nion          = Nion;
+    const int num_egroups   = eGroups;
+    const int jg            = p_leader.GroupID[iat];
+    const int num_triplets  = iGroups * eGroups * eGroups;
+    const size_t grp_size   = grp_ids_.size();
+    const size_t index_size = mw_mem.mw_functor_index.size();
+    const size_t coefs_size = mw_mem.mw_coefs.size();
+    const size_t eI_size    = mw_mem.mw_eI.size();
+    const size_t Uat_size   = mw_mem.mw_allUat.size();
+    const size_t buf_size   = mw_mem.mw_ratiograd_buffer.size();
+
+    auto* accepted_ptr       = accepted.data();
+    const auto* buffer_ptr   = mw_mem.mw_ratiograd_buffer.data();
+    const int* grp_ptr       = grp_ids_.data();
+    const int* index_ptr     = mw_mem.mw_functor_index.data();
+    const valT* coefs_ptr    = mw_mem.mw_coefs.data();
+    valT* eI_ptr             = mw_mem.mw_eI.data();
+    const RealType* ee       = ee_leader.getMultiWalkerTempDataPtr();
+    const valT* cur_allu_ptr = mw_mem.mw_cur_allu.data();
+    const valT* vgl_ptr      = mw_mem.mw_vgl.data();
+    valT* Uat_ptr            = mw_mem.mw_allUat.data();
+
+    PRAGMA_OFFLOAD("omp target teams distribute map(always, to: accepted_ptr[:nw_accepted]) \
+                    map(to: buffer_ptr[:buf_size], vgl_ptr[:(DIM + 2) * nw], cur_allu_ptr[:np * (DIM + 2) * nw]) \
+                    map(to: grp_ptr[:grp_size], index_ptr[:index_size], coefs_ptr[:coefs_size]) \
+                    map(to: ee[:ee_stride * nw * 2], eI_ptr[:eI_size]) \
+                    map(always, from: Uat_ptr[:Uat_size])")
+    for (int i = 0; i < nw_accepted; i++)
+    {
+      const int iw           = accepted_ptr[i];
+      const valT* eI_new     = reinterpret_cast<const valT*>(buffer_ptr) + iw * (DIM + 1) * nion_padded;
+      const int slot         = reinterpret_cast<const int*>(buffer_ptr + eI_nbytes)[iw];
+      valT* eI_all           = eI_ptr + slot * eI_stride;
+      const RealType* ee_old = ee + (iw + nw) * ee_stride;
+      const valT* cur_allu   = cur_allu_ptr + iw * np * (DIM + 2);
+
+      valT* Uat    = Uat_ptr + slot * np;
+      valT* dUat_x = Uat_ptr + nslots * np + slot * np * DIM;
+      valT* dUat_y = dUat_x + np;
+      valT* dUat_z = dUat_y + np;
+      valT* d2Uat  = Uat_ptr + nslots * np * (DIM + 1) + slot * np;
+
+      PRAGMA_OFFLOAD("omp parallel for")
+      for (int kel = 0; kel < nelec; kel++)
+      {
+        if (kel == iat)
+          continue;
+        // contributions of the old position
+        valT u(0), du_x(0), du_y(0), du_z(0), d2u(0);
+        const valT r_jk  = ee_old[kel];
+        const valT jk_x  = ee_old[ee_padded + kel];
+        const valT jk_y  = ee_old[ee_padded * 2 + kel];
+        const valT jk_z  = ee_old[ee_padded * 3 + kel];
+        const int* f_ids = index_ptr + (jg * num_egroups + grp_ptr[nion + kel]);
+        for (int ion = 0; ion < nion; ion++)
+        {
+          const int ifunc = f_ids[grp_ptr[ion] * num_egroups * num_egroups];
+          if (ifunc < 0)
+            continue;
+          const valT L      = coefs_ptr[ifunc];
+          const valT* eI_kI = eI_all + ion * (DIM + 1) * np;
+          const valT r_jI   = eI_kI[iat];
+          const valT r_kI   = eI_kI[kel];
+          if (r_jI >= L || r_kI >= L)
+            continue;
+          const int* f = index_ptr + num_triplets + ifunc * 4;
+          valT v, g0, g1, g2, h00, h11, h22, h01, h02;
+          FT::evaluateVGL_impl(coefs_ptr + f[0], f[1], f[2], f[3], L, r_jk, r_jI, r_kI, v, g0, g1, g2, h00, h11, h22,
+                               h01, h02);
+          g0 /= r_jk;
+          g2 /= r_kI;
+          h02 /= r_jk * r_kI;
+          const valT kI_x = eI_kI[np + kel];
+          const valT kI_y = eI_kI[np * 2 + kel];
+          const valT kI_z = eI_kI[np * 3 + kel];
+          constexpr valT lapfac(DIM - 1);
+          u += v;
+          du_x += kI_x * g2 - jk_x * g0;
+          du_y += kI_y * g2 - jk_y * g0;
+          du_z += kI_z * g2 - jk_z * g0;
+          d2u -= h00 + h22 + lapfac * (g0 + g2) - valT(2) * h02 * (kI_x * jk_x + kI_y * jk_y + kI_z * jk_z);
+        }
+        Uat[kel] += cur_allu[kel] - u;
+        dUat_x[kel] += cur_allu[np + kel] - du_x;
+        dUat_y[kel] += cur_allu[np * 2 + kel] - du_y;
+        dUat_z[kel] += cur_allu[np * 3 + kel] - du_z;
+        d2Uat[kel] += cur_allu[np * 4 + kel] - d2u;
+      }
+
+      const valT* vgl = vgl_ptr + iw * (DIM + 2);
+      Uat[iat]        = vgl[0];
+      dUat_x[iat]     = vgl[1];
+      dUat_y[iat]     = vgl[2];
+      dUat_z[iat]     = vgl[3];
+      d2Uat[iat]      = vgl[4];
+
+      // all the old contributions are removed, the e-I data of iat can be replaced
+      PRAGMA_OFFLOAD("omp parallel for")
+      for (int ion = 0; ion < nion; ion++)
+        for (int idim = 0; idim < DIM + 1; idim++)
+          eI_all[(ion * (DIM + 1) + idim) * np + iat] = eI_new[idim * nion_padded + ion];
+    }
+  }
+
+public:
+  JeeIOMPTarget(const std::string& obj_name, const ParticleSet& ions, ParticleSet& elecs)
+      : Base("JeeIOMPTarget", obj_name, ions, elecs), walker_slot_(-1)
+  {
+    grp_ids_.resize(Nion + Nelec);
+    std::copy_n(ions.GroupID.begin(), Nion, grp_ids_.begin());
+    std::copy_n(elecs.GroupID.begin(), Nelec, grp_ids_.begin() + Nion);
+    grp_ids_.updateTo();
+  }
+
+  std::unique_ptr<WaveFunctionComponent> makeClone(ParticleSet& elecs) const override
+  {
+    auto eeIcopy = std::make_unique<JeeIOMPTarget<FT>>(this->myName, this->Ions, elecs);
+    this->copyFunctorsTo(*eeIcopy);
+    return eeIcopy;
+  }
+
+  void createResource(ResourceCollection& collection) const override
+  {
+    collection.addResource(std::make_unique<JeeIOMPTargetMultiWalkerMem<valT>>());
+  }
+
+  void acquireResource(ResourceCollection& collection,
+                       const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override
+  {
+    auto& wfc_leader = wfc_list.getCastedLeader<JeeIOMPTarget<FT>>();
+    auto res_ptr     = dynamic_cast<JeeIOMPTargetMultiWalkerMem<valT>*>(collection.lendResource().release());
+    if (!res_ptr)
+      throw std::runtime_error("JeeIOMPTarget::acquireResource dynamic_cast failed");
+    wfc_leader.mw_mem_.reset(res_ptr);
+    auto& mw_mem    = *wfc_leader.mw_mem_;
+    const size_t nw = wfc_list.size();
+    const size_t np = Nelec_padded;
+    auto& mw_allUat = mw_mem.mw_allUat;
+    mw_allUat.resize(np * (OHMMS_DIM + 2) * nw);
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      // copy per walker Uat, dUat, d2Uat to shared buffer and attach buffer
+      auto& wfc        = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw);
+      wfc.walker_slot_ = iw;
+
+      Vector<valT> Uat_view(mw_allUat.data() + iw * np, Nelec);
+      Uat_view = wfc.Uat;
+      wfc.Uat.free();
+      wfc.Uat.attachReference(mw_allUat.data() + iw * np, Nelec);
+
+      typename Base::gContainer_type dUat_view(mw_allUat.data() + nw * np + iw * np * OHMMS_DIM, Nelec, np);
+      dUat_view = wfc.dUat;
+      wfc.dUat.free();
+      wfc.dUat.attachReference(Nelec, np, mw_allUat.data() + nw * np + iw * np * OHMMS_DIM);
+
+      Vector<valT> d2Uat_view(mw_allUat.data() + nw * np * (OHMMS_DIM + 1) + iw * np, Nelec);
+      d2Uat_view = wfc.d2Uat;
+      wfc.d2Uat.free();
+      wfc.d2Uat.attachReference(mw_allUat.data() + nw * np * (OHMMS_DIM + 1) + iw * np, Nelec);
+    }
+    mw_mem.mw_eI.resize(Nion * (OHMMS_DIM + 1) * np * nw);
+    mw_mem.mw_cur_allu.resize(np * (OHMMS_DIM + 2) * nw);
+    mw_mem.stale_slots.assign(nw, true);
+    packFunctors(mw_mem);
+  }
+
+  void releaseResource(ResourceCollection& collection,
+                       const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override
+  {
+    auto& wfc_leader = wfc_list.getCastedLeader<JeeIOMPTarget<FT>>();
+    const size_t nw  = wfc_list.size();
+    const size_t np  = Nelec_padded;
+    auto& mw_allUat  = wfc_leader.mw_mem_->mw_allUat;
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      // detach buffer and copy per walker Uat, dUat, d2Uat from shared buffer
+      auto& wfc        = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw);
+      wfc.walker_slot_ = -1;
+
+      Vector<valT> Uat_view(mw_allUat.data() + iw * np, Nelec);
+      wfc.Uat.free();
+      wfc.Uat.resize(Nelec);
+      wfc.Uat = Uat_view;
+
+      typename Base::gContainer_type dUat_view(mw_allUat.data() + nw * np + iw * np * OHMMS_DIM, Nelec, np);
+      wfc.dUat.free();
+      wfc.dUat.resize(Nelec);
+      wfc.dUat = dUat_view;
+
+      Vector<valT> d2Uat_view(mw_allUat.data() + nw * np * (OHMMS_DIM + 1) + iw * np, Nelec);
+      wfc.d2Uat.free();
+      wfc.d2Uat.resize(Nelec);
+      wfc.d2Uat = d2Uat_view;
+    }
+    collection.takebackResource(std::move(wfc_leader.mw_mem_));
+  }
+
+  void mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios) const override
+  {
+    assert(this == &wfc_list.getLeader());
+    mw_evaluateVGL(wfc_list, p_list, iat);
+
+    const auto& mw_vgl = wfc_list.getCastedLeader<JeeIOMPTarget<FT>>().mw_mem_->mw_vgl;
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      auto& wfc      = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw);
+      wfc.cur_Uat    = mw_vgl[iw][0];
+      wfc.UpdateMode = WaveFunctionComponent::ORB_PBYP_RATIO;
+      ratios[iw]     = std::exp(static_cast<PsiValueType>(wfc.Uat[iat] - wfc.cur_Uat));
+    }
+  }
+
+  void mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new) const override
+  {
+    assert(this == &wfc_list.getLeader());
+    mw_evaluateVGL(wfc_list, p_list, iat);
+
+    const auto& mw_vgl = wfc_list.getCastedLeader<JeeIOMPTarget<FT>>().mw_mem_->mw_vgl;
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      auto& wfc      = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw);
+      wfc.cur_Uat    = mw_vgl[iw][0];
+      wfc.UpdateMode = WaveFunctionComponent::ORB_PBYP_PARTIAL;
+      ratios[iw]     = std::exp(static_cast<PsiValueType>(wfc.Uat[iat] - wfc.cur_Uat));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        grad_new[iw][idim] += mw_vgl[iw][idim + 1];
+    }
+  }
+
+  void mw_accept_rejectMove(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                            const RefVectorWithLeader<ParticleSet>& p_list,
+                            int iat,
+                            const std::vector<bool>& isAccepted,
+                            bool safe_to_delay = false) const override
+  {
+    assert(this == &wfc_list.getLeader());
+    const auto& mw_vgl = wfc_list.getCastedLeader<JeeIOMPTarget<FT>>().mw_mem_->mw_vgl;
+    const int nw       = wfc_list.size();
+    for (int iw = 0; iw < nw; iw++)
+      if (isAccepted[iw])
+      {
+        auto& wfc = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw);
+        wfc.log_value_ += wfc.Uat[iat] - mw_vgl[iw][0];
+      }
+
+    mw_updateVGL(wfc_list, p_list, iat, isAccepted);
+
+    // keep the compact lists of the host in sync for the single walker APIs
+#pragma omp parallel for
+    for (int iw = 0; iw < nw; iw++)
+      if (isAccepted[iw])
+      {
+        auto& wfc            = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw);
+        const auto& eI_table = p_list[iw].getDistTableAB(ei_Table_ID_);
+        wfc.computeIonsNearby(eI_table.getDistRow(iat), wfc.ions_nearby_old);
+        wfc.computeIonsNearby(eI_table.getTempDists(), wfc.ions_nearby_new);
+        wfc.updateCompactList(p_list[iw], iat);
+      }
+  }
+
+  void mw_recompute(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    const std::vector<bool>& recompute) const override
+  {
+    assert(this == &wfc_list.getLeader());
+    auto& mw_mem = *wfc_list.getCastedLeader<JeeIOMPTarget<FT>>().mw_mem_;
+#pragma omp parallel for
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      if (recompute[iw])
+        wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw).recompute(p_list[iw]);
+    // stale slots are transferred before the next kernel anyway
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      auto& wfc = wfc_list.getCastedElement<JeeIOMPTarget<FT>>(iw);
+      if (recompute[iw] && !mw_mem.stale_slots[wfc.walker_slot_])
+        wfc.updateDeviceSlot(p_list[iw], mw_mem);
+    }
+  }
+
+  void mw_evaluateLog(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                      const RefVectorWithLeader<ParticleSet>& p_list,
+                      const RefVector<ParticleSet::ParticleGradient>& G_list,
+                      const RefVector<ParticleSet::ParticleLaplacian>& L_list) const override
+  {
+    mw_evaluateGL(wfc_list, p_list, G_list, L_list, true);
+  }
+
+  void mw_evaluateGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                     const RefVectorWithLeader<ParticleSet>& p_list,
+                     const RefVector<ParticleSet::ParticleGradient>& G_list,
+                     const RefVector<ParticleSet::ParticleLaplacian>& L_list,
+                     bool fromscratch) const override
+  {
+    assert(this == &wfc_list.getLeader());
+    if (fromscratch)
+      mw_recompute(wfc_list, p_list, std::vector<bool>(wfc_list.size(), true));
+#pragma omp parallel for
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      wfc_list[iw].evaluateGL(p_list[iw], G_list[iw], L_list[iw], false);
+  }
+};
+
+} // namespace qmcplusplus
+#endif
@@ -35,6 +35,7 @@ namespace qmcplusplus
 template<class FT>
 class JeeIOrbitalSoA : public WaveFunctionComponent
 {
+protected:
   ///type of each component U, dU, d2U;
   using valT = typename FT::real_type;
   ///element position type
@@ -129,12 +130,12 @@ class JeeIOrbitalSoA : public WaveFunctionComponent
     }
   }
 
-public:
-  ///alias FuncType
-  using FuncType = FT;
-
-  JeeIOrbitalSoA(const std::string& obj_name, const ParticleSet& ions, ParticleSet& elecs, bool is_master = false)
-      : WaveFunctionComponent("JeeIOrbitalSoA", obj_name),
+  /// constructor for the derived classes reporting their own class name
+  JeeIOrbitalSoA(const std::string& class_name,
+                 const std::string& obj_name,
+                 const ParticleSet& ions,
+                 ParticleSet& elecs)
+      : WaveFunctionComponent(class_name, obj_name),
         ee_Table_ID_(elecs.addTable(elecs, DTModes::NEED_TEMP_DATA_ON_HOST)),
         ei_Table_ID_(elecs.addTable(ions, DTModes::NEED_FULL_TABLE_ANYTIME)),
         Ions(ions)
@@ -144,9 +145,9 @@ public:
     init(elecs);
   }
 
-  std::unique_ptr<WaveFunctionComponent> makeClone(ParticleSet& elecs) const override
+  /// copy the functors and the optimizable variables to a clone
+  void copyFunctorsTo(JeeIOrbitalSoA& eeIcopy) const
   {
-    auto eeIcopy = std::make_unique<JeeIOrbitalSoA<FT>>(myName, Ions, elecs, false);
     std::map<const FT*, FT*> fcmap;
     for (int iG = 0; iG < iGroups; iG++)
       for (int eG1 = 0; eG1 < eGroups; eG1++)
@@ -159,14 +160,99 @@ public:
           {
             auto fc                = std::make_unique<FT>(*F(iG, eG1, eG2));
             fcmap[F(iG, eG1, eG2)] = fc.get();
-            eeIcopy->addFunc(iG, eG1, eG2, std::move(fc));
+            eeIcopy.addFunc(iG, eG1, eG2, std::move(fc));
           }
         }
     // Ye: I don't like the following memory allocated by default.
-    eeIcopy->myVars.clear();
-    eeIcopy->myVars.insertFrom(myVars);
-    eeIcopy->VarOffset   = VarOffset;
-    eeIcopy->Optimizable = Optimizable;
+    eeIcopy.myVars.clear();
+    eeIcopy.myVars.insertFrom(myVars);
+    eeIcopy.VarOffset   = VarOffset;
+    eeIcopy.Optimizable = Optimizable;
+  }
+
+  /// collect the ions within the cutoff radius of an electron
+  inline void computeIonsNearby(const DistRow& distjI, std::vector<int>& ions_nearby) const
+  {
+    ions_nearby.clear();
+    for (int iat = 0; iat < Nion; ++iat)
+      if (distjI[iat] < Ion_cutoff[iat])
+        ions_nearby.push_back(iat);
+  }
+
+  /** update the compact list elecs_inside after accepting the move of electron iat
+   * ions_nearby_old and ions_nearby_new must hold the ions near the old and the new positions.
+   */
+  void updateCompactList(const ParticleSet& P, int iat)
+  {
+    const auto& eI_table = P.getDistTableAB(ei_Table_ID_);
+    const int ig         = P.GroupID[iat];
+    // update compact list elecs_inside
+    // if the old position exists in elecs_inside
+    for (int iind = 0; iind < ions_nearby_old.size(); iind++)
+    {
+      int jat         = ions_nearby_old[iind];
+      auto iter       = std::find(elecs_inside(ig, jat).begin(), elecs_inside(ig, jat).end(), iat);
+      auto iter_dist  = elecs_inside_dist(ig, jat).begin() + std::distance(elecs_inside(ig, jat).begin(), iter);
+      auto iter_displ = elecs_inside_displ(ig, jat).begin() + std::distance(elecs_inside(ig, jat).begin(), iter);
+// sentinel code
+#ifndef NDEBUG
+      if (iter == elecs_inside(ig, jat).end())
+      {
+        std::cerr << std::setprecision(std::numeric_limits<valT>::digits10 + 1) << "updating electron iat = " << iat
+                  << " near ion " << jat << " dist " << eI_table.getDistRow(iat)[jat] << std::endl;
+        throw std::runtime_error("BUG electron not found in elecs_inside");
+      }
+      else if (std::abs(eI_table.getDistRow(iat)[jat] - *iter_dist) >= std::numeric_limits<valT>::epsilon())
+      {
+        std::cerr << std::setprecision(std::numeric_limits<valT>::digits10 + 1) << "inconsistent electron iat = " << iat
+                  << " near ion " << jat << " dist " << eI_table.getDistRow(iat)[jat]
+                  << " stored value = " << *iter_dist << std::endl;
+        throw std::runtime_error("BUG eI distance stored value elecs_inside_dist not matching distance table");
+      }
+#endif
+
+      if (eI_table.getTempDists()[jat] < Ion_cutoff[jat]) // the new position is still inside
+      {
+        *iter_dist                                                      = eI_table.getTempDists()[jat];
+        *iter_displ                                                     = eI_table.getTempDispls()[jat];
+        *std::find(ions_nearby_new.begin(), ions_nearby_new.end(), jat) = -1;
+      }
+      else
+      {
+        *iter = elecs_inside(ig, jat).back();
+        elecs_inside(ig, jat).pop_back();
+        *iter_dist = elecs_inside_dist(ig, jat).back();
+        elecs_inside_dist(ig, jat).pop_back();
+        *iter_displ = elecs_inside_displ(ig, jat).back();
+        elecs_inside_displ(ig, jat).pop_back();
+      }
+    }
+
+    // if the old position doesn't exist in elecs_inside but the new position do
+    for (int iind = 0; iind < ions_nearby_new.size(); iind++)
+    {
+      int jat = ions_nearby_new[iind];
+      if (jat >= 0)
+      {
+        elecs_inside(ig, jat).push_back(iat);
+        elecs_inside_dist(ig, jat).push_back(eI_table.getTempDists()[jat]);
+        elecs_inside_displ(ig, jat).push_back(eI_table.getTempDispls()[jat]);
+      }
+    }
+  }
+
+public:
+  ///alias FuncType
+  using FuncType = FT;
+
+  JeeIOrbitalSoA(const std::string& obj_name, const ParticleSet& ions, ParticleSet& elecs, bool is_master = false)
+      : JeeIOrbitalSoA("JeeIOrbitalSoA", obj_name, ions, elecs)
+  {}
+
+  std::unique_ptr<WaveFunctionComponent> makeClone(ParticleSet& elecs) const override
+  {
+    auto eeIcopy = std::make_unique<JeeIOrbitalSoA<FT>>(myName, Ions, elecs, false);
+    copyFunctorsTo(*eeIcopy);
     return eeIcopy;
   }
 
@@ -499,60 +585,7 @@ public:
     dUat(iat)  = cur_dUat;
     d2Uat[iat] = cur_d2Uat;
 
-    const int ig = P.GroupID[iat];
-    // update compact list elecs_inside
-    // if the old position exists in elecs_inside
-    for (int iind = 0; iind < ions_nearby_old.size(); iind++)
-    {
-      int jat         = ions_nearby_old[iind];
-      auto iter       = std::find(elecs_inside(ig, jat).begin(), elecs_inside(ig, jat).end(), iat);
-      auto iter_dist  = elecs_inside_dist(ig, jat).begin() + std::distance(elecs_inside(ig, jat).begin(), iter);
-      auto iter_displ = elecs_inside_displ(ig, jat).begin() + std::distance(elecs_inside(ig, jat).begin(), iter);
-// sentinel code
-#ifndef NDEBUG
-      if (iter == elecs_inside(ig, jat).end())
-      {
-        std::cerr << std::setprecision(std::numeric_limits<valT>::digits10 + 1) << "updating electron iat = " << iat
-                  << " near ion " << jat << " dist " << eI_table.getDistRow(iat)[jat] << std::endl;
-        throw std::runtime_error("BUG electron not found in elecs_inside");
-      }
-      else if (std::abs(eI_table.getDistRow(iat)[jat] - *iter_dist) >= std::numeric_limits<valT>::epsilon())
-      {
-        std::cerr << std::setprecision(std::numeric_limits<valT>::digits10 + 1) << "inconsistent electron iat = " << iat
-                  << " near ion " << jat << " dist " << eI_table.getDistRow(iat)[jat]
-                  << " stored value = " << *iter_dist << std::endl;
-        throw std::runtime_error("BUG eI distance stored value elecs_inside_dist not matching distance table");
-      }
-#endif
-
-      if (eI_table.getTempDists()[jat] < Ion_cutoff[jat]) // the new position is still inside
-      {
-        *iter_dist                                                      = eI_table.getTempDists()[jat];
-        *iter_displ                                                     = eI_table.getTempDispls()[jat];
-        *std::find(ions_nearby_new.begin(), ions_nearby_new.end(), jat) = -1;
-      }
-      else
-      {
-        *iter = elecs_inside(ig, jat).back();
-        elecs_inside(ig, jat).pop_back();
-        *iter_dist = elecs_inside_dist(ig, jat).back();
-        elecs_inside_dist(ig, jat).pop_back();
-        *iter_displ = elecs_inside_displ(ig, jat).back();
-        elecs_inside_displ(ig, jat).pop_back();
-      }
-    }
-
-    // if the old position doesn't exist in elecs_inside but the new position do
-    for (int iind = 0; iind < ions_nearby_new.size(); iind++)
-    {
-      int jat = ions_nearby_new[iind];
-      if (jat >= 0)
-      {
-        elecs_inside(ig, jat).push_back(iat);
-        elecs_inside_dist(ig, jat).push_back(eI_table.getTempDists()[jat]);
-        elecs_inside_displ(ig, jat).push_back(eI_table.getTempDispls()[jat]);
-      }
-    }
+    updateCompactList(P, iat);
   }
 
   inline void recompute(const ParticleSet& P) override
@@ -593,10 +626,7 @@ public:
                        const DistRow& distjk,
                        std::vector<int>& ions_nearby)
   {
-    ions_nearby.clear();
-    for (int iat = 0; iat < Nion; ++iat)
-      if (distjI[iat] < Ion_cutoff[iat])
-        ions_nearby.push_back(iat);
+    computeIonsNearby(distjI, ions_nearby);
 
     valT Uj = valT(0);
     for (int kg = 0; kg < eGroups; ++kg)
@@ -754,10 +784,7 @@ public:
     for (int idim = 0; idim < OHMMS_DIM; ++idim)
       std::fill_n(dUk.data(idim), kelmax, czero);
 
-    ions_nearby.clear();
-    for (int iat = 0; iat < Nion; ++iat)
-      if (distjI[iat] < Ion_cutoff[iat])
-        ions_nearby.push_back(iat);
+    computeIonsNearby(distjI, ions_nearby);
 
     for (int kg = 0; kg < eGroups; ++kg)
     {
@@ -194,8 +194,9 @@ struct PadeFunctor : public OptimizableFunctorBase
                            T* mw_vgl, // [nw][DIM+2]
                            const int n_padded,
                            const T* mw_dist, // [nw][DIM+1][n_padded]
-                           T* mw_allUat,     // [nw][DIM+2][n_padded]
-                           T* mw_cur_allu,   // [nw][3][n_padded]
+                           T* mw_allUat,      // [nw][DIM+2][n_padded]
+                           T* mw_allUat_comp, // [nw][DIM+2][n_padded]
+                           T* mw_cur_allu,    // [nw][3][n_padded]
                            Vector<char, OffloadPinnedAllocator<char>>& transfer_buffer)
   {
     throw std::runtime_error("PadeFunctor mw_updateVGL not implemented!");
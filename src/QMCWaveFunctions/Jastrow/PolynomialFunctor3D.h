@@ -24,6 +24,8 @@
 #include "Numerics/DeterminantOperators.h"
 #include <cstdio>
 #include <algorithm>
+#include <memory>
+#include <mutex>
 
 namespace qmcplusplus
 {
@@ -53,10 +55,45 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
   const int C;
   real_type scale;
   bool notOpt;
+  /// number of intervals of the optional table in each direction, 0 disables the table
+  int table_size;
+  /// number of values stored at each table node
+  static constexpr int TABLE_NODE_SIZE = 8;
+
+  /// the table of f, read-only once built and shared by the copies of the functor
+  struct Table
+  {
+    /// coefficients, cutoff and number of intervals the table was built from
+    std::vector<real_type> gamma;
+    real_type cutoff;
+    int size;
+    /// grid spacings along r_12, r_1I and r_2I
+    TinyVector<real_type, 3> delta, delta_inv;
+    /** f and its derivatives f_12, f_1I, f_2I, f_12_1I, f_12_2I, f_1I_2I, f_12_1I_2I on the nodes.
+     * The table is interpolated by tricubic Hermite polynomials.
+     */
+    std::vector<real_type> data;
+  };
+  /// the latest table built by any copy of the functor, a parameter update builds it only once
+  struct TableCache
+  {
+    std::mutex mutex;
+    std::shared_ptr<const Table> table;
+  };
+  /// table used by the evaluations, nullptr if not tabulated
+  std::shared_ptr<const Table> table_;
+  std::shared_ptr<TableCache> table_cache_;
 
   ///constructor
   PolynomialFunctor3D(real_type ee_cusp = 0.0, real_type eI_cusp = 0.0)
-      : N_eI(0), N_ee(0), ResetCount(0), C(3), scale(1.0), notOpt(false)
+      : N_eI(0),
+        N_ee(0),
+        ResetCount(0),
+        C(3),
+        scale(1.0),
+        notOpt(false),
+        table_size(0),
+        table_cache_(std::make_shared<TableCache>())
   {
     if (std::abs(ee_cusp) > 0.0 || std::abs(eI_cusp) > 0.0)
     {
@@ -315,6 +352,174 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
         abort();
       }
     }
+    if (table_size > 0)
+      updateTable();
+  }
+
+  /** use the table of the current gamma, it is only built if no copy of the functor built it yet
+   */
+  void updateTable()
+  {
+    std::lock_guard<std::mutex> lock(table_cache_->mutex);
+    const auto& latest = table_cache_->table;
+    if (!latest || latest->gamma != GammaVec || latest->cutoff != cutoff_radius || latest->size != table_size)
+      table_cache_->table = buildTable();
+    table_ = table_cache_->table;
+  }
+
+  /** tabulate f and its derivatives from the current gamma
+   *
+   * r_12 is tabulated in [0, rcut] and r_1I, r_2I in [0, rcut/2].
+   */
+  std::shared_ptr<const Table> buildTable()
+  {
+    auto table        = std::make_shared<Table>();
+    table->gamma      = GammaVec;
+    table->cutoff     = cutoff_radius;
+    table->size       = table_size;
+    const real_type L = 0.5 * cutoff_radius;
+    const int n1      = table_size + 1;
+    table->delta      = TinyVector<real_type, 3>(2 * L / table_size, L / table_size, L / table_size);
+    for (int idim = 0; idim < 3; idim++)
+      table->delta_inv[idim] = 1.0 / table->delta[idim];
+    table->data.resize(n1 * n1 * n1 * TABLE_NODE_SIZE);
+
+    TinyVector<real_type, 3> grad;
+    Tensor<real_type, 3> hess;
+    TinyVector<Tensor<real_type, 3>, 3> d3;
+    for (int ix = 0; ix < n1; ix++)
+      for (int iy = 0; iy < n1; iy++)
+        for (int iz = 0; iz < n1; iz++)
+        {
+          real_type* node = table->data.data() + ((ix * n1 + iy) * n1 + iz) * TABLE_NODE_SIZE;
+          node[0] = evaluate(ix * table->delta[0], iy * table->delta[1], iz * table->delta[2], grad, hess, d3);
+          node[1] = grad[0];
+          node[2] = grad[1];
+          node[3] = grad[2];
+          node[4] = hess(0, 1);
+          node[5] = hess(0, 2);
+          node[6] = hess(1, 2);
+          node[7] = d3[0](1, 2);
+        }
+    return table;
+  }
+
+  /// cubic Hermite basis of the left value, right value, left slope and right slope
+  static inline void computeHermiteBasis(real_type t, real_type h, real_type* restrict b)
+  {
+    const real_type t2 = t * t;
+    const real_type t3 = t2 * t;
+    b[0]               = 2 * t3 - 3 * t2 + 1;
+    b[1]               = 3 * t2 - 2 * t3;
+    b[2]               = (t3 - 2 * t2 + t) * h;
+    b[3]               = (t3 - t2) * h;
+  }
+
+  /// cubic Hermite basis and its first and second derivatives
+  static inline void computeHermiteBasis(real_type t,
+                                         real_type h,
+                                         real_type hinv,
+                                         real_type* restrict b,
+                                         real_type* restrict db,
+                                         real_type* restrict d2b)
+  {
+    computeHermiteBasis(t, h, b);
+    const real_type t2 = t * t;
+    db[0]              = (6 * t2 - 6 * t) * hinv;
+    db[1]              = (6 * t - 6 * t2) * hinv;
+    db[2]              = 3 * t2 - 4 * t + 1;
+    db[3]              = 3 * t2 - 2 * t;
+    d2b[0]             = (12 * t - 6) * hinv * hinv;
+    d2b[1]             = (6 - 12 * t) * hinv * hinv;
+    d2b[2]             = (6 * t - 4) * hinv;
+    d2b[3]             = (6 * t - 2) * hinv;
+  }
+
+  /// locate the table interval of r along idim and the position t in [0,1) within the interval
+  inline int locateTableCell(real_type r, int idim, real_type& t) const
+  {
+    const real_type s = r * table_->delta_inv[idim];
+    const int i       = std::max(0, std::min(static_cast<int>(s), table_size - 1));
+    t                 = s - i;
+    return i;
+  }
+
+  /** the offset in the table data of the value needed by the Hermite basis sx, sy, sz of a cell
+   * The basis index s is 0 left value, 1 right value, 2 left slope, 3 right slope.
+   */
+  inline int getTableOffset(int ix, int iy, int iz, int sx, int sy, int sz) const
+  {
+    // node value index of the derivative orders (px, py, pz), indexed by px * 4 + py * 2 + pz
+    constexpr int value_id[8] = {0, 3, 2, 6, 1, 5, 4, 7};
+    const int n1              = table_size + 1;
+    const int node            = ((ix + (sx & 1)) * n1 + iy + (sy & 1)) * n1 + iz + (sz & 1);
+    return node * TABLE_NODE_SIZE + value_id[(sx >> 1) * 4 + (sy >> 1) * 2 + (sz >> 1)];
+  }
+
+  /// interpolate the value from the table
+  inline real_type evaluateTableV(real_type r_12, real_type r_1I, real_type r_2I) const
+  {
+    real_type tx, ty, tz;
+    const int ix = locateTableCell(r_12, 0, tx);
+    const int iy = locateTableCell(r_1I, 1, ty);
+    const int iz = locateTableCell(r_2I, 2, tz);
+    real_type bx[4], by[4], bz[4];
+    computeHermiteBasis(tx, table_->delta[0], bx);
+    computeHermiteBasis(ty, table_->delta[1], by);
+    computeHermiteBasis(tz, table_->delta[2], bz);
+    const real_type* restrict table_data = table_->data.data();
+
+    real_type val(0);
+    for (int sx = 0; sx < 4; sx++)
+      for (int sy = 0; sy < 4; sy++)
+      {
+        const real_type bxy = bx[sx] * by[sy];
+        for (int sz = 0; sz < 4; sz++)
+          val += bxy * bz[sz] * table_data[getTableOffset(ix, iy, iz, sx, sy, sz)];
+      }
+    return val;
+  }
+
+  /// interpolate the value, gradient and the hessian elements needed by evaluateVGL from the table
+  inline void evaluateTableVGH(real_type r_12,
+                               real_type r_1I,
+                               real_type r_2I,
+                               real_type& val,
+                               real_type& grad0,
+                               real_type& grad1,
+                               real_type& grad2,
+                               real_type& hess00,
+                               real_type& hess11,
+                               real_type& hess22,
+                               real_type& hess01,
+                               real_type& hess02) const
+  {
+    real_type tx, ty, tz;
+    const int ix = locateTableCell(r_12, 0, tx);
+    const int iy = locateTableCell(r_1I, 1, ty);
+    const int iz = locateTableCell(r_2I, 2, tz);
+    real_type bx[4], by[4], bz[4], dbx[4], dby[4], dbz[4], d2bx[4], d2by[4], d2bz[4];
+    computeHermiteBasis(tx, table_->delta[0], table_->delta_inv[0], bx, dbx, d2bx);
+    computeHermiteBasis(ty, table_->delta[1], table_->delta_inv[1], by, dby, d2by);
+    computeHermiteBasis(tz, table_->delta[2], table_->delta_inv[2], bz, dbz, d2bz);
+    const real_type* restrict table_data = table_->data.data();
+
+    val = grad0 = grad1 = grad2 = hess00 = hess11 = hess22 = hess01 = hess02 = real_type(0);
+    for (int sx = 0; sx < 4; sx++)
+      for (int sy = 0; sy < 4; sy++)
+        for (int sz = 0; sz < 4; sz++)
+        {
+          const real_type c = table_data[getTableOffset(ix, iy, iz, sx, sy, sz)];
+          val += c * bx[sx] * by[sy] * bz[sz];
+          grad0 += c * dbx[sx] * by[sy] * bz[sz];
+          grad1 += c * bx[sx] * dby[sy] * bz[sz];
+          grad2 += c * bx[sx] * by[sy] * dbz[sz];
+          hess00 += c * d2bx[sx] * by[sy] * bz[sz];
+          hess11 += c * bx[sx] * d2by[sy] * bz[sz];
+          hess22 += c * bx[sx] * by[sy] * d2bz[sz];
+          hess01 += c * dbx[sx] * dby[sy] * bz[sz];
+          hess02 += c * dbx[sx] * by[sy] * dbz[sz];
+        }
   }
 
   inline real_type evaluate(real_type r_12, real_type r_1I, real_type r_2I) const
@@ -326,6 +531,8 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
     const real_type L = chalf * cutoff_radius;
     if (r_1I >= L || r_2I >= L)
       return czero;
+    if (table_)
+      return evaluateTableV(r_12, r_1I, r_2I);
     real_type val = czero;
     real_type r2l(cone);
     for (int l = 0; l <= N_eI; l++)
@@ -361,6 +568,13 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
     const real_type L = chalf * cutoff_radius;
     real_type val_tot = czero;
 
+    if (table_)
+    {
+      for (int ptcl = 0; ptcl < Nptcl; ptcl++)
+        val_tot += evaluateTableV(r_12_array[ptcl], r_1I_array[ptcl], r_2I_array[ptcl]);
+      return val_tot;
+    }
+
 #pragma omp simd aligned(r_12_array, r_1I_array, r_2I_array : QMC_SIMD_ALIGNMENT) reduction(+ : val_tot)
     for (int ptcl = 0; ptcl < Nptcl; ptcl++)
     {
@@ -477,6 +691,101 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
     return val;
   }
 
+  /** value, gradient and hessian of the polynomial from the packed coefficients, also callable in offload regions
+   * @param gamma_data the coefficients in the layout of the gamma array
+   * @param L half of the cutoff radius
+   * The gradients and the mixed hessian elements are not divided by the distances.
+   * assume r_1I < L && r_2I < L
+   */
+  static inline void evaluateVGL_impl(const real_type* restrict gamma_data,
+                                      const int N_eI,
+                                      const int N_ee,
+                                      const int C,
+                                      const real_type L,
+                                      const real_type r_12,
+                                      const real_type r_1I,
+                                      const real_type r_2I,
+                                      real_type& val,
+                                      real_type& grad0,
+                                      real_type& grad1,
+                                      real_type& grad2,
+                                      real_type& hess00,
+                                      real_type& hess11,
+                                      real_type& hess22,
+                                      real_type& hess01,
+                                      real_type& hess02)
+  {
+    constexpr real_type czero(0);
+    constexpr real_type cone(1);
+    constexpr real_type ctwo(2);
+
+    val    = czero;
+    grad0  = czero;
+    grad1  = czero;
+    grad2  = czero;
+    hess00 = czero;
+    hess11 = czero;
+    hess22 = czero;
+    hess01 = czero;
+    hess02 = czero;
+
+    real_type r2l(cone), r2l_1(czero), r2l_2(czero), lf(czero);
+    for (int l = 0; l <= N_eI; l++)
+    {
+      real_type r2m(cone), r2m_1(czero), r2m_2(czero), mf(czero);
+      for (int m = 0; m <= N_eI; m++)
+      {
+        real_type r2n(cone), r2n_1(czero), r2n_2(czero), nf(czero);
+        for (int n = 0; n <= N_ee; n++)
+        {
+          const real_type g    = gamma_data[(l * (N_eI + 1) + m) * (N_ee + 1) + n];
+          const real_type g00x = g * r2l * r2m;
+          const real_type g10x = g * r2l_1 * r2m;
+          const real_type g01x = g * r2l * r2m_1;
+          const real_type gxx0 = g * r2n;
+
+          val += g00x * r2n;
+          grad0 += g00x * r2n_1;
+          grad1 += g10x * r2n;
+          grad2 += g01x * r2n;
+          hess00 += g00x * r2n_2;
+          hess01 += g10x * r2n_1;
+          hess02 += g01x * r2n_1;
+          hess11 += gxx0 * r2l_2 * r2m;
+          hess22 += gxx0 * r2l * r2m_2;
+          nf += cone;
+          r2n_2 = r2n_1 * nf;
+          r2n_1 = r2n * nf;
+          r2n *= r_12;
+        }
+        mf += cone;
+        r2m_2 = r2m_1 * mf;
+        r2m_1 = r2m * mf;
+        r2m *= r_2I;
+      }
+      lf += cone;
+      r2l_2 = r2l_1 * lf;
+      r2l_1 = r2l * lf;
+      r2l *= r_1I;
+    }
+
+    const real_type r_2I_minus_L = r_2I - L;
+    const real_type r_1I_minus_L = r_1I - L;
+    const real_type both_minus_L = r_2I_minus_L * r_1I_minus_L;
+    for (int i = 0; i < C; i++)
+    {
+      hess00 = both_minus_L * hess00;
+      hess01 = both_minus_L * hess01 + r_2I_minus_L * grad0;
+      hess02 = both_minus_L * hess02 + r_1I_minus_L * grad0;
+      hess11 = both_minus_L * hess11 + ctwo * r_2I_minus_L * grad1;
+      hess22 = both_minus_L * hess22 + ctwo * r_1I_minus_L * grad2;
+      grad0  = both_minus_L * grad0;
+      grad1  = both_minus_L * grad1 + r_2I_minus_L * val;
+      grad2  = both_minus_L * grad2 + r_1I_minus_L * val;
+      val *= both_minus_L;
+    }
+  }
+
   // assume r_1I < L && r_2I < L, compression and screening is handled outside
   inline void evaluateVGL(int Nptcl,
                           const real_type* restrict r_12_array,
@@ -492,12 +801,29 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
                           real_type* restrict hess01_array,
                           real_type* restrict hess02_array) const
   {
-    constexpr real_type czero(0);
-    constexpr real_type cone(1);
     constexpr real_type chalf(0.5);
-    constexpr real_type ctwo(2);
 
     const real_type L = chalf * cutoff_radius;
+
+    if (table_)
+    {
+      for (int ptcl = 0; ptcl < Nptcl; ptcl++)
+      {
+        const real_type r_12 = r_12_array[ptcl];
+        const real_type r_1I = r_1I_array[ptcl];
+        const real_type r_2I = r_2I_array[ptcl];
+        real_type grad0, grad1, grad2, hess01, hess02;
+        evaluateTableVGH(r_12, r_1I, r_2I, val_array[ptcl], grad0, grad1, grad2, hess00_array[ptcl],
+                         hess11_array[ptcl], hess22_array[ptcl], hess01, hess02);
+        grad0_array[ptcl]  = grad0 / r_12;
+        grad1_array[ptcl]  = grad1 / r_1I;
+        grad2_array[ptcl]  = grad2 / r_2I;
+        hess01_array[ptcl] = hess01 / (r_12 * r_1I);
+        hess02_array[ptcl] = hess02 / (r_12 * r_2I);
+      }
+      return;
+    }
+
 #pragma omp simd aligned(r_12_array, r_1I_array, r_2I_array, val_array, grad0_array, grad1_array, grad2_array, \
                          hess00_array, hess11_array, hess22_array, hess01_array, hess02_array                  \
                          : QMC_SIMD_ALIGNMENT)
@@ -507,71 +833,9 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
       const real_type r_1I = r_1I_array[ptcl];
       const real_type r_2I = r_2I_array[ptcl];
 
-      real_type val(czero);
-      real_type grad0(czero);
-      real_type grad1(czero);
-      real_type grad2(czero);
-      real_type hess00(czero);
-      real_type hess11(czero);
-      real_type hess22(czero);
-      real_type hess01(czero);
-      real_type hess02(czero);
-
-      real_type r2l(cone), r2l_1(czero), r2l_2(czero), lf(czero);
-      for (int l = 0; l <= N_eI; l++)
-      {
-        real_type r2m(cone), r2m_1(czero), r2m_2(czero), mf(czero);
-        for (int m = 0; m <= N_eI; m++)
-        {
-          real_type r2n(cone), r2n_1(czero), r2n_2(czero), nf(czero);
-          for (int n = 0; n <= N_ee; n++)
-          {
-            const real_type g    = gamma(l, m, n);
-            const real_type g00x = g * r2l * r2m;
-            const real_type g10x = g * r2l_1 * r2m;
-            const real_type g01x = g * r2l * r2m_1;
-            const real_type gxx0 = g * r2n;
-
-            val += g00x * r2n;
-            grad0 += g00x * r2n_1;
-            grad1 += g10x * r2n;
-            grad2 += g01x * r2n;
-            hess00 += g00x * r2n_2;
-            hess01 += g10x * r2n_1;
-            hess02 += g01x * r2n_1;
-            hess11 += gxx0 * r2l_2 * r2m;
-            hess22 += gxx0 * r2l * r2m_2;
-            nf += cone;
-            r2n_2 = r2n_1 * nf;
-            r2n_1 = r2n * nf;
-            r2n *= r_12;
-          }
-          mf += cone;
-          r2m_2 = r2m_1 * mf;
-          r2m_1 = r2m * mf;
-          r2m *= r_2I;
-        }
-        lf += cone;
-        r2l_2 = r2l_1 * lf;
-        r2l_1 = r2l * lf;
-        r2l *= r_1I;
-      }
-
-      const real_type r_2I_minus_L = r_2I - L;
-      const real_type r_1I_minus_L = r_1I - L;
-      const real_type both_minus_L = r_2I_minus_L * r_1I_minus_L;
-      for (int i = 0; i < C; i++)
-      {
-        hess00 = both_minus_L * hess00;
-        hess01 = both_minus_L * hess01 + r_2I_minus_L * grad0;
-        hess02 = both_minus_L * hess02 + r_1I_minus_L * grad0;
-        hess11 = both_minus_L * hess11 + ctwo * r_2I_minus_L * grad1;
-        hess22 = both_minus_L * hess22 + ctwo * r_1I_minus_L * grad2;
-        grad0  = both_minus_L * grad0;
-        grad1  = both_minus_L * grad1 + r_2I_minus_L * val;
-        grad2  = both_minus_L * grad2 + r_1I_minus_L * val;
-        val *= both_minus_L;
-      }
+      real_type val, grad0, grad1, grad2, hess00, hess11, hess22, hess01, hess02;
+      evaluateVGL_impl(gamma.data(), N_eI, N_ee, C, L, r_12, r_1I, r_2I, val, grad0, grad1, grad2, hess00, hess11,
+                       hess22, hess01, hess02);
 
       val_array[ptcl]    = val;
       grad0_array[ptcl]  = grad0 / r_12;
@@ -898,6 +1162,7 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
     rAttrib.add(N_ee, "esize");
     rAttrib.add(N_eI, "isize");
     rAttrib.add(cutoff_radius, "rcut");
+    rAttrib.add(table_size, "table_size");
     rAttrib.put(cur);
     if (N_eI == 0)
       PRE.error("You must specify a positive number for \"isize\"", true);
@@ -907,6 +1172,9 @@ struct PolynomialFunctor3D : public OptimizableFunctorBase
                   << std::endl;
     app_summary() << "      Number of parameters for e-e: " << N_ee << ", for e-I: " << N_eI << std::endl;
     app_summary() << "      Cutoff radius: " << cutoff_radius << std::endl;
+    if (table_size > 0)
+      app_summary() << "      Tabulated on a grid of " << table_size << "^3 intervals for value, gradient and laplacian"
+                    << std::endl;
     app_summary() << std::endl;
     resize(N_eI, N_ee);
     // Now read coefficents
@@ -19,6 +19,9 @@
 #include "RPAJastrow.h"
 #include "QMCWaveFunctions/WaveFunctionComponentBuilder.h"
 #include "QMCWaveFunctions/Jastrow/J2OrbitalSoA.h"
+#if defined(ENABLE_OFFLOAD)
+#include "QMCWaveFunctions/Jastrow/J2OMPTarget.h"
+#endif
 #include "QMCWaveFunctions/Jastrow/LRBreakupUtilities.h"
 #include "QMCWaveFunctions/Jastrow/SplineFunctors.h"
 #include "QMCWaveFunctions/Jastrow/BsplineFunctor.h"
@@ -177,7 +180,6 @@ void RPAJastrow::makeShortRange()
   nfunc           = nfunc_uptr.get();
   ShortRangePartAdapter<RealType> SRA(myHandler.get());
   SRA.setRmax(Rcut);
-  auto j2        = std::make_unique<J2OrbitalSoA<BsplineFunctor<RealType>>>("RPA", targetPtcl);
   size_t nparam  = 12;  // number of Bspline parameters
   size_t npts    = 100; // number of 1D grid points for basis functions
   RealType cusp  = SRA.df(0);
@@ -198,7 +200,22 @@ void RPAJastrow::makeShortRange()
     X[i] = i * delta;
     Y[i] = SRA.evaluate(X[i]);
   }
-  j2->addFunc(0, 0, std::move(nfunc_uptr));
+  std::unique_ptr<WaveFunctionComponent> j2;
+#if defined(ENABLE_OFFLOAD)
+  // batched drivers with an offload particle set use the offload two-body Jastrow
+  if (targetPtcl.getCoordinates().getKind() == DynamicCoordinateKind::DC_POS_OFFLOAD)
+  {
+    auto j2_omp = std::make_unique<J2OMPTarget<FuncType>>("RPA", targetPtcl);
+    j2_omp->addFunc(0, 0, std::move(nfunc_uptr));
+    j2 = std::move(j2_omp);
+  }
+  else
+#endif
+  {
+    auto j2_soa = std::make_unique<J2OrbitalSoA<FuncType>>("RPA", targetPtcl);
+    j2_soa->addFunc(0, 0, std::move(nfunc_uptr));
+    j2 = std::move(j2_soa);
+  }
   ShortRangeRPA = j2.get();
   Psi.push_back(std::move(j2));
 }
@@ -258,8 +275,12 @@ RPAJastrow::PsiValueType RPAJastrow::ratioGrad(ParticleSet& P, int iat, GradType
 
 void RPAJastrow::acceptMove(ParticleSet& P, int iat, bool safe_to_delay)
 {
+  log_value_ = 0.0;
   for (int i = 0; i < Psi.size(); i++)
+  {
     Psi[i]->acceptMove(P, iat, safe_to_delay);
+    log_value_ += Psi[i]->get_log_value();
+  }
 }
 
 void RPAJastrow::restore(int iat)
@@ -288,6 +309,140 @@ void RPAJastrow::copyFromBuffer(ParticleSet& P, WFBufferType& buf)
     Psi[i]->copyFromBuffer(P, buf);
 }
 
+RefVectorWithLeader<WaveFunctionComponent> RPAJastrow::extractComponentRefList(
+    const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+    int i)
+{
+  auto& wfc_leader = wfc_list.getCastedLeader<RPAJastrow>();
+  RefVectorWithLeader<WaveFunctionComponent> component_list(*wfc_leader.Psi[i]);
+  component_list.reserve(wfc_list.size());
+  for (WaveFunctionComponent& wfc : wfc_list)
+    component_list.push_back(*static_cast<RPAJastrow&>(wfc).Psi[i]);
+  return component_list;
+}
+
+void RPAJastrow::updateLogValues(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list)
+{
+  for (WaveFunctionComponent& wfc : wfc_list)
+  {
+    auto& rpa      = static_cast<RPAJastrow&>(wfc);
+    rpa.log_value_ = 0.0;
+    for (int i = 0; i < rpa.Psi.size(); i++)
+      rpa.log_value_ += rpa.Psi[i]->get_log_value();
+  }
+}
+
+void RPAJastrow::createResource(ResourceCollection& collection) const
+{
+  for (int i = 0; i < Psi.size(); i++)
+    Psi[i]->createResource(collection);
+}
+
+void RPAJastrow::acquireResource(ResourceCollection& collection,
+                                 const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const
+{
+  for (int i = 0; i < Psi.size(); i++)
+    Psi[i]->acquireResource(collection, extractComponentRefList(wfc_list, i));
+}
+
+void RPAJastrow::releaseResource(ResourceCollection& collection,
+                                 const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const
+{
+  for (int i = 0; i < Psi.size(); i++)
+    Psi[i]->releaseResource(collection, extractComponentRefList(wfc_list, i));
+}
+
+void RPAJastrow::mw_evaluateLog(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                const RefVectorWithLeader<ParticleSet>& p_list,
+                                const RefVector<ParticleSet::ParticleGradient>& G_list,
+                                const RefVector<ParticleSet::ParticleLaplacian>& L_list) const
+{
+  for (int i = 0; i < Psi.size(); i++)
+    Psi[i]->mw_evaluateLog(extractComponentRefList(wfc_list, i), p_list, G_list, L_list);
+  updateLogValues(wfc_list);
+}
+
+void RPAJastrow::mw_evaluateGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                               const RefVectorWithLeader<ParticleSet>& p_list,
+                               const RefVector<ParticleSet::ParticleGradient>& G_list,
+                               const RefVector<ParticleSet::ParticleLaplacian>& L_list,
+                               bool fromscratch) const
+{
+  for (int i = 0; i < Psi.size(); i++)
+    Psi[i]->mw_evaluateGL(extractComponentRefList(wfc_list, i), p_list, G_list, L_list, fromscratch);
+  updateLogValues(wfc_list);
+}
+
+void RPAJastrow::mw_recompute(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                              const RefVectorWithLeader<ParticleSet>& p_list,
+                              const std::vector<bool>& recompute) const
+{
+  for (int i = 0; i < Psi.size(); i++)
+    Psi[i]->mw_recompute(extractComponentRefList(wfc_list, i), p_list, recompute);
+  updateLogValues(wfc_list);
+}
+
+void RPAJastrow::mw_evalGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                             const RefVectorWithLeader<ParticleSet>& p_list,
+                             int iat,
+                             std::vector<GradType>& grad_now) const
+{
+  const int nw = wfc_list.size();
+  std::vector<GradType> grad_component(nw);
+  std::fill(grad_now.begin(), grad_now.begin() + nw, GradType(0));
+  for (int i = 0; i < Psi.size(); i++)
+  {
+    Psi[i]->mw_evalGrad(extractComponentRefList(wfc_list, i), p_list, iat, grad_component);
+    for (int iw = 0; iw < nw; iw++)
+      grad_now[iw] += grad_component[iw];
+  }
+}
+
+void RPAJastrow::mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                              const RefVectorWithLeader<ParticleSet>& p_list,
+                              int iat,
+                              std::vector<PsiValueType>& ratios) const
+{
+  const int nw = wfc_list.size();
+  std::vector<PsiValueType> ratios_component(nw);
+  std::fill(ratios.begin(), ratios.begin() + nw, PsiValueType(1));
+  for (int i = 0; i < Psi.size(); i++)
+  {
+    Psi[i]->mw_calcRatio(extractComponentRefList(wfc_list, i), p_list, iat, ratios_component);
+    for (int iw = 0; iw < nw; iw++)
+      ratios[iw] *= ratios_component[iw];
+  }
+}
+
+void RPAJastrow::mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                              const RefVectorWithLeader<ParticleSet>& p_list,
+                              int iat,
+                              std::vector<PsiValueType>& ratios,
+                              std::vector<GradType>& grad_new) const
+{
+  const int nw = wfc_list.size();
+  std::vector<PsiValueType> ratios_component(nw);
+  std::fill(ratios.begin(), ratios.begin() + nw, PsiValueType(1));
+  for (int i = 0; i < Psi.size(); i++)
+  {
+    // components accumulate their gradients into grad_new
+    Psi[i]->mw_ratioGrad(extractComponentRefList(wfc_list, i), p_list, iat, ratios_component, grad_new);
+    for (int iw = 0; iw < nw; iw++)
+      ratios[iw] *= ratios_component[iw];
+  }
+}
+
+void RPAJastrow::mw_accept_rejectMove(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                      const RefVectorWithLeader<ParticleSet>& p_list,
+                                      int iat,
+                                      const std::vector<bool>& isAccepted,
+                                      bool safe_to_delay) const
+{
+  for (int i = 0; i < Psi.size(); i++)
+    Psi[i]->mw_accept_rejectMove(extractComponentRefList(wfc_list, i), p_list, iat, isAccepted, safe_to_delay);
+  updateLogValues(wfc_list);
+}
+
 /** this is a great deal of logic for make clone I'm wondering what is going on
  */
 std::unique_ptr<WaveFunctionComponent> RPAJastrow::makeClone(ParticleSet& tpq) const
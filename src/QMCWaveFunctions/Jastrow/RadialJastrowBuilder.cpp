@@ -75,6 +75,14 @@ public:
   using RadFuncType = BsplineFunctor<RadialJastrowBuilder::RealType>;
   using J2Type      = J2OMPTarget<RadFuncType>;
 };
+
+template<>
+class JastrowTypeHelper<UserFunctor<RadialJastrowBuilder::RealType>, RadialJastrowBuilder::detail::OMPTARGET>
+{
+public:
+  using RadFuncType = UserFunctor<RadialJastrowBuilder::RealType>;
+  using J2Type      = J2OMPTarget<RadFuncType>;
+};
 #endif
 
 RadialJastrowBuilder::RadialJastrowBuilder(Communicate* comm, ParticleSet& target, ParticleSet& source)
@@ -117,6 +125,18 @@ void RadialJastrowBuilder::guardAgainstPBC()
   }
 }
 
+// helper method for offload implementations which require the target particle set on the device
+void RadialJastrowBuilder::guardAgainstNonOffloadTarget()
+{
+  if (targetPtcl.getCoordinates().getKind() != DynamicCoordinateKind::DC_POS_OFFLOAD)
+  {
+    std::ostringstream msg;
+    msg << "Offload enabled Jastrow needs the gpu=\"yes\" attribute in the \"" << targetPtcl.getName()
+        << "\" particleset" << std::endl;
+    myComm->barrier_and_abort(msg.str());
+  }
+}
+
 template<class RadFuncType>
 void RadialJastrowBuilder::initTwoBodyFunctor(RadFuncType& functor, double fac)
 {}
@@ -165,11 +185,19 @@ std::unique_ptr<WaveFunctionComponent> RadialJastrowBuilder::createJ2(xmlNodePtr
   auto J2  = std::make_unique<J2Type>(j2name, targetPtcl);
 
   std::string init_mode("0");
+  int steps_between_recompute(0);
   {
     OhmmsAttributeSet hAttrib;
     hAttrib.add(init_mode, "init");
+    hAttrib.add(steps_between_recompute, "steps_between_recompute");
     hAttrib.put(cur);
   }
+  if (steps_between_recompute < 0)
+    PRE.error("steps_between_recompute of Jastrow " + j2name + " must not be negative.", true);
+#if defined(ENABLE_OFFLOAD)
+  if constexpr (Implementation == detail::OMPTARGET)
+    J2->setStepsBetweenRecompute(steps_between_recompute);
+#endif
 
   cur = cur->xmlChildrenNode;
   while (cur != NULL)
@@ -594,13 +622,7 @@ std::unique_ptr<WaveFunctionComponent> RadialJastrowBuilder::buildComponent(xmlN
         static_assert(std::is_same<JastrowTypeHelper<BsplineFunctor<RealType>, OMPTARGET>::J2Type,
                                    J2OMPTarget<BsplineFunctor<RealType>>>::value,
                       "check consistent type");
-        if (targetPtcl.getCoordinates().getKind() != DynamicCoordinateKind::DC_POS_OFFLOAD)
-        {
-          std::ostringstream msg;
-          msg << "Offload enabled Jastrow needs the gpu=\"yes\" attribute in the \"" << targetPtcl.getName()
-              << "\" particleset" << std::endl;
-          myComm->barrier_and_abort(msg.str());
-        }
+        guardAgainstNonOffloadTarget();
         app_summary() << "    Running on an accelerator via OpenMP offload." << std::endl;
         return createJ2<BsplineFunctor<RealType>, detail::OMPTARGET>(cur);
       }
@@ -616,6 +638,14 @@ std::unique_ptr<WaveFunctionComponent> RadialJastrowBuilder::buildComponent(xmlN
     }
     else if (Jastfunction == "user")
     {
+#if defined(ENABLE_OFFLOAD)
+      if (useGPU == "yes")
+      {
+        guardAgainstNonOffloadTarget();
+        app_summary() << "    Running on an accelerator via OpenMP offload." << std::endl;
+        return createJ2<UserFunctor<RealType>, detail::OMPTARGET>(cur);
+      }
+#endif
       return createJ2<UserFunctor<RealType>>(cur);
     }
     else if (Jastfunction == "rpa" || Jastfunction == "yukawa")
@@ -75,6 +75,7 @@ private:
 
   void guardAgainstOBC();
   void guardAgainstPBC();
+  void guardAgainstNonOffloadTarget();
 };
 
 } // namespace qmcplusplus
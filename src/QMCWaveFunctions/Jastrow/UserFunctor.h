@@ -34,6 +34,7 @@
 // #include <vector>
 #include "OhmmsPETE/TinyVector.h"
 #include "OMPTarget/OffloadAlignedAllocators.hpp"
+#include "OMPTarget/OMPTargetMath.hpp"
 
 
 namespace qmcplusplus
@@ -106,6 +107,38 @@ struct UserFunctor : public OptimizableFunctorBase
   }
 
 
+
+  // packed parameters for the multi-walker kernels
+
+  /// number of values packed by packParameters
+  static constexpr int NUM_PACKED_PARAMS = 2;
+
+  /// copy the parameters into params[NUM_PACKED_PARAMS] for the multi-walker kernels
+  inline void packParameters(T* params) const
+  {
+    params[0] = A;
+    params[1] = B;
+  }
+
+  /// evaluate the value from packed parameters. Usable inside offload regions.
+  inline static T evaluate_impl(T r, const T* params)
+  {
+    const T A = params[0];
+    const T B = params[1];
+    return A * r / (B * r + 1) - A / B;
+  }
+
+  /// evaluate the value, first and second derivatives from packed parameters. Usable inside offload regions.
+  inline static T evaluate_impl(T r, const T* params, T& dudr, T& d2udr2)
+  {
+    const T A = params[0];
+    const T B = params[1];
+    dudr      = -A * B * r / ((B * r + 1) * (B * r + 1)) + A / (B * r + 1);
+    d2udr2    = 2 * A * B * (B * r / (B * r + 1) - 1) / ((B * r + 1) * (B * r + 1));
+    return A * r / (B * r + 1) - A / B;
+  }
+
+
   inline real_type evaluateV(const int iat,
                              const int iStart,
                              const int iEnd,
@@ -120,8 +153,25 @@ struct UserFunctor : public OptimizableFunctorBase
     return sum;
   }
 
-  /** evaluate sum of the pair potentials FIXME
-   * @return \f$\sum u(r_j)\f$ for r_j < cutoff_radius
+  /** pack the parameters of all the functors into transfer_buffer
+   * @return the number of bytes used by the packed parameters
+   */
+  static size_t packAllParameters(const int num_groups,
+                                  const UserFunctor* const functors[],
+                                  Vector<char, OffloadPinnedAllocator<char>>& transfer_buffer,
+                                  const size_t extra_bytes = 0)
+  {
+    const size_t param_bytes = sizeof(T) * NUM_PACKED_PARAMS * num_groups;
+    transfer_buffer.resize(param_bytes + extra_bytes);
+    T* mw_params_ptr = reinterpret_cast<T*>(transfer_buffer.data());
+    for (int ig = 0; ig < num_groups; ig++)
+      functors[ig]->packParameters(mw_params_ptr + ig * NUM_PACKED_PARAMS);
+    return param_bytes;
+  }
+
+  /** evaluate sum of the pair potentials
+   * same arguments as BsplineFunctor::mw_evaluateV
+   * @return \f$\sum u(r_j)\f$
    */
   static void mw_evaluateV(const int num_groups,
                            const UserFunctor* const functors[],
@@ -134,16 +184,28 @@ struct UserFunctor : public OptimizableFunctorBase
                            T* mw_vals,
                            Vector<char, OffloadPinnedAllocator<char>>& transfer_buffer)
   {
+    /* transfer buffer used for the packed parameters NUM_PACKED_PARAMS * sizeof(T) per group
+     * these contents change based on the group of the target particle, so it is prepared per call.
+     */
+    packAllParameters(num_groups, functors, transfer_buffer);
+    auto* transfer_buffer_ptr = transfer_buffer.data();
+
+    PRAGMA_OFFLOAD("omp target teams distribute map(always, to:transfer_buffer_ptr[:transfer_buffer.size()]) \
+                    map(to: grp_ids[:n_src]) \
+                    map(to:ref_at[:num_pairs], mw_dist[:dist_stride*num_pairs]) \
+                    map(always, from:mw_vals[:num_pairs])")
     for (int ip = 0; ip < num_pairs; ip++)
     {
-      mw_vals[ip] = 0;
+      T sum              = 0;
+      const T* dist      = mw_dist + ip * dist_stride;
+      const T* mw_params = reinterpret_cast<const T*>(transfer_buffer_ptr);
+#if !defined(QMC_OFFLOAD_ROCM_WORKAROUND_BRANCH_IN_PARALLEL)
+      PRAGMA_OFFLOAD("omp parallel for reduction(+: sum)")
+#endif
       for (int j = 0; j < n_src; j++)
-      {
-        const int ig = grp_ids[j];
-        auto& functor(*functors[ig]);
         if (j != ref_at[ip])
-          mw_vals[ip] += functor.evaluate(mw_dist[ip * dist_stride + j]);
-      }
+          sum += evaluate_impl(dist[j], mw_params + grp_ids[j] * NUM_PACKED_PARAMS);
+      mw_vals[ip] = sum;
     }
   }
 
@@ -167,6 +229,9 @@ struct UserFunctor : public OptimizableFunctorBase
       valArray[iat] = gradArray[iat] = laplArray[iat] = T(0);
   }
 
+  /** compute value, gradient and laplacian for target particles
+   * same arguments as BsplineFunctor::mw_evaluateVGL
+   */
   static void mw_evaluateVGL(const int iat,
                              const int num_groups,
                              const UserFunctor* const functors[],
@@ -179,7 +244,63 @@ struct UserFunctor : public OptimizableFunctorBase
                              T* mw_cur_allu,   // [nw][3][n_padded]
                              Vector<char, OffloadPinnedAllocator<char>>& transfer_buffer)
   {
-    throw std::runtime_error("UserFunctor mw_evaluateVGL not implemented!");
+    constexpr unsigned DIM = OHMMS_DIM;
+    static_assert(DIM == 3, "only support 3D due to explicit x,y,z coded.");
+    const size_t dist_stride = n_padded * (DIM + 1);
+
+    packAllParameters(num_groups, functors, transfer_buffer);
+    auto* transfer_buffer_ptr = transfer_buffer.data();
+
+    PRAGMA_OFFLOAD("omp target teams distribute map(always, to: transfer_buffer_ptr[:transfer_buffer.size()]) \
+                    map(to: grp_ids[:n_src]) \
+                    map(to: mw_dist[:dist_stride*nw]) \
+                    map(from: mw_cur_allu[:n_padded*3*nw]) \
+                    map(always, from: mw_vgl[:(DIM+2)*nw])")
+    for (int ip = 0; ip < nw; ip++)
+    {
+      T val_sum(0);
+      T grad_x(0);
+      T grad_y(0);
+      T grad_z(0);
+      T lapl(0);
+
+      const T* dist   = mw_dist + ip * dist_stride;
+      const T* dipl_x = dist + n_padded;
+      const T* dipl_y = dist + n_padded * 2;
+      const T* dipl_z = dist + n_padded * 3;
+
+      const T* mw_params = reinterpret_cast<const T*>(transfer_buffer_ptr);
+
+      T* cur_allu = mw_cur_allu + ip * n_padded * 3;
+
+#if !defined(QMC_OFFLOAD_ROCM_WORKAROUND_BRANCH_IN_PARALLEL)
+      PRAGMA_OFFLOAD("omp parallel for reduction(+: val_sum, grad_x, grad_y, grad_z, lapl)")
+#endif
+      for (int j = 0; j < n_src; j++)
+      {
+        if (j == iat) continue;
+        T dudr(0);
+        T d2udr2(0);
+        const T u = evaluate_impl(dist[j], mw_params + grp_ids[j] * NUM_PACKED_PARAMS, dudr, d2udr2);
+        dudr *= T(1) / dist[j];
+        // save u, dudr/r and d2udr2 to cur_allu
+        cur_allu[j]                = u;
+        cur_allu[j + n_padded]     = dudr;
+        cur_allu[j + n_padded * 2] = d2udr2;
+        val_sum += u;
+        lapl += d2udr2 + (DIM - 1) * dudr;
+        grad_x += dudr * dipl_x[j];
+        grad_y += dudr * dipl_y[j];
+        grad_z += dudr * dipl_z[j];
+      }
+
+      T* vgl = mw_vgl + ip * (DIM + 2);
+      vgl[0] = val_sum;
+      vgl[1] = grad_x;
+      vgl[2] = grad_y;
+      vgl[3] = grad_z;
+      vgl[4] = -lapl;
+    }
   }
 
   inline real_type f(real_type r) override { return evaluate(r); }
@@ -191,6 +312,9 @@ struct UserFunctor : public OptimizableFunctorBase
     return dudr;
   }
 
+  /** update value, gradient and laplacian for target particles
+   * same arguments as BsplineFunctor::mw_updateVGL
+   */
   static void mw_updateVGL(const int iat,
                            const std::vector<bool>& isAccepted,
                            const int num_groups,
@@ -201,11 +325,96 @@ struct UserFunctor : public OptimizableFunctorBase
                            T* mw_vgl, // [nw][DIM+2]
                            const int n_padded,
                            const T* mw_dist, // [nw][DIM+1][n_padded]
-                           T* mw_allUat,     // [nw][DIM+2][n_padded]
-                           T* mw_cur_allu,   // [nw][3][n_padded]
+                           T* mw_allUat,      // [nw][DIM+2][n_padded]
+                           T* mw_allUat_comp, // [nw][DIM+2][n_padded]
+                           T* mw_cur_allu,    // [nw][3][n_padded]
                            Vector<char, OffloadPinnedAllocator<char>>& transfer_buffer)
   {
-    throw std::runtime_error("UserFunctor mw_updateVGL not implemented!");
+    constexpr unsigned DIM = OHMMS_DIM;
+    static_assert(DIM == 3, "only support 3D due to explicit x,y,z coded.");
+    const size_t dist_stride = n_padded * (DIM + 1);
+
+    /* transfer buffer used for the packed parameters and the packed accept list at most nw * sizeof(int)
+     */
+    const size_t param_bytes = packAllParameters(num_groups, functors, transfer_buffer, nw * sizeof(int));
+    int* accepted_indices    = reinterpret_cast<int*>(transfer_buffer.data() + param_bytes);
+
+    int nw_accepted = 0;
+    for (int iw = 0; iw < nw; iw++)
+      if (isAccepted[iw])
+        accepted_indices[nw_accepted++] = iw;
+
+    auto* transfer_buffer_ptr = transfer_buffer.data();
+
+    PRAGMA_OFFLOAD("omp target teams distribute map(always, to: transfer_buffer_ptr[:transfer_buffer.size()]) \
+                    map(to: grp_ids[:n_src]) \
+                    map(to: mw_dist[:dist_stride*nw]) \
+                    map(to: mw_vgl[:(DIM+2)*nw]) \
+                    map(always, from: mw_allUat[:nw * n_padded * (DIM + 2)]) \
+                    map(to: mw_allUat_comp[:nw * n_padded * (DIM + 2)])")
+    for (int iw = 0; iw < nw_accepted; iw++)
+    {
+      const T* mw_params    = reinterpret_cast<const T*>(transfer_buffer_ptr);
+      int* accepted_indices = reinterpret_cast<int*>(transfer_buffer_ptr + param_bytes);
+      const int ip          = accepted_indices[iw];
+
+      const T* dist_new   = mw_dist + ip * dist_stride;
+      const T* dipl_x_new = dist_new + n_padded;
+      const T* dipl_y_new = dist_new + n_padded * 2;
+      const T* dipl_z_new = dist_new + n_padded * 3;
+
+      const T* dist_old   = mw_dist + ip * dist_stride + dist_stride * nw;
+      const T* dipl_x_old = dist_old + n_padded;
+      const T* dipl_y_old = dist_old + n_padded * 2;
+      const T* dipl_z_old = dist_old + n_padded * 3;
+
+      T* Uat    = mw_allUat + ip * n_padded;
+      T* dUat_x = mw_allUat + n_padded * nw + ip * n_padded * DIM;
+      T* dUat_y = dUat_x + n_padded;
+      T* dUat_z = dUat_y + n_padded;
+      T* d2Uat  = mw_allUat + n_padded * (DIM + 1) * nw + ip * n_padded;
+
+      T* Uat_c    = mw_allUat_comp + ip * n_padded;
+      T* dUat_x_c = mw_allUat_comp + n_padded * nw + ip * n_padded * DIM;
+      T* dUat_y_c = dUat_x_c + n_padded;
+      T* dUat_z_c = dUat_y_c + n_padded;
+      T* d2Uat_c  = mw_allUat_comp + n_padded * (DIM + 1) * nw + ip * n_padded;
+
+      T* cur_allu = mw_cur_allu + ip * n_padded * 3;
+
+#if !defined(QMC_OFFLOAD_ROCM_WORKAROUND_BRANCH_IN_PARALLEL)
+      PRAGMA_OFFLOAD("omp parallel for")
+#endif
+      for (int j = 0; j < n_src; j++)
+      {
+        if (j == iat) continue;
+        T dudr(0);
+        T d2udr2(0);
+        const T u = evaluate_impl(dist_old[j], mw_params + grp_ids[j] * NUM_PACKED_PARAMS, dudr, d2udr2);
+        dudr *= T(1) / dist_old[j];
+        // update Uat, dUat, d2Uat
+        T cur_u      = cur_allu[j];
+        T cur_dudr   = cur_allu[j + n_padded];
+        T cur_d2udr2 = cur_allu[j + n_padded * 2];
+        omptarget::kahanAdd(Uat[j], Uat_c[j], cur_u - u);
+        omptarget::kahanAdd(dUat_x[j], dUat_x_c[j], dipl_x_old[j] * dudr - dipl_x_new[j] * cur_dudr);
+        omptarget::kahanAdd(dUat_y[j], dUat_y_c[j], dipl_y_old[j] * dudr - dipl_y_new[j] * cur_dudr);
+        omptarget::kahanAdd(dUat_z[j], dUat_z_c[j], dipl_z_old[j] * dudr - dipl_z_new[j] * cur_dudr);
+        constexpr T lapfac(DIM - 1);
+        omptarget::kahanAdd(d2Uat[j], d2Uat_c[j], d2udr2 + lapfac * dudr - (cur_d2udr2 + lapfac * cur_dudr));
+      }
+      const T* vgl  = mw_vgl + ip * (DIM + 2);
+      Uat[iat]      = vgl[0];
+      dUat_x[iat]   = vgl[1];
+      dUat_y[iat]   = vgl[2];
+      dUat_z[iat]   = vgl[3];
+      d2Uat[iat]    = vgl[4];
+      Uat_c[iat]    = T(0);
+      dUat_x_c[iat] = T(0);
+      dUat_y_c[iat] = T(0);
+      dUat_z_c[iat] = T(0);
+      d2Uat_c[iat]  = T(0);
+    }
   }
 
   // inline bool evaluateDerivatives(real_type r, std::vector<TinyVector<real_type, 3>>& derivs)
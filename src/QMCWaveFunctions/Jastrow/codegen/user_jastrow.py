@@ -156,7 +156,7 @@ def gen_param_defs(param_list, input_param=None):
 # Function for setting the cusp value
 def gen_set_cusp(cusp_param):
   out_str = """
-  void setCusp(real_type cusp)
+  void setCusp(real_type cusp) override
   {
     %(var_name)s     = cusp;
     %(opt_var_name)s = false;
@@ -217,6 +217,52 @@ def gen_evaluate_2nd_deriv(f, df, ddf):
   return s
 
 
+# Packed parameters and static evaluation functions used by the multi-walker kernels.
+# The parameter count is a compile-time constant so the kernels can index the packed array per group.
+def gen_packed_evaluate(f, df, ddf, param_list, input_param_list=None):
+  out_str = """
+  /// number of values packed by packParameters
+  static constexpr int NUM_PACKED_PARAMS = %(num_params)d;
+
+  /// copy the parameters into params[NUM_PACKED_PARAMS] for the multi-walker kernels
+  inline void packParameters(T* params) const
+  {
+%(pack)s  }
+
+  /// evaluate the value from packed parameters. Usable inside offload regions.
+  inline static T evaluate_impl(T r, const T* params)
+  {
+%(unpack)s    return %(val)s;
+  }
+
+  /// evaluate the value, first and second derivatives from packed parameters. Usable inside offload regions.
+  inline static T evaluate_impl(T r, const T* params, T& dudr, T& d2udr2)
+  {
+%(unpack)s    dudr      = %(df)s;
+    d2udr2    = %(ddf)s;
+    return %(val)s;
+  }
+"""
+
+  all_params = list(param_list)
+  if input_param_list:
+    all_params += list(input_param_list)
+
+  pack = ""
+  unpack = ""
+  for idx, var_name in enumerate(all_params):
+    pack += "    params[%d] = %s;\n"%(idx, var_name)
+    unpack += "    const T %s = params[%d];\n"%(var_name, idx)
+
+  s = out_str%{"num_params":len(all_params), "pack":pack, "unpack":unpack,
+               "val":CP.doprint(f), "df":CP.doprint(df), "ddf":CP.doprint(ddf)}
+  print('Creating packed parameter evaluate functions')
+  print(s)
+  print('')
+
+  return s
+
+
 # Evaluate function plus first, second, and third derivatives
 def gen_evaluate_3rd_deriv(f, df, ddf, d3f):
 
@@ -247,7 +293,7 @@ def gen_evaluate_parameter_derivatives(variational_parameters, param_derivs):
 
   func_out_str = """
   /// compute derivatives with respect to variational parameters
-  inline bool evaluateDerivatives(real_type r, std::vector<real_type>& derivs)
+  inline bool evaluateDerivatives(real_type r, std::vector<real_type>& derivs) override
   {
     int i = 0;
     %s
@@ -283,7 +329,7 @@ def gen_evaluate_parameter_derivatives(variational_parameters, param_derivs):
 # Evaluate derivatives of the function (and spatial derivatives) with respect to the parameters
 def gen_evaluate_all_parameter_derivatives(variational_parameters, param_derivs):
   func_out_str = """
-  inline bool evaluateDerivatives(real_type r, std::vector<TinyVector<real_type, 3>>& derivs)
+  inline bool evaluateDerivatives(real_type r, std::vector<TinyVector<real_type, 3>>& derivs) override
   {
     int i = 0;
     %s
@@ -321,7 +367,7 @@ def gen_evaluate_all_parameter_derivatives(variational_parameters, param_derivs)
 #  Handle the XML input
 def gen_xml_input(param_list, input_param_list=None):
   out_str="""
-  bool put(xmlNodePtr cur)
+  bool put(xmlNodePtr cur) override
   {
     cur = cur->xmlChildrenNode;
     while (cur != NULL)
@@ -387,7 +433,7 @@ def gen_xml_input(param_list, input_param_list=None):
 # Code for resetting the parameters
 def gen_reset_parameters(param_list):
   out_str = """
-  void resetParameters(const opt_variables_type& active)
+  void resetParameters(const opt_variables_type& active) override
   {
     if (myVars.size())
     {
@@ -503,6 +549,7 @@ def run_all(f, variational_parameters, input_parameters, cusp_param):
     'evaluate_func' : gen_evaluate(f),
     'evaluate_func_2nd_derivative' : gen_evaluate_2nd_deriv(f, df, ddf),
     'evaluate_func_3rd_derivative' : gen_evaluate_3rd_deriv(f, df, ddf, d3f),
+    'packed_evaluate' : gen_packed_evaluate(f, df, ddf, variational_parameters, input_parameters),
     'evaluate_parameter_derivative' : gen_evaluate_parameter_derivatives(variational_parameters, param_derivs),
     'evaluate_all_parameter_derivatives' : gen_evaluate_all_parameter_derivatives(variational_parameters, param_derivs),
     'xml_input' : gen_xml_input(variational_parameters, input_parameters),
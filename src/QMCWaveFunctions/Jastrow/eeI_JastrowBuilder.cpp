@@ -20,6 +20,10 @@
 #include "Utilities/ProgressReportEngine.h"
 #include "QMCWaveFunctions/Jastrow/PolynomialFunctor3D.h"
 
+#if defined(ENABLE_OFFLOAD)
+#include "QMCWaveFunctions/Jastrow/JeeIOMPTarget.h"
+#endif
+
 namespace qmcplusplus
 {
 eeI_JastrowBuilder::eeI_JastrowBuilder(Communicate* comm, ParticleSet& target, ParticleSet& source)
@@ -125,8 +129,12 @@ std::unique_ptr<WaveFunctionComponent> eeI_JastrowBuilder::buildComponent(xmlNod
   if (sourcePtcl)
   {
     std::string ftype("polynomial");
+    std::string useGPU;
     OhmmsAttributeSet tAttrib;
     tAttrib.add(ftype, "function");
+#if defined(ENABLE_OFFLOAD)
+    tAttrib.add(useGPU, "gpu", {"yes", "no"});
+#endif
     tAttrib.put(cur);
 
     std::string input_name(getXMLAttributeValue(cur, "name"));
@@ -134,6 +142,23 @@ std::unique_ptr<WaveFunctionComponent> eeI_JastrowBuilder::buildComponent(xmlNod
     SpeciesSet& iSet  = sourcePtcl->getSpeciesSet();
     if (ftype == "polynomial")
     {
+#if defined(ENABLE_OFFLOAD)
+      if (useGPU == "yes")
+      {
+        if (targetPtcl.getCoordinates().getKind() != DynamicCoordinateKind::DC_POS_OFFLOAD)
+        {
+          std::ostringstream msg;
+          msg << "Offload enabled Jastrow needs the gpu=\"yes\" attribute in the \"" << targetPtcl.getName()
+              << "\" particleset" << std::endl;
+          myComm->barrier_and_abort(msg.str());
+        }
+        app_summary() << "    Running on an accelerator via OpenMP offload." << std::endl;
+        using J3Type = JeeIOMPTarget<PolynomialFunctor3D>;
+        auto J3      = std::make_unique<J3Type>(jname, *sourcePtcl, targetPtcl);
+        putkids(kids, *J3);
+        return J3;
+      }
+#endif
       using J3Type = JeeIOrbitalSoA<PolynomialFunctor3D>;
       auto J3      = std::make_unique<J3Type>(jname, *sourcePtcl, targetPtcl, true);
       putkids(kids, *J3);
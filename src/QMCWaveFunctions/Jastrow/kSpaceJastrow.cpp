@@ -290,10 +290,10 @@ kSpaceJastrow::kSpaceJastrow(const ParticleSet& ions,
   TwoBodyPhase.resize(nTwo);
   TwoBody_e2iGr_new.resize(nTwo);
   TwoBody_e2iGr_old.resize(nTwo);
-  Delta_e2iGr.resize(nelecs, nTwo);
-  for (int iat = 0; iat < nelecs; iat++)
-    for (int i = 0; i < nTwo; i++)
-      Delta_e2iGr(iat, i) = ComplexType();
+  TwoBody_e2iGr_elec.resize(nelecs, nTwo);
+  OneBody_Uat.resize(nelecs);
+  OneBody_U_new = 0.0;
+  DiffVal       = 0.0;
   // Set Ion_rhoG
   for (int i = 0; i < OneBodyGvecs.size(); i++)
   {
@@ -363,6 +363,70 @@ void kSpaceJastrow::setCoefficients(std::vector<RealType>& oneBodyCoefs, std::ve
 //                  Evaluation functions                     //
 ///////////////////////////////////////////////////////////////
 
+kSpaceJastrow::RealType kSpaceJastrow::computeOneBody(const PosType& r, GradType* grad)
+{
+  RealType J1(0.0);
+  const int nOne = OneBodyGvecs.size();
+  if (nOne == 0)
+    return J1;
+  ComplexType eye(0.0, 1.0);
+  for (int i = 0; i < nOne; i++)
+    OneBodyPhase[i] = dot(OneBodyGvecs[i], r);
+  eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
+  for (int i = 0; i < nOne; i++)
+  {
+    ComplexType z = OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]);
+    J1 += Prefactor * real(z);
+    if (grad)
+      *grad += -Prefactor * real(z * eye) * OneBodyGvecs[i];
+  }
+  return J1;
+}
+
+void kSpaceJastrow::computeTwoBodyE2iGr(const PosType& r, ComplexType* restrict e2iGr)
+{
+  const int nTwo = TwoBodyGvecs.size();
+  if (nTwo == 0)
+    return;
+  for (int i = 0; i < nTwo; i++)
+    TwoBodyPhase[i] = dot(TwoBodyGvecs[i], r);
+  eval_e2iphi(nTwo, TwoBodyPhase.data(), e2iGr);
+}
+
+kSpaceJastrow::RealType kSpaceJastrow::computeTwoBodyRatio(int iat,
+                                                           const ComplexType* restrict e2iGr_new,
+                                                           GradType* grad) const
+{
+  const int nTwo                        = TwoBodyGvecs.size();
+  const ComplexType* restrict e2iGr_old = TwoBody_e2iGr_elec[iat];
+  RealType dJ2(0.0);
+  for (int i = 0; i < nTwo; i++)
+  {
+    const ComplexType rho_G_new = TwoBody_rhoG[i] + e2iGr_new[i] - e2iGr_old[i];
+    dJ2 += Prefactor * TwoBodyCoefs[i] * (std::norm(rho_G_new) - std::norm(TwoBody_rhoG[i]));
+    // the gradient at the new position uses rho_G including the moved particle
+    if (grad)
+      *grad += -Prefactor * 2.0 * TwoBodyGvecs[i] * TwoBodyCoefs[i] *
+          imag(qmcplusplus::conj(rho_G_new) * e2iGr_new[i]);
+  }
+  return dJ2;
+}
+
+void kSpaceJastrow::computeRhoG(const ParticleSet& P)
+{
+  const int N    = P.getTotalNum();
+  const int nTwo = TwoBodyGvecs.size();
+  for (int i = 0; i < nTwo; i++)
+    TwoBody_rhoG[i] = ComplexType();
+  for (int iat = 0; iat < N; iat++)
+  {
+    computeTwoBodyE2iGr(P.R[iat], TwoBody_e2iGr_elec[iat]);
+    const ComplexType* restrict e2iGr = TwoBody_e2iGr_elec[iat];
+    for (int i = 0; i < nTwo; i++)
+      TwoBody_rhoG[i] += e2iGr[i];
+  }
+}
+
 kSpaceJastrow::LogValueType kSpaceJastrow::evaluateLog(const ParticleSet& P,
                                                        ParticleSet::ParticleGradient& G,
                                                        ParticleSet::ParticleLaplacian& L)
@@ -374,157 +438,61 @@ kSpaceJastrow::LogValueType kSpaceJastrow::evaluateLog(const ParticleSet& P,
   for (int iat = 0; iat < N; iat++)
   {
     PosType r(P.R[iat]);
+    OneBody_Uat[iat] = 0.0;
+    if (nOne == 0)
+      continue;
     for (int i = 0; i < nOne; i++)
       OneBodyPhase[i] = dot(OneBodyGvecs[i], r);
     eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
     for (int i = 0; i < nOne; i++)
     {
       ComplexType z = OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]);
-      J1 += Prefactor * real(z);
+      OneBody_Uat[iat] += Prefactor * real(z);
       G[iat] += -Prefactor * real(z * eye) * OneBodyGvecs[i];
       L[iat] += -Prefactor * dot(OneBodyGvecs[i], OneBodyGvecs[i]) * real(z);
     }
+    J1 += OneBody_Uat[iat];
   }
   // Do two-body part
   int nTwo = TwoBodyGvecs.size();
-  for (int i = 0; i < nTwo; i++)
-    TwoBody_rhoG[i] = ComplexType();
-  for (int iat = 0; iat < N; iat++)
-  {
-    PosType r(P.R[iat]);
-    for (int iG = 0; iG < nTwo; iG++)
-      TwoBodyPhase[iG] = dot(TwoBodyGvecs[iG], r);
-    eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_new);
-    for (int iG = 0; iG < nTwo; iG++)
-      TwoBody_rhoG[iG] += TwoBody_e2iGr_new[iG];
-  }
-  //     std::cerr << "TwoBody_rhoG = ";
-  //     for (int i=0; i<nTwo; i++)
-  //       std::cerr << TwoBody_rhoG[i]  << "  ";
-  //     std::cerr << std::endl;
+  computeRhoG(P);
   for (int i = 0; i < nTwo; i++)
     J2 += Prefactor * TwoBodyCoefs[i] * norm(TwoBody_rhoG[i]);
   for (int iat = 0; iat < N; iat++)
   {
-    PosType r(P.R[iat]);
-    for (int i = 0; i < nTwo; i++)
-      TwoBodyPhase[i] = dot(TwoBodyGvecs[i], r);
-    eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_new);
+    const ComplexType* restrict e2iGr = TwoBody_e2iGr_elec[iat];
     for (int i = 0; i < nTwo; i++)
     {
       PosType Gvec(TwoBodyGvecs[i]);
-      ComplexType z = TwoBody_e2iGr_new[i];
+      ComplexType z = e2iGr[i];
       G[iat] += -Prefactor * 2.0 * Gvec * TwoBodyCoefs[i] * imag(qmcplusplus::conj(TwoBody_rhoG[i]) * z);
       L[iat] +=
           Prefactor * 2.0 * TwoBodyCoefs[i] * dot(Gvec, Gvec) * (-real(z * qmcplusplus::conj(TwoBody_rhoG[i])) + 1.0);
     }
   }
-  return J1 + J2;
+  return log_value_ = J1 + J2;
 }
 
 
 kSpaceJastrow::GradType kSpaceJastrow::evalGrad(ParticleSet& P, int iat)
 {
-  //     RealType J1(0.0), J2(0.0);
   kSpaceJastrow::GradType G;
-  int N = P.getTotalNum();
-  ComplexType eye(0.0, 1.0);
-  int nOne = OneBodyGvecs.size();
-  //     for (int iat=0; iat<N; iat++) {
-  PosType r(P.R[iat]);
-  for (int i = 0; i < nOne; i++)
-    OneBodyPhase[i] = dot(OneBodyGvecs[i], r);
-  eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
-  for (int i = 0; i < nOne; i++)
-  {
-    ComplexType z = OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]);
-    //    J1 += Prefactor*real(z);
-    G += -Prefactor * real(z * eye) * OneBodyGvecs[i];
-    //    L[iat] += -Prefactor*dot(OneBodyGvecs[i],OneBodyGvecs[i])*real(z);
-  }
-  //     }
-  // Do two-body part
-  int nTwo = TwoBodyGvecs.size();
-  for (int i = 0; i < nTwo; i++)
-    TwoBody_rhoG[i] = ComplexType();
-  for (int iat2 = 0; iat2 < N; iat2++)
-  {
-    PosType rp(P.R[iat2]);
-    for (int iG = 0; iG < nTwo; iG++)
-      TwoBodyPhase[iG] = dot(TwoBodyGvecs[iG], rp);
-    eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_new);
-    for (int iG = 0; iG < nTwo; iG++)
-      TwoBody_rhoG[iG] += TwoBody_e2iGr_new[iG];
-  }
-  //     std::cerr << "TwoBody_rhoG = ";
-  //     for (int i=0; i<nTwo; i++)
-  //       std::cerr << TwoBody_rhoG[i]  << "  ";
-  //     std::cerr << std::endl;
-  //     for (int i=0; i<nTwo; i++)
-  //       J2 += Prefactor*TwoBodyCoefs[i]*norm(TwoBody_rhoG[i]);
-  //     for (int iat=0; iat<N; iat++) {
-  //       PosType r(P.R[iat]);
+  computeOneBody(P.R[iat], &G);
+  // Do two-body part with the up-to-date rho_G and e^{iG.r} of iat
+  const int nTwo                    = TwoBodyGvecs.size();
+  const ComplexType* restrict e2iGr = TwoBody_e2iGr_elec[iat];
   for (int i = 0; i < nTwo; i++)
-    TwoBodyPhase[i] = dot(TwoBodyGvecs[i], r);
-  eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_new);
-  for (int i = 0; i < nTwo; i++)
-  {
-    PosType Gvec(TwoBodyGvecs[i]);
-    ComplexType z = TwoBody_e2iGr_new[i];
-    G += -Prefactor * 2.0 * Gvec * TwoBodyCoefs[i] * imag(qmcplusplus::conj(TwoBody_rhoG[i]) * z);
-    //    L[iat] += Prefactor*2.0*TwoBodyCoefs[i]*dot(Gvec,Gvec)*(-real(z*qmcplusplus::conj(TwoBody_rhoG[i])) + 1.0);
-  }
-  //     }
+    G += -Prefactor * 2.0 * TwoBodyGvecs[i] * TwoBodyCoefs[i] * imag(qmcplusplus::conj(TwoBody_rhoG[i]) * e2iGr[i]);
   return G;
 }
 
 kSpaceJastrow::PsiValueType kSpaceJastrow::ratioGrad(ParticleSet& P, int iat, GradType& grad_iat)
 {
-  ComplexType eye(0.0, 1.0);
-  RealType J1new(0.0), J1old(0.0), J2new(0.0), J2old(0.0);
-  const PosType &rnew(P.getActivePos()), &rold(P.R[iat]);
-  // Compute one-body contribution
-  int nOne = OneBodyGvecs.size();
-  for (int i = 0; i < nOne; i++)
-    OneBodyPhase[i] = dot(OneBodyGvecs[i], rnew);
-  eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
-  for (int i = 0; i < nOne; i++)
-  {
-    ComplexType z = OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]);
-    J1new += Prefactor * real(z);
-    grad_iat += -Prefactor * real(z * eye) * OneBodyGvecs[i];
-  }
-  for (int i = 0; i < nOne; i++)
-    OneBodyPhase[i] = dot(OneBodyGvecs[i], rold);
-  eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
-  for (int i = 0; i < nOne; i++)
-    J1old += Prefactor * real(OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]));
-  // Now, do two-body part
-  int nTwo = TwoBodyGvecs.size();
-  for (int i = 0; i < nTwo; i++)
-    TwoBodyPhase[i] = dot(TwoBodyGvecs[i], rold);
-  eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_old);
-  for (int i = 0; i < nTwo; i++)
-    TwoBodyPhase[i] = dot(TwoBodyGvecs[i], rnew);
-  eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_new);
-  for (int i = 0; i < nTwo; i++)
-  {
-    ComplexType rho_G = TwoBody_rhoG[i];
-    J2old += Prefactor * TwoBodyCoefs[i] * std::norm(rho_G);
-  }
-  for (int i = 0; i < nTwo; i++)
-  {
-    ComplexType rho_G = TwoBody_rhoG[i] + TwoBody_e2iGr_new[i] - TwoBody_e2iGr_old[i];
-    J2new += Prefactor * TwoBodyCoefs[i] * std::norm(rho_G);
-  }
-  for (int i = 0; i < nTwo; i++)
-  {
-    PosType Gvec(TwoBodyGvecs[i]);
-    ComplexType z = TwoBody_e2iGr_new[i];
-    grad_iat += -Prefactor * 2.0 * TwoBodyGvecs[i] * TwoBodyCoefs[i] *
-        imag(qmcplusplus::conj(TwoBody_rhoG[i]) * TwoBody_e2iGr_new[i]);
-  }
-  return std::exp(static_cast<PsiValueType>(J1new + J2new - (J1old + J2old)));
+  const PosType& rnew(P.getActivePos());
+  OneBody_U_new = computeOneBody(rnew, &grad_iat);
+  computeTwoBodyE2iGr(rnew, TwoBody_e2iGr_new.data());
+  DiffVal = OneBody_U_new - OneBody_Uat[iat] + computeTwoBodyRatio(iat, TwoBody_e2iGr_new.data(), &grad_iat);
+  return std::exp(static_cast<PsiValueType>(DiffVal));
 }
 
 /* evaluate the ratio with P.R[iat]
@@ -532,81 +500,85 @@ kSpaceJastrow::PsiValueType kSpaceJastrow::ratioGrad(ParticleSet& P, int iat, Gr
  */
 kSpaceJastrow::PsiValueType kSpaceJastrow::ratio(ParticleSet& P, int iat)
 {
-  RealType J1new(0.0), J1old(0.0), J2new(0.0), J2old(0.0);
-  const PosType &rnew(P.getActivePos()), &rold(P.R[iat]);
-  // Compute one-body contribution
-  int nOne = OneBodyGvecs.size();
-  for (int i = 0; i < nOne; i++)
-    OneBodyPhase[i] = dot(OneBodyGvecs[i], rnew);
-  eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
-  for (int i = 0; i < nOne; i++)
-    J1new += Prefactor * real(OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]));
-  for (int i = 0; i < nOne; i++)
-    OneBodyPhase[i] = dot(OneBodyGvecs[i], rold);
-  eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
-  for (int i = 0; i < nOne; i++)
-    J1old += Prefactor * real(OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]));
-  // Now, do two-body part
-  int nTwo = TwoBodyGvecs.size();
-  for (int i = 0; i < nTwo; i++)
-    TwoBodyPhase[i] = dot(TwoBodyGvecs[i], rold);
-  eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_old);
-  for (int i = 0; i < nTwo; i++)
-    TwoBodyPhase[i] = dot(TwoBodyGvecs[i], rnew);
-  eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_new);
-  for (int i = 0; i < nTwo; i++)
+  const PosType& rnew(P.getActivePos());
+  OneBody_U_new = computeOneBody(rnew, nullptr);
+  computeTwoBodyE2iGr(rnew, TwoBody_e2iGr_new.data());
+  DiffVal = OneBody_U_new - OneBody_Uat[iat] + computeTwoBodyRatio(iat, TwoBody_e2iGr_new.data(), nullptr);
+  return std::exp(static_cast<PsiValueType>(DiffVal));
+}
+
+void kSpaceJastrow::mw_computeTwoBodyE2iGr(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                           const RefVectorWithLeader<ParticleSet>& p_list)
+{
+  const int nw   = wfc_list.size();
+  const int nTwo = TwoBodyGvecs.size();
+  if (nTwo == 0)
+    return;
+  mw_TwoBodyPhase.resize(nw * nTwo);
+  mw_TwoBody_e2iGr.resize(nw * nTwo);
+  for (int iw = 0; iw < nw; iw++)
   {
-    ComplexType rho_G = TwoBody_rhoG[i];
-    J2old += Prefactor * TwoBodyCoefs[i] * std::norm(rho_G);
+    const PosType& rnew(p_list[iw].getActivePos());
+    RealType* restrict phase = mw_TwoBodyPhase.data() + iw * nTwo;
+    for (int i = 0; i < nTwo; i++)
+      phase[i] = dot(TwoBodyGvecs[i], rnew);
   }
-  for (int i = 0; i < nTwo; i++)
+  // a single dense evaluation for the whole crowd
+  eval_e2iphi(nw * nTwo, mw_TwoBodyPhase.data(), mw_TwoBody_e2iGr.data());
+  for (int iw = 0; iw < nw; iw++)
   {
-    ComplexType rho_G = TwoBody_rhoG[i] + TwoBody_e2iGr_new[i] - TwoBody_e2iGr_old[i];
-    J2new += Prefactor * TwoBodyCoefs[i] * std::norm(rho_G);
+    auto& wfc = wfc_list.getCastedElement<kSpaceJastrow>(iw);
+    std::copy_n(mw_TwoBody_e2iGr.data() + iw * nTwo, nTwo, wfc.TwoBody_e2iGr_new.data());
+  }
+}
+
+void kSpaceJastrow::mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                 const RefVectorWithLeader<ParticleSet>& p_list,
+                                 int iat,
+                                 std::vector<PsiValueType>& ratios) const
+{
+  auto& wfc_leader = wfc_list.getCastedLeader<kSpaceJastrow>();
+  wfc_leader.mw_computeTwoBodyE2iGr(wfc_list, p_list);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& wfc         = wfc_list.getCastedElement<kSpaceJastrow>(iw);
+    wfc.OneBody_U_new = wfc.computeOneBody(p_list[iw].getActivePos(), nullptr);
+    wfc.DiffVal       = wfc.OneBody_U_new - wfc.OneBody_Uat[iat] +
+        wfc.computeTwoBodyRatio(iat, wfc.TwoBody_e2iGr_new.data(), nullptr);
+    ratios[iw] = std::exp(static_cast<PsiValueType>(wfc.DiffVal));
+  }
+}
+
+void kSpaceJastrow::mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                 const RefVectorWithLeader<ParticleSet>& p_list,
+                                 int iat,
+                                 std::vector<PsiValueType>& ratios,
+                                 std::vector<GradType>& grad_new) const
+{
+  auto& wfc_leader = wfc_list.getCastedLeader<kSpaceJastrow>();
+  wfc_leader.mw_computeTwoBodyE2iGr(wfc_list, p_list);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& wfc         = wfc_list.getCastedElement<kSpaceJastrow>(iw);
+    wfc.OneBody_U_new = wfc.computeOneBody(p_list[iw].getActivePos(), &grad_new[iw]);
+    wfc.DiffVal       = wfc.OneBody_U_new - wfc.OneBody_Uat[iat] +
+        wfc.computeTwoBodyRatio(iat, wfc.TwoBody_e2iGr_new.data(), &grad_new[iw]);
+    ratios[iw] = std::exp(static_cast<PsiValueType>(wfc.DiffVal));
   }
-  return std::exp(static_cast<PsiValueType>(J1new + J2new - (J1old + J2old)));
 }
 
 /** evaluate the ratio
 */
 void kSpaceJastrow::evaluateRatiosAlltoOne(ParticleSet& P, std::vector<kSpaceJastrow::ValueType>& ratios)
 {
-  RealType J1new(0.0);
   const PosType& rnew(P.getActivePos());
   //     Compute one-body contribution
-  int nOne = OneBodyGvecs.size();
-  for (int i = 0; i < nOne; i++)
-    OneBodyPhase[i] = dot(OneBodyGvecs[i], rnew);
-  eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
-  // //
-  for (int i = 0; i < nOne; i++)
-    J1new += Prefactor * real(OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]));
+  const RealType J1new = computeOneBody(rnew, nullptr);
   // Now, do two-body part
-  int nTwo = TwoBodyGvecs.size();
-  for (int i = 0; i < nTwo; i++)
-    TwoBodyPhase[i] = dot(TwoBodyGvecs[i], rnew);
-  eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_new);
+  computeTwoBodyE2iGr(rnew, TwoBody_e2iGr_new.data());
   int N = P.getTotalNum();
   for (int n = 0; n < N; n++)
-  {
-    RealType J1old(0.0), J2Rat(0.0);
-    const PosType& rold(P.R[n]);
-    for (int i = 0; i < nOne; i++)
-      OneBodyPhase[i] = dot(OneBodyGvecs[i], rold);
-    eval_e2iphi(OneBodyPhase, OneBody_e2iGr);
-    for (int i = 0; i < nOne; i++)
-      J1old += Prefactor * real(OneBodyCoefs[i] * qmcplusplus::conj(OneBody_e2iGr[i]));
-    for (int i = 0; i < nTwo; i++)
-      TwoBodyPhase[i] = dot(TwoBodyGvecs[i], rold);
-    eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_old);
-    for (int i = 0; i < nTwo; i++)
-    {
-      ComplexType rho_G_new = TwoBody_rhoG[i] + TwoBody_e2iGr_new[i] - TwoBody_e2iGr_old[i];
-      ComplexType rho_G_old = TwoBody_rhoG[i];
-      J2Rat += Prefactor * TwoBodyCoefs[i] * (std::norm(rho_G_new) - std::norm(rho_G_old));
-    }
-    ratios[n] = std::exp(J1new - J1old + J2Rat);
-  }
+    ratios[n] = std::exp(J1new - OneBody_Uat[n] + computeTwoBodyRatio(n, TwoBody_e2iGr_new.data(), nullptr));
 }
 
 
@@ -618,13 +590,15 @@ void kSpaceJastrow::restore(int iat)
 
 void kSpaceJastrow::acceptMove(ParticleSet& P, int iat, bool safe_to_delay)
 {
+  // TwoBody_e2iGr_new and OneBody_U_new hold the proposed move of iat computed by ratio or ratioGrad
+  ComplexType* restrict e2iGr = TwoBody_e2iGr_elec[iat];
   for (int i = 0; i < TwoBody_e2iGr_new.size(); i++)
-    TwoBody_rhoG[i] += Delta_e2iGr(iat, i);
-  //TwoBody_e2iGr_new[i] - TwoBody_e2iGr_old[i];
-  // copy(eikr_new.data(),eikr_new.data()+MaxK,eikr[iat]);
-  // U += offU;
-  // dU += offdU;
-  // d2U += offd2U;
+  {
+    TwoBody_rhoG[i] += TwoBody_e2iGr_new[i] - e2iGr[i];
+    e2iGr[i] = TwoBody_e2iGr_new[i];
+  }
+  OneBody_Uat[iat] = OneBody_U_new;
+  log_value_ += DiffVal;
 }
 
 void kSpaceJastrow::registerData(ParticleSet& P, WFBufferType& buf)
@@ -657,16 +631,9 @@ kSpaceJastrow::LogValueType kSpaceJastrow::updateBuffer(ParticleSet& P, WFBuffer
 
 void kSpaceJastrow::copyFromBuffer(ParticleSet& P, WFBufferType& buf)
 {
-  for (int i = 0; i < TwoBodyCoefs.size(); i++)
-    TwoBody_rhoG[i] = ComplexType();
   for (int iat = 0; iat < num_elecs; iat++)
-  {
-    for (int i = 0; i < TwoBodyCoefs.size(); i++)
-      TwoBodyPhase[i] = dot(TwoBodyGvecs[i], P.R[iat]);
-    eval_e2iphi(TwoBodyPhase, TwoBody_e2iGr_new);
-    for (int i = 0; i < TwoBodyCoefs.size(); i++)
-      TwoBody_rhoG[i] += TwoBody_e2iGr_new[i];
-  }
+    OneBody_Uat[iat] = computeOneBody(P.R[iat], nullptr);
+  computeRhoG(P);
 }
 
 void kSpaceJastrow::checkInVariables(opt_variables_type& active)
@@ -785,31 +752,34 @@ kSpaceJastrow::kSpaceJastrow(const ParticleSet& ions)
 
 void kSpaceJastrow::copyFrom(const kSpaceJastrow& old)
 {
-  CellVolume        = old.CellVolume;
-  NormConstant      = old.NormConstant;
-  num_elecs         = old.num_elecs;
-  NumSpins          = old.NumSpins;
-  NumIons           = old.NumIons;
-  NumIonSpecies     = old.NumIonSpecies;
-  OneBodyGvecs      = old.OneBodyGvecs;
-  TwoBodyGvecs      = old.TwoBodyGvecs;
-  OneBodySymmCoefs  = old.OneBodySymmCoefs;
-  TwoBodySymmCoefs  = old.TwoBodySymmCoefs;
-  OneBodyCoefs      = old.OneBodyCoefs;
-  TwoBodyCoefs      = old.TwoBodyCoefs;
-  OneBodySymmType   = old.OneBodySymmType;
-  TwoBodySymmType   = old.TwoBodySymmType;
-  Ion_rhoG          = old.Ion_rhoG;
-  OneBody_rhoG      = old.OneBody_rhoG;
-  TwoBody_rhoG      = old.TwoBody_rhoG;
-  OneBodyPhase      = old.OneBodyPhase;
-  TwoBodyPhase      = old.TwoBodyPhase;
-  OneBody_e2iGr     = old.OneBody_e2iGr;
-  TwoBody_e2iGr_new = old.TwoBody_e2iGr_new;
-  TwoBody_e2iGr_old = old.TwoBody_e2iGr_old;
-  Delta_e2iGr       = old.Delta_e2iGr;
-  OneBodyID         = old.OneBodyID;
-  TwoBodyID         = old.TwoBodyID;
+  CellVolume         = old.CellVolume;
+  NormConstant       = old.NormConstant;
+  num_elecs          = old.num_elecs;
+  NumSpins           = old.NumSpins;
+  NumIons            = old.NumIons;
+  NumIonSpecies      = old.NumIonSpecies;
+  OneBodyGvecs       = old.OneBodyGvecs;
+  TwoBodyGvecs       = old.TwoBodyGvecs;
+  OneBodySymmCoefs   = old.OneBodySymmCoefs;
+  TwoBodySymmCoefs   = old.TwoBodySymmCoefs;
+  OneBodyCoefs       = old.OneBodyCoefs;
+  TwoBodyCoefs       = old.TwoBodyCoefs;
+  OneBodySymmType    = old.OneBodySymmType;
+  TwoBodySymmType    = old.TwoBodySymmType;
+  Ion_rhoG           = old.Ion_rhoG;
+  OneBody_rhoG       = old.OneBody_rhoG;
+  TwoBody_rhoG       = old.TwoBody_rhoG;
+  OneBodyPhase       = old.OneBodyPhase;
+  TwoBodyPhase       = old.TwoBodyPhase;
+  OneBody_e2iGr      = old.OneBody_e2iGr;
+  TwoBody_e2iGr_new  = old.TwoBody_e2iGr_new;
+  TwoBody_e2iGr_old  = old.TwoBody_e2iGr_old;
+  TwoBody_e2iGr_elec = old.TwoBody_e2iGr_elec;
+  OneBody_Uat        = old.OneBody_Uat;
+  OneBody_U_new      = old.OneBody_U_new;
+  DiffVal            = old.DiffVal;
+  OneBodyID          = old.OneBodyID;
+  TwoBodyID          = old.TwoBodyID;
   //copy the variable map
   myVars        = old.myVars;
   Optimizable   = old.Optimizable;
@@ -113,7 +113,16 @@ private:
   std::vector<RealType> OneBodyPhase, TwoBodyPhase;
   //
   std::vector<ComplexType> OneBody_e2iGr, TwoBody_e2iGr_new, TwoBody_e2iGr_old;
-  Matrix<ComplexType> Delta_e2iGr;
+  // e^{iG.r} of each electron for TwoBodyGvecs, kept in sync with TwoBody_rhoG
+  Matrix<ComplexType> TwoBody_e2iGr_elec;
+  // One-body Jastrow value of each electron and of the proposed move
+  std::vector<RealType> OneBody_Uat;
+  RealType OneBody_U_new;
+  // log ratio of the proposed move
+  RealType DiffVal;
+  // crowd scratch for the phases and e^{iG.r} of the proposed moves [nw][nTwo], only used by the leader
+  std::vector<RealType> mw_TwoBodyPhase;
+  std::vector<ComplexType> mw_TwoBody_e2iGr;
 
   // Map of the optimizable variables:
   //std::map<std::string,RealType*> VarMap;
@@ -134,6 +143,18 @@ private:
   bool Equivalent(PosType G1, PosType G2);
   void StructureFactor(PosType G, std::vector<ComplexType>& rho_G);
 
+  // One-body Jastrow value at r. The gradient is added to grad if not nullptr
+  RealType computeOneBody(const PosType& r, GradType* grad);
+  // e^{iG.r} for TwoBodyGvecs
+  void computeTwoBodyE2iGr(const PosType& r, ComplexType* e2iGr);
+  // change of the two-body Jastrow moving iat to e2iGr_new. The gradient at the new position is added to grad if not nullptr
+  RealType computeTwoBodyRatio(int iat, const ComplexType* e2iGr_new, GradType* grad) const;
+  // recompute TwoBody_rhoG and TwoBody_e2iGr_elec from scratch
+  void computeRhoG(const ParticleSet& P);
+  // e^{iG.r} of the proposed moves of a crowd computed by the leader, stored in TwoBody_e2iGr_new of each walker
+  void mw_computeTwoBodyE2iGr(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                              const RefVectorWithLeader<ParticleSet>& p_list);
+
   const ParticleSet& Ions;
   std::string OneBodyID;
   std::string TwoBodyID;
@@ -170,6 +191,17 @@ public:
   GradType evalGrad(ParticleSet& P, int iat) override;
   PsiValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat) override;
 
+  void mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios) const override;
+
+  void mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new) const override;
+
   void restore(int iat) override;
   void acceptMove(ParticleSet& P, int iat, bool safe_to_delay = false) override;
 
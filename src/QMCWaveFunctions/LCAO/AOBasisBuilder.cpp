@@ -35,7 +35,8 @@ AOBasisBuilder<COT>::AOBasisBuilder(const std::string& eName, Communicate* comm)
       sph("default"),
       basisType("Numerical"),
       elementType(eName),
-      Normalized("yes")
+      Normalized("yes"),
+      cutoff_tolerance_(0)
 {
   // mmorales: for "Cartesian Gaussian", m is an integer that maps
   //           the component to Gamess notation, see Numerics/CartesianTensor.h
@@ -56,6 +57,7 @@ bool AOBasisBuilder<COT>::put(xmlNodePtr cur)
   aAttrib.add(addsignforM, "expM");
   aAttrib.add(Morder, "expandYlm");
   aAttrib.add(Normalized, "normalized");
+  aAttrib.add(cutoff_tolerance_, "cutoffTolerance");
   aAttrib.put(cur);
   PRE.echo(cur);
   if (sph == "spherical")
@@ -235,7 +237,8 @@ std::unique_ptr<COT> AOBasisBuilder<COT>::createAOSet(xmlNodePtr cur)
 
   //Now, add distinct Radial Orbitals and (l,m) channels
   RadialOrbitalSetBuilder<COT> radFuncBuilder(myComm, *aos);
-  radFuncBuilder.Normalized = (Normalized == "yes");
+  radFuncBuilder.Normalized      = (Normalized == "yes");
+  radFuncBuilder.CutoffTolerance = cutoff_tolerance_;
   radFuncBuilder.addGrid(gptr, basisType); //assign a radial grid for the new center
   std::vector<xmlNodePtr>::iterator it(radGroup.begin());
   std::vector<xmlNodePtr>::iterator it_end(radGroup.end());
@@ -371,7 +374,8 @@ std::unique_ptr<COT> AOBasisBuilder<COT>::createAOSetH5(hdf_archive& hin)
 
   //Now, add distinct Radial Orbitals and (l,m) channels
   RadialOrbitalSetBuilder<COT> radFuncBuilder(myComm, *aos);
-  radFuncBuilder.Normalized = (Normalized == "yes");
+  radFuncBuilder.Normalized      = (Normalized == "yes");
+  radFuncBuilder.CutoffTolerance = cutoff_tolerance_;
   radFuncBuilder.addGridH5(hin); //assign a radial grid for the new center
   std::vector<int> all_nl;
   for (int i = 0; i < numbasisgroups; i++)
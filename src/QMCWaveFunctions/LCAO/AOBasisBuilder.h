@@ -51,6 +51,8 @@ private:
   std::string basisType;
   std::string elementType;
   std::string Normalized;
+  ///tolerance for screening the radial orbitals, no screening if not positive
+  double cutoff_tolerance_;
 
   ///map for the radial orbitals
   std::map<std::string, int> RnlID;
@@ -64,6 +66,9 @@ public:
   bool put(xmlNodePtr cur);
   bool putH5(hdf_archive& hin);
 
+  ///set the default screening tolerance, can be overwritten by the cutoffTolerance attribute in put
+  void setCutoffTolerance(double tolerance) { cutoff_tolerance_ = tolerance; }
+
   SPOSet* createSPOSetFromXML(xmlNodePtr cur) { return 0; }
 
   std::unique_ptr<COT> createAOSet(xmlNodePtr cur);
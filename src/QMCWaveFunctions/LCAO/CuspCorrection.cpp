@@ -209,7 +209,7 @@ void computeRadialPhiBar(ParticleSet* targetP,
                          int curOrb_,
                          int curCenter_,
                          SPOSet* Phi,
-                         Vector<QMCTraits::RealType>& xgrid,
+                         const Vector<QMCTraits::RealType>& xgrid,
                          Vector<QMCTraits::RealType>& rad_orb,
                          const CuspCorrectionParameters& data)
 {
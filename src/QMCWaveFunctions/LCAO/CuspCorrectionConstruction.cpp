@@ -15,17 +15,116 @@
 #include "SoaCuspCorrectionBasisSet.h"
 #include "Message/Communicate.h"
 #include "Utilities/FairDivide.h"
+#include "hdf/hdf_archive.h"
 
 namespace qmcplusplus
 {
+/// radial orbitals below this magnitude at the end of the grid are treated as zero
+constexpr QMCTraits::RealType CuspRadialCutoffTolerance = 1e-12;
+
+/// radial grid of the corrected orbitals
+std::unique_ptr<LogGrid<QMCTraits::RealType>> createCuspRadialGrid()
+{
+  auto radial_grid = std::make_unique<LogGrid<QMCTraits::RealType>>();
+  radial_grid->set(0.000001, 100.0, 1001);
+  return radial_grid;
+}
+
+void computeRadialPhiBars(const Matrix<CuspCorrectionParameters>& info,
+                          int num_centers,
+                          int orbital_set_size,
+                          const ParticleSet& targetPtcl,
+                          const ParticleSet& sourcePtcl,
+                          const LCAOrbitalSetWithCorrection& lcwc,
+                          const std::string& id,
+                          Matrix<QMCTraits::RealType>& radial_orbitals)
+{
+  using RealType = QMCTraits::RealType;
+
+  NewTimer& cuspRadialTimer =
+      *timer_manager.createTimer("CuspCorrectionConstruction::computeRadialPhiBars", timer_level_medium);
+
+  ScopedTimer cuspRadialTimerWrapper(cuspRadialTimer);
+
+  std::vector<bool> corrCenter(num_centers, "true");
+
+  auto radial_grid = createCuspRadialGrid();
+  Vector<RealType> xgrid(radial_grid->size());
+  for (int ig = 0; ig < radial_grid->size(); ig++)
+    xgrid[ig] = radial_grid->r(ig);
+
+  radial_orbitals.resize(num_centers * orbital_set_size, xgrid.size());
+
+#pragma omp parallel
+  {
+    // computeRadialPhiBar moves the particles, each thread works on its own copies
+    ParticleSet localTargetPtcl(targetPtcl);
+    ParticleSet localSourcePtcl(sourcePtcl);
+
+    LCAOrbitalSet local_phi(std::unique_ptr<LCAOrbitalSet::basis_type>(lcwc.myBasisSet->makeClone()),
+                            lcwc.isOptimizable());
+    local_phi.setOrbitalSetSize(lcwc.getOrbitalSetSize());
+
+    LCAOrbitalSet local_eta(std::unique_ptr<LCAOrbitalSet::basis_type>(lcwc.myBasisSet->makeClone()),
+                            lcwc.isOptimizable());
+    local_eta.setOrbitalSetSize(lcwc.getOrbitalSetSize());
+
+    Vector<RealType> rad_orb(xgrid.size());
+    // center of the current split of local_phi and local_eta
+    int split_center = -1;
+
+#pragma omp for schedule(dynamic) collapse(2)
+    for (int ic = 0; ic < num_centers; ic++)
+      for (int mo_idx = 0; mo_idx < orbital_set_size; mo_idx++)
+      {
+        if (ic != split_center)
+        {
+          *(local_eta.C) = *(lcwc.C);
+          *(local_phi.C) = *(lcwc.C);
+          splitPhiEta(ic, corrCenter, local_phi, local_eta);
+          split_center = ic;
+        }
+
+        computeRadialPhiBar(&localTargetPtcl, &localSourcePtcl, mo_idx, ic, &local_phi, xgrid, rad_orb,
+                            info(ic, mo_idx));
+        std::copy(rad_orb.begin(), rad_orb.end(), radial_orbitals[ic * orbital_set_size + mo_idx]);
+
+        if (outputManager.isDebugActive())
+        {
+          // For testing against AoS output
+          // Output phiBar to soaOrbs.downdet.C0.MO0
+          int nElms   = 500;
+          RealType dx = info(ic, mo_idx).Rc * 1.2 / nElms;
+          Vector<RealType> pos;
+          Vector<RealType> output_orb;
+          pos.resize(nElms);
+          output_orb.resize(nElms);
+          for (int i = 0; i < nElms; i++)
+          {
+            pos[i] = (i + 1.0) * dx;
+          }
+          computeRadialPhiBar(&localTargetPtcl, &localSourcePtcl, mo_idx, ic, &local_phi, pos, output_orb,
+                              info(ic, mo_idx));
+          std::string filename = "soaOrbs." + id + ".C" + std::to_string(ic) + ".MO" + std::to_string(mo_idx);
+#pragma omp critical
+          std::cout << "Writing to " << filename << std::endl;
+          std::ofstream out(filename.c_str());
+          out << "# r phiBar(r)" << std::endl;
+          for (int i = 0; i < nElms; i++)
+          {
+            out << pos[i] << "  " << output_orb[i] << std::endl;
+          }
+          out.close();
+        }
+      }
+  }
+}
+
 // Modifies orbital set lcwc
-void applyCuspCorrection(const Matrix<CuspCorrectionParameters>& info,
+void applyCuspCorrection(const Matrix<QMCTraits::RealType>& radial_orbitals,
                          int num_centers,
                          int orbital_set_size,
-                         ParticleSet& targetPtcl,
-                         ParticleSet& sourcePtcl,
-                         LCAOrbitalSetWithCorrection& lcwc,
-                         const std::string& id)
+                         LCAOrbitalSetWithCorrection& lcwc)
 {
   using RealType = QMCTraits::RealType;
 
@@ -34,85 +133,154 @@ void applyCuspCorrection(const Matrix<CuspCorrectionParameters>& info,
 
   ScopedTimer cuspApplyTimerWrapper(cuspApplyTimer);
 
-  LCAOrbitalSet phi(std::unique_ptr<LCAOrbitalSet::basis_type>(lcwc.myBasisSet->makeClone()), lcwc.isOptimizable());
-  phi.setOrbitalSetSize(lcwc.getOrbitalSetSize());
-
-  LCAOrbitalSet eta(std::unique_ptr<LCAOrbitalSet::basis_type>(lcwc.myBasisSet->makeClone()), lcwc.isOptimizable());
-  eta.setOrbitalSetSize(lcwc.getOrbitalSetSize());
-
-
   std::vector<bool> corrCenter(num_centers, "true");
 
   //What's this grid's lifespan?  Why on the heap?
-  auto radial_grid = std::make_unique<LogGrid<RealType>>();
-  radial_grid->set(0.000001, 100.0, 1001);
-
-
-  Vector<RealType> xgrid;
-  Vector<RealType> rad_orb;
-  xgrid.resize(radial_grid->size());
-  rad_orb.resize(radial_grid->size());
-  for (int ig = 0; ig < radial_grid->size(); ig++)
-  {
-    xgrid[ig] = radial_grid->r(ig);
-  }
+  auto radial_grid = createCuspRadialGrid();
+  Vector<RealType> rad_orb(radial_grid->size());
 
   for (int ic = 0; ic < num_centers; ic++)
   {
-    *(eta.C) = *(lcwc.C);
-    *(phi.C) = *(lcwc.C);
-
-    splitPhiEta(ic, corrCenter, phi, eta);
-
     // loop over MO index - cot must be an array (of len MO size)
     //   the loop is inside cot - in the multiqunitic
     auto cot = std::make_unique<CuspCorrectionAtomicBasis<RealType>>();
     cot->initializeRadialSet(*radial_grid, orbital_set_size);
-    //How is this useful?
-    // cot->ID.resize(orbital_set_size);
-    // for (int mo_idx = 0; mo_idx < orbital_set_size; mo_idx++) {
-    //   cot->ID[mo_idx] = mo_idx;
-    // }
 
+    // last grid point where any orbital of this center is not negligible
+    int ig_last = 0;
     for (int mo_idx = 0; mo_idx < orbital_set_size; mo_idx++)
     {
-      computeRadialPhiBar(&targetPtcl, &sourcePtcl, mo_idx, ic, &phi, xgrid, rad_orb, info(ic, mo_idx));
+      const RealType* orb = radial_orbitals[ic * orbital_set_size + mo_idx];
+      std::copy(orb, orb + rad_orb.size(), rad_orb.begin());
       RealType yprime_i = (rad_orb[1] - rad_orb[0]) / (radial_grid->r(1) - radial_grid->r(0));
       OneDimQuinticSpline<RealType> radial_spline(radial_grid->makeClone(), rad_orb);
       radial_spline.spline(0, yprime_i, rad_orb.size() - 1, 0.0);
       cot->addSpline(mo_idx, radial_spline);
 
-      if (outputManager.isDebugActive())
-      {
-        // For testing against AoS output
-        // Output phiBar to soaOrbs.downdet.C0.MO0
-        int nElms   = 500;
-        RealType dx = info(ic, mo_idx).Rc * 1.2 / nElms;
-        Vector<RealType> pos;
-        Vector<RealType> output_orb;
-        pos.resize(nElms);
-        output_orb.resize(nElms);
-        for (int i = 0; i < nElms; i++)
-        {
-          pos[i] = (i + 1.0) * dx;
-        }
-        computeRadialPhiBar(&targetPtcl, &sourcePtcl, mo_idx, ic, &phi, pos, output_orb, info(ic, mo_idx));
-        std::string filename = "soaOrbs." + id + ".C" + std::to_string(ic) + ".MO" + std::to_string(mo_idx);
-        std::cout << "Writing to " << filename << std::endl;
-        std::ofstream out(filename.c_str());
-        out << "# r phiBar(r)" << std::endl;
-        for (int i = 0; i < nElms; i++)
+      for (int ig = rad_orb.size() - 1; ig > ig_last; ig--)
+        if (std::abs(rad_orb[ig]) > CuspRadialCutoffTolerance)
         {
-          out << pos[i] << "  " << output_orb[i] << std::endl;
+          ig_last = ig;
+          break;
         }
-        out.close();
-      }
     }
+    if (ig_last + 1 < radial_grid->size())
+      cot->setCutoff(radial_grid->r(ig_last + 1));
     lcwc.cusp.add(ic, std::move(cot));
   }
   removeSTypeOrbitals(corrCenter, lcwc);
 }
 
+void applyCuspCorrection(const Matrix<CuspCorrectionParameters>& info,
+                         int num_centers,
+                         int orbital_set_size,
+                         ParticleSet& targetPtcl,
+                         ParticleSet& sourcePtcl,
+                         LCAOrbitalSetWithCorrection& lcwc,
+                         const std::string& id)
+{
+  Matrix<QMCTraits::RealType> radial_orbitals;
+  computeRadialPhiBars(info, num_centers, orbital_set_size, targetPtcl, sourcePtcl, lcwc, id, radial_orbitals);
+  applyCuspCorrection(radial_orbitals, num_centers, orbital_set_size, lcwc);
+}
+
+/// number of the entries of CuspCorrectionParameters in the cache file: redo, C, sg, Rc and alpha
+constexpr int NumCachedCuspParameters = 9;
+
+void saveCuspCache(const std::string& fname,
+                   const std::string& id,
+                   const Matrix<CuspCorrectionParameters>& info,
+                   const Matrix<QMCTraits::RealType>& radial_orbitals)
+{
+  using RealType = QMCTraits::RealType;
+
+  Matrix<RealType> params(info.rows() * info.cols(), NumCachedCuspParameters);
+  for (int ic = 0; ic < info.rows(); ic++)
+    for (int mo_idx = 0; mo_idx < info.cols(); mo_idx++)
+    {
+      const auto& p       = info(ic, mo_idx);
+      RealType* restrict q = params[ic * info.cols() + mo_idx];
+      q[0]                = p.redo;
+      q[1]                = p.C;
+      q[2]                = p.sg;
+      q[3]                = p.Rc;
+      for (int i = 0; i < 5; i++)
+        q[4 + i] = p.alpha[i];
+    }
+
+  auto radial_grid = createCuspRadialGrid();
+  std::vector<RealType> grid{radial_grid->rmin(), radial_grid->rmax(), static_cast<RealType>(radial_grid->size())};
+  std::string sposet(id);
+  int num_centers      = info.rows();
+  int orbital_set_size = info.cols();
+
+  hdf_archive hout;
+  if (!hout.create(fname))
+  {
+    app_warning() << "Could not create the cusp correction cache " << fname << std::endl;
+    return;
+  }
+  hout.write(sposet, "sposet");
+  hout.write(num_centers, "num_centers");
+  hout.write(orbital_set_size, "orbital_set_size");
+  hout.write(grid, "radial_grid");
+  hout.write(params, "cusp_parameters");
+  hout.write(const_cast<Matrix<RealType>&>(radial_orbitals), "radial_orbitals");
+  hout.close();
+  app_log() << "Saved the cusp correction of " << id << " to " << fname << " for potential reuse." << std::endl;
+}
+
+bool readCuspCache(const std::string& fname,
+                   const std::string& id,
+                   Matrix<CuspCorrectionParameters>& info,
+                   Matrix<QMCTraits::RealType>& radial_orbitals)
+{
+  using RealType = QMCTraits::RealType;
+
+  hdf_archive hin;
+  if (!hin.open(fname, H5F_ACC_RDONLY))
+  {
+    app_log() << "Could not find the cusp correction cache " << fname << ". Recalculating data." << std::endl;
+    return false;
+  }
+
+  std::string sposet;
+  int num_centers = 0, orbital_set_size = 0;
+  std::vector<RealType> grid;
+  auto radial_grid = createCuspRadialGrid();
+  bool valid       = hin.readEntry(sposet, "sposet") && hin.readEntry(num_centers, "num_centers") &&
+      hin.readEntry(orbital_set_size, "orbital_set_size") && hin.readEntry(grid, "radial_grid");
+  valid = valid && sposet == id && num_centers == info.rows() && orbital_set_size == info.cols() && grid.size() == 3 &&
+      grid[0] == radial_grid->rmin() && grid[1] == radial_grid->rmax() && grid[2] == radial_grid->size();
+
+  Matrix<RealType> params;
+  valid = valid && hin.readEntry(params, "cusp_parameters") && hin.readEntry(radial_orbitals, "radial_orbitals");
+  valid = valid && params.rows() == num_centers * orbital_set_size && params.cols() == NumCachedCuspParameters &&
+      radial_orbitals.rows() == num_centers * orbital_set_size && radial_orbitals.cols() == radial_grid->size();
+  hin.close();
+  if (!valid)
+  {
+    app_log() << "The cusp correction cache " << fname << " does not match sposet " << id << ". Recalculating data."
+              << std::endl;
+    return false;
+  }
+
+  for (int ic = 0; ic < num_centers; ic++)
+    for (int mo_idx = 0; mo_idx < orbital_set_size; mo_idx++)
+    {
+      auto& p                    = info(ic, mo_idx);
+      const RealType* restrict q = params[ic * orbital_set_size + mo_idx];
+      p.redo                     = q[0];
+      p.C                        = q[1];
+      p.sg                       = q[2];
+      p.Rc                       = q[3];
+      for (int i = 0; i < 5; i++)
+        p.alpha[i] = q[4 + i];
+    }
+  app_log() << "Restored the cusp correction of " << id << " from " << fname << std::endl;
+  return true;
+}
+
 void saveCusp(int orbital_set_size, int num_centers, Matrix<CuspCorrectionParameters>& info, const std::string& id)
 {
   xmlDocPtr doc       = xmlNewDoc((const xmlChar*)"1.0");
@@ -219,81 +387,90 @@ void generateCuspInfo(int orbital_set_size,
   int end_mo   = offset[Comm.rank() + 1];
   app_log() << "  Number of molecular orbitals to compute correction on this rank: " << end_mo - start_mo << std::endl;
 
-// Specify dynamic scheduling explicitly for load balancing.   Each iteration should take enough
-// time that scheduling overhead is not an issue.
-#pragma omp parallel for schedule(dynamic) collapse(2)
-  for (int center_idx = 0; center_idx < num_centers; center_idx++)
+#pragma omp parallel
   {
-    for (int mo_idx = start_mo; mo_idx < end_mo; mo_idx++)
-    {
-      ParticleSet localTargetPtcl(targetPtcl);
-      ParticleSet localSourcePtcl(sourcePtcl);
+    // each thread works on its own copies of the particle sets and the orbitals
+    ParticleSet localTargetPtcl(targetPtcl);
+    ParticleSet localSourcePtcl(sourcePtcl);
 
-      LCAOrbitalSet local_phi(std::unique_ptr<LCAOrbitalSet::basis_type>(phi.myBasisSet->makeClone()),
-                              phi.isOptimizable());
-      local_phi.setOrbitalSetSize(phi.getOrbitalSetSize());
+    LCAOrbitalSet local_phi(std::unique_ptr<LCAOrbitalSet::basis_type>(phi.myBasisSet->makeClone()),
+                            phi.isOptimizable());
+    local_phi.setOrbitalSetSize(phi.getOrbitalSetSize());
 
-      LCAOrbitalSet local_eta(std::unique_ptr<LCAOrbitalSet::basis_type>(eta.myBasisSet->makeClone()),
-                              eta.isOptimizable());
-      local_eta.setOrbitalSetSize(eta.getOrbitalSetSize());
+    LCAOrbitalSet local_eta(std::unique_ptr<LCAOrbitalSet::basis_type>(eta.myBasisSet->makeClone()),
+                            eta.isOptimizable());
+    local_eta.setOrbitalSetSize(eta.getOrbitalSetSize());
 
-#pragma omp critical
-      app_log() << "   Working on MO: " << mo_idx << " Center: " << center_idx << std::endl;
+    // center of the current split of local_phi and local_eta
+    int split_center = -1;
 
+    // Specify dynamic scheduling explicitly for load balancing.   Each iteration should take enough
+    // time that scheduling overhead is not an issue.
+#pragma omp for schedule(dynamic) collapse(2)
+    for (int center_idx = 0; center_idx < num_centers; center_idx++)
+    {
+      for (int mo_idx = start_mo; mo_idx < end_mo; mo_idx++)
       {
-        ScopedTimer local_timer(splitPhiEtaTimer);
-
-        *(local_eta.C) = *(lcwc.C);
-        *(local_phi.C) = *(lcwc.C);
-        splitPhiEta(center_idx, corrCenter, local_phi, local_eta);
-      }
+#pragma omp critical
+        app_log() << "   Working on MO: " << mo_idx << " Center: " << center_idx << std::endl;
 
-      bool corrO = false;
-      auto& cref(*(local_phi.C));
-      for (int ip = 0; ip < cref.cols(); ip++)
-      {
-        if (std::abs(cref(mo_idx, ip)) > 0)
+        if (center_idx != split_center)
         {
-          corrO = true;
-          break;
-        }
-      }
-
-      if (corrO)
-      {
-        OneMolecularOrbital etaMO(&localTargetPtcl, &localSourcePtcl, &local_eta);
-        etaMO.changeOrbital(center_idx, mo_idx);
+          ScopedTimer local_timer(splitPhiEtaTimer);
 
-        OneMolecularOrbital phiMO(&localTargetPtcl, &localSourcePtcl, &local_phi);
-        phiMO.changeOrbital(center_idx, mo_idx);
-
-        SpeciesSet& tspecies(localSourcePtcl.getSpeciesSet());
-        int iz     = tspecies.addAttribute("charge");
-        RealType Z = tspecies(iz, localSourcePtcl.GroupID[center_idx]);
-
-        RealType Rc_max = 0.2;
-        RealType rc     = 0.1;
+          *(local_eta.C) = *(lcwc.C);
+          *(local_phi.C) = *(lcwc.C);
+          splitPhiEta(center_idx, corrCenter, local_phi, local_eta);
+          split_center = center_idx;
+        }
 
-        RealType dx = rc * 1.2 / npts;
-        ValueVector pos(npts);
-        ValueVector ELideal(npts);
-        ValueVector ELcurr(npts);
-        for (int i = 0; i < npts; i++)
+        bool corrO = false;
+        auto& cref(*(local_phi.C));
+        for (int ip = 0; ip < cref.cols(); ip++)
         {
-          pos[i] = (i + 1.0) * dx;
+          if (std::abs(cref(mo_idx, ip)) > 0)
+          {
+            corrO = true;
+            break;
+          }
         }
 
-        RealType eta0 = etaMO.phi(0.0);
-        ValueVector ELorig(npts);
-        CuspCorrection cusp(info(center_idx, mo_idx));
+        if (corrO)
         {
-          ScopedTimer local_timer(computeTimer);
-          minimizeForRc(cusp, phiMO, Z, rc, Rc_max, eta0, pos, ELcurr, ELideal);
+          OneMolecularOrbital etaMO(&localTargetPtcl, &localSourcePtcl, &local_eta);
+          etaMO.changeOrbital(center_idx, mo_idx);
+
+          OneMolecularOrbital phiMO(&localTargetPtcl, &localSourcePtcl, &local_phi);
+          phiMO.changeOrbital(center_idx, mo_idx);
+
+          SpeciesSet& tspecies(localSourcePtcl.getSpeciesSet());
+          int iz     = tspecies.addAttribute("charge");
+          RealType Z = tspecies(iz, localSourcePtcl.GroupID[center_idx]);
+
+          RealType Rc_max = 0.2;
+          RealType rc     = 0.1;
+
+          RealType dx = rc * 1.2 / npts;
+          ValueVector pos(npts);
+          ValueVector ELideal(npts);
+          ValueVector ELcurr(npts);
+          for (int i = 0; i < npts; i++)
+          {
+            pos[i] = (i + 1.0) * dx;
+          }
+
+          RealType eta0 = etaMO.phi(0.0);
+          ValueVector ELorig(npts);
+          CuspCorrection cusp(info(center_idx, mo_idx));
+          {
+            ScopedTimer local_timer(computeTimer);
+            minimizeForRc(cusp, phiMO, Z, rc, Rc_max, eta0, pos, ELcurr, ELideal);
+          }
+          // Update shared object.  Each iteration accesses a different element and
+          // this is an array (no bookkeeping data to update), so no synchronization
+          // is necessary.
+          info(center_idx, mo_idx) = cusp.cparam;
         }
-        // Update shared object.  Each iteration accesses a different element and
-        // this is an array (no bookkeeping data to update), so no synchronization
-        // is necessary.
-        info(center_idx, mo_idx) = cusp.cparam;
       }
     }
   }
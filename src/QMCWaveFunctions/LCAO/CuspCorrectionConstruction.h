@@ -29,6 +29,39 @@ void applyCuspCorrection(const Matrix<CuspCorrectionParameters>& info,
                          LCAOrbitalSetWithCorrection& lcwc,
                          const std::string& id);
 
+/** compute the corrected radial orbitals phiBar of all the centers and MOs on the cusp radial grid
+ * @param radial_orbitals resized to [num_centers*orbital_set_size][grid size], row ic*orbital_set_size+mo
+ */
+void computeRadialPhiBars(const Matrix<CuspCorrectionParameters>& info,
+                          int num_centers,
+                          int orbital_set_size,
+                          const ParticleSet& targetPtcl,
+                          const ParticleSet& sourcePtcl,
+                          const LCAOrbitalSetWithCorrection& lcwc,
+                          const std::string& id,
+                          Matrix<QMCTraits::RealType>& radial_orbitals);
+
+// Modifies orbital set lcwc using precomputed radial orbitals from computeRadialPhiBars
+void applyCuspCorrection(const Matrix<QMCTraits::RealType>& radial_orbitals,
+                         int num_centers,
+                         int orbital_set_size,
+                         LCAOrbitalSetWithCorrection& lcwc);
+
+/// save the cusp parameters and the corrected radial orbitals to an HDF5 file
+void saveCuspCache(const std::string& fname,
+                   const std::string& id,
+                   const Matrix<CuspCorrectionParameters>& info,
+                   const Matrix<QMCTraits::RealType>& radial_orbitals);
+
+/** read the cusp parameters and the corrected radial orbitals saved by saveCuspCache
+ * @param info sized [num_centers][orbital_set_size] on input
+ * @return false if the file is missing or does not match info and id
+ */
+bool readCuspCache(const std::string& fname,
+                   const std::string& id,
+                   Matrix<CuspCorrectionParameters>& info,
+                   Matrix<QMCTraits::RealType>& radial_orbitals);
+
 void saveCusp(int orbital_set_size, int num_centers, Matrix<CuspCorrectionParameters>& info, const std::string& id);
 
 void generateCuspInfo(int orbital_set_size,
@@ -110,21 +110,35 @@ LCAOrbitalBuilder::LCAOrbitalBuilder(ParticleSet& els, ParticleSet& ions, Commun
       sourcePtcl(ions),
       h5_path(""),
       SuperTwist(0.0),
-      doCuspCorrection(false)
+      doCuspCorrection(false),
+      use_offload_(false),
+      cutoff_tolerance_(0),
+      share_coefficients_(false)
 {
   ClassName = "LCAOrbitalBuilder";
   ReportEngine PRE(ClassName, "createBasisSet");
 
   std::string cuspC("no"); // cusp correction
+#if defined(ENABLE_OFFLOAD)
+  std::string useGPU("yes");
+#else
+  std::string useGPU("no");
+#endif
+  std::string shared_coefficients("no");
   OhmmsAttributeSet aAttrib;
   aAttrib.add(cuspC, "cuspCorrection");
+  aAttrib.add(useGPU, "gpu");
+  aAttrib.add(cutoff_tolerance_, "cutoffTolerance");
   aAttrib.add(h5_path, "href");
   aAttrib.add(PBCImages, "PBCimages");
   aAttrib.add(SuperTwist, "twist");
+  aAttrib.add(shared_coefficients, "sharedCoefficients", {"no", "yes"});
   aAttrib.put(cur);
 
   if (cuspC == "yes")
     doCuspCorrection = true;
+  use_offload_        = (useGPU == "yes" || useGPU == "1");
+  share_coefficients_ = (shared_coefficients == "yes");
   //Evaluate the Phase factor. Equals 1 for OBC.
   EvalPeriodicImagePhaseFactors(SuperTwist, PeriodicImagePhaseFactors);
 
@@ -347,6 +361,7 @@ LCAOrbitalBuilder::BasisSet_t* LCAOrbitalBuilder::createBasisSet(xmlNodePtr cur)
       if (it == ao_built_centers.end())
       {
         AOBasisBuilder<ao_type> any(elementType, myComm);
+        any.setCutoffTolerance(cutoff_tolerance_);
         any.put(cur);
         auto aoBasis = any.createAOSet(cur);
         if (aoBasis)
@@ -362,6 +377,9 @@ LCAOrbitalBuilder::BasisSet_t* LCAOrbitalBuilder::createBasisSet(xmlNodePtr cur)
   } // done with basis set
   mBasisSet->setBasisSetSize(-1);
   mBasisSet->setPBCParams(PBCImages, SuperTwist, PeriodicImagePhaseFactors);
+  mBasisSet->setUseOffload(use_offload_);
+  if (use_offload_)
+    app_log() << "  Basis set VGL evaluation offloaded: " << (mBasisSet->isOffloaded() ? "yes" : "no") << std::endl;
   return mBasisSet;
 }
 
@@ -423,6 +441,7 @@ LCAOrbitalBuilder::BasisSet_t* LCAOrbitalBuilder::createBasisSetH5()
     if (it == ao_built_centers.end())
     {
       AOBasisBuilder<ao_type> any(elementType, myComm);
+      any.setCutoffTolerance(cutoff_tolerance_);
       any.putH5(hin);
       auto aoBasis = any.createAOSetH5(hin);
       if (aoBasis)
@@ -445,6 +464,9 @@ LCAOrbitalBuilder::BasisSet_t* LCAOrbitalBuilder::createBasisSetH5()
   }
   mBasisSet->setBasisSetSize(-1);
   mBasisSet->setPBCParams(PBCImages, SuperTwist, PeriodicImagePhaseFactors);
+  mBasisSet->setUseOffload(use_offload_);
+  if (use_offload_)
+    app_log() << "  Basis set VGL evaluation offloaded: " << (mBasisSet->isOffloaded() ? "yes" : "no") << std::endl;
   return mBasisSet;
 }
 
@@ -452,12 +474,13 @@ LCAOrbitalBuilder::BasisSet_t* LCAOrbitalBuilder::createBasisSetH5()
 std::unique_ptr<SPOSet> LCAOrbitalBuilder::createSPOSetFromXML(xmlNodePtr cur)
 {
   ReportEngine PRE(ClassName, "createSPO(xmlNodePtr)");
-  std::string spo_name(""), id, cusp_file(""), optimize("no");
+  std::string spo_name(""), id, cusp_file(""), cusp_cache(""), optimize("no");
   std::string basisset_name("LCAOBSet");
   OhmmsAttributeSet spoAttrib;
   spoAttrib.add(spo_name, "name");
   spoAttrib.add(id, "id");
   spoAttrib.add(cusp_file, "cuspInfo");
+  spoAttrib.add(cusp_cache, "cuspCache");
   spoAttrib.add(optimize, "optimize");
   spoAttrib.add(basisset_name, "basisset");
   spoAttrib.put(cur);
@@ -509,22 +532,53 @@ std::unique_ptr<SPOSet> LCAOrbitalBuilder::createSPOSetFromXML(xmlNodePtr cur)
     const int orbital_set_size = lcos->getOrbitalSetSize();
     Matrix<CuspCorrectionParameters> info(num_centers, orbital_set_size);
 
+    Matrix<RealType> radial_orbitals;
+
     /// use int instead of bool to handle MPI bcast properly.
-    int valid = false;
-    if (myComm->rank() == 0)
-      valid = readCuspInfo(cusp_file, id, orbital_set_size, info);
+    int cached = false;
+    if (!cusp_cache.empty())
+    {
+      if (myComm->rank() == 0)
+        cached = readCuspCache(cusp_cache, id, info, radial_orbitals);
+      myComm->bcast(cached);
+    }
 
+    if (cached)
+    {
 #ifdef HAVE_MPI
-    myComm->comm.broadcast_value(valid);
-    if (valid)
       for (int orb_idx = 0; orb_idx < orbital_set_size; orb_idx++)
         for (int center_idx = 0; center_idx < num_centers; center_idx++)
           broadcastCuspInfo(info(center_idx, orb_idx), *myComm, 0);
+      int nrows = radial_orbitals.rows(), ncols = radial_orbitals.cols();
+      myComm->bcast(nrows);
+      myComm->bcast(ncols);
+      radial_orbitals.resize(nrows, ncols);
+      myComm->bcast(radial_orbitals.data(), radial_orbitals.size());
+#endif
+    }
+    else
+    {
+      /// use int instead of bool to handle MPI bcast properly.
+      int valid = false;
+      if (myComm->rank() == 0)
+        valid = readCuspInfo(cusp_file, id, orbital_set_size, info);
+
+#ifdef HAVE_MPI
+      myComm->comm.broadcast_value(valid);
+      if (valid)
+        for (int orb_idx = 0; orb_idx < orbital_set_size; orb_idx++)
+          for (int center_idx = 0; center_idx < num_centers; center_idx++)
+            broadcastCuspInfo(info(center_idx, orb_idx), *myComm, 0);
 #endif
-    if (!valid)
-      generateCuspInfo(orbital_set_size, num_centers, info, tmp_targetPtcl, sourcePtcl, lcwc, id, *myComm);
+      if (!valid)
+        generateCuspInfo(orbital_set_size, num_centers, info, tmp_targetPtcl, sourcePtcl, lcwc, id, *myComm);
+
+      computeRadialPhiBars(info, num_centers, orbital_set_size, tmp_targetPtcl, sourcePtcl, lcwc, id, radial_orbitals);
+      if (!cusp_cache.empty() && myComm->rank() == 0)
+        saveCuspCache(cusp_cache, id, info, radial_orbitals);
+    }
 
-    applyCuspCorrection(info, num_centers, orbital_set_size, tmp_targetPtcl, sourcePtcl, lcwc, id);
+    applyCuspCorrection(radial_orbitals, num_centers, orbital_set_size, lcwc);
   }
 #endif
 
@@ -576,7 +630,14 @@ bool LCAOrbitalBuilder::loadMO(LCAOrbitalSet& spo, xmlNodePtr cur)
     app_log() << "   Using Identity for the LCOrbitalSet " << std::endl;
     return true;
   }
-  spo.setOrbitalSetSize(norb);
+  // the cusp correction and the orbital rotation modify the coefficients
+  if (share_coefficients_ && !doCuspCorrection && !spo.isOptimizable())
+  {
+    app_log() << "   MO coefficients are shared by the ranks of a node" << std::endl;
+    spo.setNodeSharedOrbitalSetSize(norb, *myComm);
+  }
+  else
+    spo.setOrbitalSetSize(norb);
   bool success = putOccupation(spo, occ_ptr);
   if (h5_path == "")
     success = putFromXML(spo, coeff_ptr);
@@ -641,17 +702,21 @@ bool LCAOrbitalBuilder::putFromXML(LCAOrbitalSet& spo, xmlNodePtr coeff_ptr)
     putContent(Ctemp, coeff_ptr);
     int n = 0, i = 0;
     std::vector<ValueType>::iterator cit(Ctemp.begin());
+    const bool write_coefficients = !spo.C_shared || spo.C_shared->isWriter();
     while (i < spo.getOrbitalSetSize())
     {
       if (Occ[n] > std::numeric_limits<RealType>::epsilon())
       {
-        std::copy(cit, cit + BasisSetSize, (*spo.C)[i]);
+        if (write_coefficients)
+          std::copy(cit, cit + BasisSetSize, (*spo.C)[i]);
         i++;
       }
       n++;
       cit += BasisSetSize;
     }
   }
+  if (spo.C_shared)
+    spo.C_shared->fence();
   return true;
 }
 
@@ -722,7 +787,10 @@ bool LCAOrbitalBuilder::putFromH5(LCAOrbitalSet& spo, xmlNodePtr coeff_ptr)
       n++;
     }
   }
-  myComm->bcast(spo.C->data(), spo.C->size());
+  if (spo.C_shared)
+    spo.C_shared->bcast();
+  else
+    myComm->bcast(spo.C->data(), spo.C->size());
 #else
   APP_ABORT("LCAOrbitalBuilder::putFromH5 HDF5 is disabled.")
 #endif
@@ -819,8 +887,11 @@ bool LCAOrbitalBuilder::putPBCFromH5(LCAOrbitalSet& spo, xmlNodePtr coeff_ptr)
 
     hin.close();
   }
+  if (spo.C_shared)
+    spo.C_shared->bcast();
 #ifdef HAVE_MPI
-  myComm->comm.broadcast_n(spo.C->data(), spo.C->size());
+  else
+    myComm->comm.broadcast_n(spo.C->data(), spo.C->size());
 #endif
 
 #else
@@ -64,6 +64,12 @@ protected:
 
   /// Enable cusp correction
   bool doCuspCorrection;
+  /// Evaluate the basis set with the offload kernel when supported
+  bool use_offload_;
+  /// Tolerance for screening the radial orbitals, no screening if not positive
+  double cutoff_tolerance_;
+  /// Store the MO coefficients of the SPOSets which are not optimized once per node
+  bool share_coefficients_;
 
   /** create basis set
      *
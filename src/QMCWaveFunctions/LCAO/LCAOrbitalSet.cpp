@@ -13,9 +13,30 @@
 #include "LCAOrbitalSet.h"
 #include "Numerics/MatrixOperators.h"
 #include "CPU/BLAS.hpp"
+#include "ResourceCollection.h"
+#include "OMPTarget/OffloadAlignedAllocators.hpp"
 
 namespace qmcplusplus
 {
+struct LCAOMultiWalkerMem : public Resource
+{
+  using ValueType = LCAOrbitalSet::ValueType;
+  /// stacked basis set values [nw][nel][DIM+2][BasisSetSize padded], written by the offload basis set kernel
+  Matrix<ValueType, OffloadPinnedAllocator<ValueType>> basis_vgl_mw;
+  /// stacked orbital values [nw][nel][DIM+2][norb padded]
+  Matrix<ValueType> phi_vgl_mw;
+  /// inverse matrix rows of all the walkers [nw][norb]
+  Matrix<ValueType> invrow_mw;
+  /// inverse matrix rows transformed to the basis set [nw][BasisSetSize]
+  Matrix<ValueType> inv_basis_mw;
+
+  LCAOMultiWalkerMem() : Resource("LCAOMultiWalkerMem") {}
+
+  LCAOMultiWalkerMem(const LCAOMultiWalkerMem&) : LCAOMultiWalkerMem() {}
+
+  Resource* makeClone() const override { return new LCAOMultiWalkerMem(*this); }
+};
+
 LCAOrbitalSet::LCAOrbitalSet(std::unique_ptr<basis_type>&& bs, bool optimize)
     : SPOSet(false, true, optimize), BasisSetSize(bs ? bs->getBasisSetSize() : 0), Identity(true)
 {
@@ -30,7 +51,12 @@ LCAOrbitalSet::LCAOrbitalSet(std::unique_ptr<basis_type>&& bs, bool optimize)
 }
 
 LCAOrbitalSet::LCAOrbitalSet(const LCAOrbitalSet& in)
-    : SPOSet(in), myBasisSet(in.myBasisSet->makeClone()), C(in.C), BasisSetSize(in.BasisSetSize), Identity(in.Identity)
+    : SPOSet(in),
+      myBasisSet(in.myBasisSet->makeClone()),
+      C(in.C),
+      C_shared(in.C_shared),
+      BasisSetSize(in.BasisSetSize),
+      Identity(in.Identity)
 {
   Temp.resize(BasisSetSize);
   Temph.resize(BasisSetSize);
@@ -44,6 +70,8 @@ LCAOrbitalSet::LCAOrbitalSet(const LCAOrbitalSet& in)
   LCAOrbitalSet::checkObject();
 }
 
+LCAOrbitalSet::~LCAOrbitalSet() = default;
+
 void LCAOrbitalSet::setOrbitalSetSize(int norbs)
 {
   if (C)
@@ -58,6 +86,22 @@ void LCAOrbitalSet::setOrbitalSetSize(int norbs)
   LCAOrbitalSet::checkObject();
 }
 
+void LCAOrbitalSet::setNodeSharedOrbitalSetSize(int norbs, const Communicate& comm)
+{
+  if (C)
+    throw std::runtime_error("LCAOrbitalSet::setNodeSharedOrbitalSetSize cannot reset existing MO coefficients");
+
+  Identity       = false;
+  OrbitalSetSize = norbs;
+  // C is a view of the storage shared by the ranks of the node
+  C_shared = std::make_shared<NodeSharedArray<ValueType>>(comm, static_cast<size_t>(OrbitalSetSize) * BasisSetSize);
+  C        = std::make_shared<ValueMatrix>(C_shared->data(), OrbitalSetSize, BasisSetSize);
+  Tempv.resize(OrbitalSetSize);
+  Temphv.resize(OrbitalSetSize);
+  Tempghv.resize(OrbitalSetSize);
+  LCAOrbitalSet::checkObject();
+}
+
 void LCAOrbitalSet::checkObject() const
 {
   if (Identity)
@@ -90,10 +134,19 @@ void LCAOrbitalSet::evaluateValue(const ParticleSet& P, int iat, ValueVector& ps
   else
   {
     Vector<ValueType> vTemp(Temp.data(0), BasisSetSize);
-    myBasisSet->evaluateV(P, iat, vTemp.data());
+    myBasisSet->evaluateVScreened(P, iat, vTemp.data(), basis_ranges_);
     assert(psi.size() <= OrbitalSetSize);
-    ValueMatrix C_partial_view(C->data(), psi.size(), BasisSetSize);
-    simd::gemv(C_partial_view, vTemp.data(), psi.data());
+    // psi = C * vTemp restricted to the basis functions which are not screened out
+    constexpr ValueType zone(1);
+    constexpr ValueType zero(0);
+    if (basis_ranges_.empty())
+      std::fill_n(psi.data(), psi.size(), zero);
+    for (size_t ir = 0; ir < basis_ranges_.size(); ir++)
+    {
+      const auto [first, last] = basis_ranges_[ir];
+      BLAS::gemv('T', last - first, psi.size(), zone, C->data() + first, BasisSetSize, vTemp.data() + first, 1,
+                 ir == 0 ? zero : zone, psi.data(), 1);
+    }
   }
 }
 
@@ -109,6 +162,31 @@ inline void Product_ABt(const VectorSoaContainer<T, D>& A, const Matrix<T>& B, V
              C.capacity());
 }
 
+/** Product_ABt restricted to the columns of A and B in ranges
+ *
+ * The columns outside ranges are treated as zero.
+ */
+template<typename T, unsigned D>
+inline void Product_ABt(const VectorSoaContainer<T, D>& A,
+                        const Matrix<T>& B,
+                        VectorSoaContainer<T, D>& C,
+                        const std::vector<std::pair<int, int>>& ranges)
+{
+  constexpr char transa = 't';
+  constexpr char transb = 'n';
+  constexpr T zone(1);
+  constexpr T zero(0);
+  if (ranges.empty())
+    for (int idim = 0; idim < D; idim++)
+      std::fill_n(C.data(idim), B.rows(), zero);
+  for (size_t ir = 0; ir < ranges.size(); ir++)
+  {
+    const auto [first, last] = ranges[ir];
+    BLAS::gemm(transa, transb, B.rows(), D, last - first, zone, B.data() + first, B.cols(), A.data() + first,
+               A.capacity(), ir == 0 ? zero : zone, C.data(), C.capacity());
+  }
+}
+
 inline void LCAOrbitalSet::evaluate_vgl_impl(const vgl_type& temp,
                                              ValueVector& psi,
                                              GradVector& dpsi,
@@ -311,14 +389,17 @@ inline void LCAOrbitalSet::evaluate_vghgh_impl(const vghgh_type& temp,
 void LCAOrbitalSet::evaluateVGL(const ParticleSet& P, int iat, ValueVector& psi, GradVector& dpsi, ValueVector& d2psi)
 {
   //TAKE CARE OF IDENTITY
-  myBasisSet->evaluateVGL(P, iat, Temp);
   if (Identity)
+  {
+    myBasisSet->evaluateVGL(P, iat, Temp);
     evaluate_vgl_impl(Temp, psi, dpsi, d2psi);
+  }
   else
   {
+    myBasisSet->evaluateVGLScreened(P, iat, Temp, basis_ranges_);
     assert(psi.size() <= OrbitalSetSize);
     ValueMatrix C_partial_view(C->data(), psi.size(), BasisSetSize);
-    Product_ABt(Temp, C_partial_view, Tempv);
+    Product_ABt(Temp, C_partial_view, Tempv, basis_ranges_);
     evaluate_vgl_impl(Tempv, psi, dpsi, d2psi);
   }
 }
@@ -335,8 +416,10 @@ void LCAOrbitalSet::evaluateDetRatios(const VirtualParticleSet& VP,
 
   for (size_t j = 0; j < VP.getTotalNum(); j++)
   {
-    myBasisSet->evaluateV(VP, j, vTemp.data());
-    ratios[j] = simd::dot(vTemp.data(), invTemp.data(), BasisSetSize);
+    myBasisSet->evaluateVScreened(VP, j, vTemp.data(), basis_ranges_);
+    ratios[j] = 0;
+    for (const auto& [first, last] : basis_ranges_)
+      ratios[j] += simd::dot(vTemp.data() + first, invTemp.data() + first, last - first);
   }
 }
 
@@ -600,10 +683,12 @@ void LCAOrbitalSet::evaluateGradSource(const ParticleSet& P,
   }
   else
   {
+    // only the basis functions on iat_src contribute
+    myBasisSet->getGradSourceRanges(iat_src, basis_ranges_);
     for (size_t i = 0, iat = first; iat < last; i++, iat++)
     {
       myBasisSet->evaluateGradSourceV(P, iat, source, iat_src, Temp);
-      Product_ABt(Temp, *C, Tempv);
+      Product_ABt(Temp, *C, Tempv, basis_ranges_);
       evaluate_ionderiv_v_impl(Tempv, i, gradphi);
     }
   }
@@ -628,10 +713,12 @@ void LCAOrbitalSet::evaluateGradSource(const ParticleSet& P,
   }
   else
   {
+    // only the basis functions on iat_src contribute
+    myBasisSet->getGradSourceRanges(iat_src, basis_ranges_);
     for (size_t i = 0, iat = first; iat < last; i++, iat++)
     {
       myBasisSet->evaluateGradSourceVGL(P, iat, source, iat_src, Tempgh);
-      Product_ABt(Tempgh, *C, Tempghv);
+      Product_ABt(Tempgh, *C, Tempghv, basis_ranges_);
       evaluate_ionderiv_vgl_impl(Tempghv, i, grad_phi, grad_grad_phi, grad_lapl_phi);
       //  evaluate_vghgh_impl(Tempghv, i, logdet, dlogdet, grad_grad_logdet, grad_grad_grad_logdet);
     }
@@ -645,6 +732,8 @@ void LCAOrbitalSet::evaluateThirdDeriv(const ParticleSet& P, int first, int last
 
 void LCAOrbitalSet::applyRotation(const ValueMatrix& rot_mat, bool use_stored_copy)
 {
+  if (C_shared)
+    throw std::runtime_error("LCAOrbitalSet::applyRotation cannot rotate MO coefficients shared by the ranks of a node");
   if (!use_stored_copy)
     C_copy = *C;
   //gemm is out-of-place
@@ -665,4 +754,205 @@ void LCAOrbitalSet::applyRotation(const ValueMatrix& rot_mat, bool use_stored_co
   */
 }
 
+void LCAOrbitalSet::createResource(ResourceCollection& collection) const
+{
+  collection.addResource(std::make_unique<LCAOMultiWalkerMem>());
+}
+
+void LCAOrbitalSet::acquireResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const
+{
+  assert(this == &spo_list.getLeader());
+  auto& spo_leader = spo_list.getCastedLeader<LCAOrbitalSet>();
+  auto res_ptr     = dynamic_cast<LCAOMultiWalkerMem*>(collection.lendResource().release());
+  if (!res_ptr)
+    throw std::runtime_error("LCAOrbitalSet::acquireResource dynamic_cast failed");
+  spo_leader.mw_mem_.reset(res_ptr);
+}
+
+void LCAOrbitalSet::releaseResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const
+{
+  assert(this == &spo_list.getLeader());
+  auto& spo_leader = spo_list.getCastedLeader<LCAOrbitalSet>();
+  collection.takebackResource(std::move(spo_leader.mw_mem_));
+}
+
+const LCAOrbitalSet::ValueType* LCAOrbitalSet::mw_evaluateVGLStacked(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                                     const RefVectorWithLeader<ParticleSet>& P_list,
+                                                                     int first,
+                                                                     int last,
+                                                                     size_t output_size,
+                                                                     size_t& ld) const
+{
+  constexpr size_t NCOMP = OHMMS_DIM + 2;
+  const size_t nw        = spo_list.size();
+  const size_t nel       = last - first;
+  const size_t nb_padded = getAlignedSize<ValueType>(BasisSetSize);
+  const size_t nblocks   = nw * nel * NCOMP;
+
+  auto& basis_vgl_mw = mw_mem_->basis_vgl_mw;
+  if (basis_vgl_mw.rows() < nblocks || basis_vgl_mw.cols() != nb_padded)
+    basis_vgl_mw.resize(nblocks, nb_padded);
+
+  RefVectorWithLeader<basis_type> basis_list(*myBasisSet);
+  basis_list.reserve(nw);
+  for (int iw = 0; iw < nw; iw++)
+    basis_list.push_back(*spo_list.getCastedElement<LCAOrbitalSet>(iw).myBasisSet);
+  myBasisSet->mw_evaluateVGL(basis_list, P_list, first, last, basis_vgl_mw.data(), nb_padded);
+
+  if (Identity)
+  {
+    ld = nb_padded;
+    return basis_vgl_mw.data();
+  }
+
+  assert(output_size <= OrbitalSetSize);
+  const size_t norb_padded = getAlignedSize<ValueType>(output_size);
+  auto& phi_vgl_mw         = mw_mem_->phi_vgl_mw;
+  if (phi_vgl_mw.rows() < nblocks || phi_vgl_mw.cols() != norb_padded)
+    phi_vgl_mw.resize(nblocks, norb_padded);
+
+  // all the walkers and electrons contract with C at once, see Product_ABt for the single block version
+  BLAS::gemm('t', 'n', output_size, nblocks, BasisSetSize, ValueType(1), C->data(), BasisSetSize, basis_vgl_mw.data(),
+             nb_padded, ValueType(0), phi_vgl_mw.data(), norb_padded);
+  ld = norb_padded;
+  return phi_vgl_mw.data();
+}
+
+void LCAOrbitalSet::mw_evaluateVGL(const RefVectorWithLeader<SPOSet>& spo_list,
+                                   const RefVectorWithLeader<ParticleSet>& P_list,
+                                   int iat,
+                                   const RefVector<ValueVector>& psi_v_list,
+                                   const RefVector<GradVector>& dpsi_v_list,
+                                   const RefVector<ValueVector>& d2psi_v_list) const
+{
+  assert(this == &spo_list.getLeader());
+  if (!mw_mem_)
+  {
+    SPOSet::mw_evaluateVGL(spo_list, P_list, iat, psi_v_list, dpsi_v_list, d2psi_v_list);
+    return;
+  }
+
+  constexpr size_t NCOMP   = OHMMS_DIM + 2;
+  const size_t output_size = psi_v_list[0].get().size();
+  size_t ld                = 0;
+  const ValueType* phi_vgl = mw_evaluateVGLStacked(spo_list, P_list, iat, iat + 1, output_size, ld);
+
+#pragma omp parallel for
+  for (int iw = 0; iw < spo_list.size(); iw++)
+  {
+    const vgl_type phi_vgl_view(const_cast<ValueType*>(phi_vgl) + iw * NCOMP * ld, output_size, ld);
+    evaluate_vgl_impl(phi_vgl_view, psi_v_list[iw], dpsi_v_list[iw], d2psi_v_list[iw]);
+  }
+}
+
+void LCAOrbitalSet::mw_evaluateVGLandDetRatioGrads(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                   const RefVectorWithLeader<ParticleSet>& P_list,
+                                                   int iat,
+                                                   const std::vector<const ValueType*>& invRow_ptr_list,
+                                                   VGLVector& phi_vgl_v,
+                                                   std::vector<ValueType>& ratios,
+                                                   std::vector<GradType>& grads) const
+{
+  assert(this == &spo_list.getLeader());
+  if (!mw_mem_)
+  {
+    SPOSet::mw_evaluateVGLandDetRatioGrads(spo_list, P_list, iat, invRow_ptr_list, phi_vgl_v, ratios, grads);
+    return;
+  }
+
+  constexpr size_t NCOMP      = OHMMS_DIM + 2;
+  const size_t nw             = spo_list.size();
+  const size_t norb_requested = phi_vgl_v.size() / nw;
+  size_t ld                   = 0;
+  const ValueType* phi_vgl    = mw_evaluateVGLStacked(spo_list, P_list, iat, iat + 1, norb_requested, ld);
+
+#pragma omp parallel for
+  for (int iw = 0; iw < nw; iw++)
+  {
+    const vgl_type phi_vgl_view(const_cast<ValueType*>(phi_vgl) + iw * NCOMP * ld, norb_requested, ld);
+    ValueVector phi_v(phi_vgl_v.data() + norb_requested * iw, norb_requested);
+    GradVector dphi_v(reinterpret_cast<GradType*>(phi_vgl_v.data(1)) + norb_requested * iw, norb_requested);
+    ValueVector d2phi_v(phi_vgl_v.data(4) + norb_requested * iw, norb_requested);
+    evaluate_vgl_impl(phi_vgl_view, phi_v, dphi_v, d2phi_v);
+
+    ratios[iw] = simd::dot(invRow_ptr_list[iw], phi_v.data(), norb_requested);
+    grads[iw]  = simd::dot(invRow_ptr_list[iw], dphi_v.data(), norb_requested) / ratios[iw];
+  }
+}
+
+void LCAOrbitalSet::mw_evaluate_notranspose(const RefVectorWithLeader<SPOSet>& spo_list,
+                                            const RefVectorWithLeader<ParticleSet>& P_list,
+                                            int first,
+                                            int last,
+                                            const RefVector<ValueMatrix>& logdet_list,
+                                            const RefVector<GradMatrix>& dlogdet_list,
+                                            const RefVector<ValueMatrix>& d2logdet_list) const
+{
+  assert(this == &spo_list.getLeader());
+  if (!mw_mem_)
+  {
+    SPOSet::mw_evaluate_notranspose(spo_list, P_list, first, last, logdet_list, dlogdet_list, d2logdet_list);
+    return;
+  }
+
+  constexpr size_t NCOMP   = OHMMS_DIM + 2;
+  const size_t nel         = last - first;
+  const size_t output_size = logdet_list[0].get().cols();
+  size_t ld                = 0;
+  const ValueType* phi_vgl = mw_evaluateVGLStacked(spo_list, P_list, first, last, output_size, ld);
+
+#pragma omp parallel for
+  for (int iw = 0; iw < spo_list.size(); iw++)
+    for (size_t i = 0; i < nel; i++)
+    {
+      const vgl_type phi_vgl_view(const_cast<ValueType*>(phi_vgl) + (iw * nel + i) * NCOMP * ld, output_size, ld);
+      evaluate_vgl_impl(phi_vgl_view, i, logdet_list[iw], dlogdet_list[iw], d2logdet_list[iw]);
+    }
+}
+
+void LCAOrbitalSet::mw_evaluateDetRatios(const RefVectorWithLeader<SPOSet>& spo_list,
+                                         const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                                         const RefVector<ValueVector>& psi_list,
+                                         const std::vector<const ValueType*>& invRow_ptr_list,
+                                         std::vector<std::vector<ValueType>>& ratios_list) const
+{
+  assert(this == &spo_list.getLeader());
+  if (!mw_mem_)
+  {
+    SPOSet::mw_evaluateDetRatios(spo_list, vp_list, psi_list, invRow_ptr_list, ratios_list);
+    return;
+  }
+
+  const size_t nw   = spo_list.size();
+  const size_t norb = psi_list[0].get().size();
+
+  // transform the inverse rows of all the walkers to the basis set with a single GEMM
+  auto& inv_basis_mw = mw_mem_->inv_basis_mw;
+  if (!Identity)
+  {
+    assert(norb <= OrbitalSetSize);
+    auto& invrow_mw = mw_mem_->invrow_mw;
+    invrow_mw.resize(nw, norb);
+    inv_basis_mw.resize(nw, BasisSetSize);
+    for (size_t iw = 0; iw < nw; iw++)
+      std::copy_n(invRow_ptr_list[iw], norb, invrow_mw[iw]);
+    BLAS::gemm('n', 'n', BasisSetSize, nw, norb, ValueType(1), C->data(), BasisSetSize, invrow_mw.data(), norb,
+               ValueType(0), inv_basis_mw.data(), BasisSetSize);
+  }
+  const size_t ndot = Identity ? norb : BasisSetSize;
+
+#pragma omp parallel for
+  for (int iw = 0; iw < nw; iw++)
+  {
+    auto& spo                    = spo_list.getCastedElement<LCAOrbitalSet>(iw);
+    const VirtualParticleSet& vp = vp_list[iw];
+    ValueType* vTemp             = spo.Temp.data(0);
+    for (size_t j = 0; j < vp.getTotalNum(); j++)
+    {
+      spo.myBasisSet->evaluateV(vp, j, vTemp);
+      ratios_list[iw][j] = simd::dot(vTemp, Identity ? invRow_ptr_list[iw] : inv_basis_mw[iw], ndot);
+    }
+  }
+}
+
 } // namespace qmcplusplus
@@ -19,9 +19,12 @@
 
 #include "Numerics/MatrixOperators.h"
 #include "Numerics/DeterminantOperators.h"
+#include "Message/NodeSharedArray.h"
 
 namespace qmcplusplus
 {
+struct LCAOMultiWalkerMem;
+
 /** class to handle linear combinations of basis orbitals used to evaluate the Dirac determinants.
    *
    * SoA verson of LCOrtbitalSet
@@ -39,6 +42,8 @@ public:
   std::unique_ptr<basis_type> myBasisSet;
   /// pointer to matrix containing the coefficients
   std::shared_ptr<ValueMatrix> C;
+  /// storage of C shared by the ranks of a node, nullptr if C is private to this rank
+  std::shared_ptr<NodeSharedArray<ValueType>> C_shared;
 
   /** constructor
      * @param bs pointer to the BasisSet
@@ -47,6 +52,8 @@ public:
 
   LCAOrbitalSet(const LCAOrbitalSet& in);
 
+  ~LCAOrbitalSet() override;
+
   std::unique_ptr<SPOSet> makeClone() const override;
 
   void storeParamsBeforeRotation() override { C_copy = *C; }
@@ -73,6 +80,12 @@ public:
     */
   void setOrbitalSetSize(int norbs) override;
 
+  /** setOrbitalSetSize with C stored once per node, collective over comm
+   *  Only the writer of C_shared fills C, the other ranks read it once C_shared is synchronized.
+   *  C cannot be rotated.
+   */
+  void setNodeSharedOrbitalSetSize(int norbs, const Communicate& comm);
+
   /** return the size of the basis set
     */
   int getBasisSetSize() const override { return (myBasisSet == nullptr) ? 0 : myBasisSet->getBasisSetSize(); }
@@ -93,6 +106,27 @@ public:
                          const ValueVector& psiinv,
                          std::vector<ValueType>& ratios) override;
 
+  void mw_evaluateDetRatios(const RefVectorWithLeader<SPOSet>& spo_list,
+                            const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                            const RefVector<ValueVector>& psi_list,
+                            const std::vector<const ValueType*>& invRow_ptr_list,
+                            std::vector<std::vector<ValueType>>& ratios_list) const override;
+
+  void mw_evaluateVGL(const RefVectorWithLeader<SPOSet>& spo_list,
+                      const RefVectorWithLeader<ParticleSet>& P_list,
+                      int iat,
+                      const RefVector<ValueVector>& psi_v_list,
+                      const RefVector<GradVector>& dpsi_v_list,
+                      const RefVector<ValueVector>& d2psi_v_list) const override;
+
+  void mw_evaluateVGLandDetRatioGrads(const RefVectorWithLeader<SPOSet>& spo_list,
+                                      const RefVectorWithLeader<ParticleSet>& P_list,
+                                      int iat,
+                                      const std::vector<const ValueType*>& invRow_ptr_list,
+                                      VGLVector& phi_vgl_v,
+                                      std::vector<ValueType>& ratios,
+                                      std::vector<GradType>& grads) const override;
+
   void evaluateVGH(const ParticleSet& P,
                    int iat,
                    ValueVector& psi,
@@ -113,6 +147,14 @@ public:
                             GradMatrix& dlogdet,
                             ValueMatrix& d2logdet) override;
 
+  void mw_evaluate_notranspose(const RefVectorWithLeader<SPOSet>& spo_list,
+                               const RefVectorWithLeader<ParticleSet>& P_list,
+                               int first,
+                               int last,
+                               const RefVector<ValueMatrix>& logdet_list,
+                               const RefVector<GradMatrix>& dlogdet_list,
+                               const RefVector<ValueMatrix>& d2logdet_list) const override;
+
   void evaluate_notranspose(const ParticleSet& P,
                             int first,
                             int last,
@@ -195,6 +237,13 @@ public:
 
   void evaluateThirdDeriv(const ParticleSet& P, int first, int last, GGGMatrix& grad_grad_grad_logdet) override;
 
+  /// initialize a shared resource and hand it to a collection
+  void createResource(ResourceCollection& collection) const override;
+  /// acquire a shared resource from a collection
+  void acquireResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const override;
+  /// return a shared resource to a collection
+  void releaseResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const override;
+
 protected:
   ///number of Single-particle orbitals
   const IndexType BasisSetSize;
@@ -223,6 +272,27 @@ protected:
   vghgh_type Tempghv;
 
 private:
+  ///basis function ranges not screened out by the last evaluateVGLScreened or evaluateVScreened
+  basis_type::BasisRanges basis_ranges_;
+
+  /// multi walker scratch memory, only valid on the leader between acquireResource and releaseResource
+  std::unique_ptr<LCAOMultiWalkerMem> mw_mem_;
+
+  /** evaluate VGL of electrons [first, last) for all the walkers with a single GEMM
+   * @param output_size number of orbitals requested
+   * @param ld output, leading dimension of the result
+   * @return pointer to the [nw][last-first][DIM+2][ld] result
+   *
+   * The basis set values of all the walkers and electrons are stacked into one matrix before contracting with C.
+   * When C is the identity, the stacked basis values are returned directly.
+   */
+  const ValueType* mw_evaluateVGLStacked(const RefVectorWithLeader<SPOSet>& spo_list,
+                                         const RefVectorWithLeader<ParticleSet>& P_list,
+                                         int first,
+                                         int last,
+                                         size_t output_size,
+                                         size_t& ld) const;
+
   //helper functions to handl Identity
   void evaluate_vgl_impl(const vgl_type& temp, ValueVector& psi, GradVector& dpsi, ValueVector& d2psi) const;
 
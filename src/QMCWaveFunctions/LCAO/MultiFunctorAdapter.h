@@ -13,6 +13,8 @@
 #ifndef QMCPLUSPLUS_SOA_MULTIANALYTICFUNCTOR_BUILDER_H
 #define QMCPLUSPLUS_SOA_MULTIANALYTICFUNCTOR_BUILDER_H
 
+#include <algorithm>
+#include <limits>
 #include "Configuration.h"
 #include "Numerics/SlaterBasisSet.h"
 #include "Numerics/GaussianBasisSet.h"
@@ -85,6 +87,20 @@ struct MultiFunctorAdapter
   }
 };
 
+/// radius beyond which the Gaussian radial orbital is smaller than tolerance
+template<typename T>
+inline T radialCutoff(const GaussianCombo<T>& radorb, T tolerance)
+{
+  return radorb.cutoffRadius(tolerance);
+}
+
+/// no screening of the Slater radial orbitals within the magic r_max
+template<typename T>
+inline T radialCutoff(const SlaterCombo<T>& radorb, T tolerance)
+{
+  return T(100);
+}
+
 template<typename COT>
 class RadialOrbitalSetBuilder;
 
@@ -96,13 +112,19 @@ public:
   using RadialOrbital_t = MultiFunctorAdapter<FN>;
   using single_type     = typename RadialOrbital_t::single_type;
 
+  using RealType        = typename RadialOrbital_t::RealType;
+
   ///true, if the RadialOrbitalType is normalized
   bool Normalized;
+  ///radial orbitals smaller than this are screened out, no screening if not positive
+  RealType CutoffTolerance;
   ///orbitals to build
   COT& m_orbitals;
 
   ///constructor
-  RadialOrbitalSetBuilder(Communicate* comm, COT& aos) : MPIObjectBase(comm), Normalized(true), m_orbitals(aos) {}
+  RadialOrbitalSetBuilder(Communicate* comm, COT& aos)
+      : MPIObjectBase(comm), Normalized(true), CutoffTolerance(0), m_orbitals(aos)
+  {}
 
   ///implement functions used by AOBasisBuilder
   bool addGrid(xmlNodePtr cur, const std::string& rad_type) { return true; }
@@ -121,6 +143,7 @@ public:
     auto radorb = std::make_unique<single_type>(nlms[q_l], Normalized);
     radorb->putBasisGroup(cur);
 
+    addRnlCutoff(*radorb);
     m_orbitals.RnlID.push_back(nlms);
     m_orbitals.MultiRnl.Rnl.push_back(std::move(radorb));
     return true;
@@ -131,6 +154,7 @@ public:
     auto radorb = std::make_unique<single_type>(nlms[q_l], Normalized);
     radorb->putBasisGroupH5(hin, *myComm);
 
+    addRnlCutoff(*radorb);
     m_orbitals.RnlID.push_back(nlms);
     m_orbitals.MultiRnl.Rnl.push_back(std::move(radorb));
 
@@ -139,7 +163,18 @@ public:
 
   void finalize()
   {
-    m_orbitals.setRmax(0); //set Rmax
+    const auto& rnl_cutoff = m_orbitals.RnlCutoff;
+    if (CutoffTolerance > 0 && !rnl_cutoff.empty())
+      m_orbitals.setRmax(*std::max_element(rnl_cutoff.begin(), rnl_cutoff.end()));
+    else
+      m_orbitals.setRmax(0); //set Rmax
+  }
+
+private:
+  void addRnlCutoff(const single_type& radorb)
+  {
+    m_orbitals.RnlCutoff.push_back(CutoffTolerance > 0 ? std::min(radialCutoff(radorb, CutoffTolerance), RealType(100))
+                                                       : std::numeric_limits<RealType>::max());
   }
 };
 } // namespace qmcplusplus
@@ -140,20 +140,44 @@ public:
   inline void evaluate(T r, T* restrict u, T* restrict du, T* restrict d2u) const
   {
     if (r < myGrid.lower_bound)
+      evaluate_impl(-1, r - myGrid.lower_bound, coeffs->data(), coeffs->cols(), first_deriv.data(), num_splines_, u, du,
+                    d2u);
+    else
     {
-      const T dr          = r - myGrid.lower_bound;
-      const T* restrict a = (*coeffs)[0];
-      for (size_t i = 0; i < num_splines_; ++i)
+      int loc;
+      const auto cL = myGrid.getCLForQuintic(r, loc);
+      evaluate_impl(loc, cL, coeffs->data(), coeffs->cols(), first_deriv.data(), num_splines_, u, du, d2u);
+    }
+  }
+
+  /** compute values and the first two derivatives from raw coefficients, callable in offload regions
+   * @param loc grid interval, negative when r is below the lower bound of the grid
+   * @param cL distance from the grid point loc, or from the lower bound when loc < 0
+   * @param coeff_data coefficients with leading dimension ld
+   * @param first_deriv_data first derivatives at the lower bound
+   */
+  static inline void evaluate_impl(int loc,
+                                   T cL,
+                                   const T* restrict coeff_data,
+                                   size_t ld,
+                                   const T* restrict first_deriv_data,
+                                   size_t num_splines,
+                                   T* restrict u,
+                                   T* restrict du,
+                                   T* restrict d2u)
+  {
+    if (loc < 0)
+    {
+      const T* restrict a = coeff_data;
+      for (size_t i = 0; i < num_splines; ++i)
       {
-        u[i]   = a[i] + first_deriv[i] * dr;
-        du[i]  = first_deriv[i];
+        u[i]   = a[i] + first_deriv_data[i] * cL;
+        du[i]  = first_deriv_data[i];
         d2u[i] = 0.0;
       }
     }
     else
     {
-      int loc;
-      const auto cL       = myGrid.getCLForQuintic(r, loc);
       const size_t offset = loc * 6;
 
       constexpr T ctwo(2);
@@ -164,14 +188,14 @@ public:
       constexpr T c12(12);
       constexpr T c20(20);
 
-      const T* restrict a = (*coeffs)[offset + 0];
-      const T* restrict b = (*coeffs)[offset + 1];
-      const T* restrict c = (*coeffs)[offset + 2];
-      const T* restrict d = (*coeffs)[offset + 3];
-      const T* restrict e = (*coeffs)[offset + 4];
-      const T* restrict f = (*coeffs)[offset + 5];
+      const T* restrict a = coeff_data + (offset + 0) * ld;
+      const T* restrict b = coeff_data + (offset + 1) * ld;
+      const T* restrict c = coeff_data + (offset + 2) * ld;
+      const T* restrict d = coeff_data + (offset + 3) * ld;
+      const T* restrict e = coeff_data + (offset + 4) * ld;
+      const T* restrict f = coeff_data + (offset + 5) * ld;
 
-      for (size_t i = 0; i < num_splines_; ++i)
+      for (size_t i = 0; i < num_splines; ++i)
       {
         u[i]   = a[i] + cL * (b[i] + cL * (c[i] + cL * (d[i] + cL * (e[i] + cL * f[i]))));
         du[i]  = b[i] + cL * (ctwo * c[i] + cL * (cthree * d[i] + cL * (cfour * e[i] + cL * f[i] * cfive)));
@@ -180,6 +204,85 @@ public:
     }
   }
 
+  /// radii per tile of evaluate_batch
+  static constexpr int BatchTile = 64;
+
+  /** compute values and the first two derivatives of all the splines at n radii
+   * The radii run in the innermost loops and the coefficients are gathered per radius.
+   * @param r radii, all < rmax()
+   * @param u,du,d2u spline i at radius k is stored in u[i * ld + k], ld >= n
+   */
+  inline void evaluate_batch(int n, const T* restrict r, T* restrict u, T* restrict du, T* restrict d2u, size_t ld)
+      const
+  {
+    constexpr T czero(0);
+    constexpr T ctwo(2);
+    constexpr T cthree(3);
+    constexpr T cfour(4);
+    constexpr T cfive(5);
+    constexpr T csix(6);
+    constexpr T c12(12);
+    constexpr T c20(20);
+
+    const T lower_bound      = myGrid.lower_bound;
+    const T one_over_ldelta  = myGrid.OneOverLogDelta;
+    const int num_points     = myGrid.r_values.size();
+    const T* restrict rgrid  = myGrid.r_values.data();
+    const T* restrict cdata  = coeffs->data();
+    const size_t ncols       = coeffs->cols();
+    const T* restrict fderiv = first_deriv.data();
+
+    int loc[BatchTile];
+    T cL[BatchTile];
+    bool below[BatchTile];
+    for (int first = 0; first < n; first += BatchTile)
+    {
+      const int nr = std::min(BatchTile, n - first);
+      // same as LogGridLight::getCLForQuintic, the radii below the grid take interval 0 and are overwritten
+      int loc_max = 0;
+#pragma omp simd reduction(max : loc_max)
+      for (int k = 0; k < nr; k++)
+      {
+        const T rk = r[first + k];
+        below[k]   = rk < lower_bound;
+        loc[k]     = below[k] ? 0 : static_cast<int>(std::log(rk / lower_bound) * one_over_ldelta);
+        loc_max    = std::max(loc_max, loc[k]);
+      }
+      if (loc_max >= num_points)
+        throw std::domain_error("MultiQuinticSpline1D::evaluate_batch r value >= " + std::to_string(myGrid.upper_bound) +
+                                "\n");
+      for (int k = 0; k < nr; k++)
+        cL[k] = r[first + k] - (below[k] ? lower_bound : rgrid[loc[k]]);
+
+      for (size_t i = 0; i < num_splines_; ++i)
+      {
+        const T a0        = cdata[i];
+        const T fd        = fderiv[i];
+        T* restrict u_i   = u + i * ld + first;
+        T* restrict du_i  = du + i * ld + first;
+        T* restrict d2u_i = d2u + i * ld + first;
+#pragma omp simd
+        for (int k = 0; k < nr; k++)
+        {
+          const T* restrict a = cdata + loc[k] * 6 * ncols + i;
+          const T a_k         = a[0];
+          const T b_k         = a[ncols];
+          const T c_k         = a[2 * ncols];
+          const T d_k         = a[3 * ncols];
+          const T e_k         = a[4 * ncols];
+          const T f_k         = a[5 * ncols];
+          const T x           = cL[k];
+          const T v           = a_k + x * (b_k + x * (c_k + x * (d_k + x * (e_k + x * f_k))));
+          const T dv          = b_k + x * (ctwo * c_k + x * (cthree * d_k + x * (cfour * e_k + x * f_k * cfive)));
+          const T d2v         = ctwo * c_k + x * (csix * d_k + x * (c12 * e_k + x * f_k * c20));
+          u_i[k]              = below[k] ? a0 + fd * x : v;
+          du_i[k]             = below[k] ? fd : dv;
+          d2u_i[k]            = below[k] ? czero : d2v;
+        }
+      }
+    }
+  }
+
   /** compute upto 3rd derivatives */
   inline void evaluate(T r, T* restrict u, T* restrict du, T* restrict d2u, T* restrict d3u) const
   {
@@ -277,6 +380,9 @@ public:
   }
 
   int getNumSplines() const { return num_splines_; }
+  const CoeffType& getCoeffs() const { return *coeffs; }
+  const aligned_vector<T>& getFirstDeriv() const { return first_deriv; }
+  const LogGridLight<T>& getGrid() const { return myGrid; }
   void setNumSplines(int num_splines) { num_splines_ = num_splines; }
 };
 
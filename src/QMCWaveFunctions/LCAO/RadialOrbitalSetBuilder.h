@@ -97,6 +97,8 @@ public:
 
   ///true, if the RadialOrbitalType is normalized
   bool Normalized;
+  ///radial orbitals smaller than this are screened out, no screening if not positive
+  RealType CutoffTolerance;
   ///the atomic orbitals
   COT& m_orbitals;
   ///input grid in case transform is needed
@@ -130,7 +132,11 @@ private:
   void addSlater(xmlNodePtr cur);
 
   template<typename Fin, typename T>
-  T find_cutoff(Fin& in, T rmax);
+  T find_cutoff(Fin& in, T rmax, T eps = 1e-6);
+
+  ///add the screening cutoff radius of a radial orbital
+  template<typename Fin>
+  void addRnlCutoff(Fin& in);
 
   /// hdf file only for numerical basis h5 file generated by SQD
   hdf_archive hin;
@@ -153,7 +159,12 @@ private:
 
 template<typename COT>
 RadialOrbitalSetBuilder<COT>::RadialOrbitalSetBuilder(Communicate* comm, COT& aos, int radial_grid_size)
-    : MPIObjectBase(comm), Normalized(true), m_orbitals(aos), radial_grid_size_(radial_grid_size), m_rcut(-1.0)
+    : MPIObjectBase(comm),
+      Normalized(true),
+      CutoffTolerance(0),
+      m_orbitals(aos),
+      radial_grid_size_(radial_grid_size),
+      m_rcut(-1.0)
 {}
 
 template<typename COT>
@@ -294,6 +305,7 @@ void RadialOrbitalSetBuilder<COT>::addGaussian(xmlNodePtr cur)
   //Warning::Magic Number for max rmax of gaussians
   RealType r0 = find_cutoff(*gset, 100.);
   m_rcut_safe = std::max(m_rcut_safe, r0);
+  addRnlCutoff(*gset);
   radTemp.push_back(std::make_unique<A2NTransformer<RealType, gto_type>>(std::move(gset)));
   m_orbitals.RnlID.push_back(m_nlms);
 }
@@ -313,6 +325,7 @@ void RadialOrbitalSetBuilder<COT>::addGaussianH5(hdf_archive& hin)
   //similar locations on a function by function basis.
   RealType r0 = find_cutoff(*gset, 100.);
   m_rcut_safe = 6 * std::max(m_rcut_safe, r0);
+  addRnlCutoff(*gset);
   radTemp.push_back(std::make_unique<A2NTransformer<RealType, gto_type>>(std::move(gset)));
   m_orbitals.RnlID.push_back(m_nlms);
 }
@@ -346,8 +359,21 @@ void RadialOrbitalSetBuilder<COT>::finalize()
   for (int ib = 0; ib < norbs; ++ib)
     radTemp[ib]->convert(*grid_prec, multiset, ib, 5);
 
-  app_log() << "  Setting cutoff radius " << m_rcut_safe << std::endl << std::endl;
-  m_orbitals.setRmax(static_cast<RealType>(m_rcut_safe));
+  if (CutoffTolerance > 0)
+  {
+    // the radial orbitals are screened individually, the center is skipped beyond the largest cutoff
+    auto& rnl_cutoff = m_orbitals.RnlCutoff;
+    for (auto& rc : rnl_cutoff)
+      rc = std::min(rc, m_rcut_safe);
+    const RealType rmax = rnl_cutoff.empty() ? m_rcut_safe : *std::max_element(rnl_cutoff.begin(), rnl_cutoff.end());
+    app_log() << "  Setting cutoff radius " << rmax << " for tolerance " << CutoffTolerance << std::endl << std::endl;
+    m_orbitals.setRmax(rmax);
+  }
+  else
+  {
+    app_log() << "  Setting cutoff radius " << m_rcut_safe << std::endl << std::endl;
+    m_orbitals.setRmax(static_cast<RealType>(m_rcut_safe));
+  }
 }
 
 template<typename COT>
@@ -360,23 +386,35 @@ void RadialOrbitalSetBuilder<COT>::addSlater(xmlNodePtr cur)
 
   //need a find_cutoff for STO's, but this was previously in finalize and wiping out GTO's m_rcut_safe
   m_rcut_safe = std::max(m_rcut_safe, static_cast<RealType>(100));
+  addRnlCutoff(*gset);
   radTemp.push_back(std::make_unique<A2NTransformer<RealType, sto_type>>(std::move(gset)));
   m_orbitals.RnlID.push_back(m_nlms);
 }
 
 
+template<typename COT>
+template<typename Fin>
+void RadialOrbitalSetBuilder<COT>::addRnlCutoff(Fin& in)
+{
+  //Warning::Magic Number for max rmax, same as the analytic orbitals
+  m_orbitals.RnlCutoff.push_back(CutoffTolerance > 0 ? find_cutoff(in, static_cast<RealType>(100), CutoffTolerance)
+                                                     : std::numeric_limits<RealType>::max());
+}
+
 /** compute the safe cutoff radius of a radial functor
    */
-/** temporary function to compute the cutoff without constructing NGFunctor */
+/** temporary function to compute the cutoff without constructing NGFunctor
+ * @param eps threshold of |f(r)|, also the start of the search grid
+ */
 template<typename COT>
 template<typename Fin, typename T>
-T RadialOrbitalSetBuilder<COT>::find_cutoff(Fin& in, T rmax)
+T RadialOrbitalSetBuilder<COT>::find_cutoff(Fin& in, T rmax, T eps)
 {
   LogGridLight<OHMMS_PRECISION_FULL> agrid;
   //WARNING Magic number, should come from input or be set somewhere more cnetral.
-  const OHMMS_PRECISION_FULL eps = 1e-6;
-  bool too_small                 = true;
-  agrid.set(eps, rmax, RadialOrbitalSetBuilder<COT>::radial_grid_size_);
+  const OHMMS_PRECISION_FULL rmin = 1e-6;
+  bool too_small                  = true;
+  agrid.set(rmin, rmax, RadialOrbitalSetBuilder<COT>::radial_grid_size_);
   int i = radial_grid_size_ - 1;
   T r   = rmax;
   while (too_small && i > 0)
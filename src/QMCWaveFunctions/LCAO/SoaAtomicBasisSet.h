@@ -14,6 +14,7 @@
 #ifndef QMCPLUSPLUS_SOA_SPHERICALORBITAL_BASISSET_H
 #define QMCPLUSPLUS_SOA_SPHERICALORBITAL_BASISSET_H
 
+#include <limits>
 #include "CPU/math.hpp"
 
 namespace qmcplusplus
@@ -53,6 +54,8 @@ struct SoaAtomicBasisSet
   aligned_vector<int> NL;
   ///container for the quantum-numbers
   std::vector<QuantumNumberType> RnlID;
+  ///cutoff radius of each radial orbital, the radial orbitals are negligible beyond it
+  aligned_vector<RealType> RnlCutoff;
   ///temporary storage
   VectorSoaContainer<RealType, 4> tempS;
 
@@ -107,6 +110,9 @@ struct SoaAtomicBasisSet
   {
     BasisSetSize = LM.size();
     tempS.resize(std::max(Ylm.size(), RnlID.size()));
+    // no screening of the radial orbitals if the builder does not provide the cutoffs
+    if (RnlCutoff.size() != RnlID.size())
+      RnlCutoff.assign(RnlID.size(), std::numeric_limits<RealType>::max());
   }
 
   /** Set Rmax */
@@ -116,6 +122,14 @@ struct SoaAtomicBasisSet
     Rmax = (rmax > 0) ? rmax : MultiRnl.rmax();
   }
 
+  /** return true if the basis functions of this center vanish at distance r
+   * Only the distance to the center is checked when there are no periodic images.
+   */
+  inline bool isBeyondCutoff(RealType r) const
+  {
+    return PBCImages[0] == 0 && PBCImages[1] == 0 && PBCImages[2] == 0 && r >= Rmax;
+  }
+
   ///set the current offset
   inline void setCenter(int c, int offset) {}
 
@@ -217,6 +231,8 @@ struct SoaAtomicBasisSet
           for (size_t ib = 0; ib < BasisSetSize; ++ib)
           {
             const int nl(NL[ib]);
+            if (r_new >= RnlCutoff[nl])
+              continue;
             const int lm(LM[ib]);
             const T drnloverr = rinv * dphi[nl];
             const T ang       = ylm_v[lm];
@@ -327,6 +343,8 @@ struct SoaAtomicBasisSet
           for (size_t ib = 0; ib < BasisSetSize; ++ib)
           {
             const int nl(NL[ib]);
+            if (r_new >= RnlCutoff[nl])
+              continue;
             const int lm(LM[ib]);
             const T drnloverr = rinv * dphi[nl];
             const T ang       = ylm_v[lm];
@@ -497,6 +515,8 @@ struct SoaAtomicBasisSet
           for (size_t ib = 0; ib < BasisSetSize; ++ib)
           {
             const int nl(NL[ib]);
+            if (r_new >= RnlCutoff[nl])
+              continue;
             const int lm(LM[ib]);
             const T drnloverr = rinv * dphi[nl];
             const T ang       = ylm_v[lm];
@@ -650,7 +670,8 @@ struct SoaAtomicBasisSet
           ///Phase for PBC containing the phase for the nearest image displacement and the correction due to the Distance table.
           const ValueType Phase = periodic_image_phase_factors[iter] * correctphase;
           for (size_t ib = 0; ib < BasisSetSize; ++ib)
-            psi[ib] += ylm_v[LM[ib]] * phi_r[NL[ib]] * Phase;
+            if (r_new < RnlCutoff[NL[ib]])
+              psi[ib] += ylm_v[LM[ib]] * phi_r[NL[ib]] * Phase;
         }
       }
     }
@@ -22,6 +22,7 @@
 #define QMCPLUSPLUS_SOA_CARTESIAN_TENSOR_H
 
 #include <stdexcept>
+#include <algorithm>
 #include "OhmmsSoA/VectorSoaContainer.h"
 
 namespace qmcplusplus
@@ -80,6 +81,46 @@ struct SoaCartesianTensor
   ///makes a table of \f$ r^l S_l^m \f$ and their gradients up to Lmax.
   void evaluateVGL(T x, T y, T z);
 
+  /** compute VGL from raw normalization factors, callable in offload regions
+   * The output arrays must be zero on entry.
+   */
+  static void evaluateVGL_impl(int lmax,
+                               const T* norm_factor,
+                               T x,
+                               T y,
+                               T z,
+                               T* restrict XYZ,
+                               T* restrict gr0,
+                               T* restrict gr1,
+                               T* restrict gr2,
+                               T* restrict lap);
+
+  /// number of constants stored by packConstants
+  inline size_t getNumPackedConstants() const { return NormFactor.size(); }
+
+  /// pack NormFactor for evaluateVGL_packed
+  inline void packConstants(T* packed) const { std::copy_n(NormFactor.data(), NormFactor.size(), packed); }
+
+  /** compute VGL from the constants stored by packConstants, callable in offload regions
+   * All the (lmax+1)(lmax+2)(lmax+3)/6 entries of each output are written.
+   */
+  static inline void evaluateVGL_packed(int lmax,
+                                        const T* packed,
+                                        T x,
+                                        T y,
+                                        T z,
+                                        T* restrict XYZ,
+                                        T* restrict gr0,
+                                        T* restrict gr1,
+                                        T* restrict gr2,
+                                        T* restrict lap)
+  {
+    const int ntot = (lmax + 1) * (lmax + 2) * (lmax + 3) / 6;
+    for (int i = 0; i < ntot; i++)
+      XYZ[i] = gr0[i] = gr1[i] = gr2[i] = lap[i] = T(0);
+    evaluateVGL_impl(lmax, packed, x, y, z, XYZ, gr0, gr1, gr2, lap);
+  }
+
   void evaluateVGH(T x, T y, T z);
 
   void evaluateVGHGH(T x, T y, T z);
@@ -249,18 +290,28 @@ void SoaCartesianTensor<T>::evaluateVGL(T x, T y, T z)
 {
   constexpr T czero(0);
   cXYZ = czero;
+  evaluateVGL_impl(Lmax, NormFactor.data(), x, y, z, cXYZ.data(0), cXYZ.data(1), cXYZ.data(2), cXYZ.data(3),
+                   cXYZ.data(4));
+}
 
+template<class T>
+void SoaCartesianTensor<T>::evaluateVGL_impl(int lmax,
+                                             const T* norm_factor,
+                                             T x,
+                                             T y,
+                                             T z,
+                                             T* restrict XYZ,
+                                             T* restrict gr0,
+                                             T* restrict gr1,
+                                             T* restrict gr2,
+                                             T* restrict lap)
+{
   const T x2 = x * x, y2 = y * y, z2 = z * z;
   const T x3 = x2 * x, y3 = y2 * y, z3 = z2 * z;
   const T x4 = x3 * x, y4 = y3 * y, z4 = z3 * z;
   const T x5 = x4 * x, y5 = y4 * y, z5 = z4 * z;
-  T* restrict XYZ = cXYZ.data(0);
-  T* restrict gr0 = cXYZ.data(1);
-  T* restrict gr1 = cXYZ.data(2);
-  T* restrict gr2 = cXYZ.data(3);
-  T* restrict lap = cXYZ.data(4);
 
-  switch (Lmax)
+  switch (lmax)
   {
   case 6:
     XYZ[83] = x2 * y2 * z2; // X2Y2Z2
@@ -599,14 +650,14 @@ void SoaCartesianTensor<T>::evaluateVGL(T x, T y, T z)
     XYZ[0] = 1; // S
   }
 
-  const size_t ntot = NormFactor.size();
-  for (size_t i = 0; i < ntot; i++)
+  const int ntot = (lmax + 1) * (lmax + 2) * (lmax + 3) / 6;
+  for (int i = 0; i < ntot; i++)
   {
-    XYZ[i] *= NormFactor[i];
-    gr0[i] *= NormFactor[i];
-    gr1[i] *= NormFactor[i];
-    gr2[i] *= NormFactor[i];
-    lap[i] *= NormFactor[i];
+    XYZ[i] *= norm_factor[i];
+    gr0[i] *= norm_factor[i];
+    gr1[i] *= norm_factor[i];
+    gr2[i] *= norm_factor[i];
+    lap[i] *= norm_factor[i];
   }
 }
 
@@ -30,12 +30,12 @@ void SoaCuspCorrection::setBasisSetSize(int nbs)
 {
   BasisSetSize = nbs;
   //THIS NEEDS TO BE FIXE for OpenMP
-  myVGL.resize(5, BasisSetSize);
+  myVGL.resize(8, BasisSetSize);
 }
 
-inline void SoaCuspCorrection::evaluateVGL(const ParticleSet& P, int iat, VGLVector& vgl)
+void SoaCuspCorrection::computeVGL(const ParticleSet& P, int iat)
 {
-  myVGL = 0.0;
+  std::fill_n(myVGL.data(), 5 * myVGL.cols(), RealType(0));
 
   const auto& d_table = P.getDistTableAB(myTableIndex);
   const auto& dist    = (P.getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
@@ -44,9 +44,15 @@ inline void SoaCuspCorrection::evaluateVGL(const ParticleSet& P, int iat, VGLVec
   {
     if (LOBasisSet[c])
     {
-      LOBasisSet[c]->evaluate_vgl(dist[c], displ[c], myVGL[0], myVGL[1], myVGL[2], myVGL[3], myVGL[4]);
+      LOBasisSet[c]->evaluate_vgl(dist[c], displ[c], myVGL[0], myVGL[1], myVGL[2], myVGL[3], myVGL[4], myVGL[5],
+                                  myVGL[6], myVGL[7]);
     }
   }
+}
+
+inline void SoaCuspCorrection::evaluateVGL(const ParticleSet& P, int iat, VGLVector& vgl)
+{
+  computeVGL(P, iat);
 
   {
     const auto v_in  = myVGL[0];
@@ -76,18 +82,7 @@ void SoaCuspCorrection::evaluate_vgl(const ParticleSet& P,
                                      GradVector& dpsi,
                                      ValueVector& d2psi)
 {
-  myVGL = 0.0;
-
-  const auto& d_table = P.getDistTableAB(myTableIndex);
-  const auto& dist    = (P.getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
-  const auto& displ   = (P.getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
-  for (int c = 0; c < NumCenters; c++)
-  {
-    if (LOBasisSet[c])
-    {
-      LOBasisSet[c]->evaluate_vgl(dist[c], displ[c], myVGL[0], myVGL[1], myVGL[2], myVGL[3], myVGL[4]);
-    }
-  }
+  computeVGL(P, iat);
 
   const auto v_in  = myVGL[0];
   const auto gx_in = myVGL[1];
@@ -111,18 +106,7 @@ void SoaCuspCorrection::evaluate_vgl(const ParticleSet& P,
                                      GradMatrix& dpsi,
                                      ValueMatrix& d2psi)
 {
-  myVGL = 0.0;
-
-  const auto& d_table = P.getDistTableAB(myTableIndex);
-  const auto& dist    = (P.getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
-  const auto& displ   = (P.getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
-  for (int c = 0; c < NumCenters; c++)
-  {
-    if (LOBasisSet[c])
-    {
-      LOBasisSet[c]->evaluate_vgl(dist[c], displ[c], myVGL[0], myVGL[1], myVGL[2], myVGL[3], myVGL[4]);
-    }
-  }
+  computeVGL(P, iat);
 
   const auto v_in  = myVGL[0];
   const auto gx_in = myVGL[1];
@@ -143,7 +127,7 @@ void SoaCuspCorrection::evaluateV(const ParticleSet& P, int iat, ValueType* rest
 {
   ValueType* tmp_vals = myVGL[0];
 
-  std::fill_n(tmp_vals, myVGL.size(), 0.0);
+  std::fill_n(tmp_vals, myVGL.cols(), 0.0);
 
   const auto& d_table = P.getDistTableAB(myTableIndex);
   const auto& dist    = (P.getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
@@ -153,7 +137,7 @@ void SoaCuspCorrection::evaluateV(const ParticleSet& P, int iat, ValueType* rest
   {
     if (LOBasisSet[c])
     {
-      LOBasisSet[c]->evaluate(dist[c], tmp_vals);
+      LOBasisSet[c]->evaluate(dist[c], tmp_vals, myVGL[5]);
     }
   }
 
@@ -61,8 +61,12 @@ class SoaCuspCorrection
    */
   std::vector<std::shared_ptr<const COT>> LOBasisSet;
 
+  /// corrections of V, Gx, Gy, Gz and L, followed by the scratch rows of the radial functions
   Matrix<RealType> myVGL;
 
+  /// compute the corrections of particle iat in the first 5 rows of myVGL
+  void computeVGL(const ParticleSet& P, int iat);
+
 public:
   /** constructor
    * @param ions ionic system
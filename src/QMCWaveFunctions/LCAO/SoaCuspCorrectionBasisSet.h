@@ -57,49 +57,61 @@ public:
     AOs.add_spline(mo_idx, radial_spline);
   }
 
-  inline void evaluate(const T r, T* restrict vals) const
+  /// skip the evaluation beyond r, where all the corrected orbitals of this center are negligible
+  inline void setCutoff(QMCT::RealType r) { r_max_ = std::min(r_max_, r); }
+
+  inline QMCT::RealType getCutoff() const { return r_max_; }
+
+  /** add the values at distance r to vals
+   * @param phi scratch space of the number of splines
+   */
+  inline void evaluate(const T r, T* restrict vals, T* restrict phi) const
   {
     //assume output vars are zero'd
     if (r >= r_max_)
       return;
 
-    size_t nr = AOs.getNumSplines();
-    //FIXME ad-hoc allocation for performance
-    std::vector<T> phi(nr);
-
-    AOs.evaluate(r, phi.data());
+    const size_t nr = AOs.getNumSplines();
+    AOs.evaluate(r, phi);
     for (size_t i = 0; i < nr; ++i)
-      //vals[ID[i]]+=phi[i];
       vals[i] += phi[i];
   }
 
+  /** add the values, gradients and laplacians at distance r to the outputs
+   * @param phi,dphi,d2phi scratch space of the number of splines
+   */
   inline void evaluate_vgl(const T r,
                            const PosType& dr,
                            T* restrict u,
                            T* restrict du_x,
                            T* restrict du_y,
                            T* restrict du_z,
-                           T* restrict d2u) const
+                           T* restrict d2u,
+                           T* restrict phi,
+                           T* restrict dphi,
+                           T* restrict d2phi) const
   {
     //assume output vars are zero'd
     if (r >= r_max_)
       return;
 
-    size_t nr = AOs.getNumSplines();
-    //FIXME ad-hoc allocation for performance
-    std::vector<T> phi(nr);
-    std::vector<T> dphi(nr);
-    std::vector<T> d2phi(nr);
+    const size_t nr = AOs.getNumSplines();
+    AOs.evaluate(r, phi, dphi, d2phi);
 
-    AOs.evaluate(r, phi.data(), dphi.data(), d2phi.data());
+    constexpr T cone(1);
+    constexpr T ctwo(2);
+    const T rinv = cone / r;
+    // Displacements have opposite sign (relative to AOS)
+    const T drinv_x = -dr[0] * rinv;
+    const T drinv_y = -dr[1] * rinv;
+    const T drinv_z = -dr[2] * rinv;
     for (size_t i = 0; i < nr; ++i)
     {
-      const size_t j = i; //ID[i];
-      u[j] += phi[i];
-      du_x[j] -= dphi[i] * dr[0] / r; // Displacements have opposite sign (relative to AOS)
-      du_y[j] -= dphi[i] * dr[1] / r;
-      du_z[j] -= dphi[i] * dr[2] / r;
-      d2u[j] += d2phi[i] + 2 * dphi[i] / r;
+      u[i] += phi[i];
+      du_x[i] += dphi[i] * drinv_x;
+      du_y[i] += dphi[i] * drinv_y;
+      du_z[i] += dphi[i] * drinv_z;
+      d2u[i] += d2phi[i] + ctwo * dphi[i] * rinv;
     }
   }
 };
@@ -18,12 +18,75 @@
 #include "MultiFunctorAdapter.h"
 #include "SoaCartesianTensor.h"
 #include "SoaSphericalTensor.h"
+#include "OMPTarget/ScopedDefaultDevice.h"
 
 namespace qmcplusplus
 {
+/// atomic basis sets with radial functions and angular tensors evaluated by the offload kernel and in host batches
+template<class COT>
+struct is_offload_atomic_basis : std::false_type
+{};
+
+template<typename T, typename SH>
+struct is_offload_atomic_basis<SoaAtomicBasisSet<MultiQuinticSpline1D<T>, SH>> : std::true_type
+{
+  using angular_type = SH;
+};
+
+/** data of all the species of SoaAtomicBasisSet<MultiQuinticSpline1D, SH> flattened for the offload kernel
+ *
+ * species_ints and species_reals hold NUM_SPECIES_INTS and NUM_SPECIES_REALS entries per species.
+ * The offsets index reals (spline coefficients, first derivatives, grid, angular constants, radial cutoffs)
+ * and ints (NL, LM).
+ */
+template<typename T>
+struct SoaAtomicBasisOffloadData
+{
+  enum
+  {
+    LMAX = 0,
+    NUM_SPLINES,
+    BASIS_SIZE,
+    COEFF_LD,
+    COEFF_OFFSET,
+    FIRST_DERIV_OFFSET,
+    R_VALUES_OFFSET,
+    ANGULAR_OFFSET,
+    RNL_CUTOFF_OFFSET,
+    NL_OFFSET,
+    LM_OFFSET,
+    NUM_SPECIES_INTS
+  };
+
+  enum
+  {
+    LOWER_BOUND = 0,
+    ONE_OVER_LOG_DELTA,
+    RMAX,
+    PHASE,
+    NUM_SPECIES_REALS
+  };
+
+  Vector<int, OffloadAllocator<int>> species_ints;
+  Vector<T, OffloadAllocator<T>> species_reals;
+  Vector<T, OffloadAllocator<T>> reals;
+  Vector<int, OffloadAllocator<int>> ints;
+  ///species of each center
+  Vector<int, OffloadAllocator<int>> center_species;
+  ///offset of the basis functions of each center
+  Vector<int, OffloadAllocator<int>> basis_offsets;
+  ///maximal number of radial functions of the species
+  int max_num_splines = 0;
+  ///maximal number of angular functions of the species
+  int max_num_ylm = 0;
+};
+
 template<class COT, typename ORBT>
 SoaLocalizedBasisSet<COT, ORBT>::SoaLocalizedBasisSet(ParticleSet& ions, ParticleSet& els)
-    : ions_(ions), myTableIndex(els.addTable(ions, DTModes::NEED_FULL_TABLE_ANYTIME)), SuperTwist(0.0)
+    : ions_(ions),
+      myTableIndex(els.addTable(ions, DTModes::NEED_FULL_TABLE_ANYTIME)),
+      SuperTwist(0.0),
+      use_offload_(false)
 {
   NumCenters = ions.getTotalNum();
   NumTargets = els.getTotalNum();
@@ -40,11 +103,16 @@ SoaLocalizedBasisSet<COT, ORBT>::SoaLocalizedBasisSet(const SoaLocalizedBasisSet
       ions_(a.ions_),
       myTableIndex(a.myTableIndex),
       SuperTwist(a.SuperTwist),
-      BasisOffset(a.BasisOffset)
+      BasisOffset(a.BasisOffset),
+      use_offload_(a.use_offload_),
+      offload_data_(a.offload_data_)
 {
   LOBasisSet.reserve(a.LOBasisSet.size());
   for (auto& elem : a.LOBasisSet)
     LOBasisSet.push_back(std::make_unique<COT>(*elem));
+  // the offload tables are shared by the clones on the same device, a clone for a crowd on another device rebuilds them
+  if (offload_data_ && !isPresentOnDefaultDevice(offload_data_->species_ints.data()))
+    offload_data_ = createOffloadData();
 }
 
 template<class COT, typename ORBT>
@@ -165,6 +233,454 @@ void SoaLocalizedBasisSet<COT, ORBT>::evaluateV(const ParticleSet& P, int iat, O
   }
 }
 
+/// append the basis functions [first, last) to ranges, merging with the last range if contiguous
+inline void appendBasisRange(std::vector<std::pair<int, int>>& ranges, int first, int last)
+{
+  if (!ranges.empty() && ranges.back().second == first)
+    ranges.back().second = last;
+  else
+    ranges.emplace_back(first, last);
+}
+
+template<class COT, typename ORBT>
+void SoaLocalizedBasisSet<COT, ORBT>::evaluateVGLScreened(const ParticleSet& P,
+                                                          int iat,
+                                                          vgl_type& vgl,
+                                                          BasisRanges& ranges)
+{
+  const auto& IonID(ions_.GroupID);
+  const auto& coordR  = P.activeR(iat);
+  const auto& d_table = P.getDistTableAB(myTableIndex);
+  const auto& dist    = (P.getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
+  const auto& displ   = (P.getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
+
+  ranges.clear();
+  PosType Tv;
+  for (int c = 0; c < NumCenters; c++)
+  {
+    auto& basis = *LOBasisSet[IonID[c]];
+    if (basis.isBeyondCutoff(dist[c]))
+      continue;
+    Tv[0] = (ions_.R[c][0] - coordR[0]) - displ[c][0];
+    Tv[1] = (ions_.R[c][1] - coordR[1]) - displ[c][1];
+    Tv[2] = (ions_.R[c][2] - coordR[2]) - displ[c][2];
+    basis.evaluateVGL(P.getLattice(), dist[c], displ[c], BasisOffset[c], vgl, Tv);
+    appendBasisRange(ranges, BasisOffset[c], BasisOffset[c + 1]);
+  }
+}
+
+template<class COT, typename ORBT>
+void SoaLocalizedBasisSet<COT, ORBT>::evaluateVScreened(const ParticleSet& P,
+                                                        int iat,
+                                                        ORBT* restrict vals,
+                                                        BasisRanges& ranges)
+{
+  const auto& IonID(ions_.GroupID);
+  const auto& coordR  = P.activeR(iat);
+  const auto& d_table = P.getDistTableAB(myTableIndex);
+  const auto& dist    = (P.getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
+  const auto& displ   = (P.getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
+
+  ranges.clear();
+  PosType Tv;
+  for (int c = 0; c < NumCenters; c++)
+  {
+    auto& basis = *LOBasisSet[IonID[c]];
+    if (basis.isBeyondCutoff(dist[c]))
+      continue;
+    Tv[0] = (ions_.R[c][0] - coordR[0]) - displ[c][0];
+    Tv[1] = (ions_.R[c][1] - coordR[1]) - displ[c][1];
+    Tv[2] = (ions_.R[c][2] - coordR[2]) - displ[c][2];
+    basis.evaluateV(P.getLattice(), dist[c], displ[c], vals + BasisOffset[c], Tv);
+    appendBasisRange(ranges, BasisOffset[c], BasisOffset[c + 1]);
+  }
+}
+
+template<class COT, typename ORBT>
+void SoaLocalizedBasisSet<COT, ORBT>::setUseOffload(bool use_offload)
+{
+  use_offload_  = use_offload;
+  offload_data_ = use_offload ? createOffloadData() : nullptr;
+}
+
+template<class COT, typename ORBT>
+std::shared_ptr<SoaAtomicBasisOffloadData<typename SoaLocalizedBasisSet<COT, ORBT>::RealType>> SoaLocalizedBasisSet<
+    COT,
+    ORBT>::createOffloadData() const
+{
+  // the kernel computes real values only
+  if constexpr (!is_offload_atomic_basis<COT>::value || !std::is_same<ORBT, RealType>::value)
+    return nullptr;
+  else
+  {
+    using Data = SoaAtomicBasisOffloadData<RealType>;
+    auto data  = std::make_shared<Data>();
+
+    const size_t num_species = LOBasisSet.size();
+    data->species_ints.resize(num_species * Data::NUM_SPECIES_INTS);
+    data->species_reals.resize(num_species * Data::NUM_SPECIES_REALS);
+    std::fill(data->species_ints.begin(), data->species_ints.end(), 0);
+    std::fill(data->species_reals.begin(), data->species_reals.end(), RealType(0));
+
+    std::vector<RealType> reals;
+    std::vector<int> ints;
+    for (size_t ig = 0; ig < num_species; ig++)
+    {
+      if (!LOBasisSet[ig])
+        continue;
+      const auto& aos = *LOBasisSet[ig];
+      // periodic images are only handled by the host path
+      if (aos.PBCImages[0] != 0 || aos.PBCImages[1] != 0 || aos.PBCImages[2] != 0)
+        return nullptr;
+
+      const auto& coeffs = aos.MultiRnl.getCoeffs();
+      const auto& grid   = aos.MultiRnl.getGrid();
+      int* sints         = data->species_ints.data() + ig * Data::NUM_SPECIES_INTS;
+      RealType* sreals   = data->species_reals.data() + ig * Data::NUM_SPECIES_REALS;
+
+      sints[Data::LMAX]        = aos.Ylm.lmax();
+      sints[Data::NUM_SPLINES] = aos.MultiRnl.getNumSplines();
+      sints[Data::BASIS_SIZE]  = aos.BasisSetSize;
+      sints[Data::COEFF_LD]    = coeffs.cols();
+
+      sints[Data::COEFF_OFFSET] = reals.size();
+      reals.insert(reals.end(), coeffs.data(), coeffs.data() + coeffs.size());
+      sints[Data::FIRST_DERIV_OFFSET] = reals.size();
+      reals.insert(reals.end(), aos.MultiRnl.getFirstDeriv().begin(), aos.MultiRnl.getFirstDeriv().end());
+      sints[Data::R_VALUES_OFFSET] = reals.size();
+      reals.insert(reals.end(), grid.r_values.begin(), grid.r_values.end());
+      sints[Data::ANGULAR_OFFSET] = reals.size();
+      reals.resize(reals.size() + aos.Ylm.getNumPackedConstants());
+      aos.Ylm.packConstants(reals.data() + sints[Data::ANGULAR_OFFSET]);
+      sints[Data::RNL_CUTOFF_OFFSET] = reals.size();
+      reals.insert(reals.end(), aos.RnlCutoff.begin(), aos.RnlCutoff.end());
+
+      sints[Data::NL_OFFSET] = ints.size();
+      ints.insert(ints.end(), aos.NL.begin(), aos.NL.begin() + aos.BasisSetSize);
+      sints[Data::LM_OFFSET] = ints.size();
+      ints.insert(ints.end(), aos.LM.begin(), aos.LM.begin() + aos.BasisSetSize);
+
+      sreals[Data::LOWER_BOUND]        = grid.lower_bound;
+      sreals[Data::ONE_OVER_LOG_DELTA] = grid.OneOverLogDelta;
+      sreals[Data::RMAX]               = aos.Rmax;
+      sreals[Data::PHASE] =
+          aos.periodic_image_phase_factors.empty() ? RealType(1) : aos.periodic_image_phase_factors[0];
+
+      data->max_num_splines = std::max(data->max_num_splines, sints[Data::NUM_SPLINES]);
+      data->max_num_ylm     = std::max(data->max_num_ylm, static_cast<int>(aos.Ylm.size()));
+    }
+
+    data->reals.resize(reals.size());
+    std::copy(reals.begin(), reals.end(), data->reals.begin());
+    data->ints.resize(ints.size());
+    std::copy(ints.begin(), ints.end(), data->ints.begin());
+    data->center_species.resize(NumCenters);
+    data->basis_offsets.resize(NumCenters);
+    for (int c = 0; c < NumCenters; c++)
+    {
+      data->center_species[c] = ions_.GroupID[c];
+      data->basis_offsets[c]  = BasisOffset[c];
+    }
+
+    data->species_ints.updateTo();
+    data->species_reals.updateTo();
+    data->reals.updateTo();
+    data->ints.updateTo();
+    data->center_species.updateTo();
+    data->basis_offsets.updateTo();
+    return data;
+  }
+}
+
+template<class COT, typename ORBT>
+void SoaLocalizedBasisSet<COT, ORBT>::mw_evaluateVGL(const RefVectorWithLeader<BaseType>& basis_list,
+                                                     const RefVectorWithLeader<ParticleSet>& P_list,
+                                                     int first,
+                                                     int last,
+                                                     ORBT* vgl_mw,
+                                                     size_t ld)
+{
+  assert(this == &basis_list.getLeader());
+  if (!isOffloaded())
+  {
+    if (hasBatchedRadials())
+      mw_evaluateVGLBatchedRadials(P_list, first, last, vgl_mw, ld);
+    else
+      BaseType::mw_evaluateVGL(basis_list, P_list, first, last, vgl_mw, ld);
+    return;
+  }
+
+  if constexpr (is_offload_atomic_basis<COT>::value && std::is_same<ORBT, RealType>::value)
+  {
+    using Data             = SoaAtomicBasisOffloadData<RealType>;
+    using AngularType      = typename is_offload_atomic_basis<COT>::angular_type;
+    constexpr size_t NCOMP = OHMMS_DIM + 2;
+    constexpr RealType cone(1);
+    constexpr RealType ctwo(2);
+
+    const size_t nw          = basis_list.size();
+    const size_t nel         = last - first;
+    const int nblocks        = nw * nel;
+    const int num_centers    = NumCenters;
+    const int max_num_ylm    = offload_data_->max_num_ylm;
+    const int max_num_spline = offload_data_->max_num_splines;
+    const int scratch_stride = NCOMP * max_num_ylm + 3 * max_num_spline;
+
+    // r is recomputed from the displacements on the device, see SoaAtomicBasisSet::evaluateVGL
+    mw_displ_.resize(nblocks * num_centers * OHMMS_DIM);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      const ParticleSet& P = P_list[iw];
+      const auto& d_table  = P.getDistTableAB(myTableIndex);
+      for (int i = 0; i < nel; i++)
+      {
+        const int iat     = first + i;
+        const auto& displ = (P.getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
+        RealType* displ_block = mw_displ_.data() + (iw * nel + i) * num_centers * OHMMS_DIM;
+        for (int c = 0; c < num_centers; c++)
+          for (int idim = 0; idim < OHMMS_DIM; idim++)
+            displ_block[c * OHMMS_DIM + idim] = displ[c][idim];
+      }
+    }
+    if (mw_scratch_.size() < nblocks * num_centers * scratch_stride)
+      mw_scratch_.resize(nblocks * num_centers * scratch_stride);
+
+    auto* displ_ptr          = mw_displ_.data();
+    auto* scratch_ptr        = mw_scratch_.data();
+    auto* vgl_ptr            = vgl_mw;
+    const auto* sints_ptr    = offload_data_->species_ints.data();
+    const auto* sreals_ptr   = offload_data_->species_reals.data();
+    const auto* reals_ptr    = offload_data_->reals.data();
+    const auto* ints_ptr     = offload_data_->ints.data();
+    const auto* species_ptr  = offload_data_->center_species.data();
+    const auto* offsets_ptr  = offload_data_->basis_offsets.data();
+    const size_t displ_size  = mw_displ_.size();
+    const size_t output_size = nblocks * NCOMP * ld;
+
+    PRAGMA_OFFLOAD("omp target teams distribute parallel for collapse(2) \
+                    map(always, to: displ_ptr[:displ_size]) \
+                    map(always, from: vgl_ptr[:output_size])")
+    for (int ib = 0; ib < nblocks; ib++)
+      for (int c = 0; c < num_centers; c++)
+      {
+        const int* restrict sints      = sints_ptr + species_ptr[c] * Data::NUM_SPECIES_INTS;
+        const RealType* restrict sreal = sreals_ptr + species_ptr[c] * Data::NUM_SPECIES_REALS;
+        const int basis_size           = sints[Data::BASIS_SIZE];
+
+        RealType* restrict psi    = vgl_ptr + ib * NCOMP * ld + offsets_ptr[c];
+        RealType* restrict dpsi_x = psi + ld;
+        RealType* restrict dpsi_y = psi + 2 * ld;
+        RealType* restrict dpsi_z = psi + 3 * ld;
+        RealType* restrict d2psi  = psi + 4 * ld;
+        for (int ib_c = 0; ib_c < basis_size; ib_c++)
+          psi[ib_c] = dpsi_x[ib_c] = dpsi_y[ib_c] = dpsi_z[ib_c] = d2psi[ib_c] = RealType(0);
+
+        const RealType* restrict dr = displ_ptr + (ib * num_centers + c) * OHMMS_DIM;
+        const RealType r            = std::sqrt(dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2]);
+        if (r >= sreal[Data::RMAX])
+          continue;
+
+        RealType* restrict ylm_v = scratch_ptr + (ib * num_centers + c) * scratch_stride;
+        RealType* restrict ylm_x = ylm_v + max_num_ylm;
+        RealType* restrict ylm_y = ylm_v + 2 * max_num_ylm;
+        RealType* restrict ylm_z = ylm_v + 3 * max_num_ylm;
+        RealType* restrict ylm_l = ylm_v + 4 * max_num_ylm;
+        RealType* restrict phi   = ylm_v + NCOMP * max_num_ylm;
+        RealType* restrict dphi  = phi + max_num_spline;
+        RealType* restrict d2phi = phi + 2 * max_num_spline;
+
+        //SIGN Change!!
+        const RealType x = -dr[0], y = -dr[1], z = -dr[2];
+        AngularType::evaluateVGL_packed(sints[Data::LMAX], reals_ptr + sints[Data::ANGULAR_OFFSET], x, y, z, ylm_v,
+                                        ylm_x, ylm_y, ylm_z, ylm_l);
+
+        // same as LogGridLight::getCLForQuintic, r < Rmax guarantees the grid bound
+        const RealType lower_bound = sreal[Data::LOWER_BOUND];
+        int loc                    = -1;
+        RealType cL                = r - lower_bound;
+        if (r >= lower_bound)
+        {
+          loc = static_cast<int>(std::log(r / lower_bound) * sreal[Data::ONE_OVER_LOG_DELTA]);
+          cL  = r - reals_ptr[sints[Data::R_VALUES_OFFSET] + loc];
+        }
+        MultiQuinticSpline1D<RealType>::evaluate_impl(loc, cL, reals_ptr + sints[Data::COEFF_OFFSET],
+                                                      sints[Data::COEFF_LD],
+                                                      reals_ptr + sints[Data::FIRST_DERIV_OFFSET],
+                                                      sints[Data::NUM_SPLINES], phi, dphi, d2phi);
+
+        const RealType rinv                 = cone / r;
+        const RealType Phase                = sreal[Data::PHASE];
+        const int* restrict NL              = ints_ptr + sints[Data::NL_OFFSET];
+        const int* restrict LM              = ints_ptr + sints[Data::LM_OFFSET];
+        const RealType* restrict rnl_cutoff = reals_ptr + sints[Data::RNL_CUTOFF_OFFSET];
+        for (int ib_c = 0; ib_c < basis_size; ib_c++)
+        {
+          const int nl(NL[ib_c]);
+          if (r >= rnl_cutoff[nl])
+            continue;
+          const int lm(LM[ib_c]);
+          const RealType drnloverr = rinv * dphi[nl];
+          const RealType ang       = ylm_v[lm];
+          const RealType gr_x      = drnloverr * x;
+          const RealType gr_y      = drnloverr * y;
+          const RealType gr_z      = drnloverr * z;
+          const RealType ang_x     = ylm_x[lm];
+          const RealType ang_y     = ylm_y[lm];
+          const RealType ang_z     = ylm_z[lm];
+          const RealType vr        = phi[nl];
+
+          psi[ib_c]    = ang * vr * Phase;
+          dpsi_x[ib_c] = (ang * gr_x + vr * ang_x) * Phase;
+          dpsi_y[ib_c] = (ang * gr_y + vr * ang_y) * Phase;
+          dpsi_z[ib_c] = (ang * gr_z + vr * ang_z) * Phase;
+          d2psi[ib_c] = (ang * (ctwo * drnloverr + d2phi[nl]) + ctwo * (gr_x * ang_x + gr_y * ang_y + gr_z * ang_z) +
+                         vr * ylm_l[lm]) *
+              Phase;
+        }
+      }
+  }
+}
+
+template<class COT, typename ORBT>
+bool SoaLocalizedBasisSet<COT, ORBT>::hasBatchedRadials() const
+{
+  if constexpr (!is_offload_atomic_basis<COT>::value || !std::is_same<ORBT, RealType>::value)
+    return false;
+  else
+  {
+    // periodic images are only handled per electron
+    for (const auto& aos : LOBasisSet)
+      if (aos && (aos->PBCImages[0] != 0 || aos->PBCImages[1] != 0 || aos->PBCImages[2] != 0))
+        return false;
+    return true;
+  }
+}
+
+template<class COT, typename ORBT>
+void SoaLocalizedBasisSet<COT, ORBT>::mw_evaluateVGLBatchedRadials(const RefVectorWithLeader<ParticleSet>& P_list,
+                                                                   int first,
+                                                                   int last,
+                                                                   ORBT* vgl_mw,
+                                                                   size_t ld)
+{
+  if constexpr (is_offload_atomic_basis<COT>::value && std::is_same<ORBT, RealType>::value)
+  {
+    constexpr size_t NCOMP = OHMMS_DIM + 2;
+    constexpr RealType cone(1);
+    constexpr RealType ctwo(2);
+
+    const auto& IonID(ions_.GroupID);
+    const size_t nw       = P_list.size();
+    const size_t nel      = last - first;
+    const int nblocks     = nw * nel;
+    const int num_centers = NumCenters;
+
+    // r is recomputed from the displacements, see SoaAtomicBasisSet::evaluateVGL
+    mw_displ_.resize(nblocks * num_centers * OHMMS_DIM);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      const ParticleSet& P = P_list[iw];
+      const auto& d_table  = P.getDistTableAB(myTableIndex);
+      for (int i = 0; i < nel; i++)
+      {
+        const int iat         = first + i;
+        const auto& displ     = (P.getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
+        RealType* displ_block = mw_displ_.data() + (iw * nel + i) * num_centers * OHMMS_DIM;
+        for (int c = 0; c < num_centers; c++)
+          for (int idim = 0; idim < OHMMS_DIM; idim++)
+            displ_block[c * OHMMS_DIM + idim] = displ[c][idim];
+      }
+    }
+
+    for (int ib = 0; ib < nblocks; ib++)
+      for (int icomp = 0; icomp < NCOMP; icomp++)
+        std::fill_n(vgl_mw + (ib * NCOMP + icomp) * ld, BasisSetSize, ORBT(0));
+
+    if (mw_pairs_.size() < nblocks)
+      mw_pairs_.resize(nblocks);
+    mw_pair_blocks_.resize(nblocks);
+    for (int c = 0; c < num_centers; c++)
+    {
+      auto& aos = *LOBasisSet[IonID[c]];
+
+      RealType* restrict pair_r = mw_pairs_.data(0);
+      RealType* restrict pair_x = mw_pairs_.data(1);
+      RealType* restrict pair_y = mw_pairs_.data(2);
+      RealType* restrict pair_z = mw_pairs_.data(3);
+      int npairs                = 0;
+      for (int ib = 0; ib < nblocks; ib++)
+      {
+        const RealType* dr = mw_displ_.data() + (ib * num_centers + c) * OHMMS_DIM;
+        const RealType r   = std::sqrt(dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2]);
+        if (r >= aos.Rmax)
+          continue;
+        //SIGN Change!!
+        pair_r[npairs]          = r;
+        pair_x[npairs]          = -dr[0];
+        pair_y[npairs]          = -dr[1];
+        pair_z[npairs]          = -dr[2];
+        mw_pair_blocks_[npairs] = ib;
+        npairs++;
+      }
+      if (npairs == 0)
+        continue;
+
+      const int num_splines = aos.MultiRnl.getNumSplines();
+      const size_t ld_rnl   = getAlignedSize<RealType>(npairs);
+      if (mw_rnl_.size() < 3 * num_splines * ld_rnl)
+        mw_rnl_.resize(3 * num_splines * ld_rnl);
+      RealType* restrict phi   = mw_rnl_.data();
+      RealType* restrict dphi  = phi + num_splines * ld_rnl;
+      RealType* restrict d2phi = phi + 2 * num_splines * ld_rnl;
+      aos.MultiRnl.evaluate_batch(npairs, pair_r, phi, dphi, d2phi, ld_rnl);
+
+      const RealType* restrict ylm_v = aos.Ylm[0];
+      const RealType* restrict ylm_x = aos.Ylm[1];
+      const RealType* restrict ylm_y = aos.Ylm[2];
+      const RealType* restrict ylm_z = aos.Ylm[3];
+      const RealType* restrict ylm_l = aos.Ylm[4];
+      const RealType Phase =
+          aos.periodic_image_phase_factors.empty() ? RealType(1) : aos.periodic_image_phase_factors[0];
+      for (int k = 0; k < npairs; k++)
+      {
+        const RealType r = pair_r[k], x = pair_x[k], y = pair_y[k], z = pair_z[k];
+        aos.Ylm.evaluateVGL(x, y, z);
+
+        RealType* restrict psi    = vgl_mw + mw_pair_blocks_[k] * NCOMP * ld + BasisOffset[c];
+        RealType* restrict dpsi_x = psi + ld;
+        RealType* restrict dpsi_y = psi + 2 * ld;
+        RealType* restrict dpsi_z = psi + 3 * ld;
+        RealType* restrict d2psi  = psi + 4 * ld;
+        const RealType rinv       = cone / r;
+        for (int ib_c = 0; ib_c < aos.BasisSetSize; ib_c++)
+        {
+          const int nl(aos.NL[ib_c]);
+          if (r >= aos.RnlCutoff[nl])
+            continue;
+          const int lm(aos.LM[ib_c]);
+          const RealType vr        = phi[nl * ld_rnl + k];
+          const RealType drnloverr = rinv * dphi[nl * ld_rnl + k];
+          const RealType ang       = ylm_v[lm];
+          const RealType gr_x      = drnloverr * x;
+          const RealType gr_y      = drnloverr * y;
+          const RealType gr_z      = drnloverr * z;
+          const RealType ang_x     = ylm_x[lm];
+          const RealType ang_y     = ylm_y[lm];
+          const RealType ang_z     = ylm_z[lm];
+
+          psi[ib_c]    = ang * vr * Phase;
+          dpsi_x[ib_c] = (ang * gr_x + vr * ang_x) * Phase;
+          dpsi_y[ib_c] = (ang * gr_y + vr * ang_y) * Phase;
+          dpsi_z[ib_c] = (ang * gr_z + vr * ang_z) * Phase;
+          d2psi[ib_c]  = (ang * (ctwo * drnloverr + d2phi[nl * ld_rnl + k]) +
+                         ctwo * (gr_x * ang_x + gr_y * ang_y + gr_z * ang_z) + vr * ylm_l[lm]) *
+              Phase;
+        }
+      }
+    }
+  }
+}
+
 template<class COT, typename ORBT>
 void SoaLocalizedBasisSet<COT, ORBT>::evaluateGradSourceV(const ParticleSet& P,
                                                           int iat,
@@ -21,9 +21,13 @@
 
 #include <memory>
 #include "QMCWaveFunctions/BasisSetBase.h"
+#include "OMPTarget/OffloadAlignedAllocators.hpp"
 
 namespace qmcplusplus
 {
+template<typename T>
+struct SoaAtomicBasisOffloadData;
+
 /** A localized basis set derived from SoaBasisSetBase<ORBT>
  *
  * This class performs the evaluation of the basis functions and their
@@ -42,6 +46,7 @@ public:
   using vgh_type   = typename BaseType::vgh_type;
   using vghgh_type = typename BaseType::vghgh_type;
   using PosType    = typename ParticleSet::PosType;
+  using BasisRanges = typename BaseType::BasisRanges;
 
   using BaseType::BasisSetSize;
 
@@ -69,6 +74,39 @@ public:
    */
   std::vector<std::unique_ptr<COT>> LOBasisSet;
 
+private:
+  ///if true, mw_evaluateVGL uses the offload kernel when the atomic basis sets support it
+  bool use_offload_;
+  ///radial spline and angular constants of all the species on the device, shared by the clones
+  std::shared_ptr<SoaAtomicBasisOffloadData<RealType>> offload_data_;
+  ///displacements of all the electron-center pairs of a batch
+  Vector<RealType, OffloadPinnedAllocator<RealType>> mw_displ_;
+  ///device scratch space of the radial functions and angular tensors of a batch
+  Vector<RealType, OffloadAllocator<RealType>> mw_scratch_;
+  ///r, x, y and z of the electron-center pairs of one center within its cutoff in a batch
+  VectorSoaContainer<RealType, 4> mw_pairs_;
+  ///output block of each pair in mw_pairs_
+  std::vector<int> mw_pair_blocks_;
+  ///radial functions and their first two derivatives of mw_pairs_
+  aligned_vector<RealType> mw_rnl_;
+
+  ///collect the device data, returns nullptr if the atomic basis sets cannot be offloaded
+  std::shared_ptr<SoaAtomicBasisOffloadData<RealType>> createOffloadData() const;
+
+  ///return true if mw_evaluateVGL can evaluate the radial functions of each center in a batch on the host
+  bool hasBatchedRadials() const;
+
+  /** host mw_evaluateVGL with the radial functions of all the electron-center pairs of a center evaluated at once
+   * Requires hasBatchedRadials().
+   */
+  void mw_evaluateVGLBatchedRadials(const RefVectorWithLeader<ParticleSet>& P_list,
+                                    int first,
+                                    int last,
+                                    ORBT* vgl_mw,
+                                    size_t ld);
+
+public:
+
   /** constructor
    * @param ions ionic system
    * @param els electronic system
@@ -134,6 +172,42 @@ public:
    */
   void evaluateV(const ParticleSet& P, int iat, ORBT* restrict vals) override;
 
+  /** compute VGL skipping the centers beyond the cutoff radius of their basis functions
+   * @param ranges the basis function ranges of the evaluated centers, contiguous centers are merged
+   */
+  void evaluateVGLScreened(const ParticleSet& P, int iat, vgl_type& vgl, BasisRanges& ranges) override;
+
+  /// compute values skipping the centers beyond the cutoff radius of their basis functions
+  void evaluateVScreened(const ParticleSet& P, int iat, ORBT* restrict vals, BasisRanges& ranges) override;
+
+  /// only the basis functions centered on ion jion depend on its position
+  void getGradSourceRanges(int jion, BasisRanges& ranges) const override
+  {
+    ranges.assign(1, {static_cast<int>(BasisOffset[jion]), static_cast<int>(BasisOffset[jion + 1])});
+  }
+
+  /** compute VGL of electrons [first, last) for all the walkers
+   *
+   * With offload enabled, real valued orbitals, MultiQuinticSpline1D radial functions and no periodic images,
+   * all the electron-center pairs are evaluated in a single offload region. Without offload and under the same
+   * conditions, the radial functions of each center are evaluated for all the walkers' electrons at once by
+   * MultiQuinticSpline1D::evaluate_batch. Otherwise the walkers are looped over.
+   */
+  void mw_evaluateVGL(const RefVectorWithLeader<BaseType>& basis_list,
+                      const RefVectorWithLeader<ParticleSet>& P_list,
+                      int first,
+                      int last,
+                      ORBT* vgl_mw,
+                      size_t ld) override;
+
+  /** enable or disable the offload path of mw_evaluateVGL
+   * Must be called after setBasisSetSize and setPBCParams.
+   */
+  void setUseOffload(bool use_offload);
+
+  /// return true if mw_evaluateVGL uses the offload kernel
+  bool isOffloaded() const { return use_offload_ && offload_data_; }
+
   void evaluateGradSourceV(const ParticleSet& P, int iat, const ParticleSet& ions, int jion, vgl_type& vgl) override;
 
   void evaluateGradSourceVGL(const ParticleSet& P,
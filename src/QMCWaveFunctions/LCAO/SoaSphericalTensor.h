@@ -15,6 +15,8 @@
 
 #include <stdexcept>
 #include <limits>
+#include <algorithm>
+#include "config.h"
 #include "OhmmsSoA/VectorSoaContainer.h"
 #include "OhmmsPETE/Tensor.h"
 
@@ -47,6 +49,12 @@ struct SoaSphericalTensor
   aligned_vector<T> FactorL;
   ///pre-evaluated factor \f$(2l+1)/(2l-1)\f$
   aligned_vector<T> Factor2L;
+  /** gradient table, the bare Ylm entering the x (2), y (2) and z (1) gradients of each lm
+   * unused terms point to entry 0 with a zero coefficient
+   */
+  aligned_vector<int> GradSource;
+  ///gradient table, the coefficients of GradSource with NormFactor included
+  aligned_vector<T> GradCoef;
   ///composite
   VectorSoaContainer<T, 5> cYlm;
 
@@ -55,7 +63,159 @@ struct SoaSphericalTensor
   SoaSphericalTensor(const SoaSphericalTensor& rhs) = default;
 
   ///compute Ylm
-  void evaluate_bare(T x, T y, T z, T* Ylm) const;
+  void evaluate_bare(T x, T y, T z, T* Ylm) const
+  {
+    evaluate_bare_impl(Lmax, FactorL.data(), FactorLM.data(), x, y, z, Ylm);
+  }
+
+  /** compute Ylm without normalization from raw factors, callable in offload regions
+   * @param lmax maximum angular momentum
+   * @param factor_l FactorL[lmax+1]
+   * @param factor_lm FactorLM[(lmax+1)^2]
+   */
+  static void evaluate_bare_impl(int lmax, const T* factor_l, const T* factor_lm, T x, T y, T z, T* Ylm);
+
+  /** compute r^l S_l^m and their gradients from raw factors, callable in offload regions
+   * The laplacians are zero and not touched.
+   */
+  static void evaluateVGL_impl(int lmax,
+                               const T* norm_factor,
+                               const T* factor_l,
+                               const T* factor_lm,
+                               const T* factor_2l,
+                               T x,
+                               T y,
+                               T z,
+                               T* restrict Ylm,
+                               T* restrict gYlmX,
+                               T* restrict gYlmY,
+                               T* restrict gYlmZ);
+
+  /// number of constants stored by packConstants
+  inline size_t getNumPackedConstants() const { return 2 * (NormFactor.size() + FactorL.size()); }
+
+  /// pack NormFactor, FactorL, FactorLM and Factor2L contiguously for evaluateVGL_packed
+  inline void packConstants(T* packed) const
+  {
+    const size_t ntot = NormFactor.size();
+    std::copy_n(NormFactor.data(), ntot, packed);
+    std::copy_n(FactorL.data(), Lmax + 1, packed + ntot);
+    std::copy_n(FactorLM.data(), ntot, packed + ntot + Lmax + 1);
+    std::copy_n(Factor2L.data(), Lmax + 1, packed + 2 * ntot + Lmax + 1);
+  }
+
+  /** compute VGL from the constants stored by packConstants, callable in offload regions
+   * All the (lmax+1)^2 entries of each output are written.
+   */
+  static inline void evaluateVGL_packed(int lmax,
+                                        const T* packed,
+                                        T x,
+                                        T y,
+                                        T z,
+                                        T* restrict Ylm,
+                                        T* restrict gYlmX,
+                                        T* restrict gYlmY,
+                                        T* restrict gYlmZ,
+                                        T* restrict lYlm)
+  {
+    const int ntot = (lmax + 1) * (lmax + 1);
+    for (int i = 0; i < ntot; i++)
+      lYlm[i] = T(0);
+    evaluateVGL_impl(lmax, packed, packed + ntot, packed + ntot + lmax + 1, packed + 2 * ntot + lmax + 1, x, y, z, Ylm,
+                     gYlmX, gYlmY, gYlmZ);
+  }
+
+  /// points per tile of the batched evaluation on the host
+  static constexpr int BatchTile = 64;
+
+  /** compute Ylm without normalization of n <= TILE points, callable in offload regions
+   * The points run in the innermost loops. Entry lm of point i is stored in Ylm[lm * ld + i].
+   */
+  template<int TILE>
+  static void evaluate_bare_tile(int lmax,
+                                 const T* factor_l,
+                                 const T* factor_lm,
+                                 int n,
+                                 const T* restrict x,
+                                 const T* restrict y,
+                                 const T* restrict z,
+                                 T* restrict Ylm,
+                                 size_t ld);
+
+  /** compute r^l S_l^m and their gradients of n <= TILE points from the gradient table, callable in offload regions
+   * Same layout as evaluate_bare_tile for all the outputs. The laplacians are zero and not touched.
+   */
+  template<int TILE>
+  static void evaluateVGL_tile(int lmax,
+                               const T* norm_factor,
+                               const T* factor_l,
+                               const T* factor_lm,
+                               const int* grad_source,
+                               const T* grad_coef,
+                               int n,
+                               const T* restrict x,
+                               const T* restrict y,
+                               const T* restrict z,
+                               T* restrict Ylm,
+                               T* restrict gYlmX,
+                               T* restrict gYlmY,
+                               T* restrict gYlmZ,
+                               size_t ld);
+
+  /** compute Ylm of npts points
+   * @param x,y,z coordinates of the points
+   * @param Ylm entry lm of point i is stored in Ylm[lm * ld + i], ld >= npts
+   */
+  inline void evaluateV_batch(int npts, const T* x, const T* y, const T* z, T* Ylm, size_t ld) const
+  {
+    const int ntot = NormFactor.size();
+    for (int first = 0; first < npts; first += BatchTile)
+    {
+      const int n = std::min(BatchTile, npts - first);
+      evaluate_bare_tile<BatchTile>(Lmax, FactorL.data(), FactorLM.data(), n, x + first, y + first, z + first,
+                                    Ylm + first, ld);
+      for (int lm = 0; lm < ntot; lm++)
+      {
+        T* restrict ylm = Ylm + lm * ld + first;
+        const T norm_lm = NormFactor[lm];
+#pragma omp simd
+        for (int i = 0; i < n; i++)
+          ylm[i] *= norm_lm;
+      }
+    }
+  }
+
+  /** compute Ylm and their gradients of npts points, the batched evaluateVGL
+   * Same layout as evaluateV_batch for all the outputs. The laplacians are zero and not computed.
+   */
+  inline void evaluateVGL_batch(int npts,
+                                const T* x,
+                                const T* y,
+                                const T* z,
+                                T* Ylm,
+                                T* gYlmX,
+                                T* gYlmY,
+                                T* gYlmZ,
+                                size_t ld) const
+  {
+    for (int first = 0; first < npts; first += BatchTile)
+      evaluateVGL_tile<BatchTile>(Lmax, NormFactor.data(), FactorL.data(), FactorLM.data(), GradSource.data(),
+                                  GradCoef.data(), std::min(BatchTile, npts - first), x + first, y + first,
+                                  z + first, Ylm + first, gYlmX + first, gYlmY + first, gYlmZ + first, ld);
+  }
+
+  /** evaluateVGL_batch offloaded, one point per device thread
+   * The inputs and outputs are host arrays mapped to the device for the call.
+   */
+  void evaluateVGL_batch_offload(int npts,
+                                 const T* x,
+                                 const T* y,
+                                 const T* z,
+                                 T* Ylm,
+                                 T* gYlmX,
+                                 T* gYlmY,
+                                 T* gYlmZ,
+                                 size_t ld) const;
 
   ///compute Ylm
   inline void evaluateV(T x, T y, T z, T* Ylm) const
@@ -84,7 +244,7 @@ struct SoaSphericalTensor
   void evaluateVGHGH(T x, T y, T z);
 
   ///returns the index/locator for (\f$l,m\f$) combo, \f$ l(l+1)+m \f$
-  inline int index(int l, int m) const { return (l * (l + 1)) + m; }
+  static inline int index(int l, int m) { return (l * (l + 1)) + m; }
 
   /** return the starting address of the component
    *
@@ -167,10 +327,86 @@ inline SoaSphericalTensor<T>::SoaSphericalTensor(const int l_max, bool addsign)
       FactorLM[index(l, m)]  = fac2;
       FactorLM[index(l, -m)] = fac2;
     }
+  // the terms of evaluateVGL_impl gathered into a table, so the batched gradients are branch free
+  GradSource.resize(5 * ntot, 0);
+  GradCoef.resize(5 * ntot, czero);
+  constexpr T ahalf(0.5);
+  for (int l = 1; l <= Lmax; l++)
+    for (int m = -l; m <= l; m++)
+    {
+      const int lm0 = index(l - 1, 0);
+      const int ma  = std::abs(m);
+      const T fac   = Factor2L[l];
+      const T cp    = std::sqrt(fac * (l - ma - 1) * (l - ma));
+      const T cm    = std::sqrt(fac * (l + ma - 1) * (l + ma));
+      const T c0    = std::sqrt(fac * (l - ma) * (l + ma));
+      // (source, coefficient) of dpr, dpi, dmr and dmi
+      int spr = 0, spi = 0, smr = lm0, smi = 0;
+      T cpr = czero, cpi = czero, cmr = cm, cmi = czero;
+      if (l > ma + 1)
+      {
+        spr = lm0 + ma + 1;
+        spi = lm0 - ma - 1;
+        cpr = cpi = cp;
+      }
+      if (l > 1)
+      {
+        if (ma == 0)
+        {
+          smr = lm0 + 1;
+          cmr = -cm;
+          smi = lm0 - 1;
+          cmi = cm;
+        }
+        else if (ma > 1)
+        {
+          smr = lm0 + ma - 1;
+          smi = lm0 - ma + 1;
+          cmi = cm;
+        }
+      }
+      const int lm      = index(l, m);
+      const T norm      = ma ? NormFactor[lm] : cone;
+      int* restrict src = GradSource.data() + 5 * lm;
+      T* restrict coef  = GradCoef.data() + 5 * lm;
+      if (m < 0)
+      {
+        src[0]  = spi;
+        coef[0] = ahalf * norm * cpi;
+        src[1]  = smi;
+        coef[1] = -ahalf * norm * cmi;
+        src[2]  = spr;
+        coef[2] = -ahalf * norm * cpr;
+        src[3]  = smr;
+        coef[3] = -ahalf * norm * cmr;
+      }
+      else
+      {
+        src[0]  = spr;
+        coef[0] = ahalf * norm * cpr;
+        src[1]  = smr;
+        coef[1] = -ahalf * norm * cmr;
+        src[2]  = spi;
+        coef[2] = ahalf * norm * cpi;
+        src[3]  = smi;
+        coef[3] = ahalf * norm * cmi;
+      }
+      if (l > ma)
+      {
+        src[4]  = lm0 + m;
+        coef[4] = norm * c0;
+      }
+    }
 }
 
 template<typename T>
-inline void SoaSphericalTensor<T>::evaluate_bare(T x, T y, T z, T* restrict Ylm) const
+inline void SoaSphericalTensor<T>::evaluate_bare_impl(int lmax,
+                                                     const T* factor_l,
+                                                     const T* factor_lm,
+                                                     T x,
+                                                     T y,
+                                                     T z,
+                                                     T* restrict Ylm)
 {
   constexpr T czero(0);
   constexpr T cone(1);
@@ -204,13 +440,13 @@ inline void SoaSphericalTensor<T>::evaluate_bare(T x, T y, T z, T* restrict Ylm)
   }
   T stheta = std::sqrt(cone - ctheta * ctheta);
   /* Now to calculate the associated legendre functions P_lm from the
-     recursion relation from l=0 to Lmax. Conventions of J.D. Jackson,
+     recursion relation from l=0 to lmax. Conventions of J.D. Jackson,
      Classical Electrodynamics are used. */
   Ylm[0] = cone;
   // calculate P_ll and P_l,l-1
   T fac = cone;
   int j = -1;
-  for (int l = 1; l <= Lmax; l++)
+  for (int l = 1; l <= lmax; l++)
   {
     j += 2;
     fac *= -j * stheta;
@@ -221,10 +457,10 @@ inline void SoaSphericalTensor<T>::evaluate_bare(T x, T y, T z, T* restrict Ylm)
     Ylm[l1] = j * ctheta * Ylm[l2];
   }
   // Use recurence to get other plm's //
-  for (int m = 0; m < Lmax - 1; m++)
+  for (int m = 0; m < lmax - 1; m++)
   {
     int j = 2 * m + 1;
-    for (int l = m + 2; l <= Lmax; l++)
+    for (int l = m + 2; l <= lmax; l++)
     {
       j += 2;
       int lm  = index(l, m);
@@ -237,12 +473,12 @@ inline void SoaSphericalTensor<T>::evaluate_bare(T x, T y, T z, T* restrict Ylm)
   T sphim, cphim, temp;
   Ylm[0] = omega; //1.0/sqrt(pi4);
   T rpow = 1.0;
-  for (int l = 1; l <= Lmax; l++)
+  for (int l = 1; l <= lmax; l++)
   {
     rpow *= r;
     //fac = rpow*sqrt(static_cast<T>(2*l+1))*omega;//rpow*sqrt((2*l+1)/pi4);
-    //FactorL[l] = sqrt(2*l+1)/sqrt(4*pi)
-    fac    = rpow * FactorL[l];
+    //factor_l[l] = sqrt(2*l+1)/sqrt(4*pi)
+    fac    = rpow * factor_l[l];
     int l0 = index(l, 0);
     Ylm[l0] *= fac;
     cphim = cone;
@@ -253,7 +489,7 @@ inline void SoaSphericalTensor<T>::evaluate_bare(T x, T y, T z, T* restrict Ylm)
       sphim  = sphim * cphi + cphim * sphi;
       cphim  = temp;
       int lm = index(l, m);
-      fac *= FactorLM[lm];
+      fac *= factor_lm[lm];
       temp    = fac * Ylm[lm];
       Ylm[lm] = temp * cphim;
       lm      = index(l, -m);
@@ -267,20 +503,34 @@ inline void SoaSphericalTensor<T>::evaluate_bare(T x, T y, T z, T* restrict Ylm)
 template<typename T>
 inline void SoaSphericalTensor<T>::evaluateVGL(T x, T y, T z)
 {
-  T* restrict Ylm = cYlm.data(0);
-  evaluate_bare(x, y, z, Ylm);
+  evaluateVGL_impl(Lmax, NormFactor.data(), FactorL.data(), FactorLM.data(), Factor2L.data(), x, y, z, cYlm.data(0),
+                   cYlm.data(1), cYlm.data(2), cYlm.data(3));
+}
+
+template<typename T>
+inline void SoaSphericalTensor<T>::evaluateVGL_impl(int lmax,
+                                                   const T* norm_factor,
+                                                   const T* factor_l,
+                                                   const T* factor_lm,
+                                                   const T* factor_2l,
+                                                   T x,
+                                                   T y,
+                                                   T z,
+                                                   T* restrict Ylm,
+                                                   T* restrict gYlmX,
+                                                   T* restrict gYlmY,
+                                                   T* restrict gYlmZ)
+{
+  evaluate_bare_impl(lmax, factor_l, factor_lm, x, y, z, Ylm);
 
   constexpr T czero(0);
   constexpr T ahalf(0.5);
-  T* restrict gYlmX = cYlm.data(1);
-  T* restrict gYlmY = cYlm.data(2);
-  T* restrict gYlmZ = cYlm.data(3);
 
   // Calculating Gradient now//
-  for (int l = 1; l <= Lmax; l++)
+  for (int l = 1; l <= lmax; l++)
   {
     //T fac = ((T) (2*l+1))/(2*l-1);
-    T fac = Factor2L[l];
+    T fac = factor_2l[l];
     for (int m = -l; m <= l; m++)
     {
       int lm = index(l - 1, 0);
@@ -337,9 +587,9 @@ inline void SoaSphericalTensor<T>::evaluateVGL(T x, T y, T z)
       lm = index(l, m);
       if (ma)
       {
-        gYlmX[lm] = NormFactor[lm] * gx;
-        gYlmY[lm] = NormFactor[lm] * gy;
-        gYlmZ[lm] = NormFactor[lm] * gz;
+        gYlmX[lm] = norm_factor[lm] * gx;
+        gYlmY[lm] = norm_factor[lm] * gy;
+        gYlmZ[lm] = norm_factor[lm] * gz;
       }
       else
       {
@@ -349,9 +599,198 @@ inline void SoaSphericalTensor<T>::evaluateVGL(T x, T y, T z)
       }
     }
   }
-  for (int i = 0; i < cYlm.size(); i++)
-    Ylm[i] *= NormFactor[i];
-  //for (int i=0; i<Ylm.size(); i++) gradYlm[i]*= NormFactor[i];
+  for (int i = 0, ntot = (lmax + 1) * (lmax + 1); i < ntot; i++)
+    Ylm[i] *= norm_factor[i];
+  //for (int i=0; i<Ylm.size(); i++) gradYlm[i]*= norm_factor[i];
+}
+
+template<typename T>
+template<int TILE>
+inline void SoaSphericalTensor<T>::evaluate_bare_tile(int lmax,
+                                                     const T* factor_l,
+                                                     const T* factor_lm,
+                                                     int n,
+                                                     const T* restrict x,
+                                                     const T* restrict y,
+                                                     const T* restrict z,
+                                                     T* restrict Ylm,
+                                                     size_t ld)
+{
+  constexpr T czero(0);
+  constexpr T cone(1);
+  const T pi       = 4.0 * std::atan(1.0);
+  const T omega    = 1.0 / std::sqrt(4.0 * pi);
+  constexpr T eps2 = std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon();
+
+  // the steps of evaluate_bare_impl, each over all the points with the singularity checks turned into selects
+  T r[TILE], ctheta[TILE], stheta[TILE], cphi[TILE], sphi[TILE], fac[TILE], cphim[TILE], sphim[TILE];
+#pragma omp simd
+  for (int i = 0; i < n; i++)
+  {
+    const T r2xy    = x[i] * x[i] + y[i] * y[i];
+    r[i]            = std::sqrt(r2xy + z[i] * z[i]);
+    const bool pole = r2xy < eps2;
+    const T rxyi    = cone / std::sqrt(pole ? cone : r2xy);
+    const T ct      = pole ? ((z[i] < czero) ? -cone : cone) : z[i] / r[i];
+    ctheta[i]       = std::min(std::max(ct, -cone), cone);
+    stheta[i]       = std::sqrt(cone - ctheta[i] * ctheta[i]);
+    cphi[i]         = pole ? czero : x[i] * rxyi;
+    sphi[i]         = pole ? cone : y[i] * rxyi;
+    fac[i]          = cone;
+    Ylm[i]          = cone;
+  }
+
+  // P_ll and P_l,l-1
+  int j = -1;
+  for (int l = 1; l <= lmax; l++)
+  {
+    j += 2;
+    T* restrict yll       = Ylm + index(l, l) * ld;
+    T* restrict yl1       = Ylm + index(l, l - 1) * ld;
+    const T* restrict yl2 = Ylm + index(l - 1, l - 1) * ld;
+#pragma omp simd
+    for (int i = 0; i < n; i++)
+    {
+      fac[i] *= -j * stheta[i];
+      yll[i] = fac[i];
+      yl1[i] = j * ctheta[i] * yl2[i];
+    }
+  }
+  // the other P_lm by the recurrence
+  for (int m = 0; m < lmax - 1; m++)
+  {
+    int j = 2 * m + 1;
+    for (int l = m + 2; l <= lmax; l++)
+    {
+      j += 2;
+      T* restrict ylm       = Ylm + index(l, m) * ld;
+      const T* restrict yl1 = Ylm + index(l - 1, m) * ld;
+      const T* restrict yl2 = Ylm + index(l - 2, m) * ld;
+      const T c2            = l + m - 1;
+      const T cinv          = cone / (l - m);
+#pragma omp simd
+      for (int i = 0; i < n; i++)
+        ylm[i] = (ctheta[i] * j * yl1[i] - c2 * yl2[i]) * cinv;
+    }
+  }
+
+  // r^l Y_lm
+  T rpow[TILE];
+  for (int i = 0; i < n; i++)
+  {
+    Ylm[i]  = omega;
+    rpow[i] = cone;
+  }
+  for (int l = 1; l <= lmax; l++)
+  {
+    T* restrict yl0 = Ylm + index(l, 0) * ld;
+#pragma omp simd
+    for (int i = 0; i < n; i++)
+    {
+      rpow[i] *= r[i];
+      fac[i] = rpow[i] * factor_l[l];
+      yl0[i] *= fac[i];
+      cphim[i] = cone;
+      sphim[i] = czero;
+    }
+    for (int m = 1; m <= l; m++)
+    {
+      T* restrict ylp = Ylm + index(l, m) * ld;
+      T* restrict ylm = Ylm + index(l, -m) * ld;
+      const T flm     = factor_lm[index(l, m)];
+#pragma omp simd
+      for (int i = 0; i < n; i++)
+      {
+        const T temp = cphim[i] * cphi[i] - sphim[i] * sphi[i];
+        sphim[i]     = sphim[i] * cphi[i] + cphim[i] * sphi[i];
+        cphim[i]     = temp;
+        fac[i] *= flm;
+        const T val = fac[i] * ylp[i];
+        ylp[i]      = val * cphim[i];
+        ylm[i]      = val * sphim[i];
+      }
+    }
+  }
+}
+
+template<typename T>
+template<int TILE>
+inline void SoaSphericalTensor<T>::evaluateVGL_tile(int lmax,
+                                                   const T* norm_factor,
+                                                   const T* factor_l,
+                                                   const T* factor_lm,
+                                                   const int* grad_source,
+                                                   const T* grad_coef,
+                                                   int n,
+                                                   const T* restrict x,
+                                                   const T* restrict y,
+                                                   const T* restrict z,
+                                                   T* restrict Ylm,
+                                                   T* restrict gYlmX,
+                                                   T* restrict gYlmY,
+                                                   T* restrict gYlmZ,
+                                                   size_t ld)
+{
+  evaluate_bare_tile<TILE>(lmax, factor_l, factor_lm, n, x, y, z, Ylm, ld);
+
+  const int ntot = (lmax + 1) * (lmax + 1);
+  for (int lm = 0; lm < ntot; lm++)
+  {
+    const int* restrict src = grad_source + 5 * lm;
+    const T* restrict coef  = grad_coef + 5 * lm;
+    const T* restrict x0    = Ylm + src[0] * ld;
+    const T* restrict x1    = Ylm + src[1] * ld;
+    const T* restrict y0    = Ylm + src[2] * ld;
+    const T* restrict y1    = Ylm + src[3] * ld;
+    const T* restrict z0    = Ylm + src[4] * ld;
+    T* restrict gx          = gYlmX + lm * ld;
+    T* restrict gy          = gYlmY + lm * ld;
+    T* restrict gz          = gYlmZ + lm * ld;
+#pragma omp simd
+    for (int i = 0; i < n; i++)
+    {
+      gx[i] = coef[0] * x0[i] + coef[1] * x1[i];
+      gy[i] = coef[2] * y0[i] + coef[3] * y1[i];
+      gz[i] = coef[4] * z0[i];
+    }
+  }
+  for (int lm = 0; lm < ntot; lm++)
+  {
+    T* restrict ylm = Ylm + lm * ld;
+    const T norm_lm = norm_factor[lm];
+#pragma omp simd
+    for (int i = 0; i < n; i++)
+      ylm[i] *= norm_lm;
+  }
+}
+
+template<typename T>
+void SoaSphericalTensor<T>::evaluateVGL_batch_offload(int npts,
+                                                     const T* x,
+                                                     const T* y,
+                                                     const T* z,
+                                                     T* Ylm,
+                                                     T* gYlmX,
+                                                     T* gYlmY,
+                                                     T* gYlmZ,
+                                                     size_t ld) const
+{
+  const int lmax           = Lmax;
+  const size_t ntot        = NormFactor.size();
+  const size_t output_size = ntot * ld;
+  const T* norm_factor     = NormFactor.data();
+  const T* factor_l        = FactorL.data();
+  const T* factor_lm       = FactorLM.data();
+  const int* grad_source   = GradSource.data();
+  const T* grad_coef       = GradCoef.data();
+
+  PRAGMA_OFFLOAD("omp target teams distribute parallel for \
+                  map(to: norm_factor[:ntot], factor_l[:lmax + 1], factor_lm[:ntot], \
+                          grad_source[:5 * ntot], grad_coef[:5 * ntot], x[:npts], y[:npts], z[:npts]) \
+                  map(from: Ylm[:output_size], gYlmX[:output_size], gYlmY[:output_size], gYlmZ[:output_size])")
+  for (int i = 0; i < npts; i++)
+    evaluateVGL_tile<1>(lmax, norm_factor, factor_l, factor_lm, grad_source, grad_coef, 1, x + i, y + i, z + i,
+                        Ylm + i, gYlmX + i, gYlmY + i, gYlmZ + i, ld);
 }
 
 template<typename T>
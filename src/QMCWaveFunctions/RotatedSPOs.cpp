@@ -14,6 +14,7 @@
 #include "Numerics/MatrixOperators.h"
 #include "Numerics/DeterminantOperators.h"
 #include "CPU/BLAS.hpp"
+#include <algorithm>
 
 
 namespace qmcplusplus
@@ -439,6 +440,39 @@ void RotatedSPOs::evaluateDerivativesWF(ParticleSet& P,
   }
 }
 
+int RotatedSPOs::getMaxExcitationLevel(const std::vector<int>& detData, const size_t num_unique_dets)
+{
+  int max_k = 0;
+  for (size_t index = 0, datum = 0; index < num_unique_dets; index++)
+  {
+    max_k = std::max(max_k, detData[datum]);
+    datum += 3 * detData[datum] + 1;
+  }
+  return max_k;
+}
+
+void RotatedSPOs::invertExcitedBlock(const int k,
+                                     const int* pos,
+                                     const int* uno,
+                                     const ValueType* T,
+                                     const size_t nmo,
+                                     ValueType* alpha_inv,
+                                     ValueType* WS,
+                                     IndexType* Piv)
+{
+  // alpha = P^{T}TQ gathers the rows i_1..i_k and the columns a_1..a_k of T
+  for (int i = 0; i < k; i++)
+    for (int j = 0; j < k; j++)
+      alpha_inv[i * k + j] = T[pos[i] * nmo + uno[j]];
+  if (k == 1)
+    alpha_inv[0] = ValueType(1) / alpha_inv[0];
+  else
+  {
+    std::complex<RealType> logdet = 0.0;
+    InvertWithLog(alpha_inv, k, k, WS, Piv, logdet);
+  }
+}
+
 void RotatedSPOs::table_method_eval(std::vector<ValueType>& dlogpsi,
                                     std::vector<ValueType>& dhpsioverpsi,
                                     const ParticleSet::ParticleLaplacian& myL_J,
@@ -581,7 +615,7 @@ $
 {
   ValueMatrix Table;
   ValueMatrix Bbar;
-  ValueMatrix Y1, Y2, Y3, Y4, Y5, Y6, Y7, Y11, Y23, Y24, Y25, Y26;
+  ValueMatrix Y1, Y2, Y3, Y4;
   ValueMatrix pK1, K1T, TK1T, pK2, K2AiB, TK2AiB, K2XA, TK2XA, K2T, TK2T, MK2T, pK3, K3T, TK3T, pK5, K5T, TK5T;
 
   Table.resize(nel, nmo);
@@ -685,130 +719,76 @@ $
   std::fill(pK5.begin(), pK5.end(), 0.0);
 
   //Now we are going to loop through all unique determinants.
-  //The few lines above are for the reference matrix contribution.
-  //Although I start the loop below from index 0, the loop only performs actions when the index is >= 1
+  //The reference determinant (k == 0) does not contribute to the pK matrices.
   //the detData object contains all the information about the P^T and Q matrices (projection matrices) needed in the table method
+  //The CI terms sharing a unique determinant only differ by a scalar weight, so the weights are summed first and
+  //the contractions with alpha_{I}^{-1} are done once per unique determinant.
+  //Q alpha_{I}^{-1} P^{T} only has nonzero elements in the rows a_1..a_k and the columns i_1..i_k,
+  //so the k x k blocks are added to the pK matrices directly.
+  const int max_k = getMaxExcitationLevel(detData_up, num_unique_up_dets);
+  std::vector<ValueType> alpha_inv(max_k * max_k), Y23(max_k * max_k), Y24(max_k * max_k), Y25(max_k * max_k);
+  Vector<ValueType> WS(max_k);
+  Vector<IndexType> Piv(max_k);
   const int* restrict data_it = detData_up.data();
   for (int index = 0, datum = 0; index < num_unique_up_dets; index++)
   {
-    const int k = data_it[datum];
-
+    const int k             = data_it[datum];
+    const int* restrict pos = data_it + datum + 1;
+    const int* restrict uno = pos + k;
+    datum += 3 * k + 1;
     if (k == 0)
-    {
-      datum += 3 * k + 1;
-    }
-
-    else
-    {
-      //Number of rows and cols of P^T
-      const int prows = k;
-      const int pcols = nel;
-      //Number of rows and cols of Q
-      const int qrows = nmo;
-      const int qcols = k;
-
-      Y5.resize(nel, k);
-      Y6.resize(k, k);
-
-      //Any matrix multiplication of P^T or Q is simply a projection
-      //Explicit matrix multiplication can be avoided; instead column or row copying can be done
-      //BlAS::copy(size of col/row being copied,
-      //           Matrix pointer + place to begin copying,
-      //           storage spacing (number of elements btw next row/col element),
-      //           Pointer to resultant matrix + place to begin pasting,
-      //           storage spacing of resultant matrix)
-      //For example the next 4 lines is the matrix multiplication of T*Q = Y5
-      std::fill(Y5.begin(), Y5.end(), 0.0);
-      for (int i = 0; i < k; i++)
-      {
-        BLAS::copy(nel, T + data_it[datum + 1 + k + i], nmo, Y5.data() + i, k);
-      }
-
-      std::fill(Y6.begin(), Y6.end(), 0.0);
-      for (int i = 0; i < k; i++)
-      {
-        BLAS::copy(k, Y5.data() + (data_it[datum + 1 + i]) * k, 1, (Y6.data() + i * k), 1);
-      }
-
-
-      Vector<ValueType> WS;
-      Vector<IndexType> Piv;
-      WS.resize(k);
-      Piv.resize(k);
-      std::complex<RealType> logdet = 0.0;
-      InvertWithLog(Y6.data(), k, k, WS.data(), Piv.data(), logdet);
-
-      Y11.resize(nel, k);
-      Y23.resize(k, k);
-      Y24.resize(k, k);
-      Y25.resize(k, k);
-      Y26.resize(k, nel);
-
-      std::fill(Y11.begin(), Y11.end(), 0.0);
-      for (int i = 0; i < k; i++)
-      {
-        BLAS::copy(nel, Y4.data() + (data_it[datum + 1 + k + i]), nmo, Y11.data() + i, k);
-      }
-
-      std::fill(Y23.begin(), Y23.end(), 0.0);
-      for (int i = 0; i < k; i++)
-      {
-        BLAS::copy(k, Y11.data() + (data_it[datum + 1 + i]) * k, 1, (Y23.data() + i * k), 1);
-      }
-
-      BLAS::gemm('N', 'N', k, k, k, RealType(1.0), Y23.data(), k, Y6.data(), k, RealType(0.0), Y24.data(), k);
-      BLAS::gemm('N', 'N', k, k, k, RealType(1.0), Y6.data(), k, Y24.data(), k, RealType(0.0), Y25.data(), k);
-
-
-      Y26.resize(k, nel);
+      continue;
 
-      std::fill(Y26.begin(), Y26.end(), 0.0);
-      for (int i = 0; i < k; i++)
+    //alpha_{I}^{-1}=(P^{T}TQ)^{-1} and P^{T}\widetilde{M}Q
+    invertExcitedBlock(k, pos, uno, T, nmo, alpha_inv.data(), WS.data(), Piv.data());
+    for (int i = 0; i < k; i++)
+      for (int j = 0; j < k; j++)
+        Y23[i * k + j] = Y4(pos[i], uno[j]);
+
+    //Y24 = alpha_{I}^{-1}P^{T}\widetilde{M}Q and Y25 = Y24 alpha_{I}^{-1}
+    // c_Tr_AlphaI_MI = Tr[\alpha_{I}^{-1}(P^{T}\widetilde{M} Q)]
+    RealType c_Tr_AlphaI_MI = 0.0;
+    for (int i = 0; i < k; i++)
+      for (int j = 0; j < k; j++)
       {
-        BLAS::copy(k, Y25.data() + i, k, Y26.data() + (data_it[datum + 1 + i]), nel);
+        ValueType y24(0);
+        for (int l = 0; l < k; l++)
+          y24 += alpha_inv[i * k + l] * Y23[l * k + j];
+        Y24[i * k + j] = y24;
       }
-
-
-      Y7.resize(k, nel);
-
-      std::fill(Y7.begin(), Y7.end(), 0.0);
-      for (int i = 0; i < k; i++)
+    for (int i = 0; i < k; i++)
+    {
+      c_Tr_AlphaI_MI += Y24[i * k + i];
+      for (int j = 0; j < k; j++)
       {
-        BLAS::copy(k, Y6.data() + i, k, Y7.data() + (data_it[datum + 1 + i]), nel);
+        ValueType y25(0);
+        for (int l = 0; l < k; l++)
+          y25 += Y24[i * k + l] * alpha_inv[l * k + j];
+        Y25[i * k + j] = y25;
       }
+    }
 
-      // c_Tr_AlphaI_MI is a constant contributing to constant const2
-      // c_Tr_AlphaI_MI = Tr[\alpha_{I}^{-1}(P^{T}\widetilde{M} Q)]
-      RealType c_Tr_AlphaI_MI = 0.0;
-      for (int i = 0; i < k; i++)
-      {
-        c_Tr_AlphaI_MI += Y24(i, i);
-      }
+    //el_p is the element position that contains information about the CI coefficient, and det up/dn values associated with the current unique determinant
+    RealType alpha_2(0.0), alpha_3(0.0);
+    for (const int el_p : lookup_tbl[index])
+    {
+      const RealType c  = cptr[el_p];
+      const size_t up   = upC[el_p];
+      const size_t down = dnC[el_p];
+      alpha_2 += c * detValues_dn[down] * detValues_up[up] / detValues_up[0];
+      alpha_3 += c * Oi[down] * detValues_up[up] / detValues_up[0];
+    }
+    const RealType alpha_1(alpha_2 * c_Tr_AlphaI_MI);
+    const2 += alpha_1;
 
-      for (int p = 0; p < lookup_tbl[index].size(); p++)
+    for (int i = 0; i < k; i++)
+      for (int j = 0; j < k; j++)
       {
-        //el_p is the element position that contains information about the CI coefficient, and det up/dn values associated with the current unique determinant
-        const int el_p(lookup_tbl[index][p]);
-        const RealType c  = cptr[el_p];
-        const size_t up   = upC[el_p];
-        const size_t down = dnC[el_p];
-
-        const RealType alpha_1(c * detValues_dn[down] * detValues_up[up] / detValues_up[0] * c_Tr_AlphaI_MI);
-        const RealType alpha_2(c * detValues_dn[down] * detValues_up[up] / detValues_up[0]);
-        const RealType alpha_3(c * Oi[down] * detValues_up[up] / detValues_up[0]);
-
-        const2 += alpha_1;
-
-        for (int i = 0; i < k; i++)
-        {
-          BLAS::axpy(nel, alpha_1, Y7.data() + i * nel, 1, pK1.data() + (data_it[datum + 1 + k + i]) * nel, 1);
-          BLAS::axpy(nel, alpha_2, Y7.data() + i * nel, 1, pK2.data() + (data_it[datum + 1 + k + i]) * nel, 1);
-          BLAS::axpy(nel, alpha_3, Y7.data() + i * nel, 1, pK3.data() + (data_it[datum + 1 + k + i]) * nel, 1);
-          BLAS::axpy(nel, alpha_2, Y26.data() + i * nel, 1, pK5.data() + (data_it[datum + 1 + k + i]) * nel, 1);
-        }
+        pK1(uno[i], pos[j]) += alpha_1 * alpha_inv[i * k + j];
+        pK2(uno[i], pos[j]) += alpha_2 * alpha_inv[i * k + j];
+        pK3(uno[i], pos[j]) += alpha_3 * alpha_inv[i * k + j];
+        pK5(uno[i], pos[j]) += alpha_2 * Y25[i * k + j];
       }
-      datum += 3 * k + 1;
-    }
   }
 
 
@@ -886,7 +866,6 @@ void RotatedSPOs::table_method_evalWF(std::vector<ValueType>& dlogpsi,
                                       const std::vector<std::vector<int>>& lookup_tbl)
 {
   ValueMatrix Table;
-  ValueMatrix Y5, Y6, Y7;
   ValueMatrix pK4, K4T, TK4T;
 
   Table.resize(nel, nmo);
@@ -931,84 +910,36 @@ void RotatedSPOs::table_method_evalWF(std::vector<ValueType>& dlogpsi,
 
   std::fill(pK4.begin(), pK4.end(), 0.0);
 
-  //Now we are going to loop through all unique determinants.
-  //The few lines above are for the reference matrix contribution.
-  //Although I start the loop below from index 0, the loop only performs actions when the index is >= 1
-  //the detData object contains all the information about the P^T and Q matrices (projection matrices) needed in the table method
+  //Now we are going to loop through all unique determinants, see table_method_eval.
+  const int max_k = getMaxExcitationLevel(detData_up, num_unique_up_dets);
+  std::vector<ValueType> alpha_inv(max_k * max_k);
+  Vector<ValueType> WS(max_k);
+  Vector<IndexType> Piv(max_k);
   const int* restrict data_it = detData_up.data();
   for (int index = 0, datum = 0; index < num_unique_up_dets; index++)
   {
-    const int k = data_it[datum];
-
+    const int k             = data_it[datum];
+    const int* restrict pos = data_it + datum + 1;
+    const int* restrict uno = pos + k;
+    datum += 3 * k + 1;
     if (k == 0)
-    {
-      datum += 3 * k + 1;
-    }
-
-    else
-    {
-      //Number of rows and cols of P^T
-      const int prows = k;
-      const int pcols = nel;
-      //Number of rows and cols of Q
-      const int qrows = nmo;
-      const int qcols = k;
-
-      Y5.resize(nel, k);
-      Y6.resize(k, k);
-
-      //Any matrix multiplication of P^T or Q is simply a projection
-      //Explicit matrix multiplication can be avoided; instead column or row copying can be done
-      //BlAS::copy(size of col/row being copied,
-      //           Matrix pointer + place to begin copying,
-      //           storage spacing (number of elements btw next row/col element),
-      //           Pointer to resultant matrix + place to begin pasting,
-      //           storage spacing of resultant matrix)
-      //For example the next 4 lines is the matrix multiplication of T*Q = Y5
-      std::fill(Y5.begin(), Y5.end(), 0.0);
-      for (int i = 0; i < k; i++)
-      {
-        BLAS::copy(nel, T + data_it[datum + 1 + k + i], nmo, Y5.data() + i, k);
-      }
-
-      std::fill(Y6.begin(), Y6.end(), 0.0);
-      for (int i = 0; i < k; i++)
-      {
-        BLAS::copy(k, Y5.data() + (data_it[datum + 1 + i]) * k, 1, (Y6.data() + i * k), 1);
-      }
-
-      Vector<ValueType> WS;
-      Vector<IndexType> Piv;
-      WS.resize(k);
-      Piv.resize(k);
-      std::complex<RealType> logdet = 0.0;
-      InvertWithLog(Y6.data(), k, k, WS.data(), Piv.data(), logdet);
-
-      Y7.resize(k, nel);
+      continue;
 
-      std::fill(Y7.begin(), Y7.end(), 0.0);
-      for (int i = 0; i < k; i++)
-      {
-        BLAS::copy(k, Y6.data() + i, k, Y7.data() + (data_it[datum + 1 + i]), nel);
-      }
+    invertExcitedBlock(k, pos, uno, T, nmo, alpha_inv.data(), WS.data(), Piv.data());
 
-      for (int p = 0; p < lookup_tbl[index].size(); p++)
-      {
-        //el_p is the element position that contains information about the CI coefficient, and det up/dn values associated with the current unique determinant
-        const int el_p(lookup_tbl[index][p]);
-        const RealType c  = cptr[el_p];
-        const size_t up   = upC[el_p];
-        const size_t down = dnC[el_p];
-
-        const RealType alpha_4(c * detValues_dn[down] * detValues_up[up] * (1 / psiCurrent));
-
-        for (int i = 0; i < k; i++)
-        {
-          BLAS::axpy(nel, alpha_4, Y7.data() + i * nel, 1, pK4.data() + (data_it[datum + 1 + k + i]) * nel, 1);
-        }
-      }
-      datum += 3 * k + 1;
+    //el_p is the element position that contains information about the CI coefficient, and det up/dn values associated with the current unique determinant
+    RealType alpha_4(0.0);
+    for (const int el_p : lookup_tbl[index])
+    {
+      const RealType c  = cptr[el_p];
+      const size_t up   = upC[el_p];
+      const size_t down = dnC[el_p];
+      alpha_4 += c * detValues_dn[down] * detValues_up[up] * (1 / psiCurrent);
     }
+
+    for (int i = 0; i < k; i++)
+      for (int j = 0; j < k; j++)
+        pK4(uno[i], pos[j]) += alpha_4 * alpha_inv[i * k + j];
   }
 
   BLAS::gemm('N', 'N', nmo, nmo, nel, RealType(1.0), T, nmo, pK4.data(), nel, RealType(0.0), K4T.data(), nmo);
@@ -165,6 +165,26 @@ public:
                            const std::vector<int>& detData_up,
                            const std::vector<std::vector<int>>& lookup_tbl);
 
+  /// highest excitation level among the unique determinants encoded in detData
+  static int getMaxExcitationLevel(const std::vector<int>& detData, const size_t num_unique_dets);
+
+  /** compute alpha^{-1} of an excited determinant for the table method, alpha = P^T T Q
+   * @param k excitation level
+   * @param pos rows i_1..i_k of the replaced orbitals
+   * @param uno orbitals a_1..a_k replacing them
+   * @param T the nel x nmo table A^{-1} \widetilde{A}
+   * @param alpha_inv k x k result, row major
+   * @param WS,Piv inversion scratch of size k
+   */
+  static void invertExcitedBlock(const int k,
+                                 const int* pos,
+                                 const int* uno,
+                                 const ValueType* T,
+                                 const size_t nmo,
+                                 ValueType* alpha_inv,
+                                 ValueType* WS,
+                                 IndexType* Piv);
+
   void checkInVariables(opt_variables_type& active) override
   {
     //reset parameters to zero after coefficient matrix has been updated
@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "SPOEvaluationCache.h"
+#include <algorithm>
+
+namespace qmcplusplus
+{
+std::shared_ptr<SPOEvaluationCache> SPOEvaluationCacheRegistry::getCache(const std::string& spo_name,
+                                                                           int first,
+                                                                           int last)
+{
+  if (spo_name.empty())
+    return nullptr;
+  auto& cache = caches_[spo_name];
+  if (!cache)
+    cache = std::make_shared<SPOEvaluationCache>();
+  cache->addUser(first, last);
+  return cache;
+}
+
+void SPOEvaluationCache::addUser(int first, int last)
+{
+  for (const auto& range : ranges_)
+    if (std::max(range.first, first) < std::min(range.second, last))
+      shared_ = true;
+  ranges_.emplace_back(first, last);
+}
+
+bool SPOEvaluationCache::matches(const ParticleSet& P, int iat) const
+{
+  // spinor orbitals also depend on the spin, they are never cached
+  return ptcl_ == &P && iat_ == iat && !P.isSpinor() && pos_ == P.activeR(iat);
+}
+
+void SPOEvaluationCache::setKey(const ParticleSet& P, int iat)
+{
+  ptcl_ = &P;
+  iat_  = iat;
+  pos_  = P.activeR(iat);
+}
+
+bool SPOEvaluationCache::getValue(const ParticleSet& P, int iat, ValueVector& psi) const
+{
+  if (!has_value_ || psi.size() != psi_.size() || !matches(P, iat))
+    return false;
+  std::copy_n(psi_.data(), psi_.size(), psi.data());
+  num_hits_++;
+  return true;
+}
+
+bool SPOEvaluationCache::getVGL(const ParticleSet& P,
+                                int iat,
+                                ValueVector& psi,
+                                GradVector& dpsi,
+                                ValueVector& d2psi) const
+{
+  if (!has_vgl_ || psi.size() != psi_.size() || !matches(P, iat))
+    return false;
+  std::copy_n(psi_.data(), psi_.size(), psi.data());
+  std::copy_n(dpsi_.data(), dpsi_.size(), dpsi.data());
+  std::copy_n(d2psi_.data(), d2psi_.size(), d2psi.data());
+  num_hits_++;
+  return true;
+}
+
+void SPOEvaluationCache::putValue(const ParticleSet& P, int iat, const ValueVector& psi)
+{
+  setKey(P, iat);
+  psi_.resize(psi.size());
+  std::copy_n(psi.data(), psi.size(), psi_.data());
+  has_value_ = true;
+  has_vgl_   = false;
+}
+
+void SPOEvaluationCache::putVGL(const ParticleSet& P,
+                                int iat,
+                                const ValueVector& psi,
+                                const GradVector& dpsi,
+                                const ValueVector& d2psi)
+{
+  setKey(P, iat);
+  psi_.resize(psi.size());
+  dpsi_.resize(dpsi.size());
+  d2psi_.resize(d2psi.size());
+  std::copy_n(psi.data(), psi.size(), psi_.data());
+  std::copy_n(dpsi.data(), dpsi.size(), dpsi_.data());
+  std::copy_n(d2psi.data(), d2psi.size(), d2psi_.data());
+  has_value_ = has_vgl_ = true;
+}
+
+} // namespace qmcplusplus
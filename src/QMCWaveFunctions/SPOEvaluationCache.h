@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_SPOEVALUATIONCACHE_H
+#define QMCPLUSPLUS_SPOEVALUATIONCACHE_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "QMCWaveFunctions/SPOSet.h"
+
+namespace qmcplusplus
+{
+/** orbital values of the latest single particle evaluation of a SPOSet.
+ *
+ * Components of a TrialWaveFunction built on the same SPOSet and covering the same particles
+ * evaluate the same orbitals at the same proposed position. The first one stores the result
+ * and the others consume it instead of evaluating the orbitals again.
+ * An entry is identified by the particle set, the particle index and the position so that
+ * a stale entry is never returned after a particle moved.
+ * The cache is only useful when the particle ranges of at least two users overlap, see isShared.
+ * Caches are handed out by SPOEvaluationCacheRegistry.
+ */
+class SPOEvaluationCache
+{
+public:
+  using ValueVector = SPOSet::ValueVector;
+  using GradVector  = SPOSet::GradVector;
+  using PosType     = QMCTraits::PosType;
+
+  /// true if the particle ranges of two users overlap
+  bool isShared() const { return shared_; }
+
+  /// forget the cached evaluation, for example after the orbitals changed
+  void invalidate() { has_value_ = has_vgl_ = false; }
+
+  /** copy the cached values of particle iat of P if any
+   * @return true if the values were found
+   */
+  bool getValue(const ParticleSet& P, int iat, ValueVector& psi) const;
+
+  /** copy the cached values, gradients and laplacians of particle iat of P if any
+   * @return true if they were found
+   */
+  bool getVGL(const ParticleSet& P, int iat, ValueVector& psi, GradVector& dpsi, ValueVector& d2psi) const;
+
+  /// store the values of particle iat of P
+  void putValue(const ParticleSet& P, int iat, const ValueVector& psi);
+
+  /// store the values, gradients and laplacians of particle iat of P
+  void putVGL(const ParticleSet& P, int iat, const ValueVector& psi, const GradVector& dpsi, const ValueVector& d2psi);
+
+  /// number of lookups served from the cache
+  size_t getNumHits() const { return num_hits_; }
+
+private:
+  /// particle ranges of the users
+  std::vector<std::pair<int, int>> ranges_;
+  bool shared_ = false;
+
+  const ParticleSet* ptcl_ = nullptr;
+  int iat_                 = -1;
+  PosType pos_;
+  bool has_value_ = false;
+  bool has_vgl_   = false;
+  ValueVector psi_;
+  GradVector dpsi_;
+  ValueVector d2psi_;
+  mutable size_t num_hits_ = 0;
+
+  void addUser(int first, int last);
+  friend class SPOEvaluationCacheRegistry;
+  bool matches(const ParticleSet& P, int iat) const;
+  void setKey(const ParticleSet& P, int iat);
+};
+
+/** the SPOEvaluationCache objects of a TrialWaveFunction indexed by SPOSet name
+ */
+class SPOEvaluationCacheRegistry
+{
+public:
+  /** get the cache of a SPOSet and record the particle range of its user
+   * @param spo_name name of the SPOSet, an empty name gets no cache
+   * @param first index of the first particle evaluated by the user
+   * @param last index after the last particle evaluated by the user
+   */
+  std::shared_ptr<SPOEvaluationCache> getCache(const std::string& spo_name, int first, int last);
+
+private:
+  std::map<std::string, std::shared_ptr<SPOEvaluationCache>> caches_;
+};
+
+} // namespace qmcplusplus
+#endif
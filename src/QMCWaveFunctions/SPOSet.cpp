@@ -121,6 +121,33 @@ void SPOSet::mw_evaluateVGLandDetRatioGrads(const RefVectorWithLeader<SPOSet>& s
   }
 }
 
+void SPOSet::mw_evaluateVandDetRatio(const RefVectorWithLeader<SPOSet>& spo_list,
+                                     const RefVectorWithLeader<ParticleSet>& P_list,
+                                     int iat,
+                                     const std::vector<const ValueType*>& invRow_ptr_list,
+                                     VGLVector& phi_vgl_v,
+                                     std::vector<ValueType>& ratios) const
+{
+  assert(this == &spo_list.getLeader());
+  const size_t nw = spo_list.size();
+  if (isOMPoffload())
+  {
+    // offload implementations leave phi_vgl_v on the device, only their own VGL version knows how
+    std::vector<GradType> grads(nw);
+    mw_evaluateVGLandDetRatioGrads(spo_list, P_list, iat, invRow_ptr_list, phi_vgl_v, ratios, grads);
+    return;
+  }
+
+  const size_t norb_requested = phi_vgl_v.size() / nw;
+#pragma omp parallel for
+  for (int iw = 0; iw < nw; iw++)
+  {
+    ValueVector phi_v(phi_vgl_v.data() + norb_requested * iw, norb_requested);
+    spo_list[iw].evaluateValue(P_list[iw], iat, phi_v);
+    ratios[iw] = simd::dot(invRow_ptr_list[iw], phi_v.data(), norb_requested);
+  }
+}
+
 void SPOSet::evaluateThirdDeriv(const ParticleSet& P, int first, int last, GGGMatrix& grad_grad_grad_logdet)
 {
   throw std::runtime_error("Need specialization of SPOSet::evaluateThirdDeriv(). \n");
@@ -291,6 +291,21 @@ public:
                                               std::vector<ValueType>& ratios,
                                               std::vector<GradType>& grads) const;
 
+  /** evaluate the values of this single-particle orbital sets and determinant ratio of multiple walkers
+   * Only the values in phi_vgl_v are set. Used by ratio-only moves which don't keep gradients and laplacians.
+   * @param spo_list the list of SPOSet pointers in a walker batch
+   * @param P_list the list of ParticleSet pointers in a walker batch
+   * @param iat active particle
+   * @param phi_vgl_v orbital values of all the walkers
+   * @param ratios determinant ratio of all the walkers
+   */
+  virtual void mw_evaluateVandDetRatio(const RefVectorWithLeader<SPOSet>& spo_list,
+                                       const RefVectorWithLeader<ParticleSet>& P_list,
+                                       int iat,
+                                       const std::vector<const ValueType*>& invRow_ptr_list,
+                                       VGLVector& phi_vgl_v,
+                                       std::vector<ValueType>& ratios) const;
+
   /** evaluate the values, gradients and hessians of this single-particle orbital set
    * @param P current ParticleSet
    * @param iat active particle
@@ -18,6 +18,7 @@
 
 #if !defined(QMC_COMPLEX)
 #include "QMCWaveFunctions/RotatedSPOs.h"
+#include "MemoryAccounting.h"
 #endif
 
 namespace qmcplusplus
@@ -47,6 +48,7 @@ std::unique_ptr<SPOSet> SPOSetBuilder::createSPOSet(xmlNodePtr cur, SPOSetInputI
 
 SPOSet* SPOSetBuilder::createSPOSet(xmlNodePtr cur)
 {
+  ScopedMemoryTag memory_tag("SPOs");
   std::string spo_object_name;
   std::string optimize("no");
 
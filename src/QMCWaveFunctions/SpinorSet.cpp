@@ -11,11 +11,51 @@
 //////////////////////////////////////////////////////////////////////////////////////
 
 #include "SpinorSet.h"
+#include "ResourceCollection.h"
 
 namespace qmcplusplus
 {
+/** up and down channel values of all the walkers of a crowd
+ *
+ * Kept across the calls to avoid allocating the scratch for every move.
+ */
+struct SpinorSetMultiWalkerResource : public Resource
+{
+  using ValueVector = SPOSet::ValueVector;
+  using GradVector  = SPOSet::GradVector;
+  using ValueMatrix = SPOSet::ValueMatrix;
+  using GradMatrix  = SPOSet::GradMatrix;
+
+  std::vector<ValueVector> up_psi, dn_psi, up_d2psi, dn_d2psi;
+  std::vector<GradVector> up_dpsi, dn_dpsi;
+  std::vector<ValueMatrix> up_logdet, dn_logdet, up_d2logdet, dn_d2logdet;
+  std::vector<GradMatrix> up_dlogdet, dn_dlogdet;
+
+  SpinorSetMultiWalkerResource() : Resource("SpinorSet") {}
+  SpinorSetMultiWalkerResource(const SpinorSetMultiWalkerResource&) : SpinorSetMultiWalkerResource() {}
+
+  Resource* makeClone() const override { return new SpinorSetMultiWalkerResource(*this); }
+};
+
+/// resize the scratch of nw walkers, the existing buffers are kept if already large enough
+template<typename CT, typename... Args>
+static void resizeMultiWalkerScratch(std::vector<CT>& scratch, int nw, Args... sizes)
+{
+  scratch.resize(nw);
+  for (auto& a : scratch)
+    a.resize(sizes...);
+}
+
+template<typename CT>
+static RefVector<CT> makeRefVector(std::vector<CT>& scratch)
+{
+  return RefVector<CT>(scratch.begin(), scratch.end());
+}
+
 SpinorSet::SpinorSet() : SPOSet(), className("SpinorSet"), spo_up(nullptr), spo_dn(nullptr) {}
 
+SpinorSet::~SpinorSet() = default;
+
 void SpinorSet::set_spos(std::unique_ptr<SPOSet>&& up, std::unique_ptr<SPOSet>&& dn)
 {
   //Sanity check for input SPO's.  They need to be the same size or
@@ -145,64 +185,32 @@ void SpinorSet::mw_evaluateVGLWithSpin(const RefVectorWithLeader<SPOSet>& spo_li
                                        const RefVector<ValueVector>& dspin_v_list) const
 {
   auto& spo_leader = spo_list.getCastedLeader<SpinorSet>();
-  auto& P_leader   = P_list.getLeader();
   assert(this == &spo_leader);
 
-  IndexType nw          = spo_list.size();
-  SPOSet& up_spo_leader = *(spo_leader.spo_up);
-  SPOSet& dn_spo_leader = *(spo_leader.spo_dn);
-  RefVectorWithLeader<SPOSet> up_spo_list(up_spo_leader);
-  RefVectorWithLeader<SPOSet> dn_spo_list(dn_spo_leader);
-  up_spo_list.reserve(nw);
-  dn_spo_list.reserve(nw);
-
-  std::vector<ValueVector> mw_up_psi_work, mw_dn_psi_work;
-  std::vector<GradVector> mw_up_dpsi_work, mw_dn_dpsi_work;
-  std::vector<ValueVector> mw_up_d2psi_work, mw_dn_d2psi_work;
-  mw_up_psi_work.reserve(nw);
-  mw_up_dpsi_work.reserve(nw);
-  mw_up_d2psi_work.reserve(nw);
-  mw_dn_psi_work.reserve(nw);
-  mw_dn_dpsi_work.reserve(nw);
-  mw_dn_d2psi_work.reserve(nw);
-
-  RefVector<ValueVector> up_psi_v_list, dn_psi_v_list;
-  RefVector<GradVector> up_dpsi_v_list, dn_dpsi_v_list;
-  RefVector<ValueVector> up_d2psi_v_list, dn_d2psi_v_list;
-  up_psi_v_list.reserve(nw);
-  up_dpsi_v_list.reserve(nw);
-  up_d2psi_v_list.reserve(nw);
-  dn_psi_v_list.reserve(nw);
-  dn_dpsi_v_list.reserve(nw);
-  dn_d2psi_v_list.reserve(nw);
-
-  ValueVector tmp_val_vec(OrbitalSetSize);
-  GradVector tmp_grad_vec(OrbitalSetSize);
-  for (int iw = 0; iw < nw; iw++)
-  {
-    SpinorSet& spinor = spo_list.getCastedElement<SpinorSet>(iw);
-    up_spo_list.emplace_back(*(spinor.spo_up));
-    dn_spo_list.emplace_back(*(spinor.spo_dn));
-
-    mw_up_psi_work.emplace_back(tmp_val_vec);
-    up_psi_v_list.emplace_back(mw_up_psi_work.back());
-    mw_dn_psi_work.emplace_back(tmp_val_vec);
-    dn_psi_v_list.emplace_back(mw_dn_psi_work.back());
-
-    mw_up_dpsi_work.emplace_back(tmp_grad_vec);
-    up_dpsi_v_list.emplace_back(mw_up_dpsi_work.back());
-    mw_dn_dpsi_work.emplace_back(tmp_grad_vec);
-    dn_dpsi_v_list.emplace_back(mw_dn_dpsi_work.back());
-
-    mw_up_d2psi_work.emplace_back(tmp_val_vec);
-    up_d2psi_v_list.emplace_back(mw_up_d2psi_work.back());
-    mw_dn_d2psi_work.emplace_back(tmp_val_vec);
-    dn_d2psi_v_list.emplace_back(mw_dn_d2psi_work.back());
-  }
-
-  up_spo_leader.mw_evaluateVGL(up_spo_list, P_list, iat, up_psi_v_list, up_dpsi_v_list, up_d2psi_v_list);
-  dn_spo_leader.mw_evaluateVGL(dn_spo_list, P_list, iat, dn_psi_v_list, dn_dpsi_v_list, dn_d2psi_v_list);
-
+  IndexType nw                    = spo_list.size();
+  auto [up_spo_list, dn_spo_list] = extractSpinComponentRefList(spo_list);
+  SPOSet& up_spo_leader           = up_spo_list.getLeader();
+  SPOSet& dn_spo_leader           = dn_spo_list.getLeader();
+
+  // without an acquired resource, the scratch only lives for this call
+  std::unique_ptr<SpinorSetMultiWalkerResource> local_res;
+  if (!spo_leader.mw_res_)
+    local_res = std::make_unique<SpinorSetMultiWalkerResource>();
+  auto& mw_res = spo_leader.mw_res_ ? *spo_leader.mw_res_ : *local_res;
+
+  resizeMultiWalkerScratch(mw_res.up_psi, nw, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.dn_psi, nw, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.up_dpsi, nw, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.dn_dpsi, nw, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.up_d2psi, nw, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.dn_d2psi, nw, OrbitalSetSize);
+
+  up_spo_leader.mw_evaluateVGL(up_spo_list, P_list, iat, makeRefVector(mw_res.up_psi), makeRefVector(mw_res.up_dpsi),
+                               makeRefVector(mw_res.up_d2psi));
+  dn_spo_leader.mw_evaluateVGL(dn_spo_list, P_list, iat, makeRefVector(mw_res.dn_psi), makeRefVector(mw_res.dn_dpsi),
+                               makeRefVector(mw_res.dn_d2psi));
+
+  // all the spinor quantities are combined in one pass over the orbitals
 #pragma omp parallel for
   for (int iw = 0; iw < nw; iw++)
   {
@@ -214,10 +222,25 @@ void SpinorSet::mw_evaluateVGLWithSpin(const RefVectorWithLeader<SPOSet>& spo_li
     ValueType emis(coss, -sins);
     ValueType eye(0, 1.0);
 
-    psi_v_list[iw].get()   = eis * up_psi_v_list[iw].get() + emis * dn_psi_v_list[iw].get();
-    dpsi_v_list[iw].get()  = eis * up_dpsi_v_list[iw].get() + emis * dn_dpsi_v_list[iw].get();
-    d2psi_v_list[iw].get() = eis * up_d2psi_v_list[iw].get() + emis * dn_d2psi_v_list[iw].get();
-    dspin_v_list[iw].get() = eye * (eis * up_psi_v_list[iw].get() - emis * dn_psi_v_list[iw].get());
+    const auto& up_psi   = mw_res.up_psi[iw];
+    const auto& dn_psi   = mw_res.dn_psi[iw];
+    const auto& up_dpsi  = mw_res.up_dpsi[iw];
+    const auto& dn_dpsi  = mw_res.dn_dpsi[iw];
+    const auto& up_d2psi = mw_res.up_d2psi[iw];
+    const auto& dn_d2psi = mw_res.dn_d2psi[iw];
+    auto& psi            = psi_v_list[iw].get();
+    auto& dpsi           = dpsi_v_list[iw].get();
+    auto& d2psi          = d2psi_v_list[iw].get();
+    auto& dspin          = dspin_v_list[iw].get();
+    for (int no = 0; no < OrbitalSetSize; no++)
+    {
+      const ValueType up = eis * up_psi[no];
+      const ValueType dn = emis * dn_psi[no];
+      psi[no]            = up + dn;
+      dspin[no]          = eye * (up - dn);
+      dpsi[no]           = eis * up_dpsi[no] + emis * dn_dpsi[no];
+      d2psi[no]          = eis * up_d2psi[no] + emis * dn_d2psi[no];
+    }
   }
 }
 
@@ -276,64 +299,29 @@ void SpinorSet::mw_evaluate_notranspose(const RefVectorWithLeader<SPOSet>& spo_l
   auto& P_leader   = P_list.getLeader();
   assert(this == &spo_leader);
 
-  IndexType nw    = spo_list.size();
-  IndexType nelec = P_leader.getTotalNum();
-
-  SPOSet& up_spo_leader = *(spo_leader.spo_up);
-  SPOSet& dn_spo_leader = *(spo_leader.spo_dn);
-  RefVectorWithLeader<SPOSet> up_spo_list(up_spo_leader);
-  RefVectorWithLeader<SPOSet> dn_spo_list(dn_spo_leader);
-  up_spo_list.reserve(nw);
-  dn_spo_list.reserve(nw);
-
-  std::vector<ValueMatrix> mw_up_logdet, mw_dn_logdet;
-  std::vector<GradMatrix> mw_up_dlogdet, mw_dn_dlogdet;
-  std::vector<ValueMatrix> mw_up_d2logdet, mw_dn_d2logdet;
-  mw_up_logdet.reserve(nw);
-  mw_dn_logdet.reserve(nw);
-  mw_up_dlogdet.reserve(nw);
-  mw_dn_dlogdet.reserve(nw);
-  mw_up_d2logdet.reserve(nw);
-  mw_dn_d2logdet.reserve(nw);
-
-  RefVector<ValueMatrix> up_logdet_list, dn_logdet_list;
-  RefVector<GradMatrix> up_dlogdet_list, dn_dlogdet_list;
-  RefVector<ValueMatrix> up_d2logdet_list, dn_d2logdet_list;
-  up_logdet_list.reserve(nw);
-  dn_logdet_list.reserve(nw);
-  up_dlogdet_list.reserve(nw);
-  dn_dlogdet_list.reserve(nw);
-  up_d2logdet_list.reserve(nw);
-  dn_d2logdet_list.reserve(nw);
-
-  ValueMatrix tmp_val_mat(nelec, OrbitalSetSize);
-  GradMatrix tmp_grad_mat(nelec, OrbitalSetSize);
-  for (int iw = 0; iw < nw; iw++)
-  {
-    SpinorSet& spinor = spo_list.getCastedElement<SpinorSet>(iw);
-    up_spo_list.emplace_back(*(spinor.spo_up));
-    dn_spo_list.emplace_back(*(spinor.spo_dn));
-
-    mw_up_logdet.emplace_back(tmp_val_mat);
-    up_logdet_list.emplace_back(mw_up_logdet.back());
-    mw_dn_logdet.emplace_back(tmp_val_mat);
-    dn_logdet_list.emplace_back(mw_dn_logdet.back());
-
-    mw_up_dlogdet.emplace_back(tmp_grad_mat);
-    up_dlogdet_list.emplace_back(mw_up_dlogdet.back());
-    mw_dn_dlogdet.emplace_back(tmp_grad_mat);
-    dn_dlogdet_list.emplace_back(mw_dn_dlogdet.back());
-
-    mw_up_d2logdet.emplace_back(tmp_val_mat);
-    up_d2logdet_list.emplace_back(mw_up_d2logdet.back());
-    mw_dn_d2logdet.emplace_back(tmp_val_mat);
-    dn_d2logdet_list.emplace_back(mw_dn_d2logdet.back());
-  }
-
-  up_spo_leader.mw_evaluate_notranspose(up_spo_list, P_list, first, last, up_logdet_list, up_dlogdet_list,
-                                        up_d2logdet_list);
-  dn_spo_leader.mw_evaluate_notranspose(dn_spo_list, P_list, first, last, dn_logdet_list, dn_dlogdet_list,
-                                        dn_d2logdet_list);
+  IndexType nw                    = spo_list.size();
+  IndexType nelec                 = P_leader.getTotalNum();
+  auto [up_spo_list, dn_spo_list] = extractSpinComponentRefList(spo_list);
+  SPOSet& up_spo_leader           = up_spo_list.getLeader();
+  SPOSet& dn_spo_leader           = dn_spo_list.getLeader();
+
+  // without an acquired resource, the scratch only lives for this call
+  std::unique_ptr<SpinorSetMultiWalkerResource> local_res;
+  if (!spo_leader.mw_res_)
+    local_res = std::make_unique<SpinorSetMultiWalkerResource>();
+  auto& mw_res = spo_leader.mw_res_ ? *spo_leader.mw_res_ : *local_res;
+
+  resizeMultiWalkerScratch(mw_res.up_logdet, nw, nelec, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.dn_logdet, nw, nelec, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.up_dlogdet, nw, nelec, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.dn_dlogdet, nw, nelec, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.up_d2logdet, nw, nelec, OrbitalSetSize);
+  resizeMultiWalkerScratch(mw_res.dn_d2logdet, nw, nelec, OrbitalSetSize);
+
+  up_spo_leader.mw_evaluate_notranspose(up_spo_list, P_list, first, last, makeRefVector(mw_res.up_logdet),
+                                        makeRefVector(mw_res.up_dlogdet), makeRefVector(mw_res.up_d2logdet));
+  dn_spo_leader.mw_evaluate_notranspose(dn_spo_list, P_list, first, last, makeRefVector(mw_res.dn_logdet),
+                                        makeRefVector(mw_res.dn_dlogdet), makeRefVector(mw_res.dn_d2logdet));
 
 #pragma omp parallel for
   for (int iw = 0; iw < nw; iw++)
@@ -347,12 +335,11 @@ void SpinorSet::mw_evaluate_notranspose(const RefVectorWithLeader<SPOSet>& spo_l
 
       for (int no = 0; no < OrbitalSetSize; no++)
       {
-        logdet_list[iw].get()(iat, no) =
-            eis * up_logdet_list[iw].get()(iat, no) + emis * dn_logdet_list[iw].get()(iat, no);
+        logdet_list[iw].get()(iat, no) = eis * mw_res.up_logdet[iw](iat, no) + emis * mw_res.dn_logdet[iw](iat, no);
         dlogdet_list[iw].get()(iat, no) =
-            eis * up_dlogdet_list[iw].get()(iat, no) + emis * dn_dlogdet_list[iw].get()(iat, no);
+            eis * mw_res.up_dlogdet[iw](iat, no) + emis * mw_res.dn_dlogdet[iw](iat, no);
         d2logdet_list[iw].get()(iat, no) =
-            eis * up_d2logdet_list[iw].get()(iat, no) + emis * dn_d2logdet_list[iw].get()(iat, no);
+            eis * mw_res.up_d2logdet[iw](iat, no) + emis * mw_res.dn_d2logdet[iw](iat, no);
       }
     }
 }
@@ -427,6 +414,54 @@ void SpinorSet::evaluate_spin(const ParticleSet& P, int iat, ValueVector& psi, V
   dpsi = eye * (eis * psi_work_up - emis * psi_work_down);
 }
 
+std::pair<RefVectorWithLeader<SPOSet>, RefVectorWithLeader<SPOSet>> SpinorSet::extractSpinComponentRefList(
+    const RefVectorWithLeader<SPOSet>& spo_list)
+{
+  SpinorSet& spo_leader = spo_list.getCastedLeader<SpinorSet>();
+  IndexType nw          = spo_list.size();
+  RefVectorWithLeader<SPOSet> up_list(*spo_leader.spo_up);
+  RefVectorWithLeader<SPOSet> dn_list(*spo_leader.spo_dn);
+  up_list.reserve(nw);
+  dn_list.reserve(nw);
+  for (int iw = 0; iw < nw; iw++)
+  {
+    SpinorSet& spinor = spo_list.getCastedElement<SpinorSet>(iw);
+    up_list.emplace_back(*spinor.spo_up);
+    dn_list.emplace_back(*spinor.spo_dn);
+  }
+  return std::make_pair(up_list, dn_list);
+}
+
+void SpinorSet::createResource(ResourceCollection& collection) const
+{
+  spo_up->createResource(collection);
+  spo_dn->createResource(collection);
+  collection.addResource(std::make_unique<SpinorSetMultiWalkerResource>());
+}
+
+void SpinorSet::acquireResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const
+{
+  assert(this == &spo_list.getLeader());
+  auto& spo_leader                = spo_list.getCastedLeader<SpinorSet>();
+  auto [up_spo_list, dn_spo_list] = extractSpinComponentRefList(spo_list);
+  up_spo_list.getLeader().acquireResource(collection, up_spo_list);
+  dn_spo_list.getLeader().acquireResource(collection, dn_spo_list);
+  auto res_ptr = dynamic_cast<SpinorSetMultiWalkerResource*>(collection.lendResource().release());
+  if (!res_ptr)
+    throw std::runtime_error("SpinorSet::acquireResource dynamic_cast failed");
+  spo_leader.mw_res_.reset(res_ptr);
+}
+
+void SpinorSet::releaseResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const
+{
+  assert(this == &spo_list.getLeader());
+  auto& spo_leader                = spo_list.getCastedLeader<SpinorSet>();
+  auto [up_spo_list, dn_spo_list] = extractSpinComponentRefList(spo_list);
+  up_spo_list.getLeader().releaseResource(collection, up_spo_list);
+  dn_spo_list.getLeader().releaseResource(collection, dn_spo_list);
+  collection.takebackResource(std::move(spo_leader.mw_res_));
+}
+
 std::unique_ptr<SPOSet> SpinorSet::makeClone() const
 {
   auto myclone = std::make_unique<SpinorSet>();
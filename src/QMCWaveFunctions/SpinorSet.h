@@ -17,6 +17,8 @@
 
 namespace qmcplusplus
 {
+struct SpinorSetMultiWalkerResource;
+
 /** Class for Melton & Mitas style Spinors.
  *
  */
@@ -28,7 +30,7 @@ public:
 
   /** constructor */
   SpinorSet();
-  ~SpinorSet() override = default;
+  ~SpinorSet() override;
 
   //This class is initialized by separately building the up and down channels of the spinor set and
   //then registering them.
@@ -133,9 +135,24 @@ public:
    */
   void evaluate_spin(const ParticleSet& P, int iat, ValueVector& psi, ValueVector& dpsi) override;
 
+  /** the resources of the up and down channels are created along with the scratch of the combined evaluation
+   */
+  void createResource(ResourceCollection& collection) const override;
+
+  void acquireResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const override;
+
+  void releaseResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const override;
+
   std::unique_ptr<SPOSet> makeClone() const override;
 
 private:
+  /// split spo_list into the lists of the up and down channels
+  static std::pair<RefVectorWithLeader<SPOSet>, RefVectorWithLeader<SPOSet>> extractSpinComponentRefList(
+      const RefVectorWithLeader<SPOSet>& spo_list);
+
+  /// multi-walker scratch of the up and down channels, acquired by the crowd leader
+  std::unique_ptr<SpinorSetMultiWalkerResource> mw_res_;
+
   //Sposet for the up and down channels of our spinors.
   std::unique_ptr<SPOSet> spo_up;
   std::unique_ptr<SPOSet> spo_dn;
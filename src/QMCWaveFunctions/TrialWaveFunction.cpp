@@ -98,6 +98,7 @@ void TrialWaveFunction::addComponent(std::unique_ptr<WaveFunctionComponent>&& at
   for (auto& suffix : suffixes)
     WFC_timers_.push_back(*timer_manager.createTimer(aname + "::" + suffix));
 
+  aterm->registerSPOEvaluationCache(spo_eval_caches_);
   Z.emplace_back(std::move(aterm));
 }
 
@@ -462,7 +463,8 @@ void TrialWaveFunction::mw_calcRatio(const RefVectorWithLeader<TrialWaveFunction
   const int num_wfc             = wf_leader.Z.size();
   auto& wavefunction_components = wf_leader.Z;
 
-  std::vector<PsiValueType> ratios_z(num_wf);
+  auto ratios_z_lease = wf_leader.mw_scratch_.get().getVector<PsiValueType>(num_wf);
+  auto& ratios_z      = *ratios_z_lease;
   for (int i = 0; i < num_wfc; i++)
   {
     if (ct == ComputeType::ALL || (wavefunction_components[i]->is_fermionic && ct == ComputeType::FERMIONIC) ||
@@ -542,7 +544,8 @@ void TrialWaveFunction::mw_evalGrad(const RefVectorWithLeader<TrialWaveFunction>
   const int num_wfc             = wf_leader.Z.size();
   auto& wavefunction_components = wf_leader.Z;
 
-  std::vector<GradType> grad_now_z(num_wf);
+  auto grad_now_z_lease = wf_leader.mw_scratch_.get().getVector<GradType>(num_wf);
+  auto& grad_now_z      = *grad_now_z_lease;
   for (int i = 0; i < num_wfc; ++i)
   {
     ScopedTimer localtimer(wf_leader.WFC_timers_[VGL_TIMER + TIMER_SKIP * i]);
@@ -570,8 +573,11 @@ void TrialWaveFunction::mw_evalGradWithSpin(const RefVectorWithLeader<TrialWaveF
   const int num_wfc             = wf_leader.Z.size();
   auto& wavefunction_components = wf_leader.Z;
 
-  std::vector<GradType> grad_now_z(num_wf);
-  std::vector<ComplexType> spingrad_now_z(num_wf);
+  auto& scratch             = wf_leader.mw_scratch_.get();
+  auto grad_now_z_lease     = scratch.getVector<GradType>(num_wf);
+  auto spingrad_now_z_lease = scratch.getVector<ComplexType>(num_wf);
+  auto& grad_now_z          = *grad_now_z_lease;
+  auto& spingrad_now_z      = *spingrad_now_z_lease;
   for (int i = 0; i < num_wfc; ++i)
   {
     ScopedTimer localtimer(wf_leader.WFC_timers_[VGL_TIMER + TIMER_SKIP * i]);
@@ -685,10 +691,20 @@ void TrialWaveFunction::mw_calcRatioGrad(const RefVectorWithLeader<TrialWaveFunc
   const int num_wfc             = wf_leader.Z.size();
   auto& wavefunction_components = wf_leader.Z;
 
+  auto& scratch = wf_leader.mw_scratch_.get();
   if (wf_leader.use_tasking_)
   {
-    std::vector<std::vector<PsiValueType>> ratios_components(num_wfc, std::vector<PsiValueType>(wf_list.size()));
-    std::vector<std::vector<GradType>> grads_components(num_wfc, std::vector<GradType>(wf_list.size()));
+    auto ratios_components_lease = scratch.lease<std::vector<PsiValueType>>();
+    auto grads_components_lease  = scratch.lease<std::vector<GradType>>();
+    auto& ratios_components      = *ratios_components_lease;
+    auto& grads_components       = *grads_components_lease;
+    ratios_components.resize(num_wfc);
+    grads_components.resize(num_wfc);
+    for (int i = 0; i < num_wfc; ++i)
+    {
+      ratios_components[i].assign(wf_list.size(), PsiValueType(0));
+      grads_components[i].assign(wf_list.size(), GradType(0));
+    }
     PRAGMA_OMP_TASKLOOP("omp taskloop default(shared)")
     for (int i = 0; i < num_wfc; ++i)
     {
@@ -706,7 +722,8 @@ void TrialWaveFunction::mw_calcRatioGrad(const RefVectorWithLeader<TrialWaveFunc
   }
   else
   {
-    std::vector<PsiValueType> ratios_z(wf_list.size());
+    auto ratios_z_lease = scratch.getVector<PsiValueType>(wf_list.size());
+    auto& ratios_z      = *ratios_z_lease;
     for (int i = 0; i < num_wfc; ++i)
     {
       ScopedTimer z_timer(wf_leader.WFC_timers_[VGL_TIMER + TIMER_SKIP * i]);
@@ -740,11 +757,24 @@ void TrialWaveFunction::mw_calcRatioGradWithSpin(const RefVectorWithLeader<Trial
   const int num_wfc             = wf_leader.Z.size();
   auto& wavefunction_components = wf_leader.Z;
 
+  auto& scratch = wf_leader.mw_scratch_.get();
   if (wf_leader.use_tasking_)
   {
-    std::vector<std::vector<PsiValueType>> ratios_components(num_wfc, std::vector<PsiValueType>(wf_list.size()));
-    std::vector<std::vector<GradType>> grads_components(num_wfc, std::vector<GradType>(wf_list.size()));
-    std::vector<std::vector<ComplexType>> spingrads_components(num_wfc, std::vector<ComplexType>(wf_list.size()));
+    auto ratios_components_lease    = scratch.lease<std::vector<PsiValueType>>();
+    auto grads_components_lease     = scratch.lease<std::vector<GradType>>();
+    auto spingrads_components_lease = scratch.lease<std::vector<ComplexType>>();
+    auto& ratios_components         = *ratios_components_lease;
+    auto& grads_components          = *grads_components_lease;
+    auto& spingrads_components      = *spingrads_components_lease;
+    ratios_components.resize(num_wfc);
+    grads_components.resize(num_wfc);
+    spingrads_components.resize(num_wfc);
+    for (int i = 0; i < num_wfc; ++i)
+    {
+      ratios_components[i].assign(wf_list.size(), PsiValueType(0));
+      grads_components[i].assign(wf_list.size(), GradType(0));
+      spingrads_components[i].assign(wf_list.size(), ComplexType(0));
+    }
     PRAGMA_OMP_TASKLOOP("omp taskloop default(shared)")
     for (int i = 0; i < num_wfc; ++i)
     {
@@ -764,7 +794,8 @@ void TrialWaveFunction::mw_calcRatioGradWithSpin(const RefVectorWithLeader<Trial
   }
   else
   {
-    std::vector<PsiValueType> ratios_z(wf_list.size());
+    auto ratios_z_lease = scratch.getVector<PsiValueType>(wf_list.size());
+    auto& ratios_z      = *ratios_z_lease;
     for (int i = 0; i < num_wfc; ++i)
     {
       ScopedTimer z_timer(wf_leader.WFC_timers_[VGL_TIMER + TIMER_SKIP * i]);
@@ -1094,7 +1125,9 @@ void TrialWaveFunction::mw_evaluateRatios(const RefVectorWithLeader<TrialWaveFun
   auto& wf_leader = wf_list.getLeader();
   ScopedTimer local_timer(wf_leader.TWF_timers_[NL_TIMER]);
   auto& wavefunction_components = wf_leader.Z;
-  std::vector<std::vector<ValueType>> t(ratios_list.size());
+  auto t_lease                  = wf_leader.mw_scratch_.get().lease<std::vector<ValueType>>();
+  auto& t                       = *t_lease;
+  t.resize(ratios_list.size());
   for (int iw = 0; iw < wf_list.size(); iw++)
   {
     std::vector<ValueType>& ratios = ratios_list[iw];
@@ -1187,21 +1220,27 @@ void TrialWaveFunction::mw_evaluateParameterDerivatives(const RefVectorWithLeade
                                                         RecordArray<ValueType>& dhpsioverpsi)
 {
   const int nparam = dlogpsi.nparam();
-  for (int iw = 0; iw < wf_list.size(); iw++)
-  {
-    std::vector<ValueType> tmp_dlogpsi(nparam);
-    std::vector<ValueType> tmp_dhpsioverpsi(nparam);
-    TrialWaveFunction& twf = wf_list[iw];
-    for (int i = 0; i < twf.Z.size(); i++)
-      twf.Z[i]->evaluateDerivatives(p_list[iw], optvars, tmp_dlogpsi, tmp_dhpsioverpsi);
-
-    RealType OneOverM = twf.getReciprocalMass();
+  const int nw     = wf_list.size();
+  for (int iw = 0; iw < nw; iw++)
     for (int i = 0; i < nparam; i++)
     {
-      dlogpsi.setValue(i, iw, tmp_dlogpsi[i]);
-      //orbitals do not know about mass of particle.
-      dhpsioverpsi.setValue(i, iw, tmp_dhpsioverpsi[i] * OneOverM);
+      dlogpsi.setValue(i, iw, 0.0);
+      dhpsioverpsi.setValue(i, iw, 0.0);
     }
+
+  auto& wavefunction_components = wf_list.getLeader().Z;
+  for (int i = 0; i < wavefunction_components.size(); i++)
+  {
+    const auto wfc_list(extractWFCRefList(wf_list, i));
+    wavefunction_components[i]->mw_evaluateParameterDerivatives(wfc_list, p_list, optvars, dlogpsi, dhpsioverpsi);
+  }
+
+  //orbitals do not know about mass of particle.
+  for (int iw = 0; iw < nw; iw++)
+  {
+    RealType OneOverM = wf_list[iw].getReciprocalMass();
+    for (int i = 0; i < nparam; i++)
+      dhpsioverpsi.setValue(i, iw, dhpsioverpsi.getValue(i, iw) * OneOverM);
   }
 }
 
@@ -1262,6 +1301,7 @@ void TrialWaveFunction::acquireResource(ResourceCollection& collection,
     const auto wfc_list(extractWFCRefList(wf_list, i));
     wavefunction_components[i]->acquireResource(collection, wfc_list);
   }
+  wf_leader.mw_scratch_.attach(collection.getScratchArena());
 }
 
 void TrialWaveFunction::releaseResource(ResourceCollection& collection,
@@ -1275,6 +1315,7 @@ void TrialWaveFunction::releaseResource(ResourceCollection& collection,
     const auto wfc_list(extractWFCRefList(wf_list, i));
     wavefunction_components[i]->releaseResource(collection, wfc_list);
   }
+  wf_leader.mw_scratch_.detach();
 }
 
 RefVectorWithLeader<WaveFunctionComponent> TrialWaveFunction::extractWFCRefList(
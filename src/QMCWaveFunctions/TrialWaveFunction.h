@@ -29,6 +29,8 @@
 #include "type_traits/template_types.hpp"
 #include "Containers/MinimalContainers/RecordArray.hpp"
 #include "QMCWaveFunctions/TWFFastDerivWrapper.h"
+#include "QMCWaveFunctions/SPOEvaluationCache.h"
+#include "Utilities/ScratchArena.h"
 #ifdef QMC_CUDA
 #include "type_traits/CUDATypes.h"
 #endif
@@ -542,6 +544,12 @@ private:
   ///a list of WaveFunctionComponents constituting many-body wave functions
   std::vector<std::unique_ptr<WaveFunctionComponent>> Z;
 
+  /// caches of the orbital evaluations shared by the components
+  SPOEvaluationCacheRegistry spo_eval_caches_;
+
+  /// temporaries of the mw_ calls led by this object, in the crowd resource collection once acquired
+  ScratchArenaRef mw_scratch_;
+
   /// For now, TrialWaveFunction will own the wrapper.
   TWFFastDerivWrapper twf_prototype;
   /// timers at TrialWaveFunction function call level
@@ -162,6 +162,29 @@ void WaveFunctionComponent::mw_evaluateGL(const RefVectorWithLeader<WaveFunction
     wfc_list[iw].evaluateGL(p_list[iw], G_list[iw], L_list[iw], fromscratch);
 }
 
+void WaveFunctionComponent::mw_evaluateParameterDerivatives(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                            const RefVectorWithLeader<ParticleSet>& p_list,
+                                                            const opt_variables_type& optvars,
+                                                            RecordArray<ValueType>& dlogpsi,
+                                                            RecordArray<ValueType>& dhpsioverpsi) const
+{
+  assert(this == &wfc_list.getLeader());
+  const int nparam = dlogpsi.nparam();
+  std::vector<ValueType> tmp_dlogpsi(nparam);
+  std::vector<ValueType> tmp_dhpsioverpsi(nparam);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    std::fill(tmp_dlogpsi.begin(), tmp_dlogpsi.end(), 0.0);
+    std::fill(tmp_dhpsioverpsi.begin(), tmp_dhpsioverpsi.end(), 0.0);
+    wfc_list[iw].evaluateDerivatives(p_list[iw], optvars, tmp_dlogpsi, tmp_dhpsioverpsi);
+    for (int i = 0; i < nparam; i++)
+    {
+      dlogpsi.setValue(i, iw, dlogpsi.getValue(i, iw) + tmp_dlogpsi[i]);
+      dhpsioverpsi.setValue(i, iw, dhpsioverpsi.getValue(i, iw) + tmp_dhpsioverpsi[i]);
+    }
+  }
+}
+
 void WaveFunctionComponent::evaluateDerivativesWF(ParticleSet& P,
                                                   const opt_variables_type& active,
                                                   std::vector<ValueType>& dlogpsi)
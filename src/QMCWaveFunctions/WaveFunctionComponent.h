@@ -27,6 +27,7 @@
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
 #include "Particle/MCWalkerConfiguration.h"
 #include "type_traits/template_types.hpp"
+#include "Containers/MinimalContainers/RecordArray.hpp"
 #ifdef QMC_CUDA
 #include "type_traits/CUDATypes.h"
 #endif
@@ -50,6 +51,7 @@ struct NLjob
 class WaveFunctionComponent;
 class ResourceCollection;
 class TWFFastDerivWrapper;
+class SPOEvaluationCacheRegistry;
 /**@defgroup WaveFunctionComponent group
  * @brief Classes which constitute a many-body trial wave function
  *
@@ -477,6 +479,11 @@ public:
                                const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const
   {}
 
+  /** get the caches of the SPOSets evaluated by this component from the registry of its TrialWaveFunction
+   *  Components sharing a SPOSet and particles reuse each other's orbital evaluations.
+   */
+  virtual void registerSPOEvaluationCache(SPOEvaluationCacheRegistry& registry) {}
+
   /** make clone
    * @param tqp target Quantum ParticleSet
    * @param deepcopy if true, make a decopy
@@ -507,6 +514,21 @@ public:
                                    std::vector<ValueType>& dlogpsi,
                                    std::vector<ValueType>& dhpsioverpsi) = 0;
 
+  /** Compute the parameter derivatives of a batch of walkers, see evaluateDerivatives
+   *  @param wfc_list the list of WaveFunctionComponent pointers of the same component in a walker batch
+   *  @param p_list the list of ParticleSet pointers in a walker batch
+   *  @param optvars optimizable parameters
+   *  @param dlogpsi [parameter][walker] derivatives of the log of the wavefunctions.
+   *         Add the contribution from this component.
+   *  @param dhpsioverpsi [parameter][walker] Hamiltonian derivatives.
+   *         Add the kinetic energy derivatives contribution from this component.
+   */
+  virtual void mw_evaluateParameterDerivatives(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                               const RefVectorWithLeader<ParticleSet>& p_list,
+                                               const opt_variables_type& optvars,
+                                               RecordArray<ValueType>& dlogpsi,
+                                               RecordArray<ValueType>& dhpsioverpsi) const;
+
   /** Compute the derivatives of the log of the wavefunction with respect to optimizable parameters.
    *  parameters
    *  @param P particle set
@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file DeviceTimerCUDA.hpp
+ * @brief measure the device work queued on a stream with CUDA events and add it to device_profile
+ */
+#ifndef QMCPLUSPLUS_DEVICE_TIMER_CUDA_H
+#define QMCPLUSPLUS_DEVICE_TIMER_CUDA_H
+
+#include <vector>
+#include "CUDA/CUDAruntime.hpp"
+#include "Utilities/DeviceProfile.h"
+
+namespace qmcplusplus
+{
+/** device timer of the work queued on a stream
+ *
+ * begin and end record a pair of timing events around the work queued in between on the same stream.
+ * The span is attributed to the innermost timer of the thread calling end, i.e. the host timer enclosing the launch.
+ * The spans are read without blocking once their events are done, at the next begin, or waited for in collect(true).
+ * Nothing is recorded unless device_profile is enabled. Do not use within a stream capture.
+ * Owned by a crowd scope resource, not thread-safe.
+ */
+class DeviceTimerCUDA
+{
+public:
+  DeviceTimerCUDA() = default;
+  DeviceTimerCUDA(const DeviceTimerCUDA&) = delete;
+  DeviceTimerCUDA& operator=(const DeviceTimerCUDA&) = delete;
+
+  ~DeviceTimerCUDA()
+  {
+    collect(true);
+    for (cudaEvent_t event : free_events_)
+      cudaEventDestroy(event);
+  }
+
+  /// mark the start of the work queued next on stream
+  void begin(cudaStream_t stream)
+  {
+    if (!device_profile.isEnabled())
+      return;
+    collect(false);
+    start_ = getEvent();
+    cudaErrorCheck(cudaEventRecord(start_, stream), "cudaEventRecord failed!");
+  }
+
+  /// mark the end of count kernels queued on stream since begin
+  void endKernels(cudaStream_t stream, long count = 1) { end(stream, count, 0); }
+
+  /// mark the end of a transfer of bytes queued on stream since begin
+  void endTransfer(cudaStream_t stream, size_t bytes) { end(stream, 0, bytes); }
+
+  /// add the done spans to device_profile, wait for all of them if wait is true
+  void collect(bool wait)
+  {
+    size_t done = 0;
+    for (; done < pending_.size(); done++)
+    {
+      Span& span = pending_[done];
+      if (wait)
+        cudaErrorCheck(cudaEventSynchronize(span.stop), "cudaEventSynchronize failed!");
+      else
+      {
+        const cudaError_t status = cudaEventQuery(span.stop);
+        // the spans of a stream are done in order
+        if (status == cudaErrorNotReady)
+          break;
+        cudaErrorCheck(status, "cudaEventQuery failed!");
+      }
+      float ms = 0.0f;
+      cudaErrorCheck(cudaEventElapsedTime(&ms, span.start, span.stop), "cudaEventElapsedTime failed!");
+      if (span.kernel_count > 0)
+        device_profile.addKernels(span.id, ms * 1e-3, span.kernel_count);
+      else
+        device_profile.addTransfer(span.id, ms * 1e-3, span.bytes);
+      free_events_.push_back(span.start);
+      free_events_.push_back(span.stop);
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + done);
+  }
+
+private:
+  struct Span
+  {
+    cudaEvent_t start;
+    cudaEvent_t stop;
+    timer_id_t id;
+    long kernel_count;
+    size_t bytes;
+  };
+
+  /// spans queued and not yet added, in the stream order
+  std::vector<Span> pending_;
+  /// events of the spans already added, for reuse
+  std::vector<cudaEvent_t> free_events_;
+  /// start event of the current span, nullptr outside begin/end
+  cudaEvent_t start_ = nullptr;
+
+  cudaEvent_t getEvent()
+  {
+    if (free_events_.empty())
+    {
+      cudaEvent_t event;
+      cudaErrorCheck(cudaEventCreate(&event), "cudaEventCreate failed!");
+      return event;
+    }
+    cudaEvent_t event = free_events_.back();
+    free_events_.pop_back();
+    return event;
+  }
+
+  void end(cudaStream_t stream, long kernel_count, size_t bytes)
+  {
+    if (start_ == nullptr)
+      return;
+    cudaEvent_t stop = getEvent();
+    cudaErrorCheck(cudaEventRecord(stop, stream), "cudaEventRecord failed!");
+    pending_.push_back({start_, stop, get_innermost_timer_id(), kernel_count, bytes});
+    start_ = nullptr;
+  }
+};
+
+} // namespace qmcplusplus
+#endif
@@ -109,6 +109,12 @@ __host__ __device__ __inline__ cuDoubleComplex makeZero<cuDoubleComplex>()
   return make_cuDoubleComplex(0.0, 0.0);
 }
 
+template<>
+__host__ __device__ __inline__ cuComplex makeZero<cuComplex>()
+{
+  return make_cuComplex(0.0f, 0.0f);
+}
+
 template<typename T>
 __host__ __device__ __inline__ T makeOne()
 {
@@ -121,6 +127,12 @@ __host__ __device__ __inline__ cuDoubleComplex makeOne<cuDoubleComplex>()
   return make_cuDoubleComplex(1.0, 0.0);
 }
 
+template<>
+__host__ __device__ __inline__ cuComplex makeOne<cuComplex>()
+{
+  return make_cuComplex(1.0f, 0.0f);
+}
+
 template<typename T, int BS>
 __global__ void make_identity_matrix_kernel(const int nrows, T* restrict mat, const int lda)
 {
@@ -154,6 +166,26 @@ void make_identity_matrix_cuda(const int nrows, std::complex<double>* mat, const
   (nrows, (cuDoubleComplex*)mat, lda);
 }
 
+void make_identity_matrix_cuda(const int nrows, float* mat, const int lda, cudaStream_t& hstream)
+{
+  const int BS = 128;
+  const int NB = (nrows+BS-1)/BS;
+  dim3 dimBlock(BS);
+  dim3 dimGrid(NB,NB);
+  make_identity_matrix_kernel<float, BS><<<dimGrid, dimBlock, 0, hstream>>>
+  (nrows, mat, lda);
+}
+
+void make_identity_matrix_cuda(const int nrows, std::complex<float>* mat, const int lda, cudaStream_t& hstream)
+{
+  const int BS = 128;
+  const int NB = (nrows+BS-1)/BS;
+  dim3 dimBlock(BS);
+  dim3 dimGrid(NB,NB);
+  make_identity_matrix_kernel<cuComplex, BS><<<dimGrid, dimBlock, 0, hstream>>>
+  (nrows, (cuComplex*)mat, lda);
+}
+
 /** extract matrix diagonal
  */
 template<typename T, int BS>
@@ -183,6 +215,26 @@ void extract_matrix_diagonal_cuda(const int nrows, const std::complex<double>* m
   (nrows, (cuDoubleComplex*)mat, lda, (cuDoubleComplex*)diag);
 }
 
+void extract_matrix_diagonal_cuda(const int nrows, const float* mat, const int lda, float* diag, cudaStream_t& hstream)
+{
+  const int BS = 128;
+  const int NB = (nrows+BS-1)/BS;
+  dim3 dimBlock(BS);
+  dim3 dimGrid(NB);
+  extract_matrix_diagonal_kernel<float, BS><<<dimGrid, dimBlock, 0, hstream>>>
+  (nrows, mat, lda, diag);
+}
+
+void extract_matrix_diagonal_cuda(const int nrows, const std::complex<float>* mat, const int lda, std::complex<float>* diag, cudaStream_t& hstream)
+{
+  const int BS = 128;
+  const int NB = (nrows+BS-1)/BS;
+  dim3 dimBlock(BS);
+  dim3 dimGrid(NB);
+  extract_matrix_diagonal_kernel<cuComplex, BS><<<dimGrid, dimBlock, 0, hstream>>>
+  (nrows, (cuComplex*)mat, lda, (cuComplex*)diag);
+}
+
 /** copy matrix with precision difference
  */
 
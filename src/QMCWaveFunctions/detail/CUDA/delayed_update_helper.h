@@ -52,12 +52,20 @@ void make_identity_matrix_cuda(const int nrows, double* mat, const int lda, cuda
 
 void make_identity_matrix_cuda(const int nrows, std::complex<double>* mat, const int lda, cudaStream_t& hstream);
 
+void make_identity_matrix_cuda(const int nrows, float* mat, const int lda, cudaStream_t& hstream);
+
+void make_identity_matrix_cuda(const int nrows, std::complex<float>* mat, const int lda, cudaStream_t& hstream);
+
 /** extract matrix diagonal
  */
 void extract_matrix_diagonal_cuda(const int nrows, const double* mat, const int lda, double* diag, cudaStream_t& hstream);
 
 void extract_matrix_diagonal_cuda(const int nrows, const std::complex<double>* mat, const int lda, std::complex<double>* diag, cudaStream_t& hstream);
 
+void extract_matrix_diagonal_cuda(const int nrows, const float* mat, const int lda, float* diag, cudaStream_t& hstream);
+
+void extract_matrix_diagonal_cuda(const int nrows, const std::complex<float>* mat, const int lda, std::complex<float>* diag, cudaStream_t& hstream);
+
 /** copy matrix with precision difference
  */
 void copy_matrix_cuda(const int nrows, const int ncols, const double* mat_in, const int lda, float* mat_out, const int ldb, cudaStream_t& hstream);
@@ -26,13 +26,13 @@
 namespace qmcplusplus
 {
 /** unpack packed cG to fftbox
-   * @param cG packed vector
+   * @param cG packed vector, converted to the precision of fftbox
    * @param gvecs g-coordinate for cG[i]
    * @param maxg  fft grid
    * @param fftbox unpacked data to be transformed
    */
-template<typename T>
-inline void unpack4fftw(const Vector<std::complex<T>>& cG,
+template<typename T, typename TG>
+inline void unpack4fftw(const Vector<std::complex<TG>>& cG,
                         const std::vector<TinyVector<int, 3>>& gvecs,
                         const TinyVector<int, 3>& maxg,
                         Array<std::complex<T>, 3>& fftbox)
@@ -55,7 +55,7 @@ inline void unpack4fftw(const Vector<std::complex<T>>& cG,
       continue;
     }
     fftbox((gvecs[iG][0] + maxg[0]) % maxg[0], (gvecs[iG][1] + maxg[1]) % maxg[1], (gvecs[iG][2] + maxg[2]) % maxg[2]) =
-        cG[iG];
+        std::complex<T>(cG[iG]);
   }
 }
 
@@ -220,7 +220,8 @@ inline void split_real_components_c2c(const Array<std::complex<T>, 3>& in, Array
 template<typename T>
 inline T compute_norm(const Vector<std::complex<T>>& cG)
 {
-  T total_norm2(0);
+  // accumulate in double, single precision cG of many plane waves would not pass the norm check
+  double total_norm2(0);
 #pragma omp parallel for reduction(+ : total_norm2)
   for (size_t ig = 0; ig < cG.size(); ++ig)
     total_norm2 += cG[ig].real() * cG[ig].real() + cG[ig].imag() * cG[ig].imag();
@@ -0,0 +1,388 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** \file
+ *  This implements micro benchmarking of the batched spline SPOSet evaluations,
+ *  mw_evaluateVGL and mw_evaluateDetRatios, over crowds of walkers.
+ *  The sets are built by EinsplineSetBuilder from the unit test h5 files, so the variant under test,
+ *  SplineR2R/C2R/C2C, their OpenMP offload versions and the hybrid representation, is the one the
+ *  production code picks for the given build, twist, gpu and hybridrep settings.
+ *  Grid size is set by meshfactor and the number of orbitals by size, up to the bands stored in the h5 file.
+ */
+
+#include "catch.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include "Configuration.h"
+#include "OhmmsData/Libxml2Doc.h"
+#include "Particle/ParticleSet.h"
+#include "Particle/ParticleSetPool.h"
+#include "Particle/VirtualParticleSet.h"
+#include "QMCWaveFunctions/EinsplineSetBuilder.h"
+#include "Utilities/Timer.h"
+#include "ResourceCollection.h"
+
+namespace qmcplusplus
+{
+enum class SplineBenchmarkSystem
+{
+  DIAMOND_2X1X1, // gamma point, real orbitals
+  LIH_ARB        // arbitrary twist, complex orbitals
+};
+
+// Mechanism to pretty print benchmark names.
+struct SplineBenchmarkParameters;
+std::ostream& operator<<(std::ostream& out, const SplineBenchmarkParameters& sbmp);
+struct SplineBenchmarkParameters
+{
+  std::string name;
+  SplineBenchmarkSystem system;
+  int norb;
+  double meshfactor;
+  bool offload;
+  bool hybrid;
+  std::vector<int> crowd_sizes;
+  /// number of quadrature points per virtual particle set in mw_evaluateDetRatios
+  int nknots = 12;
+  /// huge page kind and page locking of the spline coefficients, see LargePageAllocator
+  std::string hugepages = "no";
+  bool pinned           = false;
+  std::string str()
+  {
+    std::stringstream stream;
+    stream << *this;
+    return stream.str();
+  }
+};
+
+std::ostream& operator<<(std::ostream& out, const SplineBenchmarkParameters& sbmp)
+{
+  out << sbmp.name << " norb=" << sbmp.norb << " meshfactor=" << sbmp.meshfactor
+      << (sbmp.offload ? " offload" : " host") << (sbmp.hybrid ? " hybrid" : "");
+  if (sbmp.hugepages != "no")
+    out << " hugepages=" << sbmp.hugepages;
+  if (sbmp.pinned)
+    out << " pinned";
+  return out;
+}
+
+/** set up the simulation cell, ions and electrons of a system and build the SPOSet requested by params
+ *  @return the SPOSet, elec is the electron ParticleSet it was built for
+ */
+std::unique_ptr<SPOSet> buildBenchmarkSPOSet(const SplineBenchmarkParameters& params,
+                                             ParticleSetPool& ptcl,
+                                             ParticleSet*& elec_ptr)
+{
+  Communicate* c = OHMMS::Controller;
+
+  ParticleSet::ParticleLayout lattice;
+  std::string href, tilematrix;
+  std::vector<ParticleSet::SingleParticlePos> ion_pos;
+  int nelec = 0;
+  if (params.system == SplineBenchmarkSystem::DIAMOND_2X1X1)
+  {
+    lattice.R(0, 0) = 6.7463223;
+    lattice.R(0, 1) = 6.7463223;
+    lattice.R(0, 2) = 0.0;
+    lattice.R(1, 0) = 0.0;
+    lattice.R(1, 1) = 3.37316115;
+    lattice.R(1, 2) = 3.37316115;
+    lattice.R(2, 0) = 3.37316115;
+    lattice.R(2, 1) = 0.0;
+    lattice.R(2, 2) = 3.37316115;
+    href            = "diamondC_2x1x1.pwscf.h5";
+    tilematrix      = "2 0 0 0 1 0 0 0 1";
+    ion_pos         = {{0.0, 0.0, 0.0},
+                       {1.68658058, 1.68658058, 1.68658058},
+                       {3.37316115, 3.37316115, 0.0},
+                       {5.05974173, 5.05974173, 1.68658058}};
+    nelec           = 16;
+  }
+  else
+  {
+    lattice.R(0, 0) = -3.55;
+    lattice.R(0, 1) = 0.0;
+    lattice.R(0, 2) = 3.55;
+    lattice.R(1, 0) = 0.0;
+    lattice.R(1, 1) = 3.55;
+    lattice.R(1, 2) = 3.55;
+    lattice.R(2, 0) = -3.55;
+    lattice.R(2, 1) = 3.55;
+    lattice.R(2, 2) = 0.0;
+    href            = "LiH-arb.pwscf.h5";
+    tilematrix      = "1 0 0 0 1 0 0 0 1";
+    ion_pos         = {{0.0, 0.0, 0.0}, {3.55, 3.55, 3.55}};
+    nelec           = 4;
+  }
+  lattice.reset();
+
+  ptcl.setSimulationCell(lattice);
+  auto ions_uptr = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  auto elec_uptr = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  ParticleSet& ions(*ions_uptr);
+  ParticleSet& elec(*elec_uptr);
+
+  ions.setName("ion");
+  ptcl.addParticleSet(std::move(ions_uptr));
+  ions.create(ion_pos.size());
+  for (int i = 0; i < ion_pos.size(); i++)
+    ions.R[i] = ion_pos[i];
+
+  // a single species with the attributes needed by the hybrid representation
+  SpeciesSet& ion_species = ions.getSpeciesSet();
+  int ionIdx    = ion_species.addSpecies(params.system == SplineBenchmarkSystem::DIAMOND_2X1X1 ? "C" : "Li");
+  int cutoffIdx = ion_species.addAttribute("cutoff_radius");
+  int lmaxIdx   = ion_species.addAttribute("lmax");
+
+  ion_species(cutoffIdx, ionIdx) = 0.9;
+  ion_species(lmaxIdx, ionIdx)   = 3;
+
+  elec.setName("elec");
+  ptcl.addParticleSet(std::move(elec_uptr));
+  elec.create(nelec);
+  // deterministic and well spread positions in the cell
+  for (int i = 0; i < nelec; i++)
+    elec.R[i] = lattice.toCart(ParticleSet::SingleParticlePos(std::fmod(0.137 * (i + 1), 1.0),
+                                                               std::fmod(0.291 * (i + 1), 1.0),
+                                                               std::fmod(0.463 * (i + 1), 1.0)));
+
+  SpeciesSet& tspecies       = elec.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int chargeIdx              = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx) = -1;
+
+  std::ostringstream input;
+  input << "<tmp><determinantset type=\"einspline\" href=\"" << href << "\" tilematrix=\"" << tilematrix
+        << "\" twistnum=\"0\" source=\"ion\" meshfactor=\"" << params.meshfactor
+        << "\" precision=\"float\" size=\"" << params.norb << "\" gpu=\"" << (params.offload ? "yes" : "no")
+        << "\" hybridrep=\"" << (params.hybrid ? "yes" : "no") << "\" hugepages=\"" << params.hugepages
+        << "\" pinned=\"" << (params.pinned ? "yes" : "no") << "\"/></tmp>";
+
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(input.str());
+  REQUIRE(okay);
+  xmlNodePtr ein1 = xmlFirstElementChild(doc.getRoot());
+
+  EinsplineSetBuilder einSet(elec, ptcl.getPool(), c, ein1);
+  auto spo = einSet.createSPOSetFromXML(ein1);
+  REQUIRE(spo);
+
+  ions.update();
+  elec.update();
+  elec_ptr = &elec;
+  return spo;
+}
+
+/** benchmark mw_evaluateVGL and mw_evaluateDetRatios over the crowd sizes in params
+ *  A sweep moves every electron of every walker once. Besides the Catch statistics of a sweep,
+ *  the throughput in orbitals*electrons per second is printed for each kernel.
+ */
+void benchmarkSplineSPOSet(SplineBenchmarkParameters& params)
+{
+  ParticleSetPool ptcl(OHMMS::Controller);
+  ParticleSet* elec_ptr = nullptr;
+  auto spo              = buildBenchmarkSPOSet(params, ptcl, elec_ptr);
+  ParticleSet& elec(*elec_ptr);
+  const int norb  = spo->getOrbitalSetSize();
+  const int nelec = elec.getTotalNum();
+
+  for (const int nw : params.crowd_sizes)
+  {
+    // walkers at shifted configurations
+    std::vector<std::unique_ptr<ParticleSet>> elecs;
+    std::vector<std::unique_ptr<SPOSet>> spos;
+    for (int iw = 0; iw < nw; iw++)
+    {
+      elecs.push_back(std::make_unique<ParticleSet>(elec));
+      for (int iel = 0; iel < nelec; iel++)
+        elecs.back()->R[iel] += ParticleSet::SingleParticlePos(0.01 * iw, -0.02 * iw, 0.03 * iw);
+      elecs.back()->update();
+      spos.push_back(spo->makeClone());
+    }
+
+    ResourceCollection pset_res("benchmark_pset_res");
+    ResourceCollection spo_res("benchmark_spo_res");
+    elec.createResource(pset_res);
+    spo->createResource(spo_res);
+    RefVectorWithLeader<ParticleSet> p_list(*elecs[0]);
+    RefVectorWithLeader<SPOSet> spo_list(*spos[0]);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      p_list.push_back(*elecs[iw]);
+      spo_list.push_back(*spos[iw]);
+    }
+    ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, p_list);
+    ResourceCollectionTeamLock<SPOSet> mw_spo_lock(spo_res, spo_list);
+
+    std::vector<SPOSet::ValueVector> psi(nw, SPOSet::ValueVector(norb)), d2psi(nw, SPOSet::ValueVector(norb));
+    std::vector<SPOSet::GradVector> dpsi(nw, SPOSet::GradVector(norb));
+    RefVector<SPOSet::ValueVector> psi_list, d2psi_list;
+    RefVector<SPOSet::GradVector> dpsi_list;
+    for (int iw = 0; iw < nw; iw++)
+    {
+      psi_list.push_back(psi[iw]);
+      dpsi_list.push_back(dpsi[iw]);
+      d2psi_list.push_back(d2psi[iw]);
+    }
+
+    const std::vector<ParticleSet::SingleParticlePos> displs(nw, {0.1, -0.05, 0.02});
+    const std::vector<bool> isAccepted(nw, false);
+    auto vgl_sweep = [&] {
+      for (int iel = 0; iel < nelec; iel++)
+      {
+        ParticleSet::mw_makeMove(p_list, iel, displs);
+        spo->mw_evaluateVGL(spo_list, p_list, iel, psi_list, dpsi_list, d2psi_list);
+        ParticleSet::mw_accept_rejectMove(p_list, iel, isAccepted);
+      }
+    };
+
+    // quadrature points on a shell around each electron as in the non-local pseudopotential evaluation
+    std::vector<ParticleSet::SingleParticlePos> deltaV(params.nknots);
+    for (int k = 0; k < params.nknots; k++)
+    {
+      const double theta = M_PI * (k + 0.5) / params.nknots;
+      const double phi   = 2.0 * M_PI * k * 0.618033988749895;
+      deltaV[k] = {std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)};
+    }
+    std::vector<std::unique_ptr<VirtualParticleSet>> vps;
+    for (int iw = 0; iw < nw; iw++)
+      vps.push_back(std::make_unique<VirtualParticleSet>(*elecs[iw], params.nknots));
+    RefVectorWithLeader<const VirtualParticleSet> vp_list(*vps[0]);
+    for (int iw = 0; iw < nw; iw++)
+      vp_list.push_back(*vps[iw]);
+
+    std::vector<SPOSet::ValueType> inv_row(norb);
+    for (int j = 0; j < norb; j++)
+      inv_row[j] = 0.1 * (j + 1);
+    const std::vector<const SPOSet::ValueType*> inv_row_ptr(nw, inv_row.data());
+    std::vector<std::vector<SPOSet::ValueType>> ratios(nw, std::vector<SPOSet::ValueType>(params.nknots));
+    auto ratios_sweep = [&] {
+      for (int iel = 0; iel < nelec; iel++)
+      {
+        for (int iw = 0; iw < nw; iw++)
+          vps[iw]->makeMoves(iel, elecs[iw]->R[iel], deltaV);
+        spo->mw_evaluateDetRatios(spo_list, vp_list, psi_list, inv_row_ptr, ratios);
+      }
+    };
+
+    std::ostringstream crowd;
+    crowd << params.str() << " crowd=" << nw;
+    BENCHMARK_ADVANCED(crowd.str() + " mw_evaluateVGL sweep")(Catch::Benchmark::Chronometer meter)
+    {
+      meter.measure(vgl_sweep);
+    };
+    BENCHMARK_ADVANCED(crowd.str() + " mw_evaluateDetRatios sweep")(Catch::Benchmark::Chronometer meter)
+    {
+      meter.measure(ratios_sweep);
+    };
+
+    const int nsweeps = 10;
+    Timer timer;
+    for (int isweep = 0; isweep < nsweeps; isweep++)
+      vgl_sweep();
+    const double vgl_time = timer.elapsed();
+    timer.restart();
+    for (int isweep = 0; isweep < nsweeps; isweep++)
+      ratios_sweep();
+    const double ratios_time = timer.elapsed();
+
+    const double evals = static_cast<double>(nsweeps) * nw * nelec * norb;
+    std::cout << crowd.str() << " mw_evaluateVGL " << evals / vgl_time << " orbitals*electrons/s" << std::endl;
+    std::cout << crowd.str() << " mw_evaluateDetRatios " << evals * params.nknots / ratios_time
+              << " orbitals*electrons/s" << std::endl;
+  }
+}
+
+/** This and other [.benchmark] benchmarks only run if "[benchmark]" is explicitly passed as tag to test.
+ */
+TEST_CASE("BsplineSets_gamma_benchmark", "[wavefunction][.benchmark]")
+{
+  // SplineR2R in real builds and SplineC2C in complex builds
+  SplineBenchmarkParameters params;
+  params.name        = "diamondC_2x1x1 gamma";
+  params.system      = SplineBenchmarkSystem::DIAMOND_2X1X1;
+  params.norb        = 8;
+  params.crowd_sizes = {1, 8, 32, 128};
+  for (const double meshfactor : {1.0, 2.0})
+  {
+    params.meshfactor = meshfactor;
+    params.offload    = false;
+    params.hybrid     = false;
+    benchmarkSplineSPOSet(params);
+#if defined(ENABLE_OFFLOAD)
+    params.offload = true;
+    benchmarkSplineSPOSet(params);
+#endif
+  }
+}
+
+TEST_CASE("BsplineSets_twist_benchmark", "[wavefunction][.benchmark]")
+{
+  // SplineC2R(OMPTarget) in real builds and SplineC2C(OMPTarget) in complex builds
+  SplineBenchmarkParameters params;
+  params.name        = "LiH arbitrary twist";
+  params.system      = SplineBenchmarkSystem::LIH_ARB;
+  params.norb        = 2;
+  params.crowd_sizes = {1, 8, 32, 128};
+  for (const double meshfactor : {1.0, 2.0})
+  {
+    params.meshfactor = meshfactor;
+    params.offload    = false;
+    params.hybrid     = false;
+    benchmarkSplineSPOSet(params);
+#if defined(ENABLE_OFFLOAD)
+    params.offload = true;
+    benchmarkSplineSPOSet(params);
+#endif
+  }
+}
+
+TEST_CASE("BsplineSets_hugepages_benchmark", "[wavefunction][.benchmark]")
+{
+  // the random gathers over the coefficients on the default, transparent and explicit huge pages.
+  // The explicit ones fall back to transparent huge pages unless reserved in /proc/sys/vm/nr_hugepages.
+  SplineBenchmarkParameters params;
+  params.name        = "diamondC_2x1x1 gamma";
+  params.system      = SplineBenchmarkSystem::DIAMOND_2X1X1;
+  params.norb        = 8;
+  params.meshfactor  = 4.0;
+  params.offload     = false;
+  params.hybrid      = false;
+  params.crowd_sizes = {8, 32};
+  for (const std::string hugepages : {"no", "thp", "2MB", "1GB"})
+  {
+    params.hugepages = hugepages;
+    params.pinned    = false;
+    benchmarkSplineSPOSet(params);
+  }
+  params.hugepages = "thp";
+  params.pinned    = true;
+  benchmarkSplineSPOSet(params);
+}
+
+TEST_CASE("BsplineSets_hybrid_benchmark", "[wavefunction][.benchmark]")
+{
+  // HybridRepReal<SplineR2R> in real builds and HybridRepCplx<SplineC2C> in complex builds, always on the host
+  SplineBenchmarkParameters params;
+  params.name        = "diamondC_2x1x1 gamma";
+  params.system      = SplineBenchmarkSystem::DIAMOND_2X1X1;
+  params.norb        = 8;
+  params.meshfactor  = 1.0;
+  params.offload     = false;
+  params.hybrid      = true;
+  params.crowd_sizes = {1, 8, 32};
+  benchmarkSplineSPOSet(params);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** \file
+ *  This implements micro benchmarking of the ratio evaluation of the table method,
+ *  MultiDiracDeterminant::BuildDotProductsAndCalculateRatios, on synthetic expansions
+ *  shaped like selected CI (CIPSI) wavefunctions: all the single excitations and a random
+ *  selection of double, triple and quadruple excitations out of a reference determinant.
+ *  The compact excitation table is compared with the generic detData walk.
+ */
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include "QMCWaveFunctions/Fermion/MultiDiracDeterminant.h"
+#include "QMCWaveFunctions/tests/FakeSPO.h"
+
+namespace qmcplusplus
+{
+// Mechanism to pretty print benchmark names.
+struct MultiDetBenchmarkParameters;
+std::ostream& operator<<(std::ostream& out, const MultiDetBenchmarkParameters& mdbp);
+struct MultiDetBenchmarkParameters
+{
+  std::string name;
+  int nel;
+  int norb;
+  /// number of unique determinants at excitation level 2, 3, 4...
+  std::vector<int> num_excited;
+  std::string str() const
+  {
+    std::stringstream stream;
+    stream << *this;
+    return stream.str();
+  }
+};
+
+std::ostream& operator<<(std::ostream& out, const MultiDetBenchmarkParameters& mdbp)
+{
+  out << mdbp.name << " nel=" << mdbp.nel << " norb=" << mdbp.norb << " excited=";
+  for (int n : mdbp.num_excited)
+    out << n << ",";
+  return out;
+}
+
+/** build the unique determinants of a synthetic CIPSI-like expansion.
+ *  The reference occupies the lowest nel orbitals, all the single excitations are included
+ *  and num_excited[k] random distinct excitations of level k+2 are added.
+ */
+std::vector<ci_configuration2> buildCIPSILikeExpansion(const MultiDetBenchmarkParameters& params)
+{
+  std::mt19937 rng(17);
+  std::vector<size_t> ref(params.nel);
+  for (int i = 0; i < params.nel; i++)
+    ref[i] = i;
+
+  std::vector<ci_configuration2> configs;
+  configs.emplace_back(ref);
+  for (int i = 0; i < params.nel; i++)
+    for (int a = params.nel; a < params.norb; a++)
+    {
+      std::vector<size_t> occup(ref);
+      occup[i] = a;
+      configs.emplace_back(occup);
+    }
+
+  std::set<std::vector<size_t>> known;
+  for (int k = 0; k < params.num_excited.size(); k++)
+  {
+    const int level = k + 2;
+    std::uniform_int_distribution<int> hole(0, params.nel - 1);
+    // selected CI favours the virtual orbitals just above the Fermi level
+    std::geometric_distribution<int> particle(8.0 / (params.norb - params.nel));
+    int added = 0;
+    while (added < params.num_excited[k])
+    {
+      std::set<int> holes, particles;
+      while (holes.size() < level)
+        holes.insert(hole(rng));
+      while (particles.size() < level)
+        particles.insert(params.nel + particle(rng) % (params.norb - params.nel));
+      std::vector<size_t> occup(ref);
+      auto p = particles.begin();
+      for (int i : holes)
+        occup[i] = *(p++);
+      std::vector<size_t> key(occup);
+      std::sort(key.begin(), key.end());
+      if (known.insert(key).second)
+      {
+        configs.emplace_back(occup);
+        added++;
+      }
+    }
+  }
+  // selected CI lists the determinants by decreasing weight, mixing the excitation levels
+  std::shuffle(configs.begin() + 1, configs.end(), rng);
+  return configs;
+}
+
+TEST_CASE("benchmark MultiDiracDeterminant ratios", "[wavefunction][fermion][multidet][.benchmark]")
+{
+  using ValueType   = QMCTraits::ValueType;
+  using ValueMatrix = MultiDiracDeterminant::ValueMatrix;
+  using ValueVector = MultiDiracDeterminant::ValueVector;
+
+  std::vector<MultiDetBenchmarkParameters> benchmarks{{"small", 10, 60, {2000, 500}},
+                                                      {"medium", 20, 100, {20000, 5000, 1000}},
+                                                      {"large", 30, 160, {80000, 40000, 10000}}};
+
+  for (const auto& params : benchmarks)
+  {
+    auto spo = std::make_unique<FakeSPO>();
+    spo->setOrbitalSetSize(params.norb);
+    MultiDiracDeterminant det(std::move(spo), false);
+    det.getCIConfigList() = buildCIPSILikeExpansion(params);
+    det.set(0, params.nel, 0);
+    const int ndets = det.getNumDets();
+
+    std::mt19937 rng(29);
+    std::uniform_real_distribution<double> unif(-1.0, 1.0);
+    ValueMatrix psiinv(params.nel, params.nel), psi(params.norb, params.nel);
+    ValueMatrix dots(params.nel, params.norb);
+    for (auto& x : psiinv)
+      x = unif(rng);
+    for (auto& x : psi)
+      x = unif(rng);
+
+    const auto& data  = det.getDetData();
+    const auto& pairs = det.getUniquePairs();
+    const auto& signs = det.getDetSigns();
+    // a copy of detData is not recognized as the table of det and takes the generic path
+    const std::vector<int> data_copy(data);
+
+    ValueVector ratios(ndets), ratios_generic(ndets);
+    ratios[0] = ratios_generic[0] = ValueType(1);
+    det.BuildDotProductsAndCalculateRatios(0, ratios, psiinv, psi, dots, data, pairs, signs);
+    det.BuildDotProductsAndCalculateRatios(0, ratios_generic, psiinv, psi, dots, data_copy, pairs, signs);
+    int mismatches = 0;
+    for (int i = 0; i < ndets; i++)
+      if (ratios[i] != ratios_generic[i])
+        mismatches++;
+    CHECK(mismatches == 0);
+
+    std::cout << params << " unique dets=" << ndets << " unique pairs=" << pairs.size() << std::endl;
+
+    BENCHMARK_ADVANCED(params.str() + " compact table")(Catch::Benchmark::Chronometer meter)
+    {
+      meter.measure([&] { det.BuildDotProductsAndCalculateRatios(0, ratios, psiinv, psi, dots, data, pairs, signs); });
+    };
+
+    BENCHMARK_ADVANCED(params.str() + " detData")(Catch::Benchmark::Chronometer meter)
+    {
+      meter.measure(
+          [&] { det.BuildDotProductsAndCalculateRatios(0, ratios, psiinv, psi, dots, data_copy, pairs, signs); });
+    };
+  }
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,53 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "QMCWaveFunctions/Fermion/DelayRankTuner.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("DelayRankTuner", "[wavefunction][fermion]")
+{
+  DelayRankTuner tuner("test", 10, 2);
+  REQUIRE(tuner.getCandidates() == std::vector<int>{1, 2, 4, 8});
+  CHECK(tuner.isTuning());
+
+  // the fake cost of a walker update cycle is the lowest at rank 4
+  auto cycle_time = [](int rank) { return rank == 4 ? 1.0 : 2.0 + rank; };
+
+  for (int rank : tuner.getCandidates())
+  {
+    CHECK(tuner.getRank() == rank);
+    // a cycle measured with another rank is discarded
+    tuner.recordCycle(rank + 1, 0.0);
+    CHECK(tuner.getRank() == rank);
+    // one warmup cycle and two samples per candidate, each cycle covers 3 walkers
+    for (int cycle = 0; cycle < 3; cycle++)
+    {
+      CHECK(tuner.isTuning());
+      tuner.recordCycle(rank, 3 * cycle_time(rank), 3);
+    }
+  }
+
+  CHECK(!tuner.isTuning());
+  CHECK(tuner.getRank() == 4);
+  tuner.recordCycle(4, 100.0);
+  CHECK(tuner.getRank() == 4);
+
+  // nothing to tune with a single orbital
+  DelayRankTuner single("single", 1);
+  CHECK(!single.isTuning());
+  CHECK(single.getRank() == 1);
+}
+
+} // namespace qmcplusplus
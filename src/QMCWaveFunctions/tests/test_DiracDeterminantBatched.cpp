@@ -267,6 +267,66 @@ TEST_CASE("DiracDeterminantBatched_second", "[wavefunction][fermion]")
   test_DiracDeterminantBatched_second<MatrixUpdateOMPTarget<ValueType, QMCTraits::QTFull::ValueType>>();
 }
 
+template<class DET_ENGINE>
+void test_DiracDeterminantBatched_block()
+{
+  using DetType  = DiracDeterminantBatched<DET_ENGINE>;
+  auto spo_init  = std::make_unique<FakeSPO>();
+  const int norb = 4;
+  spo_init->setOrbitalSetSize(norb);
+  DetType ddb(std::move(spo_init), 0, norb);
+  auto spo = dynamic_cast<FakeSPO*>(ddb.getPhi());
+
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+
+  elec.create(4);
+  ddb.recompute(elec);
+  const LogValueType log_value_0 = ddb.get_log_value();
+
+  // the same as three consecutive single electron moves of electrons 0, 1 and 2
+  Matrix<ValueType> a_update3, scratchT;
+  a_update3.resize(4, 4);
+  scratchT.resize(4, 4);
+  a_update3 = spo->a2;
+  for (int j = 0; j < norb; j++)
+  {
+    a_update3(j, 0) = spo->v2(0, j);
+    a_update3(j, 1) = spo->v2(1, j);
+    a_update3(j, 2) = spo->v2(2, j);
+  }
+
+  DiracMatrix<ValueType> dm;
+  LogValueType det_update3;
+  simd::transpose(a_update3.data(), a_update3.rows(), a_update3.cols(), scratchT.data(), scratchT.rows(),
+                  scratchT.cols());
+  dm.invert_transpose(scratchT, a_update3, det_update3);
+  PsiValueType det_ratio3_val = LogToValue<ValueType>::convert(det_update3 - log_value_0);
+
+  PsiValueType det_ratio = ddb.ratioBlock(elec, {0, 1, 2});
+  CHECK(det_ratio == ValueApprox(det_ratio3_val));
+  ddb.acceptBlock();
+  ddb.completeUpdates();
+
+  CHECK(ddb.get_log_value() == Catch::Detail::LogComplexApprox(det_update3));
+  auto check_matrix_result = checkMatrix(a_update3, ddb.get_det_engine().get_ref_psiMinv());
+  CHECKED_ELSE(check_matrix_result.result) { FAIL(check_matrix_result.result_message); }
+
+  // a block of a single electron is a Sherman-Morrison update
+  PsiValueType ratio_block = ddb.ratioBlock(elec, {3});
+  ParticleSet::GradType grad;
+  PsiValueType ratio_single = ddb.ratioGrad(elec, 3, grad);
+  CHECK(ratio_block == ValueApprox(ratio_single));
+}
+
+TEST_CASE("DiracDeterminantBatched_block", "[wavefunction][fermion]")
+{
+#if defined(ENABLE_OFFLOAD) && defined(ENABLE_CUDA)
+  test_DiracDeterminantBatched_block<MatrixDelayedUpdateCUDA<ValueType, QMCTraits::QTFull::ValueType>>();
+#endif
+  test_DiracDeterminantBatched_block<MatrixUpdateOMPTarget<ValueType, QMCTraits::QTFull::ValueType>>();
+}
+
 template<class DET_ENGINE>
 void test_DiracDeterminantBatched_delayed_update(int delay_rank, DetMatInvertor matrix_inverter_kind)
 {
@@ -111,6 +111,76 @@ TEST_CASE("DiracMatrixComputeOMPTarget_different_batch_sizes", "[wavefunction][f
   CHECK(log_values[2] == ComplexApprox(std::complex<double>{5.267858159063328, 6.283185307179586}));
 }
 
+TEST_CASE("DiracMatrixComputeOMPTarget_padded_batch", "[wavefunction][fermion]")
+{
+  const int nw = 5;
+  std::vector<double> A{2, 5, 8, 7, 5, 2, 2, 8, 7, 5, 6, 6, 5, 4, 4, 8};
+  double invA[16]{-0.08247423, -0.26804124, 0.26804124, 0.05154639,  0.18556701,  -0.89690722, 0.39690722,  0.13402062,
+                  0.24742268,  -0.19587629, 0.19587629, -0.15463918, -0.29896907, 1.27835052,  -0.77835052, 0.06185567};
+
+  // the inverse matrices have padded rows like psiMinv in the determinant engines
+  std::vector<OffloadPinnedMatrix<double>> mats(nw), inv_mats(nw);
+  RefVector<const OffloadPinnedMatrix<double>> a_mats;
+  RefVector<OffloadPinnedMatrix<double>> inv_a_mats;
+  for (int iw = 0; iw < nw; iw++)
+  {
+    mats[iw].resize(4, 4);
+    std::copy_n(A.data(), 16, mats[iw].data());
+    inv_mats[iw].resize(4, 8);
+    a_mats.push_back(mats[iw]);
+    inv_a_mats.push_back(inv_mats[iw]);
+  }
+
+  OffloadPinnedVector<std::complex<double>> log_values(nw);
+  DiracMatrixComputeOMPTarget<double> dmc_omp;
+  DummyResource dummy_res;
+  dmc_omp.mw_invertTranspose(dummy_res, a_mats, inv_a_mats, log_values);
+
+  for (int iw = 0; iw < nw; iw++)
+  {
+    CHECK(log_values[iw] == ComplexApprox(std::complex<double>{5.267858159063328, 6.283185307179586}));
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 4; j++)
+        CHECK(inv_mats[iw](i, j) == Approx(invA[i * 4 + j]));
+  }
+}
+
+TEST_CASE("DiracMatrixComputeOMPTarget_mw_invert_host", "[wavefunction][fermion]")
+{
+  const int nw = 3;
+  std::vector<double> A{2, 5, 8, 7, 5, 2, 2, 8, 7, 5, 6, 6, 5, 4, 4, 8};
+  // inverse of the transpose of A, see above
+  double invAT[16]{-0.08247423, -0.26804124, 0.26804124, 0.05154639,  0.18556701,  -0.89690722, 0.39690722,  0.13402062,
+                   0.24742268,  -0.19587629, 0.19587629, -0.15463918, -0.29896907, 1.27835052,  -0.77835052, 0.06185567};
+
+  // plain host matrices are inverted without transposition
+  std::vector<Matrix<double>> mats(nw), inv_mats(nw);
+  RefVector<const Matrix<double>> a_mats;
+  RefVector<Matrix<double>> inv_a_mats;
+  for (int iw = 0; iw < nw; iw++)
+  {
+    mats[iw].resize(4, 4);
+    std::copy_n(A.data(), 16, mats[iw].data());
+    inv_mats[iw].resize(4, 4);
+    a_mats.push_back(mats[iw]);
+    inv_a_mats.push_back(inv_mats[iw]);
+  }
+
+  OffloadPinnedVector<std::complex<double>> log_values;
+  DiracMatrixComputeOMPTarget<double> dmc_omp;
+  DummyResource dummy_res;
+  dmc_omp.mw_invert(dummy_res, a_mats, inv_a_mats, log_values);
+
+  REQUIRE(log_values.size() == nw);
+  for (int iw = 0; iw < nw; iw++)
+  {
+    CHECK(log_values[iw] == ComplexApprox(std::complex<double>{5.267858159063328, 6.283185307179586}));
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 4; j++)
+        CHECK(inv_mats[iw](i, j) == Approx(invAT[j * 4 + i]));
+  }
+}
+
 TEST_CASE("DiracMatrixComputeOMPTarget_large_determinants_against_legacy", "[wavefunction][fermion]")
 {
   int n = 64;
@@ -15,6 +15,8 @@
 #include "QMCWaveFunctions/Jastrow/J1OrbitalSoA.h"
 #include "QMCWaveFunctions/Jastrow/RadialJastrowBuilder.h"
 #include "QMCWaveFunctions/WaveFunctionFactory.h"
+#include "Particle/VirtualParticleSet.h"
+#include "ResourceCollection.h"
 
 namespace qmcplusplus
 {
@@ -108,6 +110,19 @@ TEST_CASE("J1 evaluate derivatives Jastrow", "[wavefunction]")
     CHECK(dlogpsi[i] == ValueApprox(expected_dlogpsi[i]));
     CHECK(dhpsioverpsi[i] == ValueApprox(expected_dhpsioverpsi[i]));
   }
+
+  // the batched derivatives of two walkers through the trial wavefunction
+  RefVectorWithLeader<TrialWaveFunction> wf_list(twf, {twf, twf});
+  RefVectorWithLeader<ParticleSet> p_list(elec_, {elec_, elec_});
+  RecordArray<ValueType> mw_dlogpsi(nparam, 2);
+  RecordArray<ValueType> mw_dhpsioverpsi(nparam, 2);
+  TrialWaveFunction::mw_evaluateParameterDerivatives(wf_list, p_list, active, mw_dlogpsi, mw_dhpsioverpsi);
+  for (int i = 0; i < nparam; i++)
+    for (int iw = 0; iw < 2; iw++)
+    {
+      CHECK(mw_dlogpsi.getValue(i, iw) == ValueApprox(expected_dlogpsi[i]));
+      CHECK(mw_dhpsioverpsi.getValue(i, iw) == ValueApprox(expected_dhpsioverpsi[i]));
+    }
 }
 
 TEST_CASE("J1 evaluate derivatives Jastrow with two species", "[wavefunction]")
@@ -306,4 +321,158 @@ TEST_CASE("J1 evaluate derivatives Jastrow with two species one without Jastrow"
     CHECK(dhpsioverpsi[i] == ValueApprox(expected_dhpsioverpsi[i]));
   }
 }
+
+TEST_CASE("J1 batched APIs", "[wavefunction]")
+{
+  Communicate* c = OHMMS::Controller;
+  ParticleSetPool ptcl = ParticleSetPool(c);
+  auto ions_uptr = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  auto elec_uptr = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  ParticleSet& ions_(*ions_uptr);
+  ParticleSet& elec_(*elec_uptr);
+
+  ions_.setName("ion0");
+  ptcl.addParticleSet(std::move(ions_uptr));
+  ions_.create({1, 2});
+  ions_.R[0]                 = {0.0, 0.0, 1.0};
+  ions_.R[1]                 = {0.0, 0.0, 0.0};
+  ions_.R[2]                 = {0.0, 1.5, 0.0};
+  SpeciesSet& ispecies       = ions_.getSpeciesSet();
+  int OIdx                   = ispecies.addSpecies("O");
+  int HIdx                   = ispecies.addSpecies("H");
+  int ichargeIdx             = ispecies.addAttribute("charge");
+  ispecies(ichargeIdx, HIdx) = 1.0;
+  ispecies(ichargeIdx, OIdx) = 8.0;
+
+  elec_.setName("e");
+  ptcl.addParticleSet(std::move(elec_uptr));
+  elec_.create({2, 1});
+  elec_.R[0] = {0.5, 0.5, 0.5};
+  elec_.R[1] = {-0.5, -0.5, -0.5};
+  elec_.R[2] = {0.1, 0.9, -0.3};
+
+  SpeciesSet& tspecies       = elec_.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int downIdx                = tspecies.addSpecies("d");
+  int massIdx                = tspecies.addAttribute("mass");
+  tspecies(massIdx, upIdx)   = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+
+  ions_.update();
+  elec_.addTable(ions_);
+  elec_.update();
+
+  const char* jasxml = "<wavefunction name=\"psi0\" target=\"e\"> \
+  <jastrow name=\"J1\" type=\"One-Body\" function=\"Bspline\" print=\"yes\" source=\"ion0\"> \
+    <correlation elementType=\"H\" cusp=\"0.0\" size=\"3\" rcut=\"2.0\"> \
+      <coefficients id=\"J1H\" type=\"Array\"> 0.5 0.3 0.1 </coefficients> \
+    </correlation> \
+    <correlation elementType=\"O\" cusp=\"0.0\" size=\"3\" rcut=\"2.0\"> \
+      <coefficients id=\"J1O\" type=\"Array\"> 0.2 0.15 0.05 </coefficients> \
+    </correlation> \
+  </jastrow> \
+</wavefunction> \
+";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(jasxml);
+  REQUIRE(okay);
+
+  WaveFunctionFactory wf_factory("psi0", elec_, ptcl.getPool(), c);
+  wf_factory.put(doc.getRoot());
+  auto& twf(*wf_factory.getTWF());
+  auto& j1 = *twf.getOrbitals()[0];
+
+  ParticleSet elec2(elec_);
+  elec2.R[0] = {0.2, -0.3, 0.4};
+  elec2.R[2] = {-0.7, 1.2, 0.1};
+  elec2.update();
+  auto j1_clone = j1.makeClone(elec2);
+
+  // single walker references
+  const int nel = elec_.getTotalNum();
+  ParticleSet::ParticleGradient G(nel), G2(nel);
+  ParticleSet::ParticleLaplacian L(nel), L2(nel);
+  G  = 0.0;
+  L  = 0.0;
+  G2 = 0.0;
+  L2 = 0.0;
+  j1.evaluateLog(elec_, G, L);
+  j1_clone->evaluateLog(elec2, G2, L2);
+
+  ResourceCollection j1_res("test_j1_res");
+  j1.createResource(j1_res);
+  RefVectorWithLeader<WaveFunctionComponent> wfc_list(j1, {j1, *j1_clone});
+  RefVectorWithLeader<ParticleSet> p_list(elec_, {elec_, elec2});
+  ResourceCollectionTeamLock<WaveFunctionComponent> j1_lock(j1_res, wfc_list);
+
+  const int iat = 1;
+  const ParticleSet::SingleParticlePos delta(0.3, -0.2, 0.4);
+  elec_.makeMove(iat, delta);
+  elec2.makeMove(iat, delta);
+
+  std::vector<WaveFunctionComponent::GradType> grad_ref(2, 0), grad_new(2, 0);
+  std::vector<WaveFunctionComponent::PsiValueType> ratios_ref(2), ratios(2);
+  ratios_ref[0] = j1.ratioGrad(elec_, iat, grad_ref[0]);
+  ratios_ref[1] = j1_clone->ratioGrad(elec2, iat, grad_ref[1]);
+
+  j1.mw_calcRatio(wfc_list, p_list, iat, ratios);
+  for (int iw = 0; iw < 2; iw++)
+    CHECK(ValueApprox(ratios[iw]) == ratios_ref[iw]);
+
+  std::fill(ratios.begin(), ratios.end(), 0);
+  j1.mw_ratioGrad(wfc_list, p_list, iat, ratios, grad_new);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    CHECK(ValueApprox(ratios[iw]) == ratios_ref[iw]);
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      CHECK(ValueApprox(grad_new[iw][idim]) == grad_ref[iw][idim]);
+  }
+
+  std::vector<bool> isAccepted{true, false};
+  j1.mw_accept_rejectMove(wfc_list, p_list, iat, isAccepted);
+  elec_.acceptMove(iat);
+  elec2.rejectMove(iat);
+
+  // log values after the move must agree with a from scratch evaluation
+  const auto log_after_move = j1.get_log_value();
+  const auto log2           = j1_clone->get_log_value();
+  RefVector<ParticleSet::ParticleGradient> G_list{G, G2};
+  RefVector<ParticleSet::ParticleLaplacian> L_list{L, L2};
+  G  = 0.0;
+  L  = 0.0;
+  G2 = 0.0;
+  L2 = 0.0;
+  j1.mw_evaluateGL(wfc_list, p_list, G_list, L_list, true);
+  CHECK(std::real(j1.get_log_value()) == Approx(std::real(log_after_move)));
+  CHECK(std::real(j1_clone->get_log_value()) == Approx(std::real(log2)));
+
+  ParticleSet::ParticleGradient G_ref(nel);
+  ParticleSet::ParticleLaplacian L_ref(nel);
+  G_ref = 0.0;
+  L_ref = 0.0;
+  j1_clone->evaluateLog(elec2, G_ref, L_ref);
+  for (int iel = 0; iel < nel; iel++)
+  {
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      CHECK(ValueApprox(G2[iel][idim]) == G_ref[iel][idim]);
+    CHECK(ValueApprox(L2[iel]) == L_ref[iel]);
+  }
+
+  // virtual particle ratios
+  VirtualParticleSet vp(elec_, 2), vp2(elec2, 2);
+  std::vector<ParticleSet::SingleParticlePos> deltaV{{0.1, 0.2, -0.3}, {-0.4, 0.1, 0.2}};
+  vp.makeMoves(0, elec_.R[0], deltaV);
+  vp2.makeMoves(2, elec2.R[2], deltaV);
+  RefVectorWithLeader<const VirtualParticleSet> vp_list(vp, {vp, vp2});
+  std::vector<std::vector<WaveFunctionComponent::ValueType>> vp_ratios(2,
+                                                                       std::vector<WaveFunctionComponent::ValueType>(2));
+  std::vector<WaveFunctionComponent::ValueType> vp_ratios_ref(2);
+  j1.mw_evaluateRatios(wfc_list, vp_list, vp_ratios);
+  j1.evaluateRatios(vp, vp_ratios_ref);
+  for (int k = 0; k < 2; k++)
+    CHECK(ValueApprox(vp_ratios[0][k]) == vp_ratios_ref[k]);
+  j1_clone->evaluateRatios(vp2, vp_ratios_ref);
+  for (int k = 0; k < 2; k++)
+    CHECK(ValueApprox(vp_ratios[1][k]) == vp_ratios_ref[k]);
+}
 } // namespace qmcplusplus
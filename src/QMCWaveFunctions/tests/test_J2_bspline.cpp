@@ -120,6 +120,27 @@ TEST_CASE("BSpline builder Jastrow J2", "[wavefunction]")
   CHECK(std::real(dlogpsi[2]) == Approx(-0.2211666667));
   CHECK(std::real(dhpsioverpsi[3]) == Approx(0.1331717179));
 
+  // the batched derivatives of two walkers should agree with evaluateDerivatives
+  {
+    RefVectorWithLeader<WaveFunctionComponent> wfc_list(*j2, {*j2, *j2});
+    RefVectorWithLeader<ParticleSet> p_list(elec_, {elec_, elec_});
+    RecordArray<WaveFunctionComponent::ValueType> mw_dlogpsi(NumOptimizables, 2);
+    RecordArray<WaveFunctionComponent::ValueType> mw_dhpsioverpsi(NumOptimizables, 2);
+    for (int iparam = 0; iparam < NumOptimizables; iparam++)
+      for (int iw = 0; iw < 2; iw++)
+      {
+        mw_dlogpsi.setValue(iparam, iw, 0.0);
+        mw_dhpsioverpsi.setValue(iparam, iw, 0.0);
+      }
+    j2->mw_evaluateParameterDerivatives(wfc_list, p_list, optvars, mw_dlogpsi, mw_dhpsioverpsi);
+    for (int iparam = 0; iparam < NumOptimizables; iparam++)
+      for (int iw = 0; iw < 2; iw++)
+      {
+        CHECK(std::real(mw_dlogpsi.getValue(iparam, iw)) == Approx(std::real(dlogpsi[iparam])));
+        CHECK(std::real(mw_dhpsioverpsi.getValue(iparam, iw)) == Approx(std::real(dhpsioverpsi[iparam])));
+      }
+  }
+
 
   // now test evaluateHessian
   WaveFunctionComponent::HessVector grad_grad_psi;
@@ -18,7 +18,14 @@
 #include "ParticleIO/XMLParticleIO.h"
 #include "Numerics/GaussianBasisSet.h"
 #include "QMCWaveFunctions/LCAO/LCAOrbitalBuilder.h"
+#include "QMCWaveFunctions/LCAO/SoaLocalizedBasisSet.h"
+#include "QMCWaveFunctions/LCAO/SoaAtomicBasisSet.h"
+#include "QMCWaveFunctions/LCAO/MultiQuinticSpline1D.h"
+#include "QMCWaveFunctions/LCAO/SoaCartesianTensor.h"
+#include "QMCWaveFunctions/LCAO/SoaSphericalTensor.h"
 #include "QMCWaveFunctions/SPOSetBuilderFactory.h"
+#include "Particle/VirtualParticleSet.h"
+#include "ResourceCollection.h"
 
 namespace qmcplusplus
 {
@@ -664,4 +671,384 @@ TEST_CASE("ReadMolecularOrbital GTO HCN", "[wavefunction]") { test_HCN(false); }
 
 TEST_CASE("ReadMolecularOrbital Numerical HCN", "[wavefunction]") { test_HCN(true); }
 
+void test_HCN_batched(bool transform, bool spherical, bool offload = true)
+{
+  Communicate* c = OHMMS::Controller;
+
+  Libxml2Document doc;
+  REQUIRE(doc.parse("hcn.structure.xml"));
+
+  const SimulationCell simulation_cell;
+  ParticleSet ions(simulation_cell);
+  XMLParticleParser parse_ions(ions);
+  OhmmsXPathObject particleset_ion("//particleset[@name='ion0']", doc.getXPathContext());
+  REQUIRE(particleset_ion.size() == 1);
+  parse_ions.put(particleset_ion[0]);
+  ions.update();
+
+  ParticleSet elec(simulation_cell);
+  XMLParticleParser parse_elec(elec);
+  OhmmsXPathObject particleset_elec("//particleset[@name='e']", doc.getXPathContext());
+  REQUIRE(particleset_elec.size() == 1);
+  parse_elec.put(particleset_elec[0]);
+  REQUIRE(elec.R.size() == 14);
+  for (int iel = 0; iel < elec.getTotalNum(); iel++)
+    elec.R[iel] = {0.1 * iel - 0.7, 0.05 * iel, 0.3 - 0.04 * iel};
+  elec.addTable(ions);
+  elec.update();
+
+  Libxml2Document doc2;
+  REQUIRE(doc2.parse("hcn.wfnoj.xml"));
+  OhmmsXPathObject MO_base("//determinantset", doc2.getXPathContext());
+  REQUIRE(MO_base.size() == 1);
+  if (transform)
+  {
+    // numerical radial functions are evaluated by the offload kernel, on the host if offload is not enabled,
+    // or in host batches per center without the kernel
+    xmlSetProp(MO_base[0], (const xmlChar*)"gpu", (const xmlChar*)(offload ? "yes" : "no"));
+    if (spherical)
+    {
+      OhmmsXPathObject ao_base("//atomicBasisSet", doc2.getXPathContext());
+      for (int i = 0; i < ao_base.size(); i++)
+        xmlSetProp(ao_base[i], (const xmlChar*)"angular", (const xmlChar*)"spherical");
+    }
+  }
+  else
+  {
+    xmlSetProp(MO_base[0], (const xmlChar*)"transform", (const xmlChar*)"no");
+    xmlSetProp(MO_base[0], (const xmlChar*)"key", (const xmlChar*)"GTO");
+  }
+
+  WaveFunctionComponentBuilder::PtclPoolType particle_set_map;
+  particle_set_map["e"]    = &elec;
+  particle_set_map["ion0"] = &ions;
+  SPOSetBuilderFactory bf(c, elec, particle_set_map);
+  auto& bb = bf.createSPOSetBuilder(MO_base[0]);
+  OhmmsXPathObject slater_base("//determinant", doc2.getXPathContext());
+  SPOSet* sposet = bb.createSPOSet(slater_base[0]);
+  auto* lcao     = dynamic_cast<LCAOrbitalSet*>(sposet);
+  REQUIRE(lcao != nullptr);
+#if !defined(QMC_COMPLEX)
+  if (transform)
+  {
+    using RealType = QMCTraits::RealType;
+    using CartesianBasis =
+        SoaLocalizedBasisSet<SoaAtomicBasisSet<MultiQuinticSpline1D<RealType>, SoaCartesianTensor<RealType>>,
+                             QMCTraits::ValueType>;
+    using SphericalBasis =
+        SoaLocalizedBasisSet<SoaAtomicBasisSet<MultiQuinticSpline1D<RealType>, SoaSphericalTensor<RealType>>,
+                             QMCTraits::ValueType>;
+    if (spherical)
+    {
+      auto* basis = dynamic_cast<SphericalBasis*>(lcao->myBasisSet.get());
+      REQUIRE(basis != nullptr);
+      CHECK(basis->isOffloaded() == offload);
+    }
+    else
+    {
+      auto* basis = dynamic_cast<CartesianBasis*>(lcao->myBasisSet.get());
+      REQUIRE(basis != nullptr);
+      CHECK(basis->isOffloaded() == offload);
+    }
+  }
+#endif
+  auto sposet2 = sposet->makeClone();
+
+  // a second walker at a different configuration
+  ParticleSet elec2(elec);
+  for (int iel = 0; iel < elec2.getTotalNum(); iel++)
+    elec2.R[iel] += ParticleSet::SingleParticlePos(0.02 * iel, -0.1, 0.05);
+  elec2.update();
+
+  ResourceCollection spo_res("test_lcao_res");
+  sposet->createResource(spo_res);
+  RefVectorWithLeader<SPOSet> spo_list(*sposet, {*sposet, *sposet2});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  ResourceCollectionTeamLock<SPOSet> spo_lock(spo_res, spo_list);
+
+  const int norb = 7;
+  const int nel  = 7;
+  std::vector<SPOSet::ValueMatrix> logdet(2, SPOSet::ValueMatrix(nel, norb)), d2logdet(2, SPOSet::ValueMatrix(nel, norb));
+  std::vector<SPOSet::GradMatrix> dlogdet(2, SPOSet::GradMatrix(nel, norb));
+  sposet->mw_evaluate_notranspose(spo_list, p_list, nel, 2 * nel, {logdet[0], logdet[1]}, {dlogdet[0], dlogdet[1]},
+                                  {d2logdet[0], d2logdet[1]});
+  SPOSet::ValueMatrix logdet_ref(nel, norb), d2logdet_ref(nel, norb);
+  SPOSet::GradMatrix dlogdet_ref(nel, norb);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    spo_list[iw].evaluate_notranspose(p_list[iw], nel, 2 * nel, logdet_ref, dlogdet_ref, d2logdet_ref);
+    for (int i = 0; i < nel; i++)
+      for (int j = 0; j < norb; j++)
+      {
+        CHECK(logdet[iw][i][j] == Approx(logdet_ref[i][j]));
+        for (int idim = 0; idim < OHMMS_DIM; idim++)
+          CHECK(dlogdet[iw][i][j][idim] == Approx(dlogdet_ref[i][j][idim]));
+        CHECK(d2logdet[iw][i][j] == Approx(d2logdet_ref[i][j]));
+      }
+  }
+
+  const int iat = 2;
+  ParticleSet::SingleParticlePos newpos(0.3, -0.2, 0.1);
+  elec.makeMove(iat, newpos);
+  elec2.makeMove(iat, newpos);
+
+  std::vector<SPOSet::ValueVector> psi(2, SPOSet::ValueVector(norb)), d2psi(2, SPOSet::ValueVector(norb));
+  std::vector<SPOSet::GradVector> dpsi(2, SPOSet::GradVector(norb));
+  sposet->mw_evaluateVGL(spo_list, p_list, iat, {psi[0], psi[1]}, {dpsi[0], dpsi[1]}, {d2psi[0], d2psi[1]});
+
+  std::vector<SPOSet::ValueType> inv_row(norb);
+  for (int j = 0; j < norb; j++)
+    inv_row[j] = 0.1 * (j + 1);
+  const std::vector<const SPOSet::ValueType*> inv_row_ptr(2, inv_row.data());
+  SPOSet::VGLVector phi_vgl_v(2 * norb);
+  std::vector<SPOSet::ValueType> ratios(2);
+  std::vector<SPOSet::GradType> grads(2);
+  sposet->mw_evaluateVGLandDetRatioGrads(spo_list, p_list, iat, inv_row_ptr, phi_vgl_v, ratios, grads);
+
+  SPOSet::ValueVector psi_ref(norb), d2psi_ref(norb);
+  SPOSet::GradVector dpsi_ref(norb);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    spo_list[iw].evaluateVGL(p_list[iw], iat, psi_ref, dpsi_ref, d2psi_ref);
+    SPOSet::ValueType ratio_ref = 0;
+    SPOSet::GradType grad_ref   = 0;
+    for (int j = 0; j < norb; j++)
+    {
+      CHECK(psi[iw][j] == Approx(psi_ref[j]));
+      CHECK(phi_vgl_v.data(0)[iw * norb + j] == Approx(psi_ref[j]));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        CHECK(dpsi[iw][j][idim] == Approx(dpsi_ref[j][idim]));
+      CHECK(d2psi[iw][j] == Approx(d2psi_ref[j]));
+      ratio_ref += inv_row[j] * psi_ref[j];
+      grad_ref += inv_row[j] * dpsi_ref[j];
+    }
+    CHECK(ratios[iw] == Approx(ratio_ref));
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      CHECK(grads[iw][idim] == Approx(grad_ref[idim] / ratio_ref));
+  }
+  elec.rejectMove(iat);
+  elec2.rejectMove(iat);
+
+  VirtualParticleSet vp(elec, 2), vp2(elec2, 2);
+  std::vector<ParticleSet::SingleParticlePos> deltaV{{0.1, 0.2, -0.3}, {-0.4, 0.1, 0.2}};
+  vp.makeMoves(iat, elec.R[iat], deltaV);
+  vp2.makeMoves(iat, elec2.R[iat], deltaV);
+  RefVectorWithLeader<const VirtualParticleSet> vp_list(vp, {vp, vp2});
+  std::vector<std::vector<SPOSet::ValueType>> vp_ratios(2, std::vector<SPOSet::ValueType>(2));
+  sposet->mw_evaluateDetRatios(spo_list, vp_list, {psi[0], psi[1]}, inv_row_ptr, vp_ratios);
+
+  SPOSet::ValueVector inv_row_v(inv_row.data(), norb);
+  std::vector<SPOSet::ValueType> vp_ratios_ref(2);
+  sposet->evaluateDetRatios(vp, psi_ref, inv_row_v, vp_ratios_ref);
+  for (int k = 0; k < 2; k++)
+    CHECK(vp_ratios[0][k] == Approx(vp_ratios_ref[k]));
+  sposet2->evaluateDetRatios(vp2, psi_ref, inv_row_v, vp_ratios_ref);
+  for (int k = 0; k < 2; k++)
+    CHECK(vp_ratios[1][k] == Approx(vp_ratios_ref[k]));
+}
+
+void test_HCN_screened(bool transform)
+{
+  Communicate* c = OHMMS::Controller;
+
+  Libxml2Document doc;
+  REQUIRE(doc.parse("hcn.structure.xml"));
+
+  const SimulationCell simulation_cell;
+  ParticleSet ions(simulation_cell);
+  XMLParticleParser parse_ions(ions);
+  OhmmsXPathObject particleset_ion("//particleset[@name='ion0']", doc.getXPathContext());
+  REQUIRE(particleset_ion.size() == 1);
+  parse_ions.put(particleset_ion[0]);
+  ions.update();
+
+  ParticleSet elec(simulation_cell);
+  XMLParticleParser parse_elec(elec);
+  OhmmsXPathObject particleset_elec("//particleset[@name='e']", doc.getXPathContext());
+  REQUIRE(particleset_elec.size() == 1);
+  parse_elec.put(particleset_elec[0]);
+  elec.addTable(ions);
+  elec.update();
+
+  Libxml2Document doc2;
+  REQUIRE(doc2.parse("hcn.wfnoj.xml"));
+  OhmmsXPathObject MO_base("//determinantset", doc2.getXPathContext());
+  REQUIRE(MO_base.size() == 1);
+  xmlSetProp(MO_base[0], (const xmlChar*)"cutoffTolerance", (const xmlChar*)"1e-3");
+  if (!transform)
+  {
+    xmlSetProp(MO_base[0], (const xmlChar*)"transform", (const xmlChar*)"no");
+    xmlSetProp(MO_base[0], (const xmlChar*)"key", (const xmlChar*)"GTO");
+  }
+
+  WaveFunctionComponentBuilder::PtclPoolType particle_set_map;
+  particle_set_map["e"]    = &elec;
+  particle_set_map["ion0"] = &ions;
+  SPOSetBuilderFactory bf(c, elec, particle_set_map);
+  auto& bb = bf.createSPOSetBuilder(MO_base[0]);
+  OhmmsXPathObject slater_base("//determinant", doc2.getXPathContext());
+  SPOSet* sposet = bb.createSPOSet(slater_base[0]);
+  auto* lcao     = dynamic_cast<LCAOrbitalSet*>(sposet);
+  REQUIRE(lcao != nullptr);
+
+  auto& basis           = *lcao->myBasisSet;
+  const int nbasis      = basis.getBasisSetSize();
+  const int norb        = sposet->getOrbitalSetSize();
+  const auto& coef      = *lcao->C;
+  LCAOrbitalSet::vgl_type vgl(nbasis), vgl_screened(nbasis);
+  LCAOrbitalSet::basis_type::BasisRanges ranges;
+  SPOSet::ValueVector psi(norb), d2psi(norb), psi_v(norb);
+  SPOSet::GradVector dpsi(norb);
+
+  // move an electron along the molecular axis, from overlapping all the centers to none of them
+  int num_partial = 0, num_empty = 0;
+  const int iat   = 0;
+  for (int ix = 0; ix <= 40; ix++)
+  {
+    elec.R[iat] = {3.1 - 0.8 * ix, 0.3, -0.2};
+    elec.update();
+
+    basis.evaluateVGL(elec, iat, vgl);
+    basis.evaluateVGLScreened(elec, iat, vgl_screened, ranges);
+    if (ranges.empty())
+      num_empty++;
+    else if (ranges.size() > 1 || ranges[0].first > 0 || ranges[0].second < nbasis)
+      num_partial++;
+
+    // the screened out basis functions vanish
+    std::vector<bool> in_range(nbasis, false);
+    for (const auto& [first, last] : ranges)
+      for (int ib = first; ib < last; ib++)
+        in_range[ib] = true;
+    for (int ib = 0; ib < nbasis; ib++)
+      for (int icomp = 0; icomp < OHMMS_DIM + 2; icomp++)
+        if (in_range[ib])
+          CHECK(vgl_screened.data(icomp)[ib] == ValueApprox(vgl.data(icomp)[ib]));
+        else
+          CHECK(vgl.data(icomp)[ib] == ValueApprox(0.0));
+
+    sposet->evaluateVGL(elec, iat, psi, dpsi, d2psi);
+    sposet->evaluateValue(elec, iat, psi_v);
+    for (int j = 0; j < norb; j++)
+    {
+      SPOSet::ValueType vgl_ref[OHMMS_DIM + 2] = {0};
+      for (int ib = 0; ib < nbasis; ib++)
+        for (int icomp = 0; icomp < OHMMS_DIM + 2; icomp++)
+          vgl_ref[icomp] += coef(j, ib) * vgl.data(icomp)[ib];
+      CHECK(psi[j] == ValueApprox(vgl_ref[0]));
+      CHECK(psi_v[j] == ValueApprox(vgl_ref[0]));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        CHECK(dpsi[j][idim] == ValueApprox(vgl_ref[idim + 1]));
+      CHECK(d2psi[j] == ValueApprox(vgl_ref[OHMMS_DIM + 1]));
+    }
+  }
+  CHECK(num_partial > 0);
+  CHECK(num_empty > 0);
+
+  // the ratios of virtual moves near and far from the molecule
+  elec.R[iat] = {0.5, 0.3, -0.2};
+  elec.update();
+  VirtualParticleSet vp(elec, 2);
+  std::vector<ParticleSet::SingleParticlePos> deltaV{{0.1, 0.2, -0.3}, {-40.0, 0.1, 0.2}};
+  vp.makeMoves(iat, elec.R[iat], deltaV);
+  SPOSet::ValueVector inv_row(norb);
+  for (int j = 0; j < norb; j++)
+    inv_row[j] = 0.1 * (j + 1);
+  std::vector<SPOSet::ValueType> ratios(2);
+  sposet->evaluateDetRatios(vp, psi, inv_row, ratios);
+  CHECK(ratios[1] == ValueApprox(0.0));
+  for (int k = 0; k < 2; k++)
+  {
+    std::vector<SPOSet::ValueType> vals(nbasis);
+    basis.evaluateV(vp, k, vals.data());
+    SPOSet::ValueType ratio_ref = 0;
+    for (int j = 0; j < norb; j++)
+      for (int ib = 0; ib < nbasis; ib++)
+        ratio_ref += inv_row[j] * coef(j, ib) * vals[ib];
+    CHECK(ratios[k] == ValueApprox(ratio_ref));
+  }
+}
+
+void test_HCN_shared_coefficients()
+{
+  Communicate* c = OHMMS::Controller;
+
+  Libxml2Document doc;
+  REQUIRE(doc.parse("hcn.structure.xml"));
+
+  const SimulationCell simulation_cell;
+  ParticleSet ions(simulation_cell);
+  XMLParticleParser parse_ions(ions);
+  OhmmsXPathObject particleset_ion("//particleset[@name='ion0']", doc.getXPathContext());
+  REQUIRE(particleset_ion.size() == 1);
+  parse_ions.put(particleset_ion[0]);
+  ions.update();
+
+  ParticleSet elec(simulation_cell);
+  XMLParticleParser parse_elec(elec);
+  OhmmsXPathObject particleset_elec("//particleset[@name='e']", doc.getXPathContext());
+  REQUIRE(particleset_elec.size() == 1);
+  parse_elec.put(particleset_elec[0]);
+  elec.addTable(ions);
+  elec.R[0] = {0.5, 0.3, -0.2};
+  elec.update();
+
+  Libxml2Document doc2;
+  REQUIRE(doc2.parse("hcn.wfnoj.xml"));
+  OhmmsXPathObject MO_base("//determinantset", doc2.getXPathContext());
+  REQUIRE(MO_base.size() == 1);
+  OhmmsXPathObject slater_base("//determinant", doc2.getXPathContext());
+
+  WaveFunctionComponentBuilder::PtclPoolType particle_set_map;
+  particle_set_map["e"]    = &elec;
+  particle_set_map["ion0"] = &ions;
+
+  SPOSetBuilderFactory bf(c, elec, particle_set_map);
+  auto& bb         = bf.createSPOSetBuilder(MO_base[0]);
+  SPOSet* sposet   = bb.createSPOSet(slater_base[0]);
+  const auto* lcao = dynamic_cast<LCAOrbitalSet*>(sposet);
+  REQUIRE(lcao != nullptr);
+  REQUIRE(lcao->C_shared == nullptr);
+
+  xmlSetProp(MO_base[0], (const xmlChar*)"sharedCoefficients", (const xmlChar*)"yes");
+  SPOSetBuilderFactory bf_shared(c, elec, particle_set_map);
+  auto& bb_shared         = bf_shared.createSPOSetBuilder(MO_base[0]);
+  SPOSet* sposet_shared   = bb_shared.createSPOSet(slater_base[0]);
+  const auto* lcao_shared = dynamic_cast<LCAOrbitalSet*>(sposet_shared);
+  REQUIRE(lcao_shared != nullptr);
+  REQUIRE(lcao_shared->C_shared != nullptr);
+  REQUIRE(lcao_shared->C->data() == lcao_shared->C_shared->data());
+  CHECK(*lcao_shared->C == *lcao->C);
+
+  // the clones keep reading the same storage
+  auto clone             = sposet_shared->makeClone();
+  const auto& lcao_clone = dynamic_cast<const LCAOrbitalSet&>(*clone);
+  CHECK(lcao_clone.C->data() == lcao_shared->C_shared->data());
+
+  const int norb = sposet->getOrbitalSetSize();
+  SPOSet::ValueVector psi(norb), psi_shared(norb);
+  sposet->evaluateValue(elec, 0, psi);
+  clone->evaluateValue(elec, 0, psi_shared);
+  for (int j = 0; j < norb; j++)
+    CHECK(psi_shared[j] == ValueApprox(psi[j]));
+}
+
+TEST_CASE("LCAOrbitalSet node shared coefficients HCN", "[wavefunction]") { test_HCN_shared_coefficients(); }
+
+TEST_CASE("LCAOrbitalSet batched GTO HCN", "[wavefunction]") { test_HCN_batched(false, false); }
+
+TEST_CASE("LCAOrbitalSet batched Numerical HCN", "[wavefunction]")
+{
+  SECTION("cartesian") { test_HCN_batched(true, false); }
+  SECTION("spherical") { test_HCN_batched(true, true); }
+  SECTION("cartesian batched radials") { test_HCN_batched(true, false, false); }
+  SECTION("spherical batched radials") { test_HCN_batched(true, true, false); }
+}
+
+TEST_CASE("LCAOrbitalSet screened HCN", "[wavefunction]")
+{
+  SECTION("GTO") { test_HCN_screened(false); }
+  SECTION("Numerical") { test_HCN_screened(true); }
+}
+
 } // namespace qmcplusplus
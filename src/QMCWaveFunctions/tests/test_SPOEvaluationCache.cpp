@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "QMCWaveFunctions/SPOEvaluationCache.h"
+#include "QMCWaveFunctions/Fermion/DiracDeterminantBatched.h"
+#include "QMCWaveFunctions/tests/FakeSPO.h"
+
+namespace qmcplusplus
+{
+using ValueType    = QMCTraits::ValueType;
+using PosType      = QMCTraits::PosType;
+using GradType     = QMCTraits::GradType;
+using PsiValueType = QMCTraits::QTFull::ValueType;
+
+TEST_CASE("SPOEvaluationCache", "[wavefunction]")
+{
+  SPOEvaluationCacheRegistry registry;
+  CHECK(!registry.getCache("", 0, 2));
+
+  // up and down determinants on the same orbitals never evaluate the same particle
+  auto cache = registry.getCache("spo", 0, 2);
+  CHECK(registry.getCache("spo", 2, 4) == cache);
+  CHECK(!cache->isShared());
+  CHECK(!registry.getCache("other", 1, 3)->isShared());
+  // a second component on the up electrons does
+  CHECK(registry.getCache("spo", 1, 2) == cache);
+  CHECK(cache->isShared());
+
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+  elec.create({2, 2});
+  elec.R[1] = PosType(0.1, 0.2, 0.3);
+  ParticleSet elec2(elec);
+
+  SPOEvaluationCache::ValueVector psi{1.0, 2.0, 3.0}, psi_out(3), d2psi{-1.0, -2.0, -3.0}, d2psi_out(3);
+  SPOEvaluationCache::GradVector dpsi(3), dpsi_out(3);
+  dpsi[2] = GradType(0.5, 0.6, 0.7);
+
+  elec.makeMove(1, PosType(0.01, 0.0, 0.0));
+  CHECK(!cache->getValue(elec, 1, psi_out));
+  cache->putValue(elec, 1, psi);
+  CHECK(!cache->getVGL(elec, 1, psi_out, dpsi_out, d2psi_out));
+  CHECK(cache->getValue(elec, 1, psi_out));
+  CHECK(psi_out[2] == ValueApprox(3.0));
+
+  cache->putVGL(elec, 1, psi, dpsi, d2psi);
+  CHECK(cache->getVGL(elec, 1, psi_out, dpsi_out, d2psi_out));
+  CHECK(dpsi_out[2][1] == ValueApprox(0.6));
+  CHECK(d2psi_out[1] == ValueApprox(-2.0));
+  CHECK(cache->getNumHits() == 2);
+
+  // another particle, particle set or position is a miss
+  CHECK(!cache->getValue(elec, 0, psi_out));
+  CHECK(!cache->getValue(elec2, 1, psi_out));
+  elec.rejectMove(1);
+  elec.makeMove(1, PosType(0.02, 0.0, 0.0));
+  CHECK(!cache->getValue(elec, 1, psi_out));
+  elec.rejectMove(1);
+  elec.makeMove(1, PosType(0.01, 0.0, 0.0));
+  CHECK(cache->getValue(elec, 1, psi_out));
+
+  cache->invalidate();
+  CHECK(!cache->getValue(elec, 1, psi_out));
+}
+
+TEST_CASE("DiracDeterminantBatched shared SPO evaluations", "[wavefunction][fermion]")
+{
+  using DetType  = DiracDeterminantBatched<MatrixUpdateOMPTarget<ValueType, QMCTraits::QTFull::ValueType>>;
+  const int norb = 3;
+
+  // two components using the same orbitals for the same electrons
+  std::vector<std::unique_ptr<DetType>> dets;
+  SPOEvaluationCacheRegistry registry;
+  for (int i = 0; i < 2; i++)
+  {
+    auto spo = std::make_unique<FakeSPO>();
+    spo->setOrbitalSetSize(norb);
+    spo->setName("fake");
+    dets.push_back(std::make_unique<DetType>(std::move(spo), 0, norb));
+    dets.back()->dpsiV.resize(norb);
+    dets.back()->d2psiV.resize(norb);
+    dets.back()->registerSPOEvaluationCache(registry);
+  }
+  auto cache = registry.getCache("fake", 0, 0);
+
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+  elec.create(3);
+  for (auto& det : dets)
+    det->recompute(elec);
+
+  elec.makeMove(0, PosType(0.1, 0.0, 0.0));
+  GradType grad0, grad1;
+  const PsiValueType ratio0 = dets[0]->ratioGrad(elec, 0, grad0);
+  CHECK(cache->getNumHits() == 0);
+  const PsiValueType ratio1 = dets[1]->ratioGrad(elec, 0, grad1);
+  CHECK(cache->getNumHits() == 1);
+  CHECK(ratio1 == ValueApprox(ratio0));
+  CHECK(ratio0 == ValueApprox(0.178276269185));
+  for (int d = 0; d < OHMMS_DIM; d++)
+    CHECK(grad1[d] == ValueApprox(grad0[d]));
+
+  // values only
+  CHECK(dets[0]->ratio(elec, 0) == ValueApprox(ratio0));
+  CHECK(cache->getNumHits() == 2);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,233 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "OhmmsData/Libxml2Doc.h"
+#include "Particle/ParticleSet.h"
+#include "QMCWaveFunctions/Fermion/SlaterDetWithBackflow.h"
+#include "QMCWaveFunctions/Fermion/Backflow_ee.h"
+#include "QMCWaveFunctions/Jastrow/BsplineFunctor.h"
+
+namespace qmcplusplus
+{
+using RealType     = QMCTraits::RealType;
+using PosType      = QMCTraits::PosType;
+using PsiValueType = WaveFunctionComponent::PsiValueType;
+using GradType     = WaveFunctionComponent::GradType;
+
+/** analytic orbitals exp(-alpha_k |r-c_k|^2) providing the hessians needed by backflow
+ */
+class GaussianSPO : public SPOSet
+{
+public:
+  GaussianSPO(int norb)
+  {
+    OrbitalSetSize = norb;
+    for (int k = 0; k < norb; k++)
+    {
+      centers_.push_back(PosType(0.3 * k, 0.1 - 0.2 * k, 0.15 * k * k - 0.2));
+      alphas_.push_back(0.4 + 0.13 * k);
+    }
+  }
+
+  std::unique_ptr<SPOSet> makeClone() const override { return std::make_unique<GaussianSPO>(*this); }
+  void resetParameters(const opt_variables_type& optVariables) override {}
+  void setOrbitalSetSize(int norbs) override {}
+
+  void evaluateValue(const ParticleSet& P, int iat, ValueVector& psi) override
+  {
+    GradType g;
+    HessType h;
+    for (int k = 0; k < OrbitalSetSize; k++)
+      evaluateOrbital(P.activeR(iat), k, psi[k], g, h);
+  }
+
+  void evaluateVGL(const ParticleSet& P, int iat, ValueVector& psi, GradVector& dpsi, ValueVector& d2psi) override
+  {
+    HessType h;
+    for (int k = 0; k < OrbitalSetSize; k++)
+    {
+      evaluateOrbital(P.activeR(iat), k, psi[k], dpsi[k], h);
+      d2psi[k] = trace(h);
+    }
+  }
+
+  void evaluate_notranspose(const ParticleSet& P,
+                            int first,
+                            int last,
+                            ValueMatrix& logdet,
+                            GradMatrix& dlogdet,
+                            ValueMatrix& d2logdet) override
+  {
+    HessType h;
+    for (int i = first; i < last; i++)
+      for (int k = 0; k < OrbitalSetSize; k++)
+      {
+        evaluateOrbital(P.R[i], k, logdet(i - first, k), dlogdet(i - first, k), h);
+        d2logdet(i - first, k) = trace(h);
+      }
+  }
+
+  void evaluate_notranspose(const ParticleSet& P,
+                            int first,
+                            int last,
+                            ValueMatrix& logdet,
+                            GradMatrix& dlogdet,
+                            HessMatrix& grad_grad_logdet) override
+  {
+    for (int i = first; i < last; i++)
+      for (int k = 0; k < OrbitalSetSize; k++)
+        evaluateOrbital(P.R[i], k, logdet(i - first, k), dlogdet(i - first, k), grad_grad_logdet(i - first, k));
+  }
+
+private:
+  std::vector<PosType> centers_;
+  std::vector<RealType> alphas_;
+
+  void evaluateOrbital(const PosType& r, int k, ValueType& v, GradType& g, HessType& h) const
+  {
+    const PosType d    = r - centers_[k];
+    const RealType a   = alphas_[k];
+    const RealType val = std::exp(-a * dot(d, d));
+    v                  = val;
+    for (int i = 0; i < OHMMS_DIM; i++)
+    {
+      g[i] = -2 * a * d[i] * val;
+      for (int j = 0; j < OHMMS_DIM; j++)
+        h(i, j) = (4 * a * a * d[i] * d[j] - (i == j ? 2 * a : 0)) * val;
+    }
+  }
+};
+
+TEST_CASE("SlaterDetWithBackflow mw APIs", "[wavefunction][fermion]")
+{
+  const SimulationCell simulation_cell;
+  ParticleSet elec(simulation_cell);
+  elec.setName("e");
+  elec.create({3, 3});
+  for (int i = 0; i < elec.getTotalNum(); i++)
+    elec.R[i] = PosType(0.2 * i - 0.5, 0.37 * ((i * 7) % 5) - 0.6, 0.11 * i * i - 0.9);
+  SpeciesSet& tspecies         = elec.getSpeciesSet();
+  int upIdx                    = tspecies.addSpecies("u");
+  int downIdx                  = tspecies.addSpecies("d");
+  int chargeIdx                = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx)   = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  elec.resetGroups();
+
+  const char* xml = "<correlation size=\"5\" rcut=\"3.0\"> \
+  <coefficients id=\"eta\" type=\"Array\"> 0.2 0.15 0.1 0.05 0.02 </coefficients> \
+</correlation>";
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(xml));
+
+  // e-e backflow shared by all the spin pairs
+  auto bf            = std::make_unique<BackflowTransformation>(elec);
+  auto bf_ee         = std::make_unique<Backflow_ee<BsplineFunctor<RealType>>>(elec, elec);
+  auto eta           = std::make_unique<BsplineFunctor<RealType>>();
+  eta->cutoff_radius = 3.0;
+  eta->put(doc.getRoot());
+  bf_ee->numParams += eta->NumParams;
+  bf_ee->addFunc(0, 0, std::move(eta));
+  bf_ee->derivs.resize(bf_ee->numParams);
+  bf->bfFuns.push_back(std::move(bf_ee));
+  bf->cutOff = 3.0;
+  elec.update();
+
+  std::vector<std::unique_ptr<DiracDeterminantWithBackflow>> dets;
+  dets.push_back(std::make_unique<DiracDeterminantWithBackflow>(std::make_unique<GaussianSPO>(3), *bf, 0, 3));
+  dets.push_back(std::make_unique<DiracDeterminantWithBackflow>(std::make_unique<GaussianSPO>(3), *bf, 3, 6));
+  SlaterDetWithBackflow slater(elec, std::move(dets), std::move(bf));
+
+  // every walker has a batched copy and a reference copy driven by the single walker API
+  const int nw  = 3;
+  const int nel = elec.getTotalNum();
+  std::vector<std::unique_ptr<ParticleSet>> elecs;
+  std::vector<std::unique_ptr<WaveFunctionComponent>> batched, reference;
+  std::vector<WaveFunctionComponent::WFBufferType> buffers(2 * nw);
+  for (int iw = 0; iw < nw; iw++)
+  {
+    elecs.push_back(std::make_unique<ParticleSet>(elec));
+    elecs[iw]->R[1][0] += 0.1 * iw;
+    elecs[iw]->update();
+    batched.push_back(slater.makeClone(*elecs[iw]));
+    reference.push_back(slater.makeClone(*elecs[iw]));
+    batched[iw]->registerData(*elecs[iw], buffers[iw]);
+    reference[iw]->registerData(*elecs[iw], buffers[nw + iw]);
+  }
+
+  RefVectorWithLeader<WaveFunctionComponent> wfc_list(*batched[0]);
+  RefVectorWithLeader<ParticleSet> p_list(*elecs[0]);
+  std::vector<ParticleSet::ParticleGradient> G(nw), G_ref(nw);
+  std::vector<ParticleSet::ParticleLaplacian> L(nw), L_ref(nw);
+  RefVector<ParticleSet::ParticleGradient> G_list;
+  RefVector<ParticleSet::ParticleLaplacian> L_list;
+  for (int iw = 0; iw < nw; iw++)
+  {
+    wfc_list.push_back(*batched[iw]);
+    p_list.push_back(*elecs[iw]);
+    G[iw].resize(nel);
+    L[iw].resize(nel);
+    G_ref[iw].resize(nel);
+    L_ref[iw].resize(nel);
+    G[iw]     = GradType();
+    L[iw]     = 0;
+    G_ref[iw] = GradType();
+    L_ref[iw] = 0;
+    G_list.push_back(G[iw]);
+    L_list.push_back(L[iw]);
+  }
+
+  slater.mw_evaluateLog(wfc_list, p_list, G_list, L_list);
+  for (int iw = 0; iw < nw; iw++)
+  {
+    const auto log_ref = reference[iw]->evaluateLog(*elecs[iw], G_ref[iw], L_ref[iw]);
+    CHECK(batched[iw]->get_log_value() == ComplexApprox(log_ref));
+    for (int i = 0; i < nel; i++)
+    {
+      CHECK(ValueApprox(L[iw][i]) == L_ref[iw][i]);
+      for (int d = 0; d < OHMMS_DIM; d++)
+        CHECK(ValueApprox(G[iw][i][d]) == G_ref[iw][i][d]);
+    }
+  }
+
+  for (int iat : {0, 4})
+  {
+    for (int iw = 0; iw < nw; iw++)
+      elecs[iw]->makeMove(iat, PosType(0.05, -0.03 * iw, 0.02));
+
+    std::vector<PsiValueType> ratios(nw);
+    slater.mw_calcRatio(wfc_list, p_list, iat, ratios);
+    for (int iw = 0; iw < nw; iw++)
+      CHECK(ValueApprox(ratios[iw]) == reference[iw]->ratio(*elecs[iw], iat));
+
+    std::vector<GradType> grads(nw);
+    slater.mw_ratioGrad(wfc_list, p_list, iat, ratios, grads);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      GradType grad_ref;
+      CHECK(ValueApprox(ratios[iw]) == reference[iw]->ratioGrad(*elecs[iw], iat, grad_ref));
+      for (int d = 0; d < OHMMS_DIM; d++)
+        CHECK(ValueApprox(grads[iw][d]) == grad_ref[d]);
+    }
+
+    for (int iw = 0; iw < nw; iw++)
+    {
+      batched[iw]->acceptMove(*elecs[iw], iat);
+      reference[iw]->acceptMove(*elecs[iw], iat);
+      elecs[iw]->acceptMove(iat);
+    }
+  }
+}
+
+} // namespace qmcplusplus
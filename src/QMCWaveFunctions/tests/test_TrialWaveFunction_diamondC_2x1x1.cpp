@@ -532,6 +532,29 @@ void testTrialWaveFunction_diamondC_2x1x1(const int ndelay)
   CHECK(ValueApprox(nlpp2_ratios[0]).epsilon(ratio_precision) == ValueType(-0.3505144708));
   CHECK(ValueApprox(nlpp2_ratios[1]).epsilon(ratio_precision) == ValueType(-3.350712448));
   CHECK(ValueApprox(nlpp2_ratios[2]).epsilon(ratio_precision) == ValueType(-2.0885822923));
+
+  // place the virtual particles on the quadrature spheres around the ions
+  std::vector<PosType> rot_grid1{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+  std::vector<PosType> rot_grid2{{0, -1, 0}, {0, 0, -1}, {-1, 0, 0}};
+  std::vector<PosType> sphere_deltaV1(nknot), sphere_deltaV2(nknot);
+  VirtualParticleSet::mw_makeMovesOnSphere(vp_list, {rot_grid1, rot_grid2}, {sphere_deltaV1, sphere_deltaV2},
+                                           {job1, job2});
+  CHECK(vp.isOnSphere());
+  CHECK(vp_clone.isOnSphere());
+  CHECK(vp.refSourcePtcl == 1);
+  CHECK(vp_clone.refSourcePtcl == 3);
+  for (int k = 0; k < nknot; k++)
+    for (int d = 0; d < OHMMS_DIM; d++)
+    {
+      CHECK(sphere_deltaV1[k][d] == Approx(job1.ion_elec_dist * rot_grid1[k][d] - job1.ion_elec_displ[d]));
+      CHECK(sphere_deltaV2[k][d] == Approx(job2.ion_elec_dist * rot_grid2[k][d] - job2.ion_elec_displ[d]));
+      CHECK(vp.R[k][d] == Approx(job1.elec_pos[d] + sphere_deltaV1[k][d]));
+      CHECK(vp_clone.R[k][d] == Approx(job2.elec_pos[d] + sphere_deltaV2[k][d]));
+    }
+  // the virtual particles are at the distance of the electrons from the reference ions
+  const auto& vp_ei_table = vp.getDistTableAB(ei_table_index);
+  for (int k = 0; k < nknot; k++)
+    CHECK(vp_ei_table.getDistances()[k][1] == Approx(job1.ion_elec_dist));
 #endif // QMC_CUDA
 }
 
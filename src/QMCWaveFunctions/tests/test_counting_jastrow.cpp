@@ -15,6 +15,7 @@
 #include "OhmmsData/Libxml2Doc.h"
 #include "Particle/ParticleSet.h"
 #include "VariableSet.h"
+#include "type_traits/RefVectorWithLeader.h"
 
 #include "QMCWaveFunctions/Jastrow/CountingGaussian.h"
 #include "QMCWaveFunctions/Jastrow/CountingGaussianRegion.h"
@@ -305,6 +306,60 @@ TEST_CASE("CountingJastrow","[wavefunction]")
     cj->acceptMove(elec, iat);
   }
 
+  // test batched APIs against single walker APIs, walkers at different positions
+  ParticleSet elec2(elec);
+  elec2.R[0][0] += 0.3;
+  cj->evaluateLog(elec, elec.G, elec.L);
+  auto cj_clone = cj->makeClone(elec2);
+  cj_clone->evaluateLog(elec2, elec2.G, elec2.L);
+  RefVectorWithLeader<WaveFunctionComponent> wfc_list(*cj, {*cj, *cj_clone});
+  RefVectorWithLeader<ParticleSet> p_list(elec, {elec, elec2});
+  for (int iat = 0; iat < num_els; ++iat)
+  {
+    elec.makeMove(iat, dr[iat]);
+    elec2.makeMove(iat, dr[iat]);
+    std::vector<WaveFunctionComponent::PsiValueType> ratios(2), ratios_grad(2);
+    std::vector<GradType> grads_new(2, GradType(0));
+    cj->mw_calcRatio(wfc_list, p_list, iat, ratios);
+    cj->mw_ratioGrad(wfc_list, p_list, iat, ratios_grad, grads_new);
+    for (int iw = 0; iw < 2; iw++)
+    {
+      GradType grad_ref(0, 0, 0);
+      RealType ratio_ref = std::real(wfc_list[iw].ratioGrad(p_list[iw], iat, grad_ref));
+      CHECK(ratio_ref == Approx(std::real(ratios[iw])));
+      CHECK(ratio_ref == Approx(std::real(ratios_grad[iw])));
+      for (int k = 0; k < 3; ++k)
+        CHECK(std::real(grad_ref[k]) == Approx(std::real(grads_new[iw][k])));
+    }
+    cj->mw_accept_rejectMove(wfc_list, p_list, iat, {true, false});
+    elec.acceptMove(iat);
+    elec2.rejectMove(iat);
+  }
+  std::vector<GradType> grads_now(2);
+  cj->mw_evalGrad(wfc_list, p_list, 1, grads_now);
+  for (int iw = 0; iw < 2; iw++)
+    for (int k = 0; k < 3; ++k)
+      CHECK(std::real(grads_now[iw][k]) == Approx(std::real(wfc_list[iw].evalGrad(p_list[iw], 1)[k])));
+  // incrementally updated gradients and laplacians agree with those from scratch
+  for (int iw = 0; iw < 2; iw++)
+  {
+    ParticleSet& p = p_list[iw];
+    ParticleSet::ParticleGradient G_updated(num_els);
+    ParticleSet::ParticleLaplacian L_updated(num_els);
+    G_updated = 0;
+    L_updated = 0;
+    const RealType log_updated = std::real(wfc_list[iw].evaluateGL(p, G_updated, L_updated, false));
+    p.G = 0;
+    p.L = 0;
+    CHECK(log_updated == Approx(std::real(wfc_list[iw].evaluateLog(p, p.G, p.L))));
+    for (int iat = 0; iat < num_els; ++iat)
+    {
+      for (int k = 0; k < 3; ++k)
+        CHECK(std::real(G_updated[iat][k]) == Approx(std::real(p.G[iat][k])));
+      CHECK(std::real(L_updated[iat]) == Approx(std::real(p.L[iat])));
+    }
+  }
+
 #ifndef QMC_COMPLEX
   // setup and reference for evaluateDerivatives
   PosType R2[] = { PosType( 4.3280064837, 2.4657709845,  6.3466520181e-01),
@@ -331,6 +331,52 @@ TEST_CASE("DiracMatrix_inverse_complex", "[wavefunction][fermion]")
 }
 
 
+TEST_CASE("DiracMatrix_inverse_refined", "[wavefunction][fermion]")
+{
+  const int n = 16;
+  Matrix<double> a(n, n), a_inv(n, n), a_inv_ref(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      a(i, j) = 1.0 / (i + 2 * j + 1) + std::sin(0.3 * i * j) + (i == j ? 2.0 : 0.0);
+
+  DiracMatrix<double> dm_ref;
+  LogValueType log_ref;
+  dm_ref.invert_transpose(a, a_inv_ref, log_ref);
+
+  DiracMatrix<double> dm;
+  LogValueType log_value;
+  dm.setRefinementSteps(2);
+  dm.invert_transpose(a, a_inv, log_value);
+  // the log value comes from the single precision LU
+  CHECK(log_value == LogComplexApprox(log_ref));
+
+  double max_error = 0.0;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      max_error = std::max(max_error, std::abs(a_inv(i, j) - a_inv_ref(i, j)));
+  CHECK(max_error < 1e-12);
+
+  // complex matrix
+  Matrix<std::complex<double>> c(n, n), c_inv(n, n), c_inv_ref(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      c(i, j) = {a(i, j), std::cos(0.7 * i + 0.2 * j)};
+
+  DiracMatrix<std::complex<double>> dmc_ref;
+  dmc_ref.invert_transpose(c, c_inv_ref, log_ref);
+
+  DiracMatrix<std::complex<double>> dmc;
+  dmc.setRefinementSteps(2);
+  dmc.invert_transpose(c, c_inv, log_value);
+  CHECK(log_value == LogComplexApprox(log_ref));
+
+  max_error = 0.0;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      max_error = std::max(max_error, std::abs(c_inv(i, j) - c_inv_ref(i, j)));
+  CHECK(max_error < 1e-12);
+}
+
 TEST_CASE("DiracMatrix_update_row", "[wavefunction][fermion]")
 {
   DiracMatrix<ValueType> dm;
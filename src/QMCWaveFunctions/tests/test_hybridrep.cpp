@@ -152,6 +152,43 @@ TEST_CASE("Hybridrep SPO from HDF diamond_1x1x1", "[wavefunction]")
   REQUIRE(std::real(d2psiM[1][0]) == Approx(1.3313053846));
   REQUIRE(std::real(d2psiM[1][1]) == Approx(-4.712583065));
 #endif
+
+  // test batched interfaces
+  // electron 0 of the first walker is in an atomic region, the one of the second walker is in the interstitial region
+  ParticleSet elec_2(elec_);
+  // interchange positions
+  elec_2.R[0] = elec_.R[1];
+  elec_2.R[1] = elec_.R[0];
+  elec_2.update();
+  RefVectorWithLeader<ParticleSet> p_list(elec_);
+  p_list.push_back(elec_);
+  p_list.push_back(elec_2);
+
+  std::unique_ptr<SPOSet> spo_2(spo->makeClone());
+  RefVectorWithLeader<SPOSet> spo_list(*spo);
+  spo_list.push_back(*spo);
+  spo_list.push_back(*spo_2);
+
+  SPOSet::ValueVector psi(spo->getOrbitalSetSize());
+  SPOSet::GradVector dpsi(spo->getOrbitalSetSize());
+  SPOSet::ValueVector d2psi(spo->getOrbitalSetSize());
+  SPOSet::ValueVector psi_2(spo->getOrbitalSetSize());
+  SPOSet::GradVector dpsi_2(spo->getOrbitalSetSize());
+  SPOSet::ValueVector d2psi_2(spo->getOrbitalSetSize());
+
+  RefVector<SPOSet::ValueVector> psi_v_list{psi, psi_2};
+  RefVector<SPOSet::GradVector> dpsi_v_list{dpsi, dpsi_2};
+  RefVector<SPOSet::ValueVector> d2psi_v_list{d2psi, d2psi_2};
+
+  spo->mw_evaluateVGL(spo_list, p_list, 0, psi_v_list, dpsi_v_list, d2psi_v_list);
+  for (int iw = 0; iw < 2; iw++)
+    for (int iorb = 0; iorb < spo->getOrbitalSetSize(); iorb++)
+    {
+      CHECK(psi_v_list[iw].get()[iorb] == ValueApprox(psiM[iw][iorb]));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        CHECK(dpsi_v_list[iw].get()[iorb][idim] == ValueApprox(dpsiM[iw][iorb][idim]));
+      CHECK(d2psi_v_list[iw].get()[iorb] == ValueApprox(d2psiM[iw][iorb]));
+    }
 }
 
 TEST_CASE("Hybridrep SPO from HDF diamond_2x1x1", "[wavefunction]")
@@ -20,6 +20,7 @@
 #include "QMCWaveFunctions/Jastrow/kSpaceJastrow.h"
 #include "QMCWaveFunctions/Jastrow/kSpaceJastrowBuilder.h"
 #include "ParticleIO/ParticleLayoutIO.h"
+#include "type_traits/RefVectorWithLeader.h"
 
 #include <stdio.h>
 #include <string>
@@ -114,5 +115,66 @@ TEST_CASE("kspace jastrow", "[wavefunction]")
 
   double logpsi_real = std::real(jas->evaluateLog(elec_, elec_.G, elec_.L));
   REQUIRE(logpsi_real == Approx(-4.4088303951)); // !!!! value not checked
+
+  // a clone for batched APIs at a different configuration
+  ParticleSet elec2(elec_);
+  elec2.R[1][0] = 1.2;
+  elec2.update();
+  auto jas_clone = jas->makeClone(elec2);
+  jas_clone->evaluateLog(elec2, elec2.G, elec2.L);
+
+  using PosType = QMCTraits::PosType;
+  const PosType dr(0.3, -0.2, 0.15);
+  const int iat = 1;
+
+  // single walker move
+  elec_.makeMove(iat, dr);
+  using GradType = WaveFunctionComponent::GradType;
+  GradType grad_new(0);
+  const auto ratio_grad = jas->ratioGrad(elec_, iat, grad_new);
+  CHECK(std::real(jas->ratio(elec_, iat)) == Approx(std::real(ratio_grad)));
+  jas->acceptMove(elec_, iat);
+  elec_.acceptMove(iat);
+  // the gradient at the new position is the one after acceptance
+  GradType grad_after = jas->evalGrad(elec_, iat);
+  CHECK(grad_new[0] == Approx(grad_after[0]));
+  CHECK(grad_new[1] == Approx(grad_after[1]));
+  CHECK(grad_new[2] == Approx(grad_after[2]));
+  // log value is updated consistently
+  const double log_updated = std::real(jas->get_log_value());
+  elec_.G                  = 0;
+  elec_.L                  = 0;
+  CHECK(log_updated == Approx(std::real(jas->evaluateLog(elec_, elec_.G, elec_.L))));
+  CHECK(log_updated - logpsi_real == Approx(std::log(std::real(ratio_grad))));
+  CHECK(grad_after[0] == Approx(elec_.G[iat][0]));
+  CHECK(grad_after[1] == Approx(elec_.G[iat][1]));
+  CHECK(grad_after[2] == Approx(elec_.G[iat][2]));
+
+  // batched move, both walkers propose the same displacement
+  RefVectorWithLeader<WaveFunctionComponent> wfc_list(*jas, {*jas, *jas_clone});
+  RefVectorWithLeader<ParticleSet> p_list(elec_, {elec_, elec2});
+  const int jat = 0;
+  elec_.makeMove(jat, dr);
+  elec2.makeMove(jat, dr);
+  std::vector<WaveFunctionComponent::PsiValueType> ratios(2), ratios_grad(2);
+  std::vector<GradType> grads_new(2, GradType(0));
+  jas->mw_calcRatio(wfc_list, p_list, jat, ratios);
+  jas->mw_ratioGrad(wfc_list, p_list, jat, ratios_grad, grads_new);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    GradType grad_ref(0);
+    const auto ratio_ref = wfc_list[iw].ratioGrad(p_list[iw], jat, grad_ref);
+    CHECK(std::real(ratios[iw]) == Approx(std::real(ratio_ref)));
+    CHECK(std::real(ratios_grad[iw]) == Approx(std::real(ratio_ref)));
+    CHECK(grads_new[iw][0] == Approx(grad_ref[0]));
+    CHECK(grads_new[iw][1] == Approx(grad_ref[1]));
+    CHECK(grads_new[iw][2] == Approx(grad_ref[2]));
+  }
+  jas->mw_accept_rejectMove(wfc_list, p_list, jat, {true, false});
+  elec_.acceptMove(jat);
+  elec2.rejectMove(jat);
+  CHECK(std::real(jas->get_log_value()) == Approx(std::real(jas->evaluateLog(elec_, elec_.G, elec_.L))));
+  CHECK(std::real(jas_clone->get_log_value()) ==
+        Approx(std::real(jas_clone->evaluateLog(elec2, elec2.G, elec2.L))));
 }
 } // namespace qmcplusplus
@@ -69,4 +69,53 @@ TEST_CASE("MultiDiracDeterminantCalculator::evaluate-Small", "[wavefunction][fer
   REQUIRE(double_test.default_evaluate(12) == Approx(det_value_expect));
 }
 
+/** the allocation free determinant used by the offload kernels agrees with the host implementation.
+ */
+TEST_CASE("calcExcitedDeterminant", "[wavefunction][fermion][multidet]")
+{
+  const int nel  = 8;
+  const int norb = 12;
+  Matrix<double> dots(nel, norb);
+  for (int i = 0; i < nel; i++)
+    for (int j = 0; j < norb; j++)
+      dots(i, j) = std::sin(1.3 * i + 0.7 * j * j) + (i == j ? 2.0 : 0.0);
+
+  MultiDiracDeterminantCalculator<double> MDDC;
+  MDDC.resize(nel);
+  for (int n = 1; n <= MaxOffloadExcitationLevel; n++)
+  {
+    // i1,...,in replaced by a1,...,an, picked in a scrambled order
+    std::vector<int> excitation(2 * n);
+    for (int k = 0; k < n; k++)
+    {
+      excitation[k]     = (3 * k + 1) % nel;
+      excitation[n + k] = (5 * k + 2) % norb;
+    }
+    std::vector<int>::const_iterator it = excitation.begin();
+    CHECK(calcExcitedDeterminant(n, dots.data(), norb, excitation.data()) == Approx(MDDC.evaluate(dots, it, n)));
+  }
+  CHECK(calcExcitedDeterminant(0, dots.data(), norb, nullptr) == Approx(1.0));
+
+  Matrix<std::complex<double>> cdots(nel, norb);
+  for (int i = 0; i < nel; i++)
+    for (int j = 0; j < norb; j++)
+      cdots(i, j) = std::complex<double>(dots(i, j), std::cos(0.3 * i - 1.1 * j));
+  MultiDiracDeterminantCalculator<std::complex<double>> cMDDC;
+  cMDDC.resize(nel);
+  for (int n = 1; n <= MaxOffloadExcitationLevel; n++)
+  {
+    std::vector<int> excitation(2 * n);
+    for (int k = 0; k < n; k++)
+    {
+      excitation[k]     = (3 * k + 1) % nel;
+      excitation[n + k] = (5 * k + 2) % norb;
+    }
+    std::vector<int>::const_iterator it = excitation.begin();
+    const auto det_ref                  = cMDDC.evaluate(cdots, it, n);
+    const auto det                      = calcExcitedDeterminant(n, cdots.data(), norb, excitation.data());
+    CHECK(det.real() == Approx(det_ref.real()));
+    CHECK(det.imag() == Approx(det_ref.imag()));
+  }
+}
+
 } // namespace qmcplusplus
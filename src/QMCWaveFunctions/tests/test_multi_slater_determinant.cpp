@@ -322,6 +322,249 @@ TEST_CASE("LiH multi Slater dets precomputed_table_method", "[wavefunction]")
   test_LiH_msd(spo_xml_string1_new, "spo-up", 85, 105, true, true);
 }
 
+/** a screened expansion must agree with the expansion truncated when reading the determinant list
+ */
+TEST_CASE("LiH multi Slater dets screened", "[wavefunction]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  ParticleSetPool ptcl = ParticleSetPool(c);
+  auto ions_uptr       = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  auto elec_uptr       = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  ParticleSet& ions_(*ions_uptr);
+  ParticleSet& elec_(*elec_uptr);
+
+  ions_.setName("ion0");
+  ptcl.addParticleSet(std::move(ions_uptr));
+  ions_.create({1, 1});
+  ions_.R[0]           = {0.0, 0.0, 0.0};
+  ions_.R[1]           = {0.0, 0.0, 3.0139239693};
+  SpeciesSet& ispecies = ions_.getSpeciesSet();
+  ispecies.addSpecies("Li");
+  ispecies.addSpecies("H");
+
+  elec_.setName("elec");
+  ptcl.addParticleSet(std::move(elec_uptr));
+  elec_.create({2, 2});
+  elec_.R[0] = {0.5, 0.5, 0.5};
+  elec_.R[1] = {0.1, 0.1, 1.1};
+  elec_.R[2] = {-0.5, -0.5, -0.5};
+  elec_.R[3] = {-0.1, -0.1, 1.5};
+
+  SpeciesSet& tspecies       = elec_.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int downIdx                = tspecies.addSpecies("d");
+  int massIdx                = tspecies.addAttribute("mass");
+  tspecies(massIdx, upIdx)   = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+  elec_.resetGroups();
+
+  auto make_wf_xml = [](const std::string& msd_attribs, const std::string& cutoff) {
+    return "<wavefunction name=\"psi0\" target=\"e\"> \
+    <sposet_collection type=\"MolecularOrbital\" name=\"LCAOBSet\" source=\"ion0\" cuspCorrection=\"no\" href=\"LiH.orbs.h5\"> \
+      <basisset name=\"LCAOBSet\" key=\"GTO\" transform=\"yes\"> \
+        <grid type=\"log\" ri=\"1.e-6\" rf=\"1.e2\" npts=\"1001\"/> \
+      </basisset> \
+      <sposet basisset=\"LCAOBSet\" name=\"spo-up\" size=\"85\"> \
+        <occupation mode=\"ground\"/> \
+        <coefficient size=\"85\" spindataset=\"0\"/> \
+      </sposet> \
+      <sposet basisset=\"LCAOBSet\" name=\"spo-dn\" size=\"85\"> \
+        <occupation mode=\"ground\"/> \
+        <coefficient size=\"85\" spindataset=\"0\"/> \
+      </sposet> \
+    </sposet_collection> \
+    <determinantset> \
+      <multideterminant optimize=\"no\" spo_up=\"spo-up\" spo_dn=\"spo-dn\" " +
+        msd_attribs + "> \
+        <detlist size=\"1487\" type=\"DETS\" cutoff=\"" +
+        cutoff + "\" href=\"LiH.orbs.h5\"/> \
+      </multideterminant> \
+    </determinantset> \
+</wavefunction>";
+  };
+
+  for (const std::string algorithm : {"precomputed_table_method", "table_method"})
+  {
+    Libxml2Document doc_ref, doc_screened;
+    REQUIRE(doc_ref.parseFromString(make_wf_xml("algorithm=\"" + algorithm + "\"", "0.01")));
+    REQUIRE(doc_screened.parseFromString(
+        make_wf_xml("algorithm=\"" + algorithm + "\" screening_cutoff=\"0.01\" screening_check_period=\"1\"",
+                    "1e-20")));
+
+    WaveFunctionFactory wf_factory_ref("psi_ref", elec_, ptcl.getPool(), c);
+    wf_factory_ref.put(doc_ref.getRoot());
+    WaveFunctionFactory wf_factory_screened("psi_screened", elec_, ptcl.getPool(), c);
+    wf_factory_screened.put(doc_screened.getRoot());
+    auto& twf_ref(*wf_factory_ref.getTWF());
+    auto& twf_screened(*wf_factory_screened.getTWF());
+
+    ions_.update();
+    elec_.update();
+
+    twf_ref.evaluateLog(elec_);
+    const auto G_ref = elec_.G;
+    const auto L_ref = elec_.L;
+    twf_screened.evaluateLog(elec_);
+    CHECK(twf_screened.getLogPsi() == Approx(twf_ref.getLogPsi()));
+    CHECK(twf_screened.getPhase() == Approx(twf_ref.getPhase()));
+    for (int iel = 0; iel < elec_.getTotalNum(); iel++)
+    {
+      CHECK(elec_.G[iel][0] == ValueApprox(G_ref[iel][0]));
+      CHECK(elec_.G[iel][2] == ValueApprox(G_ref[iel][2]));
+      CHECK(elec_.L[iel] == ValueApprox(L_ref[iel]));
+    }
+
+    ParticleSet elec_clone(elec_);
+    elec_clone.update();
+    std::unique_ptr<TrialWaveFunction> twf_ref_clone(twf_ref.makeClone(elec_clone));
+    std::unique_ptr<TrialWaveFunction> twf_screened_clone(twf_screened.makeClone(elec_clone));
+
+    RefVectorWithLeader<ParticleSet> p_ref_list(elec_, {elec_, elec_clone});
+    RefVectorWithLeader<TrialWaveFunction> wf_ref_list(twf_ref, {twf_ref, *twf_ref_clone});
+    RefVectorWithLeader<TrialWaveFunction> wf_screened_list(twf_screened, {twf_screened, *twf_screened_clone});
+
+    ParticleSet::mw_update(p_ref_list);
+    TrialWaveFunction::mw_evaluateLog(wf_ref_list, p_ref_list);
+    TrialWaveFunction::mw_evaluateLog(wf_screened_list, p_ref_list);
+
+    std::vector<PosType> displ(2);
+    displ[0] = {0.1, 0.2, 0.3};
+    displ[1] = {-0.2, -0.3, 0.0};
+
+    for (int moved_elec_id : {1, 2})
+    {
+      std::vector<PsiValueType> ratios_ref(2), ratios_screened(2);
+      ParticleSet::mw_makeMove(p_ref_list, moved_elec_id, displ);
+      TrialWaveFunction::mw_calcRatio(wf_ref_list, p_ref_list, moved_elec_id, ratios_ref);
+      TrialWaveFunction::mw_calcRatio(wf_screened_list, p_ref_list, moved_elec_id, ratios_screened);
+      CHECK(ratios_screened[0] == ValueApprox(ratios_ref[0]));
+      CHECK(ratios_screened[1] == ValueApprox(ratios_ref[1]));
+
+      std::vector<GradType> grad_ref(2), grad_screened(2);
+      TrialWaveFunction::mw_calcRatioGrad(wf_ref_list, p_ref_list, moved_elec_id, ratios_ref, grad_ref);
+      TrialWaveFunction::mw_calcRatioGrad(wf_screened_list, p_ref_list, moved_elec_id, ratios_screened,
+                                          grad_screened);
+      CHECK(ratios_screened[0] == ValueApprox(ratios_ref[0]));
+      CHECK(grad_screened[1][0] == ValueApprox(grad_ref[1][0]));
+      CHECK(grad_screened[1][2] == ValueApprox(grad_ref[1][2]));
+
+      for (int iw = 0; iw < 2; iw++)
+        p_ref_list[iw].rejectMove(moved_elec_id);
+    }
+  }
+}
+
+#ifndef QMC_COMPLEX
+/** orbital rotation derivatives of a multideterminant wavefunction agree with finite differences
+ */
+TEST_CASE("LiH multi Slater dets orbital rotation derivatives", "[wavefunction]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  ParticleSetPool ptcl = ParticleSetPool(c);
+  auto ions_uptr       = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  auto elec_uptr       = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  ParticleSet& ions_(*ions_uptr);
+  ParticleSet& elec_(*elec_uptr);
+
+  ions_.setName("ion0");
+  ptcl.addParticleSet(std::move(ions_uptr));
+  ions_.create({1, 1});
+  ions_.R[0]           = {0.0, 0.0, 0.0};
+  ions_.R[1]           = {0.0, 0.0, 3.0139239693};
+  SpeciesSet& ispecies = ions_.getSpeciesSet();
+  ispecies.addSpecies("Li");
+  ispecies.addSpecies("H");
+
+  elec_.setName("elec");
+  ptcl.addParticleSet(std::move(elec_uptr));
+  elec_.create({2, 2});
+  elec_.R[0] = {0.5, 0.5, 0.5};
+  elec_.R[1] = {0.1, 0.1, 1.1};
+  elec_.R[2] = {-0.5, -0.5, -0.5};
+  elec_.R[3] = {-0.1, -0.1, 1.5};
+
+  SpeciesSet& tspecies       = elec_.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int downIdx                = tspecies.addSpecies("d");
+  int massIdx                = tspecies.addAttribute("mass");
+  tspecies(massIdx, upIdx)   = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+  elec_.resetGroups();
+
+  const char* wf_xml_string = "<wavefunction name=\"psi0\" target=\"e\"> \
+    <sposet_collection type=\"MolecularOrbital\" name=\"LCAOBSet\" source=\"ion0\" cuspCorrection=\"no\" href=\"LiH.orbs.h5\"> \
+      <basisset name=\"LCAOBSet\" key=\"GTO\" transform=\"yes\"> \
+        <grid type=\"log\" ri=\"1.e-6\" rf=\"1.e2\" npts=\"1001\"/> \
+      </basisset> \
+      <sposet basisset=\"LCAOBSet\" name=\"spo-up\" size=\"85\" optimize=\"yes\"> \
+        <occupation mode=\"ground\"/> \
+        <coefficient size=\"85\" spindataset=\"0\"/> \
+      </sposet> \
+      <sposet basisset=\"LCAOBSet\" name=\"spo-dn\" size=\"85\" optimize=\"yes\"> \
+        <occupation mode=\"ground\"/> \
+        <coefficient size=\"85\" spindataset=\"0\"/> \
+      </sposet> \
+    </sposet_collection> \
+    <determinantset> \
+      <multideterminant optimize=\"no\" spo_up=\"spo-up\" spo_dn=\"spo-dn\" algorithm=\"table_method\"> \
+        <detlist size=\"1487\" type=\"DETS\" cutoff=\"1e-20\" href=\"LiH.orbs.h5\"/> \
+      </multideterminant> \
+    </determinantset> \
+</wavefunction>";
+
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(wf_xml_string));
+  WaveFunctionFactory wf_factory("psi0", elec_, ptcl.getPool(), c);
+  wf_factory.put(doc.getRoot());
+  auto& twf(*wf_factory.getTWF());
+
+  ions_.update();
+  elec_.update();
+  twf.setMassTerm(elec_);
+
+  opt_variables_type active;
+  twf.checkInVariables(active);
+  active.removeInactive();
+  active.resetIndex();
+  twf.checkOutVariables(active);
+  const int nparam = active.size_of_active();
+  REQUIRE(nparam > 0);
+
+  // kinetic part of the local energy, the only part of H depending on the orbitals
+  auto kinetic = [&]() {
+    RealType ke = 0.0;
+    for (int iat = 0; iat < elec_.getTotalNum(); iat++)
+      ke -= 0.5 * (elec_.L[iat] + dot(elec_.G[iat], elec_.G[iat]));
+    return ke;
+  };
+
+  twf.evaluateLog(elec_);
+  std::vector<ValueType> dlogpsi(nparam), dhpsioverpsi(nparam);
+  twf.evaluateDerivatives(elec_, active, dlogpsi, dhpsioverpsi);
+
+  const RealType delta = 1e-4;
+  for (int ip : {0, 1, nparam / 3, nparam / 2, nparam - 1})
+  {
+    active[ip] = delta;
+    twf.resetParameters(active);
+    const RealType logpsi_plus = twf.evaluateLog(elec_);
+    const RealType ke_plus     = kinetic();
+    active[ip]                 = -delta;
+    twf.resetParameters(active);
+    const RealType logpsi_minus = twf.evaluateLog(elec_);
+    const RealType ke_minus     = kinetic();
+    active[ip]                  = 0.0;
+    twf.resetParameters(active);
+
+    INFO("parameter " << active.name(ip));
+    CHECK(std::real(dlogpsi[ip]) == Approx((logpsi_plus - logpsi_minus) / (2 * delta)).epsilon(1e-4).margin(1e-6));
+    CHECK(std::real(dhpsioverpsi[ip]) == Approx((ke_plus - ke_minus) / (2 * delta)).epsilon(1e-4).margin(1e-5));
+  }
+}
+#endif
+
 #ifdef QMC_COMPLEX
 void test_Bi_msd(const std::string& spo_xml_string,
                  const std::string& check_sponame,
@@ -482,6 +725,31 @@ TEST_CASE("Bi-spinor multi Slater dets", "[wavefunction]")
     </determinantset> \
 </wavefunction>";
   test_Bi_msd(spo_xml_string2_new, "myspo", 16, 123);
+
+  app_log() << "-----------------------------------------------------------------" << std::endl;
+  app_log() << "Bi using the table method with new optimization, CI expansion cached" << std::endl;
+  app_log() << "-----------------------------------------------------------------" << std::endl;
+  const char* spo_xml_string3_new = "<wavefunction name=\"psi0\" target=\"e\"> \
+    <sposet_builder name=\"spinorbuilder\" type=\"molecularorbital\" source=\"ion0\" transform=\"yes\" href=\"Bi.orbs.h5\" precision=\"double\"> \
+        <sposet name=\"myspo\" size=\"16\"> \
+            <occupation mode=\"ground\"/> \
+        </sposet> \
+    </sposet_builder> \
+    <determinantset> \
+        <multideterminant optimize=\"no\" spo_0=\"myspo\" algorithm=\"precomputed_table_method\"> \
+            <detlist size=\"4\" type=\"DETS\" nc0=\"0\" ne0=\"5\" nstates=\"16\" cutoff=\"1e-20\" cache=\"Bi.ci_cache.h5\"> \
+               <ci coeff=\" 0.8586\" occ0=\"1110110000000000\"/> \
+               <ci coeff=\"-0.2040\" occ0=\"1101110000000000\"/> \
+               <ci coeff=\" 0.4081\" occ0=\"1110101000000000\"/> \
+               <ci coeff=\"-0.2340\" occ0=\"1101101000000000\"/> \
+            </detlist> \
+        </multideterminant> \
+    </determinantset> \
+</wavefunction>";
+  std::remove("Bi.ci_cache.h5");
+  // the first build writes the cache, the second one reads it
+  test_Bi_msd(spo_xml_string3_new, "myspo", 16, 123);
+  test_Bi_msd(spo_xml_string3_new, "myspo", 16, 123);
 }
 #endif
 } // namespace qmcplusplus
@@ -120,4 +120,48 @@ TEST_CASE("MultiQuinticSpline", "[wavefunction][LCAO]")
   }
 }
 
+TEST_CASE("MultiQuinticSpline batched", "[wavefunction][LCAO]")
+{
+  auto agrid = std::make_unique<LogGrid<double>>();
+  agrid->set(.1, 1.0, 7);
+
+  const int num_splines = 3;
+  MultiQuinticSpline1D<double> m_spline;
+  m_spline.initialize(*agrid, num_splines);
+  for (int is = 0; is < num_splines; is++)
+  {
+    Vector<double> data(7);
+    for (int ig = 0; ig < data.size(); ig++)
+      data[ig] = std::cos(0.7 * ig + is) * (is + 1);
+    OneDimQuinticSpline<double> spline(agrid->makeClone());
+    spline.set(data);
+    spline.spline();
+    m_spline.add_spline(is, spline);
+  }
+
+  // more radii than a tile, including some below the grid
+  const int n     = MultiQuinticSpline1D<double>::BatchTile + 7;
+  const size_t ld = n + 1;
+  std::vector<double> r(n);
+  for (int k = 0; k < n; k++)
+    r[k] = 0.02 + 0.97 * k / n;
+  std::vector<double> u(num_splines * ld), du(num_splines * ld), d2u(num_splines * ld);
+  m_spline.evaluate_batch(n, r.data(), u.data(), du.data(), d2u.data(), ld);
+
+  double u_ref[num_splines], du_ref[num_splines], d2u_ref[num_splines];
+  for (int k = 0; k < n; k++)
+  {
+    m_spline.evaluate(r[k], u_ref, du_ref, d2u_ref);
+    for (int is = 0; is < num_splines; is++)
+    {
+      CHECK(u[is * ld + k] == Approx(u_ref[is]));
+      CHECK(du[is * ld + k] == Approx(du_ref[is]));
+      CHECK(d2u[is * ld + k] == Approx(d2u_ref[is]));
+    }
+  }
+
+  const double r_out = 1.5;
+  CHECK_THROWS_AS(m_spline.evaluate_batch(1, &r_out, u.data(), du.data(), d2u.data(), ld), std::domain_error);
+}
+
 } // namespace qmcplusplus
@@ -20,6 +20,10 @@
 #include "QMCWaveFunctions/Jastrow/JeeIOrbitalSoA.h"
 #include "QMCWaveFunctions/Jastrow/eeI_JastrowBuilder.h"
 #include "ParticleBase/ParticleAttribOps.h"
+#if defined(ENABLE_OFFLOAD)
+#include "QMCWaveFunctions/Jastrow/JeeIOMPTarget.h"
+#include "ResourceCollection.h"
+#endif
 
 
 #include <stdio.h>
@@ -188,5 +192,250 @@ TEST_CASE("PolynomialFunctor3D Jastrow", "[wavefunction]")
 
   REQUIRE(std::real(ratios2[0]) == Approx(1.0357541137));
   REQUIRE(std::real(ratios2[1]) == Approx(1.0257141422));
+
+  // batched APIs must agree with the single walker ones
+  ParticleSet elec2(elec_);
+  elec2.R[3] = {0.5, -0.4, 1.2};
+  elec2.update();
+  auto j3_clone = j3->makeClone(elec2);
+  j3_clone->evaluateLog(elec2, elec2.G, elec2.L);
+
+  RefVectorWithLeader<WaveFunctionComponent> wfc_list(*j3, {*j3, *j3_clone});
+  RefVectorWithLeader<ParticleSet> p_list(elec_, {elec_, elec2});
+
+  const int moved = 2;
+  elec_.makeMove(moved, newpos - elec_.R[moved]);
+  elec2.makeMove(moved, newpos - elec2.R[moved]);
+
+  std::vector<PsiValueType> mw_ratios(2), ratios_ref(2);
+  std::vector<WaveFunctionComponent::GradType> grad_new(2, 0), grad_ref(2, 0);
+  ratios_ref[0] = j3->ratioGrad(elec_, moved, grad_ref[0]);
+  ratios_ref[1] = j3_clone->ratioGrad(elec2, moved, grad_ref[1]);
+
+  j3->mw_calcRatio(wfc_list, p_list, moved, mw_ratios);
+  for (int iw = 0; iw < 2; iw++)
+    CHECK(ValueApprox(mw_ratios[iw]) == ratios_ref[iw]);
+
+  j3->mw_ratioGrad(wfc_list, p_list, moved, mw_ratios, grad_new);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    CHECK(ValueApprox(mw_ratios[iw]) == ratios_ref[iw]);
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      CHECK(ValueApprox(grad_new[iw][idim]) == grad_ref[iw][idim]);
+  }
+
+  std::vector<bool> isAccepted{true, false};
+  j3->mw_accept_rejectMove(wfc_list, p_list, moved, isAccepted);
+  elec_.acceptMove(moved);
+  elec2.rejectMove(moved);
+
+  const LogValueType log_updated  = j3->get_log_value();
+  const LogValueType log2_updated = j3_clone->get_log_value();
+  CHECK(std::real(log_updated) == Approx(std::real(j3->evaluateLog(elec_, elec_.G, elec_.L))));
+  CHECK(std::real(log2_updated) == Approx(std::real(j3_clone->evaluateLog(elec2, elec2.G, elec2.L))));
+}
+
+#if defined(ENABLE_OFFLOAD)
+TEST_CASE("JeeIOMPTarget", "[wavefunction]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  const SimulationCell simulation_cell;
+  ParticleSet ions_(simulation_cell, DynamicCoordinateKind::DC_POS_OFFLOAD);
+  ParticleSet elec_(simulation_cell, DynamicCoordinateKind::DC_POS_OFFLOAD);
+
+  ions_.setName("ion");
+  ions_.create({2});
+  ions_.R[0] = {2.0, 0.0, 0.0};
+  ions_.R[1] = {-2.0, 0.0, 0.0};
+  ions_.getSpeciesSet().addSpecies("O");
+  ions_.update();
+
+  elec_.setName("elec");
+  elec_.create({2, 2});
+  elec_.R[0] = {1.0, 0.0, 0.0};
+  elec_.R[1] = {0.0, 0.0, 0.0};
+  elec_.R[2] = {-1.0, 0.0, 0.0};
+  elec_.R[3] = {0.0, 0.0, 2.0};
+
+  SpeciesSet& target_species(elec_.getSpeciesSet());
+  int upIdx                          = target_species.addSpecies("u");
+  int downIdx                        = target_species.addSpecies("d");
+  int chargeIdx                      = target_species.addAttribute("charge");
+  target_species(chargeIdx, upIdx)   = -1;
+  target_species(chargeIdx, downIdx) = -1;
+
+  // rcut of 5 leaves some e-I pairs outside the cutoff
+  const char* particles = "<tmp> \
+    <jastrow name=\"J3\" type=\"eeI\" function=\"polynomial\" source=\"ion\" gpu=\"yes\"> \
+      <correlation ispecies=\"O\" especies=\"u\" isize=\"3\" esize=\"3\" rcut=\"5\"> \
+        <coefficients id=\"uuO\" type=\"Array\" optimize=\"yes\"> 8.227710241e-06 2.480817653e-06 -5.354068112e-06 -1.112644787e-05 -2.208006078e-06 5.213121933e-06 -1.537865869e-05 8.899030233e-06 6.257255156e-06 3.214580988e-06 -7.716743107e-06 -5.275682077e-06 -1.778457637e-06 7.926231121e-06 1.767406868e-06 5.451359059e-08 2.801423724e-06 4.577282736e-06 7.634608083e-06 -9.510673173e-07 -2.344131575e-06 -1.878777219e-06 3.937363358e-07 5.065353773e-07 5.086724869e-07 -1.358768154e-07</coefficients> \
+      </correlation> \
+      <correlation ispecies=\"O\" especies1=\"u\" especies2=\"d\" isize=\"3\" esize=\"3\" rcut=\"5\"> \
+        <coefficients id=\"udO\" type=\"Array\" optimize=\"yes\"> -6.939530224e-06 2.634169299e-05 4.046077477e-05 -8.002682388e-06 -5.396795988e-06 6.697370507e-06 5.433953051e-05 -6.336849668e-06 3.680471431e-05 -2.996059772e-05 1.99365828e-06 -3.222705626e-05 -8.091669063e-06 4.15738535e-06 4.843939112e-06 3.563650208e-07 3.786332474e-05 -1.418336941e-05 2.282691374e-05 1.29239286e-06 -4.93580873e-06 -3.052539228e-06 9.870288001e-08 1.844286407e-06 2.970561871e-07 -4.364303677e-08</coefficients> \
+      </correlation> \
+    </jastrow> \
+</tmp> \
+";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(particles);
+  REQUIRE(okay);
+
+  eeI_JastrowBuilder jastrow(c, elec_, ions_);
+  auto j3_uptr = jastrow.buildComponent(xmlFirstElementChild(doc.getRoot()));
+  auto* j3     = dynamic_cast<JeeIOMPTarget<PolynomialFunctor3D>*>(j3_uptr.get());
+  REQUIRE(j3 != nullptr);
+
+  ParticleSet elec2(elec_);
+  elec2.R[3] = {0.5, -0.4, 1.2};
+  auto j3_clone = j3->makeClone(elec2);
+
+  RefVectorWithLeader<WaveFunctionComponent> wfc_list(*j3, {*j3, *j3_clone});
+  RefVectorWithLeader<ParticleSet> p_list(elec_, {elec_, elec2});
+
+  ResourceCollection pset_res("test_pset_res");
+  ResourceCollection wfc_res("test_wfc_res");
+  elec_.createResource(pset_res);
+  j3->createResource(wfc_res);
+  ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, p_list);
+  ResourceCollectionTeamLock<WaveFunctionComponent> mw_wfc_lock(wfc_res, wfc_list);
+
+  ParticleSet::mw_update(p_list);
+  const RefVector<ParticleSet::ParticleGradient> G_list{elec_.G, elec2.G};
+  const RefVector<ParticleSet::ParticleLaplacian> L_list{elec_.L, elec2.L};
+  j3->mw_evaluateLog(wfc_list, p_list, G_list, L_list);
+
+  using PosType = QMCTraits::PosType;
+  const std::vector<std::vector<PosType>> moves{{{0.3, 0.2, 0.5}, {-0.4, 0.1, 0.2}},
+                                                {{-0.2, 0.6, -0.3}, {4.0, 0.5, 0.0}},
+                                                {{0.1, -0.3, 0.4}, {0.2, 0.3, -0.1}}};
+  const std::vector<std::vector<bool>> accepts{{true, false}, {true, true}, {false, true}};
+  for (int imove = 0; imove < moves.size(); imove++)
+  {
+    // move one electron of each group, the second move takes an electron out of the cutoff
+    const int moved = imove % 2 == 0 ? 1 : 2;
+    ParticleSet::mw_makeMove(p_list, moved, moves[imove]);
+
+    std::vector<PsiValueType> mw_ratios(2), ratios_ref(2);
+    std::vector<WaveFunctionComponent::GradType> grad_new(2, 0), grad_ref(2, 0);
+    ratios_ref[0] = j3->ratioGrad(elec_, moved, grad_ref[0]);
+    ratios_ref[1] = j3_clone->ratioGrad(elec2, moved, grad_ref[1]);
+
+    j3->mw_calcRatio(wfc_list, p_list, moved, mw_ratios);
+    for (int iw = 0; iw < 2; iw++)
+      CHECK(ValueApprox(mw_ratios[iw]) == ratios_ref[iw]);
+
+    j3->mw_ratioGrad(wfc_list, p_list, moved, mw_ratios, grad_new);
+    for (int iw = 0; iw < 2; iw++)
+    {
+      CHECK(ValueApprox(mw_ratios[iw]) == ratios_ref[iw]);
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        CHECK(ValueApprox(grad_new[iw][idim]) == grad_ref[iw][idim]);
+    }
+
+    j3->mw_accept_rejectMove(wfc_list, p_list, moved, accepts[imove]);
+    ParticleSet::mw_accept_rejectMove(p_list, moved, accepts[imove]);
+  }
+  ParticleSet::mw_donePbyP(p_list);
+
+  // the values updated on the device must agree with those computed from scratch
+  const LogValueType log_updated  = j3->get_log_value();
+  const LogValueType log2_updated = j3_clone->get_log_value();
+  for (auto* pset : {&elec_, &elec2})
+  {
+    pset->G = 0;
+    pset->L = 0;
+  }
+  j3->mw_evaluateGL(wfc_list, p_list, G_list, L_list, false);
+  const ParticleSet::ParticleGradient G_updated(elec_.G);
+  const ParticleSet::ParticleLaplacian L_updated(elec_.L);
+
+  elec_.update();
+  elec_.G = 0;
+  elec_.L = 0;
+  CHECK(std::real(log_updated) == Approx(std::real(j3->evaluateLog(elec_, elec_.G, elec_.L))));
+  for (int iel = 0; iel < elec_.getTotalNum(); iel++)
+  {
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      CHECK(ValueApprox(G_updated[iel][idim]) == elec_.G[iel][idim]);
+    CHECK(ValueApprox(L_updated[iel]) == elec_.L[iel]);
+  }
+  elec2.update();
+  CHECK(std::real(log2_updated) == Approx(std::real(j3_clone->evaluateLog(elec2, elec2.G, elec2.L))));
+}
+#endif
+
+TEST_CASE("PolynomialFunctor3D table", "[wavefunction]")
+{
+  const char* xml_exact = "<tmp> \
+      <correlation ispecies=\"O\" especies=\"u\" isize=\"3\" esize=\"3\" rcut=\"10\"> \
+        <coefficients id=\"uuO\" type=\"Array\"> 8.227710241e-06 2.480817653e-06 -5.354068112e-06 -1.112644787e-05 -2.208006078e-06 5.213121933e-06 -1.537865869e-05 8.899030233e-06 6.257255156e-06 3.214580988e-06 -7.716743107e-06 -5.275682077e-06 -1.778457637e-06 7.926231121e-06 1.767406868e-06 5.451359059e-08 2.801423724e-06 4.577282736e-06 7.634608083e-06 -9.510673173e-07 -2.344131575e-06 -1.878777219e-06 3.937363358e-07 5.065353773e-07 5.086724869e-07 -1.358768154e-07</coefficients> \
+      </correlation> \
+      <correlation ispecies=\"O\" especies=\"u\" isize=\"3\" esize=\"3\" rcut=\"10\" table_size=\"32\"> \
+        <coefficients id=\"uuO\" type=\"Array\"> 8.227710241e-06 2.480817653e-06 -5.354068112e-06 -1.112644787e-05 -2.208006078e-06 5.213121933e-06 -1.537865869e-05 8.899030233e-06 6.257255156e-06 3.214580988e-06 -7.716743107e-06 -5.275682077e-06 -1.778457637e-06 7.926231121e-06 1.767406868e-06 5.451359059e-08 2.801423724e-06 4.577282736e-06 7.634608083e-06 -9.510673173e-07 -2.344131575e-06 -1.878777219e-06 3.937363358e-07 5.065353773e-07 5.086724869e-07 -1.358768154e-07</coefficients> \
+      </correlation> \
+</tmp> \
+";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml_exact);
+  REQUIRE(okay);
+
+  xmlNodePtr root      = doc.getRoot();
+  xmlNodePtr cur_exact = xmlFirstElementChild(root);
+  xmlNodePtr cur_table = xmlNextElementSibling(cur_exact);
+
+  PolynomialFunctor3D functor_exact, functor_table;
+  functor_exact.put(cur_exact);
+  functor_table.put(cur_table);
+  CHECK(!functor_exact.table_);
+  CHECK(functor_table.table_);
+
+  using RealType       = PolynomialFunctor3D::real_type;
+  constexpr int Nptcl  = 4;
+  RealType r_12[Nptcl] = {0.3, 2.1, 5.7, 8.9};
+  RealType r_1I[Nptcl] = {0.4, 1.7, 3.1, 4.6};
+  RealType r_2I[Nptcl] = {0.2, 2.9, 4.2, 4.4};
+
+  for (int i = 0; i < Nptcl; i++)
+    CHECK(functor_table.evaluate(r_12[i], r_1I[i], r_2I[i]) ==
+          Approx(functor_exact.evaluate(r_12[i], r_1I[i], r_2I[i])).margin(1e-7));
+  CHECK(functor_table.evaluateV(Nptcl, r_12, r_1I, r_2I) ==
+        Approx(functor_exact.evaluateV(Nptcl, r_12, r_1I, r_2I)).margin(1e-7));
+
+  // the interpolation error of the derivatives is larger than that of the value
+  RealType val[2][Nptcl], grad0[2][Nptcl], grad1[2][Nptcl], grad2[2][Nptcl];
+  RealType hess00[2][Nptcl], hess11[2][Nptcl], hess22[2][Nptcl], hess01[2][Nptcl], hess02[2][Nptcl];
+  functor_exact.evaluateVGL(Nptcl, r_12, r_1I, r_2I, val[0], grad0[0], grad1[0], grad2[0], hess00[0], hess11[0],
+                            hess22[0], hess01[0], hess02[0]);
+  functor_table.evaluateVGL(Nptcl, r_12, r_1I, r_2I, val[1], grad0[1], grad1[1], grad2[1], hess00[1], hess11[1],
+                            hess22[1], hess01[1], hess02[1]);
+  for (int i = 0; i < Nptcl; i++)
+  {
+    CHECK(val[1][i] == Approx(val[0][i]).margin(1e-7));
+    CHECK(grad0[1][i] == Approx(grad0[0][i]).epsilon(5e-3).margin(1e-6));
+    CHECK(grad1[1][i] == Approx(grad1[0][i]).epsilon(5e-3).margin(1e-6));
+    CHECK(grad2[1][i] == Approx(grad2[0][i]).epsilon(5e-3).margin(1e-6));
+    CHECK(hess00[1][i] == Approx(hess00[0][i]).epsilon(2e-2).margin(1e-5));
+    CHECK(hess11[1][i] == Approx(hess11[0][i]).epsilon(2e-2).margin(1e-5));
+    CHECK(hess22[1][i] == Approx(hess22[0][i]).epsilon(2e-2).margin(1e-5));
+    CHECK(hess01[1][i] == Approx(hess01[0][i]).epsilon(2e-2).margin(1e-5));
+    CHECK(hess02[1][i] == Approx(hess02[0][i]).epsilon(2e-2).margin(1e-5));
+  }
+
+  // the copies share the table, a parameter update builds a new one once
+  PolynomialFunctor3D functor_copy(functor_table);
+  CHECK(functor_copy.table_ == functor_table.table_);
+  auto old_table = functor_table.table_;
+  for (auto* functor : {&functor_table, &functor_copy})
+  {
+    functor->Parameters[0] *= 1.1;
+    functor->reset();
+  }
+  CHECK(functor_table.table_ != old_table);
+  CHECK(functor_copy.table_ == functor_table.table_);
+  functor_exact.Parameters[0] *= 1.1;
+  functor_exact.reset();
+  CHECK(functor_table.evaluate(r_12[1], r_1I[1], r_2I[1]) ==
+        Approx(functor_exact.evaluate(r_12[1], r_1I[1], r_2I[1])).margin(1e-7));
 }
 } // namespace qmcplusplus
@@ -19,6 +19,8 @@
 #include "QMCWaveFunctions/Jastrow/RPAJastrow.h"
 #include "ParticleBase/ParticleAttribOps.h"
 #include "ParticleIO/ParticleLayoutIO.h"
+#include "type_traits/RefVectorWithLeader.h"
+#include "Utilities/ResourceCollection.h"
 
 
 #include <stdio.h>
@@ -117,5 +119,59 @@ TEST_CASE("RPA Jastrow", "[wavefunction]")
 
   double logpsi_real = std::real(jas->evaluateLog(elec_, elec_.G, elec_.L));
   REQUIRE(logpsi_real == Approx(-1.3327837613)); // note: number not validated
+
+  // a clone at a different configuration for batched APIs
+  ParticleSet elec2(elec_);
+  elec2.R[3][1] = 0.5;
+  elec2.update();
+  auto jas_clone = jas->makeClone(elec2);
+  jas_clone->evaluateLog(elec2, elec2.G, elec2.L);
+
+  using GradType     = WaveFunctionComponent::GradType;
+  using PsiValueType = WaveFunctionComponent::PsiValueType;
+
+  RefVectorWithLeader<WaveFunctionComponent> wfc_list(*jas, {*jas, *jas_clone});
+  RefVectorWithLeader<ParticleSet> p_list(elec_, {elec_, elec2});
+
+  ResourceCollection wfc_res("test_wfc_res");
+  jas->createResource(wfc_res);
+  ResourceCollectionTeamLock<WaveFunctionComponent> wfc_lock(wfc_res, wfc_list);
+
+  std::vector<GradType> grads_now(2);
+  jas->mw_evalGrad(wfc_list, p_list, 1, grads_now);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    const GradType grad_ref = wfc_list[iw].evalGrad(p_list[iw], 1);
+    CHECK(grads_now[iw][0] == Approx(grad_ref[0]));
+    CHECK(grads_now[iw][1] == Approx(grad_ref[1]));
+    CHECK(grads_now[iw][2] == Approx(grad_ref[2]));
+  }
+
+  const int iat = 1;
+  ParticleSet::SingleParticlePos dr(0.1, -0.2, 0.3);
+  elec_.makeMove(iat, dr);
+  elec2.makeMove(iat, dr);
+  std::vector<PsiValueType> ratios(2), ratios_grad(2);
+  std::vector<GradType> grads_new(2, GradType(0));
+  jas->mw_calcRatio(wfc_list, p_list, iat, ratios);
+  jas->mw_ratioGrad(wfc_list, p_list, iat, ratios_grad, grads_new);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    GradType grad_ref(0);
+    const PsiValueType ratio_ref = wfc_list[iw].ratioGrad(p_list[iw], iat, grad_ref);
+    CHECK(std::real(ratios[iw]) == Approx(std::real(ratio_ref)));
+    CHECK(std::real(ratios_grad[iw]) == Approx(std::real(ratio_ref)));
+    CHECK(grads_new[iw][0] == Approx(grad_ref[0]));
+    CHECK(grads_new[iw][1] == Approx(grad_ref[1]));
+    CHECK(grads_new[iw][2] == Approx(grad_ref[2]));
+  }
+
+  jas->mw_accept_rejectMove(wfc_list, p_list, iat, {true, false});
+  elec_.acceptMove(iat);
+  elec2.rejectMove(iat);
+  const double log_accepted = std::real(jas->get_log_value());
+  const double log_rejected = std::real(jas_clone->get_log_value());
+  CHECK(log_accepted == Approx(std::real(jas->evaluateLog(elec_, elec_.G, elec_.L))));
+  CHECK(log_rejected == Approx(std::real(jas_clone->evaluateLog(elec2, elec2.G, elec2.L))));
 }
 } // namespace qmcplusplus
@@ -22,6 +22,7 @@
 
 #include "QMCWaveFunctions/LCAO/LCAOrbitalSet.h"
 #include "QMCWaveFunctions/LCAO/CuspCorrection.h"
+#include "QMCWaveFunctions/LCAO/CuspCorrectionConstruction.h"
 
 #include "QMCWaveFunctions/SPOSetBuilderFactory.h"
 
@@ -62,6 +63,48 @@ TEST_CASE("readCuspInfo", "[wavefunction]")
 }
 
 
+TEST_CASE("CuspCache", "[wavefunction]")
+{
+  using RealType       = QMCTraits::RealType;
+  int num_center       = 3;
+  int orbital_set_size = 7;
+  Matrix<CuspCorrectionParameters> info(num_center, orbital_set_size);
+  bool okay = readCuspInfo("hcn_downdet.cuspInfo.xml", "downdet", orbital_set_size, info);
+  REQUIRE(okay);
+
+  // the cache is only checked for the shape of the radial orbitals on the cusp grid
+  Matrix<RealType> radial_orbitals(num_center * orbital_set_size, 1001);
+  for (int i = 0; i < radial_orbitals.size(); i++)
+    radial_orbitals.data()[i] = 0.001 * i;
+
+  saveCuspCache("hcn_downdet.cusp.h5", "downdet", info, radial_orbitals);
+
+  Matrix<CuspCorrectionParameters> info_read(num_center, orbital_set_size);
+  Matrix<RealType> radial_orbitals_read;
+  okay = readCuspCache("hcn_downdet.cusp.h5", "downdet", info_read, radial_orbitals_read);
+  REQUIRE(okay);
+
+  for (int ic = 0; ic < num_center; ic++)
+    for (int mo_idx = 0; mo_idx < orbital_set_size; mo_idx++)
+    {
+      CHECK(info_read(ic, mo_idx).redo == info(ic, mo_idx).redo);
+      CHECK(info_read(ic, mo_idx).C == Approx(info(ic, mo_idx).C));
+      CHECK(info_read(ic, mo_idx).sg == Approx(info(ic, mo_idx).sg));
+      CHECK(info_read(ic, mo_idx).Rc == Approx(info(ic, mo_idx).Rc));
+      for (int i = 0; i < 5; i++)
+        CHECK(info_read(ic, mo_idx).alpha[i] == Approx(info(ic, mo_idx).alpha[i]));
+    }
+
+  REQUIRE(radial_orbitals_read.rows() == radial_orbitals.rows());
+  REQUIRE(radial_orbitals_read.cols() == radial_orbitals.cols());
+  for (int i = 0; i < radial_orbitals.size(); i++)
+    CHECK(radial_orbitals_read.data()[i] == Approx(radial_orbitals.data()[i]));
+
+  // a cache of another sposet is rejected
+  okay = readCuspCache("hcn_downdet.cusp.h5", "updet", info_read, radial_orbitals_read);
+  CHECK(!okay);
+}
+
 TEST_CASE("applyCuspInfo", "[wavefunction]")
 {
   Communicate* c = OHMMS::Controller;
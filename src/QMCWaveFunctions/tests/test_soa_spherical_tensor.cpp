@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <cmath>
+#include <vector>
+#include "QMCWaveFunctions/LCAO/SoaSphericalTensor.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("SoA Spherical Tensor batched evaluation", "[wavefunction][LCAO]")
+{
+  // points on both sides of a tile boundary, including the poles and the origin
+  std::vector<double> x, y, z;
+  const int npts = SoaSphericalTensor<double>::BatchTile + 5;
+  for (int i = 0; i < npts; i++)
+  {
+    x.push_back(1.3 * std::cos(0.7 * i) - 0.1);
+    y.push_back(1.2 * std::sin(0.3 * i) + 0.05);
+    z.push_back(-0.5 + 0.03 * i);
+  }
+  x[3] = y[3] = 0.0;
+  x[4] = y[4] = 0.0;
+  z[4]        = -0.8;
+  x[5] = y[5] = z[5] = 0.0;
+
+  for (bool addsign : {false, true})
+    for (int lmax : {0, 1, 2, 5, 7})
+    {
+      SoaSphericalTensor<double> st(lmax, addsign);
+      const size_t ntot = st.size();
+      const size_t ld   = npts + 3;
+      std::vector<double> v(ntot * ld), gx(ntot * ld), gy(ntot * ld), gz(ntot * ld), v_only(ntot * ld);
+      std::vector<double> v_off(ntot * ld), gx_off(ntot * ld), gy_off(ntot * ld), gz_off(ntot * ld);
+      st.evaluateVGL_batch(npts, x.data(), y.data(), z.data(), v.data(), gx.data(), gy.data(), gz.data(), ld);
+      st.evaluateV_batch(npts, x.data(), y.data(), z.data(), v_only.data(), ld);
+      st.evaluateVGL_batch_offload(npts, x.data(), y.data(), z.data(), v_off.data(), gx_off.data(), gy_off.data(),
+                                   gz_off.data(), ld);
+
+      for (int i = 0; i < npts; i++)
+      {
+        st.evaluateVGL(x[i], y[i], z[i]);
+        for (size_t lm = 0; lm < ntot; lm++)
+        {
+          CHECK(v[lm * ld + i] == Approx(st[0][lm]).margin(1e-12));
+          CHECK(v_only[lm * ld + i] == Approx(st[0][lm]).margin(1e-12));
+          CHECK(gx[lm * ld + i] == Approx(st[1][lm]).margin(1e-12));
+          CHECK(gy[lm * ld + i] == Approx(st[2][lm]).margin(1e-12));
+          CHECK(gz[lm * ld + i] == Approx(st[3][lm]).margin(1e-12));
+          CHECK(v_off[lm * ld + i] == Approx(st[0][lm]).margin(1e-12));
+          CHECK(gx_off[lm * ld + i] == Approx(st[1][lm]).margin(1e-12));
+          CHECK(gy_off[lm * ld + i] == Approx(st[2][lm]).margin(1e-12));
+          CHECK(gz_off[lm * ld + i] == Approx(st[3][lm]).margin(1e-12));
+        }
+      }
+    }
+}
+
+} // namespace qmcplusplus
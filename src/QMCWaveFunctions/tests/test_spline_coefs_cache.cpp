@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "spline2/MultiBspline.hpp"
+#include "QMCWaveFunctions/BsplineFactory/SplineCoefsCache.h"
+#include <cstdio>
+
+namespace qmcplusplus
+{
+TEST_CASE("SplineCoefsCache round trip", "[wavefunction]")
+{
+  Ugrid grid[3];
+  BCtype_s bc[3];
+  for (int i = 0; i < 3; i++)
+  {
+    grid[i].start = 0.0;
+    grid[i].end   = 1.0;
+    grid[i].num   = 4 + i;
+    bc[i].lCode   = PERIODIC;
+    bc[i].rCode   = PERIODIC;
+    bc[i].lVal    = 0.0;
+    bc[i].rVal    = 0.0;
+  }
+  const int num_splines = getAlignedSize<float>(3);
+
+  MultiBspline<float> stored;
+  stored.create(grid, bc, num_splines);
+  auto* stored_spline = stored.getSplinePtr();
+  for (size_t i = 0; i < stored_spline->coefs_size; i++)
+    stored_spline->coefs[i] = 0.5f * i;
+
+  const std::string filename("spline_coefs_cache_test.coefs");
+  const std::uint64_t key = hashSplineCoefsKey("spline_coefs_cache_test");
+  CHECK(key != hashSplineCoefsKey("spline_coefs_cache_test "));
+  REQUIRE(writeSplineCoefsCache(filename, key, *stored_spline));
+
+  MultiBspline<float> restored;
+  restored.create(grid, bc, num_splines);
+  restored.flush_zero();
+  auto* restored_spline = restored.getSplinePtr();
+
+  // a different key leaves the table untouched
+  CHECK(!readSplineCoefsCache(filename, key + 1, *restored_spline));
+  CHECK(restored_spline->coefs[1] == 0.0f);
+
+  REQUIRE(readSplineCoefsCache(filename, key, *restored_spline));
+  for (size_t i = 0; i < restored_spline->coefs_size; i++)
+    CHECK(restored_spline->coefs[i] == stored_spline->coefs[i]);
+
+  // a table of a different layout is rejected
+  grid[2].num = 7;
+  MultiBspline<float> other;
+  other.create(grid, bc, num_splines);
+  CHECK(!readSplineCoefsCache(filename, key, *other.getSplinePtr()));
+
+  std::remove(filename.c_str());
+  CHECK(!readSplineCoefsCache(filename, key, *restored_spline));
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <cmath>
+#include "OhmmsSoA/VectorSoaContainer.h"
+#include "OhmmsPETE/OhmmsVector.h"
+#include "spline2/MultiBspline.hpp"
+#include "QMCWaveFunctions/BsplineFactory/SplineKPointImages.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("SplineKPointImages", "[wavefunction]")
+{
+  using PointType = TinyVector<double, 3>;
+  Ugrid grid[3];
+  BCtype_d bc[3];
+  for (int i = 0; i < 3; i++)
+  {
+    grid[i].start = 0.0;
+    grid[i].end   = 1.0;
+    grid[i].num   = 6;
+    bc[i].lCode   = PERIODIC;
+    bc[i].rCode   = PERIODIC;
+    bc[i].lVal    = 0.0;
+    bc[i].rVal    = 0.0;
+  }
+
+  // bands 0 and 2 are splined, 1 and 3 are their images by a 90 degree rotation
+  std::vector<Tensor<int, 3>> ops{Tensor<int, 3>(1, 0, 0, 0, 1, 0, 0, 0, 1), Tensor<int, 3>(0, -1, 0, 1, 0, 0, 0, 0, 1)};
+  std::vector<int> band_op{0, 1, 0, 1};
+  std::vector<int> band_source{0, 0, 2, 2};
+  std::vector<PointType> kpoints(4);
+  for (int i = 0; i < 4; i++)
+    kpoints[i] = PointType(i, 0, 0);
+  aligned_vector<int> band_index_map{0, 1, 2, 3};
+
+  SplineKPointImages<double> images;
+  CHECK(images.empty());
+  images.setBands(ops, band_op, band_source);
+  images.sortColumns(kpoints, band_index_map, 0);
+  REQUIRE(images.getNumSources() == 2);
+  CHECK(images.getSourceBands() == std::vector<int>{0, 2});
+  CHECK(band_index_map == aligned_vector<int>{0, 2, 1, 3});
+  CHECK(kpoints[1][0] == Approx(2.0));
+
+  MultiBspline<double> table;
+  table.create(grid, bc, getAlignedSize<double>(4));
+  auto* spline = table.getSplinePtr();
+  for (size_t i = 0; i < spline->coefs_size; i++)
+    spline->coefs[i] = std::sin(0.37 * i) + 0.1 * std::cos(1.3 * i);
+
+  const size_t npad = getAlignedSize<double>(8);
+  Vector<double, aligned_allocator<double>> v(npad), v_plus(npad), v_minus(npad), v_direct(npad);
+  VectorSoaContainer<double, 3> g(npad), g_plus(npad), g_minus(npad);
+  VectorSoaContainer<double, 6> h(npad), h_plus(npad), h_minus(npad);
+  VectorSoaContainer<double, 10> gh(npad);
+
+  const PointType ru(0.23, 0.71, 0.42);
+  images.evaluate_vghgh(spline, ru, v, g, h, gh, 0, npad);
+
+  // the sources are copied, the images are the sources at the rotated point
+  PointType ru_rot(1.0 - ru[1], ru[0], ru[2]);
+  spline2::evaluate3d(spline, ru, v_direct);
+  for (int k = 0; k < 4; k++)
+    CHECK(v[k] == Approx(v_direct[k]));
+  spline2::evaluate3d(spline, ru_rot, v_direct);
+  for (int k = 0; k < 4; k++)
+    CHECK(v[4 + k] == Approx(v_direct[k]));
+
+  // the derivatives of the images against finite differences
+  constexpr double delta = 1.0e-5;
+  constexpr int hidx[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+  constexpr int tidx[3][3][3] = {{{0, 1, 2}, {1, 3, 4}, {2, 4, 5}},
+                                 {{1, 3, 4}, {3, 6, 7}, {4, 7, 8}},
+                                 {{2, 4, 5}, {4, 7, 8}, {5, 8, 9}}};
+  for (int a = 0; a < 3; a++)
+  {
+    PointType ru_plus(ru), ru_minus(ru);
+    ru_plus[a] += delta;
+    ru_minus[a] -= delta;
+    images.evaluate_vgh(spline, ru_plus, v_plus, g_plus, h_plus, 0, npad);
+    images.evaluate_vgh(spline, ru_minus, v_minus, g_minus, h_minus, 0, npad);
+    for (int k = 0; k < 8; k++)
+    {
+      CHECK(g.data(a)[k] == Approx((v_plus[k] - v_minus[k]) / (2 * delta)).epsilon(1e-6));
+      for (int b = 0; b < 3; b++)
+      {
+        CHECK(h.data(hidx[a][b])[k] ==
+              Approx((g_plus.data(b)[k] - g_minus.data(b)[k]) / (2 * delta)).epsilon(1e-6).margin(1e-6));
+        for (int c = 0; c < 3; c++)
+          CHECK(gh.data(tidx[a][b][c])[k] ==
+                Approx((h_plus.data(hidx[b][c])[k] - h_minus.data(hidx[b][c])[k]) / (2 * delta))
+                    .epsilon(1e-5)
+                    .margin(1e-4));
+      }
+    }
+  }
+
+  // a thread range starting at the images only evaluates them
+  Vector<double, aligned_allocator<double>> v_part(npad, 0.0);
+  images.evaluate_v(spline, ru, v_part, 4, npad);
+  for (int k = 0; k < 4; k++)
+    CHECK(v_part[k] == 0.0);
+  for (int k = 4; k < 8; k++)
+    CHECK(v_part[k] == Approx(v[k]));
+}
+
+} // namespace qmcplusplus
@@ -16,6 +16,7 @@
 #include "Message/Communicate.h"
 #include "OhmmsData/Libxml2Doc.h"
 #include "QMCWaveFunctions/Jastrow/UserFunctor.h"
+#include <vector>
 
 namespace qmcplusplus
 {
@@ -122,4 +123,89 @@ TEST_CASE("UserJastrowFunctor", "[wavefunction]")
 
   // Could do finite differences to verify the parameter derivatives
 }
+
+TEST_CASE("UserJastrowFunctor multi-walker", "[wavefunction]")
+{
+  using RealType = OptimizableFunctorBase::real_type;
+  constexpr int DIM = OHMMS_DIM;
+
+  UserFunctor<RealType> uf;
+  uf.setCusp(1.0);
+  uf.B = 2.0;
+  const UserFunctor<RealType>* functors[] = {&uf};
+
+  static_assert(UserFunctor<RealType>::NUM_PACKED_PARAMS == 2, "A and B are packed");
+  RealType packed[UserFunctor<RealType>::NUM_PACKED_PARAMS];
+  uf.packParameters(packed);
+  RealType dudr, d2udr2, dudr_ref, d2udr2_ref;
+  CHECK(UserFunctor<RealType>::evaluate_impl(0.7, packed) == Approx(uf.evaluate(0.7)));
+  CHECK(UserFunctor<RealType>::evaluate_impl(0.7, packed, dudr, d2udr2) == Approx(uf.evaluate(0.7, dudr_ref, d2udr2_ref)));
+  CHECK(dudr == Approx(dudr_ref));
+  CHECK(d2udr2 == Approx(d2udr2_ref));
+
+  const int n_src = 4, n_padded = 8, nw = 2, iat = 1;
+  const int dist_stride = n_padded * (DIM + 1);
+  const std::vector<int> grp_ids(n_src, 0);
+  // [new, old][nw][1(distance)+DIM(displacements)][n_padded]
+  std::vector<RealType> mw_dist(2 * nw * dist_stride, 0.0);
+  for (int i = 0; i < 2 * nw; i++)
+    for (int j = 0; j < n_src; j++)
+    {
+      RealType* dist = mw_dist.data() + i * dist_stride;
+      dist[n_padded + j]     = 0.3 + 0.1 * i + 0.05 * j;
+      dist[n_padded * 2 + j] = -0.2 + 0.07 * j;
+      dist[n_padded * 3 + j] = 0.4 - 0.03 * i;
+      dist[j] = std::sqrt(dist[n_padded + j] * dist[n_padded + j] + dist[n_padded * 2 + j] * dist[n_padded * 2 + j] +
+                          dist[n_padded * 3 + j] * dist[n_padded * 3 + j]);
+    }
+
+  Vector<char, OffloadPinnedAllocator<char>> transfer_buffer;
+  std::vector<RealType> mw_vgl(nw * (DIM + 2));
+  std::vector<RealType> mw_cur_allu(nw * 3 * n_padded);
+  UserFunctor<RealType>::mw_evaluateVGL(iat, 1, functors, n_src, grp_ids.data(), nw, mw_vgl.data(), n_padded,
+                                        mw_dist.data(), mw_cur_allu.data(), transfer_buffer);
+
+  std::vector<RealType> mw_vals(nw);
+  const std::vector<int> ref_at(nw, iat);
+  UserFunctor<RealType>::mw_evaluateV(1, functors, n_src, grp_ids.data(), nw, ref_at.data(), mw_dist.data(), dist_stride,
+                                      mw_vals.data(), transfer_buffer);
+
+  for (int iw = 0; iw < nw; iw++)
+  {
+    const RealType* dist = mw_dist.data() + iw * dist_stride;
+    RealType val(0), lap(0);
+    TinyVector<RealType, DIM> grad;
+    for (int j = 0; j < n_src; j++)
+      if (j != iat)
+      {
+        val += uf.evaluate(dist[j], dudr, d2udr2);
+        dudr /= dist[j];
+        lap += d2udr2 + (DIM - 1) * dudr;
+        for (int idim = 0; idim < DIM; idim++)
+          grad[idim] += dudr * dist[n_padded * (idim + 1) + j];
+      }
+    CHECK(mw_vals[iw] == Approx(val));
+    CHECK(mw_vgl[iw * (DIM + 2)] == Approx(val));
+    for (int idim = 0; idim < DIM; idim++)
+      CHECK(mw_vgl[iw * (DIM + 2) + idim + 1] == Approx(grad[idim]));
+    CHECK(mw_vgl[iw * (DIM + 2) + DIM + 1] == Approx(-lap));
+  }
+
+  // Uat, dUat, d2Uat [nw][DIM+2][n_padded] start from zero, only the accepted walker is updated
+  std::vector<RealType> mw_allUat(nw * (DIM + 2) * n_padded, 0.0);
+  std::vector<RealType> mw_allUat_comp(mw_allUat.size(), 0.0);
+  UserFunctor<RealType>::mw_updateVGL(iat, {true, false}, 1, functors, n_src, grp_ids.data(), nw, mw_vgl.data(),
+                                      n_padded, mw_dist.data(), mw_allUat.data(), mw_allUat_comp.data(),
+                                      mw_cur_allu.data(), transfer_buffer);
+  const RealType* dist_new = mw_dist.data();
+  const RealType* dist_old = mw_dist.data() + nw * dist_stride;
+  for (int j = 0; j < n_src; j++)
+  {
+    if (j == iat)
+      CHECK(mw_allUat[j] == Approx(mw_vgl[0]));
+    else
+      CHECK(mw_allUat[j] == Approx(uf.evaluate(dist_new[j]) - uf.evaluate(dist_old[j])));
+    CHECK(mw_allUat[n_padded + j] == Approx(0.0));
+  }
+}
 } // namespace qmcplusplus
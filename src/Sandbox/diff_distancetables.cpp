@@ -12,11 +12,13 @@
 /** @file distancetables_soa.cpp
  *
  * Test code for the accuracy of AoS to SoA transformation of distance tables.
+ * It also times the orthorhombic minimum image kernel against the general cell kernel.
  */
 #include <Configuration.h>
 #include "Particle/ParticleSet.h"
 #include "ParticleBase/RandomSeqGenerator.h"
 #include "Particle/DistanceTable.h"
+#include "Particle/Lattice/ParticleBConds3DSoa.h"
 #include "OhmmsSoA/VectorSoaContainer.h"
 #include "random.hpp"
 #include "mpi/collectives.h"
@@ -169,6 +171,44 @@ int main(int argc, char** argv)
     cout << "Done with the sweep. Diffusion |els.R-R0|^2/nels = " << r_err / nels << endl;
   }
 
+  { // minimum image kernels applied to an orthorhombic cell with the lengths of the supercell vectors
+    LatticeType ortho;
+    ortho.BoxBConds = true;
+    TensorType ortho_R;
+    for (int idim = 0; idim < 3; ++idim)
+      ortho_R(idim, idim) = std::sqrt(dot(super_lattice.a(idim), super_lattice.a(idim)));
+    ortho.set(ortho_R);
+
+    const DTD_BConds<RealType, 3, PPPO + SOA_OFFSET> bc_ortho(ortho);
+    const DTD_BConds<RealType, 3, PPPG + SOA_OFFSET> bc_general(ortho);
+    const auto& Rsoa = els.getCoordinates().getAllParticlePos();
+    aligned_vector<RealType> r_ortho(nels), r_general(nels);
+    VectorSoaContainer<RealType, 3> dr_ortho(nels), dr_general(nels);
+
+    constexpr int nrepeat = 100;
+    double r_err          = 0.0;
+    Timer clock;
+    for (int irep = 0; irep < nrepeat; ++irep)
+      for (int iel = 0; iel < nels; ++iel)
+        bc_general.computeDistances(els.R[iel], Rsoa, r_general.data(), dr_general, 0, nels, iel);
+    t1 = clock.elapsed();
+    clock.restart();
+    for (int irep = 0; irep < nrepeat; ++irep)
+      for (int iel = 0; iel < nels; ++iel)
+        bc_ortho.computeDistances(els.R[iel], Rsoa, r_ortho.data(), dr_ortho, 0, nels, iel);
+    t0 = clock.elapsed();
+
+    for (int iel = 0; iel < nels; ++iel)
+    {
+      bc_general.computeDistances(els.R[iel], Rsoa, r_general.data(), dr_general, 0, nels, iel);
+      bc_ortho.computeDistances(els.R[iel], Rsoa, r_ortho.data(), dr_ortho, 0, nels, iel);
+      for (int jel = 0; jel < nels; ++jel)
+        r_err = std::max(r_err, static_cast<double>(std::abs(r_ortho[jel] - r_general[jel])));
+    }
+    cout << "Orthorhombic minimum image: general kernel " << t1 << " s, orthorhombic kernel " << t0
+         << " s, speedup = " << t1 / t0 << ", max |r_ortho-r_general| = " << r_err << endl;
+  }
+
   OHMMS::Controller->finalize();
 
   return 0;
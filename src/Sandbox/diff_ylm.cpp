@@ -11,6 +11,8 @@
 // -*- C++ -*-
 /** @file diff_ylm.cpp
  * @brief Check correctness of SoaSphericalTensor and CartesianTensor
+ *
+ * Also times the batched SoaSphericalTensor::evaluateVGL_batch against evaluateVGL point by point.
  */
 #include <Configuration.h>
 #include <random/random.hpp>
@@ -18,6 +20,7 @@
 #include "QMCWaveFunctions/LCAO/SoaCartesianTensor.h"
 #include "Numerics/SphericalTensor.h"
 #include "Numerics/CartesianTensor.h"
+#include "Utilities/Timer.h"
 #include <getopt.h>
 
 using namespace std;
@@ -49,14 +52,16 @@ int main(int argc, char** argv)
   int na       = 4;
   int lmax     = 4;
   int nsamples = 5;
+  int npts     = 1024;
+  int nrepeat  = 100;
   char* g_opt_arg;
   int opt;
-  while ((opt = getopt(argc, argv, "hl:s:")) != -1)
+  while ((opt = getopt(argc, argv, "hl:s:n:r:")) != -1)
   {
     switch (opt)
     {
     case 'h':
-      printf("[-l lmax -s samples]\n");
+      printf("[-l lmax -s samples -n points -r repeats]\n");
       return 1;
     case 'l':
       lmax = atoi(optarg);
@@ -64,6 +69,12 @@ int main(int argc, char** argv)
     case 's':
       nsamples = atoi(optarg);
       break;
+    case 'n':
+      npts = atoi(optarg);
+      break;
+    case 'r':
+      nrepeat = atoi(optarg);
+      break;
     }
   }
 
@@ -71,7 +82,7 @@ int main(int argc, char** argv)
   constexpr RealType small = std::numeric_limits<RealType>::epsilon();
 
   constexpr RealType shift(0.5);
-  TinyVector<double, 4> err;
+  TinyVector<double, 5> err;
 
   int ntot;
 
@@ -117,6 +128,52 @@ int main(int argc, char** argv)
   }
 
 
+  //Test and time the batched SoaSphericalTensor
+  {
+    SoaSphericalTensor<RealType> st(lmax);
+    const int nlm = st.size();
+    aligned_vector<RealType> x(npts), y(npts), z(npts);
+    for (int i = 0; i < npts; ++i)
+    {
+      x[i] = random() - shift;
+      y[i] = random() - shift;
+      z[i] = random() - shift;
+    }
+    const size_t ld = getAlignedSize<RealType>(npts);
+    aligned_vector<RealType> ylm(nlm * ld), ylm_x(nlm * ld), ylm_y(nlm * ld), ylm_z(nlm * ld);
+
+    Timer clock;
+    for (int irep = 0; irep < nrepeat; ++irep)
+      for (int i = 0; i < npts; ++i)
+        st.evaluateVGL(x[i], y[i], z[i]);
+    const double t_point = clock.elapsed();
+    clock.restart();
+    for (int irep = 0; irep < nrepeat; ++irep)
+      st.evaluateVGL_batch(npts, x.data(), y.data(), z.data(), ylm.data(), ylm_x.data(), ylm_y.data(), ylm_z.data(),
+                           ld);
+    const double t_batch = clock.elapsed();
+    clock.restart();
+    for (int irep = 0; irep < nrepeat; ++irep)
+      st.evaluateVGL_batch_offload(npts, x.data(), y.data(), z.data(), ylm.data(), ylm_x.data(), ylm_y.data(),
+                                   ylm_z.data(), ld);
+    const double t_offload = clock.elapsed();
+
+    for (int i = 0; i < npts; ++i)
+    {
+      st.evaluateVGL(x[i], y[i], z[i]);
+      for (int lm = 0; lm < nlm; ++lm)
+      {
+        PosType delta_grad(ylm_x[lm * ld + i] - st[1][lm], ylm_y[lm * ld + i] - st[2][lm],
+                           ylm_z[lm * ld + i] - st[3][lm]);
+        err[4] += std::abs(ylm[lm * ld + i] - st[0][lm]) + std::sqrt(dot(delta_grad, delta_grad));
+      }
+    }
+
+    cout << "SoaSphericalTensor evaluateVGL lmax " << lmax << " points " << npts << " repeats " << nrepeat << endl;
+    cout << "  per point " << t_point << " s, batched " << t_batch << " s (speedup " << t_point / t_batch
+         << "), offload " << t_offload << " s" << endl;
+  }
+
   //Test cartesian tensor
   if (lmax > 4)
     cout << "Skip Cartesian tensor tenor as lmax>4" << endl;
@@ -10,7 +10,11 @@
 //////////////////////////////////////////////////////////////////////////////////////
 // -*- C++ -*-
 /** @file restart.cpp
- * @brief developing restart IO
+ * @brief developing restart IO and benchmarking checkpoint and estimator IO
+ *
+ * After checking that the random seeds and the walkers are read back exactly, the walker checkpoints are written
+ * and read back with the collective, async and aggregated modes of HDFWalkerOutput, and synthetic estimator
+ * datasets are written reduced on the master or as one slab per rank. The bandwidths are reported per rank count.
  */
 
 #include <Configuration.h>
@@ -23,11 +27,14 @@
 #include "Sandbox/input.hpp"
 #include "Sandbox/pseudo.hpp"
 #include "Utilities/FairDivide.h"
+#include "hdf/hdf_archive.h"
 #include "Utilities/Timer.h"
 #include "Sandbox/common.hpp"
 #include <getopt.h>
 #include "mpi/collectives.h"
 #include "ParticleBase/ParticleAttribOps.h"
+#include <cstdio>
+#include <memory>
 
 using namespace std;
 using namespace qmcplusplus;
@@ -43,6 +50,230 @@ void setWalkerOffsets(MCWalkerConfiguration& W, Communicate* myComm)
   W.setWalkerOffsets(nwoff);
 }
 
+/// bytes written and read by a benchmark and the time it took on the slowest rank
+struct IOBandwidth
+{
+  double bytes       = 0.0;
+  double write_time  = 0.0;
+  double return_time = 0.0;
+  double read_time   = 0.0;
+  int mismatch_count = 0;
+};
+
+void printBandwidth(const std::string& name, int nranks, const IOBandwidth& bw)
+{
+  const double mb = bw.bytes / (1024.0 * 1024.0);
+  cout << "  " << setw(22) << left << name << right << setw(7) << nranks << setw(12) << fixed << setprecision(2) << mb
+       << setw(12) << mb / bw.write_time << setw(12) << mb / bw.return_time << setw(12) << mb / bw.read_time
+       << ((bw.mismatch_count == 0) ? "  Pass" : "  Fail") << "\n";
+}
+
+/** write the walkers with one mode of HDFWalkerOutput nrepeat times and read them back once
+ * @param mode collective, async or aggregated
+ *
+ * return_time is the average time for dump to return, write_time until the file is complete.
+ */
+IOBandwidth benchWalkers(MCWalkerConfiguration& W, Communicate* comm, const std::string& mode, int nrepeat)
+{
+  IOBandwidth bw;
+  Timer clock;
+  setWalkerOffsets(W, comm);
+  const std::string comm_name = comm->getName();
+  const std::string root      = "iobench.p" + std::to_string(comm->size()) + "." + mode;
+  comm->setName(root);
+
+  HDFWalkerOutput wOut(W.getTotalNum(), root, comm);
+  wOut.setAsync(mode == "async");
+  wOut.setAggregated(mode == "aggregated");
+  for (int i = 0; i < nrepeat; i++)
+  {
+    comm->barrier();
+    clock.restart();
+    wOut.dump(W, i);
+    bw.return_time += clock.elapsed();
+    wOut.waitForDump();
+    comm->barrier();
+    bw.write_time += clock.elapsed();
+  }
+  bw.write_time /= nrepeat;
+  bw.return_time /= nrepeat;
+  bw.bytes = static_cast<double>(W.getGlobalNumWalkers()) * W.getTotalNum() * OHMMS_DIM * sizeof(OHMMS_PRECISION);
+
+  std::vector<ParticleSet::ParticlePos> saved_R;
+  for (int wi = 0; wi < W.getActiveWalkers(); wi++)
+    saved_R.push_back(W[wi]->R);
+  W.destroyWalkers(W.begin(), W.end());
+
+  const std::string restart_input =
+      "<mcwalkerset fileroot=\"" + root + "\" node=\"-1\" version=\"3 0\" collected=\"yes\"/>";
+  Libxml2Document doc;
+  doc.parseFromString(restart_input);
+  HDFVersion in_version(0, 4);
+  HDFWalkerInput_0_4 wIn(W, W.getTotalNum(), comm, in_version);
+  comm->barrier();
+  clock.restart();
+  wIn.put(doc.getRoot());
+  comm->barrier();
+  bw.read_time = clock.elapsed();
+
+  if (saved_R.size() != W.getActiveWalkers())
+    bw.mismatch_count++;
+  else
+    for (int wi = 0; wi < saved_R.size(); wi++)
+    {
+      saved_R[wi] = saved_R[wi] - W[wi]->R;
+      if (Dot(saved_R[wi], saved_R[wi]) > std::numeric_limits<OHMMS_PRECISION>::epsilon())
+        bw.mismatch_count++;
+    }
+  comm->allreduce(bw.mismatch_count);
+
+  comm->barrier();
+  if (!comm->rank())
+  {
+    std::remove((root + hdf::config_ext).c_str());
+    for (int subfile = 0; std::remove(HDFWalkerOutput::getSubfileName(root, subfile).c_str()) == 0; subfile++)
+      ;
+  }
+  comm->setName(comm_name);
+  return bw;
+}
+
+/** write nblocks blocks of synthetic estimator data of nobs values per rank and read them back
+ * @param mode master reduces the data of the ranks and writes it, slab writes the data of each rank
+ *
+ * The slabs are written collectively with parallel HDF5, otherwise they are gathered and written by the master.
+ */
+IOBandwidth benchEstimators(Communicate* comm, const std::string& mode, int nobs, int nblocks)
+{
+  IOBandwidth bw;
+  Timer clock;
+  const std::string fname = "iobench.p" + std::to_string(comm->size()) + "." + mode + ".stat.h5";
+  const bool per_rank     = mode == "slab";
+  const size_t nranks     = comm->size();
+  auto value              = [](int rank, int block, int i) { return rank + 0.5 * block + 1.0e-3 * i; };
+  auto block_name         = [](int block) { return "block_" + std::to_string(block); };
+
+  std::vector<double> data(nobs), gathered;
+  comm->barrier();
+  clock.restart();
+  {
+    // like the estimator managers only the master opens the file of the reduced data
+    std::unique_ptr<hdf_archive> hout;
+    if (per_rank)
+      hout = std::make_unique<hdf_archive>(comm, true);
+    else if (!comm->rank())
+      hout = std::make_unique<hdf_archive>();
+    if (hout)
+    {
+      hout->create(fname);
+      hout->push("estimators");
+    }
+    for (int block = 0; block < nblocks; block++)
+    {
+      for (int i = 0; i < nobs; i++)
+        data[i] = value(comm->rank(), block, i);
+      if (!per_rank)
+      {
+        comm->reduce(data);
+        if (hout)
+          hout->write(data, block_name(block));
+      }
+      else if (hout->is_parallel())
+      {
+        std::array<size_t, 2> gcounts{nranks, static_cast<size_t>(nobs)};
+        std::array<size_t, 2> counts{1, static_cast<size_t>(nobs)};
+        std::array<size_t, 2> offsets{static_cast<size_t>(comm->rank()), 0};
+        hyperslab_proxy<std::vector<double>, 2> slab(data, gcounts, counts, offsets);
+        hout->write(slab, block_name(block));
+      }
+      else
+      {
+        // only the master writes without parallel HDF5
+        std::vector<int> counts(nranks, nobs), displ(nranks);
+        for (int ip = 0; ip < nranks; ip++)
+          displ[ip] = ip * nobs;
+        gathered.resize(nranks * nobs);
+        if (nranks > 1)
+          comm->gatherv(data, gathered, counts, displ);
+        else
+          gathered = data;
+        hout->writeSlabReshaped(gathered, std::array<size_t, 2>{nranks, static_cast<size_t>(nobs)}, block_name(block));
+      }
+    }
+    if (hout)
+      hout->close();
+  }
+  comm->barrier();
+  bw.write_time  = clock.elapsed();
+  bw.return_time = bw.write_time;
+  bw.bytes       = sizeof(double) * nobs * nblocks * (per_rank ? nranks : 1);
+
+  // the master reads the reduced data and broadcasts it, the ranks read their own slab independently
+  clock.restart();
+  for (int block = 0; block < nblocks; block++)
+  {
+    std::fill(data.begin(), data.end(), 0.0);
+    if (per_rank || !comm->rank())
+    {
+      hdf_archive hin;
+      hin.open(fname, H5F_ACC_RDONLY);
+      hin.push("estimators", false);
+      if (per_rank)
+      {
+        std::array<size_t, 2> gcounts{nranks, static_cast<size_t>(nobs)};
+        std::array<size_t, 2> counts{1, static_cast<size_t>(nobs)};
+        std::array<size_t, 2> offsets{static_cast<size_t>(comm->rank()), 0};
+        hyperslab_proxy<std::vector<double>, 2> slab(data, gcounts, counts, offsets);
+        hin.read(slab, block_name(block));
+      }
+      else
+        hin.read(data, block_name(block));
+    }
+    if (!per_rank)
+      comm->bcast(data);
+    for (int i = 0; i < nobs; i++)
+    {
+      double expected = value(comm->rank(), block, i);
+      if (!per_rank)
+      {
+        expected = 0.0;
+        for (int ip = 0; ip < nranks; ip++)
+          expected += value(ip, block, i);
+      }
+      if (std::abs(data[i] - expected) > 1.0e-10 * std::max(1.0, std::abs(expected)))
+        bw.mismatch_count++;
+    }
+  }
+  comm->barrier();
+  bw.read_time = clock.elapsed();
+  comm->allreduce(bw.mismatch_count);
+
+  if (!comm->rank())
+    std::remove(fname.c_str());
+  return bw;
+}
+
+/// run all the benchmarks on a communicator and print them on its master
+int benchIO(MCWalkerConfiguration& W, Communicate* comm, int nrepeat, int nobs, int nblocks)
+{
+  int mismatch_count = 0;
+  for (const std::string mode : {"collective", "async", "aggregated"})
+  {
+    const IOBandwidth bw = benchWalkers(W, comm, mode, nrepeat);
+    mismatch_count += bw.mismatch_count;
+    if (!comm->rank())
+      printBandwidth("walkers " + mode, comm->size(), bw);
+  }
+  for (const std::string mode : {"master", "slab"})
+  {
+    const IOBandwidth bw = benchEstimators(comm, mode, nobs, nblocks);
+    mismatch_count += bw.mismatch_count;
+    if (!comm->rank())
+      printBandwidth("estimators " + mode, comm->size(), bw);
+  }
+  return mismatch_count;
+}
+
 int main(int argc, char** argv)
 {
 #ifdef HAVE_MPI
@@ -75,14 +306,20 @@ int main(int argc, char** argv)
 
   const int NumThreads = omp_get_max_threads();
 
+  int nrepeat     = 2;
+  int nobs        = 1024;
+  int nblocks     = 4;
+  bool rank_sweep = false;
+
   char* g_opt_arg;
   int opt;
-  while ((opt = getopt(argc, argv, "hg:i:r:")) != -1)
+  while ((opt = getopt(argc, argv, "hg:i:s:w:r:n:e:b:p")) != -1)
   {
     switch (opt)
     {
     case 'h':
-      printf("[-g \"n0 n1 n2\"]\n");
+      printf("[-g \"n0 n1 n2\"] [-w walkers] [-n dumps] [-e estimator values per rank] [-b estimator blocks] [-p]\n");
+      printf("  -p repeats the I/O benchmarks on 1/2, 1/4, ... of the ranks\n");
       return 1;
     case 'g': //tiling1 tiling2 tiling3
       sscanf(optarg, "%d %d %d", &na, &nb, &nc);
@@ -99,6 +336,18 @@ int main(int argc, char** argv)
     case 'r': //rmax
       Rmax = atof(optarg);
       break;
+    case 'n': //number of walker dumps per benchmark
+      nrepeat = atoi(optarg);
+      break;
+    case 'e': //size of the estimator data of each rank
+      nobs = atoi(optarg);
+      break;
+    case 'b': //number of estimator blocks
+      nblocks = atoi(optarg);
+      break;
+    case 'p': //benchmark on fewer ranks
+      rank_sweep = true;
+      break;
     }
   }
 
@@ -307,6 +556,30 @@ int main(int argc, char** argv)
     cout << "\nTotal time of reading walkers in HDF5 file: " << setprecision(6) << walkerRead << "\n";
   }
 
+  // I/O bandwidth of the walker checkpoints and the estimator data, on the first group of ranks with -p
+  if (!myComm->rank())
+    cout << "\nI/O bandwidth of " << elecs[0].getTotalNum() << " electrons, average " << AverageWalkersPerNode
+         << " walkers per rank, " << nobs << " estimator values per rank\n"
+         << "  " << setw(22) << left << "benchmark" << right << setw(7) << "ranks" << setw(12) << "MB" << setw(12)
+         << "write MB/s" << setw(12) << "return MB/s" << setw(12) << "read MB/s\n";
+  mismatch_count = benchIO(elecs[0], myComm, nrepeat, nobs, nblocks);
+  for (int ngroups = 2; rank_sweep && ngroups <= myComm->size(); ngroups *= 2)
+  {
+    auto groupComm = std::make_unique<Communicate>(*myComm, ngroups);
+    if (groupComm->getGroupID() == 0)
+      mismatch_count += benchIO(elecs[0], groupComm.get(), nrepeat, nobs, nblocks);
+    myComm->barrier();
+  }
+  if (!myComm->rank())
+  {
+    if (mismatch_count != 0)
+      std::cout << "Fail: data mismatch between write and read in the I/O benchmarks!\n";
+    else
+      std::cout << "Pass: data match exactly between write and read in the I/O benchmarks!\n";
+  }
+  // the benchmarks on the groups of ranks changed the walker offsets
+  setWalkerOffsets(elecs[0], myComm);
+
   if (myComm->size() > 1)
   {
     Communicate* subComm = new Communicate(*myComm, 2);
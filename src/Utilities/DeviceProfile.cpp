@@ -0,0 +1,51 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file DeviceProfile.cpp
+ * @brief Implements DeviceProfile
+ */
+#include "DeviceProfile.h"
+
+namespace qmcplusplus
+{
+DeviceProfile device_profile;
+
+void DeviceProfile::addKernels(timer_id_t id, double seconds, long count)
+{
+  const std::lock_guard<std::mutex> lock(stats_lock_);
+  DeviceTimerStats& stats = stats_[id];
+  stats.kernel_time += seconds;
+  stats.kernel_count += count;
+}
+
+void DeviceProfile::addTransfer(timer_id_t id, double seconds, size_t bytes)
+{
+  const std::lock_guard<std::mutex> lock(stats_lock_);
+  DeviceTimerStats& stats = stats_[id];
+  stats.transfer_time += seconds;
+  stats.transfer_count++;
+  stats.transfer_bytes += bytes;
+}
+
+std::map<timer_id_t, DeviceTimerStats> DeviceProfile::getStats() const
+{
+  const std::lock_guard<std::mutex> lock(stats_lock_);
+  return stats_;
+}
+
+void DeviceProfile::reset()
+{
+  const std::lock_guard<std::mutex> lock(stats_lock_);
+  stats_.clear();
+}
+
+} // namespace qmcplusplus
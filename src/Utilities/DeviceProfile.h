@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file DeviceProfile.h
+ * @brief Device kernel and transfer time accumulated per timer
+ */
+#ifndef QMCPLUSPLUS_DEVICE_PROFILE_H
+#define QMCPLUSPLUS_DEVICE_PROFILE_H
+
+#include <map>
+#include <mutex>
+#include "NewTimer.h"
+
+namespace qmcplusplus
+{
+/// device work attributed to a timer
+struct DeviceTimerStats
+{
+  /// time the device spent in kernels
+  double kernel_time = 0.0;
+  long kernel_count  = 0;
+  /// time of the host-device transfers
+  double transfer_time  = 0.0;
+  long transfer_count   = 0;
+  size_t transfer_bytes = 0;
+};
+
+/** accumulator of the device work measured on the device, e.g. by CUDA events
+ *
+ * The host timers around asynchronous device work only measure the launches and the waits.
+ * The device timers of the platforms measure the work on the device and add it here to the innermost timer
+ * of the thread which queued it, see get_innermost_timer_id. The crowds add concurrently, so the adds lock.
+ * Nothing is measured unless enabled.
+ */
+class DeviceProfile
+{
+public:
+  void enable(bool enabled) { enabled_ = enabled; }
+  inline bool isEnabled() const { return enabled_; }
+
+  /// add the time of a span of kernels
+  void addKernels(timer_id_t id, double seconds, long count = 1);
+  /// add the time of a transfer
+  void addTransfer(timer_id_t id, double seconds, size_t bytes);
+
+  /// a copy of the stats per timer id
+  std::map<timer_id_t, DeviceTimerStats> getStats() const;
+
+  void reset();
+
+private:
+  bool enabled_ = false;
+  mutable std::mutex stats_lock_;
+  std::map<timer_id_t, DeviceTimerStats> stats_;
+};
+
+extern DeviceProfile device_profile;
+
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "MemoryAccountingReport.h"
+#include <algorithm>
+#include <cstdio>
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "Platforms/Host/OutputManager.h"
+
+namespace qmcplusplus
+{
+std::vector<MemoryTagPeak> collateMemoryPeaks(const std::vector<MemoryAccounting::TagStats>& stats,
+                                              Communicate* comm)
+{
+  const int n         = stats.size();
+  const int num_ranks = comm ? comm->size() : 1;
+  std::vector<double> local(n);
+  for (int i = 0; i < n; i++)
+    local[i] = stats[i].peak;
+  std::vector<double> all(local);
+
+  int n_sum = n;
+  if (num_ranks > 1)
+    comm->allreduce(n_sum);
+  const bool reduce = num_ranks > 1 && n > 0 && n_sum == n * num_ranks;
+  if (num_ranks > 1 && n_sum != n * num_ranks)
+    app_warning() << "MemoryAccounting: the ranks used different memory tags, only reporting this rank" << std::endl;
+  if (reduce)
+  {
+    all.resize(n * num_ranks);
+    comm->gather(local, all, 0);
+  }
+
+  const int nr = reduce ? num_ranks : 1;
+  std::vector<MemoryTagPeak> peaks(n);
+  for (int i = 0; i < n; i++)
+  {
+    auto& p    = peaks[i];
+    p.tag      = stats[i].tag;
+    p.space    = stats[i].space;
+    p.min      = all[i];
+    p.max      = all[i];
+    p.max_rank = reduce ? 0 : (comm ? comm->rank() : 0);
+    double sum = 0.0;
+    for (int r = 0; r < nr; r++)
+    {
+      const double bytes = all[r * n + i];
+      p.min              = std::min(p.min, bytes);
+      if (bytes > p.max)
+      {
+        p.max      = bytes;
+        p.max_rank = r;
+      }
+      sum += bytes;
+    }
+    p.avg = sum / nr;
+  }
+  return peaks;
+}
+
+void reportMemoryPeaks(Communicate* comm, std::ostream& log)
+{
+  const auto peaks = collateMemoryPeaks(getMemoryAccounting().getStats(), comm);
+  if (comm && comm->rank() != 0)
+    return;
+  char buf[160];
+  log << "  Peak memory by tag in MiB over " << (comm ? comm->size() : 1) << " ranks" << std::endl;
+  snprintf(buf, sizeof(buf), "  %-24s %-8s %12s %12s %12s %8s\n", "Tag", "Space", "Min", "Avg", "Max", "Max rank");
+  log << buf;
+  for (const auto& p : peaks)
+  {
+    snprintf(buf, sizeof(buf), "  %-24s %-8s %12.2f %12.2f %12.2f %8d\n", p.tag.c_str(),
+             MemoryAccounting::getSpaceName(p.space), p.min / 1048576.0, p.avg / 1048576.0, p.max / 1048576.0,
+             p.max_rank);
+    log << buf;
+  }
+  log << std::endl;
+}
+
+} // namespace qmcplusplus
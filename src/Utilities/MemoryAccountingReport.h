@@ -0,0 +1,52 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file MemoryAccountingReport.h
+ * @brief peak memory of the accounting tags reduced over the ranks
+ */
+#ifndef QMCPLUSPLUS_MEMORY_ACCOUNTING_REPORT_H
+#define QMCPLUSPLUS_MEMORY_ACCOUNTING_REPORT_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "MemoryAccounting.h"
+
+class Communicate;
+
+namespace qmcplusplus
+{
+struct MemoryTagPeak
+{
+  std::string tag;
+  MemorySpace space;
+  /// min, average and max of the peak bytes over the ranks
+  double min;
+  double avg;
+  double max;
+  /// the rank with the max
+  int max_rank;
+};
+
+/** the peak bytes of each tag and space with their spread over the ranks of comm, collective over comm
+ * @return valid on the first rank of comm
+ *
+ * If the ranks used different tags, only the peaks of the calling rank are returned.
+ */
+std::vector<MemoryTagPeak> collateMemoryPeaks(const std::vector<MemoryAccounting::TagStats>& stats,
+                                              Communicate* comm);
+
+/// print the peaks of getMemoryAccounting() reduced over comm, collective over comm, prints on the first rank
+void reportMemoryPeaks(Communicate* comm, std::ostream& log);
+
+} // namespace qmcplusplus
+#endif
@@ -20,11 +20,17 @@
 #include "Concurrency/OpenMP.h"
 #include "config.h"
 #include "TimerManager.h"
+#include "TimerTrace.h"
 
 namespace qmcplusplus
 {
 bool timer_max_level_exceeded = false;
 
+/// the innermost running timer of this thread
+static thread_local timer_id_t innermost_timer_id = 0;
+
+timer_id_t get_innermost_timer_id() { return innermost_timer_id; }
+
 #ifndef ENABLE_TIMERS
 template<class CLOCK>
 void TimerType<CLOCK>::start()
@@ -49,11 +55,8 @@ void TimerType<CLOCK>::start()
     nvtxRangePushA(name.c_str());
 #endif
 
-    bool is_true_master(true);
-    for (int level = omp_get_level(); level > 0; level--)
-      if (omp_get_ancestor_thread_num(level) != 0)
-        is_true_master = false;
-    if (is_true_master)
+    const int thread_id = get_outermost_thread_num();
+    if (thread_id == 0)
     {
       if (manager)
       {
@@ -72,8 +75,21 @@ void TimerType<CLOCK>::start()
 
         manager->push_timer(this);
       }
+      per_thread_profiles[0].enclosing_id = innermost_timer_id;
+      innermost_timer_id                  = timer_id;
+#ifdef ENABLE_PERF_COUNTERS
+      if (perf_counters.isOpen())
+        perf_counters.read(counter_start);
+#endif
       start_time = CLOCK()();
     }
+    else if (thread_id > 0 && thread_id < per_thread_profiles.size())
+    {
+      ThreadTimerProfile& profile = per_thread_profiles[thread_id];
+      profile.enclosing_id        = innermost_timer_id;
+      innermost_timer_id          = timer_id;
+      profile.start_time          = CLOCK()();
+    }
 #else
     start_time     = CLOCK()();
 #endif
@@ -95,22 +111,48 @@ void TimerType<CLOCK>::stop()
     nvtxRangePop();
 #endif
 
-    bool is_true_master(true);
-    for (int level = omp_get_level(); level > 0; level--)
-      if (omp_get_ancestor_thread_num(level) != 0)
-        is_true_master = false;
-    if (is_true_master)
+    const int thread_id = get_outermost_thread_num();
+    if (thread_id == 0)
     {
-      double elapsed = CLOCK()() - start_time;
+      const double end_time = CLOCK()();
+#ifdef ENABLE_PERF_COUNTERS
+      if (perf_counters.isOpen())
+      {
+        PerfCounterValues counter_end;
+        perf_counters.read(counter_end);
+        for (int i = 0; i < NUM_PERF_COUNTERS; i++)
+          counter_total[i] += counter_end[i] - counter_start[i];
+      }
+#endif
+      double elapsed = end_time - start_time;
       total_time += elapsed;
       num_calls++;
 
       per_stack_total_time[current_stack_key] += elapsed;
       per_stack_num_calls[current_stack_key] += 1;
 
+      per_thread_profiles[0].total_time += elapsed;
+      per_thread_profiles[0].num_calls++;
+      innermost_timer_id = per_thread_profiles[0].enclosing_id;
+
+      if (timer_trace.isRecording())
+        timer_trace.record(0, timer_id, start_time, end_time);
+
       if (manager)
         manager->pop_timer(this);
     }
+    else if (thread_id > 0 && thread_id < per_thread_profiles.size())
+    {
+      // only this thread writes its entry, no synchronization needed
+      ThreadTimerProfile& profile = per_thread_profiles[thread_id];
+      const double end_time       = CLOCK()();
+      profile.total_time += end_time - profile.start_time;
+      profile.num_calls++;
+      innermost_timer_id = profile.enclosing_id;
+
+      if (timer_trace.isRecording())
+        timer_trace.record(thread_id, timer_id, profile.start_time, end_time);
+    }
 #else
     double elapsed = CLOCK()() - start_time;
     total_time += elapsed;
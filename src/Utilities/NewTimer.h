@@ -21,8 +21,11 @@
 #include <string>
 #include <algorithm>
 #include <map>
+#include <vector>
 #include "config.h"
 #include "Clock.h"
+#include "Concurrency/OpenMP.h"
+#include "PerfCounters.h"
 
 #ifdef USE_VTUNE_TASKS
 #include <ittnotify.h>
@@ -128,6 +131,26 @@ public:
 // N = 2 gives 16 nesting levels
 using StackKey = StackKeyParam<2>;
 
+/** time and call counts of a timer measured by one thread
+ * Each thread only writes its own entry, aligned to a cache line to avoid false sharing.
+ */
+struct alignas(64) ThreadTimerProfile
+{
+  /// start time of the current measurement
+  double start_time = 0.0;
+  /// total time accumulated of all the calls
+  double total_time = 0.0;
+  /// total call counts
+  long num_calls = 0;
+  /// id of the timer of this thread enclosing the current measurement, 0 if none
+  timer_id_t enclosing_id = 0;
+};
+
+/** id of the innermost running timer of the calling thread, 0 if none
+ * Only the threads of the outermost parallel level are tracked. Used to attribute the device work to timers.
+ */
+timer_id_t get_innermost_timer_id();
+
 /** Timer accumulates time and call counts
  * @tparam CLOCK can be CPUClock or FakeCPUClock
  */
@@ -160,6 +183,24 @@ protected:
   /// total call counts per stack key
   std::map<StackKey, long> per_stack_num_calls;
 #endif
+  /** time and call counts per thread of the outermost parallel level, one per crowd in the batched drivers.
+   * The threads of nested regions only contribute through their master.
+   * The size is the maximum number of threads when the timer is created, the threads beyond are not profiled.
+   */
+  std::vector<ThreadTimerProfile> per_thread_profiles;
+  /// hardware counters at the start of the current measurement of the master thread
+  PerfCounterValues counter_start{};
+  /// hardware counters accumulated by the master thread, only counted with ENABLE_PERF_COUNTERS
+  PerfCounterValues counter_total{};
+
+  /// thread id at the outermost parallel level, -1 for the non-master threads of nested regions
+  static inline int get_outermost_thread_num()
+  {
+    for (int level = omp_get_level(); level > 1; level--)
+      if (omp_get_ancestor_thread_num(level) != 0)
+        return -1;
+    return omp_get_level() > 0 ? omp_get_ancestor_thread_num(1) : 0;
+  }
 
 #ifdef USE_VTUNE_TASKS
   __itt_string_handle* task_name;
@@ -183,6 +224,10 @@ public:
   inline long get_num_calls(const StackKey& key) { return per_stack_num_calls[key]; }
 #endif
 
+  const std::vector<ThreadTimerProfile>& get_per_thread_profiles() const { return per_thread_profiles; }
+
+  const PerfCounterValues& get_counter_total() const { return counter_total; }
+
   timer_id_t get_id() const { return timer_id; }
 
   void set_id(timer_id_t id) { timer_id = id; }
@@ -193,6 +238,9 @@ public:
   {
     num_calls  = 0;
     total_time = 0.0;
+    for (auto& profile : per_thread_profiles)
+      profile = ThreadTimerProfile();
+    counter_total.fill(0);
   }
 
   TimerType(const std::string& myname,
@@ -205,10 +253,11 @@ public:
         timer_level(mytimer),
         timer_id(0),
 #ifdef USE_STACK_TIMERS
-        manager(mymanager)
+        manager(mymanager),
 #else
-        manager(nullptr)
+        manager(nullptr),
 #endif
+        per_thread_profiles(omp_get_max_threads())
   {
 #ifdef USE_VTUNE_TASKS
     task_name = __itt_string_handle_create(myname.c_str());
@@ -229,6 +278,15 @@ public:
 
   template<class CLOCK1>
   friend void set_num_calls(TimerType<CLOCK1>* timer, long num_calls_input);
+
+  template<class CLOCK1>
+  friend void set_thread_profile(TimerType<CLOCK1>* timer,
+                                 int thread_id,
+                                 double total_time_input,
+                                 long num_calls_input);
+
+  template<class CLOCK1>
+  friend void set_counter_total(TimerType<CLOCK1>* timer, const PerfCounterValues& counter_total_input);
 };
 
 using NewTimer  = TimerType<CPUClock>;
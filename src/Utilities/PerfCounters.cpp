@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file PerfCounters.cpp
+ * @brief Implements PerfCounters
+ */
+#include "PerfCounters.h"
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace qmcplusplus
+{
+PerfCounters perf_counters;
+
+PerfCounters::PerfCounters() { fds_.fill(-1); }
+
+PerfCounters::~PerfCounters() { close(); }
+
+#ifdef __linux__
+namespace
+{
+int openEvent(PerfCounterEvent event, int group_fd)
+{
+  static const uint64_t configs[NUM_PERF_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                      PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size           = sizeof(attr);
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.config         = configs[event];
+  attr.read_format    = PERF_FORMAT_GROUP;
+  attr.disabled       = group_fd < 0 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  // the calling thread on any cpu
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+} // namespace
+
+bool PerfCounters::open()
+{
+  close();
+  fds_[PERF_CYCLES] = openEvent(PERF_CYCLES, -1);
+  if (fds_[PERF_CYCLES] < 0)
+    return false;
+  for (int event = PERF_CYCLES + 1; event < NUM_PERF_COUNTERS; event++)
+    fds_[event] = openEvent(static_cast<PerfCounterEvent>(event), fds_[PERF_CYCLES]);
+  ioctl(fds_[PERF_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds_[PERF_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+}
+
+void PerfCounters::close()
+{
+  for (int& fd : fds_)
+    if (fd >= 0)
+    {
+      ::close(fd);
+      fd = -1;
+    }
+}
+
+void PerfCounters::read(PerfCounterValues& values) const
+{
+  values.fill(0);
+  if (!isOpen())
+    return;
+  // the number of events followed by their values in the order they joined the group
+  uint64_t buffer[NUM_PERF_COUNTERS + 1];
+  if (::read(fds_[PERF_CYCLES], buffer, sizeof(buffer)) <= 0)
+    return;
+  int ivalue = 1;
+  for (int event = 0; event < NUM_PERF_COUNTERS && ivalue <= buffer[0]; event++)
+    if (fds_[event] >= 0)
+      values[event] = buffer[ivalue++];
+}
+#else
+bool PerfCounters::open() { return false; }
+
+void PerfCounters::close() {}
+
+void PerfCounters::read(PerfCounterValues& values) const { values.fill(0); }
+#endif
+
+const char* PerfCounters::getName(PerfCounterEvent event)
+{
+  static const char* names[NUM_PERF_COUNTERS] = {"cycles", "instructions", "cache_references", "cache_misses"};
+  return names[event];
+}
+
+} // namespace qmcplusplus
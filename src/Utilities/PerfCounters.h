@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file PerfCounters.h
+ * @brief Hardware performance counters of a thread through the Linux perf_event interface
+ */
+#ifndef QMCPLUSPLUS_PERF_COUNTERS_H
+#define QMCPLUSPLUS_PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+
+namespace qmcplusplus
+{
+/// hardware events counted for the timers
+enum PerfCounterEvent
+{
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_CACHE_REFERENCES, // last level cache
+  PERF_CACHE_MISSES,     // last level cache
+  NUM_PERF_COUNTERS
+};
+
+using PerfCounterValues = std::array<uint64_t, NUM_PERF_COUNTERS>;
+
+/** a group of hardware counters of the thread which opens it
+ *
+ * The generic perf events are used so the same events are counted on any CPU supported by the kernel.
+ * Only the user space is counted, which works with the default perf_event_paranoid setting.
+ * The events the CPU or the kernel do not support are left out and read as zero.
+ * On other systems than Linux open always fails.
+ */
+class PerfCounters
+{
+public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /** open the counters of the calling thread
+   * @return false if the counters are not available
+   */
+  bool open();
+  void close();
+  bool isOpen() const { return fds_[PERF_CYCLES] >= 0; }
+  /// true if the event is counted
+  bool isCounted(PerfCounterEvent event) const { return fds_[event] >= 0; }
+
+  /// read the current counts with a single system call, zeros if not open
+  void read(PerfCounterValues& values) const;
+
+  /// short name of an event for the reports
+  static const char* getName(PerfCounterEvent event);
+
+private:
+  /// file descriptors of the events, the cycles are the group leader, -1 for the events not counted
+  std::array<int, NUM_PERF_COUNTERS> fds_;
+};
+
+/// the counters of the master thread read by the timers
+extern PerfCounters perf_counters;
+
+} // namespace qmcplusplus
+#endif
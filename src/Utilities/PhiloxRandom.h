@@ -0,0 +1,219 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+/** @file
+ *  Counter-based Philox4x32-10 generator with the interface of StdRandom
+ *
+ *  J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw, "Parallel random numbers: as easy as 1, 2, 3", SC11 (2011).
+ */
+#ifndef QMCPLUSPLUS_PHILOXRANDOM_H
+#define QMCPLUSPLUS_PHILOXRANDOM_H
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace qmcplusplus
+{
+/** random numbers [0,1) from the Philox4x32-10 counter-based generator
+ *
+ * The n-th block of four 32 bit numbers of a stream is a pure function of the key (the seed),
+ * the stream index and n. The whole state is seven 32 bit numbers, any block can be generated
+ * independently of the others, on the host or in a device kernel through generateBlock,
+ * and the streams of given seed and stream index are identical however they are distributed.
+ */
+template<typename T>
+class PhiloxRandom
+{
+public:
+  using result_type = T;
+  using uint_type   = uint32_t;
+  static_assert(std::is_floating_point<T>::value);
+
+  /// number of 32 bit random numbers generated by a single evaluation of the bijection
+  static constexpr int block_size = 4;
+
+  PhiloxRandom(uint_type iseed = 911, uint64_t stream = 0) : stream_(stream) { seed(iseed); }
+
+  void init(int iseed_in) { seed(static_cast<uint_type>(iseed_in)); }
+
+  /// set the key and restart the current stream
+  void seed(uint_type aseed)
+  {
+    key_     = {aseed, 0};
+    counter_ = 0;
+    index_   = block_size;
+  }
+
+  /// switch to the beginning of another stream of the same key
+  void setStream(uint64_t stream)
+  {
+    stream_  = stream;
+    counter_ = 0;
+    index_   = block_size;
+  }
+
+  result_type operator()()
+  {
+    if (index_ == block_size)
+    {
+      generateBlock(key_, counter_++, stream_, block_.data());
+      index_ = 0;
+    }
+    return toReal(block_[index_++]);
+  }
+
+  /** fill n random numbers, the same as n calls of operator()
+   *
+   * The full blocks are generated independently of each other and vectorize.
+   */
+  void fill(result_type* out, size_t n)
+  {
+    size_t i = 0;
+    while (i < n && index_ < block_size)
+      out[i++] = toReal(block_[index_++]);
+
+    const size_t num_blocks = (n - i) / block_size;
+    const uint64_t counter  = counter_;
+    const auto key          = key_;
+    const uint64_t stream   = stream_;
+    result_type* out_blocks = out + i;
+#pragma omp simd
+    for (size_t ib = 0; ib < num_blocks; ib++)
+    {
+      uint32_t r[block_size];
+      generateBlock(key, counter + ib, stream, r);
+      for (int j = 0; j < block_size; j++)
+        out_blocks[ib * block_size + j] = toReal(r[j]);
+    }
+    counter_ += num_blocks;
+    i += num_blocks * block_size;
+
+    while (i < n)
+      out[i++] = (*this)();
+  }
+
+  void write(std::ostream& rout) const
+  {
+    std::vector<uint_type> state;
+    save(state);
+    for (auto s : state)
+      rout << s << " ";
+  }
+
+  void read(std::istream& rin)
+  {
+    std::vector<uint_type> state(state_size());
+    for (auto& s : state)
+      rin >> s;
+    load(state);
+  }
+
+  size_t state_size() const { return 7; }
+
+  void load(const std::vector<uint_type>& newstate)
+  {
+    if (newstate.size() != state_size())
+      throw std::runtime_error("PhiloxRandom::load the state size is not " + std::to_string(state_size()));
+    key_     = {newstate[0], newstate[1]};
+    counter_ = static_cast<uint64_t>(newstate[2]) | (static_cast<uint64_t>(newstate[3]) << 32);
+    stream_  = static_cast<uint64_t>(newstate[4]) | (static_cast<uint64_t>(newstate[5]) << 32);
+    index_   = newstate[6];
+    // the partially used block is the one before the counter
+    if (index_ < block_size)
+      generateBlock(key_, counter_ - 1, stream_, block_.data());
+  }
+
+  void save(std::vector<uint_type>& curstate) const
+  {
+    curstate = {key_[0],
+                key_[1],
+                static_cast<uint_type>(counter_),
+                static_cast<uint_type>(counter_ >> 32),
+                static_cast<uint_type>(stream_),
+                static_cast<uint_type>(stream_ >> 32),
+                static_cast<uint_type>(index_)};
+  }
+
+  /** the Philox4x32-10 bijection of the 128 bit counter (counter, stream) under the key
+   * @param key 64 bit key
+   * @param counter block index within the stream, the low 64 bits of the counter
+   * @param stream stream index, the high 64 bits of the counter
+   * @param out 4 random 32 bit numbers
+   *
+   * Free of any state and library call so that it can be called inside device kernels.
+   */
+  static inline void generateBlock(const std::array<uint32_t, 2>& key,
+                                   uint64_t counter,
+                                   uint64_t stream,
+                                   uint32_t* out)
+  {
+    constexpr uint32_t M0 = 0xD2511F53;
+    constexpr uint32_t M1 = 0xCD9E8D57;
+    constexpr uint32_t W0 = 0x9E3779B9;
+    constexpr uint32_t W1 = 0xBB67AE85;
+
+    uint32_t c0 = static_cast<uint32_t>(counter);
+    uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+    uint32_t c2 = static_cast<uint32_t>(stream);
+    uint32_t c3 = static_cast<uint32_t>(stream >> 32);
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+    for (int round = 0; round < 10; round++)
+    {
+      const uint64_t p0 = static_cast<uint64_t>(M0) * c0;
+      const uint64_t p1 = static_cast<uint64_t>(M1) * c2;
+      const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+      const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+      c1                = static_cast<uint32_t>(p1);
+      c3                = static_cast<uint32_t>(p0);
+      c0                = n0;
+      c2                = n2;
+      k0 += W0;
+      k1 += W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+  /// map a 32 bit number to [0,1), float keeps the 24 high bits so that 1 is never reached by rounding
+  static inline result_type toReal(uint32_t u)
+  {
+    if constexpr (std::is_same<result_type, float>::value)
+      return static_cast<float>(u >> 8) * 0x1p-24f;
+    else
+      return static_cast<result_type>(u) * static_cast<result_type>(0x1p-32);
+  }
+
+public:
+  // Non const allows use of default copy constructor
+  std::string ClassName{"PhiloxRandom"};
+  std::string EngineName{"philox4x32_10"};
+
+private:
+  std::array<uint32_t, 2> key_;
+  /// index of the next block in the stream
+  uint64_t counter_;
+  uint64_t stream_;
+  /// the current block and the position of the next number in it
+  std::array<uint32_t, block_size> block_;
+  int index_;
+};
+
+} // namespace qmcplusplus
+
+#endif
@@ -19,6 +19,7 @@
  *
  * Selected among
  * - std::mt19937
+ * - Philox4x32-10 if QMC_RNG_PHILOX is defined
  * qmcplusplus::Random() returns a random number [0,1)
  * For OpenMP is enabled, it is important to use thread-safe boost::random. Each
  * thread uses its own random number generator with a distinct seed. This prevents
@@ -33,6 +34,7 @@
 // The definition of the fake RNG should always be available for unit testing
 #include "FakeRandom.h"
 #include "StdRandom.h"
+#include "PhiloxRandom.h"
 
 uint32_t make_seed(int i, int n);
 
@@ -50,7 +52,11 @@ public:
 };
 
 extern template class RNGThreadSafe<FakeRandom>;
+#if defined(QMC_RNG_PHILOX)
+extern template class RNGThreadSafe<PhiloxRandom<double>>;
+#else
 extern template class RNGThreadSafe<StdRandom<double>>;
+#endif
 
 #if defined(USE_FAKE_RNG)
 // fake RNG redirection
@@ -59,7 +65,11 @@ extern RNGThreadSafe<RandomGenerator> fake_random_global;
 #define Random fake_random_global
 #else
 // real RNG redirection
+#if defined(QMC_RNG_PHILOX)
+using RandomGenerator = PhiloxRandom<OHMMS_PRECISION_FULL>;
+#else
 using RandomGenerator = StdRandom<OHMMS_PRECISION_FULL>;
+#endif
 extern RNGThreadSafe<RandomGenerator> random_global;
 #define Random random_global
 #endif
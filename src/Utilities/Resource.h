@@ -13,6 +13,7 @@
 #define QMCPLUSPLUS_RESOURCE_H
 
 #include <string>
+#include <cstddef>
 
 namespace qmcplusplus
 {
@@ -23,6 +24,10 @@ public:
   virtual ~Resource()                 = default;
   virtual Resource* makeClone() const = 0;
   const std::string& getName() const { return name_; }
+  /** memory in bytes needed by this resource for each walker of a crowd.
+   * Multi walker resources scale up with the number of walkers sharing them.
+   */
+  virtual size_t getMemoryPerWalker() const { return 0; }
 
 private:
   const std::string name_;
@@ -29,10 +29,23 @@ void ResourceCollection::printResources() const
   std::cout << "-------------------------------" << std::endl;
   for (int i = 0; i < collection_.size(); i++)
     std::cout << "resource " << i << "    name: " << collection_[i]->getName()
-              << "    address: " << collection_[i].get() << std::endl;
+              << "    address: " << collection_[i].get()
+              << "    bytes per walker: " << collection_[i]->getMemoryPerWalker() << std::endl;
   std::cout << "-------------------------------" << std::endl << std::endl;
 }
 
+size_t ResourceCollection::getMemoryPerWalker() const
+{
+  size_t bytes = 0;
+  for (auto& res : collection_)
+  {
+    if (!res)
+      throw std::runtime_error("ResourceCollection::getMemoryPerWalker BUG resources are lent out.");
+    bytes += res->getMemoryPerWalker();
+  }
+  return bytes;
+}
+
 size_t ResourceCollection::addResource(std::unique_ptr<Resource>&& res, bool noprint)
 {
   size_t index              = collection_.size();
@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <vector>
 #include "Resource.h"
+#include "ScratchArena.h"
 #include "type_traits/RefVectorWithLeader.h"
 
 namespace qmcplusplus
@@ -29,6 +30,8 @@ public:
   const std::string& getName() const { return name_; }
   size_t size() const { return collection_.size(); }
   void printResources() const;
+  /// total memory in bytes needed by all the owned resources for each walker of a crowd
+  size_t getMemoryPerWalker() const;
 
   size_t addResource(std::unique_ptr<Resource>&& res, bool noprint = false);
   std::unique_ptr<Resource> lendResource();
@@ -38,10 +41,14 @@ public:
 
   bool empty() const { return collection_.size() == 0; }
 
+  /// temporaries of the mw_ calls of the crowd owning the collection
+  ScratchArena& getScratchArena() { return scratch_arena_; }
+
 private:
   const std::string name_;
   size_t cursor_index_;
   std::vector<std::unique_ptr<Resource>> collection_;
+  ScratchArena scratch_arena_;
 };
 
 /** handles acquire/release resource by the consumer (RefVectorWithLeader type).
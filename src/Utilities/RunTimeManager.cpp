@@ -15,9 +15,11 @@
 
  */
 #include "RunTimeManager.h"
+#include "TimerSampler.h"
 #include <sstream>
 #include <fstream>
 #include <cstdio>
+#include <algorithm>
 
 namespace qmcplusplus
 {
@@ -27,7 +29,7 @@ template class RunTimeManager<CPUClock>;
 template class RunTimeManager<FakeCPUClock>;
 
 template<class CLOCK>
-LoopTimer<CLOCK>::LoopTimer() : nloop(0), ticking(false), start_time(0.0), total_time(0.0)
+LoopTimer<CLOCK>::LoopTimer() : nloop(0), nstep(0), ticking(false), start_time(0.0), total_time(0.0)
 {}
 
 template<class CLOCK>
@@ -35,18 +37,22 @@ void LoopTimer<CLOCK>::start()
 {
   if (ticking)
     throw std::runtime_error("LoopTimer started already!");
+  timer_sampler.startBlock();
   start_time = CLOCK()();
   ticking    = true;
 }
 
 template<class CLOCK>
-void LoopTimer<CLOCK>::stop()
+void LoopTimer<CLOCK>::stop(int steps)
 {
   if (!ticking)
     throw std::runtime_error("LoopTimer didn't start but called stop!");
   nloop++;
-  total_time += CLOCK()() - start_time;
+  nstep += steps;
+  const double loop_time = CLOCK()() - start_time;
+  total_time += loop_time;
   ticking = false;
+  timer_sampler.stopBlock(loop_time);
 }
 
 template<class CLOCK>
@@ -57,6 +63,14 @@ double LoopTimer<CLOCK>::get_time_per_iteration() const
   return 0.0;
 }
 
+template<class CLOCK>
+double LoopTimer<CLOCK>::get_time_per_step() const
+{
+  if (nstep > 0)
+    return total_time / nstep;
+  return 0.0;
+}
+
 template class LoopTimer<CPUClock>;
 template class LoopTimer<FakeCPUClock>;
 
@@ -106,6 +120,28 @@ bool RunTimeControl<CLOCK>::enough_time_for_next_iteration(LoopTimer<CLOCK>& loo
   return enough_time;
 }
 
+template<class CLOCK>
+int RunTimeControl<CLOCK>::steps_fitting_in_remaining_time(LoopTimer<CLOCK>& loop_timer, int max_steps)
+{
+  const double step_time = loop_timer.get_time_per_step();
+  m_loop_time            = loop_timer.get_time_per_iteration();
+  m_elapsed              = runtimeManager.elapsed();
+
+  if (m_elapsed >= MaxCPUSecs)
+  {
+    stop_status_ = StopStatus::MAX_SECONDS_PASSED;
+    return 0;
+  }
+
+  m_remaining = MaxCPUSecs - m_elapsed;
+  if (step_time <= 0.0)
+    return max_steps;
+
+  stop_status_     = StopStatus::NOT_ENOUGH_TIME;
+  const double fit = (m_remaining - m_runtime_safety_padding) / (m_loop_margin * step_time);
+  return fit < max_steps ? std::max(static_cast<int>(fit), 0) : max_steps;
+}
+
 template<class CLOCK>
 bool RunTimeControl<CLOCK>::stop_file_requested()
 {
@@ -127,6 +163,28 @@ bool RunTimeControl<CLOCK>::checkStop(LoopTimer<CLOCK>& loop_timer)
   return need_to_stop;
 }
 
+template<class CLOCK>
+bool RunTimeControl<CLOCK>::checkStop(LoopTimer<CLOCK>& loop_timer, int& steps)
+{
+  steps = steps_fitting_in_remaining_time(loop_timer, steps);
+  bool need_to_stop = steps == 0;
+  need_to_stop |= stop_file_requested();
+  return need_to_stop;
+}
+
+template<class CLOCK>
+int RunTimeControl<CLOCK>::getStepsToFinishAt(const LoopTimer<CLOCK>& loop_timer,
+                                              double finish_time,
+                                              int blocks_left,
+                                              int default_steps)
+{
+  const double step_time = loop_timer.get_time_per_step();
+  if (step_time <= 0.0 || blocks_left < 1)
+    return default_steps;
+  const double steps = (finish_time - runtimeManager.elapsed()) / (blocks_left * step_time);
+  return std::max(static_cast<int>(steps), 1);
+}
+
 template<class CLOCK>
 std::string RunTimeControl<CLOCK>::generateStopMessage(const std::string& driverName, int block) const
 {
@@ -43,17 +43,25 @@ extern RunTimeManager<CPUClock> run_time_manager;
 extern template class RunTimeManager<CPUClock>;
 extern template class RunTimeManager<FakeCPUClock>;
 
+/** times the blocks of a driver
+ * The blocks are also reported to timer_sampler which enables the detailed timers in a sample of them.
+ */
 template<class CLOCK = CPUClock>
 class LoopTimer
 {
 public:
   LoopTimer();
+  /// start a block
   void start();
-  void stop();
+  /// stop a block of steps steps, one step per block by default
+  void stop(int steps = 1);
   double get_time_per_iteration() const;
+  /// average time of the steps of the blocks, equal to the time per iteration with one step per block
+  double get_time_per_step() const;
 
 private:
   int nloop;
+  long nstep;
   bool ticking;
   double start_time;
   double total_time;
@@ -84,6 +92,8 @@ class RunTimeControl
   } stop_status_;
 
   bool enough_time_for_next_iteration(LoopTimer<CLOCK>& loop_timer);
+  /// the steps up to max_steps fitting in the remaining time
+  int steps_fitting_in_remaining_time(LoopTimer<CLOCK>& loop_timer, int max_steps);
   bool stop_file_requested();
 
 public:
@@ -100,6 +110,23 @@ public:
    */
   bool checkStop(LoopTimer<CLOCK>& loop_timer);
 
+  /** check if the run needs to stop and shorten the next block to the remaining walltime
+   * In place of checkStop for the drivers which can run a block of fewer steps. The run only stops
+   * when not a single step fits in the remaining time, so the last block ends just before the limit.
+   * @param loop_timer timer of the blocks, stopped with their number of steps
+   * @param steps the steps of the next block on input, reduced to the steps fitting in the remaining time
+   */
+  bool checkStop(LoopTimer<CLOCK>& loop_timer, int& steps);
+
+  /** the steps per block finishing the blocks left at a given time from the measured time per step
+   * @param loop_timer timer of the blocks, stopped with their number of steps
+   * @param finish_time elapsed time of the RunTimeManager at which the last block should end
+   * @param blocks_left blocks still to run
+   * @param default_steps returned before any step is timed
+   * @return at least one step
+   */
+  int getStepsToFinishAt(const LoopTimer<CLOCK>& loop_timer, double finish_time, int blocks_left, int default_steps);
+
   /// generate stop message explaining why
   std::string generateStopMessage(const std::string& driverName, int block) const;
 
@@ -0,0 +1,128 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "ScalarTable.h"
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <stdexcept>
+
+namespace qmcplusplus
+{
+static constexpr char scalar_table_magic[] = "QMCSCALT";
+static constexpr size_t scalar_table_magic_size = sizeof(scalar_table_magic) - 1;
+static constexpr uint32_t scalar_table_version  = 1;
+
+ScalarTableWriter::ScalarTableWriter(const std::string& fname,
+                                     const std::vector<std::string>& names,
+                                     size_t buffer_rows)
+    : num_columns_(names.size()), buffer_rows_(std::max(buffer_rows, size_t(1))), fout_(fname, std::ios::binary)
+{
+  if (!fout_)
+    throw std::runtime_error("ScalarTableWriter cannot create " + fname);
+  const uint32_t header[2] = {scalar_table_version, static_cast<uint32_t>(num_columns_)};
+  fout_.write(scalar_table_magic, scalar_table_magic_size);
+  fout_.write(reinterpret_cast<const char*>(header), sizeof(header));
+  for (const auto& name : names)
+  {
+    const uint32_t len = name.size();
+    fout_.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    fout_.write(name.data(), len);
+  }
+  fout_.flush();
+  buffer_.reserve(buffer_rows_ * num_columns_);
+}
+
+ScalarTableWriter::~ScalarTableWriter() { flush(); }
+
+void ScalarTableWriter::append(const double* row)
+{
+  buffer_.insert(buffer_.end(), row, row + num_columns_);
+  if (buffer_.size() >= buffer_rows_ * num_columns_)
+    flush();
+}
+
+void ScalarTableWriter::flush()
+{
+  if (buffer_.size())
+    fout_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size() * sizeof(double));
+  buffer_.clear();
+  fout_.flush();
+}
+
+ScalarTableReader::ScalarTableReader(const std::string& fname) : fin_(fname, std::ios::binary), num_rows_(0)
+{
+  if (!fin_)
+    throw std::runtime_error("ScalarTableReader cannot open " + fname);
+  char magic[scalar_table_magic_size];
+  uint32_t header[2];
+  fin_.read(magic, scalar_table_magic_size);
+  fin_.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!fin_ || std::strncmp(magic, scalar_table_magic, scalar_table_magic_size) != 0)
+    throw std::runtime_error(fname + " is not a scalar table");
+  if (header[0] != scalar_table_version)
+    throw std::runtime_error(fname + " has the unknown scalar table version " + std::to_string(header[0]));
+  names_.resize(header[1]);
+  for (auto& name : names_)
+  {
+    uint32_t len;
+    fin_.read(reinterpret_cast<char*>(&len), sizeof(len));
+    name.resize(len);
+    fin_.read(&name[0], len);
+  }
+  if (!fin_)
+    throw std::runtime_error(fname + " has a truncated scalar table header");
+
+  const auto data_begin = fin_.tellg();
+  fin_.seekg(0, std::ios::end);
+  if (names_.size())
+    num_rows_ = (fin_.tellg() - data_begin) / (names_.size() * sizeof(double));
+  fin_.seekg(data_begin);
+}
+
+bool ScalarTableReader::readRow(std::vector<double>& row)
+{
+  if (num_rows_ == 0)
+    return false;
+  row.resize(names_.size());
+  fin_.read(reinterpret_cast<char*>(row.data()), row.size() * sizeof(double));
+  --num_rows_;
+  return static_cast<bool>(fin_);
+}
+
+void writeScalarTableText(std::ostream& os, ScalarTableReader& table)
+{
+  const auto& names = table.getNames();
+  size_t field_width = 20;
+  for (const auto& name : names)
+    field_width = std::max(field_width, name.size() + 2);
+  // the first column is the block or step index
+  os.setf(std::ios::scientific, std::ios::floatfield);
+  os.setf(std::ios::left, std::ios::adjustfield);
+  os.precision(10);
+  os << "#   " << std::setw(10) << (names.size() ? names[0] : "");
+  for (int i = 1; i < names.size(); i++)
+    os << std::setw(field_width) << names[i];
+  os << std::endl;
+  os.setf(std::ios::right, std::ios::adjustfield);
+  std::vector<double> row;
+  while (table.readRow(row))
+  {
+    os << std::setw(10) << static_cast<long>(row[0]);
+    for (int i = 1; i < row.size(); i++)
+      os << std::setw(field_width) << row[i];
+    os << '\n';
+  }
+  os.flush();
+}
+
+} // namespace qmcplusplus
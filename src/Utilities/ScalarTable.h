@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_SCALAR_TABLE_H
+#define QMCPLUSPLUS_SCALAR_TABLE_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace qmcplusplus
+{
+/** binary table of scalars, the compact alternative of scalar.dat and dmc.dat
+ *
+ * The file starts with a header: the magic string "QMCSCALT", the format version and the number of
+ * columns as uint32, then the length as uint32 and the characters of each column name.
+ * The rows follow as native doubles without any separator, a truncated last row is ignored.
+ */
+class ScalarTableWriter
+{
+public:
+  /** create the file and write the header
+   * @param fname file name
+   * @param names names of the columns
+   * @param buffer_rows number of rows kept in memory before they are written to the file
+   */
+  ScalarTableWriter(const std::string& fname, const std::vector<std::string>& names, size_t buffer_rows = 64);
+  ~ScalarTableWriter();
+
+  /// append a row of names.size() values
+  void append(const double* row);
+  /// write the buffered rows to the file
+  void flush();
+  size_t numColumns() const { return num_columns_; }
+
+private:
+  const size_t num_columns_;
+  const size_t buffer_rows_;
+  std::ofstream fout_;
+  std::vector<double> buffer_;
+};
+
+/// reader of the files of ScalarTableWriter
+class ScalarTableReader
+{
+public:
+  /// read the header, throws if the file is not a scalar table
+  ScalarTableReader(const std::string& fname);
+
+  const std::vector<std::string>& getNames() const { return names_; }
+  /// number of complete rows in the file
+  size_t numRows() const { return num_rows_; }
+  /** read the next row
+   * @return false once all the rows are read
+   */
+  bool readRow(std::vector<double>& row);
+
+private:
+  std::ifstream fin_;
+  std::vector<std::string> names_;
+  size_t num_rows_;
+};
+
+/** write a scalar table as text in the layout of scalar.dat
+ * @param os output stream
+ * @param table reader of the table, its remaining rows are written
+ */
+void writeScalarTableText(std::ostream& os, ScalarTableReader& table);
+
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,181 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file ScratchArena.h
+ * @brief per crowd storage of the temporaries of the multi walker (mw_) calls
+ */
+#ifndef QMCPLUSPLUS_SCRATCH_ARENA_H
+#define QMCPLUSPLUS_SCRATCH_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace qmcplusplus
+{
+/** recycles the std::vector temporaries of the mw_ calls of a crowd
+ *
+ * A lease hands out a vector kept by the arena and gives it back at the end of its scope.
+ * The vector keeps its capacity, so after the first steps the temporaries of the hot paths
+ * no longer touch the heap. The temporaries stay std::vector to be passed through the mw_ APIs.
+ * Nested leases of the same type get distinct vectors. An arena is used by one thread at a time,
+ * the one driving its crowd.
+ */
+class ScratchArena
+{
+  struct Slot
+  {
+    virtual ~Slot()                 = default;
+    virtual size_t getBytes() const = 0;
+  };
+
+  template<typename T>
+  struct TypedSlot : Slot
+  {
+    std::vector<T> data;
+    size_t getBytes() const override { return data.capacity() * sizeof(T); }
+  };
+
+public:
+  /// a vector lent by the arena until the end of the lease
+  template<typename T>
+  class Lease
+  {
+  public:
+    Lease(ScratchArena& arena, std::unique_ptr<TypedSlot<T>>&& slot) : arena_(arena), slot_(std::move(slot)) {}
+    Lease(Lease&& other) = default;
+    ~Lease()
+    {
+      if (slot_)
+        arena_.takeback(std::move(slot_));
+    }
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    std::vector<T>& operator*() { return slot_->data; }
+    std::vector<T>* operator->() { return &slot_->data; }
+
+  private:
+    ScratchArena& arena_;
+    std::unique_ptr<TypedSlot<T>> slot_;
+  };
+
+  ScratchArena() = default;
+  /// the copies of a resource collection start with an empty arena
+  ScratchArena(const ScratchArena&) {}
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /** lend a vector, its size and elements are left from the last lease
+   *
+   * Meant for nested vectors whose inner vectors keep their capacity too.
+   */
+  template<typename T>
+  Lease<T> lease()
+  {
+    auto& slots = getSlots(getTypeID<T>());
+    if (slots.empty())
+    {
+      num_created_++;
+      return Lease<T>(*this, std::make_unique<TypedSlot<T>>());
+    }
+    std::unique_ptr<TypedSlot<T>> slot(static_cast<TypedSlot<T>*>(slots.back().release()));
+    slots.pop_back();
+    return Lease<T>(*this, std::move(slot));
+  }
+
+  /// lend a vector of n copies of value, like a newly constructed std::vector<T>(n, value)
+  template<typename T>
+  Lease<T> getVector(size_t n, const T& value = T())
+  {
+    Lease<T> vec(lease<T>());
+    vec->assign(n, value);
+    return vec;
+  }
+
+  /// number of vectors created by the arena, the leases beyond them are recycled
+  size_t getNumCreated() const { return num_created_; }
+
+  /// bytes held by the vectors given back to the arena
+  size_t getBytes() const
+  {
+    size_t bytes = 0;
+    for (const auto& slots : free_slots_)
+      for (const auto& slot : slots)
+        bytes += slot->getBytes();
+    return bytes;
+  }
+
+private:
+  /// given back vectors by type id
+  std::vector<std::vector<std::unique_ptr<Slot>>> free_slots_;
+  size_t num_created_ = 0;
+
+  template<typename T>
+  static size_t getTypeID()
+  {
+    static const size_t id = nextTypeID()++;
+    return id;
+  }
+
+  static std::atomic<size_t>& nextTypeID()
+  {
+    static std::atomic<size_t> id(0);
+    return id;
+  }
+
+  std::vector<std::unique_ptr<Slot>>& getSlots(size_t type_id)
+  {
+    if (type_id >= free_slots_.size())
+      free_slots_.resize(type_id + 1);
+    return free_slots_[type_id];
+  }
+
+  template<typename T>
+  void takeback(std::unique_ptr<TypedSlot<T>>&& slot)
+  {
+    getSlots(getTypeID<T>()).push_back(std::move(slot));
+  }
+};
+
+/** the arena used by the mw_ calls of a leader object
+ *
+ * The one of the resource collection acquired by the leader, otherwise an arena of its own.
+ * Copies start detached.
+ */
+class ScratchArenaRef
+{
+public:
+  ScratchArenaRef() = default;
+  ScratchArenaRef(const ScratchArenaRef&) {}
+  ScratchArenaRef& operator=(const ScratchArenaRef&) { return *this; }
+
+  void attach(ScratchArena& arena) { attached_ = &arena; }
+  void detach() { attached_ = nullptr; }
+
+  ScratchArena& get()
+  {
+    if (attached_)
+      return *attached_;
+    if (!own_)
+      own_ = std::make_unique<ScratchArena>();
+    return *own_;
+  }
+
+private:
+  ScratchArena* attached_ = nullptr;
+  std::unique_ptr<ScratchArena> own_;
+};
+
+} // namespace qmcplusplus
+#endif
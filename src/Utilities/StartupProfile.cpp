@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "StartupProfile.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "Platforms/Host/OutputManager.h"
+
+namespace qmcplusplus
+{
+StartupProfile<CPUClock> startup_profile;
+
+template<class CLOCK>
+void StartupProfile<CLOCK>::push(const std::string& name)
+{
+  if (finished_)
+    return;
+  const std::string path = stack_.empty() ? name : phases_[stack_.back().first].path + "/" + name;
+  auto it = std::find_if(phases_.begin(), phases_.end(), [&path](const Phase& p) { return p.path == path; });
+  if (it == phases_.end())
+  {
+    phases_.push_back({path, static_cast<int>(stack_.size()), 0, 0.0});
+    it = phases_.end() - 1;
+  }
+  it->calls++;
+  stack_.emplace_back(it - phases_.begin(), CLOCK()());
+}
+
+template<class CLOCK>
+void StartupProfile<CLOCK>::pop()
+{
+  if (finished_ || stack_.empty())
+    return;
+  phases_[stack_.back().first].seconds += CLOCK()() - stack_.back().second;
+  stack_.pop_back();
+}
+
+template<class CLOCK>
+std::vector<typename StartupProfile<CLOCK>::PhaseStats> StartupProfile<CLOCK>::collate(Communicate* comm) const
+{
+  const int n         = phases_.size();
+  const int num_ranks = comm ? comm->size() : 1;
+  std::vector<double> local(n);
+  for (int i = 0; i < n; i++)
+    local[i] = phases_[i].seconds;
+  std::vector<double> all(local);
+
+  int n_sum = n;
+  if (num_ranks > 1)
+    comm->allreduce(n_sum);
+  const bool reduce = num_ranks > 1 && n > 0 && n_sum == n * num_ranks;
+  if (num_ranks > 1 && n_sum != n * num_ranks)
+    app_warning() << "StartupProfile: the ranks entered different startup phases, only reporting this rank"
+                  << std::endl;
+  if (reduce)
+  {
+    all.resize(n * num_ranks);
+    comm->gather(local, all, 0);
+  }
+
+  const int nr = reduce ? num_ranks : 1;
+  std::vector<PhaseStats> stats(n);
+  for (int i = 0; i < n; i++)
+  {
+    auto& s = stats[i];
+    s.path  = phases_[i].path;
+    s.level = phases_[i].level;
+    s.calls = phases_[i].calls;
+    s.min   = all[i];
+    s.max   = all[i];
+    double sum = 0.0;
+    for (int r = 0; r < nr; r++)
+    {
+      const double t = all[r * n + i];
+      s.min          = std::min(s.min, t);
+      s.max          = std::max(s.max, t);
+      sum += t;
+    }
+    s.avg = sum / nr;
+  }
+  return stats;
+}
+
+template<class CLOCK>
+void StartupProfile<CLOCK>::writeJSON(std::ostream& os, const std::vector<PhaseStats>& stats, int num_ranks)
+{
+  os << "{\n  \"ranks\": " << num_ranks << ",\n  \"phases\": [";
+  char buf[128];
+  for (int i = 0; i < stats.size(); i++)
+  {
+    const auto& s   = stats[i];
+    const auto leaf = s.path.substr(s.path.rfind('/') + 1);
+    snprintf(buf, sizeof(buf), "\"calls\": %ld, \"min\": %.6f, \"avg\": %.6f, \"max\": %.6f", s.calls, s.min, s.avg,
+             s.max);
+    os << (i ? ",\n" : "\n") << "    {\"name\": \"" << leaf << "\", \"path\": \"" << s.path
+       << "\", \"level\": " << s.level << ", " << buf << "}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+template<class CLOCK>
+void StartupProfile<CLOCK>::finish(Communicate* comm)
+{
+  if (finished_)
+    return;
+  // the abandoned open phases are not counted
+  stack_.clear();
+  finished_  = true;
+  stats_     = collate(comm);
+  num_ranks_ = comm ? comm->size() : 1;
+  if (comm && comm->rank() != 0)
+    return;
+
+  size_t name_len = 5;
+  for (const auto& s : stats_)
+    name_len = std::max(name_len, s.path.size() - s.path.rfind('/') - 1 + 2 * s.level);
+  char buf[256];
+  app_summary() << "  Startup profile in seconds over " << num_ranks_ << " ranks" << std::endl;
+  snprintf(buf, sizeof(buf), "  %-*s  %6s  %10s  %10s  %10s\n", static_cast<int>(name_len), "Phase", "Calls", "Min",
+           "Avg", "Max");
+  app_summary() << buf;
+  for (const auto& s : stats_)
+  {
+    const std::string name = std::string(2 * s.level, ' ') + s.path.substr(s.path.rfind('/') + 1);
+    snprintf(buf, sizeof(buf), "  %-*s  %6ld  %10.4f  %10.4f  %10.4f\n", static_cast<int>(name_len), name.c_str(),
+             s.calls, s.min, s.avg, s.max);
+    app_summary() << buf;
+  }
+  app_summary() << std::endl;
+}
+
+template<class CLOCK>
+bool StartupProfile<CLOCK>::writeJSON(const std::string& fname) const
+{
+  std::ofstream fout(fname);
+  if (!fout)
+    return false;
+  writeJSON(fout, stats_, num_ranks_);
+  return true;
+}
+
+template<class CLOCK>
+void StartupProfile<CLOCK>::reset()
+{
+  phases_.clear();
+  stack_.clear();
+  stats_.clear();
+  finished_ = false;
+}
+
+template class StartupProfile<CPUClock>;
+template class StartupProfile<FakeCPUClock>;
+
+} // namespace qmcplusplus
@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file StartupProfile.h
+ * @brief Profile of the phases from the input to the first step, reduced over the ranks.
+ */
+#ifndef QMCPLUSPLUS_STARTUP_PROFILE_H
+#define QMCPLUSPLUS_STARTUP_PROFILE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Utilities/Clock.h"
+#include "Utilities/TimerManager.h"
+
+class Communicate;
+
+namespace qmcplusplus
+{
+/** wall time of the nested startup phases
+ *
+ * Phases are identified by their path, the names of the enclosing phases and their own joined by '/'.
+ * A phase entered several times accumulates its time and calls. Every rank must enter the same phases
+ * in the same order so that they can be reduced. Once finished, the profile ignores further phases.
+ */
+template<class CLOCK = CPUClock>
+class StartupProfile
+{
+public:
+  struct PhaseStats
+  {
+    std::string path;
+    int level;
+    long calls;
+    double min;
+    double avg;
+    double max;
+  };
+
+  /// begin a phase nested in the current one
+  void push(const std::string& name);
+  /// end the current phase
+  void pop();
+  /// false once finished
+  bool isActive() const { return !finished_; }
+
+  /** the time of each phase with its min, average and max over the ranks of comm, collective over comm
+   * @return the phases in the order they were first entered, valid on the first rank of comm
+   *
+   * If the ranks entered different phases, only the times of the calling rank are returned.
+   */
+  std::vector<PhaseStats> collate(Communicate* comm) const;
+
+  /** end the profile, reduce it over the ranks and print it to app_summary, collective over comm
+   *
+   * Only the first call has an effect, the open phases are abandoned.
+   */
+  void finish(Communicate* comm);
+
+  /** write the profile reduced by finish as JSON, call on the first rank
+   * @return false if the file cannot be written
+   */
+  bool writeJSON(const std::string& fname) const;
+
+  /// write stats as JSON
+  static void writeJSON(std::ostream& os, const std::vector<PhaseStats>& stats, int num_ranks);
+
+  /// clear the phases and start a new profile
+  void reset();
+
+private:
+  struct Phase
+  {
+    std::string path;
+    int level;
+    long calls;
+    double seconds;
+  };
+  /// phases in the order they were first entered
+  std::vector<Phase> phases_;
+  /// the open phases with their start time
+  std::vector<std::pair<size_t, double>> stack_;
+  bool finished_ = false;
+  /// the profile reduced by finish
+  std::vector<PhaseStats> stats_;
+  int num_ranks_ = 1;
+};
+
+extern template class StartupProfile<CPUClock>;
+extern template class StartupProfile<FakeCPUClock>;
+
+extern StartupProfile<CPUClock> startup_profile;
+
+/** a startup phase lasting for the scope, timed both by startup_profile and by a timer of timer_manager
+ *
+ * The timer nests the phase in the TimerManager output, the profile gives the spread over the ranks.
+ */
+class ScopedStartupPhase
+{
+public:
+  ScopedStartupPhase(const std::string& name, timer_levels level = timer_level_coarse)
+      : timer_(*timer_manager.createTimer(name, level))
+  {
+    startup_profile.push(name);
+    timer_.start();
+  }
+
+  ScopedStartupPhase(const ScopedStartupPhase&) = delete;
+  ScopedStartupPhase& operator=(const ScopedStartupPhase&) = delete;
+
+  ~ScopedStartupPhase()
+  {
+    timer_.stop();
+    startup_profile.pop();
+  }
+
+private:
+  NewTimer& timer_;
+};
+
+} // namespace qmcplusplus
+#endif
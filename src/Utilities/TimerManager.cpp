@@ -222,6 +222,13 @@ void TimerManager<TIMER>::get_stack_name_from_id(const StackKey& key, std::strin
   }
 }
 
+template<class TIMER>
+std::string TimerManager<TIMER>::get_timer_name(timer_id_t id) const
+{
+  auto it = timer_id_name.find(id);
+  return it == timer_id_name.end() ? std::string() : it->second;
+}
+
 template<class TIMER>
 void TimerManager<TIMER>::collate_stack_profile(Communicate* comm, StackProfileData& p)
 {
@@ -280,6 +287,127 @@ void TimerManager<TIMER>::collate_stack_profile(Communicate* comm, StackProfileD
 #endif
 }
 
+template<class TIMER>
+void TimerManager<TIMER>::collate_thread_profile(ThreadProfileData& p)
+{
+  // time and calls per thread of all the timers sharing a name
+  std::map<std::string, std::vector<ProfileData>> all_threads;
+  for (int i = 0; i < TimerList.size(); ++i)
+  {
+    const TIMER& timer                = *TimerList[i];
+    const auto& profiles              = timer.get_per_thread_profiles();
+    std::vector<ProfileData>& threads = all_threads[timer.get_name()];
+    if (threads.size() < profiles.size())
+      threads.resize(profiles.size(), ProfileData{0.0, 0.0});
+    for (int ith = 0; ith < profiles.size(); ith++)
+      threads[ith] += ProfileData{profiles[ith].total_time, static_cast<double>(profiles[ith].num_calls)};
+  }
+
+  for (const auto& [name, threads] : all_threads)
+  {
+    int num_threads = 0;
+    double tmin     = std::numeric_limits<double>::max();
+    double tmax     = 0.0;
+    double tsum     = 0.0;
+    for (const ProfileData& pd : threads)
+      if (pd.calls > 0)
+      {
+        num_threads++;
+        tmin = std::min(tmin, pd.time);
+        tmax = std::max(tmax, pd.time);
+        tsum += pd.time;
+      }
+    if (num_threads < 2)
+      continue;
+    const double tavg = tsum / num_threads;
+    p.names.push_back(name);
+    p.threadsList.push_back(num_threads);
+    p.minList.push_back(tmin);
+    p.avgList.push_back(tavg);
+    p.maxList.push_back(tmax);
+    p.imbalanceList.push_back(tavg > 0.0 ? tmax / tavg - 1.0 : 0.0);
+  }
+}
+
+template<class TIMER>
+void TimerManager<TIMER>::collate_counter_profile(CounterProfileData& p)
+{
+  struct CounterData
+  {
+    double time = 0.0;
+    long calls  = 0;
+    PerfCounterValues counters{};
+  };
+  std::map<std::string, CounterData> all_timers;
+  for (int i = 0; i < TimerList.size(); ++i)
+  {
+    const TIMER& timer = *TimerList[i];
+    CounterData& data  = all_timers[timer.get_name()];
+    data.time += timer.get_total();
+    data.calls += timer.get_num_calls();
+    for (int j = 0; j < NUM_PERF_COUNTERS; j++)
+      data.counters[j] += timer.get_counter_total()[j];
+  }
+
+  for (const auto& [name, data] : all_timers)
+  {
+    const PerfCounterValues& c = data.counters;
+    if (c[PERF_CYCLES] == 0)
+      continue;
+    const double bytes = 64.0 * c[PERF_CACHE_MISSES];
+    p.names.push_back(name);
+    p.timeList.push_back(data.time);
+    p.callList.push_back(data.calls);
+    p.countersList.push_back(c);
+    p.ipcList.push_back(static_cast<double>(c[PERF_INSTRUCTIONS]) / c[PERF_CYCLES]);
+    p.missRatioList.push_back(c[PERF_CACHE_REFERENCES] > 0
+                                  ? static_cast<double>(c[PERF_CACHE_MISSES]) / c[PERF_CACHE_REFERENCES]
+                                  : 0.0);
+    p.bandwidthList.push_back(data.time > 0.0 ? bytes / data.time * 1e-9 : 0.0);
+    p.intensityList.push_back(bytes > 0.0 ? c[PERF_INSTRUCTIONS] / bytes : 0.0);
+  }
+}
+
+template<class TIMER>
+void TimerManager<TIMER>::collate_device_profile(const DeviceProfile& dp, DeviceProfileData& p)
+{
+  std::map<std::string, DeviceTimerStats> all_stats;
+  for (const auto& [id, stats] : dp.getStats())
+  {
+    auto it                 = timer_id_name.find(id);
+    DeviceTimerStats& total = all_stats[it != timer_id_name.end() ? it->second : "(no timer)"];
+    total.kernel_time += stats.kernel_time;
+    total.kernel_count += stats.kernel_count;
+    total.transfer_time += stats.transfer_time;
+    total.transfer_count += stats.transfer_count;
+    total.transfer_bytes += stats.transfer_bytes;
+  }
+
+  std::map<std::string, double> host_times;
+  for (int i = 0; i < TimerList.size(); ++i)
+  {
+    const TIMER& timer = *TimerList[i];
+    if (all_stats.find(timer.get_name()) == all_stats.end())
+      continue;
+    double& host_time = host_times[timer.get_name()];
+    for (const auto& profile : timer.get_per_thread_profiles())
+      host_time += profile.total_time;
+  }
+
+  for (const auto& [name, stats] : all_stats)
+  {
+    const double host_time = host_times[name];
+    p.names.push_back(name);
+    p.hostTimeList.push_back(host_time);
+    p.kernelCountList.push_back(stats.kernel_count);
+    p.kernelTimeList.push_back(stats.kernel_time);
+    p.transferCountList.push_back(stats.transfer_count);
+    p.transferBytesList.push_back(stats.transfer_bytes);
+    p.transferTimeList.push_back(stats.transfer_time);
+    p.busyList.push_back(host_time > 0.0 ? (stats.kernel_time + stats.transfer_time) / host_time : 0.0);
+  }
+}
+
 template<class TIMER>
 void TimerManager<TIMER>::print(Communicate* comm)
 {
@@ -293,6 +421,9 @@ void TimerManager<TIMER>::print(Communicate* comm)
   if (comm == nullptr || comm->rank() == 0)
     app_log() << "Stack timer profile" << std::endl;
   print_stack(comm);
+  print_thread(comm);
+  print_counters(comm);
+  print_device(comm);
 #else
   if (comm == nullptr || comm->rank() == 0)
     app_log() << "\nFlat profile" << std::endl;
@@ -396,6 +527,118 @@ void TimerManager<TIMER>::print_stack(Communicate* comm)
 #endif
 }
 
+template<class TIMER>
+void TimerManager<TIMER>::print_thread(Communicate* comm)
+{
+#ifdef ENABLE_TIMERS
+  if (comm != nullptr && comm->rank() != 0)
+    return;
+
+  ThreadProfileData p;
+  collate_thread_profile(p);
+  if (p.names.empty())
+    return;
+
+  int max_name_len = 5;
+  for (const auto& name : p.names)
+    max_name_len = std::max(static_cast<int>(name.size()), max_name_len);
+
+  const int bufsize = 256;
+  char tmpout[bufsize];
+  std::string timer_name;
+  app_log() << std::endl << "Thread timer profile of rank 0, one thread per crowd in the batched drivers" << std::endl;
+  pad_string("Timer", timer_name, max_name_len);
+  snprintf(tmpout, bufsize, "%s  %-7s  %-9s  %-9s  %-9s  %-9s\n", timer_name.c_str(), "Threads", "Min_time", "Avg_time",
+           "Max_time", "Imbalance");
+  app_log() << tmpout;
+  for (int i = 0; i < p.names.size(); i++)
+  {
+    std::string padded_name_str;
+    pad_string(p.names[i], padded_name_str, max_name_len);
+    snprintf(tmpout, bufsize, "%s  %7d  %9.4f  %9.4f  %9.4f  %8.1f%%\n", padded_name_str.c_str(), p.threadsList[i],
+             p.minList[i], p.avgList[i], p.maxList[i], 100.0 * p.imbalanceList[i]);
+    app_log() << tmpout;
+  }
+#endif
+}
+
+template<class TIMER>
+void TimerManager<TIMER>::print_counters(Communicate* comm)
+{
+#ifdef ENABLE_TIMERS
+  if (comm != nullptr && comm->rank() != 0)
+    return;
+
+  CounterProfileData p;
+  collate_counter_profile(p);
+  if (p.names.empty())
+    return;
+
+  int max_name_len = 5;
+  for (const auto& name : p.names)
+    max_name_len = std::max(static_cast<int>(name.size()), max_name_len);
+
+  const int bufsize = 256;
+  char tmpout[bufsize];
+  std::string timer_name;
+  app_log() << std::endl
+            << "Hardware counter profile of the master thread of rank 0, the memory traffic is 64 bytes per LLC miss"
+            << std::endl;
+  pad_string("Timer", timer_name, max_name_len);
+  snprintf(tmpout, bufsize, "%s  %-9s  %-10s  %-10s  %-6s  %-9s  %-9s  %-9s\n", timer_name.c_str(), "Time", "Gcycles",
+           "Ginstr", "IPC", "LLC_miss", "GB/s", "Instr/B");
+  app_log() << tmpout;
+  for (int i = 0; i < p.names.size(); i++)
+  {
+    std::string padded_name_str;
+    pad_string(p.names[i], padded_name_str, max_name_len);
+    snprintf(tmpout, bufsize, "%s  %9.4f  %10.4f  %10.4f  %6.2f  %8.1f%%  %9.3f  %9.3f\n", padded_name_str.c_str(),
+             p.timeList[i], p.countersList[i][PERF_CYCLES] * 1e-9, p.countersList[i][PERF_INSTRUCTIONS] * 1e-9,
+             p.ipcList[i], 100.0 * p.missRatioList[i], p.bandwidthList[i], p.intensityList[i]);
+    app_log() << tmpout;
+  }
+#endif
+}
+
+template<class TIMER>
+void TimerManager<TIMER>::print_device(Communicate* comm)
+{
+#ifdef ENABLE_TIMERS
+  if (comm != nullptr && comm->rank() != 0)
+    return;
+
+  DeviceProfileData p;
+  collate_device_profile(device_profile, p);
+  if (p.names.empty())
+    return;
+
+  int max_name_len = 10;
+  for (const auto& name : p.names)
+    max_name_len = std::max(static_cast<int>(name.size()), max_name_len);
+
+  const int bufsize = 256;
+  char tmpout[bufsize];
+  std::string timer_name;
+  app_log() << std::endl
+            << "Device profile of rank 0, the host time is summed over the threads and busy is the device time "
+               "over the host time"
+            << std::endl;
+  pad_string("Timer", timer_name, max_name_len);
+  snprintf(tmpout, bufsize, "%s  %-9s  %-9s  %-9s  %-9s  %-10s  %-9s  %-6s\n", timer_name.c_str(), "Host", "Kernels",
+           "Kern_time", "Transfers", "MB", "Xfer_time", "Busy");
+  app_log() << tmpout;
+  for (int i = 0; i < p.names.size(); i++)
+  {
+    std::string padded_name_str;
+    pad_string(p.names[i], padded_name_str, max_name_len);
+    snprintf(tmpout, bufsize, "%s  %9.4f  %9ld  %9.4f  %9ld  %10.2f  %9.4f  %5.1f%%\n", padded_name_str.c_str(),
+             p.hostTimeList[i], p.kernelCountList[i], p.kernelTimeList[i], p.transferCountList[i],
+             p.transferBytesList[i] * 1e-6, p.transferTimeList[i], 100.0 * p.busyList[i]);
+    app_log() << tmpout;
+  }
+#endif
+}
+
 template<class TIMER>
 void TimerManager<TIMER>::output_timing(Communicate* comm, Libxml2Document& doc, xmlNodePtr root)
 {
@@ -444,6 +687,60 @@ void TimerManager<TIMER>::output_timing(Communicate* comm, Libxml2Document& doc,
           current_root = node_stack.back();
         }
     }
+
+    ThreadProfileData tp;
+    collate_thread_profile(tp);
+    xmlNodePtr thread_root = doc.addChild(timing_root, "thread_profile");
+    for (int i = 0; i < tp.names.size(); i++)
+    {
+      xmlNodePtr timer = doc.addChild(thread_root, "timer");
+      doc.addChild(timer, "name", tp.names[i]);
+      doc.addChild(timer, "threads", tp.threadsList[i]);
+      doc.addChild(timer, "time_min", tp.minList[i]);
+      doc.addChild(timer, "time_avg", tp.avgList[i]);
+      doc.addChild(timer, "time_max", tp.maxList[i]);
+      doc.addChild(timer, "imbalance", tp.imbalanceList[i]);
+    }
+
+    CounterProfileData cp;
+    collate_counter_profile(cp);
+    if (!cp.names.empty())
+    {
+      xmlNodePtr counter_root = doc.addChild(timing_root, "counter_profile");
+      for (int i = 0; i < cp.names.size(); i++)
+      {
+        xmlNodePtr timer = doc.addChild(counter_root, "timer");
+        doc.addChild(timer, "name", cp.names[i]);
+        doc.addChild(timer, "time", cp.timeList[i]);
+        doc.addChild(timer, "calls", cp.callList[i]);
+        for (int j = 0; j < NUM_PERF_COUNTERS; j++)
+          doc.addChild(timer, PerfCounters::getName(static_cast<PerfCounterEvent>(j)),
+                       static_cast<long>(cp.countersList[i][j]));
+        doc.addChild(timer, "ipc", cp.ipcList[i]);
+        doc.addChild(timer, "llc_miss_ratio", cp.missRatioList[i]);
+        doc.addChild(timer, "bandwidth_gbs", cp.bandwidthList[i]);
+        doc.addChild(timer, "instructions_per_byte", cp.intensityList[i]);
+      }
+    }
+
+    DeviceProfileData dp;
+    collate_device_profile(device_profile, dp);
+    if (!dp.names.empty())
+    {
+      xmlNodePtr device_root = doc.addChild(timing_root, "device_profile");
+      for (int i = 0; i < dp.names.size(); i++)
+      {
+        xmlNodePtr timer = doc.addChild(device_root, "timer");
+        doc.addChild(timer, "name", dp.names[i]);
+        doc.addChild(timer, "host_time", dp.hostTimeList[i]);
+        doc.addChild(timer, "kernels", dp.kernelCountList[i]);
+        doc.addChild(timer, "kernel_time", dp.kernelTimeList[i]);
+        doc.addChild(timer, "transfers", dp.transferCountList[i]);
+        doc.addChild(timer, "transfer_bytes", static_cast<long>(dp.transferBytesList[i]));
+        doc.addChild(timer, "transfer_time", dp.transferTimeList[i]);
+        doc.addChild(timer, "busy", dp.busyList[i]);
+      }
+    }
   }
 
 #endif
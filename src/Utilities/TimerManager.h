@@ -18,12 +18,14 @@
 #ifndef QMCPLUSPLUS_TIMER_MANAGER_H
 #define QMCPLUSPLUS_TIMER_MANAGER_H
 
+#include <array>
 #include <vector>
 #include <string>
 #include <mutex>
 #include <map>
 #include <memory>
 #include "NewTimer.h"
+#include "DeviceProfile.h"
 #include "config.h"
 #include "OhmmsData/Libxml2Doc.h"
 
@@ -66,6 +68,9 @@ private:
 
   void print_flat(Communicate* comm);
   void print_stack(Communicate* comm);
+  void print_thread(Communicate* comm);
+  void print_counters(Communicate* comm);
+  void print_device(Communicate* comm);
 
 public:
 #ifdef USE_VTUNE_TASKS
@@ -97,6 +102,7 @@ public:
 
   void set_timer_threshold(const timer_levels threshold);
   void set_timer_threshold(const std::string& threshold);
+  timer_levels get_timer_threshold() const { return timer_threshold; }
   std::string get_timer_threshold_string() const;
 
   bool maximum_number_of_timers_exceeded() const { return max_timers_exceeded; }
@@ -125,13 +131,75 @@ public:
     callList_t callList;
   };
 
+  /** time of each timer over the threads of the outermost parallel level which called it
+   * Only the timers called by more than one thread are listed.
+   * The imbalance is max / avg - 1, 0 if the threads spent the same time.
+   */
+  struct ThreadProfileData
+  {
+    names_t names;
+    std::vector<int> threadsList;
+    timeList_t minList;
+    timeList_t avgList;
+    timeList_t maxList;
+    timeList_t imbalanceList;
+  };
+
+  /** hardware counters of each timer of the master thread with the derived metrics
+   * Only the timers with counted cycles are listed.
+   * The memory traffic is estimated as 64 bytes per last level cache miss.
+   */
+  struct CounterProfileData
+  {
+    names_t names;
+    timeList_t timeList;
+    callList_t callList;
+    std::vector<PerfCounterValues> countersList;
+    /// instructions per cycle
+    timeList_t ipcList;
+    /// last level cache misses per reference
+    timeList_t missRatioList;
+    /// estimated memory bandwidth in GB/s
+    timeList_t bandwidthList;
+    /// instructions per byte of estimated memory traffic
+    timeList_t intensityList;
+  };
+
+  /** device work of each timer with the host time of the timer summed over the threads
+   * Only the timers with device work are listed, the work outside any timer is listed as "(no timer)".
+   * The busy fraction is the device time over the host time, the device is idle for the rest of the host time.
+   */
+  struct DeviceProfileData
+  {
+    names_t names;
+    timeList_t hostTimeList;
+    callList_t kernelCountList;
+    timeList_t kernelTimeList;
+    callList_t transferCountList;
+    std::vector<size_t> transferBytesList;
+    timeList_t transferTimeList;
+    timeList_t busyList;
+  };
+
   void collate_flat_profile(Communicate* comm, FlatProfileData& p);
 
   void collate_stack_profile(Communicate* comm, StackProfileData& p);
 
+  /// collate the per thread profiles of this rank, the timers of the same name are merged
+  void collate_thread_profile(ThreadProfileData& p);
+
+  /// collate the hardware counters of this rank, the timers of the same name are merged
+  void collate_counter_profile(CounterProfileData& p);
+
+  /// collate the device work of this rank, the timers of the same name are merged
+  void collate_device_profile(const DeviceProfile& dp, DeviceProfileData& p);
+
   void output_timing(Communicate* comm, Libxml2Document& doc, xmlNodePtr root);
 
   void get_stack_name_from_id(const StackKey& key, std::string& name);
+
+  /// return the name of a timer id, empty for an unknown id
+  std::string get_timer_name(timer_id_t id) const;
 };
 
 extern template class TimerManager<NewTimer>;
@@ -139,6 +207,9 @@ extern template class TimerManager<FakeTimer>;
 
 extern TimerManager<NewTimer> timer_manager;
 
+/// names of the timer levels as in --enable-timers
+extern const std::array<std::string, num_timer_levels> timer_level_names;
+
 // Helpers to make it easier to define a set of timers
 // See tests/test_timer.cpp for an example
 
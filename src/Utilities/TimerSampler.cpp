@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file TimerSampler.cpp
+ * @brief Implements TimerSampler
+ */
+#include "TimerSampler.h"
+#include "TimerManager.h"
+
+namespace qmcplusplus
+{
+TimerSampler timer_sampler;
+
+void TimerSampler::configure(timer_levels level, int period)
+{
+  sample_level_ = level;
+  period_       = period;
+  reset();
+}
+
+void TimerSampler::startBlock()
+{
+  if (!isConfigured())
+    return;
+  block_count_++;
+  base_level_ = timer_manager.get_timer_threshold();
+  sampling_   = block_count_ % period_ == 0 && sample_level_ > base_level_;
+  if (sampling_)
+    timer_manager.set_timer_threshold(sample_level_);
+}
+
+void TimerSampler::stopBlock(double block_time)
+{
+  if (!isConfigured())
+    return;
+  block_time_ += block_time;
+  if (sampling_)
+  {
+    timer_manager.set_timer_threshold(base_level_);
+    sampled_blocks_++;
+    sampled_time_ += block_time;
+    sampling_ = false;
+  }
+}
+
+void TimerSampler::report(std::ostream& os) const
+{
+  if (!isConfigured())
+    return;
+  os << "Timer sampling: the " << timer_level_names[sample_level_] << " timers ran in " << sampled_blocks_ << " of "
+     << block_count_ << " blocks, " << sampled_time_ << " of " << block_time_ << " seconds of block time." << std::endl;
+  if (sampled_blocks_ > 0)
+    os << "  Scale the times of the timers above the " << timer_level_names[base_level_] << " level by "
+       << getScale() << " to estimate them over all the blocks." << std::endl;
+}
+
+void TimerSampler::output(Libxml2Document& doc, xmlNodePtr root) const
+{
+  if (!isConfigured())
+    return;
+  xmlNodePtr sampling = doc.addChild(root, "timer_sampling");
+  doc.addChild(sampling, "level", timer_level_names[sample_level_]);
+  doc.addChild(sampling, "period", period_);
+  doc.addChild(sampling, "blocks", block_count_);
+  doc.addChild(sampling, "sampled_blocks", sampled_blocks_);
+  doc.addChild(sampling, "block_time", block_time_);
+  doc.addChild(sampling, "sampled_block_time", sampled_time_);
+  doc.addChild(sampling, "scale", getScale());
+}
+
+void TimerSampler::reset()
+{
+  block_count_    = 0;
+  sampled_blocks_ = 0;
+  block_time_     = 0.0;
+  sampled_time_   = 0.0;
+  sampling_       = false;
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file TimerSampler.h
+ * @brief Enables the detailed timers in a sample of the blocks of a run.
+ */
+#ifndef QMCPLUSPLUS_TIMER_SAMPLER_H
+#define QMCPLUSPLUS_TIMER_SAMPLER_H
+
+#include <iostream>
+#include "NewTimer.h"
+#include "OhmmsData/Libxml2Doc.h"
+
+namespace qmcplusplus
+{
+/** raises the timer threshold of timer_manager during one block out of every period
+ *
+ * The LoopTimer of the drivers starts and stops each block, so every driver is sampled and the blocks are
+ * counted over all the drivers of the run. The last block of each period is sampled, the first block of a
+ * run is left out. The timers above the threshold of the run only accumulate during the sampled blocks
+ * while the others time the whole run. Their times scaled by the ratio of all the block time over the
+ * sampled block time estimate their times over the whole run.
+ * The threshold changes at the block boundaries, only the coarse timers of the driver run across them.
+ */
+class TimerSampler
+{
+public:
+  /** select the blocks to sample
+   * @param level timer threshold of the sampled blocks
+   * @param period one block of every period is sampled, 0 disables the sampling
+   */
+  void configure(timer_levels level, int period);
+  /// true if sampling is configured
+  bool isConfigured() const { return period_ > 0; }
+
+  /// called at the start of each block, raises the timer threshold if the block is sampled
+  void startBlock();
+  /// called at the end of each block, restores the timer threshold
+  void stopBlock(double block_time);
+
+  int getBlocks() const { return block_count_; }
+  int getSampledBlocks() const { return sampled_blocks_; }
+  double getBlockTime() const { return block_time_; }
+  double getSampledBlockTime() const { return sampled_time_; }
+  /// ratio of all the block time over the sampled block time, 0 before any sampled block
+  double getScale() const { return sampled_time_ > 0.0 ? block_time_ / sampled_time_ : 0.0; }
+
+  /// print the sampled fraction of the run and the scale of the sampled timers
+  void report(std::ostream& os) const;
+  /// add the sampling summary to the timing info
+  void output(Libxml2Document& doc, xmlNodePtr root) const;
+
+  /// clear the block counts and times
+  void reset();
+
+private:
+  timer_levels sample_level_ = timer_level_fine;
+  /// threshold restored after a sampled block
+  timer_levels base_level_ = timer_level_coarse;
+  int period_              = 0;
+  /// blocks started so far
+  int block_count_    = 0;
+  int sampled_blocks_ = 0;
+  double block_time_   = 0.0;
+  double sampled_time_ = 0.0;
+  bool sampling_       = false;
+};
+
+extern TimerSampler timer_sampler;
+
+} // namespace qmcplusplus
+#endif
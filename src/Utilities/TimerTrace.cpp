@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file TimerTrace.cpp
+ * @brief Implements TimerTrace
+ */
+#include "TimerTrace.h"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include "Concurrency/OpenMP.h"
+
+namespace qmcplusplus
+{
+TimerTrace timer_trace;
+
+namespace
+{
+/// quote a string for JSON
+std::string quoted(const std::string& in)
+{
+  std::string out("\"");
+  for (char c : in)
+  {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    out += c;
+  }
+  return out + '"';
+}
+} // namespace
+
+void TimerTrace::configure(int first_block, int last_block, size_t capacity)
+{
+  buffers_ = std::vector<ThreadBuffer>(omp_get_max_threads());
+  for (auto& buffer : buffers_)
+    buffer.events.resize(std::max(capacity, size_t(1)));
+  first_block_ = first_block;
+  last_block_  = last_block;
+  reset();
+}
+
+void TimerTrace::startBlock()
+{
+  recording_ = isConfigured() && block_count_ >= first_block_ && block_count_ <= last_block_;
+  block_count_++;
+}
+
+size_t TimerTrace::size() const
+{
+  size_t n = 0;
+  for (const auto& buffer : buffers_)
+    n += std::min(buffer.count, buffer.events.size());
+  return n;
+}
+
+size_t TimerTrace::dropped() const
+{
+  size_t n = 0;
+  for (const auto& buffer : buffers_)
+    n += buffer.count - std::min(buffer.count, buffer.events.size());
+  return n;
+}
+
+void TimerTrace::writeJSON(std::ostream& os, int rank, const std::function<std::string(timer_id_t)>& get_name) const
+{
+  // the times are written in microseconds from the first event kept
+  double origin = std::numeric_limits<double>::max();
+  for (const auto& buffer : buffers_)
+    for (size_t i = 0; i < std::min(buffer.count, buffer.events.size()); i++)
+      origin = std::min(origin, buffer.events[i].begin);
+
+  std::vector<std::string> names(std::numeric_limits<timer_id_t>::max() + 1);
+  for (size_t id = 0; id < names.size(); id++)
+    names[id] = quoted(get_name(id));
+
+  const auto old_flags     = os.flags();
+  const auto old_precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+  os << "{\"traceEvents\":[" << std::endl;
+  os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+  for (int tid = 0; tid < buffers_.size(); tid++)
+  {
+    const ThreadBuffer& buffer = buffers_[tid];
+    if (buffer.count == 0)
+      continue;
+    os << "," << std::endl
+       << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"tid\":" << tid
+       << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+    // oldest event first
+    const size_t capacity = buffer.events.size();
+    const size_t kept     = std::min(buffer.count, capacity);
+    for (size_t i = buffer.count - kept; i < buffer.count; i++)
+    {
+      const Event& event = buffer.events[i % capacity];
+      os << "," << std::endl
+         << "{\"name\":" << names[event.id] << ",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":" << tid
+         << ",\"ts\":" << (event.begin - origin) * 1e6 << ",\"dur\":" << (event.end - event.begin) * 1e6 << "}";
+    }
+  }
+  os << std::endl
+     << "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"first_block\":" << first_block_
+     << ",\"last_block\":" << last_block_ << ",\"dropped_events\":" << dropped() << "}}" << std::endl;
+  os.flags(old_flags);
+  os.precision(old_precision);
+}
+
+void TimerTrace::reset()
+{
+  for (auto& buffer : buffers_)
+    buffer.count = 0;
+  block_count_ = 0;
+  recording_   = false;
+}
+
+} // namespace qmcplusplus
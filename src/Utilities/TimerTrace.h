@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file TimerTrace.h
+ * @brief Ring buffers of the timer events of a range of blocks, written as a Chrome trace.
+ */
+#ifndef QMCPLUSPLUS_TIMER_TRACE_H
+#define QMCPLUSPLUS_TIMER_TRACE_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "NewTimer.h"
+
+namespace qmcplusplus
+{
+/** recorder of the timer events of a range of blocks
+ *
+ * The timers record one event per start/stop pair into the ring buffer of the calling thread,
+ * the thread of the outermost parallel level as in the per thread profiles of the timers.
+ * Each thread only writes its own buffer so the recording is lock free. When a buffer is full,
+ * the oldest events are overwritten. The blocks are counted over all the batched drivers of the run.
+ * The events are written in the Chrome trace event format, readable by chrome://tracing and Perfetto.
+ */
+class TimerTrace
+{
+public:
+  struct Event
+  {
+    double begin;
+    double end;
+    timer_id_t id;
+  };
+
+  /** allocate the buffers and select the blocks to record
+   * @param first_block first block recorded, counting from 0
+   * @param last_block last block recorded
+   * @param capacity number of events kept per thread
+   */
+  void configure(int first_block, int last_block, size_t capacity = 65536);
+  /// true if configure was called
+  bool isConfigured() const { return !buffers_.empty(); }
+  /// true while recording, read by the timers
+  inline bool isRecording() const { return recording_; }
+
+  /// called at the start of each block of the drivers, records the block if it is in the selected range
+  void startBlock();
+  /// called at the end of the blocks of a driver, stops recording
+  void stopBlocks() { recording_ = false; }
+
+  /// record an event of thread thread_id, only called by that thread
+  inline void record(int thread_id, timer_id_t id, double begin, double end)
+  {
+    if (thread_id < buffers_.size())
+    {
+      ThreadBuffer& buffer                               = buffers_[thread_id];
+      buffer.events[buffer.count % buffer.events.size()] = {begin, end, id};
+      buffer.count++;
+    }
+  }
+
+  /// the number of events kept
+  size_t size() const;
+  /// the number of events overwritten in the full buffers
+  size_t dropped() const;
+
+  /** write the events in the Chrome trace event format
+   * @param os output stream
+   * @param rank the process id of the events
+   * @param get_name the name of a timer id
+   */
+  void writeJSON(std::ostream& os, int rank, const std::function<std::string(timer_id_t)>& get_name) const;
+
+  /// clear the events and the block count
+  void reset();
+
+private:
+  /// ring buffer of a thread, on its own cache lines
+  struct alignas(64) ThreadBuffer
+  {
+    std::vector<Event> events;
+    /// number of events recorded, the last events.size() of them are kept
+    size_t count = 0;
+  };
+
+  std::vector<ThreadBuffer> buffers_;
+  int first_block_ = 0;
+  int last_block_  = -1;
+  /// blocks started so far
+  int block_count_ = 0;
+  bool recording_  = false;
+};
+
+extern TimerTrace timer_trace;
+
+} // namespace qmcplusplus
+#endif
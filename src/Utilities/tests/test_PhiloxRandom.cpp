@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Utilities/PhiloxRandom.h"
+
+#include <vector>
+
+namespace qmcplusplus
+{
+TEST_CASE("PhiloxRandom known answers", "[utilities]")
+{
+  // test vectors of the Random123 reference implementation of philox4x32_10
+  uint32_t out[4];
+  PhiloxRandom<double>::generateBlock({0, 0}, 0, 0, out);
+  CHECK(out[0] == 0x6627e8d5);
+  CHECK(out[1] == 0xe169c58d);
+  CHECK(out[2] == 0xbc57ac4c);
+  CHECK(out[3] == 0x9b00dbd8);
+
+  PhiloxRandom<double>::generateBlock({0xa4093822, 0x299f31d0}, 0x85a308d3243f6a88, 0x0370734413198a2e, out);
+  CHECK(out[0] == 0xd16cfe09);
+  CHECK(out[1] == 0x94fdcceb);
+  CHECK(out[2] == 0x5001e420);
+  CHECK(out[3] == 0x24126ea1);
+}
+
+TEST_CASE("PhiloxRandom fill and streams", "[utilities]")
+{
+  PhiloxRandom<double> rng(13, 5);
+  PhiloxRandom<double> rng_fill(13, 5);
+
+  // fill gives the same numbers as the scalar calls, starting in the middle of a block
+  rng();
+  rng_fill();
+  std::vector<double> filled(103);
+  rng_fill.fill(filled.data(), filled.size());
+  for (double r : filled)
+  {
+    CHECK(r == rng());
+    CHECK(r >= 0.0);
+    CHECK(r < 1.0);
+  }
+  CHECK(rng_fill() == rng());
+
+  // a stream only depends on the seed and the stream index
+  PhiloxRandom<double> other(13, 4);
+  other.setStream(5);
+  PhiloxRandom<double> first(13, 5);
+  CHECK(other() == first());
+  PhiloxRandom<double> next_stream(13, 6);
+  CHECK(next_stream() != PhiloxRandom<double>(13, 5)());
+
+  PhiloxRandom<float> rng_float(7);
+  for (int i = 0; i < 100; i++)
+    CHECK(rng_float() < 1.0f);
+}
+
+TEST_CASE("PhiloxRandom save and load", "[utilities]")
+{
+  using DoubleRNG = PhiloxRandom<double>;
+  DoubleRNG rng;
+  rng.init(111);
+
+  for (int i = 0; i < 10; i++)
+    rng();
+
+  std::vector<DoubleRNG::uint_type> state;
+  rng.save(state);
+  CHECK(state.size() == rng.state_size());
+
+  DoubleRNG rng2;
+  rng2.init(110);
+  rng2.load(state);
+  for (int i = 0; i < 10; i++)
+    CHECK(rng2() == rng());
+}
+
+} // namespace qmcplusplus
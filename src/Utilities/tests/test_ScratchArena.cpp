@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+#include "ResourceCollection.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("ScratchArena recycling", "[utilities]")
+{
+  ScratchArena arena;
+  const double* first_data = nullptr;
+  {
+    auto v = arena.getVector<double>(100, 1.0);
+    CHECK(v->size() == 100);
+    CHECK((*v)[99] == 1.0);
+    first_data = v->data();
+    // nested leases of the same type get distinct vectors
+    auto w = arena.getVector<double>(10);
+    CHECK(w->data() != first_data);
+    CHECK((*w)[0] == 0.0);
+    auto i = arena.getVector<int>(5, 3);
+    CHECK((*i)[4] == 3);
+  }
+  CHECK(arena.getNumCreated() == 3);
+  CHECK(arena.getBytes() >= 110 * sizeof(double) + 5 * sizeof(int));
+
+  for (int step = 0; step < 10; step++)
+  {
+    auto v = arena.getVector<double>(50);
+    auto w = arena.getVector<double>(100);
+    CHECK((*v)[0] == 0.0);
+    CHECK((*w)[99] == 0.0);
+  }
+  CHECK(arena.getNumCreated() == 3);
+
+  // nested vectors keep the capacity of their inner vectors
+  {
+    auto nested = arena.lease<std::vector<int>>();
+    nested->resize(2);
+    (*nested)[1].assign(64, 7);
+  }
+  {
+    auto nested = arena.lease<std::vector<int>>();
+    REQUIRE(nested->size() == 2);
+    CHECK((*nested)[1].capacity() >= 64);
+  }
+}
+
+TEST_CASE("ScratchArena in ResourceCollection", "[utilities]")
+{
+  ResourceCollection res("test_res");
+  {
+    auto v = res.getScratchArena().getVector<float>(8);
+  }
+  CHECK(res.getScratchArena().getNumCreated() == 1);
+  // copies of a collection do not share the arena
+  ResourceCollection res_copy(res);
+  CHECK(res_copy.getScratchArena().getNumCreated() == 0);
+
+  ScratchArenaRef ref;
+  ref.attach(res.getScratchArena());
+  CHECK(&ref.get() == &res.getScratchArena());
+  ref.detach();
+  CHECK(&ref.get() != &res.getScratchArena());
+}
+
+} // namespace qmcplusplus
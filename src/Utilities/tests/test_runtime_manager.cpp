@@ -13,6 +13,8 @@
 #include "catch.hpp"
 
 #include "Utilities/RunTimeManager.h"
+#include "Utilities/TimerSampler.h"
+#include "Utilities/TimerManager.h"
 #include <stdio.h>
 #include <string>
 #include <vector>
@@ -76,5 +78,83 @@ TEST_CASE("test_loop_control", "[utilities]")
   REQUIRE(msg.size() > 0);
 }
 
+TEST_CASE("test_loop_control_shorten_block", "[utilities]")
+{
+  // fake clock advances by one every time it is called
+  LoopTimer<FakeCPUClock> loop;
+  RunTimeManager<FakeCPUClock> rm; // fake clock = 0 relative to the start
+  RunTimeControl<FakeCPUClock> rc(rm, 5, "dummy", false);
+  rc.runtime_padding(1.0);
+  rc.loop_margin(1.0);
+
+  loop.start();  // fake clock = 1
+  loop.stop(4);  // fake clock = 2
+  CHECK(loop.get_time_per_iteration() == Approx(1.0));
+  CHECK(loop.get_time_per_step() == Approx(0.25));
+
+  // fake clock = 3, remaining = 5 - 3 = 2, minus the padding fits 4 steps of 0.25 sec
+  int steps = 8;
+  CHECK(!rc.checkStop(loop, steps));
+  CHECK(steps == 4);
+
+  loop.start(); // fake clock = 4
+  loop.stop(4); // fake clock = 5
+  // fake clock = 6, past the limit
+  steps = 8;
+  CHECK(rc.checkStop(loop, steps));
+  CHECK(steps == 0);
+  CHECK(rc.generateStopMessage("QMC", 1).size() > 0);
+}
+
+TEST_CASE("test_loop_control_target_time", "[utilities]")
+{
+  LoopTimer<FakeCPUClock> loop;
+  RunTimeManager<FakeCPUClock> rm;
+  RunTimeControl<FakeCPUClock> rc(rm, 100, "dummy", false);
+  // no step timed yet
+  CHECK(rc.getStepsToFinishAt(loop, 21.0, 4, 5) == 5);
+
+  loop.start();  // fake clock = 1
+  loop.stop(10); // fake clock = 2
+  // fake clock = 3, 18 sec left for 4 blocks of 0.1 sec steps
+  CHECK(rc.getStepsToFinishAt(loop, 21.0, 4, 5) == 45);
+  // at least a step when late
+  CHECK(rc.getStepsToFinishAt(loop, 2.0, 4, 5) == 1);
+}
+
+TEST_CASE("test_timer_sampler", "[utilities]")
+{
+  const timer_levels run_level = timer_manager.get_timer_threshold();
+  timer_manager.set_timer_threshold(timer_level_coarse);
+  timer_sampler.configure(timer_level_fine, 3);
+
+  // each block takes one second of the fake clock
+  LoopTimer<FakeCPUClock> loop;
+  for (int block = 0; block < 7; block++)
+  {
+    loop.start();
+    CHECK(timer_manager.get_timer_threshold() == ((block + 1) % 3 == 0 ? timer_level_fine : timer_level_coarse));
+    loop.stop();
+    CHECK(timer_manager.get_timer_threshold() == timer_level_coarse);
+  }
+
+  CHECK(timer_sampler.getBlocks() == 7);
+  CHECK(timer_sampler.getSampledBlocks() == 2);
+  CHECK(timer_sampler.getBlockTime() == Approx(7.0));
+  CHECK(timer_sampler.getSampledBlockTime() == Approx(2.0));
+  CHECK(timer_sampler.getScale() == Approx(3.5));
+
+  // no sampling at or below the level of the run
+  timer_manager.set_timer_threshold(timer_level_fine);
+  timer_sampler.configure(timer_level_medium, 1);
+  loop.start();
+  CHECK(timer_manager.get_timer_threshold() == timer_level_fine);
+  loop.stop();
+  CHECK(timer_sampler.getSampledBlocks() == 0);
+
+  timer_sampler.configure(timer_level_fine, 0);
+  timer_manager.set_timer_threshold(run_level);
+}
+
 
 } // namespace qmcplusplus
@@ -0,0 +1,85 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <sstream>
+#include "ScalarTable.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("ScalarTable write and read", "[utilities]")
+{
+  const std::vector<std::string> names{"index", "LocalEnergy", "Variance"};
+  {
+    // fewer buffered rows than rows, some are written before the destructor
+    ScalarTableWriter writer("scalar_table_test.bin", names, 2);
+    CHECK(writer.numColumns() == 3);
+    for (int i = 0; i < 5; i++)
+    {
+      const double row[3] = {double(i), -1.5 + i, 0.25 * i};
+      writer.append(row);
+    }
+  }
+
+  ScalarTableReader reader("scalar_table_test.bin");
+  CHECK(reader.getNames() == names);
+  REQUIRE(reader.numRows() == 5);
+  std::vector<double> row;
+  for (int i = 0; i < 5; i++)
+  {
+    REQUIRE(reader.readRow(row));
+    CHECK(row[0] == i);
+    CHECK(row[1] == -1.5 + i);
+    CHECK(row[2] == 0.25 * i);
+  }
+  CHECK(!reader.readRow(row));
+}
+
+TEST_CASE("ScalarTable text", "[utilities]")
+{
+  {
+    ScalarTableWriter writer("scalar_table_text.bin", {"index", "LocalEnergy"});
+    const double row0[2] = {0, -1.25};
+    const double row1[2] = {1, -1.5};
+    writer.append(row0);
+    writer.append(row1);
+  }
+
+  ScalarTableReader reader("scalar_table_text.bin");
+  std::ostringstream os;
+  writeScalarTableText(os, reader);
+  std::istringstream is(os.str());
+  std::string line;
+  std::getline(is, line);
+  CHECK(line.find("#") == 0);
+  CHECK(line.find("LocalEnergy") != std::string::npos);
+  int index;
+  double energy;
+  is >> index >> energy;
+  CHECK(index == 0);
+  CHECK(energy == -1.25);
+  is >> index >> energy;
+  CHECK(index == 1);
+  CHECK(energy == -1.5);
+}
+
+TEST_CASE("ScalarTable not a table", "[utilities]")
+{
+  {
+    std::ofstream fout("scalar_table_bad.bin");
+    fout << "#   index    LocalEnergy" << std::endl;
+  }
+  CHECK_THROWS_AS(ScalarTableReader("scalar_table_bad.bin"), std::runtime_error);
+}
+
+} // namespace qmcplusplus
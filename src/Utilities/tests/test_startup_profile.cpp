@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2022 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include <sstream>
+#include "Utilities/StartupProfile.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("StartupProfile nested phases", "[utilities]")
+{
+  // each clock call advances the time by one second
+  StartupProfile<FakeCPUClock> profile;
+  profile.push("Startup");
+  profile.push("Particles");
+  profile.pop();
+  profile.push("WaveFunction");
+  profile.push("Orbitals");
+  profile.pop();
+  profile.pop();
+  profile.push("Particles");
+  profile.pop();
+  profile.pop();
+  profile.push("Driver");
+  profile.pop();
+
+  auto stats = profile.collate(nullptr);
+  REQUIRE(stats.size() == 5);
+  CHECK(stats[0].path == "Startup");
+  CHECK(stats[0].level == 0);
+  CHECK(stats[0].calls == 1);
+  CHECK(stats[0].max == Approx(9.0));
+  CHECK(stats[1].path == "Startup/Particles");
+  CHECK(stats[1].level == 1);
+  CHECK(stats[1].calls == 2);
+  CHECK(stats[1].avg == Approx(2.0));
+  CHECK(stats[2].path == "Startup/WaveFunction");
+  CHECK(stats[2].avg == Approx(3.0));
+  CHECK(stats[3].path == "Startup/WaveFunction/Orbitals");
+  CHECK(stats[3].level == 2);
+  CHECK(stats[3].min == Approx(1.0));
+  CHECK(stats[4].path == "Driver");
+  CHECK(stats[4].level == 0);
+
+  std::ostringstream os;
+  StartupProfile<FakeCPUClock>::writeJSON(os, stats, 1);
+  const std::string json = os.str();
+  CHECK(json.find("\"ranks\": 1") != std::string::npos);
+  CHECK(json.find("\"name\": \"Orbitals\", \"path\": \"Startup/WaveFunction/Orbitals\", \"level\": 2") !=
+        std::string::npos);
+
+  // phases after finish are ignored
+  profile.finish(nullptr);
+  CHECK(!profile.isActive());
+  CHECK(profile.writeJSON("startup_profile_test.json"));
+  profile.push("Late");
+  profile.pop();
+  CHECK(profile.collate(nullptr).size() == 5);
+
+  profile.reset();
+  CHECK(profile.isActive());
+  CHECK(profile.collate(nullptr).empty());
+}
+
+} // namespace qmcplusplus
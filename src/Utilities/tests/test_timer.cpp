@@ -12,9 +12,11 @@
 
 #include "catch.hpp"
 
+#include <sstream>
 #include <string>
 #include <vector>
 #include "Utilities/TimerManager.h"
+#include "Utilities/TimerTrace.h"
 
 namespace qmcplusplus
 {
@@ -32,6 +34,19 @@ void set_num_calls(TimerType<CLOCK>* timer, long num_calls_input)
   timer->num_calls = num_calls_input;
 }
 
+template<class CLOCK>
+void set_counter_total(TimerType<CLOCK>* timer, const PerfCounterValues& counter_total_input)
+{
+  timer->counter_total = counter_total_input;
+}
+
+template<class CLOCK>
+void set_thread_profile(TimerType<CLOCK>* timer, int thread_id, double total_time_input, long num_calls_input)
+{
+  timer->per_thread_profiles[thread_id].total_time = total_time_input;
+  timer->per_thread_profiles[thread_id].num_calls  = num_calls_input;
+}
+
 
 TEST_CASE("test_timer_stack", "[utilities]")
 {
@@ -398,4 +413,237 @@ TEST_CASE("test setup timers", "[utilities]")
 #endif
 }
 
+TEST_CASE("test_timer_thread_profile", "[utilities]")
+{
+  FakeTimerManager tm;
+  FakeTimer* t1  = tm.createTimer("timer1");
+  FakeTimer* t1b = tm.createTimer("timer1");
+  FakeTimer* t2  = tm.createTimer("timer2");
+  if (t1->get_per_thread_profiles().size() < 3)
+    return;
+
+  // timers of the same name are merged per thread
+  set_thread_profile(t1, 0, 1.0, 2);
+  set_thread_profile(t1b, 0, 1.0, 1);
+  set_thread_profile(t1, 1, 3.0, 2);
+  set_thread_profile(t1b, 2, 5.0, 4);
+  // a timer called by a single thread is not listed
+  set_thread_profile(t2, 1, 2.0, 1);
+
+  FakeTimerManager::ThreadProfileData p;
+  tm.collate_thread_profile(p);
+  REQUIRE(p.names.size() == 1);
+  CHECK(p.names[0] == "timer1");
+  CHECK(p.threadsList[0] == 3);
+  CHECK(p.minList[0] == Approx(2.0));
+  CHECK(p.avgList[0] == Approx(10.0 / 3));
+  CHECK(p.maxList[0] == Approx(5.0));
+  CHECK(p.imbalanceList[0] == Approx(0.5));
+
+  Libxml2Document doc;
+  doc.newDoc("resources");
+  tm.output_timing(NULL, doc, doc.getRoot());
+  doc.dump("tmp6.xml");
+}
+
+#if defined(ENABLE_TIMERS) && defined(_OPENMP)
+TEST_CASE("test_timer_thread_profile_parallel", "[utilities]")
+{
+  TimerManager<NewTimer> tm;
+  tm.set_timer_threshold(timer_level_fine);
+  NewTimer* t1       = tm.createTimer("timer1");
+  const int nthreads = std::min(static_cast<int>(t1->get_per_thread_profiles().size()), 4);
+  int team_size      = 1;
+
+#pragma omp parallel num_threads(nthreads)
+  {
+    const int ith = omp_get_thread_num();
+#pragma omp master
+    team_size = omp_get_num_threads();
+    for (int i = 0; i <= ith; i++)
+    {
+      ScopedTimer local(*t1);
+    }
+  }
+
+  const auto& profiles = t1->get_per_thread_profiles();
+  for (int ith = 0; ith < team_size; ith++)
+    CHECK(profiles[ith].num_calls == ith + 1);
+  // only the master thread feeds the rank level totals
+  CHECK(t1->get_num_calls() == 1);
+}
+#endif
+
+TEST_CASE("test_timer_trace", "[utilities]")
+{
+  FakeTimerManager tm;
+  FakeTimer* t1 = tm.createTimer("timer1", timer_level_coarse);
+  FakeTimer* t2 = tm.createTimer("timer2", timer_level_coarse);
+
+  // only block 1 is recorded, two events are kept per thread
+  TimerTrace trace;
+  trace.configure(1, 1, 2);
+  CHECK(!trace.isRecording());
+  trace.startBlock();
+  CHECK(!trace.isRecording());
+  trace.startBlock();
+  CHECK(trace.isRecording());
+  trace.record(0, t1->get_id(), 1.0, 1.5);
+  trace.record(0, t2->get_id(), 2.0, 2.25);
+  trace.record(0, t1->get_id(), 3.0, 4.0);
+  trace.stopBlocks();
+  CHECK(!trace.isRecording());
+  trace.startBlock();
+  CHECK(!trace.isRecording());
+  CHECK(trace.size() == 2);
+  CHECK(trace.dropped() == 1);
+
+  std::ostringstream out;
+  trace.writeJSON(out, 3, [&tm](timer_id_t id) { return tm.get_timer_name(id); });
+  const std::string json = out.str();
+  // the oldest event was overwritten, the times are in microseconds from the first event kept
+  const std::string event2 = R"({"name":"timer2","ph":"X","pid":3,"tid":0,"ts":0.000,"dur":250000.000})";
+  const std::string event3 = R"({"name":"timer1","ph":"X","pid":3,"tid":0,"ts":1000000.000,"dur":1000000.000})";
+  CHECK(json.find(event2) != std::string::npos);
+  CHECK(json.find(event3) != std::string::npos);
+  CHECK(json.find(R"("dropped_events":1)") != std::string::npos);
+
+#if defined(ENABLE_TIMERS) && defined(USE_STACK_TIMERS)
+  // the timers record into the global trace
+  FakeCPUClock::fake_cpu_clock_increment = 1.0;
+  timer_trace.configure(0, 0);
+  timer_trace.startBlock();
+  t1->start();
+  t2->start();
+  t2->stop();
+  t1->stop();
+  timer_trace.stopBlocks();
+  t1->start();
+  t1->stop();
+  CHECK(timer_trace.size() == 2);
+  timer_trace.reset();
+#endif
+}
+
+TEST_CASE("test_timer_counter_profile", "[utilities]")
+{
+  FakeTimerManager tm;
+  FakeTimer* t1  = tm.createTimer("timer1");
+  FakeTimer* t1b = tm.createTimer("timer1");
+  FakeTimer* t2  = tm.createTimer("timer2");
+  tm.createTimer("timer3");
+
+  // timers of the same name are merged, a timer without counted cycles is not listed
+  set_total_time(t1, 1.0);
+  set_total_time(t1b, 1.0);
+  set_num_calls(t1, 3);
+  set_counter_total(t1, {1000, 1500, 200, 50});
+  set_counter_total(t1b, {1000, 500, 200, 50});
+  set_total_time(t2, 0.5);
+  set_counter_total(t2, {400, 1600, 0, 0});
+
+  FakeTimerManager::CounterProfileData p;
+  tm.collate_counter_profile(p);
+  REQUIRE(p.names.size() == 2);
+  CHECK(p.names[0] == "timer1");
+  CHECK(p.timeList[0] == Approx(2.0));
+  CHECK(p.callList[0] == 3);
+  CHECK(p.countersList[0][PERF_CACHE_MISSES] == 100);
+  CHECK(p.ipcList[0] == Approx(1.0));
+  CHECK(p.missRatioList[0] == Approx(0.25));
+  CHECK(p.bandwidthList[0] == Approx(6400 / 2.0 * 1e-9));
+  CHECK(p.intensityList[0] == Approx(2000 / 6400.0));
+  CHECK(p.names[1] == "timer2");
+  CHECK(p.ipcList[1] == Approx(4.0));
+  CHECK(p.missRatioList[1] == 0.0);
+  CHECK(p.intensityList[1] == 0.0);
+
+  t1->reset();
+  CHECK(t1->get_counter_total()[PERF_CYCLES] == 0);
+}
+
+TEST_CASE("test_perf_counters", "[utilities]")
+{
+  PerfCounters counters;
+  PerfCounterValues start, end;
+  // the counters may not be available, e.g. in virtual machines or with a restrictive perf_event_paranoid
+  if (!counters.open())
+  {
+    CHECK(!counters.isOpen());
+    counters.read(start);
+    CHECK(start[PERF_CYCLES] == 0);
+    return;
+  }
+  counters.read(start);
+  volatile double sum = 0.0;
+  for (int i = 0; i < 100000; i++)
+    sum = sum + i;
+  counters.read(end);
+  CHECK(end[PERF_CYCLES] > start[PERF_CYCLES]);
+  if (counters.isCounted(PERF_INSTRUCTIONS))
+    CHECK(end[PERF_INSTRUCTIONS] > start[PERF_INSTRUCTIONS] + 100000);
+  counters.close();
+  CHECK(!counters.isOpen());
+}
+
+TEST_CASE("test_timer_device_profile", "[utilities]")
+{
+  FakeTimerManager tm;
+  FakeTimer* t1  = tm.createTimer("timer1");
+  FakeTimer* t1b = tm.createTimer("timer1");
+  FakeTimer* t2  = tm.createTimer("timer2");
+  tm.createTimer("timer3");
+
+  // the host time is summed over the threads
+  set_thread_profile(t1, 0, 1.0, 1);
+  set_thread_profile(t1b, 0, 1.0, 1);
+  set_total_time(t2, 2.0);
+  set_thread_profile(t2, 0, 2.0, 1);
+
+  DeviceProfile dp;
+  dp.addKernels(t1->get_id(), 0.5, 4);
+  dp.addTransfer(t1b->get_id(), 0.5, 1000);
+  dp.addTransfer(t1->get_id(), 0.25, 24);
+  dp.addKernels(0, 0.1);
+
+  FakeTimerManager::DeviceProfileData p;
+  tm.collate_device_profile(dp, p);
+  // a timer without device work is not listed
+  REQUIRE(p.names.size() == 2);
+  CHECK(p.names[0] == "(no timer)");
+  CHECK(p.kernelTimeList[0] == Approx(0.1));
+  CHECK(p.busyList[0] == 0.0);
+  CHECK(p.names[1] == "timer1");
+  CHECK(p.hostTimeList[1] == Approx(2.0));
+  CHECK(p.kernelCountList[1] == 4);
+  CHECK(p.kernelTimeList[1] == Approx(0.5));
+  CHECK(p.transferCountList[1] == 2);
+  CHECK(p.transferBytesList[1] == 1024);
+  CHECK(p.transferTimeList[1] == Approx(0.75));
+  CHECK(p.busyList[1] == Approx(0.625));
+
+  dp.reset();
+  CHECK(dp.getStats().empty());
+}
+
+#ifdef ENABLE_TIMERS
+TEST_CASE("test_timer_innermost_id", "[utilities]")
+{
+  FakeTimerManager tm;
+  tm.set_timer_threshold(timer_level_fine);
+  FakeTimer* t1 = tm.createTimer("timer1");
+  FakeTimer* t2 = tm.createTimer("timer2");
+
+  CHECK(get_innermost_timer_id() == 0);
+  t1->start();
+  CHECK(get_innermost_timer_id() == t1->get_id());
+  t2->start();
+  CHECK(get_innermost_timer_id() == t2->get_id());
+  t2->stop();
+  CHECK(get_innermost_timer_id() == t1->get_id());
+  t1->stop();
+  CHECK(get_innermost_timer_id() == 0);
+}
+#endif
+
 } // namespace qmcplusplus
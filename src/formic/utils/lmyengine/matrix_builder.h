@@ -119,6 +119,21 @@ namespace cqmc {
         /// \brief flag to tell whether to compute 1rdm 
         bool _compute_rdm;
 
+        /// \brief number of samples buffered by each thread before they are added to the matrices in one gemm
+        static constexpr int _samp_block_size = 64;
+
+        /// \brief per thread buffers of the samples not yet added to the matrices, one sample per column: bare
+        ///        derivative ratios, energy (or harmonic davidson) derivative ratios, S^2 derivative ratios,
+        ///        weights and the weighted conjugate left vectors of the gemm
+        std::vector<formic::Matrix<S> > _der_buf;
+        std::vector<formic::Matrix<S> > _eng_buf;
+        std::vector<formic::Matrix<S> > _ss_buf;
+        std::vector<std::vector<double> > _ww_buf;
+        std::vector<formic::Matrix<S> > _left_buf;
+
+        /// \brief number of samples in the buffers of each thread
+        std::vector<int> _nbuf;
+
       public:
         
       //////////////////////////////////////////////////////////////////////////////////////////////
@@ -168,6 +183,12 @@ namespace cqmc {
         _smat_temp.resize(NumThreads);
         _ssmat_temp.resize(NumThreads);
         _one_rdm_temp.resize(NumThreads);
+        _der_buf.resize(NumThreads);
+        _eng_buf.resize(NumThreads);
+        _ss_buf.resize(NumThreads);
+        _ww_buf.resize(NumThreads);
+        _left_buf.resize(NumThreads);
+        _nbuf.assign(NumThreads, 0);
 
         // size the matrix correctly
         int ndim = _num_params + 1;
@@ -175,6 +196,7 @@ namespace cqmc {
           _hmat_temp[ip].reset(ndim, ndim, formic::zero(S()));
           _smat_temp[ip].reset(ndim, ndim, formic::zero(S()));
           _ssmat_temp[ip].reset(ndim, ndim, formic::zero(S()));
+          this->reset_sample_buffers(ip, ndim);
         }
 
       }
@@ -215,10 +237,73 @@ namespace cqmc {
           _hmat_temp[ip].reset(ndim, ndim, formic::zero(S()));
           _smat_temp[ip].reset(ndim, ndim, formic::zero(S()));
           _ssmat_temp[ip].reset(ndim, ndim, formic::zero(S()));
+          this->reset_sample_buffers(ip, ndim);
         }
 
       }
 
+      /////////////////////////////////////////////////////////////////////////////////////////////
+      // \brief size the sample buffers of a thread and empty them
+      //
+      /////////////////////////////////////////////////////////////////////////////////////////////
+      void reset_sample_buffers(const int ip, const int ndim)
+      {
+        _der_buf[ip].reset(ndim, _samp_block_size, formic::zero(S()));
+        _eng_buf[ip].reset(ndim, _samp_block_size, formic::zero(S()));
+        _ss_buf[ip].reset(ndim, _samp_block_size, formic::zero(S()));
+        _left_buf[ip].reset(ndim, _samp_block_size, formic::zero(S()));
+        _ww_buf[ip].assign(_samp_block_size, 0.0);
+        _nbuf[ip] = 0;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////
+      // \brief add the buffered samples of a thread to its matrices, one gemm per matrix
+      //
+      /////////////////////////////////////////////////////////////////////////////////////////////
+      void flush_sample_buffers(const int ip)
+      {
+        const int nb = _nbuf[ip];
+        if ( nb == 0 )
+          return;
+        const int ndim = _der_buf[ip].rows();
+
+        // the weighted conjugate of the given buffer, left factor of the rank-nb update
+        auto weighted_conj = [&](const formic::Matrix<S> & buf) {
+          for (int s = 0; s < nb; s++)
+            for (int i = 0; i < ndim; i++)
+              _left_buf[ip].at(i, s) = _ww_buf[ip].at(s) * formic::conj(buf.at(i, s));
+        };
+
+        weighted_conj(_der_buf[ip]);
+
+        // hamiltonian matrix 
+        formic::xgemm('N', 'T', ndim, ndim, nb, formic::unity(S()), &_left_buf[ip].at(0,0), ndim, &_eng_buf[ip].at(0,0), ndim, formic::unity(S()), &_hmat_temp[ip].at(0,0), ndim);
+
+        // for ground state calculations 
+        if ( _ground_state ) {
+
+          // overlap matrix 
+          formic::xgemm('N', 'T', ndim, ndim, nb, formic::unity(S()), &_left_buf[ip].at(0,0), ndim, &_der_buf[ip].at(0,0), ndim, formic::unity(S()), &_smat_temp[ip].at(0,0), ndim);
+
+          // spin matrix if requested 
+          if ( _ss_build ) 
+            formic::xgemm('N', 'T', ndim, ndim, nb, formic::unity(S()), &_left_buf[ip].at(0,0), ndim, &_ss_buf[ip].at(0,0), ndim, formic::unity(S()), &_ssmat_temp[ip].at(0,0), ndim);
+        }
+
+        // for excited state calculations 
+        else {
+
+          // normal linear method overlap matrix 
+          formic::xgemm('N', 'T', ndim, ndim, nb, formic::unity(S()), &_left_buf[ip].at(0,0), ndim, &_der_buf[ip].at(0,0), ndim, formic::unity(S()), &_ssmat_temp[ip].at(0,0), ndim);
+
+          // overlap matrix 
+          weighted_conj(_eng_buf[ip]);
+          formic::xgemm('N', 'T', ndim, ndim, nb, formic::unity(S()), &_left_buf[ip].at(0,0), ndim, &_eng_buf[ip].at(0,0), ndim, formic::unity(S()), &_smat_temp[ip].at(0,0), ndim);
+        }
+
+        _nbuf[ip] = 0;
+      }
+
       /////////////////////////////////////////////////////////////////////////////////////////////
       // \brief build harmonic davidson matrix
       //
@@ -414,55 +499,37 @@ namespace cqmc {
           _smat_temp.at(myThread).reset(ndim, ndim, formic::zero(S()));
         if ( _ssmat_temp.at(myThread).rows() != _ssmat_temp.at(myThread).cols() || _ssmat_temp.at(myThread).rows() != der_rat_samp.size() ) 
           _ssmat_temp.at(myThread).reset(ndim, ndim, formic::zero(S()));
+        if ( _der_buf.at(myThread).rows() != der_rat_samp.size() ) 
+          this->reset_sample_buffers(myThread, ndim);
 
         //std::cout << boost::format("entering take_sample function in matrix build3") << std::endl;
 
-        // include the value to guiding square ratio in the weight 
-        const double ww = weight_samp * vgs_samp;
-
-        // take the complex conjugation of der_rat
-        std::vector<S> der_rat_samp_ct(der_rat_samp.size(), formic::zero(S()));
-        for (int i = 0; i < der_rat_samp.size(); i++)
-          der_rat_samp_ct.at(i) = formic::conj(der_rat_samp.at(i));
-
-        // for ground state calculations 
-        if ( _ground_state ) {
-           
-          // add contribution to hamiltonian matrix 
-          formic::xgemm('N', 'N', ndim, ndim, 1, ww * formic::unity(S()), &der_rat_samp_ct.at(0), ndim, &le_der_samp.at(0), 1, formic::unity(S()), &(_hmat_temp.at(myThread).at(0,0)), ndim);
-
-          // add contribution to overlap matrix 
-          formic::xgemm('N', 'N', ndim, ndim, 1, ww * formic::unity(S()), &der_rat_samp_ct.at(0), ndim, &der_rat_samp.at(0), 1, formic::unity(S()), &(_smat_temp.at(myThread).at(0,0)), ndim);
-
-          // add contribution to spin matrix if requested 
-          if ( _ss_build ) 
-            formic::xgemm('N', 'N', ndim, ndim, 1, ww * formic::unity(S()), &der_rat_samp_ct.at(0), ndim, &ls_der_samp.at(0), 1, formic::unity(S()), &(_ssmat_temp.at(myThread).at(0,0)), ndim);
+        // buffer the sample, the matrices get the contributions of a whole block of samples at once 
+        const int s = _nbuf.at(myThread);
 
+        // include the value to guiding square ratio in the weight 
+        _ww_buf.at(myThread).at(s) = weight_samp * vgs_samp;
+
+        // for ground state calculations energy derivative ratios, for excited states combine bare and energy
+        // derivative ratio with respect to harmonic davidson shift 
+        formic::Matrix<S> & der_buf = _der_buf.at(myThread);
+        formic::Matrix<S> & eng_buf = _eng_buf.at(myThread);
+        for (int i = 0; i < ndim; i++) {
+          der_buf.at(i, s) = der_rat_samp.at(i);
+          eng_buf.at(i, s) = _ground_state ? le_der_samp.at(i) : _hd_shift * der_rat_samp.at(i) - le_der_samp.at(i);
         }
-        
-        // for excited state calculations 
-        else {
-        
-          // combine bare and energy derivative ratio with respect to harmonic davidson shift 
-          std::vector<S> hle_der_samp(ndim, formic::zero(S()));
-          for ( int i = 0; i < ndim; i++) 
-            hle_der_samp.at(i) = _hd_shift * der_rat_samp.at(i) - le_der_samp.at(i);
 
-          // take the complex conjugation of hle_der_samp
-          std::vector<S> hle_der_samp_ct(ndim, formic::zero(S()));
+        // S^2 derivative ratios if requested 
+        if ( _ground_state && _ss_build ) {
+          formic::Matrix<S> & ss_buf = _ss_buf.at(myThread);
           for (int i = 0; i < ndim; i++) 
-            hle_der_samp_ct.at(i) = formic::conj(hle_der_samp.at(i));
-
-          // add contribution to hailtonian matrix 
-          formic::xgemm('N', 'N', ndim, ndim, 1, ww*formic::unity(S()), &der_rat_samp_ct.at(0), ndim, &hle_der_samp.at(0), 1, formic::unity(S()), &(_hmat_temp.at(myThread).at(0,0)), ndim);
-
-          // add contribution to overlap matrix
-          formic::xgemm('N', 'N', ndim, ndim, 1, ww*formic::unity(S()), &hle_der_samp_ct.at(0), ndim, &hle_der_samp.at(0), 1, formic::unity(S()), &(_smat_temp.at(myThread).at(0,0)), ndim);
-
-          // add contribution to spin matrix if requested 
-          formic::xgemm('N', 'N', ndim, ndim, 1, ww * formic::unity(S()), &der_rat_samp_ct.at(0), ndim, &der_rat_samp.at(0), 1, formic::unity(S()), &(_ssmat_temp.at(myThread).at(0,0)), ndim);
-
+            ss_buf.at(i, s) = ls_der_samp.at(i);
         }
+
+        // add the block to the matrices once it is full 
+        _nbuf.at(myThread) = s + 1;
+        if ( _nbuf.at(myThread) == _samp_block_size ) 
+          this->flush_sample_buffers(myThread);
       }
 
       /////////////////////////////////////////////////////////////////////////////////////////////
@@ -512,6 +579,10 @@ namespace cqmc {
         // get thread number 
         int myThread = omp_get_thread_num();
 
+        // add the samples left in the buffers of each thread 
+        for (int ip = 0; ip < NumThreads; ip++) 
+          this->flush_sample_buffers(ip);
+
         // sum over threads
         for (int ip = 1; ip < NumThreads; ip++) {
           _hmat_temp[0] += _hmat_temp[ip];
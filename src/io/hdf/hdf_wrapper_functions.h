@@ -350,7 +350,8 @@ inline bool h5d_append(hid_t grp,
                        const hsize_t* dims,
                        const T* first,
                        hsize_t chunk_size = 1,
-                       hid_t xfer_plist   = H5P_DEFAULT)
+                       hid_t xfer_plist   = H5P_DEFAULT,
+                       int deflate_level  = 0)
 {
   //app_log()<<omp_get_thread_num()<<"  h5d_append  group = "<<grp<<"  name = "<<aname.c_str()<< std::endl;
   if (grp < 0)
@@ -381,6 +382,9 @@ inline bool h5d_append(hid_t grp,
     hid_t sl = H5Pset_layout(p, H5D_CHUNKED);
     // set chunk size
     hid_t cs = H5Pset_chunk(p, ndims, chunk_dims.data());
+    // compress the chunks
+    if (deflate_level > 0)
+      H5Pset_deflate(p, deflate_level);
     // create the dataset
     dataset = H5Dcreate2(grp, aname.c_str(), h5d_type_id, dataspace, H5P_DEFAULT, p, H5P_DEFAULT);
     // create memory dataspace, size of current buffer
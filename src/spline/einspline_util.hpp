@@ -20,6 +20,7 @@
 
 #include "mpi/mpi_datatype.h"
 #include "Message/CommOperators.h"
+#include "Message/NodeSharedArray.h"
 #include "OhmmsData/FileUtility.h"
 #include "hdf/hdf_archive.h"
 #include "einspline/multi_bspline_copy.h"
@@ -55,6 +56,23 @@ inline void chunked_bcast(Communicate* comm, ENGT* buffer)
   chunked_bcast(comm, buffer->coefs, buffer->coefs_size);
 }
 
+/** store the table of the first rank of comm once per node and make the table of every rank use it
+ * @param comm communicator of the ranks holding the table, collective over comm
+ * @param table MultiBspline, complete on the first rank of comm
+ * @return the node shared coefficients, they must outlive the table
+ */
+template<typename T, typename MBSPLINE>
+inline std::shared_ptr<NodeSharedArray<T>> share_tables_on_node(Communicate* comm, MBSPLINE& table)
+{
+  auto* spline = table.getSplinePtr();
+  auto shared  = std::make_shared<NodeSharedArray<T>>(*comm, spline->coefs_size);
+  if (comm->rank() == 0)
+    std::copy_n(spline->coefs, spline->coefs_size, shared->data());
+  shared->bcast();
+  table.useExternalCoefs(shared->data());
+  return shared;
+}
+
 template<typename ENGT>
 inline void gatherv(Communicate* comm, ENGT* buffer, const int ncol, std::vector<int>& offset)
 {
@@ -69,10 +69,18 @@ public:
 
   void destroy(SplineType* spline)
   {
-    coefs_allocator.deallocate(spline->coefs, spline->coefs_size);
+    deallocateCoefs(spline);
     multi_spline_allocator.deallocate(spline, 1);
   }
 
+  /// free the coefficients of a multi-bspline structure, coefs is left nullptr
+  void deallocateCoefs(SplineType* spline)
+  {
+    if (spline->coefs != nullptr)
+      coefs_allocator.deallocate(spline->coefs, spline->coefs_size);
+    spline->coefs = nullptr;
+  }
+
   void destroy(SingleSplineType* spline)
   {
     coefs_allocator.deallocate(spline->coefs, spline->coefs_size);
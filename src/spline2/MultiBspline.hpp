@@ -19,6 +19,8 @@
 #ifndef QMCPLUSPLUS_MULTIEINSPLINE_COMMON_HPP
 #define QMCPLUSPLUS_MULTIEINSPLINE_COMMON_HPP
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <type_traits>
 #include "config.h"
@@ -47,16 +49,22 @@ private:
   SplineType* spline_m;
   ///use allocator
   BsplineAllocator<T, COEFS_ALLOC, MULTI_SPLINE_ALLOC, SINGLE_SPLINE_ALLOC> myAllocator;
+  ///true if the coefficients are owned by the caller of useExternalCoefs
+  bool external_coefs_;
 
 public:
-  MultiBspline() : spline_m(nullptr) {}
+  MultiBspline() : spline_m(nullptr), external_coefs_(false) {}
   MultiBspline(const MultiBspline& in) = delete;
   MultiBspline& operator=(const MultiBspline& in) = delete;
 
   ~MultiBspline()
   {
     if (spline_m != nullptr)
+    {
+      if (external_coefs_)
+        spline_m->coefs = nullptr;
       myAllocator.destroy(spline_m);
+    }
   }
 
   SplineType* getSplinePtr() { return spline_m; }
@@ -95,6 +103,20 @@ public:
       throw std::runtime_error("MultiBspline::spline_m cannot be created twice!\n");
   }
 
+  /** replace the coefficients by an external copy of the table and free the own ones
+   * @param coefs coefs_size coefficients in the layout of the table, e.g. in node shared memory.
+   *        The storage is not freed by this object and must outlive it.
+   */
+  void useExternalCoefs(T* coefs)
+  {
+    if (spline_m == nullptr)
+      throw std::runtime_error("The internal storage of MultiBspline must be created first!\n");
+    if (!external_coefs_)
+      myAllocator.deallocateCoefs(spline_m);
+    spline_m->coefs = coefs;
+    external_coefs_ = true;
+  }
+
   void flush_zero() const
   {
     if (spline_m != nullptr)
@@ -123,6 +145,35 @@ public:
     const int BaseN[3]      = {spline_m->x_grid.num + 3, spline_m->y_grid.num + 3, spline_m->z_grid.num + 3};
     myAllocator.copy(aSpline, spline_m, i, BaseOffset, BaseN);
   }
+
+  /** relative deviation of the stored spline i from aSpline, max|c_i - c| / max|c|
+   * @param aSpline UBspline_3d_(d,s) previously copied by copy_spline
+   * @param i index of aSpline
+   *
+   * The B-spline basis functions are non-negative and sum to one. max|c_i - c| bounds
+   * the error of the spline values introduced by the storage precision.
+   */
+  template<typename SingleSpline>
+  double copy_error(const SingleSpline* aSpline, int i) const
+  {
+    if (spline_m == nullptr)
+      throw std::runtime_error("The internal storage of MultiBspline must be created first!\n");
+    const intptr_t n0 = spline_m->x_grid.num + 3, n1 = spline_m->y_grid.num + 3, n2 = spline_m->z_grid.num + 3;
+    double max_diff = 0, max_coef = 0;
+    for (intptr_t ix = 0; ix < n0; ++ix)
+      for (intptr_t iy = 0; iy < n1; ++iy)
+      {
+        const T* restrict out = spline_m->coefs + ix * spline_m->x_stride + iy * spline_m->y_stride + i;
+        const auto* restrict in = aSpline->coefs + ix * aSpline->x_stride + iy * aSpline->y_stride;
+        for (intptr_t iz = 0; iz < n2; ++iz)
+        {
+          const double c = in[iz];
+          max_diff       = std::max(max_diff, std::abs(static_cast<double>(out[iz * spline_m->z_stride]) - c));
+          max_coef       = std::max(max_coef, std::abs(c));
+        }
+      }
+    return max_coef > 0 ? max_diff / max_coef : max_diff;
+  }
 };
 
 } // namespace qmcplusplus
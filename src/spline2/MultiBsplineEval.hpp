@@ -51,6 +51,19 @@ inline void evaluate3d(const SPLINET& spline, const PT& r, VT& psi, int first, i
   evaluate_v_impl(spline, r[0], r[1], r[2], psi.data() + first, first, last);
 }
 
+/// evaluate values, gradients optionally in the range [first,last)
+template<typename SPLINET, typename PT, typename VT, typename GT>
+inline void evaluate3d_vg(const SPLINET& spline, const PT& r, VT& psi, GT& grad)
+{
+  evaluate_vg_impl(spline, r[0], r[1], r[2], psi.data(), grad.data(), psi.size(), 0, psi.size());
+}
+
+template<typename SPLINET, typename PT, typename VT, typename GT>
+inline void evaluate3d_vg(const SPLINET& spline, const PT& r, VT& psi, GT& grad, int first, int last)
+{
+  evaluate_vg_impl(spline, r[0], r[1], r[2], psi.data() + first, grad.data() + first, psi.size(), first, last);
+}
+
 /// evaluate values, gradients, laplacians optionally in the range [first,last)
 template<typename SPLINET, typename PT, typename VT, typename GT, typename LT>
 inline void evaluate3d_vgl(const SPLINET& spline, const PT& r, VT& psi, GT& grad, LT& lap)
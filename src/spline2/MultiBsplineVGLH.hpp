@@ -25,6 +25,81 @@
 
 namespace spline2
 {
+/** evaluate values and gradients only, skipping all the second derivatives
+ */
+template<typename T>
+inline void evaluate_vg_impl(const typename qmcplusplus::bspline_traits<T, 3>::SplineType* restrict spline_m,
+                             T x,
+                             T y,
+                             T z,
+                             T* restrict vals,
+                             T* restrict grads,
+                             size_t out_offset,
+                             int first,
+                             int last)
+{
+  int ix, iy, iz;
+  T a[4], b[4], c[4], da[4], db[4], dc[4], d2a[4], d2b[4], d2c[4];
+
+  computeLocationAndFractional(spline_m, x, y, z, ix, iy, iz, a, b, c, da, db, dc, d2a, d2b, d2c);
+
+  const intptr_t xs = spline_m->x_stride;
+  const intptr_t ys = spline_m->y_stride;
+  const intptr_t zs = spline_m->z_stride;
+
+  const int num_splines = last - first;
+
+  T* restrict gx = grads;
+  T* restrict gy = grads + out_offset;
+  T* restrict gz = grads + 2 * out_offset;
+
+  std::fill(vals, vals + num_splines, T());
+  std::fill(gx, gx + num_splines, T());
+  std::fill(gy, gy + num_splines, T());
+  std::fill(gz, gz + num_splines, T());
+
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++)
+    {
+      const T pre10 = da[i] * b[j];
+      const T pre00 = a[i] * b[j];
+      const T pre01 = a[i] * db[j];
+
+      const T* restrict coefs    = spline_m->coefs + ((ix + i) * xs + (iy + j) * ys + iz * zs) + first;
+      const T* restrict coefszs  = coefs + zs;
+      const T* restrict coefs2zs = coefs + 2 * zs;
+      const T* restrict coefs3zs = coefs + 3 * zs;
+
+#pragma omp simd aligned(coefs, coefszs, coefs2zs, coefs3zs, gx, gy, gz, vals: QMC_SIMD_ALIGNMENT)
+      for (int n = 0; n < num_splines; n++)
+      {
+        const T coefsv    = coefs[n];
+        const T coefsvzs  = coefszs[n];
+        const T coefsv2zs = coefs2zs[n];
+        const T coefsv3zs = coefs3zs[n];
+
+        T sum0 = c[0] * coefsv + c[1] * coefsvzs + c[2] * coefsv2zs + c[3] * coefsv3zs;
+        T sum1 = dc[0] * coefsv + dc[1] * coefsvzs + dc[2] * coefsv2zs + dc[3] * coefsv3zs;
+        gx[n] += pre10 * sum0;
+        gy[n] += pre01 * sum0;
+        gz[n] += pre00 * sum1;
+        vals[n] += pre00 * sum0;
+      }
+    }
+
+  const T dxInv = spline_m->x_grid.delta_inv;
+  const T dyInv = spline_m->y_grid.delta_inv;
+  const T dzInv = spline_m->z_grid.delta_inv;
+
+#pragma omp simd aligned(gx, gy, gz: QMC_SIMD_ALIGNMENT)
+  for (int n = 0; n < num_splines; n++)
+  {
+    gx[n] *= dxInv;
+    gy[n] *= dyInv;
+    gz[n] *= dzInv;
+  }
+}
+
 template<typename T>
 inline void evaluate_vgl_impl(const typename qmcplusplus::bspline_traits<T, 3>::SplineType* restrict spline_m,
                               T x,
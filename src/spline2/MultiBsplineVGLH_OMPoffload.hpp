@@ -267,6 +267,67 @@ inline void evaluate_vgh_impl(const typename qmcplusplus::bspline_traits<T, 3>::
   }
 }
 
+/** evaluate the value and gradient of the index-th spline, skipping all the second derivatives
+ */
+template<typename T>
+inline void evaluate_vg_impl_v2(const typename qmcplusplus::bspline_traits<T, 3>::SplineType* restrict spline_m,
+                                int ix,
+                                int iy,
+                                int iz,
+                                const T a[4],
+                                const T b[4],
+                                const T c[4],
+                                const T da[4],
+                                const T db[4],
+                                const T dc[4],
+                                T* restrict vals,
+                                T* restrict grads,
+                                const size_t out_offset,
+                                const int first,
+                                const int index)
+{
+  const intptr_t xs = spline_m->x_stride;
+  const intptr_t ys = spline_m->y_stride;
+  const intptr_t zs = spline_m->z_stride;
+
+  T val = T();
+  T gx  = T();
+  T gy  = T();
+  T gz  = T();
+
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++)
+    {
+      const T* restrict coefs    = spline_m->coefs + ((ix + i) * xs + (iy + j) * ys + iz * zs) + first;
+      const T* restrict coefszs  = coefs + zs;
+      const T* restrict coefs2zs = coefs + 2 * zs;
+      const T* restrict coefs3zs = coefs + 3 * zs;
+
+      const T pre10 = da[i] * b[j];
+      const T pre00 = a[i] * b[j];
+      const T pre01 = a[i] * db[j];
+
+      T coefsv    = coefs[index];
+      T coefsvzs  = coefszs[index];
+      T coefsv2zs = coefs2zs[index];
+      T coefsv3zs = coefs3zs[index];
+
+      T sum0 = c[0] * coefsv + c[1] * coefsvzs + c[2] * coefsv2zs + c[3] * coefsv3zs;
+      T sum1 = dc[0] * coefsv + dc[1] * coefsvzs + dc[2] * coefsv2zs + dc[3] * coefsv3zs;
+
+      gx += pre10 * sum0;
+      gy += pre01 * sum0;
+      gz += pre00 * sum1;
+      val += pre00 * sum0;
+    }
+
+  // put data back to the result vector
+  vals[index]                   = val;
+  grads[index]                  = gx * spline_m->x_grid.delta_inv;
+  grads[index + out_offset]     = gy * spline_m->y_grid.delta_inv;
+  grads[index + 2 * out_offset] = gz * spline_m->z_grid.delta_inv;
+}
+
 template<typename T>
 inline void evaluate_vgh_impl_v2(const typename qmcplusplus::bspline_traits<T, 3>::SplineType* restrict spline_m,
                                  int ix,
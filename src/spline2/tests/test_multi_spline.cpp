@@ -17,6 +17,7 @@
 #include "spline2/MultiBsplineEval.hpp"
 #include "QMCWaveFunctions/BsplineFactory/contraction_helper.hpp"
 #include "config/stdlib/Constants.h"
+#include <limits>
 
 namespace qmcplusplus
 {
@@ -202,6 +203,10 @@ struct test_splines : public test_splines_base<T, GRID_SIZE, NUM_SPLINES>
     for (int i = 0; i < num_splines; i++)
       bs.copy_spline(aspline, i);
 
+    // only rounding to the storage precision
+    for (int i = 0; i < num_splines; i++)
+      CHECK(bs.copy_error(aspline, i) <= std::numeric_limits<T>::epsilon());
+
     mAllocator.destroy(aspline);
 
     //  The values for N=5 are not good enough for finer grids so by default we don't do those checks
@@ -220,6 +225,8 @@ struct test_splines : public test_splines_base<T, GRID_SIZE, NUM_SPLINES>
 
     spline2::evaluate3d_vgh(bs.getSplinePtr(), pos, v, dv, hess);
 
+    spline2::evaluate3d_vg(bs.getSplinePtr(), pos, v, dv);
+
     VectorSoaContainer<T, 3> lap(npad);
     spline2::evaluate3d_vgl(bs.getSplinePtr(), pos, v, dv, lap);
 
@@ -318,6 +325,14 @@ struct test_splines<T, 5, 1> : public test_splines_base<T, 5, 1>
     // Laplacian
     REQUIRE(lap[0][0] == Approx(147.1127789));
 
+    spline2::evaluate3d_vg(bs.getSplinePtr(), pos, v, dv);
+    // Value
+    REQUIRE(v[0] == Approx(-0.9476393279));
+    // Gradient
+    REQUIRE(dv[0][0] == Approx(5.111042137));
+    REQUIRE(dv[0][1] == Approx(5.989106342));
+    REQUIRE(dv[0][2] == Approx(1.952244379));
+
     VectorSoaContainer<T, 10> ghess(npad);
     spline2::evaluate3d_vghgh(bs.getSplinePtr(), pos, v, dv, hess, ghess);
     // Value
@@ -74,6 +74,17 @@ def change_jastrow(tree, j3_tree):
     for j3_node in j3_nodes:
         wf_node.append(j3_node)
 
+def set_random_seed(tree, seed):
+  root = tree.getroot()
+  nodes = root.findall("./random")
+  if nodes:
+    add_or_change_attribute(nodes[0], 'seed', str(seed))
+  else:
+    # before the system and qmc sections, after the project
+    project_nodes = root.findall("./project")
+    index = list(root).index(project_nodes[0]) + 1 if project_nodes else 0
+    root.insert(index, ET.Element("random", {"seed": str(seed)}))
+
 def change_to_unified_drivers(tree):
   qmc_nodes = tree.findall(".//qmc")
   for qmc in qmc_nodes:
@@ -101,6 +112,8 @@ if __name__ == '__main__':
                       help="Use one, two and three body Jastrow factors")
   parser.add_argument('-o', '--output',
                       help="Ouput XML file")
+  parser.add_argument('-s', '--seed',
+                      help="Use a fixed random number seed")
   parser.add_argument('-u', '--unified', action='store_true',
                       help="Use unified batched drivers")
   parser.add_argument('-w', '--walker',
@@ -130,6 +143,9 @@ if __name__ == '__main__':
   if args.unified:
     change_to_unified_drivers(tree)
 
+  if args.seed:
+    set_random_seed(tree, args.seed)
+
   if args.output:
     tree.write(args.output)
   else:
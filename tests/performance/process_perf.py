@@ -0,0 +1,205 @@
+#! /usr/bin/env python3
+
+import xml.etree.ElementTree as ET
+import argparse
+import json
+import os.path
+import sys
+import os
+
+# Read timing information from the .info.xml file and output highlights
+# in a form that can be read by CDash.
+# Optionally write the time of every timer as JSON and compare them against
+# a baseline JSON file written the same way, flagging the slower kernels.
+
+
+def get_timer_from_list(timers, timer_names):
+  for timer_name in timer_names:
+    for timer in timers:
+      if timer.find('name').text == timer_name:
+        return timer
+  return None
+
+
+def get_incl_time(timers, timer_names):
+  timer = get_timer_from_list(timers, timer_names)
+  time_incl = 0.0
+  if timer is not None:
+    time_incl = float(timer.find('time_incl').text)
+  return time_incl
+
+
+def get_stack_timers(timing):
+  """
+     Timers of the stack profile, the direct timer children of timing and the timers they include.
+     The thread, counter and device profiles also use timer elements but have no time_incl.
+  """
+  timers = []
+  nodes = timing.findall('./timer')
+  while nodes:
+    timers.extend(nodes)
+    nodes = [child for node in nodes for child in node.findall('./includes/timer')]
+  return timers
+
+
+def get_performance_info(info_fname):
+  tree = ET.parse(info_fname)
+  timing = tree.find('timing')
+  timers = get_stack_timers(timing)
+  # Alternative with XPath syntax to find a particular timer
+  # vmc_timers = timing.findall(".//timer[name='VMCSingleOMP']")
+
+  vmc_time = get_incl_time(timers, ['VMC', 'VMCBatched', 'VMCSingleOMP', 'VMCcuda'])
+  dmc_time = get_incl_time(timers, ['DMC', 'DMCBatched', 'DMCOMP', 'DMCcuda'])
+
+  return {'VMC Time': vmc_time, 'DMC Time': dmc_time}
+
+
+def get_kernel_info(info_fname):
+  """
+     Inclusive time and calls of every timer, summed over the stacks it appears in.
+  """
+  tree = ET.parse(info_fname)
+  kernels = {}
+  for timer in get_stack_timers(tree.find('timing')):
+    name = timer.find('name').text
+    kernel = kernels.setdefault(name, {'time': 0.0, 'calls': 0})
+    kernel['time'] += float(timer.find('time_incl').text)
+    kernel['calls'] += int(timer.find('calls').text)
+  return kernels
+
+
+# Output on stdout in the right format will be included in the CDash information.
+# Format found in this email:
+#   https://cmake.org/pipermail/cmake/2010-April/036574.html
+def print_for_cdash(vals):
+  for k, v in vals.items():
+    print('<DartMeasurement name="%s" type="numeric/double">%g</DartMeasurement>' % (k, v))
+
+
+def compare_to_baseline(kernels, baseline, tolerance, min_time):
+  """
+     Compare the kernel times against the baseline.
+     A kernel regresses if it is slower than the baseline by more than its tolerance,
+     the 'tolerance' of the kernel or of the whole baseline file, else the given default.
+     Kernels faster than min_time in the baseline are too noisy to compare.
+     Returns the comparison of each kernel, keyed by name.
+  """
+  comparison = {}
+  tolerance = baseline.get('tolerance', tolerance)
+  for name, ref in sorted(baseline['kernels'].items()):
+    if ref['time'] < min_time:
+      continue
+    result = {'baseline': ref['time'], 'tolerance': ref.get('tolerance', tolerance)}
+    if name not in kernels:
+      result['status'] = 'missing'
+    else:
+      result['time'] = kernels[name]['time']
+      result['change'] = result['time'] / ref['time'] - 1.0
+      if result['change'] > result['tolerance']:
+        result['status'] = 'regression'
+      elif result['change'] < -result['tolerance']:
+        result['status'] = 'faster'
+      else:
+        result['status'] = 'ok'
+      if kernels[name]['calls'] != ref['calls']:
+        result['calls'] = kernels[name]['calls']
+        result['baseline_calls'] = ref['calls']
+    comparison[name] = result
+  return comparison
+
+
+def print_comparison(comparison):
+  print('%-50s %12s %12s %9s  %s' % ('Kernel', 'Baseline(s)', 'Current(s)', 'Change', 'Status'))
+  for name, result in comparison.items():
+    if result['status'] == 'missing':
+      print('%-50s %12.4g %12s %9s  MISSING' % (name, result['baseline'], '-', '-'))
+      continue
+    status = result['status']
+    if status == 'regression':
+      status = 'REGRESSION (tolerance %+.1f%%)' % (100 * result['tolerance'])
+    if 'calls' in result:
+      status += ', calls %d, baseline %d' % (result['calls'], result['baseline_calls'])
+    print('%-50s %12.4g %12.4g %+8.1f%%  %s' % (name, result['baseline'], result['time'], 100 * result['change'], status))
+  print_for_cdash({name: result['time'] for name, result in comparison.items() if 'time' in result})
+
+
+def get_info_file(fname):
+  """
+     Construct the info file name from the project id.
+     Read the project id from the qmcpack input file.
+  """
+
+  if fname.endswith('.info.xml'):
+    return fname
+
+  info_fname = ''
+  try:
+    tree = ET.parse(fname)
+  except IOError as e:
+    print('Assuming xml input file, unable to open:',fname)
+    print('  Error ',e)
+    return None
+  node = tree.find('project')
+  if node is not None:
+    base = node.attrib.get('id')
+    if base:
+      info_fname = base + '.info.xml'
+  else:
+    print("project node in XML file node found")
+  path = os.path.dirname(fname)
+  return os.path.join(path, info_fname)
+
+
+if __name__ == '__main__':
+  parser = argparse.ArgumentParser(description="Report the timers of a QMCPACK run and check them against a baseline")
+  parser.add_argument('input_file',
+                      help="*.info.xml file or the QMCPACK input file naming it")
+  parser.add_argument('--json',
+                      help="Write the time and calls of every timer to this JSON file, usable as a baseline")
+  parser.add_argument('--baseline',
+                      help="Baseline JSON file to compare the timers against")
+  parser.add_argument('--tolerance', type=float, default=0.15,
+                      help="Relative slowdown of a kernel flagged as a regression, unless set in the baseline")
+  parser.add_argument('--min-time', type=float, default=0.01,
+                      help="Skip the kernels below this baseline time in seconds")
+  args = parser.parse_args()
+
+  fname = args.input_file
+  if not os.path.exists(fname):
+    print('Input file not found: ', fname)
+    sys.exit(1)
+
+  info_fname = get_info_file(fname)
+  if not info_fname:
+    print('Info file not extracted from: ', fname)
+    sys.exit(1)
+
+  if not os.path.exists(info_fname):
+    print('Info file does not exist: %s'%info_fname)
+    print('  Current directory: %s'%os.getcwd())
+    sys.exit(1)
+  vals = get_performance_info(info_fname)
+  print_for_cdash(vals)
+
+  kernels = get_kernel_info(info_fname)
+  comparison = None
+  if args.baseline:
+    with open(args.baseline) as f:
+      baseline = json.load(f)
+    comparison = compare_to_baseline(kernels, baseline, args.tolerance, args.min_time)
+    print_comparison(comparison)
+
+  if args.json:
+    results = {'info_file': os.path.abspath(info_fname), 'summary': vals, 'kernels': kernels}
+    if comparison is not None:
+      results['baseline_file'] = os.path.abspath(args.baseline)
+      results['comparison'] = comparison
+    with open(args.json, 'w') as f:
+      json.dump(results, f, indent=2, sort_keys=True)
+
+  if comparison:
+    failed = [name for name, result in comparison.items() if result['status'] in ('regression', 'missing')]
+    if failed:
+      print('Performance regression in %d kernel(s): %s' % (len(failed), ', '.join(failed)))
+      sys.exit(1)